@@ -26,7 +26,7 @@ TACS_LD_FLAGS = ${EXTRA_LD_FLAGS} ${TACS_LD_CMD} ${TACS_EXTERN_LIBS}
 # This is the one rule that is used to compile all the
 # source code in TACS
 %.o: %.cpp
-	${CXX} ${TACS_CC_FLAGS} -std=c++11 -c $< -o $*.o
+	${CXX} ${TACS_CC_FLAGS} -std=c++14 -c $< -o $*.o
 	@echo
 	@echo "        --- Compiled $*.cpp successfully ---"
 	@echo
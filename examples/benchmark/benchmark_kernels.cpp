@@ -0,0 +1,331 @@
+#include "BCSRMat.h"
+#include "TACSElement3D.h"
+#include "TACSElementVerification.h"
+#include "TACSHexaBasis.h"
+#include "TACSIsoShellConstitutive.h"
+#include "TACSLinearElasticity.h"
+#include "TACSShellElementDefs.h"
+#include "TACSSolidConstitutive.h"
+
+/*
+  Microbenchmarks for the BCSR matrix kernels and the element kernels.
+
+  Each BCSR block size is timed on a synthetic block-banded matrix
+  sized to exceed the last-level cache, so the reported rates reflect
+  streaming performance rather than cache residency. The element
+  benchmarks time addResidual and addJacobian with random inputs in
+  the style of the element verification tests.
+
+  Every result is printed both in a human-readable form and as a CSV
+  line prefixed with "csv," so that the output can be collected and
+  tracked across releases:
+
+  csv, <benchmark>, <parameter>, <reps>, <time/call>, <GFLOP/s>, <GB/s>
+
+  For the element benchmarks the last two fields are the time per
+  element and the number of elements processed per second.
+
+  Usage:
+  ./benchmark_kernels [nrows=value] [nnz=value]
+
+  nrows: the number of block rows in the benchmark matrices
+  nnz:   the average number of blocks per block row
+*/
+
+/*
+  Create a block-banded BCSR matrix with the given block size and fill
+  it with random values
+*/
+BCSRMat *createRandomBCSRMat(MPI_Comm comm, TACSThreadInfo *thread_info,
+                             int bsize, int nrows, int nnz_per_row) {
+  int *rowp = new int[nrows + 1];
+  int *cols = new int[nrows * nnz_per_row];
+
+  // Build a banded pattern with the diagonal included: a band of
+  // nnz_per_row blocks centered on the diagonal
+  rowp[0] = 0;
+  for (int i = 0; i < nrows; i++) {
+    int start = i - nnz_per_row / 2;
+    if (start < 0) {
+      start = 0;
+    }
+    if (start + nnz_per_row > nrows) {
+      start = nrows - nnz_per_row;
+    }
+
+    int nz = rowp[i];
+    for (int j = start; j < start + nnz_per_row; j++) {
+      cols[nz] = j;
+      nz++;
+    }
+    rowp[i + 1] = nz;
+  }
+
+  BCSRMat *mat = new BCSRMat(comm, thread_info, bsize, nrows, nrows, &rowp,
+                             &cols, NULL);
+
+  // Fill the matrix with random entries and make it diagonally
+  // dominant so that the factorization is stable
+  int bs, nr, nc;
+  const int *mrowp, *mcols;
+  TacsScalar *A;
+  mat->getArrays(&bs, &nr, &nc, &mrowp, &mcols, &A);
+
+  const int b2 = bsize * bsize;
+  TacsGenerateRandomArray(A, b2 * mrowp[nrows]);
+
+  for (int i = 0; i < nrows; i++) {
+    for (int jp = mrowp[i]; jp < mrowp[i + 1]; jp++) {
+      if (mcols[jp] == i) {
+        for (int k = 0; k < bsize; k++) {
+          A[b2 * jp + (bsize + 1) * k] += 2.0 * nnz_per_row;
+        }
+      }
+    }
+  }
+
+  return mat;
+}
+
+/*
+  Time the matrix-vector product and the factor apply for a single
+  block size and report the achieved rates
+*/
+void benchmarkBCSRKernels(MPI_Comm comm, TACSThreadInfo *thread_info,
+                          int bsize, int nrows, int nnz_per_row) {
+  BCSRMat *mat = createRandomBCSRMat(comm, thread_info, bsize, nrows,
+                                     nnz_per_row);
+  mat->incref();
+
+  const int b2 = bsize * bsize;
+  const int nnz = nnz_per_row * nrows;
+
+  TacsScalar *x = new TacsScalar[bsize * nrows];
+  TacsScalar *y = new TacsScalar[bsize * nrows];
+  TacsGenerateRandomArray(x, bsize * nrows);
+
+  // Time the matrix-vector product. Calibrate the repetition count so
+  // that each measurement runs for roughly half a second
+  mat->mult(x, y);  // Warm up
+
+  double t0 = MPI_Wtime();
+  mat->mult(x, y);
+  double t_single = MPI_Wtime() - t0;
+  int reps = (int)(0.5 / t_single) + 1;
+
+  t0 = MPI_Wtime();
+  for (int i = 0; i < reps; i++) {
+    mat->mult(x, y);
+  }
+  double t_mult = (MPI_Wtime() - t0) / reps;
+
+  // 2*b2 flops per block; each block is streamed once with its column
+  // index, and the vectors are read/written once
+  double flops = 2.0 * b2 * nnz;
+  double bytes = (sizeof(TacsScalar) * b2 + sizeof(int)) * (double)nnz +
+                 3.0 * sizeof(TacsScalar) * bsize * nrows;
+
+  printf("BCSRMatVecMult%-2d  n %8d  %10.3e s  %7.2f GFLOP/s  %7.2f GB/s\n",
+         bsize, bsize * nrows, t_mult, 1e-9 * flops / t_mult,
+         1e-9 * bytes / t_mult);
+  printf("csv, mult%d, %d, %d, %.6e, %.3f, %.3f\n", bsize, bsize * nrows,
+         reps, t_mult, 1e-9 * flops / t_mult, 1e-9 * bytes / t_mult);
+
+  // Time the triangular solves from the factored matrix. The flop and
+  // byte counts are the same as the product to first order: every
+  // block is visited once per apply
+  mat->factor();
+  mat->applyFactor(x, y);  // Warm up
+
+  t0 = MPI_Wtime();
+  for (int i = 0; i < reps; i++) {
+    mat->applyFactor(x, y);
+  }
+  double t_apply = (MPI_Wtime() - t0) / reps;
+
+  printf("BCSRMatApply%-2d    n %8d  %10.3e s  %7.2f GFLOP/s  %7.2f GB/s\n",
+         bsize, bsize * nrows, t_apply, 1e-9 * flops / t_apply,
+         1e-9 * bytes / t_apply);
+  printf("csv, apply%d, %d, %d, %.6e, %.3f, %.3f\n", bsize, bsize * nrows,
+         reps, t_apply, 1e-9 * flops / t_apply, 1e-9 * bytes / t_apply);
+
+  delete[] x;
+  delete[] y;
+  mat->decref();
+}
+
+/*
+  Time the residual and Jacobian kernels of a single element with
+  random inputs
+*/
+void benchmarkElement(TACSElement *element, const char *label) {
+  int nnodes = element->getNumNodes();
+  int nvars = element->getNumVariables();
+
+  TacsScalar *Xpts = new TacsScalar[3 * nnodes];
+  TacsScalar *vars = new TacsScalar[nvars];
+  TacsScalar *dvars = new TacsScalar[nvars];
+  TacsScalar *ddvars = new TacsScalar[nvars];
+  TacsScalar *res = new TacsScalar[nvars];
+  TacsScalar *mat = new TacsScalar[nvars * nvars];
+
+  // Use a regular node layout with a small random perturbation so
+  // that the element geometry is well-conditioned
+  TacsGenerateRandomArray(Xpts, 3 * nnodes, 0.0, 0.1);
+  for (int i = 0; i < nnodes; i++) {
+    Xpts[3 * i] += i % 2;
+    Xpts[3 * i + 1] += (i / 2) % 2;
+    Xpts[3 * i + 2] += i / 4;
+  }
+  TacsGenerateRandomArray(vars, nvars, -1e-3, 1e-3);
+  TacsGenerateRandomArray(dvars, nvars, -1e-3, 1e-3);
+  TacsGenerateRandomArray(ddvars, nvars, -1e-3, 1e-3);
+
+  int elemIndex = 0;
+  double time = 0.0;
+
+  // Calibrate the repetition counts to roughly half a second
+  memset(res, 0, nvars * sizeof(TacsScalar));
+  element->addResidual(elemIndex, time, Xpts, vars, dvars, ddvars, res);
+
+  double t0 = MPI_Wtime();
+  element->addResidual(elemIndex, time, Xpts, vars, dvars, ddvars, res);
+  double t_single = MPI_Wtime() - t0;
+  int reps = (int)(0.5 / t_single) + 1;
+
+  t0 = MPI_Wtime();
+  for (int i = 0; i < reps; i++) {
+    element->addResidual(elemIndex, time, Xpts, vars, dvars, ddvars, res);
+  }
+  double t_res = (MPI_Wtime() - t0) / reps;
+
+  printf("%-18s addResidual  %10.3e s/elem  %10.0f elem/s\n", label, t_res,
+         1.0 / t_res);
+  printf("csv, %s_residual, %d, %d, %.6e, %.1f, 0\n", label, nvars, reps,
+         t_res, 1.0 / t_res);
+
+  memset(mat, 0, nvars * nvars * sizeof(TacsScalar));
+  element->addJacobian(elemIndex, time, 1.0, 0.0, 0.0, Xpts, vars, dvars,
+                       ddvars, res, mat);
+
+  t0 = MPI_Wtime();
+  element->addJacobian(elemIndex, time, 1.0, 0.0, 0.0, Xpts, vars, dvars,
+                       ddvars, res, mat);
+  t_single = MPI_Wtime() - t0;
+  reps = (int)(0.5 / t_single) + 1;
+
+  t0 = MPI_Wtime();
+  for (int i = 0; i < reps; i++) {
+    element->addJacobian(elemIndex, time, 1.0, 0.0, 0.0, Xpts, vars, dvars,
+                         ddvars, res, mat);
+  }
+  double t_jac = (MPI_Wtime() - t0) / reps;
+
+  printf("%-18s addJacobian  %10.3e s/elem  %10.0f elem/s\n", label, t_jac,
+         1.0 / t_jac);
+  printf("csv, %s_jacobian, %d, %d, %.6e, %.1f, 0\n", label, nvars, reps,
+         t_jac, 1.0 / t_jac);
+
+  delete[] Xpts;
+  delete[] vars;
+  delete[] dvars;
+  delete[] ddvars;
+  delete[] res;
+  delete[] mat;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+  TacsInitialize();
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+
+  // Size the matrices to exceed the last-level cache: the default is
+  // about 180 MB of matrix data at block size 6
+  int nrows = 50000;
+  int nnz_per_row = 18;
+  for (int k = 0; k < argc; k++) {
+    int value;
+    if (sscanf(argv[k], "nrows=%d", &value) == 1 && value > 100) {
+      nrows = value;
+    }
+    if (sscanf(argv[k], "nnz=%d", &value) == 1 && value > 1) {
+      nnz_per_row = value;
+    }
+  }
+
+  TacsSeedRandomGenerator(0);
+
+  TACSThreadInfo *thread_info = new TACSThreadInfo(1);
+  thread_info->incref();
+
+  printf("BCSR kernel benchmarks: %d block rows, %d blocks per row\n", nrows,
+         nnz_per_row);
+
+  // Benchmark each specialized block size, and block size 7 for the
+  // generic fallback kernels
+  const int bsizes[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 12};
+  const int nbsizes = sizeof(bsizes) / sizeof(bsizes[0]);
+  for (int i = 0; i < nbsizes; i++) {
+    benchmarkBCSRKernels(comm, thread_info, bsizes[i], nrows, nnz_per_row);
+  }
+
+  // Create the material properties for the element benchmarks
+  TacsScalar rho = 2700.0;
+  TacsScalar specific_heat = 921.096;
+  TacsScalar E = 70e3;
+  TacsScalar nu = 0.3;
+  TacsScalar ys = 270.0;
+  TacsScalar cte = 24.0e-6;
+  TacsScalar kappa = 230.0;
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(rho, specific_heat, E, nu, ys, cte, kappa);
+  props->incref();
+
+  printf("\nElement kernel benchmarks\n");
+
+  // Benchmark the linear and quadratic shell elements
+  TACSShellTransform *transform = new TACSShellNaturalTransform();
+  transform->incref();
+  TACSShellConstitutive *shell_con = new TACSIsoShellConstitutive(props, 1.0);
+  shell_con->incref();
+
+  TACSElement *quad4 = new TACSQuad4Shell(transform, shell_con);
+  quad4->incref();
+  benchmarkElement(quad4, "quad4_shell");
+  quad4->decref();
+
+  TACSElement *quad9 = new TACSQuad9Shell(transform, shell_con);
+  quad9->incref();
+  benchmarkElement(quad9, "quad9_shell");
+  quad9->decref();
+
+  transform->decref();
+  shell_con->decref();
+
+  // Benchmark the linear and quadratic solid elements
+  TACSSolidConstitutive *solid_con = new TACSSolidConstitutive(props);
+  solid_con->incref();
+  TACSLinearElasticity3D *model =
+      new TACSLinearElasticity3D(solid_con, TACS_LINEAR_STRAIN);
+  model->incref();
+
+  TACSElement *hexa8 = new TACSElement3D(model, new TACSLinearHexaBasis());
+  hexa8->incref();
+  benchmarkElement(hexa8, "hexa8_solid");
+  hexa8->decref();
+
+  TACSElement *hexa27 = new TACSElement3D(model, new TACSQuadraticHexaBasis());
+  hexa27->incref();
+  benchmarkElement(hexa27, "hexa27_solid");
+  hexa27->decref();
+
+  model->decref();
+  solid_con->decref();
+  props->decref();
+  thread_info->decref();
+
+  TacsFinalize();
+  MPI_Finalize();
+  return 0;
+}
@@ -18,7 +18,10 @@
 
 #include "TACSAssembler.h"
 
+#include <math.h>
+
 #include "TACSElementVerification.h"
+#include "TACSProfiler.h"
 #include "TacsUtilities.h"
 
 // Reordering implementation
@@ -35,6 +38,20 @@
 // TACS-BLAS/LAPACK header
 #include "tacslapack.h"
 
+// The number of elements staged together in each call to the batched
+// element residual interface
+static const int TACS_RESIDUAL_BATCH_SIZE = 32;
+
+// The number of elements staged together in each call to the batched
+// element Jacobian interface. This is smaller than the residual batch
+// size since each staged element carries its full element matrix.
+static const int TACS_JACOBIAN_BATCH_SIZE = 8;
+
+// The number of elements whose node-coordinate sensitivities are
+// accumulated into a tile-local buffer before the tile is scattered
+// into the output vectors
+static const int TACS_XPTSENS_TILE_SIZE = 32;
+
 /**
   Constructor for the TACSAssembler object
 
@@ -65,9 +82,13 @@ TACSAssembler::TACSAssembler(MPI_Comm _tacs_comm, int _varsPerNode,
   thread_info->incref();
   pthread_mutex_init(&tacs_mutex, NULL);
 
+  // The work-stealing thread pool is created on the first threaded
+  // assembly call. The workers are not pinned to cores by default.
+  threadPool = NULL;
+  pinThreads = 0;
+
   // Create the class that is used to
   tacsPInfo = new TACSAssemblerPthreadInfo();
-  numCompletedElements = 0;
 
   // copy data to be used later in the program
   varsPerNode = _varsPerNode;
@@ -75,6 +96,9 @@ TACSAssembler::TACSAssembler(MPI_Comm _tacs_comm, int _varsPerNode,
   numOwnedNodes = _numOwnedNodes;
   numDependentNodes = _numDependentNodes;
 
+  // No halo element replicas by default
+  numHaloElements = 0;
+
   // These values will be computed later
   numMultiplierNodes = 0;
   numExtNodes = 0;
@@ -114,6 +138,11 @@ TACSAssembler::TACSAssembler(MPI_Comm _tacs_comm, int _varsPerNode,
   // Set the auxiliary element class to NULL
   auxElements = NULL;
 
+  // The cached load vector for the state-independent aux elements
+  auxLoadVec = NULL;
+  auxLoadTime = 0.0;
+  auxLoadsValid = 0;
+
   // Information for setting boundary conditions and distributing variables
   nodeMap = new TACSNodeMap(tacs_comm, numOwnedNodes);
   nodeMap->incref();
@@ -130,6 +159,7 @@ TACSAssembler::TACSAssembler(MPI_Comm _tacs_comm, int _varsPerNode,
   dvarsVec = NULL;
   ddvarsVec = NULL;
   xptVec = NULL;
+  nodeVersion = 0;
 
   // Set the external node numbers to NULL
   tacsExtNodeNums = NULL;
@@ -141,9 +171,19 @@ TACSAssembler::TACSAssembler(MPI_Comm _tacs_comm, int _varsPerNode,
   // Reordering information old node i -> newNodeIndices[i]
   newNodeIndices = NULL;
 
+  // Element reordering information old element i -> newElementNums[i]
+  newElementNums = NULL;
+
+  // Per-element assembly cost measurement
+  recordElementTime = 0;
+  elementRuntime = NULL;
+
   // parMat specific objects
   parMatIndices = NULL;
 
+  // No cached symbolic structure by default
+  symbolicStruct = NULL;
+
   // TACSSchurMat-specific objects
   schurBIndices = schurCIndices = NULL;
   schurBMap = schurCMap = NULL;
@@ -152,6 +192,17 @@ TACSAssembler::TACSAssembler(MPI_Comm _tacs_comm, int _varsPerNode,
   elementNodeIndex = NULL;
   elementTacsNodes = NULL;
 
+  // The element coloring is computed on the first threaded matrix
+  // assembly call
+  numElementColors = 0;
+  elementColorPtr = NULL;
+  elementColorList = NULL;
+
+  // The interior/boundary element split is computed on the first
+  // assembly call that overlaps computation with communication
+  elementBoundaryFlag = NULL;
+  pendingVarsDist = 0;
+
   // Null out the dependent node data
   depNodes = NULL;
 
@@ -164,9 +215,87 @@ TACSAssembler::TACSAssembler(MPI_Comm _tacs_comm, int _varsPerNode,
   // Set the local element data to NULL
   elementData = NULL;
   elementIData = NULL;
+  elementDataSize = 0;
+  elementIDataSize = 0;
   elementSensData = NULL;
   elementSensIData = NULL;
 
+  // The per-thread scratch space is allocated by the worker threads
+  // on their first assembly call
+  for (int k = 0; k < TACSThreadInfo::TACS_MAX_NUM_THREADS; k++) {
+    threadElementData[k] = NULL;
+    threadElementIData[k] = NULL;
+  }
+
+  // The function and batch scratch space is allocated on first use
+  maxNumFuncs = 0;
+  funcSubDomains = NULL;
+  funcIData = NULL;
+
+  // The restricted reverse-scatter plans are built on first use
+  numFuncDists = 0;
+  maxFuncDists = 0;
+  funcDistFuncs = NULL;
+  funcDistDomainSizes = NULL;
+  funcDistDomainElems = NULL;
+  funcDistUsable = NULL;
+  funcDists = NULL;
+  funcDistCtxs = NULL;
+  funcDistVals = NULL;
+  batchData = NULL;
+  batchIData = NULL;
+  batchJacData = NULL;
+  batchElemPtrs = NULL;
+  jacBlockPattern = NULL;
+  blockScatterData = NULL;
+  blockScatterIData = NULL;
+
+  // Devirtualized residual kernel registry
+  numResidualKernels = 0;
+  residualKernelTypes = NULL;
+  residualKernelFns = NULL;
+  elementKernels = NULL;
+  kernelsResolved = 0;
+  vecPlan = NULL;
+  dvPlan = NULL;
+  dvPlanPtr = NULL;
+  numOwnedDesignVars = 0;
+
+  // Incremental assembly is off by default
+  useIncrementalAssembly = 0;
+  elementDirtyFlags = NULL;
+  cachedElemJac = NULL;
+  cachedJacValid = 0;
+  cachedJacTime = 0.0;
+  cachedJacAlpha = cachedJacBeta = cachedJacGamma = 0.0;
+  cachedJacLambda = 1.0;
+  cachedJacMatOr = TACS_MAT_NORMAL;
+
+  // Canonical-element matrix sharing is off by default
+  useCanonicalElements = 0;
+  elemMatClass = NULL;
+  matClassElems = NULL;
+  numMatClasses = 0;
+  matClassMats = NULL;
+  matClassNodeVersion = -1;
+
+  // Linear-element caching is off by default
+  useLinearElemCache = 0;
+  linearCacheValid = 0;
+  linearCacheNodeVersion = -1;
+  linearCacheTime = 0.0;
+  linearCacheHasLoad = 0;
+  numLinearElems = 0;
+  linearElemOffset = NULL;
+  linearElemFlags = NULL;
+  linearElemSize = NULL;
+  linearElemData = NULL;
+
+  // Static condensation ordering is off by default
+  useCondensationOrdering = 0;
+  autoLocalOrdering = 0;
+  useMultiplierOrdering = 0;
+
   // Initial condition vectors
   vars0 = NULL;
   dvars0 = NULL;
@@ -213,6 +342,15 @@ TACSAssembler::~TACSAssembler() {
   if (elementTacsNodes) {
     delete[] elementTacsNodes;
   }
+  if (elementColorPtr) {
+    delete[] elementColorPtr;
+  }
+  if (elementColorList) {
+    delete[] elementColorList;
+  }
+  if (elementBoundaryFlag) {
+    delete[] elementBoundaryFlag;
+  }
   if (tacsExtNodeNums) {
     delete[] tacsExtNodeNums;
   }
@@ -226,6 +364,9 @@ TACSAssembler::~TACSAssembler() {
   if (auxElements) {
     auxElements->decref();
   }
+  if (auxLoadVec) {
+    auxLoadVec->decref();
+  }
 
   // Decrease the reference count to objects allocated in initialize
   if (nodeMap) {
@@ -248,12 +389,23 @@ TACSAssembler::~TACSAssembler() {
   if (newNodeIndices) {
     newNodeIndices->decref();
   }
+  if (elementRuntime) {
+    delete[] elementRuntime;
+  }
+  if (newElementNums) {
+    delete[] newElementNums;
+  }
 
   // Decrease ref. count for TACSParallelMat data
   if (parMatIndices) {
     parMatIndices->decref();
   }
 
+  // Decrease ref. count for the cached symbolic structure
+  if (symbolicStruct) {
+    symbolicStruct->decref();
+  }
+
   // Decrease ref. count for the TACSSchurMat data if it is allocated
   if (schurBIndices) {
     schurBIndices->decref();
@@ -282,6 +434,116 @@ TACSAssembler::~TACSAssembler() {
     delete[] elementSensIData;
   }
 
+  // Delete the per-thread scratch space
+  for (int k = 0; k < TACSThreadInfo::TACS_MAX_NUM_THREADS; k++) {
+    if (threadElementData[k]) {
+      delete[] threadElementData[k];
+    }
+    if (threadElementIData[k]) {
+      delete[] threadElementIData[k];
+    }
+  }
+
+  // Delete the function and batch scratch space
+  if (funcSubDomains) {
+    delete[] funcSubDomains;
+  }
+  if (funcIData) {
+    delete[] funcIData;
+  }
+
+  // Free the restricted reverse-scatter plans
+  for (int k = 0; k < numFuncDists; k++) {
+    funcDistFuncs[k]->decref();
+    if (funcDistDomainElems[k]) {
+      delete[] funcDistDomainElems[k];
+    }
+    if (funcDists[k]) {
+      funcDists[k]->decref();
+    }
+    if (funcDistCtxs[k]) {
+      funcDistCtxs[k]->decref();
+    }
+    if (funcDistVals[k]) {
+      delete[] funcDistVals[k];
+    }
+  }
+  if (funcDistFuncs) {
+    delete[] funcDistFuncs;
+    delete[] funcDistDomainSizes;
+    delete[] funcDistDomainElems;
+    delete[] funcDistUsable;
+    delete[] funcDists;
+    delete[] funcDistCtxs;
+    delete[] funcDistVals;
+  }
+  if (batchData) {
+    delete[] batchData;
+  }
+  if (batchIData) {
+    delete[] batchIData;
+  }
+  if (batchJacData) {
+    delete[] batchJacData;
+  }
+  if (batchElemPtrs) {
+    delete[] batchElemPtrs;
+  }
+  if (jacBlockPattern) {
+    delete[] jacBlockPattern;
+  }
+  if (blockScatterData) {
+    delete[] blockScatterData;
+  }
+  if (blockScatterIData) {
+    delete[] blockScatterIData;
+  }
+  if (residualKernelTypes) {
+    delete[] residualKernelTypes;
+  }
+  if (residualKernelFns) {
+    delete[] residualKernelFns;
+  }
+  if (elementKernels) {
+    delete[] elementKernels;
+  }
+  if (vecPlan) {
+    delete[] vecPlan;
+  }
+  if (dvPlan) {
+    delete[] dvPlan;
+  }
+  if (dvPlanPtr) {
+    delete[] dvPlanPtr;
+  }
+  if (elementDirtyFlags) {
+    delete[] elementDirtyFlags;
+  }
+  if (cachedElemJac) {
+    delete[] cachedElemJac;
+  }
+  if (elemMatClass) {
+    delete[] elemMatClass;
+  }
+  if (matClassElems) {
+    delete[] matClassElems;
+  }
+  if (matClassMats) {
+    delete[] matClassMats;
+  }
+  if (linearElemOffset) {
+    delete[] linearElemOffset;
+  }
+  if (linearElemFlags) {
+    delete[] linearElemFlags;
+  }
+  if (linearElemSize) {
+    delete[] linearElemSize;
+  }
+  if (linearElemData) {
+    delete[] linearElemData;
+  }
+
   // Delete initial condition vectors
   if (vars0) {
     vars0->decref();
@@ -295,6 +557,11 @@ TACSAssembler::~TACSAssembler() {
 
   // Decref the thread information class
   thread_info->decref();
+
+  // Shut down the thread pool - if it was created
+  if (threadPool) {
+    threadPool->decref();
+  }
 }
 
 const char *TACSAssembler::tacsName = "TACSAssembler";
@@ -311,7 +578,48 @@ MPI_Comm TACSAssembler::getMPIComm() { return tacs_comm; }
 
   @param t The number of threads
 */
-void TACSAssembler::setNumThreads(int t) { thread_info->setNumThreads(t); }
+void TACSAssembler::setNumThreads(int t) {
+  thread_info->setNumThreads(t);
+
+  // Discard the thread pool so that it is re-created with the new
+  // number of threads on the next threaded assembly call
+  if (threadPool && threadPool->getNumThreads() != thread_info->getNumThreads()) {
+    threadPool->decref();
+    threadPool = NULL;
+  }
+}
+
+/**
+  Pin the assembly worker threads to processor cores
+
+  On multi-socket nodes this keeps each worker on the same memory
+  node across assembly calls, so the per-thread scratch arrays - which
+  are first touched by the worker that owns them - stay local to that
+  worker. Thread pinning is only available on Linux.
+
+  @param flag Non-zero to pin the pool workers, zero to unpin them
+*/
+void TACSAssembler::setThreadAffinity(int flag) {
+  pinThreads = flag;
+  if (threadPool) {
+    threadPool->setThreadAffinity(pinThreads);
+  }
+}
+
+/*
+  Retrieve the persistent work-stealing thread pool, creating it on
+  the first threaded assembly call
+*/
+TACSThreadPool *TACSAssembler::getThreadPool() {
+  if (!threadPool) {
+    threadPool = new TACSThreadPool(thread_info->getNumThreads());
+    threadPool->incref();
+    if (pinThreads) {
+      threadPool->setThreadAffinity(pinThreads);
+    }
+  }
+  return threadPool;
+}
 
 /**
    Return the thread information from the TACSAssembler object
@@ -446,21 +754,23 @@ TACSElement **TACSAssembler::getElements() { return elements; }
 TACSElement *TACSAssembler::getElement(int index, TacsScalar *Xpts,
                                        TacsScalar *vars, TacsScalar *dvars,
                                        TacsScalar *ddvars) {
+  finishDistributingVariables();
+
   if (elements && xptVec && (index >= 0 && index < numElements)) {
     int ptr = elementNodeIndex[index];
     int len = elementNodeIndex[index + 1] - ptr;
     const int *nodes = &elementTacsNodes[ptr];
     if (Xpts) {
-      xptVec->getValues(len, nodes, Xpts);
+      xptVec->getBlockedValues(len, nodes, Xpts);
     }
     if (vars) {
-      varsVec->getValues(len, nodes, vars);
+      varsVec->getBlockedValues(len, nodes, vars);
     }
     if (dvars) {
-      dvarsVec->getValues(len, nodes, dvars);
+      dvarsVec->getBlockedValues(len, nodes, dvars);
     }
     if (ddvars) {
-      ddvarsVec->getValues(len, nodes, ddvars);
+      ddvarsVec->getBlockedValues(len, nodes, ddvars);
     }
 
     return elements[index];
@@ -657,6 +967,10 @@ int TACSAssembler::setElements(TACSElement **_elements) {
     }
   }
 
+  // The per-element kernel table must be re-resolved for the new
+  // element objects
+  kernelsResolved = 0;
+
   // Keep track of the number of multiplier nodes
   numMultiplierNodes = 0;
 
@@ -708,6 +1022,260 @@ int TACSAssembler::setElements(TACSElement **_elements) {
   return 0;
 }
 
+/**
+  Ingest an externally generated mesh in bulk.
+
+  This combines setElementConnectivity(), setElements(), addBCs(),
+  initialize() and setNodes() into a single call designed for large
+  meshes produced by external mesh generators. The connectivity arrays
+  are adopted without copying: they must be allocated with new[] and
+  ownership passes to TACSAssembler, so the caller must not free or
+  modify them afterwards. Instead of one element object per element,
+  the caller provides a table of distinct element types and a
+  per-element index into that table, so the per-element consistency
+  checks in setElements() reduce to one check per type.
+
+  The node locations are supplied for the locally owned nodes in their
+  ownership order (length 3*numOwnedNodes), matching the global node
+  numbering used by the connectivity. The boundary condition nodes are
+  fully fixed to zero; partial or non-homogeneous conditions can be
+  added with addBCs() before this call. Since this call runs
+  initialize(), it cannot be combined with computeReordering().
+
+  The per-element validation performed by setElementConnectivity() -
+  node numbers within the ownership range and connectivity sizes that
+  match the element types - is skipped unless the validate flag is
+  set, since it is a significant cost at large element counts.
+
+  @param elemPtr Offset into the connectivity array (adopted, new[])
+  @param elemConn Element to global node connectivity (adopted, new[])
+  @param numElemTypes The number of distinct element objects
+  @param elemTypes The array of distinct element objects
+  @param elemTypeIds Per-element index into the element type table
+  @param Xpts Locally owned node locations (may be NULL)
+  @param numBCNodes The number of fully fixed boundary condition nodes
+  @param bcNodes The global boundary condition node numbers
+  @param validate Flag to enable the per-element consistency checks
+  @return Fail flag indicating if a failure occured
+*/
+int TACSAssembler::setBulkModel(int *elemPtr, int *elemConn, int numElemTypes,
+                                TACSElement **elemTypes,
+                                const int *elemTypeIds, const TacsScalar *Xpts,
+                                int numBCNodes, const int *bcNodes,
+                                int validate) {
+  if (meshInitializedFlag) {
+    fprintf(stderr, "[%d] Cannot call setBulkModel() after initialize()\n",
+            mpiRank);
+    return 1;
+  }
+  if (tacsExtNodeNums) {
+    fprintf(stderr, "[%d] Cannot call setBulkModel() after reordering\n",
+            mpiRank);
+    return 1;
+  }
+
+  // Check the element types up front - this replaces the per-element
+  // checks performed by setElements()
+  for (int t = 0; t < numElemTypes; t++) {
+    if (elemTypes[t]->getVarsPerNode() != varsPerNode) {
+      fprintf(stderr,
+              "[%d] TACSAssembler: Element %s, num displacements %d "
+              "does not match variables per node %d\n",
+              mpiRank, elemTypes[t]->getObjectName(),
+              elemTypes[t]->getVarsPerNode(), varsPerNode);
+      return 1;
+    }
+  }
+
+  if (validate) {
+    const int *ownerRange;
+    nodeMap->getOwnerRange(&ownerRange);
+
+    for (int i = 0; i < numElements; i++) {
+      int t = elemTypeIds[i];
+      if (t < 0 || t >= numElemTypes) {
+        fprintf(stderr, "[%d] TACSAssembler: Element %d type %d out of range\n",
+                mpiRank, i, t);
+        return 1;
+      }
+      if (elemPtr[i + 1] - elemPtr[i] != elemTypes[t]->getNumNodes()) {
+        fprintf(stderr,
+                "[%d] TACSAssembler: Element %s does not match "
+                "connectivity\n",
+                mpiRank, elemTypes[t]->getObjectName());
+        return 1;
+      }
+      for (int j = elemPtr[i]; j < elemPtr[i + 1]; j++) {
+        if (elemConn[j] >= ownerRange[mpiSize]) {
+          fprintf(stderr,
+                  "[%d] TACSAssembler: Element %d contains node number "
+                  "out of range\n",
+                  mpiRank, i);
+          return 1;
+        } else if (elemConn[j] < -numDependentNodes) {
+          fprintf(stderr,
+                  "[%d] TACSAssembler: Element %d contains dependent "
+                  "node number out of range\n",
+                  mpiRank, i);
+          return 1;
+        }
+      }
+    }
+  }
+
+  // Adopt the connectivity arrays without copying them
+  if (elementTacsNodes) {
+    delete[] elementTacsNodes;
+  }
+  if (elementNodeIndex) {
+    delete[] elementNodeIndex;
+  }
+  elementNodeIndex = elemPtr;
+  elementTacsNodes = elemConn;
+
+  // Expand the element type table into the per-element array
+  if (elements) {
+    for (int i = 0; i < numElements; i++) {
+      if (elements[i]) {
+        elements[i]->decref();
+      }
+    }
+  } else {
+    elements = new TACSElement *[numElements];
+  }
+  for (int i = 0; i < numElements; i++) {
+    elements[i] = elemTypes[elemTypeIds[i]];
+    elements[i]->incref();
+  }
+
+  // The per-element kernel table must be re-resolved for the new
+  // element objects
+  kernelsResolved = 0;
+
+  // Count the number of elements of each type and record the first
+  // element index of each type so that the size information can be
+  // computed once per type rather than once per element
+  int *typeCounts = new int[numElemTypes];
+  int *typeFirstElem = new int[numElemTypes];
+  memset(typeCounts, 0, numElemTypes * sizeof(int));
+  for (int i = 0; i < numElements; i++) {
+    if (typeCounts[elemTypeIds[i]] == 0) {
+      typeFirstElem[elemTypeIds[i]] = i;
+    }
+    typeCounts[elemTypeIds[i]]++;
+  }
+
+  // Keep track of the number of multiplier nodes
+  numMultiplierNodes = 0;
+
+  // Determine the maximum number of nodes per element
+  maxElementDesignVars = 0;
+  maxElementSize = 0;
+  maxElementNodes = 0;
+
+  for (int t = 0; t < numElemTypes; t++) {
+    if (typeCounts[t] == 0) {
+      continue;
+    }
+
+    // Determine if the maximum number of variables and nodes needs to
+    // be changed
+    int elemSize = elemTypes[t]->getNumVariables();
+    if (elemSize > maxElementSize) {
+      maxElementSize = elemSize;
+    }
+
+    elemSize = elemTypes[t]->getNumNodes();
+    if (elemSize > maxElementNodes) {
+      maxElementNodes = elemSize;
+    }
+
+    // Count up the multiplier nodes
+    int multiplier = elemTypes[t]->getMultiplierIndex();
+    if (multiplier > 0) {
+      numMultiplierNodes += typeCounts[t];
+    }
+
+    // Keep track of the maximum number of element design variables
+    int numDVs = elemTypes[t]->getDesignVarNums(typeFirstElem[t], 0, NULL);
+    if (numDVs > maxElementDesignVars) {
+      maxElementDesignVars = numDVs;
+    }
+  }
+
+  delete[] typeCounts;
+  delete[] typeFirstElem;
+
+  // Fully fix the boundary condition nodes within the ownership range
+  if (numBCNodes > 0 && bcNodes) {
+    const int *ownerRange;
+    nodeMap->getOwnerRange(&ownerRange);
+
+    for (int i = 0; i < numBCNodes; i++) {
+      if (bcNodes[i] >= ownerRange[mpiRank] &&
+          bcNodes[i] < ownerRange[mpiRank + 1]) {
+        bcMap->addBC(bcNodes[i], varsPerNode, NULL, NULL);
+      }
+    }
+  }
+
+  // Initialize the mesh
+  if (initialize()) {
+    return 1;
+  }
+
+  // Set the node locations for the locally owned nodes
+  if (Xpts) {
+    TACSBVec *X = createNodeVec();
+    X->incref();
+
+    TacsScalar *xvals;
+    int size = X->getArray(&xvals);
+    memcpy(xvals, Xpts, size * sizeof(TacsScalar));
+
+    setNodes(X);
+    X->decref();
+  }
+
+  return 0;
+}
+
+/**
+  Declare that the trailing elements are halo replicas of elements
+  owned by neighboring processors.
+
+  This enables the redundant-compute assembly mode: the local element
+  list holds depth-1 element ghosts - copies of every off-processor
+  element that touches a locally owned node - appended after the owned
+  elements. Each processor then computes its own matrix and residual
+  rows entirely locally, and the reverse add exchange that normally
+  finishes assembleRes()/assembleJacobian() is skipped. The extra
+  element evaluations are typically a few percent of the assembly work,
+  while the removed synchronization dominates at large processor
+  counts.
+
+  The replicas are excluded from the energy, function and sensitivity
+  reductions so that each element is counted exactly once across the
+  communicator. Note that auxiliary elements (tractions etc.) must be
+  attached to the replicas as well as the owned copies, otherwise the
+  locally-computed rows are missing their contributions. The element
+  partition with the appended ghosts is produced by TACSCreator when
+  boundary element replication is enabled.
+
+  @param _numHaloElements The number of trailing halo element replicas
+  @return Fail flag indicating if a failure occured
+*/
+int TACSAssembler::setNumHaloElements(int _numHaloElements) {
+  if (_numHaloElements < 0 || _numHaloElements > numElements) {
+    fprintf(stderr,
+            "[%d] TACSAssembler: Halo element count %d out of range [0,%d]\n",
+            mpiRank, _numHaloElements, numElements);
+    return 1;
+  }
+  numHaloElements = _numHaloElements;
+  return 0;
+}
+
 /**
   Set the dependent node data structure
 
@@ -923,8 +1491,33 @@ void TACSAssembler::setNodes(TACSBVec *X) {
   // Distribute the values at this point
   xptVec->beginDistributeValues();
   xptVec->endDistributeValues();
+
+  // Bump the node version number and discard any geometry data cached
+  // by the elements, since it is now out of date
+  nodeVersion++;
+  if (elements) {
+    for (int i = 0; i < numElements; i++) {
+      elements[i]->invalidateGeometryCache();
+    }
+  }
+
+  // The cached element Jacobians and the cached auxiliary load
+  // vector depend on the node locations
+  cachedJacValid = 0;
+  auxLoadsValid = 0;
 }
 
+/**
+  Get the version number of the node location vector
+
+  The version number is incremented each time the node locations are
+  modified through setNodes(). It can be used to detect when data
+  computed from the node locations has become stale.
+
+  @return The node vector version number
+*/
+int TACSAssembler::getNodeVersion() { return nodeVersion; }
+
 /**
   Get the node locations from TACS
 
@@ -973,6 +1566,9 @@ void TACSAssembler::setAuxElements(TACSAuxElements *auxElems) {
   }
   auxElements = auxElems;
 
+  // The cached auxiliary load vector no longer matches the elements
+  auxLoadsValid = 0;
+
   // Check whether the auxiliary elements match
   if (auxElements) {
     int naux = 0;
@@ -1097,6 +1693,58 @@ int TACSAssembler::computeExtNodes() {
   return 0;
 }
 
+/**
+  Apply a partition-local RCM ordering automatically at initialize()
+
+  The layout of the solver-internal vectors and matrices follows the
+  global node numbering, so the cache behavior of the matrix-vector
+  products depends on how the mesh happens to be numbered. When this
+  flag is set, initialize() reorders the locally owned unknowns of
+  each processor with a reverse Cuthill-McKee ordering computed from
+  the local node-to-node connectivity, with the coupling unknowns
+  ordered last. This decouples the bandwidth of the assembled matrices
+  from the mesh numbering without any further involvement from the
+  caller: the translation between the orderings is handled by the
+  existing reordering machinery (reorderVec(), reorderNodes() and the
+  reordering-aware output paths).
+
+  The flag has no effect when computeReordering() is called
+  explicitly, since only a single reordering can be applied.
+
+  @param flag Flag indicating whether to apply the automatic ordering
+*/
+void TACSAssembler::setAutoLocalOrdering(int flag) {
+  autoLocalOrdering = flag;
+}
+
+/**
+  Enable or disable the Lagrange multiplier ordering
+
+  The kinematic constraint and rigid-body elements introduce Lagrange
+  multiplier unknowns whose diagonal block of the Jacobian is
+  zero. When such a node is eliminated before the nodes it constrains,
+  the zero block reaches the diagonal inversion and the incomplete
+  factorization used by the TACSParallelMat preconditioners breaks
+  down, forcing a fallback to the serial direct solver. When this flag
+  is set, computeReordering() refines the computed ordering so that
+  each multiplier node is numbered directly after the last of its
+  independent nodes. Eliminating the independent nodes first fills the
+  multiplier diagonal block with its Schur complement contribution,
+  and the row pivoting within the block inversion handles the
+  indefinite block structure of the constrained node/multiplier
+  pair. The refinement only permutes the locally owned nodes, so the
+  parallel matrix structure is unchanged.
+
+  The flag must be set before computeReordering() is called. It has
+  no effect on the Gauss-Seidel orderings, since moving the
+  multiplier nodes would break the multicolor structure.
+
+  @param flag Non-zero to order multipliers after their independent nodes
+*/
+void TACSAssembler::setLagrangeMultiplierOrdering(int flag) {
+  useMultiplierOrdering = flag;
+}
+
 /**
   Compute a reordering of the nodes.
 
@@ -1443,6 +2091,14 @@ void TACSAssembler::computeReordering(OrderingType order_type,
     delete[] reducedNodes;
   }
 
+  // If requested, refine the ordering of the locally owned nodes so
+  // that each Lagrange multiplier node is eliminated directly after
+  // its independent nodes - see setLagrangeMultiplierOrdering()
+  if (useMultiplierOrdering && numMultiplierNodes > 0 &&
+      mat_type != GAUSS_SEIDEL) {
+    reorderMultiplierNodes(newNodeNums);
+  }
+
   // So now we have new node numbers for the nodes owned by this
   // processor, but the other processors do not have these new numbers
   // yet. Find the values assigned to the nodes requested from
@@ -1536,27 +2192,383 @@ void TACSAssembler::computeReordering(OrderingType order_type,
   delete[] recvNodes;
 }
 
-/**
-  Compute the reordering for the given matrix.
-
-  This uses either Reverse Cuthill-McKee (RCM_ORDER), Approximate
-  Minimum Degree (AMD) or Nested Disection (ND) to compute a
-  reordering of the variables.
-
-  The input to the function is a CSR-type data structure of the
-  matrix. Note that for ND (with the external package Metis), requires
-  that the diagonal be eliminated from the CSR data structure. (This
-  modified data structure can be computed with the no_diagonal flag
-  when calling the CSR creation routines.)
-
-  The matrix ordering routines compute a reordering such that:
+/*
+  Refine the new node numbers so that each Lagrange multiplier node
+  is numbered directly after the last of its independent nodes.
+
+  The refinement operates on the locally owned portion of the
+  ordering only. The non-multiplier nodes are compacted without
+  changing their relative order, and each owned multiplier is
+  re-inserted immediately after the independent node of its
+  constraint that is eliminated last. Multipliers whose independent
+  nodes are all owned by other processes are left in place - these
+  are coupling nodes that are handled by the parallel matrix
+  ordering itself.
+*/
+void TACSAssembler::reorderMultiplierNodes(int *newNodeNums) {
+  // Compute the multiplier node numbers and their connectivity
+  int num_multipliers = 0;
+  int *multipliers = NULL;
+  int *indep_ptr = NULL;
+  int *indep_nodes = NULL;
+  computeMultiplierConn(&num_multipliers, &multipliers, &indep_ptr,
+                        &indep_nodes);
+  if (num_multipliers == 0) {
+    return;
+  }
 
-  P*A*P^{T} has fewer non-zeros.
+  // Get the ownership offset for this processor
+  const int *ownerRange;
+  nodeMap->getOwnerRange(&ownerRange);
+  int offset = ownerRange[mpiRank];
+
+  // Flag the multiplier nodes so that one multiplier cannot anchor
+  // the position of another
+  int *mult_flag = new int[numNodes];
+  memset(mult_flag, 0, numNodes * sizeof(int));
+  for (int i = 0; i < num_multipliers; i++) {
+    mult_flag[multipliers[i]] = 1;
+  }
+
+  // Compute the local node at each position of the owned portion of
+  // the new ordering
+  int *pos_to_node = new int[numOwnedNodes];
+  for (int i = extNodeOffset; i < extNodeOffset + numOwnedNodes; i++) {
+    pos_to_node[newNodeNums[i] - offset] = i;
+  }
+
+  // For each owned multiplier, find the position of the last of its
+  // owned independent nodes. The multiplier is re-inserted directly
+  // after this anchor position.
+  int *anchor_ptr = new int[numOwnedNodes + 1];
+  memset(anchor_ptr, 0, (numOwnedNodes + 1) * sizeof(int));
+
+  int *anchor = new int[num_multipliers];
+  for (int i = 0; i < num_multipliers; i++) {
+    anchor[i] = -1;
+    int node = multipliers[i];
+    if (node >= extNodeOffset && node < extNodeOffset + numOwnedNodes) {
+      for (int jp = indep_ptr[i]; jp < indep_ptr[i + 1]; jp++) {
+        int indep = indep_nodes[jp];
+        if (indep >= extNodeOffset &&
+            indep < extNodeOffset + numOwnedNodes && !mult_flag[indep]) {
+          int pos = newNodeNums[indep] - offset;
+          if (pos > anchor[i]) {
+            anchor[i] = pos;
+          }
+        }
+      }
+      if (anchor[i] >= 0) {
+        anchor_ptr[anchor[i] + 1]++;
+      }
+    }
+  }
 
-  The function returns an array new_vars such that:
+  // Build the CSR-like structure of the multipliers at each anchor
+  // position
+  for (int i = 0; i < numOwnedNodes; i++) {
+    anchor_ptr[i + 1] += anchor_ptr[i];
+  }
+  int *anchor_mults = new int[anchor_ptr[numOwnedNodes]];
+  for (int i = 0; i < num_multipliers; i++) {
+    if (anchor[i] >= 0) {
+      anchor_mults[anchor_ptr[anchor[i]]] = multipliers[i];
+      anchor_ptr[anchor[i]]++;
+    }
+  }
 
-  new_vars = P^{T} old_vars
-  perm = P
+  // Reset the pointer array
+  for (int i = numOwnedNodes; i > 0; i--) {
+    anchor_ptr[i] = anchor_ptr[i - 1];
+  }
+  anchor_ptr[0] = 0;
+
+  // Record which of the multiplier nodes are re-inserted. The anchor
+  // nodes are never multipliers, so every anchor keeps its place in
+  // the compacted ordering.
+  int *moved = new int[numNodes];
+  memset(moved, 0, numNodes * sizeof(int));
+  for (int i = 0; i < num_multipliers; i++) {
+    if (anchor[i] >= 0) {
+      moved[multipliers[i]] = 1;
+    }
+  }
+
+  // Re-number the owned nodes: the nodes that stay keep their
+  // relative order and each re-inserted multiplier follows its
+  // anchor node
+  int count = 0;
+  for (int pos = 0; pos < numOwnedNodes; pos++) {
+    int node = pos_to_node[pos];
+    if (!moved[node]) {
+      newNodeNums[node] = offset + count;
+      count++;
+    }
+    for (int jp = anchor_ptr[pos]; jp < anchor_ptr[pos + 1]; jp++) {
+      newNodeNums[anchor_mults[jp]] = offset + count;
+      count++;
+    }
+  }
+
+  delete[] multipliers;
+  delete[] indep_ptr;
+  delete[] indep_nodes;
+  delete[] mult_flag;
+  delete[] pos_to_node;
+  delete[] anchor;
+  delete[] anchor_ptr;
+  delete[] anchor_mults;
+  delete[] moved;
+}
+
+/**
+  Compute a reordering of the elements to improve cache reuse.
+
+  The node reordering computed by computeReordering() reduces the
+  matrix fill-in, but does not change the order in which the elements
+  are visited during assembly. This function renumbers the local
+  elements using a breadth-first traversal of the element graph, in
+  which two elements are adjacent when they share a node. Consecutive
+  elements in the new ordering therefore reference overlapping node
+  data, which improves the cache reuse of the variable and node
+  location arrays within the assembly loops.
+
+  The element numbering is process-local so no communication is
+  required. This function must be called after the element
+  connectivity (and the elements, if they are used) are set, but
+  before the call to initialize() and before any objects that
+  reference the element numbers - such as the auxiliary elements - are
+  created. The mapping from the old to the new element numbers can be
+  retrieved with getElementReordering().
+
+  When the group_by_constitutive flag is set, the traversal order is
+  refined so that the elements that share a constitutive object are
+  visited consecutively. Constitutive objects that are shared across
+  many elements cache state that depends only on the design variables
+  - such as the stiffener stiffness computed by the blade-stiffened
+  shell constitutive - and grouping the elements keeps that state hot
+  in cache across the constitutive's whole element set. The grouping
+  is stable: the groups appear in the order of the traversal and the
+  elements keep their traversal order within each group, so the
+  spatial locality of the ordering is preserved inside every group.
+
+  @param group_by_constitutive Group elements by constitutive object
+*/
+void TACSAssembler::computeElementReordering(int group_by_constitutive) {
+  if (!elementNodeIndex) {
+    fprintf(stderr,
+            "[%d] Must define element connectivity before the element "
+            "reordering\n",
+            mpiRank);
+    return;
+  }
+  if (meshInitializedFlag) {
+    fprintf(stderr,
+            "[%d] Cannot call computeElementReordering() after initialize()\n",
+            mpiRank);
+    return;
+  }
+  if (auxElements) {
+    fprintf(stderr,
+            "[%d] Cannot call computeElementReordering() after the auxiliary "
+            "elements are set\n",
+            mpiRank);
+    return;
+  }
+  if (newElementNums) {
+    fprintf(
+        stderr,
+        "[%d] TACSAssembler::computeElementReordering() can only be called "
+        "once\n",
+        mpiRank);
+    return;
+  }
+
+  // Compress the node numbers referenced by the connectivity into a
+  // contiguous index. The dependent nodes (stored as negative
+  // entries) are kept as keys of their own: two elements that share a
+  // dependent node also share its data during the assembly.
+  int conn_size = elementNodeIndex[numElements];
+  int *node_keys = new int[conn_size];
+  memcpy(node_keys, elementTacsNodes, conn_size * sizeof(int));
+  int nnodes = TacsUniqueSort(conn_size, node_keys);
+
+  // Count up the number of elements referencing each node
+  int *nodeElementPtr = new int[nnodes + 1];
+  memset(nodeElementPtr, 0, (nnodes + 1) * sizeof(int));
+  for (int i = 0; i < conn_size; i++) {
+    int *item = TacsSearchArray(elementTacsNodes[i], nnodes, node_keys);
+    nodeElementPtr[(item - node_keys) + 1]++;
+  }
+  for (int i = 0; i < nnodes; i++) {
+    nodeElementPtr[i + 1] += nodeElementPtr[i];
+  }
+
+  // Fill in the node -> element data structure
+  int *nodeToElements = new int[conn_size];
+  for (int i = 0; i < numElements; i++) {
+    int end = elementNodeIndex[i + 1];
+    for (int jp = elementNodeIndex[i]; jp < end; jp++) {
+      int *item = TacsSearchArray(elementTacsNodes[jp], nnodes, node_keys);
+      int node = item - node_keys;
+      nodeToElements[nodeElementPtr[node]] = i;
+      nodeElementPtr[node]++;
+    }
+  }
+  for (int i = 0; i < nnodes; i++) {
+    nodeElementPtr[nnodes - i] = nodeElementPtr[nnodes - i - 1];
+  }
+  nodeElementPtr[0] = 0;
+
+  // Perform a breadth-first traversal of the element graph. Each
+  // element is visited exactly once, and the queue doubles as the
+  // list of elements sorted in the new traversal order.
+  int *queue = new int[numElements];
+  int *visited = new int[numElements];
+  memset(visited, 0, numElements * sizeof(int));
+
+  int nqueue = 0;
+  int head = 0;
+  for (int seed = 0; seed < numElements; seed++) {
+    if (visited[seed]) {
+      continue;
+    }
+    visited[seed] = 1;
+    queue[nqueue++] = seed;
+
+    // Add the unvisited elements adjacent to each queued element
+    while (head < nqueue) {
+      int elem = queue[head++];
+      int end = elementNodeIndex[elem + 1];
+      for (int jp = elementNodeIndex[elem]; jp < end; jp++) {
+        int *item = TacsSearchArray(elementTacsNodes[jp], nnodes, node_keys);
+        int node = item - node_keys;
+        for (int kp = nodeElementPtr[node]; kp < nodeElementPtr[node + 1];
+             kp++) {
+          int next = nodeToElements[kp];
+          if (!visited[next]) {
+            visited[next] = 1;
+            queue[nqueue++] = next;
+          }
+        }
+      }
+    }
+  }
+
+  delete[] node_keys;
+  delete[] nodeElementPtr;
+  delete[] nodeToElements;
+  delete[] visited;
+
+  // Refine the traversal so that the elements sharing a constitutive
+  // object are visited consecutively. The stable counting sort keeps
+  // the traversal order within each group.
+  if (group_by_constitutive && elements) {
+    // Assign a group number to each element based on its constitutive
+    // object. The groups are numbered in order of first appearance in
+    // the traversal. The number of distinct constitutive objects is
+    // small, so a linear scan over the groups is sufficient.
+    int *group = new int[numElements];
+    TACSConstitutive **group_con = new TACSConstitutive *[numElements];
+    int num_groups = 0;
+    for (int k = 0; k < numElements; k++) {
+      TACSConstitutive *con = elements[queue[k]]->getConstitutive();
+      int g = 0;
+      while (g < num_groups && group_con[g] != con) {
+        g++;
+      }
+      if (g == num_groups) {
+        group_con[num_groups] = con;
+        num_groups++;
+      }
+      group[k] = g;
+    }
+
+    if (num_groups > 1) {
+      // Count the number of elements in each group
+      int *count = new int[num_groups + 1];
+      memset(count, 0, (num_groups + 1) * sizeof(int));
+      for (int k = 0; k < numElements; k++) {
+        count[group[k] + 1]++;
+      }
+      for (int g = 0; g < num_groups; g++) {
+        count[g + 1] += count[g];
+      }
+
+      // Sort the queued elements by their group number
+      int *sorted = new int[numElements];
+      for (int k = 0; k < numElements; k++) {
+        sorted[count[group[k]]] = queue[k];
+        count[group[k]]++;
+      }
+      memcpy(queue, sorted, numElements * sizeof(int));
+
+      delete[] sorted;
+      delete[] count;
+    }
+
+    delete[] group;
+    delete[] group_con;
+  }
+
+  // Invert the traversal to obtain the old -> new element numbers
+  newElementNums = new int[numElements];
+  for (int k = 0; k < numElements; k++) {
+    newElementNums[queue[k]] = k;
+  }
+
+  // Apply the permutation to the element objects. The references are
+  // moved, not copied, so the reference counts are unchanged.
+  if (elements) {
+    TACSElement **elems = new TACSElement *[numElements];
+    for (int k = 0; k < numElements; k++) {
+      elems[k] = elements[queue[k]];
+    }
+    delete[] elements;
+    elements = elems;
+  }
+
+  // Apply the permutation to the element connectivity
+  int *nodeIndex = new int[numElements + 1];
+  int *tacsNodes = new int[conn_size];
+  nodeIndex[0] = 0;
+  for (int k = 0; k < numElements; k++) {
+    int elem = queue[k];
+    int ptr = elementNodeIndex[elem];
+    int len = elementNodeIndex[elem + 1] - ptr;
+    memcpy(&tacsNodes[nodeIndex[k]], &elementTacsNodes[ptr],
+           len * sizeof(int));
+    nodeIndex[k + 1] = nodeIndex[k] + len;
+  }
+  delete[] elementNodeIndex;
+  delete[] elementTacsNodes;
+  elementNodeIndex = nodeIndex;
+  elementTacsNodes = tacsNodes;
+
+  delete[] queue;
+}
+
+/**
+  Compute the reordering for the given matrix.
+
+  This uses either Reverse Cuthill-McKee (RCM_ORDER), Approximate
+  Minimum Degree (AMD) or Nested Disection (ND) to compute a
+  reordering of the variables.
+
+  The input to the function is a CSR-type data structure of the
+  matrix. Note that for ND (with the external package Metis), requires
+  that the diagonal be eliminated from the CSR data structure. (This
+  modified data structure can be computed with the no_diagonal flag
+  when calling the CSR creation routines.)
+
+  The matrix ordering routines compute a reordering such that:
+
+  P*A*P^{T} has fewer non-zeros.
+
+  The function returns an array new_vars such that:
+
+  new_vars = P^{T} old_vars
+  perm = P
 
   @param order_type The ordering type
   @param nvars The number of variables
@@ -1874,6 +2886,179 @@ void TACSAssembler::computeNodeToElementCSR(int **_nodeElementPtr,
   *_nodeElementPtr = nodeElementPtr;
 }
 
+/*
+  Compute a greedy distance-1 coloring of the element graph.
+
+  Two elements are adjacent if they share a local node, where the
+  dependent nodes are expanded into their independent nodes. Elements
+  with the same color therefore have disjoint node sets, and all the
+  elements within a single color can scatter their contributions into
+  the matrix and residual concurrently without any locking.
+
+  The coloring is stored as a CSR-style structure: the elements sorted
+  by color in elementColorList, with elementColorPtr pointing to the
+  start of each color. Elements within each color remain in ascending
+  order so that the sorted auxiliary element list can still be scanned
+  incrementally.
+*/
+void TACSAssembler::computeElementColoring() {
+  // Create the node -> element data structure. Note that this expands
+  // the dependent nodes into their independent node sets.
+  int *nodeElementPtr = NULL;
+  int *nodeToElements = NULL;
+  computeNodeToElementCSR(&nodeElementPtr, &nodeToElements);
+
+  // Get the dependent node connectivity information
+  const int *depNodePtr = NULL;
+  const int *depNodeConn = NULL;
+  if (depNodes) {
+    depNodes->getDepNodes(&depNodePtr, &depNodeConn, NULL);
+  }
+
+  // The color assigned to each element
+  int *colors = new int[numElements];
+  for (int i = 0; i < numElements; i++) {
+    colors[i] = -1;
+  }
+
+  // colorMark[c] == i indicates that color c is already used by an
+  // element adjacent to element i
+  int *colorMark = new int[numElements + 1];
+  for (int i = 0; i < numElements + 1; i++) {
+    colorMark[i] = -1;
+  }
+
+  numElementColors = 0;
+  for (int i = 0; i < numElements; i++) {
+    // Mark the colors of all the elements that share a node with
+    // element i
+    int jend = elementNodeIndex[i + 1];
+    for (int jp = elementNodeIndex[i]; jp < jend; jp++) {
+      int node = elementTacsNodes[jp];
+      if (node >= 0) {
+        node = getLocalNodeNum(node);
+        for (int kp = nodeElementPtr[node]; kp < nodeElementPtr[node + 1];
+             kp++) {
+          int elem = nodeToElements[kp];
+          if (colors[elem] >= 0) {
+            colorMark[colors[elem]] = i;
+          }
+        }
+      } else {
+        // This is a dependent node - mark the elements attached to
+        // each of its independent nodes
+        int dep_node = -node - 1;
+        int pend = depNodePtr[dep_node + 1];
+        for (int pp = depNodePtr[dep_node]; pp < pend; pp++) {
+          node = getLocalNodeNum(depNodeConn[pp]);
+          for (int kp = nodeElementPtr[node]; kp < nodeElementPtr[node + 1];
+               kp++) {
+            int elem = nodeToElements[kp];
+            if (colors[elem] >= 0) {
+              colorMark[colors[elem]] = i;
+            }
+          }
+        }
+      }
+    }
+
+    // Assign the smallest color not used by any adjacent element
+    int c = 0;
+    while (colorMark[c] == i) {
+      c++;
+    }
+    colors[i] = c;
+    if (c + 1 > numElementColors) {
+      numElementColors = c + 1;
+    }
+  }
+
+  delete[] colorMark;
+  delete[] nodeElementPtr;
+  delete[] nodeToElements;
+
+  // Bucket the elements by color. Since the elements are visited in
+  // ascending order, each color's element list is sorted.
+  elementColorPtr = new int[numElementColors + 1];
+  memset(elementColorPtr, 0, (numElementColors + 1) * sizeof(int));
+  for (int i = 0; i < numElements; i++) {
+    elementColorPtr[colors[i] + 1]++;
+  }
+  for (int c = 0; c < numElementColors; c++) {
+    elementColorPtr[c + 1] += elementColorPtr[c];
+  }
+
+  elementColorList = new int[numElements];
+  for (int i = 0; i < numElements; i++) {
+    elementColorList[elementColorPtr[colors[i]]] = i;
+    elementColorPtr[colors[i]]++;
+  }
+
+  // Reset the pointer array
+  for (int c = numElementColors; c > 0; c--) {
+    elementColorPtr[c] = elementColorPtr[c - 1];
+  }
+  elementColorPtr[0] = 0;
+
+  delete[] colors;
+}
+
+/*
+  Compute the interior/boundary element split.
+
+  A boundary element is an element with at least one node that is
+  owned by another processor, or a dependent node (whose value may
+  depend on externally owned nodes). The values at the nodes of the
+  interior elements are not modified by the distribution of the state
+  variables, so these elements can be integrated while the halo
+  exchange started by setVariables() is still in flight. The boundary
+  elements are processed after the exchange has completed.
+*/
+void TACSAssembler::computeBoundaryElements() {
+  // Get the ownership range of the nodes
+  const int *ownerRange;
+  nodeMap->getOwnerRange(&ownerRange);
+  int lower = ownerRange[mpiRank];
+  int upper = ownerRange[mpiRank + 1];
+
+  elementBoundaryFlag = new int[numElements];
+  for (int i = 0; i < numElements; i++) {
+    elementBoundaryFlag[i] = 0;
+    int jend = elementNodeIndex[i + 1];
+    for (int jp = elementNodeIndex[i]; jp < jend; jp++) {
+      int node = elementTacsNodes[jp];
+      if (node < lower || node >= upper) {
+        // The node is either externally owned or dependent
+        elementBoundaryFlag[i] = 1;
+        break;
+      }
+    }
+  }
+}
+
+/*
+  Complete any outstanding distribution of the state variables that
+  was started by setVariables().
+
+  This is called before the external variable values are used - either
+  directly before the values are accessed, or between the interior and
+  boundary element loops within the assembly routines.
+*/
+void TACSAssembler::finishDistributingVariables() {
+  if (pendingVarsDist) {
+    if (pendingVarsDist & 1) {
+      varsVec->endDistributeValues();
+    }
+    if (pendingVarsDist & 2) {
+      dvarsVec->endDistributeValues();
+    }
+    if (pendingVarsDist & 4) {
+      ddvarsVec->endDistributeValues();
+    }
+    pendingVarsDist = 0;
+  }
+}
+
 /**
   Set up a CSR data structure pointing from local nodes to other
   local nodes.
@@ -2499,6 +3684,88 @@ int TACSAssembler::computeCouplingElements(int **_couplingElems) {
   return numCouplingElems;
 }
 
+/**
+  Compute the local nodes that can be statically condensed.
+
+  A node that is referenced by exactly one element can be eliminated
+  without creating any fill outside the clique formed by the other
+  nodes of that element - entries that the element matrix contributes
+  anyway. Eliminating these nodes first in the factorization is
+  therefore equivalent to exact element-level static condensation of
+  the element-interior degrees of freedom. Nodes that couple to other
+  processors and Lagrange multiplier nodes are excluded: the former
+  must remain in the global interface system and the latter have a
+  zero diagonal block and cannot be pivoted on first.
+
+  @param _condNodes The sorted local node numbers of condensable nodes
+  @return The number of condensable nodes
+*/
+int TACSAssembler::computeCondensableNodes(int **_condNodes) {
+  // Count the number of element references for each local node
+  int *refCount = new int[numNodes];
+  memset(refCount, 0, numNodes * sizeof(int));
+
+  for (int i = 0; i < numElements; i++) {
+    int jend = elementNodeIndex[i + 1];
+    for (int jp = elementNodeIndex[i]; jp < jend; jp++) {
+      int node = elementTacsNodes[jp];
+
+      // Skip the dependent nodes - they are constrained to other
+      // nodes and cannot be eliminated independently
+      if (node >= 0) {
+        node = getLocalNodeNum(node);
+        refCount[node]++;
+      }
+    }
+  }
+
+  // Nodes that are referenced from other processors must remain in
+  // the global interface system
+  int *couplingNodes;
+  int numCouplingNodes = computeCouplingNodes(&couplingNodes);
+  for (int i = 0; i < numCouplingNodes; i++) {
+    refCount[couplingNodes[i]] = 0;
+  }
+  delete[] couplingNodes;
+
+  // Exclude the Lagrange multiplier nodes
+  int num_multipliers = 0;
+  int *multipliers = NULL;
+  int *indep_ptr = NULL;
+  int *indep_nodes = NULL;
+  computeMultiplierConn(&num_multipliers, &multipliers, &indep_ptr,
+                        &indep_nodes);
+  if (multipliers) {
+    for (int i = 0; i < num_multipliers; i++) {
+      refCount[multipliers[i]] = 0;
+    }
+    delete[] multipliers;
+    delete[] indep_ptr;
+    delete[] indep_nodes;
+  }
+
+  // Count and collect the nodes referenced by exactly one element
+  int numCondNodes = 0;
+  for (int i = 0; i < numNodes; i++) {
+    if (refCount[i] == 1) {
+      numCondNodes++;
+    }
+  }
+
+  int *condNodes = new int[numCondNodes];
+  numCondNodes = 0;
+  for (int i = 0; i < numNodes; i++) {
+    if (refCount[i] == 1) {
+      condNodes[numCondNodes] = i;
+      numCondNodes++;
+    }
+  }
+  delete[] refCount;
+
+  *_condNodes = condNodes;
+  return numCondNodes;
+}
+
 /**
   The function initialize performs a number of synchronization
   tasks that prepare the finite-element model for use.
@@ -2534,6 +3801,12 @@ int TACSAssembler::initialize() {
     return 1;
   }
 
+  // Apply the automatic partition-local ordering, unless an explicit
+  // reordering has already been computed
+  if (autoLocalOrdering && !tacsExtNodeNums) {
+    computeReordering(RCM_ORDER, DIRECT_SCHUR);
+  }
+
   // If the external nodes have not been computed, compute them now...
   if (!tacsExtNodeNums) {
     computeExtNodes();
@@ -2606,9 +3879,18 @@ int TACSAssembler::initialize() {
   } else {
     dataSize += maxElementSize * maxElementSize;
   }
-  elementData = new TacsScalar[dataSize];
+  elementDataSize = dataSize;
+
+  // An extra element-matrix-size block is allocated past the layout
+  // handed out by getDataPointers(). This block is used as scratch
+  // for the scaled auxiliary element contributions and the element
+  // matrix diagonal, so that the assembly code paths do not allocate
+  // memory inside their element loops.
+  elementData =
+      new TacsScalar[elementDataSize + maxElementSize * maxElementSize];
 
   int idataSize = maxElementIndepNodes + maxElementNodes + 1;
+  elementIDataSize = idataSize;
   elementIData = new int[idataSize];
 
   // Allocate memory for the design variable data
@@ -2722,64 +4004,288 @@ int TACSAssembler::initialize() {
     designExtDist->incref();
   }
 
+  // Resolve the element node indices into direct vector offsets for
+  // the assembly loops
+  computeVecPlan();
+
+  // Resolve the element design variable numbers into direct offsets
+  // for the gradient accumulation
+  computeDVPlan();
+
   return 0;
 }
 
 /*
-  Check the element Jacobian entries at each quadrature point to
-  see if they are positive. The code prints the rank and element
-  index on that rank if the check fails.
+  Resolve the element node indices into direct storage offsets.
+
+  Every entry of elementTacsNodes is classified once - locally owned,
+  dependent or external - and converted to a node-unit offset into the
+  corresponding storage of a TACSBVec created by this assembler. The
+  assembly loops then gather and scatter element values through the
+  plan with contiguous block copies, rather than re-testing the
+  ownership range and searching the external indices for every node of
+  every element on every call.
+
+  The plan encoding is: values in [0, numOwnedNodes) index the owned
+  array, values >= numOwnedNodes index the external array, and
+  negative values retain the dependent-node encoding -(dep + 1).
 */
-void TACSAssembler::checkElementDeterminants() {
-  if (elements) {
-    TacsScalar *vars, *dvars, *ddvars;
-    TacsScalar *elemXpts;
-    getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts, NULL,
-                    NULL, NULL);
-
-    for (int elemIndex = 0; elemIndex < numElements; elemIndex++) {
-      TACSElement *element = elements[elemIndex];
+void TACSAssembler::computeVecPlan() {
+  // Get the ownership range
+  const int *ownerRange;
+  nodeMap->getOwnerRange(&ownerRange);
+  int lower = ownerRange[mpiRank];
+  int upper = ownerRange[mpiRank + 1];
+
+  int size = elementNodeIndex[numElements];
+  vecPlan = new int[size];
+
+  for (int j = 0; j < size; j++) {
+    int node = elementTacsNodes[j];
+    if (node >= lower && node < upper) {
+      vecPlan[j] = node - lower;
+    } else if (node < 0) {
+      // Keep the dependent-node encoding
+      vecPlan[j] = node;
+    } else {
+      vecPlan[j] = numOwnedNodes + extDistIndices->findIndex(node);
+    }
+  }
+}
 
-      // Determine the values of the state variables for the
-      // current element
-      int ptr = elementNodeIndex[elemIndex];
-      int len = elementNodeIndex[elemIndex + 1] - ptr;
-      const int *nodes = &elementTacsNodes[ptr];
-      xptVec->getValues(len, nodes, elemXpts);
-      varsVec->getValues(len, nodes, vars);
-      dvarsVec->getValues(len, nodes, dvars);
-      ddvarsVec->getValues(len, nodes, ddvars);
+/*
+  Gather the element values from the vector through the precomputed
+  plan. This is equivalent to calling vec->getValues() with the
+  element node numbers, but without the per-node index resolution.
+*/
+void TACSAssembler::getVecValuesPlan(TACSBVec *vec, int elem,
+                                     TacsScalar *vals) {
+  // Fall back to the index-based path for vectors that do not share
+  // the assembler's external index layout
+  if (!vecPlan || vec->getBVecIndices() != extDistIndices) {
+    int ptr = elementNodeIndex[elem];
+    int len = elementNodeIndex[elem + 1] - ptr;
+    vec->getBlockedValues(len, &elementTacsNodes[ptr], vals);
+    return;
+  }
 
-      for (int n = 0; n < element->getNumQuadraturePoints(); n++) {
-        double pt[3];
-        element->getQuadraturePoint(n, pt);
+  TacsScalar *x = NULL, *x_ext = NULL, *x_dep = NULL;
+  vec->getArray(&x);
+  vec->getExtArray(&x_ext);
+  vec->getDepArray(&x_dep);
+  const int bs = vec->getBlockSize();
 
-        // Evaluate the pointwise element density
-        TacsScalar density = 0.0, detXd = 0.0;
-        int count = element->evalPointQuantity(elemIndex, TACS_ELEMENT_DENSITY,
-                                               time, n, pt, elemXpts, vars,
-                                               dvars, ddvars, &detXd, &density);
+  int jp = elementNodeIndex[elem];
+  int len = elementNodeIndex[elem + 1] - jp;
+  const int *plan = &vecPlan[jp];
 
-        if (count > 0) {
-          if (TacsRealPart(detXd) <= 0.0) {
-            printf(
-                "[%d] TACS Warning: Negative determinant of the Jacobian "
-                "transformation for element %d of type %s. Flipped mesh?",
-                mpiRank, elemIndex, element->getObjectName());
-          }
-        }
-      }
+  for (int j = 0; j < len; j++) {
+    const TacsScalar *y;
+    if (plan[j] >= numOwnedNodes) {
+      y = &x_ext[bs * (plan[j] - numOwnedNodes)];
+    } else if (plan[j] >= 0) {
+      y = &x[bs * plan[j]];
+    } else {
+      y = &x_dep[-bs * (plan[j] + 1)];
+    }
+    for (int k = 0; k < bs; k++, vals++) {
+      vals[0] = y[k];
     }
   }
 }
 
 /*
-  Scatter the boundary conditions that are shared between processors
+  Scatter-add the element values into the vector through the
+  precomputed plan. This is equivalent to calling vec->setValues()
+  with the element node numbers and TACS_ADD_VALUES.
+*/
+void TACSAssembler::addVecValuesPlan(TACSBVec *vec, int elem,
+                                     const TacsScalar *vals) {
+  // Fall back to the index-based path for vectors that do not share
+  // the assembler's external index layout
+  if (!vecPlan || vec->getBVecIndices() != extDistIndices) {
+    int ptr = elementNodeIndex[elem];
+    int len = elementNodeIndex[elem + 1] - ptr;
+    vec->setValues(len, &elementTacsNodes[ptr], vals, TACS_ADD_VALUES);
+    return;
+  }
 
-  Note that we do not need to scatter the values along with the
-  boundary condition values because the values are only used on the
-  processors which own the nodes (that already have the correct
-  information.)
+  TacsScalar *x = NULL, *x_ext = NULL, *x_dep = NULL;
+  vec->getArray(&x);
+  vec->getExtArray(&x_ext);
+  vec->getDepArray(&x_dep);
+  const int bs = vec->getBlockSize();
+
+  int jp = elementNodeIndex[elem];
+  int len = elementNodeIndex[elem + 1] - jp;
+  const int *plan = &vecPlan[jp];
+
+  for (int j = 0; j < len; j++) {
+    TacsScalar *y;
+    if (plan[j] >= numOwnedNodes) {
+      y = &x_ext[bs * (plan[j] - numOwnedNodes)];
+    } else if (plan[j] >= 0) {
+      y = &x[bs * plan[j]];
+    } else {
+      y = &x_dep[-bs * (plan[j] + 1)];
+    }
+    for (int k = 0; k < bs; k++, vals++) {
+      y[k] += vals[0];
+    }
+  }
+}
+
+/*
+  Resolve the element design variable numbers into direct storage
+  offsets.
+
+  This is the design variable counterpart of computeVecPlan(): the
+  design variable numbers of each element are classified once and
+  converted to offsets into the owned, external or dependent storage
+  of a design vector created by createDesignVec(). Since the number of
+  design variables varies from element to element, the plan is stored
+  in CSR form. The gradient accumulation in addDVSens() then scatters
+  through the plan, rather than searching the external design variable
+  indices for every entry of every element for every function.
+*/
+void TACSAssembler::computeDVPlan() {
+  // Get the ownership range of the design variables
+  const int *range;
+  designNodeMap->getOwnerRange(&range);
+  int lower = range[mpiRank];
+  int upper = range[mpiRank + 1];
+  numOwnedDesignVars = upper - lower;
+
+  // Get the external design variable indices
+  TACSBVecIndices *dvIndices = designExtDist->getIndices();
+
+  const int maxDVs = maxElementDesignVars;
+  int *dvNums = elementSensIData;
+
+  // Count the design variables of each element
+  dvPlanPtr = new int[numElements + 1];
+  dvPlanPtr[0] = 0;
+  for (int i = 0; i < numElements; i++) {
+    int numDVs = elements[i]->getDesignVarNums(i, maxDVs, dvNums);
+    dvPlanPtr[i + 1] = dvPlanPtr[i] + numDVs;
+  }
+
+  // Classify each design variable number
+  dvPlan = new int[dvPlanPtr[numElements]];
+  for (int i = 0; i < numElements; i++) {
+    int numDVs = elements[i]->getDesignVarNums(i, maxDVs, dvNums);
+    int *plan = &dvPlan[dvPlanPtr[i]];
+    for (int j = 0; j < numDVs; j++) {
+      int dv = dvNums[j];
+      if (dv >= lower && dv < upper) {
+        plan[j] = dv - lower;
+      } else if (dv < 0) {
+        // Keep the dependent design variable encoding
+        plan[j] = dv;
+      } else {
+        plan[j] = numOwnedDesignVars + dvIndices->findIndex(dv);
+      }
+    }
+  }
+}
+
+/*
+  Scatter-add the element design variable gradient into the design
+  vector through the precomputed plan. This is equivalent to calling
+  vec->setValues() with the element design variable numbers and
+  TACS_ADD_VALUES.
+*/
+void TACSAssembler::addDVValuesPlan(TACSBVec *vec, int elem, int numDVs,
+                                    const int *dvNums,
+                                    const TacsScalar *vals) {
+  // Fall back to the index-based path for vectors that do not share
+  // the assembler's external design variable layout
+  if (!dvPlan || vec->getBVecIndices() != designExtDist->getIndices() ||
+      numDVs != dvPlanPtr[elem + 1] - dvPlanPtr[elem]) {
+    vec->setValues(numDVs, dvNums, vals, TACS_ADD_VALUES);
+    return;
+  }
+
+  TacsScalar *x = NULL, *x_ext = NULL, *x_dep = NULL;
+  vec->getArray(&x);
+  vec->getExtArray(&x_ext);
+  vec->getDepArray(&x_dep);
+  const int bs = vec->getBlockSize();
+
+  const int *plan = &dvPlan[dvPlanPtr[elem]];
+
+  for (int j = 0; j < numDVs; j++) {
+    TacsScalar *y;
+    if (plan[j] >= numOwnedDesignVars) {
+      y = &x_ext[bs * (plan[j] - numOwnedDesignVars)];
+    } else if (plan[j] >= 0) {
+      y = &x[bs * plan[j]];
+    } else {
+      y = &x_dep[-bs * (plan[j] + 1)];
+    }
+    for (int k = 0; k < bs; k++, vals++) {
+      y[k] += vals[0];
+    }
+  }
+}
+
+/*
+  Check the element Jacobian entries at each quadrature point to
+  see if they are positive. The code prints the rank and element
+  index on that rank if the check fails.
+*/
+void TACSAssembler::checkElementDeterminants() {
+  finishDistributingVariables();
+
+  if (elements) {
+    TacsScalar *vars, *dvars, *ddvars;
+    TacsScalar *elemXpts;
+    getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts, NULL,
+                    NULL, NULL);
+
+    for (int elemIndex = 0; elemIndex < numElements; elemIndex++) {
+      TACSElement *element = elements[elemIndex];
+
+      // Determine the values of the state variables for the
+      // current element
+      int ptr = elementNodeIndex[elemIndex];
+      int len = elementNodeIndex[elemIndex + 1] - ptr;
+      const int *nodes = &elementTacsNodes[ptr];
+      xptVec->getBlockedValues(len, nodes, elemXpts);
+      varsVec->getBlockedValues(len, nodes, vars);
+      dvarsVec->getBlockedValues(len, nodes, dvars);
+      ddvarsVec->getBlockedValues(len, nodes, ddvars);
+
+      for (int n = 0; n < element->getNumQuadraturePoints(); n++) {
+        double pt[3];
+        element->getQuadraturePoint(n, pt);
+
+        // Evaluate the pointwise element density
+        TacsScalar density = 0.0, detXd = 0.0;
+        int count = element->evalPointQuantity(elemIndex, TACS_ELEMENT_DENSITY,
+                                               time, n, pt, elemXpts, vars,
+                                               dvars, ddvars, &detXd, &density);
+
+        if (count > 0) {
+          if (TacsRealPart(detXd) <= 0.0) {
+            printf(
+                "[%d] TACS Warning: Negative determinant of the Jacobian "
+                "transformation for element %d of type %s. Flipped mesh?",
+                mpiRank, elemIndex, element->getObjectName());
+          }
+        }
+      }
+    }
+  }
+}
+
+/*
+  Scatter the boundary conditions that are shared between processors
+
+  Note that we do not need to scatter the values along with the
+  boundary condition values because the values are only used on the
+  processors which own the nodes (that already have the correct
+  information.)
 
   This function is called during initialize()
 */
@@ -2914,6 +4420,69 @@ void TACSAssembler::getDataPointers(TacsScalar *data, TacsScalar **v1,
   }
 }
 
+/**
+  Get the scratch arrays owned by a worker thread.
+
+  Each worker thread in the pool owns one slot of the per-thread
+  scratch space, so the threaded assembly code performs no heap
+  allocation and requires no synchronization to obtain its working
+  arrays. The slot is allocated the first time the thread requests it
+  and is re-used by every subsequent assembly call. The scalar array
+  holds the element data layout used by getDataPointers() plus an
+  extra element-matrix-size block for the scaled auxiliary element
+  contributions.
+
+  @param threadId The worker slot index from the thread pool
+  @param data The scalar scratch array for this thread (output)
+  @param idata The index scratch array for this thread (output)
+*/
+void TACSAssembler::getThreadDataPointers(int threadId, TacsScalar **data,
+                                          int **idata) {
+  if (!threadElementData[threadId]) {
+    threadElementData[threadId] =
+        new TacsScalar[elementDataSize + maxElementSize * maxElementSize];
+    threadElementIData[threadId] = new int[elementIDataSize];
+  }
+  *data = threadElementData[threadId];
+  *idata = threadElementIData[threadId];
+}
+
+/**
+  Get the scratch arrays for the per-function data.
+
+  These arrays are used by the code that evaluates all functions in a
+  single sweep over the elements. The space is grown whenever a larger
+  number of functions is requested and is then re-used, so that no
+  heap allocation occurs in the steady-state function-evaluation and
+  adjoint code paths.
+
+  @param numFuncs The number of functions
+  @param subDomains The array of sub-domain element lists (output)
+  @param subDomainSizes The size of each sub-domain list (output)
+  @param cursors The cursor into each sub-domain list (output)
+  @param active The flags marking the active functions (output)
+*/
+void TACSAssembler::getFunctionDataPointers(int numFuncs,
+                                            const int ***subDomains,
+                                            int **subDomainSizes, int **cursors,
+                                            int **active) {
+  if (numFuncs > maxNumFuncs) {
+    if (funcSubDomains) {
+      delete[] funcSubDomains;
+    }
+    if (funcIData) {
+      delete[] funcIData;
+    }
+    funcSubDomains = new const int *[numFuncs];
+    funcIData = new int[3 * numFuncs];
+    maxNumFuncs = numFuncs;
+  }
+  *subDomains = funcSubDomains;
+  *subDomainSizes = &funcIData[0];
+  *cursors = &funcIData[maxNumFuncs];
+  *active = &funcIData[2 * maxNumFuncs];
+}
+
 /**
   Check whether a reordering has been applied to the nodes
 
@@ -2941,6 +4510,22 @@ void TACSAssembler::getReordering(int *oldToNew) {
   }
 }
 
+/**
+  Get the ordering from the old element numbers to the new element
+  numbers computed by computeElementReordering()
+
+  @param oldToNew Array of size equal to the number of elements
+*/
+void TACSAssembler::getElementReordering(int *oldToNew) {
+  if (newElementNums) {
+    memcpy(oldToNew, newElementNums, numElements * sizeof(int));
+  } else {
+    for (int k = 0; k < numElements; k++) {
+      oldToNew[k] = k;
+    }
+  }
+}
+
 /**
   Reorder the vector using the reordering computed using the
   computeReordering() call.
@@ -3249,13 +4834,39 @@ void TACSAssembler::setDesignVars(TACSBVec *dvs) {
   TacsScalar *dvVals = elementSensData;
   int *dvNums = elementSensIData;
 
-  // Get the design variables from the auxiliary elements
+  // When incremental assembly is active, compare the new design
+  // variable values against the current ones and mark only the
+  // elements that actually change as dirty
+  TacsScalar *oldVals = NULL;
+  if (useIncrementalAssembly) {
+    if (!elementDirtyFlags) {
+      elementDirtyFlags = new int[numElements];
+      memset(elementDirtyFlags, 0, numElements * sizeof(int));
+    }
+    oldVals = new TacsScalar[designVarsPerNode * maxDVs];
+  }
+
+  // The cached linear-element matrices depend on the design variables
+  linearCacheValid = 0;
+
+  // Get the design variables from the auxiliary elements. The cached
+  // auxiliary load vector may depend on the design variables
+  auxLoadsValid = 0;
   if (auxElements) {
     TACSAuxElem *aux = NULL;
     int naux = auxElements->getAuxElements(&aux);
     for (int i = 0; i < naux; i++) {
       int numDVs = aux[i].elem->getDesignVarNums(aux[i].num, maxDVs, dvNums);
       dvs->getValues(numDVs, dvNums, dvVals);
+      if (oldVals && aux[i].num >= 0 && aux[i].num < numElements) {
+        aux[i].elem->getDesignVars(aux[i].num, numDVs, oldVals);
+        for (int k = 0; k < designVarsPerNode * numDVs; k++) {
+          if (dvVals[k] != oldVals[k]) {
+            elementDirtyFlags[aux[i].num] = 1;
+            break;
+          }
+        }
+      }
       aux[i].elem->setDesignVars(aux[i].num, maxDVs, dvVals);
     }
   }
@@ -3263,8 +4874,21 @@ void TACSAssembler::setDesignVars(TACSBVec *dvs) {
   for (int i = 0; i < numElements; i++) {
     int numDVs = elements[i]->getDesignVarNums(i, maxDVs, dvNums);
     dvs->getValues(numDVs, dvNums, dvVals);
+    if (oldVals) {
+      elements[i]->getDesignVars(i, numDVs, oldVals);
+      for (int k = 0; k < designVarsPerNode * numDVs; k++) {
+        if (dvVals[k] != oldVals[k]) {
+          elementDirtyFlags[i] = 1;
+          break;
+        }
+      }
+    }
     elements[i]->setDesignVars(i, numDVs, dvVals);
   }
+
+  if (oldVals) {
+    delete[] oldVals;
+  }
 }
 
 /**
@@ -3364,6 +4988,171 @@ void TACSAssembler::applyTransposeBCs(TACSMat *mat) {
 */
 void TACSAssembler::setBCs(TACSVec *vec) { vec->setBCs(bcMap); }
 
+/**
+  Compute a hash of the mesh topology for symbolic-structure caching.
+
+  The hash covers the element connectivity, the dependent node
+  connectivity and the node ordering - everything the node-to-node
+  CSR structure depends on - but not the node locations or design
+  variables, which change freely during shape optimization. The hash
+  is local to this process.
+
+  @return The hash of the local mesh topology
+*/
+uint32_t TACSAssembler::computeTopologyHash() {
+  // FNV-1a hash over the connectivity data
+  uint32_t hash = 2166136261u;
+
+  // Hash a sequence of integers into the current hash value
+  const uint32_t prime = 16777619u;
+  int header[4] = {numElements, numNodes, numDependentNodes, varsPerNode};
+  const int *arrays[4] = {header, elementNodeIndex, elementTacsNodes, NULL};
+  int lens[4] = {4, numElements + 1, 0, 0};
+  if (elementNodeIndex) {
+    lens[2] = elementNodeIndex[numElements];
+  }
+
+  // Include the dependent node connectivity if it is defined
+  const int *depPtr = NULL, *depConn = NULL;
+  if (depNodes) {
+    depNodes->getDepNodes(&depPtr, &depConn, NULL);
+    arrays[3] = depPtr;
+    lens[3] = numDependentNodes + 1;
+  }
+
+  for (int k = 0; k < 4; k++) {
+    const int *array = arrays[k];
+    for (int i = 0; i < lens[k]; i++) {
+      uint32_t value = (uint32_t)array[i];
+      hash = (hash ^ (value & 0xff)) * prime;
+      hash = (hash ^ ((value >> 8) & 0xff)) * prime;
+      hash = (hash ^ ((value >> 16) & 0xff)) * prime;
+      hash = (hash ^ ((value >> 24) & 0xff)) * prime;
+    }
+  }
+  if (depConn && depPtr) {
+    for (int i = 0; i < depPtr[numDependentNodes]; i++) {
+      uint32_t value = (uint32_t)depConn[i];
+      hash = (hash ^ (value & 0xff)) * prime;
+      hash = (hash ^ ((value >> 8) & 0xff)) * prime;
+      hash = (hash ^ ((value >> 16) & 0xff)) * prime;
+      hash = (hash ^ ((value >> 24) & 0xff)) * prime;
+    }
+  }
+
+  return hash;
+}
+
+/**
+  Retrieve the local node-to-node CSR structure, re-using the cached
+  symbolic structure when its topology hash matches.
+
+  On a cache hit the structure is copied out of the cache - stripping
+  the diagonal entries when requested - which is a streaming copy of
+  the pattern rather than the full sweep over the elements performed
+  by computeLocalNodeToNodeCSR(). The returned arrays are owned by the
+  caller. On a hash mismatch a warning is printed and the structure is
+  recomputed.
+
+  @param _rowp The row pointer into the columns array
+  @param _cols The column indices
+  @param nodiag Flag to exclude the diagonal entries
+*/
+void TACSAssembler::getSymbolicCSR(int **_rowp, int **_cols, int nodiag) {
+  if (symbolicStruct) {
+    if (symbolicStruct->getTopologyHash() == computeTopologyHash()) {
+      int num_nodes;
+      const int *crowp, *ccols;
+      symbolicStruct->getCSR(&num_nodes, &crowp, &ccols);
+
+      if (num_nodes == numNodes) {
+        int *rowp = new int[numNodes + 1];
+        int *cols = new int[crowp[numNodes]];
+
+        if (nodiag) {
+          // Copy the pattern, dropping the diagonal entries
+          int nnz = 0;
+          rowp[0] = 0;
+          for (int i = 0; i < numNodes; i++) {
+            for (int jp = crowp[i]; jp < crowp[i + 1]; jp++) {
+              if (ccols[jp] != i) {
+                cols[nnz] = ccols[jp];
+                nnz++;
+              }
+            }
+            rowp[i + 1] = nnz;
+          }
+        } else {
+          memcpy(rowp, crowp, (numNodes + 1) * sizeof(int));
+          memcpy(cols, ccols, crowp[numNodes] * sizeof(int));
+        }
+
+        *_rowp = rowp;
+        *_cols = cols;
+        return;
+      }
+    }
+
+    fprintf(stderr,
+            "[%d] TACSAssembler warning: Symbolic structure does not match "
+            "the mesh topology and will be ignored\n",
+            mpiRank);
+  }
+
+  computeLocalNodeToNodeCSR(_rowp, _cols, nodiag);
+}
+
+/**
+  Create a cacheable copy of the symbolic structure of this assembler.
+
+  The returned object captures the local node-to-node CSR pattern with
+  a hash of the mesh topology. Passing it to a subsequent assembler
+  with setSymbolicStructure() lets createMat() and createSchurMat()
+  skip the symbolic computation when the connectivity and ordering are
+  unchanged - the common case when the geometry is updated without
+  remeshing.
+
+  @return The symbolic structure for this assembler
+*/
+TACSSymbolicStructure *TACSAssembler::createSymbolicStructure() {
+  if (!meshInitializedFlag) {
+    fprintf(stderr,
+            "[%d] Cannot call createSymbolicStructure() before initialize()\n",
+            mpiRank);
+    return NULL;
+  }
+
+  // Re-use the cached structure itself when it is still valid
+  if (symbolicStruct &&
+      symbolicStruct->getTopologyHash() == computeTopologyHash()) {
+    return symbolicStruct;
+  }
+
+  int *rowp, *cols;
+  computeLocalNodeToNodeCSR(&rowp, &cols);
+
+  return new TACSSymbolicStructure(computeTopologyHash(), numNodes, &rowp,
+                                   &cols);
+}
+
+/**
+  Set the cached symbolic structure for this assembler.
+
+  The topology hash is verified whenever the structure is used; on a
+  mismatch the symbolic data is recomputed as if no cache were set.
+
+  @param structure The symbolic structure to re-use (may be NULL)
+*/
+void TACSAssembler::setSymbolicStructure(TACSSymbolicStructure *structure) {
+  if (structure) {
+    structure->incref();
+  }
+  if (symbolicStruct) {
+    symbolicStruct->decref();
+  }
+  symbolicStruct = structure;
+}
+
 /**
   Create a distributed matrix
 
@@ -3398,9 +5187,10 @@ TACSParallelMat *TACSAssembler::createMat() {
     parMatIndices->setUpInverse();
   }
 
-  // Compute the local connectivity
+  // Compute the local connectivity, or copy it from the cached
+  // symbolic structure when the mesh topology is unchanged
   int *rowp, *cols;
-  computeLocalNodeToNodeCSR(&rowp, &cols);
+  getSymbolicCSR(&rowp, &cols, 0);
 
   // Create the distributed matrix class
   TACSParallelMat *dmat = new TACSParallelMat(
@@ -3580,6 +5370,30 @@ void TACSAssembler::computeMultiplierConn(int *_num_multipliers,
   @param order_type Order the Schur matrix with this type of ordeirng
   @return A new TACSSchurMat matrix with zeroed entries
 */
+/**
+  Enable or disable the static condensation ordering
+
+  When enabled, createSchurMat() refines the AMD ordering so that the
+  condensable nodes - local nodes referenced by a single element - are
+  eliminated first. Eliminating such a node only fills in the clique
+  formed by the remaining nodes of its element, so the leading block
+  of the factorization performs exact element-level static
+  condensation of the element-interior degrees of freedom without
+  introducing any additional fill. This is most effective for
+  high-order meshes where the interior nodes make up a large fraction
+  of the system. The back-substitution for the condensed degrees of
+  freedom and the corresponding adjoint solves are handled by the
+  existing factorization machinery.
+
+  The flag must be set before createSchurMat() is called and only
+  affects the TACS_AMD_ORDER path.
+
+  @param flag Non-zero to order condensable nodes first
+*/
+void TACSAssembler::setStaticCondensationOrdering(int flag) {
+  useCondensationOrdering = flag;
+}
+
 TACSSchurMat *TACSAssembler::createSchurMat(OrderingType order_type) {
   if (!meshInitializedFlag) {
     fprintf(stderr,
@@ -3615,10 +5429,11 @@ TACSSchurMat *TACSAssembler::createSchurMat(OrderingType order_type) {
       nlocal_nodes = numNodes - ncoupling_nodes;
 
       // Compute the CSR data structure for the node-to-node
-      // connectivity without the diagonal entry
+      // connectivity without the diagonal entry, re-using the cached
+      // symbolic structure when the mesh topology is unchanged
       int *rowp, *cols;
       int no_diagonal = 1;
-      computeLocalNodeToNodeCSR(&rowp, &cols, no_diagonal);
+      getSymbolicCSR(&rowp, &cols, no_diagonal);
 
       // Compute the multipliers/connectivity
       int num_multipliers = 0;
@@ -3645,6 +5460,45 @@ TACSSchurMat *TACSAssembler::createSchurMat(OrderingType order_type) {
       delete[] indep_ptr;
       delete[] indep_nodes;
 
+      // Refine the ordering so that the condensable nodes are
+      // eliminated first. This performs exact element-level static
+      // condensation within the factorization - see
+      // setStaticCondensationOrdering().
+      if (useCondensationOrdering && nlocal_nodes > 0) {
+        int *cond_nodes;
+        int num_cond = computeCondensableNodes(&cond_nodes);
+
+        // Flag the condensable nodes
+        int *cond_flag = new int[numNodes];
+        memset(cond_flag, 0, numNodes * sizeof(int));
+        for (int i = 0; i < num_cond; i++) {
+          cond_flag[cond_nodes[i]] = 1;
+        }
+
+        // Stable partition of the local (non-coupling) portion of
+        // the permutation: condensable nodes first, preserving the
+        // AMD elimination order within each group
+        int *new_perm = new int[nlocal_nodes];
+        int count = 0;
+        for (int i = 0; i < nlocal_nodes; i++) {
+          if (cond_flag[perm[i]]) {
+            new_perm[count] = perm[i];
+            count++;
+          }
+        }
+        for (int i = 0; i < nlocal_nodes; i++) {
+          if (!cond_flag[perm[i]]) {
+            new_perm[count] = perm[i];
+            count++;
+          }
+        }
+        memcpy(perm, new_perm, nlocal_nodes * sizeof(int));
+
+        delete[] new_perm;
+        delete[] cond_flag;
+        delete[] cond_nodes;
+      }
+
       // Compute the coupling nodes based on their permutation
       tacs_local_nodes = new int[nlocal_nodes];
       tacs_coupling_nodes = new int[ncoupling_nodes];
@@ -3663,8 +5517,10 @@ TACSSchurMat *TACSAssembler::createSchurMat(OrderingType order_type) {
       delete[] coupling_nodes;
     } else {
       // This scheme uses AMD or Nested Disection on the local and
-      // coupling nodes independently. This ignores the off-diagonal
-      // fill-ins which can be considerable!
+      // coupling nodes independently. For AMD this ignores the
+      // off-diagonal fill-ins which can be considerable! The nested
+      // dissection path additionally splits the local nodes about the
+      // coupling interface to limit that fill.
       int no_diagonal = 0;
       if (order_type == ND_ORDER) {
         no_diagonal = 1;
@@ -3724,20 +5580,88 @@ TACSSchurMat *TACSAssembler::createSchurMat(OrderingType order_type) {
       }
 
       // Now, compute the reordering for the local variables
-      int *rowp, *cols;
-      computeLocalNodeToNodeCSR(&rowp, &cols, nlocal_nodes, all_nodes,
-                                no_diagonal);
-      computeMatReordering(order_type, nlocal_nodes, rowp, cols,
-                           perm_local_nodes, NULL);
+      if (order_type == ND_ORDER && ncoupling_nodes > 0) {
+        // Interface-aware nested dissection: order the strictly
+        // interior nodes first, followed by the local nodes adjacent
+        // to the coupling interface. This confines the off-diagonal
+        // fill between the local factor and the interface columns to
+        // the trailing border block.
+        int *rowp, *cols;
+        computeLocalNodeToNodeCSR(&rowp, &cols);
+
+        // Flag the local nodes that neighbor a coupling node
+        int *border = new int[numNodes];
+        memset(border, 0, numNodes * sizeof(int));
+        for (int k = 0; k < ncoupling_nodes; k++) {
+          int node = coupling_nodes[k];
+          for (int jp = rowp[node]; jp < rowp[node + 1]; jp++) {
+            border[cols[jp]] = 1;
+          }
+        }
+
+        delete[] rowp;
+        delete[] cols;
+
+        // Order the interior set, then the border set, applying the
+        // nested dissection ordering to each subgraph
+        int *mask = new int[numNodes];
+        int *sub_nodes = new int[nlocal_nodes];
+        int *perm_sub = new int[nlocal_nodes];
+        for (int offset = 0, pass = 0; pass < 2; pass++) {
+          // On the first pass gather the interior nodes, on the
+          // second pass gather the border nodes
+          int nsub = 0;
+          for (int k = 0; k < numNodes; k++) {
+            mask[k] = -1;
+          }
+          for (int j = 0; j < nlocal_nodes; j++) {
+            int node = local_nodes[j];
+            if ((pass == 0 && !border[node]) || (pass == 1 && border[node])) {
+              mask[node] = nsub;
+              sub_nodes[nsub] = node;
+              nsub++;
+            }
+          }
+
+          if (nsub > 0) {
+            computeLocalNodeToNodeCSR(&rowp, &cols, nsub, mask, no_diagonal);
+            computeMatReordering(order_type, nsub, rowp, cols, perm_sub, NULL);
+
+            for (int i = 0; i < nsub; i++) {
+              perm_local_nodes[offset + i] = sub_nodes[perm_sub[i]];
+            }
+
+            delete[] rowp;
+            delete[] cols;
+            offset += nsub;
+          }
+        }
+
+        delete[] border;
+        delete[] mask;
+        delete[] sub_nodes;
+        delete[] perm_sub;
+      } else {
+        int *rowp, *cols;
+        computeLocalNodeToNodeCSR(&rowp, &cols, nlocal_nodes, all_nodes,
+                                  no_diagonal);
+        computeMatReordering(order_type, nlocal_nodes, rowp, cols,
+                             perm_local_nodes, NULL);
+
+        for (int i = 0; i < nlocal_nodes; i++) {
+          // Permute the local nodes
+          perm_local_nodes[i] = local_nodes[perm_local_nodes[i]];
+        }
+
+        delete[] rowp;
+        delete[] cols;
+      }
 
+      // Record the tacs variables corresponding to the local nodes
       for (int i = 0; i < nlocal_nodes; i++) {
-        // Permute the local nodes and record the corresponding tacs variables
-        perm_local_nodes[i] = local_nodes[perm_local_nodes[i]];
         tacs_local_nodes[i] = getGlobalNodeNum(perm_local_nodes[i]);
       }
 
-      delete[] rowp;
-      delete[] cols;
       delete[] coupling_nodes;
       delete[] all_nodes;
       delete[] local_nodes;
@@ -3838,7 +5762,7 @@ void TACSAssembler::getInitConditions(TACSBVec *vars, TACSBVec *dvars,
       int ptr = elementNodeIndex[i];
       int len = elementNodeIndex[i + 1] - ptr;
       const int *nodes = &elementTacsNodes[ptr];
-      xptVec->getValues(len, nodes, elemXpts);
+      xptVec->getBlockedValues(len, nodes, elemXpts);
 
       // Get the initial condition values
       int nvars = elements[i]->getNumVariables();
@@ -3931,19 +5855,28 @@ void TACSAssembler::setInitConditions(TACSBVec *vars, TACSBVec *dvars,
 /**
   Zero the entries of the local variables
 */
-void TACSAssembler::zeroVariables() { varsVec->zeroEntries(); }
+void TACSAssembler::zeroVariables() {
+  finishDistributingVariables();
+  varsVec->zeroEntries();
+}
 
 /**
   Zero the values of the time-derivatives of the state variables.
   This time-derivative is load-case independent.
 */
-void TACSAssembler::zeroDotVariables() { dvarsVec->zeroEntries(); }
+void TACSAssembler::zeroDotVariables() {
+  finishDistributingVariables();
+  dvarsVec->zeroEntries();
+}
 
 /**
   Zero the values of the time-derivatives of the state variables.
   This time-derivative is load-case independent.
 */
-void TACSAssembler::zeroDDotVariables() { ddvarsVec->zeroEntries(); }
+void TACSAssembler::zeroDDotVariables() {
+  finishDistributingVariables();
+  ddvarsVec->zeroEntries();
+}
 
 /**
   Set the value of the time/variables/time derivatives simultaneously
@@ -3954,6 +5887,9 @@ void TACSAssembler::zeroDDotVariables() { ddvarsVec->zeroEntries(); }
 */
 void TACSAssembler::setVariables(TACSBVec *vars, TACSBVec *dvars,
                                  TACSBVec *ddvars) {
+  // Complete any distribution still outstanding from a previous call
+  finishDistributingVariables();
+
   // Copy the values to the array.
   if (vars) {
     varsVec->copyValues(vars);
@@ -3965,24 +5901,48 @@ void TACSAssembler::setVariables(TACSBVec *vars, TACSBVec *dvars,
     ddvarsVec->copyValues(ddvars);
   }
 
-  // Distribute the values and evaluate the dependent nodes.
+  // Begin distributing the values. The distribution is not completed
+  // here: it is finished by finishDistributingVariables() the first
+  // time the external values are needed. This allows the assembly
+  // routines to integrate the interior elements while the halo
+  // exchange is still in flight.
   if (vars) {
     varsVec->beginDistributeValues();
+    pendingVarsDist |= 1;
   }
   if (dvars) {
     dvarsVec->beginDistributeValues();
+    pendingVarsDist |= 2;
   }
   if (ddvars) {
     ddvarsVec->beginDistributeValues();
+    pendingVarsDist |= 4;
   }
-  if (vars) {
-    varsVec->endDistributeValues();
-  }
-  if (dvars) {
-    dvarsVec->endDistributeValues();
-  }
-  if (ddvars) {
-    ddvarsVec->endDistributeValues();
+
+  // The element Jacobians depend on the state variables. Elements
+  // with a constant Jacobian (linear elements) keep their cached
+  // contributions; only the state-dependent elements are marked for
+  // recomputation. Elements with attached auxiliary elements are
+  // treated conservatively since the auxiliary terms may depend on
+  // the states.
+  if (useIncrementalAssembly && cachedJacValid && elementDirtyFlags) {
+    for (int i = 0; i < numElements; i++) {
+      if (!elements[i]->isConstantJacobian()) {
+        elementDirtyFlags[i] = 1;
+      }
+    }
+    if (auxElements) {
+      TACSAuxElem *aux = NULL;
+      int naux = auxElements->getAuxElements(&aux);
+      for (int i = 0; i < naux; i++) {
+        if (aux[i].num >= 0 && aux[i].num < numElements &&
+            !aux[i].elem->isConstantJacobian()) {
+          elementDirtyFlags[aux[i].num] = 1;
+        }
+      }
+    }
+  } else {
+    cachedJacValid = 0;
   }
 }
 
@@ -4000,6 +5960,8 @@ void TACSAssembler::setVariables(TACSBVec *vars, TACSBVec *dvars,
 */
 void TACSAssembler::copyVariables(TACSBVec *vars, TACSBVec *dvars,
                                   TACSBVec *ddvars) {
+  finishDistributingVariables();
+
   if (vars) {
     varsVec->copyValues(vars);
   }
@@ -4020,6 +5982,8 @@ void TACSAssembler::copyVariables(TACSBVec *vars, TACSBVec *dvars,
 */
 void TACSAssembler::getVariables(TACSBVec *vars, TACSBVec *dvars,
                                  TACSBVec *ddvars) {
+  finishDistributingVariables();
+
   // Copy the values to the array. Only local values are
   // copied, not external/dependents
   if (vars) {
@@ -4042,6 +6006,8 @@ void TACSAssembler::getVariables(TACSBVec *vars, TACSBVec *dvars,
 */
 void TACSAssembler::getVariables(TACSBVec **vars, TACSBVec **dvars,
                                  TACSBVec **ddvars) {
+  finishDistributingVariables();
+
   // Copy the values to the array. Only local values are
   // copied, not external/dependents
   if (vars) {
@@ -4076,6 +6042,8 @@ double TACSAssembler::getSimulationTime() { return time; }
   @param Pe The potential energy
 */
 void TACSAssembler::evalEnergies(TacsScalar *Te, TacsScalar *Pe) {
+  finishDistributingVariables();
+
   // Zero the kinetic and potential energy
   *Te = 0.0;
   *Pe = 0.0;
@@ -4087,13 +6055,13 @@ void TACSAssembler::evalEnergies(TacsScalar *Te, TacsScalar *Pe) {
 
   // Loop over all elements and add individual contributions to the
   // total energy
-  for (int i = 0; i < numElements; i++) {
+  for (int i = 0; i < numElements - numHaloElements; i++) {
     int ptr = elementNodeIndex[i];
     int len = elementNodeIndex[i + 1] - ptr;
     const int *nodes = &elementTacsNodes[ptr];
-    xptVec->getValues(len, nodes, elemXpts);
-    varsVec->getValues(len, nodes, vars);
-    dvarsVec->getValues(len, nodes, dvars);
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
+    dvarsVec->getBlockedValues(len, nodes, dvars);
 
     // Compute and add the element's contributions to the total
     // energy
@@ -4127,10 +6095,374 @@ void TACSAssembler::evalEnergies(TacsScalar *Te, TacsScalar *Pe) {
   @param residual The residual vector
   @param lambda Scaling factor for the aux element contributions, by default 1
 */
-void TACSAssembler::assembleRes(TACSBVec *residual, const TacsScalar lambda) {
-  // Sort the list of auxiliary elements - this only performs the
-  // sort if it is required (if new elements are added)
-  if (auxElements) {
+/**
+  Register a devirtualized residual kernel for a concrete element type.
+
+  The serial assembly path buckets the elements by concrete type and
+  dispatches each batch of a registered type through the kernel, which
+  calls the element implementation directly rather than through the
+  vtable. This allows the compiler to inline the element residual into
+  the batch loop, and lets batches span distinct element objects of
+  the same type, which the object-keyed addResidualBatch() staging
+  cannot do. Elements whose type has no registered kernel fall back to
+  the virtual path unchanged.
+
+  Use the templated overload to instantiate and register the kernel in
+  one call:
+
+  assembler->registerResidualKernel<TACSQuad4Shell>();
+
+  @param elemType The type_info of the concrete element type
+  @param kernel The kernel generated by TacsElementResidualKernel
+*/
+void TACSAssembler::registerResidualKernel(const std::type_info *elemType,
+                                           TacsElementResidualKernelFn kernel) {
+  if (!elemType || !kernel) {
+    fprintf(stderr, "[%d] Cannot register a NULL residual kernel\n", mpiRank);
+    return;
+  }
+
+  // Replace the kernel if the type is already registered
+  for (int k = 0; k < numResidualKernels; k++) {
+    if (*residualKernelTypes[k] == *elemType) {
+      residualKernelFns[k] = kernel;
+      kernelsResolved = 0;
+      return;
+    }
+  }
+
+  // Extend the registry - registration is rare so the arrays are
+  // simply re-allocated
+  const std::type_info **types =
+      new const std::type_info *[numResidualKernels + 1];
+  TacsElementResidualKernelFn *fns =
+      new TacsElementResidualKernelFn[numResidualKernels + 1];
+  for (int k = 0; k < numResidualKernels; k++) {
+    types[k] = residualKernelTypes[k];
+    fns[k] = residualKernelFns[k];
+  }
+  types[numResidualKernels] = elemType;
+  fns[numResidualKernels] = kernel;
+
+  if (residualKernelTypes) {
+    delete[] residualKernelTypes;
+  }
+  if (residualKernelFns) {
+    delete[] residualKernelFns;
+  }
+  residualKernelTypes = types;
+  residualKernelFns = fns;
+  numResidualKernels++;
+  kernelsResolved = 0;
+}
+
+/*
+  Bucket the elements by concrete type: look up the registered kernel
+  for the dynamic type of each local element. The per-element table is
+  rebuilt lazily whenever the registry changes.
+*/
+void TACSAssembler::resolveResidualKernels() {
+  if (!elementKernels) {
+    elementKernels = new TacsElementResidualKernelFn[numElements];
+  }
+
+  for (int i = 0; i < numElements; i++) {
+    elementKernels[i] = NULL;
+    if (elements && elements[i]) {
+      const std::type_info &id = typeid(*elements[i]);
+      for (int k = 0; k < numResidualKernels; k++) {
+        if (*residualKernelTypes[k] == id) {
+          elementKernels[i] = residualKernelFns[k];
+          break;
+        }
+      }
+    }
+  }
+
+  kernelsResolved = 1;
+}
+
+/*
+  Add the element matrix to the provided matrix, skipping the
+  node-pair sub-blocks that the element declared as structurally zero
+  through getJacobianBlockPattern().
+
+  Each block row of the element matrix is compressed: the retained
+  column blocks are packed into a contiguous slab and submitted with
+  one addValues() call per block row. The callers must fall back to
+  the dense addMatValues() when there are dependent nodes or the
+  matrix orientation is not TACS_MAT_NORMAL.
+*/
+void TACSAssembler::addMatValuesSparse(TACSMat *A, const int elemNum,
+                                       const TacsScalar *mat,
+                                       const int *pattern) {
+  int start = elementNodeIndex[elemNum];
+  int end = elementNodeIndex[elemNum + 1];
+  int nnodes = end - start;
+  int nvars = varsPerNode * nnodes;
+  const int *nodeNums = &elementTacsNodes[start];
+
+  // Allocate the packing storage on the first call
+  if (!blockScatterData) {
+    blockScatterData = new TacsScalar[varsPerNode * maxElementSize];
+    blockScatterIData = new int[maxElementNodes];
+  }
+
+  for (int i = 0; i < nnodes; i++) {
+    // Count the retained column blocks in this block row
+    int ncols = 0;
+    for (int j = 0; j < nnodes; j++) {
+      if (pattern[nnodes * i + j]) {
+        blockScatterIData[ncols] = nodeNums[j];
+        ncols++;
+      }
+    }
+
+    if (ncols == nnodes) {
+      // Nothing is skipped in this block row - submit it in place
+      A->addValues(1, &nodeNums[i], nnodes, nodeNums, varsPerNode, nvars,
+                   &mat[nvars * varsPerNode * i]);
+    } else if (ncols > 0) {
+      // Pack the retained blocks into a contiguous slab
+      const int ldb = varsPerNode * ncols;
+      for (int j = 0, jb = 0; j < nnodes; j++) {
+        if (pattern[nnodes * i + j]) {
+          for (int ii = 0; ii < varsPerNode; ii++) {
+            const TacsScalar *src =
+                &mat[nvars * (varsPerNode * i + ii) + varsPerNode * j];
+            TacsScalar *dest = &blockScatterData[ldb * ii + varsPerNode * jb];
+            for (int jj = 0; jj < varsPerNode; jj++) {
+              dest[jj] = src[jj];
+            }
+          }
+          jb++;
+        }
+      }
+
+      A->addValues(1, &nodeNums[i], ncols, blockScatterIData, varsPerNode, ldb,
+                   blockScatterData);
+    }
+  }
+}
+
+/**
+  Compute the cached load vector from the state-independent auxiliary
+  elements.
+
+  Auxiliary elements that declare isConstantLoad() contribute a
+  residual that depends only on the node locations, the design
+  variables and the time. Their contributions are evaluated once here
+  and folded into a single assembled load vector that assembleRes()
+  adds to the residual, so a mesh carrying one traction per wetted
+  shell does not re-integrate every load on every residual assembly.
+  The cache is invalidated when the nodes, the design variables or the
+  auxiliary elements change, or when the simulation time differs from
+  the cached time.
+
+  @param time The simulation time
+*/
+void TACSAssembler::computeAuxLoadVector(double time) {
+  if (!auxLoadVec) {
+    auxLoadVec = createVec();
+    auxLoadVec->incref();
+  }
+  auxLoadVec->zeroEntries();
+
+  // Retrieve pointers to temporary storage
+  TacsScalar *vars, *elemRes, *elemXpts;
+  getDataPointers(elementData, &vars, NULL, NULL, &elemRes, &elemXpts, NULL,
+                  NULL, NULL);
+
+  // The loads do not depend on the states - pass zeroed arrays for
+  // the variables and their time derivatives
+  memset(vars, 0, maxElementSize * sizeof(TacsScalar));
+
+  TACSAuxElem *aux = NULL;
+  int naux = auxElements->getAuxElements(&aux);
+
+  for (int k = 0; k < naux; k++) {
+    if (!aux[k].elem->isConstantLoad()) {
+      continue;
+    }
+    int elem = aux[k].num;
+    getVecValuesPlan(xptVec, elem, elemXpts);
+
+    int nvars = elements[elem]->getNumVariables();
+    memset(elemRes, 0, nvars * sizeof(TacsScalar));
+    aux[k].elem->addResidual(elem, time, elemXpts, vars, vars, vars, elemRes);
+
+    addVecValuesPlan(auxLoadVec, elem, elemRes);
+  }
+
+  // Assemble the contributions that belong to other processors. With
+  // halo element replicas every owned row is computed locally, so the
+  // exchange is skipped just as it is for the residual itself
+  if (numHaloElements == 0) {
+    auxLoadVec->beginSetValues(TACS_ADD_VALUES);
+    auxLoadVec->endSetValues(TACS_ADD_VALUES);
+  }
+
+  auxLoadTime = time;
+  auxLoadsValid = 1;
+}
+
+// Bits marking which blocks are packed for each cached linear element,
+// in storage order: the constant residual r0, then K, C and M
+static const int TACS_LINEAR_ELEM_R0 = 1;
+static const int TACS_LINEAR_ELEM_K = 2;
+static const int TACS_LINEAR_ELEM_C = 4;
+static const int TACS_LINEAR_ELEM_M = 8;
+
+/*
+  Compute y <- y + A*x for a cached dense element matrix
+*/
+static inline void addLinearElemMatVec(int n, const TacsScalar *A,
+                                       const TacsScalar *x, TacsScalar *y) {
+  for (int i = 0; i < n; i++) {
+    const TacsScalar *a = &A[n * i];
+    TacsScalar t = 0.0;
+    for (int j = 0; j < n; j++) {
+      t += a[j] * x[j];
+    }
+    y[i] += t;
+  }
+}
+
+/**
+  Probe and cache the constant matrices of the linear elements.
+
+  The residual of an element that declares isConstantJacobian() is
+  affine in the states: r = r0 + K u + C udot + M uddot. The constant
+  part r0 is recovered from a residual evaluation at zero states and
+  the matrices from three Jacobian evaluations with unit coefficients.
+  The non-zero blocks are packed contiguously in element order - a
+  spring stores only its 12x12 stiffness, a concentrated mass only
+  its mass matrix - so the storage stays bounded even when the model
+  carries hundreds of thousands of these elements. The probing cost
+  is incurred once; the cache is rebuilt when the node locations or
+  the design variables change, or when the simulation time changes
+  and a cached element carries a constant load.
+*/
+void TACSAssembler::computeLinearElementCache() {
+  TacsProfileScope profile("TACSAssembler::computeLinearElementCache");
+
+  if (linearElemData) {
+    delete[] linearElemData;
+    linearElemData = NULL;
+  }
+  numLinearElems = 0;
+  linearCacheHasLoad = 0;
+
+  // Retrieve pointers to the temporary element storage. The zeroed
+  // variable array doubles for all three state arrays
+  TacsScalar *vars, *elemRes, *elemXpts, *elemMat;
+  getDataPointers(elementData, &vars, NULL, NULL, &elemRes, &elemXpts, NULL,
+                  NULL, &elemMat);
+  memset(vars, 0, maxElementSize * sizeof(TacsScalar));
+
+  if (!linearElemOffset) {
+    linearElemOffset = new int[numElements];
+    linearElemFlags = new int[numElements];
+    linearElemSize = new int[numElements];
+  }
+
+  // The coefficient sets that isolate K, C and M from addJacobian()
+  const TacsScalar coef[3][3] = {
+      {1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+  const int mat_flags[3] = {TACS_LINEAR_ELEM_K, TACS_LINEAR_ELEM_C,
+                            TACS_LINEAR_ELEM_M};
+
+  // First pass: probe each linear element to determine which of the
+  // blocks are non-zero and size the packed storage
+  size_t total = 0;
+  for (int i = 0; i < numElements; i++) {
+    linearElemOffset[i] = -1;
+    linearElemFlags[i] = 0;
+    linearElemSize[i] = 0;
+    if (!elements[i]->isConstantJacobian()) {
+      continue;
+    }
+    int nvars = elements[i]->getNumVariables();
+    getVecValuesPlan(xptVec, i, elemXpts);
+
+    int flags = 0;
+    memset(elemRes, 0, nvars * sizeof(TacsScalar));
+    elements[i]->addResidual(i, time, elemXpts, vars, vars, vars, elemRes);
+    for (int jj = 0; jj < nvars; jj++) {
+      if (elemRes[jj] != 0.0) {
+        flags |= TACS_LINEAR_ELEM_R0;
+        total += nvars;
+        break;
+      }
+    }
+
+    for (int m = 0; m < 3; m++) {
+      memset(elemRes, 0, nvars * sizeof(TacsScalar));
+      memset(elemMat, 0, nvars * nvars * sizeof(TacsScalar));
+      elements[i]->addJacobian(i, time, coef[m][0], coef[m][1], coef[m][2],
+                               elemXpts, vars, vars, vars, elemRes, elemMat);
+      for (int jj = 0; jj < nvars * nvars; jj++) {
+        if (elemMat[jj] != 0.0) {
+          flags |= mat_flags[m];
+          total += nvars * nvars;
+          break;
+        }
+      }
+    }
+
+    linearElemFlags[i] = flags;
+    linearElemSize[i] = nvars;
+    if (flags & TACS_LINEAR_ELEM_R0) {
+      linearCacheHasLoad = 1;
+    }
+    numLinearElems++;
+  }
+
+  // Second pass: recompute the retained blocks and pack them. The
+  // matrices are small, so the cost of evaluating them twice is
+  // negligible against the storage of a worst-case allocation
+  if (total > 0) {
+    linearElemData = new TacsScalar[total];
+    size_t offset = 0;
+    for (int i = 0; i < numElements; i++) {
+      int flags = linearElemFlags[i];
+      if (!flags) {
+        continue;
+      }
+      int nvars = linearElemSize[i];
+      linearElemOffset[i] = (int)offset;
+      getVecValuesPlan(xptVec, i, elemXpts);
+
+      if (flags & TACS_LINEAR_ELEM_R0) {
+        memset(&linearElemData[offset], 0, nvars * sizeof(TacsScalar));
+        elements[i]->addResidual(i, time, elemXpts, vars, vars, vars,
+                                 &linearElemData[offset]);
+        offset += nvars;
+      }
+      for (int m = 0; m < 3; m++) {
+        if (flags & mat_flags[m]) {
+          memset(elemRes, 0, nvars * sizeof(TacsScalar));
+          memset(&linearElemData[offset], 0,
+                 nvars * nvars * sizeof(TacsScalar));
+          elements[i]->addJacobian(i, time, coef[m][0], coef[m][1], coef[m][2],
+                                   elemXpts, vars, vars, vars, elemRes,
+                                   &linearElemData[offset]);
+          offset += nvars * nvars;
+        }
+      }
+    }
+  }
+
+  TacsProfileAddCount("linear elements cached", numLinearElems);
+  linearCacheValid = 1;
+  linearCacheNodeVersion = nodeVersion;
+  linearCacheTime = time;
+}
+
+void TACSAssembler::assembleRes(TACSBVec *residual, const TacsScalar lambda) {
+  // Sort the list of auxiliary elements - this only performs the
+  // sort if it is required (if new elements are added)
+  if (auxElements) {
     auxElements->sort();
   }
 
@@ -4138,103 +6470,467 @@ void TACSAssembler::assembleRes(TACSBVec *residual, const TacsScalar lambda) {
   residual->zeroEntries();
 
   if (thread_info->getNumThreads() > 1) {
-    // Set the number of completed elements to zero
-    numCompletedElements = 0;
+    // The threaded assembly does not split the element loop - wait
+    // for any outstanding distribution of the variables
+    finishDistributingVariables();
+
     tacsPInfo->assembler = this;
     tacsPInfo->lambda = lambda;
 
-    // Create the joinable attribute
-    pthread_attr_t attr;
-    pthread_attr_init(&attr);
-    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-
-    for (int k = 0; k < thread_info->getNumThreads(); k++) {
-      pthread_create(&threads[k], &attr, TACSAssembler::assembleRes_thread,
-                     (void *)tacsPInfo);
-    }
-
-    // Join all the threads
-    for (int k = 0; k < thread_info->getNumThreads(); k++) {
-      pthread_join(threads[k], NULL);
-    }
-
-    // Destroy the attribute
-    pthread_attr_destroy(&attr);
+    // Schedule the elements and run the assembly on the pool
+    TACSThreadPool *pool = getThreadPool();
+    pool->initSchedule(numElements);
+    pool->run(TACSAssembler::assembleRes_thread, (void *)tacsPInfo);
   } else {
-    // Retrieve pointers to temporary storage
-    TacsScalar *vars, *dvars, *ddvars, *elemRes, *elemXpts;
-    getDataPointers(elementData, &vars, &dvars, &ddvars, &elemRes, &elemXpts,
-                    NULL, NULL, NULL);
+    // Compute the interior/boundary element split on the first call
+    if (!elementBoundaryFlag) {
+      computeBoundaryElements();
+    }
 
     // Get the auxiliary elements
-    int naux = 0, aux_count = 0;
+    int naux = 0;
     TACSAuxElem *aux = NULL;
     if (auxElements) {
       naux = auxElements->getAuxElements(&aux);
     }
 
-    // To avoid allocating memory inside the element loop, make the aux element
-    // contribution array big enough for the largest element
+    // Count the state-independent loads. Their contributions come
+    // from the cached load vector added to the assembled residual
+    // below, so they are skipped in the element loop
+    int nconst_aux = 0;
+    for (int k = 0; k < naux; k++) {
+      if (aux[k].elem->isConstantLoad()) {
+        nconst_aux++;
+      }
+    }
+    if (nconst_aux > 0 && (!auxLoadsValid || auxLoadTime != time)) {
+      computeAuxLoadVector(time);
+    }
+
+    // The scratch block past the getDataPointers() layout is big
+    // enough for the aux element contributions of the largest element
     int maxNVar = this->maxElementSize;
-    TacsScalar *auxElemRes = NULL;
+    TacsScalar *auxElemRes = &elementData[elementDataSize];
     bool scaleAux = lambda != TacsScalar(1.0) && naux > 0;
-    if (scaleAux) {
-      auxElemRes = new TacsScalar[maxNVar];
-    }
 
-    // Go through and add the residuals from all the elements
-    for (int i = 0; i < numElements; i++) {
-      int ptr = elementNodeIndex[i];
-      int len = elementNodeIndex[i + 1] - ptr;
-      const int *nodes = &elementTacsNodes[ptr];
-      xptVec->getValues(len, nodes, elemXpts);
-      varsVec->getValues(len, nodes, vars);
-      dvarsVec->getValues(len, nodes, dvars);
-      ddvarsVec->getValues(len, nodes, ddvars);
+    // Rebuild the cached linear-element matrices if the nodes, the
+    // design variables or - when a cached element carries a constant
+    // load - the simulation time have changed since the cache was
+    // built
+    if (useLinearElemCache &&
+        (!linearCacheValid || linearCacheNodeVersion != nodeVersion ||
+         (linearCacheHasLoad && linearCacheTime != time))) {
+      computeLinearElementCache();
+    }
+    const int linearOK =
+        (useLinearElemCache && linearCacheValid && numLinearElems > 0);
+
+    // Set the staging storage for batches of elements. Contiguous
+    // runs of elements that share the same element object are staged
+    // into element-contiguous arrays and evaluated with a single call
+    // to addResidualBatch(), which amortizes the per-call overhead
+    // and lets the element kernels work across the whole batch. The
+    // staging arrays are allocated on the first call and re-used.
+    const int batchSize = TACS_RESIDUAL_BATCH_SIZE;
+    int s = maxElementSize;
+    int sx = 3 * maxElementNodes;
+    if (!batchData) {
+      batchData = new TacsScalar[batchSize * (4 * s + sx)];
+    }
+    if (!batchIData) {
+      batchIData = new int[batchSize];
+    }
+    if (!batchElemPtrs) {
+      batchElemPtrs = new TACSElement *[batchSize];
+    }
+
+    // Resolve the registered devirtualized kernels for the element
+    // types, if the registry has changed since the last resolution
+    if (numResidualKernels > 0 && !kernelsResolved && elements) {
+      resolveResidualKernels();
+    }
+    TacsScalar *batchVars = &batchData[0];
+    TacsScalar *batchDvars = &batchData[batchSize * s];
+    TacsScalar *batchDdvars = &batchData[2 * batchSize * s];
+    TacsScalar *batchRes = &batchData[3 * batchSize * s];
+    TacsScalar *batchXpts = &batchData[4 * batchSize * s];
+    int *batchIndex = batchIData;
+
+    // Process the elements in two passes: the interior elements are
+    // integrated first, while the halo exchange started by
+    // setVariables() may still be in flight; the distribution is then
+    // completed and the boundary elements are processed. If no
+    // distribution is pending, all elements are handled in one pass.
+    int npasses = (pendingVarsDist ? 2 : 1);
+
+    for (int pass = 0; pass < npasses; pass++) {
+      if (pass == 1) {
+        finishDistributingVariables();
+      }
 
-      // Add the residual from the working element
-      int nvars = elements[i]->getNumVariables();
-      memset(elemRes, 0, nvars * sizeof(TacsScalar));
-      elements[i]->addResidual(i, time, elemXpts, vars, dvars, ddvars, elemRes);
+      // The cursor into the sorted auxiliary element list. Each pass
+      // visits its elements in ascending order, so the entries that
+      // are skipped here belong to elements in the other pass.
+      int aux_count = 0;
+
+      // Go through and add the residuals from the elements
+      for (int i = 0; i < numElements;) {
+        // Fast path for the cached linear elements: the residual is
+        // assembled directly from the stored constant blocks without
+        // dispatching into the element
+        if (linearOK && linearElemSize[i] > 0) {
+          if (!(npasses == 2 && elementBoundaryFlag[i] != pass)) {
+            double tstart = 0.0;
+            if (recordElementTime) {
+              tstart = MPI_Wtime();
+            }
+            int nvars = linearElemSize[i];
+            int flags = linearElemFlags[i];
+            const TacsScalar *data = &linearElemData[linearElemOffset[i]];
+
+            memset(batchRes, 0, nvars * sizeof(TacsScalar));
+            if (flags & TACS_LINEAR_ELEM_R0) {
+              memcpy(batchRes, data, nvars * sizeof(TacsScalar));
+              data += nvars;
+            }
+            int gathered = 0;
+            if (flags & TACS_LINEAR_ELEM_K) {
+              getVecValuesPlan(varsVec, i, batchVars);
+              gathered |= 1;
+              addLinearElemMatVec(nvars, data, batchVars, batchRes);
+              data += nvars * nvars;
+            }
+            if (flags & TACS_LINEAR_ELEM_C) {
+              getVecValuesPlan(dvarsVec, i, batchDvars);
+              gathered |= 2;
+              addLinearElemMatVec(nvars, data, batchDvars, batchRes);
+              data += nvars * nvars;
+            }
+            if (flags & TACS_LINEAR_ELEM_M) {
+              getVecValuesPlan(ddvarsVec, i, batchDdvars);
+              gathered |= 4;
+              addLinearElemMatVec(nvars, data, batchDdvars, batchRes);
+            }
 
-      // Add the residual from any auxiliary elements, if the load factor is 1
-      // they can be added straight to the elemRes, otherwise they need to be
-      // scaled first
-      if (!scaleAux) {
-        while (aux_count < naux && aux[aux_count].num == i) {
-          aux[aux_count].elem->addResidual(i, time, elemXpts, vars, dvars,
-                                           ddvars, elemRes);
-          aux_count++;
+            // Advance past the entries for elements in the other pass
+            while (aux_count < naux && aux[aux_count].num < i) {
+              aux_count++;
+            }
+
+            // Auxiliary elements attached to a cached element go
+            // through the general interface - gather the node
+            // locations and any state arrays that the cached blocks
+            // did not need
+            if (aux_count < naux && aux[aux_count].num == i) {
+              getVecValuesPlan(xptVec, i, batchXpts);
+              if (!(gathered & 1)) {
+                getVecValuesPlan(varsVec, i, batchVars);
+              }
+              if (!(gathered & 2)) {
+                getVecValuesPlan(dvarsVec, i, batchDvars);
+              }
+              if (!(gathered & 4)) {
+                getVecValuesPlan(ddvarsVec, i, batchDdvars);
+              }
+              if (!scaleAux) {
+                while (aux_count < naux && aux[aux_count].num == i) {
+                  if (!aux[aux_count].elem->isConstantLoad()) {
+                    aux[aux_count].elem->addResidual(i, time, batchXpts,
+                                                     batchVars, batchDvars,
+                                                     batchDdvars, batchRes);
+                  }
+                  aux_count++;
+                }
+              } else {
+                memset(auxElemRes, 0, maxNVar * sizeof(TacsScalar));
+                while (aux_count < naux && aux[aux_count].num == i) {
+                  if (!aux[aux_count].elem->isConstantLoad()) {
+                    aux[aux_count].elem->addResidual(i, time, batchXpts,
+                                                     batchVars, batchDvars,
+                                                     batchDdvars, auxElemRes);
+                  }
+                  aux_count++;
+                }
+                for (int jj = 0; jj < nvars; jj++) {
+                  batchRes[jj] += lambda * auxElemRes[jj];
+                }
+              }
+            }
+
+            addVecValuesPlan(residual, i, batchRes);
+            if (recordElementTime) {
+              elementRuntime[i] += MPI_Wtime() - tstart;
+            }
+          }
+          i++;
+          continue;
         }
-      } else {
-        memset(auxElemRes, 0, maxNVar * sizeof(TacsScalar));
-        while (aux_count < naux && aux[aux_count].num == i) {
-          aux[aux_count].elem->addResidual(i, time, elemXpts, vars, dvars,
-                                           ddvars, auxElemRes);
-          aux_count++;
+
+        // Find the contiguous run of elements that can be evaluated as
+        // a single batch. Elements that share the element object have
+        // identical types and sizes; when a devirtualized kernel is
+        // registered for the concrete type, the run may also span
+        // distinct objects of that type with the same sizes.
+        TACSElement *element = elements[i];
+        TacsElementResidualKernelFn kernel =
+            (kernelsResolved ? elementKernels[i] : NULL);
+
+        double tstart = 0.0;
+        if (recordElementTime) {
+          tstart = MPI_Wtime();
         }
-        for (int jj = 0; jj < nvars; jj++) {
-          elemRes[jj] += lambda * auxElemRes[jj];
+
+        int nnodes = element->getNumNodes();
+        int nvars = element->getNumVariables();
+
+        int run = 1;
+        while (run < batchSize && i + run < numElements) {
+          TACSElement *next = elements[i + run];
+          if (next != element &&
+              !(kernel && elementKernels[i + run] == kernel &&
+                next->getNumNodes() == nnodes &&
+                next->getNumVariables() == nvars)) {
+            break;
+          }
+          run++;
         }
-      }
 
-      // Add the residual values
-      residual->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
+        // Gather the elements belonging to this pass into the
+        // staging arrays
+        int nb = 0;
+        for (int k = 0; k < run; k++) {
+          if (npasses == 2 && elementBoundaryFlag[i + k] != pass) {
+            continue;
+          }
+          getVecValuesPlan(xptVec, i + k, &batchXpts[3 * nnodes * nb]);
+          getVecValuesPlan(varsVec, i + k, &batchVars[nvars * nb]);
+          getVecValuesPlan(dvarsVec, i + k, &batchDvars[nvars * nb]);
+          getVecValuesPlan(ddvarsVec, i + k, &batchDdvars[nvars * nb]);
+          batchIndex[nb] = i + k;
+          batchElemPtrs[nb] = elements[i + k];
+          nb++;
+        }
+
+        if (nb > 0) {
+          memset(batchRes, 0, nb * nvars * sizeof(TacsScalar));
+
+          // Evaluate the entire batch of residuals through the
+          // devirtualized kernel if one is registered for this type
+          if (kernel) {
+            kernel(batchElemPtrs, nb, batchIndex, time, batchXpts, batchVars,
+                   batchDvars, batchDdvars, batchRes);
+          } else {
+            element->addResidualBatch(nb, batchIndex, time, batchXpts,
+                                      batchVars, batchDvars, batchDdvars,
+                                      batchRes);
+          }
+
+          // Add the auxiliary element contributions and scatter the
+          // residuals back element-by-element
+          for (int k = 0; k < nb; k++) {
+            int elem = batchIndex[k];
+            TacsScalar *elemXpts = &batchXpts[3 * nnodes * k];
+            TacsScalar *vars = &batchVars[nvars * k];
+            TacsScalar *dvars = &batchDvars[nvars * k];
+            TacsScalar *ddvars = &batchDdvars[nvars * k];
+            TacsScalar *elemRes = &batchRes[nvars * k];
+
+            // Advance past the entries for elements in the other pass
+            while (aux_count < naux && aux[aux_count].num < elem) {
+              aux_count++;
+            }
+
+            // Add the residual from any auxiliary elements, if the load
+            // factor is 1 they can be added straight to the elemRes,
+            // otherwise they need to be scaled first
+            if (!scaleAux) {
+              while (aux_count < naux && aux[aux_count].num == elem) {
+                if (!aux[aux_count].elem->isConstantLoad()) {
+                  aux[aux_count].elem->addResidual(elem, time, elemXpts, vars,
+                                                   dvars, ddvars, elemRes);
+                }
+                aux_count++;
+              }
+            } else {
+              memset(auxElemRes, 0, maxNVar * sizeof(TacsScalar));
+              while (aux_count < naux && aux[aux_count].num == elem) {
+                if (!aux[aux_count].elem->isConstantLoad()) {
+                  aux[aux_count].elem->addResidual(elem, time, elemXpts, vars,
+                                                   dvars, ddvars, auxElemRes);
+                }
+                aux_count++;
+              }
+              for (int jj = 0; jj < nvars; jj++) {
+                elemRes[jj] += lambda * auxElemRes[jj];
+              }
+            }
+
+            // Add the residual values
+            addVecValuesPlan(residual, elem, elemRes);
+          }
+
+          // Spread the measured batch time over its elements
+          if (recordElementTime) {
+            double dt = (MPI_Wtime() - tstart) / nb;
+            for (int k = 0; k < nb; k++) {
+              elementRuntime[batchIndex[k]] += dt;
+            }
+          }
+        }
+
+        i += run;
+      }
     }
 
-    if (scaleAux) {
-      delete[] auxElemRes;
+    // Add the cached loads from the state-independent aux elements
+    if (nconst_aux > 0) {
+      residual->axpy(lambda, auxLoadVec);
     }
   }
 
-  // Finish transmitting the residual
-  residual->beginSetValues(TACS_ADD_VALUES);
-  residual->endSetValues(TACS_ADD_VALUES);
+  // Finish transmitting the residual. With halo element replicas every
+  // locally owned row is computed in full on this processor, so the
+  // reverse exchange is skipped
+  if (numHaloElements == 0) {
+    residual->beginSetValues(TACS_ADD_VALUES);
+    residual->endSetValues(TACS_ADD_VALUES);
+  }
 
   // Apply the boundary conditions for the residual
   residual->applyBCs(bcMap, varsVec);
 }
 
+/**
+  Enable or disable per-element assembly cost measurement
+
+  When enabled, the serial residual and Jacobian assembly paths
+  accumulate the measured wall time of each element batch, spread
+  evenly over the elements of the batch. The accumulated times feed
+  the measured-cost repartitioning in TACSCreator, which rebalances
+  ranks whose assembly cost has drifted apart - local nonlinearity or
+  contact activation can skew per-rank cost long after an
+  element-count-balanced partition was computed.
+
+  @param flag Non-zero to record the per-element assembly cost
+*/
+void TACSAssembler::setElementTimingFlag(int flag) {
+  recordElementTime = flag;
+  if (recordElementTime && !elementRuntime && numElements > 0) {
+    elementRuntime = new double[numElements];
+    memset(elementRuntime, 0, numElements * sizeof(double));
+  }
+}
+
+/**
+  Zero the accumulated per-element assembly times
+*/
+void TACSAssembler::zeroElementRuntimes() {
+  if (elementRuntime) {
+    memset(elementRuntime, 0, numElements * sizeof(double));
+  }
+}
+
+/**
+  Retrieve the accumulated per-element assembly times
+
+  The times are returned in the original element ordering used when
+  the assembler was created, undoing any cache-friendly element
+  reordering, so that the caller can map them back to the global
+  element numbering.
+
+  @param times Array of length numElements for the times in seconds
+*/
+void TACSAssembler::getElementRuntimes(double *times) {
+  if (!elementRuntime) {
+    memset(times, 0, numElements * sizeof(double));
+    return;
+  }
+  if (newElementNums) {
+    for (int i = 0; i < numElements; i++) {
+      times[i] = elementRuntime[newElementNums[i]];
+    }
+  } else {
+    memcpy(times, elementRuntime, numElements * sizeof(double));
+  }
+}
+
+/**
+  Enable or disable incremental Jacobian re-assembly
+
+  When enabled, the serial assembly path caches the per-element
+  Jacobian contributions and setDesignVars() marks the elements whose
+  design variables actually changed. A subsequent assembleJacobian()
+  call with the same state variables and coefficients then only
+  recomputes the dirty elements and scatters the cached contributions
+  for the rest. In design optimization, where a typical step only
+  modifies the design variables of a small fraction of the elements,
+  this skips most of the element-level work.
+
+  The cache stores the full element matrix for every element, which
+  costs maxElementSize^2 scalars per element - only enable this when
+  the memory trade-off is worthwhile. The cache is invalidated
+  whenever the state variables, node locations or assembly
+  coefficients change.
+
+  @param flag Non-zero to enable incremental assembly
+*/
+void TACSAssembler::setIncrementalAssembly(int flag) {
+  useIncrementalAssembly = flag;
+  cachedJacValid = 0;
+  if (useIncrementalAssembly && !elementDirtyFlags && numElements > 0) {
+    elementDirtyFlags = new int[numElements];
+    memset(elementDirtyFlags, 0, numElements * sizeof(int));
+  }
+}
+
+/**
+  Enable or disable canonical-element sharing in assembleMatType()
+
+  Lattice and stiffened-panel models contain many elements that are
+  translated copies of one another with the same constitutive state,
+  and each copy recomputes an identical element matrix during linear
+  assembly. When sharing is enabled, the elements are grouped into
+  equivalence classes of translated copies of the same element object
+  and the element matrix of each class is computed once and reused for
+  the remaining members.
+
+  The sharing is only valid when the requested matrix type does not
+  depend on the state variables or on the element index - the
+  stiffness and mass matrices of a linear model satisfy this, the
+  geometric stiffness of a loaded structure does not. Rotated copies
+  are not detected, since transforming the element matrix would
+  require element-specific knowledge. The classes are rebuilt
+  automatically when the node locations change.
+
+  @param flag Non-zero to share the element matrices across the classes
+*/
+void TACSAssembler::setCanonicalElementSharing(int flag) {
+  useCanonicalElements = flag;
+  matClassNodeVersion = -1;
+}
+
+/**
+  Enable or disable the cached linear-element fast path
+
+  Spring, concentrated mass and rigid-body constraint elements pass
+  through the same gather/evaluate/scatter machinery as the largest
+  continuum elements, and for models carrying hundreds of thousands
+  of them the dispatch and per-element setup dominate their actual
+  arithmetic. When caching is enabled, the constant matrices of every
+  element that declares isConstantJacobian() are probed once, the
+  non-zero blocks are packed contiguously, and the serial residual
+  and Jacobian assembly loops evaluate these elements with direct
+  matrix-vector products against the stored blocks. The cache is
+  rebuilt automatically when the node locations or the design
+  variables change.
+
+  @param flag Non-zero to cache the constant element matrices
+*/
+void TACSAssembler::setLinearElementCaching(int flag) {
+  useLinearElemCache = flag;
+  linearCacheValid = 0;
+}
+
 /**
   Assemble the Jacobian matrix
 
@@ -4258,6 +6954,9 @@ void TACSAssembler::assembleJacobian(TacsScalar alpha, TacsScalar beta,
                                      TacsScalar gamma, TACSBVec *residual,
                                      TACSMat *A, MatrixOrientation matOr,
                                      const TacsScalar lambda) {
+  TacsProfileScope profile("TACSAssembler::assembleJacobian");
+  TacsProfileAddCount("elements assembled", numElements);
+
   // Zero the residual and the matrix
   if (residual) {
     residual->zeroEntries();
@@ -4272,8 +6971,14 @@ void TACSAssembler::assembleJacobian(TacsScalar alpha, TacsScalar beta,
 
   // Run the p-threaded version of the assembly code
   if (thread_info->getNumThreads() > 1) {
-    // Set the number of completed elements to zero
-    numCompletedElements = 0;
+    // The threaded assembly does not maintain the element Jacobian
+    // cache
+    cachedJacValid = 0;
+
+    // The threaded assembly does not split the element loop - wait
+    // for any outstanding distribution of the variables
+    finishDistributingVariables();
+
     tacsPInfo->assembler = this;
     tacsPInfo->res = residual;
     tacsPInfo->mat = A;
@@ -4283,89 +6988,590 @@ void TACSAssembler::assembleJacobian(TacsScalar alpha, TacsScalar beta,
     tacsPInfo->lambda = lambda;
     tacsPInfo->matOr = matOr;
 
-    // Create the joinable attribute
-    pthread_attr_t attr;
-    pthread_attr_init(&attr);
-    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-
-    for (int k = 0; k < thread_info->getNumThreads(); k++) {
-      pthread_create(&threads[k], &attr, TACSAssembler::assembleJacobian_thread,
-                     (void *)tacsPInfo);
+    // Compute the element coloring on the first threaded call
+    if (!elementColorList) {
+      computeElementColoring();
     }
 
-    // Join all the threads
-    for (int k = 0; k < thread_info->getNumThreads(); k++) {
-      pthread_join(threads[k], NULL);
+    // Materialize the ghost storage of the residual up front: the
+    // lock-free scatter below writes ghost entries concurrently, and
+    // the lazy allocation on first ghost access is not thread-safe
+    if (residual) {
+      residual->initExtArray();
     }
 
-    // Destroy the attribute
-    pthread_attr_destroy(&attr);
+    // Run one job per color. The elements within each color have
+    // disjoint node sets, so the workers scatter into the matrix and
+    // residual without taking the assembly mutex.
+    TACSThreadPool *pool = getThreadPool();
+    for (int c = 0; c < numElementColors; c++) {
+      tacsPInfo->elemSchedList = &elementColorList[elementColorPtr[c]];
+      pool->initSchedule(elementColorPtr[c + 1] - elementColorPtr[c]);
+      pool->run(TACSAssembler::assembleJacobian_thread, (void *)tacsPInfo);
+    }
+    tacsPInfo->elemSchedList = NULL;
   } else {
-    // Retrieve pointers to temporary storage
-    TacsScalar *vars, *dvars, *ddvars, *elemRes, *elemXpts;
-    TacsScalar *elemWeights, *elemMat;
-    getDataPointers(elementData, &vars, &dvars, &ddvars, &elemRes, &elemXpts,
-                    NULL, &elemWeights, &elemMat);
+    // Compute the interior/boundary element split on the first call
+    if (!elementBoundaryFlag) {
+      computeBoundaryElements();
+    }
+
+    // Retrieve the pointer to the dependent node weight storage
+    TacsScalar *elemWeights;
+    getDataPointers(elementData, NULL, NULL, NULL, NULL, NULL, NULL,
+                    &elemWeights, NULL);
 
     // Set the data for the auxiliary elements - if there are any
-    int naux = 0, aux_count = 0;
+    int naux = 0;
     TACSAuxElem *aux = NULL;
     if (auxElements) {
       naux = auxElements->getAuxElements(&aux);
     }
 
-    for (int i = 0; i < numElements; i++) {
-      int ptr = elementNodeIndex[i];
-      int len = elementNodeIndex[i + 1] - ptr;
-      const int *nodes = &elementTacsNodes[ptr];
-      xptVec->getValues(len, nodes, elemXpts);
-      varsVec->getValues(len, nodes, vars);
-      dvarsVec->getValues(len, nodes, dvars);
-      ddvarsVec->getValues(len, nodes, ddvars);
+    // Set the staging storage for batches of elements. Contiguous
+    // runs of elements that share the same element object are staged
+    // into element-contiguous arrays and evaluated with a single call
+    // to addJacobianBatch(). The Jacobian staging carries the full
+    // element matrix for every staged element, so the batch size is
+    // smaller than the residual batch size and the storage is
+    // allocated separately on the first call.
+    const int batchSize = TACS_JACOBIAN_BATCH_SIZE;
+    int s = maxElementSize;
+    int sx = 3 * maxElementNodes;
+    if (!batchJacData) {
+      batchJacData = new TacsScalar[batchSize * (4 * s + sx + s * s)];
+    }
+    if (!batchIData) {
+      batchIData = new int[TACS_RESIDUAL_BATCH_SIZE];
+    }
+    TacsScalar *batchVars = &batchJacData[0];
+    TacsScalar *batchDvars = &batchJacData[batchSize * s];
+    TacsScalar *batchDdvars = &batchJacData[2 * batchSize * s];
+    TacsScalar *batchRes = &batchJacData[3 * batchSize * s];
+    TacsScalar *batchXpts = &batchJacData[4 * batchSize * s];
+    TacsScalar *batchMat = &batchJacData[batchSize * (4 * s + sx)];
+    int *batchIndex = batchIData;
+
+    // Check whether the cached element Jacobians can be re-used. The
+    // residual depends on the state at every element, so the
+    // incremental path only applies to matrix-only assembly.
+    int incremental = 0;
+    if (useIncrementalAssembly) {
+      if (!cachedElemJac) {
+        cachedElemJac = new TacsScalar[(size_t)s * s * numElements];
+      }
+      if (!elementDirtyFlags) {
+        elementDirtyFlags = new int[numElements];
+        memset(elementDirtyFlags, 0, numElements * sizeof(int));
+      }
+      if (cachedJacValid && !residual && time == cachedJacTime &&
+          alpha == cachedJacAlpha && beta == cachedJacBeta &&
+          gamma == cachedJacGamma && lambda == cachedJacLambda &&
+          matOr == cachedJacMatOr) {
+        incremental = 1;
+      }
+    }
 
-      // Get the number of variables from the element
-      int nvars = elements[i]->getNumVariables();
+    // The block-sparse scatter can only be used when the element
+    // matrix is added without re-weighting or transposition
+    const int sparseOK = (matOr == TACS_MAT_NORMAL && numDependentNodes == 0);
+    if (sparseOK && !jacBlockPattern) {
+      jacBlockPattern = new int[maxElementNodes * maxElementNodes];
+    }
 
-      // Compute and add the contributions to the Jacobian
-      memset(elemRes, 0, nvars * sizeof(TacsScalar));
-      memset(elemMat, 0, nvars * nvars * sizeof(TacsScalar));
-      elements[i]->addJacobian(i, time, alpha, beta, gamma, elemXpts, vars,
-                               dvars, ddvars, elemRes, elemMat);
+    // Rebuild the cached linear-element matrices if the nodes, the
+    // design variables or - when a cached element carries a constant
+    // load - the simulation time have changed since the cache was
+    // built
+    if (useLinearElemCache &&
+        (!linearCacheValid || linearCacheNodeVersion != nodeVersion ||
+         (linearCacheHasLoad && linearCacheTime != time))) {
+      computeLinearElementCache();
+    }
+    const int linearOK =
+        (useLinearElemCache && linearCacheValid && numLinearElems > 0);
+
+    // Process the interior elements first, while the halo exchange
+    // started by setVariables() may still be in flight; complete the
+    // distribution and then process the boundary elements. If no
+    // distribution is pending, all elements are handled in one pass.
+    int npasses = (pendingVarsDist ? 2 : 1);
+
+    for (int pass = 0; pass < npasses; pass++) {
+      if (pass == 1) {
+        finishDistributingVariables();
+      }
+
+      // The cursor into the sorted auxiliary element list. Each pass
+      // visits its elements in ascending order, so the entries that
+      // are skipped here belong to elements in the other pass.
+      int aux_count = 0;
+
+      for (int i = 0; i < numElements;) {
+        // Fast path for the cached linear elements: the element matrix
+        // is the coefficient combination of the stored constant blocks
+        // and the residual follows from direct matrix-vector products
+        if (linearOK && linearElemSize[i] > 0) {
+          if (!(npasses == 2 && elementBoundaryFlag[i] != pass)) {
+            if (incremental && !elementDirtyFlags[i]) {
+              // The cached Jacobian for this element is still valid
+              addMatValues(A, i, &cachedElemJac[(size_t)s * s * i],
+                           elementIData, elemWeights, matOr);
+            } else {
+              double tstart = 0.0;
+              if (recordElementTime) {
+                tstart = MPI_Wtime();
+              }
+              int nvars = linearElemSize[i];
+              int flags = linearElemFlags[i];
+              const TacsScalar *data = &linearElemData[linearElemOffset[i]];
+              const TacsScalar *r0 = NULL, *Kc = NULL, *Cc = NULL, *Mc = NULL;
+              if (flags & TACS_LINEAR_ELEM_R0) {
+                r0 = data;
+                data += nvars;
+              }
+              if (flags & TACS_LINEAR_ELEM_K) {
+                Kc = data;
+                data += nvars * nvars;
+              }
+              if (flags & TACS_LINEAR_ELEM_C) {
+                Cc = data;
+                data += nvars * nvars;
+              }
+              if (flags & TACS_LINEAR_ELEM_M) {
+                Mc = data;
+              }
+
+              // Combine the stored blocks into the element matrix
+              TacsScalar *elemMat = batchMat;
+              memset(elemMat, 0, nvars * nvars * sizeof(TacsScalar));
+              if (Kc) {
+                for (int jj = 0; jj < nvars * nvars; jj++) {
+                  elemMat[jj] += alpha * Kc[jj];
+                }
+              }
+              if (Cc) {
+                for (int jj = 0; jj < nvars * nvars; jj++) {
+                  elemMat[jj] += beta * Cc[jj];
+                }
+              }
+              if (Mc) {
+                for (int jj = 0; jj < nvars * nvars; jj++) {
+                  elemMat[jj] += gamma * Mc[jj];
+                }
+              }
+
+              // Assemble the residual from the stored blocks
+              TacsScalar *elemRes = batchRes;
+              int gathered = 0;
+              memset(elemRes, 0, nvars * sizeof(TacsScalar));
+              if (residual) {
+                if (r0) {
+                  memcpy(elemRes, r0, nvars * sizeof(TacsScalar));
+                }
+                if (Kc) {
+                  getVecValuesPlan(varsVec, i, batchVars);
+                  gathered |= 1;
+                  addLinearElemMatVec(nvars, Kc, batchVars, elemRes);
+                }
+                if (Cc) {
+                  getVecValuesPlan(dvarsVec, i, batchDvars);
+                  gathered |= 2;
+                  addLinearElemMatVec(nvars, Cc, batchDvars, elemRes);
+                }
+                if (Mc) {
+                  getVecValuesPlan(ddvarsVec, i, batchDdvars);
+                  gathered |= 4;
+                  addLinearElemMatVec(nvars, Mc, batchDdvars, elemRes);
+                }
+              }
+
+              // Advance past the entries for elements in the other pass
+              while (aux_count < naux && aux[aux_count].num < i) {
+                aux_count++;
+              }
+
+              // Auxiliary elements attached to a cached element go
+              // through the general interface - gather the node
+              // locations and any state arrays not already loaded
+              int num_aux_elem = 0;
+              if (aux_count < naux && aux[aux_count].num == i) {
+                getVecValuesPlan(xptVec, i, batchXpts);
+                if (!(gathered & 1)) {
+                  getVecValuesPlan(varsVec, i, batchVars);
+                }
+                if (!(gathered & 2)) {
+                  getVecValuesPlan(dvarsVec, i, batchDvars);
+                }
+                if (!(gathered & 4)) {
+                  getVecValuesPlan(ddvarsVec, i, batchDdvars);
+                }
+                while (aux_count < naux && aux[aux_count].num == i) {
+                  aux[aux_count].elem->addJacobian(
+                      i, time, alpha * lambda, beta * lambda, gamma * lambda,
+                      batchXpts, batchVars, batchDvars, batchDdvars, elemRes,
+                      elemMat);
+                  aux_count++;
+                  num_aux_elem++;
+                }
+              }
+
+              // Store the contribution for the incremental path
+              if (useIncrementalAssembly) {
+                memcpy(&cachedElemJac[(size_t)s * s * i], elemMat,
+                       nvars * nvars * sizeof(TacsScalar));
+              }
+
+              if (residual) {
+                addVecValuesPlan(residual, i, elemRes);
+              }
+
+              if (sparseOK && num_aux_elem == 0 &&
+                  elements[i]->getJacobianBlockPattern(i, jacBlockPattern)) {
+                addMatValuesSparse(A, i, elemMat, jacBlockPattern);
+              } else {
+                addMatValues(A, i, elemMat, elementIData, elemWeights, matOr);
+              }
+
+              if (recordElementTime) {
+                elementRuntime[i] += MPI_Wtime() - tstart;
+              }
+            }
+          }
+          i++;
+          continue;
+        }
+
+        // Find the contiguous run of elements that share this element
+        // object. These elements have identical types and sizes and can
+        // be evaluated as a single batch.
+        TACSElement *element = elements[i];
+        int run = 1;
+        while (run < batchSize && i + run < numElements &&
+               elements[i + run] == element) {
+          run++;
+        }
+
+        int nnodes = element->getNumNodes();
+        int nvars = element->getNumVariables();
+
+        double tstart = 0.0;
+        if (recordElementTime) {
+          tstart = MPI_Wtime();
+        }
+
+        // Gather the elements belonging to this pass into the
+        // staging arrays
+        int nb = 0;
+        for (int k = 0; k < run; k++) {
+          if (npasses == 2 && elementBoundaryFlag[i + k] != pass) {
+            continue;
+          }
+          if (incremental && !elementDirtyFlags[i + k]) {
+            // The cached Jacobian for this element is still valid -
+            // scatter it into the matrix without recomputing it
+            addMatValues(A, i + k, &cachedElemJac[(size_t)s * s * (i + k)],
+                         elementIData, elemWeights, matOr);
+            continue;
+          }
+          getVecValuesPlan(xptVec, i + k, &batchXpts[3 * nnodes * nb]);
+          getVecValuesPlan(varsVec, i + k, &batchVars[nvars * nb]);
+          getVecValuesPlan(dvarsVec, i + k, &batchDvars[nvars * nb]);
+          getVecValuesPlan(ddvarsVec, i + k, &batchDdvars[nvars * nb]);
+          batchIndex[nb] = i + k;
+          nb++;
+        }
+
+        if (nb > 0) {
+          memset(batchRes, 0, nb * nvars * sizeof(TacsScalar));
+          memset(batchMat, 0, nb * nvars * nvars * sizeof(TacsScalar));
+
+          // Evaluate the entire batch of element Jacobians
+          element->addJacobianBatch(nb, batchIndex, time, alpha, beta, gamma,
+                                    batchXpts, batchVars, batchDvars,
+                                    batchDdvars, batchRes, batchMat);
+
+          // Add the auxiliary element contributions and scatter the
+          // residuals and matrices back element-by-element
+          for (int k = 0; k < nb; k++) {
+            int elem = batchIndex[k];
+            TacsScalar *elemXpts = &batchXpts[3 * nnodes * k];
+            TacsScalar *vars = &batchVars[nvars * k];
+            TacsScalar *dvars = &batchDvars[nvars * k];
+            TacsScalar *ddvars = &batchDdvars[nvars * k];
+            TacsScalar *elemRes = &batchRes[nvars * k];
+            TacsScalar *elemMat = &batchMat[nvars * nvars * k];
+
+            // Advance past the entries for elements in the other pass
+            while (aux_count < naux && aux[aux_count].num < elem) {
+              aux_count++;
+            }
+
+            // Add the contribution to the residual and the Jacobian from
+            // the auxiliary elements - if any, this is scaled by the
+            // loadFactor lambda
+            int num_aux_elem = 0;
+            while (aux_count < naux && aux[aux_count].num == elem) {
+              aux[aux_count].elem->addJacobian(elem, time, alpha * lambda,
+                                               beta * lambda, gamma * lambda,
+                                               elemXpts, vars, dvars, ddvars,
+                                               elemRes, elemMat);
+              aux_count++;
+              num_aux_elem++;
+            }
+
+            // Store the contribution - including the auxiliary terms -
+            // for re-use by the incremental assembly path
+            if (useIncrementalAssembly) {
+              memcpy(&cachedElemJac[(size_t)s * s * elem], elemMat,
+                     nvars * nvars * sizeof(TacsScalar));
+            }
+
+            if (residual) {
+              addVecValuesPlan(residual, elem, elemRes);
+            }
+
+            // Scatter the element matrix, skipping the structurally
+            // zero sub-blocks when the element declares its pattern.
+            // Auxiliary contributions are not bound by the pattern, so
+            // elements with auxiliary terms use the dense scatter
+            if (sparseOK && num_aux_elem == 0 &&
+                element->getJacobianBlockPattern(elem, jacBlockPattern)) {
+              addMatValuesSparse(A, elem, elemMat, jacBlockPattern);
+            } else {
+              addMatValues(A, elem, elemMat, elementIData, elemWeights, matOr);
+            }
+          }
+
+          // Spread the measured batch time over its elements
+          if (recordElementTime) {
+            double dt = (MPI_Wtime() - tstart) / nb;
+            for (int k = 0; k < nb; k++) {
+              elementRuntime[batchIndex[k]] += dt;
+            }
+          }
+        }
+
+        i += run;
+      }
+    }
+
+    // The cache now matches the matrix contents for this set of
+    // coefficients, and every dirty element has been recomputed
+    if (useIncrementalAssembly) {
+      cachedJacValid = 1;
+      cachedJacTime = time;
+      cachedJacAlpha = alpha;
+      cachedJacBeta = beta;
+      cachedJacGamma = gamma;
+      cachedJacLambda = lambda;
+      cachedJacMatOr = matOr;
+      memset(elementDirtyFlags, 0, numElements * sizeof(int));
+    }
+  }
+
+  // Do any matrix and residual assembly if required. With halo element
+  // replicas the off-processor contributions are computed redundantly
+  // by their owners and the reverse exchange is skipped
+  if (numHaloElements == 0) {
+    A->beginAssembly();
+    if (residual) {
+      residual->beginSetValues(TACS_ADD_VALUES);
+    }
+
+    A->endAssembly();
+    if (residual) {
+      residual->endSetValues(TACS_ADD_VALUES);
+    }
+  }
+
+  // Apply the boundary conditions
+  if (residual) {
+    residual->applyBCs(bcMap, varsVec);
+  }
+
+  // Apply the appropriate boundary conditions
+  A->applyBCs(bcMap);
+}
+
+// Static data for the canonical-element comparator: the quantized
+// node-relative coordinate key of each element and the element
+// objects themselves. Note that this is not thread-safe.
+static const long long *canonical_qcoords = NULL;
+static TACSElement *const *canonical_elements = NULL;
+static int canonical_key_len = 0;
+
+/*
+  Compare two elements by their element object and their quantized
+  node-relative geometry, breaking ties by the element index so that
+  the members of each equivalence class sort into ascending order
+*/
+static int compare_canonical_elements(const void *a, const void *b) {
+  int ia = *(const int *)a;
+  int ib = *(const int *)b;
+  TACSElement *ea = canonical_elements[ia];
+  TACSElement *eb = canonical_elements[ib];
+  if (ea != eb) {
+    return (ea < eb ? -1 : 1);
+  }
+  const long long *qa = &canonical_qcoords[canonical_key_len * (size_t)ia];
+  const long long *qb = &canonical_qcoords[canonical_key_len * (size_t)ib];
+  for (int k = 0; k < canonical_key_len; k++) {
+    if (qa[k] < qb[k]) {
+      return -1;
+    } else if (qa[k] > qb[k]) {
+      return 1;
+    }
+  }
+  return ia - ib;
+}
+
+/*
+  Check whether two elements fall in the same equivalence class
+*/
+static int canonical_elements_match(int ia, int ib) {
+  return (canonical_elements[ia] == canonical_elements[ib] &&
+          memcmp(&canonical_qcoords[canonical_key_len * (size_t)ia],
+                 &canonical_qcoords[canonical_key_len * (size_t)ib],
+                 canonical_key_len * sizeof(long long)) == 0);
+}
+
+/**
+  Group the elements into canonical equivalence classes
+
+  Two elements fall in the same class when they share the same element
+  object - and with it the constitutive state - and their node
+  coordinates relative to their first node agree to within a relative
+  tolerance, i.e. when one element is a translated copy of the other.
+  The comparison quantizes the relative coordinates by the tolerance,
+  so copies that straddle a quantization boundary may conservatively
+  land in separate classes - a missed match costs only the matrix
+  computation that would have been saved. Only the classes with at
+  least two members are retained; every other element keeps the class
+  number -1 and computes its matrix directly.
+*/
+void TACSAssembler::computeElementMatClasses() {
+  // Free the classes computed for the previous node locations
+  if (elemMatClass) {
+    delete[] elemMatClass;
+    elemMatClass = NULL;
+  }
+  if (matClassElems) {
+    delete[] matClassElems;
+    matClassElems = NULL;
+  }
+  if (matClassMats) {
+    delete[] matClassMats;
+    matClassMats = NULL;
+  }
+  numMatClasses = 0;
 
-      // Add the contribution to the residual and the Jacobian from the
-      // auxiliary elements - if any, this is scaled by the loadFactor lambda
-      while (aux_count < naux && aux[aux_count].num == i) {
-        aux[aux_count].elem->addJacobian(i, time, alpha * lambda, beta * lambda,
-                                         gamma * lambda, elemXpts, vars, dvars,
-                                         ddvars, elemRes, elemMat);
-        aux_count++;
-      }
+  // Retrieve the scratch array for the element node locations
+  TacsScalar *elemXpts;
+  getDataPointers(elementData, NULL, NULL, NULL, NULL, &elemXpts, NULL, NULL,
+                  NULL);
+
+  // In the complex and dual builds the perturbation lane of the
+  // coordinates enters the key, so a perturbed copy - the node
+  // perturbation of a complex-step sensitivity, for example - is
+  // never shared with its unperturbed counterparts
+#if defined(TACS_USE_COMPLEX) || defined(TACS_USE_DUAL)
+  const int nlanes = 2;
+#else
+  const int nlanes = 1;
+#endif
+  const int key_len = nlanes * 3 * maxElementNodes;
 
-      if (residual) {
-        residual->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
+  // Compute the coordinate scale that sets the relative tolerance
+  double scale = 0.0;
+  for (int i = 0; i < numElements; i++) {
+    int ptr = elementNodeIndex[i];
+    int len = elementNodeIndex[i + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    for (int k = 0; k < 3 * len; k++) {
+      double xk = fabs(TacsRealPart(elemXpts[k]));
+      if (xk > scale) {
+        scale = xk;
       }
-      addMatValues(A, i, elemMat, elementIData, elemWeights, matOr);
     }
   }
-
-  // Do any matrix and residual assembly if required
-  A->beginAssembly();
-  if (residual) {
-    residual->beginSetValues(TACS_ADD_VALUES);
+  if (scale == 0.0) {
+    scale = 1.0;
   }
+  const double tol = 1e-8 * scale;
 
-  A->endAssembly();
-  if (residual) {
-    residual->endSetValues(TACS_ADD_VALUES);
+  // Quantize the node-relative coordinates of each element. The key
+  // entries of the nodes past the element length stay zero.
+  long long *qcoords = new long long[key_len * (size_t)numElements];
+  memset(qcoords, 0, key_len * (size_t)numElements * sizeof(long long));
+  int *order = new int[numElements];
+  for (int i = 0; i < numElements; i++) {
+    order[i] = i;
+
+    int ptr = elementNodeIndex[i];
+    int len = elementNodeIndex[i + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+
+    long long *q = &qcoords[key_len * (size_t)i];
+    for (int k = 3; k < 3 * len; k++) {
+      TacsScalar rel = elemXpts[k] - elemXpts[k % 3];
+      q[nlanes * k] = llround(TacsRealPart(rel) / tol);
+#if defined(TACS_USE_COMPLEX)
+      q[nlanes * k + 1] = llround(TacsImagPart(rel) / tol);
+#elif defined(TACS_USE_DUAL)
+      q[nlanes * k + 1] = llround(TacsDualPart(rel) / tol);
+#endif
+    }
+  }
+
+  // Sort the elements so that the members of each class are adjacent
+  canonical_qcoords = qcoords;
+  canonical_elements = elements;
+  canonical_key_len = key_len;
+  qsort(order, numElements, sizeof(int), compare_canonical_elements);
+
+  // Scan the sorted order and assign class numbers to the runs of
+  // matching elements with at least two members. The first - lowest
+  // numbered - member of each run becomes the representative.
+  elemMatClass = new int[numElements];
+  for (int i = 0; i < numElements; i++) {
+    elemMatClass[i] = -1;
+  }
+  int *rep = new int[numElements];
+  int start = 0;
+  while (start < numElements) {
+    int end = start + 1;
+    while (end < numElements &&
+           canonical_elements_match(order[start], order[end])) {
+      end++;
+    }
+    if (end - start > 1) {
+      rep[numMatClasses] = order[start];
+      for (int p = start; p < end; p++) {
+        elemMatClass[order[p]] = numMatClasses;
+      }
+      numMatClasses++;
+    }
+    start = end;
   }
 
-  // Apply the boundary conditions
-  if (residual) {
-    residual->applyBCs(bcMap, varsVec);
+  // Keep the representative list and allocate one matrix slot for
+  // each shared class
+  if (numMatClasses > 0) {
+    matClassElems = new int[numMatClasses];
+    memcpy(matClassElems, rep, numMatClasses * sizeof(int));
+    matClassMats =
+        new TacsScalar[maxElementSize * (size_t)maxElementSize * numMatClasses];
   }
+  delete[] rep;
+  delete[] order;
+  delete[] qcoords;
+  canonical_qcoords = NULL;
+  canonical_elements = NULL;
 
-  // Apply the appropriate boundary conditions
-  A->applyBCs(bcMap);
+  matClassNodeVersion = nodeVersion;
 }
 
 /**
@@ -4381,35 +7587,47 @@ void TACSAssembler::assembleJacobian(TacsScalar alpha, TacsScalar beta,
 void TACSAssembler::assembleMatType(ElementMatrixType matType, TACSMat *A,
                                     MatrixOrientation matOr,
                                     const TacsScalar lambda) {
+  finishDistributingVariables();
+
   // Zero the matrix
   A->zeroEntries();
 
+  // Group the identical elements and compute the shared matrix of
+  // each equivalence class once, so that both the serial and the
+  // threaded loops below only copy the class matrices
+  if (useCanonicalElements) {
+    if (!elemMatClass || matClassNodeVersion != nodeVersion) {
+      computeElementMatClasses();
+    }
+
+    TacsScalar *vars, *elemXpts;
+    getDataPointers(elementData, &vars, NULL, NULL, NULL, &elemXpts, NULL, NULL,
+                    NULL);
+
+    const int s2 = maxElementSize * maxElementSize;
+    for (int c = 0; c < numMatClasses; c++) {
+      int i = matClassElems[c];
+      int ptr = elementNodeIndex[i];
+      int len = elementNodeIndex[i + 1] - ptr;
+      const int *nodes = &elementTacsNodes[ptr];
+      xptVec->getBlockedValues(len, nodes, elemXpts);
+      varsVec->getBlockedValues(len, nodes, vars);
+      elements[i]->getMatType(matType, i, time, elemXpts, vars,
+                              &matClassMats[s2 * (size_t)c]);
+    }
+  }
+
   if (thread_info->getNumThreads() > 1) {
-    // Set the number of completed elements to zero
-    numCompletedElements = 0;
     tacsPInfo->assembler = this;
     tacsPInfo->mat = A;
     tacsPInfo->matType = matType;
     tacsPInfo->matOr = matOr;
     tacsPInfo->lambda = lambda;
 
-    // Create the joinable attribute
-    pthread_attr_t attr;
-    pthread_attr_init(&attr);
-    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-
-    for (int k = 0; k < thread_info->getNumThreads(); k++) {
-      pthread_create(&threads[k], &attr, TACSAssembler::assembleMatType_thread,
-                     (void *)tacsPInfo);
-    }
-
-    // Join all the threads
-    for (int k = 0; k < thread_info->getNumThreads(); k++) {
-      pthread_join(threads[k], NULL);
-    }
-
-    // Destroy the attribute
-    pthread_attr_destroy(&attr);
+    // Schedule the elements and run the assembly on the pool
+    TACSThreadPool *pool = getThreadPool();
+    pool->initSchedule(numElements);
+    pool->run(TACSAssembler::assembleMatType_thread, (void *)tacsPInfo);
   } else {
     // Retrieve pointers to temporary storage
     TacsScalar *vars, *elemXpts, *elemMat, *elemWeights;
@@ -4423,10 +7641,9 @@ void TACSAssembler::assembleMatType(ElementMatrixType matType, TACSMat *A,
       naux = auxElements->getAuxElements(&aux);
     }
 
-    // To avoid allocating memory inside the element loop, make the aux element
-    // contribution mat big enough for the largest element
-    int maxNVar = this->maxElementSize;
-    TacsScalar *auxElemMat = new TacsScalar[maxNVar * maxNVar];
+    // The scratch block past the getDataPointers() layout is big
+    // enough for the aux element matrix of the largest element
+    TacsScalar *auxElemMat = &elementData[elementDataSize];
 
     for (int i = 0; i < numElements; i++) {
       // Retrieve the element variables and node locations
@@ -4434,11 +7651,22 @@ void TACSAssembler::assembleMatType(ElementMatrixType matType, TACSMat *A,
       int len = elementNodeIndex[i + 1] - ptr;
       int nvars = elements[i]->getNumVariables();
       const int *nodes = &elementTacsNodes[ptr];
-      xptVec->getValues(len, nodes, elemXpts);
-      varsVec->getValues(len, nodes, vars);
-
-      // Get the element matrix
-      elements[i]->getMatType(matType, i, time, elemXpts, vars, elemMat);
+      xptVec->getBlockedValues(len, nodes, elemXpts);
+      varsVec->getBlockedValues(len, nodes, vars);
+
+      // Get the element matrix, or copy the shared matrix of the
+      // element's equivalence class
+      int c = -1;
+      if (useCanonicalElements && elemMatClass) {
+        c = elemMatClass[i];
+      }
+      if (c >= 0) {
+        const int s2 = maxElementSize * maxElementSize;
+        memcpy(elemMat, &matClassMats[s2 * (size_t)c],
+               nvars * nvars * sizeof(TacsScalar));
+      } else {
+        elements[i]->getMatType(matType, i, time, elemXpts, vars, elemMat);
+      }
 
       // Add the contribution from any auxiliary elements,  they need to be
       // scaled first
@@ -4454,11 +7682,12 @@ void TACSAssembler::assembleMatType(ElementMatrixType matType, TACSMat *A,
       // Add the values into the element
       addMatValues(A, i, elemMat, elementIData, elemWeights, matOr);
     }
-    delete[] auxElemMat;
   }
 
-  A->beginAssembly();
-  A->endAssembly();
+  if (numHaloElements == 0) {
+    A->beginAssembly();
+    A->endAssembly();
+  }
 
   A->applyBCs(bcMap);
 }
@@ -4467,7 +7696,13 @@ void TACSAssembler::assembleMatType(ElementMatrixType matType, TACSMat *A,
   Assemble a linear combination of matrices.
 
   This is used for some buckling/eigenvalue computations which require
-  matrices that are linear combinations of specific types.
+  matrices that are linear combinations of specific types, and for
+  Rayleigh damping matrices of the form C = alpha*M + beta*K.
+
+  The element matrices of all the types are combined into a single
+  element matrix before it is scattered, so each element performs one
+  scatter into the sparse matrix regardless of the number of terms in
+  the combination.
 
   @param matTypes The array of matrix types
   @param scale The array of scalar values
@@ -4480,6 +7715,8 @@ void TACSAssembler::assembleMatCombo(ElementMatrixType matTypes[],
                                      TacsScalar scale[], int nmats, TACSMat *A,
                                      MatrixOrientation matOr,
                                      TacsScalar lambda) {
+  finishDistributingVariables();
+
   // Zero the matrix
   A->zeroEntries();
 
@@ -4495,133 +7732,601 @@ void TACSAssembler::assembleMatCombo(ElementMatrixType matTypes[],
     naux = auxElements->getAuxElements(&aux);
   }
 
-  // To avoid allocating memory inside the element loop, make the aux element
-  // contribution mat big enough for the largest element
-  int maxNVar = this->maxElementSize;
-  TacsScalar *auxElemMat = NULL;
-  bool scaleAux = lambda != TacsScalar(1.0) && naux > 0;
-  if (scaleAux) {
-    auxElemMat = new TacsScalar[maxNVar * maxNVar];
-  }
+  // The scratch block past the getDataPointers() layout holds the
+  // matrix of a single term while it is accumulated into the combined
+  // element matrix
+  TacsScalar *termMat = &elementData[elementDataSize];
 
   for (int i = 0; i < numElements; i++) {
     // Retrieve the element variables and node locations
     int ptr = elementNodeIndex[i];
     int len = elementNodeIndex[i + 1] - ptr;
+    int nvars = elements[i]->getNumVariables();
     const int *nodes = &elementTacsNodes[ptr];
-    xptVec->getValues(len, nodes, elemXpts);
-    varsVec->getValues(len, nodes, vars);
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
 
+    // Accumulate the combined element matrix across the terms
+    memset(elemMat, 0, nvars * nvars * sizeof(TacsScalar));
+    int aux_start = aux_count;
     for (int j = 0; j < nmats; j++) {
-      // Get the element matrix
-      elements[i]->getMatType(matTypes[j], i, time, elemXpts, vars, elemMat);
+      // Get the element matrix for this term
+      elements[i]->getMatType(matTypes[j], i, time, elemXpts, vars, termMat);
+      for (int ii = 0; ii < nvars * nvars; ii++) {
+        elemMat[ii] += scale[j] * termMat[ii];
+      }
 
-      // Add the contribution from any auxiliary elements, if the load factor is
-      // 1 they can be added straight to the elemRes, otherwise they need to be
-      // scaled first
-      int nvars = elements[i]->getNumVariables();
-      if (!scaleAux) {
-        while (aux_count < naux && aux[aux_count].num == i) {
-          aux[aux_count].elem->getMatType(matTypes[j], i, time, elemXpts, vars,
-                                          elemMat);
-          aux_count++;
-        }
-      } else {
-        memset(auxElemMat, 0, maxNVar * maxNVar * sizeof(TacsScalar));
-        while (aux_count < naux && aux[aux_count].num == i) {
-          aux[aux_count].elem->getMatType(matTypes[j], i, time, elemXpts, vars,
-                                          auxElemMat);
-          aux_count++;
-        }
+      // Add the contribution from any auxiliary elements to each term,
+      // scaled by the load factor and the term coefficient
+      aux_count = aux_start;
+      while (aux_count < naux && aux[aux_count].num == i) {
+        aux[aux_count].elem->getMatType(matTypes[j], i, time, elemXpts, vars,
+                                        termMat);
         for (int ii = 0; ii < nvars * nvars; ii++) {
-          elemMat[ii] += lambda * auxElemMat[ii];
+          elemMat[ii] += lambda * scale[j] * termMat[ii];
         }
+        aux_count++;
+      }
+    }
+
+    // Add the values into the element
+    addMatValues(A, i, elemMat, elementIData, elemWeights, matOr);
+  }
+
+  if (numHaloElements == 0) {
+    A->beginAssembly();
+    A->endAssembly();
+  }
+
+  A->applyBCs(bcMap);
+}
+
+/**
+  Assemble the diagonal of a matrix of a specified type.
+
+  This computes the element matrices, but only scatters their diagonal
+  entries into the output vector. This provides the diagonal scaling
+  required by Jacobi-type smoothers without storing the full matrix,
+  which is useful when the matrix itself is only applied matrix-free.
+
+  For the Jacobian matrix, the coefficients alpha, beta and gamma
+  define the linear combination of the state and time derivative
+  contributions. For all other matrix types, the diagonal entries are
+  scaled by alpha.
+
+  The entries associated with the boundary conditions are zeroed,
+  consistent with the vector-level applyBCs() operation.
+
+  @param matType The matrix type
+  @param alpha Coefficient for the variables
+  @param beta Coefficient for the first time derivative terms
+  @param gamma Coefficient for the second time derivative terms
+  @param diag The vector of matrix diagonal entries (output)
+*/
+void TACSAssembler::assembleMatDiag(ElementMatrixType matType, TacsScalar alpha,
+                                    TacsScalar beta, TacsScalar gamma,
+                                    TACSBVec *diag) {
+  finishDistributingVariables();
+
+  // Zero the diagonal values
+  diag->zeroEntries();
+
+  // Retrieve pointers to temporary storage
+  TacsScalar *vars, *dvars, *ddvars, *elemRes, *elemXpts, *elemMat;
+  getDataPointers(elementData, &vars, &dvars, &ddvars, &elemRes, &elemXpts,
+                  NULL, NULL, &elemMat);
+
+  // Get the auxiliary elements
+  int naux = 0, aux_count = 0;
+  TACSAuxElem *aux = NULL;
+  if (auxElements) {
+    naux = auxElements->getAuxElements(&aux);
+  }
+
+  // Extract the diagonal entries of the element matrix into the
+  // scratch block past the getDataPointers() layout
+  TacsScalar *elemDiag = &elementData[elementDataSize];
+
+  for (int i = 0; i < numElements; i++) {
+    // Retrieve the element variables and node locations
+    int ptr = elementNodeIndex[i];
+    int len = elementNodeIndex[i + 1] - ptr;
+    int nvars = elements[i]->getNumVariables();
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
+
+    if (matType == TACS_JACOBIAN_MATRIX) {
+      dvarsVec->getBlockedValues(len, nodes, dvars);
+      ddvarsVec->getBlockedValues(len, nodes, ddvars);
+
+      // Compute the element Jacobian
+      memset(elemRes, 0, nvars * sizeof(TacsScalar));
+      memset(elemMat, 0, nvars * nvars * sizeof(TacsScalar));
+      elements[i]->addJacobian(i, time, alpha, beta, gamma, elemXpts, vars,
+                               dvars, ddvars, elemRes, elemMat);
+
+      // Add the contribution from any auxiliary elements
+      while (aux_count < naux && aux[aux_count].num == i) {
+        aux[aux_count].elem->addJacobian(i, time, alpha, beta, gamma, elemXpts,
+                                         vars, dvars, ddvars, elemRes, elemMat);
+        aux_count++;
       }
 
-      // Scale the matrix
-      if (scale[j] != 1.0) {
-        int n = nvars * nvars, one = 1;
-        BLASscal(&n, &scale[j], elemMat, &one);
+      // Extract the diagonal of the element matrix
+      for (int j = 0; j < nvars; j++) {
+        elemDiag[j] = elemMat[(nvars + 1) * j];
       }
+    } else {
+      // Get the element matrix
+      elements[i]->getMatType(matType, i, time, elemXpts, vars, elemMat);
 
-      // Add the values into the element
-      addMatValues(A, i, elemMat, elementIData, elemWeights, matOr);
+      // Add the contribution from any auxiliary elements
+      while (aux_count < naux && aux[aux_count].num == i) {
+        aux[aux_count].elem->getMatType(matType, i, time, elemXpts, vars,
+                                        elemMat);
+        aux_count++;
+      }
+
+      // Extract the diagonal of the element matrix, scaled by alpha
+      for (int j = 0; j < nvars; j++) {
+        elemDiag[j] = alpha * elemMat[(nvars + 1) * j];
+      }
     }
+
+    // Add the diagonal values into the vector
+    diag->setValues(len, nodes, elemDiag, TACS_ADD_VALUES);
   }
-  if (scaleAux) {
-    delete[] auxElemMat;
+
+  // Accumulate the diagonal contributions across all processors
+  if (numHaloElements == 0) {
+    diag->beginSetValues(TACS_ADD_VALUES);
+    diag->endSetValues(TACS_ADD_VALUES);
   }
 
-  A->beginAssembly();
-  A->endAssembly();
+  // Zero the entries associated with the boundary conditions
+  diag->applyBCs(bcMap);
+}
 
-  A->applyBCs(bcMap);
+/**
+  Evaluate a list of TACS functions
+
+  First, check if the functions are initialized. Obtain the number of
+  iterations over the function domain required to evaluate the
+  functions.
+
+  This function will print an error and return 0 if the underlying
+  TACSAssembler object does not correspond to the TACSAssembler object.
+
+  @param numFuncs The number of functions to evaluate
+  @param funcs Array of functions to evaluate
+  @param funcVals The function values
+*/
+void TACSAssembler::evalFunctions(int numFuncs, TACSFunction **funcs,
+                                  TacsScalar *funcVals) {
+  // Here we will use time-independent formulation
+  TacsScalar tcoef = 1.0;
+
+  // Check whether these are two-stage or single-stage functions
+  int twoStage = 0;
+  for (int k = 0; k < numFuncs; k++) {
+    if (funcs[k] && funcs[k]->getStageType() == TACSFunction::TWO_STAGE) {
+      twoStage = 1;
+      break;
+    }
+  }
+
+  // Just be lazy and call initialize on all the functions if any
+  // function is two-stage
+  if (twoStage) {
+    for (int k = 0; k < numFuncs; k++) {
+      if (funcs[k]) {
+        funcs[k]->initEvaluation(TACSFunction::INITIALIZE);
+      }
+    }
+    integrateFunctions(tcoef, TACSFunction::INITIALIZE, numFuncs, funcs);
+    for (int k = 0; k < numFuncs; k++) {
+      if (funcs[k]) {
+        funcs[k]->finalEvaluation(TACSFunction::INITIALIZE);
+      }
+    }
+  }
+
+  // Perform the integration required to evaluate the function
+  for (int k = 0; k < numFuncs; k++) {
+    if (funcs[k]) {
+      funcs[k]->initEvaluation(TACSFunction::INTEGRATE);
+    }
+  }
+
+  integrateFunctions(tcoef, TACSFunction::INTEGRATE, numFuncs, funcs);
+
+  for (int k = 0; k < numFuncs; k++) {
+    if (funcs[k]) {
+      funcs[k]->finalEvaluation(TACSFunction::INTEGRATE);
+    }
+  }
+
+  // Retrieve the function values
+  for (int k = 0; k < numFuncs; k++) {
+    funcVals[k] = 0.0;
+    if (funcs[k]) {
+      funcVals[k] = funcs[k]->getFunctionValue();
+    }
+  }
+}
+
+/**
+  Determine which functions include the given element in their domain.
+
+  The sub-domain element lists are unique and sorted, so a cursor into
+  each list tracks the next sub-domain element as the element loop
+  advances. This allows a single sweep over the elements to evaluate
+  all of the functions at once, rather than re-streaming the mesh for
+  each function. The cursors must start at zero and the elements must
+  be visited in ascending order.
+
+  @param elemNum The element number
+  @param numFuncs The number of functions
+  @param funcs The array of functions
+  @param subDomains The sub-domain element list for each function
+  @param subDomainSizes The size of each sub-domain list
+  @param cursors The cursor into each sub-domain list
+  @param active Flag for each function in whose domain the element lies
+  @return The number of active functions for this element
+*/
+int TACSAssembler::getActiveFunctions(int elemNum, int numFuncs,
+                                      TACSFunction **funcs,
+                                      const int **subDomains,
+                                      const int *subDomainSizes, int *cursors,
+                                      int *active) {
+  int nactive = 0;
+  for (int k = 0; k < numFuncs; k++) {
+    active[k] = 0;
+    if (funcs[k]) {
+      if (funcs[k]->getDomainType() == TACSFunction::ENTIRE_DOMAIN) {
+        active[k] = 1;
+      } else if (subDomains[k]) {
+        // Advance the cursor past any entries that precede this
+        // element. Negative or out-of-range entries are skipped.
+        while (cursors[k] < subDomainSizes[k] &&
+               subDomains[k][cursors[k]] < elemNum) {
+          cursors[k]++;
+        }
+        if (cursors[k] < subDomainSizes[k] &&
+            subDomains[k][cursors[k]] == elemNum) {
+          active[k] = 1;
+        }
+      }
+      nactive += active[k];
+    }
+  }
+  return nactive;
+}
+
+/**
+  Retrieve the sub-domain element lists for each function.
+
+  @param numFuncs The number of functions
+  @param funcs The array of functions
+  @param subDomains The sub-domain element list for each function (output)
+  @param subDomainSizes The size of each sub-domain list (output)
+*/
+void TACSAssembler::getFunctionDomains(int numFuncs, TACSFunction **funcs,
+                                       const int **subDomains,
+                                       int *subDomainSizes) {
+  for (int k = 0; k < numFuncs; k++) {
+    subDomains[k] = NULL;
+    subDomainSizes[k] = 0;
+    if (funcs[k] && funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN) {
+      subDomainSizes[k] = funcs[k]->getElementNums(&subDomains[k]);
+    }
+  }
+}
+
+/**
+  Set up the restricted reverse-scatter plans for the given functions.
+
+  A function restricted to a sub-domain only writes halo contributions
+  at the external nodes touched by its domain elements, so the reverse
+  exchange that assembles its sensitivity vector can be restricted to
+  that subset. For a function defined on a single component of a large
+  model this subset is a small fraction of the full halo. The plans
+  are cached per function and rebuilt when the local element domain
+  changes.
+
+  This call is collective on the TACSAssembler communicator: the
+  decision to use a restricted plan must agree on all processors, so
+  the per-function classification is reduced across the communicator
+  before any plan is built.
+
+  @param numFuncs The number of functions
+  @param funcs The array of functions
+  @param vecs The vectors that will be assembled for each function
+  @param use_restricted Whether each function uses a restricted plan
+*/
+void TACSAssembler::setupFunctionHaloDists(int numFuncs, TACSFunction **funcs,
+                                           TACSBVec **vecs,
+                                           int *use_restricted) {
+  // Classify each function: 0 - the cached plan is current, 1 - the
+  // plan must be (re)built, 2 - the restricted exchange does not apply
+  for (int k = 0; k < numFuncs; k++) {
+    use_restricted[k] = 2;
+    if (funcs[k] && funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN &&
+        numDependentNodes == 0 && vecs[k] &&
+        vecs[k]->getBlockSize() == varsPerNode &&
+        vecs[k]->getNodeMap() == nodeMap) {
+      int index = findFunctionHaloDist(funcs[k]);
+      if (index >= 0) {
+        if (funcDistUsable[index]) {
+          // The plan is stale if the local element domain has changed
+          const int *elemNums;
+          int size = funcs[k]->getElementNums(&elemNums);
+          if (size == funcDistDomainSizes[index] &&
+              memcmp(elemNums, funcDistDomainElems[index],
+                     size * sizeof(int)) == 0) {
+            use_restricted[k] = 0;
+          } else {
+            use_restricted[k] = 1;
+          }
+        }
+      } else {
+        use_restricted[k] = 1;
+      }
+    }
+  }
+
+  // The classification must agree on all processors
+  MPI_Allreduce(MPI_IN_PLACE, use_restricted, numFuncs, MPI_INT, MPI_MAX,
+                tacs_comm);
+
+  for (int k = 0; k < numFuncs; k++) {
+    if (use_restricted[k] == 1) {
+      // Build the restricted plan - this is a collective operation
+      buildFunctionHaloDist(funcs[k], 1);
+      use_restricted[k] = 1;
+    } else if (use_restricted[k] == 2) {
+      // Record the functions that cannot use the restricted exchange
+      // so that the classification remains stable across calls
+      if (funcs[k] &&
+          funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN &&
+          findFunctionHaloDist(funcs[k]) < 0) {
+        buildFunctionHaloDist(funcs[k], 0);
+      }
+      use_restricted[k] = 0;
+    } else {
+      use_restricted[k] = 1;
+    }
+  }
+}
+
+/**
+  Find the cached restricted plan for the given function.
+
+  @param func The function of interest
+  @return The index of the cached plan, or -1 if it is not cached
+*/
+int TACSAssembler::findFunctionHaloDist(TACSFunction *func) {
+  for (int k = 0; k < numFuncDists; k++) {
+    if (funcDistFuncs[k] == func) {
+      return k;
+    }
+  }
+  return -1;
 }
 
 /**
-  Evaluate a list of TACS functions
-
-  First, check if the functions are initialized. Obtain the number of
-  iterations over the function domain required to evaluate the
-  functions.
+  Build (or rebuild) the restricted reverse-scatter plan for the
+  given function from its current element domain.
 
-  This function will print an error and return 0 if the underlying
-  TACSAssembler object does not correspond to the TACSAssembler object.
+  This call is collective on the TACSAssembler communicator.
 
-  @param numFuncs The number of functions to evaluate
-  @param funcs Array of functions to evaluate
-  @param funcVals The function values
+  @param func The function of interest
+  @param usable Whether the restricted exchange applies to the function
 */
-void TACSAssembler::evalFunctions(int numFuncs, TACSFunction **funcs,
-                                  TacsScalar *funcVals) {
-  // Here we will use time-independent formulation
-  TacsScalar tcoef = 1.0;
-
-  // Check whether these are two-stage or single-stage functions
-  int twoStage = 0;
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k] && funcs[k]->getStageType() == TACSFunction::TWO_STAGE) {
-      twoStage = 1;
-      break;
+void TACSAssembler::buildFunctionHaloDist(TACSFunction *func, int usable) {
+  int index = findFunctionHaloDist(func);
+  if (index < 0) {
+    // Extend the cache arrays if they are full
+    if (numFuncDists >= maxFuncDists) {
+      int max_dists = (maxFuncDists > 0 ? 2 * maxFuncDists : 4);
+      TACSFunction **dist_funcs = new TACSFunction *[max_dists];
+      int *domain_sizes = new int[max_dists];
+      int **domain_elems = new int *[max_dists];
+      int *dist_usable = new int[max_dists];
+      TACSBVecDistribute **dists = new TACSBVecDistribute *[max_dists];
+      TACSBVecDistCtx **ctxs = new TACSBVecDistCtx *[max_dists];
+      TacsScalar **vals = new TacsScalar *[max_dists];
+      for (int k = 0; k < numFuncDists; k++) {
+        dist_funcs[k] = funcDistFuncs[k];
+        domain_sizes[k] = funcDistDomainSizes[k];
+        domain_elems[k] = funcDistDomainElems[k];
+        dist_usable[k] = funcDistUsable[k];
+        dists[k] = funcDists[k];
+        ctxs[k] = funcDistCtxs[k];
+        vals[k] = funcDistVals[k];
+      }
+      if (funcDistFuncs) {
+        delete[] funcDistFuncs;
+        delete[] funcDistDomainSizes;
+        delete[] funcDistDomainElems;
+        delete[] funcDistUsable;
+        delete[] funcDists;
+        delete[] funcDistCtxs;
+        delete[] funcDistVals;
+      }
+      maxFuncDists = max_dists;
+      funcDistFuncs = dist_funcs;
+      funcDistDomainSizes = domain_sizes;
+      funcDistDomainElems = domain_elems;
+      funcDistUsable = dist_usable;
+      funcDists = dists;
+      funcDistCtxs = ctxs;
+      funcDistVals = vals;
+    }
+
+    index = numFuncDists;
+    numFuncDists++;
+    funcDistFuncs[index] = func;
+    func->incref();
+    funcDistDomainElems[index] = NULL;
+    funcDists[index] = NULL;
+    funcDistCtxs[index] = NULL;
+    funcDistVals[index] = NULL;
+  } else {
+    // Release the plan that is being replaced
+    if (funcDistDomainElems[index]) {
+      delete[] funcDistDomainElems[index];
+      funcDistDomainElems[index] = NULL;
+    }
+    if (funcDists[index]) {
+      funcDists[index]->decref();
+      funcDists[index] = NULL;
+    }
+    if (funcDistCtxs[index]) {
+      funcDistCtxs[index]->decref();
+      funcDistCtxs[index] = NULL;
+    }
+    if (funcDistVals[index]) {
+      delete[] funcDistVals[index];
+      funcDistVals[index] = NULL;
     }
   }
 
-  // Just be lazy and call initialize on all the functions if any
-  // function is two-stage
-  if (twoStage) {
-    for (int k = 0; k < numFuncs; k++) {
-      if (funcs[k]) {
-        funcs[k]->initEvaluation(TACSFunction::INITIALIZE);
+  const int *elemNums = NULL;
+  int size = func->getElementNums(&elemNums);
+  funcDistDomainSizes[index] = size;
+  funcDistDomainElems[index] = new int[size + 1];
+  memcpy(funcDistDomainElems[index], elemNums, size * sizeof(int));
+  funcDistUsable[index] = usable;
+
+  if (usable) {
+    // Get the ownership range
+    const int *ownerRange;
+    nodeMap->getOwnerRange(&ownerRange);
+
+    // Count an upper bound on the number of halo nodes in the domain
+    int max_nodes = 1;
+    for (int i = 0; i < size; i++) {
+      int elem = elemNums[i];
+      if (elem >= 0 && elem < numElements - numHaloElements) {
+        max_nodes +=
+            elementNodeIndex[elem + 1] - elementNodeIndex[elem];
       }
     }
-    integrateFunctions(tcoef, TACSFunction::INITIALIZE, numFuncs, funcs);
-    for (int k = 0; k < numFuncs; k++) {
-      if (funcs[k]) {
-        funcs[k]->finalEvaluation(TACSFunction::INITIALIZE);
+
+    // Collect the external nodes touched by the domain elements
+    int *ext_nodes = new int[max_nodes];
+    int num_ext = 0;
+    for (int i = 0; i < size; i++) {
+      int elem = elemNums[i];
+      if (elem >= 0 && elem < numElements - numHaloElements) {
+        int ptr = elementNodeIndex[elem];
+        int len = elementNodeIndex[elem + 1] - ptr;
+        const int *nodes = &elementTacsNodes[ptr];
+        for (int j = 0; j < len; j++) {
+          if (nodes[j] >= 0 && (nodes[j] < ownerRange[mpiRank] ||
+                                nodes[j] >= ownerRange[mpiRank + 1])) {
+            ext_nodes[num_ext] = nodes[j];
+            num_ext++;
+          }
+        }
       }
     }
-  }
 
-  // Perform the integration required to evaluate the function
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k]) {
-      funcs[k]->initEvaluation(TACSFunction::INTEGRATE);
-    }
+    // Uniquely sort the external node subset
+    num_ext = TacsUniqueSort(num_ext, ext_nodes);
+
+    // Copy the subset into an exactly-sized array - the indices
+    // object takes ownership of the array that is passed in
+    int *ext_copy = new int[num_ext + 1];
+    memcpy(ext_copy, ext_nodes, num_ext * sizeof(int));
+    delete[] ext_nodes;
+
+    TACSBVecIndices *ext_index = new TACSBVecIndices(&ext_copy, num_ext);
+    funcDists[index] = new TACSBVecDistribute(nodeMap, ext_index);
+    funcDists[index]->incref();
+    funcDistCtxs[index] = funcDists[index]->createCtx(varsPerNode);
+    funcDistCtxs[index]->incref();
+    funcDistVals[index] = new TacsScalar[varsPerNode * num_ext + 1];
   }
+}
 
-  integrateFunctions(tcoef, TACSFunction::INTEGRATE, numFuncs, funcs);
+/**
+  Begin the reverse exchange of the halo contributions written by the
+  given function, using its cached restricted plan.
 
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k]) {
-      funcs[k]->finalEvaluation(TACSFunction::INTEGRATE);
+  @param func The function of interest
+  @param vec The vector that is being assembled
+*/
+void TACSAssembler::beginFunctionHaloAssembly(TACSFunction *func,
+                                              TACSBVec *vec) {
+  int index = findFunctionHaloDist(func);
+  const int *subset;
+  int nsub = funcDists[index]->getIndices()->getIndices(&subset);
+
+  // Gather the pending halo contributions into the compact buffer.
+  // If the vector carries no external storage, the contributions are
+  // all zero
+  TacsScalar *vals = funcDistVals[index];
+  if (nsub > 0) {
+    TacsScalar *ext = NULL;
+    vec->getExtArray(&ext);
+    TACSBVecIndices *vec_index = vec->getBVecIndices();
+    if (ext && vec_index) {
+      vec_index->setUpInverse();
+      for (int i = 0; i < nsub; i++) {
+        int loc = vec_index->findIndex(subset[i]);
+        if (loc >= 0) {
+          memcpy(&vals[varsPerNode * i], &ext[varsPerNode * loc],
+                 varsPerNode * sizeof(TacsScalar));
+        } else {
+          memset(&vals[varsPerNode * i], 0,
+                 varsPerNode * sizeof(TacsScalar));
+        }
+      }
+    } else {
+      memset(vals, 0, varsPerNode * nsub * sizeof(TacsScalar));
     }
   }
 
-  // Retrieve the function values
-  for (int k = 0; k < numFuncs; k++) {
-    funcVals[k] = 0.0;
-    if (funcs[k]) {
-      funcVals[k] = funcs[k]->getFunctionValue();
+  TacsScalar *array;
+  vec->getArray(&array);
+  funcDists[index]->beginReverse(funcDistCtxs[index], vals, array,
+                                 TACS_ADD_VALUES);
+}
+
+/**
+  Finish the restricted reverse exchange started by
+  beginFunctionHaloAssembly() and zero the halo entries that were
+  consumed.
+
+  @param func The function of interest
+  @param vec The vector that is being assembled
+*/
+void TACSAssembler::endFunctionHaloAssembly(TACSFunction *func,
+                                            TACSBVec *vec) {
+  int index = findFunctionHaloDist(func);
+  TacsScalar *array;
+  vec->getArray(&array);
+  funcDists[index]->endReverse(funcDistCtxs[index], funcDistVals[index],
+                               array, TACS_ADD_VALUES);
+
+  // Zero the halo entries that were just assembled
+  const int *subset;
+  int nsub = funcDists[index]->getIndices()->getIndices(&subset);
+  if (nsub > 0) {
+    TacsScalar *ext = NULL;
+    vec->getExtArray(&ext);
+    TACSBVecIndices *vec_index = vec->getBVecIndices();
+    if (ext && vec_index) {
+      for (int i = 0; i < nsub; i++) {
+        int loc = vec_index->findIndex(subset[i]);
+        if (loc >= 0) {
+          memset(&ext[varsPerNode * loc], 0,
+                 varsPerNode * sizeof(TacsScalar));
+        }
+      }
     }
   }
 }
@@ -4630,6 +8335,10 @@ void TACSAssembler::evalFunctions(int numFuncs, TACSFunction **funcs,
   Integrate or initialize functions for a single time step of a time
   integration (or steady-state simulation).
 
+  The elements are visited once, and every function that includes an
+  element in its domain is evaluated while the element data is still
+  in cache.
+
   @param tcoef The integration coefficient
   @param ftype The type of integration to use
   @param numFuncs The number of functions
@@ -4638,56 +8347,49 @@ void TACSAssembler::evalFunctions(int numFuncs, TACSFunction **funcs,
 void TACSAssembler::integrateFunctions(TacsScalar tcoef,
                                        TACSFunction::EvaluationType ftype,
                                        int numFuncs, TACSFunction **funcs) {
+  finishDistributingVariables();
+
   // Retrieve pointers to temporary storage
   TacsScalar *vars, *dvars, *ddvars;
   TacsScalar *elemXpts;
   getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts, NULL,
                   NULL, NULL);
 
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k]) {
-      if (funcs[k]->getDomainType() == TACSFunction::ENTIRE_DOMAIN) {
-        for (int i = 0; i < numElements; i++) {
-          // Determine the values of the state variables for the
-          // current element
-          int ptr = elementNodeIndex[i];
-          int len = elementNodeIndex[i + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
-
-          // Evaluate the element-wise component of the function
-          funcs[k]->elementWiseEval(ftype, i, elements[i], time, tcoef,
-                                    elemXpts, vars, dvars, ddvars);
-        }
-      } else if (funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN) {
-        const int *elementNums;
-        int subDomainSize = funcs[k]->getElementNums(&elementNums);
-
-        for (int i = 0; i < subDomainSize; i++) {
-          int elemNum = elementNums[i];
-
-          if (elemNum >= 0 && elemNum < numElements) {
-            // Determine the values of the state variables
-            // for the current element
-            int ptr = elementNodeIndex[elemNum];
-            int len = elementNodeIndex[elemNum + 1] - ptr;
-            const int *nodes = &elementTacsNodes[ptr];
-            xptVec->getValues(len, nodes, elemXpts);
-            varsVec->getValues(len, nodes, vars);
-            dvarsVec->getValues(len, nodes, dvars);
-            ddvarsVec->getValues(len, nodes, ddvars);
-
-            // Evaluate the element-wise component of the function
-            funcs[k]->elementWiseEval(ftype, elemNum, elements[elemNum], time,
-                                      tcoef, elemXpts, vars, dvars, ddvars);
-          }
-        }
+  // Retrieve the sub-domain element lists
+  const int **subDomains;
+  int *subDomainSizes, *cursors, *active;
+  getFunctionDataPointers(numFuncs, &subDomains, &subDomainSizes, &cursors,
+                          &active);
+  getFunctionDomains(numFuncs, funcs, subDomains, subDomainSizes);
+  memset(cursors, 0, numFuncs * sizeof(int));
+
+  for (int i = 0; i < numElements - numHaloElements; i++) {
+    // Determine which functions are defined on this element
+    int nactive = getActiveFunctions(i, numFuncs, funcs, subDomains,
+                                     subDomainSizes, cursors, active);
+    if (nactive == 0) {
+      continue;
+    }
+
+    // Determine the values of the state variables for the
+    // current element
+    int ptr = elementNodeIndex[i];
+    int len = elementNodeIndex[i + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
+    dvarsVec->getBlockedValues(len, nodes, dvars);
+    ddvarsVec->getBlockedValues(len, nodes, ddvars);
+
+    // Evaluate the element-wise component of each function
+    for (int k = 0; k < numFuncs; k++) {
+      if (active[k]) {
+        funcs[k]->elementWiseEval(ftype, i, elements[i], time, tcoef, elemXpts,
+                                  vars, dvars, ddvars);
       }
     }
   }
+
 }
 
 /**
@@ -4724,6 +8426,8 @@ void TACSAssembler::integrateFunctions(TacsScalar tcoef,
 */
 void TACSAssembler::addDVSens(TacsScalar coef, int numFuncs,
                               TACSFunction **funcs, TACSBVec **dfdx) {
+  finishDistributingVariables();
+
   // Retrieve pointers to temporary storage
   TacsScalar *vars, *dvars, *ddvars, *elemXpts;
   getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts, NULL,
@@ -4734,66 +8438,51 @@ void TACSAssembler::addDVSens(TacsScalar coef, int numFuncs,
   TacsScalar *fdvSens = elementSensData;
   int *dvNums = elementSensIData;
 
-  // For each function, evaluate the derivative w.r.t. the
-  // design variables for each element
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k]) {
-      if (funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN) {
-        // Get the funcs[k] sub-domain
-        const int *elemSubList;
-        int numSubElems = funcs[k]->getElementNums(&elemSubList);
-
-        for (int i = 0; i < numSubElems; i++) {
-          int elemNum = elemSubList[i];
-          // Determine the values of the state variables for subElem
-          int ptr = elementNodeIndex[elemNum];
-          int len = elementNodeIndex[elemNum + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
-
-          // Get the design variables for this element
-          int numDVs =
-              elements[elemNum]->getDesignVarNums(elemNum, maxDVs, dvNums);
-
-          // Evaluate the element-wise sensitivity of the function
-          memset(fdvSens, 0, numDVs * designVarsPerNode * sizeof(TacsScalar));
-          funcs[k]->addElementDVSens(elemNum, elements[elemNum], time, coef,
-                                     elemXpts, vars, dvars, ddvars, maxDVs,
-                                     fdvSens);
-
-          // Add the derivative values
-          dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
-        }
-      } else if (funcs[k]->getDomainType() == TACSFunction::ENTIRE_DOMAIN) {
-        for (int elemNum = 0; elemNum < numElements; elemNum++) {
-          // Determine the values of the state variables for elemNum
-          int ptr = elementNodeIndex[elemNum];
-          int len = elementNodeIndex[elemNum + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
-
-          // Get the design variables for this element
-          int numDVs =
-              elements[elemNum]->getDesignVarNums(elemNum, maxDVs, dvNums);
+  // Retrieve the sub-domain element lists
+  const int **subDomains;
+  int *subDomainSizes, *cursors, *active;
+  getFunctionDataPointers(numFuncs, &subDomains, &subDomainSizes, &cursors,
+                          &active);
+  getFunctionDomains(numFuncs, funcs, subDomains, subDomainSizes);
+  memset(cursors, 0, numFuncs * sizeof(int));
+
+  // Walk the elements once, evaluating the derivative of every
+  // function w.r.t. the design variables while the element data is
+  // still in cache
+  for (int elemNum = 0; elemNum < numElements - numHaloElements; elemNum++) {
+    // Determine which functions are defined on this element
+    int nactive = getActiveFunctions(elemNum, numFuncs, funcs, subDomains,
+                                     subDomainSizes, cursors, active);
+    if (nactive == 0) {
+      continue;
+    }
+
+    // Determine the values of the state variables for elemNum
+    int ptr = elementNodeIndex[elemNum];
+    int len = elementNodeIndex[elemNum + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
+    dvarsVec->getBlockedValues(len, nodes, dvars);
+    ddvarsVec->getBlockedValues(len, nodes, ddvars);
 
-          // Evaluate the element-wise sensitivity of the function
-          memset(fdvSens, 0, numDVs * designVarsPerNode * sizeof(TacsScalar));
-          funcs[k]->addElementDVSens(elemNum, elements[elemNum], time, coef,
-                                     elemXpts, vars, dvars, ddvars, maxDVs,
-                                     fdvSens);
+    // Get the design variables for this element
+    int numDVs = elements[elemNum]->getDesignVarNums(elemNum, maxDVs, dvNums);
 
-          // Add the derivative values
-          dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
-        }
+    for (int k = 0; k < numFuncs; k++) {
+      if (active[k]) {
+        // Evaluate the element-wise sensitivity of the function
+        memset(fdvSens, 0, numDVs * designVarsPerNode * sizeof(TacsScalar));
+        funcs[k]->addElementDVSens(elemNum, elements[elemNum], time, coef,
+                                   elemXpts, vars, dvars, ddvars, maxDVs,
+                                   fdvSens);
+
+        // Add the derivative values through the precomputed plan
+        addDVValuesPlan(dfdx[k], elemNum, numDVs, dvNums, fdvSens);
       }
     }
   }
+
 }
 
 /**
@@ -4808,13 +8497,38 @@ void TACSAssembler::addDVSens(TacsScalar coef, int numFuncs,
   This function should be preferred to the use of evalDVSens without a
   list of functions since it is more efficient!
 
+  The elements are processed in cache-sized tiles: the sensitivities
+  of each tile are accumulated into a tile-local buffer over the
+  nodes the tile touches and scattered once per function, which
+  coalesces the scatter of nodes shared between neighbouring
+  elements.
+
   @param coef The coefficient applied to the derivative
   @param numFuncs The number of functions - size of funcs array
   @param funcs The TACSFunction function objects
   @param dfdXpt The derivative vector
 */
+/*
+  Accumulate an element coordinate sensitivity into the tile-local
+  buffer at the positions of its nodes within the sorted tile node
+  list. The three entries per node are the x, y and z components.
+*/
+static void addTileXptSens(int len, const int *nodes, const TacsScalar *sens,
+                           int numTileNodes, const int *tileNodes,
+                           TacsScalar *tile) {
+  for (int j = 0; j < len; j++) {
+    int *loc = TacsSearchArray(nodes[j], numTileNodes, tileNodes);
+    int p = (int)(loc - tileNodes);
+    tile[3 * p] += sens[3 * j];
+    tile[3 * p + 1] += sens[3 * j + 1];
+    tile[3 * p + 2] += sens[3 * j + 2];
+  }
+}
+
 void TACSAssembler::addXptSens(TacsScalar coef, int numFuncs,
                                TACSFunction **funcs, TACSBVec **dfdXpt) {
+  finishDistributingVariables();
+
   // First check if this is the right assembly object
   for (int k = 0; k < numFuncs; k++) {
     if (funcs[k] && this != funcs[k]->getAssembler()) {
@@ -4829,42 +8543,115 @@ void TACSAssembler::addXptSens(TacsScalar coef, int numFuncs,
   getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts,
                   &elemXptSens, NULL, NULL);
 
-  // For each function, evaluate the derivative w.r.t. the
-  // nodal locations for all elements or part of the domain
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k]) {
-      if (funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN) {
-        // Get the function sub-domain
-        const int *elemSubList;
-        int numSubElems = funcs[k]->getElementNums(&elemSubList);
-        for (int i = 0; i < numSubElems; i++) {
-          int elemNum = elemSubList[i];
-          // Determine the values of the state variables for subElem
+  // Retrieve the sub-domain element lists
+  const int **subDomains;
+  int *subDomainSizes, *cursors, *active;
+  getFunctionDataPointers(numFuncs, &subDomains, &subDomainSizes, &cursors,
+                          &active);
+  getFunctionDomains(numFuncs, funcs, subDomains, subDomainSizes);
+  memset(cursors, 0, numFuncs * sizeof(int));
+
+  int nlocal = numElements - numHaloElements;
+
+  if (numDependentNodes == 0) {
+    // Walk the elements in tiles: the sensitivities of each tile are
+    // accumulated into a tile-local buffer over the nodes the tile
+    // touches and scattered with one call per function, rather than
+    // scattering every element of every function separately
+    const int maxTileNodes = TACS_XPTSENS_TILE_SIZE * maxElementNodes;
+    int *tileElems = new int[TACS_XPTSENS_TILE_SIZE];
+    int *tileActive = new int[TACS_XPTSENS_TILE_SIZE * numFuncs];
+    int *tileNodes = new int[maxTileNodes];
+    int *funcUsed = new int[numFuncs];
+    TacsScalar *tileSens =
+        new TacsScalar[TACS_SPATIAL_DIM * maxTileNodes * numFuncs];
+
+    int elemNum = 0;
+    while (elemNum < nlocal) {
+      // Collect the next tile of elements on which at least one
+      // function is active, together with the nodes they touch
+      int ntile = 0, numTileNodes = 0;
+      while (elemNum < nlocal && ntile < TACS_XPTSENS_TILE_SIZE) {
+        int nactive = getActiveFunctions(elemNum, numFuncs, funcs, subDomains,
+                                         subDomainSizes, cursors, active);
+        if (nactive > 0) {
           int ptr = elementNodeIndex[elemNum];
           int len = elementNodeIndex[elemNum + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
+          tileElems[ntile] = elemNum;
+          memcpy(&tileActive[numFuncs * ntile], active,
+                 numFuncs * sizeof(int));
+          memcpy(&tileNodes[numTileNodes], &elementTacsNodes[ptr],
+                 len * sizeof(int));
+          numTileNodes += len;
+          ntile++;
+        }
+        elemNum++;
+      }
+      numTileNodes = TacsUniqueSort(numTileNodes, tileNodes);
+      memset(tileSens, 0,
+             TACS_SPATIAL_DIM * numTileNodes * numFuncs * sizeof(TacsScalar));
+      memset(funcUsed, 0, numFuncs * sizeof(int));
+
+      // Evaluate the element sensitivities of the tile while the
+      // element data is in cache
+      for (int t = 0; t < ntile; t++) {
+        int e = tileElems[t];
+        int ptr = elementNodeIndex[e];
+        int len = elementNodeIndex[e + 1] - ptr;
+        const int *nodes = &elementTacsNodes[ptr];
+        xptVec->getBlockedValues(len, nodes, elemXpts);
+        varsVec->getBlockedValues(len, nodes, vars);
+        dvarsVec->getBlockedValues(len, nodes, dvars);
+        ddvarsVec->getBlockedValues(len, nodes, ddvars);
+
+        for (int k = 0; k < numFuncs; k++) {
+          if (tileActive[numFuncs * t + k]) {
+            funcs[k]->getElementXptSens(e, elements[e], time, coef, elemXpts,
+                                        vars, dvars, ddvars, elemXptSens);
+            addTileXptSens(len, nodes, elemXptSens, numTileNodes, tileNodes,
+                           &tileSens[TACS_SPATIAL_DIM * numTileNodes * k]);
+            funcUsed[k] = 1;
+          }
+        }
+      }
 
-          // Evaluate the element-wise sensitivity of the function
-          funcs[k]->getElementXptSens(elemNum, elements[elemNum], time, coef,
-                                      elemXpts, vars, dvars, ddvars,
-                                      elemXptSens);
-          dfdXpt[k]->setValues(len, nodes, elemXptSens, TACS_ADD_VALUES);
+      // Scatter the tile with one call per function
+      for (int k = 0; k < numFuncs; k++) {
+        if (funcUsed[k]) {
+          dfdXpt[k]->setValues(numTileNodes, tileNodes,
+                               &tileSens[TACS_SPATIAL_DIM * numTileNodes * k],
+                               TACS_ADD_VALUES);
         }
-      } else if (funcs[k]->getDomainType() == TACSFunction::ENTIRE_DOMAIN) {
-        for (int elemNum = 0; elemNum < numElements; elemNum++) {
-          // Determine the values of the state variables for elemNum
-          int ptr = elementNodeIndex[elemNum];
-          int len = elementNodeIndex[elemNum + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
+      }
+    }
+
+    delete[] tileElems;
+    delete[] tileActive;
+    delete[] tileNodes;
+    delete[] funcUsed;
+    delete[] tileSens;
+  } else {
+    // Dependent node numbers cannot be merged into the tile node
+    // lists - scatter the elements one at a time
+    for (int elemNum = 0; elemNum < nlocal; elemNum++) {
+      // Determine which functions are defined on this element
+      int nactive = getActiveFunctions(elemNum, numFuncs, funcs, subDomains,
+                                       subDomainSizes, cursors, active);
+      if (nactive == 0) {
+        continue;
+      }
 
+      // Determine the values of the state variables for elemNum
+      int ptr = elementNodeIndex[elemNum];
+      int len = elementNodeIndex[elemNum + 1] - ptr;
+      const int *nodes = &elementTacsNodes[ptr];
+      xptVec->getBlockedValues(len, nodes, elemXpts);
+      varsVec->getBlockedValues(len, nodes, vars);
+      dvarsVec->getBlockedValues(len, nodes, dvars);
+      ddvarsVec->getBlockedValues(len, nodes, ddvars);
+
+      for (int k = 0; k < numFuncs; k++) {
+        if (active[k]) {
           // Evaluate the element-wise sensitivity of the function
           funcs[k]->getElementXptSens(elemNum, elements[elemNum], time, coef,
                                       elemXpts, vars, dvars, ddvars,
@@ -4899,6 +8686,8 @@ void TACSAssembler::addXptSens(TacsScalar coef, int numFuncs,
 void TACSAssembler::addSVSens(TacsScalar alpha, TacsScalar beta,
                               TacsScalar gamma, int numFuncs,
                               TACSFunction **funcs, TACSBVec **dfdu) {
+  finishDistributingVariables();
+
   // First check if this is the right assembly object
   for (int k = 0; k < numFuncs; k++) {
     if (funcs[k] && this != funcs[k]->getAssembler()) {
@@ -4912,60 +8701,70 @@ void TACSAssembler::addSVSens(TacsScalar alpha, TacsScalar beta,
   getDataPointers(elementData, &vars, &dvars, &ddvars, &elemRes, &elemXpts,
                   NULL, NULL, NULL);
 
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k]) {
-      if (funcs[k]->getDomainType() == TACSFunction::ENTIRE_DOMAIN) {
-        for (int elemNum = 0; elemNum < numElements; elemNum++) {
-          // Determine the values of the state variables for subElem
-          int ptr = elementNodeIndex[elemNum];
-          int len = elementNodeIndex[elemNum + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
+  // Retrieve the sub-domain element lists
+  const int **subDomains;
+  int *subDomainSizes, *cursors, *active;
+  getFunctionDataPointers(numFuncs, &subDomains, &subDomainSizes, &cursors,
+                          &active);
+  getFunctionDomains(numFuncs, funcs, subDomains, subDomainSizes);
+  memset(cursors, 0, numFuncs * sizeof(int));
+
+  // Walk the elements once, evaluating the derivative of every
+  // function w.r.t. the state variables while the element data is
+  // still in cache
+  for (int elemNum = 0; elemNum < numElements - numHaloElements; elemNum++) {
+    // Determine which functions are defined on this element
+    int nactive = getActiveFunctions(elemNum, numFuncs, funcs, subDomains,
+                                     subDomainSizes, cursors, active);
+    if (nactive == 0) {
+      continue;
+    }
+
+    // Determine the values of the state variables for elemNum
+    int ptr = elementNodeIndex[elemNum];
+    int len = elementNodeIndex[elemNum + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
+    dvarsVec->getBlockedValues(len, nodes, dvars);
+    ddvarsVec->getBlockedValues(len, nodes, ddvars);
 
-          // Evaluate the element-wise sensitivity of the function
-          funcs[k]->getElementSVSens(elemNum, elements[elemNum], time, alpha,
-                                     beta, gamma, elemXpts, vars, dvars, ddvars,
-                                     elemRes);
-          dfdu[k]->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
-        }
-      } else if (funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN) {
-        const int *elementNums;
-        int subDomainSize = funcs[k]->getElementNums(&elementNums);
-
-        for (int i = 0; i < subDomainSize; i++) {
-          int elemNum = elementNums[i];
-          if (elemNum >= 0 && elemNum < numElements) {
-            // Determine the values of the state variables for the
-            // current element
-            int ptr = elementNodeIndex[elemNum];
-            int len = elementNodeIndex[elemNum + 1] - ptr;
-            const int *nodes = &elementTacsNodes[ptr];
-            xptVec->getValues(len, nodes, elemXpts);
-            varsVec->getValues(len, nodes, vars);
-            dvarsVec->getValues(len, nodes, dvars);
-            ddvarsVec->getValues(len, nodes, ddvars);
-
-            // Evaluate the element-wise sensitivity of the function
-            funcs[k]->getElementSVSens(elemNum, elements[elemNum], time, alpha,
-                                       beta, gamma, elemXpts, vars, dvars,
-                                       ddvars, elemRes);
-            dfdu[k]->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
-          }
-        }
+    for (int k = 0; k < numFuncs; k++) {
+      if (active[k]) {
+        // Evaluate the element-wise sensitivity of the function
+        funcs[k]->getElementSVSens(elemNum, elements[elemNum], time, alpha,
+                                   beta, gamma, elemXpts, vars, dvars, ddvars,
+                                   elemRes);
+        dfdu[k]->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
       }
+    }
+  }
 
-      // Add the values into the array
-      dfdu[k]->beginSetValues(TACS_ADD_VALUES);
+
+  // Determine which functions can assemble their sensitivities
+  // through a reverse exchange restricted to the halo nodes touched
+  // by their element domain - the active array is re-used as scratch
+  setupFunctionHaloDists(numFuncs, funcs, dfdu, active);
+
+  // Add the values into the array
+  for (int k = 0; k < numFuncs; k++) {
+    if (funcs[k]) {
+      if (active[k]) {
+        beginFunctionHaloAssembly(funcs[k], dfdu[k]);
+      } else {
+        dfdu[k]->beginSetValues(TACS_ADD_VALUES);
+      }
     }
   }
 
   // Finish adding the values
   for (int k = 0; k < numFuncs; k++) {
     if (funcs[k]) {
-      dfdu[k]->endSetValues(TACS_ADD_VALUES);
+      if (active[k]) {
+        endFunctionHaloAssembly(funcs[k], dfdu[k]);
+      } else {
+        dfdu[k]->endSetValues(TACS_ADD_VALUES);
+      }
       dfdu[k]->applyBCs(bcMap);
     }
   }
@@ -4992,6 +8791,8 @@ void TACSAssembler::addSVSens(TacsScalar alpha, TacsScalar beta,
 void TACSAssembler::addAdjointResProducts(TacsScalar scale, int numAdjoints,
                                           TACSBVec **adjoint, TACSBVec **dfdx,
                                           const TacsScalar lambda) {
+  finishDistributingVariables();
+
   // Distribute the design variable values to all processors
   for (int k = 0; k < numAdjoints; k++) {
     adjoint[k]->beginDistributeValues();
@@ -5024,15 +8825,15 @@ void TACSAssembler::addAdjointResProducts(TacsScalar scale, int numAdjoints,
     naux = auxElements->getAuxElements(&aux);
   }
 
-  for (int i = 0; i < numElements; i++) {
+  for (int i = 0; i < numElements - numHaloElements; i++) {
     // Find the variables and nodes
     int ptr = elementNodeIndex[i];
     int len = elementNodeIndex[i + 1] - ptr;
     const int *nodes = &elementTacsNodes[ptr];
-    xptVec->getValues(len, nodes, elemXpts);
-    varsVec->getValues(len, nodes, vars);
-    dvarsVec->getValues(len, nodes, dvars);
-    ddvarsVec->getValues(len, nodes, ddvars);
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
+    dvarsVec->getBlockedValues(len, nodes, dvars);
+    ddvarsVec->getBlockedValues(len, nodes, ddvars);
 
     // Get the design variables for this element
     int numDVs = elements[i]->getDesignVarNums(i, maxDVs, dvNums);
@@ -5042,7 +8843,7 @@ void TACSAssembler::addAdjointResProducts(TacsScalar scale, int numAdjoints,
       memset(fdvSens, 0, numDVs * designVarsPerNode * sizeof(TacsScalar));
 
       // Get the element adjoint vector
-      adjoint[k]->getValues(len, nodes, elemAdjoint);
+      adjoint[k]->getBlockedValues(len, nodes, elemAdjoint);
 
       // Add the adjoint-residual product
       elements[i]->addAdjResProduct(i, time, scale, elemAdjoint, elemXpts, vars,
@@ -5057,46 +8858,237 @@ void TACSAssembler::addAdjointResProducts(TacsScalar scale, int numAdjoints,
         // Get the design variables for this element
         numDVs = aux[aux_count].elem->getDesignVarNums(i, maxDVs, dvNums);
 
-        // Get the adjoint variables
-        for (int k = 0; k < numAdjoints; k++) {
-          memset(fdvSens, 0, numDVs * designVarsPerNode * sizeof(TacsScalar));
+        // Get the adjoint variables
+        for (int k = 0; k < numAdjoints; k++) {
+          memset(fdvSens, 0, numDVs * designVarsPerNode * sizeof(TacsScalar));
+
+          // Get the element adjoint vector
+          adjoint[k]->getBlockedValues(len, nodes, elemAdjoint);
+
+          aux[aux_count].elem->addAdjResProduct(i, time, lambda * scale,
+                                                elemAdjoint, elemXpts, vars,
+                                                dvars, ddvars, numDVs, fdvSens);
+
+          dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
+        }
+        aux_count++;
+      }
+    }
+  }
+}
+
+/**
+  Evaluate the product of several ajdoint vectors with the derivative
+  of the residual w.r.t. the nodal points.
+
+  This function is collective on all TACSAssembler processes. This
+  computes the product of the derivative of the residual w.r.t. the
+  nodal points with several adjoint vectors simultaneously. This
+  saves computational time as the derivative of the element residuals
+  can be reused for each adjoint vector.
+
+  The elements are processed in cache-sized tiles: the coordinate
+  sensitivities of each tile are accumulated into a tile-local buffer
+  over the nodes the tile touches and scattered once per adjoint,
+  which coalesces the scatter of nodes shared between neighbouring
+  elements.
+
+  @param scale Scalar factor applied to the derivative
+  @param numAdjoints The number of adjoint vectors
+  @param adjoint The array of adjoint vectors
+  @param dfdXpt Product of the derivative of the residuals and the adjoint
+  @param lambda Scaling factor for the aux element contributions, by default 1
+*/
+void TACSAssembler::addAdjointResXptSensProducts(TacsScalar scale,
+                                                 int numAdjoints,
+                                                 TACSBVec **adjoint,
+                                                 TACSBVec **dfdXpt,
+                                                 const TacsScalar lambda) {
+  finishDistributingVariables();
+
+  for (int k = 0; k < numAdjoints; k++) {
+    adjoint[k]->beginDistributeValues();
+  }
+  for (int k = 0; k < numAdjoints; k++) {
+    adjoint[k]->endDistributeValues();
+  }
+
+  // Sort the list of auxiliary elements - this only performs the
+  // sort if it is required (if new elements are added)
+  if (auxElements) {
+    auxElements->sort();
+  }
+
+  // Retrieve pointers to temporary storage
+  TacsScalar *vars, *dvars, *ddvars;
+  TacsScalar *elemXpts, *elemAdjoint, *xptSens;
+  getDataPointers(elementData, &vars, &dvars, &ddvars, &elemAdjoint, &elemXpts,
+                  &xptSens, NULL, NULL);
+
+  // Set the data for the auxiliary elements - if there are any
+  int naux = 0, aux_count = 0;
+  TACSAuxElem *aux = NULL;
+  if (auxElements) {
+    naux = auxElements->getAuxElements(&aux);
+  }
+
+  int nlocal = numElements - numHaloElements;
+
+  if (numDependentNodes == 0) {
+    // Walk the elements in tiles: the coordinate sensitivities of
+    // each tile are accumulated into a tile-local buffer over the
+    // nodes the tile touches and scattered with one call per adjoint,
+    // rather than scattering every element of every adjoint
+    // separately
+    const int maxTileNodes = TACS_XPTSENS_TILE_SIZE * maxElementNodes;
+    int *tileNodes = new int[maxTileNodes];
+    TacsScalar *tileSens =
+        new TacsScalar[TACS_SPATIAL_DIM * maxTileNodes * numAdjoints];
+
+    for (int start = 0; start < nlocal; start += TACS_XPTSENS_TILE_SIZE) {
+      int end = start + TACS_XPTSENS_TILE_SIZE;
+      if (end > nlocal) {
+        end = nlocal;
+      }
+
+      // Collect the nodes touched by the tile
+      int numTileNodes = 0;
+      for (int i = start; i < end; i++) {
+        int ptr = elementNodeIndex[i];
+        int len = elementNodeIndex[i + 1] - ptr;
+        memcpy(&tileNodes[numTileNodes], &elementTacsNodes[ptr],
+               len * sizeof(int));
+        numTileNodes += len;
+      }
+      numTileNodes = TacsUniqueSort(numTileNodes, tileNodes);
+      memset(tileSens, 0, TACS_SPATIAL_DIM * numTileNodes * numAdjoints *
+                              sizeof(TacsScalar));
+
+      for (int i = start; i < end; i++) {
+        // Find the variables and nodes
+        int ptr = elementNodeIndex[i];
+        int len = elementNodeIndex[i + 1] - ptr;
+        const int *nodes = &elementTacsNodes[ptr];
+        xptVec->getBlockedValues(len, nodes, elemXpts);
+        varsVec->getBlockedValues(len, nodes, vars);
+        dvarsVec->getBlockedValues(len, nodes, dvars);
+        ddvarsVec->getBlockedValues(len, nodes, ddvars);
+
+        // Get the adjoint variables
+        for (int k = 0; k < numAdjoints; k++) {
+          memset(xptSens, 0, TACS_SPATIAL_DIM * len * sizeof(TacsScalar));
+          adjoint[k]->getBlockedValues(len, nodes, elemAdjoint);
+          elements[i]->addAdjResXptProduct(i, time, scale, elemAdjoint,
+                                           elemXpts, vars, dvars, ddvars,
+                                           xptSens);
+          addTileXptSens(len, nodes, xptSens, numTileNodes, tileNodes,
+                         &tileSens[TACS_SPATIAL_DIM * numTileNodes * k]);
+        }
+
+        // Add the contribution from the auxiliary elements, scaled by
+        // lambda
+        while (aux_count < naux && aux[aux_count].num == i) {
+          for (int k = 0; k < numAdjoints; k++) {
+            memset(xptSens, 0, TACS_SPATIAL_DIM * len * sizeof(TacsScalar));
+            adjoint[k]->getBlockedValues(len, nodes, elemAdjoint);
+            aux[aux_count].elem->addAdjResXptProduct(
+                i, time, lambda * scale, elemAdjoint, elemXpts, vars, dvars,
+                ddvars, xptSens);
+            addTileXptSens(len, nodes, xptSens, numTileNodes, tileNodes,
+                           &tileSens[TACS_SPATIAL_DIM * numTileNodes * k]);
+          }
+          aux_count++;
+        }
+      }
+
+      // Scatter the tile with one call per adjoint
+      for (int k = 0; k < numAdjoints; k++) {
+        dfdXpt[k]->setValues(numTileNodes, tileNodes,
+                             &tileSens[TACS_SPATIAL_DIM * numTileNodes * k],
+                             TACS_ADD_VALUES);
+      }
+    }
+
+    delete[] tileNodes;
+    delete[] tileSens;
+  } else {
+    // Dependent node numbers cannot be merged into the tile node
+    // lists - scatter the elements one at a time
+    for (int i = 0; i < nlocal; i++) {
+      // Find the variables and nodes
+      int ptr = elementNodeIndex[i];
+      int len = elementNodeIndex[i + 1] - ptr;
+      const int *nodes = &elementTacsNodes[ptr];
+      xptVec->getBlockedValues(len, nodes, elemXpts);
+      varsVec->getBlockedValues(len, nodes, vars);
+      dvarsVec->getBlockedValues(len, nodes, dvars);
+      ddvarsVec->getBlockedValues(len, nodes, ddvars);
+
+      // Get the adjoint variables
+      for (int k = 0; k < numAdjoints; k++) {
+        memset(xptSens, 0, TACS_SPATIAL_DIM * len * sizeof(TacsScalar));
+        adjoint[k]->getBlockedValues(len, nodes, elemAdjoint);
+        elements[i]->addAdjResXptProduct(i, time, scale, elemAdjoint, elemXpts,
+                                         vars, dvars, ddvars, xptSens);
+
+        dfdXpt[k]->setValues(len, nodes, xptSens, TACS_ADD_VALUES);
+      }
 
-          // Get the element adjoint vector
-          adjoint[k]->getValues(len, nodes, elemAdjoint);
+      // Add the contribution from the auxiliary elements, scaled by lambda
+      if (aux_count < naux) {
+        while (aux_count < naux && aux[aux_count].num == i) {
+          // Get the adjoint variables
+          for (int k = 0; k < numAdjoints; k++) {
+            memset(xptSens, 0, TACS_SPATIAL_DIM * len * sizeof(TacsScalar));
 
-          aux[aux_count].elem->addAdjResProduct(i, time, lambda * scale,
-                                                elemAdjoint, elemXpts, vars,
-                                                dvars, ddvars, numDVs, fdvSens);
+            // Get the element adjoint vector
+            adjoint[k]->getBlockedValues(len, nodes, elemAdjoint);
 
-          dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
+            aux[aux_count].elem->addAdjResXptProduct(i, time, lambda * scale,
+                                                     elemAdjoint, elemXpts,
+                                                     vars, dvars, ddvars,
+                                                     xptSens);
+
+            dfdXpt[k]->setValues(len, nodes, xptSens, TACS_ADD_VALUES);
+          }
+          aux_count++;
         }
-        aux_count++;
       }
     }
   }
 }
 
 /**
-  Evaluate the product of several ajdoint vectors with the derivative
-  of the residual w.r.t. the nodal points.
-
-  This function is collective on all TACSAssembler processes. This
-  computes the product of the derivative of the residual w.r.t. the
-  nodal points with several adjoint vectors simultaneously. This
-  saves computational time as the derivative of the element residuals
-  can be reused for each adjoint vector.
-
-  @param scale Scalar factor applied to the derivative
+  Evaluate the product of several adjoint vectors with the derivatives
+  of the residual w.r.t. both the design variables and the nodal
+  points in a single pass over the elements.
+
+  This function is collective on all TACSAssembler processes. It
+  computes the same products as addAdjointResProducts and
+  addAdjointResXptSensProducts, but gathers the element nodes, states
+  and adjoint variables once and evaluates both products while the
+  element data is in cache. The loop over the adjoint vectors is
+  innermost so that each gathered adjoint is used for both products
+  before moving on. Use this when both the design variable and nodal
+  sensitivities are required, as in coupled-sensitivity gradient
+  evaluations.
+
+  @param scale Scalar factor applied to the derivatives
   @param numAdjoints The number of adjoint vectors
   @param adjoint The array of adjoint vectors
-  @param dfdXpt Product of the derivative of the residuals and the adjoint
+  @param dfdx Product of the residual derivative w.r.t. the design variables
+  @param dfdXpt Product of the residual derivative w.r.t. the nodal points
   @param lambda Scaling factor for the aux element contributions, by default 1
 */
-void TACSAssembler::addAdjointResXptSensProducts(TacsScalar scale,
-                                                 int numAdjoints,
-                                                 TACSBVec **adjoint,
-                                                 TACSBVec **dfdXpt,
-                                                 const TacsScalar lambda) {
+void TACSAssembler::addAdjointResProductsCombo(TacsScalar scale,
+                                               int numAdjoints,
+                                               TACSBVec **adjoint,
+                                               TACSBVec **dfdx,
+                                               TACSBVec **dfdXpt,
+                                               const TacsScalar lambda) {
+  finishDistributingVariables();
+
+  // Distribute the adjoint values to all processors
   for (int k = 0; k < numAdjoints; k++) {
     adjoint[k]->beginDistributeValues();
   }
@@ -5116,6 +9108,11 @@ void TACSAssembler::addAdjointResXptSensProducts(TacsScalar scale,
   getDataPointers(elementData, &vars, &dvars, &ddvars, &elemAdjoint, &elemXpts,
                   &xptSens, NULL, NULL);
 
+  // Get the design variables from the elements on this process
+  const int maxDVs = maxElementDesignVars;
+  TacsScalar *fdvSens = elementSensData;
+  int *dvNums = elementSensIData;
+
   // Set the data for the auxiliary elements - if there are any
   int naux = 0, aux_count = 0;
   TACSAuxElem *aux = NULL;
@@ -5123,40 +9120,60 @@ void TACSAssembler::addAdjointResXptSensProducts(TacsScalar scale,
     naux = auxElements->getAuxElements(&aux);
   }
 
-  for (int i = 0; i < numElements; i++) {
+  for (int i = 0; i < numElements - numHaloElements; i++) {
     // Find the variables and nodes
     int ptr = elementNodeIndex[i];
     int len = elementNodeIndex[i + 1] - ptr;
     const int *nodes = &elementTacsNodes[ptr];
-    xptVec->getValues(len, nodes, elemXpts);
-    varsVec->getValues(len, nodes, vars);
-    dvarsVec->getValues(len, nodes, dvars);
-    ddvarsVec->getValues(len, nodes, ddvars);
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
+    dvarsVec->getBlockedValues(len, nodes, dvars);
+    ddvarsVec->getBlockedValues(len, nodes, ddvars);
 
-    // Get the adjoint variables
+    // Get the design variables for this element
+    int numDVs = elements[i]->getDesignVarNums(i, maxDVs, dvNums);
+
+    // Compute both products for each adjoint vector while the element
+    // data remains in cache
     for (int k = 0; k < numAdjoints; k++) {
+      memset(fdvSens, 0, numDVs * designVarsPerNode * sizeof(TacsScalar));
       memset(xptSens, 0, TACS_SPATIAL_DIM * len * sizeof(TacsScalar));
-      adjoint[k]->getValues(len, nodes, elemAdjoint);
+
+      // Get the element adjoint vector
+      adjoint[k]->getBlockedValues(len, nodes, elemAdjoint);
+
+      // Add the adjoint-residual products
+      elements[i]->addAdjResProduct(i, time, scale, elemAdjoint, elemXpts, vars,
+                                    dvars, ddvars, numDVs, fdvSens);
       elements[i]->addAdjResXptProduct(i, time, scale, elemAdjoint, elemXpts,
                                        vars, dvars, ddvars, xptSens);
 
+      dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
       dfdXpt[k]->setValues(len, nodes, xptSens, TACS_ADD_VALUES);
     }
 
     // Add the contribution from the auxiliary elements, scaled by lambda
     if (aux_count < naux) {
       while (aux_count < naux && aux[aux_count].num == i) {
+        // Get the design variables for this element
+        numDVs = aux[aux_count].elem->getDesignVarNums(i, maxDVs, dvNums);
+
         // Get the adjoint variables
         for (int k = 0; k < numAdjoints; k++) {
+          memset(fdvSens, 0, numDVs * designVarsPerNode * sizeof(TacsScalar));
           memset(xptSens, 0, TACS_SPATIAL_DIM * len * sizeof(TacsScalar));
 
           // Get the element adjoint vector
-          adjoint[k]->getValues(len, nodes, elemAdjoint);
+          adjoint[k]->getBlockedValues(len, nodes, elemAdjoint);
 
+          aux[aux_count].elem->addAdjResProduct(i, time, lambda * scale,
+                                                elemAdjoint, elemXpts, vars,
+                                                dvars, ddvars, numDVs, fdvSens);
           aux[aux_count].elem->addAdjResXptProduct(i, time, lambda * scale,
                                                    elemAdjoint, elemXpts, vars,
                                                    dvars, ddvars, xptSens);
 
+          dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
           dfdXpt[k]->setValues(len, nodes, xptSens, TACS_ADD_VALUES);
         }
         aux_count++;
@@ -5182,6 +9199,8 @@ void TACSAssembler::addMatDVSensInnerProduct(TacsScalar scale,
                                              ElementMatrixType matType,
                                              TACSBVec *psi, TACSBVec *phi,
                                              TACSBVec *dfdx) {
+  finishDistributingVariables();
+
   psi->beginDistributeValues();
   if (phi != psi) {
     phi->beginDistributeValues();
@@ -5204,15 +9223,15 @@ void TACSAssembler::addMatDVSensInnerProduct(TacsScalar scale,
   // Go through each element in the domain and compute the derivative
   // of the residuals with respect to each design variable and multiply by
   // the adjoint variables
-  for (int i = 0; i < numElements; i++) {
+  for (int i = 0; i < numElements - numHaloElements; i++) {
     // Find the variables and nodes
     int ptr = elementNodeIndex[i];
     int len = elementNodeIndex[i + 1] - ptr;
     const int *nodes = &elementTacsNodes[ptr];
-    xptVec->getValues(len, nodes, elemXpts);
-    varsVec->getValues(len, nodes, elemVars);
-    psi->getValues(len, nodes, elemPsi);
-    phi->getValues(len, nodes, elemPhi);
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, elemVars);
+    psi->getBlockedValues(len, nodes, elemPsi);
+    phi->getBlockedValues(len, nodes, elemPhi);
 
     // Get the design variables for this element
     int numDVs = elements[i]->getDesignVarNums(i, maxDVs, dvNums);
@@ -5244,6 +9263,8 @@ void TACSAssembler::addMatXptSensInnerProduct(TacsScalar scale,
                                               ElementMatrixType matType,
                                               TACSBVec *psi, TACSBVec *phi,
                                               TACSBVec *dfdXpt) {
+  finishDistributingVariables();
+
   psi->beginDistributeValues();
   if (phi != psi) {
     phi->beginDistributeValues();
@@ -5266,15 +9287,15 @@ void TACSAssembler::addMatXptSensInnerProduct(TacsScalar scale,
   // Go through each element in the domain and compute the derivative
   // of the residuals with respect to each design variable and multiply by
   // the adjoint variables
-  for (int i = 0; i < numElements; i++) {
+  for (int i = 0; i < numElements - numHaloElements; i++) {
     // Find the variables and nodes
     int ptr = elementNodeIndex[i];
     int len = elementNodeIndex[i + 1] - ptr;
     const int *nodes = &elementTacsNodes[ptr];
-    xptVec->getValues(len, nodes, elemXpts);
-    varsVec->getValues(len, nodes, elemVars);
-    psi->getValues(len, nodes, elemPsi);
-    phi->getValues(len, nodes, elemPhi);
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, elemVars);
+    psi->getBlockedValues(len, nodes, elemPsi);
+    phi->getBlockedValues(len, nodes, elemPhi);
 
     memset(xptSens, 0, TACS_SPATIAL_DIM * len * sizeof(TacsScalar));
 
@@ -5302,6 +9323,8 @@ void TACSAssembler::addMatXptSensInnerProduct(TacsScalar scale,
 void TACSAssembler::evalMatSVSensInnerProduct(ElementMatrixType matType,
                                               TACSBVec *psi, TACSBVec *phi,
                                               TACSBVec *dfdu) {
+  finishDistributingVariables();
+
   // Zero the entries in the residual vector
   dfdu->zeroEntries();
 
@@ -5323,15 +9346,15 @@ void TACSAssembler::evalMatSVSensInnerProduct(ElementMatrixType matType,
   // Go through each element in the domain and compute the derivative
   // of the residuals with respect to each design variable and multiply by
   // the adjoint variables
-  for (int i = 0; i < numElements; i++) {
+  for (int i = 0; i < numElements - numHaloElements; i++) {
     // Find the variables and nodes
     int ptr = elementNodeIndex[i];
     int len = elementNodeIndex[i + 1] - ptr;
     const int *nodes = &elementTacsNodes[ptr];
-    xptVec->getValues(len, nodes, elemXpts);
-    varsVec->getValues(len, nodes, elemVars);
-    psi->getValues(len, nodes, elemPsi);
-    phi->getValues(len, nodes, elemPhi);
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, elemVars);
+    psi->getBlockedValues(len, nodes, elemPsi);
+    phi->getBlockedValues(len, nodes, elemPhi);
 
     // Add the contribution to the design variable vector
     elements[i]->getMatSVSensInnerProduct(matType, i, time, elemPsi, elemPhi,
@@ -5374,6 +9397,8 @@ void TACSAssembler::addJacobianVecProduct(TacsScalar scale, TacsScalar alpha,
                                           TACSBVec *x, TACSBVec *y,
                                           MatrixOrientation matOr,
                                           const TacsScalar lambda) {
+  finishDistributingVariables();
+
   x->beginDistributeValues();
   x->endDistributeValues();
 
@@ -5395,10 +9420,10 @@ void TACSAssembler::addJacobianVecProduct(TacsScalar scale, TacsScalar alpha,
     int ptr = elementNodeIndex[i];
     int len = elementNodeIndex[i + 1] - ptr;
     const int *nodes = &elementTacsNodes[ptr];
-    xptVec->getValues(len, nodes, elemXpts);
-    varsVec->getValues(len, nodes, vars);
-    dvarsVec->getValues(len, nodes, dvars);
-    ddvarsVec->getValues(len, nodes, ddvars);
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
+    dvarsVec->getBlockedValues(len, nodes, dvars);
+    ddvarsVec->getBlockedValues(len, nodes, ddvars);
 
     // Get the number of variables from the element
     int nvars = elements[i]->getNumVariables();
@@ -5421,7 +9446,7 @@ void TACSAssembler::addJacobianVecProduct(TacsScalar scale, TacsScalar alpha,
     // Temporarily set the variable array as the element input array
     // and get the local variable input values from the local array.
     TacsScalar *xvars = vars;
-    x->getValues(len, nodes, xvars);
+    x->getBlockedValues(len, nodes, xvars);
 
     // Take the matrix vector product. Note the matrix is stored in
     // row-major order and BLAS assumes column-major order. As a
@@ -5441,8 +9466,10 @@ void TACSAssembler::addJacobianVecProduct(TacsScalar scale, TacsScalar alpha,
   }
 
   // Add the dependent-variable residual from the dependent nodes
-  y->beginSetValues(TACS_ADD_VALUES);
-  y->endSetValues(TACS_ADD_VALUES);
+  if (numHaloElements == 0) {
+    y->beginSetValues(TACS_ADD_VALUES);
+    y->endSetValues(TACS_ADD_VALUES);
+  }
 
   // Set the boundary conditions
   y->applyBCs(bcMap);
@@ -5512,6 +9539,8 @@ void TACSAssembler::assembleMatrixFreeData(ElementMatrixType matType,
                                            TacsScalar alpha, TacsScalar beta,
                                            TacsScalar gamma,
                                            TacsScalar data[]) {
+  finishDistributingVariables();
+
   // Retrieve pointers to temporary storage
   TacsScalar *vars, *dvars, *ddvars, *yvars, *elemXpts;
   getDataPointers(elementData, &vars, &dvars, &ddvars, &yvars, &elemXpts, NULL,
@@ -5531,10 +9560,10 @@ void TACSAssembler::assembleMatrixFreeData(ElementMatrixType matType,
     int len = elementNodeIndex[i + 1] - ptr;
     const int *nodes = &elementTacsNodes[ptr];
     if (data) {
-      xptVec->getValues(len, nodes, elemXpts);
-      varsVec->getValues(len, nodes, vars);
-      dvarsVec->getValues(len, nodes, dvars);
-      ddvarsVec->getValues(len, nodes, ddvars);
+      xptVec->getBlockedValues(len, nodes, elemXpts);
+      varsVec->getBlockedValues(len, nodes, vars);
+      dvarsVec->getBlockedValues(len, nodes, dvars);
+      ddvarsVec->getBlockedValues(len, nodes, ddvars);
     }
 
     // Get the size of the data array
@@ -5603,7 +9632,7 @@ void TACSAssembler::addMatrixFreeVecProduct(ElementMatrixType matType,
     int nvars = elements[i]->getNumVariables();
 
     // Get the values
-    x->getValues(len, nodes, xvars);
+    x->getBlockedValues(len, nodes, xvars);
 
     // Compute and add the contributions to the Jacobian
     memset(yvars, 0, nvars * sizeof(TacsScalar));
@@ -5647,8 +9676,10 @@ void TACSAssembler::addMatrixFreeVecProduct(ElementMatrixType matType,
   }
 
   // Add the dependent-variable residual from the dependent nodes
-  y->beginSetValues(TACS_ADD_VALUES);
-  y->endSetValues(TACS_ADD_VALUES);
+  if (numHaloElements == 0) {
+    y->beginSetValues(TACS_ADD_VALUES);
+    y->endSetValues(TACS_ADD_VALUES);
+  }
 
   // Set the boundary conditions
   y->applyBCs(bcMap);
@@ -5671,6 +9702,8 @@ void TACSAssembler::addMatrixFreeVecProduct(ElementMatrixType matType,
 */
 void TACSAssembler::testElement(int elemNum, int print_level, double dh,
                                 double rtol, double atol) {
+  finishDistributingVariables();
+
   if (!meshInitializedFlag) {
     fprintf(stderr, "[%d] Cannot call testElement() before initialize()\n",
             mpiRank);
@@ -5690,10 +9723,10 @@ void TACSAssembler::testElement(int elemNum, int print_level, double dh,
   int ptr = elementNodeIndex[elemNum];
   int len = elementNodeIndex[elemNum + 1] - ptr;
   const int *nodes = &elementTacsNodes[ptr];
-  xptVec->getValues(len, nodes, elemXpts);
-  varsVec->getValues(len, nodes, vars);
-  dvarsVec->getValues(len, nodes, dvars);
-  ddvarsVec->getValues(len, nodes, ddvars);
+  xptVec->getBlockedValues(len, nodes, elemXpts);
+  varsVec->getBlockedValues(len, nodes, vars);
+  dvarsVec->getBlockedValues(len, nodes, dvars);
+  ddvarsVec->getBlockedValues(len, nodes, ddvars);
 
   int col = -1;
   TacsTestElementJacobian(elements[elemNum], elemNum, time, elemXpts, vars,
@@ -5961,6 +9994,264 @@ void TACSAssembler::testFunction(TACSFunction *func, double dh) {
   Xvars->decref();
 }
 
+/**
+  Spot-check the adjoint-residual products on a random sample of elements.
+
+  This verifies the element-level derivative implementations used by
+  addAdjointResProducts() against a finite-difference (or complex-step)
+  approximation, without re-running the full analysis. Each process
+  draws its samples independently from its owned element range, so the
+  cost is local and proportional to the number of samples. The element
+  design variable values are restored after each check.
+
+  @param num_elem_samples The number of elements sampled per process
+  @param dh Finite-difference (or complex-step) step length
+  @param print_level Print the summary if > 0, each sample if > 1
+  @param rtol Relative tolerance to apply
+  @param atol Absolute tolerance to apply
+  @return The total number of failed samples across all processes
+*/
+int TACSAssembler::verifyAdjResProductsSample(int num_elem_samples, double dh,
+                                              int print_level, double rtol,
+                                              double atol) {
+  finishDistributingVariables();
+
+  if (!meshInitializedFlag) {
+    fprintf(stderr,
+            "[%d] Cannot call verifyAdjResProductsSample() before "
+            "initialize()\n",
+            mpiRank);
+    return -1;
+  }
+
+  // Retrieve pointers to temporary storage
+  TacsScalar *vars, *dvars, *ddvars, *elemXpts;
+  getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts, NULL,
+                  NULL, NULL);
+
+  const int maxDVs = maxElementDesignVars;
+  TacsScalar *x = elementSensData;
+
+  // Sample only from the elements owned by this process
+  int num_owned = numElements - numHaloElements;
+  if (num_elem_samples > num_owned) {
+    num_elem_samples = num_owned;
+  }
+
+  int fail_count = 0;
+  for (int k = 0; k < num_elem_samples; k++) {
+    int elemNum = rand() % num_owned;
+
+    // Stage the state variables and node locations for this element
+    int ptr = elementNodeIndex[elemNum];
+    int len = elementNodeIndex[elemNum + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
+    dvarsVec->getBlockedValues(len, nodes, dvars);
+    ddvarsVec->getBlockedValues(len, nodes, ddvars);
+
+    // Test the adjoint-residual product for this element. The test
+    // perturbs and then restores the element design variable values.
+    elements[elemNum]->getDesignVars(elemNum, maxDVs, x);
+    fail_count += TacsTestAdjResProduct(
+        elements[elemNum], elemNum, time, elemXpts, vars, dvars, ddvars, maxDVs,
+        x, dh, (print_level > 1 ? print_level : 0), rtol, atol);
+  }
+
+  // Reduce the failure and sample counts across all processes
+  int counts[2] = {fail_count, num_elem_samples};
+  MPI_Allreduce(MPI_IN_PLACE, counts, 2, MPI_INT, MPI_SUM, tacs_comm);
+
+  if (print_level > 0 && mpiRank == 0) {
+    fprintf(stderr,
+            "Sampled adjoint-residual product check: "
+            "%d of %d element samples failed\n",
+            counts[0], counts[1]);
+  }
+
+  return counts[0];
+}
+
+/**
+  Spot-check sampled components of the design variable sensitivities.
+
+  This compares individual components of the gradients computed through
+  addDVSens() against a finite-difference (or complex-step)
+  approximation of the functions, perturbing one sampled design
+  variable at a time. The cost is two function evaluation sweeps per
+  sample, so a handful of samples can run within a production analysis
+  instead of a full complex-step re-run of the entire gradient. The
+  design variable values and function evaluations are restored on exit.
+
+  This call is collective on all processes.
+
+  @param num_dv_samples The number of design variables sampled
+  @param numFuncs The number of functions to check
+  @param funcs The array of functions
+  @param dh Finite-difference (or complex-step) step length
+  @param print_level Print the summary if > 0, each sample if > 1
+  @param rtol Relative tolerance to apply
+  @param atol Absolute tolerance to apply
+  @return The total number of failed component samples
+*/
+int TACSAssembler::verifyDVSensSample(int num_dv_samples, int numFuncs,
+                                      TACSFunction **funcs, double dh,
+                                      int print_level, double rtol,
+                                      double atol) {
+  if (!meshInitializedFlag) {
+    fprintf(stderr,
+            "[%d] Cannot call verifyDVSensSample() before initialize()\n",
+            mpiRank);
+    return -1;
+  }
+
+  // Evaluate the functions and assemble the gradients at the current
+  // design point
+  TacsScalar *fvals = new TacsScalar[3 * numFuncs];
+  TacsScalar *ftmp = &fvals[numFuncs];
+  TacsScalar *fd = &fvals[2 * numFuncs];
+
+  TACSBVec **dfdx = new TACSBVec *[numFuncs];
+  for (int k = 0; k < numFuncs; k++) {
+    dfdx[k] = createDesignVec();
+    dfdx[k]->incref();
+  }
+
+  TACSBVec *xvec = createDesignVec();
+  TACSBVec *xtemp = createDesignVec();
+  xvec->incref();
+  xtemp->incref();
+  getDesignVars(xvec);
+
+  evalFunctions(numFuncs, funcs, fvals);
+  addDVSens(1.0, numFuncs, funcs, dfdx);
+  for (int k = 0; k < numFuncs; k++) {
+    dfdx[k]->beginSetValues(TACS_ADD_VALUES);
+  }
+  for (int k = 0; k < numFuncs; k++) {
+    dfdx[k]->endSetValues(TACS_ADD_VALUES);
+  }
+
+  // Get the ownership range of the design variables
+  const int *owner_range;
+  xvec->getNodeMap()->getOwnerRange(&owner_range);
+  int total_dvs = designVarsPerNode * owner_range[mpiSize];
+  if (num_dv_samples > total_dvs) {
+    num_dv_samples = total_dvs;
+  }
+
+  int fail_count = 0;
+  double max_rel_err = 0.0;
+
+  for (int n = 0; n < num_dv_samples; n++) {
+    // Draw the same sampled design variable on every process
+    int dv = 0;
+    if (mpiRank == 0) {
+      dv = rand() % total_dvs;
+    }
+    MPI_Bcast(&dv, 1, MPI_INT, 0, tacs_comm);
+
+    // Find the process that owns the sampled variable
+    int owner = 0;
+    while (designVarsPerNode * owner_range[owner + 1] <= dv) {
+      owner++;
+    }
+    int index = dv - designVarsPerNode * owner_range[owner];
+
+#ifdef TACS_USE_COMPLEX
+    // Evaluate the functions at the perturbed point x + dh*e
+    xtemp->copyValues(xvec);
+    if (mpiRank == owner) {
+      TacsScalar *xarray;
+      xtemp->getArray(&xarray);
+      xarray[index] = xarray[index] + TacsScalar(0.0, dh);
+    }
+    setDesignVars(xtemp);
+    evalFunctions(numFuncs, funcs, fd);
+    for (int k = 0; k < numFuncs; k++) {
+      fd[k] = TacsImagPart(fd[k]) / dh;
+    }
+#else
+    // Evaluate the functions at the perturbed point x + dh*e
+    xtemp->copyValues(xvec);
+    if (mpiRank == owner) {
+      TacsScalar *xarray;
+      xtemp->getArray(&xarray);
+      xarray[index] = xarray[index] + dh;
+    }
+    setDesignVars(xtemp);
+    TacsScalar *fval0 = new TacsScalar[numFuncs];
+    evalFunctions(numFuncs, funcs, fval0);
+
+    // Evaluate the functions at the perturbed point x - dh*e
+    xtemp->copyValues(xvec);
+    if (mpiRank == owner) {
+      TacsScalar *xarray;
+      xtemp->getArray(&xarray);
+      xarray[index] = xarray[index] - dh;
+    }
+    setDesignVars(xtemp);
+    evalFunctions(numFuncs, funcs, fd);
+    for (int k = 0; k < numFuncs; k++) {
+      fd[k] = 0.5 * (fval0[k] - fd[k]) / dh;
+    }
+    delete[] fval0;
+#endif  // TACS_USE_COMPLEX
+
+    // Extract the analytic gradient components from the owner
+    for (int k = 0; k < numFuncs; k++) {
+      if (mpiRank == owner) {
+        TacsScalar *grad;
+        dfdx[k]->getArray(&grad);
+        ftmp[k] = grad[index];
+      }
+    }
+    MPI_Bcast(ftmp, numFuncs, TACS_MPI_TYPE, owner, tacs_comm);
+
+    // Compare the sampled components on all processes. The broadcast
+    // values are identical everywhere, so no further reduction is
+    // needed.
+    for (int k = 0; k < numFuncs; k++) {
+      double an = TacsRealPart(ftmp[k]);
+      double approx = TacsRealPart(fd[k]);
+      double abs_err = fabs(an - approx);
+      if (approx != 0.0 && abs_err / fabs(approx) > max_rel_err) {
+        max_rel_err = abs_err / fabs(approx);
+      }
+      if (abs_err > atol + rtol * fabs(approx)) {
+        fail_count++;
+      }
+      if (print_level > 1 && mpiRank == 0) {
+        fprintf(stderr, "df/dx[%6d] %-20s %15.6e %15.6e %15.4e\n", dv,
+                funcs[k]->getObjectName(), an, approx,
+                (approx != 0.0 ? abs_err / fabs(approx) : abs_err));
+      }
+    }
+  }
+
+  // Restore the design point and the function evaluations
+  setDesignVars(xvec);
+  evalFunctions(numFuncs, funcs, ftmp);
+
+  if (print_level > 0 && mpiRank == 0) {
+    fprintf(stderr,
+            "Sampled DV sensitivity check: %d of %d component samples "
+            "failed, max rel. error %10.4e\n",
+            fail_count, num_dv_samples * numFuncs, max_rel_err);
+  }
+
+  for (int k = 0; k < numFuncs; k++) {
+    dfdx[k]->decref();
+  }
+  delete[] dfdx;
+  xvec->decref();
+  xtemp->decref();
+  delete[] fvals;
+
+  return fail_count;
+}
+
 /**
   Determine the number of components defined by elements in the
   TACSAssembler object.
@@ -5995,15 +10286,27 @@ int TACSAssembler::getNumComponents() {
   remaining data may be design variable entries that are computed
   below.
 
+  When a list of component numbers is supplied, only the elements that
+  belong to those components are evaluated; the data for all other
+  elements is left zero. This keeps the layout of the output array
+  unchanged while skipping the extraction cost for components that are
+  not of interest - for instance when monitoring a few components of
+  stresses every time step.
+
   @param elem_type The element type to match
   @param write_flag Binary flag indicating the components to write
   @param len The number of points (output)
   @param nvals The number of values at each point (output)
   @param data The data for each point for each value (output)
+  @param num_comps The length of the component filter (0 = no filter)
+  @param comp_nums The component numbers to extract
 */
 void TACSAssembler::getElementOutputData(ElementType elem_type, int write_flag,
                                          int *_len, int *_nvals,
-                                         TacsScalar **_data) {
+                                         TacsScalar **_data, int num_comps,
+                                         const int *comp_nums) {
+  finishDistributingVariables();
+
   int nvals = TacsGetTotalOutputCount(elem_type, write_flag);
   int len = 0;
   for (int i = 0; i < numElements; i++) {
@@ -6018,13 +10321,30 @@ void TACSAssembler::getElementOutputData(ElementType elem_type, int write_flag,
                   NULL, NULL);
 
   for (int i = 0, offset = 0; i < numElements; i++) {
+    // Skip elements outside the component filter, leaving their data
+    // zeroed so that the layout of the output array is unchanged
+    if (num_comps > 0 && comp_nums) {
+      int comp = elements[i]->getComponentNum();
+      int match = 0;
+      for (int k = 0; k < num_comps; k++) {
+        if (comp_nums[k] == comp) {
+          match = 1;
+          break;
+        }
+      }
+      if (!match) {
+        offset += nvals * elements[i]->getNumNodes();
+        continue;
+      }
+    }
+
     int ptr = elementNodeIndex[i];
     int len = elementNodeIndex[i + 1] - ptr;
     const int *nodes = &elementTacsNodes[ptr];
-    xptVec->getValues(len, nodes, elemXpts);
-    varsVec->getValues(len, nodes, vars);
-    dvarsVec->getValues(len, nodes, dvars);
-    ddvarsVec->getValues(len, nodes, ddvars);
+    xptVec->getBlockedValues(len, nodes, elemXpts);
+    varsVec->getBlockedValues(len, nodes, vars);
+    dvarsVec->getBlockedValues(len, nodes, dvars);
+    ddvarsVec->getBlockedValues(len, nodes, ddvars);
 
     elements[i]->getOutputData(i, elem_type, write_flag, elemXpts, vars, dvars,
                                ddvars, nvals, &data[offset]);
@@ -6038,10 +10358,262 @@ void TACSAssembler::getElementOutputData(ElementType elem_type, int write_flag,
   *_data = data;
 }
 
+/*!
+  Recover smoothed nodal output data by patch recovery.
+
+  The element output data produced by getElementOutputData() is
+  discontinuous: each element writes its own values at its nodes. This
+  routine fits a linear polynomial by least squares to the
+  element-local values over the patch of elements surrounding each
+  owned node - the node-to-element connectivity computed by
+  computeNodeToElementCSR() - and evaluates the fit at the node. The
+  fit filters the inter-element jumps and produces a continuous nodal
+  field directly inside the solver, without a separate smoothing pass
+  over the output files.
+
+  The patch fits are independent, so they are solved in parallel on
+  the thread pool when more than one thread is available.
+
+  The output array contains one row for each owned node followed by
+  one row for each dependent node, matching the layout of the
+  continuous data zone in the output file. The dependent node rows
+  contain the plain average of the element-local values at the
+  dependent node.
+
+  @param elem_type The element type to match
+  @param write_flag Binary flag indicating the components to write
+  @param len The number of nodal points (output)
+  @param nvals The number of values at each point (output)
+  @param data The recovered data for each point (output)
+  @param num_comps The length of the component filter (0 = no filter)
+  @param comp_nums The component numbers to extract
+*/
+void TACSAssembler::getSmoothedOutputData(ElementType elem_type,
+                                          int write_flag, int *_len,
+                                          int *_nvals, TacsScalar **_data,
+                                          int num_comps,
+                                          const int *comp_nums) {
+  // Evaluate the element-local output data
+  int npts, nvals;
+  TacsScalar *point_data;
+  getElementOutputData(elem_type, write_flag, &npts, &nvals, &point_data,
+                       num_comps, comp_nums);
+
+  // Gather the coordinates of every element point up front so that
+  // the patch fits can form the polynomial basis without re-fetching
+  // the element node locations
+  TacsScalar *point_Xpts = new TacsScalar[3 * npts];
+  for (int i = 0; i < numElements; i++) {
+    int ptr = elementNodeIndex[i];
+    int len = elementNodeIndex[i + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getBlockedValues(len, nodes, &point_Xpts[3 * ptr]);
+  }
+
+  // Compute the patch of elements surrounding each local node
+  int *nodeElementPtr, *nodeToElements;
+  computeNodeToElementCSR(&nodeElementPtr, &nodeToElements);
+
+  // Allocate the recovered data: the owned nodes followed by the
+  // dependent nodes
+  int dim1 = numOwnedNodes + numDependentNodes;
+  TacsScalar *data = new TacsScalar[dim1 * nvals];
+  memset(data, 0, dim1 * nvals * sizeof(TacsScalar));
+
+  if (thread_info->getNumThreads() > 1) {
+    tacsPInfo->assembler = this;
+    tacsPInfo->nodeElementPtr = nodeElementPtr;
+    tacsPInfo->nodeToElements = nodeToElements;
+    tacsPInfo->pointXpts = point_Xpts;
+    tacsPInfo->pointData = point_data;
+    tacsPInfo->numOutputVals = nvals;
+    tacsPInfo->smoothedData = data;
+
+    // Schedule the owned nodes and run the patch fits on the pool
+    TACSThreadPool *pool = getThreadPool();
+    pool->initSchedule(numOwnedNodes);
+    pool->run(TACSAssembler::recoverSmoothedData_thread, (void *)tacsPInfo);
+  } else {
+    TacsScalar *rhs = new TacsScalar[4 * nvals];
+    for (int i = 0; i < numOwnedNodes; i++) {
+      recoverPatchValues(i, nodeElementPtr, nodeToElements, point_Xpts,
+                         point_data, nvals, rhs, &data[nvals * i]);
+    }
+    delete[] rhs;
+  }
+
+  // Average the element-local values at the dependent nodes
+  if (numDependentNodes > 0) {
+    int *counts = new int[numDependentNodes];
+    memset(counts, 0, numDependentNodes * sizeof(int));
+
+    for (int i = 0; i < numElements; i++) {
+      int end = elementNodeIndex[i + 1];
+      for (int jp = elementNodeIndex[i]; jp < end; jp++) {
+        int node = elementTacsNodes[jp];
+        if (node < 0) {
+          int dep = -node - 1;
+          TacsScalar *d = &data[nvals * (numOwnedNodes + dep)];
+          for (int k = 0; k < nvals; k++) {
+            d[k] += point_data[nvals * jp + k];
+          }
+          counts[dep]++;
+        }
+      }
+    }
+
+    for (int dep = 0; dep < numDependentNodes; dep++) {
+      if (counts[dep] > 0) {
+        TacsScalar *d = &data[nvals * (numOwnedNodes + dep)];
+        for (int k = 0; k < nvals; k++) {
+          d[k] = d[k] / (1.0 * counts[dep]);
+        }
+      }
+    }
+    delete[] counts;
+  }
+
+  delete[] nodeElementPtr;
+  delete[] nodeToElements;
+  delete[] point_Xpts;
+  delete[] point_data;
+
+  // Set the output pointers
+  *_len = dim1;
+  *_nvals = nvals;
+  *_data = data;
+}
+
+/*!
+  Recover the smoothed output values at a single owned node.
+
+  A linear polynomial {1, x - x0, y - y0, z - z0}, centered at the
+  node, is fit by least squares to the element-local output values
+  over the node's patch of elements. With the centered basis the
+  constant coefficient of the fit is the recovered value at the node.
+  The normal equations are formed for all output components at once
+  and solved with a single dense 4x4 factorization.
+
+  Basis directions in which the patch has no extent - the normal
+  direction of a flat shell patch, for example - are excluded from the
+  fit so that the normal equations remain non-singular. If the solve
+  fails anyway, or the patch has fewer than four points, the fit falls
+  back to the plain average of the patch values.
+
+  input:
+  node:            the owned node index
+  nodeElementPtr:  pointer into the node -> element patch array
+  nodeToElements:  the node -> element patches over the local nodes
+  point_Xpts:      the coordinates of the element points
+  point_data:      the element-local output data
+  nvals:           the number of values at each point
+  rhs:             scratch array of length at least 4*nvals
+
+  output:
+  vals:  the recovered values at the node
+*/
+void TACSAssembler::recoverPatchValues(int node, const int *nodeElementPtr,
+                                       const int *nodeToElements,
+                                       const TacsScalar *point_Xpts,
+                                       const TacsScalar *point_data, int nvals,
+                                       TacsScalar *rhs, TacsScalar *vals) {
+  // Retrieve the coordinates of the owned nodes
+  TacsScalar *Xpts;
+  xptVec->getArray(&Xpts);
+  const TacsScalar *x0 = &Xpts[3 * node];
+
+  // The patches are indexed by local node number, with the owned
+  // nodes offset by the external nodes that precede them
+  int local = extNodeOffset + node;
+
+  // Form the normal equations for all output components at once
+  TacsScalar A[16];
+  memset(A, 0, 16 * sizeof(TacsScalar));
+  memset(rhs, 0, 4 * nvals * sizeof(TacsScalar));
+
+  int npatch = 0;
+  int end = nodeElementPtr[local + 1];
+  for (int ip = nodeElementPtr[local]; ip < end; ip++) {
+    int elem = nodeToElements[ip];
+    int jend = elementNodeIndex[elem + 1];
+    for (int jp = elementNodeIndex[elem]; jp < jend; jp++) {
+      TacsScalar p[4];
+      p[0] = 1.0;
+      p[1] = point_Xpts[3 * jp] - x0[0];
+      p[2] = point_Xpts[3 * jp + 1] - x0[1];
+      p[3] = point_Xpts[3 * jp + 2] - x0[2];
+
+      for (int m = 0; m < 4; m++) {
+        for (int n = 0; n < 4; n++) {
+          A[4 * m + n] += p[m] * p[n];
+        }
+      }
+
+      const TacsScalar *d = &point_data[nvals * jp];
+      for (int k = 0; k < nvals; k++) {
+        for (int m = 0; m < 4; m++) {
+          rhs[4 * k + m] += p[m] * d[k];
+        }
+      }
+      npatch++;
+    }
+  }
+
+  if (npatch == 0) {
+    memset(vals, 0, nvals * sizeof(TacsScalar));
+    return;
+  }
+
+  // Set the fall-back values: the plain average of the patch values.
+  // With the centered basis this is the constant-term entry of the
+  // right-hand side divided by the number of patch points
+  for (int k = 0; k < nvals; k++) {
+    vals[k] = rhs[4 * k] / (1.0 * npatch);
+  }
+
+  if (npatch < 4) {
+    return;
+  }
+
+  // Exclude the basis directions in which the patch has no extent by
+  // replacing their normal equations with the trivial equation. The
+  // length scale of the patch is set by the largest diagonal entry
+  double hmax = 0.0;
+  for (int m = 1; m < 4; m++) {
+    if (TacsRealPart(A[5 * m]) > hmax) {
+      hmax = TacsRealPart(A[5 * m]);
+    }
+  }
+  for (int m = 1; m < 4; m++) {
+    if (TacsRealPart(A[5 * m]) <= 1e-12 * hmax) {
+      for (int n = 0; n < 4; n++) {
+        A[4 * m + n] = A[4 * n + m] = 0.0;
+      }
+      A[5 * m] = 1.0;
+      for (int k = 0; k < nvals; k++) {
+        rhs[4 * k + m] = 0.0;
+      }
+    }
+  }
+
+  // Solve the normal equations for all the output components at
+  // once - the matrix is symmetric so the storage order is immaterial
+  int n = 4, info = 0, ipiv[4];
+  LAPACKgesv(&n, &nvals, A, &n, ipiv, rhs, &n, &info);
+
+  if (info == 0) {
+    for (int k = 0; k < nvals; k++) {
+      vals[k] = rhs[4 * k];
+    }
+  }
+}
+
 /* get average output stress resultants from TACS*/
 void TACSAssembler::getAverageStresses(ElementType elem_type,
                                        TacsScalar *avgStresses,
                                        int componentNum) {
+  finishDistributingVariables();
+
   // TacsScalar *avgStresses = new TacsScalar[9];
   // memset(avgStresses, 0, 9);
   int nvals;
@@ -6052,17 +10624,17 @@ void TACSAssembler::getAverageStresses(ElementType elem_type,
                   NULL, NULL);
 
   int numCompElems = 0;
-  for (int i = 0; i < numElements; i++) {
+  for (int i = 0; i < numElements - numHaloElements; i++) {
     // note TACS component nums are 0-based
     if (elements[i]->getComponentNum() == componentNum) {
       numCompElems += 1;
       int ptr = elementNodeIndex[i];
       int len = elementNodeIndex[i + 1] - ptr;
       const int *nodes = &elementTacsNodes[ptr];
-      xptVec->getValues(len, nodes, elemXpts);
-      varsVec->getValues(len, nodes, vars);
-      dvarsVec->getValues(len, nodes, dvars);
-      ddvarsVec->getValues(len, nodes, ddvars);
+      xptVec->getBlockedValues(len, nodes, elemXpts);
+      varsVec->getBlockedValues(len, nodes, vars);
+      dvarsVec->getBlockedValues(len, nodes, dvars);
+      ddvarsVec->getBlockedValues(len, nodes, ddvars);
 
       elements[i]->getAverageStresses(i, elem_type, elemXpts, vars, dvars,
                                       ddvars, &avgStresses[0]);
@@ -38,6 +38,57 @@ class TACSAssembler;
 #include "TACSSchurMat.h"
 #include "TACSSerialPivotMat.h"
 
+// The persistent work-stealing thread pool
+#include "TACSThreadPool.h"
+
+// The symbolic structure cache
+#include "TACSSymbolicStructure.h"
+
+#include <typeinfo>
+
+/*
+  Function pointer for a devirtualized residual kernel.
+
+  A kernel evaluates a batch of elements that all share one concrete
+  element type, with the element object supplied for each batch entry
+  so the batch may span distinct objects of that type. Kernels are
+  instantiated with TacsElementResidualKernel and registered with
+  TACSAssembler::registerResidualKernel().
+*/
+typedef void (*TacsElementResidualKernelFn)(
+    TACSElement **batchElems, int count, const int *elemIndex, double time,
+    const TacsScalar *Xpts, const TacsScalar *vars, const TacsScalar *dvars,
+    const TacsScalar *ddvars, TacsScalar *res);
+
+/**
+  Devirtualized residual kernel for the concrete element type ElemType.
+
+  The qualified calls bypass the virtual dispatch, so the compiler can
+  inline the element residual implementation into the batch loop. The
+  kernel must only be registered for the exact concrete type: the
+  assembler matches elements against the registered type before
+  dispatching to the kernel, so elements of any other type fall back
+  to the virtual path.
+*/
+template <class ElemType>
+void TacsElementResidualKernel(TACSElement **batchElems, int count,
+                               const int *elemIndex, double time,
+                               const TacsScalar *Xpts, const TacsScalar *vars,
+                               const TacsScalar *dvars,
+                               const TacsScalar *ddvars, TacsScalar *res) {
+  if (count <= 0) {
+    return;
+  }
+  const int nxpts = 3 * batchElems[0]->getNumNodes();
+  const int nvars = batchElems[0]->getNumVariables();
+  for (int i = 0; i < count; i++) {
+    ElemType *elem = static_cast<ElemType *>(batchElems[i]);
+    elem->ElemType::addResidual(elemIndex[i], time, &Xpts[nxpts * i],
+                                &vars[nvars * i], &dvars[nvars * i],
+                                &ddvars[nvars * i], &res[nvars * i]);
+  }
+}
+
 /*
   TACSAssembler
 
@@ -92,6 +143,17 @@ class TACSAssembler : public TACSObject {
   int setDependentNodes(const int *_depNodeIndex, const int *_depNodeToTacs,
                         const double *_depNodeWeights);
 
+  // Bulk ingestion of an externally generated mesh
+  // ----------------------------------------------
+  int setBulkModel(int *elemPtr, int *elemConn, int numElemTypes,
+                   TACSElement **elemTypes, const int *elemTypeIds,
+                   const TacsScalar *Xpts, int numBCNodes = 0,
+                   const int *bcNodes = NULL, int validate = 0);
+
+  // Declare trailing halo element replicas for redundant-compute assembly
+  // ---------------------------------------------------------------------
+  int setNumHaloElements(int _numHaloElements);
+
   void getAverageStresses(ElementType elem_type, TacsScalar *avgStresses,
                           int compNum);
   void setComplexStepGmatrix(bool flag);
@@ -119,6 +181,19 @@ class TACSAssembler : public TACSObject {
   // ----------------------------------------------------------
   void computeReordering(OrderingType order_type, MatrixOrderingType mat_type);
 
+  // Apply a partition-local RCM ordering automatically at initialize()
+  // ------------------------------------------------------------------
+  void setAutoLocalOrdering(int flag);
+
+  // Order each multiplier node directly after its independent nodes
+  // ---------------------------------------------------------------
+  void setLagrangeMultiplierOrdering(int flag);
+
+  // Reorder the elements so that consecutive elements share nodes
+  // -------------------------------------------------------------
+  void computeElementReordering(int group_by_constitutive = 0);
+  void getElementReordering(int *oldToNew);
+
   // Functions for retrieving the reordering
   // ---------------------------------------
   int isReordered();
@@ -164,6 +239,7 @@ class TACSAssembler : public TACSObject {
   void setNodes(TACSBVec *X);
   void getNodes(TACSBVec *X);
   void getNodes(TACSBVec **X);
+  int getNodeVersion();
 
   // Check for the elements for non-positive determinants
   // ----------------------------------------------------
@@ -204,9 +280,15 @@ class TACSAssembler : public TACSObject {
   // Create the matrices that can be used for analysis
   // -------------------------------------------------
   TACSParallelMat *createMat();
+  void setStaticCondensationOrdering(int flag);
   TACSSchurMat *createSchurMat(OrderingType order_type = TACS_AMD_ORDER);
   TACSSerialPivotMat *createSerialMat();
 
+  // Cache the symbolic structure across assembler instances
+  // -------------------------------------------------------
+  TACSSymbolicStructure *createSymbolicStructure();
+  void setSymbolicStructure(TACSSymbolicStructure *structure);
+
   // Retrieve or set the initial conditions for the simulation
   // --------------------------------------------------
   void getInitConditions(TACSBVec *vars, TACSBVec *dvars, TACSBVec *ddvars);
@@ -216,8 +298,27 @@ class TACSAssembler : public TACSObject {
   // -----------------------------------------
   void evalEnergies(TacsScalar *Te, TacsScalar *Pe);
 
+  // Register devirtualized residual kernels by concrete element type
+  // -----------------------------------------------------------------
+  void registerResidualKernel(const std::type_info *elemType,
+                              TacsElementResidualKernelFn kernel);
+  template <class ElemType>
+  void registerResidualKernel() {
+    registerResidualKernel(&typeid(ElemType),
+                           TacsElementResidualKernel<ElemType>);
+  }
+
+  // Record the per-element assembly cost for load rebalancing
+  // ---------------------------------------------------------
+  void setElementTimingFlag(int flag);
+  void zeroElementRuntimes();
+  void getElementRuntimes(double *times);
+
   // Residual and Jacobian assembly
   // ------------------------------
+  void setIncrementalAssembly(int flag);
+  void setCanonicalElementSharing(int flag);
+  void setLinearElementCaching(int flag);
   void assembleRes(TACSBVec *residual, const TacsScalar lambda = 1.0);
   void assembleJacobian(TacsScalar alpha, TacsScalar beta, TacsScalar gamma,
                         TACSBVec *residual, TACSMat *A,
@@ -230,6 +331,8 @@ class TACSAssembler : public TACSObject {
                         int nmats, TACSMat *A,
                         MatrixOrientation matOr = TACS_MAT_NORMAL,
                         const TacsScalar lambda = 1.0);
+  void assembleMatDiag(ElementMatrixType matType, TacsScalar alpha,
+                       TacsScalar beta, TacsScalar gamma, TACSBVec *diag);
   void addJacobianVecProduct(TacsScalar scale, TacsScalar alpha,
                              TacsScalar beta, TacsScalar gamma, TACSBVec *x,
                              TACSBVec *y,
@@ -274,6 +377,10 @@ class TACSAssembler : public TACSObject {
   void addAdjointResXptSensProducts(TacsScalar scale, int numAdjoints,
                                     TACSBVec **adjoint, TACSBVec **dfdXpts,
                                     const TacsScalar lambda = 1.0);
+  void addAdjointResProductsCombo(TacsScalar scale, int numAdjoints,
+                                  TACSBVec **adjoint, TACSBVec **dfdx,
+                                  TACSBVec **dfdXpts,
+                                  const TacsScalar lambda = 1.0);
 
   // Advanced function interface - for time integration
   // --------------------------------------------------
@@ -304,15 +411,32 @@ class TACSAssembler : public TACSObject {
                    double rtol = 1e-8, double atol = 1e-1);
   void testFunction(TACSFunction *func, double dh);
 
+  // Sampled spot-check verification of the sensitivity products
+  // -----------------------------------------------------------
+  int verifyAdjResProductsSample(int num_elem_samples, double dh = 1e-6,
+                                 int print_level = 1, double rtol = 1e-5,
+                                 double atol = 1e-5);
+  int verifyDVSensSample(int num_dv_samples, int numFuncs, TACSFunction **funcs,
+                         double dh = 1e-6, int print_level = 1,
+                         double rtol = 1e-5, double atol = 1e-5);
+
   // Set the number of threads to work with
   // --------------------------------------
   void setNumThreads(int t);
 
+  // Pin the assembly worker threads to processor cores
+  // --------------------------------------------------
+  void setThreadAffinity(int flag);
+
   // Get information about the output files; For use by TACSToFH5
   // ------------------------------------------------------------
   int getNumComponents();
   void getElementOutputData(ElementType elem_type, int write_flag, int *len,
-                            int *nvals, TacsScalar **data);
+                            int *nvals, TacsScalar **data, int num_comps = 0,
+                            const int *comp_nums = NULL);
+  void getSmoothedOutputData(ElementType elem_type, int write_flag, int *len,
+                             int *nvals, TacsScalar **data, int num_comps = 0,
+                             const int *comp_nums = NULL);
 
   // Functions for ordering the variables
   // ------------------------------------
@@ -332,6 +456,35 @@ class TACSAssembler : public TACSObject {
                        TacsScalar **v3, TacsScalar **v4, TacsScalar **x1,
                        TacsScalar **x2, TacsScalar **weights, TacsScalar **mat);
 
+  // Get the scratch arrays owned by a worker thread
+  // -----------------------------------------------
+  void getThreadDataPointers(int threadId, TacsScalar **data, int **idata);
+
+  // Get the scratch arrays for the per-function data
+  // ------------------------------------------------
+  void getFunctionDataPointers(int numFuncs, const int ***subDomains,
+                               int **subDomainSizes, int **cursors,
+                               int **active);
+
+  // Helper functions for evaluating all functions in a single sweep
+  // over the elements
+  // ---------------------------------------------------------------
+  void getFunctionDomains(int numFuncs, TACSFunction **funcs,
+                          const int **subDomains, int *subDomainSizes);
+  int getActiveFunctions(int elemNum, int numFuncs, TACSFunction **funcs,
+                         const int **subDomains, const int *subDomainSizes,
+                         int *cursors, int *active);
+
+  // Reverse-scatter plans restricted to the halo nodes touched by the
+  // element domain of each sub-domain function
+  // ----------------------------------------------------------------
+  void setupFunctionHaloDists(int numFuncs, TACSFunction **funcs,
+                              TACSBVec **vecs, int *use_restricted);
+  int findFunctionHaloDist(TACSFunction *func);
+  void buildFunctionHaloDist(TACSFunction *func, int usable);
+  void beginFunctionHaloAssembly(TACSFunction *func, TACSBVec *vec);
+  void endFunctionHaloAssembly(TACSFunction *func, TACSBVec *vec);
+
   // Functions that are used to perform reordering
   // ---------------------------------------------
   int computeExtNodes();
@@ -339,16 +492,27 @@ class TACSAssembler : public TACSObject {
                            int **_extCount = NULL, int **_recvPtr = NULL,
                            int **_recvCount = NULL, int **_recvNodes = NULL);
   int computeCouplingElements(int **_celems);
+  int computeCondensableNodes(int **_condNodes);
 
   // Functions for ordering the variables
   // ------------------------------------
   void computeLocalNodeToNodeCSR(int **_rowp, int **_cols, int nrnodes,
                                  const int *rnodes, int nodiag);
 
+  // Compute a hash of the mesh topology for symbolic-structure caching
+  uint32_t computeTopologyHash();
+
+  // Retrieve the node-to-node CSR, using the cached symbolic structure
+  // when its topology hash matches
+  void getSymbolicCSR(int **_rowp, int **_cols, int nodiag);
+
   // Compute the connectivity of the multiplier information
   void computeMultiplierConn(int *_num_multipliers, int **_multipliers,
                              int **_indep_ptr, int **_indep_nodes);
 
+  // Refine an ordering so multipliers follow their independent nodes
+  void reorderMultiplierNodes(int *newNodeNums);
+
   // Compute the reordering for a local matrix
   // -----------------------------------------
   void computeMatReordering(OrderingType order_type, int nvars, int *rowp,
@@ -375,9 +539,20 @@ class TACSAssembler : public TACSObject {
   // Reordering information
   TACSBVecIndices *newNodeIndices;
 
+  // Element reordering information old element i -> newElementNums[i]
+  int *newElementNums;
+
+  // Measured per-element assembly cost in seconds, accumulated by the
+  // serial assembly paths when the timing flag is set
+  int recordElementTime;
+  double *elementRuntime;
+
   // Additional information information for the TACSParallel class
   TACSBVecIndices *parMatIndices;
 
+  // Cached symbolic structure shared across assembler instances
+  TACSSymbolicStructure *symbolicStruct;
+
   // Additional ordering information for the TACSSchurMat class
   // These are created once - all subsequent calls use this data.
   TACSBVecIndices *schurBIndices, *schurCIndices;
@@ -392,6 +567,7 @@ class TACSAssembler : public TACSObject {
   // Information about the variables and elements
   int varsPerNode;         // number of variables per node
   int numElements;         // number of elements
+  int numHaloElements;     // number of trailing halo element replicas
   int numNodes;            // number of nodes referenced by this process
   int numOwnedNodes;       // number of nodes owned by this processor
   int numExtNodes;         // number of extneral nodes
@@ -420,15 +596,150 @@ class TACSAssembler : public TACSObject {
   // The auxiliary element class
   TACSAuxElements *auxElements;
 
+  // Cached load vector holding the contributions of the
+  // state-independent auxiliary elements, the time it was computed
+  // at, and whether it is up to date
+  TACSBVec *auxLoadVec;
+  double auxLoadTime;
+  int auxLoadsValid;
+  void computeAuxLoadVector(double time);
+
   // The variables, velocities and accelerations
   TACSBVec *varsVec, *dvarsVec, *ddvarsVec;
 
   // Memory for the node locations
   TACSBVec *xptVec;
+  int nodeVersion;  // Incremented each time the node locations change
 
   // Memory for the element residuals and variables
   TacsScalar *elementData;  // Space for element residuals/matrices
   int *elementIData;        // Space for element index data
+  int elementDataSize;      // Size of the scalar data layout
+  int elementIDataSize;     // Size of the index data
+
+  // Per-thread scratch space for the threaded assembly code. Each
+  // worker thread allocates its own slot the first time it is used
+  // and re-uses it across all subsequent assembly calls.
+  TacsScalar *threadElementData[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+  int *threadElementIData[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+
+  // Scratch space for the per-function data used when evaluating
+  // functions and their derivatives. The space is grown on demand and
+  // re-used across calls.
+  int maxNumFuncs;
+  const int **funcSubDomains;
+  int *funcIData;
+
+  // Cached reverse-scatter plans restricted to the halo nodes touched
+  // by the element domains of sub-domain functions
+  int numFuncDists, maxFuncDists;
+  TACSFunction **funcDistFuncs;
+  int *funcDistDomainSizes;
+  int **funcDistDomainElems;
+  int *funcDistUsable;
+  TACSBVecDistribute **funcDists;
+  TACSBVecDistCtx **funcDistCtxs;
+  TacsScalar **funcDistVals;
+
+  // Staging arrays for batches of element residual data
+  TacsScalar *batchData;
+  int *batchIData;
+  TACSElement **batchElemPtrs;
+
+  // Devirtualized residual kernels registered by concrete element
+  // type, and the per-element kernel resolved from the registry
+  int numResidualKernels;
+  const std::type_info **residualKernelTypes;
+  TacsElementResidualKernelFn *residualKernelFns;
+  TacsElementResidualKernelFn *elementKernels;
+  int kernelsResolved;
+
+  // Staging array for batches of element Jacobian matrices
+  TacsScalar *batchJacData;
+
+  // Staging data for the block-sparse element matrix scatter: the
+  // node-pair pattern queried from the element and the packed block
+  // rows submitted to the matrix
+  int *jacBlockPattern;
+  TacsScalar *blockScatterData;
+  int *blockScatterIData;
+  void addMatValuesSparse(TACSMat *A, const int elemNum, const TacsScalar *mat,
+                          const int *pattern);
+
+  // Precomputed gather/scatter plan for the element vectors. Each
+  // entry of elementTacsNodes is resolved once into a direct offset
+  // into the owned, external or dependent storage of a TACSBVec
+  // created by this assembler, which replaces the per-call ownership
+  // tests and external index searches in the assembly loops.
+  int *vecPlan;
+  void computeVecPlan();
+  void getVecValuesPlan(TACSBVec *vec, int elem, TacsScalar *vals);
+  void addVecValuesPlan(TACSBVec *vec, int elem, const TacsScalar *vals);
+
+  // Precomputed scatter plan for the element design variable
+  // gradients, in the same encoding as vecPlan. The per-element
+  // design variable counts vary, so the plan is stored in CSR form.
+  int *dvPlan;
+  int *dvPlanPtr;
+  int numOwnedDesignVars;
+  void computeDVPlan();
+  void addDVValuesPlan(TACSBVec *vec, int elem, int numDVs, const int *dvNums,
+                       const TacsScalar *vals);
+
+  // Data for incremental Jacobian re-assembly. When enabled, the
+  // per-element Jacobian contributions are cached and setDesignVars()
+  // marks the elements whose design variables actually changed, so
+  // that a subsequent assembly only recomputes the dirty elements.
+  int useIncrementalAssembly;  // Incremental assembly enabled?
+  int *elementDirtyFlags;      // Per-element dirty markers
+  TacsScalar *cachedElemJac;   // Cached element Jacobians
+  int cachedJacValid;          // Does the cache match the matrix state?
+  double cachedJacTime;        // The coefficients of the cached assembly
+  TacsScalar cachedJacAlpha, cachedJacBeta, cachedJacGamma, cachedJacLambda;
+  MatrixOrientation cachedJacMatOr;
+
+  // Data for canonical-element matrix sharing in assembleMatType().
+  // Translated copies of the same element object are grouped into
+  // equivalence classes from their node-relative geometry, and the
+  // element matrix is computed once per class and shared across the
+  // remaining members.
+  int useCanonicalElements;  // Canonical-element sharing enabled?
+  int *elemMatClass;         // Per-element class number, or -1
+  int *matClassElems;        // Representative element of each class
+  int numMatClasses;         // The number of shared classes
+  TacsScalar *matClassMats;  // One matrix slot for each shared class
+  int matClassNodeVersion;   // Node version when the classes were built
+  void computeElementMatClasses();
+
+  // Data for the cached linear-element fast path. The residual of an
+  // element with a constant Jacobian is affine in the states,
+  // r = r0 + K u + C udot + M uddot, with matrices that depend only
+  // on the node locations and the design variables. The matrices of
+  // these elements - springs, concentrated masses and rigid-body
+  // constraint elements - are probed once, the non-zero blocks are
+  // packed contiguously, and the serial assembly loops evaluate
+  // their contributions directly from the stored blocks without
+  // dispatching into the element.
+  int useLinearElemCache;      // Linear-element caching enabled?
+  int linearCacheValid;        // Does the cache match the DV state?
+  int linearCacheNodeVersion;  // Node version when the cache was built
+  double linearCacheTime;      // Simulation time when the cache was built
+  int linearCacheHasLoad;      // Does any cached element have r0 != 0?
+  int numLinearElems;          // The number of cached elements
+  int *linearElemOffset;       // Per-element offset into the data, or -1
+  int *linearElemFlags;        // Per-element bits marking the stored blocks
+  int *linearElemSize;         // Per-element number of variables
+  TacsScalar *linearElemData;  // The packed r0/K/C/M blocks
+  void computeLinearElementCache();
+
+  // Order condensable nodes first in createSchurMat()
+  int useCondensationOrdering;
+
+  // Order each multiplier node directly after its independent nodes
+  int useMultiplierOrdering;
+
+  // Apply a partition-local RCM ordering automatically at initialize()
+  int autoLocalOrdering;
 
   // Memory for the design variables and inddex data
   TacsScalar *elementSensData;
@@ -442,12 +753,20 @@ class TACSAssembler : public TACSObject {
   int mpiRank, mpiSize;
   MPI_Comm tacs_comm;
 
-  // The static member functions that are used to p-thread TACSAssembler
+  // The static member functions that are used to thread TACSAssembler
   // operations... These are the most time-consuming operations.
-  static void schedPthreadJob(TACSAssembler *tacs, int *index, int total_size);
   static void *assembleRes_thread(void *t);
   static void *assembleJacobian_thread(void *t);
   static void *assembleMatType_thread(void *t);
+  static void *recoverSmoothedData_thread(void *t);
+
+  // Recover the smoothed output values at a single owned node by a
+  // least-squares fit of a linear polynomial over the node's patch
+  void recoverPatchValues(int node, const int *nodeElementPtr,
+                          const int *nodeToElements,
+                          const TacsScalar *point_Xpts,
+                          const TacsScalar *point_data, int nvals,
+                          TacsScalar *rhs, TacsScalar *vals);
 
   // Class to store specific information about the threaded
   // operations to perform. Note that assembly operations are
@@ -472,6 +791,13 @@ class TACSAssembler : public TACSObject {
       fdvSens = NULL;
       fXptSens = NULL;
       adjoints = NULL;
+      elemSchedList = NULL;
+      nodeElementPtr = NULL;
+      nodeToElements = NULL;
+      pointXpts = NULL;
+      pointData = NULL;
+      numOutputVals = 0;
+      smoothedData = NULL;
     }
 
     // The data required to perform most of the matrix
@@ -500,14 +826,58 @@ class TACSAssembler : public TACSObject {
     // Information for adjoint-dR/dx products
     int numAdjoints;
     TACSBVec **adjoints;
+
+    // Optional indirection from schedule index to element index. When
+    // this is set, the schedule ranges from the thread pool index into
+    // this list, and the elements in the list are guaranteed to have
+    // disjoint node sets so no locking is needed during the scatter.
+    const int *elemSchedList;
+
+    // Information for the patch recovery of smoothed output data
+    const int *nodeElementPtr;     // Node -> element patch pointer
+    const int *nodeToElements;     // Node -> element patch elements
+    const TacsScalar *pointXpts;   // Coordinates of the element points
+    const TacsScalar *pointData;   // Element-local output data
+    int numOutputVals;             // Values per output point
+    TacsScalar *smoothedData;      // Recovered nodal output data
   } * tacsPInfo;
 
-  // The pthread data required to pthread tacs operations
-  int numCompletedElements;     // Keep track of how much work has been done
-  TACSThreadInfo *thread_info;  // The pthread object
+  // The data required to thread tacs operations
+  TACSThreadInfo *thread_info;  // The thread count information
+  int pinThreads;               // Pin the pool workers to cores
+
+  // The persistent work-stealing pool of worker threads. This is
+  // created on the first threaded assembly call and re-used until the
+  // number of threads is changed.
+  TACSThreadPool *threadPool;
+  TACSThreadPool *getThreadPool();
+
+  // The element coloring used for lock-free threaded matrix assembly.
+  // Elements with the same color have disjoint node sets (including
+  // the independent nodes of any dependent nodes) and can scatter
+  // into the matrix and residual concurrently without locks.
+  int numElementColors;  // The number of element colors
+  int *elementColorPtr;  // Pointer into the color-sorted element list
+  int *elementColorList;  // The elements sorted by color
+  void computeElementColoring();
+
+  // The interior/boundary element split used to overlap the element
+  // integration with the halo exchange of the state variables. An
+  // element is a boundary element if any of its nodes is owned by
+  // another processor or is a dependent node; interior elements can be
+  // integrated before the distribution of the variables has completed.
+  int *elementBoundaryFlag;
+  void computeBoundaryElements();
+
+  // Resolve the registered devirtualized kernel (if any) for each
+  // local element
+  void resolveResidualKernels();
+
+  // Bit-flags indicating which of the vars/dvars/ddvars distributions
+  // started by setVariables() have not yet been completed
+  int pendingVarsDist;
+  void finishDistributingVariables();
 
-  // The thread objects
-  pthread_t threads[TACSThreadInfo::TACS_MAX_NUM_THREADS];
   pthread_mutex_t tacs_mutex;  // The mutex for coordinating assembly ops.
 
   // The name of the TACSAssembler object
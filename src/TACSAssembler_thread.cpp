@@ -19,24 +19,18 @@
 #include "TACSAssembler.h"
 #include "tacslapack.h"
 
-/*!
-  Schedule the parts of the matrix/residual to assemble
+/*
+  The worker functions below pull chunks of element indices from the
+  work-stealing schedule in TACSThreadPool, rather than taking a
+  global lock for each element pick-up. Each worker owns a contiguous
+  range of elements and steals chunks from the other workers' ranges
+  once its own range is exhausted, which keeps heterogeneous element
+  mixes load-balanced.
+
+  Note that a stolen chunk may fall earlier in the element ordering
+  than the previous chunk, so the scan through the sorted auxiliary
+  element list must be restarted at the beginning of each chunk.
 */
-static pthread_mutex_t sched_mutex = PTHREAD_MUTEX_INITIALIZER;
-
-void TACSAssembler::schedPthreadJob(TACSAssembler *assembler, int *index,
-                                    int total_size) {
-  pthread_mutex_lock(&sched_mutex);
-
-  if (assembler->numCompletedElements < total_size) {
-    *index = assembler->numCompletedElements;
-    assembler->numCompletedElements += 1;
-  } else {
-    *index = -1;
-  }
-
-  pthread_mutex_unlock(&sched_mutex);
-}
 
 /*!
   The threaded-implementation of the residual assembly
@@ -54,39 +48,42 @@ void *TACSAssembler::assembleRes_thread(void *t) {
   TACSBVec *res = pinfo->res;
   TacsScalar lambda = pinfo->lambda;
 
-  // Allocate a temporary array large enough to store everything required
-  int s = assembler->maxElementSize;
-  int sx = 3 * assembler->maxElementNodes;
-  int dataSize = 4 * s + sx;
-  TacsScalar *data = new TacsScalar[dataSize];
+  // Claim a worker slot in the work-stealing schedule and retrieve
+  // the scratch arrays owned by this worker
+  TACSThreadPool *pool = assembler->threadPool;
+  const int threadId = pool->acquireThread();
+
+  TacsScalar *data;
+  int *idata;
+  assembler->getThreadDataPointers(threadId, &data, &idata);
 
-  // Set pointers to the allocate memory
+  // Set pointers into the scratch memory
+  int s = assembler->maxElementSize;
   TacsScalar *vars = &data[0];
   TacsScalar *dvars = &data[s];
   TacsScalar *ddvars = &data[2 * s];
   TacsScalar *elemRes = &data[3 * s];
   TacsScalar *elemXpts = &data[4 * s];
 
+  // The scratch block past the getDataPointers() layout is big
+  // enough for the aux element contributions of the largest element
+  TacsScalar *auxElemRes = &data[assembler->elementDataSize];
+
   // Set the data for the auxiliary elements - if there are any
   int naux = 0, aux_count = 0;
   TACSAuxElem *aux = NULL;
   if (assembler->auxElements) {
     naux = assembler->auxElements->getAuxElements(&aux);
   }
-  // To avoid allocating memory inside the element loop, make the aux element
-  // contribution array big enough for the largest element
-  TacsScalar *auxElemRes;
   bool scaleAux = lambda != TacsScalar(1.0) && naux > 0;
-  if (scaleAux) {
-    auxElemRes = new TacsScalar[s];
-  }
 
-  while (assembler->numCompletedElements < assembler->numElements) {
-    int elemIndex = -1;
-    TACSAssembler::schedPthreadJob(assembler, &elemIndex,
-                                   assembler->numElements);
+  int beginIndex, endIndex;
+  while (pool->getNextRange(threadId, &beginIndex, &endIndex)) {
+    // Restart the scan through the sorted auxiliary element list
+    // since stolen chunks may fall earlier in the element ordering
+    aux_count = 0;
 
-    if (elemIndex >= 0) {
+    for (int elemIndex = beginIndex; elemIndex < endIndex; elemIndex++) {
       // Get the element object
       TACSElement *element = assembler->elements[elemIndex];
 
@@ -94,12 +91,14 @@ void *TACSAssembler::assembleRes_thread(void *t) {
       int ptr = assembler->elementNodeIndex[elemIndex];
       int len = assembler->elementNodeIndex[elemIndex + 1] - ptr;
       const int *nodes = &assembler->elementTacsNodes[ptr];
-      assembler->xptVec->getValues(len, nodes, elemXpts);
-      assembler->varsVec->getValues(len, nodes, vars);
-      assembler->dvarsVec->getValues(len, nodes, dvars);
-      assembler->ddvarsVec->getValues(len, nodes, ddvars);
+      assembler->xptVec->getBlockedValues(len, nodes, elemXpts);
+      assembler->varsVec->getBlockedValues(len, nodes, vars);
+      assembler->dvarsVec->getBlockedValues(len, nodes, dvars);
+      assembler->ddvarsVec->getBlockedValues(len, nodes, ddvars);
 
-      // Generate the Jacobian of the element
+      // Generate the residual of the element
+      int nvars = element->getNumVariables();
+      memset(elemRes, 0, nvars * sizeof(TacsScalar));
       element->addResidual(elemIndex, assembler->time, elemXpts, vars, dvars,
                            ddvars, elemRes);
 
@@ -136,12 +135,7 @@ void *TACSAssembler::assembleRes_thread(void *t) {
       pthread_mutex_unlock(&assembler->tacs_mutex);
     }
   }
-  if (scaleAux) {
-    delete[] auxElemRes;
-  }
-  delete[] data;
-
-  pthread_exit(NULL);
+  return NULL;
 }
 
 /*!
@@ -166,16 +160,24 @@ void *TACSAssembler::assembleJacobian_thread(void *t) {
   TacsScalar lambda = pinfo->lambda;
   MatrixOrientation matOr = pinfo->matOr;
 
-  // Allocate a temporary array large enough to store everything
-  // required
+  // When an element schedule list is set, the schedule indices map
+  // through the list to elements with disjoint node sets, so the
+  // scatter below does not need the assembly mutex
+  const int *elemSchedList = pinfo->elemSchedList;
+
+  // Claim a worker slot in the work-stealing schedule and retrieve
+  // the scratch arrays owned by this worker
+  TACSThreadPool *pool = assembler->threadPool;
+  const int threadId = pool->acquireThread();
+
+  TacsScalar *data;
+  int *idata;
+  assembler->getThreadDataPointers(threadId, &data, &idata);
+
+  // Set pointers into the scratch memory
   int s = assembler->maxElementSize;
   int sx = 3 * assembler->maxElementNodes;
   int sw = assembler->maxElementIndepNodes;
-  int dataSize = 4 * s + sx + s * s + sw;
-  TacsScalar *data = new TacsScalar[dataSize];
-  int *idata = new int[sw + assembler->maxElementNodes + 1];
-
-  // Set pointers to the allocate memory
   TacsScalar *vars = &data[0];
   TacsScalar *dvars = &data[s];
   TacsScalar *ddvars = &data[2 * s];
@@ -191,12 +193,19 @@ void *TACSAssembler::assembleJacobian_thread(void *t) {
     naux = assembler->auxElements->getAuxElements(&aux);
   }
 
-  while (assembler->numCompletedElements < assembler->numElements) {
-    int elemIndex = -1;
-    TACSAssembler::schedPthreadJob(assembler, &elemIndex,
-                                   assembler->numElements);
+  int beginIndex, endIndex;
+  while (pool->getNextRange(threadId, &beginIndex, &endIndex)) {
+    // Restart the scan through the sorted auxiliary element list
+    // since stolen chunks may fall earlier in the element ordering
+    aux_count = 0;
+
+    for (int schedIndex = beginIndex; schedIndex < endIndex; schedIndex++) {
+      // Map the schedule index through the color list - if one is set
+      int elemIndex = schedIndex;
+      if (elemSchedList) {
+        elemIndex = elemSchedList[schedIndex];
+      }
 
-    if (elemIndex >= 0) {
       // Get the element object
       TACSElement *element = assembler->elements[elemIndex];
 
@@ -204,10 +213,10 @@ void *TACSAssembler::assembleJacobian_thread(void *t) {
       int ptr = assembler->elementNodeIndex[elemIndex];
       int len = assembler->elementNodeIndex[elemIndex + 1] - ptr;
       const int *nodes = &assembler->elementTacsNodes[ptr];
-      assembler->xptVec->getValues(len, nodes, elemXpts);
-      assembler->varsVec->getValues(len, nodes, vars);
-      assembler->dvarsVec->getValues(len, nodes, dvars);
-      assembler->ddvarsVec->getValues(len, nodes, ddvars);
+      assembler->xptVec->getBlockedValues(len, nodes, elemXpts);
+      assembler->varsVec->getBlockedValues(len, nodes, vars);
+      assembler->dvarsVec->getBlockedValues(len, nodes, dvars);
+      assembler->ddvarsVec->getBlockedValues(len, nodes, ddvars);
 
       // Retrieve the number of element variables
       int nvars = element->getNumVariables();
@@ -232,7 +241,12 @@ void *TACSAssembler::assembleJacobian_thread(void *t) {
         aux_count++;
       }
 
-      pthread_mutex_lock(&assembler->tacs_mutex);
+      // The scatter is lock-free when the coloring is active, since
+      // the elements within the job have disjoint node sets
+      if (!elemSchedList) {
+        pthread_mutex_lock(&assembler->tacs_mutex);
+      }
+
       // Add values to the residual
       if (res) {
         res->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
@@ -240,14 +254,14 @@ void *TACSAssembler::assembleJacobian_thread(void *t) {
 
       // Add values to the matrix
       assembler->addMatValues(A, elemIndex, elemMat, idata, elemWeights, matOr);
-      pthread_mutex_unlock(&assembler->tacs_mutex);
+
+      if (!elemSchedList) {
+        pthread_mutex_unlock(&assembler->tacs_mutex);
+      }
     }
   }
 
-  delete[] data;
-  delete[] idata;
-
-  pthread_exit(NULL);
+  return NULL;
 }
 
 /*!
@@ -271,51 +285,68 @@ void *TACSAssembler::assembleMatType_thread(void *t) {
   MatrixOrientation matOr = pinfo->matOr;
   TacsScalar lambda = pinfo->lambda;
 
-  // Allocate a temporary array large enough to store everything required
+  // Claim a worker slot in the work-stealing schedule and retrieve
+  // the scratch arrays owned by this worker
+  TACSThreadPool *pool = assembler->threadPool;
+  const int threadId = pool->acquireThread();
+
+  TacsScalar *data;
+  int *idata;
+  assembler->getThreadDataPointers(threadId, &data, &idata);
+
+  // Set pointers into the scratch memory
   int s = assembler->maxElementSize;
   int sx = 3 * assembler->maxElementNodes;
   int sw = assembler->maxElementIndepNodes;
-  int dataSize = s + sx + s * s + sw;
-  TacsScalar *data = new TacsScalar[dataSize];
-  int *idata = new int[sw + assembler->maxElementNodes + 1];
-
   TacsScalar *vars = &data[0];
   TacsScalar *elemXpts = &data[s];
   TacsScalar *elemWeights = &data[s + sx];
   TacsScalar *elemMat = &data[s + sx + sw];
 
+  // The scratch block past the getDataPointers() layout is big
+  // enough for the aux element matrix of the largest element
+  TacsScalar *auxElemMat = &data[assembler->elementDataSize];
+
   // Set the data for the auxiliary elements - if there are any
   int naux = 0, aux_count = 0;
   TACSAuxElem *aux = NULL;
   if (assembler->auxElements) {
     naux = assembler->auxElements->getAuxElements(&aux);
   }
-  TacsScalar *auxElemMat;
   bool scaleAux = lambda != TacsScalar(1.0) && naux > 0;
-  if (scaleAux) {
-    auxElemMat = new TacsScalar[s * s];
-  }
 
-  while (assembler->numCompletedElements < assembler->numElements) {
-    int elemIndex = -1;
-    TACSAssembler::schedPthreadJob(assembler, &elemIndex,
-                                   assembler->numElements);
+  int beginIndex, endIndex;
+  while (pool->getNextRange(threadId, &beginIndex, &endIndex)) {
+    // Restart the scan through the sorted auxiliary element list
+    // since stolen chunks may fall earlier in the element ordering
+    aux_count = 0;
 
-    if (elemIndex >= 0) {
+    for (int elemIndex = beginIndex; elemIndex < endIndex; elemIndex++) {
       // Get the element
       TACSElement *element = assembler->elements[elemIndex];
 
-      // Retrieve the variable values
       // Retrieve the variable values
       int ptr = assembler->elementNodeIndex[elemIndex];
       int len = assembler->elementNodeIndex[elemIndex + 1] - ptr;
       const int *nodes = &assembler->elementTacsNodes[ptr];
-      assembler->xptVec->getValues(len, nodes, elemXpts);
-      assembler->varsVec->getValues(len, nodes, vars);
-
-      // Retrieve the type of the matrix
-      element->getMatType(matType, elemIndex, assembler->time, elemXpts, vars,
-                          elemMat);
+      assembler->xptVec->getBlockedValues(len, nodes, elemXpts);
+      assembler->varsVec->getBlockedValues(len, nodes, vars);
+
+      // Retrieve the type of the matrix, or copy the shared matrix of
+      // the element's equivalence class. The class matrices were
+      // computed before the pool started, so they are read-only here.
+      int c = -1;
+      if (assembler->useCanonicalElements && assembler->elemMatClass) {
+        c = assembler->elemMatClass[elemIndex];
+      }
+      if (c >= 0) {
+        int nvars = element->getNumVariables();
+        memcpy(elemMat, &assembler->matClassMats[s * (size_t)s * c],
+               nvars * nvars * sizeof(TacsScalar));
+      } else {
+        element->getMatType(matType, elemIndex, assembler->time, elemXpts, vars,
+                            elemMat);
+      }
 
       // Increment the aux counter until we possibly have
       // aux[aux_count].num == elemIndex
@@ -350,10 +381,45 @@ void *TACSAssembler::assembleMatType_thread(void *t) {
       pthread_mutex_unlock(&assembler->tacs_mutex);
     }
   }
-  if (scaleAux) {
-    delete[] auxElemMat;
+  return NULL;
+}
+
+/*!
+  The threaded implementation of the smoothed output data recovery
+
+  Note that the input must be the TACSAssemblerPthreadInfo data type.
+  This function only uses the patch recovery data members. The patch
+  fits are independent and each owned node is visited exactly once, so
+  the recovered values are written without any locking.
+*/
+void *TACSAssembler::recoverSmoothedData_thread(void *t) {
+  TACSAssemblerPthreadInfo *pinfo = static_cast<TACSAssemblerPthreadInfo *>(t);
+
+  // Un-pack information for this computation
+  TACSAssembler *assembler = pinfo->assembler;
+  const int *nodeElementPtr = pinfo->nodeElementPtr;
+  const int *nodeToElements = pinfo->nodeToElements;
+  const TacsScalar *pointXpts = pinfo->pointXpts;
+  const TacsScalar *pointData = pinfo->pointData;
+  int nvals = pinfo->numOutputVals;
+  TacsScalar *smoothed = pinfo->smoothedData;
+
+  // Claim a worker slot in the work-stealing schedule
+  TACSThreadPool *pool = assembler->threadPool;
+  const int threadId = pool->acquireThread();
+
+  // Scratch space for the normal equations right-hand sides
+  TacsScalar *rhs = new TacsScalar[4 * nvals];
+
+  int beginIndex, endIndex;
+  while (pool->getNextRange(threadId, &beginIndex, &endIndex)) {
+    for (int node = beginIndex; node < endIndex; node++) {
+      assembler->recoverPatchValues(node, nodeElementPtr, nodeToElements,
+                                    pointXpts, pointData, nvals, rhs,
+                                    &smoothed[nvals * node]);
+    }
   }
-  delete[] data;
 
-  pthread_exit(NULL);
+  delete[] rhs;
+  return NULL;
 }
@@ -18,12 +18,69 @@
 
 #include "TACSBuckling.h"
 
+#include "TACSSchurMat.h"
 #include "tacslapack.h"
 
 /*
   Implementation of the buckling/frequency analysis
 */
 
+/*
+  Create the shifted operator K + sigma*G with a matrix-free
+  geometric stiffness matrix
+*/
+TACSMatFreeShiftedOp::TACSMatFreeShiftedOp(TACSAssembler *_assembler,
+                                           TACSMat *_kmat,
+                                           TACSMatrixFreeMat *_gmat,
+                                           TacsScalar _sigma) {
+  assembler = _assembler;
+  assembler->incref();
+  kmat = _kmat;
+  kmat->incref();
+  gmat = _gmat;
+  gmat->incref();
+  sigma = _sigma;
+
+  temp = assembler->createVec();
+  temp->incref();
+}
+
+TACSMatFreeShiftedOp::~TACSMatFreeShiftedOp() {
+  assembler->decref();
+  kmat->decref();
+  gmat->decref();
+  temp->decref();
+}
+
+/*
+  Set the shift parameter in the operator
+*/
+void TACSMatFreeShiftedOp::setShift(TacsScalar _sigma) { sigma = _sigma; }
+
+TACSVec *TACSMatFreeShiftedOp::createVec() { return assembler->createVec(); }
+
+/*
+  Compute y = (K + sigma*G)*x
+
+  The stiffness matrix product applies the boundary conditions, but
+  the matrix-free geometric stiffness product does not - the entries
+  of the product associated with the boundary conditions are zeroed
+  before the term is added so that the boundary rows of the operator
+  remain an identity.
+*/
+void TACSMatFreeShiftedOp::mult(TACSVec *x, TACSVec *y) {
+  kmat->mult(x, y);
+  if (sigma != TacsScalar(0.0)) {
+    gmat->mult(x, temp);
+    assembler->applyBCs(temp);
+    y->axpy(sigma, temp);
+  }
+}
+
+const char *TACSMatFreeShiftedOp::getObjectName() {
+  return "TACSMatFreeShiftedOp";
+}
+
 /*
   Linear buckling analysis object.
 
@@ -104,6 +161,24 @@ TACSLinearBuckling::TACSLinearBuckling(TACSAssembler *_assembler,
   // multigrid level.
   mg = dynamic_cast<TACSMg *>(pc);
 
+  // Check whether the geometric stiffness matrix is matrix-free. In
+  // this case the auxiliary matrix must be the shifted operator so
+  // that only the stiffness matrix is ever assembled and factored.
+  gmat_free = dynamic_cast<TACSMatrixFreeMat *>(gmat);
+  shift_op = dynamic_cast<TACSMatFreeShiftedOp *>(aux_mat);
+  if (gmat_free && !shift_op) {
+    fprintf(stderr,
+            "TACSBuckling: Error, a matrix-free geometric stiffness "
+            "matrix requires a TACSMatFreeShiftedOp auxiliary matrix\n");
+    gmat_free = NULL;
+  }
+  if (gmat_free && mg) {
+    fprintf(stderr,
+            "TACSBuckling: Error, a matrix-free geometric stiffness "
+            "matrix cannot be used with a multigrid preconditioner\n");
+    gmat_free = NULL;
+  }
+
   // Store the spectral shift info
   sigma = _sigma;
 
@@ -121,6 +196,12 @@ TACSLinearBuckling::TACSLinearBuckling(TACSAssembler *_assembler,
   sep->incref();
   sep->setTolerances(eig_tol, SEP::SMALLEST_MAGNITUDE, num_eigvals);
 
+  // By default, each solve restarts the Lanczos iteration and
+  // refactors the preconditioner
+  use_factor_reuse = 0;
+  factor_reuse_tol = 0.01;
+  pc_factored = 0;
+
   // Allocate temporary local vectors
   res = assembler->createVec();
   update = assembler->createVec();
@@ -167,6 +248,59 @@ TacsScalar TACSLinearBuckling::getSigma() { return sigma; }
 void TACSLinearBuckling::setSigma(TacsScalar _sigma) {
   sigma = _sigma;
   ep_op->setSigma(sigma);
+  if (gmat_free && shift_op) {
+    shift_op->setShift(sigma);
+  }
+}
+
+/*
+  Warm-start each eigenvalue solve from the eigenvector basis
+  computed during the previous solve
+*/
+void TACSLinearBuckling::setWarmStart(int flag) { sep->setWarmStart(flag); }
+
+/*
+  Re-use the factorization of the shifted operator across calls to
+  solve() when it remains an effective preconditioner.
+
+  Before refactoring, the existing factorization is applied to the
+  action of the updated operator on the load path. If the result
+  deviates from the identity by less than the given relative
+  tolerance, the (expensive) refactorization is skipped and the
+  Krylov solver absorbs the difference in a few extra iterations.
+
+  input:
+  flag:  re-use the factorization when possible
+  tol:   relative tolerance on the preconditioned identity check
+*/
+void TACSLinearBuckling::setFactorizationReuse(int flag, double tol) {
+  use_factor_reuse = flag;
+  factor_reuse_tol = tol;
+}
+
+/*
+  Check whether the current factorization of the preconditioner is
+  still a good approximation of the given operator. This applies the
+  factorization to op_mat*path and measures the relative deviation
+  from path itself - an inexpensive test requiring one matrix-vector
+  product and one application of the preconditioner.
+*/
+int TACSLinearBuckling::checkFactorReuse(TACSMat *op_mat) {
+  if (!(use_factor_reuse && pc_factored)) {
+    return 0;
+  }
+
+  TacsScalar pnorm = path->norm();
+  if (TacsRealPart(pnorm) == 0.0) {
+    return 0;
+  }
+
+  op_mat->mult(path, res);
+  pc->applyFactor(res, update);
+  update->axpy(-1.0, path);
+
+  return (TacsRealPart(update->norm()) <
+          factor_reuse_tol * TacsRealPart(pnorm));
 }
 
 /*
@@ -232,6 +366,52 @@ void TACSLinearBuckling::solve(TACSVec *rhs, TACSVec *u0, KSMPrint *ksm_print) {
     // Assemble the geometric stiffness matrix and the stiffness matrix itself
     assembler->assembleMatType(TACS_STIFFNESS_MATRIX, kmat);
     assembler->assembleMatType(TACS_GEOMETRIC_STIFFNESS_MATRIX, gmat);
+  } else if (gmat_free && shift_op) {
+    // The geometric stiffness matrix is matrix-free: assemble and
+    // factor the stiffness matrix - this is the only factorization
+    // required during the entire solve
+    assembler->assembleMatType(TACS_STIFFNESS_MATRIX, kmat);
+    pc->factor();
+    pc_factored = 1;
+
+    if (u0) {
+      path->copyValues(u0);
+    } else {
+      // The shifted operator reduces to the stiffness matrix while
+      // solving for the load path
+      shift_op->setShift(0.0);
+      assembler->assembleRes(res);
+
+      // If need to add rhs
+      if (rhs) {
+        // copy force values and zero bcs indices
+        update->copyValues(rhs);
+        assembler->applyBCs(update);
+        res->axpy(-1.0, update);
+      }
+
+      // Solve for the load path and set the variables
+      solver->solve(res, path);
+      path->scale(-1.0);
+    }
+
+    // set BCs associated with displacements (displacement control)
+    assembler->setBCs(path);
+    assembler->setVariables(path);
+
+    // Assemble the quadrature-point data for the matrix-free
+    // geometric stiffness products and restore the shift. The
+    // factorization of the stiffness matrix is retained as the
+    // preconditioner for the shifted operator - the Krylov solver
+    // absorbs the sigma*G term in extra iterations instead of a
+    // second factorization
+    gmat_free->assembleMatrixFreeData(TACS_GEOMETRIC_STIFFNESS_MATRIX, 1.0, 0.0,
+                                      0.0);
+    shift_op->setShift(sigma);
+
+    // Solve the symmetric eigenvalue problem
+    sep->solve(ksm_print);
+    return;
   } else {
     // Compute the stiffness matrix and copy the values to the
     // auxiliary matrix used to solve for the load path.
@@ -241,7 +421,10 @@ void TACSLinearBuckling::solve(TACSVec *rhs, TACSVec *u0, KSMPrint *ksm_print) {
     if (u0) {
       path->copyValues(u0);
     } else {
-      pc->factor();
+      if (!checkFactorReuse(aux_mat)) {
+        pc->factor();
+        pc_factored = 1;
+      }
       assembler->assembleRes(res);
 
       // If need to add rhs
@@ -269,8 +452,16 @@ void TACSLinearBuckling::solve(TACSVec *rhs, TACSVec *u0, KSMPrint *ksm_print) {
     aux_mat->applyBCs(assembler->getBcMap());
   }
 
-  // Factor the preconditioner
-  pc->factor();
+  // Factor the preconditioner for the shifted operator, unless the
+  // existing factorization can be re-used
+  TACSMat *op_mat = aux_mat;
+  if (mg) {
+    mg->getMat(&op_mat);
+  }
+  if (!checkFactorReuse(op_mat)) {
+    pc->factor();
+    pc_factored = 1;
+  }
 
   // Solve the symmetric eigenvalue problem
   sep->solve(ksm_print);
@@ -674,10 +865,29 @@ TACSFrequencyAnalysis::TACSFrequencyAnalysis(TACSAssembler *_assembler,
   sep->incref();
   sep->setTolerances(eig_tol, SEP::SMALLEST_MAGNITUDE, num_eigvals);
 
+  // Store the eigenvalue count and tolerance for the sliced solves
+  this->num_eigvals = num_eigvals;
+  this->eig_tol = eig_tol;
+
   // Set unallocated objects to NULL
   pcmat = NULL;
   jd_op = NULL;
   jd = NULL;
+
+  // Mode tracking is disabled by default
+  track_modes = 0;
+  tracking_initialized = 0;
+  prev_modes = NULL;
+  cur_modes = NULL;
+  mode_indices = NULL;
+
+  // Set the default path-following refinement controls
+  path_max_iters = 15;
+  path_rtol = 1e-6;
+  path_div_factor = 10.0;
+  path_eigs = NULL;
+  path_errors = NULL;
+  path_work = NULL;
 }
 
 /*!
@@ -757,14 +967,51 @@ TACSFrequencyAnalysis::TACSFrequencyAnalysis(
   // Set the tolerance to the Jacobi-Davidson solver
   jd->setTolerances(eigtol, 1e-30, eig_rtol, eig_atol);
 
+  // Store the eigenvalue count and tolerance
+  this->num_eigvals = num_eigvals;
+  eig_tol = eigtol;
+
   // Set the number of eigenvectors to recycle
   jd->setRecycle(num_recycle, recycle_type);
+
+  // Mode tracking is disabled by default
+  track_modes = 0;
+  tracking_initialized = 0;
+  prev_modes = NULL;
+  cur_modes = NULL;
+  mode_indices = NULL;
+
+  // Set the default path-following refinement controls
+  path_max_iters = 15;
+  path_rtol = 1e-6;
+  path_div_factor = 10.0;
+  path_eigs = NULL;
+  path_errors = NULL;
+  path_work = NULL;
 }
 
 /*
   Deallocate all of the stored data
 */
 TACSFrequencyAnalysis::~TACSFrequencyAnalysis() {
+  if (prev_modes) {
+    for (int i = 0; i < num_eigvals; i++) {
+      prev_modes[i]->decref();
+      cur_modes[i]->decref();
+    }
+    delete[] prev_modes;
+    delete[] cur_modes;
+    delete[] mode_indices;
+  }
+
+  if (path_eigs) {
+    delete[] path_eigs;
+    delete[] path_errors;
+  }
+  if (path_work) {
+    path_work->decref();
+  }
+
   assembler->decref();
   eigvec->decref();
   res->decref();
@@ -801,12 +1048,45 @@ void TACSFrequencyAnalysis::setSigma(TacsScalar _sigma) {
   }
 }
 
+/*
+  Set the flag to warm-start each Lanczos solve from the Ritz vectors
+  computed during the previous solve. Since the mode shapes change
+  slowly across design iterations, this typically cuts the number of
+  Lanczos iterations substantially. The Jacobi-Davidson solver
+  recycles its subspace through the num_recycle argument instead.
+*/
+void TACSFrequencyAnalysis::setWarmStart(int flag) {
+  if (sep) {
+    sep->setWarmStart(flag);
+  }
+}
+
+/*
+  Enable or disable mode tracking across solves.
+
+  When enabled, the eigenvectors from each solve are matched against
+  the mode shapes from the previous solve using the modal assurance
+  criterion so that each tracked mode keeps a consistent index even
+  when the eigenvalues cross. The tracked indices are accessed through
+  getTrackedModeIndex() or the extractTracked* functions.
+*/
+void TACSFrequencyAnalysis::setModeTracking(int flag) {
+  track_modes = flag;
+  if (!track_modes) {
+    tracking_initialized = 0;
+  }
+}
+
 /*
   Solve the eigenvalue problem
 */
-void TACSFrequencyAnalysis::solve(KSMPrint *ksm_print, int print_level) {
-  // Zero the variables
-  assembler->zeroVariables();
+void TACSFrequencyAnalysis::solve(KSMPrint *ksm_print, int print_level,
+                                  int zero_variables) {
+  // Zero the variables. Path-following solves about a non-zero state
+  // skip this so that the stiffness reflects the current state.
+  if (zero_variables) {
+    assembler->zeroVariables();
+  }
   if (jd) {
     if (mg) {
       // Assemble the mass matrix
@@ -884,6 +1164,391 @@ void TACSFrequencyAnalysis::solve(KSMPrint *ksm_print, int print_level) {
       ksm_print->print(line);
     }
   }
+
+  // Match the new eigenvectors against the tracked mode shapes
+  if (track_modes) {
+    trackModes(ksm_print);
+  }
+}
+
+/*
+  Count the number of eigenvalues of the problem K*u = lambda*M*u
+  that lie below the given shift.
+
+  The count is obtained by factoring the shifted operator K - shift*M
+  and counting the negative pivots in the factorization. Since the
+  factorization is performed without pivoting, Sylvester's law of
+  inertia guarantees that the number of negative pivots equals the
+  number of eigenvalues below the shift. This is used to verify that
+  the sliced eigenvalue solves have not skipped any modes.
+
+  This requires the Lanczos solver path with a TACSSchurPc
+  preconditioner, since the pivot count is extracted from the Schur
+  complement factorization. Note that this call overwrites the
+  stiffness matrix with the shifted operator and re-factors the
+  preconditioner.
+
+  returns: the number of eigenvalues below the shift, or -1 if the
+  count is not available
+*/
+int TACSFrequencyAnalysis::countEigenvaluesBelow(TacsScalar shift) {
+  TACSSchurPc *schur_pc = dynamic_cast<TACSSchurPc *>(pc);
+  if (jd || mg || !mmat || !schur_pc) {
+    fprintf(stderr,
+            "TACSFrequency: Eigenvalue counts require the Lanczos "
+            "solver with a TACSSchurPc preconditioner\n");
+    return -1;
+  }
+
+  // Assemble and factor the shifted operator K - shift*M
+  assembler->zeroVariables();
+  assembler->assembleMatType(TACS_STIFFNESS_MATRIX, kmat);
+  assembler->assembleMatType(TACS_MASS_MATRIX, mmat);
+  kmat->axpy(-shift, mmat);
+  kmat->applyBCs(assembler->getBcMap());
+  pc->factor();
+
+  // The boundary condition rows are replaced by identity rows which
+  // contribute only positive pivots
+  return schur_pc->countNegativePivots();
+}
+
+/*!
+  Compute the eigenvalues within the range [eig_min, eig_max] using
+  spectrum slicing.
+
+  The range is split into num_slices windows and an independent
+  shift-inverted Lanczos solve is performed with the shift placed at
+  the center of each window. Each solve converges the eigenvalues
+  closest to its shift, so a sliced solve recovers many more modes
+  than a single-shift solve of the same subspace size. Before the
+  window solves, the shifted operator is factored at each window
+  boundary and the negative pivot counts are recorded; by Sylvester's
+  law of inertia the difference between the counts at the two ends of
+  a window is the exact number of eigenvalues it contains, which is
+  checked against the number of converged eigenvalues recovered from
+  the window.
+
+  The windows are solved sequentially on the full communicator, since
+  the matrices and solver are bound to the communicator of the
+  assembler. The converged eigenvalues within the range are written
+  in window order to slice_eigs. The eigenvectors of the final window
+  remain available through extractEigenvector().
+
+  input:
+  eig_min:        the lower bound of the eigenvalue range
+  eig_max:        the upper bound of the eigenvalue range
+  num_slices:     the number of windows to use
+  max_slice_eigs: the length of the slice_eigs array
+  slice_eigs:     array in which the eigenvalues are written
+  ksm_print:      a KSMPrint object for printing the progress
+  print_level:    the print level to use
+
+  returns: the total number of converged eigenvalues found in the
+  range, or -1 on an error
+*/
+int TACSFrequencyAnalysis::solveSliced(TacsScalar eig_min, TacsScalar eig_max,
+                                       int num_slices, int max_slice_eigs,
+                                       TacsScalar *slice_eigs,
+                                       KSMPrint *ksm_print, int print_level) {
+  if (jd || mg || !mmat) {
+    fprintf(stderr,
+            "TACSFrequency: Spectrum slicing requires the Lanczos "
+            "solver without multigrid\n");
+    return -1;
+  }
+  if (num_slices < 1) {
+    num_slices = 1;
+  }
+
+  int rank;
+  MPI_Comm_rank(assembler->getMPIComm(), &rank);
+
+  // Save the shift so that it can be restored after the solves
+  TacsScalar sigma_orig = sigma;
+
+  // Record the inertia counts at the window boundaries. These are
+  // computed before the window solves since each solve re-factors
+  // the preconditioner at its own shift.
+  int *counts = new int[num_slices + 1];
+  int have_counts = 1;
+  for (int k = 0; k <= num_slices; k++) {
+    TacsScalar bound =
+        eig_min + (k / ((double)num_slices)) * (eig_max - eig_min);
+    counts[k] = countEigenvaluesBelow(bound);
+    if (counts[k] < 0) {
+      have_counts = 0;
+    }
+  }
+
+  if (have_counts && ksm_print) {
+    char line[256];
+    sprintf(line, "Eigenvalues in range: %d\n", counts[num_slices] - counts[0]);
+    ksm_print->print(line);
+  }
+
+  // Solve each window with the shift at its center and harvest the
+  // converged eigenvalues that fall within the window
+  int num_found = 0;
+  for (int k = 0; k < num_slices; k++) {
+    TacsScalar lower =
+        eig_min + (k / ((double)num_slices)) * (eig_max - eig_min);
+    TacsScalar upper =
+        eig_min + ((k + 1) / ((double)num_slices)) * (eig_max - eig_min);
+
+    setSigma(0.5 * (lower + upper));
+    solve(ksm_print, print_level);
+
+    int window_found = 0;
+    for (int n = 0; n < num_eigvals; n++) {
+      TacsScalar error;
+      TacsScalar eig = sep->extractEigenvalue(n, &error);
+      if (fabs(TacsRealPart(error)) < eig_tol &&
+          TacsRealPart(eig) >= TacsRealPart(lower) &&
+          TacsRealPart(eig) < TacsRealPart(upper)) {
+        if (slice_eigs && num_found < max_slice_eigs) {
+          slice_eigs[num_found] = eig;
+        }
+        num_found++;
+        window_found++;
+      }
+    }
+
+    // Validate the window against the inertia counts
+    if (have_counts) {
+      int expected = counts[k + 1] - counts[k];
+      if (window_found != expected && rank == 0) {
+        fprintf(stderr,
+                "TACSFrequency: Window %d recovered %d of %d "
+                "eigenvalues; increase num_eigvals or num_slices\n",
+                k, window_found, expected);
+      }
+    }
+
+    if (ksm_print) {
+      char line[256];
+      sprintf(line, "Window %3d eigenvalues: %d\n", k, window_found);
+      ksm_print->print(line);
+    }
+  }
+
+  // Restore the original shift
+  setSigma(sigma_orig);
+  delete[] counts;
+
+  return num_found;
+}
+
+/*
+  Set the controls for the path-following eigenpair refinement.
+
+  input:
+  max_iters:  the maximum number of inverse iterations per mode
+  rtol:       the relative eigenvalue residual tolerance
+  div_factor: residual growth factor that triggers divergence
+*/
+void TACSFrequencyAnalysis::setPathRefinement(int max_iters, double rtol,
+                                              double div_factor) {
+  if (max_iters > 0) {
+    path_max_iters = max_iters;
+  }
+  if (rtol > 0.0) {
+    path_rtol = rtol;
+  }
+  if (div_factor > 1.0) {
+    path_div_factor = div_factor;
+  }
+}
+
+/*
+  Advance the eigenpairs to the current point along a parameter path.
+
+  At closely spaced path points a full Lanczos solve repeats almost
+  all of its work, since the eigenpairs barely move between points.
+  This call instead refines the eigenpairs from the previous point by
+  inverse iteration: each tracked mode shape seeds the iteration, the
+  Rayleigh quotient provides the eigenvalue estimate, and the solves
+  with the shifted operator re-use the preconditioner factorization
+  from the last full solve. The Krylov solver corrects for the drift
+  in the operator, so the solves remain accurate as the path moves
+  away from the factorization point.
+
+  The stiffness matrix is assembled about the current state of the
+  assembler, so set the state for the path point before calling. The
+  first call performs a full eigensolve to seed the path. If the
+  refinement of any mode diverges, stagnates or collapses onto
+  another mode, the call falls back to a full eigensolve, which also
+  refreshes the factorization for the subsequent path points.
+
+  The refined eigenpairs are accessed through getPathEigenvalue()
+  and getPathEigenvector() in tracked mode order.
+
+  returns: 1 if the point was refined from the previous eigenpairs,
+  0 if a full eigensolve was performed, and -1 on error
+*/
+int TACSFrequencyAnalysis::solvePath(KSMPrint *ksm_print, int print_level) {
+  if (jd || mg || !mmat) {
+    fprintf(stderr,
+            "TACSFrequency: Path continuation requires the Lanczos "
+            "solver path with a mass matrix\n");
+    return -1;
+  }
+
+  // The tracked mode shapes seed the continuation
+  if (!track_modes) {
+    track_modes = 1;
+  }
+
+  // Allocate the storage for the refined eigenpairs
+  if (!path_eigs) {
+    path_eigs = new TacsScalar[num_eigvals];
+    path_errors = new TacsScalar[num_eigvals];
+  }
+  if (!path_work) {
+    path_work = assembler->createVec();
+    path_work->incref();
+  }
+
+  // Seed the path with a full eigensolve at the first point
+  if (!tracking_initialized) {
+    solve(ksm_print, print_level, 0);
+    for (int m = 0; m < num_eigvals; m++) {
+      TacsScalar err;
+      path_eigs[m] = extractTrackedEigenvalue(m, &err);
+      path_errors[m] = err;
+    }
+    return 0;
+  }
+
+  // Assemble the matrices about the current state and form the
+  // shifted operator. The preconditioner is deliberately not
+  // re-factored here.
+  assembler->assembleMatType(TACS_STIFFNESS_MATRIX, kmat);
+  assembler->assembleMatType(TACS_MASS_MATRIX, mmat);
+  kmat->axpy(-sigma, mmat);
+  kmat->applyBCs(assembler->getBcMap());
+
+  int fail = 0;
+  for (int m = 0; m < num_eigvals && !fail; m++) {
+    eigvec->copyValues(prev_modes[m]);
+
+    double prev_rel = -1.0;
+    int converged = 0;
+    for (int iter = 0; iter < path_max_iters; iter++) {
+      // Solve (K - sigma*M)*w = M*v for the next iterate
+      mmat->mult(eigvec, res);
+      assembler->applyBCs(res);
+      solver->solve(res, eigvec);
+
+      // Normalize the iterate in the mass matrix inner product
+      mmat->mult(eigvec, res);
+      TacsScalar mnorm = sqrt(eigvec->dot(res));
+      if (TacsRealPart(mnorm) <= 0.0) {
+        break;
+      }
+      eigvec->scale(1.0 / mnorm);
+      res->scale(1.0 / mnorm);
+
+      // Compute the Rayleigh quotient from the shifted operator
+      kmat->mult(eigvec, path_work);
+      TacsScalar theta = eigvec->dot(path_work);
+      TacsScalar eig = sigma + theta;
+
+      // Compute the relative eigenvalue residual
+      path_work->axpy(-theta, res);
+      double rnorm = TacsRealPart(path_work->norm());
+      double rscale = fabs(TacsRealPart(eig)) * TacsRealPart(res->norm());
+      if (rscale == 0.0) {
+        rscale = 1.0;
+      }
+      double rel = rnorm / rscale;
+
+      if (rel < path_rtol) {
+        path_eigs[m] = eig;
+        path_errors[m] = rel;
+        prev_modes[m]->copyValues(eigvec);
+        converged = 1;
+        break;
+      }
+
+      // Divergence detection: the residual should contract between
+      // the inverse iterations
+      if (prev_rel > 0.0 && rel > path_div_factor * prev_rel) {
+        break;
+      }
+      prev_rel = rel;
+    }
+
+    if (!converged) {
+      fail = 1;
+    }
+  }
+
+  // Guard against two modes collapsing onto the same eigenvector.
+  // The refined modes are M-normalized so the inner products measure
+  // their correlation directly.
+  for (int m = 0; m < num_eigvals && !fail; m++) {
+    mmat->mult(prev_modes[m], res);
+    for (int j = m + 1; j < num_eigvals && !fail; j++) {
+      double h = fabs(TacsRealPart(res->dot(prev_modes[j])));
+      if (h > 0.9) {
+        fail = 1;
+      }
+    }
+  }
+
+  if (fail) {
+    // Fall back to the full eigensolve about the current state. This
+    // also refreshes the factorization used by the continuation.
+    if (ksm_print) {
+      ksm_print->print(
+          "TACSFrequency: Path refinement diverged; "
+          "performing a full eigensolve\n");
+    }
+    solve(ksm_print, print_level, 0);
+    for (int m = 0; m < num_eigvals; m++) {
+      TacsScalar err;
+      path_eigs[m] = extractTrackedEigenvalue(m, &err);
+      path_errors[m] = err;
+    }
+    return 0;
+  }
+
+  return 1;
+}
+
+/*
+  Retrieve the eigenvalue for the given tracked mode from the most
+  recent path point
+*/
+TacsScalar TACSFrequencyAnalysis::getPathEigenvalue(int mode,
+                                                    TacsScalar *error) {
+  if (!path_eigs || mode < 0 || mode >= num_eigvals) {
+    fprintf(stderr, "TACSFrequency: Path eigenvalue %d not available\n", mode);
+    return 0.0;
+  }
+  if (error) {
+    *error = path_errors[mode];
+  }
+  return path_eigs[mode];
+}
+
+/*
+  Retrieve the eigenvector for the given tracked mode from the most
+  recent path point
+*/
+TacsScalar TACSFrequencyAnalysis::getPathEigenvector(int mode, TACSBVec *ans,
+                                                     TacsScalar *error) {
+  if (!path_eigs || !prev_modes || mode < 0 || mode >= num_eigvals) {
+    fprintf(stderr, "TACSFrequency: Path eigenvector %d not available\n",
+            mode);
+    return 0.0;
+  }
+  ans->copyValues(prev_modes[mode]);
+  if (error) {
+    *error = path_errors[mode];
+  }
+  return path_eigs[mode];
 }
 
 /*!
@@ -911,6 +1576,156 @@ TacsScalar TACSFrequencyAnalysis::extractEigenvector(int n, TACSBVec *ans,
   }
 }
 
+/*
+  Match the eigenvectors from the most recent solve against the
+  tracked mode shapes.
+
+  The correlation between each tracked mode and each new eigenvector
+  is measured with the modal assurance criterion evaluated in the mass
+  matrix inner product. Each tracked mode is assigned greedily to the
+  best-correlated unassigned eigenvector, and the matched eigenvector
+  becomes the reference shape for the next solve. If a tracked mode
+  drifts to the top of the eigenvalue window, the Lanczos solver is
+  asked to converge a buffer of extra eigenvalues on subsequent solves
+  so that the tracking does not latch onto an unconverged estimate.
+*/
+void TACSFrequencyAnalysis::trackModes(KSMPrint *ksm_print) {
+  // Allocate storage for the tracked and current mode shapes
+  if (!prev_modes) {
+    prev_modes = new TACSBVec *[num_eigvals];
+    cur_modes = new TACSBVec *[num_eigvals];
+    mode_indices = new int[num_eigvals];
+    for (int i = 0; i < num_eigvals; i++) {
+      prev_modes[i] = assembler->createVec();
+      prev_modes[i]->incref();
+      cur_modes[i] = assembler->createVec();
+      cur_modes[i]->incref();
+    }
+  }
+
+  // Extract the eigenvectors from the most recent solve
+  for (int i = 0; i < num_eigvals; i++) {
+    extractEigenvector(i, cur_modes[i], NULL);
+  }
+
+  if (!tracking_initialized) {
+    // On the first tracked solve the tracked ordering coincides with
+    // the eigenvalue ordering
+    for (int i = 0; i < num_eigvals; i++) {
+      mode_indices[i] = i;
+      prev_modes[i]->copyValues(cur_modes[i]);
+    }
+    tracking_initialized = 1;
+    return;
+  }
+
+  // Compute the correlation between the tracked and the new mode
+  // shapes in the mass matrix inner product
+  double *mac = new double[num_eigvals * num_eigvals];
+  double *cnorm = new double[num_eigvals];
+  for (int t = 0; t < num_eigvals; t++) {
+    if (mmat) {
+      mmat->mult(prev_modes[t], res);
+    } else {
+      res->copyValues(prev_modes[t]);
+    }
+    double pnorm = TacsRealPart(res->dot(prev_modes[t]));
+    for (int j = 0; j < num_eigvals; j++) {
+      double h = fabs(TacsRealPart(res->dot(cur_modes[j])));
+      mac[t * num_eigvals + j] = h * h / pnorm;
+    }
+  }
+  for (int j = 0; j < num_eigvals; j++) {
+    if (mmat) {
+      mmat->mult(cur_modes[j], res);
+    } else {
+      res->copyValues(cur_modes[j]);
+    }
+    cnorm[j] = TacsRealPart(res->dot(cur_modes[j]));
+  }
+
+  // Assign each tracked mode to the best-correlated eigenvector that
+  // has not yet been assigned
+  int max_index = 0;
+  int *used = new int[num_eigvals];
+  memset(used, 0, num_eigvals * sizeof(int));
+  for (int t = 0; t < num_eigvals; t++) {
+    int best = -1;
+    double best_mac = -1.0;
+    for (int j = 0; j < num_eigvals; j++) {
+      if (!used[j]) {
+        double m = mac[t * num_eigvals + j] / cnorm[j];
+        if (m > best_mac) {
+          best_mac = m;
+          best = j;
+        }
+      }
+    }
+    used[best] = 1;
+    mode_indices[t] = best;
+    if (best > max_index) {
+      max_index = best;
+    }
+
+    // Store the matched shape as the reference for the next solve
+    prev_modes[t]->copyValues(cur_modes[best]);
+
+    if (ksm_print) {
+      char line[256];
+      sprintf(line, "Mode tracking: mode %3d -> eig %3d  MAC %8.4f\n", t, best,
+              best_mac);
+      ksm_print->print(line);
+    }
+  }
+
+  // If a tracked mode has drifted to the top of the window, converge
+  // extra eigenvalues on subsequent solves
+  if (sep) {
+    sep->setConvergenceBuffer(max_index >= num_eigvals - 2 ? 2 : 0);
+  }
+
+  delete[] mac;
+  delete[] cnorm;
+  delete[] used;
+}
+
+/*
+  Get the current eigenvalue index of the given tracked mode, or -1 if
+  mode tracking has not been initialized by a solve
+*/
+int TACSFrequencyAnalysis::getTrackedModeIndex(int mode) {
+  if (!track_modes || !tracking_initialized || mode < 0 ||
+      mode >= num_eigvals) {
+    return -1;
+  }
+  return mode_indices[mode];
+}
+
+/*
+  Extract the eigenvalue associated with the given tracked mode
+*/
+TacsScalar TACSFrequencyAnalysis::extractTrackedEigenvalue(int mode,
+                                                           TacsScalar *error) {
+  int index = getTrackedModeIndex(mode);
+  if (index < 0) {
+    index = mode;
+  }
+  return extractEigenvalue(index, error);
+}
+
+/*
+  Extract the eigenvector associated with the given tracked mode
+*/
+TacsScalar TACSFrequencyAnalysis::extractTrackedEigenvector(int mode,
+                                                            TACSBVec *ans,
+                                                            TacsScalar *error) {
+  int index = getTrackedModeIndex(mode);
+  if (index < 0) {
+    index = mode;
+  }
+  return extractEigenvector(index, ans, error);
+}
+
 /*
   Check the orthogonality of the Lanczos subspace
 */
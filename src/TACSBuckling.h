@@ -27,8 +27,43 @@
 #include "GSEP.h"
 #include "JacobiDavidson.h"
 #include "TACSAssembler.h"
+#include "TACSMatrixFreeMat.h"
 #include "TACSMg.h"
 
+/*
+  Shifted buckling operator with a matrix-free geometric stiffness
+  matrix.
+
+  This operator computes products with K + sigma*G, where the
+  stiffness matrix K is assembled but the geometric stiffness matrix
+  G is applied matrix-free. For large high-order models, G costs as
+  much memory as K when assembled - using this operator as the
+  auxiliary matrix in TACSLinearBuckling avoids assembling G
+  entirely, while the factorization of K alone serves as the
+  preconditioner for the shifted solves.
+*/
+class TACSMatFreeShiftedOp : public TACSMat {
+ public:
+  TACSMatFreeShiftedOp(TACSAssembler *_assembler, TACSMat *_kmat,
+                       TACSMatrixFreeMat *_gmat, TacsScalar _sigma);
+  ~TACSMatFreeShiftedOp();
+
+  // Set the shift parameter
+  void setShift(TacsScalar _sigma);
+
+  // Compute products with the shifted operator
+  TACSVec *createVec();
+  void mult(TACSVec *x, TACSVec *y);
+  const char *getObjectName();
+
+ private:
+  TACSAssembler *assembler;
+  TACSMat *kmat;
+  TACSMatrixFreeMat *gmat;
+  TacsScalar sigma;
+  TACSBVec *temp;
+};
+
 /*
   Linearized buckling analysis code.
 
@@ -57,6 +92,11 @@ class TACSLinearBuckling : public TACSObject {
   TacsScalar getSigma();
   void setSigma(TacsScalar sigma);
 
+  // Options for re-using information across design iterations
+  // ---------------------------------------------------------
+  void setWarmStart(int flag);
+  void setFactorizationReuse(int flag, double tol = 0.01);
+
   // Solve the eigenvalue problem
   // ----------------------------
   void solve(TACSVec *rhs = NULL, TACSVec *u0 = NULL,
@@ -76,12 +116,20 @@ class TACSLinearBuckling : public TACSObject {
   void printOrthogonality();
 
  private:
+  // Check whether the factorization can be re-used for the operator
+  int checkFactorReuse(TACSMat *op_mat);
+
   // Data for the eigenvalue analysis
   TacsScalar sigma;
 
   EPBucklingShiftInvert *ep_op;
   SEP *sep;
 
+  // Options controlling factorization re-use across solves
+  int use_factor_reuse;
+  double factor_reuse_tol;
+  int pc_factored;
+
   // The tacs object
   TACSAssembler *assembler;
 
@@ -96,6 +144,12 @@ class TACSLinearBuckling : public TACSObject {
   TACSKsm *solver;
   TACSMat *aux_mat, *kmat, *gmat;
 
+  // Non-NULL when the geometric stiffness matrix is matrix-free. In
+  // this case the auxiliary matrix must be the shifted operator and
+  // only the stiffness matrix is factored.
+  TACSMatrixFreeMat *gmat_free;
+  TACSMatFreeShiftedOp *shift_op;
+
   // Vectors used in the analysis
   TACSBVec *path;  // The solution path
   TACSBVec *res, *update, *eigvec;
@@ -148,10 +202,35 @@ class TACSFrequencyAnalysis : public TACSObject {
   // ----------------------------------------
   TacsScalar getSigma();
   void setSigma(TacsScalar _sigma);
-  void solve(KSMPrint *ksm_print = NULL, int print_level = 0);
+  void setWarmStart(int flag);
+  void solve(KSMPrint *ksm_print = NULL, int print_level = 0,
+             int zero_variables = 1);
   void evalEigenDVSens(int n, TACSBVec *dfdx);
   void evalEigenXptSens(int n, TACSBVec *dfdX);
 
+  // Track the modes across a sequence of solves
+  // -------------------------------------------
+  void setModeTracking(int flag);
+  int getTrackedModeIndex(int mode);
+  TacsScalar extractTrackedEigenvalue(int mode, TacsScalar *error);
+  TacsScalar extractTrackedEigenvector(int mode, TACSBVec *ans,
+                                       TacsScalar *error);
+
+  // Spectrum slicing over a range of eigenvalues
+  // --------------------------------------------
+  int countEigenvaluesBelow(TacsScalar shift);
+  int solveSliced(TacsScalar eig_min, TacsScalar eig_max, int num_slices,
+                  int max_slice_eigs, TacsScalar *slice_eigs,
+                  KSMPrint *ksm_print = NULL, int print_level = 0);
+
+  // Path-following continuation of the eigenpairs
+  // ---------------------------------------------
+  void setPathRefinement(int max_iters, double rtol, double div_factor);
+  int solvePath(KSMPrint *ksm_print = NULL, int print_level = 0);
+  TacsScalar getPathEigenvalue(int mode, TacsScalar *error = NULL);
+  TacsScalar getPathEigenvector(int mode, TACSBVec *ans,
+                                TacsScalar *error = NULL);
+
   // Extract and check the solution
   // ------------------------------
   TacsScalar extractEigenvalue(int n, TacsScalar *error);
@@ -180,10 +259,36 @@ class TACSFrequencyAnalysis : public TACSObject {
   EPShiftInvert *simple_ep_op;
   SEP *sep;
 
+  // The number of eigenvalues and the eigenvalue tolerance
+  int num_eigvals;
+  double eig_tol;
+
   // Objects associated with the Jacobi-Davidson method
   TACSJDFrequencyOperator *jd_op;
   TACSJacobiDavidson *jd;
 
+  // Match the new eigenvectors against the tracked mode shapes
+  void trackModes(KSMPrint *ksm_print);
+
+  // Data for tracking the modes across solves. The tracked mode
+  // shapes are stored in tracked order, and mode_indices maps each
+  // tracked mode to its index in the current eigenvalue ordering.
+  int track_modes;
+  int tracking_initialized;
+  TACSBVec **prev_modes;
+  TACSBVec **cur_modes;
+  int *mode_indices;
+
+  // Data for the path-following eigenpair continuation. The tracked
+  // mode shapes double as the continuation seeds and the refined
+  // eigenvalues and residuals are stored in tracked order.
+  int path_max_iters;
+  double path_rtol;
+  double path_div_factor;
+  TacsScalar *path_eigs;
+  TacsScalar *path_errors;
+  TACSBVec *path_work;
+
   // Vectors required for eigen-sensitivity analysis
   TACSBVec *eigvec, *res;
 };
@@ -192,6 +192,10 @@ TACSContinuation::TACSContinuation(TACSAssembler *_assembler,
   term_function = NULL;
   term_function_value = 1.0;
   dlambda_ds_term_value = -1e20;
+
+  // Default to the tangent predictor with a fixed arc-length increment
+  predictor_order = 0;
+  target_correction_iters = 0;
 }
 
 TACSContinuation::~TACSContinuation() {
@@ -222,6 +226,42 @@ void TACSContinuation::setTermLambdaRate(TacsScalar term_dlambda_ds) {
   dlambda_ds_term_value = term_dlambda_ds;
 }
 
+/**
+  Set the order of the polynomial predictor.
+
+  When the order is greater than zero, the predictor for each load
+  step is computed by extrapolating a Lagrange polynomial through the
+  last (order + 1) converged points (u, lambda), parameterized by the
+  accumulated arc-length. A better predictor starts the corrector
+  closer to the equilibrium path and reduces the number of corrector
+  iterations per step. Until enough points have been accumulated, the
+  first-order tangent predictor is used. Setting the order to zero
+  recovers the tangent predictor.
+*/
+void TACSContinuation::setPredictorOrder(int order) {
+  predictor_order = order;
+  if (predictor_order < 0) {
+    predictor_order = 0;
+  }
+}
+
+/**
+  Set the target number of corrector iterations per load step.
+
+  When the target is greater than zero, the arc-length increment is
+  adapted after each converged step: the target change in the solution
+  is scaled by sqrt(target/actual), so that steps converging in fewer
+  iterations than the target grow and steps requiring more iterations
+  shrink. The scaling factor is limited to the range [0.5, 2.0] per
+  step. Setting the target to zero keeps the increment fixed.
+*/
+void TACSContinuation::setTargetCorrectionIters(int iters) {
+  target_correction_iters = iters;
+  if (target_correction_iters < 0) {
+    target_correction_iters = 0;
+  }
+}
+
 /**
   Retrieve information about the solve
 */
@@ -298,9 +338,27 @@ void TACSContinuation::solve_tangent(TACSMat *mat, TACSPc *pc, TACSKsm *ksm,
       new TACSContinuationPathMat(mat, load, tangent, 0.0);
   path_mat->incref();
 
+  // Allocate storage for the predictor history: the most recent
+  // converged points along the path, parameterized by arc-length
+  int num_hist = 0;
+  int max_hist = (predictor_order > 0 ? predictor_order + 1 : 0);
+  TACSBVec **hist_vars = NULL;
+  TacsScalar *hist_lambda = NULL;
+  TacsScalar *hist_s = NULL;
+  if (max_hist > 0) {
+    hist_vars = new TACSBVec *[max_hist];
+    hist_lambda = new TacsScalar[max_hist];
+    hist_s = new TacsScalar[max_hist];
+    for (int k = 0; k < max_hist; k++) {
+      hist_vars[k] = assembler->createVec();
+      hist_vars[k]->incref();
+    }
+  }
+
   TacsScalar lambda = 0.0;          // The load factor
   TacsScalar lambda_old = 0.0;      // The previous load factor
   TacsScalar target_delta_r = 0.0;  // Target change in r = (u - u_k)^T(u - u_k)
+  TacsScalar path_s = 0.0;          // The accumulated arc-length position
 
   double t0 = MPI_Wtime();
 
@@ -481,17 +539,55 @@ void TACSContinuation::solve_tangent(TACSMat *mat, TACSPc *pc, TACSKsm *ksm,
     old_vars->copyValues(vars);
     lambda_old = lambda;
 
+    // Record the converged point in the predictor history
+    if (max_hist > 0) {
+      if (num_hist == max_hist) {
+        // Shift out the oldest point, recycling its vector
+        TACSBVec *oldest = hist_vars[0];
+        for (int k = 0; k < max_hist - 1; k++) {
+          hist_vars[k] = hist_vars[k + 1];
+          hist_lambda[k] = hist_lambda[k + 1];
+          hist_s[k] = hist_s[k + 1];
+        }
+        hist_vars[max_hist - 1] = oldest;
+        num_hist--;
+      }
+      hist_vars[num_hist]->copyValues(vars);
+      hist_lambda[num_hist] = lambda;
+      hist_s[num_hist] = path_s;
+      num_hist++;
+    }
+
     // Set the tolerances for the correction update iterations
     ksm->setTolerances(krylov_rtol, krylov_atol);
 
     // Try using the current solution again
     int fail_flag = 1;
     int nrestarts = 0;
+    int ncorrections = 1;
     for (; fail_flag && (nrestarts < max_correction_restarts); nrestarts++) {
-      // Perform an update based on the calculated value of ds
-      // This ensures that the step lenght constraint is satisfied
-      vars->axpy(delta_s, tangent);
-      lambda = lambda + dlambda_ds * delta_s;
+      if (num_hist >= 2) {
+        // Extrapolate the predictor through the stored points with a
+        // Lagrange polynomial evaluated at the new arc-length position
+        TacsScalar snew = path_s + delta_s;
+        vars->zeroEntries();
+        lambda = 0.0;
+        for (int i = 0; i < num_hist; i++) {
+          TacsScalar coef = 1.0;
+          for (int j = 0; j < num_hist; j++) {
+            if (i != j) {
+              coef *= (snew - hist_s[j]) / (hist_s[i] - hist_s[j]);
+            }
+          }
+          vars->axpy(coef, hist_vars[i]);
+          lambda = lambda + coef * hist_lambda[i];
+        }
+      } else {
+        // Perform an update based on the calculated value of ds
+        // This ensures that the step lenght constraint is satisfied
+        vars->axpy(delta_s, tangent);
+        lambda = lambda + dlambda_ds * delta_s;
+      }
 
       // Set the ksm to use the path_mat object
       ksm->setOperators(path_mat, pc);
@@ -519,6 +615,7 @@ void TACSContinuation::solve_tangent(TACSMat *mat, TACSPc *pc, TACSKsm *ksm,
         } else if (TacsRealPart(res_norm) <
                    correction_rtol * TacsRealPart(init_res_norm)) {
           fail_flag = 0;
+          ncorrections = j;
           break;
         } else if (TacsRealPart(res_norm) >
                    correction_dtol * TacsRealPart(init_res_norm)) {
@@ -554,11 +651,36 @@ void TACSContinuation::solve_tangent(TACSMat *mat, TACSPc *pc, TACSKsm *ksm,
       break;
     }
 
+    // Update the arc-length position with the step that converged
+    path_s = path_s + delta_s;
+
+    // Adapt the target solution increment based on the number of
+    // corrector iterations used for this step
+    if (target_correction_iters > 0 && iteration_count > 0) {
+      double fact = sqrt(target_correction_iters / (double)ncorrections);
+      if (fact > 2.0) {
+        fact = 2.0;
+      } else if (fact < 0.5) {
+        fact = 0.5;
+      }
+      target_delta_r = fact * target_delta_r;
+    }
+
     if (callback) {
       callback->iteration(iteration_count, vars, lambda, dlambda_ds, assembler);
     }
   }
 
+  // Free the predictor history
+  if (max_hist > 0) {
+    for (int k = 0; k < max_hist; k++) {
+      hist_vars[k]->decref();
+    }
+    delete[] hist_vars;
+    delete[] hist_lambda;
+    delete[] hist_s;
+  }
+
   // Deallocate temporary variables
   vars->decref();
   old_vars->decref();
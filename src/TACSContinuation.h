@@ -120,6 +120,11 @@ class TACSContinuation : public TACSObject {
   void setTermFunction(TACSFunction *func, TacsScalar term_value);
   void setTermLambdaRate(TacsScalar term_dlambda_ds);
 
+  // Set the predictor and adaptive step-size options
+  // ------------------------------------------------
+  void setPredictorOrder(int order);
+  void setTargetCorrectionIters(int iters);
+
   // Perform a continuation solve using a linearized arc-length constraint
   // ---------------------------------------------------------------------
   void solve_tangent(TACSMat *mat, TACSPc *pc, TACSKsm *ksm, TACSBVec *load,
@@ -148,6 +153,13 @@ class TACSContinuation : public TACSObject {
   // relative and absolute tolerances for the tangent computation
   double tangent_rtol, tangent_atol;
 
+  // Order of the polynomial predictor extrapolation (0 = tangent only)
+  int predictor_order;
+
+  // Target corrector iteration count for adaptive arc-length control
+  // (0 = keep the arc-length increment fixed)
+  int target_correction_iters;
+
   // Solution variables
   TACSAssembler *assembler;
 
@@ -71,6 +71,11 @@ TACSCreator::TACSCreator(MPI_Comm _comm, int _vars_per_node) {
   num_elements = 0;
   num_dependent_nodes = 0;
 
+  // No extruded-topology description by default
+  num_base_nodes = 0;
+  num_base_elements = 0;
+  num_layers = 0;
+
   // Set the element connectivity and nodes
   elem_id_nums = NULL;
   elem_node_ptr = NULL;
@@ -90,6 +95,8 @@ TACSCreator::TACSCreator(MPI_Comm _comm, int _vars_per_node) {
   bc_ptr = NULL;
   bc_vars = NULL;
   bc_vals = NULL;
+  bc_win = MPI_WIN_NULL;
+  bc_packed = 0;
 
   // Set the dependent node pointers to zero
   new_nodes = NULL;
@@ -99,13 +106,23 @@ TACSCreator::TACSCreator(MPI_Comm _comm, int _vars_per_node) {
   owned_elements = NULL;
   owned_nodes = NULL;
 
+  // No element cost weights by default
+  num_partition_weights = 0;
+  partition_weights = NULL;
+  partition_dof_balance = 0;
+  element_weights = NULL;
+
   // Set the elements array to NULL
   elements = NULL;
   element_creator = NULL;
 
+  // No boundary element replication by default
+  replicate_boundary = 0;
+
   // Information about the partitioned mesh
   num_owned_elements = 0;
   num_owned_nodes = 0;
+  num_halo_elements = 0;
   local_elem_id_nums = NULL;
 }
 
@@ -125,17 +142,23 @@ TACSCreator::~TACSCreator() {
   if (Xpts) {
     delete[] Xpts;
   }
-  if (bc_nodes) {
-    delete[] bc_nodes;
-  }
-  if (bc_vars) {
-    delete[] bc_vars;
-  }
-  if (bc_vals) {
-    delete[] bc_vals;
-  }
-  if (bc_ptr) {
-    delete[] bc_ptr;
+  if (bc_packed) {
+    // The boundary condition arrays point into a single packed
+    // segment whose base is bc_nodes
+    TacsFreeSharedMemory(bc_nodes, &bc_win);
+  } else {
+    if (bc_nodes) {
+      delete[] bc_nodes;
+    }
+    if (bc_vars) {
+      delete[] bc_vars;
+    }
+    if (bc_vals) {
+      delete[] bc_vals;
+    }
+    if (bc_ptr) {
+      delete[] bc_ptr;
+    }
   }
   if (dep_node_ptr) {
     delete[] dep_node_ptr;
@@ -152,6 +175,12 @@ TACSCreator::~TACSCreator() {
   if (partition) {
     delete[] partition;
   }
+  if (partition_weights) {
+    delete[] partition_weights;
+  }
+  if (element_weights) {
+    delete[] element_weights;
+  }
   if (owned_elements) {
     delete[] owned_elements;
   }
@@ -199,6 +228,92 @@ void TACSCreator::setGlobalConnectivity(int _num_nodes, int _num_elements,
   memcpy(elem_id_nums, _elem_id_nums, num_elements * sizeof(int));
 }
 
+/*
+  Set the global connectivity for an extruded or swept mesh described
+  as (base mesh) x (layers).
+
+  The base mesh gives the connectivity of a single plane of nodes. The
+  full mesh consists of num_layers element layers stacked between
+  num_layers+1 node planes. The node numbers are assigned plane-major:
+  node n on plane p is numbered p*num_base_nodes + n, and the elements
+  are laid out layer-major in the same manner. The element in layer p
+  derived from base element e connects the nodes of e on plane p
+  followed by the same nodes on plane p+1, and inherits the element id
+  of its base element. Note that the base connectivity must use the
+  TACS tensor-product node ordering so that the extruded elements do
+  as well - a linear quad base produces linear hexahedral elements.
+
+  The plane-major numbering is banded with a bandwidth of roughly
+  twice the number of nodes per plane. For meshes that are long in the
+  sweep direction this is already a near-optimal fill-reducing order,
+  so the reordering step in TACSAssembler can be left disabled.
+
+  Like setGlobalConnectivity(), the connectivity only needs to be set
+  on the root processor.
+
+  input:
+  num_base_nodes:      the number of nodes in the base plane
+  num_base_elements:   the number of elements in the base mesh
+  base_elem_node_ptr:  pointer into the base connectivity array
+  base_elem_node_conn: the base element -> node connectivity
+  base_elem_id_nums:   the base element id numbers
+  num_layers:          the number of element layers in the extrusion
+*/
+void TACSCreator::setExtrudedConnectivity(int _num_base_nodes,
+                                          int _num_base_elements,
+                                          const int *_base_elem_node_ptr,
+                                          const int *_base_elem_node_conn,
+                                          const int *_base_elem_id_nums,
+                                          int _num_layers) {
+  if (_num_base_nodes <= 0 || _num_base_elements <= 0 || _num_layers <= 0) {
+    fprintf(stderr,
+            "TACSCreator: The extruded mesh description must have a "
+            "positive number of base nodes, base elements and layers\n");
+    return;
+  }
+
+  // Record the extruded-topology description
+  num_base_nodes = _num_base_nodes;
+  num_base_elements = _num_base_elements;
+  num_layers = _num_layers;
+
+  // Set the sizes of the full extruded mesh
+  num_nodes = (num_layers + 1) * num_base_nodes;
+  num_elements = num_layers * num_base_elements;
+
+  // Each extruded element connects the base element nodes on two
+  // adjacent planes
+  int base_conn_size = _base_elem_node_ptr[num_base_elements];
+  elem_node_ptr = new int[num_elements + 1];
+  elem_node_conn = new int[2 * num_layers * base_conn_size];
+  elem_id_nums = new int[num_elements];
+
+  elem_node_ptr[0] = 0;
+  int *conn = elem_node_conn;
+  for (int p = 0; p < num_layers; p++) {
+    for (int e = 0; e < num_base_elements; e++) {
+      // Connect the base element nodes on plane p, then the same
+      // nodes on plane p+1
+      for (int jp = _base_elem_node_ptr[e]; jp < _base_elem_node_ptr[e + 1];
+           jp++) {
+        conn[0] = p * num_base_nodes + _base_elem_node_conn[jp];
+        conn++;
+      }
+      for (int jp = _base_elem_node_ptr[e]; jp < _base_elem_node_ptr[e + 1];
+           jp++) {
+        conn[0] = (p + 1) * num_base_nodes + _base_elem_node_conn[jp];
+        conn++;
+      }
+
+      int elem = p * num_base_elements + e;
+      elem_node_ptr[elem + 1] =
+          elem_node_ptr[elem] + 2 * (_base_elem_node_ptr[e + 1] -
+                                     _base_elem_node_ptr[e]);
+      elem_id_nums[elem] = _base_elem_id_nums[e];
+    }
+  }
+}
+
 /*
   Set the dependent node information
 */
@@ -310,6 +425,166 @@ void TACSCreator::setReorderingType(
   mat_type = _mat_type;
 }
 
+/*
+  Set the relative cost weights used when partitioning the mesh.
+
+  The weights are indexed by the element-id numbers supplied through
+  setGlobalConnectivity(). The weight for an element type should be
+  proportional to its cost in assembleJacobian() - these can be
+  measured with the kernel benchmark or a quick warmup timing pass.
+  Without weights, a mesh that mixes cheap and expensive element types
+  can end up badly load-imbalanced even when the element counts are
+  balanced.
+
+  This call must be made before partitionMesh() to take effect.
+
+  input:
+  num_weights:  the number of element-id weights
+  weights:      the relative cost of each element type
+*/
+void TACSCreator::setPartitionWeights(int _num_weights,
+                                      const double *_weights) {
+  if (partition_weights) {
+    delete[] partition_weights;
+    partition_weights = NULL;
+    num_partition_weights = 0;
+  }
+  if (_num_weights > 0 && _weights) {
+    num_partition_weights = _num_weights;
+    partition_weights = new double[num_partition_weights];
+    memcpy(partition_weights, _weights,
+           num_partition_weights * sizeof(double));
+  }
+}
+
+/*
+  Balance the number of element nodes as a second partition constraint.
+
+  When this flag is set, the METIS multi-constraint interface balances
+  both the element cost weights and the per-element node counts, so
+  that processors end up with comparable numbers of degrees of freedom
+  as well as comparable assembly cost.
+*/
+void TACSCreator::setPartitionDOFBalance(int flag) {
+  partition_dof_balance = flag;
+}
+
+/*
+  Gather the measured per-element assembly times from an assembler
+  created by this object back into the global element ordering.
+
+  The creator guarantees that the owned elements of each partition are
+  numbered in ascending global order, so the times recorded by the
+  assembler (see TACSAssembler::setElementTimingFlag()) can be mapped
+  back to the global element numbers through the stored partition. The
+  result is significant on the root processor only and feeds
+  setPartitionElementWeights() on a new creator, which repartitions
+  the mesh to balance the measured cost instead of the element count.
+
+  This call is collective on the communicator.
+
+  input:
+  tacs:   the assembler created from this object
+  times:  array of length num_elements for the times (root only)
+*/
+void TACSCreator::gatherElementRuntimes(TACSAssembler *tacs, double *times) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  // Retrieve the times in the original local element ordering. Only
+  // the owned elements are sent - the halo element replicas appended
+  // after them are timed by their owners
+  int num_local = tacs->getNumElements();
+  double *local_times = new double[num_local > 0 ? num_local : 1];
+  tacs->getElementRuntimes(local_times);
+
+  int *recv_counts = NULL, *recv_ptr = NULL;
+  double *recv_times = NULL;
+  if (rank == root_rank) {
+    int size;
+    MPI_Comm_size(comm, &size);
+    recv_counts = owned_elements;
+    recv_ptr = new int[size + 1];
+    recv_ptr[0] = 0;
+    for (int k = 0; k < size; k++) {
+      recv_ptr[k + 1] = recv_ptr[k] + recv_counts[k];
+    }
+    recv_times = new double[num_elements];
+  }
+
+  MPI_Gatherv(local_times, num_owned_elements, MPI_DOUBLE, recv_times,
+              recv_counts, recv_ptr, MPI_DOUBLE, root_rank, comm);
+
+  if (rank == root_rank) {
+    // The j-th entry from processor p is the j-th global element
+    // owned by p in ascending order - scan the partition to undo
+    // the permutation
+    for (int e = 0; e < num_elements; e++) {
+      times[e] = recv_times[recv_ptr[partition[e]]];
+      recv_ptr[partition[e]]++;
+    }
+    delete[] recv_ptr;
+    delete[] recv_times;
+  }
+  delete[] local_times;
+}
+
+/*
+  Set per-element cost weights in the global element ordering.
+
+  These weights take precedence over the element-id weights set
+  through setPartitionWeights() when the mesh is partitioned. The
+  values are significant on the root processor only and are typically
+  the measured assembly times gathered from a previous run through
+  gatherElementRuntimes().
+
+  This call must be made before partitionMesh() to take effect.
+
+  input:
+  _num_elements:  the number of weights - must match the global mesh
+  _weights:       the per-element cost weights (root only)
+*/
+void TACSCreator::setPartitionElementWeights(int _num_elements,
+                                             const double *_weights) {
+  if (element_weights) {
+    delete[] element_weights;
+    element_weights = NULL;
+  }
+
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  if (rank == root_rank && _weights) {
+    if (_num_elements != num_elements) {
+      fprintf(stderr,
+              "TACSCreator: Number of element weights %d does not match "
+              "the number of elements %d\n",
+              _num_elements, num_elements);
+      return;
+    }
+    element_weights = new double[num_elements];
+    memcpy(element_weights, _weights, num_elements * sizeof(double));
+  }
+}
+
+/*
+  Replicate the boundary elements of each partition on its neighbors.
+
+  When this flag is set, createTACS() appends a copy of every element
+  that touches a locally owned node but belongs to another partition
+  after the owned elements on each processor, and declares the copies
+  to the assembler through setNumHaloElements(). The assembler then
+  computes its matrix and residual rows entirely locally and skips the
+  reverse add exchange that normally completes the assembly. The
+  redundant element evaluations cost a few percent of the assembly
+  work for typical partitions, while the removed synchronization is
+  the dominant cost at large processor counts.
+
+  This call must be made on all processors before createTACS().
+*/
+void TACSCreator::setBoundaryElementReplication(int flag) {
+  replicate_boundary = flag;
+}
+
 /*
   Get the new node numbers
 */
@@ -444,6 +719,81 @@ TACSAssembler *TACSCreator::createTACS() {
     partitionMesh(size);
   }
 
+  // When boundary element replication is enabled, determine the halo
+  // elements for each processor: the elements that belong to another
+  // partition but touch at least one node owned by this processor
+  int *halo_counts = NULL, *halo_ptr = NULL, *halo_elems = NULL;
+  if (rank == root_rank && replicate_boundary) {
+    // Find the owner of each node in the new numbering. The new node
+    // numbers are assigned in contiguous blocks of owned nodes.
+    int *node_owner = new int[num_nodes];
+    for (int k = 0, j = 0; k < size; k++) {
+      for (int i = 0; i < owned_nodes[k]; i++, j++) {
+        node_owner[j] = k;
+      }
+    }
+
+    // Count and then collect the halo elements for each processor.
+    // The marker array records the last element added for each rank
+    // so that an element is replicated at most once per processor.
+    halo_counts = new int[size];
+    halo_ptr = new int[size + 1];
+    int *marker = new int[size];
+
+    for (int pass = 0; pass < 2; pass++) {
+      memset(halo_counts, 0, size * sizeof(int));
+      for (int k = 0; k < size; k++) {
+        marker[k] = -1;
+      }
+
+      for (int elem = 0; elem < num_elements; elem++) {
+        int iend = elem_node_ptr[elem + 1];
+        for (int i = elem_node_ptr[elem]; i < iend; i++) {
+          int node = elem_node_conn[i];
+          if (node >= 0) {
+            int owner = node_owner[new_nodes[node]];
+            if (owner != partition[elem] && marker[owner] != elem) {
+              marker[owner] = elem;
+              if (pass == 1) {
+                halo_elems[halo_ptr[owner] + halo_counts[owner]] = elem;
+              }
+              halo_counts[owner]++;
+            }
+          } else {
+            // The element couples to the independent nodes of this
+            // dependent node, so it must be replicated on their
+            // owners as well
+            int dep = -node - 1;
+            for (int jp = dep_node_ptr[dep]; jp < dep_node_ptr[dep + 1];
+                 jp++) {
+              int owner = node_owner[new_nodes[dep_node_conn[jp]]];
+              if (owner != partition[elem] && marker[owner] != elem) {
+                marker[owner] = elem;
+                if (pass == 1) {
+                  halo_elems[halo_ptr[owner] + halo_counts[owner]] = elem;
+                }
+                halo_counts[owner]++;
+              }
+            }
+          }
+        }
+      }
+
+      // Set the offsets and allocate the element lists for the
+      // second pass
+      if (pass == 0) {
+        halo_ptr[0] = 0;
+        for (int k = 0; k < size; k++) {
+          halo_ptr[k + 1] = halo_ptr[k] + halo_counts[k];
+        }
+        halo_elems = new int[halo_ptr[size]];
+      }
+    }
+
+    delete[] node_owner;
+    delete[] marker;
+  }
+
   // The number of local and owned nodes and the number of
   // elements for each processor in the mesh
   num_owned_nodes = 0;
@@ -453,17 +803,26 @@ TACSAssembler *TACSCreator::createTACS() {
   MPI_Scatter(owned_elements, 1, MPI_INT, &num_owned_elements, 1, MPI_INT,
               root_rank, comm);
 
+  // The number of halo element replicas appended after the owned
+  // elements on this processor
+  num_halo_elements = 0;
+  if (replicate_boundary) {
+    MPI_Scatter(halo_counts, 1, MPI_INT, &num_halo_elements, 1, MPI_INT,
+                root_rank, comm);
+  }
+  int num_local_elements = num_owned_elements + num_halo_elements;
+
   // The number of local nodes
   int num_local_dep_nodes = 0;
 
   // Allocate space for the portion of the element connectivity on
-  // this processor
-  int *local_elem_node_ptr = new int[num_owned_elements + 1];
+  // this processor, including any halo element replicas
+  int *local_elem_node_ptr = new int[num_local_elements + 1];
   int *local_elem_node_conn = NULL;
 
   // This will be used later to determine which elements belong to
   // which domain within the finite-element mesh
-  local_elem_id_nums = new int[num_owned_elements];
+  local_elem_id_nums = new int[num_local_elements];
 
   // Loacal nodal information
   TacsScalar *Xpts_local = NULL;
@@ -560,11 +919,18 @@ TACSAssembler *TACSCreator::createTACS() {
       elem_ptr[0] = 0;
 
       // Cycle through the element partition k, and assign
-      // the connectivity for the new
+      // the connectivity for the new ordering. The halo element
+      // replicas, if any, are appended after the owned elements.
+      int num_halo = (replicate_boundary ? halo_ptr[k + 1] - halo_ptr[k] : 0);
       int n = 0;
       int local_conn_size = 0;
-      for (int j = start; j < end; j++, n++) {
-        int elem = elem_part[j];
+      for (int j = start; j < end + num_halo; j++, n++) {
+        int elem;
+        if (j < end) {
+          elem = elem_part[j];
+        } else {
+          elem = halo_elems[halo_ptr[k] + (j - end)];
+        }
 
         // Add the connectivity from the element 'elem'
         // that belongs to partition k
@@ -655,13 +1021,13 @@ TACSAssembler *TACSCreator::createTACS() {
                  conn_len * sizeof(double));
         }
 
-        // Copy over values for the elements
-        memcpy(local_elem_id_nums, elem_ids, num_owned_elements * sizeof(int));
-        memcpy(local_elem_node_ptr, elem_ptr,
-               (num_owned_elements + 1) * sizeof(int));
-        local_elem_node_conn = new int[local_elem_node_ptr[num_owned_elements]];
+        // Copy over values for the elements, including the halo
+        // element replicas appended after the owned elements
+        memcpy(local_elem_id_nums, elem_ids, n * sizeof(int));
+        memcpy(local_elem_node_ptr, elem_ptr, (n + 1) * sizeof(int));
+        local_elem_node_conn = new int[local_elem_node_ptr[n]];
         memcpy(local_elem_node_conn, elem_conn,
-               local_elem_node_ptr[num_owned_elements] * sizeof(int));
+               local_elem_node_ptr[n] * sizeof(int));
       } else {
         // Send the data to the other process
         MPI_Send(&local_dep_node_size, 1, MPI_INT, k, 2, comm);
@@ -675,10 +1041,10 @@ TACSAssembler *TACSCreator::createTACS() {
                    comm);
         }
 
-        // Send the element data
-        MPI_Send(elem_ids, owned_elements[k], MPI_INT, k, 8, comm);
-        MPI_Send(elem_ptr, owned_elements[k] + 1, MPI_INT, k, 9, comm);
-        MPI_Send(elem_conn, elem_ptr[owned_elements[k]], MPI_INT, k, 10, comm);
+        // Send the element data, including the halo element replicas
+        MPI_Send(elem_ids, n, MPI_INT, k, 8, comm);
+        MPI_Send(elem_ptr, n + 1, MPI_INT, k, 9, comm);
+        MPI_Send(elem_conn, elem_ptr[n], MPI_INT, k, 10, comm);
       }
 
       // Increment the pointers to the start of the new nodes
@@ -688,6 +1054,11 @@ TACSAssembler *TACSCreator::createTACS() {
 
     delete[] inv_new_nodes;
     delete[] elem_part;
+    if (halo_counts) {
+      delete[] halo_counts;
+      delete[] halo_ptr;
+      delete[] halo_elems;
+    }
     delete[] dep_nodes;
     delete[] dep_node_flags;
     delete[] inv_dep_nodes;
@@ -735,12 +1106,12 @@ TACSAssembler *TACSCreator::createTACS() {
     }
 
     // Receive the element data
-    MPI_Recv(local_elem_id_nums, num_owned_elements, MPI_INT, root_rank, 8,
+    MPI_Recv(local_elem_id_nums, num_local_elements, MPI_INT, root_rank, 8,
              comm, &status);
-    MPI_Recv(local_elem_node_ptr, num_owned_elements + 1, MPI_INT, root_rank, 9,
+    MPI_Recv(local_elem_node_ptr, num_local_elements + 1, MPI_INT, root_rank, 9,
              comm, &status);
 
-    int con_size = local_elem_node_ptr[num_owned_elements];
+    int con_size = local_elem_node_ptr[num_local_elements];
     local_elem_node_conn = new int[con_size];
     MPI_Recv(local_elem_node_conn, con_size, MPI_INT, root_rank, 10, comm,
              &status);
@@ -750,44 +1121,72 @@ TACSAssembler *TACSCreator::createTACS() {
   MPI_Bcast(&num_bcs, 1, MPI_INT, root_rank, comm);
 
   if (num_bcs > 0) {
-    // Broadcast all the boundary conditions to all processors
-    if (rank != root_rank) {
+    // The boundary condition table is read-only after this point and
+    // is identical on every rank. Rather than duplicating it on every
+    // rank, pack the arrays into a single segment and store one copy
+    // per node in a shared-memory window.
+    int con_size = 0;
+    if (rank == root_rank) {
+      con_size = bc_ptr[num_bcs];
+    }
+    MPI_Bcast(&con_size, 1, MPI_INT, root_rank, comm);
+
+    // Compute the offsets of the arrays within the packed segment.
+    // The scalar values are aligned to a TacsScalar boundary.
+    size_t nodes_offset = 0;
+    size_t ptr_offset = num_bcs * sizeof(int);
+    size_t vars_offset = ptr_offset + (num_bcs + 1) * sizeof(int);
+    size_t vals_offset = vars_offset + con_size * sizeof(int);
+    vals_offset = sizeof(TacsScalar) *
+                  ((vals_offset + sizeof(TacsScalar) - 1) / sizeof(TacsScalar));
+    size_t total_size = vals_offset + con_size * sizeof(TacsScalar);
+
+    // Pack the boundary condition data on the root rank
+    char *pack = NULL;
+    if (rank == root_rank) {
+      pack = new char[total_size];
+      memcpy(&pack[nodes_offset], bc_nodes, num_bcs * sizeof(int));
+      memcpy(&pack[ptr_offset], bc_ptr, (num_bcs + 1) * sizeof(int));
+      memcpy(&pack[vars_offset], bc_vars, con_size * sizeof(int));
+      memcpy(&pack[vals_offset], bc_vals, con_size * sizeof(TacsScalar));
+    }
+
+    // Release the previous boundary condition storage
+    if (bc_packed) {
+      TacsFreeSharedMemory(bc_nodes, &bc_win);
+    } else {
       if (bc_nodes) {
         delete[] bc_nodes;
       }
-      bc_nodes = new int[num_bcs];
-    }
-    MPI_Bcast(bc_nodes, num_bcs, MPI_INT, root_rank, comm);
-
-    // Broacast the boundary condition pointer array
-    if (rank != root_rank) {
       if (bc_ptr) {
         delete[] bc_ptr;
       }
-      bc_ptr = new int[num_bcs + 1];
-    }
-    MPI_Bcast(bc_ptr, num_bcs + 1, MPI_INT, root_rank, comm);
-
-    if (rank != root_rank) {
       if (bc_vars) {
         delete[] bc_vars;
       }
-      bc_vars = new int[bc_ptr[num_bcs]];
-    }
-    MPI_Bcast(bc_vars, bc_ptr[num_bcs], MPI_INT, root_rank, comm);
-
-    if (rank != root_rank) {
       if (bc_vals) {
         delete[] bc_vals;
       }
-      bc_vals = new TacsScalar[bc_ptr[num_bcs]];
     }
-    MPI_Bcast(bc_vals, bc_ptr[num_bcs], TACS_MPI_TYPE, root_rank, comm);
+
+    // Allocate the node-shared copy of the data and re-point the
+    // boundary condition arrays into the packed segment
+    char *shared = (char *)TacsAllocateSharedMemory(comm, root_rank, pack,
+                                                    total_size, &bc_win);
+    if (pack) {
+      delete[] pack;
+    }
+
+    bc_nodes = (int *)&shared[nodes_offset];
+    bc_ptr = (int *)&shared[ptr_offset];
+    bc_vars = (int *)&shared[vars_offset];
+    bc_vals = (TacsScalar *)&shared[vals_offset];
+    bc_packed = 1;
   }
 
   TACSAssembler *tacs =
       new TACSAssembler(comm, vars_per_node, num_owned_nodes,
-                        num_owned_elements, num_local_dep_nodes);
+                        num_local_elements, num_local_dep_nodes);
 
   // Set the dependent node data
   if (num_local_dep_nodes > 0) {
@@ -800,8 +1199,8 @@ TACSAssembler *TACSCreator::createTACS() {
 
   // Add the elements
   if (elements) {
-    TACSElement **elems = new TACSElement *[num_owned_elements];
-    for (int k = 0; k < num_owned_elements; k++) {
+    TACSElement **elems = new TACSElement *[num_local_elements];
+    for (int k = 0; k < num_local_elements; k++) {
       elems[k] = elements[local_elem_id_nums[k]];
       if (!elems[k]) {
         fprintf(stderr,
@@ -816,8 +1215,8 @@ TACSAssembler *TACSCreator::createTACS() {
     tacs->setElements(elems);
     delete[] elems;
   } else if (element_creator) {
-    TACSElement **elems = new TACSElement *[num_owned_elements];
-    for (int k = 0; k < num_owned_elements; k++) {
+    TACSElement **elems = new TACSElement *[num_local_elements];
+    for (int k = 0; k < num_local_elements; k++) {
       elems[k] = element_creator(k, local_elem_id_nums[k]);
       if (!elems[k]) {
         fprintf(stderr, "[%d] TACSCreator: Callback failed for element ID %d\n",
@@ -837,6 +1236,12 @@ TACSAssembler *TACSCreator::createTACS() {
     return NULL;
   }
 
+  // Declare the trailing halo replicas so that the assembler runs in
+  // redundant-compute mode
+  if (num_halo_elements > 0) {
+    tacs->setNumHaloElements(num_halo_elements);
+  }
+
   // Allocate the arrays to store the variable values
   int *bvars = new int[vars_per_node];
   TacsScalar *bvals = new TacsScalar[vars_per_node];
@@ -863,15 +1268,28 @@ TACSAssembler *TACSCreator::createTACS() {
   delete[] bvars;
   delete[] bvals;
 
-  // We no longer need the boundary condition information
-  delete[] bc_nodes;
-  bc_nodes = NULL;
-  delete[] bc_ptr;
-  bc_ptr = NULL;
-  delete[] bc_vars;
-  bc_vars = NULL;
-  delete[] bc_vals;
-  bc_vals = NULL;
+  // The packed boundary condition data is retained for the life of
+  // the creator so that the mesh can be rebuilt by reconfigure().
+  // The arrays point into the shared-memory window and are released
+  // in the destructor.
+  if (!bc_packed) {
+    if (bc_nodes) {
+      delete[] bc_nodes;
+      bc_nodes = NULL;
+    }
+    if (bc_ptr) {
+      delete[] bc_ptr;
+      bc_ptr = NULL;
+    }
+    if (bc_vars) {
+      delete[] bc_vars;
+      bc_vars = NULL;
+    }
+    if (bc_vals) {
+      delete[] bc_vals;
+      bc_vals = NULL;
+    }
+  }
 
   // Use the reordering if the flag has been set in the
   // TACSCreator object
@@ -908,6 +1326,298 @@ TACSAssembler *TACSCreator::createTACS() {
   return tacs;
 }
 
+/*
+  Rebuild the assembler for a resized processor allocation and
+  transfer the solution state to the new layout.
+
+  The partition, node map and distribution plans inside TACSAssembler
+  are fixed once initialize() has been called, so a resize cannot
+  migrate ownership in place. Instead, this function re-runs the
+  standard creation path: the state vectors are gathered to the root
+  processor in the original node ordering, the old partition is
+  discarded, the mesh is re-partitioned for the size of the new
+  communicator, and a fresh assembler is built through createTACS()
+  on the new communicator. The boundary conditions and node locations
+  are re-applied from the data retained on the root processor, so no
+  restart files are written or read during the resize.
+
+  The call is collective over the communicator that the creator was
+  created with: every processor of that communicator must call this
+  function, including processors that are not part of the new
+  allocation. Processors that do not hold the old assembler pass NULL
+  for the assembler argument, and processors that are not part of the
+  new allocation pass MPI_COMM_NULL for the new communicator and
+  receive NULL in return. The root processor must be a member of the
+  new communicator and must hold the old assembler whenever state
+  vectors are transferred.
+
+  The state vectors must have been created through createVec() on the
+  old assembler. The corresponding output vectors are created on the
+  new assembler with the owned values copied into place; external and
+  dependent values are recomputed by the first distributeValues()
+  call as usual.
+
+  input:
+  new_comm:   the communicator for the new allocation
+  assembler:  the old assembler, or NULL if not held on this process
+  num_vecs:   the number of state vectors to transfer
+  vecs:       the state vectors on the old assembler
+  new_vecs:   the transferred vectors on the new assembler
+
+  returns: the new assembler, or NULL outside the new communicator
+*/
+TACSAssembler *TACSCreator::reconfigure(MPI_Comm new_comm,
+                                        TACSAssembler *assembler,
+                                        int num_vecs, TACSBVec **vecs,
+                                        TACSBVec **new_vecs) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  // Gather the state vectors to the root processor in the original
+  // node ordering. The owned values on each old processor form a
+  // contiguous block of the creator ordering, up to the internal
+  // reordering of the assembler which is undone locally first.
+  TacsScalar **state = NULL;
+  if (assembler && num_vecs > 0) {
+    MPI_Comm old_comm = assembler->getMPIComm();
+    int old_rank, old_size;
+    MPI_Comm_rank(old_comm, &old_rank);
+    MPI_Comm_size(old_comm, &old_size);
+
+    // Find the rank of the root processor within the old communicator
+    MPI_Group group, old_group;
+    MPI_Comm_group(comm, &group);
+    MPI_Comm_group(old_comm, &old_group);
+    int old_root;
+    MPI_Group_translate_ranks(group, 1, &root_rank, old_group, &old_root);
+    MPI_Group_free(&group);
+    MPI_Group_free(&old_group);
+
+    // Get the ownership range and the local reordering
+    TACSNodeMap *nodeMap = assembler->getNodeMap();
+    const int *range;
+    nodeMap->getOwnerRange(&range);
+    int n_owned = range[old_rank + 1] - range[old_rank];
+
+    int *node_order = new int[n_owned];
+    assembler->getReordering(node_order);
+
+    // Set the counts/displacements in the creator ordering
+    int *counts = NULL, *displs = NULL;
+    if (rank == root_rank) {
+      counts = new int[old_size];
+      displs = new int[old_size];
+      for (int k = 0; k < old_size; k++) {
+        counts[k] = vars_per_node * (range[k + 1] - range[k]);
+        displs[k] = vars_per_node * range[k];
+      }
+      state = new TacsScalar *[num_vecs];
+    }
+
+    TacsScalar *local = new TacsScalar[vars_per_node * n_owned];
+    TacsScalar *global = NULL;
+    if (rank == root_rank) {
+      global = new TacsScalar[vars_per_node * num_nodes];
+    }
+
+    for (int i = 0; i < num_vecs; i++) {
+      // Undo the internal reordering so that the local values are in
+      // the contiguous creator ordering
+      TacsScalar *array;
+      vecs[i]->getArray(&array);
+      for (int k = 0; k < n_owned; k++) {
+        int index = node_order[k] - range[old_rank];
+        memcpy(&local[vars_per_node * k], &array[vars_per_node * index],
+               vars_per_node * sizeof(TacsScalar));
+      }
+
+      MPI_Gatherv(local, vars_per_node * n_owned, TACS_MPI_TYPE, global,
+                  counts, displs, TACS_MPI_TYPE, old_root, old_comm);
+
+      // Convert from the creator ordering to the original ordering
+      if (rank == root_rank) {
+        state[i] = new TacsScalar[vars_per_node * num_nodes];
+        for (int j = 0; j < num_nodes; j++) {
+          memcpy(&state[i][vars_per_node * j],
+                 &global[vars_per_node * new_nodes[j]],
+                 vars_per_node * sizeof(TacsScalar));
+        }
+      }
+    }
+
+    delete[] node_order;
+    delete[] local;
+    if (rank == root_rank) {
+      delete[] counts;
+      delete[] displs;
+      delete[] global;
+    }
+  }
+
+  // Restore the boundary conditions in the original node ordering and
+  // release the packed shared-memory copies. Every processor that took
+  // part in the previous createTACS() call holds the window, and all
+  // of them call this function, so the free is collective.
+  if (num_bcs > 0 && bc_packed) {
+    int *bcn = NULL, *bcp = NULL, *bcv = NULL;
+    TacsScalar *bcvals = NULL;
+    if (rank == root_rank) {
+      // Invert the node ordering from the previous partition
+      int *inv_new_nodes = new int[num_nodes];
+      for (int i = 0; i < num_nodes; i++) {
+        inv_new_nodes[new_nodes[i]] = i;
+      }
+
+      int con_size = bc_ptr[num_bcs];
+      bcn = new int[num_bcs];
+      bcp = new int[num_bcs + 1];
+      bcv = new int[con_size];
+      bcvals = new TacsScalar[con_size];
+      for (int j = 0; j < num_bcs; j++) {
+        bcn[j] = inv_new_nodes[bc_nodes[j]];
+      }
+      memcpy(bcp, bc_ptr, (num_bcs + 1) * sizeof(int));
+      memcpy(bcv, bc_vars, con_size * sizeof(int));
+      memcpy(bcvals, bc_vals, con_size * sizeof(TacsScalar));
+      delete[] inv_new_nodes;
+    }
+
+    TacsFreeSharedMemory(bc_nodes, &bc_win);
+    bc_packed = 0;
+    bc_nodes = bcn;
+    bc_ptr = bcp;
+    bc_vars = bcv;
+    bc_vals = bcvals;
+  }
+
+  // Discard the old partition so that createTACS() re-partitions the
+  // mesh for the size of the new communicator
+  if (rank == root_rank) {
+    if (partition) {
+      delete[] partition;
+      partition = NULL;
+    }
+    if (new_nodes) {
+      delete[] new_nodes;
+      new_nodes = NULL;
+    }
+    if (owned_elements) {
+      delete[] owned_elements;
+      owned_elements = NULL;
+    }
+    if (owned_nodes) {
+      delete[] owned_nodes;
+      owned_nodes = NULL;
+    }
+  }
+  if (local_elem_id_nums) {
+    delete[] local_elem_id_nums;
+    local_elem_id_nums = NULL;
+  }
+
+  // Rebuild the assembler on the new communicator
+  TACSAssembler *new_assembler = NULL;
+  if (new_comm != MPI_COMM_NULL) {
+    // Find the rank of the root processor within the new communicator
+    MPI_Group group, new_group;
+    MPI_Comm_group(comm, &group);
+    MPI_Comm_group(new_comm, &new_group);
+    int new_root;
+    MPI_Group_translate_ranks(group, 1, &root_rank, new_group, &new_root);
+    MPI_Group_free(&group);
+    MPI_Group_free(&new_group);
+
+    if (new_root == MPI_UNDEFINED) {
+      fprintf(stderr,
+              "[%d] TACSCreator: The root processor must be a member of "
+              "the new communicator\n",
+              rank);
+      return NULL;
+    }
+
+    // Run the standard creation path on the new communicator
+    MPI_Comm creator_comm = comm;
+    int creator_root = root_rank;
+    comm = new_comm;
+    root_rank = new_root;
+    new_assembler = createTACS();
+    comm = creator_comm;
+    root_rank = creator_root;
+
+    // Scatter the state into vectors on the new assembler
+    if (num_vecs > 0 && new_vecs) {
+      int new_rank, new_size;
+      MPI_Comm_rank(new_comm, &new_rank);
+      MPI_Comm_size(new_comm, &new_size);
+
+      TACSNodeMap *nodeMap = new_assembler->getNodeMap();
+      const int *range;
+      nodeMap->getOwnerRange(&range);
+      int n_owned = range[new_rank + 1] - range[new_rank];
+
+      int *node_order = new int[n_owned];
+      new_assembler->getReordering(node_order);
+
+      int *counts = NULL, *displs = NULL;
+      TacsScalar *global = NULL;
+      if (new_rank == new_root) {
+        counts = new int[new_size];
+        displs = new int[new_size];
+        for (int k = 0; k < new_size; k++) {
+          counts[k] = vars_per_node * (range[k + 1] - range[k]);
+          displs[k] = vars_per_node * range[k];
+        }
+        global = new TacsScalar[vars_per_node * num_nodes];
+      }
+
+      TacsScalar *local = new TacsScalar[vars_per_node * n_owned];
+      for (int i = 0; i < num_vecs; i++) {
+        // Convert from the original ordering to the new creator
+        // ordering on the root processor
+        if (new_rank == new_root) {
+          for (int j = 0; j < num_nodes; j++) {
+            memcpy(&global[vars_per_node * new_nodes[j]],
+                   &state[i][vars_per_node * j],
+                   vars_per_node * sizeof(TacsScalar));
+          }
+        }
+
+        MPI_Scatterv(global, counts, displs, TACS_MPI_TYPE, local,
+                     vars_per_node * n_owned, TACS_MPI_TYPE, new_root,
+                     new_comm);
+
+        // Apply the internal reordering of the new assembler
+        new_vecs[i] = new_assembler->createVec();
+        TacsScalar *array;
+        new_vecs[i]->getArray(&array);
+        for (int k = 0; k < n_owned; k++) {
+          int index = node_order[k] - range[new_rank];
+          memcpy(&array[vars_per_node * index], &local[vars_per_node * k],
+                 vars_per_node * sizeof(TacsScalar));
+        }
+      }
+
+      delete[] node_order;
+      delete[] local;
+      if (new_rank == new_root) {
+        delete[] counts;
+        delete[] displs;
+        delete[] global;
+      }
+    }
+  }
+
+  // Free the gathered state on the root processor
+  if (state) {
+    for (int i = 0; i < num_vecs; i++) {
+      delete[] state[i];
+    }
+    delete[] state;
+  }
+
+  return new_assembler;
+}
+
 /*
   Partition the mesh stored on the root processor for parallel
   computations.
@@ -1104,6 +1814,89 @@ void TACSCreator::partitionMesh(int split_size, const int *part) {
     if (split_size > 1) {
       int ncon = 1;  // "It should be at least 1"??
 
+      // Set the vertex weights from the element cost weights, if they
+      // have been specified. The node count is added as a second
+      // balance constraint if the DOF balance flag is set.
+      int *vwgt = NULL;
+      if (element_weights) {
+        // Per-element measured cost weights take precedence over the
+        // element-id weights
+        if (partition_dof_balance) {
+          ncon = 2;
+        }
+
+        // Scale the weights so that the smallest positive weight
+        // maps to an integer weight of one
+        double wmin = 0.0;
+        for (int i = 0; i < num_elements; i++) {
+          double w = element_weights[i];
+          if (w > 0.0 && (wmin == 0.0 || w < wmin)) {
+            wmin = w;
+          }
+        }
+        if (wmin <= 0.0) {
+          wmin = 1.0;
+        }
+
+        vwgt = new int[ncon * num_elements];
+        for (int i = 0; i < num_elements; i++) {
+          int iw = (int)(element_weights[i] / wmin + 0.5);
+          vwgt[ncon * i] = (iw >= 1 ? iw : 1);
+
+          if (ncon == 2) {
+            int nn = elem_node_ptr[i + 1] - elem_node_ptr[i];
+            vwgt[ncon * i + 1] = (nn >= 1 ? nn : 1);
+          }
+        }
+      } else if (partition_weights) {
+        // Check that every element id has an associated weight
+        int legit = 1;
+        for (int i = 0; i < num_elements; i++) {
+          if (elem_id_nums[i] < 0 ||
+              elem_id_nums[i] >= num_partition_weights) {
+            legit = 0;
+            break;
+          }
+        }
+
+        if (legit) {
+          if (partition_dof_balance) {
+            ncon = 2;
+          }
+
+          // Scale the weights so that the smallest positive weight
+          // maps to an integer weight of one
+          double wmin = 0.0;
+          for (int i = 0; i < num_elements; i++) {
+            double w = partition_weights[elem_id_nums[i]];
+            if (w > 0.0 && (wmin == 0.0 || w < wmin)) {
+              wmin = w;
+            }
+          }
+          if (wmin <= 0.0) {
+            wmin = 1.0;
+          }
+
+          vwgt = new int[ncon * num_elements];
+          for (int i = 0; i < num_elements; i++) {
+            double w = partition_weights[elem_id_nums[i]];
+            int iw = (int)(w / wmin + 0.5);
+            vwgt[ncon * i] = (iw >= 1 ? iw : 1);
+
+            if (ncon == 2) {
+              // Count the independent nodes of the element as a proxy
+              // for its contribution to the DOF count
+              int nn = elem_node_ptr[i + 1] - elem_node_ptr[i];
+              vwgt[ncon * i + 1] = (nn >= 1 ? nn : 1);
+            }
+          }
+        } else {
+          fprintf(stderr,
+                  "TACSCreator: Element id exceeds the number of partition "
+                  "weights. Using uniform weights\n");
+        }
+      }
+
       // Set the default options
       int options[METIS_NOPTIONS];
       METIS_SetDefaultOptions(options);
@@ -1114,15 +1907,19 @@ void TACSCreator::partitionMesh(int split_size, const int *part) {
       // The objective value in METIS
       int objval = 0;
 
-      if (split_size < 8) {
+      if (split_size < 8 && ncon == 1) {
         METIS_PartGraphRecursive(&num_elements, &ncon, elem_ptr, elem_conn,
-                                 NULL, NULL, NULL, &split_size, NULL, NULL,
+                                 vwgt, NULL, NULL, &split_size, NULL, NULL,
                                  options, &objval, partition);
       } else {
-        METIS_PartGraphKway(&num_elements, &ncon, elem_ptr, elem_conn, NULL,
+        METIS_PartGraphKway(&num_elements, &ncon, elem_ptr, elem_conn, vwgt,
                             NULL, NULL, &split_size, NULL, NULL, options,
                             &objval, partition);
       }
+
+      if (vwgt) {
+        delete[] vwgt;
+      }
     } else {
       // If there is no split, just assign all elements to the
       // root processor
@@ -1208,6 +2005,368 @@ void TACSCreator::partitionMesh(int split_size, const int *part) {
   delete[] split_offset;
 }
 
+/*
+  Partition the mesh collectively using recursive coordinate
+  bisection on the element centroids.
+
+  The serial METIS path in partitionMesh() builds the full dual graph
+  on the root processor, which becomes a memory and startup-time
+  bottleneck at large scale. This path avoids the graph entirely: the
+  root scatters only the element centroids (24 bytes per element) and
+  all processors cooperate in the bisection. At each level, every
+  active partition range is split along the longest axis of its
+  bounding box at a plane located by bisection on the coordinate so
+  that the element counts balance. The resulting partition is gathered
+  to the root and fed into the existing partitionMesh() flow.
+
+  The edge-cut quality of coordinate bisection is somewhat worse than
+  the METIS k-way partition, but the partition cost is a few dozen
+  small all-reduce operations per level rather than a serial graph
+  partition of the whole model.
+
+  This call is collective on the TACSCreator communicator.
+
+  input:
+  split_size:  the number of segments in the partition
+*/
+void TACSCreator::partitionMeshRCB(int split_size) {
+  int rank, mpi_size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &mpi_size);
+
+  // Set the split size to ensure that it is less than the comm size
+  if (split_size <= 0 || split_size > mpi_size) {
+    split_size = mpi_size;
+  }
+
+  // Broadcast the number of elements from the root
+  int nelems = num_elements;
+  MPI_Bcast(&nelems, 1, MPI_INT, root_rank, comm);
+  if (nelems <= 0) {
+    return;
+  }
+
+  // Compute the element centroids on the root processor
+  double *cent = NULL;
+  if (rank == root_rank) {
+    cent = new double[3 * nelems];
+    for (int i = 0; i < nelems; i++) {
+      double c[3] = {0.0, 0.0, 0.0};
+      int nn = 0;
+      for (int jp = elem_node_ptr[i]; jp < elem_node_ptr[i + 1]; jp++) {
+        int node = elem_node_conn[jp];
+        if (node >= 0) {
+          c[0] += TacsRealPart(Xpts[3 * node]);
+          c[1] += TacsRealPart(Xpts[3 * node + 1]);
+          c[2] += TacsRealPart(Xpts[3 * node + 2]);
+          nn++;
+        }
+      }
+      if (nn > 0) {
+        c[0] = c[0] / nn;
+        c[1] = c[1] / nn;
+        c[2] = c[2] / nn;
+      }
+      cent[3 * i] = c[0];
+      cent[3 * i + 1] = c[1];
+      cent[3 * i + 2] = c[2];
+    }
+  }
+
+  // Scatter contiguous chunks of the centroids to all processors
+  int *counts = new int[mpi_size];
+  int *displs = new int[mpi_size];
+  for (int k = 0; k < mpi_size; k++) {
+    counts[k] = 3 * ((nelems / mpi_size) + (k < nelems % mpi_size ? 1 : 0));
+  }
+  displs[0] = 0;
+  for (int k = 1; k < mpi_size; k++) {
+    displs[k] = displs[k - 1] + counts[k - 1];
+  }
+
+  int nlocal = counts[rank] / 3;
+  double *xc = new double[3 * nlocal];
+  MPI_Scatterv(cent, counts, displs, MPI_DOUBLE, xc, 3 * nlocal, MPI_DOUBLE,
+               root_rank, comm);
+  if (cent) {
+    delete[] cent;
+  }
+
+  // The partition range [lo, hi) that each local element currently
+  // belongs to, and the index of its range in the active range list
+  int *lo = new int[nlocal];
+  int *hi = new int[nlocal];
+  int *ridx = new int[nlocal];
+  for (int i = 0; i < nlocal; i++) {
+    lo[i] = 0;
+    hi[i] = split_size;
+    ridx[i] = 0;
+  }
+
+  // The list of active ranges - identical on every processor
+  int nranges = 1;
+  int *range_lo = new int[split_size];
+  int *range_hi = new int[split_size];
+  range_lo[0] = 0;
+  range_hi[0] = split_size;
+
+  // Work space for the per-range reductions
+  double *local_red = new double[6 * split_size];
+  double *global_red = new double[6 * split_size];
+
+  // Split the ranges until each contains a single part
+  int done = 0;
+  while (!done) {
+    done = 1;
+    for (int r = 0; r < nranges; r++) {
+      if (range_hi[r] - range_lo[r] > 1) {
+        done = 0;
+      }
+    }
+    if (done) {
+      break;
+    }
+
+    // Compute the bounding box of each active range. The coordinates
+    // are negated for the max reduction so that a single MPI_MIN
+    // reduction handles both bounds
+    for (int r = 0; r < nranges; r++) {
+      for (int d = 0; d < 3; d++) {
+        local_red[6 * r + d] = 1e300;
+        local_red[6 * r + 3 + d] = 1e300;
+      }
+    }
+    for (int i = 0; i < nlocal; i++) {
+      int r = ridx[i];
+      for (int d = 0; d < 3; d++) {
+        if (xc[3 * i + d] < local_red[6 * r + d]) {
+          local_red[6 * r + d] = xc[3 * i + d];
+        }
+        if (-xc[3 * i + d] < local_red[6 * r + 3 + d]) {
+          local_red[6 * r + 3 + d] = -xc[3 * i + d];
+        }
+      }
+    }
+    MPI_Allreduce(local_red, global_red, 6 * nranges, MPI_DOUBLE, MPI_MIN,
+                  comm);
+
+    // Select the split axis, target fraction and initial bounds for
+    // each range
+    int *axis = new int[nranges];
+    double *tlo = new double[nranges];
+    double *thi = new double[nranges];
+    double *frac = new double[nranges];
+    for (int r = 0; r < nranges; r++) {
+      axis[r] = 0;
+      double len = -1.0;
+      for (int d = 0; d < 3; d++) {
+        double ext = -global_red[6 * r + 3 + d] - global_red[6 * r + d];
+        if (ext > len) {
+          len = ext;
+          axis[r] = d;
+        }
+      }
+      tlo[r] = global_red[6 * r + axis[r]];
+      thi[r] = -global_red[6 * r + 3 + axis[r]];
+
+      // The left child takes the larger half of an odd range
+      int width = range_hi[r] - range_lo[r];
+      frac[r] = (double)((width + 1) / 2) / width;
+    }
+
+    // Count the total number of elements in each range once
+    double *total = new double[nranges];
+    for (int r = 0; r < nranges; r++) {
+      local_red[r] = 0.0;
+    }
+    for (int i = 0; i < nlocal; i++) {
+      local_red[ridx[i]] += 1.0;
+    }
+    MPI_Allreduce(local_red, total, nranges, MPI_DOUBLE, MPI_SUM, comm);
+
+    // Locate the splitting plane of each range by bisection on the
+    // coordinate value
+    for (int iter = 0; iter < 50; iter++) {
+      for (int r = 0; r < nranges; r++) {
+        local_red[r] = 0.0;
+      }
+      for (int i = 0; i < nlocal; i++) {
+        int r = ridx[i];
+        double mid = 0.5 * (tlo[r] + thi[r]);
+        if (xc[3 * i + axis[r]] <= mid) {
+          local_red[r] += 1.0;
+        }
+      }
+      MPI_Allreduce(local_red, global_red, nranges, MPI_DOUBLE, MPI_SUM,
+                    comm);
+
+      for (int r = 0; r < nranges; r++) {
+        double mid = 0.5 * (tlo[r] + thi[r]);
+        if (global_red[r] > frac[r] * total[r]) {
+          thi[r] = mid;
+        } else {
+          tlo[r] = mid;
+        }
+      }
+    }
+
+    // Build the list of child ranges - processed identically on all
+    // processors so that the lists stay consistent
+    int new_nranges = 0;
+    int *new_range_lo = new int[split_size];
+    int *new_range_hi = new int[split_size];
+    int *left_child = new int[nranges];
+    int *right_child = new int[nranges];
+    for (int r = 0; r < nranges; r++) {
+      int width = range_hi[r] - range_lo[r];
+      if (width > 1) {
+        int mid = range_lo[r] + (width + 1) / 2;
+        left_child[r] = new_nranges;
+        new_range_lo[new_nranges] = range_lo[r];
+        new_range_hi[new_nranges] = mid;
+        new_nranges++;
+        right_child[r] = new_nranges;
+        new_range_lo[new_nranges] = mid;
+        new_range_hi[new_nranges] = range_hi[r];
+        new_nranges++;
+      } else {
+        left_child[r] = right_child[r] = new_nranges;
+        new_range_lo[new_nranges] = range_lo[r];
+        new_range_hi[new_nranges] = range_hi[r];
+        new_nranges++;
+      }
+    }
+
+    // Assign the local elements to the child ranges
+    for (int i = 0; i < nlocal; i++) {
+      int r = ridx[i];
+      int width = range_hi[r] - range_lo[r];
+      if (width > 1) {
+        double t = 0.5 * (tlo[r] + thi[r]);
+        if (xc[3 * i + axis[r]] <= t) {
+          ridx[i] = left_child[r];
+        } else {
+          ridx[i] = right_child[r];
+        }
+        lo[i] = new_range_lo[ridx[i]];
+        hi[i] = new_range_hi[ridx[i]];
+      } else {
+        ridx[i] = left_child[r];
+      }
+    }
+
+    // Swap in the new range list
+    memcpy(range_lo, new_range_lo, new_nranges * sizeof(int));
+    memcpy(range_hi, new_range_hi, new_nranges * sizeof(int));
+    nranges = new_nranges;
+
+    delete[] new_range_lo;
+    delete[] new_range_hi;
+    delete[] left_child;
+    delete[] right_child;
+    delete[] axis;
+    delete[] tlo;
+    delete[] thi;
+    delete[] frac;
+    delete[] total;
+  }
+
+  // Gather the partition to the root processor in the original
+  // element order
+  int *part = NULL;
+  if (rank == root_rank) {
+    part = new int[nelems];
+  }
+  for (int k = 0; k < mpi_size; k++) {
+    counts[k] = counts[k] / 3;
+    displs[k] = displs[k] / 3;
+  }
+  MPI_Gatherv(lo, nlocal, MPI_INT, part, counts, displs, MPI_INT, root_rank,
+              comm);
+
+  // Feed the gathered partition into the standard flow
+  if (rank == root_rank) {
+    partitionMesh(split_size, part);
+    delete[] part;
+  }
+
+  delete[] counts;
+  delete[] displs;
+  delete[] xc;
+  delete[] lo;
+  delete[] hi;
+  delete[] ridx;
+  delete[] range_lo;
+  delete[] range_hi;
+  delete[] local_red;
+  delete[] global_red;
+}
+
+/*
+  Partition an extruded mesh analytically into contiguous layer slabs.
+
+  This uses the structured topology recorded by
+  setExtrudedConnectivity() in place of the METIS dual-graph
+  partition: the element layers are divided into split_size contiguous
+  slabs with balanced element counts, so each interface between
+  adjacent partitions cuts exactly one plane of nodes. When the
+  partition must be finer than the number of layers, the remaining
+  splits divide the base elements of each layer into contiguous
+  ranges.
+
+  Since the slabs are contiguous in the layer-major element order, the
+  plane-major node numbering of the extrusion is preserved and the
+  assembled matrix retains its banded structure.
+
+  Like partitionMesh(), this function is only called on the root
+  processor.
+
+  input:
+  split_size:  the number of segments in the partition
+*/
+void TACSCreator::partitionMeshExtruded(int split_size) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  if (rank != root_rank) {
+    return;
+  }
+
+  if (num_layers <= 0) {
+    fprintf(stderr,
+            "TACSCreator: Must call setExtrudedConnectivity() before "
+            "partitionMeshExtruded()\n");
+    return;
+  }
+
+  // Set the split size to ensure that it is less than the comm size
+  int mpi_size;
+  MPI_Comm_size(comm, &mpi_size);
+  if (split_size <= 0 || split_size > mpi_size) {
+    split_size = mpi_size;
+  }
+
+  int *part = new int[num_elements];
+  if (split_size <= num_layers) {
+    // Assign each partition a contiguous range of whole layers
+    for (int p = 0; p < num_layers; p++) {
+      int owner = (p * split_size) / num_layers;
+      for (int e = 0; e < num_base_elements; e++) {
+        part[p * num_base_elements + e] = owner;
+      }
+    }
+  } else {
+    // More partitions than layers: split the layer-major element
+    // order into contiguous ranges of balanced size
+    for (int i = 0; i < num_elements; i++) {
+      part[i] = (int)(((int64_t)i * split_size) / num_elements);
+    }
+  }
+
+  // Feed the analytic partition into the standard flow
+  partitionMesh(split_size, part);
+  delete[] part;
+}
+
 /*
   Retrieve the element numbers on each processor corresponding to the
   given component numbers.
@@ -1227,9 +2386,13 @@ int TACSCreator::getElementIdNums(int num_ids, int ids[], int **elem_nums) {
   // Sort the component numbers on input
   num_ids = TacsUniqueSort(num_ids, ids);
 
-  int *all_elems = new int[num_owned_elements];
+  // The halo element replicas are included so that any auxiliary
+  // elements attached by element id are added to the replicas as
+  // well - this keeps the redundantly-computed rows consistent
+  int num_local_elements = num_owned_elements + num_halo_elements;
+  int *all_elems = new int[num_local_elements];
   int elem_size = 0;
-  for (int k = 0; k < num_owned_elements; k++) {
+  for (int k = 0; k < num_local_elements; k++) {
     if (TacsSearchArray(local_elem_id_nums[k], num_ids, ids)) {
       all_elems[elem_size] = k;
       elem_size++;
@@ -53,6 +53,13 @@ class TACSCreator : public TACSObject {
                              const int *_elem_node_conn,
                              const int *_elem_id_nums);
 
+  // Set the connectivity of an extruded/swept structured mesh
+  // ---------------------------------------------------------
+  void setExtrudedConnectivity(int _num_base_nodes, int _num_base_elements,
+                               const int *_base_elem_node_ptr,
+                               const int *_base_elem_node_conn,
+                               const int *_base_elem_id_nums, int _num_layers);
+
   // Set the boundary conditions
   // ---------------------------
   void setBoundaryConditions(int _num_bcs, const int *_bc_nodes,
@@ -78,6 +85,22 @@ class TACSCreator : public TACSObject {
   // Partition the mesh
   // ------------------
   void partitionMesh(int split_size = 0, const int *part = NULL);
+  void partitionMeshRCB(int split_size = 0);
+  void partitionMeshExtruded(int split_size = 0);
+
+  // Set weights for the mesh partition
+  // ----------------------------------
+  void setPartitionWeights(int _num_weights, const double *_weights);
+  void setPartitionDOFBalance(int flag);
+
+  // Rebalance from the measured per-element assembly cost
+  // -----------------------------------------------------
+  void gatherElementRuntimes(TACSAssembler *tacs, double *times);
+  void setPartitionElementWeights(int _num_elements, const double *_weights);
+
+  // Replicate the partition boundary elements on their neighbors
+  // ------------------------------------------------------------
+  void setBoundaryElementReplication(int flag);
 
   // Set the elements into TACS creator
   // ----------------------------------
@@ -88,6 +111,12 @@ class TACSCreator : public TACSObject {
   // -------------------------------
   TACSAssembler *createTACS();
 
+  // Rebuild the assembler for a resized processor allocation
+  // --------------------------------------------------------
+  TACSAssembler *reconfigure(MPI_Comm new_comm, TACSAssembler *assembler,
+                             int num_vecs = 0, TACSBVec **vecs = NULL,
+                             TACSBVec **new_vecs = NULL);
+
   // Get local element numbers with the given set of element-id numbers
   // ------------------------------------------------------------------
   int getElementIdNums(int num_ids, int *ids, int **elem_nums);
@@ -124,6 +153,9 @@ class TACSCreator : public TACSObject {
   // The global connectivity information
   int num_nodes, num_elements;
 
+  // The extruded-topology description set by setExtrudedConnectivity
+  int num_base_nodes, num_base_elements, num_layers;
+
   // The dependent node data, connectivity and weights
   int num_dependent_nodes;
   int *dep_node_ptr, *dep_node_conn;
@@ -135,10 +167,15 @@ class TACSCreator : public TACSObject {
   // Unique global element identifier
   int *elem_id_nums;
 
-  // Boundary conditions
+  // Boundary conditions. After the broadcast in createTACS() the
+  // arrays point into a single packed segment with base bc_nodes,
+  // stored once per node in a shared-memory window when one is
+  // available. bc_packed indicates the packed storage.
   int num_bcs;
   int *bc_nodes, *bc_vars, *bc_ptr;
   TacsScalar *bc_vals;
+  MPI_Win bc_win;
+  int bc_packed;
 
   // The node locations
   TacsScalar *Xpts;
@@ -156,8 +193,24 @@ class TACSCreator : public TACSObject {
   // The element partition
   int *partition;
 
+  // Relative element cost weights, indexed by element-id number, and
+  // the flag that adds the DOF count as a second balance constraint
+  int num_partition_weights;
+  double *partition_weights;
+  int partition_dof_balance;
+
+  // Per-element cost weights in the global element ordering, set from
+  // the measured assembly times. These take precedence over the
+  // element-id weights when the mesh is partitioned
+  double *element_weights;
+
+  // Replicate the boundary elements of neighboring partitions so
+  // that the assembler can run in redundant-compute mode
+  int replicate_boundary;
+
   // Local information about the partitioned mesh
   int num_owned_elements, num_owned_nodes;
+  int num_halo_elements;
   int *local_elem_id_nums;
 };
 
@@ -0,0 +1,325 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSDesignSpace.h"
+
+/*
+  Get the number of locally owned design variable nodes of an
+  assembler from its design node map
+*/
+static int getNumOwnedDesignNodes(TACSAssembler *assembler) {
+  int rank;
+  MPI_Comm_rank(assembler->getMPIComm(), &rank);
+  const int *range;
+  assembler->getDesignNodeMap()->getOwnerRange(&range);
+  return range[rank + 1] - range[rank];
+}
+
+/**
+  Create the design space from the primary assembler
+
+  The primary assembler defines the design variable layout: vectors
+  created by createDesignVec() use its design node map, and the
+  design variable values and ranges are read from it.
+
+  @param _assembler The primary (usually the finest) assembler
+*/
+TACSDesignSpace::TACSDesignSpace(TACSAssembler *_assembler) {
+  num_assemblers = 0;
+  max_assemblers = 4;
+  assemblers = new TACSAssembler *[max_assemblers];
+  dv_maps = new int *[max_assemblers];
+  dv_vecs = new TACSBVec *[max_assemblers];
+
+  assemblers[0] = _assembler;
+  assemblers[0]->incref();
+  dv_maps[0] = NULL;
+  dv_vecs[0] = NULL;
+  num_assemblers = 1;
+}
+
+TACSDesignSpace::~TACSDesignSpace() {
+  for (int i = 0; i < num_assemblers; i++) {
+    assemblers[i]->decref();
+    if (dv_maps[i]) {
+      delete[] dv_maps[i];
+    }
+    if (dv_vecs[i]) {
+      dv_vecs[i]->decref();
+    }
+  }
+  delete[] assemblers;
+  delete[] dv_maps;
+  delete[] dv_vecs;
+}
+
+/**
+  Register another assembler against the shared design space
+
+  When the map is NULL the assembler shares the design-space
+  numbering and the design vector is passed to it directly. Otherwise
+  the map gives, for each of the assembler's locally owned design
+  variable nodes, the design-space node its values are drawn from.
+  The map is copied.
+
+  @param _assembler The assembler to register
+  @param dv_map The owned-node index map, or NULL for pass-through
+*/
+void TACSDesignSpace::addAssembler(TACSAssembler *_assembler,
+                                   const int *dv_map) {
+  if (dv_map && (_assembler->getDesignVarsPerNode() !=
+                 assemblers[0]->getDesignVarsPerNode())) {
+    fprintf(stderr,
+            "TACSDesignSpace: Cannot map assemblers with different "
+            "design variables per node\n");
+    return;
+  }
+
+  // Extend the storage if needed
+  if (num_assemblers == max_assemblers) {
+    max_assemblers *= 2;
+    TACSAssembler **tmp_assem = new TACSAssembler *[max_assemblers];
+    int **tmp_maps = new int *[max_assemblers];
+    TACSBVec **tmp_vecs = new TACSBVec *[max_assemblers];
+    memcpy(tmp_assem, assemblers, num_assemblers * sizeof(TACSAssembler *));
+    memcpy(tmp_maps, dv_maps, num_assemblers * sizeof(int *));
+    memcpy(tmp_vecs, dv_vecs, num_assemblers * sizeof(TACSBVec *));
+    delete[] assemblers;
+    delete[] dv_maps;
+    delete[] dv_vecs;
+    assemblers = tmp_assem;
+    dv_maps = tmp_maps;
+    dv_vecs = tmp_vecs;
+  }
+
+  assemblers[num_assemblers] = _assembler;
+  assemblers[num_assemblers]->incref();
+  dv_maps[num_assemblers] = NULL;
+  dv_vecs[num_assemblers] = NULL;
+
+  if (dv_map) {
+    int nowned = getNumOwnedDesignNodes(_assembler);
+    dv_maps[num_assemblers] = new int[nowned];
+    memcpy(dv_maps[num_assemblers], dv_map, nowned * sizeof(int));
+  }
+  num_assemblers++;
+}
+
+/*
+  Get the number of registered fidelities
+*/
+int TACSDesignSpace::getNumFidelities() { return num_assemblers; }
+
+/*
+  Get the assembler registered at the given fidelity index
+*/
+TACSAssembler *TACSDesignSpace::getAssembler(int fidelity) {
+  if (fidelity >= 0 && fidelity < num_assemblers) {
+    return assemblers[fidelity];
+  }
+  return NULL;
+}
+
+/**
+  Create a vector of the shared design space
+
+  @return A design vector with the primary assembler's layout
+*/
+TACSBVec *TACSDesignSpace::createDesignVec() {
+  return assemblers[0]->createDesignVec();
+}
+
+/*
+  Get the design variable values from the primary assembler
+*/
+void TACSDesignSpace::getDesignVars(TACSBVec *x) {
+  assemblers[0]->getDesignVars(x);
+}
+
+/*
+  Get the design variable range from the primary assembler
+*/
+void TACSDesignSpace::getDesignVarRange(TACSBVec *lb, TACSBVec *ub) {
+  assemblers[0]->getDesignVarRange(lb, ub);
+}
+
+/**
+  Set the design variable values on every registered assembler
+
+  The pass-through assemblers receive the vector directly. For the
+  mapped assemblers the owned values are gathered through the index
+  map into a cached fidelity design vector first. The mapped values
+  must be available on the local process.
+
+  @param x The design variable values in the design-space layout
+*/
+void TACSDesignSpace::setDesignVars(TACSBVec *x) {
+  for (int i = 0; i < num_assemblers; i++) {
+    if (!dv_maps[i]) {
+      assemblers[i]->setDesignVars(x);
+    } else {
+      TACSBVec *xf = getFidelityVec(i);
+      int nowned = getNumOwnedDesignNodes(assemblers[i]);
+      TacsScalar *vals;
+      xf->getArray(&vals);
+      if (x->getValues(nowned, dv_maps[i], vals)) {
+        fprintf(stderr,
+                "TACSDesignSpace: Design variable values are not "
+                "available locally for fidelity %d\n",
+                i);
+      }
+      assemblers[i]->setDesignVars(xf);
+    }
+  }
+}
+
+/**
+  Evaluate the functions on the selected fidelity
+
+  @param fidelity The fidelity index, 0 for the primary assembler
+  @param numFuncs The number of functions
+  @param funcs The function objects, created on the selected assembler
+  @param fvals The function values
+*/
+void TACSDesignSpace::evalFunctions(int fidelity, int numFuncs,
+                                    TACSFunction **funcs, TacsScalar *fvals) {
+  if (fidelity < 0 || fidelity >= num_assemblers) {
+    fprintf(stderr, "TACSDesignSpace: Fidelity index %d out of range\n",
+            fidelity);
+    return;
+  }
+  assemblers[fidelity]->evalFunctions(numFuncs, funcs, fvals);
+}
+
+/**
+  Add the function derivatives on the selected fidelity
+
+  For a mapped fidelity the derivatives are evaluated into temporary
+  fidelity vectors and scattered through the index map into the
+  design-space output vectors. As with TACSAssembler::addDVSens, the
+  caller completes the assembly of the output vectors.
+
+  @param fidelity The fidelity index, 0 for the primary assembler
+  @param coef The coefficient applied to the derivative
+  @param numFuncs The number of functions
+  @param funcs The function objects, created on the selected assembler
+  @param dfdx The derivative vectors in the design-space layout
+*/
+void TACSDesignSpace::addDVSens(int fidelity, TacsScalar coef, int numFuncs,
+                                TACSFunction **funcs, TACSBVec **dfdx) {
+  if (fidelity < 0 || fidelity >= num_assemblers) {
+    fprintf(stderr, "TACSDesignSpace: Fidelity index %d out of range\n",
+            fidelity);
+    return;
+  }
+
+  if (!dv_maps[fidelity]) {
+    assemblers[fidelity]->addDVSens(coef, numFuncs, funcs, dfdx);
+  } else {
+    // Evaluate the derivatives in the fidelity's own design space
+    TACSBVec **tmp = new TACSBVec *[numFuncs];
+    for (int k = 0; k < numFuncs; k++) {
+      tmp[k] = assemblers[fidelity]->createDesignVec();
+      tmp[k]->incref();
+    }
+    assemblers[fidelity]->addDVSens(coef, numFuncs, funcs, tmp);
+
+    // Scatter the derivatives back into the design-space vectors
+    for (int k = 0; k < numFuncs; k++) {
+      scatterToDesignSpace(fidelity, tmp[k], dfdx[k]);
+      tmp[k]->decref();
+    }
+    delete[] tmp;
+  }
+}
+
+/**
+  Add the adjoint-residual products on the selected fidelity
+
+  For a mapped fidelity the products are evaluated into temporary
+  fidelity vectors and scattered through the index map into the
+  design-space output vectors. As with
+  TACSAssembler::addAdjointResProducts, the caller completes the
+  assembly of the output vectors.
+
+  @param fidelity The fidelity index, 0 for the primary assembler
+  @param scale Scalar factor applied to the derivative
+  @param numAdjoints The number of adjoint vectors
+  @param adjoint The adjoint vectors on the selected assembler
+  @param dfdx The derivative vectors in the design-space layout
+  @param lambda Scaling factor for the aux element contributions
+*/
+void TACSDesignSpace::addAdjointResProducts(int fidelity, TacsScalar scale,
+                                            int numAdjoints,
+                                            TACSBVec **adjoint,
+                                            TACSBVec **dfdx,
+                                            const TacsScalar lambda) {
+  if (fidelity < 0 || fidelity >= num_assemblers) {
+    fprintf(stderr, "TACSDesignSpace: Fidelity index %d out of range\n",
+            fidelity);
+    return;
+  }
+
+  if (!dv_maps[fidelity]) {
+    assemblers[fidelity]->addAdjointResProducts(scale, numAdjoints, adjoint,
+                                                dfdx, lambda);
+  } else {
+    TACSBVec **tmp = new TACSBVec *[numAdjoints];
+    for (int k = 0; k < numAdjoints; k++) {
+      tmp[k] = assemblers[fidelity]->createDesignVec();
+      tmp[k]->incref();
+    }
+    assemblers[fidelity]->addAdjointResProducts(scale, numAdjoints, adjoint,
+                                                tmp, lambda);
+
+    for (int k = 0; k < numAdjoints; k++) {
+      scatterToDesignSpace(fidelity, tmp[k], dfdx[k]);
+      tmp[k]->decref();
+    }
+    delete[] tmp;
+  }
+}
+
+/*
+  Retrieve the cached design vector for a mapped fidelity, creating
+  it on the first use
+*/
+TACSBVec *TACSDesignSpace::getFidelityVec(int fidelity) {
+  if (!dv_vecs[fidelity]) {
+    dv_vecs[fidelity] = assemblers[fidelity]->createDesignVec();
+    dv_vecs[fidelity]->incref();
+  }
+  return dv_vecs[fidelity];
+}
+
+/*
+  Scatter a fidelity design vector back into a design-space vector
+  through the index map. The off-process contributions accumulated
+  during the fidelity evaluation are assembled first so that the
+  owned values are complete before they are remapped.
+*/
+void TACSDesignSpace::scatterToDesignSpace(int fidelity, TACSBVec *xf,
+                                           TACSBVec *x) {
+  xf->beginSetValues(TACS_ADD_VALUES);
+  xf->endSetValues(TACS_ADD_VALUES);
+
+  int nowned = getNumOwnedDesignNodes(assemblers[fidelity]);
+  TacsScalar *vals;
+  xf->getArray(&vals);
+  x->setValues(nowned, dv_maps[fidelity], vals, TACS_ADD_VALUES);
+}
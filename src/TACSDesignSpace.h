@@ -0,0 +1,102 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_DESIGN_SPACE_H
+#define TACS_DESIGN_SPACE_H
+
+/*
+  Share one set of design variables across several TACSAssembler
+  instances of different fidelity
+*/
+
+#include "TACSAssembler.h"
+
+/**
+  A shared design variable space for paired-assembler analyses.
+
+  Multi-fidelity optimizations carry a coarse model for the cheap
+  evaluations and a fine model for the accepted steps, but both
+  models describe the same design. This class owns the design
+  variable layout - taken from the primary assembler passed to the
+  constructor - and propagates a single setDesignVars() call to every
+  registered assembler, so the design no longer needs to be marshaled
+  between the models by the driver script on every iteration.
+
+  Assemblers that share the primary design variable numbering are
+  registered without a map and receive the design vector directly,
+  exactly as the multigrid levels do in TACSMg. Assemblers with their
+  own numbering are registered with an index map that gives, for each
+  of their locally owned design variable nodes, the design-space node
+  the values are drawn from. The mapped nodes must be available on
+  the local process - owned, or in the external set of the design
+  vector.
+
+  Function and gradient evaluations are routed to a fidelity by
+  index: index 0 is the primary assembler and subsequent indices
+  follow the registration order. Gradients computed on a mapped
+  fidelity are scattered back through the map into design-space
+  vectors, so the optimizer only ever sees one design variable
+  numbering.
+*/
+class TACSDesignSpace : public TACSObject {
+ public:
+  TACSDesignSpace(TACSAssembler *_assembler);
+  ~TACSDesignSpace();
+
+  // Register another assembler against the shared design space
+  void addAssembler(TACSAssembler *_assembler, const int *dv_map = NULL);
+
+  // Get the registered assemblers
+  int getNumFidelities();
+  TACSAssembler *getAssembler(int fidelity);
+
+  // Create a vector of the shared design space
+  TACSBVec *createDesignVec();
+
+  // Get/set the design variable values. The values set here are
+  // propagated to every registered assembler
+  void getDesignVars(TACSBVec *x);
+  void setDesignVars(TACSBVec *x);
+  void getDesignVarRange(TACSBVec *lb, TACSBVec *ub);
+
+  // Route the function and gradient evaluation to a fidelity. The
+  // gradients are returned in design-space vectors
+  void evalFunctions(int fidelity, int numFuncs, TACSFunction **funcs,
+                     TacsScalar *fvals);
+  void addDVSens(int fidelity, TacsScalar coef, int numFuncs,
+                 TACSFunction **funcs, TACSBVec **dfdx);
+  void addAdjointResProducts(int fidelity, TacsScalar scale, int numAdjoints,
+                             TACSBVec **adjoint, TACSBVec **dfdx,
+                             const TacsScalar lambda = 1.0);
+
+ private:
+  // Retrieve the cached design vector for a mapped fidelity
+  TACSBVec *getFidelityVec(int fidelity);
+
+  // Scatter a fidelity design vector back into design-space vectors
+  void scatterToDesignSpace(int fidelity, TACSBVec *xf, TACSBVec *x);
+
+  // The registered assemblers. Entry 0 is the primary assembler that
+  // defines the design variable layout
+  int num_assemblers, max_assemblers;
+  TACSAssembler **assemblers;
+  int **dv_maps;       // Owned-node index maps, NULL for pass-through
+  TACSBVec **dv_vecs;  // Cached fidelity design vectors, lazily created
+};
+
+#endif  // TACS_DESIGN_SPACE_H
@@ -17,6 +17,8 @@
 #include <math.h>
 
 #include "TACSMg.h"
+#include "TACSProfiler.h"
+#include "TacsUtilities.h"
 #include "tacslapack.h"
 
 /*
@@ -58,25 +60,47 @@ TACSIntegrator::TACSIntegrator(TACSAssembler *_assembler, double tinit,
     logfp = stdout;
   }
 
-  // State variables that store the entire time history
+  // State variables that store the time history. The vectors themselves
+  // are created as the integration marches forward so that checkpointing
+  // can limit how many steps are kept in memory at once.
   q = new TACSBVec *[num_time_steps + 1];
   qdot = new TACSBVec *[num_time_steps + 1];
   qddot = new TACSBVec *[num_time_steps + 1];
-
-  // create state vectors for TACS during each timestep
   for (int k = 0; k < num_time_steps + 1; k++) {
-    q[k] = assembler->createVec();
-    q[k]->incref();
-    qdot[k] = assembler->createVec();
-    qdot[k]->incref();
-    qddot[k] = assembler->createVec();
-    qddot[k]->incref();
+    q[k] = NULL;
+    qdot[k] = NULL;
+    qddot[k] = NULL;
   }
 
+  // The snapshot pool is empty until state vectors are released
+  num_pool_vecs = 0;
+  max_pool_vecs = 0;
+  vec_pool = NULL;
+  pool_bytes = 0;
+
+  // Create the state vectors that store the initial conditions
+  createStepVectors(0);
+
+  // By default, keep the entire time history in memory
+  num_checkpoints = 0;
+
+  // Restart file output is disabled by default
+  restart_fname[0] = '\0';
+  restart_freq = 0;
+  restart_step = -1;
+  restart_fp = MPI_FILE_NULL;
+  num_restart_records = 0;
+  restart_range = NULL;
+  restart_stage[0] = restart_stage[1] = restart_stage[2] = NULL;
+  restart_nreqs = 0;
+
   // Objects to store information about the functions of interest
   funcs = NULL;
   start_plane = 0;
   end_plane = num_time_steps;
+  func_start_plane = NULL;
+  func_end_plane = NULL;
+  use_func_windows = 0;
   num_funcs = 0;
   fvals = NULL;
   dfdx = NULL;
@@ -88,6 +112,15 @@ TACSIntegrator::TACSIntegrator(TACSAssembler *_assembler, double tinit,
   res->incref();
   update->incref();
 
+  // The Krylov predictor history is allocated when it is first used
+  update_hist[0] = update_hist[1] = NULL;
+  num_update_hist = 0;
+  use_krylov_predictor = 0;
+
+  // The inner solves run to a fixed tolerance unless a forcing-term
+  // controller is supplied with setAdaptiveForcing()
+  forcing = NULL;
+
   // NULL the different KSM/solver objects
   mat = NULL;
   pc = NULL;
@@ -100,6 +133,9 @@ TACSIntegrator::TACSIntegrator(TACSAssembler *_assembler, double tinit,
   rtol = 1.0e-9;
   init_newton_delta = 0.0;
   jac_comp_freq = 1;
+  use_adaptive_jac = 0;
+  jac_contraction_tol = 0.5;
+  jac_current = 0;
 
   // Set the default LINEAR solver
   use_lapack = 0;
@@ -135,16 +171,52 @@ TACSIntegrator::~TACSIntegrator() {
     fclose(logfp);
   }
 
+  // Complete any outstanding restart writes and close the file
+  finalizeRestartFile();
+  for (int j = 0; j < 3; j++) {
+    if (restart_stage[j]) {
+      restart_stage[j]->decref();
+    }
+  }
+  if (restart_range) {
+    delete[] restart_range;
+  }
+
   // Dereference position, velocity and acceleration states
   for (int k = 0; k < num_time_steps + 1; k++) {
-    q[k]->decref();
-    qdot[k]->decref();
-    qddot[k]->decref();
+    if (q[k]) {
+      q[k]->decref();
+    }
+    if (qdot[k]) {
+      qdot[k]->decref();
+    }
+    if (qddot[k]) {
+      qddot[k]->decref();
+    }
+  }
+
+  // Dereference the pooled state vectors and release the bytes
+  // registered against the memory budget
+  for (int k = 0; k < num_pool_vecs; k++) {
+    vec_pool[k]->decref();
+  }
+  if (vec_pool) {
+    delete[] vec_pool;
+  }
+  if (pool_bytes > 0) {
+    TacsReleaseAllocation(pool_bytes);
   }
 
   // Dereference Newton's method objects
   res->decref();
   update->decref();
+  if (update_hist[0]) {
+    update_hist[0]->decref();
+    update_hist[1]->decref();
+  }
+  if (forcing) {
+    forcing->decref();
+  }
   if (mat) {
     mat->decref();
   }
@@ -167,6 +239,12 @@ TACSIntegrator::~TACSIntegrator() {
   if (qddot) {
     delete[] qddot;
   }
+  if (func_start_plane) {
+    delete[] func_start_plane;
+  }
+  if (func_end_plane) {
+    delete[] func_end_plane;
+  }
 
   // Dereference TACS
   if (assembler) {
@@ -226,6 +304,68 @@ void TACSIntegrator::setJacAssemblyFreq(int _jac_comp_freq) {
   jac_comp_freq = _jac_comp_freq;
 }
 
+/*
+  Re-use the factored Jacobian across time steps and Newton iterations
+  until the observed convergence rate degrades.
+
+  When this option is enabled, the Newton solver skips the Jacobian
+  assembly and factorization as long as a factorization from an earlier
+  solve is available and the residual norm contracts by at least the
+  given factor per iteration. Once the contraction degrades past the
+  threshold, the Jacobian is re-assembled and re-factored at the current
+  states. For mildly nonlinear problems most time steps can then re-use
+  the same factorization.
+
+  input:
+  flag:            re-use the lagged Jacobian if possible
+  contraction_tol: required per-iteration reduction of the residual norm
+*/
+void TACSIntegrator::setAdaptiveJacobianReuse(int flag,
+                                              double contraction_tol) {
+  use_adaptive_jac = flag;
+  if (contraction_tol > 0.0 && contraction_tol < 1.0) {
+    jac_contraction_tol = contraction_tol;
+  }
+}
+
+/*
+  Set whether to extrapolate the initial guess for the first linear
+  solve of each Newton solve.
+
+  For smooth transients the first Newton update of consecutive time
+  steps changes slowly, so the update from the previous one or two
+  steps is a much better starting point for the Krylov solver than
+  zero. The updates from the previous two Newton solves are stored and
+  extrapolated linearly in time. Later Newton iterations within a step
+  still start from zero, since those updates contract rapidly. This
+  option is intended for marching schemes where consecutive Newton
+  solves correspond to consecutive time steps.
+*/
+void TACSIntegrator::setKrylovPredictor(int flag) {
+  use_krylov_predictor = flag;
+  if (!use_krylov_predictor) {
+    num_update_hist = 0;
+  }
+}
+
+/*
+  Set the adaptive forcing-term controller for the inner linear solves.
+
+  When a controller is supplied, the relative tolerance of the Krylov
+  solver is chosen at each Newton iteration from the nonlinear
+  residual history, so that early Newton steps far from the solution
+  are not over-solved. Pass NULL to restore the fixed tolerance.
+*/
+void TACSIntegrator::setAdaptiveForcing(TACSEisenstatWalker *controller) {
+  if (controller) {
+    controller->incref();
+  }
+  if (forcing) {
+    forcing->decref();
+  }
+  forcing = controller;
+}
+
 /*
   Set whether or not to use LAPACK for linear solve
 */
@@ -280,6 +420,31 @@ void TACSIntegrator::setTimeInterval(double tinit, double tfinal) {
   }
 }
 
+/*
+  Set the number of state snapshots retained in memory during the
+  forward integration.
+
+  When a positive number of checkpoints is set, the time history is not
+  stored in its entirety. Instead, snapshots of the states are retained
+  at evenly spaced steps and the intermediate states are recomputed from
+  the closest snapshot during the function and adjoint evaluations. This
+  trades additional forward computation for a large reduction in memory
+  for long time histories. Checkpointing is supported by the BDF
+  integrator.
+
+  input:
+  num_checkpoints: the number of snapshots kept (0 stores all steps)
+*/
+void TACSIntegrator::setNumCheckpoints(int _num_checkpoints) {
+  num_checkpoints = _num_checkpoints;
+  if (num_checkpoints < 0) {
+    num_checkpoints = 0;
+  }
+  if (num_checkpoints > num_time_steps) {
+    num_checkpoints = num_time_steps;
+  }
+}
+
 /*
   Set the functions of interest that take part in the adjoint solve.
 */
@@ -333,6 +498,15 @@ void TACSIntegrator::setFunctions(int _num_funcs, TACSFunction **_funcs,
     delete[] dfdXpt;
   }
 
+  // Drop any per-function time windows from a previous registration
+  if (func_start_plane) {
+    delete[] func_start_plane;
+    func_start_plane = NULL;
+    delete[] func_end_plane;
+    func_end_plane = NULL;
+  }
+  use_func_windows = 0;
+
   // Set the number of functions
   num_funcs = _num_funcs;
   funcs = new TACSFunction *[num_funcs];
@@ -348,6 +522,134 @@ void TACSIntegrator::setFunctions(int _num_funcs, TACSFunction **_funcs,
   }
 }
 
+/*
+  Restrict one of the functions of interest to a time window.
+
+  The window is converted to the time planes that bracket the input
+  interval: function contributions accumulate from the first plane at
+  or after tstart to the last plane at or before tstop, with the usual
+  trapezoid weights applied at the window boundaries. The window is
+  clipped against the global window given to setFunctions().
+
+  Beyond restricting the forward accumulation, the windows shorten the
+  backward adjoint sweep: the sweep starts from the last plane at
+  which any function contributes, since the adjoint variables are
+  identically zero beyond that plane. For an event window early in a
+  long time history - a gust encounter, say - this removes most of the
+  backward integration.
+
+  The BDF and DIRK integrators apply the windows per function; the
+  remaining integrators apply the union of the registered windows.
+
+  input:
+  func_num: the index of the function within setFunctions()
+  tstart:   the start time of the window
+  tstop:    the stop time of the window
+*/
+void TACSIntegrator::setFunctionTimeWindow(int func_num, double tstart,
+                                           double tstop) {
+  if (func_num < 0 || func_num >= num_funcs) {
+    fprintf(stderr,
+            "[%d] TACSIntegrator: Function index %d out of range for the "
+            "time window\n",
+            mpiRank, func_num);
+    return;
+  }
+
+  // Allocate the windows on first use, defaulting to the global window
+  if (!func_start_plane) {
+    func_start_plane = new int[num_funcs];
+    func_end_plane = new int[num_funcs];
+    for (int n = 0; n < num_funcs; n++) {
+      func_start_plane[n] = start_plane;
+      func_end_plane[n] = end_plane;
+    }
+  }
+
+  // Find the first plane at or after tstart and the last plane at or
+  // before tstop
+  int ks = 0;
+  while (ks < num_time_steps && time[ks] < tstart) {
+    ks++;
+  }
+  int ke = num_time_steps;
+  while (ke > 0 && time[ke] > tstop) {
+    ke--;
+  }
+
+  // Clip the window against the global window
+  if (ks < start_plane) {
+    ks = start_plane;
+  }
+  if (ke > end_plane) {
+    ke = end_plane;
+  }
+  if (ke < ks) {
+    ke = ks;
+  }
+
+  func_start_plane[func_num] = ks;
+  func_end_plane[func_num] = ke;
+  use_func_windows = 1;
+}
+
+/*
+  Compute the trapezoid time coefficient of the given time plane
+  within the time window of the given function. The coefficient is
+  zero outside the window.
+*/
+double TACSIntegrator::getFunctionTimeCoeff(int func_num, int k) {
+  int ks = start_plane, ke = end_plane;
+  if (use_func_windows) {
+    ks = func_start_plane[func_num];
+    ke = func_end_plane[func_num];
+  }
+
+  double tcoeff = 0.0;
+  if (k >= ks && k <= ke) {
+    if (k > ks) {
+      tcoeff += 0.5 * (time[k] - time[k - 1]);
+    }
+    if (k < ke) {
+      tcoeff += 0.5 * (time[k + 1] - time[k]);
+    }
+  }
+  return tcoeff;
+}
+
+/*
+  Check whether the step interval starting at the given time plane
+  falls within the time window of the given function. This is the
+  activity test used by the stage-based integrators, whose quadrature
+  spans whole step intervals.
+*/
+int TACSIntegrator::isFunctionIntervalActive(int func_num, int k) {
+  int ks = start_plane, ke = end_plane;
+  if (use_func_windows) {
+    ks = func_start_plane[func_num];
+    ke = func_end_plane[func_num];
+  }
+  return (k >= ks && k < ke);
+}
+
+/*
+  Get the last time plane at which any function contributes. The
+  adjoint variables are identically zero beyond this plane, so the
+  backward sweep can start from it directly.
+*/
+int TACSIntegrator::getLastActivePlane() {
+  int last = end_plane;
+  if (use_func_windows) {
+    last = 0;
+    for (int n = 0; n < num_funcs; n++) {
+      if (funcs[n] && func_end_plane[n] > last) {
+        last = func_end_plane[n];
+      }
+    }
+  }
+  return last;
+}
+
 /*
   Set the output directory prefix
 */
@@ -359,12 +661,328 @@ void TACSIntegrator::setOutputPrefix(const char *_prefix) {
   Integration the equations of motion forward in time.
 */
 int TACSIntegrator::integrate() {
-  for (int i = 0; i < num_time_steps + 1; i++) {
+  TacsProfileScope profile("TACSIntegrator::integrate");
+  for (int i = restart_step + 1; i < num_time_steps + 1; i++) {
     int flag = iterate(i, NULL);
     if (flag != 0) {
+      // Keep the restart file valid up to the last completed step
+      finalizeRestartFile();
       return flag;
     }
+
+    // Write the restart checkpoint for this step if one is scheduled
+    if (isRestartStep(i)) {
+      writeRestartStep(i);
+    }
   }
+
+  // Complete the outstanding restart writes
+  finalizeRestartFile();
+  return 0;
+}
+
+/*
+  Set the restart file name and the checkpoint cadence.
+
+  Every restart_freq steps the integrator writes the states required
+  to resume the forward integration from that step, including the
+  trailing history window needed by multi-step schemes. A
+  non-positive frequency disables the restart output.
+
+  input:
+  filename:      the name of the restart file (same on all procs)
+  restart_freq:  the number of time steps between checkpoints
+*/
+void TACSIntegrator::setRestartFile(const char *filename, int _restart_freq) {
+  strncpy(restart_fname, filename, sizeof(restart_fname) - 1);
+  restart_fname[sizeof(restart_fname) - 1] = '\0';
+  restart_freq = _restart_freq;
+  if (restart_freq < 0) {
+    restart_freq = 0;
+  }
+}
+
+/*
+  The number of trailing steps that a restart must restore. One-step
+  schemes only need the states at the restart step itself.
+*/
+int TACSIntegrator::restartHistorySize() { return 1; }
+
+/*
+  Check whether the states at the given step are written to the
+  restart file. The initial conditions are always recorded. At each
+  checkpoint, the trailing history window is also recorded so that
+  multi-step schemes can resume at full order. This mirrors the
+  snapshot logic used for the in-memory checkpointing.
+*/
+int TACSIntegrator::isRestartStep(int step_num) {
+  if (restart_freq <= 0) {
+    return 0;
+  }
+  if (step_num == 0) {
+    return 1;
+  }
+
+  // Find the closest checkpoint at or after this step
+  int ckpt = restart_freq * ((step_num + restart_freq - 1) / restart_freq);
+  if (ckpt > num_time_steps) {
+    ckpt = num_time_steps;
+  }
+
+  return (step_num <= ckpt && ckpt - step_num < restartHistorySize());
+}
+
+/*
+  Write the states at the given step to the restart file.
+
+  The states are copied into staging vectors and written with
+  nonblocking MPI I/O so that the write of this checkpoint overlaps
+  the Newton solves of the following steps. The file format is:
+
+  int                       the global length of the state vectors
+  then for each record:
+  int                       the time step number
+  double                    the time value
+  3*len*sizeof(TacsScalar)  the q, qdot and qddot entries
+*/
+void TACSIntegrator::writeRestartStep(int step_num) {
+  int size;
+  res->getSize(&size);
+
+  // Open the file and write the header for the first record
+  if (restart_fp == MPI_FILE_NULL) {
+    MPI_Comm comm = assembler->getMPIComm();
+    MPI_File_open(comm, restart_fname, MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                  MPI_INFO_NULL, &restart_fp);
+    if (restart_fp == MPI_FILE_NULL) {
+      fprintf(stderr, "TACSIntegrator: Failed to open restart file %s\n",
+              restart_fname);
+      restart_freq = 0;
+      return;
+    }
+
+    // Discard the contents of any previous file with the same name
+    MPI_File_set_size(restart_fp, 0);
+
+    // Compute the ownership offsets of the distributed states
+    if (!restart_range) {
+      restart_range = new int[mpiSize + 1];
+      restart_range[0] = 0;
+      MPI_Allgather(&size, 1, MPI_INT, &restart_range[1], 1, MPI_INT, comm);
+      for (int i = 0; i < mpiSize; i++) {
+        restart_range[i + 1] += restart_range[i];
+      }
+    }
+
+    if (mpiRank == 0) {
+      MPI_File_write_at(restart_fp, 0, &restart_range[mpiSize], 1, MPI_INT,
+                        MPI_STATUS_IGNORE);
+    }
+
+    // Create the staging vectors for the nonblocking writes
+    for (int j = 0; j < 3; j++) {
+      if (!restart_stage[j]) {
+        restart_stage[j] = assembler->createVec();
+        restart_stage[j]->incref();
+      }
+    }
+  }
+
+  // Complete the outstanding writes of the previous record before the
+  // staging vectors are overwritten
+  if (restart_nreqs > 0) {
+    MPI_Waitall(restart_nreqs, restart_reqs, MPI_STATUSES_IGNORE);
+    restart_nreqs = 0;
+  }
+
+  // Stage copies of the states so that the checkpointing logic is
+  // free to release or overwrite the originals while the write is in
+  // flight
+  restart_stage[0]->copyValues(q[step_num]);
+  restart_stage[1]->copyValues(qdot[step_num]);
+  restart_stage[2]->copyValues(qddot[step_num]);
+
+  // Compute the byte offset of this record
+  int len = restart_range[mpiSize];
+  MPI_Offset rec_bytes =
+      sizeof(int) + sizeof(double) + 3 * (MPI_Offset)len * sizeof(TacsScalar);
+  MPI_Offset offset = sizeof(int) + num_restart_records * rec_bytes;
+
+  // Write the step number and the time value
+  if (mpiRank == 0) {
+    MPI_File_write_at(restart_fp, offset, &step_num, 1, MPI_INT,
+                      MPI_STATUS_IGNORE);
+    MPI_File_write_at(restart_fp, offset + sizeof(int), &time[step_num], 1,
+                      MPI_DOUBLE, MPI_STATUS_IGNORE);
+  }
+
+  // Start the nonblocking writes of the staged states
+  offset += sizeof(int) + sizeof(double);
+  for (int j = 0; j < 3; j++) {
+    TacsScalar *vals;
+    restart_stage[j]->getArray(&vals);
+    MPI_Offset off = offset + ((MPI_Offset)j * len + restart_range[mpiRank]) *
+                                  sizeof(TacsScalar);
+    MPI_File_iwrite_at(restart_fp, off, vals, size, TACS_MPI_TYPE,
+                       &restart_reqs[j]);
+  }
+  restart_nreqs = 3;
+  num_restart_records++;
+}
+
+/*
+  Complete any outstanding restart writes and close the restart file
+*/
+void TACSIntegrator::finalizeRestartFile() {
+  if (restart_nreqs > 0) {
+    MPI_Waitall(restart_nreqs, restart_reqs, MPI_STATUSES_IGNORE);
+    restart_nreqs = 0;
+  }
+  if (restart_fp != MPI_FILE_NULL) {
+    MPI_File_close(&restart_fp);
+    restart_fp = MPI_FILE_NULL;
+  }
+  num_restart_records = 0;
+}
+
+/*
+  Restart the integration from the states stored in a restart file.
+
+  All records within the history window of the requested step are
+  read back so that multi-step schemes resume at full order. The step
+  must be one of the checkpoint steps recorded in the file. The
+  Jacobian factorization and the Krylov predictor history cannot be
+  meaningfully persisted and are rebuilt during the first steps after
+  the restart. After a successful restart, integrate() resumes from
+  the step following the requested one.
+
+  input:
+  filename:  the name of the restart file (same on all procs)
+  step:      the time step to restart from
+
+  returns 0 on success and 1 on failure
+*/
+int TACSIntegrator::restart(const char *filename, int step) {
+  if (step < 0 || step > num_time_steps) {
+    fprintf(stderr, "TACSIntegrator: Restart step %d out of range\n", step);
+    return 1;
+  }
+
+  MPI_Comm comm = assembler->getMPIComm();
+  int size;
+  res->getSize(&size);
+
+  // Compute the ownership offsets of the distributed states
+  int *range = new int[mpiSize + 1];
+  range[0] = 0;
+  MPI_Allgather(&size, 1, MPI_INT, &range[1], 1, MPI_INT, comm);
+  for (int i = 0; i < mpiSize; i++) {
+    range[i + 1] += range[i];
+  }
+
+  MPI_File fp = MPI_FILE_NULL;
+  MPI_File_open(comm, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fp);
+  if (fp == MPI_FILE_NULL) {
+    fprintf(stderr, "TACSIntegrator: Failed to open restart file %s\n",
+            filename);
+    delete[] range;
+    return 1;
+  }
+
+  // Check that the stored vector length matches this problem
+  int len = 0;
+  if (mpiRank == 0) {
+    MPI_File_read_at(fp, 0, &len, 1, MPI_INT, MPI_STATUS_IGNORE);
+  }
+  MPI_Bcast(&len, 1, MPI_INT, 0, comm);
+  if (len != range[mpiSize]) {
+    fprintf(stderr,
+            "TACSIntegrator: Cannot restart from %s, incorrect "
+            "size %d != %d\n",
+            filename, range[mpiSize], len);
+    MPI_File_close(&fp);
+    delete[] range;
+    return 1;
+  }
+
+  // Compute the number of complete records in the file
+  MPI_Offset rec_bytes =
+      sizeof(int) + sizeof(double) + 3 * (MPI_Offset)len * sizeof(TacsScalar);
+  MPI_Offset fsize = 0;
+  MPI_File_get_size(fp, &fsize);
+  int nrecs = (int)((fsize - sizeof(int)) / rec_bytes);
+
+  // Read back the records within the history window of the step
+  int hist = restartHistorySize();
+  int found = 0;
+  for (int r = 0; r < nrecs; r++) {
+    MPI_Offset offset = sizeof(int) + r * rec_bytes;
+
+    int step_r = 0;
+    double t_r = 0.0;
+    if (mpiRank == 0) {
+      MPI_File_read_at(fp, offset, &step_r, 1, MPI_INT, MPI_STATUS_IGNORE);
+      MPI_File_read_at(fp, offset + sizeof(int), &t_r, 1, MPI_DOUBLE,
+                       MPI_STATUS_IGNORE);
+    }
+    MPI_Bcast(&step_r, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&t_r, 1, MPI_DOUBLE, 0, comm);
+
+    if (step_r >= 0 && step_r <= step && step - step_r < hist) {
+      createStepVectors(step_r);
+      time[step_r] = t_r;
+
+      TACSBVec *vecs[3] = {q[step_r], qdot[step_r], qddot[step_r]};
+      offset += sizeof(int) + sizeof(double);
+      for (int j = 0; j < 3; j++) {
+        TacsScalar *vals;
+        vecs[j]->getArray(&vals);
+        MPI_Offset off = offset + ((MPI_Offset)j * len + range[mpiRank]) *
+                                      sizeof(TacsScalar);
+        MPI_File_read_at_all(fp, off, vals, size, TACS_MPI_TYPE,
+                             MPI_STATUS_IGNORE);
+      }
+
+      if (step_r == step) {
+        found = 1;
+      }
+    }
+  }
+
+  MPI_File_close(&fp);
+  delete[] range;
+
+  if (!found) {
+    fprintf(stderr, "TACSIntegrator: Step %d is not stored in %s\n", step,
+            filename);
+    return 1;
+  }
+
+  // Check that the trailing history window was restored
+  int start = step - hist + 1;
+  if (start < 0) {
+    start = 0;
+  }
+  for (int k = start; k <= step; k++) {
+    if (!q[k]) {
+      fprintf(stderr,
+              "TACSIntegrator: Restart history for step %d missing "
+              "from %s\n",
+              k, filename);
+      return 1;
+    }
+  }
+
+  // Resume from the step following the restored one and rebuild the
+  // Newton solver state
+  restart_step = step;
+  jac_current = 0;
+  num_update_hist = 0;
+
+  // Set the restored states into the assembler
+  assembler->setSimulationTime(time[step]);
+  assembler->setVariables(q[step], qdot[step], qddot[step]);
+
   return 0;
 }
 
@@ -372,7 +990,9 @@ int TACSIntegrator::integrate() {
   Integrate the adjoint equations backwards in time
 */
 void TACSIntegrator::integrateAdjoint() {
-  for (int i = num_time_steps; i >= 0; i--) {
+  // The adjoint variables are identically zero beyond the last plane
+  // with a function contribution, so the sweep starts there
+  for (int i = getLastActivePlane(); i >= 0; i--) {
     initAdjoint(i);
     iterateAdjoint(i, NULL);
     postAdjoint(i);
@@ -388,6 +1008,11 @@ void TACSIntegrator::writeRawSolution(const char *filename, int format) {
 
   if (format == 1) {
     for (int k = 0; k < num_time_steps + 1; k++) {
+      // Skip any steps that are no longer stored in memory
+      if (!q[k]) {
+        continue;
+      }
+
       // Copy over the state values from TACSBVec
       int num_state_vars = q[k]->getArray(&qvals);
       qdot[k]->getArray(&qdotvals);
@@ -414,6 +1039,11 @@ void TACSIntegrator::writeRawSolution(const char *filename, int format) {
         . qddot
       */
       for (int k = 0; k < num_time_steps + 1; k++) {
+        // Skip any steps that are no longer stored in memory
+        if (!q[k]) {
+          continue;
+        }
+
         // Copy over the state values from TACSBVec
         int num_state_vars = q[k]->getArray(&qvals);
         qdot[k]->getArray(&qdotvals);
@@ -437,6 +1067,11 @@ void TACSIntegrator::writeRawSolution(const char *filename, int format) {
     } else {
       // Write the DOFS on user specified element number in final ordering
       for (int k = 0; k < num_time_steps + 1; k++) {
+        // Skip any steps that are no longer stored in memory
+        if (!q[k]) {
+          continue;
+        }
+
         // Copy over the state values from TACSBVec
         int num_state_vars = q[k]->getArray(&qvals);
         qdot[k]->getArray(&qdotvals);
@@ -469,7 +1104,10 @@ void TACSIntegrator::writeRawSolution(const char *filename, int format) {
 */
 void TACSIntegrator::writeSolutionToF5() {
   for (int k = 0; k < num_time_steps + 1; k++) {
-    writeStepToF5(k);
+    // Skip any steps that are no longer stored in memory
+    if (q[k]) {
+      writeStepToF5(k);
+    }
   }
 }
 
@@ -646,6 +1284,11 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
   // Create KSM
   initializeLinearSolver();
 
+  // Start each nonlinear solve from the loosest inner tolerance
+  if (forcing) {
+    forcing->reset();
+  }
+
   // Initialize the update norms
   update_norm = 1.0e99;
 
@@ -663,16 +1306,23 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
   // Track the time taken for newton solve at each time step
   double tnewton = MPI_Wtime();
 
+  // Check whether the factorization from an earlier solve can be lagged
+  int jac_lagged = (use_adaptive_jac && jac_current && !use_lapack);
+
   // Iterate until max iters or R <= tol
   double delta = 0.0;
+  TacsScalar prev_res_norm = 0.0;
   for (niter = 0; niter < max_newton_iters; niter++) {
     // Set the supplied initial input states into TACS
     assembler->setSimulationTime(t);
     assembler->setVariables(u, udot, uddot);
 
-    // Assemble the Jacobian matrix once in Newton iterations
+    // Assemble the Jacobian matrix once in Newton iterations, unless
+    // the factorization is lagged from an earlier solve
+    int assemble_jac = (!jac_lagged && (niter % jac_comp_freq) == 0);
+
     double t0 = MPI_Wtime();
-    if ((niter % jac_comp_freq) == 0) {
+    if (assemble_jac) {
       delta = init_newton_delta * gamma;
       if (niter > 0 && (TacsRealPart(res_norm) < TacsRealPart(init_res_norm))) {
         delta *= TacsRealPart(res_norm / init_res_norm);
@@ -753,6 +1403,39 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
       break;
     }
 
+    // Monitor the contraction of the residual when the Jacobian is
+    // lagged. If the convergence rate has degraded past the threshold,
+    // re-assemble the Jacobian at the current states and re-factor.
+    if (jac_lagged && niter > 0 &&
+        TacsRealPart(res_norm) >
+            jac_contraction_tol * TacsRealPart(prev_res_norm)) {
+      jac_lagged = 0;
+      assemble_jac = 1;
+
+      double ta = MPI_Wtime();
+      delta = init_newton_delta * gamma;
+      if (TacsRealPart(res_norm) < TacsRealPart(init_res_norm)) {
+        delta *= TacsRealPart(res_norm / init_res_norm);
+      }
+
+      TACSMg *mg = dynamic_cast<TACSMg *>(pc);
+      if (mg) {
+        mg->assembleJacobian(alpha, beta, gamma + delta, NULL, TACS_MAT_NORMAL);
+      } else {
+        assembler->assembleJacobian(alpha, beta, gamma + delta, NULL, mat,
+                                    TACS_MAT_NORMAL);
+      }
+      time_fwd_assembly += MPI_Wtime() - ta;
+    }
+    prev_res_norm = res_norm;
+
+    // Choose the inner solve tolerance from the nonlinear residual
+    // history so that early Newton steps are not over-solved
+    if (forcing && !use_lapack) {
+      double eta = forcing->update(res_norm);
+      ksm->setTolerances(eta, 1.0e-30);
+    }
+
     if (use_lapack) {
       if (mpiSize > 1) {
         fprintf(stderr, "TACSIntegrator:: Using LAPACK in parallel!\n");
@@ -762,15 +1445,44 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
     } else {
       // LU Factor the matrix when needed
       double t1 = MPI_Wtime();
-      if ((niter % jac_comp_freq) == 0) {
+      if (assemble_jac) {
         pc->factor();
+        jac_current = 1;
       }
       time_fwd_factor += MPI_Wtime() - t1;
 
-      // Solve for update using KSM
+      // Solve for update using KSM. On the first Newton iteration,
+      // extrapolate the initial guess from the updates computed at
+      // the previous steps
       double t2 = MPI_Wtime();
-      ksm->solve(res, update);
+      int zero_guess = 1;
+      if (use_krylov_predictor && niter == 0 && num_update_hist > 0) {
+        update->copyValues(update_hist[0]);
+        if (num_update_hist > 1) {
+          update->scale(2.0);
+          update->axpy(-1.0, update_hist[1]);
+        }
+        zero_guess = 0;
+      }
+      ksm->solve(res, update, zero_guess);
       time_fwd_apply_factor += MPI_Wtime() - t2;
+
+      // Store the first update of this solve in the predictor history
+      if (use_krylov_predictor && niter == 0) {
+        if (!update_hist[0]) {
+          update_hist[0] = assembler->createVec();
+          update_hist[1] = assembler->createVec();
+          update_hist[0]->incref();
+          update_hist[1]->incref();
+        }
+        TACSBVec *tmp = update_hist[1];
+        update_hist[1] = update_hist[0];
+        update_hist[0] = tmp;
+        update_hist[0]->copyValues(update);
+        if (num_update_hist < 2) {
+          num_update_hist++;
+        }
+      }
     }
 
     // Find the norm of the displacement update
@@ -1157,11 +1869,110 @@ void TACSIntegrator::logTimeStep(int step_num) {
   }
 }
 
+/*
+  Create the state vectors for the given time step if they have not
+  been allocated yet. The vectors are drawn from the snapshot pool
+  when released vectors are available.
+*/
+void TACSIntegrator::createStepVectors(int step_num) {
+  if (!q[step_num]) {
+    q[step_num] = acquireStateVec();
+  }
+  if (!qdot[step_num]) {
+    qdot[step_num] = acquireStateVec();
+  }
+  if (!qddot[step_num]) {
+    qddot[step_num] = acquireStateVec();
+  }
+}
+
+/*
+  Release the state vectors for the given time step back into the
+  snapshot pool
+*/
+void TACSIntegrator::freeStepVectors(int step_num) {
+  releaseStateVec(&q[step_num]);
+  releaseStateVec(&qdot[step_num]);
+  releaseStateVec(&qddot[step_num]);
+}
+
+/*
+  Acquire a state vector for the time history, re-using a vector from
+  the snapshot pool when one is available.
+
+  The pool turns the history management under checkpointing into a
+  pointer rotation: the vectors released as the steps fall behind the
+  multi-step recurrence are handed back out for the incoming steps,
+  so the steady-state marching loop performs no vector allocation.
+  The bytes of each newly created history vector are registered
+  against the per-process memory budget when it is created, so the
+  history storage appears in the budget accounting exactly once.
+*/
+TACSBVec *TACSIntegrator::acquireStateVec() {
+  if (num_pool_vecs > 0) {
+    num_pool_vecs--;
+    TACSBVec *vec = vec_pool[num_pool_vecs];
+    vec->zeroEntries();
+    return vec;
+  }
+
+  TACSBVec *vec = assembler->createVec();
+  vec->incref();
+
+  // Register the memory held by the vector against the budget
+  TacsScalar *array;
+  size_t bytes = sizeof(TacsScalar) * vec->getArray(&array);
+  TacsRegisterAllocation(bytes);
+  pool_bytes += bytes;
+
+  return vec;
+}
+
+/*
+  Return a state vector to the snapshot pool and clear the pointer
+*/
+void TACSIntegrator::releaseStateVec(TACSBVec **vec) {
+  if (*vec) {
+    if (num_pool_vecs == max_pool_vecs) {
+      max_pool_vecs = (max_pool_vecs > 0 ? 2 * max_pool_vecs : 16);
+      TACSBVec **tmp = new TACSBVec *[max_pool_vecs];
+      memcpy(tmp, vec_pool, num_pool_vecs * sizeof(TACSBVec *));
+      if (vec_pool) {
+        delete[] vec_pool;
+      }
+      vec_pool = tmp;
+    }
+    vec_pool[num_pool_vecs] = *vec;
+    num_pool_vecs++;
+    *vec = NULL;
+  }
+}
+
+/*
+  Pre-allocate state vectors into the snapshot pool.
+
+  Allocating the history window in one place keeps the arrays of the
+  history vectors adjacent in memory rather than interleaved with the
+  other allocations made during the marching loop, which improves the
+  TLB behavior of the recurrences that sweep all of them each step.
+*/
+void TACSIntegrator::warmStateVecPool(int count) {
+  TACSBVec **vecs = new TACSBVec *[count];
+  for (int i = 0; i < count; i++) {
+    vecs[i] = acquireStateVec();
+  }
+  for (int i = 0; i < count; i++) {
+    releaseStateVec(&vecs[i]);
+  }
+  delete[] vecs;
+}
+
 /*
   Get the state variables from TACS at the given step
 */
 double TACSIntegrator::getStates(int step_num, TACSBVec **_q, TACSBVec **_qdot,
                                  TACSBVec **_qddot) {
+  createStepVectors(step_num);
   if (_q) {
     *_q = q[step_num];
   }
@@ -1414,8 +2225,20 @@ TACSBDFIntegrator::TACSBDFIntegrator(TACSAssembler *_assembler, double _tinit,
   rhs = NULL;
   psi = NULL;
 
+  // Flag indicating that the forward states are being recomputed from
+  // a checkpoint during the function or adjoint evaluation
+  in_recompute = 0;
+
+  // In-line function integration is off by default
+  inline_funcs = 0;
+  funcs_integrated = 0;
+
   // As many RHS as the number of second derivative coeffs
   num_adjoint_rhs = (2 * max_bdf_order + 1) + 1;
+
+  // Pre-allocate the state history window through the snapshot pool
+  // so that the arrays of the history vectors are allocated together
+  warmStateVecPool(3 * (2 * max_bdf_order + 1));
 }
 
 /*
@@ -1521,11 +2344,162 @@ int TACSBDFIntegrator::getBDFCoeff(const int k, double bdf[], int order) {
   return 0;
 }
 
+/*
+  Compute the spacing between the state snapshots retained in memory
+*/
+int TACSBDFIntegrator::checkpointInterval() {
+  int interval = (num_time_steps + num_checkpoints - 1) / num_checkpoints;
+  if (interval < 1) {
+    interval = 1;
+  }
+  return interval;
+}
+
+/*
+  The number of trailing steps a restart must restore so that the
+  multi-step BDF recurrence resumes at full order
+*/
+int TACSBDFIntegrator::restartHistorySize() { return 2 * max_bdf_order; }
+
+/*
+  Check whether the states at the given step are retained in memory when
+  checkpointing is active.
+
+  The initial conditions are always kept. At each snapshot, the trailing
+  window of 2*max_bdf_order steps is also kept so that the multi-step
+  BDF recurrence can be restarted from the snapshot without altering the
+  order of the scheme.
+*/
+int TACSBDFIntegrator::isStepRetained(int step) {
+  if (step <= 0) {
+    return 1;
+  }
+
+  // Find the closest snapshot at or after this step
+  int interval = checkpointInterval();
+  int ckpt = interval * ((step + interval - 1) / interval);
+
+  return (ckpt <= num_time_steps && ckpt - step < 2 * max_bdf_order);
+}
+
+/*
+  Recompute the states at the given step by re-integrating forward from
+  the closest step that is still stored in memory. The recomputed states
+  are kept in memory until they are explicitly freed.
+*/
+void TACSBDFIntegrator::restoreStates(int k) {
+  if (q[k] && qdot[k] && qddot[k]) {
+    return;
+  }
+
+  // March back to the closest stored step
+  int start = k;
+  while (start > 0 && !q[start]) {
+    start--;
+  }
+
+  // Re-run the forward integration over the missing segment
+  in_recompute = 1;
+  for (int i = start + 1; i <= k; i++) {
+    iterate(i, NULL);
+  }
+  in_recompute = 0;
+}
+
 /*
   March one step and exit the integration. This is primarily for use
   with FUNtoFEM.
 */
+/*
+  Integrate the functions of interest within the forward time loop.
+
+  The Newton solves form the only sequential dependency chain in the
+  forward problem. With this option enabled, the function quadrature
+  for each time step is performed immediately after its Newton solve,
+  while the converged states are already set in the assembler, and
+  evalFunctions only finalizes the reduction. This eliminates the
+  separate sweep over the stored state history, and with checkpointing
+  enabled it avoids recomputing the dropped states altogether. Only
+  single-stage functions can be integrated in-line; two-stage functions
+  fall back to the post-processing sweep.
+*/
+void TACSBDFIntegrator::setInlineFunctionEvaluation(int flag) {
+  inline_funcs = flag;
+}
+
+/*
+  Add the function contributions from the step that was just solved
+*/
+void TACSBDFIntegrator::integrateStepFunctions(int k) {
+  if (!inline_funcs || num_funcs == 0) {
+    return;
+  }
+
+  // The in-line path can only handle single-stage functions
+  for (int n = 0; n < num_funcs; n++) {
+    if (funcs[n] && funcs[n]->getStageType() == TACSFunction::TWO_STAGE) {
+      return;
+    }
+  }
+
+  // Skip the steps that fall outside the evaluation time window
+  if (use_func_windows) {
+    int active = 0;
+    for (int n = 0; n < num_funcs; n++) {
+      if (funcs[n] && getFunctionTimeCoeff(n, k) != 0.0) {
+        active = 1;
+        break;
+      }
+    }
+    if (!active) {
+      return;
+    }
+  } else if (k < start_plane || k > end_plane) {
+    return;
+  }
+
+  // Initialize the integration pass with the first contribution
+  if (!funcs_integrated) {
+    for (int n = 0; n < num_funcs; n++) {
+      if (funcs[n]) {
+        funcs[n]->initEvaluation(TACSFunction::INTEGRATE);
+      }
+    }
+    funcs_integrated = 1;
+  }
+
+  // Reset the states so that the quadrature does not depend on the
+  // exit path taken by the Newton solve
+  assembler->setSimulationTime(time[k]);
+  assembler->setVariables(q[k], qdot[k], qddot[k]);
+
+  // Integrate the functions with the same trapezoidal time coefficient
+  // used by the post-processing sweep
+  if (use_func_windows) {
+    for (int n = 0; n < num_funcs; n++) {
+      double tcoeff = getFunctionTimeCoeff(n, k);
+      if (funcs[n] && tcoeff != 0.0) {
+        assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, 1,
+                                      &funcs[n]);
+      }
+    }
+  } else {
+    double tcoeff = 0.0;
+    if (k > start_plane && k <= end_plane) {
+      tcoeff += 0.5 * (time[k] - time[k - 1]);
+    }
+    if (k >= start_plane && k < end_plane) {
+      tcoeff += 0.5 * (time[k + 1] - time[k]);
+    }
+    assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, num_funcs,
+                                  funcs);
+  }
+}
+
 int TACSBDFIntegrator::iterate(int k, TACSBVec *forces) {
+  // Create the state vectors for this step if they are not allocated
+  createStepVectors(k);
+
   if (k == 0) {
     // Output the results at the initial condition if configured
     printOptionSummary();
@@ -1538,6 +2512,13 @@ int TACSBDFIntegrator::iterate(int k, TACSBVec *forces) {
     // Solve for acceleration and set into TACS
     logTimeStep(k);
 
+    // Restart the in-line function integration pass and add the
+    // contribution from the initial condition
+    if (!in_recompute) {
+      funcs_integrated = 0;
+      integrateStepFunctions(0);
+    }
+
     return 0;
   }
 
@@ -1548,6 +2529,17 @@ int TACSBDFIntegrator::iterate(int k, TACSBVec *forces) {
   q[k]->axpy(h, qdot[k - 1]);
   q[k]->axpy(0.5 * h * h, qddot[k - 1]);
 
+  // Add the third-order term of the predictor using the backward
+  // difference of the accelerations from the previous two steps
+  if (k >= 2) {
+    double hp = time[k - 1] - time[k - 2];
+    if (hp > 0.0) {
+      double scale = h * h * h / (6.0 * hp);
+      q[k]->axpy(scale, qddot[k - 1]);
+      q[k]->axpy(-scale, qddot[k - 2]);
+    }
+  }
+
   // Get the BDF coefficients
   int nbdf, nbddf;
   double bdf_coeff[4];
@@ -1585,8 +2577,23 @@ int TACSBDFIntegrator::iterate(int k, TACSBVec *forces) {
   int newton_term =
       newtonSolve(alpha, beta, gamma, time[k], q[k], qdot[k], qddot[k], forces);
 
-  // Tecplot output and print related stuff as configured
-  logTimeStep(k);
+  // Tecplot output and print related stuff as configured. Skip the
+  // output when re-running steps that have already been reported.
+  if (!in_recompute) {
+    integrateStepFunctions(k);
+    logTimeStep(k);
+  }
+
+  // With checkpointing enabled, release the states that have fallen
+  // behind the BDF recurrence and are not part of a retained snapshot.
+  // During a recomputation the states are kept so that the backward
+  // sweep can consume them.
+  if (num_checkpoints > 0 && !in_recompute) {
+    int drop = k - 2 * max_bdf_order;
+    if (drop > 0 && !isStepRetained(drop)) {
+      freeStepVectors(drop);
+    }
+  }
 
   // Return a non-zero flag when the Newton iteration fails
   int fail = 0;
@@ -1600,8 +2607,26 @@ int TACSBDFIntegrator::iterate(int k, TACSBVec *forces) {
   Evaluate the functions of interest
 */
 void TACSBDFIntegrator::evalFunctions(TacsScalar *fvals) {
-  // TODO: integrate functions as the forward problem is integrated
-  //  Check whether these are two-stage or single-stage functions
+  // If the functions were integrated step-by-step within the forward
+  // loop, finish the integration pass and retrieve the values directly
+  if (funcs_integrated) {
+    for (int n = 0; n < num_funcs; n++) {
+      if (funcs[n]) {
+        funcs[n]->finalEvaluation(TACSFunction::INTEGRATE);
+      }
+    }
+    funcs_integrated = 0;
+
+    for (int n = 0; n < num_funcs; n++) {
+      fvals[n] = 0.0;
+      if (funcs[n]) {
+        fvals[n] = funcs[n]->getFunctionValue();
+      }
+    }
+    return;
+  }
+
+  // Check whether these are two-stage or single-stage functions
   int twoStage = 0;
   for (int n = 0; n < num_funcs; n++) {
     if (funcs[n] && funcs[n]->getStageType() == TACSFunction::TWO_STAGE) {
@@ -1620,19 +2645,42 @@ void TACSBDFIntegrator::evalFunctions(TacsScalar *fvals) {
     }
 
     for (int k = start_plane; k <= end_plane; k++) {
+      // Recompute the states for this step if they were dropped
+      if (num_checkpoints > 0) {
+        restoreStates(k);
+      }
+
       // Set the stages
       assembler->setSimulationTime(time[k]);
       assembler->setVariables(q[k], qdot[k], qddot[k]);
 
-      double tcoeff = 0.0;
-      if (k > start_plane && k <= end_plane) {
-        tcoeff += 0.5 * (time[k] - time[k - 1]);
+      if (use_func_windows) {
+        for (int n = 0; n < num_funcs; n++) {
+          double tcoeff = getFunctionTimeCoeff(n, k);
+          if (funcs[n] && tcoeff != 0.0) {
+            assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE, 1,
+                                          &funcs[n]);
+          }
+        }
+      } else {
+        double tcoeff = 0.0;
+        if (k > start_plane && k <= end_plane) {
+          tcoeff += 0.5 * (time[k] - time[k - 1]);
+        }
+        if (k >= start_plane && k < end_plane) {
+          tcoeff += 0.5 * (time[k + 1] - time[k]);
+        }
+        assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE,
+                                      num_funcs, funcs);
       }
-      if (k >= start_plane && k < end_plane) {
-        tcoeff += 0.5 * (time[k + 1] - time[k]);
+
+      // Release the states that fall outside the retained snapshots
+      if (num_checkpoints > 0) {
+        int drop = k - 2 * max_bdf_order;
+        if (drop > 0 && !isStepRetained(drop)) {
+          freeStepVectors(drop);
+        }
       }
-      assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE, num_funcs,
-                                    funcs);
     }
 
     for (int n = 0; n < num_funcs; n++) {
@@ -1650,18 +2698,41 @@ void TACSBDFIntegrator::evalFunctions(TacsScalar *fvals) {
   }
 
   for (int k = start_plane; k <= end_plane; k++) {
+    // Recompute the states for this step if they were dropped
+    if (num_checkpoints > 0) {
+      restoreStates(k);
+    }
+
     assembler->setSimulationTime(time[k]);
     assembler->setVariables(q[k], qdot[k], qddot[k]);
 
-    double tcoeff = 0.0;
-    if (k > start_plane && k <= end_plane) {
-      tcoeff += 0.5 * (time[k] - time[k - 1]);
+    if (use_func_windows) {
+      for (int n = 0; n < num_funcs; n++) {
+        double tcoeff = getFunctionTimeCoeff(n, k);
+        if (funcs[n] && tcoeff != 0.0) {
+          assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, 1,
+                                        &funcs[n]);
+        }
+      }
+    } else {
+      double tcoeff = 0.0;
+      if (k > start_plane && k <= end_plane) {
+        tcoeff += 0.5 * (time[k] - time[k - 1]);
+      }
+      if (k >= start_plane && k < end_plane) {
+        tcoeff += 0.5 * (time[k + 1] - time[k]);
+      }
+      assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, num_funcs,
+                                    funcs);
     }
-    if (k >= start_plane && k < end_plane) {
-      tcoeff += 0.5 * (time[k + 1] - time[k]);
+
+    // Release the states that fall outside the retained snapshots
+    if (num_checkpoints > 0) {
+      int drop = k - 2 * max_bdf_order;
+      if (drop > 0 && !isStepRetained(drop)) {
+        freeStepVectors(drop);
+      }
     }
-    assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, num_funcs,
-                                  funcs);
   }
 
   for (int n = 0; n < num_funcs; n++) {
@@ -1746,16 +2817,6 @@ void TACSBDFIntegrator::initAdjoint(int k) {
     double bddf_coeff[9];
     get2ndBDFCoeff(k, bdf_coeff, &nbdf, bddf_coeff, &nbddf, max_bdf_order);
 
-    // Compute the time coefficient for the integral of
-    // the functional
-    double tcoeff = 0.0;
-    if (k > start_plane && k <= end_plane) {
-      tcoeff += 0.5 * (time[k] - time[k - 1]);
-    }
-    if (k >= start_plane && k < end_plane) {
-      tcoeff += 0.5 * (time[k + 1] - time[k]);
-    }
-
     // Determine the linearization coefficients for Jacobian Assembly
     double alpha = 1.0;
     double beta = bdf_coeff[0];
@@ -1764,14 +2825,14 @@ void TACSBDFIntegrator::initAdjoint(int k) {
     // Find the adjoint index
     int adj_index = k % num_adjoint_rhs;
 
-    // Setup the adjoint RHS
-    if (k >= start_plane && k <= end_plane) {
-      for (int n = 0; n < num_funcs; n++) {
-        if (funcs[n]) {
-          // Add up the contribution from function state derivative to RHS
-          assembler->addSVSens(tcoeff, 0.0, 0.0, 1, &funcs[n],
-                               &rhs[adj_index * num_funcs + n]);
-        }
+    // Setup the adjoint RHS using the trapezoidal time coefficient for
+    // the integral of each functional over its evaluation window
+    for (int n = 0; n < num_funcs; n++) {
+      double tcoeff = getFunctionTimeCoeff(n, k);
+      if (funcs[n] && tcoeff != 0.0) {
+        // Add up the contribution from function state derivative to RHS
+        assembler->addSVSens(tcoeff, 0.0, 0.0, 1, &funcs[n],
+                             &rhs[adj_index * num_funcs + n]);
       }
     }
 
@@ -1797,6 +2858,9 @@ void TACSBDFIntegrator::initAdjoint(int k) {
     double tfactor = MPI_Wtime();
     pc->factor();
     time_rev_factor += MPI_Wtime() - tfactor;
+
+    // The transpose factorization cannot be re-used by the forward solve
+    jac_current = 0;
   }
 }
 
@@ -1839,16 +2903,26 @@ void TACSBDFIntegrator::postAdjoint(int k) {
     rhs[adj_index * num_funcs + n]->zeroEntries();
   }
 
-  double tcoeff = 0.0;
-  if (k > start_plane && k <= end_plane) {
-    tcoeff += 0.5 * (time[k] - time[k - 1]);
-  }
-  if (k >= start_plane && k < end_plane) {
-    tcoeff += 0.5 * (time[k + 1] - time[k]);
-  }
-  if (k >= start_plane && k <= end_plane) {
-    assembler->addDVSens(tcoeff, num_funcs, funcs, dfdx);
-    assembler->addXptSens(tcoeff, num_funcs, funcs, dfdXpt);
+  if (use_func_windows) {
+    for (int n = 0; n < num_funcs; n++) {
+      double tcoeff = getFunctionTimeCoeff(n, k);
+      if (funcs[n] && tcoeff != 0.0) {
+        assembler->addDVSens(tcoeff, 1, &funcs[n], &dfdx[n]);
+        assembler->addXptSens(tcoeff, 1, &funcs[n], &dfdXpt[n]);
+      }
+    }
+  } else {
+    double tcoeff = 0.0;
+    if (k > start_plane && k <= end_plane) {
+      tcoeff += 0.5 * (time[k] - time[k - 1]);
+    }
+    if (k >= start_plane && k < end_plane) {
+      tcoeff += 0.5 * (time[k + 1] - time[k]);
+    }
+    if (k >= start_plane && k <= end_plane) {
+      assembler->addDVSens(tcoeff, num_funcs, funcs, dfdx);
+      assembler->addXptSens(tcoeff, num_funcs, funcs, dfdXpt);
+    }
   }
 
   if (k > 0) {
@@ -1909,6 +2983,39 @@ void TACSBDFIntegrator::getAdjoint(int step_num, int func_num,
   *adjoint = psi[func_num];
 }
 
+/*
+  Integrate the adjoint equations backwards in time.
+
+  When checkpointing is active, the forward states for each step are
+  recomputed on demand from the closest retained snapshot. Each
+  recomputed segment remains in memory until the backward sweep has
+  passed over it, so that at most one segment of intermediate states is
+  stored at any time in addition to the snapshots.
+*/
+void TACSBDFIntegrator::integrateAdjoint() {
+  if (num_checkpoints <= 0) {
+    TACSIntegrator::integrateAdjoint();
+    return;
+  }
+
+  // Skip the planes beyond the last function contribution - the
+  // adjoint variables are identically zero there
+  for (int k = getLastActivePlane(); k >= 0; k--) {
+    // Recompute the forward states for this step if they were dropped
+    // during the forward integration
+    restoreStates(k);
+
+    initAdjoint(k);
+    iterateAdjoint(k, NULL);
+    postAdjoint(k);
+
+    // The backward sweep will not revisit this step - release it
+    if (k > 0) {
+      freeStepVectors(k);
+    }
+  }
+}
+
 /*
   Constructor for TACSDIRKIntegrator
 
@@ -1931,6 +3038,10 @@ TACSDIRKIntegrator::TACSDIRKIntegrator(TACSAssembler *_tacs, double _tinit,
   // Set the number of stages
   num_stages = _num_stages;
 
+  // By default, evaluate the functions in a sweep over the stage history
+  inline_funcs = 0;
+  funcs_integrated = 0;
+
   // allocate space for stage state variables
   qS = new TACSBVec *[num_stages * num_time_steps];
   qdotS = new TACSBVec *[num_stages * num_time_steps];
@@ -2166,16 +3277,100 @@ int TACSDIRKIntegrator::getRowIndex(int stageNum) {
   return stageNum * (stageNum + 1) / 2;
 }
 
+/*
+  Integrate the functions of interest within the forward stage loop.
+
+  The implicit stage solves are the only sequential dependency chain in
+  the DIRK scheme. With this option enabled, the function quadrature for
+  each stage is performed immediately after its stage solve, while the
+  stage states are already set in the assembler, and evalFunctions only
+  finalizes the reduction. This removes the separate sweep over the
+  stored stage history. Only single-stage functions can be integrated
+  in-line; two-stage functions fall back to the post-processing sweep.
+*/
+void TACSDIRKIntegrator::setInlineFunctionEvaluation(int flag) {
+  inline_funcs = flag;
+}
+
+/*
+  Add the function contributions from the stage that was just solved
+*/
+void TACSDIRKIntegrator::integrateStageFunctions(int k, int stage) {
+  if (!inline_funcs || num_funcs == 0) {
+    return;
+  }
+
+  // The in-line path can only handle single-stage functions
+  for (int n = 0; n < num_funcs; n++) {
+    if (funcs[n] && funcs[n]->getStageType() == TACSFunction::TWO_STAGE) {
+      return;
+    }
+  }
+
+  // The stages of step k span the interval [k-1, k]
+  if (use_func_windows) {
+    int active = 0;
+    for (int n = 0; n < num_funcs; n++) {
+      if (funcs[n] && isFunctionIntervalActive(n, k - 1)) {
+        active = 1;
+        break;
+      }
+    }
+    if (!active) {
+      return;
+    }
+  } else if (k - 1 < start_plane || k - 1 >= end_plane) {
+    return;
+  }
+
+  // Initialize the integration pass with the first contribution
+  if (!funcs_integrated) {
+    for (int n = 0; n < num_funcs; n++) {
+      if (funcs[n]) {
+        funcs[n]->initEvaluation(TACSFunction::INTEGRATE);
+      }
+    }
+    funcs_integrated = 1;
+  }
+
+  // Reset the stage states so that the quadrature does not depend on
+  // the exit path taken by the Newton solve
+  double h = time[k] - time[k - 1];
+  double tS = time[k - 1] + c[stage] * h;
+  int offset = (k - 1) * num_stages + stage;
+  assembler->setSimulationTime(tS);
+  assembler->setVariables(qS[offset], qdotS[offset], qddotS[offset]);
+
+  // Integrate the functions with the stage quadrature weight
+  if (use_func_windows) {
+    for (int n = 0; n < num_funcs; n++) {
+      if (funcs[n] && isFunctionIntervalActive(n, k - 1)) {
+        assembler->integrateFunctions(h * b[stage], TACSFunction::INTEGRATE, 1,
+                                      &funcs[n]);
+      }
+    }
+  } else {
+    assembler->integrateFunctions(h * b[stage], TACSFunction::INTEGRATE,
+                                  num_funcs, funcs);
+  }
+}
+
 /*
   Integration logic of DIRK. Use this function to march in time. The
   solution over time is set into the class variables q, qdot and qddot
   and time.
 */
 int TACSDIRKIntegrator::iterate(int k, TACSBVec *forces) {
+  // Create the state vectors for this step if they are not allocated
+  createStepVectors(k);
+
   if (k == 0) {
     // Output the results at the initial condition if configured
     printOptionSummary();
 
+    // Restart the in-line function integration pass
+    funcs_integrated = 0;
+
     // Retrieve the initial conditions and set into TACS
     assembler->getInitConditions(q[0], qdot[0], qddot[0]);
     assembler->setBCs(q[0]);  // Set the Dirichlet BCs
@@ -2239,6 +3434,10 @@ int TACSDIRKIntegrator::iterate(int k, TACSBVec *forces) {
       fail = 1;
       return fail;
     }
+
+    // Add the function contributions from this stage if the in-line
+    // evaluation is enabled
+    integrateStageFunctions(k, stage);
   }
 
   // Compute the state varialbes at the current time step using the
@@ -2272,12 +3471,18 @@ int TACSDIRKIntegrator::iterate(int k, TACSBVec *forces) {
    while the stage states are saved to the qS, qdotS, and qddotS variables.
  */
 int TACSDIRKIntegrator::iterateStage(int k, int s, TACSBVec *forces) {
+  // Create the state vectors for this step if they are not allocated
+  createStepVectors(k);
+
   // For the 0th time step, get the initial conditions and solve for the
   // unknown states
   if (k == 0) {
     // Output the results at the initial condition if configured
     printOptionSummary();
 
+    // Restart the in-line function integration pass
+    funcs_integrated = 0;
+
     // TODO: getInitConditions() always returns zeros, even for nonzero entries
     // fix getInitConditions() implementation
 
@@ -2341,6 +3546,10 @@ int TACSDIRKIntegrator::iterateStage(int k, int s, TACSBVec *forces) {
     return fail;
   }
 
+  // Add the function contributions from this stage if the in-line
+  // evaluation is enabled
+  integrateStageFunctions(k, s);
+
   // if its the final stage, update the state vectors using all the stage
   // information associated with the current time step
   if (s == num_stages - 1) {
@@ -2370,6 +3579,25 @@ int TACSDIRKIntegrator::iterateStage(int k, int s, TACSBVec *forces) {
   Evaluate the functions of interest
 */
 void TACSDIRKIntegrator::evalFunctions(TacsScalar *fvals) {
+  // If the functions were integrated within the forward stage loop,
+  // finish the integration pass and retrieve the values directly
+  if (funcs_integrated) {
+    for (int n = 0; n < num_funcs; n++) {
+      if (funcs[n]) {
+        funcs[n]->finalEvaluation(TACSFunction::INTEGRATE);
+      }
+    }
+    funcs_integrated = 0;
+
+    for (int n = 0; n < num_funcs; n++) {
+      fvals[n] = 0.0;
+      if (funcs[n]) {
+        fvals[n] = funcs[n]->getFunctionValue();
+      }
+    }
+    return;
+  }
+
   // Check whether these are two-stage or single-stage functions
   int twoStage = 0;
   for (int n = 0; n < num_funcs; n++) {
@@ -2404,8 +3632,17 @@ void TACSDIRKIntegrator::evalFunctions(TacsScalar *fvals) {
         double tcoeff = h * b[stage];
 
         // Integrate the functions
-        assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE,
-                                      num_funcs, funcs);
+        if (use_func_windows) {
+          for (int n = 0; n < num_funcs; n++) {
+            if (funcs[n] && isFunctionIntervalActive(n, k)) {
+              assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE,
+                                            1, &funcs[n]);
+            }
+          }
+        } else {
+          assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE,
+                                        num_funcs, funcs);
+        }
       }
     }
 
@@ -2439,8 +3676,17 @@ void TACSDIRKIntegrator::evalFunctions(TacsScalar *fvals) {
       double tcoeff = h * b[stage];
 
       // Integrate the functions
-      assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, num_funcs,
-                                    funcs);
+      if (use_func_windows) {
+        for (int n = 0; n < num_funcs; n++) {
+          if (funcs[n] && isFunctionIntervalActive(n, k)) {
+            assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, 1,
+                                          &funcs[n]);
+          }
+        }
+      } else {
+        assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE,
+                                      num_funcs, funcs);
+      }
     }
   }
 
@@ -2562,8 +3808,20 @@ void TACSDIRKIntegrator::iterateAdjoint(int k, TACSBVec **adj_rhs) {
     // Factor the preconditioner
     pc->factor();
 
+    // The transpose factorization cannot be re-used by the forward solve
+    jac_current = 0;
+
     // Compute the derivatives and store them
-    if (k > start_plane && k <= end_plane) {
+    if (use_func_windows) {
+      for (int n = 0; n < num_funcs; n++) {
+        if (funcs[n] && isFunctionIntervalActive(n, k - 1)) {
+          assembler->addSVSens(1.0, 0.0, 0.0, 1, &funcs[n],
+                               &omega[num_funcs * stage + n]);
+          assembler->addSVSens(0.0, 1.0, 0.0, 1, &funcs[n],
+                               &domega[num_funcs * stage + n]);
+        }
+      }
+    } else if (k > start_plane && k <= end_plane) {
       assembler->addSVSens(1.0, 0.0, 0.0, num_funcs, funcs,
                            &omega[num_funcs * stage]);
       assembler->addSVSens(0.0, 1.0, 0.0, num_funcs, funcs,
@@ -2636,7 +3894,14 @@ void TACSDIRKIntegrator::postAdjoint(int k) {
       assembler->setVariables(qS[offset], qdotS[offset], qddotS[offset]);
 
       double tcoeff = h * b[stage];
-      if (k > start_plane && k <= end_plane) {
+      if (use_func_windows) {
+        for (int n = 0; n < num_funcs; n++) {
+          if (funcs[n] && isFunctionIntervalActive(n, k - 1)) {
+            assembler->addDVSens(tcoeff, 1, &funcs[n], &dfdx[n]);
+            assembler->addXptSens(tcoeff, 1, &funcs[n], &dfdXpt[n]);
+          }
+        }
+      } else if (k > start_plane && k <= end_plane) {
         assembler->addDVSens(tcoeff, num_funcs, funcs, dfdx);
         assembler->addXptSens(tcoeff, num_funcs, funcs, dfdXpt);
       }
@@ -3067,6 +4332,9 @@ void TACSESDIRKIntegrator::getLinearizationCoeffs(const int stage,
   time.
 */
 int TACSESDIRKIntegrator::iterate(int k, TACSBVec *forces) {
+  // Create the state vectors for this step if they are not allocated
+  createStepVectors(k);
+
   if (k == 0) {
     // Output the results at the initial condition if configured
     printOptionSummary();
@@ -3174,6 +4442,9 @@ int TACSESDIRKIntegrator::iterate(int k, TACSBVec *forces) {
   evaluated at each stage are set to qS, qdotS, qddotS.
 */
 int TACSESDIRKIntegrator::iterateStage(int k, int s, TACSBVec *forces) {
+  // Create the state vectors for this step if they are not allocated
+  createStepVectors(k);
+
   if (k == 0 && s == 0) {
     // Output the results at the initial condition if configured
     printOptionSummary();
@@ -3319,8 +4590,17 @@ void TACSESDIRKIntegrator::evalFunctions(TacsScalar *fvals) {
         double tcoeff = h * b[stage];
 
         // integrate the functions
-        assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE,
-                                      num_funcs, funcs);
+        if (use_func_windows) {
+          for (int n = 0; n < num_funcs; n++) {
+            if (funcs[n] && isFunctionIntervalActive(n, k)) {
+              assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE,
+                                            1, &funcs[n]);
+            }
+          }
+        } else {
+          assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE,
+                                        num_funcs, funcs);
+        }
       }
     }
 
@@ -3350,8 +4630,17 @@ void TACSESDIRKIntegrator::evalFunctions(TacsScalar *fvals) {
       double tcoeff = h * b[stage];
 
       // integrate the functions
-      assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, num_funcs,
-                                    funcs);
+      if (use_func_windows) {
+        for (int n = 0; n < num_funcs; n++) {
+          if (funcs[n] && isFunctionIntervalActive(n, k)) {
+            assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, 1,
+                                          &funcs[n]);
+          }
+        }
+      } else {
+        assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE,
+                                      num_funcs, funcs);
+      }
     }
   }
 
@@ -3414,4 +4703,264 @@ double TACSESDIRKIntegrator::getStageStates(int step_num, int stage_num,
 
     return tS;
   }
-}
\ No newline at end of file
+}
+/*
+  Constructor for the generalized-alpha integration scheme
+
+  Input:
+  tinit:     the initial time
+  tfinal:    the final time
+  num_steps: the number of steps to take for each second
+  rho_inf:   the spectral radius at the high-frequency limit
+*/
+TACSGAlphaIntegrator::TACSGAlphaIntegrator(TACSAssembler *_assembler,
+                                           double _tinit, double _tfinal,
+                                           double _num_steps, double _rho_inf)
+    : TACSIntegrator(_assembler, _tinit, _tfinal, _num_steps) {
+  if (mpiRank == 0) {
+    fprintf(logfp, "[%d] Creating TACSIntegrator of type %s rho_inf %f\n",
+            mpiRank, "GeneralizedAlpha", _rho_inf);
+  }
+
+  // Truncate the spectral radius to [0, 1]
+  rho_inf = _rho_inf;
+  if (rho_inf < 0.0) {
+    rho_inf = 0.0;
+  } else if (rho_inf > 1.0) {
+    rho_inf = 1.0;
+  }
+
+  // Set the algorithmic parameters of Chung and Hulbert for optimal
+  // high-frequency dissipation at second-order accuracy
+  alpha_m = (2.0 * rho_inf - 1.0) / (rho_inf + 1.0);
+  alpha_f = rho_inf / (rho_inf + 1.0);
+  nm_gamma = 0.5 - alpha_m + alpha_f;
+  nm_beta = 0.25 * (1.0 - alpha_m + alpha_f) * (1.0 - alpha_m + alpha_f);
+
+  // Allocate the intermediate state vectors
+  qa = assembler->createVec();
+  qa->incref();
+  qdota = assembler->createVec();
+  qdota->incref();
+  qddota = assembler->createVec();
+  qddota->incref();
+
+  // The linearization coefficients are constant since the time step
+  // is fixed, so the factored Jacobian from the first step remains
+  // exact for linear problems. Enable the adaptive re-use of the
+  // factorization by default - the contraction monitor within the
+  // Newton solve re-factors when the problem is nonlinear.
+  use_adaptive_jac = 1;
+}
+
+/*
+  Free the data allocated by this class
+*/
+TACSGAlphaIntegrator::~TACSGAlphaIntegrator() {
+  qa->decref();
+  qdota->decref();
+  qddota->decref();
+}
+
+/*
+  Integration logic for the generalized-alpha scheme. Use this
+  function to march in time. The solution over time is set into the
+  class variables q, qdot and qddot.
+*/
+int TACSGAlphaIntegrator::iterate(int k, TACSBVec *forces) {
+  // Create the state vectors for this step if they are not allocated
+  createStepVectors(k);
+
+  if (k == 0) {
+    // Output the results at the initial condition if configured
+    printOptionSummary();
+
+    // Retrieve the initial conditions and set into TACS
+    assembler->getInitConditions(q[0], qdot[0], qddot[0]);
+    assembler->setBCs(q[0]);  // Set the Dirichlet BCs
+    assembler->setVariables(q[0], qdot[0], qddot[0]);
+
+    // Perform logging, tecplot export, etc.
+    logTimeStep(k);
+
+    return 0;
+  }
+
+  // The time step
+  double h = time[k] - time[k - 1];
+
+  // Predict the states with constant acceleration. This satisfies the
+  // Newmark update formulas exactly so that the Newton corrections,
+  // which are applied in the same fixed proportions, preserve them.
+  qddot[k]->copyValues(qddot[k - 1]);
+  qdot[k]->copyValues(qdot[k - 1]);
+  qdot[k]->axpy(h, qddot[k - 1]);
+  q[k]->copyValues(q[k - 1]);
+  q[k]->axpy(h, qdot[k - 1]);
+  q[k]->axpy(0.5 * h * h, qddot[k - 1]);
+
+  // Form the alpha-weighted intermediate states. The residual is
+  // evaluated at the time t(k) - alpha_f*h with the displacements and
+  // velocities weighted by alpha_f and the accelerations by alpha_m.
+  double ta = (1.0 - alpha_f) * time[k] + alpha_f * time[k - 1];
+
+  qa->copyValues(q[k]);
+  qa->scale(1.0 - alpha_f);
+  qa->axpy(alpha_f, q[k - 1]);
+
+  qdota->copyValues(qdot[k]);
+  qdota->scale(1.0 - alpha_f);
+  qdota->axpy(alpha_f, qdot[k - 1]);
+
+  qddota->copyValues(qddot[k]);
+  qddota->scale(1.0 - alpha_m);
+  qddota->axpy(alpha_m, qddot[k - 1]);
+
+  // Determine the coefficients for linearizing the residual. The
+  // primary unknown is the acceleration at the end of the step: a
+  // change dw in qddot(k) changes the intermediate states by
+  // (1 - alpha_f)*beta*h^2*dw, (1 - alpha_f)*gamma*h*dw and
+  // (1 - alpha_m)*dw through the Newmark formulas. With the fixed
+  // time step these coefficients are identical for every step.
+  double alpha = (1.0 - alpha_f) * nm_beta * h * h;
+  double beta = (1.0 - alpha_f) * nm_gamma * h;
+  double gamma = 1.0 - alpha_m;
+
+  // Solve the nonlinear system at the intermediate states
+  int newton_term =
+      newtonSolve(alpha, beta, gamma, ta, qa, qdota, qddota, forces);
+
+  // Recover the end-of-step states from the converged intermediate
+  // states
+  q[k]->copyValues(qa);
+  q[k]->axpy(-alpha_f, q[k - 1]);
+  q[k]->scale(1.0 / (1.0 - alpha_f));
+
+  qdot[k]->copyValues(qdota);
+  qdot[k]->axpy(-alpha_f, qdot[k - 1]);
+  qdot[k]->scale(1.0 / (1.0 - alpha_f));
+
+  qddot[k]->copyValues(qddota);
+  qddot[k]->axpy(-alpha_m, qddot[k - 1]);
+  qddot[k]->scale(1.0 / (1.0 - alpha_m));
+
+  // Perform logging, tecplot export, etc.
+  logTimeStep(k);
+
+  // Return a non-zero flag when the Newton iteration fails
+  int fail = 0;
+  if (newton_term < 0) {
+    fail = 1;
+  }
+  return fail;
+}
+
+/*
+  Evaluate the functions of interest
+*/
+void TACSGAlphaIntegrator::evalFunctions(TacsScalar *fvals) {
+  // Check whether these are two-stage or single-stage functions
+  int twoStage = 0;
+  for (int n = 0; n < num_funcs; n++) {
+    if (funcs[n] && funcs[n]->getStageType() == TACSFunction::TWO_STAGE) {
+      twoStage = 1;
+      break;
+    }
+  }
+
+  // Initialize the function if had already not been initialized
+  if (twoStage) {
+    // First stage
+    for (int n = 0; n < num_funcs; n++) {
+      if (funcs[n]) {
+        funcs[n]->initEvaluation(TACSFunction::INITIALIZE);
+      }
+    }
+
+    for (int k = start_plane; k <= end_plane; k++) {
+      // Set the stages
+      assembler->setSimulationTime(time[k]);
+      assembler->setVariables(q[k], qdot[k], qddot[k]);
+
+      if (use_func_windows) {
+        for (int n = 0; n < num_funcs; n++) {
+          double tcoeff = getFunctionTimeCoeff(n, k);
+          if (funcs[n] && tcoeff != 0.0) {
+            assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE, 1,
+                                          &funcs[n]);
+          }
+        }
+      } else {
+        double tcoeff = 0.0;
+        if (k > start_plane && k <= end_plane) {
+          tcoeff += 0.5 * (time[k] - time[k - 1]);
+        }
+        if (k >= start_plane && k < end_plane) {
+          tcoeff += 0.5 * (time[k + 1] - time[k]);
+        }
+        assembler->integrateFunctions(tcoeff, TACSFunction::INITIALIZE,
+                                      num_funcs, funcs);
+      }
+    }
+
+    for (int n = 0; n < num_funcs; n++) {
+      if (funcs[n]) {
+        funcs[n]->finalEvaluation(TACSFunction::INITIALIZE);
+      }
+    }
+  }
+
+  // Second stage
+  for (int n = 0; n < num_funcs; n++) {
+    if (funcs[n]) {
+      funcs[n]->initEvaluation(TACSFunction::INTEGRATE);
+    }
+  }
+
+  for (int k = start_plane; k <= end_plane; k++) {
+    assembler->setSimulationTime(time[k]);
+    assembler->setVariables(q[k], qdot[k], qddot[k]);
+
+    if (use_func_windows) {
+      for (int n = 0; n < num_funcs; n++) {
+        double tcoeff = getFunctionTimeCoeff(n, k);
+        if (funcs[n] && tcoeff != 0.0) {
+          assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, 1,
+                                        &funcs[n]);
+        }
+      }
+    } else {
+      double tcoeff = 0.0;
+      if (k > start_plane && k <= end_plane) {
+        tcoeff += 0.5 * (time[k] - time[k - 1]);
+      }
+      if (k >= start_plane && k < end_plane) {
+        tcoeff += 0.5 * (time[k + 1] - time[k]);
+      }
+      assembler->integrateFunctions(tcoeff, TACSFunction::INTEGRATE, num_funcs,
+                                    funcs);
+    }
+  }
+
+  for (int n = 0; n < num_funcs; n++) {
+    if (funcs[n]) {
+      funcs[n]->finalEvaluation(TACSFunction::INTEGRATE);
+    }
+  }
+
+  // Retrieve the function values
+  for (int n = 0; n < num_funcs; n++) {
+    fvals[n] = 0.0;
+    if (funcs[n]) {
+      fvals[n] = funcs[n]->getFunctionValue();
+    }
+  }
+}
+
+/*
+  Get the adjoint value for the given function
+*/
+void TACSGAlphaIntegrator::getAdjoint(int step_num, int func_num,
+                                      TACSBVec **adjoint) {
+  // Dummy implementation
+}
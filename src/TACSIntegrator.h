@@ -44,6 +44,9 @@ class TACSIntegrator : public TACSObject {
   void setMaxNewtonIters(int _max_newton_iters);
   void setPrintLevel(int _print_level, const char *logfilename = NULL);
   void setJacAssemblyFreq(int _jac_comp_freq);
+  void setAdaptiveJacobianReuse(int flag, double contraction_tol = 0.5);
+  void setKrylovPredictor(int flag);
+  void setAdaptiveForcing(TACSEisenstatWalker *controller);
   void setUseLapack(int _use_lapack);
   void setUseSchurMat(int _use_schur_mat, TACSAssembler::OrderingType _type);
   void setInitNewtonDeltaFraction(double frac);
@@ -53,11 +56,19 @@ class TACSIntegrator : public TACSObject {
   // --------------------------------
   void setTimeInterval(double tinit, double tfinal);
 
+  // Set the number of state snapshots retained in memory
+  // ----------------------------------------------------
+  void setNumCheckpoints(int _num_checkpoints);
+
   // Set the functions to integrate
   //--------------------------------
   void setFunctions(int num_funcs, TACSFunction **funcs, int start_plane = -1,
                     int end_plane = -1);
 
+  // Restrict a function to a time window within the integration
+  // -----------------------------------------------------------
+  void setFunctionTimeWindow(int func_num, double tstart, double tstop);
+
   // Solve for time-step t with
   virtual int iterate(int step_num, TACSBVec *forces) = 0;
 
@@ -110,6 +121,11 @@ class TACSIntegrator : public TACSObject {
   // Check the gradient using finite-difference
   void checkGradients(double dh);
 
+  // Write binary restart checkpoints and resume from them
+  //------------------------------------------------------
+  void setRestartFile(const char *filename, int _restart_freq);
+  int restart(const char *filename, int step);
+
   // Functions to export the solution in raw and tecplot binary forms
   //-----------------------------------------------------------------
   void setOutputPrefix(const char *prefix);
@@ -153,6 +169,23 @@ class TACSIntegrator : public TACSObject {
   // Log the time step information
   void logTimeStep(int time_step);
 
+  // Create/free the state vectors associated with a single time step
+  void createStepVectors(int step_num);
+  void freeStepVectors(int step_num);
+
+  // Acquire/release state vectors through the snapshot pool
+  TACSBVec *acquireStateVec();
+  void releaseStateVec(TACSBVec **vec);
+  void warmStateVecPool(int count);
+
+  // Restart file helper functions. The history size is the number of
+  // trailing steps that a restart must restore; multi-step schemes
+  // override it so that the recurrence resumes at full order
+  virtual int restartHistorySize();
+  int isRestartStep(int step_num);
+  void writeRestartStep(int step_num);
+  void finalizeRestartFile();
+
   // TACSAssembler information
   TACSAssembler *assembler;  // Instance of TACSAssembler
 
@@ -163,8 +196,45 @@ class TACSIntegrator : public TACSObject {
   TACSBVec **qdot;     // first time derivative of ''
   TACSBVec **qddot;    // second time derivative of ''
 
+  // The number of state snapshots retained in memory during the
+  // forward integration (0 = store the entire time history)
+  int num_checkpoints;
+
+  // Pool of released state history vectors. With checkpointing the
+  // history vectors are dropped as the steps advance; the released
+  // vectors are kept here and handed back out for the incoming
+  // steps, so the marching loop rotates pointers instead of
+  // allocating and freeing vectors. The bytes held by the history
+  // vectors are registered against the per-process memory budget
+  // once, when each vector is created
+  int num_pool_vecs, max_pool_vecs;
+  TACSBVec **vec_pool;
+  size_t pool_bytes;
+
+  // Restart file output. The states are staged into copies so that
+  // the nonblocking writes overlap the solution of the next steps
+  char restart_fname[256];      // Restart file name
+  int restart_freq;             // Steps between checkpoints (0 = off)
+  int restart_step;             // Resume point set by restart()
+  MPI_File restart_fp;          // Open restart file handle
+  int num_restart_records;      // Number of records written so far
+  int *restart_range;           // Ownership offsets of the states
+  TACSBVec *restart_stage[3];   // Staging copies of (q, qdot, qddot)
+  MPI_Request restart_reqs[3];  // Outstanding nonblocking writes
+  int restart_nreqs;            // Number of outstanding writes
+
+  // Per-function time-window helpers: the trapezoid coefficient of a
+  // time plane, the activity of a step interval and the last plane
+  // with any function contribution
+  double getFunctionTimeCoeff(int func_num, int k);
+  int isFunctionIntervalActive(int func_num, int k);
+  int getLastActivePlane();
+
   // Objects that store information about the functions of interest
   int start_plane, end_plane;  // Time-window for the functions of interest
+  int *func_start_plane;       // Per-function window start planes
+  int *func_end_plane;         // Per-function window end planes
+  int use_func_windows;        // Flag for the per-function time windows
   int num_funcs;               // The number of objective functions
   TACSFunction **funcs;        // List of functions
   TacsScalar *fvals;           // Function values
@@ -173,6 +243,10 @@ class TACSIntegrator : public TACSObject {
 
   // Linear algebra objects and parameters associated with the Newton solver
   TACSBVec *res, *update;         // Residual and Newton update
+  TACSBVec *update_hist[2];       // First Newton updates of previous solves
+  int num_update_hist;            // Number of stored previous updates
+  int use_krylov_predictor;       // Extrapolate the Krylov initial guess
+  TACSEisenstatWalker *forcing;   // Adaptive inner tolerance controller
   TACSMat *mat;                   // Jacobian matrix
   TACSPc *pc;                     // Preconditioner
   TACSKsm *ksm;                   // KSM solver
@@ -188,6 +262,9 @@ class TACSIntegrator : public TACSObject {
   double rtol;               // Relative tolerance
   double init_newton_delta;  // Initial value of delta for globalization
   int jac_comp_freq;         // Frequency of Jacobian factorization
+  int use_adaptive_jac;      // Re-use the factored Jacobian across steps
+  double jac_contraction_tol;  // Contraction rate required for re-use
+  int jac_current;             // Flag indicating a factorization exists
   int use_schur_mat;         // use the Schur matrix type for parallel execution
   TACSAssembler::OrderingType order_type;
   int use_lapack;  // Flag to switch to LAPACK for linear solve
@@ -244,12 +321,34 @@ class TACSBDFIntegrator : public TACSIntegrator {
   // Evaluate the functions of interest
   void evalFunctions(TacsScalar *fvals);
 
+  // Integrate the adjoint, recomputing states from snapshots if needed
+  void integrateAdjoint();
+
+  // Integrate the functions within the forward time loop
+  void setInlineFunctionEvaluation(int flag);
+
  private:
   void get2ndBDFCoeff(const int k, double bdf[], int *nbdf, double bddf[],
                       int *nbddf, const int max_order);
   int getBDFCoeff(const int k, double bdf[], int order);
 
+  // Checkpointing helper functions
+  int checkpointInterval();
+  int isStepRetained(int step);
+  void restoreStates(int k);
+
+  // The restart history window for the multi-step BDF recurrence
+  int restartHistorySize();
+
+  // Add the function contributions for the step that was just solved
+  void integrateStepFunctions(int k);
+
   int max_bdf_order;  // Maximum order of the BDF integration scheme
+  int in_recompute;   // Flag set while forward steps are recomputed
+
+  // Flags controlling the in-line function integration
+  int inline_funcs;      // Integrate the functions within the time loop
+  int funcs_integrated;  // The integration pass has been started
 
   // Adjoint information
   int num_adjoint_rhs;  // the number of right hand sides allocated
@@ -291,6 +390,9 @@ class TACSDIRKIntegrator : public TACSIntegrator {
   // Evaluate the functions of interest
   void evalFunctions(TacsScalar *fvals);
 
+  // Integrate the functions within the forward stage loop
+  void setInlineFunctionEvaluation(int flag);
+
  private:
   // Set the default coefficients
   void setupDefaultCoeffs();
@@ -311,9 +413,16 @@ class TACSDIRKIntegrator : public TACSIntegrator {
   void getLinearizationCoeffs(const int stage, const double h, double *alpha,
                               double *beta, double *gamma);
 
+  // Add the function contributions for the stage that was just solved
+  void integrateStageFunctions(int k, int stage);
+
   // The number of stages for this method
   int num_stages;
 
+  // Flags controlling the in-line function integration
+  int inline_funcs;      // Integrate the functions within the stage loop
+  int funcs_integrated;  // The integration pass has been started
+
   // States at each stage
   TACSBVec **qS, **qdotS, **qddotS;
 
@@ -397,6 +506,54 @@ class TACSESDIRKIntegrator : public TACSIntegrator {
   double *A, *B;
 };
 
+/*
+  Generalized-alpha integration scheme for TACS. *No adjoint
+  implementation yet*
+
+  The method of Chung and Hulbert with the high-frequency spectral
+  radius rho_inf as the single algorithmic parameter. The scheme is
+  second-order accurate and unconditionally stable for any value of
+  rho_inf in [0, 1], with rho_inf = 1 recovering the undamped
+  trapezoidal rule and smaller values adding controllable numerical
+  dissipation of the unresolved high-frequency modes.
+
+  Since the time step is constant, the linearization coefficients are
+  identical for every step and the effective Jacobian is the fixed
+  combination c1*K + c2*C + c3*M. The integrator therefore enables the
+  adaptive Jacobian reuse in the Newton solver by default: the matrix
+  is factored at the first step and the factorization is re-used for
+  all subsequent steps. For linear problems this results in a single
+  factorization for the entire time history; for nonlinear problems
+  the residual contraction monitor triggers a re-factorization only
+  when the Newton convergence degrades.
+*/
+class TACSGAlphaIntegrator : public TACSIntegrator {
+ public:
+  TACSGAlphaIntegrator(TACSAssembler *_tacs, double _tinit, double _tfinal,
+                       double _num_steps, double _rho_inf = 0.8);
+  ~TACSGAlphaIntegrator();
+
+  // Iterate through the forward solution
+  int iterate(int k, TACSBVec *forces);
+
+  // Evaluate the functions of interest
+  void evalFunctions(TacsScalar *fvals);
+
+  // Get the adjoint value for the given function - adjoint not implemented yet
+  void getAdjoint(int step_num, int func_num, TACSBVec **adjoint);
+
+ private:
+  // The spectral radius at the high-frequency limit and the derived
+  // algorithmic parameters
+  double rho_inf;
+  double alpha_m, alpha_f;  // The state weighting parameters
+  double nm_beta, nm_gamma;  // The underlying Newmark coefficients
+
+  // The alpha-weighted intermediate states at which the residual and
+  // its Jacobian are evaluated during the Newton solve
+  TACSBVec *qa, *qdota, *qddota;
+};
+
 /*
   Adams-Bashforth-Moulton integration scheme for TACS
 */
@@ -0,0 +1,256 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSLoadCaseDriver.h"
+
+#include <stdio.h>
+#include <string.h>
+
+const char *TACSLoadCaseDriver::driverName = "TACSLoadCaseDriver";
+
+/*!
+  Create the load case driver.
+
+  The matrix, preconditioner and solver must be created for the given
+  assembler object and associated with one another by the caller. The
+  driver assembles the stiffness matrix into kmat, factors it through
+  the preconditioner once, and re-uses the factorization for every
+  load case.
+
+  input:
+  assembler: the TACSAssembler object
+  kmat:      the stiffness matrix
+  pc:        the preconditioner for the stiffness matrix
+  solver:    the Krylov solver associated with kmat/pc
+  num_cases: the number of load cases in the batch
+*/
+TACSLoadCaseDriver::TACSLoadCaseDriver(TACSAssembler *_assembler,
+                                       TACSMat *_kmat, TACSPc *_pc,
+                                       TACSKsm *_solver, int _num_cases) {
+  assembler = _assembler;
+  assembler->incref();
+  kmat = _kmat;
+  kmat->incref();
+  pc = _pc;
+  pc->incref();
+  solver = _solver;
+  solver->incref();
+
+  num_cases = _num_cases;
+  if (num_cases < 1) {
+    num_cases = 1;
+  }
+
+  loads = new TACSBVec *[num_cases];
+  vars = new TACSBVec *[num_cases];
+  for (int k = 0; k < num_cases; k++) {
+    loads[k] = NULL;
+    vars[k] = NULL;
+  }
+
+  res = assembler->createVec();
+  res->incref();
+
+  num_funcs = 0;
+  funcs = NULL;
+  func_vals = NULL;
+
+  f5 = NULL;
+  file_fmt = NULL;
+}
+
+/*!
+  Free the data allocated by the driver
+*/
+TACSLoadCaseDriver::~TACSLoadCaseDriver() {
+  for (int k = 0; k < num_cases; k++) {
+    if (loads[k]) {
+      loads[k]->decref();
+    }
+    if (vars[k]) {
+      vars[k]->decref();
+    }
+  }
+  delete[] loads;
+  delete[] vars;
+  res->decref();
+
+  if (funcs) {
+    for (int k = 0; k < num_funcs; k++) {
+      funcs[k]->decref();
+    }
+    delete[] funcs;
+  }
+  if (func_vals) {
+    delete[] func_vals;
+  }
+
+  if (f5) {
+    f5->decref();
+  }
+  if (file_fmt) {
+    delete[] file_fmt;
+  }
+
+  assembler->decref();
+  kmat->decref();
+  pc->decref();
+  solver->decref();
+}
+
+/*!
+  Set the load vector for the given load case
+*/
+void TACSLoadCaseDriver::setLoads(int load_case, TACSBVec *_loads) {
+  if (load_case < 0 || load_case >= num_cases) {
+    fprintf(stderr,
+            "TACSLoadCaseDriver: Load case %d out of range, "
+            "must be in [0, %d)\n",
+            load_case, num_cases);
+    return;
+  }
+
+  _loads->incref();
+  if (loads[load_case]) {
+    loads[load_case]->decref();
+  }
+  loads[load_case] = _loads;
+}
+
+/*!
+  Set the functions of interest that are evaluated for every load case
+*/
+void TACSLoadCaseDriver::setFunctions(int _num_funcs, TACSFunction **_funcs) {
+  // Free the old function data
+  if (funcs) {
+    for (int k = 0; k < num_funcs; k++) {
+      funcs[k]->decref();
+    }
+    delete[] funcs;
+  }
+  if (func_vals) {
+    delete[] func_vals;
+  }
+  funcs = NULL;
+  func_vals = NULL;
+
+  num_funcs = _num_funcs;
+  if (num_funcs > 0) {
+    funcs = new TACSFunction *[num_funcs];
+    for (int k = 0; k < num_funcs; k++) {
+      funcs[k] = _funcs[k];
+      funcs[k]->incref();
+    }
+
+    func_vals = new TacsScalar[num_funcs * num_cases];
+    memset(func_vals, 0, num_funcs * num_cases * sizeof(TacsScalar));
+  }
+}
+
+/*!
+  Set the solution output written for each load case.
+
+  The file name format must contain a single integer conversion,
+  e.g. "solution_%03d.f5", that is expanded with the load case index.
+*/
+void TACSLoadCaseDriver::setOutput(TACSToFH5 *_f5, const char *_file_fmt) {
+  if (_f5) {
+    _f5->incref();
+  }
+  if (f5) {
+    f5->decref();
+  }
+  f5 = _f5;
+
+  if (file_fmt) {
+    delete[] file_fmt;
+    file_fmt = NULL;
+  }
+  if (_file_fmt) {
+    size_t len = strlen(_file_fmt) + 1;
+    file_fmt = new char[len];
+    memcpy(file_fmt, _file_fmt, len);
+  }
+}
+
+/*!
+  Solve all of the load cases.
+
+  The stiffness matrix is assembled about the zero state and factored
+  once. Each load case then requires only the Krylov solve with the
+  existing factorization, the function evaluation and the optional
+  output - the assembly and factorization costs are amortized over
+  the entire batch.
+*/
+void TACSLoadCaseDriver::solve() {
+  // Assemble and factor the stiffness matrix once for all cases
+  assembler->zeroVariables();
+  assembler->assembleJacobian(1.0, 0.0, 0.0, NULL, kmat);
+  pc->factor();
+
+  for (int k = 0; k < num_cases; k++) {
+    if (!loads[k]) {
+      continue;
+    }
+
+    if (!vars[k]) {
+      vars[k] = assembler->createVec();
+      vars[k]->incref();
+    }
+
+    // Solve K * u = f for this case with the shared factorization
+    res->copyValues(loads[k]);
+    assembler->applyBCs(res);
+    solver->solve(res, vars[k]);
+    assembler->setBCs(vars[k]);
+
+    // Evaluate the functions of interest at the solution. The
+    // evaluation uses the assembler's threaded path when multiple
+    // threads are enabled.
+    if (num_funcs > 0 || f5) {
+      assembler->setVariables(vars[k]);
+    }
+    if (num_funcs > 0) {
+      assembler->evalFunctions(num_funcs, funcs, &func_vals[num_funcs * k]);
+    }
+
+    // Write the solution file for this case
+    if (f5 && file_fmt) {
+      char filename[512];
+      snprintf(filename, sizeof(filename), file_fmt, k);
+      f5->writeToFile(filename);
+    }
+  }
+}
+
+/*!
+  Retrieve the solution vector for the given load case. This returns
+  NULL if the case has not been solved.
+*/
+TACSBVec *TACSLoadCaseDriver::getVariables(int load_case) {
+  if (load_case >= 0 && load_case < num_cases) {
+    return vars[load_case];
+  }
+  return NULL;
+}
+
+/*!
+  Retrieve the function values computed for the given load case
+*/
+void TACSLoadCaseDriver::getFunctionValues(int load_case, TacsScalar *fvals) {
+  if (load_case >= 0 && load_case < num_cases && func_vals) {
+    memcpy(fvals, &func_vals[num_funcs * load_case],
+           num_funcs * sizeof(TacsScalar));
+  }
+}
+
+const char *TACSLoadCaseDriver::getObjectName() { return driverName; }
@@ -0,0 +1,94 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_LOAD_CASE_DRIVER_H
+#define TACS_LOAD_CASE_DRIVER_H
+
+#include "TACSAssembler.h"
+#include "TACSToFH5.h"
+
+/**
+  Driver for solving batches of linear static load cases that share
+  the same stiffness matrix.
+
+  Load-case sweeps often involve hundreds of right-hand sides with an
+  identical structural state. Solving the cases through separate
+  problem objects re-assembles and re-factors the stiffness matrix for
+  every case, which dominates the cost of the sweep. This driver
+  assembles and factors the matrix exactly once and then batches the
+  load vectors through the Krylov solver with the single factorization
+  as the preconditioner.
+
+  After each solve the driver evaluates an optional set of functions
+  of interest and writes an optional solution file for the case. The
+  function evaluation runs through TACSAssembler and therefore uses
+  its threaded evaluation path when the assembler is created with
+  multiple threads.
+*/
+class TACSLoadCaseDriver : public TACSObject {
+ public:
+  TACSLoadCaseDriver(TACSAssembler *_assembler, TACSMat *_kmat, TACSPc *_pc,
+                     TACSKsm *_solver, int _num_cases);
+  ~TACSLoadCaseDriver();
+
+  // Set the load vector for each case
+  // ---------------------------------
+  void setLoads(int load_case, TACSBVec *_loads);
+
+  // Set the functions evaluated for every load case
+  // -----------------------------------------------
+  void setFunctions(int _num_funcs, TACSFunction **_funcs);
+
+  // Set the solution output written for each load case
+  // --------------------------------------------------
+  void setOutput(TACSToFH5 *_f5, const char *_file_fmt);
+
+  // Factor the stiffness matrix once and solve all of the cases
+  // -----------------------------------------------------------
+  void solve();
+
+  // Retrieve the solution and function values for a case
+  // ----------------------------------------------------
+  TACSBVec *getVariables(int load_case);
+  void getFunctionValues(int load_case, TacsScalar *fvals);
+
+  const char *getObjectName();
+
+ private:
+  // The TACS assembler object
+  TACSAssembler *assembler;
+
+  // The stiffness matrix, preconditioner and solver
+  TACSMat *kmat;
+  TACSPc *pc;
+  TACSKsm *solver;
+
+  // The load and solution vectors for each case
+  int num_cases;
+  TACSBVec **loads;
+  TACSBVec **vars;
+  TACSBVec *res;
+
+  // The functions of interest and their values for each case
+  int num_funcs;
+  TACSFunction **funcs;
+  TacsScalar *func_vals;
+
+  // Optional solution output. The file name format must contain a
+  // single integer conversion for the load case index.
+  TACSToFH5 *f5;
+  char *file_fmt;
+
+  static const char *driverName;
+};
+
+#endif  // TACS_LOAD_CASE_DRIVER_H
@@ -22,6 +22,9 @@ TACSMatrixFreeMat::TACSMatrixFreeMat(TACSAssembler *_assembler) {
   data = NULL;
   temp = NULL;
   matType = TACS_JACOBIAN_MATRIX;
+  alpha = 1.0;
+  beta = 0.0;
+  gamma = 0.0;
 }
 
 TACSMatrixFreeMat::~TACSMatrixFreeMat() {
@@ -35,8 +38,8 @@ TACSMatrixFreeMat::~TACSMatrixFreeMat() {
 }
 
 void TACSMatrixFreeMat::assembleMatrixFreeData(ElementMatrixType _matType,
-                                               double alpha, double beta,
-                                               double gamma) {
+                                               double _alpha, double _beta,
+                                               double _gamma) {
   if (data) {
     delete[] data;
   }
@@ -44,12 +47,23 @@ void TACSMatrixFreeMat::assembleMatrixFreeData(ElementMatrixType _matType,
     delete[] temp;
   }
   matType = _matType;
+  alpha = _alpha;
+  beta = _beta;
+  gamma = _gamma;
   assembler->getMatrixFreeDataSize(matType, &data_size, &temp_size);
   data = new TacsScalar[data_size];
   temp = new TacsScalar[temp_size];
   assembler->assembleMatrixFreeData(matType, alpha, beta, gamma, data);
 }
 
+/*
+  Assemble the diagonal of the matrix using the same matrix type and
+  coefficients as the most recent call to assembleMatrixFreeData()
+*/
+void TACSMatrixFreeMat::assembleDiag(TACSBVec *diag) {
+  assembler->assembleMatDiag(matType, alpha, beta, gamma, diag);
+}
+
 TACSVec *TACSMatrixFreeMat::createVec() { return assembler->createVec(); }
 
 void TACSMatrixFreeMat::mult(TACSVec *tx, TACSVec *ty) {
@@ -72,4 +86,185 @@ void TACSMatrixFreeMat::multTranspose(TACSVec *tx, TACSVec *ty) {
   }
 }
 
-const char *TACSMatrixFreeMat::getObjectName() { return "TACSMatrixFreeMat"; }
\ No newline at end of file
+const char *TACSMatrixFreeMat::getObjectName() { return "TACSMatrixFreeMat"; }
+
+/*
+  Create the Jacobi smoother object
+*/
+TACSJacobiSmoother::TACSJacobiSmoother(TACSMatrixFreeMat *_mat,
+                                       TacsScalar _omega, int _iters) {
+  mat = _mat;
+  mat->incref();
+
+  omega = _omega;
+  iters = _iters;
+
+  // A non-positive damping factor selects automatic tuning
+  auto_omega = (TacsRealPart(omega) <= 0.0);
+  if (auto_omega) {
+    omega = 2.0 / 3.0;
+  }
+  power_iters = 15;
+  rho_rtol = 0.05;
+  rho_cached = -1.0;
+  power_vec = NULL;
+
+  // Create the vectors that are needed in the computation
+  Dinv = dynamic_cast<TACSBVec *>(mat->createVec());
+  res = dynamic_cast<TACSBVec *>(mat->createVec());
+  t = dynamic_cast<TACSBVec *>(mat->createVec());
+  Dinv->incref();
+  res->incref();
+  t->incref();
+}
+
+/*
+  Free the memory associated with the Jacobi smoother
+*/
+TACSJacobiSmoother::~TACSJacobiSmoother() {
+  mat->decref();
+  Dinv->decref();
+  res->decref();
+  t->decref();
+  if (power_vec) {
+    power_vec->decref();
+  }
+}
+
+/*
+  Estimate the spectral radius of the diagonally-scaled operator
+  Dinv*A by power iteration.
+
+  The power iterate persists between factorizations and each call
+  first advances it by a single step, which both verifies and
+  sharpens the cached estimate. The full iteration only re-runs when
+  the single-step value drifts from the cached estimate by more than
+  the relative tolerance.
+*/
+double TACSJacobiSmoother::powerEstimate() {
+  // Create and seed the power iterate on the first call
+  if (!power_vec) {
+    power_vec = dynamic_cast<TACSBVec *>(mat->createVec());
+    power_vec->incref();
+    power_vec->setRand(-1.0, 1.0);
+    double vnorm = TacsRealPart(power_vec->norm());
+    if (vnorm != 0.0) {
+      power_vec->scale(1.0 / vnorm);
+    }
+  }
+
+  TacsScalar *d, *tv;
+  Dinv->getArray(&d);
+  int size = t->getArray(&tv);
+
+  // Advance the iterate by one step of Dinv*A
+  mat->mult(power_vec, t);
+  for (int j = 0; j < size; j++) {
+    tv[j] *= d[j];
+  }
+  double rho = TacsRealPart(t->norm());
+  if (rho != 0.0) {
+    t->scale(1.0 / rho);
+    power_vec->copyValues(t);
+  }
+
+  // Re-use the cached estimate when the single-step value has not
+  // drifted appreciably
+  if (rho_cached > 0.0 && fabs(rho - rho_cached) <= rho_rtol * rho_cached) {
+    rho_cached = rho;
+    return rho_cached;
+  }
+
+  // Run the power iteration until the estimate settles
+  for (int i = 0; i < power_iters; i++) {
+    double rho_prev = rho;
+    mat->mult(power_vec, t);
+    for (int j = 0; j < size; j++) {
+      tv[j] *= d[j];
+    }
+    rho = TacsRealPart(t->norm());
+    if (rho == 0.0) {
+      rho = 1.0;
+      break;
+    }
+    t->scale(1.0 / rho);
+    power_vec->copyValues(t);
+
+    if (fabs(rho - rho_prev) <= 0.01 * rho) {
+      break;
+    }
+  }
+
+  rho_cached = rho;
+  return rho_cached;
+}
+
+/*
+  Factor the smoother.
+
+  This assembles the diagonal of the matrix and inverts the entries.
+  The entries that are zeroed by the boundary conditions are set to
+  one - the residual is zero at those entries, so the corresponding
+  update is zero regardless of the scaling.
+*/
+void TACSJacobiSmoother::factor() {
+  // Assemble the diagonal of the matrix
+  mat->assembleDiag(Dinv);
+
+  // Invert the diagonal entries
+  TacsScalar *d;
+  int size = Dinv->getArray(&d);
+  for (int i = 0; i < size; i++) {
+    if (d[i] != 0.0) {
+      d[i] = 1.0 / d[i];
+    } else {
+      d[i] = 1.0;
+    }
+  }
+
+  // Tune the damping factor to the estimated spectral radius of the
+  // scaled operator
+  if (auto_omega) {
+    double rho = powerEstimate();
+    if (rho > 0.0) {
+      omega = 4.0 / (3.0 * rho);
+    }
+  }
+}
+
+/*
+  Apply the damped Jacobi smoother
+*/
+void TACSJacobiSmoother::applyFactor(TACSVec *tx, TACSVec *ty) {
+  // Convert to TACSBVec objects
+  TACSBVec *x, *y;
+  x = dynamic_cast<TACSBVec *>(tx);
+  y = dynamic_cast<TACSBVec *>(ty);
+
+  if (x && y) {
+    TacsScalar *d, *r, *yvals;
+    Dinv->getArray(&d);
+    res->getArray(&r);
+    int size = y->getArray(&yvals);
+
+    for (int i = 0; i < iters; i++) {
+      // Compute the residual res := x - A*y
+      mat->mult(y, t);
+      res->copyValues(x);
+      res->axpy(-1.0, t);
+
+      // Apply the update y <- y + omega*Dinv*res
+      for (int j = 0; j < size; j++) {
+        yvals[j] += omega * d[j] * r[j];
+      }
+    }
+  } else {
+    fprintf(stderr,
+            "TACSJacobiSmoother type error: Input/output must be TACSBVec\n");
+  }
+}
+
+/*
+  Retrieve the matrix associated with the smoother
+*/
+void TACSJacobiSmoother::getMat(TACSMat **_mat) { *_mat = mat; }
\ No newline at end of file
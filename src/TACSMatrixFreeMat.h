@@ -28,6 +28,7 @@ class TACSMatrixFreeMat : public TACSMat {
 
   void assembleMatrixFreeData(ElementMatrixType _matType, double alpha,
                               double beta, double gamma);
+  void assembleDiag(TACSBVec *diag);
   TACSVec *createVec();
   void mult(TACSVec *x, TACSVec *y);
   void multTranspose(TACSVec *x, TACSVec *y);
@@ -36,8 +37,57 @@ class TACSMatrixFreeMat : public TACSMat {
  private:
   TACSAssembler *assembler;
   ElementMatrixType matType;
+  double alpha, beta, gamma;
   TacsScalar *data, *temp;
   int data_size, temp_size;
 };
 
+/*
+  Damped Jacobi smoother for matrix-free matrices.
+
+  This smoother only requires matrix-vector products and the matrix
+  diagonal, which is assembled through a lightweight diagonal-only
+  pass over the elements. This allows the fine levels of a multigrid
+  hierarchy to be smoothed without ever assembling the full matrix.
+
+  Passing a non-positive damping factor selects automatic tuning:
+  each factorization estimates the spectral radius of the
+  diagonally-scaled operator by power iteration and sets the optimal
+  damping for it. The estimate is cached across factorizations and
+  only re-converged when it drifts.
+*/
+class TACSJacobiSmoother : public TACSPc {
+ public:
+  TACSJacobiSmoother(TACSMatrixFreeMat *_mat, TacsScalar _omega, int _iters);
+  ~TACSJacobiSmoother();
+
+  void factor();
+  void applyFactor(TACSVec *xvec, TACSVec *yvec);
+  void getMat(TACSMat **_mat);
+
+ private:
+  // Estimate the spectral radius of Dinv*A by power iteration
+  double powerEstimate();
+
+  // The matrix-free matrix pointer
+  TACSMatrixFreeMat *mat;
+
+  // The damping factor and the number of iterations to apply
+  TacsScalar omega;
+  int iters;
+
+  // The cached spectral radius estimate for the automatic damping
+  int auto_omega;
+  int power_iters;
+  double rho_rtol;
+  double rho_cached;
+  TACSBVec *power_vec;
+
+  // The inverse of the matrix diagonal
+  TACSBVec *Dinv;
+
+  // Temporary vectors
+  TACSBVec *res, *t;
+};
+
 #endif  // TACS_MATRIX_FREE_MAT_H
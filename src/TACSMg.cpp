@@ -96,6 +96,7 @@ TACSMg::TACSMg(MPI_Comm _comm, int _nlevels, double _sor_omega, int _sor_iters,
   monitor = NULL;
   root_mat = NULL;
   root_pc = NULL;
+  agglom_dof_threshold = 0;
 
   // Total time for smoothing and interpolation for each level
   cumulative_level_time = new double[nlevels];
@@ -154,6 +155,67 @@ TACSMg::~TACSMg() {
   delete[] cumulative_level_time;
 }
 
+/**
+  Create the default smoother for a multi-grid level.
+
+  The Gauss-Seidel smoother is the default. The Chebyshev smoother
+  only requires matrix-vector products, so it retains thread
+  scalability where the sequential triangular sweeps in Gauss-Seidel
+  do not. The eigenvalue estimate needed for the Chebyshev interval
+  is computed when the smoother is factored.
+
+  @param pmat The matrix at this level
+  @param use_chebyshev Use a Chebyshev smoother instead of Gauss-Seidel
+  @param chebyshev_degree The degree of the Chebyshev polynomial
+*/
+TACSPc *TACSMg::createDefaultSmoother(TACSParallelMat *pmat, int use_chebyshev,
+                                      int chebyshev_degree) {
+  if (use_chebyshev) {
+    double lower_factor = 1.0 / 30.0;
+    double upper_factor = 1.1;
+    return new TACSChebyshevSmoother(pmat, chebyshev_degree, lower_factor,
+                                     upper_factor, sor_iters);
+  }
+
+  // Do not zero the initial guess for the PSOR object
+  int zero_guess = 0;
+  return new TACSGaussSeidel(pmat, zero_guess, sor_omega, sor_iters,
+                             sor_symmetric);
+}
+
+/**
+  Create the direct solver for the coarsest level of the hierarchy.
+
+  When the total number of degrees of freedom on the coarsest level
+  falls below the agglomeration threshold, the solve there is pure
+  communication latency with the distributed block-cyclic solver. In
+  that case, gather the coarse operator to a single processor and
+  factor it there instead. The default threshold of zero disables
+  agglomeration so that the block-cyclic solver is always used.
+
+  @param coarse_mat The parallel matrix on the coarsest level
+*/
+TACSPc *TACSMg::createRootSolver(TACSParallelMat *coarse_mat) {
+  int mpi_size;
+  MPI_Comm_size(comm, &mpi_size);
+
+  if (mpi_size > 1 && agglom_dof_threshold > 0) {
+    // Compute the total number of degrees of freedom on the
+    // coarsest level
+    int bsize, n, nc;
+    coarse_mat->getRowMap(&bsize, &n, &nc);
+    const int *range;
+    coarse_mat->getRowMap()->getOwnerRange(&range);
+    int total_dof = bsize * range[mpi_size];
+
+    if (total_dof <= agglom_dof_threshold) {
+      return new TACSGatherDirectPc(coarse_mat);
+    }
+  }
+
+  return new TACSBlockCyclicPc(coarse_mat);
+}
+
 /**
   Set the data for the given multi-grid level.
 
@@ -165,6 +227,15 @@ TACSMg::~TACSMg() {
   A custom matrix may be provided. If it is, then the smoother must
   also be provided as well.
 
+  If the use_matrix_free flag is set, the level is formed with a
+  TACSMatrixFreeMat so that the matrix is never assembled at this
+  level. The smoother is then either a Jacobi smoother, which uses a
+  diagonal-only assembly pass, or a Chebyshev smoother when the
+  use_chebyshev flag is also set, since both require only
+  matrix-vector products. Note that a matrix-free level cannot serve
+  as the fine level for a Galerkin projection, since the projection
+  requires the assembled matrix.
+
   If the use_galerkin flag is used at a given level, the matrix is formed
   from Galerkin projection: A[i] = P[i-1]^{T}*A[i-1]*P[i-1]. This only works
   when the matrix on the finer level is of type TACSParallelMat. If not, then
@@ -179,10 +250,14 @@ TACSMg::~TACSMg() {
   @param use_galerkin Use Galerkin projection at this level
   @param mat The matrix at this level (may be NULL)
   @param smoother The smoother defined at this level (may be NULL)
+  @param use_chebyshev Use a Chebyshev smoother instead of Gauss-Seidel
+  @param chebyshev_degree The degree of the Chebyshev polynomial
+  @param use_matrix_free Use a matrix-free matrix at this level
 */
 void TACSMg::setLevel(int level, TACSAssembler *_assembler,
                       TACSBVecInterp *_interp, int _iters, int _use_galerkin,
-                      TACSMat *_mat, TACSPc *_smoother) {
+                      TACSMat *_mat, TACSPc *_smoother, int _use_chebyshev,
+                      int _chebyshev_degree, int _use_matrix_free) {
   assembler[level] = _assembler;
   assembler[level]->incref();
 
@@ -217,9 +292,8 @@ void TACSMg::setLevel(int level, TACSAssembler *_assembler,
         mat[level] = pmat;
         mat[level]->incref();
 
-        int zero_guess = 0;
-        pc[level] = new TACSGaussSeidel(pmat, zero_guess, sor_omega, sor_iters,
-                                        sor_symmetric);
+        pc[level] =
+            createDefaultSmoother(pmat, _use_chebyshev, _chebyshev_degree);
         pc[level]->incref();
       } else {
         TACSParallelMat *fine_mat =
@@ -232,9 +306,8 @@ void TACSMg::setLevel(int level, TACSAssembler *_assembler,
           mat[level] = coarse_mat;
           mat[level]->incref();
 
-          int zero_guess = 0;
-          pc[level] = new TACSGaussSeidel(coarse_mat, zero_guess, sor_omega,
-                                          sor_iters, sor_symmetric);
+          pc[level] = createDefaultSmoother(coarse_mat, _use_chebyshev,
+                                            _chebyshev_degree);
           pc[level]->incref();
 
           // This matrix is computed using Galerkin projection
@@ -256,15 +329,30 @@ void TACSMg::setLevel(int level, TACSAssembler *_assembler,
 
         _smoother->incref();
         pc[level] = _smoother;
+      } else if (_use_matrix_free) {
+        // Create a matrix-free matrix so that the full matrix is
+        // never assembled at this level
+        TACSMatrixFreeMat *mat_free = new TACSMatrixFreeMat(assembler[level]);
+        mat[level] = mat_free;
+        mat[level]->incref();
+
+        if (_use_chebyshev) {
+          double lower_factor = 1.0 / 30.0;
+          double upper_factor = 1.1;
+          pc[level] = new TACSChebyshevSmoother(
+              mat_free, _chebyshev_degree, lower_factor, upper_factor,
+              sor_iters);
+        } else {
+          pc[level] = new TACSJacobiSmoother(mat_free, sor_omega, sor_iters);
+        }
+        pc[level]->incref();
       } else {
         TACSParallelMat *pmat = assembler[level]->createMat();
         mat[level] = pmat;
         mat[level]->incref();
 
-        // Do not zero the initial guess for the PSOR object
-        int zero_guess = 0;
-        pc[level] = new TACSGaussSeidel(pmat, zero_guess, sor_omega, sor_iters,
-                                        sor_symmetric);
+        pc[level] =
+            createDefaultSmoother(pmat, _use_chebyshev, _chebyshev_degree);
         pc[level]->incref();
       }
     }
@@ -280,7 +368,7 @@ void TACSMg::setLevel(int level, TACSAssembler *_assembler,
         root_mat = coarse_mat;
         root_mat->incref();
 
-        root_pc = new TACSBlockCyclicPc(coarse_mat);
+        root_pc = createRootSolver(coarse_mat);
         root_pc->incref();
 
         // Use Galerkin projection to create the coarsest problem
@@ -637,6 +725,25 @@ void TACSMg::setMonitor(KSMPrint *_monitor) {
   monitor = _monitor;
 }
 
+/**
+  Set the threshold for agglomerating the coarsest-level direct solve.
+
+  When the total number of degrees of freedom on the coarsest level is
+  at most min_dof, the coarse operator is gathered to a single
+  processor and factored there, rather than solved with the
+  distributed block-cyclic solver. This must be called before
+  setLevel() is called for the coarsest level. A value of zero
+  disables agglomeration.
+
+  @param min_dof The maximum problem size to gather to one processor
+*/
+void TACSMg::setCoarseGridAgglomeration(int min_dof) {
+  agglom_dof_threshold = min_dof;
+  if (agglom_dof_threshold < 0) {
+    agglom_dof_threshold = 0;
+  }
+}
+
 /**
   Repeatedly apply the multi-grid method until the problem is solved
 */
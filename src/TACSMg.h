@@ -65,7 +65,8 @@ class TACSMg : public TACSPc {
   void setLevel(int level, TACSAssembler *_assembler,
                 TACSBVecInterp *interp = NULL, int _iters = 1,
                 int _use_galerkin = 0, TACSMat *_mat = NULL,
-                TACSPc *_smoother = NULL);
+                TACSPc *_smoother = NULL, int _use_chebyshev = 0,
+                int _chebyshev_degree = 3, int _use_matrix_free = 0);
 
   // Set the state/design variables of all lower finite-element models
   // -----------------------------------------------------------------
@@ -104,10 +105,21 @@ class TACSMg : public TACSPc {
   // --------------------------------
   void setMonitor(KSMPrint *_monitor);
 
+  // Set the threshold for agglomerating the coarse-grid solve
+  // ---------------------------------------------------------
+  void setCoarseGridAgglomeration(int min_dof);
+
  private:
   // Recursive function to apply multi-grid at each level
   void applyMg(int level);
 
+  // Create the default smoother for a level
+  TACSPc *createDefaultSmoother(TACSParallelMat *pmat, int use_chebyshev,
+                                int chebyshev_degree);
+
+  // Create the direct solver for the coarsest level
+  TACSPc *createRootSolver(TACSParallelMat *coarse_mat);
+
   // The MPI communicator for this object
   MPI_Comm comm;
 
@@ -118,6 +130,10 @@ class TACSMg : public TACSPc {
   int sor_iters, sor_symmetric;
   double sor_omega;
 
+  // Gather the coarsest-level solve to a single processor when the
+  // total number of degrees of freedom falls below this threshold
+  int agglom_dof_threshold;
+
   // Flag to indicate whether to form the coarse grid operators
   // via Galerkin projection coarse = P^{T}*A*P
   int *use_galerkin;
@@ -0,0 +1,526 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSModalTransient.h"
+
+/*
+  Create the modal transient engine
+
+  input:
+  assembler: the assembler associated with the modal basis
+  max_modes: the maximum number of modes in the basis
+*/
+TACSModalTransient::TACSModalTransient(TACSAssembler *_assembler,
+                                       int _max_modes) {
+  assembler = _assembler;
+  assembler->incref();
+
+  // Allocate the modal data
+  max_modes = (_max_modes > 0 ? _max_modes : 1);
+  num_modes = 0;
+  modes = new TACSBVec *[max_modes];
+  omega = new TacsScalar[max_modes];
+  zeta = new double[max_modes];
+  fproj = new TacsScalar[max_modes];
+  q0 = new TacsScalar[max_modes];
+  qdot0 = new TacsScalar[max_modes];
+  for (int i = 0; i < max_modes; i++) {
+    omega[i] = 0.0;
+    zeta[i] = 0.0;
+    fproj[i] = 0.0;
+    q0[i] = 0.0;
+    qdot0[i] = 0.0;
+  }
+
+  // No loads by default
+  forces = NULL;
+  load_scale = NULL;
+  load_scale_ctx = NULL;
+
+  // Default time interval
+  num_time_steps = 100;
+  tinit = 0.0;
+  tfinal = 1.0;
+
+  // The histories are allocated by integrate()
+  qhist = NULL;
+  qdhist = NULL;
+  qddhist = NULL;
+
+  // Create the work vectors for the reconstruction
+  uvec = assembler->createVec();
+  uvec->incref();
+  vvec = assembler->createVec();
+  vvec->incref();
+  avec = assembler->createVec();
+  avec->incref();
+}
+
+/*
+  Free the modal basis and the coordinate histories
+*/
+TACSModalTransient::~TACSModalTransient() {
+  for (int i = 0; i < num_modes; i++) {
+    modes[i]->decref();
+  }
+  delete[] modes;
+  delete[] omega;
+  delete[] zeta;
+  delete[] fproj;
+  delete[] q0;
+  delete[] qdot0;
+  if (forces) {
+    forces->decref();
+  }
+  if (qhist) {
+    delete[] qhist;
+    delete[] qdhist;
+    delete[] qddhist;
+  }
+  uvec->decref();
+  vvec->decref();
+  avec->decref();
+  assembler->decref();
+}
+
+/*!
+  Extract the modal basis from a frequency analysis.
+
+  The eigenvectors produced by the frequency analysis are
+  mass-normalized, so the modal mass is unity and the modal stiffness
+  is the eigenvalue. Eigenvalues that are numerically negative are
+  clamped to zero and treated as rigid-body modes.
+
+  Any previously extracted basis is replaced, and the modal load
+  projection is recomputed if a load vector has been set. The initial
+  modal coordinates are reset to zero - call setInitConditions() after
+  this call, not before.
+
+  input:
+  freq:      the frequency analysis holding the solved eigenproblem
+  num_modes: the number of modes to extract
+
+  returns: the number of modes in the basis
+*/
+int TACSModalTransient::extractModes(TACSFrequencyAnalysis *freq,
+                                     int _num_modes) {
+  if (_num_modes > max_modes) {
+    _num_modes = max_modes;
+  }
+
+  // Free the previous basis
+  for (int i = 0; i < num_modes; i++) {
+    modes[i]->decref();
+  }
+  num_modes = 0;
+
+  for (int i = 0; i < _num_modes; i++) {
+    TacsScalar error;
+    TacsScalar eig = freq->extractEigenvalue(i, &error);
+
+    modes[num_modes] = assembler->createVec();
+    modes[num_modes]->incref();
+    freq->extractEigenvector(i, modes[num_modes], &error);
+
+    if (TacsRealPart(eig) > 0.0) {
+      omega[num_modes] = sqrt(eig);
+    } else {
+      omega[num_modes] = 0.0;
+    }
+    q0[num_modes] = 0.0;
+    qdot0[num_modes] = 0.0;
+    num_modes++;
+  }
+
+  // Recompute the modal load projection for the new basis
+  if (forces) {
+    for (int i = 0; i < num_modes; i++) {
+      fproj[i] = modes[i]->dot(forces);
+    }
+  }
+
+  return num_modes;
+}
+
+/*
+  Set a uniform damping ratio for all modes
+*/
+void TACSModalTransient::setModalDamping(double _zeta) {
+  for (int i = 0; i < max_modes; i++) {
+    setModalDamping(i, _zeta);
+  }
+}
+
+/*
+  Set the damping ratio for a single mode. The piecewise-exact update
+  assumes a sub-critically damped mode, so the ratio is clamped below
+  one.
+*/
+void TACSModalTransient::setModalDamping(int mode, double _zeta) {
+  if (mode >= 0 && mode < max_modes) {
+    if (_zeta < 0.0) {
+      _zeta = 0.0;
+    } else if (_zeta >= 1.0) {
+      fprintf(stderr,
+              "TACSModalTransient: Damping ratio %g clamped below critical "
+              "damping\n",
+              _zeta);
+      _zeta = 0.999;
+    }
+    zeta[mode] = _zeta;
+  }
+}
+
+/*
+  Set the modal damping ratios from the Rayleigh coefficients of the
+  damping matrix C = alpha*M + beta*K. This must be called after the
+  modes are extracted since the ratios depend on the frequencies.
+*/
+void TACSModalTransient::setRayleighDamping(double alpha, double beta) {
+  for (int i = 0; i < num_modes; i++) {
+    double w = TacsRealPart(omega[i]);
+    if (w > 0.0) {
+      setModalDamping(i, 0.5 * (alpha / w + beta * w));
+    } else {
+      zeta[i] = 0.0;
+    }
+  }
+}
+
+/*
+  Set the time interval for the transient integration
+*/
+void TACSModalTransient::setTimeInterval(double _tinit, double _tfinal,
+                                         int _num_steps) {
+  tinit = _tinit;
+  tfinal = _tfinal;
+  if (_num_steps > 0) {
+    num_time_steps = _num_steps;
+  }
+}
+
+/*!
+  Set the spatial load shape.
+
+  The load applied to the structure is F(t) = forces*scale(t), where
+  the scalar history is set through setLoadScale() and defaults to
+  one. The load is projected onto the modal basis once here - the
+  per-step work involves only the scalar history.
+
+  input:
+  forces: the spatial shape of the applied load
+*/
+void TACSModalTransient::setLoads(TACSBVec *_forces) {
+  _forces->incref();
+  if (forces) {
+    forces->decref();
+  }
+  forces = _forces;
+
+  for (int i = 0; i < num_modes; i++) {
+    fproj[i] = modes[i]->dot(forces);
+  }
+}
+
+/*
+  Set the scalar load history applied to the spatial load shape
+*/
+void TACSModalTransient::setLoadScale(TacsModalLoadScale _load_scale,
+                                      void *_load_scale_ctx) {
+  load_scale = _load_scale;
+  load_scale_ctx = _load_scale_ctx;
+}
+
+/*!
+  Set the initial conditions by projecting the initial state onto the
+  modal basis.
+
+  Since the basis is mass-normalized, the projection of the initial
+  displacement and velocity is taken through the mass matrix:
+  q_i(0) = phi_i^{T} M u(0). Either vector may be NULL for a zero
+  initial condition.
+
+  input:
+  u0:    the initial displacement, or NULL
+  udot0: the initial velocity, or NULL
+  mmat:  the mass matrix used for the projection
+*/
+void TACSModalTransient::setInitConditions(TACSBVec *u0, TACSBVec *udot0,
+                                           TACSMat *mmat) {
+  TACSVec *temp = mmat->createVec();
+  temp->incref();
+
+  if (u0) {
+    mmat->mult(u0, temp);
+    for (int i = 0; i < num_modes; i++) {
+      q0[i] = modes[i]->dot(temp);
+    }
+  } else {
+    for (int i = 0; i < num_modes; i++) {
+      q0[i] = 0.0;
+    }
+  }
+
+  if (udot0) {
+    mmat->mult(udot0, temp);
+    for (int i = 0; i < num_modes; i++) {
+      qdot0[i] = modes[i]->dot(temp);
+    }
+  } else {
+    for (int i = 0; i < num_modes; i++) {
+      qdot0[i] = 0.0;
+    }
+  }
+
+  temp->decref();
+}
+
+/*!
+  Integrate the decoupled modal equations over the time interval.
+
+  The modal load is interpolated linearly over each step and each
+  modal equation is advanced with the piecewise-exact solution of the
+  damped single degree-of-freedom oscillator: the update coefficients
+  are computed once per mode and each step costs a handful of flops.
+  Rigid-body modes (zero frequency) are advanced with the exact
+  polynomial response to the linearly varying load.
+
+  The step size therefore only needs to resolve the load history and
+  the output sampling - not the highest retained frequency.
+*/
+void TACSModalTransient::integrate() {
+  if (num_modes == 0) {
+    fprintf(stderr,
+            "TACSModalTransient: No modal basis - call extractModes() "
+            "before integrate()\n");
+    return;
+  }
+
+  double h = (tfinal - tinit) / num_time_steps;
+
+  // Allocate the modal coordinate histories
+  if (qhist) {
+    delete[] qhist;
+    delete[] qdhist;
+    delete[] qddhist;
+  }
+  int len = num_modes * (num_time_steps + 1);
+  qhist = new TacsScalar[len];
+  qdhist = new TacsScalar[len];
+  qddhist = new TacsScalar[len];
+
+  // Evaluate the scalar load history at the time planes
+  TacsScalar *scale = new TacsScalar[num_time_steps + 1];
+  for (int k = 0; k <= num_time_steps; k++) {
+    if (load_scale) {
+      scale[k] = load_scale(tinit + h * k, load_scale_ctx);
+    } else {
+      scale[k] = 1.0;
+    }
+  }
+
+  for (int i = 0; i < num_modes; i++) {
+    TacsScalar w = omega[i];
+    double z = zeta[i];
+
+    // Set the initial conditions for this mode
+    TacsScalar q = q0[i];
+    TacsScalar qd = qdot0[i];
+    TacsScalar p = fproj[i] * scale[0];
+    qhist[i] = q;
+    qdhist[i] = qd;
+    qddhist[i] = p - 2.0 * z * w * qd - w * w * q;
+
+    if (TacsRealPart(w) * h > 1e-12) {
+      // Compute the piecewise-exact update coefficients for a
+      // sub-critically damped oscillator with unit modal mass
+      double zr = sqrt(1.0 - z * z);
+      TacsScalar wd = zr * w;
+      TacsScalar wh = w * h;
+      TacsScalar w2 = w * w;
+      TacsScalar e = exp(-z * w * h);
+      TacsScalar s = sin(wd * h);
+      TacsScalar c = cos(wd * h);
+
+      TacsScalar A = e * ((z / zr) * s + c);
+      TacsScalar B = e * s / wd;
+      TacsScalar C =
+          (2.0 * z / wh +
+           e * (((1.0 - 2.0 * z * z) / (wd * h) - z / zr) * s -
+                (1.0 + 2.0 * z / wh) * c)) /
+          w2;
+      TacsScalar D = (1.0 - 2.0 * z / wh +
+                      e * ((2.0 * z * z - 1.0) / (wd * h) * s +
+                           (2.0 * z / wh) * c)) /
+                     w2;
+      TacsScalar Ad = -e * (w / zr) * s;
+      TacsScalar Bd = e * (c - (z / zr) * s);
+      TacsScalar Cd =
+          (-1.0 / h + e * ((w / zr + z / (h * zr)) * s + c / h)) / w2;
+      TacsScalar Dd = (1.0 - e * ((z / zr) * s + c)) / (w2 * h);
+
+      for (int k = 0; k < num_time_steps; k++) {
+        TacsScalar pk = fproj[i] * scale[k];
+        TacsScalar pk1 = fproj[i] * scale[k + 1];
+
+        TacsScalar q1 = A * q + B * qd + C * pk + D * pk1;
+        TacsScalar qd1 = Ad * q + Bd * qd + Cd * pk + Dd * pk1;
+        q = q1;
+        qd = qd1;
+
+        int index = num_modes * (k + 1) + i;
+        qhist[index] = q;
+        qdhist[index] = qd;
+        qddhist[index] = pk1 - 2.0 * z * w * qd - w2 * q;
+      }
+    } else {
+      // Rigid-body mode: integrate qddot = p(t) exactly for the
+      // linearly interpolated load
+      for (int k = 0; k < num_time_steps; k++) {
+        TacsScalar pk = fproj[i] * scale[k];
+        TacsScalar pk1 = fproj[i] * scale[k + 1];
+
+        q = q + h * qd + h * h * (pk / 3.0 + pk1 / 6.0);
+        qd = qd + 0.5 * h * (pk + pk1);
+
+        int index = num_modes * (k + 1) + i;
+        qhist[index] = q;
+        qdhist[index] = qd;
+        qddhist[index] = pk1;
+      }
+    }
+  }
+
+  delete[] scale;
+}
+
+/*
+  Retrieve the number of modes in the basis
+*/
+int TACSModalTransient::getNumModes() { return num_modes; }
+
+/*
+  Retrieve the natural frequency of the given mode
+*/
+TacsScalar TACSModalTransient::getFrequency(int mode) {
+  if (mode >= 0 && mode < num_modes) {
+    return omega[mode];
+  }
+  return 0.0;
+}
+
+/*
+  Retrieve the mode shape for the given mode, or NULL if it does not
+  exist
+*/
+TACSBVec *TACSModalTransient::getMode(int mode) {
+  if (mode >= 0 && mode < num_modes) {
+    return modes[mode];
+  }
+  return NULL;
+}
+
+/*
+  Retrieve pointers into the modal coordinate histories for the given
+  time step. The arrays hold one entry per mode.
+*/
+void TACSModalTransient::getModalCoordinates(int step, const TacsScalar **q,
+                                             const TacsScalar **qdot,
+                                             const TacsScalar **qddot) {
+  if (qhist && step >= 0 && step <= num_time_steps) {
+    if (q) {
+      *q = &qhist[num_modes * step];
+    }
+    if (qdot) {
+      *qdot = &qdhist[num_modes * step];
+    }
+    if (qddot) {
+      *qddot = &qddhist[num_modes * step];
+    }
+  } else {
+    if (q) {
+      *q = NULL;
+    }
+    if (qdot) {
+      *qdot = NULL;
+    }
+    if (qddot) {
+      *qddot = NULL;
+    }
+  }
+}
+
+/*!
+  Reconstruct the physical state at the given time step from the
+  modal coordinate history.
+
+  Only the requested vectors are assembled - any of the output
+  vectors may be NULL.
+
+  input:
+  step: the time step index
+
+  output:
+  u:     the displacement state, or NULL
+  udot:  the velocity state, or NULL
+  uddot: the acceleration state, or NULL
+
+  returns: the simulation time of the step
+*/
+double TACSModalTransient::reconstruct(int step, TACSBVec *u, TACSBVec *udot,
+                                       TACSBVec *uddot) {
+  double h = (tfinal - tinit) / num_time_steps;
+  if (!qhist || step < 0 || step > num_time_steps) {
+    fprintf(stderr,
+            "TACSModalTransient: Cannot reconstruct step %d - no history\n",
+            step);
+    return tinit;
+  }
+
+  if (u) {
+    u->zeroEntries();
+  }
+  if (udot) {
+    udot->zeroEntries();
+  }
+  if (uddot) {
+    uddot->zeroEntries();
+  }
+
+  for (int i = 0; i < num_modes; i++) {
+    int index = num_modes * step + i;
+    if (u) {
+      u->axpy(qhist[index], modes[i]);
+    }
+    if (udot) {
+      udot->axpy(qdhist[index], modes[i]);
+    }
+    if (uddot) {
+      uddot->axpy(qddhist[index], modes[i]);
+    }
+  }
+
+  return tinit + h * step;
+}
+
+/*
+  Reconstruct the state at the given time step, set it into the
+  assembler and write the output file through the element output
+  pipeline
+*/
+void TACSModalTransient::writeStepToF5(TACSToFH5 *f5, int step,
+                                       const char *filename) {
+  double t = reconstruct(step, uvec, vvec, avec);
+  assembler->setSimulationTime(t);
+  assembler->setVariables(uvec, vvec, avec);
+  f5->writeToFile(filename);
+}
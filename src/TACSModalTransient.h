@@ -0,0 +1,130 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_MODAL_TRANSIENT_H
+#define TACS_MODAL_TRANSIENT_H
+
+#include "TACSBuckling.h"
+#include "TACSToFH5.h"
+
+/*
+  A scalar load history evaluated at a simulation time. The context
+  pointer is passed through unchanged from setLoadScale().
+*/
+typedef TacsScalar (*TacsModalLoadScale)(double time, void *ctx);
+
+/**
+  Modal superposition engine for linear transient analysis.
+
+  For a linear structure, the transient response is dominated by a
+  small number of low-frequency modes, and the implicit time
+  integrators pay a full linear solve per step for information that a
+  modal basis captures directly. This class extracts a mass-normalized
+  modal basis from a TACSFrequencyAnalysis solve, projects the loads
+  onto the basis, and integrates the resulting decoupled single
+  degree-of-freedom modal equations
+
+  qddot_i + 2*zeta_i*omega_i*qdot_i + omega_i^2*q_i = p_i(t)
+
+  with the piecewise-exact method: the modal load is interpolated
+  linearly over each step and the single degree-of-freedom response is
+  advanced with the closed-form solution, so the step size is set by
+  the resolution of the load history rather than by stability or
+  accuracy limits of a time-marching scheme. The cost per step is a
+  handful of flops per mode.
+
+  The physical response is never stored - only the modal coordinate
+  histories are retained. Full state vectors for selected steps are
+  reconstructed on demand through reconstruct(), and writeStepToF5()
+  pushes a reconstructed state through the standard element output
+  pipeline.
+
+  Damping is specified in modal form, either as a uniform or per-mode
+  damping ratio or through Rayleigh coefficients. The modal basis is
+  assumed to be mass-normalized, which is the normalization produced
+  by the frequency analysis.
+*/
+class TACSModalTransient : public TACSObject {
+ public:
+  TACSModalTransient(TACSAssembler *_assembler, int _max_modes);
+  ~TACSModalTransient();
+
+  // Extract the modal basis from a frequency analysis
+  // -------------------------------------------------
+  int extractModes(TACSFrequencyAnalysis *freq, int num_modes);
+
+  // Set the modal damping ratios
+  // ----------------------------
+  void setModalDamping(double _zeta);
+  void setModalDamping(int mode, double _zeta);
+  void setRayleighDamping(double alpha, double beta);
+
+  // Set the time interval and the load history
+  // ------------------------------------------
+  void setTimeInterval(double _tinit, double _tfinal, int _num_steps);
+  void setLoads(TACSBVec *_forces);
+  void setLoadScale(TacsModalLoadScale _load_scale, void *_load_scale_ctx);
+
+  // Set the initial conditions by mass-orthogonal projection
+  // --------------------------------------------------------
+  void setInitConditions(TACSBVec *u0, TACSBVec *udot0, TACSMat *mmat);
+
+  // Integrate the decoupled modal equations over the time interval
+  // --------------------------------------------------------------
+  void integrate();
+
+  // Retrieve the modal data and the modal coordinate histories
+  // ----------------------------------------------------------
+  int getNumModes();
+  TacsScalar getFrequency(int mode);
+  TACSBVec *getMode(int mode);
+  void getModalCoordinates(int step, const TacsScalar **q,
+                           const TacsScalar **qdot, const TacsScalar **qddot);
+
+  // Reconstruct the physical state at a time step on demand
+  // -------------------------------------------------------
+  double reconstruct(int step, TACSBVec *u, TACSBVec *udot, TACSBVec *uddot);
+  void writeStepToF5(TACSToFH5 *f5, int step, const char *filename);
+
+ private:
+  // The assembler associated with the modal basis
+  TACSAssembler *assembler;
+
+  // The mass-normalized modal basis and the natural frequencies
+  int max_modes, num_modes;
+  TACSBVec **modes;
+  TacsScalar *omega;
+  double *zeta;
+
+  // The spatial load shape, its modal projection and the scalar load
+  // history applied to it
+  TACSBVec *forces;
+  TacsScalar *fproj;
+  TacsModalLoadScale load_scale;
+  void *load_scale_ctx;
+
+  // The initial modal coordinates
+  TacsScalar *q0, *qdot0;
+
+  // The time interval for the integration
+  int num_time_steps;
+  double tinit, tfinal;
+
+  // The modal coordinate histories, stored with the modes contiguous
+  // within each step: qhist[num_modes*step + mode]
+  TacsScalar *qhist, *qdhist, *qddhist;
+
+  // Work vectors for the reconstruction and output
+  TACSBVec *uvec, *vvec, *avec;
+};
+
+#endif  // TACS_MODAL_TRANSIENT_H
@@ -18,6 +18,8 @@
 
 #include "TACSObject.h"
 
+#include "TACSProfiler.h"
+
 /*
   Implementation of the reference counting TACSObject as well as
   initialization of MPI data for complex arithmetic
@@ -36,6 +38,19 @@ double TacsGetNumFlops() {
 
 void TacsZeroNumFlops() { tacs_local_flop_count = 0.0; }
 
+long tacs_local_alloc_count = 0;
+
+long TacsGetNumAllocations() {
+#ifdef TACS_LOG_ALLOCS
+  return tacs_local_alloc_count;
+#else
+  fprintf(stderr, "Warning: TACS not compiled with -DTACS_LOG_ALLOCS\n");
+  return 0;
+#endif
+}
+
+void TacsZeroNumAllocations() { tacs_local_alloc_count = 0; }
+
 /*
   These definite the min/max operations for complex values
 */
@@ -86,6 +101,11 @@ void TacsInitialize() {
     TACS_MPI_MAX = MPI_MAX;
     TACS_MPI_MIN = MPI_MIN;
 #endif
+
+    // Run the opt-in machine self-calibration for the profile summary
+    if (getenv("TACS_PROFILE_CALIBRATE")) {
+      TacsProfileCalibrate();
+    }
   }
   TacsInitialized++;
 }
@@ -96,6 +116,9 @@ void TacsFinalize() {
   TacsInitialized--;
 
   if (TacsInitialized == 0) {
+    // Write the profile summary if one was requested
+    TacsProfileWriteSummary(MPI_COMM_WORLD);
+
 #ifdef TACS_USE_COMPLEX
     MPI_Op_free(&TACS_MPI_MAX);
     MPI_Op_free(&TACS_MPI_MIN);
@@ -109,28 +132,39 @@ TACSObject::~TACSObject() {}
 
 /*
   Increase the reference count functions
+
+  Relaxed memory ordering is sufficient for the increment: a thread
+  can only take a new reference through a reference that it already
+  holds, so no memory needs to be synchronized here.
 */
-void TACSObject::incref() { ref_count++; }
+void TACSObject::incref() { ref_count.fetch_add(1, std::memory_order_relaxed); }
 
 /*
   Decrease the reference count
+
+  The decrement both releases the writes made through this reference
+  and acquires the writes released by the other references, so that
+  the thread that drops the count to zero observes the fully
+  constructed object state before deleting it.
 */
 void TACSObject::decref() {
-  ref_count--;
+  int count = ref_count.fetch_sub(1, std::memory_order_acq_rel) - 1;
 
-  if (ref_count == 0) {
+  if (count == 0) {
 #ifdef TACS_DEBUG
     fprintf(stderr, "Deleting object %s\n", this->getObjectName());
 #endif
     delete this;
-  } else if (ref_count < 0) {
+  } else if (count < 0) {
     fprintf(stderr, "Encountered a negative reference count for %s\n",
             this->getObjectName());
   }
 }
 
 //! Return the reference count
-int TACSObject::refcount() { return ref_count; }
+int TACSObject::refcount() {
+  return ref_count.load(std::memory_order_relaxed);
+}
 
 //! Return the name of the object
 const char *TACSObject::getObjectName() { return tacsDefault; }
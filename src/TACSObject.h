@@ -35,7 +35,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <atomic>
+
 #include "TacsComplexStep.h"
+#include "TacsDualNum.h"
 #include "mpi.h"
 
 extern MPI_Op TACS_MPI_MIN;
@@ -50,9 +53,18 @@ typedef double TacsReal;
 /*
   Define the basic scalar type TacsScalar
 */
+#if defined(TACS_USE_COMPLEX) && defined(TACS_USE_DUAL)
+#error "TACS_USE_COMPLEX and TACS_USE_DUAL cannot be combined"
+#endif
+
 #ifdef TACS_USE_COMPLEX
 #define TACS_MPI_TYPE MPI_DOUBLE_COMPLEX
 typedef TacsComplex TacsScalar;
+#elif defined(TACS_USE_DUAL)
+// A dual scalar is two contiguous doubles - (value, derivative) - and
+// sums reduce componentwise, so the complex MPI type is reused
+#define TACS_MPI_TYPE MPI_DOUBLE_COMPLEX
+typedef TacsDual TacsScalar;
 #else
 #define TACS_MPI_TYPE MPI_DOUBLE
 typedef double TacsScalar;
@@ -82,6 +94,30 @@ double TacsGetNumFlops();
 #define TacsAddFlops(flop)
 #endif
 
+/*
+  Keep track of the number of heap allocations performed by the
+  solver-level classes. This is used to audit the steady-state solve
+  loop: after the first solve, the count between two calls to
+  TacsGetNumAllocations() should be zero, and a regression that
+  introduces a per-iteration allocation shows up as a non-zero count.
+  Like the flop counter, this is not thread-safe and only logs the
+  allocation sites that have been instrumented.
+*/
+extern long tacs_local_alloc_count;
+
+// Zero the number of counted allocations
+void TacsZeroNumAllocations();
+
+// Retrieve the total number of counted allocations
+long TacsGetNumAllocations();
+
+// Macro to record an allocation
+#ifdef TACS_LOG_ALLOCS
+#define TacsAddAllocs(count) (tacs_local_alloc_count += (count));
+#else
+#define TacsAddAllocs(count)
+#endif
+
 /*
   Set up the define statements for beginning/ending a namespace
   environment
@@ -108,6 +144,15 @@ void TacsFinalize();
   TACSObject: The base class for all TACS objects to enable reference
   counting. In most cases this is sufficient to free any allocated
   memory.
+
+  The reference count itself is atomic, so incref()/decref() may be
+  called concurrently from several host threads without external
+  locking. Note that this makes the object lifetime thread-safe, not
+  the object: concurrent read-only access (e.g. TACSBVec::getValues(),
+  or querying a TACSBcMap once the boundary conditions have been
+  initialized) is safe, but operations that modify an object must
+  still be serialized by the caller unless their documentation states
+  otherwise.
 */
 class TACSObject {
  public:
@@ -135,7 +180,7 @@ class TACSObject {
   virtual const char *getObjectName();
 
  private:
-  int ref_count;
+  std::atomic<int> ref_count;
   static const char *tacsDefault;
 };
 
@@ -0,0 +1,328 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2014 Georgia Tech Research Corporation
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSParareal.h"
+
+/*
+  Create the Parareal driver.
+
+  The time interval [tinit, tfinal] is divided evenly into one chunk
+  per rank of the time communicator, and fine/coarse BDF propagators
+  are created over the local chunk. The coarse propagator defaults to
+  a loosened Newton tolerance of 1e-4; use setCoarseRelTol() or
+  getCoarsePropagator() to adjust it.
+
+  input:
+  assembler:              the TACSAssembler object (on the spatial comm)
+  time_comm:              communicator over the time chunks
+  tinit:                  start time of the full interval
+  tfinal:                 end time of the full interval
+  fine_steps_per_chunk:   fine time steps within each chunk
+  coarse_steps_per_chunk: coarse time steps within each chunk
+  max_bdf_order:          maximum order of the BDF schemes
+*/
+TACSPararealIntegrator::TACSPararealIntegrator(
+    TACSAssembler *_assembler, MPI_Comm _time_comm, double tinit, double tfinal,
+    int fine_steps_per_chunk, int coarse_steps_per_chunk, int max_bdf_order) {
+  assembler = _assembler;
+  assembler->incref();
+  time_comm = _time_comm;
+  MPI_Comm_rank(time_comm, &time_rank);
+  MPI_Comm_size(time_comm, &time_size);
+
+  // Compute the time interval owned by this chunk
+  double dt_chunk = (tfinal - tinit) / time_size;
+  chunk_tinit = tinit + time_rank * dt_chunk;
+  chunk_tfinal = chunk_tinit + dt_chunk;
+
+  // Create the fine and coarse propagators over the local chunk
+  num_fine_steps = fine_steps_per_chunk;
+  num_coarse_steps = coarse_steps_per_chunk;
+  fine = new TACSBDFIntegrator(assembler, chunk_tinit, chunk_tfinal,
+                               num_fine_steps, max_bdf_order);
+  fine->incref();
+  coarse = new TACSBDFIntegrator(assembler, chunk_tinit, chunk_tfinal,
+                                 num_coarse_steps, max_bdf_order);
+  coarse->incref();
+  coarse->setRelTol(1.0e-4);
+  coarse->setPrintLevel(0);
+
+  // Set the default Parareal iteration parameters
+  max_parareal_iters = 10;
+  parareal_rtol = 1.0e-8;
+  parareal_atol = 1.0e-12;
+
+  // Allocate the chunk-boundary state vectors
+  q0 = assembler->createVec();
+  q0->incref();
+  qdot0 = assembler->createVec();
+  qdot0->incref();
+  qF = assembler->createVec();
+  qF->incref();
+  qdotF = assembler->createVec();
+  qdotF->incref();
+  qG_prev = assembler->createVec();
+  qG_prev->incref();
+  qdotG_prev = assembler->createVec();
+  qdotG_prev->incref();
+  q1 = assembler->createVec();
+  q1->incref();
+  qdot1 = assembler->createVec();
+  qdot1->incref();
+  temp = assembler->createVec();
+  temp->incref();
+}
+
+/*
+  Free the propagators and boundary state vectors
+*/
+TACSPararealIntegrator::~TACSPararealIntegrator() {
+  fine->decref();
+  coarse->decref();
+  q0->decref();
+  qdot0->decref();
+  qF->decref();
+  qdotF->decref();
+  qG_prev->decref();
+  qdotG_prev->decref();
+  q1->decref();
+  qdot1->decref();
+  temp->decref();
+  assembler->decref();
+}
+
+/*
+  Set the maximum number of Parareal correction sweeps. The iteration
+  never exceeds the number of time chunks, after which the solution is
+  exact by construction.
+*/
+void TACSPararealIntegrator::setMaxPararealIterations(int max_iters) {
+  if (max_iters > 0) {
+    max_parareal_iters = max_iters;
+  }
+}
+
+/*
+  Set the relative/absolute tolerance on the chunk-boundary state jump
+  used to declare the Parareal iteration converged
+*/
+void TACSPararealIntegrator::setConvergenceTol(double rtol, double atol) {
+  parareal_rtol = rtol;
+  parareal_atol = atol;
+}
+
+/*
+  Set the relative Newton tolerance used by the coarse propagator
+*/
+void TACSPararealIntegrator::setCoarseRelTol(double rtol) {
+  coarse->setRelTol(rtol);
+}
+
+/*
+  Integrate forward in time using the Parareal iteration.
+
+  The initialization pass propagates the initial conditions through the
+  chunks with the coarse integrator in a sequential pipeline. Each
+  subsequent iteration runs the fine propagator concurrently on every
+  chunk from its current start state, then sweeps a coarse correction
+  through the time communicator to update the chunk-boundary states.
+
+  returns: the number of Parareal iterations performed, or -1 if a
+  propagation failed to converge
+*/
+int TACSPararealIntegrator::integrate() {
+  // Set the initial conditions on the first chunk
+  if (time_rank == 0) {
+    assembler->getInitConditions(q0, qdot0, NULL);
+  }
+
+  // Pipelined coarse initialization: receive the chunk-start state,
+  // propagate it with the coarse integrator and pass it on
+  if (time_rank > 0) {
+    recvStates(q0, qdot0, time_rank - 1);
+  }
+  int fail =
+      propagate(coarse, num_coarse_steps, q0, qdot0, qG_prev, qdotG_prev);
+  if (time_rank < time_size - 1) {
+    sendStates(qG_prev, qdotG_prev, time_rank + 1);
+  }
+  q1->copyValues(qG_prev);
+  qdot1->copyValues(qdotG_prev);
+
+  MPI_Allreduce(MPI_IN_PLACE, &fail, 1, MPI_INT, MPI_MAX, time_comm);
+  if (fail) {
+    return -1;
+  }
+
+  // After k iterations the first k chunks are exact, so never iterate
+  // more times than there are chunks
+  int max_iters = max_parareal_iters;
+  if (max_iters > time_size) {
+    max_iters = time_size;
+  }
+
+  int iter = 0;
+  while (iter < max_iters) {
+    // Fine propagation from the current chunk-start states. This is
+    // the expensive step and runs concurrently on all time ranks.
+    fail = propagate(fine, num_fine_steps, q0, qdot0, qF, qdotF);
+    MPI_Allreduce(MPI_IN_PLACE, &fail, 1, MPI_INT, MPI_MAX, time_comm);
+    if (fail) {
+      return -1;
+    }
+    iter++;
+
+    // Sequential correction sweep: receive the updated chunk-start
+    // state and record the jump from the previous iterate
+    double delta = 0.0, qnorm = 0.0;
+    if (time_rank > 0) {
+      temp->copyValues(q0);
+      recvStates(q0, qdot0, time_rank - 1);
+      temp->axpy(-1.0, q0);
+      delta = TacsRealPart(temp->norm());
+    }
+    qnorm = TacsRealPart(q0->norm());
+
+    // Form the correction F(U^k) - G(U^k) before qG_prev is overwritten
+    qF->axpy(-1.0, qG_prev);
+    qdotF->axpy(-1.0, qdotG_prev);
+
+    // Coarse propagation from the updated start state; keep the raw
+    // result for the next iteration's correction
+    fail = propagate(coarse, num_coarse_steps, q0, qdot0, qG_prev, qdotG_prev);
+
+    // Corrected chunk-end state: G(U^{k+1}) + F(U^k) - G(U^k)
+    q1->copyValues(qG_prev);
+    q1->axpy(1.0, qF);
+    qdot1->copyValues(qdotG_prev);
+    qdot1->axpy(1.0, qdotF);
+
+    if (time_rank < time_size - 1) {
+      sendStates(q1, qdot1, time_rank + 1);
+    }
+
+    // Check for failure and convergence across all chunks
+    MPI_Allreduce(MPI_IN_PLACE, &fail, 1, MPI_INT, MPI_MAX, time_comm);
+    if (fail) {
+      return -1;
+    }
+    double local[2] = {delta, qnorm}, global[2];
+    MPI_Allreduce(local, global, 2, MPI_DOUBLE, MPI_MAX, time_comm);
+    if (iter > 1 && global[0] <= parareal_atol + parareal_rtol * global[1]) {
+      break;
+    }
+  }
+
+  // Leave the fine solution over the local chunk consistent with the
+  // converged chunk-start state
+  fail = propagate(fine, num_fine_steps, q0, qdot0, qF, qdotF);
+  MPI_Allreduce(MPI_IN_PLACE, &fail, 1, MPI_INT, MPI_MAX, time_comm);
+  if (fail) {
+    return -1;
+  }
+  q1->copyValues(qF);
+  qdot1->copyValues(qdotF);
+
+  return iter;
+}
+
+/*
+  Retrieve the states at the end of the local chunk.
+
+  returns: the final time of the local chunk
+*/
+double TACSPararealIntegrator::getChunkStates(TACSBVec **q, TACSBVec **qdot) {
+  if (q) {
+    *q = q1;
+  }
+  if (qdot) {
+    *qdot = qdot1;
+  }
+  return chunk_tfinal;
+}
+
+/*
+  Retrieve the time interval associated with the local chunk
+*/
+void TACSPararealIntegrator::getChunkInterval(double *t0, double *t1) {
+  if (t0) {
+    *t0 = chunk_tinit;
+  }
+  if (t1) {
+    *t1 = chunk_tfinal;
+  }
+}
+
+/*
+  Access the fine propagator to adjust solver options or retrieve the
+  per-step states over the local chunk after integrate()
+*/
+TACSIntegrator *TACSPararealIntegrator::getFinePropagator() { return fine; }
+
+/*
+  Access the coarse propagator to adjust solver options
+*/
+TACSIntegrator *TACSPararealIntegrator::getCoarsePropagator() { return coarse; }
+
+/*
+  Propagate the states (_q0, _qdot0) across the local chunk using the
+  given integrator and copy the chunk-end states into (_q1, _qdot1)
+*/
+int TACSPararealIntegrator::propagate(TACSIntegrator *integ, int num_steps,
+                                      TACSBVec *_q0, TACSBVec *_qdot0,
+                                      TACSBVec *_q1, TACSBVec *_qdot1) {
+  // The chunk-start state becomes the initial condition for this run.
+  // The initial acceleration is recovered by the BDF start-up steps.
+  assembler->setInitConditions(_q0, _qdot0, NULL);
+
+  int fail = integ->integrate();
+  if (fail) {
+    return fail;
+  }
+
+  TACSBVec *qk, *qdotk;
+  integ->getStates(num_steps, &qk, &qdotk, NULL);
+  _q1->copyValues(qk);
+  _qdot1->copyValues(qdotk);
+
+  return 0;
+}
+
+/*
+  Send the chunk-boundary states to the corresponding spatial rank of
+  an adjacent time chunk
+*/
+void TACSPararealIntegrator::sendStates(TACSBVec *q, TACSBVec *qdot,
+                                        int dest) {
+  TacsScalar *array;
+  int size = q->getArray(&array);
+  MPI_Send(array, size, TACS_MPI_TYPE, dest, 1, time_comm);
+  qdot->getArray(&array);
+  MPI_Send(array, size, TACS_MPI_TYPE, dest, 2, time_comm);
+}
+
+/*
+  Receive the chunk-boundary states from the corresponding spatial rank
+  of an adjacent time chunk
+*/
+void TACSPararealIntegrator::recvStates(TACSBVec *q, TACSBVec *qdot,
+                                        int source) {
+  TacsScalar *array;
+  int size = q->getArray(&array);
+  MPI_Recv(array, size, TACS_MPI_TYPE, source, 1, time_comm,
+           MPI_STATUS_IGNORE);
+  qdot->getArray(&array);
+  MPI_Recv(array, size, TACS_MPI_TYPE, source, 2, time_comm,
+           MPI_STATUS_IGNORE);
+}
@@ -0,0 +1,116 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2014 Georgia Tech Research Corporation
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_PARAREAL_H
+#define TACS_PARAREAL_H
+
+#include "TACSIntegrator.h"
+
+/*
+  Parallel-in-time (Parareal) driver built on top of the existing
+  time-integration classes.
+
+  The full time interval [tinit, tfinal] is split into one chunk per
+  rank of the time communicator. Each time rank owns two BDF
+  integrators over its chunk: a fine propagator with the target step
+  size and tolerances, and a coarse propagator with a larger step size
+  and a looser Newton tolerance. The driver performs the standard
+  Parareal correction sweeps
+
+  U_{p+1}^{k+1} = G(U_{p}^{k+1}) + F(U_{p}^{k}) - G(U_{p}^{k})
+
+  where F and G denote fine and coarse propagation across chunk p. The
+  fine propagations run concurrently across all time ranks, while the
+  cheap coarse corrections sweep sequentially through the time
+  communicator. After k iterations the first k chunks are exact, so the
+  iteration terminates after at most as many sweeps as there are time
+  ranks.
+
+  Usage: split MPI_COMM_WORLD (or the analysis communicator) into a
+  spatial communicator and a time communicator, e.g. with two time
+  chunks per spatial partition of size nprocs/2:
+
+  MPI_Comm_split(comm, rank % (nprocs/2), rank, &spatial_comm);
+  MPI_Comm_split(comm, rank / (nprocs/2), rank, &time_comm);
+
+  The assembler must be created on the spatial communicator, and each
+  time rank must use an identical spatial partition so that the state
+  vectors can be exchanged directly between corresponding spatial ranks
+  of adjacent chunks. Boundary states are exchanged as (q, qdot) pairs;
+  the acceleration at each chunk start is recovered by the BDF start-up
+  procedure, so the scheme is best suited to first-order (e.g. thermal)
+  and lightly damped second-order problems.
+*/
+class TACSPararealIntegrator : public TACSObject {
+ public:
+  TACSPararealIntegrator(TACSAssembler *assembler, MPI_Comm time_comm,
+                         double tinit, double tfinal,
+                         int fine_steps_per_chunk, int coarse_steps_per_chunk,
+                         int max_bdf_order);
+  ~TACSPararealIntegrator();
+
+  // Set optional parameters for the Parareal iteration
+  void setMaxPararealIterations(int max_iters);
+  void setConvergenceTol(double rtol, double atol);
+  void setCoarseRelTol(double rtol);
+
+  // Integrate forward in time. Returns the number of Parareal
+  // iterations performed, or a negative value if a propagation failed.
+  int integrate();
+
+  // Retrieve the converged states at the end of the local chunk
+  double getChunkStates(TACSBVec **q, TACSBVec **qdot);
+
+  // Retrieve the time interval associated with the local chunk
+  void getChunkInterval(double *t0, double *t1);
+
+  // Access the underlying propagators to adjust solver options
+  TACSIntegrator *getFinePropagator();
+  TACSIntegrator *getCoarsePropagator();
+
+ private:
+  // Propagate (q0, qdot0) across the local chunk with the given
+  // integrator and copy the chunk-end states into (q1, qdot1)
+  int propagate(TACSIntegrator *integ, int num_steps, TACSBVec *q0,
+                TACSBVec *qdot0, TACSBVec *q1, TACSBVec *qdot1);
+
+  // Exchange chunk-boundary states between adjacent time ranks
+  void sendStates(TACSBVec *q, TACSBVec *qdot, int dest);
+  void recvStates(TACSBVec *q, TACSBVec *qdot, int source);
+
+  TACSAssembler *assembler;
+  MPI_Comm time_comm;
+  int time_rank, time_size;
+
+  // The time interval of the local chunk
+  double chunk_tinit, chunk_tfinal;
+
+  // The fine and coarse propagators over the local chunk
+  TACSBDFIntegrator *fine;
+  TACSBDFIntegrator *coarse;
+  int num_fine_steps, num_coarse_steps;
+
+  // Parareal iteration parameters
+  int max_parareal_iters;
+  double parareal_rtol, parareal_atol;
+
+  // Chunk-boundary state vectors
+  TACSBVec *q0, *qdot0;            // Current chunk-start state
+  TACSBVec *qF, *qdotF;            // Fine propagation from (q0, qdot0)
+  TACSBVec *qG_prev, *qdotG_prev;  // Coarse propagation from previous iterate
+  TACSBVec *q1, *qdot1;            // Corrected chunk-end state
+  TACSBVec *temp;                  // Temporary for convergence checks
+};
+
+#endif  // TACS_PARAREAL_H
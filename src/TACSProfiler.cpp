@@ -0,0 +1,651 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2014 Georgia Tech Research Corporation
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "BCSRMatImpl.h"
+#include "TACSProfiler.h"
+
+/*
+  The profile tables. The number of instrumented phases is small and
+  fixed at compile time in practice, so simple linear-scan tables are
+  used: with a handful of entries the lookup costs a few string
+  comparisons per phase, which is negligible against the cost of the
+  phases themselves.
+
+  The tables are process-global and are not thread-safe - phases are
+  only started and stopped from the serial sections of the code, never
+  from inside the pthread worker loops.
+*/
+static const int TACS_PROFILE_MAX_ENTRIES = 64;
+static const int TACS_PROFILE_NAME_LEN = 64;
+static const int TACS_PROFILE_MAX_DEPTH = 16;
+
+// A named timer entry
+struct TacsProfileTimerEntry {
+  char name[TACS_PROFILE_NAME_LEN];
+  double calls;  // The number of start/stop pairs
+  double incl;   // The inclusive time
+  double child;  // Time spent in enclosed phases
+  double flops;  // The recorded floating-point work
+  double bytes;  // The recorded memory traffic
+};
+
+// A named counter entry
+struct TacsProfileCountEntry {
+  char name[TACS_PROFILE_NAME_LEN];
+  double value;
+};
+
+static TacsProfileTimerEntry tacs_profile_timers[TACS_PROFILE_MAX_ENTRIES];
+static int tacs_profile_num_timers = 0;
+
+static TacsProfileCountEntry tacs_profile_counts[TACS_PROFILE_MAX_ENTRIES];
+static int tacs_profile_num_counts = 0;
+
+// The number of histogram bins for the MPI wait attribution. The bin
+// edges are powers of four starting from one microsecond, so twelve
+// bins span waits from under a microsecond to tens of seconds
+static const int TACS_PROFILE_WAIT_BINS = 12;
+
+// A tagged MPI-wait entry
+struct TacsProfileWaitEntry {
+  char name[TACS_PROFILE_NAME_LEN];
+  double calls;    // The number of recorded waits
+  double total;    // The accumulated wait time
+  double longest;  // The longest single wait
+  double hist[TACS_PROFILE_WAIT_BINS];  // Counts of waits per bin
+};
+
+static TacsProfileWaitEntry tacs_profile_waits[TACS_PROFILE_MAX_ENTRIES];
+static int tacs_profile_num_waits = 0;
+
+// The stack of active phases: the entry index and its start time
+static int tacs_profile_stack[TACS_PROFILE_MAX_DEPTH];
+static double tacs_profile_stack_time[TACS_PROFILE_MAX_DEPTH];
+static int tacs_profile_depth = 0;
+
+/*
+  Find the timer entry with the given name, creating it if needed.
+  Returns -1 if the table is full.
+*/
+static int tacs_profile_find_timer(const char *name) {
+  for (int i = 0; i < tacs_profile_num_timers; i++) {
+    if (strncmp(tacs_profile_timers[i].name, name, TACS_PROFILE_NAME_LEN) ==
+        0) {
+      return i;
+    }
+  }
+  if (tacs_profile_num_timers < TACS_PROFILE_MAX_ENTRIES) {
+    int i = tacs_profile_num_timers;
+    strncpy(tacs_profile_timers[i].name, name, TACS_PROFILE_NAME_LEN - 1);
+    tacs_profile_timers[i].name[TACS_PROFILE_NAME_LEN - 1] = '\0';
+    tacs_profile_timers[i].calls = 0.0;
+    tacs_profile_timers[i].incl = 0.0;
+    tacs_profile_timers[i].child = 0.0;
+    tacs_profile_timers[i].flops = 0.0;
+    tacs_profile_timers[i].bytes = 0.0;
+    tacs_profile_num_timers++;
+    return i;
+  }
+  return -1;
+}
+
+/*
+  Start a named profiling phase
+*/
+void TacsProfileStart(const char *name) {
+  if (tacs_profile_depth < TACS_PROFILE_MAX_DEPTH) {
+    int i = tacs_profile_find_timer(name);
+    tacs_profile_stack[tacs_profile_depth] = i;
+    tacs_profile_stack_time[tacs_profile_depth] = MPI_Wtime();
+  }
+  tacs_profile_depth++;
+}
+
+/*
+  Stop the innermost profiling phase. The elapsed time is added to the
+  phase, and also to the child time of the enclosing phase so that
+  exclusive times can be reported.
+*/
+void TacsProfileStop(const char *name) {
+  tacs_profile_depth--;
+  if (tacs_profile_depth >= 0 && tacs_profile_depth < TACS_PROFILE_MAX_DEPTH) {
+    int i = tacs_profile_stack[tacs_profile_depth];
+    if (i >= 0) {
+      double dt = MPI_Wtime() - tacs_profile_stack_time[tacs_profile_depth];
+      tacs_profile_timers[i].calls += 1.0;
+      tacs_profile_timers[i].incl += dt;
+
+      if (tacs_profile_depth > 0) {
+        int parent = tacs_profile_stack[tacs_profile_depth - 1];
+        if (parent >= 0) {
+          tacs_profile_timers[parent].child += dt;
+        }
+      }
+    }
+  }
+}
+
+/*
+  Accumulate a value into a named counter
+*/
+void TacsProfileAddCount(const char *name, double value) {
+  for (int i = 0; i < tacs_profile_num_counts; i++) {
+    if (strncmp(tacs_profile_counts[i].name, name, TACS_PROFILE_NAME_LEN) ==
+        0) {
+      tacs_profile_counts[i].value += value;
+      return;
+    }
+  }
+  if (tacs_profile_num_counts < TACS_PROFILE_MAX_ENTRIES) {
+    int i = tacs_profile_num_counts;
+    strncpy(tacs_profile_counts[i].name, name, TACS_PROFILE_NAME_LEN - 1);
+    tacs_profile_counts[i].name[TACS_PROFILE_NAME_LEN - 1] = '\0';
+    tacs_profile_counts[i].value = value;
+    tacs_profile_num_counts++;
+  }
+}
+
+/*
+  Record the time spent blocked in a tagged MPI wait
+*/
+void TacsProfileAddWait(const char *name, double seconds) {
+  int i = 0;
+  while (i < tacs_profile_num_waits &&
+         strncmp(tacs_profile_waits[i].name, name, TACS_PROFILE_NAME_LEN) !=
+             0) {
+    i++;
+  }
+  if (i == tacs_profile_num_waits) {
+    if (tacs_profile_num_waits == TACS_PROFILE_MAX_ENTRIES) {
+      return;
+    }
+    strncpy(tacs_profile_waits[i].name, name, TACS_PROFILE_NAME_LEN - 1);
+    tacs_profile_waits[i].name[TACS_PROFILE_NAME_LEN - 1] = '\0';
+    tacs_profile_waits[i].calls = 0.0;
+    tacs_profile_waits[i].total = 0.0;
+    tacs_profile_waits[i].longest = 0.0;
+    memset(tacs_profile_waits[i].hist, 0,
+           TACS_PROFILE_WAIT_BINS * sizeof(double));
+    tacs_profile_num_waits++;
+  }
+
+  tacs_profile_waits[i].calls += 1.0;
+  tacs_profile_waits[i].total += seconds;
+  if (seconds > tacs_profile_waits[i].longest) {
+    tacs_profile_waits[i].longest = seconds;
+  }
+
+  // Find the histogram bin for the wait duration
+  int bin = 0;
+  double edge = 1e-6;
+  while (bin < TACS_PROFILE_WAIT_BINS - 1 && seconds >= edge) {
+    edge *= 4.0;
+    bin++;
+  }
+  tacs_profile_waits[i].hist[bin] += 1.0;
+}
+
+/*
+  Record the work content of a named phase
+*/
+void TacsProfileAddWork(const char *name, double flops, double bytes) {
+  int i = tacs_profile_find_timer(name);
+  if (i >= 0) {
+    tacs_profile_timers[i].flops += flops;
+    tacs_profile_timers[i].bytes += bytes;
+  }
+}
+
+/*
+  The measured machine limits from TacsProfileCalibrate(). These
+  remain zero until the calibration has been run, in which case the
+  roofline column of the summary is reported as zero.
+*/
+static double tacs_profile_peak_bw = 0.0;     // bytes/second
+static double tacs_profile_peak_flops = 0.0;  // flops/second
+
+/*
+  Measure the memory bandwidth of a STREAM-style triad. The arrays are
+  sized well beyond the last-level cache so that the loop streams
+  through main memory, and the best rate over several repetitions is
+  taken to discard warm-up effects.
+*/
+static double tacs_profile_measure_bandwidth() {
+  const int n = 1 << 22;
+  double *a = new double[n];
+  double *b = new double[n];
+  double *c = new double[n];
+  for (int i = 0; i < n; i++) {
+    a[i] = 0.0;
+    b[i] = 1.0;
+    c[i] = 2.0;
+  }
+
+  double best = 0.0;
+  for (int rep = 0; rep < 5; rep++) {
+    double t = MPI_Wtime();
+    for (int i = 0; i < n; i++) {
+      a[i] = b[i] + 0.5 * c[i];
+    }
+    t = MPI_Wtime() - t;
+
+    // One read of b, one read of c and one write of a per iteration
+    double rate = 24.0 * n / t;
+    if (rate > best) {
+      best = rate;
+    }
+  }
+
+  // Keep the result observable so that the loop is not optimized away
+  if (a[n - 1] != 2.0) {
+    fprintf(stderr, "TacsProfileCalibrate: bandwidth check failed\n");
+  }
+
+  delete[] a;
+  delete[] b;
+  delete[] c;
+  return best;
+}
+
+/*
+  Measure the dense compute peak with a small cache-resident
+  matrix-matrix product. The loop order vectorizes over the columns of
+  the output, so the measured rate reflects the SIMD throughput of the
+  processor rather than its memory system.
+*/
+static double tacs_profile_measure_flops() {
+  const int m = 48;
+  double *A = new double[m * m];
+  double *B = new double[m * m];
+  double *C = new double[m * m];
+  for (int i = 0; i < m * m; i++) {
+    A[i] = 1.0 / (1.0 + i);
+    B[i] = 1.0 / (2.0 + i);
+    C[i] = 0.0;
+  }
+
+  const int nreps = 100;
+  double best = 0.0;
+  for (int rep = 0; rep < 3; rep++) {
+    double t = MPI_Wtime();
+    for (int r = 0; r < nreps; r++) {
+      for (int i = 0; i < m; i++) {
+        for (int k = 0; k < m; k++) {
+          double aik = A[m * i + k];
+          for (int j = 0; j < m; j++) {
+            C[m * i + j] += aik * B[m * k + j];
+          }
+        }
+      }
+    }
+    t = MPI_Wtime() - t;
+
+    double rate = 2.0 * m * m * m * nreps / t;
+    if (rate > best) {
+      best = rate;
+    }
+  }
+
+  if (C[0] != C[0]) {
+    fprintf(stderr, "TacsProfileCalibrate: compute check failed\n");
+  }
+
+  delete[] A;
+  delete[] B;
+  delete[] C;
+  return best;
+}
+
+/*
+  Time a reference run of the production BCSR matrix-vector kernel for
+  the given block size on a synthetic block-banded matrix with 27
+  blocks per row - the bandwidth of a structured 3D grid. The achieved
+  rate and the fraction of the measured roofline are recorded as
+  counters so that they appear in the summary with the spread over all
+  ranks.
+*/
+static void tacs_profile_measure_bcsr(int bsize) {
+  const int nrows = 2048;
+  const int band = 13;
+
+  BCSRMatData *data = new BCSRMatData(bsize, nrows, nrows);
+  data->incref();
+
+  // Build the banded non-zero pattern
+  data->rowp = new int[nrows + 1];
+  data->diag = new int[nrows];
+  data->rowp[0] = 0;
+  int nnz = 0;
+  for (int i = 0; i < nrows; i++) {
+    int start = (i > band ? i - band : 0);
+    int end = (i + band + 1 < nrows ? i + band + 1 : nrows);
+    nnz += end - start;
+    data->rowp[i + 1] = nnz;
+  }
+  data->cols = new int[nnz];
+  for (int i = 0, p = 0; i < nrows; i++) {
+    int start = (i > band ? i - band : 0);
+    int end = (i + band + 1 < nrows ? i + band + 1 : nrows);
+    for (int j = start; j < end; j++, p++) {
+      data->cols[p] = j;
+      if (j == i) {
+        data->diag[i] = p;
+      }
+    }
+  }
+
+  const int b2 = bsize * bsize;
+  data->A = new TacsScalar[b2 * nnz];
+  for (int i = 0; i < b2 * nnz; i++) {
+    data->A[i] = 1.0 / (1.0 + (i % 97));
+  }
+
+  TacsScalar *x = new TacsScalar[bsize * nrows];
+  TacsScalar *y = new TacsScalar[bsize * nrows];
+  for (int i = 0; i < bsize * nrows; i++) {
+    x[i] = 1.0;
+  }
+
+  // Select the same kernel that BCSRMat would use in production
+  void (*kernel)(BCSRMatData *, TacsScalar *, TacsScalar *) = NULL;
+  if (bsize == 6) {
+    kernel = BCSRMatVecMult6;
+  } else {
+    kernel = BCSRMatVecMult8;
+  }
+#ifdef TACS_BCSR_SIMD
+  if (BCSRMatGetSimdLevel() >= 2) {
+    kernel = (bsize == 6 ? BCSRMatVecMult6Avx512 : BCSRMatVecMult8Avx512);
+  } else if (BCSRMatGetSimdLevel() == 1) {
+    kernel = (bsize == 6 ? BCSRMatVecMult6Avx2 : BCSRMatVecMult8Avx2);
+  }
+#endif  // TACS_BCSR_SIMD
+
+  // Warm up, then take the best rate over several repetitions
+  kernel(data, x, y);
+
+  const int nreps = 20;
+  double best_time = 1e20;
+  for (int rep = 0; rep < 3; rep++) {
+    double t = MPI_Wtime();
+    for (int r = 0; r < nreps; r++) {
+      kernel(data, x, y);
+    }
+    t = MPI_Wtime() - t;
+    if (t < best_time) {
+      best_time = t;
+    }
+  }
+
+  // The flops and the memory traffic of one matrix-vector product:
+  // each block is multiplied once and streamed from memory together
+  // with its column index
+  double flops = 2.0 * b2 * nnz;
+  double bytes = (sizeof(TacsScalar) * b2 + sizeof(int)) * (double)nnz;
+  double rate = flops * nreps / best_time;
+
+  // The attainable time from the measured roofline
+  double bound = flops / tacs_profile_peak_flops;
+  if (bytes / tacs_profile_peak_bw > bound) {
+    bound = bytes / tacs_profile_peak_bw;
+  }
+  double pct = 100.0 * bound * nreps / best_time;
+
+  char name[TACS_PROFILE_NAME_LEN];
+  snprintf(name, sizeof(name), "calibrate.BCSRMatVecMult%d.GFLOPS", bsize);
+  TacsProfileAddCount(name, 1e-9 * rate);
+  snprintf(name, sizeof(name), "calibrate.BCSRMatVecMult%d.roofline_pct",
+           bsize);
+  TacsProfileAddCount(name, pct);
+
+  // Release the synthetic matrix without disturbing the allocation
+  // accounting performed for production matrices
+  delete[] data->A;
+  data->A = NULL;
+  data->decref();
+  delete[] x;
+  delete[] y;
+}
+
+/*
+  Run the machine self-calibration.
+
+  The measured memory bandwidth and compute peak define the roofline
+  that phases with recorded work content are reported against, and the
+  reference BCSR matrix-vector runs give a known-kernel baseline for
+  each processor. All of the results are recorded as counters, so the
+  summary reports the spread of every quantity over the ranks - on a
+  heterogeneous allocation this shows directly which machine
+  generation is the outlier.
+*/
+void TacsProfileCalibrate() {
+  tacs_profile_peak_bw = tacs_profile_measure_bandwidth();
+  tacs_profile_peak_flops = tacs_profile_measure_flops();
+
+  TacsProfileAddCount("calibrate.stream_GBps", 1e-9 * tacs_profile_peak_bw);
+  TacsProfileAddCount("calibrate.dense_GFLOPS",
+                      1e-9 * tacs_profile_peak_flops);
+
+  tacs_profile_measure_bcsr(6);
+  tacs_profile_measure_bcsr(8);
+}
+
+/*
+  Write the aggregated profile summary in CSV form.
+
+  The entry list from the root rank defines the rows of the summary;
+  ranks that never entered a phase contribute zero to it. For each
+  timer the minimum, mean and maximum inclusive time over the ranks is
+  reported together with the mean exclusive time; for each counter the
+  sum, minimum, mean and maximum of the per-rank totals is reported.
+  Timers with recorded work content additionally report the achieved
+  GFLOP/s and GB/s rates, and - when the startup calibration has been
+  run - the mean percentage of the measured roofline.
+
+  This is collective on the communicator. It is a no-op unless the
+  environment variable TACS_PROFILE_OUTPUT names the output file.
+*/
+void TacsProfileWriteSummary(MPI_Comm comm) {
+  const char *fname = getenv("TACS_PROFILE_OUTPUT");
+  if (!fname) {
+    return;
+  }
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  // Broadcast the entry names from the root so that every rank
+  // contributes values in the same order
+  int counts[3];
+  counts[0] = tacs_profile_num_timers;
+  counts[1] = tacs_profile_num_counts;
+  counts[2] = tacs_profile_num_waits;
+  MPI_Bcast(counts, 3, MPI_INT, 0, comm);
+  int ntimers = counts[0], ncounts = counts[1], nwaits = counts[2];
+
+  char *names =
+      new char[(ntimers + ncounts + nwaits) * TACS_PROFILE_NAME_LEN];
+  if (rank == 0) {
+    for (int i = 0; i < ntimers; i++) {
+      memcpy(&names[i * TACS_PROFILE_NAME_LEN], tacs_profile_timers[i].name,
+             TACS_PROFILE_NAME_LEN);
+    }
+    for (int i = 0; i < ncounts; i++) {
+      memcpy(&names[(ntimers + i) * TACS_PROFILE_NAME_LEN],
+             tacs_profile_counts[i].name, TACS_PROFILE_NAME_LEN);
+    }
+    for (int i = 0; i < nwaits; i++) {
+      memcpy(&names[(ntimers + ncounts + i) * TACS_PROFILE_NAME_LEN],
+             tacs_profile_waits[i].name, TACS_PROFILE_NAME_LEN);
+    }
+  }
+  MPI_Bcast(names, (ntimers + ncounts + nwaits) * TACS_PROFILE_NAME_LEN,
+            MPI_CHAR, 0, comm);
+
+  // Assemble the local values: calls, inclusive and exclusive time,
+  // recorded work and the local roofline fraction for each timer,
+  // then the counter values. The roofline fraction compares the
+  // inclusive time against the attainable time from the measured
+  // machine limits and is computed per rank, so each processor is
+  // judged against its own calibration.
+  const int wstride = 3 + TACS_PROFILE_WAIT_BINS;
+  int nvals = 6 * ntimers + ncounts + wstride * nwaits;
+  double *vals = new double[nvals];
+  memset(vals, 0, nvals * sizeof(double));
+  for (int i = 0; i < ntimers; i++) {
+    int j = tacs_profile_find_timer(&names[i * TACS_PROFILE_NAME_LEN]);
+    if (j >= 0) {
+      vals[6 * i] = tacs_profile_timers[j].calls;
+      vals[6 * i + 1] = tacs_profile_timers[j].incl;
+      vals[6 * i + 2] =
+          tacs_profile_timers[j].incl - tacs_profile_timers[j].child;
+      vals[6 * i + 3] = tacs_profile_timers[j].flops;
+      vals[6 * i + 4] = tacs_profile_timers[j].bytes;
+
+      if (tacs_profile_peak_bw > 0.0 && tacs_profile_timers[j].incl > 0.0) {
+        double bound = tacs_profile_timers[j].flops / tacs_profile_peak_flops;
+        if (tacs_profile_timers[j].bytes / tacs_profile_peak_bw > bound) {
+          bound = tacs_profile_timers[j].bytes / tacs_profile_peak_bw;
+        }
+        vals[6 * i + 5] = 100.0 * bound / tacs_profile_timers[j].incl;
+      }
+    }
+  }
+  for (int i = 0; i < ncounts; i++) {
+    const char *name = &names[(ntimers + i) * TACS_PROFILE_NAME_LEN];
+    for (int j = 0; j < tacs_profile_num_counts; j++) {
+      if (strncmp(tacs_profile_counts[j].name, name,
+                  TACS_PROFILE_NAME_LEN) == 0) {
+        vals[6 * ntimers + i] = tacs_profile_counts[j].value;
+        break;
+      }
+    }
+  }
+  for (int i = 0; i < nwaits; i++) {
+    const char *name = &names[(ntimers + ncounts + i) * TACS_PROFILE_NAME_LEN];
+    for (int j = 0; j < tacs_profile_num_waits; j++) {
+      if (strncmp(tacs_profile_waits[j].name, name, TACS_PROFILE_NAME_LEN) ==
+          0) {
+        double *w = &vals[6 * ntimers + ncounts + wstride * i];
+        w[0] = tacs_profile_waits[j].calls;
+        w[1] = tacs_profile_waits[j].total;
+        w[2] = tacs_profile_waits[j].longest;
+        memcpy(&w[3], tacs_profile_waits[j].hist,
+               TACS_PROFILE_WAIT_BINS * sizeof(double));
+        break;
+      }
+    }
+  }
+
+  // Reduce the sums, minima and maxima onto the root
+  double *vsum = NULL, *vmin = NULL, *vmax = NULL;
+  if (rank == 0) {
+    vsum = new double[nvals];
+    vmin = new double[nvals];
+    vmax = new double[nvals];
+  }
+  MPI_Reduce(vals, vsum, nvals, MPI_DOUBLE, MPI_SUM, 0, comm);
+  MPI_Reduce(vals, vmin, nvals, MPI_DOUBLE, MPI_MIN, 0, comm);
+  MPI_Reduce(vals, vmax, nvals, MPI_DOUBLE, MPI_MAX, 0, comm);
+
+  // Locate the rank with the largest total wait in each wait phase
+  typedef struct {
+    double value;
+    int rank;
+  } TacsProfileWaitLoc;
+  TacsProfileWaitLoc *wloc = NULL, *wmax = NULL;
+  if (nwaits > 0) {
+    wloc = new TacsProfileWaitLoc[nwaits];
+    for (int i = 0; i < nwaits; i++) {
+      wloc[i].value = vals[6 * ntimers + ncounts + wstride * i + 1];
+      wloc[i].rank = rank;
+    }
+    if (rank == 0) {
+      wmax = new TacsProfileWaitLoc[nwaits];
+    }
+    MPI_Reduce(wloc, wmax, nwaits, MPI_DOUBLE_INT, MPI_MAXLOC, 0, comm);
+  }
+
+  if (rank == 0) {
+    FILE *fp = fopen(fname, "w");
+    if (fp) {
+      fprintf(fp, "# TACS profile summary on %d ranks\n", size);
+      fprintf(fp,
+              "type, name, calls, incl_min, incl_mean, incl_max, "
+              "excl_mean, gflops, gbps, roofline_pct_mean\n");
+      for (int i = 0; i < ntimers; i++) {
+        // The achieved rates from the aggregated work and time; zero
+        // when no work content was recorded for the phase
+        double gflops = 0.0, gbps = 0.0;
+        if (vsum[6 * i + 1] > 0.0) {
+          gflops = 1e-9 * vsum[6 * i + 3] / vsum[6 * i + 1];
+          gbps = 1e-9 * vsum[6 * i + 4] / vsum[6 * i + 1];
+        }
+        fprintf(fp, "timer, %s, %.0f, %.6e, %.6e, %.6e, %.6e, %.3f, "
+                "%.3f, %.1f\n",
+                &names[i * TACS_PROFILE_NAME_LEN], vsum[6 * i] / size,
+                vmin[6 * i + 1], vsum[6 * i + 1] / size, vmax[6 * i + 1],
+                vsum[6 * i + 2] / size, gflops, gbps, vsum[6 * i + 5] / size);
+      }
+      for (int i = 0; i < ncounts; i++) {
+        int j = 6 * ntimers + i;
+        fprintf(fp, "counter, %s, %.0f, %.6e, %.6e, %.6e, 0, 0, 0, 0\n",
+                &names[(ntimers + i) * TACS_PROFILE_NAME_LEN], vsum[j],
+                vmin[j], vsum[j] / size, vmax[j]);
+      }
+      if (nwaits > 0) {
+        fprintf(fp,
+                "# MPI wait attribution: histogram bins are powers of "
+                "four from 1 microsecond\n");
+        fprintf(fp,
+                "# wait, name, calls, wait_min, wait_mean, wait_max, "
+                "max_rank, straggler, longest, hist[12]\n");
+      }
+      for (int i = 0; i < nwaits; i++) {
+        int j = 6 * ntimers + ncounts + wstride * i;
+        double mean = vsum[j + 1] / size;
+
+        // Flag the phase when the largest per-rank wait time is more
+        // than twice the mean over the ranks. The rank reported in
+        // the max_rank column is then waiting on a straggler
+        int flag = (mean > 0.0 && vmax[j + 1] > 2.0 * mean);
+        fprintf(fp, "wait, %s, %.0f, %.6e, %.6e, %.6e, %d, %d, %.6e",
+                &names[(ntimers + ncounts + i) * TACS_PROFILE_NAME_LEN],
+                vsum[j] / size, vmin[j + 1], mean, vmax[j + 1], wmax[i].rank,
+                flag, vmax[j + 2]);
+        for (int b = 0; b < TACS_PROFILE_WAIT_BINS; b++) {
+          fprintf(fp, ", %.0f", vsum[j + 3 + b]);
+        }
+        fprintf(fp, "\n");
+      }
+      fclose(fp);
+    } else {
+      fprintf(stderr, "TacsProfileWriteSummary: could not open file %s\n",
+              fname);
+    }
+    delete[] vsum;
+    delete[] vmin;
+    delete[] vmax;
+    if (wmax) {
+      delete[] wmax;
+    }
+  }
+
+  if (wloc) {
+    delete[] wloc;
+  }
+  delete[] names;
+  delete[] vals;
+}
@@ -0,0 +1,96 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2014 Georgia Tech Research Corporation
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_PROFILER_H
+#define TACS_PROFILER_H
+
+#include "TACSObject.h"
+
+/*
+  Lightweight always-compiled instrumentation for the hot phases of an
+  analysis: assembly, factorization, Krylov solves and file output.
+
+  Phases are identified by name and may nest - the summary reports
+  both the inclusive time of each phase and the time exclusive of
+  enclosed phases. Counters accumulate event totals (elements
+  assembled, Krylov iterations, bytes written) alongside the timers.
+
+  The instrumentation is cheap enough to leave on in production: a
+  phase costs two calls to MPI_Wtime() and a lookup in a small table,
+  and the phases instrumented are coarse (an entire assembly or
+  solve), so the overhead is far below measurement noise.
+
+  A per-rank aggregated summary (min/max/mean over all ranks) is
+  written in CSV form from TacsFinalize() when the environment
+  variable TACS_PROFILE_OUTPUT names an output file. When the variable
+  is unset, nothing is written and no collective communication takes
+  place.
+
+  The MPI wait attribution records the time the communication calls
+  in the bpmat layer spend blocked, tagged by the phase that issued
+  them. The summary reports a per-phase histogram of the individual
+  wait durations aggregated over the ranks and flags the phases in
+  which the per-rank wait times are strongly imbalanced, together
+  with the rank that waited longest - the first step of a straggler
+  diagnosis without attaching an external tracing tool.
+
+  An optional startup self-calibration measures the machine limits -
+  STREAM-style memory bandwidth, dense compute peak and reference runs
+  of the production BCSR matrix-vector kernels - so that phases with
+  recorded work content can be reported as a percentage of the
+  measured roofline. The calibration runs from TacsInitialize() when
+  the environment variable TACS_PROFILE_CALIBRATE is set and costs a
+  fraction of a second per process.
+*/
+
+// Start/stop a named profiling phase. Each start must be matched by a
+// stop of the same name; phases nest in LIFO order
+void TacsProfileStart(const char *name);
+void TacsProfileStop(const char *name);
+
+// Accumulate a value into a named counter
+void TacsProfileAddCount(const char *name, double value);
+
+// Record the time spent blocked in a tagged MPI wait. The waits are
+// reported separately from the timers, with a histogram of the wait
+// durations and straggler detection over the ranks
+void TacsProfileAddWait(const char *name, double seconds);
+
+// Record the floating-point and memory-traffic content of a named
+// phase. The totals feed the roofline column of the summary when the
+// calibration has been run
+void TacsProfileAddWork(const char *name, double flops, double bytes);
+
+// Run the machine self-calibration. Called from TacsInitialize() when
+// the environment variable TACS_PROFILE_CALIBRATE is set
+void TacsProfileCalibrate();
+
+// Write the MPI-aggregated summary. This is collective on the
+// communicator and is called from TacsFinalize()
+void TacsProfileWriteSummary(MPI_Comm comm);
+
+/*
+  Scoped timer: starts its phase on construction and stops it on
+  destruction, so early returns are handled automatically
+*/
+class TacsProfileScope {
+ public:
+  TacsProfileScope(const char *_name) : name(_name) { TacsProfileStart(name); }
+  ~TacsProfileScope() { TacsProfileStop(name); }
+
+ private:
+  const char *name;
+};
+
+#endif  // TACS_PROFILER_H
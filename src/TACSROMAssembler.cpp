@@ -0,0 +1,520 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSROMAssembler.h"
+
+#include "tacslapack.h"
+
+/*
+  Create the reduced-order model object
+
+  input:
+  assembler:      the full-order assembler
+  max_snapshots:  the maximum number of snapshots that can be stored
+*/
+TACSROMAssembler::TACSROMAssembler(TACSAssembler *_assembler,
+                                   int _max_snapshots) {
+  assembler = _assembler;
+  assembler->incref();
+
+  // Allocate the snapshot storage
+  max_snapshots = (_max_snapshots > 0 ? _max_snapshots : 1);
+  num_snapshots = 0;
+  snapshots = new TACSBVec *[max_snapshots];
+
+  // No basis has been computed yet
+  num_modes = 0;
+  basis = NULL;
+  ref_state = NULL;
+  ref_proj = NULL;
+
+  // No element-sampling domain by default - the residual is
+  // assembled over the full domain
+  num_samples = 0;
+  sample_elems = NULL;
+  sample_weights = NULL;
+
+  // The element scratch space is allocated with the sampling domain
+  elem_Xpts = NULL;
+  elem_vars = elem_dvars = elem_ddvars = NULL;
+  elem_res = NULL;
+
+  // Create the work vectors
+  full_work = assembler->createVec();
+  full_work->incref();
+  full_res = assembler->createVec();
+  full_res->incref();
+}
+
+/*
+  Free the reduced-order model data
+*/
+TACSROMAssembler::~TACSROMAssembler() {
+  assembler->decref();
+  for (int i = 0; i < num_snapshots; i++) {
+    snapshots[i]->decref();
+  }
+  delete[] snapshots;
+  if (basis) {
+    for (int k = 0; k < num_modes; k++) {
+      basis[k]->decref();
+    }
+    delete[] basis;
+  }
+  if (ref_state) {
+    ref_state->decref();
+  }
+  if (ref_proj) {
+    delete[] ref_proj;
+  }
+  if (sample_elems) {
+    delete[] sample_elems;
+    delete[] sample_weights;
+  }
+  if (elem_Xpts) {
+    delete[] elem_Xpts;
+    delete[] elem_vars;
+    delete[] elem_dvars;
+    delete[] elem_ddvars;
+    delete[] elem_res;
+  }
+  full_work->decref();
+  full_res->decref();
+}
+
+/*
+  Store a copy of the given solution vector as a snapshot.
+
+  returns: the snapshot index, or -1 if the storage is full
+*/
+int TACSROMAssembler::addSnapshot(TACSBVec *vec) {
+  if (num_snapshots >= max_snapshots) {
+    fprintf(stderr,
+            "TACSROMAssembler: Snapshot storage is full (%d snapshots)\n",
+            max_snapshots);
+    return -1;
+  }
+
+  TACSBVec *snap = assembler->createVec();
+  snap->incref();
+  snap->copyValues(vec);
+  snapshots[num_snapshots] = snap;
+  num_snapshots++;
+
+  return num_snapshots - 1;
+}
+
+/*
+  Get the number of stored snapshots
+*/
+int TACSROMAssembler::getNumSnapshots() { return num_snapshots; }
+
+/*
+  Compute the POD basis from the stored snapshots with the method of
+  snapshots.
+
+  The mean snapshot is used as the reference state. The Gram matrix
+  of the centered snapshots is formed from parallel inner products
+  and decomposed with a dense symmetric eigensolve - the centering
+  terms are expanded analytically so the snapshots themselves are
+  never modified. The basis vectors are the linear combinations of
+  the snapshots given by the dominant eigenvectors, scaled so the
+  basis is orthonormal.
+
+  input:
+  max_modes:   the maximum number of basis vectors to retain
+  energy_tol:  drop modes whose eigenvalue is below this fraction of
+               the largest eigenvalue
+
+  returns: the number of basis vectors retained
+*/
+int TACSROMAssembler::computeBasis(int max_modes, double energy_tol) {
+  if (num_snapshots <= 0) {
+    fprintf(stderr, "TACSROMAssembler: No snapshots have been collected\n");
+    return 0;
+  }
+
+  // Free any previously computed basis
+  if (basis) {
+    for (int k = 0; k < num_modes; k++) {
+      basis[k]->decref();
+    }
+    delete[] basis;
+    basis = NULL;
+  }
+  if (ref_state) {
+    ref_state->decref();
+  }
+  if (ref_proj) {
+    delete[] ref_proj;
+    ref_proj = NULL;
+  }
+  num_modes = 0;
+
+  // Compute the mean snapshot as the reference state
+  int m = num_snapshots;
+  ref_state = assembler->createVec();
+  ref_state->incref();
+  for (int j = 0; j < m; j++) {
+    ref_state->axpy(1.0 / m, snapshots[j]);
+  }
+
+  // Form the Gram matrix of the centered snapshots:
+  // G[i,j] = (s[i] - sbar)^{T} (s[j] - sbar)
+  //        = s[i]^{T} s[j] - d[i] - d[j] + sbar^{T} sbar
+  double *d = new double[m];
+  for (int j = 0; j < m; j++) {
+    d[j] = TacsRealPart(snapshots[j]->dot(ref_state));
+  }
+  double mean2 = TacsRealPart(ref_state->dot(ref_state));
+
+  double *G = new double[m * m];
+  for (int j = 0; j < m; j++) {
+    for (int i = 0; i <= j; i++) {
+      double sij = TacsRealPart(snapshots[i]->dot(snapshots[j]));
+      G[i + m * j] = sij - d[i] - d[j] + mean2;
+      G[j + m * i] = G[i + m * j];
+    }
+  }
+
+  // Compute the eigenvalues/vectors of the Gram matrix. The
+  // eigenvalues are sorted in ascending order.
+  const char *jobz = "V", *uplo = "U";
+  int n = m, lwork = 16 * m, info = 0;
+  double *eigs = new double[m];
+  double *work = new double[lwork];
+  LAPACKdsyev(jobz, uplo, &n, G, &n, eigs, work, &lwork, &info);
+  delete[] work;
+
+  if (info != 0) {
+    fprintf(stderr, "TACSROMAssembler: Error in LAPACK function dsyev\n");
+    delete[] d;
+    delete[] G;
+    delete[] eigs;
+    return 0;
+  }
+
+  // Count the number of modes to retain, starting from the largest
+  // eigenvalue
+  if (max_modes <= 0 || max_modes > m) {
+    max_modes = m;
+  }
+  int nmodes = 0;
+  while (nmodes < max_modes && eigs[m - 1 - nmodes] > 0.0 &&
+         eigs[m - 1 - nmodes] > energy_tol * eigs[m - 1]) {
+    nmodes++;
+  }
+
+  if (nmodes == 0) {
+    fprintf(stderr, "TACSROMAssembler: No modes above the energy tolerance\n");
+    delete[] d;
+    delete[] G;
+    delete[] eigs;
+    return 0;
+  }
+
+  // Form the basis vectors from the snapshot combinations:
+  // phi[k] = sum_j v[j,k] (s[j] - sbar) / sqrt(lambda[k])
+  basis = new TACSBVec *[nmodes];
+  for (int k = 0; k < nmodes; k++) {
+    const double *v = &G[m * (m - 1 - k)];
+
+    TACSBVec *phi = assembler->createVec();
+    phi->incref();
+
+    double vsum = 0.0;
+    for (int j = 0; j < m; j++) {
+      phi->axpy(v[j], snapshots[j]);
+      vsum += v[j];
+    }
+    phi->axpy(-vsum, ref_state);
+    phi->scale(1.0 / sqrt(eigs[m - 1 - k]));
+
+    // Zero the basis entries at the boundary conditions - the
+    // boundary values are carried by the reference state
+    assembler->applyBCs(phi);
+
+    basis[k] = phi;
+  }
+  num_modes = nmodes;
+
+  // Record the projection of the reference state onto the basis
+  ref_proj = new TacsScalar[num_modes];
+  for (int k = 0; k < num_modes; k++) {
+    ref_proj[k] = basis[k]->dot(ref_state);
+  }
+
+  delete[] d;
+  delete[] G;
+  delete[] eigs;
+
+  return num_modes;
+}
+
+/*
+  Get the number of basis vectors
+*/
+int TACSROMAssembler::getNumBasisVectors() { return num_modes; }
+
+/*
+  Get the k-th basis vector, or NULL if it does not exist
+*/
+TACSBVec *TACSROMAssembler::getBasisVector(int k) {
+  if (k >= 0 && k < num_modes) {
+    return basis[k];
+  }
+  return NULL;
+}
+
+/*
+  Project the given full-order vector onto the basis, relative to the
+  reference state: q[k] = phi[k]^{T} (vec - ref)
+*/
+void TACSROMAssembler::projectVector(TACSBVec *vec, TacsScalar *q) {
+  for (int k = 0; k < num_modes; k++) {
+    q[k] = basis[k]->dot(vec) - ref_proj[k];
+  }
+}
+
+/*
+  Reconstruct the full-order vector from the reduced coordinates:
+  vec = ref + sum_k q[k] phi[k]
+*/
+void TACSROMAssembler::expandVector(const TacsScalar *q, TACSBVec *vec) {
+  vec->copyValues(ref_state);
+  for (int k = 0; k < num_modes; k++) {
+    vec->axpy(q[k], basis[k]);
+  }
+}
+
+/*
+  Set the element-sampling domain for the hyper-reduced residual
+  evaluation.
+
+  When a sampling domain is set, the residual is evaluated only over
+  the given subset of the local elements, with each element
+  contribution scaled by its weight. Calling this function with no
+  elements restores the full residual assembly.
+
+  input:
+  num_samples:     the number of sampled local elements
+  sample_elems:    the local element numbers
+  sample_weights:  the weight applied to each element contribution
+*/
+void TACSROMAssembler::setSampleElements(int _num_samples,
+                                         const int *_sample_elems,
+                                         const double *_sample_weights) {
+  if (sample_elems) {
+    delete[] sample_elems;
+    delete[] sample_weights;
+    sample_elems = NULL;
+    sample_weights = NULL;
+  }
+  num_samples = 0;
+
+  if (_num_samples > 0) {
+    int nelems = assembler->getNumElements();
+    for (int i = 0; i < _num_samples; i++) {
+      if (_sample_elems[i] < 0 || _sample_elems[i] >= nelems) {
+        fprintf(stderr,
+                "TACSROMAssembler: Sample element %d out of range [0, %d)\n",
+                _sample_elems[i], nelems);
+        return;
+      }
+    }
+
+    num_samples = _num_samples;
+    sample_elems = new int[num_samples];
+    sample_weights = new double[num_samples];
+    memcpy(sample_elems, _sample_elems, num_samples * sizeof(int));
+    memcpy(sample_weights, _sample_weights, num_samples * sizeof(double));
+
+    // Allocate the element-level scratch space
+    if (!elem_Xpts) {
+      int max_nodes = assembler->getMaxElementNodes();
+      int max_vars = assembler->getMaxElementVariables();
+      elem_Xpts = new TacsScalar[3 * max_nodes];
+      elem_vars = new TacsScalar[max_vars];
+      elem_dvars = new TacsScalar[max_vars];
+      elem_ddvars = new TacsScalar[max_vars];
+      elem_res = new TacsScalar[max_vars];
+    }
+  }
+}
+
+/*
+  Evaluate the residual about the current state of the assembler,
+  using either the full assembly or the sampled element subset
+*/
+void TACSROMAssembler::evalResidual(TACSBVec *res) {
+  if (num_samples > 0) {
+    res->zeroEntries();
+    double time = assembler->getSimulationTime();
+
+    for (int i = 0; i < num_samples; i++) {
+      int elem = sample_elems[i];
+      TACSElement *element = assembler->getElement(elem, elem_Xpts, elem_vars,
+                                                   elem_dvars, elem_ddvars);
+      if (!element) {
+        continue;
+      }
+
+      // Evaluate the weighted element residual
+      int nvars = element->getNumVariables();
+      memset(elem_res, 0, nvars * sizeof(TacsScalar));
+      element->addResidual(elem, time, elem_Xpts, elem_vars, elem_dvars,
+                           elem_ddvars, elem_res);
+      for (int k = 0; k < nvars; k++) {
+        elem_res[k] *= sample_weights[i];
+      }
+
+      // Add the contribution into the residual vector
+      int len;
+      const int *nodes;
+      assembler->getElement(elem, &len, &nodes);
+      res->setValues(len, nodes, elem_res, TACS_ADD_VALUES);
+    }
+
+    // Collect the off-processor contributions and apply the
+    // boundary conditions
+    res->beginSetValues(TACS_ADD_VALUES);
+    res->endSetValues(TACS_ADD_VALUES);
+    assembler->applyBCs(res);
+  } else {
+    assembler->assembleRes(res);
+  }
+}
+
+/*
+  Assemble the projected residual about the reconstructed state:
+  rr = Phi^{T} r(ref + Phi q)
+*/
+void TACSROMAssembler::assembleReducedRes(const TacsScalar *q,
+                                          TacsScalar *rr) {
+  expandVector(q, full_work);
+  assembler->setVariables(full_work);
+  evalResidual(full_res);
+
+  for (int k = 0; k < num_modes; k++) {
+    rr[k] = basis[k]->dot(full_res);
+  }
+}
+
+/*
+  Assemble the projected Jacobian about the current state:
+  Jr = Phi^{T} K Phi
+
+  The Jacobian is assembled into the given full-order matrix and the
+  reduced matrix is formed from matrix-vector products against the
+  basis vectors. Jr is stored in column-major order on all processes.
+*/
+void TACSROMAssembler::assembleReducedJacobian(TACSMat *mat, TacsScalar *Jr) {
+  assembler->assembleJacobian(1.0, 0.0, 0.0, NULL, mat);
+
+  for (int j = 0; j < num_modes; j++) {
+    mat->mult(basis[j], full_work);
+    for (int i = 0; i < num_modes; i++) {
+      Jr[i + num_modes * j] = basis[i]->dot(full_work);
+    }
+  }
+}
+
+/*
+  Approximately solve the full-order problem with a Newton iteration
+  in the reduced coordinates.
+
+  The iteration starts from the projection of the current state of
+  the assembler. Each iteration assembles the (possibly sampled)
+  residual about the reconstructed state, projects it onto the basis,
+  forms the reduced Jacobian and solves the dense reduced system
+  redundantly on every process. On exit the assembler state is set to
+  the reconstructed solution.
+
+  input:
+  mat:              the full-order matrix used for the Jacobian
+  max_newton_iters: the maximum number of Newton iterations
+  rtol:             relative tolerance on the projected residual
+  atol:             absolute tolerance on the projected residual
+  ksm_print:        optional object for printing the convergence
+
+  returns: the number of iterations, or -1 if not converged
+*/
+int TACSROMAssembler::solve(TACSMat *mat, int max_newton_iters, double rtol,
+                            double atol, KSMPrint *ksm_print) {
+  if (num_modes <= 0) {
+    fprintf(stderr,
+            "TACSROMAssembler: Must call computeBasis() before solve()\n");
+    return -1;
+  }
+
+  int m = num_modes;
+  TacsScalar *q = new TacsScalar[m];
+  TacsScalar *rr = new TacsScalar[m];
+  TacsScalar *Jr = new TacsScalar[m * m];
+  int *ipiv = new int[m];
+
+  // Project the current state onto the basis
+  assembler->getVariables(full_work);
+  projectVector(full_work, q);
+
+  double init_norm = 0.0;
+  int converged = -1;
+
+  for (int iter = 0; iter < max_newton_iters; iter++) {
+    // Assemble and project the residual about the current iterate
+    assembleReducedRes(q, rr);
+
+    double norm = 0.0;
+    for (int k = 0; k < m; k++) {
+      norm += TacsRealPart(rr[k]) * TacsRealPart(rr[k]);
+    }
+    norm = sqrt(norm);
+
+    if (ksm_print) {
+      ksm_print->printResidual(iter, norm);
+    }
+    if (iter == 0) {
+      init_norm = norm;
+    }
+    if (norm < atol || norm < rtol * init_norm) {
+      converged = iter;
+      break;
+    }
+
+    // Form the reduced Jacobian and compute the Newton update
+    assembleReducedJacobian(mat, Jr);
+
+    int info = 0;
+    TacsLAPACKgesv(m, 1, Jr, ipiv, rr, &info);
+    if (info != 0) {
+      fprintf(stderr,
+              "TACSROMAssembler: Error in LAPACK function gesv, info = %d\n",
+              info);
+      break;
+    }
+
+    for (int k = 0; k < m; k++) {
+      q[k] -= rr[k];
+    }
+  }
+
+  // Leave the assembler state at the reconstructed solution
+  expandVector(q, full_work);
+  assembler->setVariables(full_work);
+
+  delete[] q;
+  delete[] rr;
+  delete[] Jr;
+  delete[] ipiv;
+
+  return converged;
+}
@@ -0,0 +1,116 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_ROM_ASSEMBLER_H
+#define TACS_ROM_ASSEMBLER_H
+
+#include "TACSAssembler.h"
+
+/**
+  Galerkin reduced-order model built from solution snapshots.
+
+  The class collects solution snapshots during full-order solves,
+  computes a proper orthogonal decomposition (POD) basis and then
+  projects the residual and Jacobian of the full-order model onto the
+  span of that basis. The resulting dense reduced system is orders of
+  magnitude cheaper to solve than the full-order problem, which makes
+  it suitable for screening large numbers of load cases before
+  committing to full solves.
+
+  The POD basis is computed with the method of snapshots: the small
+  snapshot Gram matrix is formed with parallel inner products and
+  decomposed with a dense symmetric eigensolve, so no distributed SVD
+  is required. The snapshot mean is used as the reference state and
+  the basis spans the centered snapshots.
+
+  The reduced solve is a Newton iteration in the reduced coordinates:
+  the full residual is assembled about the reconstructed state and
+  projected onto the basis, the reduced Jacobian is formed from
+  matrix-vector products against the basis vectors, and the dense
+  system is solved redundantly on every processor.
+
+  An element-sampling (hyper-reduction) mode can replace the full
+  residual assembly: setSampleElements() restricts the residual
+  evaluation to a weighted subset of the local elements, reusing the
+  per-element machinery of the underlying TACSAssembler. The weights
+  should be fit so that the sampled residual reproduces the projected
+  residual over the snapshot set.
+*/
+class TACSROMAssembler : public TACSObject {
+ public:
+  TACSROMAssembler(TACSAssembler *_assembler, int _max_snapshots);
+  virtual ~TACSROMAssembler();
+
+  // Collect solution snapshots from full-order solves
+  // -------------------------------------------------
+  int addSnapshot(TACSBVec *vec);
+  int getNumSnapshots();
+
+  // Compute the POD basis from the snapshots
+  // ----------------------------------------
+  int computeBasis(int max_modes, double energy_tol = 1e-8);
+  int getNumBasisVectors();
+  TACSBVec *getBasisVector(int k);
+
+  // Transfer between full and reduced coordinates
+  // ---------------------------------------------
+  void projectVector(TACSBVec *vec, TacsScalar *q);
+  void expandVector(const TacsScalar *q, TACSBVec *vec);
+
+  // Set the element-sampling (hyper-reduction) domain
+  // -------------------------------------------------
+  void setSampleElements(int _num_samples, const int *_sample_elems,
+                         const double *_sample_weights);
+
+  // Assemble the projected residual and Jacobian
+  // --------------------------------------------
+  void assembleReducedRes(const TacsScalar *q, TacsScalar *rr);
+  void assembleReducedJacobian(TACSMat *mat, TacsScalar *Jr);
+
+  // Approximately solve the full-order problem in the reduced space
+  // ---------------------------------------------------------------
+  int solve(TACSMat *mat, int max_newton_iters = 10, double rtol = 1e-6,
+            double atol = 1e-30, KSMPrint *ksm_print = NULL);
+
+ private:
+  // Evaluate the full or sampled residual about the current state
+  void evalResidual(TACSBVec *res);
+
+  // The full-order assembler
+  TACSAssembler *assembler;
+
+  // The snapshot storage
+  int max_snapshots;
+  int num_snapshots;
+  TACSBVec **snapshots;
+
+  // The POD basis and the reference (mean snapshot) state
+  int num_modes;
+  TACSBVec **basis;
+  TACSBVec *ref_state;
+  TacsScalar *ref_proj;
+
+  // The element-sampling domain for hyper-reduction
+  int num_samples;
+  int *sample_elems;
+  double *sample_weights;
+
+  // Scratch space for the sampled element evaluation
+  TacsScalar *elem_Xpts;
+  TacsScalar *elem_vars, *elem_dvars, *elem_ddvars;
+  TacsScalar *elem_res;
+
+  // Work vectors for the reduced assembly and solve
+  TACSBVec *full_work, *full_res;
+};
+
+#endif  // TACS_ROM_ASSEMBLER_H
@@ -625,15 +625,23 @@ void TACSLinearSpectralMg::MgData::restriction(TACSSpectralVec *in,
       }
 
     } else {
-      // Use a straight injection in time
+      // Use a straight injection in time. All the time instances are
+      // restricted in a single multi-vector operation so that the
+      // interpolation weights are only streamed once.
+      TACSBVec **invecs = new TACSBVec *[N];
+      TACSBVec **outvecs = new TACSBVec *[N];
       for (int i = 0; i < N; i++) {
-        TACSBVec *invec = in->getVec(i);
-        TACSBVec *outvec = out->getVec(i);
-        interp->multTranspose(invec, outvec);
+        invecs[i] = in->getVec(i);
+        outvecs[i] = out->getVec(i);
+      }
+      interp->multTranspose(N, invecs, outvecs);
 
-        // Apply boundary conditions at this new level
-        outvec->applyBCs(assembler->getBcMap());
+      // Apply boundary conditions at this new level
+      for (int i = 0; i < N; i++) {
+        outvecs[i]->applyBCs(assembler->getBcMap());
       }
+      delete[] invecs;
+      delete[] outvecs;
     }
   }
 }
@@ -679,17 +687,25 @@ void TACSLinearSpectralMg::MgData::interpolateAdd(TACSSpectralVec *in,
         }
       }
     } else {
-      // For now, use a straight injection in time
+      // For now, use a straight injection in time. All the time
+      // instances are interpolated in a single multi-vector operation
+      // so that the interpolation weights are only streamed once.
+      TACSBVec **invecs = new TACSBVec *[N];
+      TACSBVec **outvecs = new TACSBVec *[N];
       for (int i = 0; i < N; i++) {
-        TACSBVec *invec = in->getVec(i);
-        TACSBVec *outvec = out->getVec(i);
-        interp->multAdd(invec, outvec, outvec);
+        invecs[i] = in->getVec(i);
+        outvecs[i] = out->getVec(i);
+      }
+      interp->multAdd(N, invecs, outvecs, outvecs);
 
-        // Apply boundary conditions on the fine mesh
+      // Apply boundary conditions on the fine mesh
+      for (int i = 0; i < N; i++) {
         if (fine) {
-          outvec->applyBCs(fine->assembler->getBcMap());
+          outvecs[i]->applyBCs(fine->assembler->getBcMap());
         }
       }
+      delete[] invecs;
+      delete[] outvecs;
     }
   }
 }
@@ -744,6 +760,87 @@ void TACSLinearSpectralMg::applyMg(int level) {
   data[level]->applyFactor(data[level]->b, data[level]->x);
 }
 
+/*
+  Block-diagonal preconditioner for a spectral problem in TACS
+*/
+TACSLinearSpectralBlockPc::TACSLinearSpectralBlockPc(
+    TACSLinearSpectralMat *_mat) {
+  mat = _mat;
+  mat->incref();
+
+  // Copy the first-order coefficients that set the diagonal shifts
+  const double *d;
+  N = mat->getFirstOrderCoefficients(&d);
+  d0 = new double[N];
+  for (int i = 0; i < N; i++) {
+    d0[i] = d[i];
+  }
+
+  // Allocate the shifted matrix and factorization for each time instance
+  TACSParallelMat *H;
+  mat->getMat(&H, NULL);
+
+  block_mats = new TACSParallelMat *[N];
+  block_pcs = new TACSBlockCyclicPc *[N];
+  for (int i = 0; i < N; i++) {
+    block_mats[i] = dynamic_cast<TACSParallelMat *>(H->createDuplicate());
+    block_mats[i]->incref();
+    block_pcs[i] = new TACSBlockCyclicPc(block_mats[i]);
+    block_pcs[i]->incref();
+  }
+}
+
+TACSLinearSpectralBlockPc::~TACSLinearSpectralBlockPc() {
+  mat->decref();
+  delete[] d0;
+  for (int i = 0; i < N; i++) {
+    block_mats[i]->decref();
+    block_pcs[i]->decref();
+  }
+  delete[] block_mats;
+  delete[] block_pcs;
+}
+
+/*
+  Factor the shifted matrix for each time instance
+*/
+void TACSLinearSpectralBlockPc::factor() {
+  TACSParallelMat *H, *C;
+  mat->getMat(&H, &C);
+
+  for (int i = 0; i < N; i++) {
+    block_mats[i]->copyValues(H);
+    block_mats[i]->axpy(d0[i], C);
+    block_pcs[i]->factor();
+  }
+}
+
+/*
+  Apply the block-diagonal preconditioner
+
+  [ (H + d0[0] * C) |                                   ][out[0]] = [in[0]]
+  [                 | (H + d0[1] * C) |                 ][out[1]] = [in[1]]
+  [                                   | (H + d0[2] * C) ][out[2]] = [in[2]]
+
+  The per-instance solves are independent of one another. The diagonal
+  blocks are the same for both matrix orientations, so no orientation
+  check is needed here.
+*/
+void TACSLinearSpectralBlockPc::applyFactor(TACSVec *invec, TACSVec *outvec) {
+  TACSSpectralVec *in = dynamic_cast<TACSSpectralVec *>(invec);
+  TACSSpectralVec *out = dynamic_cast<TACSSpectralVec *>(outvec);
+
+  if (in && out) {
+    for (int i = 0; i < N; i++) {
+      block_pcs[i]->applyFactor(in->getVec(i), out->getVec(i));
+    }
+  } else {
+    fprintf(stderr,
+            "TACSLinearSpectralBlockPc type error: Input/output must be "
+            "TACSSpectralVec\n");
+  }
+}
+
 TACSSpectralIntegrator::TACSSpectralIntegrator(TACSAssembler *_assembler,
                                                double _tfinal, int _N) {
   N = _N;
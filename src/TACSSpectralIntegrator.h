@@ -152,6 +152,36 @@ class TACSLinearSpectralMg : public TACSPc {
   TACSLinearSpectralMat *mat;
 };
 
+/*
+  Block-diagonal (Jacobi-in-time) preconditioner for a spectral problem.
+
+  Dropping the sub-diagonal temporal coupling from the first-order
+  approximation of the spectral operator leaves one independent spatial
+  problem (H + d0[i] * C) per time instance. Each block is factored
+  with a direct block-cyclic factorization and the per-instance solves
+  are fully decoupled, in contrast to the sequential sweeps performed
+  by the multigrid smoother.
+*/
+class TACSLinearSpectralBlockPc : public TACSPc {
+ public:
+  TACSLinearSpectralBlockPc(TACSLinearSpectralMat *_mat);
+  ~TACSLinearSpectralBlockPc();
+
+  void factor();
+  void applyFactor(TACSVec *in, TACSVec *out);
+
+ private:
+  TACSLinearSpectralMat *mat;
+
+  // The number of time instances (excluding the initial condition)
+  int N;
+  double *d0;
+
+  // The shifted matrix and factorization for each time instance
+  TACSParallelMat **block_mats;
+  TACSBlockCyclicPc **block_pcs;
+};
+
 class TACSSpectralIntegrator : public TACSObject {
  public:
   TACSSpectralIntegrator(TACSAssembler *_assembler, double tfinal, int N);
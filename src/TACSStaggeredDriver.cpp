@@ -0,0 +1,387 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSStaggeredDriver.h"
+
+#include <stdio.h>
+
+const char *TACSStaggeredDriver::driverName = "TACSStaggeredDriver";
+
+/*!
+  Create the staggered thermal-structural driver.
+
+  The matrix, preconditioner and solver for each field must be
+  created for the corresponding assembler and associated with one
+  another by the caller. When the two assemblers use different node
+  maps, the interpolation must be created between the thermal and
+  structural node maps with the thermal block size.
+
+  input:
+  thermal:    the assembler for the thermal field
+  tmat:       the thermal Jacobian matrix
+  tpc:        the preconditioner for the thermal matrix
+  tsolver:    the Krylov solver associated with tmat/tpc
+  structural: the assembler for the structural field
+  smat:       the structural Jacobian matrix
+  spc:        the preconditioner for the structural matrix
+  ssolver:    the Krylov solver associated with smat/spc
+  interp:     the thermal-to-structural transfer (may be NULL)
+*/
+TACSStaggeredDriver::TACSStaggeredDriver(
+    TACSAssembler *_thermal, TACSMat *_tmat, TACSPc *_tpc, TACSKsm *_tsolver,
+    TACSAssembler *_structural, TACSMat *_smat, TACSPc *_spc, TACSKsm *_ssolver,
+    TACSBVecInterp *_interp) {
+  thermal = _thermal;
+  thermal->incref();
+  tmat = _tmat;
+  tmat->incref();
+  tpc = _tpc;
+  tpc->incref();
+  tsolver = _tsolver;
+  tsolver->incref();
+
+  structural = _structural;
+  structural->incref();
+  smat = _smat;
+  smat->incref();
+  spc = _spc;
+  spc->incref();
+  ssolver = _ssolver;
+  ssolver->incref();
+
+  interp = _interp;
+  if (interp) {
+    interp->incref();
+  }
+
+  // Create the solution, residual and update vectors
+  tvars = thermal->createVec();
+  tvars->incref();
+  tres = thermal->createVec();
+  tres->incref();
+  tupdate = thermal->createVec();
+  tupdate->incref();
+  twork = thermal->createVec();
+  twork->incref();
+
+  svars = structural->createVec();
+  svars->incref();
+  sres = structural->createVec();
+  sres->incref();
+  supdate = structural->createVec();
+  supdate->incref();
+
+  // Create the transferred temperature and the scalar work vector on
+  // the structural mesh. When the fields share the node map the
+  // thermal vectors are used directly.
+  temp_s = NULL;
+  work_s = NULL;
+  if (interp) {
+    temp_s = new TACSBVec(structural->getNodeMap(), thermal->getVarsPerNode());
+    temp_s->incref();
+    work_s = new TACSBVec(structural->getNodeMap(), thermal->getVarsPerNode());
+    work_s->incref();
+  }
+
+  tloads = NULL;
+  sloads = NULL;
+  tcoup = NULL;
+  fcoup = NULL;
+
+  rtol = 1e-8;
+  omega = 1.0;
+  max_iters = 25;
+  initialized = 0;
+}
+
+/*!
+  Free the data allocated by the driver
+*/
+TACSStaggeredDriver::~TACSStaggeredDriver() {
+  tvars->decref();
+  tres->decref();
+  tupdate->decref();
+  twork->decref();
+  svars->decref();
+  sres->decref();
+  supdate->decref();
+
+  if (temp_s) {
+    temp_s->decref();
+  }
+  if (work_s) {
+    work_s->decref();
+  }
+  if (tloads) {
+    tloads->decref();
+  }
+  if (sloads) {
+    sloads->decref();
+  }
+  if (tcoup) {
+    tcoup->decref();
+  }
+  if (fcoup) {
+    fcoup->decref();
+  }
+  if (interp) {
+    interp->decref();
+  }
+
+  thermal->decref();
+  tmat->decref();
+  tpc->decref();
+  tsolver->decref();
+  structural->decref();
+  smat->decref();
+  spc->decref();
+  ssolver->decref();
+}
+
+/*!
+  Set the applied loads for the two fields. Either vector may be NULL
+  when the corresponding field has no applied load.
+*/
+void TACSStaggeredDriver::setLoads(TACSBVec *_tloads, TACSBVec *_sloads) {
+  if (_tloads) {
+    _tloads->incref();
+  }
+  if (tloads) {
+    tloads->decref();
+  }
+  tloads = _tloads;
+
+  if (_sloads) {
+    _sloads->incref();
+  }
+  if (sloads) {
+    sloads->decref();
+  }
+  sloads = _sloads;
+}
+
+/*!
+  Set the lumped nodal coupling coefficients.
+
+  Both vectors are in the structural solution space. The structural
+  load at each node is the nodal entries of tcoup scaled by the
+  transferred temperature at the node; the thermal source at each
+  node is the inner product of the nodal entries of fcoup with the
+  structural state at the node. A NULL vector disables the
+  corresponding coupling direction.
+*/
+void TACSStaggeredDriver::setCouplingVectors(TACSBVec *_tcoup,
+                                             TACSBVec *_fcoup) {
+  if (_tcoup) {
+    _tcoup->incref();
+  }
+  if (tcoup) {
+    tcoup->decref();
+  }
+  tcoup = _tcoup;
+
+  if (_fcoup) {
+    _fcoup->incref();
+  }
+  if (fcoup) {
+    fcoup->decref();
+  }
+  fcoup = _fcoup;
+}
+
+/*!
+  Set the relative tolerance on the solution updates and the maximum
+  number of coupling iterations
+*/
+void TACSStaggeredDriver::setConvergenceCriteria(double _rtol,
+                                                 int _max_iters) {
+  rtol = _rtol;
+  if (_max_iters > 0) {
+    max_iters = _max_iters;
+  }
+}
+
+/*!
+  Set the under-relaxation factor applied to the solution updates
+*/
+void TACSStaggeredDriver::setRelaxationFactor(double _omega) {
+  if (_omega > 0.0) {
+    omega = _omega;
+  }
+}
+
+/*!
+  Assemble and factor the Jacobians of both fields.
+
+  This is called automatically on the first solve. Call it again
+  after the design or mesh changes to refresh the factorizations -
+  the coupling iterations themselves never re-factor.
+*/
+void TACSStaggeredDriver::initialize() {
+  thermal->setVariables(tvars);
+  thermal->assembleJacobian(1.0, 0.0, 0.0, NULL, tmat);
+  tpc->factor();
+
+  structural->setVariables(svars);
+  structural->assembleJacobian(1.0, 0.0, 0.0, NULL, smat);
+  spc->factor();
+
+  initialized = 1;
+}
+
+/*!
+  Add the coupling term to the structural right-hand side.
+
+  input:
+  temp: the temperature on the structural mesh
+  srhs: the structural right-hand side
+*/
+void TACSStaggeredDriver::addStructuralCoupling(TACSBVec *temp,
+                                                TACSBVec *srhs) {
+  if (tcoup) {
+    TacsScalar *c, *t, *r;
+    int size = tcoup->getArray(&c);
+    temp->getArray(&t);
+    srhs->getArray(&r);
+
+    const int bsize = tcoup->getBlockSize();
+    const int nnodes = size / bsize;
+    for (int i = 0; i < nnodes; i++) {
+      for (int k = 0; k < bsize; k++) {
+        r[bsize * i + k] += c[bsize * i + k] * t[i];
+      }
+    }
+  }
+}
+
+/*!
+  Add the coupling term to the thermal right-hand side.
+
+  input:
+  svec: the structural state vector
+  trhs: the thermal right-hand side
+*/
+void TACSStaggeredDriver::addThermalCoupling(TACSBVec *svec, TACSBVec *trhs) {
+  if (fcoup) {
+    // Compute the nodal inner products of the feedback coefficients
+    // with the structural state
+    TACSBVec *w = (interp ? work_s : twork);
+
+    TacsScalar *f, *s, *wvals;
+    int size = fcoup->getArray(&f);
+    svec->getArray(&s);
+    w->getArray(&wvals);
+
+    const int bsize = fcoup->getBlockSize();
+    const int nnodes = size / bsize;
+    for (int i = 0; i < nnodes; i++) {
+      TacsScalar wval = 0.0;
+      for (int k = 0; k < bsize; k++) {
+        wval += f[bsize * i + k] * s[bsize * i + k];
+      }
+      wvals[i] = wval;
+    }
+
+    // Transfer the source back to the thermal mesh and add it to the
+    // right-hand side
+    if (interp) {
+      interp->multTranspose(work_s, twork);
+    }
+    trhs->axpy(1.0, twork);
+  }
+}
+
+/*!
+  Run the staggered coupling iterations.
+
+  Each iteration solves the thermal field with the coupling source
+  from the current structural state, transfers the temperature to
+  the structural mesh, and solves the structural field with the
+  thermal load. Both solves re-use the factorizations computed in
+  initialize(); only the right-hand sides are rebuilt.
+
+  Returns the number of iterations performed, or -1 when the
+  iterations did not converge within the limit.
+*/
+int TACSStaggeredDriver::solve() {
+  if (!initialized) {
+    initialize();
+  }
+
+  for (int iter = 0; iter < max_iters; iter++) {
+    // Build the thermal right-hand side from the applied load and
+    // the coupling source from the current structural state
+    if (tloads) {
+      tres->copyValues(tloads);
+    } else {
+      tres->zeroEntries();
+    }
+    addThermalCoupling(svars, tres);
+    thermal->applyBCs(tres);
+
+    // Solve the thermal field with the existing factorization
+    tsolver->solve(tres, tupdate);
+    thermal->setBCs(tupdate);
+
+    // Apply the relaxed update and measure the change
+    tupdate->axpy(-1.0, tvars);
+    double tchange = TacsRealPart(tupdate->norm());
+    tvars->axpy(omega, tupdate);
+    thermal->setVariables(tvars);
+
+    // Transfer the temperature to the structural mesh
+    TACSBVec *temp = tvars;
+    if (interp) {
+      interp->mult(tvars, temp_s);
+      temp = temp_s;
+    }
+
+    // Build the structural right-hand side from the applied load and
+    // the thermal load
+    if (sloads) {
+      sres->copyValues(sloads);
+    } else {
+      sres->zeroEntries();
+    }
+    addStructuralCoupling(temp, sres);
+    structural->applyBCs(sres);
+
+    // Solve the structural field with the existing factorization
+    ssolver->solve(sres, supdate);
+    structural->setBCs(supdate);
+
+    // Apply the relaxed update and measure the change
+    supdate->axpy(-1.0, svars);
+    double schange = TacsRealPart(supdate->norm());
+    svars->axpy(omega, supdate);
+    structural->setVariables(svars);
+
+    // Test for convergence of the coupling iterations relative to
+    // the current solution magnitudes
+    double tref = TacsRealPart(tvars->norm());
+    double sref = TacsRealPart(svars->norm());
+    if (tref == 0.0) {
+      tref = 1.0;
+    }
+    if (sref == 0.0) {
+      sref = 1.0;
+    }
+
+    if (tchange <= rtol * tref && schange <= rtol * sref) {
+      return iter + 1;
+    }
+  }
+
+  return -1;
+}
+
+const char *TACSStaggeredDriver::getObjectName() { return driverName; }
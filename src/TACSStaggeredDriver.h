@@ -0,0 +1,124 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_STAGGERED_DRIVER_H
+#define TACS_STAGGERED_DRIVER_H
+
+#include "TACSAssembler.h"
+#include "TACSBVecInterp.h"
+
+/**
+  Staggered driver for coupled thermal-structural static problems.
+
+  The driver alternates between solves of a thermal field and a
+  structural field, each discretized by its own TACSAssembler object.
+  Both Jacobians are assembled and factored once in initialize() and
+  the factorizations persist across the coupling iterations: each
+  substep only rebuilds the coupling right-hand side and performs a
+  Krylov solve with the existing preconditioner.
+
+  The thermal solution is transferred to the structural mesh through
+  an optional TACSBVecInterp created between the thermal and
+  structural node maps with the thermal block size. When the two
+  assemblers share the same node map the interpolation can be omitted
+  and the thermal solution is used directly.
+
+  The default coupling model uses lumped nodal coefficients: the
+  structural load at each node is the nodal coupling vector scaled by
+  the transferred temperature, and the thermal source is the inner
+  product of the feedback vector with the structural state at each
+  node. Override addStructuralCoupling()/addThermalCoupling() for
+  coupling models beyond the lumped coefficients.
+*/
+class TACSStaggeredDriver : public TACSObject {
+ public:
+  TACSStaggeredDriver(TACSAssembler *_thermal, TACSMat *_tmat, TACSPc *_tpc,
+                      TACSKsm *_tsolver, TACSAssembler *_structural,
+                      TACSMat *_smat, TACSPc *_spc, TACSKsm *_ssolver,
+                      TACSBVecInterp *_interp = NULL);
+  virtual ~TACSStaggeredDriver();
+
+  // Set the applied loads for the two fields
+  // ----------------------------------------
+  void setLoads(TACSBVec *_tloads, TACSBVec *_sloads);
+
+  // Set the lumped nodal coupling coefficients
+  // ------------------------------------------
+  void setCouplingVectors(TACSBVec *_tcoup, TACSBVec *_fcoup);
+
+  // Set the coupling iteration controls
+  // -----------------------------------
+  void setConvergenceCriteria(double _rtol, int _max_iters);
+  void setRelaxationFactor(double _omega);
+
+  // Assemble and factor both Jacobians
+  // ----------------------------------
+  void initialize();
+
+  // Run the staggered iterations to convergence
+  // -------------------------------------------
+  int solve();
+
+  // Retrieve the coupled solution fields
+  // ------------------------------------
+  TACSBVec *getTemperatures() { return tvars; }
+  TACSBVec *getVariables() { return svars; }
+
+  const char *getObjectName();
+
+ protected:
+  // Add the coupling terms to the right-hand sides. The temperature
+  // vector passed to the structural coupling is on the structural
+  // mesh when an interpolation is set.
+  virtual void addStructuralCoupling(TACSBVec *temp, TACSBVec *srhs);
+  virtual void addThermalCoupling(TACSBVec *svec, TACSBVec *trhs);
+
+ private:
+  // The thermal field and its solver objects
+  TACSAssembler *thermal;
+  TACSMat *tmat;
+  TACSPc *tpc;
+  TACSKsm *tsolver;
+
+  // The structural field and its solver objects
+  TACSAssembler *structural;
+  TACSMat *smat;
+  TACSPc *spc;
+  TACSKsm *ssolver;
+
+  // The transfer between the thermal and structural meshes
+  TACSBVecInterp *interp;
+
+  // The solution, residual and update vectors for the two fields
+  TACSBVec *tvars, *tres, *tupdate, *twork;
+  TACSBVec *svars, *sres, *supdate;
+
+  // The applied loads for the two fields
+  TACSBVec *tloads, *sloads;
+
+  // The transferred temperature and the scalar work vector on the
+  // structural mesh
+  TACSBVec *temp_s, *work_s;
+
+  // The lumped nodal coupling coefficients
+  TACSBVec *tcoup;  // Structural load per unit nodal temperature
+  TACSBVec *fcoup;  // Thermal source per unit structural state
+
+  // The coupling iteration controls
+  double rtol, omega;
+  int max_iters;
+  int initialized;
+
+  static const char *driverName;
+};
+
+#endif  // TACS_STAGGERED_DRIVER_H
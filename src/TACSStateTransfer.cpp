@@ -0,0 +1,614 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSStateTransfer.h"
+
+#include "TACSElementBasis.h"
+#include "TACSProfiler.h"
+
+/*
+  A donor candidate: one local coarse element with its bounding box
+  and centroid
+*/
+typedef struct {
+  int elem;           // The coarse element index
+  double xmin[3];     // The element bounding box
+  double xmax[3];
+  double centroid[3];
+} StateTransferBox;
+
+/*
+  A node of the bounding-box search tree. A leaf covers the range
+  [start, start + count) of the element permutation array; interior
+  nodes have count = 0 and refer to their children
+*/
+typedef struct {
+  double xmin[3], xmax[3];
+  int start, count;
+  int left, right;
+} StateTransferTreeNode;
+
+// The number of elements kept in one leaf of the tree
+static const int STATE_TRANSFER_LEAF_SIZE = 8;
+
+// The maximum number of donor candidates tested per fine node
+static const int STATE_TRANSFER_MAX_CANDIDATES = 64;
+
+// The axis used by the centroid comparator during the tree build
+static int state_transfer_sort_axis = 0;
+
+static int compareCentroids(const void *a, const void *b) {
+  const StateTransferBox *ba = (const StateTransferBox *)a;
+  const StateTransferBox *bb = (const StateTransferBox *)b;
+  double d = ba->centroid[state_transfer_sort_axis] -
+             bb->centroid[state_transfer_sort_axis];
+  return (d < 0.0 ? -1 : (d > 0.0 ? 1 : 0));
+}
+
+/*
+  Recursively build the bounding-box tree over the element range
+  [start, start + count). The elements are reordered in place so that
+  each node covers a contiguous range.
+
+  returns: the index of the new tree node
+*/
+static int buildTree(StateTransferBox *boxes, int start, int count,
+                     StateTransferTreeNode *nodes, int *num_nodes) {
+  int node = *num_nodes;
+  *num_nodes = node + 1;
+
+  // Compute the bounding box of the range
+  StateTransferTreeNode *n = &nodes[node];
+  for (int k = 0; k < 3; k++) {
+    n->xmin[k] = boxes[start].xmin[k];
+    n->xmax[k] = boxes[start].xmax[k];
+  }
+  for (int i = start + 1; i < start + count; i++) {
+    for (int k = 0; k < 3; k++) {
+      if (boxes[i].xmin[k] < n->xmin[k]) {
+        n->xmin[k] = boxes[i].xmin[k];
+      }
+      if (boxes[i].xmax[k] > n->xmax[k]) {
+        n->xmax[k] = boxes[i].xmax[k];
+      }
+    }
+  }
+
+  if (count <= STATE_TRANSFER_LEAF_SIZE) {
+    n->start = start;
+    n->count = count;
+    n->left = n->right = -1;
+    return node;
+  }
+
+  // Split the range at the median centroid along the longest axis
+  int axis = 0;
+  for (int k = 1; k < 3; k++) {
+    if (n->xmax[k] - n->xmin[k] > n->xmax[axis] - n->xmin[axis]) {
+      axis = k;
+    }
+  }
+  state_transfer_sort_axis = axis;
+  qsort(&boxes[start], count, sizeof(StateTransferBox), compareCentroids);
+
+  int half = count / 2;
+  n->start = n->count = 0;
+
+  // Note: the recursion may reallocate nothing - nodes was sized for
+  // the worst case up front - but &nodes[node] must be re-resolved
+  // after the recursive calls since the entries are written in order
+  int left = buildTree(boxes, start, half, nodes, num_nodes);
+  int right = buildTree(boxes, start + half, count - half, nodes, num_nodes);
+  nodes[node].left = left;
+  nodes[node].right = right;
+
+  return node;
+}
+
+/*
+  Collect the donor candidates whose padded bounding box contains the
+  query point
+*/
+static void queryTree(const StateTransferTreeNode *nodes, int root,
+                      const StateTransferBox *boxes, const double x[],
+                      double pad, int *num_cand, int *cand) {
+  const StateTransferTreeNode *n = &nodes[root];
+  for (int k = 0; k < 3; k++) {
+    if (x[k] < n->xmin[k] - pad || x[k] > n->xmax[k] + pad) {
+      return;
+    }
+  }
+
+  if (n->count > 0) {
+    for (int i = n->start; i < n->start + n->count; i++) {
+      int inside = 1;
+      for (int k = 0; k < 3; k++) {
+        if (x[k] < boxes[i].xmin[k] - pad || x[k] > boxes[i].xmax[k] + pad) {
+          inside = 0;
+          break;
+        }
+      }
+      if (inside && *num_cand < STATE_TRANSFER_MAX_CANDIDATES) {
+        cand[*num_cand] = i;
+        *num_cand = *num_cand + 1;
+      }
+    }
+  } else {
+    queryTree(nodes, n->left, boxes, x, pad, num_cand, cand);
+    queryTree(nodes, n->right, boxes, x, pad, num_cand, cand);
+  }
+}
+
+/*
+  Check whether the element layout uses simplex parametric coordinates
+*/
+static int isSimplexLayout(ElementLayout layout) {
+  return ((layout >= TACS_TRI_ELEMENT && layout <= TACS_TRI_CUBIC_ELEMENT) ||
+          (layout >= TACS_TETRA_ELEMENT &&
+           layout <= TACS_TETRA_CUBIC_ELEMENT));
+}
+
+/*
+  Clamp the parametric coordinates into the reference element
+*/
+static void clampParams(int num_params, int simplex, double pt[]) {
+  if (simplex) {
+    double sum = 0.0;
+    for (int k = 0; k < num_params; k++) {
+      if (pt[k] < 0.0) {
+        pt[k] = 0.0;
+      }
+      sum += pt[k];
+    }
+    if (sum > 1.0) {
+      for (int k = 0; k < num_params; k++) {
+        pt[k] = pt[k] / sum;
+      }
+    }
+  } else {
+    for (int k = 0; k < num_params; k++) {
+      pt[k] = (pt[k] < -1.0 ? -1.0 : (pt[k] > 1.0 ? 1.0 : pt[k]));
+    }
+  }
+}
+
+/*
+  Recover the parametric coordinates of the query point within the
+  element by Newton iteration on the element mapping.
+
+  The parametric update is computed from the normal equations of the
+  mapping Jacobian, which handles both solid elements and elements
+  whose parametric dimension is lower than three (plane and shell
+  meshes embedded in three dimensions).
+
+  input:
+  basis:  the element basis
+  Xpts:   the element node locations (real parts)
+  xq:     the query point
+
+  output:
+  pt:     the converged parametric coordinates
+  N:      the basis function values at pt
+  dist:   the distance from the query point to the mapped point
+
+  returns: 2 if converged inside the element, 1 if converged outside,
+  0 if the iteration failed
+*/
+static int computeInverseMap(TACSElementBasis *basis, const double Xpts[],
+                             const double xq[], double pt[], double N[],
+                             double Nxi[], double *dist) {
+  const int num_params = basis->getNumParameters();
+  const int num_nodes = basis->getNumNodes();
+  const int simplex = isSimplexLayout(basis->getLayoutType());
+
+  // Start from the centroid of the reference element
+  for (int k = 0; k < num_params; k++) {
+    pt[k] = (simplex ? 1.0 / (num_params + 1.0) : 0.0);
+  }
+  pt[2] = (num_params < 3 ? 0.0 : pt[2]);
+
+  double rnorm = 0.0;
+  for (int iter = 0; iter < 30; iter++) {
+    basis->computeBasisGradient(pt, N, Nxi);
+
+    // Compute the mapped point and the mapping Jacobian
+    double X[3] = {0.0, 0.0, 0.0};
+    double Xd[9];
+    memset(Xd, 0, 3 * num_params * sizeof(double));
+    for (int i = 0; i < num_nodes; i++) {
+      for (int k = 0; k < 3; k++) {
+        X[k] += N[i] * Xpts[3 * i + k];
+        for (int j = 0; j < num_params; j++) {
+          Xd[num_params * k + j] += Nxi[num_params * i + j] * Xpts[3 * i + k];
+        }
+      }
+    }
+
+    // Compute the residual
+    double r[3];
+    rnorm = 0.0;
+    for (int k = 0; k < 3; k++) {
+      r[k] = xq[k] - X[k];
+      rnorm += r[k] * r[k];
+    }
+    rnorm = sqrt(rnorm);
+
+    // Form the normal equations A*dp = b with A = Xd^{T}*Xd
+    double A[9], b[3];
+    for (int j = 0; j < num_params; j++) {
+      b[j] = 0.0;
+      for (int k = 0; k < 3; k++) {
+        b[j] += Xd[num_params * k + j] * r[k];
+      }
+      for (int jj = 0; jj < num_params; jj++) {
+        double a = 0.0;
+        for (int k = 0; k < 3; k++) {
+          a += Xd[num_params * k + j] * Xd[num_params * k + jj];
+        }
+        A[num_params * j + jj] = a;
+      }
+    }
+
+    // Solve the small system by cofactors
+    double dp[3] = {0.0, 0.0, 0.0};
+    if (num_params == 1) {
+      if (A[0] == 0.0) {
+        return 0;
+      }
+      dp[0] = b[0] / A[0];
+    } else if (num_params == 2) {
+      double det = A[0] * A[3] - A[1] * A[2];
+      if (det == 0.0) {
+        return 0;
+      }
+      dp[0] = (A[3] * b[0] - A[1] * b[1]) / det;
+      dp[1] = (A[0] * b[1] - A[2] * b[0]) / det;
+    } else {
+      double det = A[0] * (A[4] * A[8] - A[5] * A[7]) -
+                   A[1] * (A[3] * A[8] - A[5] * A[6]) +
+                   A[2] * (A[3] * A[7] - A[4] * A[6]);
+      if (det == 0.0) {
+        return 0;
+      }
+      dp[0] = ((A[4] * A[8] - A[5] * A[7]) * b[0] -
+               (A[1] * A[8] - A[2] * A[7]) * b[1] +
+               (A[1] * A[5] - A[2] * A[4]) * b[2]) /
+              det;
+      dp[1] = (-(A[3] * A[8] - A[5] * A[6]) * b[0] +
+               (A[0] * A[8] - A[2] * A[6]) * b[1] -
+               (A[0] * A[5] - A[2] * A[3]) * b[2]) /
+              det;
+      dp[2] = ((A[3] * A[7] - A[4] * A[6]) * b[0] -
+               (A[0] * A[7] - A[1] * A[6]) * b[1] +
+               (A[0] * A[4] - A[1] * A[3]) * b[2]) /
+              det;
+    }
+
+    double dpnorm = 0.0;
+    for (int k = 0; k < num_params; k++) {
+      pt[k] += dp[k];
+      dpnorm += dp[k] * dp[k];
+
+      // Abandon clearly divergent iterations
+      if (pt[k] < -10.0 || pt[k] > 10.0) {
+        return 0;
+      }
+    }
+
+    if (sqrt(dpnorm) < 1e-12) {
+      break;
+    }
+  }
+
+  *dist = rnorm;
+
+  // Check whether the point lies within the reference element
+  const double ptol = 1e-4;
+  int inside = 1;
+  if (simplex) {
+    double sum = 0.0;
+    for (int k = 0; k < num_params; k++) {
+      if (pt[k] < -ptol) {
+        inside = 0;
+      }
+      sum += pt[k];
+    }
+    if (sum > 1.0 + ptol) {
+      inside = 0;
+    }
+  } else {
+    for (int k = 0; k < num_params; k++) {
+      if (pt[k] < -1.0 - ptol || pt[k] > 1.0 + ptol) {
+        inside = 0;
+      }
+    }
+  }
+
+  return (inside ? 2 : 1);
+}
+
+/*
+  Create the state-transfer object between the two refinement levels.
+
+  input:
+  coarse:  the coarse refinement level
+  fine:    the fine refinement level
+  tol:     the geometric tolerance relative to the mesh dimensions
+*/
+TACSStateTransfer::TACSStateTransfer(TACSAssembler *_coarse,
+                                     TACSAssembler *_fine, double _tol) {
+  coarse = _coarse;
+  coarse->incref();
+  fine = _fine;
+  fine->incref();
+  tol = _tol;
+  interp = NULL;
+
+  buildInterp();
+}
+
+TACSStateTransfer::~TACSStateTransfer() {
+  coarse->decref();
+  fine->decref();
+  if (interp) {
+    interp->decref();
+  }
+}
+
+/*
+  Construct the interpolation operator: locate each owned fine node
+  within a donor coarse element and use the basis function values at
+  the recovered parametric coordinates as the interpolation weights
+*/
+void TACSStateTransfer::buildInterp() {
+  TacsProfileScope profile("TACSStateTransfer::buildInterp");
+
+  if (coarse->getVarsPerNode() != fine->getVarsPerNode()) {
+    fprintf(stderr,
+            "TACSStateTransfer: the refinement levels must have the "
+            "same number of variables per node\n");
+    return;
+  }
+
+  interp = new TACSBVecInterp(coarse, fine);
+  interp->incref();
+
+  // Collect the bounding boxes of the local coarse elements that can
+  // act as donors
+  const int nelems = coarse->getNumElements();
+  const int max_nodes = coarse->getMaxElementNodes();
+  TacsScalar *Xpts = new TacsScalar[3 * max_nodes];
+  StateTransferBox *boxes = new StateTransferBox[nelems];
+  int nboxes = 0;
+
+  for (int e = 0; e < nelems; e++) {
+    TACSElement *element = coarse->getElement(e, Xpts);
+    if (!element || !element->getElementBasis()) {
+      continue;
+    }
+    int len;
+    coarse->getElement(e, &len, NULL);
+
+    StateTransferBox *box = &boxes[nboxes];
+    box->elem = e;
+    for (int k = 0; k < 3; k++) {
+      box->xmin[k] = box->xmax[k] = TacsRealPart(Xpts[k]);
+      box->centroid[k] = 0.0;
+    }
+    for (int i = 0; i < len; i++) {
+      for (int k = 0; k < 3; k++) {
+        double x = TacsRealPart(Xpts[3 * i + k]);
+        if (x < box->xmin[k]) {
+          box->xmin[k] = x;
+        }
+        if (x > box->xmax[k]) {
+          box->xmax[k] = x;
+        }
+        box->centroid[k] += x / len;
+      }
+    }
+    nboxes++;
+  }
+
+  if (nboxes == 0) {
+    fprintf(stderr,
+            "TACSStateTransfer: no local coarse elements provide an "
+            "element basis\n");
+    delete[] Xpts;
+    delete[] boxes;
+    interp->initialize();
+    return;
+  }
+
+  // Build the search tree and set the geometric padding from the
+  // local mesh dimensions
+  StateTransferTreeNode *nodes = new StateTransferTreeNode[2 * nboxes];
+  int num_nodes = 0;
+  int root = buildTree(boxes, 0, nboxes, nodes, &num_nodes);
+
+  double diag = 0.0;
+  for (int k = 0; k < 3; k++) {
+    double d = nodes[root].xmax[k] - nodes[root].xmin[k];
+    diag += d * d;
+  }
+  const double pad = tol * sqrt(diag);
+
+  // Get the owned fine node locations
+  TACSBVec *X = fine->createNodeVec();
+  X->incref();
+  fine->getNodes(X);
+  TacsScalar *xarr;
+  int xsize = X->getArray(&xarr);
+  const int num_fine_nodes = xsize / 3;
+
+  const int *range;
+  fine->getNodeMap()->getOwnerRange(&range);
+  int rank;
+  MPI_Comm_rank(fine->getMPIComm(), &rank);
+
+  // Work arrays for the donor search
+  double *eXpts = new double[3 * max_nodes];
+  double *N = new double[max_nodes];
+  double *Nxi = new double[3 * max_nodes];
+  TacsScalar *wts = new TacsScalar[max_nodes];
+  int *nums = new int[max_nodes];
+  int cand[STATE_TRANSFER_MAX_CANDIDATES];
+
+  int num_clamped = 0;
+  for (int i = 0; i < num_fine_nodes; i++) {
+    double xq[3];
+    xq[0] = TacsRealPart(xarr[3 * i]);
+    xq[1] = TacsRealPart(xarr[3 * i + 1]);
+    xq[2] = TacsRealPart(xarr[3 * i + 2]);
+
+    // Collect the donor candidates from the search tree
+    int num_cand = 0;
+    queryTree(nodes, root, boxes, xq, pad, &num_cand, cand);
+
+    // Test the candidates and keep the closest donor as a fallback
+    int donor = -1, best = -1;
+    double best_dist = 0.0;
+    double pt[3];
+    for (int c = 0; c < num_cand; c++) {
+      int e = boxes[cand[c]].elem;
+      TACSElement *element = coarse->getElement(e, Xpts);
+      TACSElementBasis *basis = element->getElementBasis();
+      int len;
+      coarse->getElement(e, &len, NULL);
+      for (int j = 0; j < 3 * len; j++) {
+        eXpts[j] = TacsRealPart(Xpts[j]);
+      }
+
+      double dist;
+      int status = computeInverseMap(basis, eXpts, xq, pt, N, Nxi, &dist);
+      if (status == 2 && dist <= pad) {
+        donor = e;
+        break;
+      }
+      if (status > 0 && (best < 0 || dist < best_dist)) {
+        best = e;
+        best_dist = dist;
+      }
+    }
+
+    if (donor < 0) {
+      // No containing donor: fall back to the closest candidate, or
+      // to the nearest element centroid when the tree query was empty
+      if (best < 0) {
+        for (int c = 0; c < nboxes; c++) {
+          double d = 0.0;
+          for (int k = 0; k < 3; k++) {
+            double dx = xq[k] - boxes[c].centroid[k];
+            d += dx * dx;
+          }
+          if (best < 0 || d < best_dist) {
+            best = boxes[c].elem;
+            best_dist = d;
+          }
+        }
+      }
+
+      // Clamp the node into the fallback donor element
+      TACSElement *element = coarse->getElement(best, Xpts);
+      TACSElementBasis *basis = element->getElementBasis();
+      int len;
+      coarse->getElement(best, &len, NULL);
+      for (int j = 0; j < 3 * len; j++) {
+        eXpts[j] = TacsRealPart(Xpts[j]);
+      }
+
+      double dist;
+      computeInverseMap(basis, eXpts, xq, pt, N, Nxi, &dist);
+      clampParams(basis->getNumParameters(),
+                  isSimplexLayout(basis->getLayoutType()), pt);
+      basis->computeBasis(pt, N);
+      donor = best;
+      num_clamped++;
+    }
+
+    // Add the interpolation weights for this fine node
+    int len;
+    const int *donor_nodes;
+    coarse->getElement(donor, &len, &donor_nodes);
+    for (int j = 0; j < len; j++) {
+      wts[j] = N[j];
+      nums[j] = donor_nodes[j];
+    }
+    interp->addInterp(range[rank] + i, wts, nums, len);
+  }
+
+  if (num_clamped > 0) {
+    fprintf(stderr,
+            "TACSStateTransfer: %d fine nodes fell outside the local "
+            "coarse elements and were clamped to the nearest donor\n",
+            num_clamped);
+  }
+
+  interp->initialize();
+
+  X->decref();
+  delete[] Xpts;
+  delete[] boxes;
+  delete[] nodes;
+  delete[] eXpts;
+  delete[] N;
+  delete[] Nxi;
+  delete[] wts;
+  delete[] nums;
+}
+
+/*
+  Get the interpolation operator from the coarse to the fine mesh
+*/
+TACSBVecInterp *TACSStateTransfer::getInterpolation() { return interp; }
+
+/*
+  Interpolate a coarse-mesh vector onto the fine mesh
+*/
+void TACSStateTransfer::transfer(TACSBVec *coarse_vec, TACSBVec *fine_vec) {
+  if (interp) {
+    interp->mult(coarse_vec, fine_vec);
+  }
+}
+
+/*
+  Interpolate the current coarse-mesh state onto the fine mesh and
+  set it as the fine-mesh state, so that the fine-level Newton and
+  Krylov solves warm-start from the coarse solution
+*/
+void TACSStateTransfer::transferState() {
+  if (!interp) {
+    return;
+  }
+
+  TACSBVec *qc = coarse->createVec();
+  TACSBVec *qf = fine->createVec();
+  qc->incref();
+  qf->incref();
+
+  coarse->getVariables(qc);
+  interp->mult(qc, qf);
+
+  // Overwrite the interpolated values with the fine-mesh boundary
+  // conditions
+  fine->setBCs(qf);
+  fine->setVariables(qf);
+
+  qc->decref();
+  qf->decref();
+}
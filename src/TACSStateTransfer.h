@@ -0,0 +1,82 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_STATE_TRANSFER_H
+#define TACS_STATE_TRANSFER_H
+
+/*
+  Transfer the solution state between refinement levels of the same
+  geometry
+*/
+
+#include "TACSAssembler.h"
+#include "TACSBVecInterp.h"
+
+/**
+  Build the interpolation between two refinement levels of the same
+  geometry so that the fine-level solves can warm-start from the
+  coarse-level solution.
+
+  Unlike the multigrid interpolation operators, which are assembled
+  from a known element-to-element refinement relationship, this class
+  constructs the interpolation geometrically: each node of the fine
+  mesh is located within a donor element of the coarse mesh using a
+  bounding-box search tree over the local coarse elements, the
+  parametric coordinates of the node within the donor are recovered
+  by Newton iteration on the element mapping, and the basis function
+  values at those coordinates become the interpolation weights. The
+  meshes therefore do not need to be nested - only to cover the same
+  geometry with a compatible partitioning.
+
+  Donor elements are searched on the local process. Fine nodes that
+  fall outside all local coarse elements - at curved boundaries or
+  partition edges - are clamped into the nearest local element, which
+  reduces to nearest-donor extrapolation. Only elements that provide
+  a TACSElementBasis can act as donors.
+*/
+class TACSStateTransfer : public TACSObject {
+ public:
+  TACSStateTransfer(TACSAssembler *_coarse, TACSAssembler *_fine,
+                    double _tol = 1e-6);
+  ~TACSStateTransfer();
+
+  // Get the interpolation operator from the coarse to the fine mesh
+  TACSBVecInterp *getInterpolation();
+
+  // Interpolate a coarse-mesh vector onto the fine mesh
+  void transfer(TACSBVec *coarse_vec, TACSBVec *fine_vec);
+
+  // Interpolate the current coarse-mesh state onto the fine mesh and
+  // set it as the fine-mesh state for a warm start
+  void transferState();
+
+ private:
+  // Construct the interpolation operator
+  void buildInterp();
+
+  // The coarse and fine mesh levels
+  TACSAssembler *coarse, *fine;
+
+  // The geometric tolerance, relative to the coarse mesh dimensions
+  double tol;
+
+  // The interpolation operator from the coarse to the fine mesh
+  TACSBVecInterp *interp;
+};
+
+#endif  // TACS_STATE_TRANSFER_H
@@ -0,0 +1,425 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSSubstructureSolver.h"
+
+#include "tacslapack.h"
+
+/*
+  Create the substructure solver
+
+  input:
+  num_substructs: the number of substructures
+  assemblers:     the assembler for each substructure
+*/
+TACSSubstructureSolver::TACSSubstructureSolver(int _num_substructs,
+                                               TACSAssembler **_assemblers) {
+  num_substructs = (_num_substructs > 0 ? _num_substructs : 1);
+  assemblers = new TACSAssembler *[num_substructs];
+  ksm = new TACSKsm *[num_substructs];
+  wvec = new TACSBVec *[num_substructs];
+  zvec = new TACSBVec *[num_substructs];
+  sub_modified = new int[num_substructs];
+  Fsub = new TacsScalar *[num_substructs];
+  for (int i = 0; i < num_substructs; i++) {
+    assemblers[i] = _assemblers[i];
+    assemblers[i]->incref();
+    ksm[i] = NULL;
+    wvec[i] = NULL;
+    zvec[i] = NULL;
+    sub_modified[i] = 1;
+    Fsub[i] = NULL;
+  }
+
+  // All the assemblers must share the communicator and the block size
+  comm = assemblers[0]->getMPIComm();
+  vars_per_node = assemblers[0]->getVarsPerNode();
+  for (int i = 1; i < num_substructs; i++) {
+    if (assemblers[i]->getVarsPerNode() != vars_per_node) {
+      fprintf(stderr,
+              "TACSSubstructureSolver: All substructures must use the same "
+              "number of variables per node\n");
+    }
+  }
+
+  // The ties are added incrementally
+  num_ties = 0;
+  max_ties = 0;
+  tie_subs = NULL;
+  tie_nodes = NULL;
+
+  // The interface data is allocated when the operator is factored
+  num_lambda = 0;
+  F = NULL;
+  Fpiv = NULL;
+  lambda = NULL;
+  dvals = NULL;
+  factored = 0;
+}
+
+/*
+  Free the substructure data and the interface operator
+*/
+TACSSubstructureSolver::~TACSSubstructureSolver() {
+  for (int i = 0; i < num_substructs; i++) {
+    assemblers[i]->decref();
+    if (ksm[i]) {
+      ksm[i]->decref();
+    }
+    if (wvec[i]) {
+      wvec[i]->decref();
+    }
+    if (zvec[i]) {
+      zvec[i]->decref();
+    }
+    if (Fsub[i]) {
+      delete[] Fsub[i];
+    }
+  }
+  delete[] assemblers;
+  delete[] ksm;
+  delete[] wvec;
+  delete[] zvec;
+  delete[] sub_modified;
+  delete[] Fsub;
+  if (tie_subs) {
+    delete[] tie_subs;
+    delete[] tie_nodes;
+  }
+  if (F) {
+    delete[] F;
+    delete[] Fpiv;
+    delete[] lambda;
+    delete[] dvals;
+  }
+}
+
+/*!
+  Set the solver for the given substructure.
+
+  The Krylov solver wraps the substructure matrix and preconditioner -
+  typically a TACSSchurMat with its TACSSchurPc. The substructure is
+  marked as modified so that its interface contribution is rebuilt on
+  the next call to factor().
+
+  input:
+  substruct: the substructure index
+  ksm:       the Krylov solver for the substructure matrix
+*/
+void TACSSubstructureSolver::setSubstructureSolver(int substruct,
+                                                   TACSKsm *_ksm) {
+  if (substruct >= 0 && substruct < num_substructs) {
+    _ksm->incref();
+    if (ksm[substruct]) {
+      ksm[substruct]->decref();
+    }
+    ksm[substruct] = _ksm;
+    sub_modified[substruct] = 1;
+    factored = 0;
+  }
+}
+
+/*!
+  Tie a node pair from two substructures together.
+
+  All variables at the two nodes are constrained to be equal. The node
+  numbers are given in the global ordering of each assembler - if the
+  assembler reorders its nodes, the tie nodes must be given in the
+  reordered numbering.
+
+  input:
+  sub_a:  the first substructure index
+  node_a: the global node number within the first substructure
+  sub_b:  the second substructure index
+  node_b: the global node number within the second substructure
+*/
+void TACSSubstructureSolver::addInterfaceTie(int sub_a, int node_a, int sub_b,
+                                             int node_b) {
+  if (sub_a < 0 || sub_a >= num_substructs || sub_b < 0 ||
+      sub_b >= num_substructs) {
+    fprintf(stderr, "TACSSubstructureSolver: Tie substructure out of range\n");
+    return;
+  }
+
+  // Extend the tie arrays if they are full
+  if (num_ties >= max_ties) {
+    int new_max = (max_ties > 0 ? 2 * max_ties : 64);
+    int *new_subs = new int[2 * new_max];
+    int *new_nodes = new int[2 * new_max];
+    if (tie_subs) {
+      memcpy(new_subs, tie_subs, 2 * num_ties * sizeof(int));
+      memcpy(new_nodes, tie_nodes, 2 * num_ties * sizeof(int));
+      delete[] tie_subs;
+      delete[] tie_nodes;
+    }
+    max_ties = new_max;
+    tie_subs = new_subs;
+    tie_nodes = new_nodes;
+  }
+
+  tie_subs[2 * num_ties] = sub_a;
+  tie_subs[2 * num_ties + 1] = sub_b;
+  tie_nodes[2 * num_ties] = node_a;
+  tie_nodes[2 * num_ties + 1] = node_b;
+  num_ties++;
+
+  // Both substructures contribute new interface columns
+  sub_modified[sub_a] = 1;
+  sub_modified[sub_b] = 1;
+  factored = 0;
+}
+
+/*
+  Retrieve the number of interface ties
+*/
+int TACSSubstructureSolver::getNumTies() { return num_ties; }
+
+/*
+  Mark a substructure whose matrix values have changed. Its
+  factorization and interface contribution are rebuilt on the next
+  call to factor(); all other substructures are reused.
+*/
+void TACSSubstructureSolver::markModified(int substruct) {
+  if (substruct >= 0 && substruct < num_substructs) {
+    sub_modified[substruct] = 1;
+    factored = 0;
+  }
+}
+
+/*
+  Compute the local part of out += B_i*vec: the signed values of the
+  vector at the tie nodes owned by this processor. The result must be
+  summed across the communicator by the caller.
+*/
+void TACSSubstructureSolver::applyB(int substruct, TACSBVec *vec,
+                                    TacsScalar *out) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  const int *owner_range;
+  vec->getNodeMap()->getOwnerRange(&owner_range);
+
+  TacsScalar *vals = new TacsScalar[vars_per_node];
+  for (int t = 0; t < num_ties; t++) {
+    for (int e = 0; e < 2; e++) {
+      if (tie_subs[2 * t + e] == substruct) {
+        int node = tie_nodes[2 * t + e];
+        if (node >= owner_range[rank] && node < owner_range[rank + 1]) {
+          double sign = (e == 0 ? 1.0 : -1.0);
+          vec->getValues(1, &node, vals);
+          for (int c = 0; c < vars_per_node; c++) {
+            out[vars_per_node * t + c] += sign * vals[c];
+          }
+        }
+      }
+    }
+  }
+  delete[] vals;
+}
+
+/*
+  Compute vec = B_i^{T}*in: distribute the signed multiplier values to
+  the tie nodes of the substructure. Only locally owned nodes are
+  written, so no exchange is required.
+*/
+void TACSSubstructureSolver::applyBTranspose(int substruct,
+                                             const TacsScalar *in,
+                                             TACSBVec *vec) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  const int *owner_range;
+  vec->getNodeMap()->getOwnerRange(&owner_range);
+
+  vec->zeroEntries();
+  TacsScalar *vals = new TacsScalar[vars_per_node];
+  for (int t = 0; t < num_ties; t++) {
+    for (int e = 0; e < 2; e++) {
+      if (tie_subs[2 * t + e] == substruct) {
+        int node = tie_nodes[2 * t + e];
+        if (node >= owner_range[rank] && node < owner_range[rank + 1]) {
+          double sign = (e == 0 ? 1.0 : -1.0);
+          for (int c = 0; c < vars_per_node; c++) {
+            vals[c] = sign * in[vars_per_node * t + c];
+          }
+          vec->setValues(1, &node, vals, TACS_ADD_VALUES);
+        }
+      }
+    }
+  }
+  delete[] vals;
+}
+
+/*!
+  Factor the coupled system.
+
+  The preconditioner of each modified substructure is re-factored and
+  its cached contribution to the interface operator is rebuilt - one
+  substructure solve per tie degree of freedom that touches the
+  substructure. Unmodified substructures reuse both their
+  factorization and their cached interface columns. The summed
+  interface operator is then factored densely with LAPACK, replicated
+  on every processor.
+
+  This call is collective on the communicator shared by the
+  assemblers.
+*/
+void TACSSubstructureSolver::factor() {
+  // (Re)allocate the interface data if the ties have changed
+  if (num_lambda != vars_per_node * num_ties) {
+    num_lambda = vars_per_node * num_ties;
+    if (F) {
+      delete[] F;
+      delete[] Fpiv;
+      delete[] lambda;
+      delete[] dvals;
+    }
+    F = new TacsScalar[num_lambda * num_lambda];
+    Fpiv = new int[num_lambda];
+    lambda = new TacsScalar[num_lambda];
+    dvals = new TacsScalar[num_lambda];
+    for (int i = 0; i < num_substructs; i++) {
+      if (Fsub[i]) {
+        delete[] Fsub[i];
+        Fsub[i] = NULL;
+      }
+      sub_modified[i] = 1;
+    }
+  }
+
+  for (int i = 0; i < num_substructs; i++) {
+    if (!ksm[i]) {
+      fprintf(stderr,
+              "TACSSubstructureSolver: No solver set for substructure %d\n",
+              i);
+      return;
+    }
+
+    if (sub_modified[i] || !Fsub[i]) {
+      // Re-factor the substructure preconditioner
+      TACSMat *mat;
+      TACSPc *pc;
+      ksm[i]->getOperators(&mat, &pc);
+      if (pc) {
+        pc->factor();
+      }
+
+      // Create the work vectors for this substructure
+      if (!wvec[i]) {
+        wvec[i] = assemblers[i]->createVec();
+        wvec[i]->incref();
+        zvec[i] = assemblers[i]->createVec();
+        zvec[i]->incref();
+      }
+
+      if (!Fsub[i]) {
+        Fsub[i] = new TacsScalar[num_lambda * num_lambda];
+      }
+      memset(Fsub[i], 0, num_lambda * num_lambda * sizeof(TacsScalar));
+
+      // Rebuild the interface columns touched by this substructure:
+      // one substructure solve per tie degree of freedom
+      for (int t = 0; t < num_ties; t++) {
+        if (tie_subs[2 * t] == i || tie_subs[2 * t + 1] == i) {
+          for (int c = 0; c < vars_per_node; c++) {
+            int col = vars_per_node * t + c;
+            memset(lambda, 0, num_lambda * sizeof(TacsScalar));
+            lambda[col] = 1.0;
+
+            applyBTranspose(i, lambda, wvec[i]);
+            ksm[i]->solve(wvec[i], zvec[i]);
+            applyB(i, zvec[i], &Fsub[i][num_lambda * col]);
+          }
+        }
+      }
+
+      // Sum the owner contributions so that the cached operator is
+      // replicated on every processor
+      MPI_Allreduce(MPI_IN_PLACE, Fsub[i], num_lambda * num_lambda,
+                    TACS_MPI_TYPE, MPI_SUM, comm);
+      sub_modified[i] = 0;
+    }
+  }
+
+  // Sum the substructure contributions and factor the dense
+  // interface operator
+  memset(F, 0, num_lambda * num_lambda * sizeof(TacsScalar));
+  for (int i = 0; i < num_substructs; i++) {
+    for (int j = 0; j < num_lambda * num_lambda; j++) {
+      F[j] += Fsub[i][j];
+    }
+  }
+
+  if (num_lambda > 0) {
+    int info = 0;
+    LAPACKgetrf(&num_lambda, &num_lambda, F, &num_lambda, Fpiv, &info);
+    if (info != 0) {
+      fprintf(stderr,
+              "TACSSubstructureSolver: Interface factorization failed with "
+              "info = %d. Check for redundant ties or a floating "
+              "substructure\n",
+              info);
+      return;
+    }
+  }
+  factored = 1;
+}
+
+/*!
+  Solve the coupled substructure system.
+
+  Each substructure is first solved independently for its applied
+  load, the interface multipliers are computed from the dense Schur
+  system, and the multiplier reaction is back-substituted with one
+  additional substructure solve each.
+
+  input:
+  forces: the force vector for each substructure
+
+  output:
+  ans: the coupled solution for each substructure
+*/
+void TACSSubstructureSolver::solve(TACSBVec **forces, TACSBVec **ans) {
+  if (!factored) {
+    factor();
+  }
+  if (!factored) {
+    return;
+  }
+
+  // Independent substructure solves: y_i = K_i^{-1} f_i
+  for (int i = 0; i < num_substructs; i++) {
+    ksm[i]->solve(forces[i], ans[i]);
+  }
+
+  if (num_lambda > 0) {
+    // Assemble the interface gap d = sum_i B_i y_i
+    memset(dvals, 0, num_lambda * sizeof(TacsScalar));
+    for (int i = 0; i < num_substructs; i++) {
+      applyB(i, ans[i], dvals);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, dvals, num_lambda, TACS_MPI_TYPE, MPI_SUM,
+                  comm);
+
+    // Solve for the interface multipliers
+    int one = 1, info = 0;
+    memcpy(lambda, dvals, num_lambda * sizeof(TacsScalar));
+    LAPACKgetrs("N", &num_lambda, &one, F, &num_lambda, Fpiv, lambda,
+                &num_lambda, &info);
+
+    // Back-substitute the multiplier reactions:
+    // u_i = y_i - K_i^{-1} B_i^{T} lambda
+    for (int i = 0; i < num_substructs; i++) {
+      applyBTranspose(i, lambda, wvec[i]);
+      ksm[i]->solve(wvec[i], zvec[i]);
+      ans[i]->axpy(-1.0, zvec[i]);
+    }
+  }
+}
@@ -0,0 +1,108 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_SUBSTRUCTURE_SOLVER_H
+#define TACS_SUBSTRUCTURE_SOLVER_H
+
+#include "TACSAssembler.h"
+
+/**
+  Coupled interface solver for multi-assembler substructure models.
+
+  Assemblies such as a wing, pylon and nacelle are modeled as separate
+  TACSAssembler instances joined at shared interface nodes. This class
+  solves the coupled system natively by dual substructuring: the tie
+  constraints u_a - u_b = 0 between interface node pairs are enforced
+  with Lagrange multipliers, and the multipliers satisfy the interface
+  Schur complement system
+
+  F*lambda = d,  F = sum_i B_i K_i^{-1} B_i^{T},
+                 d = sum_i B_i K_i^{-1} f_i
+
+  where B_i selects the signed interface values of substructure i.
+  Each substructure retains its own matrix, preconditioner and Krylov
+  solver, so the per-substructure factorizations reuse the existing
+  machinery (a TACSSchurMat/TACSSchurPc pair is the typical choice).
+
+  The interface operator is assembled explicitly, one column per tie
+  degree of freedom, with one substructure solve per column. The
+  contribution F_i of each substructure is cached: when only one
+  component's design changes, markModified() invalidates that
+  component alone and factor() rebuilds its factorization and its
+  columns of the interface operator while every other substructure is
+  reused. The dense interface system is replicated on every processor
+  and factored with LAPACK, so the interface is assumed to be small
+  relative to the substructures - which is the case for the discrete
+  joints this class is intended for.
+
+  Requirements: all assemblers must share the same communicator and
+  the same number of variables per node, the tie nodes are specified
+  in each assembler's global ordering, and each substructure matrix
+  must be nonsingular - a floating substructure must be regularized
+  through its own boundary conditions or support elements.
+*/
+class TACSSubstructureSolver : public TACSObject {
+ public:
+  TACSSubstructureSolver(int _num_substructs, TACSAssembler **_assemblers);
+  ~TACSSubstructureSolver();
+
+  // Set the solver for each substructure
+  // ------------------------------------
+  void setSubstructureSolver(int substruct, TACSKsm *_ksm);
+
+  // Define the interface by tying node pairs together
+  // -------------------------------------------------
+  void addInterfaceTie(int sub_a, int node_a, int sub_b, int node_b);
+  int getNumTies();
+
+  // Mark a substructure whose matrix has changed
+  // --------------------------------------------
+  void markModified(int substruct);
+
+  // Factor the modified substructures and the interface operator
+  // ------------------------------------------------------------
+  void factor();
+
+  // Solve the coupled system for all substructures
+  // ----------------------------------------------
+  void solve(TACSBVec **forces, TACSBVec **ans);
+
+ private:
+  // Apply the signed interface restriction and its transpose
+  void applyB(int substruct, TACSBVec *vec, TacsScalar *out);
+  void applyBTranspose(int substruct, const TacsScalar *in, TACSBVec *vec);
+
+  // The substructure assemblers and their solvers
+  int num_substructs;
+  TACSAssembler **assemblers;
+  TACSKsm **ksm;
+  TACSBVec **wvec, **zvec;
+  int vars_per_node;
+  MPI_Comm comm;
+
+  // The interface ties: two (substructure, node) pairs per tie
+  int num_ties, max_ties;
+  int *tie_subs;
+  int *tie_nodes;
+
+  // The cached per-substructure interface contributions, the summed
+  // interface operator and its LU factorization
+  int num_lambda;
+  int *sub_modified;
+  TacsScalar **Fsub;
+  TacsScalar *F;
+  int *Fpiv;
+  TacsScalar *lambda, *dvals;
+  int factored;
+};
+
+#endif  // TACS_SUBSTRUCTURE_SOLVER_H
@@ -0,0 +1,152 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSSymbolicStructure.h"
+
+#include <stdio.h>
+
+const char *TACSSymbolicStructure::structName = "TACSSymbolicStructure";
+
+// The leading record written to the serialized file
+static const uint32_t TACS_SYMBOLIC_FILE_MAGIC = 0x54435352;  // "TCSR"
+
+/*
+  Create the symbolic structure cache. The object takes ownership of
+  the rowp/cols arrays and sets the input pointers to NULL.
+*/
+TACSSymbolicStructure::TACSSymbolicStructure(uint32_t _topo_hash,
+                                            int _num_nodes, int **_rowp,
+                                            int **_cols) {
+  topo_hash = _topo_hash;
+  num_nodes = _num_nodes;
+  rowp = *_rowp;
+  *_rowp = NULL;
+  cols = *_cols;
+  *_cols = NULL;
+}
+
+TACSSymbolicStructure::~TACSSymbolicStructure() {
+  if (rowp) {
+    delete[] rowp;
+  }
+  if (cols) {
+    delete[] cols;
+  }
+}
+
+/*
+  Retrieve the topology hash the structure was created from
+*/
+uint32_t TACSSymbolicStructure::getTopologyHash() { return topo_hash; }
+
+/*
+  Retrieve the cached node-to-node CSR structure. The arrays remain
+  owned by this object.
+*/
+void TACSSymbolicStructure::getCSR(int *_num_nodes, const int **_rowp,
+                                   const int **_cols) {
+  if (_num_nodes) {
+    *_num_nodes = num_nodes;
+  }
+  if (_rowp) {
+    *_rowp = rowp;
+  }
+  if (_cols) {
+    *_cols = cols;
+  }
+}
+
+/*
+  Write the structure to a binary file.
+
+  The structure is local to each process, so each process must write
+  its own file - encode the rank into the file name.
+
+  returns: non-zero on failure
+*/
+int TACSSymbolicStructure::writeToFile(const char *filename) {
+  FILE *fp = fopen(filename, "wb");
+  if (!fp) {
+    fprintf(stderr, "TACSSymbolicStructure: Could not open file %s\n",
+            filename);
+    return 1;
+  }
+
+  uint32_t header[2] = {TACS_SYMBOLIC_FILE_MAGIC, topo_hash};
+  int fail = (fwrite(header, sizeof(uint32_t), 2, fp) != 2);
+  fail = fail || (fwrite(&num_nodes, sizeof(int), 1, fp) != 1);
+  fail = fail || (fwrite(rowp, sizeof(int), num_nodes + 1, fp) !=
+                  (size_t)num_nodes + 1);
+  int nnz = rowp[num_nodes];
+  fail = fail || (fwrite(cols, sizeof(int), nnz, fp) != (size_t)nnz);
+  fclose(fp);
+
+  if (fail) {
+    fprintf(stderr, "TACSSymbolicStructure: Error writing to file %s\n",
+            filename);
+  }
+  return fail;
+}
+
+/*
+  Read a structure previously written with writeToFile().
+
+  returns: the structure, or NULL on failure
+*/
+TACSSymbolicStructure *TACSSymbolicStructure::readFromFile(
+    const char *filename) {
+  FILE *fp = fopen(filename, "rb");
+  if (!fp) {
+    fprintf(stderr, "TACSSymbolicStructure: Could not open file %s\n",
+            filename);
+    return NULL;
+  }
+
+  uint32_t header[2] = {0, 0};
+  int num_nodes = 0;
+  int fail = (fread(header, sizeof(uint32_t), 2, fp) != 2);
+  fail = fail || (header[0] != TACS_SYMBOLIC_FILE_MAGIC);
+  fail = fail || (fread(&num_nodes, sizeof(int), 1, fp) != 1);
+  fail = fail || (num_nodes < 0);
+
+  int *rowp = NULL, *cols = NULL;
+  if (!fail) {
+    rowp = new int[num_nodes + 1];
+    fail =
+        (fread(rowp, sizeof(int), num_nodes + 1, fp) != (size_t)num_nodes + 1);
+  }
+  if (!fail) {
+    int nnz = rowp[num_nodes];
+    fail = (nnz < 0);
+    if (!fail) {
+      cols = new int[nnz];
+      fail = (fread(cols, sizeof(int), nnz, fp) != (size_t)nnz);
+    }
+  }
+  fclose(fp);
+
+  if (fail) {
+    fprintf(stderr, "TACSSymbolicStructure: Error reading from file %s\n",
+            filename);
+    if (rowp) {
+      delete[] rowp;
+    }
+    if (cols) {
+      delete[] cols;
+    }
+    return NULL;
+  }
+
+  return new TACSSymbolicStructure(header[1], num_nodes, &rowp, &cols);
+}
+
+const char *TACSSymbolicStructure::getObjectName() { return structName; }
@@ -0,0 +1,69 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_SYMBOLIC_STRUCTURE_H
+#define TACS_SYMBOLIC_STRUCTURE_H
+
+#include <stdint.h>
+
+#include "TACSObject.h"
+
+/**
+  Cache of the symbolic (non-zero) structure computed by a
+  TACSAssembler object.
+
+  The node-to-node CSR pattern produced by computeLocalNodeToNodeCSR()
+  depends only on the element connectivity and the node ordering, not
+  on the node locations or design variables. Shape optimization
+  without remeshing therefore recomputes identical symbolic data every
+  time the assembler is recreated for a new geometry. This object
+  captures the CSR pattern together with a hash of the mesh topology,
+  so that a new assembler created with the same connectivity can skip
+  the symbolic computation in createMat() and createSchurMat().
+
+  Create the structure from an initialized assembler with
+  createSymbolicStructure() and hand it to subsequent assemblers with
+  setSymbolicStructure(). The topology hash is verified at the point
+  of use; on a mismatch the cached data is ignored and the symbolic
+  computation runs as before. The structure is local to each process
+  and can be serialized to disk with one file per process.
+*/
+class TACSSymbolicStructure : public TACSObject {
+ public:
+  TACSSymbolicStructure(uint32_t _topo_hash, int _num_nodes, int **_rowp,
+                        int **_cols);
+  ~TACSSymbolicStructure();
+
+  // Retrieve the topology hash the structure was created from
+  uint32_t getTopologyHash();
+
+  // Retrieve the cached node-to-node CSR structure
+  void getCSR(int *_num_nodes, const int **_rowp, const int **_cols);
+
+  // Serialize the structure to/from a per-process file
+  int writeToFile(const char *filename);
+  static TACSSymbolicStructure *readFromFile(const char *filename);
+
+  const char *getObjectName();
+
+ private:
+  // Hash of the mesh topology used to validate the cache
+  uint32_t topo_hash;
+
+  // The node-to-node CSR structure (diagonal included)
+  int num_nodes;
+  int *rowp, *cols;
+
+  static const char *structName;
+};
+
+#endif  // TACS_SYMBOLIC_STRUCTURE_H
@@ -0,0 +1,317 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSThreadPool.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+const char *TACSThreadPool::poolName = "TACSThreadPool";
+
+/*
+  Processor hint executed inside the spin-wait loops
+*/
+static inline void TacsSpinPause() {
+#if defined(__x86_64__) && defined(__GNUC__)
+  __builtin_ia32_pause();
+#endif
+}
+
+const char *TACSThreadPool::getObjectName() { return poolName; }
+
+/*!
+  Create the pool and start the persistent worker threads.
+
+  The workers spin-wait for their next job and park on the work
+  condition variable until run() hands them one or the destructor
+  shuts the pool down.
+
+  input:
+  num_threads:  the number of worker threads to create
+*/
+TACSThreadPool::TACSThreadPool(int _num_threads) {
+  num_threads = _num_threads;
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  if (num_threads > TACSThreadInfo::TACS_MAX_NUM_THREADS) {
+    num_threads = TACSThreadInfo::TACS_MAX_NUM_THREADS;
+  }
+
+  work = NULL;
+  work_info = NULL;
+  job_count = 0;
+  num_active = 0;
+  pool_active = 1;
+  thread_count = 0;
+
+  for (int k = 0; k < num_threads; k++) {
+    sched_head[k] = 0;
+    sched_end[k] = 0;
+  }
+
+  pthread_mutex_init(&pool_mutex, NULL);
+  pthread_cond_init(&work_cond, NULL);
+  pthread_cond_init(&done_cond, NULL);
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+
+  for (int k = 0; k < num_threads; k++) {
+    pthread_create(&workers[k], &attr, TACSThreadPool::worker, (void *)this);
+  }
+
+  pthread_attr_destroy(&attr);
+}
+
+/*!
+  Shut down the pool: wake all the workers so that they observe the
+  shutdown flag, then join them.
+*/
+TACSThreadPool::~TACSThreadPool() {
+  pool_active.store(0, std::memory_order_release);
+
+  // Wake any workers that have parked - the spinning workers observe
+  // the shutdown flag directly
+  pthread_mutex_lock(&pool_mutex);
+  pthread_cond_broadcast(&work_cond);
+  pthread_mutex_unlock(&pool_mutex);
+
+  for (int k = 0; k < num_threads; k++) {
+    pthread_join(workers[k], NULL);
+  }
+
+  pthread_mutex_destroy(&pool_mutex);
+  pthread_cond_destroy(&work_cond);
+  pthread_cond_destroy(&done_cond);
+}
+
+/*
+  Retrieve the number of worker threads in the pool
+*/
+int TACSThreadPool::getNumThreads() { return num_threads; }
+
+/*!
+  Pin each worker thread to a processor core.
+
+  The workers are pinned round-robin over the available cores. On
+  multi-socket nodes this keeps every worker on the same core - and
+  therefore the same memory node - across assembly calls, so the pages
+  that a worker touched first stay local to it for the rest of the
+  run. When the flag is zero the workers are released to run on any
+  core again.
+
+  Thread pinning is only implemented on Linux; elsewhere this call has
+  no effect.
+
+  input:
+  flag:  non-zero to pin the workers, zero to unpin them
+*/
+void TACSThreadPool::setThreadAffinity(int flag) {
+#ifdef __linux__
+  long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (num_cpus < 1) {
+    num_cpus = 1;
+  }
+
+  for (int k = 0; k < num_threads; k++) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    if (flag) {
+      CPU_SET(k % num_cpus, &cpuset);
+    } else {
+      for (long j = 0; j < num_cpus; j++) {
+        CPU_SET(j, &cpuset);
+      }
+    }
+    pthread_setaffinity_np(workers[k], sizeof(cpu_set_t), &cpuset);
+  }
+#else
+  (void)flag;
+#endif
+}
+
+/*!
+  The persistent worker loop.
+
+  Each worker spin-waits on the atomic job counter for a bounded
+  number of iterations and parks on the work condition variable only
+  if no job arrives in that window. After running the work function,
+  the last worker to finish wakes the submitting thread in case it has
+  parked.
+*/
+void *TACSThreadPool::worker(void *t) {
+  TACSThreadPool *pool = static_cast<TACSThreadPool *>(t);
+
+  // The index of the last job this worker has completed
+  int last_job = 0;
+
+  while (1) {
+    // Spin-wait for the next job. Between the assembly calls of a
+    // time-stepping loop the wait is typically short enough that the
+    // rendezvous completes here, without a sleep/wake transition.
+    int posted = 0;
+    for (int spin = 0; spin < SPIN_ITERS; spin++) {
+      if (pool->job_count.load(std::memory_order_acquire) != last_job ||
+          !pool->pool_active.load(std::memory_order_acquire)) {
+        posted = 1;
+        break;
+      }
+      TacsSpinPause();
+    }
+
+    // The spin bound is exhausted - park on the condition variable
+    if (!posted) {
+      pthread_mutex_lock(&pool->pool_mutex);
+      while (pool->pool_active.load(std::memory_order_acquire) &&
+             pool->job_count.load(std::memory_order_acquire) == last_job) {
+        pthread_cond_wait(&pool->work_cond, &pool->pool_mutex);
+      }
+      pthread_mutex_unlock(&pool->pool_mutex);
+    }
+
+    if (!pool->pool_active.load(std::memory_order_acquire)) {
+      break;
+    }
+
+    // The acquire load of the job counter orders these reads after
+    // the stores made by run() before it posted the job
+    last_job = pool->job_count.load(std::memory_order_acquire);
+    void *(*work)(void *) = pool->work;
+    void *work_info = pool->work_info;
+
+    work(work_info);
+
+    // The last worker to finish wakes the submitting thread. Taking
+    // the mutex here ensures the signal cannot fall between the
+    // submitter's predicate check and its wait.
+    if (pool->num_active.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      pthread_mutex_lock(&pool->pool_mutex);
+      pthread_cond_signal(&pool->done_cond);
+      pthread_mutex_unlock(&pool->pool_mutex);
+    }
+  }
+
+  return NULL;
+}
+
+/*!
+  Run the work function on every worker thread and block until all of
+  the workers have completed it.
+
+  Note that the work function must return (not call pthread_exit)
+  since it executes on the persistent worker threads.
+
+  input:
+  work:       the work function to execute on each worker
+  work_info:  the argument passed to each invocation of work
+*/
+void TACSThreadPool::run(void *(*_work)(void *), void *_work_info) {
+  // Publish the job: the release increment of the job counter orders
+  // the job state for the workers' acquire loads
+  work = _work;
+  work_info = _work_info;
+  num_active.store(num_threads, std::memory_order_relaxed);
+  job_count.fetch_add(1, std::memory_order_release);
+
+  // Wake any workers that exhausted their spin bound and parked - the
+  // spinning workers observe the job counter directly
+  pthread_mutex_lock(&pool_mutex);
+  pthread_cond_broadcast(&work_cond);
+  pthread_mutex_unlock(&pool_mutex);
+
+  // Spin-wait for the workers to complete the job before parking
+  for (int spin = 0; spin < SPIN_ITERS; spin++) {
+    if (num_active.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+    TacsSpinPause();
+  }
+
+  pthread_mutex_lock(&pool_mutex);
+  while (num_active.load(std::memory_order_acquire) > 0) {
+    pthread_cond_wait(&done_cond, &pool_mutex);
+  }
+  pthread_mutex_unlock(&pool_mutex);
+}
+
+/*!
+  Initialize the work-stealing schedule over the range [0, total_size).
+
+  The range is split into one contiguous range per worker. This must
+  be called before run() for work functions that pull indices from
+  the schedule.
+
+  input:
+  total_size:  the total number of work indices to schedule
+*/
+void TACSThreadPool::initSchedule(int total_size) {
+  thread_count = 0;
+  for (int k = 0; k < num_threads; k++) {
+    sched_head[k] = (k * total_size) / num_threads;
+    sched_end[k] = ((k + 1) * total_size) / num_threads;
+  }
+}
+
+/*!
+  Claim a unique worker slot in the schedule for the current job.
+
+  Each worker calls this once at the start of the work function and
+  uses the returned slot for all subsequent getNextRange() calls.
+*/
+int TACSThreadPool::acquireThread() {
+  return thread_count.fetch_add(1, std::memory_order_relaxed) % num_threads;
+}
+
+/*!
+  Claim the next chunk of work indices for the given worker slot.
+
+  The worker first takes a chunk from the head of its own range with
+  an atomic fetch-add. Once its own range is exhausted it sweeps the
+  other workers' ranges and steals chunks from them in the same way.
+  Since no work is added during a job, a full sweep that finds every
+  range exhausted terminates the worker.
+
+  input:
+  thread:  the worker slot returned by acquireThread()
+
+  output:
+  begin, end:  the half-open index range [begin, end) to process
+
+  returns:  1 if a chunk was claimed, 0 if all work is complete
+*/
+int TACSThreadPool::getNextRange(int thread, int *begin, int *end) {
+  for (int k = 0; k < num_threads; k++) {
+    int v = (thread + k) % num_threads;
+    int next = sched_head[v].fetch_add(SCHED_CHUNK_SIZE,
+                                       std::memory_order_relaxed);
+    if (next < sched_end[v]) {
+      *begin = next;
+      *end = next + SCHED_CHUNK_SIZE;
+      if (*end > sched_end[v]) {
+        *end = sched_end[v];
+      }
+      return 1;
+    }
+  }
+
+  return 0;
+}
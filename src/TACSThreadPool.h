@@ -0,0 +1,114 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_THREAD_POOL_H
+#define TACS_THREAD_POOL_H
+
+#include <pthread.h>
+
+#include <atomic>
+
+#include "TACSObject.h"
+
+/**
+  A persistent pool of worker threads with a work-stealing element
+  schedule.
+
+  The pool creates its worker threads once and keeps them alive
+  between jobs, so repeated assembly calls do not pay the
+  pthread_create/pthread_join cost. A job consists of running the same
+  work function on every worker; the work function pulls element
+  indices from the pool's schedule.
+
+  Between jobs the workers spin-wait on an atomic job counter for a
+  bounded number of iterations before parking on a condition variable,
+  and the submitting thread waits for completion the same way. The
+  rendezvous between the assembly calls of an explicit-style time loop
+  is typically well under a millisecond, so it usually completes in
+  the spin phase without any sleep/wake transitions; the bound keeps
+  an idle pool from burning cores once the application stops
+  assembling.
+
+  The schedule partitions the total index range into one contiguous
+  range per worker. Workers claim chunks of indices from their own
+  range with a single atomic fetch-add, and when their range is
+  exhausted they steal chunks from the other workers' ranges in the
+  same way. This keeps heterogeneous element mixes load-balanced
+  without any locks on the element pick-up path.
+*/
+class TACSThreadPool : public TACSObject {
+ public:
+  TACSThreadPool(int _num_threads);
+  ~TACSThreadPool();
+
+  // Run the work function on all workers and wait for completion
+  // --------------------------------------------------------------
+  void run(void *(*_work)(void *), void *_work_info);
+
+  // Set up/query the work-stealing schedule for the next job
+  // --------------------------------------------------------
+  void initSchedule(int total_size);
+  int acquireThread();
+  int getNextRange(int thread, int *begin, int *end);
+
+  // Pin the worker threads to processor cores
+  // -----------------------------------------
+  void setThreadAffinity(int flag);
+
+  // Retrieve the number of worker threads
+  // -------------------------------------
+  int getNumThreads();
+
+  const char *getObjectName();
+
+ private:
+  // The entry point executed by each persistent worker thread
+  static void *worker(void *t);
+
+  // The number of indices claimed per atomic schedule operation
+  static const int SCHED_CHUNK_SIZE = 8;
+
+  // The number of spin-wait iterations before a waiting thread parks
+  // on its condition variable
+  static const int SPIN_ITERS = 40000;
+
+  // The number of persistent worker threads
+  int num_threads;
+  pthread_t workers[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+
+  // Job hand-off state. The counters are atomic so that the spin-wait
+  // phase of the rendezvous runs without the pool mutex; the mutex and
+  // condition variables are only used to park and wake threads that
+  // exhaust their spin bound.
+  pthread_mutex_t pool_mutex;
+  pthread_cond_t work_cond, done_cond;
+  void *(*work)(void *);
+  void *work_info;
+  std::atomic<int> job_count;    // Incremented once for each call to run()
+  std::atomic<int> num_active;   // Workers that have not finished the job
+  std::atomic<int> pool_active;  // Zero once the pool is shutting down
+
+  // The work-stealing schedule state
+  std::atomic<int> thread_count;
+  std::atomic<int> sched_head[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+  int sched_end[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+
+  static const char *poolName;
+};
+
+#endif  // TACS_THREAD_POOL_H
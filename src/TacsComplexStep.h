@@ -24,7 +24,7 @@ inline double TacsRealPart(const std::complex<double>& c) { return real(c); }
 inline double TacsImagPart(const std::complex<double>& c) { return imag(c); }
 
 // Dummy function for real part
-inline double TacsRealPart(const double& r) { return r; }
+constexpr double TacsRealPart(const double& r) { return r; }
 
 // There are issues with noise in the complex version of std::arctan
 // We use th following definition to avoid issues with cs
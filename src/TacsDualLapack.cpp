@@ -0,0 +1,377 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2014 Georgia Tech Research Corporation
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "tacslapack.h"
+
+#ifdef TACS_USE_DUAL
+
+/*
+  Native implementations of the BLAS/LAPACK routines that take
+  TacsScalar arguments, for the dual-number build.
+
+  No vendor BLAS exists for the dual type, so the routines that the
+  solver and element code call with TacsScalar arguments are provided
+  here as straightforward loops over the overloaded dual arithmetic.
+  The derivative propagates through every operation by the chain rule,
+  including through the LU factorizations: pivot selection compares
+  value parts only, so the factorization follows the same pivot
+  sequence as the real computation it differentiates.
+
+  These are reference implementations - the dual build is a
+  verification target, not a production target, so clarity is
+  preferred over blocking or vectorization. Routines for banded and
+  packed storage that are only reached from the eigenvalue drivers
+  are not supported in dual mode and report an error.
+*/
+
+extern "C" {
+
+TacsScalar BLASdot(int *n, TacsScalar *x, int *incx, TacsScalar *y,
+                   int *incy) {
+  TacsScalar d = 0.0;
+  for (int i = 0; i < *n; i++) {
+    d += x[i * (*incx)] * y[i * (*incy)];
+  }
+  return d;
+}
+
+double BLASnrm2(int *n, TacsScalar *x, int *incx) {
+  // Following the complex convention, the norm is computed from the
+  // value parts alone and returned as a plain double
+  double d = 0.0;
+  for (int i = 0; i < *n; i++) {
+    double v = x[i * (*incx)].value;
+    d += v * v;
+  }
+  return sqrt(d);
+}
+
+void BLASaxpy(int *n, TacsScalar *a, TacsScalar *x, int *incx, TacsScalar *y,
+              int *incy) {
+  for (int i = 0; i < *n; i++) {
+    y[i * (*incy)] += (*a) * x[i * (*incx)];
+  }
+}
+
+void BLASscal(int *n, TacsScalar *a, TacsScalar *x, int *incx) {
+  for (int i = 0; i < *n; i++) {
+    x[i * (*incx)] *= (*a);
+  }
+}
+
+void BLAScopy(int *n, TacsScalar *x, int *incx, TacsScalar *y, int *incy) {
+  for (int i = 0; i < *n; i++) {
+    y[i * (*incy)] = x[i * (*incx)];
+  }
+}
+
+/*
+  y = alpha*op(A)*x + beta*y for a general column-major matrix
+*/
+void BLASgemv(const char *trans, int *m, int *n, TacsScalar *alpha,
+              TacsScalar *a, int *lda, TacsScalar *x, int *incx,
+              TacsScalar *beta, TacsScalar *y, int *incy) {
+  if (*trans == 'N' || *trans == 'n') {
+    for (int i = 0; i < *m; i++) {
+      TacsScalar t = 0.0;
+      for (int j = 0; j < *n; j++) {
+        t += a[i + j * (*lda)] * x[j * (*incx)];
+      }
+      y[i * (*incy)] = (*alpha) * t + (*beta) * y[i * (*incy)];
+    }
+  } else {
+    for (int j = 0; j < *n; j++) {
+      TacsScalar t = 0.0;
+      for (int i = 0; i < *m; i++) {
+        t += a[i + j * (*lda)] * x[i * (*incx)];
+      }
+      y[j * (*incy)] = (*alpha) * t + (*beta) * y[j * (*incy)];
+    }
+  }
+}
+
+/*
+  C = alpha*op(A)*op(B) + beta*C for general column-major matrices
+*/
+void BLASgemm(const char *ta, const char *tb, int *m, int *n, int *k,
+              TacsScalar *alpha, TacsScalar *a, int *lda, TacsScalar *b,
+              int *ldb, TacsScalar *beta, TacsScalar *c, int *ldc) {
+  int nota = (*ta == 'N' || *ta == 'n');
+  int notb = (*tb == 'N' || *tb == 'n');
+
+  for (int j = 0; j < *n; j++) {
+    for (int i = 0; i < *m; i++) {
+      TacsScalar t = 0.0;
+      for (int p = 0; p < *k; p++) {
+        TacsScalar aip = nota ? a[i + p * (*lda)] : a[p + i * (*lda)];
+        TacsScalar bpj = notb ? b[p + j * (*ldb)] : b[j + p * (*ldb)];
+        t += aip * bpj;
+      }
+      c[i + j * (*ldc)] = (*alpha) * t + (*beta) * c[i + j * (*ldc)];
+    }
+  }
+}
+
+/*
+  Solve op(A)*x = b in-place for a triangular column-major matrix
+*/
+void BLAStrsv(const char *uplo, const char *trans, const char *diag, int *n,
+              TacsScalar *a, int *lda, TacsScalar *x, int *incx) {
+  int upper = (*uplo == 'U' || *uplo == 'u');
+  int notrans = (*trans == 'N' || *trans == 'n');
+  int unit = (*diag == 'U' || *diag == 'u');
+
+  // op(A) is lower triangular when A is lower and not transposed, or
+  // when A is upper and transposed
+  int forward = (upper == !notrans);
+
+  if (forward) {
+    for (int i = 0; i < *n; i++) {
+      TacsScalar t = x[i * (*incx)];
+      for (int j = 0; j < i; j++) {
+        TacsScalar aij = notrans ? a[i + j * (*lda)] : a[j + i * (*lda)];
+        t -= aij * x[j * (*incx)];
+      }
+      if (!unit) {
+        TacsScalar aii = a[i + i * (*lda)];
+        t = t / aii;
+      }
+      x[i * (*incx)] = t;
+    }
+  } else {
+    for (int i = *n - 1; i >= 0; i--) {
+      TacsScalar t = x[i * (*incx)];
+      for (int j = i + 1; j < *n; j++) {
+        TacsScalar aij = notrans ? a[i + j * (*lda)] : a[j + i * (*lda)];
+        t -= aij * x[j * (*incx)];
+      }
+      if (!unit) {
+        TacsScalar aii = a[i + i * (*lda)];
+        t = t / aii;
+      }
+      x[i * (*incx)] = t;
+    }
+  }
+}
+
+/*
+  Solve op(A)*X = alpha*B or X*op(A) = alpha*B for triangular A
+*/
+void BLAStrsm(const char *side, const char *uplo, const char *transa,
+              const char *diag, int *m, int *n, TacsScalar *alpha,
+              TacsScalar *a, int *lda, TacsScalar *b, int *ldb) {
+  int one = 1;
+
+  if (*side == 'L' || *side == 'l') {
+    // Solve op(A)*X = alpha*B one column at a time
+    for (int j = 0; j < *n; j++) {
+      TacsScalar *bj = &b[j * (*ldb)];
+      for (int i = 0; i < *m; i++) {
+        bj[i] = (*alpha) * bj[i];
+      }
+      BLAStrsv(uplo, transa, diag, m, a, lda, bj, &one);
+    }
+  } else {
+    // Solve X*op(A) = alpha*B: each row of X satisfies
+    // op(A)^{T} x^{T} = alpha*b^{T}
+    const char *t =
+        (*transa == 'N' || *transa == 'n') ? "T" : "N";
+    for (int i = 0; i < *m; i++) {
+      TacsScalar *bi = &b[i];
+      for (int j = 0; j < *n; j++) {
+        bi[j * (*ldb)] = (*alpha) * bi[j * (*ldb)];
+      }
+      BLAStrsv(uplo, t, diag, n, a, lda, bi, ldb);
+    }
+  }
+}
+
+/*
+  Compute an LU factorization with partial pivoting. The pivot
+  selection compares value parts only, so the pivot sequence matches
+  the underlying real factorization.
+*/
+void LAPACKgetrf(int *m, int *n, TacsScalar *a, int *lda, int *ipiv,
+                 int *info) {
+  *info = 0;
+  int mn = (*m < *n) ? *m : *n;
+
+  for (int k = 0; k < mn; k++) {
+    // Find the pivot row
+    int p = k;
+    double amax = fabs(a[k + k * (*lda)].value);
+    for (int i = k + 1; i < *m; i++) {
+      double av = fabs(a[i + k * (*lda)].value);
+      if (av > amax) {
+        amax = av;
+        p = i;
+      }
+    }
+    ipiv[k] = p + 1;  // LAPACK uses 1-based pivot indices
+
+    if (amax == 0.0) {
+      if (*info == 0) {
+        *info = k + 1;
+      }
+      continue;
+    }
+
+    // Swap rows k and p
+    if (p != k) {
+      for (int j = 0; j < *n; j++) {
+        TacsScalar t = a[k + j * (*lda)];
+        a[k + j * (*lda)] = a[p + j * (*lda)];
+        a[p + j * (*lda)] = t;
+      }
+    }
+
+    // Eliminate below the diagonal
+    TacsScalar inv = 1.0 / a[k + k * (*lda)];
+    for (int i = k + 1; i < *m; i++) {
+      a[i + k * (*lda)] *= inv;
+    }
+    for (int j = k + 1; j < *n; j++) {
+      TacsScalar akj = a[k + j * (*lda)];
+      for (int i = k + 1; i < *m; i++) {
+        a[i + j * (*lda)] -= a[i + k * (*lda)] * akj;
+      }
+    }
+  }
+}
+
+/*
+  Solve op(A)*X = B with a factored matrix from LAPACKgetrf
+*/
+void LAPACKgetrs(const char *trans, int *n, int *nrhs, TacsScalar *a, int *lda,
+                 int *ipiv, TacsScalar *b, int *ldb, int *info) {
+  *info = 0;
+  int one = 1;
+
+  if (*trans == 'N' || *trans == 'n') {
+    for (int j = 0; j < *nrhs; j++) {
+      TacsScalar *bj = &b[j * (*ldb)];
+
+      // Apply the row interchanges
+      for (int k = 0; k < *n; k++) {
+        int p = ipiv[k] - 1;
+        if (p != k) {
+          TacsScalar t = bj[k];
+          bj[k] = bj[p];
+          bj[p] = t;
+        }
+      }
+
+      // Solve L*y = b then U*x = y
+      BLAStrsv("L", "N", "U", n, a, lda, bj, &one);
+      BLAStrsv("U", "N", "N", n, a, lda, bj, &one);
+    }
+  } else {
+    for (int j = 0; j < *nrhs; j++) {
+      TacsScalar *bj = &b[j * (*ldb)];
+
+      // Solve U^{T}*y = b then L^{T}*x = y
+      BLAStrsv("U", "T", "N", n, a, lda, bj, &one);
+      BLAStrsv("L", "T", "U", n, a, lda, bj, &one);
+
+      // Apply the row interchanges in reverse
+      for (int k = *n - 1; k >= 0; k--) {
+        int p = ipiv[k] - 1;
+        if (p != k) {
+          TacsScalar t = bj[k];
+          bj[k] = bj[p];
+          bj[p] = t;
+        }
+      }
+    }
+  }
+}
+
+/*
+  Solve A*X = B by LU factorization with partial pivoting
+*/
+void LAPACKgesv(int *n, int *nrhs, TacsScalar *a, int *lda, int *ipiv,
+                TacsScalar *b, int *ldb, int *info) {
+  LAPACKgetrf(n, n, a, lda, ipiv, info);
+  if (*info == 0) {
+    LAPACKgetrs("N", n, nrhs, a, lda, ipiv, b, ldb, info);
+  }
+}
+
+/*
+  Compute the inverse of a matrix from its LU factorization
+*/
+void LAPACKgetri(int *n, TacsScalar *a, int *lda, int *ipiv, TacsScalar *work,
+                 int *lwork, int *info) {
+  *info = 0;
+
+  // Solve A*X = I column by column into a temporary, then copy back
+  TacsScalar *ainv = new TacsScalar[(*n) * (*n)];
+  memset(ainv, 0, (*n) * (*n) * sizeof(TacsScalar));
+  for (int j = 0; j < *n; j++) {
+    ainv[j + j * (*n)] = 1.0;
+  }
+
+  LAPACKgetrs("N", n, n, a, lda, ipiv, ainv, n, info);
+
+  for (int j = 0; j < *n; j++) {
+    for (int i = 0; i < *n; i++) {
+      a[i + j * (*lda)] = ainv[i + j * (*n)];
+    }
+  }
+  delete[] ainv;
+}
+
+/*
+  The banded and packed-storage routines are only reached from the
+  eigenvalue and banded-matrix drivers, which are not supported in the
+  dual build
+*/
+void BLASsbmv(const char *uplo, int *n, int *kb, TacsScalar *alpha,
+              TacsScalar *a, int *lda, TacsScalar *x, int *incx,
+              TacsScalar *beta, TacsScalar *y, int *incy) {
+  fprintf(stderr, "BLASsbmv is not available in the dual build\n");
+}
+
+void BLASgbmv(const char *trans, int *m, int *n, int *kl, int *ku,
+              TacsScalar *alpha, TacsScalar *a, int *lda, TacsScalar *x,
+              int *incx, TacsScalar *beta, TacsScalar *y, int *incy) {
+  fprintf(stderr, "BLASgbmv is not available in the dual build\n");
+}
+
+void BLAStbsv(const char *uplo, const char *trans, const char *diag, int *n,
+              int *kd, TacsScalar *a, int *lda, TacsScalar *x, int *incx) {
+  fprintf(stderr, "BLAStbsv is not available in the dual build\n");
+}
+
+void LAPACKpbtrf(const char *uplo, int *n, int *kd, TacsScalar *ab, int *ldab,
+                 int *info) {
+  fprintf(stderr, "LAPACKpbtrf is not available in the dual build\n");
+  *info = -1;
+}
+
+void LAPACKspsv(const char *uplo, int *n, int *nrhs, TacsScalar *a, int *ipiv,
+                TacsScalar *b, int *ldb, int *info) {
+  fprintf(stderr, "LAPACKspsv is not available in the dual build\n");
+  *info = -1;
+}
+
+void LAPACKstev(const char *jobz, int *n, TacsScalar *d, TacsScalar *e,
+                TacsScalar *z, int *ldz, TacsScalar *work, int *info) {
+  fprintf(stderr, "LAPACKstev is not available in the dual build\n");
+  *info = -1;
+}
+
+}  // extern "C"
+
+#endif  // TACS_USE_DUAL
@@ -0,0 +1,246 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2014 Georgia Tech Research Corporation
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_DUAL_NUM_H
+#define TACS_DUAL_NUM_H
+
+#include <math.h>
+
+/*
+  A dual-number scalar type for forward-mode derivative propagation.
+
+  Each scalar carries a value and a single directional derivative.
+  Arithmetic propagates the derivative exactly by the chain rule, so
+  compiling with -DTACS_USE_DUAL gives machine-precision directional
+  derivatives - like the complex-step method - but with native real
+  arithmetic: storage is the same two doubles as a complex number,
+  while products cost two multiply-adds instead of the four multiplies
+  and two additions of complex arithmetic, and no step size is needed.
+
+  To compute a derivative, seed the dual part of the inputs with the
+  perturbation direction and read the dual part of the outputs.
+
+  Unlike std::complex, the type is ordered by its value part, so code
+  written for the real build that compares TacsScalar values directly
+  compiles unchanged.
+*/
+class TacsDual {
+ public:
+  TacsDual() : value(0.0), deriv(0.0) {}
+  TacsDual(double _value) : value(_value), deriv(0.0) {}
+  TacsDual(double _value, double _deriv) : value(_value), deriv(_deriv) {}
+
+  // In-place arithmetic operators
+  inline TacsDual& operator+=(const TacsDual& a) {
+    value += a.value;
+    deriv += a.deriv;
+    return *this;
+  }
+  inline TacsDual& operator-=(const TacsDual& a) {
+    value -= a.value;
+    deriv -= a.deriv;
+    return *this;
+  }
+  inline TacsDual& operator*=(const TacsDual& a) {
+    deriv = deriv * a.value + value * a.deriv;
+    value *= a.value;
+    return *this;
+  }
+  inline TacsDual& operator/=(const TacsDual& a) {
+    double inv = 1.0 / a.value;
+    value *= inv;
+    deriv = (deriv - value * a.deriv) * inv;
+    return *this;
+  }
+  inline TacsDual& operator+=(double a) {
+    value += a;
+    return *this;
+  }
+  inline TacsDual& operator-=(double a) {
+    value -= a;
+    return *this;
+  }
+  inline TacsDual& operator*=(double a) {
+    value *= a;
+    deriv *= a;
+    return *this;
+  }
+  inline TacsDual& operator/=(double a) {
+    value /= a;
+    deriv /= a;
+    return *this;
+  }
+
+  double value;  // The value
+  double deriv;  // The directional derivative
+};
+
+// Unary operators
+inline TacsDual operator-(const TacsDual& a) {
+  return TacsDual(-a.value, -a.deriv);
+}
+inline TacsDual operator+(const TacsDual& a) { return a; }
+
+// Binary arithmetic operators
+inline TacsDual operator+(const TacsDual& a, const TacsDual& b) {
+  return TacsDual(a.value + b.value, a.deriv + b.deriv);
+}
+inline TacsDual operator+(const TacsDual& a, double b) {
+  return TacsDual(a.value + b, a.deriv);
+}
+inline TacsDual operator+(double a, const TacsDual& b) {
+  return TacsDual(a + b.value, b.deriv);
+}
+inline TacsDual operator-(const TacsDual& a, const TacsDual& b) {
+  return TacsDual(a.value - b.value, a.deriv - b.deriv);
+}
+inline TacsDual operator-(const TacsDual& a, double b) {
+  return TacsDual(a.value - b, a.deriv);
+}
+inline TacsDual operator-(double a, const TacsDual& b) {
+  return TacsDual(a - b.value, -b.deriv);
+}
+inline TacsDual operator*(const TacsDual& a, const TacsDual& b) {
+  return TacsDual(a.value * b.value, a.deriv * b.value + a.value * b.deriv);
+}
+inline TacsDual operator*(const TacsDual& a, double b) {
+  return TacsDual(a.value * b, a.deriv * b);
+}
+inline TacsDual operator*(double a, const TacsDual& b) {
+  return TacsDual(a * b.value, a * b.deriv);
+}
+inline TacsDual operator/(const TacsDual& a, const TacsDual& b) {
+  double inv = 1.0 / b.value;
+  double val = a.value * inv;
+  return TacsDual(val, (a.deriv - val * b.deriv) * inv);
+}
+inline TacsDual operator/(const TacsDual& a, double b) {
+  return TacsDual(a.value / b, a.deriv / b);
+}
+inline TacsDual operator/(double a, const TacsDual& b) {
+  double inv = 1.0 / b.value;
+  double val = a * inv;
+  return TacsDual(val, -val * b.deriv * inv);
+}
+
+// Comparison operators - ordered by the value part
+inline bool operator==(const TacsDual& a, const TacsDual& b) {
+  return a.value == b.value;
+}
+inline bool operator!=(const TacsDual& a, const TacsDual& b) {
+  return a.value != b.value;
+}
+inline bool operator<(const TacsDual& a, const TacsDual& b) {
+  return a.value < b.value;
+}
+inline bool operator<=(const TacsDual& a, const TacsDual& b) {
+  return a.value <= b.value;
+}
+inline bool operator>(const TacsDual& a, const TacsDual& b) {
+  return a.value > b.value;
+}
+inline bool operator>=(const TacsDual& a, const TacsDual& b) {
+  return a.value >= b.value;
+}
+inline bool operator==(const TacsDual& a, double b) { return a.value == b; }
+inline bool operator!=(const TacsDual& a, double b) { return a.value != b; }
+inline bool operator<(const TacsDual& a, double b) { return a.value < b; }
+inline bool operator<=(const TacsDual& a, double b) { return a.value <= b; }
+inline bool operator>(const TacsDual& a, double b) { return a.value > b; }
+inline bool operator>=(const TacsDual& a, double b) { return a.value >= b; }
+inline bool operator==(double a, const TacsDual& b) { return a == b.value; }
+inline bool operator!=(double a, const TacsDual& b) { return a != b.value; }
+inline bool operator<(double a, const TacsDual& b) { return a < b.value; }
+inline bool operator<=(double a, const TacsDual& b) { return a <= b.value; }
+inline bool operator>(double a, const TacsDual& b) { return a > b.value; }
+inline bool operator>=(double a, const TacsDual& b) { return a >= b.value; }
+
+// Mathematical functions with chain-rule derivative propagation
+inline TacsDual sqrt(const TacsDual& a) {
+  double val = ::sqrt(a.value);
+  return TacsDual(val, 0.5 * a.deriv / val);
+}
+inline TacsDual exp(const TacsDual& a) {
+  double val = ::exp(a.value);
+  return TacsDual(val, val * a.deriv);
+}
+inline TacsDual log(const TacsDual& a) {
+  return TacsDual(::log(a.value), a.deriv / a.value);
+}
+inline TacsDual pow(const TacsDual& a, double b) {
+  double val = ::pow(a.value, b);
+  return TacsDual(val, b * ::pow(a.value, b - 1.0) * a.deriv);
+}
+inline TacsDual pow(const TacsDual& a, int b) {
+  double val = ::pow(a.value, b);
+  return TacsDual(val, b * ::pow(a.value, b - 1) * a.deriv);
+}
+inline TacsDual pow(const TacsDual& a, const TacsDual& b) {
+  double val = ::pow(a.value, b.value);
+  return TacsDual(val, val * (b.deriv * ::log(a.value) +
+                              b.value * a.deriv / a.value));
+}
+inline TacsDual sin(const TacsDual& a) {
+  return TacsDual(::sin(a.value), ::cos(a.value) * a.deriv);
+}
+inline TacsDual cos(const TacsDual& a) {
+  return TacsDual(::cos(a.value), -::sin(a.value) * a.deriv);
+}
+inline TacsDual tan(const TacsDual& a) {
+  double t = ::tan(a.value);
+  return TacsDual(t, (1.0 + t * t) * a.deriv);
+}
+inline TacsDual asin(const TacsDual& a) {
+  return TacsDual(::asin(a.value),
+                  a.deriv / ::sqrt(1.0 - a.value * a.value));
+}
+inline TacsDual acos(const TacsDual& a) {
+  return TacsDual(::acos(a.value),
+                  -a.deriv / ::sqrt(1.0 - a.value * a.value));
+}
+inline TacsDual atan(const TacsDual& a) {
+  return TacsDual(::atan(a.value), a.deriv / (1.0 + a.value * a.value));
+}
+inline TacsDual atan2(const TacsDual& y, const TacsDual& x) {
+  double den = x.value * x.value + y.value * y.value;
+  return TacsDual(::atan2(y.value, x.value),
+                  (x.value * y.deriv - y.value * x.deriv) / den);
+}
+inline TacsDual sinh(const TacsDual& a) {
+  return TacsDual(::sinh(a.value), ::cosh(a.value) * a.deriv);
+}
+inline TacsDual cosh(const TacsDual& a) {
+  return TacsDual(::cosh(a.value), ::sinh(a.value) * a.deriv);
+}
+inline TacsDual tanh(const TacsDual& a) {
+  double t = ::tanh(a.value);
+  return TacsDual(t, (1.0 - t * t) * a.deriv);
+}
+inline TacsDual fabs(const TacsDual& a) {
+  if (a.value < 0.0) {
+    return -a;
+  }
+  return a;
+}
+
+// Extract the value part of a dual number
+inline double TacsRealPart(const TacsDual& a) { return a.value; }
+
+// Extract the derivative part of a dual number
+inline double TacsDualPart(const TacsDual& a) { return a.deriv; }
+
+// Dummy function for the real scalar type
+inline double TacsDualPart(const double& a) { return 0.0; }
+
+#endif  // TACS_DUAL_NUM_H
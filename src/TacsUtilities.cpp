@@ -16,6 +16,9 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "TACSProfiler.h"
 
 int TacsIntegerComparator(const void *a, const void *b) {
   return (*(int *)a - *(int *)b);
@@ -1033,3 +1036,289 @@ TacsScalar ksAggregationSensProduct(const TacsScalar f[], const int numVals,
   }
   return maxVal + log(sum) / ksWeight;
 }
+
+/*
+  Duplicate a read-only array into MPI-3 shared memory with one copy
+  per node.
+
+  The communicator is split into node-local groups and a shared-memory
+  window holding a single copy of the data is allocated on each node.
+  The data is broadcast from the root rank to the leader rank of each
+  node and is then visible to every rank on the node through the
+  window. When shared-memory windows are not available, the code falls
+  back to one private copy per rank and sets the window to
+  MPI_WIN_NULL.
+*/
+void *TacsAllocateSharedMemory(MPI_Comm comm, int root, const void *data,
+                               size_t size, MPI_Win *win) {
+#if MPI_VERSION >= 3
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  // Split the communicator into groups of ranks that share memory
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL,
+                      &node_comm);
+
+  int node_rank;
+  MPI_Comm_rank(node_comm, &node_rank);
+
+  // Allocate the storage for the data on the leader rank of each node
+  // and query the node-local address of the single copy
+  void *base = NULL;
+  MPI_Aint local_size = (node_rank == 0 ? size : 0);
+  MPI_Win_allocate_shared(local_size, 1, MPI_INFO_NULL, node_comm, &base, win);
+
+  MPI_Aint shared_size;
+  int disp_unit;
+  void *ptr = NULL;
+  MPI_Win_shared_query(*win, 0, &shared_size, &disp_unit, &ptr);
+
+  // Broadcast the data from the root rank to the node leaders. The
+  // root rank is placed first in the leader communicator so that it
+  // is the broadcast root, regardless of whether it leads its node.
+  int color = (node_rank == 0 || rank == root) ? 1 : MPI_UNDEFINED;
+  int key = (rank == root) ? 0 : rank + 1;
+  MPI_Comm leader_comm;
+  MPI_Comm_split(comm, color, key, &leader_comm);
+
+  if (leader_comm != MPI_COMM_NULL) {
+    void *buf = ptr;
+    if (rank == root) {
+      if (node_rank == 0) {
+        memcpy(ptr, data, size);
+      } else {
+        buf = (void *)data;
+      }
+    }
+    MPI_Bcast(buf, size, MPI_BYTE, 0, leader_comm);
+    MPI_Comm_free(&leader_comm);
+  }
+
+  // Ensure that the data is in place before any rank reads it
+  MPI_Barrier(comm);
+  MPI_Comm_free(&node_comm);
+
+  return ptr;
+#else
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  // Shared-memory windows are unavailable - allocate a private copy
+  // of the data on every rank
+  *win = MPI_WIN_NULL;
+  char *ptr = new char[size];
+  if (rank == root) {
+    memcpy(ptr, data, size);
+  }
+  MPI_Bcast(ptr, size, MPI_BYTE, root, comm);
+
+  return ptr;
+#endif  // MPI_VERSION >= 3
+}
+
+/*
+  Free memory allocated by TacsAllocateSharedMemory()
+*/
+void TacsFreeSharedMemory(void *ptr, MPI_Win *win) {
+  if (*win != MPI_WIN_NULL) {
+    MPI_Win_free(win);
+  } else if (ptr) {
+    delete[] (char *)ptr;
+  }
+}
+
+/*
+  The cached node-level communicator hierarchies.
+
+  Each entry stores the node-local and node-leader communicators
+  derived from one communicator. The entries are created on first use
+  and kept for the life of the process - the hierarchies are tiny and
+  are reused by every reduction over the same communicator.
+*/
+struct TacsCommHierarchy {
+  MPI_Comm comm;         // The communicator the hierarchy derives from
+  MPI_Comm node_comm;    // The ranks of comm on the same node
+  MPI_Comm leader_comm;  // The node leaders (MPI_COMM_NULL otherwise)
+  int two_level;         // Whether the two-level path applies
+};
+
+static const int TACS_MAX_COMM_HIERARCHIES = 16;
+static TacsCommHierarchy tacs_comm_hierarchy[TACS_MAX_COMM_HIERARCHIES];
+static int tacs_num_comm_hierarchies = 0;
+
+/*
+  Retrieve (or build) the node-level hierarchy for a communicator
+*/
+static TacsCommHierarchy *tacsGetCommHierarchy(MPI_Comm comm) {
+  for (int k = 0; k < tacs_num_comm_hierarchies; k++) {
+    if (tacs_comm_hierarchy[k].comm == comm) {
+      return &tacs_comm_hierarchy[k];
+    }
+  }
+
+  // The cache is full - fall back to the flat reduction
+  if (tacs_num_comm_hierarchies >= TACS_MAX_COMM_HIERARCHIES) {
+    return NULL;
+  }
+
+  TacsCommHierarchy *h = &tacs_comm_hierarchy[tacs_num_comm_hierarchies];
+  tacs_num_comm_hierarchies++;
+  h->comm = comm;
+  h->node_comm = MPI_COMM_NULL;
+  h->leader_comm = MPI_COMM_NULL;
+  h->two_level = 0;
+
+#if MPI_VERSION >= 3
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  // Split the communicator into groups of ranks that share memory
+  MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL,
+                      &h->node_comm);
+
+  int node_rank, node_size;
+  MPI_Comm_rank(h->node_comm, &node_rank);
+  MPI_Comm_size(h->node_comm, &node_size);
+
+  // Create the communicator of node leaders
+  int color = (node_rank == 0 ? 1 : MPI_UNDEFINED);
+  MPI_Comm_split(comm, color, rank, &h->leader_comm);
+
+  // The two-level path only pays off when nodes hold several ranks
+  // and there is more than one node
+  int num_nodes = (node_rank == 0 ? 1 : 0);
+  MPI_Allreduce(MPI_IN_PLACE, &num_nodes, 1, MPI_INT, MPI_SUM, comm);
+
+  if (node_size > 1 && num_nodes > 1) {
+    h->two_level = 1;
+  } else {
+    MPI_Comm_free(&h->node_comm);
+    if (h->leader_comm != MPI_COMM_NULL) {
+      MPI_Comm_free(&h->leader_comm);
+    }
+    h->node_comm = MPI_COMM_NULL;
+    h->leader_comm = MPI_COMM_NULL;
+  }
+#endif  // MPI_VERSION >= 3
+
+  return h;
+}
+
+/*
+  Non-zero if the scalar reductions must be bit-reproducible from run
+  to run
+*/
+static int tacs_deterministic_reductions = 0;
+
+void TacsSetDeterministicReductions(int flag) {
+  tacs_deterministic_reductions = flag;
+}
+
+int TacsGetDeterministicReductions() { return tacs_deterministic_reductions; }
+
+/*
+  Sum scalar values over all ranks with a node-aware two-level
+  reduction: reduce to the node leader in shared memory, sum across
+  the node leaders, then broadcast within each node.
+
+  In the deterministic mode the per-rank partial sums are gathered to
+  the root and added in rank order instead, so the result does not
+  depend on the reduction tree chosen by the MPI library.
+*/
+void TacsScalarAllreduce(MPI_Comm comm, TacsScalar *vals, int count) {
+  double twait = MPI_Wtime();
+  if (tacs_deterministic_reductions) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    TacsScalar *parts = NULL;
+    if (rank == 0) {
+      parts = new TacsScalar[count * (size_t)size];
+    }
+    MPI_Gather(vals, count, TACS_MPI_TYPE, parts, count, TACS_MPI_TYPE, 0,
+               comm);
+
+    if (rank == 0) {
+      for (int j = 0; j < count; j++) {
+        // Compensated (Kahan) summation over the ranks in rank order
+        TacsScalar sum = 0.0, c = 0.0;
+        for (int k = 0; k < size; k++) {
+          TacsScalar y = parts[count * k + j] - c;
+          TacsScalar t = sum + y;
+          c = (t - sum) - y;
+          sum = t;
+        }
+        vals[j] = sum;
+      }
+      delete[] parts;
+    }
+    MPI_Bcast(vals, count, TACS_MPI_TYPE, 0, comm);
+    TacsProfileAddWait("ScalarAllreduce", MPI_Wtime() - twait);
+    return;
+  }
+
+  TacsCommHierarchy *h = tacsGetCommHierarchy(comm);
+
+  if (h && h->two_level) {
+    int node_rank;
+    MPI_Comm_rank(h->node_comm, &node_rank);
+
+    if (node_rank == 0) {
+      MPI_Reduce(MPI_IN_PLACE, vals, count, TACS_MPI_TYPE, MPI_SUM, 0,
+                 h->node_comm);
+      MPI_Allreduce(MPI_IN_PLACE, vals, count, TACS_MPI_TYPE, MPI_SUM,
+                    h->leader_comm);
+    } else {
+      MPI_Reduce(vals, NULL, count, TACS_MPI_TYPE, MPI_SUM, 0, h->node_comm);
+    }
+
+    MPI_Bcast(vals, count, TACS_MPI_TYPE, 0, h->node_comm);
+  } else {
+    MPI_Allreduce(MPI_IN_PLACE, vals, count, TACS_MPI_TYPE, MPI_SUM, comm);
+  }
+  TacsProfileAddWait("ScalarAllreduce", MPI_Wtime() - twait);
+}
+
+/*
+  The per-process memory budget and the bytes registered against it.
+
+  The budget is consulted from the set-up code paths that allocate
+  factorization storage. Those paths run on a single thread, so no
+  locking is used for the counters.
+*/
+static size_t tacs_memory_budget = 0;
+static size_t tacs_registered_memory = 0;
+
+/*
+  Set the per-process memory budget in bytes. Zero disables the budget.
+*/
+void TacsSetMemoryBudget(size_t bytes) { tacs_memory_budget = bytes; }
+
+/*
+  Retrieve the per-process memory budget
+*/
+size_t TacsGetMemoryBudget() { return tacs_memory_budget; }
+
+/*
+  Register an allocation against the per-process budget
+*/
+void TacsRegisterAllocation(size_t bytes) { tacs_registered_memory += bytes; }
+
+/*
+  Release an allocation registered against the per-process budget
+*/
+void TacsReleaseAllocation(size_t bytes) {
+  if (bytes > tacs_registered_memory) {
+    tacs_registered_memory = 0;
+  } else {
+    tacs_registered_memory -= bytes;
+  }
+}
+
+/*
+  Retrieve the number of bytes registered against the budget
+*/
+size_t TacsGetRegisteredMemory() { return tacs_registered_memory; }
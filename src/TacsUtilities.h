@@ -114,6 +114,116 @@ int TacsComputeRCMOrder(const int nvars, const int *rowp, const int *cols,
 int TacsComputeSerialMultiColor(const int nvars, const int *rowp,
                                 const int *cols, int *colors, int *new_vars);
 
+/**
+  Duplicate a read-only array into MPI-3 shared memory with one copy
+  per node.
+
+  The communicator is split into node-local groups and the data is
+  stored once per node in a shared-memory window, so every rank on a
+  node reads the same copy rather than holding its own duplicate. The
+  data is broadcast from the given root rank into each node's copy.
+  When the MPI library does not provide shared-memory windows, each
+  rank receives its own copy and the window is set to MPI_WIN_NULL.
+
+  This call is collective on the communicator. The returned memory
+  must be treated as read-only and freed with TacsFreeSharedMemory().
+
+  @param comm The communicator over which the data is shared
+  @param root The rank that owns the source data
+  @param data The source data on the root rank (ignored elsewhere)
+  @param size The size of the data in bytes
+  @param win The window associated with the allocation
+  @return The node-local pointer to the shared copy of the data
+*/
+void *TacsAllocateSharedMemory(MPI_Comm comm, int root, const void *data,
+                               size_t size, MPI_Win *win);
+
+/**
+  Free memory allocated by TacsAllocateSharedMemory(). This call is
+  collective on the communicator used for the allocation.
+
+  @param ptr The pointer returned by the allocation
+  @param win The window associated with the allocation
+*/
+void TacsFreeSharedMemory(void *ptr, MPI_Win *win);
+
+/**
+  Sum scalar values over all ranks with a node-aware reduction.
+
+  The values are first reduced in shared memory across the ranks on
+  each node, then summed across the node leaders, and finally
+  broadcast within each node. With several ranks per node this
+  shortens the critical path of the reduction relative to a flat
+  MPI_Allreduce over all ranks. The communicator hierarchy is built
+  on first use and cached, so repeated reductions over the same
+  communicator - such as the inner products in the Krylov methods -
+  pay no setup cost. When the MPI library cannot split the
+  communicator by node, or when the split would not help, the call
+  falls back to a flat all-reduce.
+
+  This call is collective on the communicator.
+
+  @param comm The communicator for the reduction
+  @param vals The local values; overwritten with the global sums
+  @param count The number of values to reduce
+*/
+void TacsScalarAllreduce(MPI_Comm comm, TacsScalar *vals, int count);
+
+/**
+  Enable or disable deterministic (bit-reproducible) reductions.
+
+  When enabled, TacsScalarAllreduce gathers the per-rank partial sums
+  to the root and adds them in rank order with compensated summation,
+  then broadcasts the result. The summation order no longer depends on
+  the reduction tree chosen by the MPI library, so the function values
+  and the Krylov inner products are identical from run to run on a
+  fixed processor count. The split-phase dot products also complete
+  eagerly in this mode, since a non-blocking all-reduce does not fix
+  the reduction order. The gather lengthens the critical path of each
+  reduction, which is a reasonable price in regression and debugging
+  runs.
+
+  @param flag Non-zero for deterministic reductions
+*/
+void TacsSetDeterministicReductions(int flag);
+
+/**
+  Retrieve the deterministic reduction flag
+
+  @return Non-zero if deterministic reductions are enabled
+*/
+int TacsGetDeterministicReductions();
+
+/**
+  Set the per-process memory budget.
+
+  The large consumers of memory - principally the storage allocated
+  for matrix factorizations - register their allocations against this
+  budget. When a projected allocation would exceed the budget, the
+  consumer degrades predictably, for instance by reducing the ILU
+  level of fill, or prints a warning ahead of the allocation instead
+  of being killed by the operating system mid-run.
+
+  @param bytes The budget in bytes. Zero disables the budget.
+*/
+void TacsSetMemoryBudget(size_t bytes);
+
+/**
+  Retrieve the per-process memory budget (zero when no budget is set)
+*/
+size_t TacsGetMemoryBudget();
+
+/**
+  Register/release an allocation against the per-process budget
+*/
+void TacsRegisterAllocation(size_t bytes);
+void TacsReleaseAllocation(size_t bytes);
+
+/**
+  Retrieve the number of bytes registered against the budget
+*/
+size_t TacsGetRegisteredMemory();
+
 /*
   Hash table implementation for storing a set of integers
 */
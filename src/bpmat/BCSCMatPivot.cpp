@@ -1536,6 +1536,7 @@ BCSCMatPivot::BCSCMatPivot(BCSCMat *_mat) {
   lu_aptr = new int[nblock_cols + 1];
   lu_diag_ptr = new int[nblock_cols];
   lu_col_ptr = new int[nblock_cols + 1];
+  lu_col_end = new int[nblock_cols];
 
   // Null-out the initial arrays
   max_lu_size = 0;
@@ -1543,6 +1544,15 @@ BCSCMatPivot::BCSCMatPivot(BCSCMat *_mat) {
 
   max_lu_rows_size = 0;
   lu_rows = NULL;
+
+  // By default, the factorization is serial. The elimination tree is
+  // only computed if the threaded factorization is used.
+  num_threads = 1;
+  pool = NULL;
+  etree_parent = NULL;
+  etree_list = NULL;
+  etree_level_ptr = NULL;
+  num_etree_levels = 0;
 }
 
 /*
@@ -1582,9 +1592,52 @@ BCSCMatPivot::~BCSCMatPivot() {
   if (lu_col_ptr) {
     delete[] lu_col_ptr;
   }
+  if (lu_col_end) {
+    delete[] lu_col_end;
+  }
   if (lu_rows) {
     delete[] lu_rows;
   }
+  if (pool) {
+    pool->decref();
+  }
+  if (etree_parent) {
+    delete[] etree_parent;
+  }
+  if (etree_list) {
+    delete[] etree_list;
+  }
+  if (etree_level_ptr) {
+    delete[] etree_level_ptr;
+  }
+}
+
+/*
+  Set the number of threads to use during the factorization.
+
+  When more than one thread is requested, the factorization is
+  level-scheduled over the column elimination tree: block columns on
+  disjoint subtrees are factored concurrently. The partial pivoting
+  semantics are unchanged and the threaded code produces the same
+  factorization as the serial code.
+
+  input:
+  num_threads:  the number of threads to use in factor()
+*/
+void BCSCMatPivot::setNumThreads(int _num_threads) {
+  num_threads = _num_threads;
+  if (num_threads < 1) {
+    num_threads = 1;
+  } else if (num_threads > TACSThreadInfo::TACS_MAX_NUM_THREADS) {
+    num_threads = TACSThreadInfo::TACS_MAX_NUM_THREADS;
+  }
+
+  // If the size of the pool has changed, free the old pool. A new
+  // pool is created on the next call to factor().
+  if (pool && pool->getNumThreads() != num_threads) {
+    pool->decref();
+    pool = NULL;
+  }
 }
 
 /*
@@ -1651,7 +1704,7 @@ void BCSCMatPivot::computeTopologicalOrder(int iteration, const int *rhs_rows,
 
         // Search through all the variables in the current column
         // below the diagonal
-        for (; jp < lu_col_ptr[node + 1]; jp++) {
+        for (; jp < lu_col_end[node]; jp++) {
           int row = lu_rows[jp];
           int next_node = var_to_node[row];
 
@@ -1673,7 +1726,7 @@ void BCSCMatPivot::computeTopologicalOrder(int iteration, const int *rhs_rows,
         }
 
         // We've exhausted all possible nodes in the list
-        if (jp == lu_col_ptr[node + 1]) {
+        if (jp == lu_col_end[node]) {
           // Label the node as done, and update the vertex ordering
           node_labels[node] = vertex_label_done;
           topo_order[num_nodes] = node;
@@ -1741,7 +1794,7 @@ void BCSCMatPivot::computeColNzPattern(int iteration, const int *rhs_rows,
     int node = update_nodes[i];
 
     // Scan through the node's column of updating rows
-    for (int jp = lu_diag_ptr[node]; jp < lu_col_ptr[node + 1]; jp++) {
+    for (int jp = lu_diag_ptr[node]; jp < lu_col_end[node]; jp++) {
       int row = lu_rows[jp];
       int node = var_to_node[row];
 
@@ -1848,7 +1901,7 @@ void BCSCMatPivot::applyNodeUpdate(int node, int node_dim, TacsScalar *spa,
   // Compute the product of temp_block with the column L.  This stores
   // the array in the temporary vector, then applies the updates to the
   // rows in f
-  int j_end = lu_col_ptr[node + 1];
+  int j_end = lu_col_end[node];
   for (int j = lu_diag_ptr[node] + node_dim; j < j_end; j += max_col_size) {
     // Compute the size of the updating block
     int col_size = max_col_size;
@@ -2014,8 +2067,10 @@ void BCSCMatPivot::factorNode(int node, TacsScalar *col, int node_dim,
                               int *rows, int num_rows, int diag_index) {
   int init_diag_index = diag_index;
 
-  // Update the data structure for this newly constructed node
-  node_to_vars_ptr[node + 1] = node_to_vars_ptr[node];
+  // The location of the first pivot variable for this node. Since
+  // each block column eliminates exactly its dimension of pivots,
+  // node_to_vars_ptr is set before the factorization begins.
+  int node_var_base = node_to_vars_ptr[node];
 
   for (int j = 0; j < node_dim; diag_index++, j++) {
     // Apply the update from the previous rows
@@ -2094,11 +2149,10 @@ void BCSCMatPivot::factorNode(int node, TacsScalar *col, int node_dim,
     }
 
     // Record the pivot sequence
-    perm[pivot] = node_to_vars_ptr[node + 1];
+    perm[pivot] = node_var_base + j;
 
     // Record the node->variables array
-    node_to_vars[node_to_vars_ptr[node + 1]] = pivot;
-    node_to_vars_ptr[node + 1]++;
+    node_to_vars[node_var_base + j] = pivot;
 
     // Record the var->node information
     var_to_node[pivot] = node;
@@ -2174,8 +2228,13 @@ double BCSCMatPivot::factor(double _fill) {
     var_to_node[i] = -1;
   }
 
-  // Initialize the node -> var data structure
-  memset(node_to_vars_ptr, 0, (nblock_cols + 1) * sizeof(int));
+  // Initialize the node -> var data structure. Each block column
+  // eliminates exactly its dimension of pivot variables, so the
+  // pointer array can be set before the factorization.
+  node_to_vars_ptr[0] = 0;
+  for (int i = 0; i < nblock_cols; i++) {
+    node_to_vars_ptr[i + 1] = node_to_vars_ptr[i] + (bptr[i + 1] - bptr[i]);
+  }
   for (int i = 0; i < ncols; i++) {
     node_to_vars[i] = -1;
   }
@@ -2203,6 +2262,11 @@ double BCSCMatPivot::factor(double _fill) {
   memset(node_labels, 0, nblock_cols * sizeof(int));
   memset(var_labels, 0, nrows * sizeof(int));
 
+  // Use the level-scheduled threaded factorization if requested
+  if (num_threads > 1) {
+    return factorThreaded(A, mat_aptr, mat_colp, mat_rows);
+  }
+
   // Set the initial positions within the array
   lu_aptr[0] = 0;
   lu_col_ptr[0] = 0;
@@ -2289,6 +2353,7 @@ double BCSCMatPivot::factor(double _fill) {
     // accumulator and set the non-zero pattern in the LU data
     // Keep track of the element of the matrix added last
     lu_col_ptr[node + 1] = lu_col_ptr[node] + nnz_rows;
+    lu_col_end[node] = lu_col_ptr[node + 1];
 
     // Update the pointer to the next column
     lu_aptr[node + 1] = lu_aptr[node] + node_dim * nnz_rows;
@@ -2348,6 +2413,504 @@ double BCSCMatPivot::factor(double _fill) {
   return (1.0 * lu_col_ptr[nblock_cols]) / mat_colp[nblock_cols];
 }
 
+/*
+  Compute the column elimination tree of the matrix and group its
+  nodes into level sets.
+
+  The column elimination tree is the elimination tree of A^{T}*A,
+  computed here at the block column level without forming the product.
+  For an LU factorization with partial pivoting, the tree bounds the
+  column dependencies of the factorization: block column j can only
+  receive updates from its descendants in the tree, regardless of the
+  pivot sequence. Block columns within a level of the tree lie on
+  disjoint subtrees and therefore have structurally disjoint factor
+  patterns and pivot rows, so they can be factored concurrently
+  without synchronization.
+
+  input:
+  mat_colp:  pointer into the row indices for each block column
+  mat_rows:  the non-zero row indices of the matrix
+*/
+void BCSCMatPivot::computeColumnEtree(const int *mat_colp,
+                                      const int *mat_rows) {
+  etree_parent = new int[nblock_cols];
+  etree_list = new int[nblock_cols];
+  etree_level_ptr = new int[nblock_cols + 1];
+
+  // The root of the partially-assembled subtree containing each node.
+  // This is maintained with path compression so that repeated root
+  // look-ups take nearly constant time.
+  int *root = new int[nblock_cols];
+
+  // The most recent block column visited that contains each row
+  int *prev_col = new int[nrows];
+  for (int i = 0; i < nrows; i++) {
+    prev_col[i] = -1;
+  }
+
+  for (int j = 0; j < nblock_cols; j++) {
+    etree_parent[j] = -1;
+    root[j] = j;
+
+    for (int ip = mat_colp[j]; ip < mat_colp[j + 1]; ip++) {
+      int row = mat_rows[ip];
+
+      // Row 'row' creates a non-zero in column j of A^{T}*A for every
+      // previous column containing the row. Only the most recent such
+      // column is needed since the others are already in its subtree.
+      int k = prev_col[row];
+      prev_col[row] = j;
+
+      if (k >= 0) {
+        // Find the root of the subtree containing column k
+        int r = k;
+        while (root[r] != r) {
+          r = root[r];
+        }
+
+        // Compress the path from k up to the root
+        while (root[k] != r) {
+          int next = root[k];
+          root[k] = r;
+          k = next;
+        }
+
+        // Attach the subtree to column j
+        if (r != j) {
+          etree_parent[r] = j;
+          root[r] = j;
+        }
+      }
+    }
+  }
+
+  // Compute the level of each node: leaves are level 0 and each
+  // parent lies one level above its deepest child. Parents always
+  // have a higher index than their children, so a single ascending
+  // pass suffices. The root array is re-used for the levels.
+  int *level = root;
+  for (int j = 0; j < nblock_cols; j++) {
+    level[j] = 0;
+  }
+
+  num_etree_levels = 0;
+  for (int j = 0; j < nblock_cols; j++) {
+    int parent = etree_parent[j];
+    if (parent >= 0 && level[j] + 1 > level[parent]) {
+      level[parent] = level[j] + 1;
+    }
+    if (level[j] + 1 > num_etree_levels) {
+      num_etree_levels = level[j] + 1;
+    }
+  }
+
+  // Bucket the nodes level-by-level using a counting sort. The nodes
+  // within each level remain in ascending order.
+  for (int i = 0; i <= num_etree_levels; i++) {
+    etree_level_ptr[i] = 0;
+  }
+  for (int j = 0; j < nblock_cols; j++) {
+    etree_level_ptr[level[j] + 1]++;
+  }
+  for (int i = 0; i < num_etree_levels; i++) {
+    etree_level_ptr[i + 1] += etree_level_ptr[i];
+  }
+  for (int j = 0; j < nblock_cols; j++) {
+    etree_list[etree_level_ptr[level[j]]] = j;
+    etree_level_ptr[level[j]]++;
+  }
+
+  // Restore the level pointer
+  for (int i = num_etree_levels; i > 0; i--) {
+    etree_level_ptr[i] = etree_level_ptr[i - 1];
+  }
+  etree_level_ptr[0] = 0;
+
+  delete[] root;
+  delete[] prev_col;
+}
+
+/*
+  The phases of the threaded factorization and the information shared
+  between the worker threads. The worker threads draw block columns
+  from the current level of the column elimination tree through the
+  work-stealing schedule of the thread pool.
+*/
+static const int BCSC_PHASE_SYMBOLIC = 1;
+static const int BCSC_PHASE_NUMERIC = 2;
+
+class BCSCMatPivotThreadInfo {
+ public:
+  BCSCMatPivot *self;  // The matrix being factored
+  int phase;           // The phase to execute
+
+  // The arrays from the input matrix
+  TacsScalar *A;
+  const int *mat_aptr;
+  const int *mat_colp;
+  const int *mat_rows;
+
+  // The symbolic pattern computed for each block column: the update
+  // nodes in topological post-order followed by the new variables
+  int **patterns;
+  int *pattern_num_nodes;  // The number of update nodes per pattern
+  int *pattern_num_vars;   // The number of new variables per pattern
+
+  // The block columns in the current level
+  const int *level_nodes;
+
+  // Flag set if a thread fails to allocate memory
+  int alloc_fail;
+};
+
+/*
+  Factor the matrix using the level-scheduled threaded code.
+
+  The block columns are processed level-by-level over the column
+  elimination tree. Since the columns within a level have structurally
+  disjoint factor patterns, each level is processed in three steps:
+
+  1. The symbolic patterns of all of the columns in the level are
+  computed in parallel. The depth-first searches from columns on
+  disjoint subtrees visit disjoint nodes and rows, so the threads can
+  share the label arrays without locking.
+
+  2. The storage for the new columns is assigned serially, growing the
+  LU/lu_rows arrays if the fill estimate is exceeded. Since the
+  columns of a level are not contiguous, the column extents are
+  recorded in lu_col_end rather than being inferred from lu_col_ptr.
+
+  3. The numerical updates, extraction and panel factorization of the
+  columns are performed in parallel. All of the updating columns lie
+  at lower levels of the tree and are complete, and the pivot rows
+  selected by columns within the level cannot conflict.
+
+  Each block column performs exactly the same operations in the same
+  order as the serial code, so the threaded factorization produces an
+  identical result.
+
+  input:
+  A:         the numerical values of the input matrix
+  mat_aptr:  pointer into A for each block column
+  mat_colp:  pointer into the row indices for each block column
+  mat_rows:  the non-zero row indices of the matrix
+
+  returns: the actual fill from the factored matrix, or -1.0 on failure
+*/
+double BCSCMatPivot::factorThreaded(TacsScalar *A, const int *mat_aptr,
+                                    const int *mat_colp, const int *mat_rows) {
+  // Compute the column elimination tree on the first threaded
+  // factorization. The non-zero pattern of the matrix is fixed, so
+  // the tree is re-used on subsequent factorizations.
+  if (!etree_parent) {
+    computeColumnEtree(mat_colp, mat_rows);
+  }
+
+  // Create the persistent pool of worker threads
+  if (!pool) {
+    pool = new TACSThreadPool(num_threads);
+    pool->incref();
+  }
+
+  // The current capacities of the LU/lu_rows arrays
+  int max_lu_size = fill * mat_aptr[nblock_cols];
+  int max_lu_rows_size = fill * mat_colp[nblock_cols];
+
+  // Allocate the symbolic pattern storage for each block column
+  int **patterns = new int *[nblock_cols];
+  int *pattern_num_nodes = new int[nblock_cols];
+  int *pattern_num_vars = new int[nblock_cols];
+  memset(patterns, 0, nblock_cols * sizeof(int *));
+
+  // Set the information shared between the worker threads
+  BCSCMatPivotThreadInfo info;
+  info.self = this;
+  info.A = A;
+  info.mat_aptr = mat_aptr;
+  info.mat_colp = mat_colp;
+  info.mat_rows = mat_rows;
+  info.patterns = patterns;
+  info.pattern_num_nodes = pattern_num_nodes;
+  info.pattern_num_vars = pattern_num_vars;
+  info.alloc_fail = 0;
+
+  // The running totals of the storage assigned so far
+  int lu_top = 0;
+  int lu_rows_top = 0;
+
+  for (int lev = 0; lev < num_etree_levels; lev++) {
+    int level_size = etree_level_ptr[lev + 1] - etree_level_ptr[lev];
+    info.level_nodes = &etree_list[etree_level_ptr[lev]];
+
+    // Compute the symbolic patterns of the columns in this level
+    info.phase = BCSC_PHASE_SYMBOLIC;
+    pool->initSchedule(level_size);
+    pool->run(factor_thread, &info);
+
+    // Assign the storage locations for the new columns
+    for (int ii = 0; ii < level_size && !info.alloc_fail; ii++) {
+      int node = info.level_nodes[ii];
+      int node_dim = bptr[node + 1] - bptr[node];
+
+      // Compute the space required for the non-zero pattern
+      int nnz_rows = pattern_num_vars[node];
+      const int *pat = patterns[node];
+      for (int i = 0; i < pattern_num_nodes[node]; i++) {
+        int update = pat[i];
+        nnz_rows += node_to_vars_ptr[update + 1] - node_to_vars_ptr[update];
+      }
+
+      // Check if this new column will exceed the available space
+      if (node_dim * nnz_rows + lu_top > max_lu_size) {
+        max_lu_size = node_dim * nnz_rows + 2 * max_lu_size;
+
+        // Allocate a new LU array and free the old one
+        TacsScalar *old_LU = LU;
+        LU = new (std::nothrow) TacsScalar[max_lu_size];
+        if (LU) {
+          memcpy(LU, old_LU, lu_top * sizeof(TacsScalar));
+        }
+        delete[] old_LU;
+
+        if (!LU) {
+          info.alloc_fail = 1;
+          break;
+        }
+      }
+
+      // Check if this new column will exceed the available row space
+      if (nnz_rows + lu_rows_top > max_lu_rows_size) {
+        max_lu_rows_size = nnz_rows + 2 * max_lu_rows_size;
+
+        // Allocate a new lu_rows array and free the old one
+        int *old_rows = lu_rows;
+        lu_rows = new (std::nothrow) int[max_lu_rows_size];
+        if (lu_rows) {
+          memcpy(lu_rows, old_rows, lu_rows_top * sizeof(int));
+        }
+        delete[] old_rows;
+
+        if (!lu_rows) {
+          info.alloc_fail = 1;
+          break;
+        }
+      }
+
+      // Assign the storage for the column
+      lu_aptr[node] = lu_top;
+      lu_col_ptr[node] = lu_rows_top;
+      lu_col_end[node] = lu_rows_top + nnz_rows;
+      lu_top += node_dim * nnz_rows;
+      lu_rows_top += nnz_rows;
+    }
+
+    if (info.alloc_fail) {
+      break;
+    }
+
+    // Apply the updates and factor the new columns
+    info.phase = BCSC_PHASE_NUMERIC;
+    pool->initSchedule(level_size);
+    pool->run(factor_thread, &info);
+
+    if (info.alloc_fail) {
+      break;
+    }
+  }
+
+  // Free the symbolic pattern storage
+  for (int i = 0; i < nblock_cols; i++) {
+    if (patterns[i]) {
+      delete[] patterns[i];
+    }
+  }
+  delete[] patterns;
+  delete[] pattern_num_nodes;
+  delete[] pattern_num_vars;
+
+  if (info.alloc_fail) {
+    return -1.0;
+  }
+
+  // Record the total size of the factorization
+  lu_aptr[nblock_cols] = lu_top;
+  lu_col_ptr[nblock_cols] = lu_rows_top;
+
+  return (1.0 * lu_rows_top) / mat_colp[nblock_cols];
+}
+
+/*
+  The work function executed by the worker threads during the
+  threaded factorization. Depending on the phase, the threads either
+  compute the symbolic patterns or perform the numerical
+  factorization of the block columns in the current level.
+*/
+void *BCSCMatPivot::factor_thread(void *t) {
+  BCSCMatPivotThreadInfo *info = static_cast<BCSCMatPivotThreadInfo *>(t);
+  BCSCMatPivot *self = info->self;
+  TACSThreadPool *pool = self->pool;
+
+  const int *bptr = self->bptr;
+  const int *mat_colp = info->mat_colp;
+  const int *mat_rows = info->mat_rows;
+
+  if (info->phase == BCSC_PHASE_SYMBOLIC) {
+    // Allocate the thread-local stack and ordering space
+    int *node_stack = new (std::nothrow) int[2 * self->nblock_cols];
+    int *topo_order = new (std::nothrow) int[self->nrows];
+    if (!node_stack || !topo_order) {
+      info->alloc_fail = 1;
+      delete[] node_stack;
+      delete[] topo_order;
+      return NULL;
+    }
+
+    // The label arrays are shared between the threads: the searches
+    // from columns within a level visit disjoint nodes and rows
+    int *node_labels = &self->temp_iarray[2 * self->nblock_cols + self->nrows];
+    int *var_labels = &self->temp_iarray[3 * self->nblock_cols + self->nrows];
+
+    const int threadId = pool->acquireThread();
+    int begin, end;
+    while (pool->getNextRange(threadId, &begin, &end)) {
+      for (int ii = begin; ii < end; ii++) {
+        int node = info->level_nodes[ii];
+        int col_size = mat_colp[node + 1] - mat_colp[node];
+
+        // Compute the topological post-order of the update nodes
+        int num_nodes = 0;
+        self->computeTopologicalOrder(node, &mat_rows[mat_colp[node]],
+                                      col_size, topo_order, &num_nodes,
+                                      node_stack, node_labels);
+
+        // Compute the non-zero pattern of the new variables
+        int num_vars = 0;
+        self->computeColNzPattern(node, &mat_rows[mat_colp[node]], col_size,
+                                  topo_order, num_nodes, var_labels,
+                                  &topo_order[num_nodes], &num_vars);
+
+        // Store the pattern for the storage assignment/numeric phases
+        int *pat = new (std::nothrow) int[num_nodes + num_vars];
+        if (pat) {
+          memcpy(pat, topo_order, (num_nodes + num_vars) * sizeof(int));
+        } else {
+          info->alloc_fail = 1;
+        }
+        info->patterns[node] = pat;
+        info->pattern_num_nodes[node] = num_nodes;
+        info->pattern_num_vars[node] = num_vars;
+      }
+    }
+
+    delete[] node_stack;
+    delete[] topo_order;
+  } else {
+    // Allocate the thread-local sparse accumulator and scratch space
+    int max_block_size = self->max_block_size;
+    TacsScalar *column =
+        new (std::nothrow) TacsScalar[self->nrows * max_block_size];
+    TacsScalar *temp = new (std::nothrow)
+        TacsScalar[max_block_size * max_block_size + self->temp_array_size];
+    if (!column || !temp) {
+      info->alloc_fail = 1;
+      delete[] column;
+      delete[] temp;
+      return NULL;
+    }
+    memset(column, 0, self->nrows * max_block_size * sizeof(TacsScalar));
+
+    TacsScalar *temp_block = &temp[0];
+    TacsScalar *temp_cols = &temp[max_block_size * max_block_size];
+
+    const int threadId = pool->acquireThread();
+    int begin, end;
+    while (pool->getNextRange(threadId, &begin, &end)) {
+      for (int ii = begin; ii < end; ii++) {
+        int node = info->level_nodes[ii];
+        int node_dim = bptr[node + 1] - bptr[node];
+
+        // Copy the values from the input matrix to the accumulator
+        const TacsScalar *a = &info->A[info->mat_aptr[node]];
+        for (int ip = mat_colp[node]; ip < mat_colp[node + 1];
+             ip++, a += node_dim) {
+          memcpy(&column[node_dim * mat_rows[ip]], a,
+                 node_dim * sizeof(TacsScalar));
+        }
+
+        // Retrieve the symbolic pattern of the column
+        int num_nodes = info->pattern_num_nodes[node];
+        int num_vars = info->pattern_num_vars[node];
+        int *pat = info->patterns[node];
+
+        // Apply the numerical updates to the spa array
+        for (int i = num_nodes - 1; i >= 0; i--) {
+          int update = pat[i];
+          int cdim = bptr[update + 1] - bptr[update];
+          self->applyNodeUpdate(update, cdim, column, node_dim, temp_block,
+                                node_dim * node_dim, temp_cols,
+                                self->temp_array_size);
+        }
+
+        // Extract the matrix values from the temporary sparse
+        // accumulator into the assigned storage locations
+        TacsScalar *lu = &self->LU[self->lu_aptr[node]];
+        int *lu_row = &self->lu_rows[self->lu_col_ptr[node]];
+
+        // Scan through all the new data in topological order
+        for (int i = num_nodes - 1; i >= 0; i--) {
+          int update = pat[i];
+          for (int k = self->node_to_vars_ptr[update];
+               k < self->node_to_vars_ptr[update + 1]; k++) {
+            int row = self->node_to_vars[k];
+
+            // Copy the data from the row and zero the accumulator
+            memcpy(lu, &column[node_dim * row],
+                   node_dim * sizeof(TacsScalar));
+            lu += node_dim;
+            memset(&column[node_dim * row], 0, node_dim * sizeof(TacsScalar));
+
+            // Set the row index
+            lu_row[0] = row;
+            lu_row++;
+          }
+        }
+
+        // Set the pointer to the diagonal entry of the LU factorization
+        self->lu_diag_ptr[node] = lu_row - self->lu_rows;
+
+        for (int i = num_nodes; i < num_vars + num_nodes; i++) {
+          int row = pat[i];
+
+          // Copy the data from the row and zero the accumulator
+          memcpy(lu, &column[node_dim * row], node_dim * sizeof(TacsScalar));
+          lu += node_dim;
+          memset(&column[node_dim * row], 0, node_dim * sizeof(TacsScalar));
+
+          // Set the row index and increment the pointer
+          lu_row[0] = row;
+          lu_row++;
+        }
+
+        // Apply the factorization to the column
+        int col_ptr = self->lu_col_ptr[node];
+        int num_rows = self->lu_col_end[node] - col_ptr;
+        int diag_index = self->lu_diag_ptr[node] - col_ptr;
+        self->factorNode(node, &self->LU[self->lu_aptr[node]], node_dim,
+                         &self->lu_rows[col_ptr], num_rows, diag_index);
+
+        // The pattern is no longer required
+        delete[] pat;
+        info->patterns[node] = NULL;
+      }
+    }
+
+    delete[] column;
+    delete[] temp;
+  }
+
+  return NULL;
+}
+
 /*
   Apply the pivot sequence and the lower/upper factorization to the
   input vector to obtain X <- U^{-1}*L^{-1}*P*X.
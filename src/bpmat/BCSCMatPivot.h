@@ -21,6 +21,7 @@
 */
 
 #include "TACSObject.h"
+#include "TACSThreadPool.h"
 
 /*
   A block-CSC matrix for general purpose storage. Note that this
@@ -184,10 +185,22 @@ class BCSCMatPivot : public TACSObject {
   // Factor the matrix and store the result
   double factor(double _fill = -1.0);
 
+  // Set the number of threads to use during the factorization
+  void setNumThreads(int _num_threads);
+
   // Apply the factorization to a right-hand-side vector
   void applyFactor(TacsScalar *X, int vec_bsize);
 
  private:
+  // Compute the column elimination tree and its level sets
+  void computeColumnEtree(const int *mat_colp, const int *mat_rows);
+
+  // Factor the matrix using the level-scheduled threaded code
+  double factorThreaded(TacsScalar *A, const int *mat_aptr,
+                        const int *mat_colp, const int *mat_rows);
+
+  // The work function executed by the worker threads
+  static void *factor_thread(void *t);
   // Apply the lower portion of the factorization
   void applyLower(TacsScalar *B, int vec_bsize, TacsScalar *temp,
                   int temp_size);
@@ -234,6 +247,19 @@ class BCSCMatPivot : public TACSObject {
   // The expected fill-in in the matrix
   double fill;
 
+  // Data for the threaded factorization
+  int num_threads;       // The number of threads to use
+  TACSThreadPool *pool;  // The persistent worker pool
+
+  // The column elimination tree of the matrix computed at the block
+  // column level. The tree bounds the column dependencies of the
+  // factorization with partial pivoting: a block column can only
+  // receive updates from its descendants in the tree.
+  int *etree_parent;     // The parent of each node (or -1 for a root)
+  int *etree_list;       // The nodes ordered level-by-level
+  int *etree_level_ptr;  // Pointer to the start of each level
+  int num_etree_levels;  // The number of levels in the tree
+
   // Buffer size info
   int temp_array_size;
   TacsScalar *temp_array;
@@ -272,6 +298,7 @@ class BCSCMatPivot : public TACSObject {
   int *lu_aptr;      // Pointer into the numerical columns stored in A
   int *lu_diag_ptr;  // Pointer to the diagonal of the matrix
   int *lu_col_ptr;   // Pointer to the indices of each column
+  int *lu_col_end;   // Pointer past the last index of each column
 };
 
 #endif  // TACS_BCSC_MAT_PIVOT_H
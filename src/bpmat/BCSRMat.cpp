@@ -18,9 +18,13 @@
 
 #include "BCSRMat.h"
 
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "BCSRMatImpl.h"
+#include "BCSRMatKernelSelect.h"
+#include "TACSProfiler.h"
 #include "TacsUtilities.h"
 #include "tacslapack.h"
 
@@ -28,6 +32,66 @@
   BCSR matrix implementation
 */
 
+/*
+  The slice of the block storage zeroed by one first-touch thread
+*/
+typedef struct {
+  TacsScalar *array;
+  size_t begin, end;
+} BCSRMatZeroSlice;
+
+static void *bcsr_first_touch_thread(void *ptr) {
+  BCSRMatZeroSlice *slice = static_cast<BCSRMatZeroSlice *>(ptr);
+  memset(&slice->array[slice->begin], 0,
+         (slice->end - slice->begin) * sizeof(TacsScalar));
+  return NULL;
+}
+
+/*!
+  Allocate and zero the block storage for the matrix.
+
+  When threading is enabled, the storage is zeroed in parallel with
+  one contiguous range of block rows per thread. Since the operating
+  system assigns each page to the memory node of the thread that
+  touches it first, this distributes the matrix pages across the
+  memory nodes of a multi-socket machine instead of leaving them all
+  on the node of the allocating core, which is what a serial memset
+  after the allocation would do. The threaded matrix-vector products
+  stream the same rows in the same order, so the bulk of their
+  traffic stays on the local memory node.
+
+  input:
+  length:  the total number of scalar entries in the block storage
+*/
+void BCSRMat::initBlockStorage(int length) {
+  data->A = new TacsScalar[length];
+  TacsRegisterAllocation(length * sizeof(TacsScalar));
+  TacsAddAllocs(1);
+
+  int nthreads = thread_info->getNumThreads();
+  if (nthreads > 1 && data->nrows > 0) {
+    pthread_t threads[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+    BCSRMatZeroSlice slices[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+
+    // Split the storage at block-row boundaries so that the pages of
+    // each row range are touched by the thread that owns the range
+    const size_t b2 = data->bsize * data->bsize;
+    for (int k = 0; k < nthreads; k++) {
+      int first_row = (k * data->nrows) / nthreads;
+      int last_row = ((k + 1) * data->nrows) / nthreads;
+      slices[k].array = data->A;
+      slices[k].begin = b2 * data->rowp[first_row];
+      slices[k].end = b2 * data->rowp[last_row];
+      pthread_create(&threads[k], NULL, bcsr_first_touch_thread, &slices[k]);
+    }
+    for (int k = 0; k < nthreads; k++) {
+      pthread_join(threads[k], NULL);
+    }
+  } else {
+    memset(data->A, 0, length * sizeof(TacsScalar));
+  }
+}
+
 /*
   Merge two uniquely sorted arrays with levels associated with them.
 
@@ -142,6 +206,17 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *mat, int levFill, double fill,
   thread_info->incref();
   tdata = NULL;
   Adiag = NULL;
+  use_single_factor = 0;
+  single_nnz = 0;
+  Asp = NULL;
+  xsp = NULL;
+  symm_storage = 0;
+  complex_lanes = 0;
+  morton_layout = 0;
+  use_transpose = 0;
+  trans_valid = 0;
+  trans_perm = NULL;
+  trans_data = NULL;
 
   if (fill < 1.0) {
     fprintf(stderr, "BCSRMat(): fill must be greater than 1.0\n");
@@ -156,12 +231,43 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *mat, int levFill, double fill,
   int *levs;
   computeILUk(mat, levFill, fill, &levs);
 
+  // If a per-process memory budget is set, project the size of the
+  // factor storage from the symbolic count and reduce the level of
+  // fill until the projection fits within the remaining budget
+  size_t budget = TacsGetMemoryBudget();
+  while (budget > 0 && levFill > 0) {
+    size_t nnz = data->rowp[data->nrows];
+    size_t b2 = data->bsize * data->bsize;
+    size_t bytes = b2 * nnz * sizeof(TacsScalar) +
+                   (nnz + 2 * data->nrows + 1) * sizeof(int);
+    if (TacsGetRegisteredMemory() + bytes <= budget) {
+      break;
+    }
+
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    int new_fill = levFill / 2;
+    fprintf(stderr,
+            "[%d] BCSRMat: ILU(%d) factor projected to exceed the "
+            "memory budget, reducing to ILU(%d)\n",
+            rank, levFill, new_fill);
+    levFill = new_fill;
+
+    // Discard the symbolic factorization and recompute it with the
+    // reduced level of fill
+    delete[] levs;
+    delete[] data->rowp;
+    delete[] data->cols;
+    delete[] data->diag;
+    data->rowp = data->cols = data->diag = NULL;
+    computeILUk(mat, levFill, fill, &levs);
+  }
+
   int length = data->rowp[data->nrows];
   int bsize = data->bsize;
   length *= bsize * bsize;
 
-  data->A = new TacsScalar[length];
-  memset(data->A, 0, length * sizeof(TacsScalar));
+  initBlockStorage(length);
 
   // Go through and print out the nz-pattern of the matrix
   if (fname) {
@@ -215,6 +321,17 @@ BCSRMat::BCSRMat(MPI_Comm _comm, TACSThreadInfo *_thread_info, int bsize,
   thread_info->incref();
   tdata = NULL;
   Adiag = NULL;
+  use_single_factor = 0;
+  single_nnz = 0;
+  Asp = NULL;
+  xsp = NULL;
+  symm_storage = 0;
+  complex_lanes = 0;
+  morton_layout = 0;
+  use_transpose = 0;
+  trans_valid = 0;
+  trans_perm = NULL;
+  trans_data = NULL;
 
   data = new BCSRMatData(bsize, nrows, ncols);
   data->incref();
@@ -229,11 +346,12 @@ BCSRMat::BCSRMat(MPI_Comm _comm, TACSThreadInfo *_thread_info, int bsize,
   if (_A) {
     data->A = *_A;
     *_A = NULL;
+    TacsRegisterAllocation(bsize * bsize * (size_t)data->rowp[nrows] *
+                           sizeof(TacsScalar));
   } else {
     // Find the size of the array
     int length = bsize * bsize * data->rowp[nrows];
-    data->A = new TacsScalar[length];
-    memset(data->A, 0, length * sizeof(TacsScalar));
+    initBlockStorage(length);
   }
 }
 
@@ -261,6 +379,17 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *Bmat, BCSRMat *Emat, BCSRMat *Fmat,
   thread_info->incref();
   tdata = NULL;
   Adiag = NULL;
+  use_single_factor = 0;
+  single_nnz = 0;
+  Asp = NULL;
+  xsp = NULL;
+  symm_storage = 0;
+  complex_lanes = 0;
+  morton_layout = 0;
+  use_transpose = 0;
+  trans_valid = 0;
+  trans_perm = NULL;
+  trans_data = NULL;
 
   // Check that the dimensions of the matrices match
   if (Bmat->data->nrows != Emat->data->nrows ||
@@ -299,8 +428,7 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *Bmat, BCSRMat *Emat, BCSRMat *Fmat,
   int bsize = data->bsize;
   int length = data->rowp[data->nrows];
   length *= bsize * bsize;
-  data->A = new TacsScalar[length];
-  memset(data->A, 0, length * sizeof(TacsScalar));
+  initBlockStorage(length);
 }
 
 /*!
@@ -323,6 +451,17 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *smat, int *alevs, BCSRMat *amat,
   thread_info->incref();
   tdata = NULL;
   Adiag = NULL;
+  use_single_factor = 0;
+  single_nnz = 0;
+  Asp = NULL;
+  xsp = NULL;
+  symm_storage = 0;
+  complex_lanes = 0;
+  morton_layout = 0;
+  use_transpose = 0;
+  trans_valid = 0;
+  trans_perm = NULL;
+  trans_data = NULL;
 
   // Check that the block sizes are the same
   if (amat->data->bsize != bmat->data->bsize) {
@@ -450,8 +589,7 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *smat, int *alevs, BCSRMat *amat,
   int length = rowp[nrows];
   length *= bsize * bsize;
 
-  data->A = new TacsScalar[length];
-  memset(data->A, 0, length * sizeof(TacsScalar));
+  initBlockStorage(length);
 }
 
 /*
@@ -491,6 +629,17 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *B, double fill) {
   thread_info->incref();
   tdata = NULL;
   Adiag = NULL;
+  use_single_factor = 0;
+  single_nnz = 0;
+  Asp = NULL;
+  xsp = NULL;
+  symm_storage = 0;
+  complex_lanes = 0;
+  morton_layout = 0;
+  use_transpose = 0;
+  trans_valid = 0;
+  trans_perm = NULL;
+  trans_data = NULL;
 
   data = new BCSRMatData(B->data->bsize, B->data->ncols, B->data->ncols);
   data->incref();
@@ -580,8 +729,7 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *B, double fill) {
   int length = rowp[nrows];
   length *= bsize * bsize;
 
-  data->A = new TacsScalar[length];
-  memset(data->A, 0, length * sizeof(TacsScalar));
+  initBlockStorage(length);
 }
 
 BCSRMat::~BCSRMat() {
@@ -593,6 +741,18 @@ BCSRMat::~BCSRMat() {
   if (Adiag) {
     delete[] Adiag;
   }
+  if (Asp) {
+    delete[] Asp;
+  }
+  if (xsp) {
+    delete[] xsp;
+  }
+  if (trans_perm) {
+    delete[] trans_perm;
+  }
+  if (trans_data) {
+    trans_data->decref();
+  }
 }
 
 /*
@@ -999,6 +1159,7 @@ void BCSRMat::initGenericImpl() {
   applylower = BCSRMatApplyLower;
   applyupper = BCSRMatApplyUpper;
   bmult = BCSRMatVecMult;
+  bmultrhs = BCSRMatVecMultRHS;
   bmultadd = BCSRMatVecMultAdd;
   bmulttrans = BCSRMatVecMultTranspose;
   bmatmult = BCSRMatMatMultAdd;
@@ -1010,14 +1171,21 @@ void BCSRMat::initGenericImpl() {
   applyschur = BCSRMatApplyFactorSchur;
   applysor = BCSRMatApplySOR;
 
-  // No default threaded versions
-  bmultadd_thread = NULL;
+  // Generic threaded versions. The block-specific implementations
+  // replace these when an unrolled kernel is available.
+  bmultadd_thread = BCSRMatVecMultAdd_thread;
   bfactor_thread = NULL;
-  applylower_thread = NULL;
-  applyupper_thread = NULL;
+  applylower_thread = BCSRMatApplyLower_thread;
+  applyupper_thread = BCSRMatApplyUpper_thread;
   bmatmult_thread = NULL;
   bfactorlower_thread = NULL;
   bfactorupper_thread = NULL;
+
+  // No alternative kernel candidates by default
+  num_mult_kernels = 0;
+  num_apply_kernels = 0;
+  mult_kernels_selected = 0;
+  apply_kernels_selected = 0;
 }
 
 /*
@@ -1036,6 +1204,7 @@ void BCSRMat::initBlockImpl() {
       applylower = BCSRMatApplyLower1;
       applyupper = BCSRMatApplyUpper1;
       bmult = BCSRMatVecMult1;
+      bmultrhs = BCSRMatVecMultRHS1;
       bmultadd = BCSRMatVecMultAdd1;
       bmulttrans = BCSRMatVecMultTranspose1;
       bmatmult = BCSRMatMatMultAdd1;
@@ -1052,6 +1221,7 @@ void BCSRMat::initBlockImpl() {
       applylower = BCSRMatApplyLower2;
       applyupper = BCSRMatApplyUpper2;
       bmult = BCSRMatVecMult2;
+      bmultrhs = BCSRMatVecMultRHS2;
       bmultadd = BCSRMatVecMultAdd2;
       bmatmult = BCSRMatMatMultAdd2;
       bfactorlower = BCSRMatFactorLower2;
@@ -1066,7 +1236,9 @@ void BCSRMat::initBlockImpl() {
       applylower = BCSRMatApplyLower3;
       applyupper = BCSRMatApplyUpper3;
       bmult = BCSRMatVecMult3;
+      bmultrhs = BCSRMatVecMultRHS3;
       bmultadd = BCSRMatVecMultAdd3;
+      bmulttrans = BCSRMatVecMultTranspose3;
       bmatmult = BCSRMatMatMultAdd3;
       bfactorlower = BCSRMatFactorLower3;
       bfactorupper = BCSRMatFactorUpper3;
@@ -1080,6 +1252,7 @@ void BCSRMat::initBlockImpl() {
       applylower = BCSRMatApplyLower4;
       applyupper = BCSRMatApplyUpper4;
       bmult = BCSRMatVecMult4;
+      bmultrhs = BCSRMatVecMultRHS4;
       bmultadd = BCSRMatVecMultAdd4;
       bmatmult = BCSRMatMatMultAdd4;
       bfactorlower = BCSRMatFactorLower4;
@@ -1094,6 +1267,7 @@ void BCSRMat::initBlockImpl() {
       applylower = BCSRMatApplyLower5;
       applyupper = BCSRMatApplyUpper5;
       bmult = BCSRMatVecMult5;
+      bmultrhs = BCSRMatVecMultRHS5;
       bmultadd = BCSRMatVecMultAdd5;
       bmatmult = BCSRMatMatMultAdd5;
       bfactorlower = BCSRMatFactorLower5;
@@ -1113,7 +1287,9 @@ void BCSRMat::initBlockImpl() {
       applylower = BCSRMatApplyLower6;
       applyupper = BCSRMatApplyUpper6;
       bmult = BCSRMatVecMult6;
+      bmultrhs = BCSRMatVecMultRHS6;
       bmultadd = BCSRMatVecMultAdd6;
+      bmulttrans = BCSRMatVecMultTranspose6;
       bmatmult = BCSRMatMatMultAdd6;
       bfactorlower = BCSRMatFactorLower6;
       bfactorupper = BCSRMatFactorUpper6;
@@ -1130,6 +1306,38 @@ void BCSRMat::initBlockImpl() {
       bmatmult_thread = BCSRMatMatMultAdd6_thread;
       bfactorlower_thread = BCSRMatFactorLower6_thread;
       bfactorupper_thread = BCSRMatFactorUpper6_thread;
+
+#ifdef TACS_BCSR_SIMD
+      // Register the kernel candidates available on this processor.
+      // The winner is selected by a short microbenchmark on the
+      // matrix at first use of each operation.
+      if (BCSRMatGetSimdLevel() >= 1) {
+        mult_kernels[0] = BCSRMatVecMult6;
+        multadd_kernels[0] = BCSRMatVecMultAdd6;
+        applylower_kernels[0] = BCSRMatApplyLower6;
+        applyupper_kernels[0] = BCSRMatApplyUpper6;
+        mult_kernels[1] = BCSRMatVecMult6Avx2;
+        multadd_kernels[1] = BCSRMatVecMultAdd6Avx2;
+        applylower_kernels[1] = BCSRMatApplyLower6Avx2;
+        applyupper_kernels[1] = BCSRMatApplyUpper6Avx2;
+        num_mult_kernels = num_apply_kernels = 2;
+        bmatmult = BCSRMatMatMultAdd6Avx2;
+        if (BCSRMatGetSimdLevel() >= 2) {
+          mult_kernels[2] = BCSRMatVecMult6Avx512;
+          multadd_kernels[2] = BCSRMatVecMultAdd6Avx512;
+          applylower_kernels[2] = BCSRMatApplyLower6Avx512;
+          applyupper_kernels[2] = BCSRMatApplyUpper6Avx512;
+          num_mult_kernels = num_apply_kernels = 3;
+          bmatmult = BCSRMatMatMultAdd6Avx512;
+        }
+
+        // Use the widest SIMD kernels until the selection runs
+        bmult = mult_kernels[num_mult_kernels - 1];
+        bmultadd = multadd_kernels[num_mult_kernels - 1];
+        applylower = applylower_kernels[num_apply_kernels - 1];
+        applyupper = applyupper_kernels[num_apply_kernels - 1];
+      }
+#endif  // TACS_BCSR_SIMD
       break;
     case 8:
       // These are tuning parameters
@@ -1141,7 +1349,9 @@ void BCSRMat::initBlockImpl() {
       applylower = BCSRMatApplyLower8;
       applyupper = BCSRMatApplyUpper8;
       bmult = BCSRMatVecMult8;
+      bmultrhs = BCSRMatVecMultRHS8;
       bmultadd = BCSRMatVecMultAdd8;
+      bmulttrans = BCSRMatVecMultTranspose8;
       bmatmult = BCSRMatMatMultAdd8;
       bfactorlower = BCSRMatFactorLower8;
       bfactorupper = BCSRMatFactorUpper8;
@@ -1158,6 +1368,68 @@ void BCSRMat::initBlockImpl() {
       bmatmult_thread = BCSRMatMatMultAdd8_thread;
       bfactorlower_thread = BCSRMatFactorLower8_thread;
       bfactorupper_thread = BCSRMatFactorUpper8_thread;
+
+#ifdef TACS_BCSR_SIMD
+      // Register the kernel candidates available on this processor.
+      // The winner is selected by a short microbenchmark on the
+      // matrix at first use of each operation.
+      if (BCSRMatGetSimdLevel() >= 1) {
+        mult_kernels[0] = BCSRMatVecMult8;
+        multadd_kernels[0] = BCSRMatVecMultAdd8;
+        applylower_kernels[0] = BCSRMatApplyLower8;
+        applyupper_kernels[0] = BCSRMatApplyUpper8;
+        mult_kernels[1] = BCSRMatVecMult8Avx2;
+        multadd_kernels[1] = BCSRMatVecMultAdd8Avx2;
+        applylower_kernels[1] = BCSRMatApplyLower8Avx2;
+        applyupper_kernels[1] = BCSRMatApplyUpper8Avx2;
+        num_mult_kernels = num_apply_kernels = 2;
+        bmatmult = BCSRMatMatMultAdd8Avx2;
+        if (BCSRMatGetSimdLevel() >= 2) {
+          mult_kernels[2] = BCSRMatVecMult8Avx512;
+          multadd_kernels[2] = BCSRMatVecMultAdd8Avx512;
+          applylower_kernels[2] = BCSRMatApplyLower8Avx512;
+          applyupper_kernels[2] = BCSRMatApplyUpper8Avx512;
+          num_mult_kernels = num_apply_kernels = 3;
+          bmatmult = BCSRMatMatMultAdd8Avx512;
+        }
+
+        // Use the widest SIMD kernels until the selection runs
+        bmult = mult_kernels[num_mult_kernels - 1];
+        bmultadd = multadd_kernels[num_mult_kernels - 1];
+        applylower = applylower_kernels[num_apply_kernels - 1];
+        applyupper = applyupper_kernels[num_apply_kernels - 1];
+      }
+#endif  // TACS_BCSR_SIMD
+      break;
+    case 9:
+      bfactor = BCSRMatFactor9;
+      applylower = BCSRMatApplyLower9;
+      applyupper = BCSRMatApplyUpper9;
+      bmult = BCSRMatVecMult9;
+      bmultrhs = BCSRMatVecMultRHS9;
+      bmultadd = BCSRMatVecMultAdd9;
+      bmatmult = BCSRMatMatMultAdd9;
+      bfactorlower = BCSRMatFactorLower9;
+      bfactorupper = BCSRMatFactorUpper9;
+      applypartiallower = BCSRMatApplyPartialLower9;
+      applypartialupper = BCSRMatApplyPartialUpper9;
+      applyschur = BCSRMatApplyFactorSchur9;
+      applysor = BCSRMatApplySOR9;
+      break;
+    case 12:
+      bfactor = BCSRMatFactor12;
+      applylower = BCSRMatApplyLower12;
+      applyupper = BCSRMatApplyUpper12;
+      bmult = BCSRMatVecMult12;
+      bmultrhs = BCSRMatVecMultRHS12;
+      bmultadd = BCSRMatVecMultAdd12;
+      bmatmult = BCSRMatMatMultAdd12;
+      bfactorlower = BCSRMatFactorLower12;
+      bfactorupper = BCSRMatFactorUpper12;
+      applypartiallower = BCSRMatApplyPartialLower12;
+      applypartialupper = BCSRMatApplyPartialUpper12;
+      applyschur = BCSRMatApplyFactorSchur12;
+      applysor = BCSRMatApplySOR12;
       break;
     default:
       break;
@@ -1173,6 +1445,8 @@ void BCSRMat::initBlockImpl() {
   performed in place.
 */
 void BCSRMat::factor() {
+  TacsProfileScope profile("BCSRMat::factor");
+
   if (!data->diag) {
     setUpDiag();
   }
@@ -1204,12 +1478,811 @@ void BCSRMat::factor() {
   } else {
     bfactor(data);
   }
+
+  // Refresh the single-precision copy of the factorization
+  if (use_single_factor) {
+    copyFactorToSingle();
+  }
+}
+
+/*!
+  Factor the matrix using threshold-based ILUT dropping.
+
+  The values of the input matrix are factored row-by-row with dual
+  dropping: blocks whose norm falls below tol times the average block
+  norm of their row are discarded, and at most maxfill blocks are kept
+  on either side of the diagonal in each row. The non-zero pattern of
+  this matrix is replaced by the pattern that survives the dropping,
+  so the fill can be re-tuned between factorizations by simply calling
+  this function again with different parameters - there is no symbolic
+  structure to rebuild.
+
+  Note that this matrix holds the completed factorization on return -
+  do not call factor() afterwards.
+
+  input:
+  mat:         the matrix to factor - its values are left unchanged
+  tol:         the relative drop tolerance
+  maxfill:     the maximum number of blocks kept per row in L and in U
+  diag_shift:  value added to the scalar diagonal before factoring
+*/
+void BCSRMat::factorILUT(BCSRMat *mat, double tol, int maxfill,
+                         TacsScalar diag_shift) {
+  if (mat->data->nrows != data->nrows || mat->data->ncols != data->ncols ||
+      mat->data->bsize != data->bsize || data->nrows != data->ncols) {
+    fprintf(stderr,
+            "BCSRMat: Matrices are not the same size, "
+            "cannot perform ILUT factorization\n");
+    return;
+  }
+
+  int *rowp, *cols;
+  TacsScalar *A;
+  BCSRMatFactorILUT(mat->data, tol, maxfill, diag_shift, &rowp, &cols, &A);
+
+  // Replace the non-zero pattern and the values with the factorization
+  size_t b2 = data->bsize * data->bsize;
+  TacsReleaseAllocation(b2 * (size_t)data->rowp[data->nrows] *
+                        sizeof(TacsScalar));
+  delete[] data->rowp;
+  delete[] data->cols;
+  delete[] data->A;
+  data->rowp = rowp;
+  data->cols = cols;
+  data->A = A;
+  TacsRegisterAllocation(b2 * (size_t)data->rowp[data->nrows] *
+                         sizeof(TacsScalar));
+  setUpDiag();
+
+  // The threaded schedules depend on the non-zero pattern - free them
+  // so that they are recomputed on the next threaded operation
+  if (tdata) {
+    tdata->decref();
+    tdata = NULL;
+  }
+
+  // The explicit transpose also depends on the non-zero pattern
+  if (trans_data) {
+    trans_data->decref();
+    trans_data = NULL;
+    delete[] trans_perm;
+    trans_perm = NULL;
+    trans_valid = 0;
+  }
+
+  // Refresh the single-precision copy of the factorization
+  if (use_single_factor) {
+    copyFactorToSingle();
+  }
+}
+
+/*!
+  Enable or disable single-precision storage of the factorization.
+
+  When enabled, a single-precision copy of the factored matrix is
+  created after each call to factor() or factorILUT(), and applyFactor
+  performs its triangular solves on that copy. This halves the memory
+  traffic of the apply phase - which is bandwidth-bound - at the cost
+  of a reduced-precision preconditioner. Since the preconditioner only
+  steers the outer Krylov iteration, which remains in full TacsScalar
+  precision, the final solution accuracy is unaffected.
+*/
+void BCSRMat::setSinglePrecisionFactor(int flag) {
+  if (flag && (symm_storage || complex_lanes || morton_layout)) {
+    fprintf(stderr,
+            "BCSRMat: The single-precision factor is not available "
+            "with the symmetric, interleaved complex or Morton-ordered "
+            "storage\n");
+    return;
+  }
+  use_single_factor = flag;
+  if (!use_single_factor) {
+    if (Asp) {
+      delete[] Asp;
+      Asp = NULL;
+    }
+    if (xsp) {
+      delete[] xsp;
+      xsp = NULL;
+    }
+    single_nnz = 0;
+  }
+}
+
+/*!
+  Copy the factored matrix values into single-precision storage.
+
+  The non-zero pattern is shared with the full-precision matrix; only
+  the values are duplicated. If the pattern changed since the last
+  copy - as happens between ILUT factorizations - the storage is
+  re-allocated to match.
+*/
+void BCSRMat::copyFactorToSingle() {
+  const int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+  const int nnz = data->rowp[data->nrows];
+
+  if (Asp && single_nnz != nnz) {
+    delete[] Asp;
+    Asp = NULL;
+  }
+  if (!Asp) {
+    Asp = new TacsSingleScalar[b2 * nnz];
+    single_nnz = nnz;
+  }
+  if (!xsp) {
+    xsp = new TacsSingleScalar[bsize * data->nrows];
+  }
+
+  for (int i = 0; i < b2 * nnz; i++) {
+#ifdef TACS_USE_COMPLEX
+    Asp[i] = TacsSingleScalar((float)data->A[i].real(),
+                              (float)data->A[i].imag());
+#else
+    Asp[i] = (float)TacsRealPart(data->A[i]);
+#endif
+  }
+}
+
+/*!
+  Enable or disable explicit storage of the transposed matrix.
+
+  When enabled, multTranspose runs the tuned forward mat-vec kernel on
+  an explicit copy of A^{T} rather than the transpose kernel, which
+  scatters into the output with strided access. The transposed
+  non-zero pattern is computed once, and the values are refreshed
+  lazily the first time multTranspose is called after the matrix
+  values change, so the cost of the copy is amortized over all of the
+  transpose products - such as the adjoint right-hand sides - computed
+  from the same assembly. The storage for the matrix is doubled.
+*/
+void BCSRMat::setStoreTranspose(int flag) {
+  if (flag && (symm_storage || complex_lanes || morton_layout)) {
+    fprintf(stderr,
+            "BCSRMat: The explicit transpose is not available "
+            "with the symmetric, interleaved complex or Morton-ordered "
+            "storage\n");
+    return;
+  }
+  use_transpose = flag;
+  if (!use_transpose) {
+    if (trans_perm) {
+      delete[] trans_perm;
+      trans_perm = NULL;
+    }
+    if (trans_data) {
+      trans_data->decref();
+      trans_data = NULL;
+    }
+    trans_valid = 0;
+  }
+}
+
+/*!
+  Convert the matrix to symmetric (upper-triangle) storage.
+
+  The strictly lower-triangle blocks are discarded and only the
+  blocks with column >= row are retained, halving the matrix memory
+  and the mat-vec traffic. Each stored off-diagonal block represents
+  both itself and its transpose, so the matrix values must actually
+  be symmetric - mass matrices, conduction operators and undamped
+  stiffness matrices assembled through assembleMatType are. The
+  element scatter through addRowValues/addBlockRowValues silently
+  skips the lower-triangle contributions, so the assembly code does
+  not change.
+
+  The supported operations are mult, multAdd, multRHS, multTranspose,
+  factor and applyFactor, along with the value-setting routines and
+  zeroEntries/zeroRow. The factorization is the Cholesky-style
+  decomposition A = R^{T}*R restricted to the stored pattern, which
+  requires a positive definite matrix. Note that zeroing a boundary
+  condition row also zeroes the matching column contributions of the
+  product - the standard symmetric form of the constraint. The
+  single-precision factor, the explicit transpose and the threaded
+  kernels assume the full storage layout and are disabled.
+
+  Call this once after the symbolic structure is created, before the
+  matrix is assembled.
+*/
+void BCSRMat::useSymmetricStorage() {
+  if (symm_storage) {
+    return;
+  }
+  if (complex_lanes || morton_layout) {
+    fprintf(stderr,
+            "BCSRMat: Symmetric storage is not available with "
+            "interleaved complex or Morton-ordered storage\n");
+    return;
+  }
+  if (data->nrows != data->ncols) {
+    fprintf(stderr,
+            "BCSRMat: Cannot use symmetric storage for a "
+            "rectangular matrix\n");
+    return;
+  }
+
+  const int nrows = data->nrows;
+  const int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  // Count the blocks in the upper triangle
+  int *rowp = new int[nrows + 1];
+  rowp[0] = 0;
+  for (int i = 0; i < nrows; i++) {
+    int count = 0;
+    for (int k = data->rowp[i]; k < data->rowp[i + 1]; k++) {
+      if (data->cols[k] >= i) {
+        count++;
+      }
+    }
+    rowp[i + 1] = rowp[i] + count;
+  }
+
+  // Copy the upper-triangle column indices and values
+  int nnz = rowp[nrows];
+  int *cols = new int[nnz];
+  TacsScalar *A = new TacsScalar[b2 * nnz];
+  for (int i = 0, n = 0; i < nrows; i++) {
+    for (int k = data->rowp[i]; k < data->rowp[i + 1]; k++) {
+      if (data->cols[k] >= i) {
+        cols[n] = data->cols[k];
+        memcpy(&A[b2 * n], &data->A[b2 * k], b2 * sizeof(TacsScalar));
+        n++;
+      }
+    }
+  }
+
+  // Replace the storage, updating the memory accounting
+  TacsReleaseAllocation(b2 * (size_t)data->rowp[nrows] * sizeof(TacsScalar));
+  delete[] data->rowp;
+  delete[] data->cols;
+  delete[] data->A;
+  data->rowp = rowp;
+  data->cols = cols;
+  data->A = A;
+  TacsRegisterAllocation(b2 * (size_t)nnz * sizeof(TacsScalar));
+  setUpDiag();
+
+  // The threaded schedules refer to the old non-zero pattern
+  if (tdata) {
+    tdata->decref();
+    tdata = NULL;
+  }
+
+  // The single-precision and explicit-transpose copies assume the
+  // full storage layout
+  setSinglePrecisionFactor(0);
+  setStoreTranspose(0);
+
+  // Install the symmetric kernels. The mat-vec and triangular sweeps
+  // scatter into the output vector, so there are no threaded
+  // counterparts.
+  bmult = BCSRMatVecMultSymm;
+  bmultadd = BCSRMatVecMultAddSymm;
+  bmultrhs = BCSRMatVecMultRHSSymm;
+  bmulttrans = BCSRMatVecMultSymm;
+  bfactor = BCSRMatFactorSymm;
+  applylower = BCSRMatApplyLowerSymm;
+  applyupper = BCSRMatApplyUpperSymm;
+  bmultadd_thread = NULL;
+  bfactor_thread = NULL;
+  applylower_thread = NULL;
+  applyupper_thread = NULL;
+
+  // The kernel candidates refer to the full block storage
+  num_mult_kernels = num_apply_kernels = 0;
+
+  symm_storage = 1;
+}
+
+/*!
+  Convert the matrix to interleaved complex storage.
+
+  Each scalar entry of the matrix becomes an adjacent (real,
+  imaginary) pair, doubling the value storage on the existing non-zero
+  pattern. The vectors use the same pairing: the paired vector is an
+  ordinary TacsScalar array with twice the block length, so the entry
+  for block row i starts at 2*bsize*i. The kernels perform the complex
+  arithmetic on the pairs directly, which lets a complex system - the
+  dynamic stiffness matrix K + i*omega*C - omega^2*M of a harmonic
+  response, for example - be assembled and solved through the real
+  build. Compared with the doubled real-equivalent system, both lanes
+  of each entry are read together with unit stride, halving the matrix
+  memory and bandwidth.
+
+  The values are set through addComplexRowValues and zeroEntries; the
+  existing values are discarded by the conversion. The supported
+  operations are mult, multAdd, multRHS, multTranspose (the
+  unconjugated transpose), factor and applyFactor. Since the paired
+  vectors are plain TacsScalar arrays, the existing Krylov classes
+  drive a harmonic solve unchanged through vectors with twice the
+  variables per block: the real inner product of two paired vectors is
+  the real part of the complex inner product, which is exactly the
+  inner product of the real-equivalent system.
+
+  The single-precision factor, the explicit transpose and the threaded
+  kernels assume the unpaired layout and are disabled.
+
+  Call this once after the symbolic structure is created, before the
+  matrix is assembled.
+*/
+void BCSRMat::useInterleavedComplex() {
+  if (complex_lanes) {
+    return;
+  }
+  if (symm_storage || morton_layout) {
+    fprintf(stderr,
+            "BCSRMat: Interleaved complex storage is not available "
+            "with symmetric or Morton-ordered storage\n");
+    return;
+  }
+
+  const int b2 = data->bsize * data->bsize;
+  const int nnz = data->rowp[data->nrows];
+
+  // Replace the value storage with the paired layout, updating the
+  // memory accounting
+  TacsReleaseAllocation(b2 * (size_t)nnz * sizeof(TacsScalar));
+  delete[] data->A;
+  data->A = new TacsScalar[2 * b2 * (size_t)nnz];
+  memset(data->A, 0, 2 * b2 * (size_t)nnz * sizeof(TacsScalar));
+  TacsRegisterAllocation(2 * b2 * (size_t)nnz * sizeof(TacsScalar));
+
+  // The threaded schedules and the reduced-storage copies assume the
+  // unpaired layout
+  if (tdata) {
+    tdata->decref();
+    tdata = NULL;
+  }
+  setSinglePrecisionFactor(0);
+  setStoreTranspose(0);
+
+  // Install the interleaved complex kernels. There are no threaded
+  // counterparts.
+  bmult = BCSRMatVecMultComplex;
+  bmultadd = BCSRMatVecMultAddComplex;
+  bmultrhs = BCSRMatVecMultRHSComplex;
+  bmulttrans = BCSRMatVecMultTransComplex;
+  bfactor = BCSRMatFactorComplex;
+  applylower = BCSRMatApplyLowerComplex;
+  applyupper = BCSRMatApplyUpperComplex;
+  bmultadd_thread = NULL;
+  bfactor_thread = NULL;
+  applylower_thread = NULL;
+  applyupper_thread = NULL;
+
+  // The kernel candidates refer to the unpaired storage
+  num_mult_kernels = num_apply_kernels = 0;
+
+  complex_lanes = 1;
+}
+
+/*
+  Compute the Morton (Z-order) code of a block index pair by
+  interleaving the bits of the row and column indices
+*/
+static uint64_t computeMortonCode(uint32_t row, uint32_t col) {
+  uint64_t code = 0;
+  for (int k = 0; k < 32; k++) {
+    code |= ((uint64_t)((row >> k) & 1)) << (2 * k + 1);
+    code |= ((uint64_t)((col >> k) & 1)) << (2 * k);
+  }
+  return code;
+}
+
+/*
+  A Morton code paired with the pattern position of its block, used to
+  sort the blocks into the Z-order storage sequence
+*/
+struct BCSRMatMortonPair {
+  uint64_t code;
+  int block;
+};
+
+static int compare_morton_pairs(const void *a, const void *b) {
+  const BCSRMatMortonPair *pa = static_cast<const BCSRMatMortonPair *>(a);
+  const BCSRMatMortonPair *pb = static_cast<const BCSRMatMortonPair *>(b);
+  if (pa->code < pb->code) {
+    return -1;
+  } else if (pa->code > pb->code) {
+    return 1;
+  }
+  return pa->block - pb->block;
+}
+
+/*!
+  Convert the matrix to the Morton-ordered (Z-order) block layout.
+
+  The value blocks are stored in the order of the Morton codes of
+  their (row, column) block indices instead of row-by-row. Blocks that
+  are close in both the row and the column direction then sit close in
+  memory at every scale, which matches the access pattern of the
+  factorization: eliminating a column updates the matching entries of
+  every later row that shares its columns, and with the row-major
+  layout those updates stride across the entire value array with poor
+  TLB behavior on large factorizations. The non-zero pattern is
+  unchanged; the kernels locate each block through a permutation, so
+  the indirection costs one extra integer load per block against much
+  better locality for the values, which dominate the traffic.
+
+  The layout pays off for the factorization and the triangular
+  solves of large matrices; for the mat-vec alone the row-major
+  streaming layout is already optimal, so convert only matrices that
+  will be factored in place.
+
+  The values are set through the usual add and zero routines and the
+  supported operations are mult, multAdd, multRHS, multTranspose,
+  factor and applyFactor. The single-precision factor, the explicit
+  transpose, the matrix-matrix products and the threaded kernels
+  assume the row-major layout and are disabled or unsupported.
+
+  Call this once after the symbolic structure is created. The existing
+  values are permuted into the new layout, so the conversion may be
+  applied before or after the matrix is assembled.
+*/
+void BCSRMat::useMortonBlockLayout() {
+  if (morton_layout) {
+    return;
+  }
+  if (symm_storage || complex_lanes) {
+    fprintf(stderr,
+            "BCSRMat: The Morton-ordered layout is not available with "
+            "symmetric or interleaved complex storage\n");
+    return;
+  }
+
+  const int nrows = data->nrows;
+  const int b2 = data->bsize * data->bsize;
+  const int nnz = data->rowp[data->nrows];
+
+  // Assign each block the Morton code of its block index pair and
+  // sort the blocks into Z-order, breaking ties by pattern position
+  BCSRMatMortonPair *pairs = new BCSRMatMortonPair[nnz];
+  for (int i = 0; i < nrows; i++) {
+    for (int k = data->rowp[i]; k < data->rowp[i + 1]; k++) {
+      pairs[k].code = computeMortonCode(i, data->cols[k]);
+      pairs[k].block = k;
+    }
+  }
+  qsort(pairs, nnz, sizeof(BCSRMatMortonPair), compare_morton_pairs);
+
+  // Build the permutation from pattern order to storage order
+  int *bperm = new int[nnz];
+  for (int p = 0; p < nnz; p++) {
+    bperm[pairs[p].block] = p;
+  }
+  delete[] pairs;
+
+  // Permute the existing values into the new layout. The value
+  // storage size is unchanged, so the memory accounting is untouched.
+  TacsScalar *A = new TacsScalar[b2 * (size_t)nnz];
+  for (int k = 0; k < nnz; k++) {
+    memcpy(&A[b2 * bperm[k]], &data->A[b2 * k], b2 * sizeof(TacsScalar));
+  }
+  delete[] data->A;
+  data->A = A;
+  data->bperm = bperm;
+
+  // The threaded schedules and the reduced-storage copies assume the
+  // row-major layout
+  if (tdata) {
+    tdata->decref();
+    tdata = NULL;
+  }
+  setSinglePrecisionFactor(0);
+  setStoreTranspose(0);
+
+  // Install the Morton-ordered kernels. There are no threaded
+  // counterparts.
+  bmult = BCSRMatVecMultMorton;
+  bmultadd = BCSRMatVecMultAddMorton;
+  bmultrhs = BCSRMatVecMultRHSMorton;
+  bmulttrans = BCSRMatVecMultTransMorton;
+  bfactor = BCSRMatFactorMorton;
+  applylower = BCSRMatApplyLowerMorton;
+  applyupper = BCSRMatApplyUpperMorton;
+  bmultadd_thread = NULL;
+  bfactor_thread = NULL;
+  applylower_thread = NULL;
+  applyupper_thread = NULL;
+
+  // The kernel candidates refer to the row-major block order
+  num_mult_kernels = num_apply_kernels = 0;
+
+  morton_layout = 1;
+}
+
+/*!
+  Copy the matrix values into the explicit transpose storage.
+
+  On the first call this computes the transposed non-zero pattern and
+  the permutation from each block to its transposed position. On
+  subsequent calls only the values are copied, with each block
+  transposed in place.
+*/
+void BCSRMat::copyValuesToTranspose() {
+  const int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+  const int nrows = data->nrows;
+  const int ncols = data->ncols;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int nnz = rowp[nrows];
+
+  if (!trans_data) {
+    // Count the number of blocks in each column of A to form the
+    // row pointer of the transpose
+    int *trowp = new int[ncols + 1];
+    memset(trowp, 0, (ncols + 1) * sizeof(int));
+    for (int k = 0; k < nnz; k++) {
+      trowp[cols[k] + 1]++;
+    }
+    for (int j = 0; j < ncols; j++) {
+      trowp[j + 1] += trowp[j];
+    }
+
+    // Scan the rows in order so that the column indices within each
+    // transposed row are sorted, recording where each block lands
+    int *tcols = new int[nnz];
+    trans_perm = new int[nnz];
+    int *next = new int[ncols];
+    memcpy(next, trowp, ncols * sizeof(int));
+    for (int i = 0; i < nrows; i++) {
+      for (int k = rowp[i]; k < rowp[i + 1]; k++) {
+        int t = next[cols[k]];
+        tcols[t] = i;
+        trans_perm[k] = t;
+        next[cols[k]]++;
+      }
+    }
+    delete[] next;
+
+    trans_data = new BCSRMatData(bsize, ncols, nrows);
+    trans_data->incref();
+    trans_data->rowp = trowp;
+    trans_data->cols = tcols;
+    trans_data->A = new TacsScalar[b2 * nnz];
+    TacsRegisterAllocation(b2 * (size_t)nnz * sizeof(TacsScalar));
+  }
+
+  // Copy the values, transposing each block
+  TacsScalar *At = trans_data->A;
+  for (int k = 0; k < nnz; k++) {
+    const TacsScalar *a = &data->A[b2 * k];
+    TacsScalar *at = &At[b2 * trans_perm[k]];
+    for (int ii = 0; ii < bsize; ii++) {
+      for (int jj = 0; jj < bsize; jj++) {
+        at[bsize * jj + ii] = a[bsize * ii + jj];
+      }
+    }
+  }
+
+  trans_valid = 1;
+}
+
+/*
+  Time one kernel with the signature of the mat-vec and triangular
+  solve operations: a warm-up call followed by enough repetitions to
+  accumulate a measurable interval
+
+  returns: the time per call in seconds
+*/
+static double benchmarkKernel(void (*kernel)(BCSRMatData *, TacsScalar *,
+                                             TacsScalar *),
+                              BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  // Warm the caches and page in the vectors
+  kernel(data, x, y);
+
+  int reps = 1;
+  double t = 0.0;
+  for (int iter = 0; iter < 24; iter++) {
+    double t0 = MPI_Wtime();
+    for (int k = 0; k < reps; k++) {
+      kernel(data, x, y);
+    }
+    t = MPI_Wtime() - t0;
+    if (t >= 1e-3) {
+      break;
+    }
+    reps = 2 * reps;
+  }
+
+  return t / reps;
+}
+
+/*
+  Time one kernel with the signature of the mat-vec-add operation
+*/
+static double benchmarkKernelAdd(void (*kernel)(BCSRMatData *, TacsScalar *,
+                                                TacsScalar *, TacsScalar *),
+                                 BCSRMatData *data, TacsScalar *x,
+                                 TacsScalar *y, TacsScalar *z) {
+  kernel(data, x, y, z);
+
+  int reps = 1;
+  double t = 0.0;
+  for (int iter = 0; iter < 24; iter++) {
+    double t0 = MPI_Wtime();
+    for (int k = 0; k < reps; k++) {
+      kernel(data, x, y, z);
+    }
+    t = MPI_Wtime() - t0;
+    if (t >= 1e-3) {
+      break;
+    }
+    reps = 2 * reps;
+  }
+
+  return t / reps;
+}
+
+/*
+  Select the mat-vec kernels from the registered candidates.
+
+  The selection for this (operation, block size, size class) key is
+  looked up in the process-wide registry first. When no selection has
+  been recorded, each candidate is microbenchmarked on this matrix
+  for a few milliseconds and the winner is cached for later matrices
+  with the same key.
+*/
+void BCSRMat::selectMultKernels() {
+  TacsProfileScope profile("BCSRMat::selectMultKernels");
+  mult_kernels_selected = 1;
+
+  // In deterministic mode pin the widest registered kernels rather
+  // than timing the candidates: the wall-clock benchmark can pick
+  // different winners on identical runs, which would make the results
+  // bitwise-different from run to run
+  if (TacsGetDeterministicReductions()) {
+    bmult = mult_kernels[num_mult_kernels - 1];
+    bmultadd = multadd_kernels[num_mult_kernels - 1];
+    return;
+  }
+
+  const int bsize = data->bsize;
+  const int size_class = BCSRMatKernelSizeClass(bsize, data->nrows);
+
+  int imult = BCSRMatLookupKernel(BCSR_KERNEL_MULT, bsize, size_class);
+  int iadd = BCSRMatLookupKernel(BCSR_KERNEL_MULTADD, bsize, size_class);
+
+  if (imult < 0 || iadd < 0) {
+    // Benchmark the candidates on work vectors sized for this matrix
+    TacsScalar *x = new TacsScalar[bsize * data->ncols];
+    TacsScalar *y = new TacsScalar[bsize * data->nrows];
+    TacsScalar *z = new TacsScalar[bsize * data->nrows];
+    memset(x, 0, bsize * data->ncols * sizeof(TacsScalar));
+    memset(z, 0, bsize * data->nrows * sizeof(TacsScalar));
+
+    if (imult < 0) {
+      double tbest = 0.0;
+      for (int i = 0; i < num_mult_kernels; i++) {
+        double t = benchmarkKernel(mult_kernels[i], data, x, y);
+        if (imult < 0 || t < tbest) {
+          imult = i;
+          tbest = t;
+        }
+      }
+      BCSRMatRecordKernel(BCSR_KERNEL_MULT, bsize, size_class, imult);
+    }
+
+    if (iadd < 0) {
+      double tbest = 0.0;
+      for (int i = 0; i < num_mult_kernels; i++) {
+        double t = benchmarkKernelAdd(multadd_kernels[i], data, x, y, z);
+        if (iadd < 0 || t < tbest) {
+          iadd = i;
+          tbest = t;
+        }
+      }
+      BCSRMatRecordKernel(BCSR_KERNEL_MULTADD, bsize, size_class, iadd);
+    }
+
+    delete[] x;
+    delete[] y;
+    delete[] z;
+  }
+
+  // Guard against a stale persistent cache recorded with more
+  // candidates than this processor provides
+  if (imult >= num_mult_kernels) {
+    imult = num_mult_kernels - 1;
+  }
+  if (iadd >= num_mult_kernels) {
+    iadd = num_mult_kernels - 1;
+  }
+
+  bmult = mult_kernels[imult];
+  bmultadd = multadd_kernels[iadd];
+}
+
+/*
+  Select the triangular solve kernels from the registered candidates.
+
+  This is called from applyFactor once the matrix has been factored,
+  since the solves read the factored diagonal blocks.
+*/
+void BCSRMat::selectApplyKernels() {
+  TacsProfileScope profile("BCSRMat::selectApplyKernels");
+  apply_kernels_selected = 1;
+
+  // Pin the widest registered kernels in deterministic mode - see
+  // selectMultKernels
+  if (TacsGetDeterministicReductions()) {
+    applylower = applylower_kernels[num_apply_kernels - 1];
+    applyupper = applyupper_kernels[num_apply_kernels - 1];
+    return;
+  }
+
+  const int bsize = data->bsize;
+  const int size_class = BCSRMatKernelSizeClass(bsize, data->nrows);
+
+  int ilow = BCSRMatLookupKernel(BCSR_KERNEL_APPLY_LOWER, bsize, size_class);
+  int iupp = BCSRMatLookupKernel(BCSR_KERNEL_APPLY_UPPER, bsize, size_class);
+
+  if (ilow < 0 || iupp < 0) {
+    // Benchmark the candidates on work vectors sized for this matrix
+    TacsScalar *x = new TacsScalar[bsize * data->nrows];
+    TacsScalar *y = new TacsScalar[bsize * data->nrows];
+    memset(x, 0, bsize * data->nrows * sizeof(TacsScalar));
+
+    if (ilow < 0) {
+      double tbest = 0.0;
+      for (int i = 0; i < num_apply_kernels; i++) {
+        double t = benchmarkKernel(applylower_kernels[i], data, x, y);
+        if (ilow < 0 || t < tbest) {
+          ilow = i;
+          tbest = t;
+        }
+      }
+      BCSRMatRecordKernel(BCSR_KERNEL_APPLY_LOWER, bsize, size_class, ilow);
+    }
+
+    if (iupp < 0) {
+      double tbest = 0.0;
+      for (int i = 0; i < num_apply_kernels; i++) {
+        double t = benchmarkKernel(applyupper_kernels[i], data, x, y);
+        if (iupp < 0 || t < tbest) {
+          iupp = i;
+          tbest = t;
+        }
+      }
+      BCSRMatRecordKernel(BCSR_KERNEL_APPLY_UPPER, bsize, size_class, iupp);
+    }
+
+    delete[] x;
+    delete[] y;
+  }
+
+  // Guard against a stale persistent cache recorded with more
+  // candidates than this processor provides
+  if (ilow >= num_apply_kernels) {
+    ilow = num_apply_kernels - 1;
+  }
+  if (iupp >= num_apply_kernels) {
+    iupp = num_apply_kernels - 1;
+  }
+
+  applylower = applylower_kernels[ilow];
+  applyupper = applyupper_kernels[iupp];
 }
 
 /*!
   Compute y = A*x
 */
 void BCSRMat::mult(TacsScalar *xvec, TacsScalar *yvec) {
+  TacsProfileScope profile("BCSRMat::mult");
+
+  if (num_mult_kernels > 1 && !mult_kernels_selected) {
+    selectMultKernels();
+  }
+
+  // Record the work content of the product: each block is multiplied
+  // once and is streamed from memory with its column index
+  const double nnz = data->rowp[data->nrows];
+  const double b2 = data->bsize * data->bsize;
+  TacsProfileAddWork("BCSRMat::mult", 2.0 * b2 * nnz,
+                     (sizeof(TacsScalar) * b2 + sizeof(int)) * nnz);
+
   if (bmultadd_thread && thread_info->getNumThreads() > 1) {
     // If not allocated, allocate the threaded data
     if (!tdata) {
@@ -1244,10 +2317,28 @@ void BCSRMat::mult(TacsScalar *xvec, TacsScalar *yvec) {
   }
 }
 
+/*!
+  Compute Y = A*X for multiple right-hand sides
+
+  The input and output multivectors are packed by block row: the nrhs
+  right-hand sides for block row i are stored contiguously at
+  &xvec[bsize*nrhs*i], with the bsize components of each right-hand
+  side adjacent. Each block row of the matrix is read once for the
+  whole set of vectors, so the cost of streaming the matrix through
+  memory is amortized over all of the right-hand sides.
+*/
+void BCSRMat::multRHS(int nrhs, TacsScalar *xvec, TacsScalar *yvec) {
+  bmultrhs(data, nrhs, xvec, yvec);
+}
+
 /*!
   Compute y = A*x + z
 */
 void BCSRMat::multAdd(TacsScalar *xvec, TacsScalar *zvec, TacsScalar *yvec) {
+  if (num_mult_kernels > 1 && !mult_kernels_selected) {
+    selectMultKernels();
+  }
+
   if (bmultadd_thread && thread_info->getNumThreads() > 1) {
     // If not allocated, allocate the threaded data
     if (!tdata) {
@@ -1290,6 +2381,16 @@ void BCSRMat::multAdd(TacsScalar *xvec, TacsScalar *zvec, TacsScalar *yvec) {
   Compute y = A^{T}*x
 */
 void BCSRMat::multTranspose(TacsScalar *xvec, TacsScalar *yvec) {
+  if (use_transpose) {
+    // Use the forward kernel on the explicit transpose, refreshing
+    // the transposed values if the matrix has changed
+    if (!trans_valid) {
+      copyValuesToTranspose();
+    }
+    bmult(trans_data, xvec, yvec);
+    return;
+  }
+
   memset(yvec, 0, data->bsize * data->ncols * sizeof(TacsScalar));
   bmulttrans(data, xvec, yvec);
 }
@@ -1304,6 +2405,24 @@ void BCSRMat::multTranspose(TacsScalar *xvec, TacsScalar *yvec) {
 void BCSRMat::applyFactor(TacsScalar *xvec, TacsScalar *yvec) {
   if (!data->diag) {
     fprintf(stderr, "BCSRMat applyFactor error: matrix not factored\n");
+  } else if (use_single_factor && Asp) {
+    // Convert the input at the boundary and perform the triangular
+    // solves on the single-precision copy of the factorization
+    const int n = data->bsize * data->nrows;
+    for (int i = 0; i < n; i++) {
+#ifdef TACS_USE_COMPLEX
+      xsp[i] = TacsSingleScalar((float)xvec[i].real(), (float)xvec[i].imag());
+#else
+      xsp[i] = (float)TacsRealPart(xvec[i]);
+#endif
+    }
+
+    BCSRMatApplyLowerSP(data, Asp, xsp, xsp);
+    BCSRMatApplyUpperSP(data, Asp, xsp, xsp);
+
+    for (int i = 0; i < n; i++) {
+      yvec[i] = xsp[i];
+    }
   } else {
     if (applylower_thread && applyupper_thread &&
         thread_info->getNumThreads() > 1) {
@@ -1323,8 +2442,8 @@ void BCSRMat::applyFactor(TacsScalar *xvec, TacsScalar *yvec) {
       pthread_attr_init(&attr);
       pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
 
-      // Apply L^{-1}
-      tdata->init_apply_lower_sched();
+      // Apply L^{-1} using the level-set schedule
+      tdata->init_apply_lower_level_sched();
 
       // Go through and run the threads
       for (long k = 0; k < thread_info->getNumThreads(); k++) {
@@ -1336,8 +2455,8 @@ void BCSRMat::applyFactor(TacsScalar *xvec, TacsScalar *yvec) {
         pthread_join(tdata->threads[k], NULL);
       }
 
-      // Apply U^{-1}
-      tdata->init_apply_upper_sched();
+      // Apply U^{-1} using the level-set schedule
+      tdata->init_apply_upper_level_sched();
 
       // Go through and run the threads
       for (long k = 0; k < thread_info->getNumThreads(); k++) {
@@ -1352,6 +2471,9 @@ void BCSRMat::applyFactor(TacsScalar *xvec, TacsScalar *yvec) {
       // Destroy the attribute and join all the threads
       pthread_attr_destroy(&attr);
     } else {
+      if (num_apply_kernels > 1 && !apply_kernels_selected) {
+        selectApplyKernels();
+      }
       applylower(data, xvec, yvec);
       applyupper(data, yvec, yvec);
     }
@@ -1368,6 +2490,24 @@ void BCSRMat::applyFactor(TacsScalar *xvec, TacsScalar *yvec) {
 void BCSRMat::applyFactor(TacsScalar *xvec) {
   if (!data->diag) {
     fprintf(stderr, "BCSRMat applyFactor error: matrix not factored\n");
+  } else if (use_single_factor && Asp) {
+    // Convert the input at the boundary and perform the triangular
+    // solves on the single-precision copy of the factorization
+    const int n = data->bsize * data->nrows;
+    for (int i = 0; i < n; i++) {
+#ifdef TACS_USE_COMPLEX
+      xsp[i] = TacsSingleScalar((float)xvec[i].real(), (float)xvec[i].imag());
+#else
+      xsp[i] = (float)TacsRealPart(xvec[i]);
+#endif
+    }
+
+    BCSRMatApplyLowerSP(data, Asp, xsp, xsp);
+    BCSRMatApplyUpperSP(data, Asp, xsp, xsp);
+
+    for (int i = 0; i < n; i++) {
+      xvec[i] = xsp[i];
+    }
   } else {
     if (applylower_thread && applyupper_thread &&
         thread_info->getNumThreads() > 1) {
@@ -1384,8 +2524,8 @@ void BCSRMat::applyFactor(TacsScalar *xvec) {
       pthread_attr_init(&attr);
       pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
 
-      // Apply L^{-1}
-      tdata->init_apply_lower_sched();
+      // Apply L^{-1} using the level-set schedule
+      tdata->init_apply_lower_level_sched();
 
       // Go through and run the threads
       for (long k = 0; k < thread_info->getNumThreads(); k++) {
@@ -1397,8 +2537,8 @@ void BCSRMat::applyFactor(TacsScalar *xvec) {
         pthread_join(tdata->threads[k], NULL);
       }
 
-      // Apply U^{-1}
-      tdata->init_apply_upper_sched();
+      // Apply U^{-1} using the level-set schedule
+      tdata->init_apply_upper_level_sched();
 
       // Go through and run the threads
       for (long k = 0; k < thread_info->getNumThreads(); k++) {
@@ -1413,6 +2553,9 @@ void BCSRMat::applyFactor(TacsScalar *xvec) {
       // Destroy the attribute and join all the threads
       pthread_attr_destroy(&attr);
     } else {
+      if (num_apply_kernels > 1 && !apply_kernels_selected) {
+        selectApplyKernels();
+      }
       applylower(data, xvec, xvec);
       applyupper(data, xvec, xvec);
     }
@@ -1428,6 +2571,9 @@ void BCSRMat::applyUpper(TacsScalar *xvec, TacsScalar *yvec) {
   if (!data->diag) {
     fprintf(stderr, "BCSRMat applyUpper error: matrix not factored\n");
   } else {
+    if (num_apply_kernels > 1 && !apply_kernels_selected) {
+      selectApplyKernels();
+    }
     applyupper(data, xvec, yvec);
   }
 }
@@ -1441,6 +2587,9 @@ void BCSRMat::applyLower(TacsScalar *xvec, TacsScalar *yvec) {
   if (!data->diag) {
     fprintf(stderr, "BCSRMat applyLower error: matrix not factored\n");
   } else {
+    if (num_apply_kernels > 1 && !apply_kernels_selected) {
+      selectApplyKernels();
+    }
     applylower(data, xvec, yvec);
   }
 }
@@ -1743,9 +2892,14 @@ void BCSRMat::matMultNormal(TacsScalar *s, BCSRMat *bmat) {
   Zero all entries of the matrix
 */
 void BCSRMat::zeroEntries() {
+  trans_valid = 0;
+
   int bsize = data->bsize;
   int length = data->rowp[data->nrows];
   length *= bsize * bsize;
+  if (complex_lanes) {
+    length *= 2;
+  }
 
   memset(data->A, 0, length * sizeof(TacsScalar));
 }
@@ -1754,9 +2908,15 @@ void BCSRMat::zeroEntries() {
   Scale all the entries in the matrix by a factor
 */
 void BCSRMat::scale(TacsScalar alpha) {
+  trans_valid = 0;
+
   const int bsize = data->bsize;
   int length = data->rowp[data->nrows];
   length *= bsize * bsize;
+  if (complex_lanes) {
+    // Both lanes are scaled, which is a real scaling of the entries
+    length *= 2;
+  }
 
   int one = 1;
   BLASscal(&length, &alpha, data->A, &one);
@@ -1780,6 +2940,7 @@ void BCSRMat::addRowValues(int row, int ncol, const int *col, int nca,
   if (ncol <= 0) {
     return;
   }
+  trans_valid = 0;
 
   const int ncols = data->ncols;
   const int nrows = data->nrows;
@@ -1794,7 +2955,9 @@ void BCSRMat::addRowValues(int row, int ncol, const int *col, int nca,
 
     for (int j = 0; j < ncol; j++) {
       int c = col[j];
-      if (c < 0) {  // Skip entries that are negative
+      if (c < 0 || (symm_storage && c < row)) {
+        // Skip entries that are negative and, with symmetric storage,
+        // the lower-triangle contributions
         continue;
       } else if (c < ncols) {
         int *item = TacsSearchArray(c, row_size, col_array);
@@ -1804,6 +2967,9 @@ void BCSRMat::addRowValues(int row, int ncol, const int *col, int nca,
         } else {
           // Place the values into the array
           int cp = item - cols;
+          if (morton_layout) {
+            cp = data->bperm[cp];
+          }
           int bj = bsize * j;
           TacsScalar *a = &(data->A[b2 * cp]);
 
@@ -1825,6 +2991,79 @@ void BCSRMat::addRowValues(int row, int ncol, const int *col, int nca,
   }
 }
 
+/*!
+  Add interleaved complex values into the matrix row. The values may
+  only be added to locations with an existing non-zero pattern, and
+  the matrix must be in the interleaved complex storage mode.
+
+  The element values follow the same row-major layout as addRowValues,
+  with each scalar entry replaced by an adjacent (real, imaginary)
+  pair: the pair for local row jj of local column j starts at
+  avals[2*(nca*jj + bsize*j)].
+
+  input:
+  row:    the block row number
+  ncol:   the number of block columns in avals
+  col:    the block column numbers
+  nca:    the unpaired leading dimension of avals
+  avals:  the interleaved complex values
+*/
+void BCSRMat::addComplexRowValues(int row, int ncol, const int *col, int nca,
+                                  const TacsScalar *avals) {
+  if (!complex_lanes) {
+    fprintf(stderr,
+            "BCSRMat error: addComplexRowValues requires interleaved "
+            "complex storage\n");
+    return;
+  }
+  if (ncol <= 0) {
+    return;
+  }
+
+  const int ncols = data->ncols;
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int bsize = data->bsize;
+  const int pb2 = 2 * bsize * bsize;
+
+  if (row >= 0 && row < nrows) {
+    int row_size = rowp[row + 1] - rowp[row];
+    const int *col_array = &cols[rowp[row]];
+
+    for (int j = 0; j < ncol; j++) {
+      int c = col[j];
+      if (c < 0) {
+        continue;
+      } else if (c < ncols) {
+        int *item = TacsSearchArray(c, row_size, col_array);
+
+        if (item == NULL) {
+          fprintf(stderr, "BCSRMat error: no entry for (%d,%d)\n", row, c);
+        } else {
+          // Place the paired values into the array
+          int cp = item - cols;
+          int bj = 2 * bsize * j;
+          TacsScalar *a = &(data->A[pb2 * cp]);
+
+          for (int jj = 0; jj < bsize; jj++) {
+            int njj = 2 * nca * jj;
+            int bjj = 2 * bsize * jj;
+            for (int ii = 0; ii < 2 * bsize; ii++) {
+              a[ii + bjj] += avals[ii + bj + njj];
+            }
+          }
+        }
+      } else {
+        fprintf(stderr, "BCSRMat error: column %d out of range [0,%d)\n", c,
+                ncols);
+      }
+    }
+  } else {
+    fprintf(stderr, "BCSRMat error: row %d out of range [0,%d)\n", row, nrows);
+  }
+}
+
 /*!
   Add weighted values into the matrix row. Values can only be added to
   locations that have an existing non-zero pattern. Trying to add
@@ -1859,6 +3098,7 @@ void BCSRMat::addRowWeightValues(TacsScalar alpha, int row, int nwrows,
                                  const TacsScalar *weights, int nca,
                                  const TacsScalar *avals,
                                  MatrixOrientation matOr) {
+  trans_valid = 0;
   if (nwrows <= 0 || alpha == 0.0) {
     return;
   }
@@ -1879,9 +3119,9 @@ void BCSRMat::addRowWeightValues(TacsScalar alpha, int row, int nwrows,
         int c = wcols[jp];
         TacsScalar aw = alpha * weights[jp];
 
-        // Skip entries that are negative or have a
-        // zero weight value
-        if (c < 0 || aw == 0.0) {
+        // Skip entries that are negative, have a zero weight value
+        // or, with symmetric storage, fall in the lower triangle
+        if (c < 0 || aw == 0.0 || (symm_storage && c < row)) {
           continue;
         } else if (c < ncols) {
           int *item = TacsSearchArray(c, row_size, col_array);
@@ -1891,6 +3131,9 @@ void BCSRMat::addRowWeightValues(TacsScalar alpha, int row, int nwrows,
           } else {
             // Place the values into the array
             int cp = item - cols;
+            if (morton_layout) {
+              cp = data->bperm[cp];
+            }
             TacsScalar *A = &(data->A[b2 * cp]);
 
             if (matOr == TACS_MAT_NORMAL) {
@@ -1952,6 +3195,7 @@ void BCSRMat::addBlockRowValues(int row, int ncol, const int *col,
   if (ncol <= 0) {
     return;
   }
+  trans_valid = 0;
 
   const int ncols = data->ncols;
   const int nrows = data->nrows;
@@ -1967,7 +3211,9 @@ void BCSRMat::addBlockRowValues(int row, int ncol, const int *col,
     for (int j = 0; j < ncol; j++) {
       int c = col[j];
 
-      if (c < 0) {  // Skip entries that are negative
+      if (c < 0 || (symm_storage && c < row)) {
+        // Skip entries that are negative and, with symmetric storage,
+        // the lower-triangle contributions
         continue;
       } else if (c < ncols) {
         int *item = TacsSearchArray(c, row_size, col_array);
@@ -1977,6 +3223,9 @@ void BCSRMat::addBlockRowValues(int row, int ncol, const int *col,
         } else {
           // Add values into the array
           int cp = item - cols;
+          if (morton_layout) {
+            cp = data->bperm[cp];
+          }
           TacsScalar *a = &(data->A[b2 * cp]);
 
           for (int k = 0; k < b2; k++) {
@@ -2003,6 +3252,8 @@ void BCSRMat::addBlockRowValues(int row, int ncol, const int *col,
   ident:    flag to indicate whether to set the diagonal to 1
 */
 void BCSRMat::zeroRow(int row, int vars, int ident) {
+  trans_valid = 0;
+
   if (row >= 0 && row < data->nrows) {
     const int *rowp = data->rowp;
     const int *cols = data->cols;
@@ -2011,7 +3262,8 @@ void BCSRMat::zeroRow(int row, int vars, int ident) {
 
     int end = rowp[row + 1];
     for (int j = rowp[row]; j < end; j++) {
-      TacsScalar *a = &(data->A[b2 * j]);
+      int jp = (morton_layout ? data->bperm[j] : j);
+      TacsScalar *a = &(data->A[b2 * jp]);
       for (int ii = 0; ii < bsize; ii++) {
         if (vars & (1 << ii)) {
           for (int jj = 0; jj < bsize; jj++) {
@@ -2030,11 +3282,69 @@ void BCSRMat::zeroRow(int row, int vars, int ident) {
   }
 }
 
+/*!
+  Zero a contiguous range of rows that share a uniform variable mask.
+
+  When all of the variables in the block are constrained, the values
+  of the entire row range are contiguous in memory and are zeroed with
+  a single memset before the diagonal entries are restored. Otherwise
+  the rows are zeroed one at a time.
+
+  first_row: the first row of the range
+  num_rows:  the number of consecutive rows to zero
+  vars:      an integer containing binary variables
+  ident:     flag to indicate whether to set the diagonal to 1
+*/
+void BCSRMat::zeroRows(int first_row, int num_rows, int vars, int ident) {
+  trans_valid = 0;
+
+  const int bsize = data->bsize;
+
+  // The values of the row range are only contiguous with the
+  // row-major layout
+  if (vars == ((1 << bsize) - 1) && !morton_layout) {
+    if (first_row >= 0 && first_row + num_rows <= data->nrows) {
+      const int *rowp = data->rowp;
+      const int *cols = data->cols;
+      const int b2 = bsize * bsize;
+
+      // Zero the values for the entire row range in one sweep
+      int start = rowp[first_row];
+      int end = rowp[first_row + num_rows];
+      memset(&(data->A[b2 * start]), 0,
+             b2 * (end - start) * sizeof(TacsScalar));
+
+      // Restore the diagonal entries
+      if (ident) {
+        for (int row = first_row; row < first_row + num_rows; row++) {
+          for (int j = rowp[row]; j < rowp[row + 1]; j++) {
+            if (row == cols[j]) {
+              TacsScalar *a = &(data->A[b2 * j]);
+              for (int ii = 0; ii < bsize; ii++) {
+                a[(bsize + 1) * ii] = 1.0;
+              }
+            }
+          }
+        }
+      }
+    } else {
+      fprintf(stderr, "BCSRMat error: rows [%d,%d) out of range [0,%d)\n",
+              first_row, first_row + num_rows, data->nrows);
+    }
+  } else {
+    for (int row = first_row; row < first_row + num_rows; row++) {
+      zeroRow(row, vars, ident);
+    }
+  }
+}
+
 /*!
   Zero the column values
 */
 void BCSRMat::zeroColumns(int num_zero_cols, const int *zero_cols,
                           const int *zero_vars, int ident) {
+  trans_valid = 0;
+
   const int ncols = data->ncols;
   const int nrows = data->nrows;
   const int *rowp = data->rowp;
@@ -2100,6 +3410,9 @@ void BCSRMat::zeroColumns(int num_zero_cols, const int *zero_cols,
     if (col >= 0 && col < ncols) {
       for (int j = colp[col]; j < colp[col + 1]; j++) {
         int jp = ptr[j];
+        if (morton_layout) {
+          jp = data->bperm[jp];
+        }
 
         TacsScalar *a = &(data->A[b2 * jp]);
         for (int jj = 0; jj < bsize; jj++) {
@@ -2118,6 +3431,9 @@ void BCSRMat::zeroColumns(int num_zero_cols, const int *zero_cols,
       int col = zero_cols[i];
       if (col >= 0 && col < ncols) {
         int jp = diag[col];
+        if (morton_layout) {
+          jp = data->bperm[jp];
+        }
 
         TacsScalar *a = &(data->A[b2 * jp]);
         for (int jj = 0; jj < bsize; jj++) {
@@ -2236,9 +3552,9 @@ void BCSRMat::partition(int nrows_p, BCSRMat **Bmat, BCSRMat **Emat,
     }
   }
 
-  // Create the B and E non-zero pattern
-  int *frowp = new int[nrows_b + 1];
-  int *crowp = new int[nrows_b + 1];
+  // Create the F and C non-zero pattern
+  int *frowp = new int[nrows_c + 1];
+  int *crowp = new int[nrows_c + 1];
 
   int nf = 0, nc = 0;
   frowp[0] = 0;
@@ -2435,6 +3751,7 @@ void BCSRMat::axpy(TacsScalar alpha, BCSRMat *mat) {
             "size cannot apply axpy\n");
     return;
   }
+  trans_valid = 0;
 
   const int nrows = data->nrows;
   const int *rowp = data->rowp;
@@ -2490,6 +3807,7 @@ void BCSRMat::axpby(TacsScalar alpha, TacsScalar beta, BCSRMat *mat) {
             "BCSRMat: Matrices are not the same "
             "size cannot apply axpby\n");
   }
+  trans_valid = 0;
 
   const int nrows = data->nrows;
   const int *rowp = data->rowp;
@@ -2535,11 +3853,17 @@ void BCSRMat::axpby(TacsScalar alpha, TacsScalar beta, BCSRMat *mat) {
   Add a value to the diagonal entries of the matrix
 */
 void BCSRMat::addDiag(TacsScalar alpha) {
+  trans_valid = 0;
+
   if (data->diag) {
     const int bsize = data->bsize;
     const int b2 = bsize * bsize;
     for (int i = 0; i < data->nrows; i++) {
-      TacsScalar *a = &(data->A[b2 * data->diag[i]]);
+      int dp = data->diag[i];
+      if (morton_layout) {
+        dp = data->bperm[dp];
+      }
+      TacsScalar *a = &(data->A[b2 * dp]);
       for (int k = 0; k < bsize; k++) {
         a[(bsize + 1) * k] += alpha;
       }
@@ -2551,7 +3875,8 @@ void BCSRMat::addDiag(TacsScalar alpha) {
       for (int jp = data->rowp[i]; jp < data->rowp[i + 1]; jp++) {
         int j = data->cols[jp];
         if (i == j) {
-          TacsScalar *a = &(data->A[b2 * jp]);
+          int cp = (morton_layout ? data->bperm[jp] : jp);
+          TacsScalar *a = &(data->A[b2 * cp]);
           for (int k = 0; k < bsize; k++) {
             a[(bsize + 1) * k] += alpha;
           }
@@ -2565,12 +3890,18 @@ void BCSRMat::addDiag(TacsScalar alpha) {
   Add an array of values to the diagonal entries of the matrix
 */
 void BCSRMat::addDiag(TacsScalar *alpha) {
+  trans_valid = 0;
+
   if (data->diag) {
     const int bsize = data->bsize;
     const int b2 = bsize * bsize;
     for (int i = 0; i < data->nrows; i++) {
       TacsScalar *d = &alpha[bsize * i];
-      TacsScalar *a = &(data->A[b2 * data->diag[i]]);
+      int dp = data->diag[i];
+      if (morton_layout) {
+        dp = data->bperm[dp];
+      }
+      TacsScalar *a = &(data->A[b2 * dp]);
       for (int k = 0; k < bsize; k++) {
         a[(bsize + 1) * k] += d[k];
       }
@@ -2583,7 +3914,8 @@ void BCSRMat::addDiag(TacsScalar *alpha) {
       for (int jp = data->rowp[i]; jp < data->rowp[i + 1]; jp++) {
         int j = data->cols[jp];
         if (i == j) {
-          TacsScalar *a = &(data->A[b2 * jp]);
+          int cp = (morton_layout ? data->bperm[jp] : jp);
+          TacsScalar *a = &(data->A[b2 * cp]);
           for (int k = 0; k < bsize; k++) {
             a[(bsize + 1) * k] += d[k];
           }
@@ -2593,6 +3925,63 @@ void BCSRMat::addDiag(TacsScalar *alpha) {
   }
 }
 
+/*!
+  Count the number of negative pivots in the factored matrix.
+
+  The factorization stores the diagonal blocks in inverted form.
+  Since inversion preserves the inertia of each pivot block, and the
+  block factorization itself is performed without pivoting, summing
+  the negative pivot signs of the (inverted) diagonal blocks gives
+  the number of negative eigenvalues of a symmetric matrix by
+  Sylvester's law of inertia. The count is only exact when factor()
+  has been applied with a complete fill pattern (levFill such that no
+  fill is dropped); with an incomplete factorization the result is
+  approximate.
+
+  returns: the number of negative pivots, or -1 if the matrix has
+  not been factored
+*/
+int BCSRMat::countNegativePivots() {
+  if (!data->diag) {
+    fprintf(stderr,
+            "BCSRMat: Must call factor() before counting "
+            "negative pivots\n");
+    return -1;
+  }
+
+  const int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+  TacsScalar *block = new TacsScalar[b2];
+
+  int count = 0;
+  for (int i = 0; i < data->nrows; i++) {
+    // Copy the inverted diagonal block so that the pivot computation
+    // does not modify the stored factorization
+    memcpy(block, &(data->A[b2 * data->diag[i]]), b2 * sizeof(TacsScalar));
+
+    // Compute an unpivoted LU factorization of the block and count
+    // the pivots with negative real part
+    for (int k = 0; k < bsize; k++) {
+      TacsScalar d = block[(bsize + 1) * k];
+      if (TacsRealPart(d) < 0.0) {
+        count++;
+      }
+      if (TacsRealPart(d) != 0.0) {
+        for (int j = k + 1; j < bsize; j++) {
+          TacsScalar ljk = block[bsize * j + k] / d;
+          for (int p = k + 1; p < bsize; p++) {
+            block[bsize * j + p] -= ljk * block[bsize * k + p];
+          }
+        }
+      }
+    }
+  }
+
+  delete[] block;
+
+  return count;
+}
+
 /*!
   Compute the bandwidth of the matrix.
 
@@ -2950,3 +4339,105 @@ void BCSRMat::printNzPattern(const char *fname) {
     fclose(fp);
   }
 }
+
+/*!
+  Write the matrix to a binary file.
+
+  The file layout is flat so that each section can be mapped directly
+  into memory:
+
+  int[4]                       bsize, nrows, ncols, nnz
+  int[nrows + 1]               The rowp array
+  int[nnz]                     The cols array
+  TacsScalar[bsize*bsize*nnz]  The block values
+
+  Returns 0 on success, 1 on failure.
+*/
+int BCSRMat::writeToFile(const char *fname) {
+  FILE *fp = fopen(fname, "wb");
+  if (!fp) {
+    fprintf(stderr, "BCSRMat: Could not open file %s for writing\n", fname);
+    return 1;
+  }
+
+  const int nrows = data->nrows;
+  const int nnz = data->rowp[nrows];
+  const int b2 = data->bsize * data->bsize;
+
+  int header[4] = {data->bsize, nrows, data->ncols, nnz};
+  int fail = (fwrite(header, sizeof(int), 4, fp) != 4);
+  fail = fail || (fwrite(data->rowp, sizeof(int), nrows + 1, fp) !=
+                  (size_t)(nrows + 1));
+  fail = fail || (fwrite(data->cols, sizeof(int), nnz, fp) != (size_t)nnz);
+  fail = fail || (fwrite(data->A, sizeof(TacsScalar), b2 * nnz, fp) !=
+                  (size_t)(b2 * nnz));
+  fclose(fp);
+
+  if (fail) {
+    fprintf(stderr, "BCSRMat: Error writing to file %s\n", fname);
+  }
+
+  return fail;
+}
+
+/*!
+  Read the matrix values from a binary file written by writeToFile().
+
+  The stored non-zero structure must match the existing structure
+  exactly: only the block values are loaded, so no symbolic
+  computation is performed. Returns 0 on success, 1 on failure.
+*/
+int BCSRMat::readFromFile(const char *fname) {
+  FILE *fp = fopen(fname, "rb");
+  if (!fp) {
+    fprintf(stderr, "BCSRMat: Could not open file %s for reading\n", fname);
+    return 1;
+  }
+
+  const int nrows = data->nrows;
+  const int nnz = data->rowp[nrows];
+  const int b2 = data->bsize * data->bsize;
+
+  // Check that the stored dimensions match the existing matrix
+  int header[4] = {0, 0, 0, 0};
+  int fail = (fread(header, sizeof(int), 4, fp) != 4);
+  if (fail || header[0] != data->bsize || header[1] != nrows ||
+      header[2] != data->ncols || header[3] != nnz) {
+    fprintf(stderr,
+            "BCSRMat: Matrix in file %s does not match the "
+            "existing non-zero structure\n",
+            fname);
+    fclose(fp);
+    return 1;
+  }
+
+  // Check that the stored non-zero pattern is identical
+  int *rowp = new int[nrows + 1];
+  int *cols = new int[nnz];
+  fail = (fread(rowp, sizeof(int), nrows + 1, fp) != (size_t)(nrows + 1));
+  fail = fail || (fread(cols, sizeof(int), nnz, fp) != (size_t)nnz);
+  fail = fail || (memcmp(rowp, data->rowp, (nrows + 1) * sizeof(int)) != 0);
+  fail = fail || (memcmp(cols, data->cols, nnz * sizeof(int)) != 0);
+  delete[] rowp;
+  delete[] cols;
+
+  if (fail) {
+    fprintf(stderr,
+            "BCSRMat: Matrix in file %s does not match the "
+            "existing non-zero structure\n",
+            fname);
+    fclose(fp);
+    return 1;
+  }
+
+  // Read the values directly into the matrix
+  fail = (fread(data->A, sizeof(TacsScalar), b2 * nnz, fp) !=
+          (size_t)(b2 * nnz));
+  fclose(fp);
+
+  if (fail) {
+    fprintf(stderr, "BCSRMat: Error reading values from file %s\n", fname);
+  }
+
+  return fail;
+}
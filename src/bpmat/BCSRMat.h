@@ -69,6 +69,8 @@ class BCSRMat : public TACSObject {
   void zeroEntries();
   void addRowValues(int row, int ncol, const int *col, int nca,
                     const TacsScalar *avals);
+  void addComplexRowValues(int row, int ncol, const int *col, int nca,
+                           const TacsScalar *avals);
   void addRowWeightValues(TacsScalar alpha, int row, int nwrows,
                           const int *wrowp, const int *wcols,
                           const TacsScalar *weights, int nca,
@@ -77,6 +79,7 @@ class BCSRMat : public TACSObject {
   void addBlockRowValues(int row, int ncol, const int *col,
                          const TacsScalar *a);
   void zeroRow(int row, int vars, int ident = 0);
+  void zeroRows(int first_row, int num_rows, int vars, int ident = 0);
   void zeroColumns(int num_zero_cols, const int *zero_cols,
                    const int *zero_vars, int ident = 0);
   void getArrays(int *_bsize, int *nrows, int *ncols, const int **rowp,
@@ -92,7 +95,15 @@ class BCSRMat : public TACSObject {
   // Functions related to solving the system of equations
   // ----------------------------------------------------
   void factor();
+  void factorILUT(BCSRMat *mat, double tol, int maxfill,
+                  TacsScalar diag_shift = 0.0);
+  void setSinglePrecisionFactor(int flag);
+  void setStoreTranspose(int flag);
+  void useSymmetricStorage();
+  void useInterleavedComplex();
+  void useMortonBlockLayout();
   void mult(TacsScalar *xvec, TacsScalar *yvec);
+  void multRHS(int nrhs, TacsScalar *xvec, TacsScalar *yvec);
   void multAdd(TacsScalar *xvec, TacsScalar *zvec, TacsScalar *yvec);
   void multTranspose(TacsScalar *xvec, TacsScalar *yvec);
   void applyFactor(TacsScalar *xvec, TacsScalar *yvec);
@@ -109,6 +120,10 @@ class BCSRMat : public TACSObject {
                 TacsScalar omega, const TacsScalar *b, const TacsScalar *xext,
                 TacsScalar *x);
 
+  // Count the negative pivots in the factored matrix
+  // ------------------------------------------------
+  int countNegativePivots();
+
   void matMultAdd(double alpha, BCSRMat *amat, BCSRMat *bmat);
   void applyLowerFactor(BCSRMat *emat);
   void applyUpperFactor(BCSRMat *fmat);
@@ -122,6 +137,9 @@ class BCSRMat : public TACSObject {
   int getBlockSize() { return data->bsize; }
   int getRowDim() { return data->nrows; }
   int getColDim() { return data->ncols; }
+  int isSymmetricStorage() { return symm_storage; }
+  int isInterleavedComplex() { return complex_lanes; }
+  int isMortonLayout() { return morton_layout; }
   BCSRMatData *getMatData() { return data; }
 
   // Extract the matrix in a  LAPACK format
@@ -139,6 +157,11 @@ class BCSRMat : public TACSObject {
   void printMat(const char *fname);
   void printNzPattern(const char *fname);
 
+  // Binary export/import of the matrix structure and values
+  // -------------------------------------------------------
+  int writeToFile(const char *fname);
+  int readFromFile(const char *fname);
+
   // Initialize either the generic or block-specific implementations
   // ---------------------------------------------------------------
   void initGenericImpl();
@@ -146,6 +169,9 @@ class BCSRMat : public TACSObject {
 
  private:
   void setUpDiag();  // Set up the diagonal entry pointer 'diag'
+
+  // Allocate and zero the block storage with NUMA-aware first touch
+  void initBlockStorage(int length);
   void computeILUk(BCSRMat *mat, int levFill, double fill, int **_levs);
   BCSRMat *computeILUkEpc(BCSRMat *EMat, const int *levs, int levFill,
                           double fill, int **_elevs);
@@ -154,6 +180,7 @@ class BCSRMat : public TACSObject {
 
   // (potential) block-specific implementations for each operation
   void (*bmult)(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+  void (*bmultrhs)(BCSRMatData *A, int nrhs, TacsScalar *x, TacsScalar *y);
   void (*bmultadd)(BCSRMatData *A, TacsScalar *x, TacsScalar *y, TacsScalar *z);
   void (*bmulttrans)(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
   void (*bfactor)(BCSRMatData *A);
@@ -174,6 +201,27 @@ class BCSRMat : public TACSObject {
   void (*bfactorupper)(BCSRMatData *A, BCSRMatData *F);
   void (*bmatmatmultnormal)(BCSRMatData *A, TacsScalar *s, BCSRMatData *B);
 
+  // Profile-guided kernel selection. When an operation has more than
+  // one candidate implementation, the candidates are microbenchmarked
+  // on this matrix at first use and the winner is cached per
+  // (operation, block size, size class) - see BCSRMatKernelSelect.h.
+  static const int MAX_KERNEL_CANDIDATES = 3;
+  void selectMultKernels();
+  void selectApplyKernels();
+  int mult_kernels_selected, apply_kernels_selected;
+  int num_mult_kernels;
+  void (*mult_kernels[MAX_KERNEL_CANDIDATES])(BCSRMatData *A, TacsScalar *x,
+                                              TacsScalar *y);
+  void (*multadd_kernels[MAX_KERNEL_CANDIDATES])(BCSRMatData *A, TacsScalar *x,
+                                                 TacsScalar *y, TacsScalar *z);
+  int num_apply_kernels;
+  void (*applylower_kernels[MAX_KERNEL_CANDIDATES])(BCSRMatData *A,
+                                                    TacsScalar *x,
+                                                    TacsScalar *y);
+  void (*applyupper_kernels[MAX_KERNEL_CANDIDATES])(BCSRMatData *A,
+                                                    TacsScalar *x,
+                                                    TacsScalar *y);
+
   // The thread-specific implementations
   void *(*bmultadd_thread)(void *);
   void *(*bfactor_thread)(void *);
@@ -199,6 +247,45 @@ class BCSRMat : public TACSObject {
   TacsScalar *Adiag;
   int npairs;
   int *pairs;
+
+  // Optional single-precision copy of the factored matrix. When
+  // enabled, applyFactor converts the input to single precision,
+  // performs the triangular solves on the reduced-precision copy and
+  // converts the result back, halving the preconditioner memory
+  // traffic while the Krylov iteration remains in full precision.
+  void copyFactorToSingle();
+  int use_single_factor;
+  int single_nnz;          // The number of blocks in the single copy
+  TacsSingleScalar *Asp;   // The single-precision factored values
+  TacsSingleScalar *xsp;   // Work vector for the converted input
+
+  // Optional explicit transpose of the matrix. When enabled, the
+  // transposed non-zero pattern is computed once and the values are
+  // copied over lazily after each assembly, so that multTranspose can
+  // run the tuned forward mat-vec kernel with unit-stride access
+  // instead of the scattered transpose kernel. The copy is shared
+  // across all transpose products until the matrix values change.
+  // Non-zero if only the upper-triangle blocks are stored. The
+  // symmetric mode halves the matrix memory and mat-vec traffic for
+  // SPD systems - see useSymmetricStorage() for the supported
+  // operations.
+  int symm_storage;
+
+  // Non-zero if each scalar entry is stored as an interleaved (real,
+  // imaginary) pair - see useInterleavedComplex() for the supported
+  // operations.
+  int complex_lanes;
+
+  // Non-zero if the value blocks are stored in Morton (Z-order) order
+  // rather than row-by-row - see useMortonBlockLayout() for the
+  // supported operations.
+  int morton_layout;
+
+  void copyValuesToTranspose();
+  int use_transpose;
+  int trans_valid;          // Non-zero if the transpose values are current
+  int *trans_perm;          // Maps each block to its transposed position
+  BCSRMatData *trans_data;  // The transposed matrix data
 };
 
 #endif  // TACS_BCSR_MATRIX_H
@@ -0,0 +1,439 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "BCSRMatImpl.h"
+
+/*
+  Kernels for the interleaved complex storage mode.
+
+  Each scalar entry of the matrix and the vectors is a (real,
+  imaginary) pair of adjacent TacsScalar values, so a block occupies
+  2*bsize*bsize values and the vector entry for block row i starts at
+  2*bsize*i. The kernels perform the complex arithmetic on the pairs
+  directly, so a complex system - the dynamic stiffness matrix of a
+  harmonic response, for example - can be solved through the real
+  build without assembling the doubled real-equivalent system. Both
+  lanes of each entry are read together with unit stride, which halves
+  the memory traffic of the doubled system and vectorizes cleanly.
+
+  The factorization is the same in-place block LU used by
+  BCSRMatFactor, with the diagonal slot storing the inverse of the
+  diagonal factor.
+*/
+
+/*
+  Compute y += A*x for a single paired block
+*/
+static void BCSRComplexBlockMultAdd(const int bsize, const TacsScalar *a,
+                                    const TacsScalar *x, TacsScalar *y) {
+  for (int m = 0; m < bsize; m++) {
+    TacsScalar yre = 0.0, yim = 0.0;
+    const TacsScalar *am = &a[2 * bsize * m];
+    for (int n = 0; n < bsize; n++) {
+      yre += am[2 * n] * x[2 * n] - am[2 * n + 1] * x[2 * n + 1];
+      yim += am[2 * n] * x[2 * n + 1] + am[2 * n + 1] * x[2 * n];
+    }
+    y[2 * m] += yre;
+    y[2 * m + 1] += yim;
+  }
+}
+
+/*
+  Compute y -= A*x for a single paired block
+*/
+static void BCSRComplexBlockMultSub(const int bsize, const TacsScalar *a,
+                                    const TacsScalar *x, TacsScalar *y) {
+  for (int m = 0; m < bsize; m++) {
+    TacsScalar yre = 0.0, yim = 0.0;
+    const TacsScalar *am = &a[2 * bsize * m];
+    for (int n = 0; n < bsize; n++) {
+      yre += am[2 * n] * x[2 * n] - am[2 * n + 1] * x[2 * n + 1];
+      yim += am[2 * n] * x[2 * n + 1] + am[2 * n + 1] * x[2 * n];
+    }
+    y[2 * m] -= yre;
+    y[2 * m + 1] -= yim;
+  }
+}
+
+/*
+  Compute y += A^{T}*x for a single paired block. This is the
+  unconjugated transpose, matching the semantics of multTranspose.
+*/
+static void BCSRComplexBlockMultTransAdd(const int bsize, const TacsScalar *a,
+                                         const TacsScalar *x, TacsScalar *y) {
+  for (int m = 0; m < bsize; m++) {
+    const TacsScalar *am = &a[2 * bsize * m];
+    for (int n = 0; n < bsize; n++) {
+      y[2 * n] += am[2 * n] * x[2 * m] - am[2 * n + 1] * x[2 * m + 1];
+      y[2 * n + 1] += am[2 * n] * x[2 * m + 1] + am[2 * n + 1] * x[2 * m];
+    }
+  }
+}
+
+/*
+  Compute D = A*B for paired blocks
+*/
+static void BCSRComplexBlockMatMult(const int bsize, const TacsScalar *a,
+                                    const TacsScalar *b, TacsScalar *d) {
+  for (int m = 0; m < bsize; m++) {
+    const TacsScalar *am = &a[2 * bsize * m];
+    TacsScalar *dm = &d[2 * bsize * m];
+    for (int n = 0; n < bsize; n++) {
+      TacsScalar dre = 0.0, dim = 0.0;
+      for (int l = 0; l < bsize; l++) {
+        const TacsScalar *bl = &b[2 * (bsize * l + n)];
+        dre += am[2 * l] * bl[0] - am[2 * l + 1] * bl[1];
+        dim += am[2 * l] * bl[1] + am[2 * l + 1] * bl[0];
+      }
+      dm[2 * n] = dre;
+      dm[2 * n + 1] = dim;
+    }
+  }
+}
+
+/*
+  Compute C -= A*B for paired blocks
+*/
+static void BCSRComplexBlockMatMultSub(const int bsize, const TacsScalar *a,
+                                       const TacsScalar *b, TacsScalar *c) {
+  for (int m = 0; m < bsize; m++) {
+    const TacsScalar *am = &a[2 * bsize * m];
+    TacsScalar *cm = &c[2 * bsize * m];
+    for (int n = 0; n < bsize; n++) {
+      TacsScalar cre = 0.0, cim = 0.0;
+      for (int l = 0; l < bsize; l++) {
+        const TacsScalar *bl = &b[2 * (bsize * l + n)];
+        cre += am[2 * l] * bl[0] - am[2 * l + 1] * bl[1];
+        cim += am[2 * l] * bl[1] + am[2 * l + 1] * bl[0];
+      }
+      cm[2 * n] -= cre;
+      cm[2 * n + 1] -= cim;
+    }
+  }
+}
+
+/*
+  Invert a paired block in place by Gauss--Jordan elimination with
+  partial pivoting on the complex magnitude. The work array must hold
+  2*bsize*bsize values. Returns zero on success, or the offending
+  row plus one if a pivot vanishes.
+*/
+static int BCSRComplexBlockInverse(const int bsize, TacsScalar *a,
+                                   TacsScalar *w) {
+  const int pb = 2 * bsize;
+
+  // Copy the block into the work array and set a to the identity
+  memcpy(w, a, pb * bsize * sizeof(TacsScalar));
+  memset(a, 0, pb * bsize * sizeof(TacsScalar));
+  for (int m = 0; m < bsize; m++) {
+    a[pb * m + 2 * m] = 1.0;
+  }
+
+  for (int k = 0; k < bsize; k++) {
+    // Select the pivot row by the largest complex magnitude
+    int piv = k;
+    double pmag = TacsRealPart(w[pb * k + 2 * k] * w[pb * k + 2 * k] +
+                               w[pb * k + 2 * k + 1] * w[pb * k + 2 * k + 1]);
+    for (int m = k + 1; m < bsize; m++) {
+      double t = TacsRealPart(w[pb * m + 2 * k] * w[pb * m + 2 * k] +
+                              w[pb * m + 2 * k + 1] * w[pb * m + 2 * k + 1]);
+      if (t > pmag) {
+        pmag = t;
+        piv = m;
+      }
+    }
+    if (pmag == 0.0) {
+      return k + 1;
+    }
+
+    if (piv != k) {
+      for (int n = 0; n < pb; n++) {
+        TacsScalar t = w[pb * k + n];
+        w[pb * k + n] = w[pb * piv + n];
+        w[pb * piv + n] = t;
+        t = a[pb * k + n];
+        a[pb * k + n] = a[pb * piv + n];
+        a[pb * piv + n] = t;
+      }
+    }
+
+    // Scale the pivot row by the inverse of the pivot
+    TacsScalar pre = w[pb * k + 2 * k];
+    TacsScalar pim = w[pb * k + 2 * k + 1];
+    TacsScalar den = pre * pre + pim * pim;
+    TacsScalar ire = pre / den;
+    TacsScalar iim = -pim / den;
+    for (int n = 0; n < bsize; n++) {
+      TacsScalar tre = w[pb * k + 2 * n], tim = w[pb * k + 2 * n + 1];
+      w[pb * k + 2 * n] = tre * ire - tim * iim;
+      w[pb * k + 2 * n + 1] = tre * iim + tim * ire;
+      tre = a[pb * k + 2 * n];
+      tim = a[pb * k + 2 * n + 1];
+      a[pb * k + 2 * n] = tre * ire - tim * iim;
+      a[pb * k + 2 * n + 1] = tre * iim + tim * ire;
+    }
+
+    // Eliminate the pivot column from the other rows
+    for (int m = 0; m < bsize; m++) {
+      if (m == k) {
+        continue;
+      }
+      TacsScalar fre = w[pb * m + 2 * k];
+      TacsScalar fim = w[pb * m + 2 * k + 1];
+      for (int n = 0; n < bsize; n++) {
+        w[pb * m + 2 * n] -=
+            fre * w[pb * k + 2 * n] - fim * w[pb * k + 2 * n + 1];
+        w[pb * m + 2 * n + 1] -=
+            fre * w[pb * k + 2 * n + 1] + fim * w[pb * k + 2 * n];
+        a[pb * m + 2 * n] -=
+            fre * a[pb * k + 2 * n] - fim * a[pb * k + 2 * n + 1];
+        a[pb * m + 2 * n + 1] -=
+            fre * a[pb * k + 2 * n + 1] + fim * a[pb * k + 2 * n];
+      }
+    }
+  }
+
+  return 0;
+}
+
+/*!
+  Compute the interleaved complex product y = A*x
+*/
+void BCSRMatVecMultComplex(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int bsize = data->bsize;
+  const int pb2 = 2 * bsize * bsize;
+
+  memset(y, 0, 2 * bsize * nrows * sizeof(TacsScalar));
+
+  for (int i = 0; i < nrows; i++) {
+    TacsScalar *yi = &y[2 * bsize * i];
+    int end = rowp[i + 1];
+    const TacsScalar *a = &data->A[pb2 * rowp[i]];
+    for (int j = rowp[i]; j < end; j++) {
+      BCSRComplexBlockMultAdd(bsize, a, &x[2 * bsize * cols[j]], yi);
+      a += pb2;
+    }
+  }
+}
+
+/*!
+  Compute the interleaved complex product y = A*x + z
+*/
+void BCSRMatVecMultAddComplex(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
+                              TacsScalar *z) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int bsize = data->bsize;
+  const int pb2 = 2 * bsize * bsize;
+
+  if (z != y) {
+    memcpy(y, z, 2 * bsize * nrows * sizeof(TacsScalar));
+  }
+
+  for (int i = 0; i < nrows; i++) {
+    TacsScalar *yi = &y[2 * bsize * i];
+    int end = rowp[i + 1];
+    const TacsScalar *a = &data->A[pb2 * rowp[i]];
+    for (int j = rowp[i]; j < end; j++) {
+      BCSRComplexBlockMultAdd(bsize, a, &x[2 * bsize * cols[j]], yi);
+      a += pb2;
+    }
+  }
+}
+
+/*!
+  Compute the interleaved complex product Y = A*X for multiple
+  right-hand sides, packed by block row as in multRHS
+*/
+void BCSRMatVecMultRHSComplex(BCSRMatData *data, int nrhs, TacsScalar *x,
+                              TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int bsize = data->bsize;
+  const int pb2 = 2 * bsize * bsize;
+
+  memset(y, 0, 2 * bsize * nrhs * nrows * sizeof(TacsScalar));
+
+  for (int i = 0; i < nrows; i++) {
+    TacsScalar *yi = &y[2 * bsize * nrhs * i];
+    int end = rowp[i + 1];
+    const TacsScalar *a = &data->A[pb2 * rowp[i]];
+    for (int j = rowp[i]; j < end; j++) {
+      const TacsScalar *xj = &x[2 * bsize * nrhs * cols[j]];
+      for (int r = 0; r < nrhs; r++) {
+        BCSRComplexBlockMultAdd(bsize, a, &xj[2 * bsize * r],
+                                &yi[2 * bsize * r]);
+      }
+      a += pb2;
+    }
+  }
+}
+
+/*!
+  Compute the interleaved complex product y = A^{T}*x. This is the
+  unconjugated transpose product.
+*/
+void BCSRMatVecMultTransComplex(BCSRMatData *data, TacsScalar *x,
+                                TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int ncols = data->ncols;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int bsize = data->bsize;
+  const int pb2 = 2 * bsize * bsize;
+
+  // The multTranspose wrapper only zeroes the unpaired length
+  memset(y, 0, 2 * bsize * ncols * sizeof(TacsScalar));
+
+  for (int i = 0; i < nrows; i++) {
+    const TacsScalar *xi = &x[2 * bsize * i];
+    int end = rowp[i + 1];
+    const TacsScalar *a = &data->A[pb2 * rowp[i]];
+    for (int j = rowp[i]; j < end; j++) {
+      BCSRComplexBlockMultTransAdd(bsize, a, xi, &y[2 * bsize * cols[j]]);
+      a += pb2;
+    }
+  }
+}
+
+/*!
+  Perform the in-place block LU factorization of the interleaved
+  complex matrix on the existing non-zero pattern. As in
+  BCSRMatFactor, the diagonal slot stores the inverse of the diagonal
+  factor.
+*/
+void BCSRMatFactorComplex(BCSRMatData *data) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  const int bsize = data->bsize;
+  const int pb2 = 2 * bsize * bsize;
+  TacsScalar *A = data->A;
+
+  TacsScalar *D = new TacsScalar[pb2];
+
+  for (int i = 0; i < nrows; i++) {
+    if (diag[i] < 0) {
+      fprintf(stderr, "Error in factorization: no diagonal entry for row %d\n",
+              i);
+      delete[] D;
+      return;
+    }
+
+    // Scan from the first entry in the current row towards the diagonal
+    int row_end = rowp[i + 1];
+    for (int j = rowp[i]; j < row_end && cols[j] < i; j++) {
+      int cj = cols[j];
+
+      // D = A[j] * inv(A[diag[cj]])
+      BCSRComplexBlockMatMult(bsize, &A[pb2 * j], &A[pb2 * diag[cj]], D);
+
+      // Subtract D times row cj past the diagonal from the matching
+      // entries of this row
+      int k = j + 1;
+      int end = rowp[cj + 1];
+      for (int p = diag[cj] + 1; (p < end) && (k < row_end); p++) {
+        while (k < row_end && cols[k] < cols[p]) {
+          k++;
+        }
+        if (k < row_end && cols[k] == cols[p]) {
+          BCSRComplexBlockMatMultSub(bsize, D, &A[pb2 * p], &A[pb2 * k]);
+        }
+      }
+
+      memcpy(&A[pb2 * j], D, pb2 * sizeof(TacsScalar));
+    }
+
+    // Invert the diagonal block
+    int fail = BCSRComplexBlockInverse(bsize, &A[pb2 * diag[i]], D);
+    if (fail != 0) {
+      fprintf(stderr,
+              "Failure in complex factorization of row %d, block row %d\n", i,
+              fail);
+    }
+  }
+
+  delete[] D;
+}
+
+/*!
+  Apply the lower factorization y = L^{-1} x for the interleaved
+  complex matrix
+*/
+void BCSRMatApplyLowerComplex(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  const int bsize = data->bsize;
+  const int pb2 = 2 * bsize * bsize;
+
+  for (int i = 0; i < nrows; i++) {
+    TacsScalar *yi = &y[2 * bsize * i];
+    if (x != y) {
+      memcpy(yi, &x[2 * bsize * i], 2 * bsize * sizeof(TacsScalar));
+    }
+
+    int end = diag[i];
+    const TacsScalar *a = &data->A[pb2 * rowp[i]];
+    for (int j = rowp[i]; j < end; j++) {
+      BCSRComplexBlockMultSub(bsize, a, &y[2 * bsize * cols[j]], yi);
+      a += pb2;
+    }
+  }
+}
+
+/*!
+  Apply the upper factorization y = U^{-1} x for the interleaved
+  complex matrix
+*/
+void BCSRMatApplyUpperComplex(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  const int bsize = data->bsize;
+  const int pb2 = 2 * bsize * bsize;
+
+  TacsScalar *ty = new TacsScalar[2 * bsize];
+
+  for (int i = nrows - 1; i >= 0; i--) {
+    memcpy(ty, &x[2 * bsize * i], 2 * bsize * sizeof(TacsScalar));
+
+    int end = rowp[i + 1];
+    const TacsScalar *adiag = &data->A[pb2 * diag[i]];
+    const TacsScalar *a = adiag + pb2;
+    for (int j = diag[i] + 1; j < end; j++) {
+      BCSRComplexBlockMultSub(bsize, a, &y[2 * bsize * cols[j]], ty);
+      a += pb2;
+    }
+
+    // Multiply by the stored inverse of the diagonal factor
+    TacsScalar *yi = &y[2 * bsize * i];
+    memset(yi, 0, 2 * bsize * sizeof(TacsScalar));
+    BCSRComplexBlockMultAdd(bsize, adiag, ty, yi);
+  }
+
+  delete[] ty;
+}
@@ -16,18 +16,79 @@
   http://www.apache.org/licenses/LICENSE-2.0
 */
 
+#include <math.h>
+
 #include "BCSRMatImpl.h"
+#include "tacslapack.h"
 
 /*
   Implementation of general block code
 */
 
+/*!
+  Detect the supernodes within the non-zero pattern of the matrix.
+
+  A supernode is a group of consecutive rows that share an identical
+  non-zero pattern beyond the diagonal: row r+1 belongs to the same
+  supernode as row r if the column pattern of row r past its diagonal
+  matches the column pattern of row r+1 from its diagonal onwards.
+  Supernodes are common after a fill-reducing ordering and allow the
+  elimination updates to be aggregated into dense panel operations.
+
+  On output snode[r] is the last row of the supernode containing row r.
+*/
+static void BCSRMatDetectSupernodes(BCSRMatData* data, int* snode) {
+  const int nrows = data->nrows;
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const int* diag = data->diag;
+
+  int start = 0;
+  while (start < nrows) {
+    int end = start;
+    while (end + 1 < nrows && diag[end] >= 0 && diag[end + 1] >= 0) {
+      // The number of entries past the diagonal in row end
+      int len = rowp[end + 1] - diag[end] - 1;
+      if (len != rowp[end + 2] - diag[end + 1]) {
+        break;
+      }
+
+      // Check that the patterns match column-by-column
+      const int* c1 = &cols[diag[end] + 1];
+      const int* c2 = &cols[diag[end + 1]];
+      int match = 1;
+      for (int t = 0; t < len; t++) {
+        if (c1[t] != c2[t]) {
+          match = 0;
+          break;
+        }
+      }
+      if (!match) {
+        break;
+      }
+      end++;
+    }
+
+    for (int r = start; r <= end; r++) {
+      snode[r] = end;
+    }
+    start = end + 1;
+  }
+}
+
 /*!
   Perform an ILU factorization of the matrix using the existing
   non-zero pattern. The entries are over-written and all operations
   are performed in place. This is for an arbitrary block size.
-*/
 
+  When several consecutive entries below the diagonal of the current
+  row fall within a single supernode, the elimination updates from
+  those columns are aggregated: the corresponding row of L is formed
+  with a small dense triangular sweep, the matching rows of U are
+  packed into a dense panel and the trailing update is applied with a
+  single GEMM call rather than one small matrix-matrix product per
+  block. Single-column updates fall back to the block-by-block code.
+*/
 void BCSRMatFactor(BCSRMatData* data) {
   // Retrieve the data required from the matrix
   const int nrows = data->nrows;
@@ -41,6 +102,33 @@ void BCSRMatFactor(BCSRMatData* data) {
   TacsScalar* D = new TacsScalar[bsize * bsize];
   int* ipiv = new int[bsize];
 
+  // Detect the supernodes in the non-zero pattern
+  int* snode = new int[nrows];
+  BCSRMatDetectSupernodes(data, snode);
+
+  // Compute the maximum supernode width and the maximum number of
+  // entries past the diagonal to size the panel buffers
+  int max_width = 1, max_trail = 0;
+  for (int i = 0; i < nrows; i++) {
+    if (snode[i] - i + 1 > max_width) {
+      max_width = snode[i] - i + 1;
+    }
+    if (diag[i] >= 0 && rowp[i + 1] - diag[i] - 1 > max_trail) {
+      max_trail = rowp[i + 1] - diag[i] - 1;
+    }
+  }
+
+  // Allocate the panel buffers: Dp stores the blocks of the L row,
+  // Dpane/Vp/R store the L row, the U panel and the trailing update
+  // as dense row-major matrices
+  TacsScalar *Dp = NULL, *Dpane = NULL, *Vp = NULL, *R = NULL;
+  if (max_width > 1) {
+    Dp = new TacsScalar[max_width * b2];
+    Dpane = new TacsScalar[max_width * b2];
+    Vp = new TacsScalar[max_width * max_trail * b2];
+    R = new TacsScalar[max_trail * b2];
+  }
+
   for (int i = 0; i < nrows; i++) {
     // variable = i
     if (diag[i] < 0) {
@@ -52,54 +140,175 @@ void BCSRMatFactor(BCSRMatData* data) {
     // Scan from the first entry in the current row, towards the diagonal
     int row_end = rowp[i + 1];
 
-    for (int j = rowp[i]; cols[j] < i; j++) {
+    int j = rowp[i];
+    while (j < row_end && cols[j] < i) {
       int cj = cols[j];
-      TacsScalar* a = &A[b2 * j];
-      TacsScalar* b = &A[b2 * diag[cj]];
 
-      // D = A[cj] * A[diag[cj]]
-      for (int n = 0; n < bsize; n++) {
-        for (int m = 0; m < bsize; m++) {
-          D[n * bsize + m] = 0.0;
-          for (int l = 0; l < bsize; l++) {
-            D[n * bsize + m] += a[n * bsize + l] * b[l * bsize + m];
-          }
-        }
+      // Find the run of consecutive columns within the same supernode
+      // that are all present in this row
+      int last = snode[cj];
+      if (last > i - 1) {
+        last = i - 1;
+      }
+      int len = 1;
+      while (cj + len <= last && j + len < row_end &&
+             cols[j + len] == cj + len) {
+        len++;
       }
 
-      // Scan through the remainder of the row
-      int k = j + 1;
+      if (len > 1) {
+        // Aggregate the updates from columns cj through cj + len - 1.
+        // First compute the blocks of the L row: each block receives
+        // the updates from the preceding columns in the run, since the
+        // supernode diagonal region is dense
+        for (int q = 0; q < len; q++) {
+          TacsScalar* dq = &Dp[b2 * q];
+          TacsScalar* a = &A[b2 * (j + q)];
+          for (int n = 0; n < b2; n++) {
+            dq[n] = a[n];
+          }
+
+          for (int t = 0; t < q; t++) {
+            const TacsScalar* dt = &Dp[b2 * t];
+            const TacsScalar* b = &A[b2 * (diag[cj + t] + (q - t))];
+            for (int n = 0; n < bsize; n++) {
+              int nb = n * bsize;
+              for (int m = 0; m < bsize; m++) {
+                for (int l = 0; l < bsize; l++) {
+                  dq[nb + m] -= dt[nb + l] * b[l * bsize + m];
+                }
+              }
+            }
+          }
 
-      // The final entry for row: cols[j]
-      int end = rowp[cj + 1];
+          // Multiply by the (inverted) diagonal: dq = dq * A[diag[cj + q]]
+          const TacsScalar* binv = &A[b2 * diag[cj + q]];
+          for (int n = 0; n < b2; n++) {
+            D[n] = dq[n];
+          }
+          for (int n = 0; n < bsize; n++) {
+            for (int m = 0; m < bsize; m++) {
+              dq[n * bsize + m] = 0.0;
+              for (int l = 0; l < bsize; l++) {
+                dq[n * bsize + m] += D[n * bsize + l] * binv[l * bsize + m];
+              }
+            }
+          }
 
-      // Now, scan through row cj starting at the first entry past the diagonal
-      for (int p = diag[cj] + 1; (p < end) && (k < row_end); p++) {
-        // Determine where the two rows have the same elements
-        while (k < row_end && cols[k] < cols[p]) {
-          k++;
+          // Store the computed block of L back into the matrix
+          for (int n = 0; n < b2; n++) {
+            a[n] = dq[n];
+          }
         }
 
-        // A[k] = A[k] - A[j] * A[p]
-        if (k < row_end && cols[k] == cols[p]) {
-          a = &A[b2 * k];
-          b = &A[b2 * p];
+        // The trailing pattern is shared by all of the rows in the
+        // run: it consists of the entries of row ce past the run
+        int ce = cj + len - 1;
+        int ntrail = rowp[ce + 1] - diag[ce] - 1;
 
-          for (int n = 0; n < bsize; n++) {
-            int nb = n * bsize;
-            for (int m = 0; m < bsize; m++) {
+        if (ntrail > 0) {
+          const int K = len * bsize;
+          const int W = ntrail * bsize;
+
+          // Pack the L row as a bsize x K row-major matrix
+          for (int q = 0; q < len; q++) {
+            for (int n = 0; n < bsize; n++) {
+              memcpy(&Dpane[n * K + q * bsize], &Dp[b2 * q + n * bsize],
+                     bsize * sizeof(TacsScalar));
+            }
+          }
+
+          // Pack the U panel as a K x W row-major matrix. The entries
+          // of each row past the end of the run are contiguous
+          for (int q = 0; q < len; q++) {
+            const TacsScalar* useg = &A[b2 * (diag[cj + q] + (ce - cj - q) + 1)];
+            for (int t = 0; t < ntrail; t++) {
               for (int l = 0; l < bsize; l++) {
-                a[nb + m] -= D[nb + l] * b[l * bsize + m];
+                memcpy(&Vp[(q * bsize + l) * W + t * bsize],
+                       &useg[b2 * t + l * bsize], bsize * sizeof(TacsScalar));
+              }
+            }
+          }
+
+          // Compute the trailing update R = Dpane * Vp with a single
+          // GEMM. The row-major matrices are passed as their
+          // column-major transposes: R^{T} = Vp^{T} * Dpane^{T}
+          int m = W, n = bsize, k = K;
+          TacsScalar alpha = 1.0, beta = 0.0;
+          BLASgemm("N", "N", &m, &n, &k, &alpha, Vp, &m, Dpane, &k, &beta, R,
+                   &m);
+
+          // Subtract the update from the matching entries of this row
+          const int* tcols = &cols[diag[ce] + 1];
+          int k2 = j + len;
+          for (int t = 0; t < ntrail && k2 < row_end; t++) {
+            while (k2 < row_end && cols[k2] < tcols[t]) {
+              k2++;
+            }
+
+            if (k2 < row_end && cols[k2] == tcols[t]) {
+              TacsScalar* a = &A[b2 * k2];
+              for (int n2 = 0; n2 < bsize; n2++) {
+                for (int m2 = 0; m2 < bsize; m2++) {
+                  a[n2 * bsize + m2] -= R[n2 * W + t * bsize + m2];
+                }
               }
             }
           }
         }
-      }
 
-      // Copy over the matrix
-      a = &A[b2 * j];
-      for (int n = 0; n < b2; n++) {
-        a[n] = D[n];
+        j += len;
+      } else {
+        TacsScalar* a = &A[b2 * j];
+        TacsScalar* b = &A[b2 * diag[cj]];
+
+        // D = A[cj] * A[diag[cj]]
+        for (int n = 0; n < bsize; n++) {
+          for (int m = 0; m < bsize; m++) {
+            D[n * bsize + m] = 0.0;
+            for (int l = 0; l < bsize; l++) {
+              D[n * bsize + m] += a[n * bsize + l] * b[l * bsize + m];
+            }
+          }
+        }
+
+        // Scan through the remainder of the row
+        int k = j + 1;
+
+        // The final entry for row: cols[j]
+        int end = rowp[cj + 1];
+
+        // Now, scan through row cj starting at the first entry past the
+        // diagonal
+        for (int p = diag[cj] + 1; (p < end) && (k < row_end); p++) {
+          // Determine where the two rows have the same elements
+          while (k < row_end && cols[k] < cols[p]) {
+            k++;
+          }
+
+          // A[k] = A[k] - A[j] * A[p]
+          if (k < row_end && cols[k] == cols[p]) {
+            a = &A[b2 * k];
+            b = &A[b2 * p];
+
+            for (int n = 0; n < bsize; n++) {
+              int nb = n * bsize;
+              for (int m = 0; m < bsize; m++) {
+                for (int l = 0; l < bsize; l++) {
+                  a[nb + m] -= D[nb + l] * b[l * bsize + m];
+                }
+              }
+            }
+          }
+        }
+
+        // Copy over the matrix
+        a = &A[b2 * j];
+        for (int n = 0; n < b2; n++) {
+          a[n] = D[n];
+        }
+
+        j++;
       }
     }
 
@@ -116,10 +325,308 @@ void BCSRMatFactor(BCSRMatData* data) {
     }
   }
 
+  if (Dp) {
+    delete[] Dp;
+    delete[] Dpane;
+    delete[] Vp;
+    delete[] R;
+  }
+  delete[] snode;
   delete[] D;
   delete[] ipiv;
 }
 
+/*
+  Compute the Frobenius norm of a block. For complex arithmetic only
+  the real parts are compared - the values are used to make dropping
+  decisions, not in the factorization itself.
+*/
+static double BCSRMatBlockNorm(const TacsScalar* a, int b2) {
+  double s = 0.0;
+  for (int n = 0; n < b2; n++) {
+    double t = TacsRealPart(a[n]);
+    s += t * t;
+  }
+  return sqrt(s);
+}
+
+/*!
+  Compute a threshold-based ILUT factorization of the matrix.
+
+  This uses the dual dropping strategy: a block is dropped when its
+  Frobenius norm falls below tol times the average block norm of its
+  row, and at most maxfill blocks are kept in the strictly lower and
+  in the strictly upper part of each row (the diagonal block is always
+  kept). The non-zero pattern of the factorization is therefore
+  determined by the matrix values, not by a symbolic analysis, and
+  changing tol/maxfill only requires re-running this factorization.
+
+  The input matrix is not modified. New rowp/cols/A arrays holding the
+  factorization are returned through the output arguments. The storage
+  convention of the factor matches BCSRMatFactor(): the rows of L are
+  stored multiplied by the inverted diagonal of their column, the
+  diagonal blocks are stored inverted, and the rows of U are stored
+  as-is, so the factorization can be applied with the existing
+  triangular solve kernels.
+
+  input:
+  data:        the matrix to factor - the values are left unchanged
+  tol:         the relative drop tolerance
+  maxfill:     the maximum number of blocks kept per row in L and in U
+  diag_shift:  value added to the scalar diagonal before factoring
+
+  output:
+  _rowp, _cols, _A:  the new factorization in BCSR format
+*/
+void BCSRMatFactorILUT(BCSRMatData* data, double tol, int maxfill,
+                       TacsScalar diag_shift, int** _rowp, int** _cols,
+                       TacsScalar** _A) {
+  const int nrows = data->nrows;
+  const int* arowp = data->rowp;
+  const int* acols = data->cols;
+  const int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+  const TacsScalar* Ain = data->A;
+
+  if (maxfill < 1) {
+    maxfill = 1;
+  }
+
+  // Each row keeps at most maxfill blocks on either side of the
+  // diagonal, which bounds the size of the output exactly
+  int max_row_size = 2 * maxfill + 1;
+  int* rowp = new int[nrows + 1];
+  int* cols = new int[nrows * max_row_size];
+  TacsScalar* A = new TacsScalar[nrows * max_row_size * b2];
+
+  // The location of the diagonal in the completed rows of the factor
+  int* fdiag = new int[nrows];
+
+  // Dense scatter workspace for the blocks of the current row
+  TacsScalar* w = new TacsScalar[nrows * b2];
+  memset(w, 0, nrows * b2 * sizeof(TacsScalar));
+
+  // marker[j] >= 0 iff column j is present in the current row;
+  // flag[j] marks the columns that have been eliminated
+  int* marker = new int[nrows];
+  int* flag = new int[nrows];
+  for (int j = 0; j < nrows; j++) {
+    marker[j] = -1;
+    flag[j] = 0;
+  }
+
+  // The list of non-zero columns in the current row
+  int* rlist = new int[nrows];
+
+  // Scratch for the candidate selection and the diagonal inverse
+  int* cand = new int[nrows];
+  double* cnorm = new double[nrows];
+  TacsScalar* T = new TacsScalar[b2];
+  TacsScalar* D = new TacsScalar[b2];
+  int* ipiv = new int[bsize];
+
+  rowp[0] = 0;
+
+  for (int i = 0; i < nrows; i++) {
+    // Scatter the blocks of row i into the dense workspace
+    int nr = 0;
+    double sum_norm = 0.0;
+    for (int jp = arowp[i]; jp < arowp[i + 1]; jp++) {
+      int j = acols[jp];
+      memcpy(&w[b2 * j], &Ain[b2 * jp], b2 * sizeof(TacsScalar));
+      marker[j] = nr;
+      rlist[nr] = j;
+      nr++;
+      sum_norm += BCSRMatBlockNorm(&Ain[b2 * jp], b2);
+    }
+
+    // Add the diagonal entry if it is not present in the pattern
+    if (marker[i] < 0) {
+      marker[i] = nr;
+      rlist[nr] = i;
+      nr++;
+    }
+
+    // Add the diagonal shift
+    if (diag_shift != TacsScalar(0.0)) {
+      for (int n = 0; n < bsize; n++) {
+        w[b2 * i + (bsize + 1) * n] += diag_shift;
+      }
+    }
+
+    // Set the absolute drop tolerance for this row from the average
+    // block norm of the assembled row
+    double drop_tol = 0.0;
+    if (arowp[i + 1] > arowp[i]) {
+      drop_tol = tol * sum_norm / (arowp[i + 1] - arowp[i]);
+    }
+
+    // Eliminate the entries below the diagonal in ascending column
+    // order. The updates introduce new entries that may themselves
+    // fall below the diagonal, so the smallest uneliminated column is
+    // selected on each pass.
+    for (;;) {
+      int cj = i;
+      for (int p = 0; p < nr; p++) {
+        if (rlist[p] < cj && !flag[rlist[p]]) {
+          cj = rlist[p];
+        }
+      }
+      if (cj == i) {
+        break;
+      }
+      flag[cj] = 1;
+
+      // Compute the block of L: T = w[cj] * inv(D[cj]). The diagonal
+      // blocks of the completed rows are stored inverted.
+      const TacsScalar* binv = &A[b2 * fdiag[cj]];
+      TacsScalar* wj = &w[b2 * cj];
+      for (int n = 0; n < bsize; n++) {
+        for (int m = 0; m < bsize; m++) {
+          T[n * bsize + m] = 0.0;
+          for (int l = 0; l < bsize; l++) {
+            T[n * bsize + m] += wj[n * bsize + l] * binv[l * bsize + m];
+          }
+        }
+      }
+
+      // First dropping test: a small block of L is discarded before
+      // its update is applied to the remainder of the row
+      if (BCSRMatBlockNorm(T, b2) < drop_tol) {
+        memset(wj, 0, b2 * sizeof(TacsScalar));
+        continue;
+      }
+      memcpy(wj, T, b2 * sizeof(TacsScalar));
+
+      // Apply the update from the upper part of the factored row cj:
+      // w[k] = w[k] - T * U[cj, k]
+      int p_end = rowp[cj + 1];
+      for (int p = fdiag[cj] + 1; p < p_end; p++) {
+        int k = cols[p];
+        TacsScalar* wk = &w[b2 * k];
+        if (marker[k] < 0) {
+          // The entry is new - it was zeroed when the previous row
+          // was cleaned up
+          marker[k] = nr;
+          rlist[nr] = k;
+          flag[k] = 0;
+          nr++;
+        }
+
+        const TacsScalar* b = &A[b2 * p];
+        for (int n = 0; n < bsize; n++) {
+          int nb = n * bsize;
+          for (int m = 0; m < bsize; m++) {
+            for (int l = 0; l < bsize; l++) {
+              wk[nb + m] -= T[nb + l] * b[l * bsize + m];
+            }
+          }
+        }
+      }
+    }
+
+    // Select the entries to keep: at most maxfill blocks in the
+    // strictly lower part and maxfill blocks in the strictly upper
+    // part, dropping any block below the row tolerance
+    int row_start = rowp[i];
+    int nkeep = 0;
+
+    for (int side = 0; side < 2; side++) {
+      // Gather the candidates for this side of the diagonal
+      int ncand = 0;
+      for (int p = 0; p < nr; p++) {
+        int j = rlist[p];
+        if ((side == 0 && j < i) || (side == 1 && j > i)) {
+          double nrm = BCSRMatBlockNorm(&w[b2 * j], b2);
+          if (nrm >= drop_tol && nrm > 0.0) {
+            cand[ncand] = j;
+            cnorm[ncand] = nrm;
+            ncand++;
+          }
+        }
+      }
+
+      // Select the maxfill largest candidates
+      int nsel = (ncand < maxfill ? ncand : maxfill);
+      for (int q = 0; q < nsel; q++) {
+        int best = q;
+        for (int p = q + 1; p < ncand; p++) {
+          if (cnorm[p] > cnorm[best]) {
+            best = p;
+          }
+        }
+        int tc = cand[q];
+        double tn = cnorm[q];
+        cand[q] = cand[best];
+        cnorm[q] = cnorm[best];
+        cand[best] = tc;
+        cnorm[best] = tn;
+      }
+
+      // Sort the selected columns into ascending order
+      for (int q = 1; q < nsel; q++) {
+        int c = cand[q];
+        int p = q - 1;
+        while (p >= 0 && cand[p] > c) {
+          cand[p + 1] = cand[p];
+          p--;
+        }
+        cand[p + 1] = c;
+      }
+
+      // The diagonal block goes between the lower and upper entries
+      if (side == 1) {
+        fdiag[i] = row_start + nkeep;
+        cols[row_start + nkeep] = i;
+        memcpy(&A[b2 * (row_start + nkeep)], &w[b2 * i],
+               b2 * sizeof(TacsScalar));
+        nkeep++;
+      }
+
+      for (int q = 0; q < nsel; q++) {
+        cols[row_start + nkeep] = cand[q];
+        memcpy(&A[b2 * (row_start + nkeep)], &w[b2 * cand[q]],
+               b2 * sizeof(TacsScalar));
+        nkeep++;
+      }
+    }
+
+    rowp[i + 1] = row_start + nkeep;
+
+    // Invert the diagonal block of the completed row
+    TacsScalar* a = &A[b2 * fdiag[i]];
+    memcpy(D, a, b2 * sizeof(TacsScalar));
+    int fail = BMatComputeInverse(a, D, ipiv, bsize);
+    if (fail != 0) {
+      fprintf(stderr, "Failure in factorization of row %d, block row %d\n", i,
+              fail);
+    }
+
+    // Clean up the workspace for the next row
+    for (int p = 0; p < nr; p++) {
+      int j = rlist[p];
+      memset(&w[b2 * j], 0, b2 * sizeof(TacsScalar));
+      marker[j] = -1;
+      flag[j] = 0;
+    }
+  }
+
+  delete[] fdiag;
+  delete[] w;
+  delete[] marker;
+  delete[] flag;
+  delete[] rlist;
+  delete[] cand;
+  delete[] cnorm;
+  delete[] T;
+  delete[] D;
+  delete[] ipiv;
+
+  *_rowp = rowp;
+  *_cols = cols;
+  *_A = A;
+}
+
 /*!
   Compute x = L_{B}^{-1} E
 */
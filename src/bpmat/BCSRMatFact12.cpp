@@ -0,0 +1,263 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "BCSRMatImpl.h"
+
+/*
+  Block size = 12 code
+
+  These kernels use fixed trip-count loops rather than the fully
+  unrolled style of the smaller block sizes. With the block dimension
+  known at compile time the compiler unrolls and vectorizes the inner
+  loops, and the source remains manageable at this block size.
+*/
+
+/*!
+  Perform an ILU factorization of the matrix using the existing
+  non-zero pattern.  The entries are over-written, all operations are
+  performed in place.
+*/
+
+void BCSRMatFactor12(BCSRMatData* data) {
+  // Retrieve the data required from the matrix
+  const int nrows = data->nrows;
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const int* diag = data->diag;
+  TacsScalar* A = data->A;
+
+  TacsScalar d[144];
+
+  for (int i = 0; i < nrows; i++) {
+    // variable = i
+    if (diag[i] < 0) {
+      fprintf(stderr, "Error in factorization: no diagonal entry for row %d",
+              i);
+      return;
+    }
+
+    // Scan from the first entry in the current row, towards the diagonal
+    int row_end = rowp[i + 1];
+
+    for (int j = rowp[i]; cols[j] < i; j++) {
+      int cj = cols[j];
+      TacsScalar* a = &A[144 * j];
+      const TacsScalar* b = &A[144 * diag[cj]];
+
+      // Multiply d = A[j] * A[diag[cj]]
+      for (int n = 0; n < 12; n++) {
+        for (int m = 0; m < 12; m++) {
+          TacsScalar t = 0.0;
+          for (int q = 0; q < 12; q++) {
+            t += a[12 * n + q] * b[12 * q + m];
+          }
+          d[12 * n + m] = t;
+        }
+      }
+
+      // Scan through the remainder of the row
+      int k = j + 1;
+      int p = diag[cj] + 1;
+      a = &A[144 * k];
+      b = &A[144 * p];
+
+      // The final entry for row: cols[j]
+      int end = rowp[cj + 1];
+
+      // Now, scan through row cj starting at the first entry past the diagonal
+      for (; (p < end) && (k < row_end); p++) {
+        // Determine where the two rows have the same elements
+        while (k < row_end && cols[k] < cols[p]) {
+          k++;
+          a += 144;
+        }
+
+        // A[k] = A[k] - A[j] * A[p]
+        if (k < row_end && cols[k] == cols[p]) {
+          for (int n = 0; n < 12; n++) {
+            for (int m = 0; m < 12; m++) {
+              TacsScalar t = a[12 * n + m];
+              for (int q = 0; q < 12; q++) {
+                t -= d[12 * n + q] * b[12 * q + m];
+              }
+              a[12 * n + m] = t;
+            }
+          }
+        }
+        b += 144;
+      }
+
+      // Copy the matrix back into the row
+      a = &A[144 * j];
+      for (int n = 0; n < 144; n++) {
+        a[n] = d[n];
+      }
+    }
+
+    // Invert the diagonal portion of the matrix
+    TacsScalar D[144];
+    TacsScalar* a = &A[144 * diag[i]];
+    for (int n = 0; n < 144; n++) {
+      D[n] = a[n];
+    }
+
+    int ipiv[12];
+    int info = BMatComputeInverse(a, D, ipiv, 12);
+
+    if (info > 0) {
+      fprintf(stderr,
+              "Error during factorization of diagonal %d in block row %d \n",
+              i + 1, info);
+    }
+  }
+}
+
+/*!
+  Compute x = L_{B}^{-1} E
+*/
+
+void BCSRMatFactorLower12(BCSRMatData* data, BCSRMatData* Edata) {
+  // Retrieve the data required from the matrix
+  const int nrows = data->nrows;
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const int* diag = data->diag;
+  const TacsScalar* A = data->A;
+
+  // Retrieve the data required from the matrix
+  const int* erowp = Edata->rowp;
+  const int* ecols = Edata->cols;
+  TacsScalar* E = Edata->A;
+
+  for (int i = 0; i < nrows; i++) {
+    // Scan from the first entry in the current row, towards the diagonal
+    int j_end = diag[i];
+
+    for (int j = rowp[i]; j < j_end; j++) {
+      int cj = cols[j];
+      const TacsScalar* d = &A[144 * j];
+
+      int k = erowp[i];
+      int k_end = erowp[i + 1];
+      TacsScalar* a = &E[144 * k];
+
+      int p = erowp[cj];
+      int p_end = erowp[cj + 1];
+      const TacsScalar* b = &E[144 * p];
+
+      // Now, scan through row cj starting at the first entry past the diagonal
+      for (; (p < p_end) && (k < k_end); p++) {
+        // Determine where the two rows have the same elements
+        while (k < k_end && ecols[k] < ecols[p]) {
+          k++;
+          a += 144;
+        }
+
+        if (k < k_end && ecols[k] == ecols[p]) {
+          for (int n = 0; n < 12; n++) {
+            for (int m = 0; m < 12; m++) {
+              TacsScalar t = a[12 * n + m];
+              for (int q = 0; q < 12; q++) {
+                t -= d[12 * n + q] * b[12 * q + m];
+              }
+              a[12 * n + m] = t;
+            }
+          }
+        }
+        b += 144;
+      }
+    }
+  }
+}
+
+/*!
+  Compute x = F U_{B}^{-1}
+*/
+
+void BCSRMatFactorUpper12(BCSRMatData* data, BCSRMatData* Fdata) {
+  // Retrieve the data required from the matrix
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const int* diag = data->diag;
+  const TacsScalar* A = data->A;
+
+  // Retrieve the data required from the matrix
+  const int nrows_f = Fdata->nrows;
+  const int* frowp = Fdata->rowp;
+  const int* fcols = Fdata->cols;
+  TacsScalar* F = Fdata->A;
+
+  TacsScalar d[144];
+
+  for (int i = 0; i < nrows_f; i++) {
+    int j_end = frowp[i + 1];
+
+    for (int j = frowp[i]; j < j_end; j++) {
+      int cj = fcols[j];
+      TacsScalar* a = &F[144 * j];
+      const TacsScalar* b = &A[144 * diag[cj]];
+
+      // Multiply d = F[j] * A[diag[cj]]
+      for (int n = 0; n < 12; n++) {
+        for (int m = 0; m < 12; m++) {
+          TacsScalar t = 0.0;
+          for (int q = 0; q < 12; q++) {
+            t += a[12 * n + q] * b[12 * q + m];
+          }
+          d[12 * n + m] = t;
+        }
+      }
+
+      int k = j + 1;
+      int k_end = frowp[i + 1];
+      a = &F[144 * k];
+
+      int p = diag[cj] + 1;
+      int p_end = rowp[cj + 1];
+      b = &A[144 * p];
+
+      // Now, scan through row cj starting at the first entry past the diagonal
+      for (; (p < p_end) && (k < k_end); p++) {
+        // Determine where the two rows have the same elements
+        while (k < k_end && fcols[k] < cols[p]) {
+          k++;
+          a += 144;
+        }
+
+        if (k < k_end && fcols[k] == cols[p]) {
+          for (int n = 0; n < 12; n++) {
+            for (int m = 0; m < 12; m++) {
+              TacsScalar t = a[12 * n + m];
+              for (int q = 0; q < 12; q++) {
+                t -= d[12 * n + q] * b[12 * q + m];
+              }
+              a[12 * n + m] = t;
+            }
+          }
+        }
+        b += 144;
+      }
+
+      // Copy over the matrix
+      a = &F[144 * j];
+      for (int n = 0; n < 144; n++) {
+        a[n] = d[n];
+      }
+    }
+  }
+}
@@ -973,6 +973,13 @@ void BCSRMatFactor6(BCSRMatData *data) {
       TacsScalar *a = &(data->A[36 * j]);
       TacsScalar *b = &(data->A[36 * diag[cj]]);
 
+      // Start the fetch of the blocks of the next sub-diagonal entry
+      // while the current update is in flight
+      if (cols[j + 1] < i) {
+        TACS_BCSR_PREFETCH(&(data->A[36 * (j + 1)]));
+        TACS_BCSR_PREFETCH(&(data->A[36 * diag[cols[j + 1]]]));
+      }
+
       // Multiply d = A[j] * A[diag[cj]]
       TacsScalar b0, b1, b2, b3, b4, b5;
 
@@ -1104,6 +1111,12 @@ void BCSRMatFactor6(BCSRMatData *data) {
 
       // Now, scan through row cj starting at the first entry past the diagonal
       for (; (p < pend) && (k < kend); p++) {
+        // Prefetch the next block of row cj while this one is updated
+        if (p + 1 < pend) {
+          TACS_BCSR_PREFETCH(b + 36);
+          TACS_BCSR_PREFETCH(b + 52);
+        }
+
         // Determine where the two rows have the same elements
         while (k < kend && cols[k] < cols[p]) {
           k++;
@@ -1366,6 +1379,12 @@ void BCSRMatFactorLower6(BCSRMatData *data, BCSRMatData *Edata) {
       // Now, scan through row cj starting at the first entry past the
       // diagonal
       for (; (p < p_end) && (k < k_end); p++) {
+        // Prefetch the next block of row cj while this one is updated
+        if (p + 1 < p_end) {
+          TACS_BCSR_PREFETCH(b + 36);
+          TACS_BCSR_PREFETCH(b + 52);
+        }
+
         // Determine where the two rows have the same elements
         while (k < k_end && ecols[k] < ecols[p]) {
           k++;
@@ -1657,6 +1676,12 @@ void BCSRMatFactorUpper6(BCSRMatData *data, BCSRMatData *Fdata) {
 
       // Now, scan through row cj starting at the first entry past the diagonal
       for (; (p < p_end) && (k < k_end); p++) {
+        // Prefetch the next block of row cj while this one is updated
+        if (p + 1 < p_end) {
+          TACS_BCSR_PREFETCH(b + 36);
+          TACS_BCSR_PREFETCH(b + 52);
+        }
+
         // Determine where the two rows have the same elements
         while (k < k_end && fcols[k] < cols[p]) {
           k++;
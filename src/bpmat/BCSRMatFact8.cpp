@@ -1461,6 +1461,13 @@ void BCSRMatFactor8(BCSRMatData *data) {
       TacsScalar *a = &(data->A[64 * j]);
       TacsScalar *b = &(data->A[64 * diag[cj]]);
 
+      // Start the fetch of the blocks of the next sub-diagonal entry
+      // while the current update is in flight
+      if (cols[j + 1] < i) {
+        TACS_BCSR_PREFETCH(&(data->A[64 * (j + 1)]));
+        TACS_BCSR_PREFETCH(&(data->A[64 * diag[cols[j + 1]]]));
+      }
+
       // Multiply d = A[j] *A[diag[cj]]
       TacsScalar b0, b1, b2, b3, b4, b5, b6, b7;
 
@@ -1678,6 +1685,12 @@ void BCSRMatFactor8(BCSRMatData *data) {
 
       // Now, scan through row cj starting at the first entry past the diagonal
       for (; (p < pend) && (k < kend); p++) {
+        // Prefetch the next block of row cj while this one is updated
+        if (p + 1 < pend) {
+          TACS_BCSR_PREFETCH(b + 64);
+          TACS_BCSR_PREFETCH(b + 96);
+        }
+
         // Determine where the two rows have the same elements
         while (k < kend && cols[k] < cols[p]) {
           k++;
@@ -2066,6 +2079,12 @@ void BCSRMatFactorLower8(BCSRMatData *data, BCSRMatData *Edata) {
       // Now, scan through row cj starting at the first entry past the
       // diagonal
       for (; (p < p_end) && (k < k_end); p++) {
+        // Prefetch the next block of row cj while this one is updated
+        if (p + 1 < p_end) {
+          TACS_BCSR_PREFETCH(b + 64);
+          TACS_BCSR_PREFETCH(b + 96);
+        }
+
         // Determine where the two rows have the same elements
         while (k < k_end && ecols[k] < ecols[p]) {
           k++;
@@ -2531,6 +2550,12 @@ void BCSRMatFactorUpper8(BCSRMatData *data, BCSRMatData *Fdata) {
 
       // Now, scan through row cj starting at the first entry past the diagonal
       for (; (p < p_end) && (k < k_end); p++) {
+        // Prefetch the next block of row cj while this one is updated
+        if (p + 1 < p_end) {
+          TACS_BCSR_PREFETCH(b + 64);
+          TACS_BCSR_PREFETCH(b + 96);
+        }
+
         // Determine where the two rows have the same elements
         while (k < k_end && fcols[k] < cols[p]) {
           k++;
@@ -24,6 +24,31 @@
 */
 #include "TACSObject.h"
 
+/*
+  The reduced-precision scalar type used for the optional
+  single-precision storage of a factored preconditioner. The Krylov
+  iteration remains in full TacsScalar precision - values are
+  converted only at the applyFactor boundary.
+*/
+#ifdef TACS_USE_COMPLEX
+typedef std::complex<float> TacsSingleScalar;
+#else
+typedef float TacsSingleScalar;
+#endif
+
+/*
+  Read-prefetch hint for the latency-bound factorization loops. The
+  update targets of the next loop iteration are known from the index
+  arrays several iterations ahead, so the fetch of the next block can
+  be overlapped with the arithmetic of the current one. The hint
+  compiles to nothing on compilers without the builtin.
+*/
+#if defined(__GNUC__)
+#define TACS_BCSR_PREFETCH(ptr) __builtin_prefetch((ptr))
+#else
+#define TACS_BCSR_PREFETCH(ptr)
+#endif
+
 class BCSRMatData : public TACSObject {
  public:
   BCSRMatData(int _bsize, int _nrows, int _ncols);
@@ -43,6 +68,11 @@ class BCSRMatData : public TACSObject {
 
   // The storage space for each block - this can change
   TacsScalar *A;  // The vector of elements of each block
+
+  // Optional permutation from the pattern order of the blocks to
+  // their position in A, used by the Morton-ordered storage mode.
+  // NULL for the default row-major block layout.
+  int *bperm;
 };
 
 class BCSRMatThread : public TACSObject {
@@ -71,6 +101,15 @@ class BCSRMatThread : public TACSObject {
   void apply_upper_mark_completed(const int group_size, int index, int irow,
                                   int jstart, int jend);
 
+  // Level-set (wavefront) scheduler for the triangular solves of a
+  // factored matrix. Rows within a level have no mutual dependencies
+  // and may be processed concurrently; the levels themselves are
+  // processed in order.
+  void init_apply_lower_level_sched();
+  void init_apply_upper_level_sched();
+  void apply_level_sched_job(const int group_size, int *start, int *end);
+  void apply_level_mark_completed(const int count);
+
   pthread_t threads[TACSThreadInfo::TACS_MAX_NUM_THREADS];
 
   // The input/output when dealing with vectors
@@ -91,6 +130,19 @@ class BCSRMatThread : public TACSObject {
   int *assigned_row_index;   // The index of the fully assigned rows
   int *completed_row_index;  // The indices of the full assigned columns
 
+  // The level-set schedules for the lower/upper triangular solves.
+  // These depend only on the non-zero pattern and are computed once.
+  int num_lower_levels, num_upper_levels;
+  int *lower_level_ptr, *lower_level_rows;
+  int *upper_level_ptr, *upper_level_rows;
+
+  // The level schedule currently in use and its progress counters
+  int sched_num_levels;
+  const int *sched_level_ptr;
+  const int *sched_level_rows;
+  int current_level;   // The level currently being processed
+  int level_row_head;  // The next unassigned entry in sched_level_rows
+
   // The threaded implementation
   pthread_mutex_t mutex;
   pthread_cond_t cond;
@@ -107,16 +159,74 @@ void BCSRMatVecMult(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatVecMultAdd(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
                        TacsScalar *z);
 void BCSRMatVecMultTranspose(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultRHS(BCSRMatData *A, int nrhs, TacsScalar *x,
+                       TacsScalar *y);
 void BCSRMatFactor(BCSRMatData *A);
+void BCSRMatFactorILUT(BCSRMatData *A, double tol, int maxfill,
+                       TacsScalar diag_shift, int **_rowp, int **_cols,
+                       TacsScalar **_A);
 void BCSRMatApplyLower(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatApplyUpper(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 
+// Generic triangular solves on a single-precision copy of the factored
+// matrix. The non-zero pattern is taken from A, the values from Asp.
+void BCSRMatApplyLowerSP(BCSRMatData *A, const TacsSingleScalar *Asp,
+                         TacsSingleScalar *x, TacsSingleScalar *y);
+void BCSRMatApplyUpperSP(BCSRMatData *A, const TacsSingleScalar *Asp,
+                         TacsSingleScalar *x, TacsSingleScalar *y);
+
+// Generic kernels for the symmetric (upper-triangle) storage mode.
+// Each stored block contributes to both triangles of the product, and
+// the factorization is the Cholesky-style decomposition A = R^{T}*R
+// restricted to the stored pattern.
+void BCSRMatVecMultSymm(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultAddSymm(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
+                           TacsScalar *z);
+void BCSRMatVecMultRHSSymm(BCSRMatData *A, int nrhs, TacsScalar *x,
+                           TacsScalar *y);
+void BCSRMatFactorSymm(BCSRMatData *A);
+void BCSRMatApplyLowerSymm(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatApplyUpperSymm(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+
+// Generic kernels for the interleaved complex storage mode. Each
+// scalar entry of the matrix and the vectors is a (real, imaginary)
+// pair of adjacent values, and the kernels perform the complex
+// arithmetic on the pairs directly.
+void BCSRMatVecMultComplex(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultAddComplex(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
+                              TacsScalar *z);
+void BCSRMatVecMultRHSComplex(BCSRMatData *A, int nrhs, TacsScalar *x,
+                              TacsScalar *y);
+void BCSRMatVecMultTransComplex(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatFactorComplex(BCSRMatData *A);
+void BCSRMatApplyLowerComplex(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatApplyUpperComplex(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+
+// Generic kernels for the Morton-ordered storage mode. The non-zero
+// pattern is unchanged; the value blocks are stored in the order of
+// the Morton (Z-order) codes of their (row, column) indices, and each
+// block is located through the bperm permutation of the matrix data.
+void BCSRMatVecMultMorton(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultAddMorton(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
+                             TacsScalar *z);
+void BCSRMatVecMultRHSMorton(BCSRMatData *A, int nrhs, TacsScalar *x,
+                             TacsScalar *y);
+void BCSRMatVecMultTransMorton(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatFactorMorton(BCSRMatData *A);
+void BCSRMatApplyLowerMorton(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatApplyUpperMorton(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+
 void BCSRMatApplyPartialLower(BCSRMatData *A, TacsScalar *x, int var_offset);
 void BCSRMatApplyPartialUpper(BCSRMatData *A, TacsScalar *x, int var_offset);
 void BCSRMatApplyFactorSchur(BCSRMatData *A, TacsScalar *x, int var_offset);
 
 void BCSRMatMatMultAdd(double alpha, BCSRMatData *A, BCSRMatData *B,
                        BCSRMatData *C);
+
+// The threaded implementations for the general block-size case
+void *BCSRMatVecMultAdd_thread(void *t);
+void *BCSRMatApplyLower_thread(void *t);
+void *BCSRMatApplyUpper_thread(void *t);
 void BCSRMatFactorLower(BCSRMatData *A, BCSRMatData *E);
 void BCSRMatFactorUpper(BCSRMatData *A, BCSRMatData *F);
 void BCSRMatMatMultNormal(BCSRMatData *A, TacsScalar *s, BCSRMatData *B);
@@ -136,6 +246,8 @@ void BCSRMatVecMult1(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatVecMultAdd1(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
                         TacsScalar *z);
 void BCSRMatVecMultTranspose1(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultRHS1(BCSRMatData *A, int nrhs, TacsScalar *x,
+                        TacsScalar *y);
 void BCSRMatFactor1(BCSRMatData *A);
 void BCSRMatApplyLower1(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatApplyUpper1(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
@@ -160,6 +272,8 @@ void BCSRMatVecMult2(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatVecMultAdd2(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
                         TacsScalar *z);
 void BCSRMatVecMultTranspose2(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultRHS2(BCSRMatData *A, int nrhs, TacsScalar *x,
+                        TacsScalar *y);
 void BCSRMatFactor2(BCSRMatData *A);
 void BCSRMatApplyLower2(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatApplyUpper2(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
@@ -183,6 +297,8 @@ void BCSRMatVecMult3(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatVecMultAdd3(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
                         TacsScalar *z);
 void BCSRMatVecMultTranspose3(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultRHS3(BCSRMatData *A, int nrhs, TacsScalar *x,
+                        TacsScalar *y);
 void BCSRMatFactor3(BCSRMatData *A);
 void BCSRMatApplyLower3(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatApplyUpper3(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
@@ -206,6 +322,8 @@ void BCSRMatVecMult4(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatVecMultAdd4(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
                         TacsScalar *z);
 void BCSRMatVecMultTranspose4(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultRHS4(BCSRMatData *A, int nrhs, TacsScalar *x,
+                        TacsScalar *y);
 void BCSRMatFactor4(BCSRMatData *A);
 void BCSRMatApplyLower4(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatApplyUpper4(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
@@ -229,6 +347,8 @@ void BCSRMatVecMult5(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatVecMultAdd5(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
                         TacsScalar *z);
 void BCSRMatVecMultTranspose5(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultRHS5(BCSRMatData *A, int nrhs, TacsScalar *x,
+                        TacsScalar *y);
 void BCSRMatFactor5(BCSRMatData *A);
 void BCSRMatApplyLower5(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatApplyUpper5(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
@@ -252,6 +372,8 @@ void BCSRMatVecMult6(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatVecMultAdd6(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
                         TacsScalar *z);
 void BCSRMatVecMultTranspose6(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultRHS6(BCSRMatData *A, int nrhs, TacsScalar *x,
+                        TacsScalar *y);
 void BCSRMatFactor6(BCSRMatData *A);
 void BCSRMatApplyLower6(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatApplyUpper6(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
@@ -286,6 +408,8 @@ void BCSRMatVecMult8(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatVecMultAdd8(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
                         TacsScalar *z);
 void BCSRMatVecMultTranspose8(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultRHS8(BCSRMatData *A, int nrhs, TacsScalar *x,
+                        TacsScalar *y);
 void BCSRMatFactor8(BCSRMatData *A);
 void BCSRMatApplyLower8(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
 void BCSRMatApplyUpper8(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
@@ -315,4 +439,104 @@ void *BCSRMatApplyUpper8_thread(void *t);
 
 void *BCSRMatMatMultAdd8_thread(void *t);
 
+// The bsize == 9 code
+void BCSRMatVecMult9(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultAdd9(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
+                        TacsScalar *z);
+void BCSRMatVecMultRHS9(BCSRMatData *A, int nrhs, TacsScalar *x,
+                        TacsScalar *y);
+void BCSRMatFactor9(BCSRMatData *A);
+void BCSRMatApplyLower9(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatApplyUpper9(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+
+void BCSRMatApplyPartialLower9(BCSRMatData *A, TacsScalar *x, int var_offset);
+void BCSRMatApplyPartialUpper9(BCSRMatData *A, TacsScalar *x, int var_offset);
+void BCSRMatApplyFactorSchur9(BCSRMatData *A, TacsScalar *x, int var_offset);
+
+void BCSRMatMatMultAdd9(double alpha, BCSRMatData *A, BCSRMatData *B,
+                        BCSRMatData *C);
+void BCSRMatFactorLower9(BCSRMatData *A, BCSRMatData *E);
+void BCSRMatFactorUpper9(BCSRMatData *A, BCSRMatData *F);
+void BCSRMatApplySOR9(BCSRMatData *Adata, BCSRMatData *Bdata, const int start,
+                      const int end, const int var_offset,
+                      const TacsScalar *Adiag, const TacsScalar omega,
+                      const TacsScalar *b, const TacsScalar *xext,
+                      TacsScalar *x);
+
+// The bsize == 12 code
+void BCSRMatVecMult12(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultAdd12(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
+                         TacsScalar *z);
+void BCSRMatVecMultRHS12(BCSRMatData *A, int nrhs, TacsScalar *x,
+                         TacsScalar *y);
+void BCSRMatFactor12(BCSRMatData *A);
+void BCSRMatApplyLower12(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatApplyUpper12(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+
+void BCSRMatApplyPartialLower12(BCSRMatData *A, TacsScalar *x, int var_offset);
+void BCSRMatApplyPartialUpper12(BCSRMatData *A, TacsScalar *x, int var_offset);
+void BCSRMatApplyFactorSchur12(BCSRMatData *A, TacsScalar *x, int var_offset);
+
+void BCSRMatMatMultAdd12(double alpha, BCSRMatData *A, BCSRMatData *B,
+                         BCSRMatData *C);
+void BCSRMatFactorLower12(BCSRMatData *A, BCSRMatData *E);
+void BCSRMatFactorUpper12(BCSRMatData *A, BCSRMatData *F);
+void BCSRMatApplySOR12(BCSRMatData *Adata, BCSRMatData *Bdata, const int start,
+                       const int end, const int var_offset,
+                       const TacsScalar *Adiag, const TacsScalar omega,
+                       const TacsScalar *b, const TacsScalar *xext,
+                       TacsScalar *x);
+
+/*
+  Explicit SIMD kernels for bsize = 6 and bsize = 8. These are only
+  available for real (double precision) builds on x86-64 - the scalar
+  kernels above remain the fallback on other platforms or processors.
+*/
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(TACS_USE_COMPLEX) && \
+    !defined(TACS_USE_DUAL)
+#define TACS_BCSR_SIMD 1
+#endif
+
+// Run-time processor detection: 0 = scalar only, 1 = AVX2+FMA,
+// 2 = AVX-512F
+int BCSRMatGetSimdLevel();
+
+#ifdef TACS_BCSR_SIMD
+// The AVX2 + FMA kernels for bsize = 6
+void BCSRMatVecMult6Avx2(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultAdd6Avx2(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
+                            TacsScalar *z);
+void BCSRMatApplyLower6Avx2(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatApplyUpper6Avx2(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatMatMultAdd6Avx2(double alpha, BCSRMatData *A, BCSRMatData *B,
+                            BCSRMatData *C);
+
+// The AVX2 + FMA kernels for bsize = 8
+void BCSRMatVecMult8Avx2(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultAdd8Avx2(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
+                            TacsScalar *z);
+void BCSRMatApplyLower8Avx2(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatApplyUpper8Avx2(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatMatMultAdd8Avx2(double alpha, BCSRMatData *A, BCSRMatData *B,
+                            BCSRMatData *C);
+
+// The AVX-512F kernels for bsize = 6
+void BCSRMatVecMult6Avx512(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultAdd6Avx512(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
+                              TacsScalar *z);
+void BCSRMatApplyLower6Avx512(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatApplyUpper6Avx512(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatMatMultAdd6Avx512(double alpha, BCSRMatData *A, BCSRMatData *B,
+                              BCSRMatData *C);
+
+// The AVX-512F kernels for bsize = 8
+void BCSRMatVecMult8Avx512(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatVecMultAdd8Avx512(BCSRMatData *A, TacsScalar *x, TacsScalar *y,
+                              TacsScalar *z);
+void BCSRMatApplyLower8Avx512(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatApplyUpper8Avx512(BCSRMatData *A, TacsScalar *x, TacsScalar *y);
+void BCSRMatMatMultAdd8Avx512(double alpha, BCSRMatData *A, BCSRMatData *B,
+                              BCSRMatData *C);
+#endif  // TACS_BCSR_SIMD
+
 #endif
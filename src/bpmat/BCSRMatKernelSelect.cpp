@@ -0,0 +1,172 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "BCSRMatKernelSelect.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+  The registry of cached kernel selections
+*/
+
+// The largest block size with selectable kernels and the number of
+// logarithmic size classes
+static const int BCSR_KERNEL_MAX_BSIZE = 16;
+static const int BCSR_KERNEL_NUM_SIZE_CLASSES = 32;
+
+// The cached kernel index for each key; negative entries are unset
+static int kernel_table[BCSR_NUM_KERNEL_OPS][BCSR_KERNEL_MAX_BSIZE +
+                                             1][BCSR_KERNEL_NUM_SIZE_CLASSES];
+static int kernel_table_init = 0;
+
+// The optional file used to persist the selections across runs
+static char kernel_cache_file[256] = "";
+
+// The lock guarding the registry
+static pthread_mutex_t kernel_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+  Clear the registry. The caller must hold the registry lock.
+*/
+static void initKernelTable() {
+  if (!kernel_table_init) {
+    for (int op = 0; op < BCSR_NUM_KERNEL_OPS; op++) {
+      for (int b = 0; b <= BCSR_KERNEL_MAX_BSIZE; b++) {
+        for (int sc = 0; sc < BCSR_KERNEL_NUM_SIZE_CLASSES; sc++) {
+          kernel_table[op][b][sc] = -1;
+        }
+      }
+    }
+    kernel_table_init = 1;
+  }
+}
+
+/*
+  Compute the size class of a matrix.
+
+  Matrices are bucketed by the log2 of their total row dimension so
+  that matrices of similar size share a cached selection: the relative
+  kernel performance is driven by whether the vectors fit in cache,
+  not by the exact row count.
+
+  input:
+  bsize:  the block size of the matrix
+  nrows:  the number of block rows
+
+  returns: the size class index
+*/
+int BCSRMatKernelSizeClass(int bsize, int nrows) {
+  int n = bsize * nrows;
+  int size_class = 0;
+  while (n > 1 && size_class < BCSR_KERNEL_NUM_SIZE_CLASSES - 1) {
+    n = n >> 1;
+    size_class++;
+  }
+  return size_class;
+}
+
+/*
+  Look up the cached kernel index for the given key.
+
+  returns: the cached index, or a negative value if no selection has
+  been recorded for this key
+*/
+int BCSRMatLookupKernel(BCSRMatKernelOp op, int bsize, int size_class) {
+  if (op < 0 || op >= BCSR_NUM_KERNEL_OPS || bsize < 0 ||
+      bsize > BCSR_KERNEL_MAX_BSIZE || size_class < 0 ||
+      size_class >= BCSR_KERNEL_NUM_SIZE_CLASSES) {
+    return -1;
+  }
+
+  pthread_mutex_lock(&kernel_table_mutex);
+  initKernelTable();
+  int index = kernel_table[op][bsize][size_class];
+  pthread_mutex_unlock(&kernel_table_mutex);
+
+  return index;
+}
+
+/*
+  Record the winning kernel index for the given key and append it to
+  the persistent cache file if one has been set
+*/
+void BCSRMatRecordKernel(BCSRMatKernelOp op, int bsize, int size_class,
+                         int index) {
+  if (op < 0 || op >= BCSR_NUM_KERNEL_OPS || bsize < 0 ||
+      bsize > BCSR_KERNEL_MAX_BSIZE || size_class < 0 ||
+      size_class >= BCSR_KERNEL_NUM_SIZE_CLASSES) {
+    return;
+  }
+
+  pthread_mutex_lock(&kernel_table_mutex);
+  initKernelTable();
+  kernel_table[op][bsize][size_class] = index;
+
+  if (kernel_cache_file[0]) {
+    FILE *fp = fopen(kernel_cache_file, "a");
+    if (fp) {
+      fprintf(fp, "%d %d %d %d\n", (int)op, bsize, size_class, index);
+      fclose(fp);
+    }
+  }
+  pthread_mutex_unlock(&kernel_table_mutex);
+}
+
+/*
+  Set a file used to persist the selections across runs.
+
+  The file holds one selection per line as "op bsize size_class
+  index". Entries recorded by earlier runs are loaded immediately and
+  new selections are appended, so repeated runs on the same host type
+  skip the microbenchmarks. Later entries for the same key override
+  earlier ones.
+
+  input:
+  filename:  the cache file name, or NULL to disable persistence
+*/
+void BCSRMatSetKernelCacheFile(const char *filename) {
+  pthread_mutex_lock(&kernel_table_mutex);
+  initKernelTable();
+
+  if (filename && strlen(filename) < sizeof(kernel_cache_file)) {
+    strcpy(kernel_cache_file, filename);
+
+    // Load the selections recorded by earlier runs
+    FILE *fp = fopen(kernel_cache_file, "r");
+    if (fp) {
+      int op, bsize, size_class, index;
+      while (fscanf(fp, "%d %d %d %d", &op, &bsize, &size_class, &index) ==
+             4) {
+        if (op >= 0 && op < BCSR_NUM_KERNEL_OPS && bsize >= 0 &&
+            bsize <= BCSR_KERNEL_MAX_BSIZE && size_class >= 0 &&
+            size_class < BCSR_KERNEL_NUM_SIZE_CLASSES) {
+          kernel_table[op][bsize][size_class] = index;
+        }
+      }
+      fclose(fp);
+    }
+  } else {
+    kernel_cache_file[0] = '\0';
+    if (filename) {
+      fprintf(stderr, "BCSRMatSetKernelCacheFile: file name too long\n");
+    }
+  }
+  pthread_mutex_unlock(&kernel_table_mutex);
+}
@@ -0,0 +1,70 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_BCSR_MAT_KERNEL_SELECT_H
+#define TACS_BCSR_MAT_KERNEL_SELECT_H
+
+/*
+  A process-wide registry of profile-guided kernel selections for the
+  low-level BCSR operations.
+
+  Several of the BCSR operations have more than one implementation -
+  the scalar kernels and the AVX2/AVX-512 variants - and the fastest
+  choice depends on the block size, the matrix size and the machine.
+  Rather than hand-tuning the choice per machine, the matrix
+  microbenchmarks the candidate kernels on its own data at first use
+  of each operation and records the winner here, keyed by the
+  operation, the block size and a logarithmic size class. Later
+  matrices with the same key reuse the cached selection without
+  re-running the benchmark.
+
+  The cached selections can optionally be persisted to a file so that
+  repeated runs on the same host type skip the benchmarks entirely.
+
+  When deterministic reductions are requested through
+  TacsSetDeterministicReductions, the timed benchmark is skipped and
+  the widest SIMD kernels are pinned instead so that identical runs
+  always execute the same kernels.
+*/
+
+// The operations with selectable kernel implementations
+enum BCSRMatKernelOp {
+  BCSR_KERNEL_MULT = 0,     // y = A*x
+  BCSR_KERNEL_MULTADD,      // y = A*x + z
+  BCSR_KERNEL_APPLY_LOWER,  // y = L^{-1}*x
+  BCSR_KERNEL_APPLY_UPPER,  // y = U^{-1}*x
+  BCSR_NUM_KERNEL_OPS
+};
+
+// Compute the size class of a matrix: the log2 of its row dimension
+int BCSRMatKernelSizeClass(int bsize, int nrows);
+
+// Look up the cached kernel index for the given key; returns a
+// negative value if no selection has been recorded
+int BCSRMatLookupKernel(BCSRMatKernelOp op, int bsize, int size_class);
+
+// Record the winning kernel index for the given key
+void BCSRMatRecordKernel(BCSRMatKernelOp op, int bsize, int size_class,
+                         int index);
+
+// Set a file used to persist the selections across runs. Existing
+// entries are loaded immediately and new selections are appended.
+// The file is host-specific - do not share it between machine types.
+void BCSRMatSetKernelCacheFile(const char *filename);
+
+#endif  // TACS_BCSR_MAT_KERNEL_SELECT_H
@@ -0,0 +1,366 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "BCSRMatImpl.h"
+#include "tacslapack.h"
+
+/*
+  Kernels for the Morton-ordered block storage mode.
+
+  The non-zero pattern is the usual block CSR structure, but the value
+  blocks are stored in the order of the Morton (Z-order) codes of
+  their (row, column) block indices rather than row-by-row. Blocks
+  that are close in both the row and the column direction are then
+  close in memory, which matches the update pattern of the
+  factorization: the trailing update of row cj touches the entries of
+  every later row that shares its columns, and with the row-major
+  layout those entries are spread across the full value array. The
+  kernels locate the block for pattern position k through the
+  data->bperm permutation, so they traverse the pattern in the usual
+  order while the memory traffic follows the recursive layout.
+
+  The factorization is the same in-place block LU used by
+  BCSRMatFactor, with the diagonal slot storing the inverse of the
+  diagonal factor.
+*/
+
+/*!
+  Compute the matrix-vector product y = A*x with the Morton-ordered
+  value layout
+*/
+void BCSRMatVecMultMorton(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *bperm = data->bperm;
+  int bsize = data->bsize;
+  int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = 1.0;
+  TacsScalar beta = 1.0;
+
+  for (int i = 0; i < nrows; i++) {
+    memset(y, 0, bsize * sizeof(TacsScalar));
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int bj = bsize * cols[k];
+      TacsScalar *a = &data->A[b2 * bperm[k]];
+
+      BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &x[bj], &one, &beta, y,
+               &one);
+    }
+
+    y += bsize;
+  }
+}
+
+/*!
+  Compute the matrix-vector product plus addition y = A*x + z with the
+  Morton-ordered value layout
+*/
+void BCSRMatVecMultAddMorton(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
+                             TacsScalar *z) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *bperm = data->bperm;
+  int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = 1.0;
+  TacsScalar beta = 1.0;
+
+  if (z != y) {
+    memcpy(y, z, bsize * nrows * sizeof(TacsScalar));
+  }
+
+  for (int i = 0; i < nrows; i++) {
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int bj = bsize * cols[k];
+      TacsScalar *a = &data->A[b2 * bperm[k]];
+
+      BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &x[bj], &one, &beta, y,
+               &one);
+    }
+
+    y += bsize;
+  }
+}
+
+/*!
+  Compute the product Y = A*X for multiple right-hand sides with the
+  Morton-ordered value layout. The multivectors are packed by block
+  row as in BCSRMatVecMultRHS.
+*/
+void BCSRMatVecMultRHSMorton(BCSRMatData *data, int nrhs, TacsScalar *x,
+                             TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *bperm = data->bperm;
+  int bsize = data->bsize;
+  int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = 1.0;
+  TacsScalar beta = 1.0;
+
+  for (int i = 0; i < nrows; i++) {
+    memset(y, 0, bsize * nrhs * sizeof(TacsScalar));
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int bj = bsize * nrhs * cols[k];
+      TacsScalar *a = &data->A[b2 * bperm[k]];
+
+      for (int r = 0; r < nrhs; r++) {
+        BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &x[bj + bsize * r],
+                 &one, &beta, &y[bsize * r], &one);
+      }
+    }
+
+    y += bsize * nrhs;
+  }
+}
+
+/*!
+  Compute the matrix-vector product y = A^{T}*x with the Morton-ordered
+  value layout
+*/
+void BCSRMatVecMultTransMorton(BCSRMatData *data, TacsScalar *x,
+                               TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *bperm = data->bperm;
+  int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = 1.0;
+  TacsScalar beta = 1.0;
+
+  for (int i = 0; i < nrows; i++) {
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int bj = bsize * cols[k];
+      TacsScalar *a = &data->A[b2 * bperm[k]];
+
+      BLASgemv("N", &bsize, &bsize, &alpha, a, &bsize, x, &one, &beta, &y[bj],
+               &one);
+    }
+
+    x += bsize;
+  }
+}
+
+/*!
+  Perform the in-place block LU factorization with the Morton-ordered
+  value layout.
+
+  This follows the column-by-column elimination of BCSRMatFactor: for
+  each entry below the diagonal, the row multiplier is formed against
+  the stored inverse of the diagonal factor and the trailing entries
+  of the row are updated by a two-pointer scan over the shared column
+  pattern. The supernode panel aggregation of the row-major
+  factorization assumes consecutive blocks are adjacent in memory and
+  is not applied here - the layout itself supplies the locality that
+  the panels recover by copying.
+*/
+void BCSRMatFactorMorton(BCSRMatData *data) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  const int *bperm = data->bperm;
+  const int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+  TacsScalar *A = data->A;
+
+  TacsScalar *D = new TacsScalar[b2];
+  int *ipiv = new int[bsize];
+
+  for (int i = 0; i < nrows; i++) {
+    if (diag[i] < 0) {
+      fprintf(stderr, "Error in factorization: no diagonal entry for row %d\n",
+              i);
+      delete[] D;
+      delete[] ipiv;
+      return;
+    }
+
+    // Scan from the first entry in the current row towards the diagonal
+    int row_end = rowp[i + 1];
+
+    for (int j = rowp[i]; j < row_end && cols[j] < i; j++) {
+      int cj = cols[j];
+      TacsScalar *a = &A[b2 * bperm[j]];
+      TacsScalar *b = &A[b2 * bperm[diag[cj]]];
+
+      // D = A[j] * A[diag[cj]]
+      for (int n = 0; n < bsize; n++) {
+        for (int m = 0; m < bsize; m++) {
+          D[n * bsize + m] = 0.0;
+          for (int l = 0; l < bsize; l++) {
+            D[n * bsize + m] += a[n * bsize + l] * b[l * bsize + m];
+          }
+        }
+      }
+
+      // Scan through the remainder of the row
+      int k = j + 1;
+
+      // The final entry for row cj
+      int end = rowp[cj + 1];
+
+      // Now scan through row cj starting at the first entry past the
+      // diagonal
+      for (int p = diag[cj] + 1; (p < end) && (k < row_end); p++) {
+        // Determine where the two rows have the same elements
+        while (k < row_end && cols[k] < cols[p]) {
+          k++;
+        }
+
+        // A[k] = A[k] - A[j] * A[p]
+        if (k < row_end && cols[k] == cols[p]) {
+          a = &A[b2 * bperm[k]];
+          b = &A[b2 * bperm[p]];
+
+          for (int n = 0; n < bsize; n++) {
+            int nb = n * bsize;
+            for (int m = 0; m < bsize; m++) {
+              for (int l = 0; l < bsize; l++) {
+                a[nb + m] -= D[nb + l] * b[l * bsize + m];
+              }
+            }
+          }
+        }
+      }
+
+      // Copy the multiplier back into the matrix
+      a = &A[b2 * bperm[j]];
+      for (int n = 0; n < b2; n++) {
+        a[n] = D[n];
+      }
+    }
+
+    // Invert the diagonal matrix component
+    TacsScalar *a = &A[b2 * bperm[diag[i]]];
+    for (int n = 0; n < b2; n++) {
+      D[n] = a[n];
+    }
+
+    int fail = BMatComputeInverse(a, D, ipiv, bsize);
+    if (fail != 0) {
+      fprintf(stderr, "Failure in factorization of row %d, block row %d\n", i,
+              fail);
+    }
+  }
+
+  delete[] D;
+  delete[] ipiv;
+}
+
+/*!
+  Apply the lower factorization y = L^{-1} x with the Morton-ordered
+  value layout
+*/
+void BCSRMatApplyLowerMorton(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  const int *bperm = data->bperm;
+  int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = -1.0;
+  TacsScalar beta = 1.0;
+
+  TacsScalar *yy = y;
+  TacsScalar *xx = x;
+
+  for (int i = 0; i < nrows; i++) {
+    if (x != y) {
+      memcpy(yy, xx, bsize * sizeof(TacsScalar));
+    }
+
+    int end = diag[i];
+    for (int j = rowp[i]; j < end; j++) {
+      int bj = bsize * cols[j];
+      TacsScalar *a = &data->A[b2 * bperm[j]];
+
+      BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &y[bj], &one, &beta, yy,
+               &one);
+    }
+
+    yy += bsize;
+    xx += bsize;
+  }
+}
+
+/*!
+  Apply the upper factorization y = U^{-1} x with the Morton-ordered
+  value layout
+*/
+void BCSRMatApplyUpperMorton(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  const int *bperm = data->bperm;
+  int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = -1.0;
+  TacsScalar beta = 1.0;
+  TacsScalar zero = 0.0;
+
+  TacsScalar *ty = new TacsScalar[bsize];
+  TacsScalar *yy = &y[bsize * (nrows - 1)];
+  x = &x[bsize * (nrows - 1)];
+
+  for (int i = nrows - 1; i >= 0; i--) {
+    memcpy(ty, x, bsize * sizeof(TacsScalar));
+
+    int end = rowp[i + 1];
+    for (int j = diag[i] + 1; j < end; j++) {
+      int bj = bsize * cols[j];
+      TacsScalar *a = &data->A[b2 * bperm[j]];
+
+      BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &y[bj], &one, &beta, ty,
+               &one);
+    }
+
+    // Multiply by the stored inverse of the diagonal factor
+    TacsScalar *adiag = &data->A[b2 * bperm[diag[i]]];
+    BLASgemv("T", &bsize, &bsize, &beta, adiag, &bsize, ty, &one, &zero, yy,
+             &one);
+
+    x -= bsize;
+    yy -= bsize;
+  }
+
+  delete[] ty;
+}
@@ -17,6 +17,7 @@
 */
 
 #include "BCSRMatImpl.h"
+#include "TacsUtilities.h"
 #include "tacslapack.h"
 
 /*!
@@ -35,6 +36,7 @@ BCSRMatData::BCSRMatData(int _bsize, int _nrows, int _ncols) {
   rowp = NULL;
   cols = NULL;
   A = NULL;
+  bperm = NULL;
 
   // The sizes of the groups of procs
   matvec_group_size = 1;
@@ -52,8 +54,16 @@ BCSRMatData::~BCSRMatData() {
     delete[] cols;
   }
   if (A) {
+    // Release the block storage from the per-process memory budget
+    if (rowp) {
+      TacsReleaseAllocation(bsize * bsize * (size_t)rowp[nrows] *
+                            sizeof(TacsScalar));
+    }
     delete[] A;
   }
+  if (bperm) {
+    delete[] bperm;
+  }
 }
 
 /*
@@ -73,6 +83,16 @@ BCSRMatThread::BCSRMatThread(BCSRMatData *_mat) {
   assigned_row_index = new int[nrows];
   completed_row_index = new int[nrows];
 
+  // The level-set schedules are computed on demand
+  num_lower_levels = num_upper_levels = 0;
+  lower_level_ptr = lower_level_rows = NULL;
+  upper_level_ptr = upper_level_rows = NULL;
+
+  sched_num_levels = 0;
+  sched_level_ptr = sched_level_rows = NULL;
+  current_level = 0;
+  level_row_head = 0;
+
   num_completed_rows = 0;
   pthread_mutex_init(&mutex, NULL);
   pthread_cond_init(&cond, NULL);
@@ -90,6 +110,18 @@ BCSRMatThread::~BCSRMatThread() {
   if (completed_row_index) {
     delete[] completed_row_index;
   }
+  if (lower_level_ptr) {
+    delete[] lower_level_ptr;
+  }
+  if (lower_level_rows) {
+    delete[] lower_level_rows;
+  }
+  if (upper_level_ptr) {
+    delete[] upper_level_ptr;
+  }
+  if (upper_level_rows) {
+    delete[] upper_level_rows;
+  }
 }
 
 /*
@@ -299,6 +331,193 @@ void BCSRMatThread::apply_upper_mark_completed(const int group_size, int index,
   pthread_mutex_unlock(&mutex);
 }
 
+/*
+  Build the level-set (wavefront) schedule for the lower triangular
+  sweep and make it the active schedule.
+
+  The level of a row is one greater than the deepest level among the
+  rows it depends on through the strictly lower triangular part of the
+  factored pattern. All rows within a level can be processed
+  concurrently once the previous level is complete. The schedule
+  depends only on the non-zero pattern, so it is computed on the first
+  call and reused afterwards.
+*/
+void BCSRMatThread::init_apply_lower_level_sched() {
+  const int nrows = mat->nrows;
+
+  if (!lower_level_rows) {
+    const int *rowp = mat->rowp;
+    const int *cols = mat->cols;
+    const int *diag = mat->diag;
+
+    // Compute the level of each row in the forward sweep
+    int *level = new int[nrows];
+    num_lower_levels = 0;
+    for (int i = 0; i < nrows; i++) {
+      int lev = 0;
+      for (int k = rowp[i]; k < diag[i]; k++) {
+        if (level[cols[k]] + 1 > lev) {
+          lev = level[cols[k]] + 1;
+        }
+      }
+      level[i] = lev;
+      if (lev + 1 > num_lower_levels) {
+        num_lower_levels = lev + 1;
+      }
+    }
+
+    // Bucket the rows by level, keeping the rows within each level in
+    // ascending order
+    lower_level_ptr = new int[num_lower_levels + 1];
+    lower_level_rows = new int[nrows];
+    memset(lower_level_ptr, 0, (num_lower_levels + 1) * sizeof(int));
+    for (int i = 0; i < nrows; i++) {
+      lower_level_ptr[level[i] + 1]++;
+    }
+    for (int lev = 0; lev < num_lower_levels; lev++) {
+      lower_level_ptr[lev + 1] += lower_level_ptr[lev];
+    }
+
+    int *count = new int[num_lower_levels];
+    memset(count, 0, num_lower_levels * sizeof(int));
+    for (int i = 0; i < nrows; i++) {
+      lower_level_rows[lower_level_ptr[level[i]] + count[level[i]]] = i;
+      count[level[i]]++;
+    }
+
+    delete[] count;
+    delete[] level;
+  }
+
+  // Set the active schedule and reset the progress counters
+  sched_num_levels = num_lower_levels;
+  sched_level_ptr = lower_level_ptr;
+  sched_level_rows = lower_level_rows;
+  current_level = 0;
+  level_row_head = 0;
+  num_completed_rows = 0;
+}
+
+/*
+  Build the level-set schedule for the upper triangular sweep and make
+  it the active schedule.
+
+  This is the mirror image of the lower schedule: the dependencies run
+  through the strictly upper triangular part of the factored pattern,
+  so the levels are computed in a backward sweep over the rows.
+*/
+void BCSRMatThread::init_apply_upper_level_sched() {
+  const int nrows = mat->nrows;
+
+  if (!upper_level_rows) {
+    const int *rowp = mat->rowp;
+    const int *cols = mat->cols;
+    const int *diag = mat->diag;
+
+    // Compute the level of each row in the backward sweep
+    int *level = new int[nrows];
+    num_upper_levels = 0;
+    for (int i = nrows - 1; i >= 0; i--) {
+      int lev = 0;
+      for (int k = diag[i] + 1; k < rowp[i + 1]; k++) {
+        if (level[cols[k]] + 1 > lev) {
+          lev = level[cols[k]] + 1;
+        }
+      }
+      level[i] = lev;
+      if (lev + 1 > num_upper_levels) {
+        num_upper_levels = lev + 1;
+      }
+    }
+
+    // Bucket the rows by level, keeping the rows within each level in
+    // descending order
+    upper_level_ptr = new int[num_upper_levels + 1];
+    upper_level_rows = new int[nrows];
+    memset(upper_level_ptr, 0, (num_upper_levels + 1) * sizeof(int));
+    for (int i = 0; i < nrows; i++) {
+      upper_level_ptr[level[i] + 1]++;
+    }
+    for (int lev = 0; lev < num_upper_levels; lev++) {
+      upper_level_ptr[lev + 1] += upper_level_ptr[lev];
+    }
+
+    int *count = new int[num_upper_levels];
+    memset(count, 0, num_upper_levels * sizeof(int));
+    for (int i = nrows - 1; i >= 0; i--) {
+      upper_level_rows[upper_level_ptr[level[i]] + count[level[i]]] = i;
+      count[level[i]]++;
+    }
+
+    delete[] count;
+    delete[] level;
+  }
+
+  // Set the active schedule and reset the progress counters
+  sched_num_levels = num_upper_levels;
+  sched_level_ptr = upper_level_ptr;
+  sched_level_rows = upper_level_rows;
+  current_level = 0;
+  level_row_head = 0;
+  num_completed_rows = 0;
+}
+
+/*
+  Claim the next group of rows from the current level of the active
+  level schedule.
+
+  The indices returned are positions within the sched_level_rows
+  array. If the current level has been fully assigned but is not yet
+  complete, the calling thread waits at the level boundary. Once all
+  levels are complete, start is set to -1 to signal the thread to
+  exit.
+*/
+void BCSRMatThread::apply_level_sched_job(const int group_size, int *start,
+                                          int *end) {
+  pthread_mutex_lock(&mutex);
+
+  *start = -1;
+  *end = -1;
+
+  while (current_level < sched_num_levels) {
+    if (level_row_head < sched_level_ptr[current_level + 1]) {
+      *start = level_row_head;
+      *end = level_row_head + group_size;
+      if (*end > sched_level_ptr[current_level + 1]) {
+        *end = sched_level_ptr[current_level + 1];
+      }
+      level_row_head = *end;
+      break;
+    }
+
+    // All rows in the current level are assigned but not yet complete
+    // - wait for the level to finish
+    pthread_cond_wait(&cond, &mutex);
+  }
+
+  pthread_mutex_unlock(&mutex);
+}
+
+/*
+  Mark a group of rows from the active level schedule as completed.
+
+  When the last group of rows in the current level is completed, the
+  schedule advances to the next level and the threads waiting at the
+  level boundary are woken up.
+*/
+void BCSRMatThread::apply_level_mark_completed(const int count) {
+  pthread_mutex_lock(&mutex);
+
+  num_completed_rows += count;
+  if (current_level < sched_num_levels &&
+      num_completed_rows == sched_level_ptr[current_level + 1]) {
+    current_level++;
+    pthread_cond_broadcast(&cond);
+  }
+
+  pthread_mutex_unlock(&mutex);
+}
+
 /*!
   Compute the inverse of a matrix.
 
@@ -420,6 +639,48 @@ void BCSRMatVecMult(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
   }
 }
 
+/*!
+  Compute the matrix-vector product for multiple right-hand sides:
+  Y = A * X
+
+  The multivectors are packed by block row: the nrhs right-hand sides
+  for block j are stored contiguously at &x[bsize*nrhs*j], with the
+  bsize components of each right-hand side adjacent. Each block row of
+  the matrix is streamed through memory only once for all of the
+  right-hand sides, so the matrix traffic is amortized over the full
+  set of vectors.
+*/
+void BCSRMatVecMultRHS(BCSRMatData *data, int nrhs, TacsScalar *x,
+                       TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  int bsize = data->bsize;
+  int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = 1.0;
+  TacsScalar beta = 1.0;
+
+  TacsScalar *a = data->A;
+  for (int i = 0; i < nrows; i++) {
+    memset(y, 0, bsize * nrhs * sizeof(TacsScalar));
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int bj = bsize * nrhs * cols[k];
+
+      for (int r = 0; r < nrhs; r++) {
+        BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &x[bj + bsize * r],
+                 &one, &beta, &y[bsize * r], &one);
+      }
+      a += b2;
+    }
+
+    y += bsize * nrhs;
+  }
+}
+
 /*!
   Compute the matrix vector product plus addition: z = A * x + y
 */
@@ -457,6 +718,60 @@ void BCSRMatVecMultAdd(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
   }
 }
 
+/*
+  Threaded matrix-vector product for the general block-size case.
+
+  Each worker pulls a group of block rows from the dynamic scheduler
+  and accumulates the product for those rows into the shared output
+  vector. Rows are owned exclusively by the worker that claimed them
+  so no locking of the output is required. The block-specific kernels
+  override this implementation when an unrolled version exists.
+*/
+void *BCSRMatVecMultAdd_thread(void *t) {
+  BCSRMatThread *tdata = static_cast<BCSRMatThread *>(t);
+  const int nrows = tdata->mat->nrows;
+  int bsize = tdata->mat->bsize;
+  const int b2 = bsize * bsize;
+
+  // Get the input/output vectors
+  TacsScalar *x = tdata->input;
+
+  const int *rowp = tdata->mat->rowp;
+  const int *cols = tdata->mat->cols;
+  TacsScalar *A = tdata->mat->A;
+  const int group_size = tdata->mat->matvec_group_size;
+
+  int one = 1;
+  TacsScalar alpha = 1.0;
+  TacsScalar beta = 1.0;
+
+  while (tdata->num_completed_rows < nrows) {
+    int row = -1;
+    tdata->mat_mult_sched_job(group_size, &row);
+
+    if (row >= 0) {
+      TacsScalar *y = &tdata->output[bsize * row];
+      int k = rowp[row];
+      for (int ii = row; ii < nrows && (ii < row + group_size); ii++) {
+        int end = rowp[ii + 1];
+        TacsScalar *a = &A[b2 * k];
+
+        for (; k < end; k++) {
+          int bj = bsize * cols[k];
+
+          BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &x[bj], &one, &beta,
+                   y, &one);
+          a += b2;
+        }
+
+        y += bsize;
+      }
+    }
+  }
+
+  pthread_exit(NULL);
+}
+
 /*!
   Compute the matrix-vector product: y = A^{T} * x
 */
@@ -572,6 +887,129 @@ void BCSRMatApplyUpper(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
   delete[] ty;
 }
 
+/*
+  Threaded lower triangular solve for the general block-size case.
+
+  Compute in place:
+  y <- L^{-1} y
+
+  Rows are drawn from the level-set scheduler. Rows within a level
+  depend only on rows from earlier levels, so each row can be
+  completed without further synchronization.
+*/
+void *BCSRMatApplyLower_thread(void *t) {
+  BCSRMatThread *tdata = static_cast<BCSRMatThread *>(t);
+  int bsize = tdata->mat->bsize;
+  const int b2 = bsize * bsize;
+
+  const int *rowp = tdata->mat->rowp;
+  const int *cols = tdata->mat->cols;
+  const int *diag = tdata->mat->diag;
+  TacsScalar *A = tdata->mat->A;
+  const int group_size = tdata->mat->matvec_group_size;
+  const int *level_rows = tdata->sched_level_rows;
+
+  TacsScalar *y = tdata->output;
+
+  int one = 1;
+  TacsScalar alpha = -1.0;
+  TacsScalar beta = 1.0;
+
+  while (1) {
+    int start, end;
+    tdata->apply_level_sched_job(group_size, &start, &end);
+    if (start < 0) {
+      break;
+    }
+
+    for (int ii = start; ii < end; ii++) {
+      int i = level_rows[ii];
+      TacsScalar *z = &y[bsize * i];
+
+      int kend = diag[i];
+      int k = rowp[i];
+      TacsScalar *a = &A[b2 * k];
+      for (; k < kend; k++) {
+        int bj = bsize * cols[k];
+
+        BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &y[bj], &one, &beta,
+                 z, &one);
+        a += b2;
+      }
+    }
+
+    tdata->apply_level_mark_completed(end - start);
+  }
+
+  pthread_exit(NULL);
+}
+
+/*
+  Threaded upper triangular solve for the general block-size case.
+
+  Compute in place:
+  y <- U^{-1} y
+
+  The off-diagonal contributions are subtracted into a small
+  thread-local buffer and the result is multiplied by the stored
+  inverse of the diagonal block, following the serial kernel.
+*/
+void *BCSRMatApplyUpper_thread(void *t) {
+  BCSRMatThread *tdata = static_cast<BCSRMatThread *>(t);
+  int bsize = tdata->mat->bsize;
+  const int b2 = bsize * bsize;
+
+  const int *rowp = tdata->mat->rowp;
+  const int *cols = tdata->mat->cols;
+  const int *diag = tdata->mat->diag;
+  TacsScalar *A = tdata->mat->A;
+  const int group_size = tdata->mat->matvec_group_size;
+  const int *level_rows = tdata->sched_level_rows;
+
+  TacsScalar *y = tdata->output;
+
+  int one = 1;
+  TacsScalar alpha = -1.0;
+  TacsScalar beta = 1.0;
+  TacsScalar zero = 0.0;
+
+  TacsScalar *ty = new TacsScalar[bsize];
+
+  while (1) {
+    int start, end;
+    tdata->apply_level_sched_job(group_size, &start, &end);
+    if (start < 0) {
+      break;
+    }
+
+    for (int ii = start; ii < end; ii++) {
+      int i = level_rows[ii];
+      TacsScalar *z = &y[bsize * i];
+      memcpy(ty, z, bsize * sizeof(TacsScalar));
+
+      int kend = rowp[i + 1];
+      int k = diag[i] + 1;
+      TacsScalar *a = &A[b2 * k];
+      for (; k < kend; k++) {
+        int bj = bsize * cols[k];
+
+        BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &y[bj], &one, &beta,
+                 ty, &one);
+        a += b2;
+      }
+
+      TacsScalar *adiag = &A[b2 * diag[i]];
+      BLASgemv("T", &bsize, &bsize, &beta, adiag, &bsize, ty, &one, &zero, z,
+               &one);
+    }
+
+    tdata->apply_level_mark_completed(end - start);
+  }
+
+  delete[] ty;
+  pthread_exit(NULL);
+}
+
 /*!
   Apply the lower factorization y = L^{-1} x
 */
@@ -559,3 +559,36 @@ void BCSRMatApplySOR1(BCSRMatData *Adata, BCSRMatData *Bdata, const int start,
     }
   }
 }
+
+/*!
+  Compute the matrix-vector product for multiple right-hand sides:
+  Y = A * X
+
+  The multivectors are packed by block row: the nrhs right-hand
+  sides for block j are stored contiguously at &x[1 * nrhs * j],
+  so that each row of the matrix is streamed through memory only
+  once for all of the right-hand sides.
+*/
+void BCSRMatVecMultRHS1(BCSRMatData *data, int nrhs, TacsScalar *x,
+                        TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int r = 0; r < nrhs; r++) {
+      y[r] = 0.0;
+    }
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = nrhs * cols[k];
+      for (int r = 0; r < nrhs; r++) {
+        y[r] += a[0] * x[j + r];
+      }
+      a++;
+    }
+    y += nrhs;
+  }
+}
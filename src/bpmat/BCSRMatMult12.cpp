@@ -0,0 +1,605 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "BCSRMatImpl.h"
+
+/*
+  Block size = 12 code
+
+  These kernels use fixed trip-count loops rather than the fully
+  unrolled style of the smaller block sizes. With the block dimension
+  known at compile time the compiler unrolls and vectorizes the inner
+  loops, and the source remains manageable at this block size.
+*/
+
+/*!
+  Compute the matrix-vector product: y = A * x
+*/
+
+void BCSRMatVecMult12(BCSRMatData* data, TacsScalar* x, TacsScalar* y) {
+  const int nrows = data->nrows;
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const TacsScalar* a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int n = 0; n < 12; n++) {
+      y[n] = 0.0;
+    }
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      const TacsScalar* xj = &x[12 * cols[k]];
+      for (int n = 0; n < 12; n++) {
+        TacsScalar t = y[n];
+        for (int m = 0; m < 12; m++) {
+          t += a[12 * n + m] * xj[m];
+        }
+        y[n] = t;
+      }
+      a += 144;
+    }
+    y += 12;
+  }
+}
+
+/*!
+  Compute the matrix vector product plus addition: z = A * x + y
+*/
+
+void BCSRMatVecMultAdd12(BCSRMatData* data, TacsScalar* x, TacsScalar* y,
+                        TacsScalar* z) {
+  const int nrows = data->nrows;
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const TacsScalar* a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int n = 0; n < 12; n++) {
+      y[n] = z[n];
+    }
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      const TacsScalar* xj = &x[12 * cols[k]];
+      for (int n = 0; n < 12; n++) {
+        TacsScalar t = y[n];
+        for (int m = 0; m < 12; m++) {
+          t += a[12 * n + m] * xj[m];
+        }
+        y[n] = t;
+      }
+      a += 144;
+    }
+    y += 12;
+    z += 12;
+  }
+}
+
+/*!
+  Apply the lower factorization y = L^{-1} x
+*/
+
+void BCSRMatApplyLower12(BCSRMatData* data, TacsScalar* x, TacsScalar* y) {
+  const int nrows = data->nrows;
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const int* diag = data->diag;
+  const TacsScalar* A = data->A;
+
+  TacsScalar* z = y;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int n = 0; n < 12; n++) {
+      z[n] = x[n];
+    }
+
+    int end = diag[i];
+    int k = rowp[i];
+    const TacsScalar* a = &A[144 * k];
+    for (; k < end; k++) {
+      const TacsScalar* yj = &y[12 * cols[k]];
+      for (int n = 0; n < 12; n++) {
+        TacsScalar t = z[n];
+        for (int m = 0; m < 12; m++) {
+          t -= a[12 * n + m] * yj[m];
+        }
+        z[n] = t;
+      }
+      a += 144;
+    }
+
+    z += 12;
+    x += 12;
+  }
+}
+
+/*!
+  Apply the upper factorization y = U^{-1} x
+*/
+
+void BCSRMatApplyUpper12(BCSRMatData* data, TacsScalar* x, TacsScalar* y) {
+  const int nrows = data->nrows;
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const int* diag = data->diag;
+  const TacsScalar* A = data->A;
+
+  TacsScalar ty[12];
+
+  x = &x[12 * (nrows - 1)];
+  for (int i = nrows - 1; i >= 0; i--) {
+    for (int n = 0; n < 12; n++) {
+      ty[n] = x[n];
+    }
+
+    int end = rowp[i + 1];
+    int k = diag[i] + 1;
+    const TacsScalar* a = &A[144 * k];
+    for (; k < end; k++) {
+      const TacsScalar* yj = &y[12 * cols[k]];
+      for (int n = 0; n < 12; n++) {
+        TacsScalar t = ty[n];
+        for (int m = 0; m < 12; m++) {
+          t -= a[12 * n + m] * yj[m];
+        }
+        ty[n] = t;
+      }
+      a += 144;
+    }
+
+    TacsScalar* yi = &y[12 * i];
+    a = &A[144 * diag[i]];
+    for (int n = 0; n < 12; n++) {
+      TacsScalar t = 0.0;
+      for (int m = 0; m < 12; m++) {
+        t += a[12 * n + m] * ty[m];
+      }
+      yi[n] = t;
+    }
+
+    x -= 12;
+  }
+}
+
+/*!
+  Apply a portion of the lower factorization x = L^{-1} x
+*/
+
+void BCSRMatApplyPartialLower12(BCSRMatData* data, TacsScalar* x,
+                               int var_offset) {
+  const int nrows = data->nrows;
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const int* diag = data->diag;
+  const TacsScalar* A = data->A;
+
+  TacsScalar* xx = &x[12];
+  int off = 12 * var_offset;
+
+  for (int i = var_offset + 1; i < nrows; i++) {
+    int end = diag[i];
+    int k = rowp[i];
+    while (cols[k] < var_offset) k++;
+
+    const TacsScalar* a = &A[144 * k];
+    for (; k < end; k++) {
+      const TacsScalar* xj = &x[12 * cols[k] - off];
+      for (int n = 0; n < 12; n++) {
+        TacsScalar t = xx[n];
+        for (int m = 0; m < 12; m++) {
+          t -= a[12 * n + m] * xj[m];
+        }
+        xx[n] = t;
+      }
+      a += 144;
+    }
+    xx += 12;
+  }
+}
+
+/*!
+  Apply a portion of he upper factorization x = U^{-1} x
+*/
+
+void BCSRMatApplyPartialUpper12(BCSRMatData* data, TacsScalar* x,
+                               int var_offset) {
+  const int nrows = data->nrows;
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const int* diag = data->diag;
+  const TacsScalar* A = data->A;
+
+  TacsScalar ty[12];
+  TacsScalar* xx = &x[12 * (nrows - var_offset - 1)];
+  int off = 12 * var_offset;
+
+  for (int i = nrows - 1; i >= var_offset; i--) {
+    for (int n = 0; n < 12; n++) {
+      ty[n] = xx[n];
+    }
+
+    int end = rowp[i + 1];
+    int k = diag[i] + 1;
+    const TacsScalar* a = &A[144 * k];
+    for (; k < end; k++) {
+      const TacsScalar* xj = &x[12 * cols[k] - off];
+      for (int n = 0; n < 12; n++) {
+        TacsScalar t = ty[n];
+        for (int m = 0; m < 12; m++) {
+          t -= a[12 * n + m] * xj[m];
+        }
+        ty[n] = t;
+      }
+      a += 144;
+    }
+
+    a = &A[144 * diag[i]];
+    for (int n = 0; n < 12; n++) {
+      TacsScalar t = 0.0;
+      for (int m = 0; m < 12; m++) {
+        t += a[12 * n + m] * ty[m];
+      }
+      xx[n] = t;
+    }
+    xx -= 12;
+  }
+}
+
+/*!
+  Function for the approximate Schur preconditioner
+*/
+
+void BCSRMatApplyFactorSchur12(BCSRMatData* data, TacsScalar* x,
+                              int var_offset) {
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const int* diag = data->diag;
+  const TacsScalar* A = data->A;
+
+  TacsScalar ty[12];
+  TacsScalar* xx = &x[12 * (var_offset - 1)];
+
+  for (int i = var_offset - 1; i >= 0; i--) {
+    for (int n = 0; n < 12; n++) {
+      ty[n] = xx[n];
+    }
+
+    int end = rowp[i + 1];
+    int k = diag[i] + 1;
+    const TacsScalar* a = &A[144 * k];
+    for (; k < end; k++) {
+      const TacsScalar* xj = &x[12 * cols[k]];
+      for (int n = 0; n < 12; n++) {
+        TacsScalar t = ty[n];
+        for (int m = 0; m < 12; m++) {
+          t -= a[12 * n + m] * xj[m];
+        }
+        ty[n] = t;
+      }
+      a += 144;
+    }
+
+    a = &A[144 * diag[i]];
+    for (int n = 0; n < 12; n++) {
+      TacsScalar t = 0.0;
+      for (int m = 0; m < 12; m++) {
+        t += a[12 * n + m] * ty[m];
+      }
+      xx[n] = t;
+    }
+    xx -= 12;
+  }
+}
+
+/*!
+  Perform a matrix-matrix multiplication
+*/
+
+void BCSRMatMatMultAdd12(double alpha, BCSRMatData* Adata, BCSRMatData* Bdata,
+                        BCSRMatData* Cdata) {
+  // Retrieve the data required from the matrix
+  const int nrows_a = Adata->nrows;
+  const int* arowp = Adata->rowp;
+  const int* acols = Adata->cols;
+  const TacsScalar* A = Adata->A;
+
+  const int* browp = Bdata->rowp;
+  const int* bcols = Bdata->cols;
+  const TacsScalar* B = Bdata->A;
+
+  // The matrix being written to
+  const int* crowp = Cdata->rowp;
+  const int* ccols = Cdata->cols;
+  TacsScalar* C = Cdata->A;
+
+  if (alpha == 1.0) {
+    // C_{ik} += A_{ij} B_{jk}
+    for (int i = 0; i < nrows_a; i++) {
+      for (int jp = arowp[i]; jp < arowp[i + 1]; jp++) {
+        int j = acols[jp];
+        const TacsScalar* a = &A[144 * jp];
+
+        int kp = browp[j];
+        int kp_end = browp[j + 1];
+        const TacsScalar* b = &B[144 * kp];
+
+        int cp = crowp[i];
+        int cp_end = crowp[i + 1];
+        TacsScalar* c = &C[144 * cp];
+
+        for (; kp < kp_end; kp++) {
+          while ((cp < cp_end) && (ccols[cp] < bcols[kp])) {
+            cp++;
+            c += 144;
+          }
+          if (cp >= cp_end) {
+            break;
+          }
+
+          if (bcols[kp] == ccols[cp]) {
+            // Compute the matrix-matrix multiplication
+            for (int n = 0; n < 12; n++) {
+              for (int m = 0; m < 12; m++) {
+                TacsScalar t = c[12 * n + m];
+                for (int q = 0; q < 12; q++) {
+                  t += a[12 * n + q] * b[12 * q + m];
+                }
+                c[12 * n + m] = t;
+              }
+            }
+          }
+          b += 144;
+        }
+      }
+    }
+  } else {
+    // C_{ik} += alpha * A_{ij} B_{jk}
+    for (int i = 0; i < nrows_a; i++) {
+      for (int jp = arowp[i]; jp < arowp[i + 1]; jp++) {
+        int j = acols[jp];
+        const TacsScalar* a = &A[144 * jp];
+
+        int kp = browp[j];
+        int kp_end = browp[j + 1];
+        const TacsScalar* b = &B[144 * kp];
+
+        int cp = crowp[i];
+        int cp_end = crowp[i + 1];
+        TacsScalar* c = &C[144 * cp];
+
+        for (; kp < kp_end; kp++) {
+          while ((cp < cp_end) && (ccols[cp] < bcols[kp])) {
+            cp++;
+            c += 144;
+          }
+          if (cp >= cp_end) {
+            break;
+          }
+
+          if (bcols[kp] == ccols[cp]) {
+            // Compute the matrix-matrix multiplication
+            for (int n = 0; n < 12; n++) {
+              for (int m = 0; m < 12; m++) {
+                TacsScalar t = 0.0;
+                for (int q = 0; q < 12; q++) {
+                  t += a[12 * n + q] * b[12 * q + m];
+                }
+                c[12 * n + m] += alpha * t;
+              }
+            }
+          }
+          b += 144;
+        }
+      }
+    }
+  }
+}
+
+/*!
+  Apply a given number of steps of SOR to the system A*x = b.
+*/
+
+void BCSRMatApplySOR12(BCSRMatData* Adata, BCSRMatData* Bdata, const int start,
+                      const int end, const int var_offset,
+                      const TacsScalar* Adiag, const TacsScalar omega,
+                      const TacsScalar* b, const TacsScalar* xext,
+                      TacsScalar* x) {
+  const int* Arowp = Adata->rowp;
+  const int* Acols = Adata->cols;
+
+  const int* Browp = NULL;
+  const int* Bcols = NULL;
+  if (Bdata) {
+    Browp = Bdata->rowp;
+    Bcols = Bdata->cols;
+  }
+
+  // Store temporary data for each row
+  TacsScalar t[12];
+
+  if (start < end) {
+    // Go through the matrix with the forward ordering
+    for (int i = start; i < end; i++) {
+      // Copy the right-hand-side to the temporary vector for this row
+      for (int n = 0; n < 12; n++) {
+        t[n] = b[12 * i + n];
+      }
+
+      // Set the pointer to the beginning of the current row
+      const TacsScalar* a = &Adata->A[144 * Arowp[i]];
+
+      // Scan through the row and compute the result:
+      // tx <- b_i - A_{ij}*x_{j} for j != i
+      int row_end = Arowp[i + 1];
+      for (int k = Arowp[i]; k < row_end; k++) {
+        int j = Acols[k];
+
+        if (i != j) {
+          const TacsScalar* y = &x[12 * j];
+          for (int n = 0; n < 12; n++) {
+            TacsScalar tn = t[n];
+            for (int m = 0; m < 12; m++) {
+              tn -= a[12 * n + m] * y[m];
+            }
+            t[n] = tn;
+          }
+        }
+
+        // Increment the block pointer by bsize^2
+        a += 144;
+      }
+
+      if (Bdata && i >= var_offset) {
+        const int row = i - var_offset;
+
+        // Set the pointer to the row in B
+        a = &Bdata->A[144 * Browp[row]];
+        row_end = Browp[row + 1];
+        for (int k = Browp[row]; k < row_end; k++) {
+          const TacsScalar* y = &xext[12 * Bcols[k]];
+          for (int n = 0; n < 12; n++) {
+            TacsScalar tn = t[n];
+            for (int m = 0; m < 12; m++) {
+              tn -= a[12 * n + m] * y[m];
+            }
+            t[n] = tn;
+          }
+          a += 144;
+        }
+      }
+
+      // Set a pointer to the inverse of the diagonal
+      const TacsScalar* d = &Adiag[144 * i];
+
+      // Compute the update:
+      // x[i] = (1.0 - omega)*x[i] + omega*D^{-1}tx
+      TacsScalar* xi = &x[12 * i];
+      for (int n = 0; n < 12; n++) {
+        TacsScalar tn = 0.0;
+        for (int m = 0; m < 12; m++) {
+          tn += d[12 * n + m] * t[m];
+        }
+        xi[n] = (1.0 - omega) * xi[n] + omega * tn;
+      }
+    }
+  } else {
+    // Go through the matrix with the reverse ordering
+    for (int i = start - 1; i >= end; i--) {
+      // Copy the right-hand-side to the temporary vector for this row
+      for (int n = 0; n < 12; n++) {
+        t[n] = b[12 * i + n];
+      }
+
+      // Set the pointer to the beginning of the current row
+      const TacsScalar* a = &Adata->A[144 * Arowp[i]];
+
+      // Scan through the row and compute the result:
+      // tx <- b_i - A_{ij}*x_{j} for j != i
+      int row_end = Arowp[i + 1];
+      for (int k = Arowp[i]; k < row_end; k++) {
+        int j = Acols[k];
+
+        if (i != j) {
+          const TacsScalar* y = &x[12 * j];
+          for (int n = 0; n < 12; n++) {
+            TacsScalar tn = t[n];
+            for (int m = 0; m < 12; m++) {
+              tn -= a[12 * n + m] * y[m];
+            }
+            t[n] = tn;
+          }
+        }
+
+        // Increment the block pointer by bsize^2
+        a += 144;
+      }
+
+      if (Bdata && i >= var_offset) {
+        const int row = i - var_offset;
+
+        // Set the pointer to the row in B
+        a = &Bdata->A[144 * Browp[row]];
+        row_end = Browp[row + 1];
+        for (int k = Browp[row]; k < row_end; k++) {
+          const TacsScalar* y = &xext[12 * Bcols[k]];
+          for (int n = 0; n < 12; n++) {
+            TacsScalar tn = t[n];
+            for (int m = 0; m < 12; m++) {
+              tn -= a[12 * n + m] * y[m];
+            }
+            t[n] = tn;
+          }
+          a += 144;
+        }
+      }
+
+      // Set a pointer to the inverse of the diagonal
+      const TacsScalar* d = &Adiag[144 * i];
+
+      // Compute the update:
+      // x[i] = (1.0 - omega)*x[i] + omega*D^{-1}tx
+      TacsScalar* xi = &x[12 * i];
+      for (int n = 0; n < 12; n++) {
+        TacsScalar tn = 0.0;
+        for (int m = 0; m < 12; m++) {
+          tn += d[12 * n + m] * t[m];
+        }
+        xi[n] = (1.0 - omega) * xi[n] + omega * tn;
+      }
+    }
+  }
+}
+
+/*!
+  Compute the matrix-vector product for multiple right-hand-sides:
+  y = A * x
+*/
+
+void BCSRMatVecMultRHS12(BCSRMatData* data, int nrhs, TacsScalar* x,
+                        TacsScalar* y) {
+  const int nrows = data->nrows;
+  const int* rowp = data->rowp;
+  const int* cols = data->cols;
+  const TacsScalar* a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int r = 0; r < 12 * nrhs; r++) {
+      y[r] = 0.0;
+    }
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      const TacsScalar* xj = &x[12 * nrhs * cols[k]];
+      TacsScalar* yr = y;
+      for (int r = 0; r < nrhs; r++) {
+        for (int n = 0; n < 12; n++) {
+          TacsScalar t = yr[n];
+          for (int m = 0; m < 12; m++) {
+            t += a[12 * n + m] * xj[m];
+          }
+          yr[n] = t;
+        }
+        xj += 12;
+        yr += 12;
+      }
+      a += 144;
+    }
+    y += 12 * nrhs;
+  }
+}
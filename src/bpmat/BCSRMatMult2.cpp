@@ -538,3 +538,41 @@ void BCSRMatApplySOR2(BCSRMatData *Adata, BCSRMatData *Bdata, const int start,
     }
   }
 }
+
+/*!
+  Compute the matrix-vector product for multiple right-hand sides:
+  Y = A * X
+
+  The multivectors are packed by block row: the nrhs right-hand
+  sides for block j are stored contiguously at &x[2 * nrhs * j],
+  with the 2 components of each right-hand side adjacent. Each
+  block row of the matrix is streamed through memory only once
+  for all of the right-hand sides.
+*/
+void BCSRMatVecMultRHS2(BCSRMatData *data, int nrhs, TacsScalar *x,
+                        TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int r = 0; r < 2 * nrhs; r++) {
+      y[r] = 0.0;
+    }
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = 2 * nrhs * cols[k];
+      TacsScalar *yr = y;
+      for (int r = 0; r < nrhs; r++) {
+        yr[0] += a[0] * x[j] + a[1] * x[j + 1];
+        yr[1] += a[2] * x[j] + a[3] * x[j + 1];
+        j += 2;
+        yr += 2;
+      }
+      a += 4;
+    }
+    y += 2 * nrhs;
+  }
+}
@@ -78,6 +78,29 @@ void BCSRMatVecMultAdd3(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
   }
 }
 
+/*!
+  Compute y = A^{T} * x
+*/
+void BCSRMatVecMultTranspose3(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = 3 * cols[k];
+
+      y[j] += a[0] * x[0] + a[3] * x[1] + a[6] * x[2];
+      y[j + 1] += a[1] * x[0] + a[4] * x[1] + a[7] * x[2];
+      y[j + 2] += a[2] * x[0] + a[5] * x[1] + a[8] * x[2];
+      a += 9;
+    }
+    x += 3;
+  }
+}
+
 /*!
   Apply the lower factorization y = L^{-1} x
 */
@@ -551,3 +574,42 @@ void BCSRMatApplySOR3(BCSRMatData *Adata, BCSRMatData *Bdata, const int start,
     }
   }
 }
+
+/*!
+  Compute the matrix-vector product for multiple right-hand sides:
+  Y = A * X
+
+  The multivectors are packed by block row: the nrhs right-hand
+  sides for block j are stored contiguously at &x[3 * nrhs * j],
+  with the 3 components of each right-hand side adjacent. Each
+  block row of the matrix is streamed through memory only once
+  for all of the right-hand sides.
+*/
+void BCSRMatVecMultRHS3(BCSRMatData *data, int nrhs, TacsScalar *x,
+                        TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int r = 0; r < 3 * nrhs; r++) {
+      y[r] = 0.0;
+    }
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = 3 * nrhs * cols[k];
+      TacsScalar *yr = y;
+      for (int r = 0; r < nrhs; r++) {
+        yr[0] += a[0] * x[j] + a[1] * x[j + 1] + a[2] * x[j + 2];
+        yr[1] += a[3] * x[j] + a[4] * x[j + 1] + a[5] * x[j + 2];
+        yr[2] += a[6] * x[j] + a[7] * x[j + 1] + a[8] * x[j + 2];
+        j += 3;
+        yr += 3;
+      }
+      a += 9;
+    }
+    y += 3 * nrhs;
+  }
+}
@@ -663,3 +663,47 @@ void BCSRMatApplySOR4(BCSRMatData *Adata, BCSRMatData *Bdata, const int start,
     }
   }
 }
+
+/*!
+  Compute the matrix-vector product for multiple right-hand sides:
+  Y = A * X
+
+  The multivectors are packed by block row: the nrhs right-hand
+  sides for block j are stored contiguously at &x[4 * nrhs * j],
+  with the 4 components of each right-hand side adjacent. Each
+  block row of the matrix is streamed through memory only once
+  for all of the right-hand sides.
+*/
+void BCSRMatVecMultRHS4(BCSRMatData *data, int nrhs, TacsScalar *x,
+                        TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int r = 0; r < 4 * nrhs; r++) {
+      y[r] = 0.0;
+    }
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = 4 * nrhs * cols[k];
+      TacsScalar *yr = y;
+      for (int r = 0; r < nrhs; r++) {
+        yr[0] += a[0] * x[j] + a[1] * x[j + 1] + a[2] * x[j + 2] +
+                 a[3] * x[j + 3];
+        yr[1] += a[4] * x[j] + a[5] * x[j + 1] + a[6] * x[j + 2] +
+                 a[7] * x[j + 3];
+        yr[2] += a[8] * x[j] + a[9] * x[j + 1] + a[10] * x[j + 2] +
+                 a[11] * x[j + 3];
+        yr[3] += a[12] * x[j] + a[13] * x[j + 1] + a[14] * x[j + 2] +
+                 a[15] * x[j + 3];
+        j += 4;
+        yr += 4;
+      }
+      a += 16;
+    }
+    y += 4 * nrhs;
+  }
+}
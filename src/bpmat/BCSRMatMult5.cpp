@@ -865,3 +865,49 @@ void BCSRMatApplySOR5(BCSRMatData *Adata, BCSRMatData *Bdata, const int start,
     }
   }
 }
+
+/*!
+  Compute the matrix-vector product for multiple right-hand sides:
+  Y = A * X
+
+  The multivectors are packed by block row: the nrhs right-hand
+  sides for block j are stored contiguously at &x[5 * nrhs * j],
+  with the 5 components of each right-hand side adjacent. Each
+  block row of the matrix is streamed through memory only once
+  for all of the right-hand sides.
+*/
+void BCSRMatVecMultRHS5(BCSRMatData *data, int nrhs, TacsScalar *x,
+                        TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int r = 0; r < 5 * nrhs; r++) {
+      y[r] = 0.0;
+    }
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = 5 * nrhs * cols[k];
+      TacsScalar *yr = y;
+      for (int r = 0; r < nrhs; r++) {
+        yr[0] += a[0] * x[j] + a[1] * x[j + 1] + a[2] * x[j + 2] +
+                 a[3] * x[j + 3] + a[4] * x[j + 4];
+        yr[1] += a[5] * x[j] + a[6] * x[j + 1] + a[7] * x[j + 2] +
+                 a[8] * x[j + 3] + a[9] * x[j + 4];
+        yr[2] += a[10] * x[j] + a[11] * x[j + 1] + a[12] * x[j + 2] +
+                 a[13] * x[j + 3] + a[14] * x[j + 4];
+        yr[3] += a[15] * x[j] + a[16] * x[j + 1] + a[17] * x[j + 2] +
+                 a[18] * x[j + 3] + a[19] * x[j + 4];
+        yr[4] += a[20] * x[j] + a[21] * x[j + 1] + a[22] * x[j + 2] +
+                 a[23] * x[j + 3] + a[24] * x[j + 4];
+        j += 5;
+        yr += 5;
+      }
+      a += 25;
+    }
+    y += 5 * nrhs;
+  }
+}
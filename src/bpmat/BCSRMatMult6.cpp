@@ -168,146 +168,183 @@ void BCSRMatVecMultAdd6(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
   TacsAddFlops(2 * 36 * rowp[nrows]);
 }
 
+/*!
+  Compute y = A^{T} * x
+*/
+void BCSRMatVecMultTranspose6(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  // Retrieve the data required from the matrix
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    int end = rowp[i + 1];
+
+    TacsScalar x0 = x[0];
+    TacsScalar x1 = x[1];
+    TacsScalar x2 = x[2];
+    TacsScalar x3 = x[3];
+    TacsScalar x4 = x[4];
+    TacsScalar x5 = x[5];
+
+    for (int k = rowp[i]; k < end; k++) {
+      int j = 6 * cols[k];
+
+      y[j] += a[0] * x0 + a[6] * x1 + a[12] * x2 + a[18] * x3 + a[24] * x4 +
+              a[30] * x5;
+      y[j + 1] += a[1] * x0 + a[7] * x1 + a[13] * x2 + a[19] * x3 + a[25] * x4 +
+                  a[31] * x5;
+      y[j + 2] += a[2] * x0 + a[8] * x1 + a[14] * x2 + a[20] * x3 +
+                  a[26] * x4 + a[32] * x5;
+      y[j + 3] += a[3] * x0 + a[9] * x1 + a[15] * x2 + a[21] * x3 +
+                  a[27] * x4 + a[33] * x5;
+      y[j + 4] += a[4] * x0 + a[10] * x1 + a[16] * x2 + a[22] * x3 +
+                  a[28] * x4 + a[34] * x5;
+      y[j + 5] += a[5] * x0 + a[11] * x1 + a[17] * x2 + a[23] * x3 +
+                  a[29] * x4 + a[35] * x5;
+
+      a += 36;
+    }
+
+    x += 6;
+  }
+
+  TacsAddFlops(2 * 36 * rowp[nrows]);
+}
+
 /*
-  Apply the lower-triangular matrix over a column range of a row
-  obtained from a scheduling function.
+  Apply the lower-triangular matrix over groups of rows obtained from
+  the level-set scheduler.
 
   Compute:
-  y <- L[irow, jstart:jend]^{-1} y
-
-  where y is the output array.
+  y <- L^{-1} y
 
-  Note that the scheduler ensures that no two threads are operating on
-  the same data simultaneously.
+  where y is the output array. The rows within a level have no mutual
+  dependencies so entire rows can be processed without further
+  synchronization.
 */
 void *BCSRMatApplyLower6_thread(void *t) {
   BCSRMatThread *tdata = static_cast<BCSRMatThread *>(t);
-  const int nrows = tdata->mat->nrows;
   const int *rowp = tdata->mat->rowp;
   const int *cols = tdata->mat->cols;
   const int *diag = tdata->mat->diag;
   const TacsScalar *A = tdata->mat->A;
   const int group_size = tdata->mat->matvec_group_size;
+  const int *level_rows = tdata->sched_level_rows;
 
   TacsScalar *y = tdata->output;
 
-  while (tdata->num_completed_rows < nrows) {
-    int index, irow, jstart, jend;
-    tdata->apply_lower_sched_job(group_size, &index, &irow, &jstart, &jend);
-
-    if (irow >= 0) {
-      TacsScalar *z = &y[6 * irow];
-
-      for (int i = irow; (i < nrows) && (i < irow + group_size); i++) {
-        int end = diag[i];
-        int k = rowp[i];
-        while ((k < end) && (cols[k] < jstart)) {
-          k++;
-        }
-
-        const TacsScalar *a = &A[36 * k];
-        for (; (k < end) && (cols[k] < jend); k++) {
-          int j = 6 * cols[k];
-
-          z[0] -= a[0] * y[j] + a[1] * y[j + 1] + a[2] * y[j + 2] +
-                  a[3] * y[j + 3] + a[4] * y[j + 4] + a[5] * y[j + 5];
-          z[1] -= a[6] * y[j] + a[7] * y[j + 1] + a[8] * y[j + 2] +
-                  a[9] * y[j + 3] + a[10] * y[j + 4] + a[11] * y[j + 5];
-          z[2] -= a[12] * y[j] + a[13] * y[j + 1] + a[14] * y[j + 2] +
-                  a[15] * y[j + 3] + a[16] * y[j + 4] + a[17] * y[j + 5];
-          z[3] -= a[18] * y[j] + a[19] * y[j + 1] + a[20] * y[j + 2] +
-                  a[21] * y[j + 3] + a[22] * y[j + 4] + a[23] * y[j + 5];
-          z[4] -= a[24] * y[j] + a[25] * y[j + 1] + a[26] * y[j + 2] +
-                  a[27] * y[j + 3] + a[28] * y[j + 4] + a[29] * y[j + 5];
-          z[5] -= a[30] * y[j] + a[31] * y[j + 1] + a[32] * y[j + 2] +
-                  a[33] * y[j + 3] + a[34] * y[j + 4] + a[35] * y[j + 5];
-          a += 36;
-        }
+  while (1) {
+    int start, end;
+    tdata->apply_level_sched_job(group_size, &start, &end);
+    if (start < 0) {
+      break;
+    }
 
-        z += 6;
+    for (int ii = start; ii < end; ii++) {
+      int i = level_rows[ii];
+      TacsScalar *z = &y[6 * i];
+
+      int kend = diag[i];
+      int k = rowp[i];
+      const TacsScalar *a = &A[36 * k];
+      for (; k < kend; k++) {
+        int j = 6 * cols[k];
+
+        z[0] -= a[0] * y[j] + a[1] * y[j + 1] + a[2] * y[j + 2] +
+                a[3] * y[j + 3] + a[4] * y[j + 4] + a[5] * y[j + 5];
+        z[1] -= a[6] * y[j] + a[7] * y[j + 1] + a[8] * y[j + 2] +
+                a[9] * y[j + 3] + a[10] * y[j + 4] + a[11] * y[j + 5];
+        z[2] -= a[12] * y[j] + a[13] * y[j + 1] + a[14] * y[j + 2] +
+                a[15] * y[j + 3] + a[16] * y[j + 4] + a[17] * y[j + 5];
+        z[3] -= a[18] * y[j] + a[19] * y[j + 1] + a[20] * y[j + 2] +
+                a[21] * y[j + 3] + a[22] * y[j + 4] + a[23] * y[j + 5];
+        z[4] -= a[24] * y[j] + a[25] * y[j + 1] + a[26] * y[j + 2] +
+                a[27] * y[j + 3] + a[28] * y[j + 4] + a[29] * y[j + 5];
+        z[5] -= a[30] * y[j] + a[31] * y[j + 1] + a[32] * y[j + 2] +
+                a[33] * y[j + 3] + a[34] * y[j + 4] + a[35] * y[j + 5];
+        a += 36;
       }
-
-      tdata->apply_lower_mark_completed(group_size, index, irow, jstart, jend);
     }
+
+    tdata->apply_level_mark_completed(end - start);
   }
 
   pthread_exit(NULL);
 }
 
 /*
-  Apply the upper-triangular matrix over a range of columns dictated
-  by a scheduler.
+  Apply the upper-triangular matrix over groups of rows obtained from
+  the level-set scheduler.
 
   Compute:
-  y <- U[irow, jstart:jend]^{-1} y
+  y <- U^{-1} y
+
+  The rows within a level have no mutual dependencies so entire rows
+  can be processed without further synchronization.
 */
 void *BCSRMatApplyUpper6_thread(void *t) {
   BCSRMatThread *tdata = static_cast<BCSRMatThread *>(t);
-  const int nrows = tdata->mat->nrows;
   const int *rowp = tdata->mat->rowp;
   const int *cols = tdata->mat->cols;
   const int *diag = tdata->mat->diag;
   const TacsScalar *A = tdata->mat->A;
   const int group_size = tdata->mat->matvec_group_size;
+  const int *level_rows = tdata->sched_level_rows;
 
   TacsScalar *y = tdata->output;
 
-  while (tdata->num_completed_rows < nrows) {
-    int index, irow, jstart, jend;
-    tdata->apply_upper_sched_job(group_size, &index, &irow, &jstart, &jend);
-
-    if (irow >= 0) {
-      for (int i = irow - 1; (i >= 0) && (i >= irow - group_size); i--) {
-        int start = diag[i] + 1;
-        int end = rowp[i + 1];
-
-        int k = end - 1;
-        while ((k >= start) && (cols[k] >= jend)) {
-          k--;
-        }
+  while (1) {
+    int start, end;
+    tdata->apply_level_sched_job(group_size, &start, &end);
+    if (start < 0) {
+      break;
+    }
 
-        TacsScalar *z = &y[6 * i];
-        const TacsScalar *a = &A[36 * k];
-        for (; (k >= start) && (cols[k] >= jstart); k--) {
-          int j = 6 * cols[k];
+    for (int ii = start; ii < end; ii++) {
+      int i = level_rows[ii];
+      TacsScalar *z = &y[6 * i];
+      TacsScalar y0 = z[0], y1 = z[1], y2 = z[2];
+      TacsScalar y3 = z[3], y4 = z[4], y5 = z[5];
 
-          z[0] -= a[0] * y[j] + a[1] * y[j + 1] + a[2] * y[j + 2] +
-                  a[3] * y[j + 3] + a[4] * y[j + 4] + a[5] * y[j + 5];
-          z[1] -= a[6] * y[j] + a[7] * y[j + 1] + a[8] * y[j + 2] +
-                  a[9] * y[j + 3] + a[10] * y[j + 4] + a[11] * y[j + 5];
-          z[2] -= a[12] * y[j] + a[13] * y[j + 1] + a[14] * y[j + 2] +
-                  a[15] * y[j + 3] + a[16] * y[j + 4] + a[17] * y[j + 5];
-          z[3] -= a[18] * y[j] + a[19] * y[j + 1] + a[20] * y[j + 2] +
-                  a[21] * y[j + 3] + a[22] * y[j + 4] + a[23] * y[j + 5];
-          z[4] -= a[24] * y[j] + a[25] * y[j + 1] + a[26] * y[j + 2] +
-                  a[27] * y[j + 3] + a[28] * y[j + 4] + a[29] * y[j + 5];
-          z[5] -= a[30] * y[j] + a[31] * y[j + 1] + a[32] * y[j + 2] +
-                  a[33] * y[j + 3] + a[34] * y[j + 4] + a[35] * y[j + 5];
-          a -= 36;
-        }
+      int kend = rowp[i + 1];
+      int k = diag[i] + 1;
+      const TacsScalar *a = &A[36 * k];
+      for (; k < kend; k++) {
+        int j = 6 * cols[k];
 
-        if (irow == jstart + group_size) {
-          TacsScalar y0 = z[0], y1 = z[1], y2 = z[2];
-          TacsScalar y3 = z[3], y4 = z[4], y5 = z[5];
-
-          a = &A[36 * (start - 1)];
-          z[0] = a[0] * y0 + a[1] * y1 + a[2] * y2 + a[3] * y3 + a[4] * y4 +
-                 a[5] * y5;
-          z[1] = a[6] * y0 + a[7] * y1 + a[8] * y2 + a[9] * y3 + a[10] * y4 +
-                 a[11] * y5;
-          z[2] = a[12] * y0 + a[13] * y1 + a[14] * y2 + a[15] * y3 +
-                 a[16] * y4 + a[17] * y5;
-          z[3] = a[18] * y0 + a[19] * y1 + a[20] * y2 + a[21] * y3 +
-                 a[22] * y4 + a[23] * y5;
-          z[4] = a[24] * y0 + a[25] * y1 + a[26] * y2 + a[27] * y3 +
-                 a[28] * y4 + a[29] * y5;
-          z[5] = a[30] * y0 + a[31] * y1 + a[32] * y2 + a[33] * y3 +
-                 a[34] * y4 + a[35] * y5;
-        }
+        y0 -= a[0] * y[j] + a[1] * y[j + 1] + a[2] * y[j + 2] +
+              a[3] * y[j + 3] + a[4] * y[j + 4] + a[5] * y[j + 5];
+        y1 -= a[6] * y[j] + a[7] * y[j + 1] + a[8] * y[j + 2] +
+              a[9] * y[j + 3] + a[10] * y[j + 4] + a[11] * y[j + 5];
+        y2 -= a[12] * y[j] + a[13] * y[j + 1] + a[14] * y[j + 2] +
+              a[15] * y[j + 3] + a[16] * y[j + 4] + a[17] * y[j + 5];
+        y3 -= a[18] * y[j] + a[19] * y[j + 1] + a[20] * y[j + 2] +
+              a[21] * y[j + 3] + a[22] * y[j + 4] + a[23] * y[j + 5];
+        y4 -= a[24] * y[j] + a[25] * y[j + 1] + a[26] * y[j + 2] +
+              a[27] * y[j + 3] + a[28] * y[j + 4] + a[29] * y[j + 5];
+        y5 -= a[30] * y[j] + a[31] * y[j + 1] + a[32] * y[j + 2] +
+              a[33] * y[j + 3] + a[34] * y[j + 4] + a[35] * y[j + 5];
+        a += 36;
       }
 
-      tdata->apply_upper_mark_completed(group_size, index, irow, jstart, jend);
+      a = &A[36 * diag[i]];
+      z[0] =
+          a[0] * y0 + a[1] * y1 + a[2] * y2 + a[3] * y3 + a[4] * y4 + a[5] * y5;
+      z[1] = a[6] * y0 + a[7] * y1 + a[8] * y2 + a[9] * y3 + a[10] * y4 +
+             a[11] * y5;
+      z[2] = a[12] * y0 + a[13] * y1 + a[14] * y2 + a[15] * y3 + a[16] * y4 +
+             a[17] * y5;
+      z[3] = a[18] * y0 + a[19] * y1 + a[20] * y2 + a[21] * y3 + a[22] * y4 +
+             a[23] * y5;
+      z[4] = a[24] * y0 + a[25] * y1 + a[26] * y2 + a[27] * y3 + a[28] * y4 +
+             a[29] * y5;
+      z[5] = a[30] * y0 + a[31] * y1 + a[32] * y2 + a[33] * y3 + a[34] * y4 +
+             a[35] * y5;
     }
+
+    tdata->apply_level_mark_completed(end - start);
   }
 
   pthread_exit(NULL);
@@ -1735,3 +1772,51 @@ void BCSRMatApplySOR6(BCSRMatData *Adata, BCSRMatData *Bdata, const int start,
     }
   }
 }
+
+/*!
+  Compute the matrix-vector product for multiple right-hand sides:
+  Y = A * X
+
+  The multivectors are packed by block row: the nrhs right-hand
+  sides for block j are stored contiguously at &x[6 * nrhs * j],
+  with the 6 components of each right-hand side adjacent. Each
+  block row of the matrix is streamed through memory only once
+  for all of the right-hand sides.
+*/
+void BCSRMatVecMultRHS6(BCSRMatData *data, int nrhs, TacsScalar *x,
+                        TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int r = 0; r < 6 * nrhs; r++) {
+      y[r] = 0.0;
+    }
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = 6 * nrhs * cols[k];
+      TacsScalar *yr = y;
+      for (int r = 0; r < nrhs; r++) {
+        yr[0] += a[0] * x[j] + a[1] * x[j + 1] + a[2] * x[j + 2] +
+                 a[3] * x[j + 3] + a[4] * x[j + 4] + a[5] * x[j + 5];
+        yr[1] += a[6] * x[j] + a[7] * x[j + 1] + a[8] * x[j + 2] +
+                 a[9] * x[j + 3] + a[10] * x[j + 4] + a[11] * x[j + 5];
+        yr[2] += a[12] * x[j] + a[13] * x[j + 1] + a[14] * x[j + 2] +
+                 a[15] * x[j + 3] + a[16] * x[j + 4] + a[17] * x[j + 5];
+        yr[3] += a[18] * x[j] + a[19] * x[j + 1] + a[20] * x[j + 2] +
+                 a[21] * x[j + 3] + a[22] * x[j + 4] + a[23] * x[j + 5];
+        yr[4] += a[24] * x[j] + a[25] * x[j + 1] + a[26] * x[j + 2] +
+                 a[27] * x[j + 3] + a[28] * x[j + 4] + a[29] * x[j + 5];
+        yr[5] += a[30] * x[j] + a[31] * x[j + 1] + a[32] * x[j + 2] +
+                 a[33] * x[j + 3] + a[34] * x[j + 4] + a[35] * x[j + 5];
+        j += 6;
+        yr += 6;
+      }
+      a += 36;
+    }
+    y += 6 * nrhs;
+  }
+}
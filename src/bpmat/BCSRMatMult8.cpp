@@ -208,174 +208,216 @@ void BCSRMatVecMultAdd8(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
   TacsAddFlops(2 * 64 * rowp[nrows]);
 }
 
+/*!
+  Compute y = A^{T} * x
+*/
+void BCSRMatVecMultTranspose8(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  // Retrieve the data required from the matrix
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    int end = rowp[i + 1];
+
+    TacsScalar x0 = x[0];
+    TacsScalar x1 = x[1];
+    TacsScalar x2 = x[2];
+    TacsScalar x3 = x[3];
+    TacsScalar x4 = x[4];
+    TacsScalar x5 = x[5];
+    TacsScalar x6 = x[6];
+    TacsScalar x7 = x[7];
+
+    for (int k = rowp[i]; k < end; k++) {
+      int j = 8 * cols[k];
+
+      y[j] += a[0] * x0 + a[8] * x1 + a[16] * x2 + a[24] * x3 + a[32] * x4 +
+              a[40] * x5 + a[48] * x6 + a[56] * x7;
+      y[j + 1] += a[1] * x0 + a[9] * x1 + a[17] * x2 + a[25] * x3 +
+                  a[33] * x4 + a[41] * x5 + a[49] * x6 + a[57] * x7;
+      y[j + 2] += a[2] * x0 + a[10] * x1 + a[18] * x2 + a[26] * x3 +
+                  a[34] * x4 + a[42] * x5 + a[50] * x6 + a[58] * x7;
+      y[j + 3] += a[3] * x0 + a[11] * x1 + a[19] * x2 + a[27] * x3 +
+                  a[35] * x4 + a[43] * x5 + a[51] * x6 + a[59] * x7;
+      y[j + 4] += a[4] * x0 + a[12] * x1 + a[20] * x2 + a[28] * x3 +
+                  a[36] * x4 + a[44] * x5 + a[52] * x6 + a[60] * x7;
+      y[j + 5] += a[5] * x0 + a[13] * x1 + a[21] * x2 + a[29] * x3 +
+                  a[37] * x4 + a[45] * x5 + a[53] * x6 + a[61] * x7;
+      y[j + 6] += a[6] * x0 + a[14] * x1 + a[22] * x2 + a[30] * x3 +
+                  a[38] * x4 + a[46] * x5 + a[54] * x6 + a[62] * x7;
+      y[j + 7] += a[7] * x0 + a[15] * x1 + a[23] * x2 + a[31] * x3 +
+                  a[39] * x4 + a[47] * x5 + a[55] * x6 + a[63] * x7;
+      a += 64;
+    }
+
+    x += 8;
+  }
+
+  TacsAddFlops(2 * 64 * rowp[nrows]);
+}
+
 /*
-  Apply the lower-triangular matrix over a column range of a row
-  obtained from a scheduling function.
+  Apply the lower-triangular matrix over groups of rows obtained from
+  the level-set scheduler.
 
   Compute:
-  y <- L[irow, jstart:jend]^{-1} y
-
-  where y is the output array.
+  y <- L^{-1} y
 
-  Note that the scheduler ensures that no two threads are operating on
-  the same data simultaneously.
+  where y is the output array. The rows within a level have no mutual
+  dependencies so entire rows can be processed without further
+  synchronization.
 */
 void *BCSRMatApplyLower8_thread(void *t) {
   BCSRMatThread *tdata = static_cast<BCSRMatThread *>(t);
-  const int nrows = tdata->mat->nrows;
   const int *rowp = tdata->mat->rowp;
   const int *cols = tdata->mat->cols;
   const int *diag = tdata->mat->diag;
   const TacsScalar *A = tdata->mat->A;
   const int group_size = tdata->mat->matvec_group_size;
+  const int *level_rows = tdata->sched_level_rows;
 
   TacsScalar *y = tdata->output;
 
-  while (tdata->num_completed_rows < nrows) {
-    int index, irow, jstart, jend;
-    tdata->apply_lower_sched_job(group_size, &index, &irow, &jstart, &jend);
-
-    if (irow >= 0) {
-      TacsScalar *z = &y[8 * irow];
-
-      for (int i = irow; (i < nrows) && (i < irow + group_size); i++) {
-        int end = diag[i];
-        int k = rowp[i];
-        while ((k < end) && (cols[k] < jstart)) {
-          k++;
-        }
-
-        const TacsScalar *a = &A[64 * k];
-        for (; (k < end) && (cols[k] < jend); k++) {
-          int j = 6 * cols[k];
-
-          z[0] -= a[0] * y[j] + a[1] * y[j + 1] + a[2] * y[j + 2] +
-                  a[3] * y[j + 3] + a[4] * y[j + 4] + a[5] * y[j + 5] +
-                  a[6] * y[j + 6] + a[7] * y[j + 7];
-          z[1] -= a[8] * y[j] + a[9] * y[j + 1] + a[10] * y[j + 2] +
-                  a[11] * y[j + 3] + a[12] * y[j + 4] + a[13] * y[j + 5] +
-                  a[14] * y[j + 6] + a[15] * y[j + 7];
-          z[2] -= a[16] * y[j] + a[17] * y[j + 1] + a[18] * y[j + 2] +
-                  a[19] * y[j + 3] + a[20] * y[j + 4] + a[21] * y[j + 5] +
-                  a[22] * y[j + 6] + a[23] * y[j + 7];
-          z[3] -= a[24] * y[j] + a[25] * y[j + 1] + a[26] * y[j + 2] +
-                  a[27] * y[j + 3] + a[28] * y[j + 4] + a[29] * y[j + 5] +
-                  a[30] * y[j + 6] + a[31] * y[j + 7];
-          z[4] -= a[32] * y[j] + a[33] * y[j + 1] + a[34] * y[j + 2] +
-                  a[35] * y[j + 3] + a[36] * y[j + 4] + a[37] * y[j + 5] +
-                  a[38] * y[j + 6] + a[39] * y[j + 7];
-          z[5] -= a[40] * y[j] + a[41] * y[j + 1] + a[42] * y[j + 2] +
-                  a[43] * y[j + 3] + a[44] * y[j + 4] + a[45] * y[j + 5] +
-                  a[46] * y[j + 6] + a[47] * y[j + 7];
-          z[6] -= a[48] * y[j] + a[49] * y[j + 1] + a[50] * y[j + 2] +
-                  a[51] * y[j + 3] + a[52] * y[j + 4] + a[53] * y[j + 5] +
-                  a[54] * y[j + 6] + a[55] * y[j + 7];
-          z[7] -= a[56] * y[j] + a[57] * y[j + 1] + a[58] * y[j + 2] +
-                  a[59] * y[j + 3] + a[60] * y[j + 4] + a[61] * y[j + 5] +
-                  a[62] * y[j + 6] + a[63] * y[j + 7];
-          a += 64;
-        }
+  while (1) {
+    int start, end;
+    tdata->apply_level_sched_job(group_size, &start, &end);
+    if (start < 0) {
+      break;
+    }
 
-        z += 8;
+    for (int ii = start; ii < end; ii++) {
+      int i = level_rows[ii];
+      TacsScalar *z = &y[8 * i];
+
+      int kend = diag[i];
+      int k = rowp[i];
+      const TacsScalar *a = &A[64 * k];
+      for (; k < kend; k++) {
+        int j = 8 * cols[k];
+
+        z[0] -= a[0] * y[j] + a[1] * y[j + 1] + a[2] * y[j + 2] +
+                a[3] * y[j + 3] + a[4] * y[j + 4] + a[5] * y[j + 5] +
+                a[6] * y[j + 6] + a[7] * y[j + 7];
+        z[1] -= a[8] * y[j] + a[9] * y[j + 1] + a[10] * y[j + 2] +
+                a[11] * y[j + 3] + a[12] * y[j + 4] + a[13] * y[j + 5] +
+                a[14] * y[j + 6] + a[15] * y[j + 7];
+        z[2] -= a[16] * y[j] + a[17] * y[j + 1] + a[18] * y[j + 2] +
+                a[19] * y[j + 3] + a[20] * y[j + 4] + a[21] * y[j + 5] +
+                a[22] * y[j + 6] + a[23] * y[j + 7];
+        z[3] -= a[24] * y[j] + a[25] * y[j + 1] + a[26] * y[j + 2] +
+                a[27] * y[j + 3] + a[28] * y[j + 4] + a[29] * y[j + 5] +
+                a[30] * y[j + 6] + a[31] * y[j + 7];
+        z[4] -= a[32] * y[j] + a[33] * y[j + 1] + a[34] * y[j + 2] +
+                a[35] * y[j + 3] + a[36] * y[j + 4] + a[37] * y[j + 5] +
+                a[38] * y[j + 6] + a[39] * y[j + 7];
+        z[5] -= a[40] * y[j] + a[41] * y[j + 1] + a[42] * y[j + 2] +
+                a[43] * y[j + 3] + a[44] * y[j + 4] + a[45] * y[j + 5] +
+                a[46] * y[j + 6] + a[47] * y[j + 7];
+        z[6] -= a[48] * y[j] + a[49] * y[j + 1] + a[50] * y[j + 2] +
+                a[51] * y[j + 3] + a[52] * y[j + 4] + a[53] * y[j + 5] +
+                a[54] * y[j + 6] + a[55] * y[j + 7];
+        z[7] -= a[56] * y[j] + a[57] * y[j + 1] + a[58] * y[j + 2] +
+                a[59] * y[j + 3] + a[60] * y[j + 4] + a[61] * y[j + 5] +
+                a[62] * y[j + 6] + a[63] * y[j + 7];
+        a += 64;
       }
-
-      tdata->apply_lower_mark_completed(group_size, index, irow, jstart, jend);
     }
+
+    tdata->apply_level_mark_completed(end - start);
   }
 
   pthread_exit(NULL);
 }
 
 /*
-  Apply the upper-triangular matrix over a range of columns dictated
-  by a scheduler.
+  Apply the upper-triangular matrix over groups of rows obtained from
+  the level-set scheduler.
 
   Compute:
-  y <- U[irow, jstart:jend]^{-1} y
+  y <- U^{-1} y
+
+  The rows within a level have no mutual dependencies so entire rows
+  can be processed without further synchronization.
 */
 void *BCSRMatApplyUpper8_thread(void *t) {
   BCSRMatThread *tdata = static_cast<BCSRMatThread *>(t);
-  const int nrows = tdata->mat->nrows;
   const int *rowp = tdata->mat->rowp;
   const int *cols = tdata->mat->cols;
   const int *diag = tdata->mat->diag;
   const TacsScalar *A = tdata->mat->A;
   const int group_size = tdata->mat->matvec_group_size;
+  const int *level_rows = tdata->sched_level_rows;
 
   TacsScalar *y = tdata->output;
 
-  while (tdata->num_completed_rows < nrows) {
-    int index, irow, jstart, jend;
-    tdata->apply_upper_sched_job(group_size, &index, &irow, &jstart, &jend);
-
-    if (irow >= 0) {
-      for (int i = irow - 1; (i >= 0) && (i >= irow - group_size); i--) {
-        int start = diag[i] + 1;
-        int end = rowp[i + 1];
-
-        int k = end - 1;
-        while ((k >= start) && (cols[k] >= jend)) {
-          k--;
-        }
+  while (1) {
+    int start, end;
+    tdata->apply_level_sched_job(group_size, &start, &end);
+    if (start < 0) {
+      break;
+    }
 
-        TacsScalar *z = &y[8 * i];
-        const TacsScalar *a = &A[64 * k];
-        for (; (k >= start) && (cols[k] >= jstart); k--) {
-          int j = 8 * cols[k];
+    for (int ii = start; ii < end; ii++) {
+      int i = level_rows[ii];
+      TacsScalar *z = &y[8 * i];
+      TacsScalar y0 = z[0], y1 = z[1], y2 = z[2], y3 = z[3];
+      TacsScalar y4 = z[4], y5 = z[5], y6 = z[6], y7 = z[7];
 
-          z[0] -= a[0] * y[j] + a[1] * y[j + 1] + a[2] * y[j + 2] +
-                  a[3] * y[j + 3] + a[4] * y[j + 4] + a[5] * y[j + 5] +
-                  a[6] * y[j + 6] + a[7] * y[j + 7];
-          z[1] -= a[8] * y[j] + a[9] * y[j + 1] + a[10] * y[j + 2] +
-                  a[11] * y[j + 3] + a[12] * y[j + 4] + a[13] * y[j + 5] +
-                  a[14] * y[j + 6] + a[15] * y[j + 7];
-          z[2] -= a[16] * y[j] + a[17] * y[j + 1] + a[18] * y[j + 2] +
-                  a[19] * y[j + 3] + a[20] * y[j + 4] + a[21] * y[j + 5] +
-                  a[22] * y[j + 6] + a[23] * y[j + 7];
-          z[3] -= a[24] * y[j] + a[25] * y[j + 1] + a[26] * y[j + 2] +
-                  a[27] * y[j + 3] + a[28] * y[j + 4] + a[29] * y[j + 5] +
-                  a[30] * y[j + 6] + a[31] * y[j + 7];
-          z[4] -= a[32] * y[j] + a[33] * y[j + 1] + a[34] * y[j + 2] +
-                  a[35] * y[j + 3] + a[36] * y[j + 4] + a[37] * y[j + 5] +
-                  a[38] * y[j + 6] + a[39] * y[j + 7];
-          z[5] -= a[40] * y[j] + a[41] * y[j + 1] + a[42] * y[j + 2] +
-                  a[43] * y[j + 3] + a[44] * y[j + 4] + a[45] * y[j + 5] +
-                  a[46] * y[j + 6] + a[47] * y[j + 7];
-          z[6] -= a[48] * y[j] + a[49] * y[j + 1] + a[50] * y[j + 2] +
-                  a[51] * y[j + 3] + a[52] * y[j + 4] + a[53] * y[j + 5] +
-                  a[54] * y[j + 6] + a[55] * y[j + 7];
-          z[7] -= a[56] * y[j] + a[57] * y[j + 1] + a[58] * y[j + 2] +
-                  a[59] * y[j + 3] + a[60] * y[j + 4] + a[61] * y[j + 5] +
-                  a[62] * y[j + 6] + a[63] * y[j + 7];
-          a -= 64;
-        }
+      int kend = rowp[i + 1];
+      int k = diag[i] + 1;
+      const TacsScalar *a = &A[64 * k];
+      for (; k < kend; k++) {
+        int j = 8 * cols[k];
 
-        if (irow == jstart + group_size) {
-          TacsScalar y0 = z[0], y1 = z[1], y2 = z[2], y3 = z[3];
-          TacsScalar y4 = z[4], y5 = z[5], y6 = z[6], y7 = z[7];
-
-          a = &A[64 * (start - 1)];
-          z[0] = a[0] * y0 + a[1] * y1 + a[2] * y2 + a[3] * y3 + a[4] * y4 +
-                 a[5] * y5 + a[6] * y6 + a[7] * y7;
-          z[1] = a[8] * y0 + a[9] * y1 + a[10] * y2 + a[11] * y3 + a[12] * y4 +
-                 a[13] * y5 + a[14] * y6 + a[15] * y7;
-          z[2] = a[16] * y0 + a[17] * y1 + a[18] * y2 + a[19] * y3 +
-                 a[20] * y4 + a[21] * y5 + a[22] * y6 + a[23] * y7;
-          z[3] = a[24] * y0 + a[25] * y1 + a[26] * y2 + a[27] * y3 +
-                 a[28] * y4 + a[29] * y5 + a[30] * y6 + a[31] * y7;
-          z[4] = a[32] * y0 + a[33] * y1 + a[34] * y2 + a[35] * y3 +
-                 a[36] * y4 + a[37] * y5 + a[38] * y6 + a[39] * y7;
-          z[5] = a[40] * y0 + a[41] * y1 + a[42] * y2 + a[43] * y3 +
-                 a[44] * y4 + a[45] * y5 + a[46] * y6 + a[47] * y7;
-          z[6] = a[48] * y0 + a[49] * y1 + a[50] * y2 + a[51] * y3 +
-                 a[52] * y4 + a[53] * y5 + a[54] * y6 + a[55] * y7;
-          z[7] = a[56] * y0 + a[57] * y1 + a[58] * y2 + a[59] * y3 +
-                 a[60] * y4 + a[61] * y5 + a[62] * y6 + a[63] * y7;
-        }
+        y0 -= a[0] * y[j] + a[1] * y[j + 1] + a[2] * y[j + 2] +
+              a[3] * y[j + 3] + a[4] * y[j + 4] + a[5] * y[j + 5] +
+              a[6] * y[j + 6] + a[7] * y[j + 7];
+        y1 -= a[8] * y[j] + a[9] * y[j + 1] + a[10] * y[j + 2] +
+              a[11] * y[j + 3] + a[12] * y[j + 4] + a[13] * y[j + 5] +
+              a[14] * y[j + 6] + a[15] * y[j + 7];
+        y2 -= a[16] * y[j] + a[17] * y[j + 1] + a[18] * y[j + 2] +
+              a[19] * y[j + 3] + a[20] * y[j + 4] + a[21] * y[j + 5] +
+              a[22] * y[j + 6] + a[23] * y[j + 7];
+        y3 -= a[24] * y[j] + a[25] * y[j + 1] + a[26] * y[j + 2] +
+              a[27] * y[j + 3] + a[28] * y[j + 4] + a[29] * y[j + 5] +
+              a[30] * y[j + 6] + a[31] * y[j + 7];
+        y4 -= a[32] * y[j] + a[33] * y[j + 1] + a[34] * y[j + 2] +
+              a[35] * y[j + 3] + a[36] * y[j + 4] + a[37] * y[j + 5] +
+              a[38] * y[j + 6] + a[39] * y[j + 7];
+        y5 -= a[40] * y[j] + a[41] * y[j + 1] + a[42] * y[j + 2] +
+              a[43] * y[j + 3] + a[44] * y[j + 4] + a[45] * y[j + 5] +
+              a[46] * y[j + 6] + a[47] * y[j + 7];
+        y6 -= a[48] * y[j] + a[49] * y[j + 1] + a[50] * y[j + 2] +
+              a[51] * y[j + 3] + a[52] * y[j + 4] + a[53] * y[j + 5] +
+              a[54] * y[j + 6] + a[55] * y[j + 7];
+        y7 -= a[56] * y[j] + a[57] * y[j + 1] + a[58] * y[j + 2] +
+              a[59] * y[j + 3] + a[60] * y[j + 4] + a[61] * y[j + 5] +
+              a[62] * y[j + 6] + a[63] * y[j + 7];
+        a += 64;
       }
 
-      tdata->apply_upper_mark_completed(group_size, index, irow, jstart, jend);
+      a = &A[64 * diag[i]];
+      z[0] = a[0] * y0 + a[1] * y1 + a[2] * y2 + a[3] * y3 + a[4] * y4 +
+             a[5] * y5 + a[6] * y6 + a[7] * y7;
+      z[1] = a[8] * y0 + a[9] * y1 + a[10] * y2 + a[11] * y3 + a[12] * y4 +
+             a[13] * y5 + a[14] * y6 + a[15] * y7;
+      z[2] = a[16] * y0 + a[17] * y1 + a[18] * y2 + a[19] * y3 + a[20] * y4 +
+             a[21] * y5 + a[22] * y6 + a[23] * y7;
+      z[3] = a[24] * y0 + a[25] * y1 + a[26] * y2 + a[27] * y3 + a[28] * y4 +
+             a[29] * y5 + a[30] * y6 + a[31] * y7;
+      z[4] = a[32] * y0 + a[33] * y1 + a[34] * y2 + a[35] * y3 + a[36] * y4 +
+             a[37] * y5 + a[38] * y6 + a[39] * y7;
+      z[5] = a[40] * y0 + a[41] * y1 + a[42] * y2 + a[43] * y3 + a[44] * y4 +
+             a[45] * y5 + a[46] * y6 + a[47] * y7;
+      z[6] = a[48] * y0 + a[49] * y1 + a[50] * y2 + a[51] * y3 + a[52] * y4 +
+             a[53] * y5 + a[54] * y6 + a[55] * y7;
+      z[7] = a[56] * y0 + a[57] * y1 + a[58] * y2 + a[59] * y3 + a[60] * y4 +
+             a[61] * y5 + a[62] * y6 + a[63] * y7;
     }
+
+    tdata->apply_level_mark_completed(end - start);
   }
 
   pthread_exit(NULL);
@@ -2415,3 +2457,63 @@ void BCSRMatApplySOR8(BCSRMatData *Adata, BCSRMatData *Bdata, const int start,
                             d[60] * t5 + d[61] * t6 + d[62] * t7 + d[63] * t8);
   }
 }
+
+/*!
+  Compute the matrix-vector product for multiple right-hand sides:
+  Y = A * X
+
+  The multivectors are packed by block row: the nrhs right-hand
+  sides for block j are stored contiguously at &x[8 * nrhs * j],
+  with the 8 components of each right-hand side adjacent. Each
+  block row of the matrix is streamed through memory only once
+  for all of the right-hand sides.
+*/
+void BCSRMatVecMultRHS8(BCSRMatData *data, int nrhs, TacsScalar *x,
+                        TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *a = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    for (int r = 0; r < 8 * nrhs; r++) {
+      y[r] = 0.0;
+    }
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = 8 * nrhs * cols[k];
+      TacsScalar *yr = y;
+      for (int r = 0; r < nrhs; r++) {
+        yr[0] += a[0] * x[j] + a[1] * x[j + 1] + a[2] * x[j + 2] +
+                 a[3] * x[j + 3] + a[4] * x[j + 4] + a[5] * x[j + 5] +
+                 a[6] * x[j + 6] + a[7] * x[j + 7];
+        yr[1] += a[8] * x[j] + a[9] * x[j + 1] + a[10] * x[j + 2] +
+                 a[11] * x[j + 3] + a[12] * x[j + 4] + a[13] * x[j + 5] +
+                 a[14] * x[j + 6] + a[15] * x[j + 7];
+        yr[2] += a[16] * x[j] + a[17] * x[j + 1] + a[18] * x[j + 2] +
+                 a[19] * x[j + 3] + a[20] * x[j + 4] + a[21] * x[j + 5] +
+                 a[22] * x[j + 6] + a[23] * x[j + 7];
+        yr[3] += a[24] * x[j] + a[25] * x[j + 1] + a[26] * x[j + 2] +
+                 a[27] * x[j + 3] + a[28] * x[j + 4] + a[29] * x[j + 5] +
+                 a[30] * x[j + 6] + a[31] * x[j + 7];
+        yr[4] += a[32] * x[j] + a[33] * x[j + 1] + a[34] * x[j + 2] +
+                 a[35] * x[j + 3] + a[36] * x[j + 4] + a[37] * x[j + 5] +
+                 a[38] * x[j + 6] + a[39] * x[j + 7];
+        yr[5] += a[40] * x[j] + a[41] * x[j + 1] + a[42] * x[j + 2] +
+                 a[43] * x[j + 3] + a[44] * x[j + 4] + a[45] * x[j + 5] +
+                 a[46] * x[j + 6] + a[47] * x[j + 7];
+        yr[6] += a[48] * x[j] + a[49] * x[j + 1] + a[50] * x[j + 2] +
+                 a[51] * x[j + 3] + a[52] * x[j + 4] + a[53] * x[j + 5] +
+                 a[54] * x[j + 6] + a[55] * x[j + 7];
+        yr[7] += a[56] * x[j] + a[57] * x[j + 1] + a[58] * x[j + 2] +
+                 a[59] * x[j + 3] + a[60] * x[j + 4] + a[61] * x[j + 5] +
+                 a[62] * x[j + 6] + a[63] * x[j + 7];
+        j += 8;
+        yr += 8;
+      }
+      a += 64;
+    }
+    y += 8 * nrhs;
+  }
+}
@@ -0,0 +1,127 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "BCSRMatImpl.h"
+
+/*
+  Single-precision triangular solves for a factored matrix.
+
+  These kernels apply the L/U factors from a single-precision copy of
+  the factored matrix values while the non-zero pattern is shared with
+  the full-precision matrix. The triangular solves are bandwidth-bound:
+  halving the size of each matrix entry nearly doubles the effective
+  apply bandwidth, and the reduced preconditioner accuracy is absorbed
+  by the outer Krylov iteration, which remains in full precision.
+
+  The kernels are written for a generic block size so that a single
+  implementation serves every block dimension.
+*/
+
+/*!
+  Apply the lower factorization y = L^{-1} x in single precision
+*/
+void BCSRMatApplyLowerSP(BCSRMatData *data, const TacsSingleScalar *Asp,
+                         TacsSingleScalar *x, TacsSingleScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  const int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  TacsSingleScalar *yy = y;
+  TacsSingleScalar *xx = x;
+
+  for (int i = 0; i < nrows; i++) {
+    if (x != y) {
+      memcpy(yy, xx, bsize * sizeof(TacsSingleScalar));
+    }
+
+    int end = diag[i];
+    int j = rowp[i];
+    const TacsSingleScalar *a = &Asp[b2 * j];
+    for (; j < end; j++) {
+      int bj = bsize * cols[j];
+
+      for (int ii = 0; ii < bsize; ii++) {
+        TacsSingleScalar t = 0.0f;
+        for (int jj = 0; jj < bsize; jj++) {
+          t += a[bsize * ii + jj] * y[bj + jj];
+        }
+        yy[ii] -= t;
+      }
+      a += b2;
+    }
+
+    yy += bsize;
+    xx += bsize;
+  }
+}
+
+/*!
+  Apply the upper factorization y = U^{-1} x in single precision
+*/
+void BCSRMatApplyUpperSP(BCSRMatData *data, const TacsSingleScalar *Asp,
+                         TacsSingleScalar *x, TacsSingleScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  const int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  TacsSingleScalar *ty = new TacsSingleScalar[bsize];
+  TacsSingleScalar *yy = &y[bsize * (nrows - 1)];
+  x = &x[bsize * (nrows - 1)];
+
+  for (int i = nrows - 1; i >= 0; i--) {
+    memcpy(ty, x, bsize * sizeof(TacsSingleScalar));
+
+    int end = rowp[i + 1];
+    int j = diag[i] + 1;
+    const TacsSingleScalar *a = &Asp[b2 * j];
+    const TacsSingleScalar *adiag = &Asp[b2 * diag[i]];
+
+    for (; j < end; j++) {
+      int bj = bsize * cols[j];
+
+      for (int ii = 0; ii < bsize; ii++) {
+        TacsSingleScalar t = 0.0f;
+        for (int jj = 0; jj < bsize; jj++) {
+          t += a[bsize * ii + jj] * y[bj + jj];
+        }
+        ty[ii] -= t;
+      }
+      a += b2;
+    }
+
+    // Multiply by the inverse of the diagonal block
+    for (int ii = 0; ii < bsize; ii++) {
+      TacsSingleScalar t = 0.0f;
+      for (int jj = 0; jj < bsize; jj++) {
+        t += adiag[bsize * ii + jj] * ty[jj];
+      }
+      yy[ii] = t;
+    }
+
+    x -= bsize;
+    yy -= bsize;
+  }
+
+  delete[] ty;
+}
@@ -0,0 +1,1008 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "BCSRMatImpl.h"
+
+/*
+  Explicit SIMD implementations of the block-specific kernels for
+  block sizes 6 and 8.
+
+  These kernels are only compiled for real (double precision) builds
+  on x86-64. The processor capabilities are detected at run time in
+  BCSRMatGetSimdLevel() and the function pointers in
+  BCSRMat::initBlockImpl() fall back to the scalar kernels when the
+  required instructions are not available.
+
+  The mat-vec and triangular-sweep kernels keep one vector accumulator
+  per block row and only perform the horizontal reductions once per
+  matrix row, so the inner loop over the blocks is pure fused
+  multiply-adds. The block matrix-matrix kernels broadcast the entries
+  of A and accumulate whole rows of C at once.
+*/
+
+/*!
+  Detect the SIMD level supported by the processor at run time.
+
+  returns: 0 for no SIMD support, 1 for AVX2+FMA, 2 for AVX-512F
+*/
+int BCSRMatGetSimdLevel() {
+  static int level = -1;
+  if (level < 0) {
+    level = 0;
+#ifdef TACS_BCSR_SIMD
+    if (__builtin_cpu_supports("avx512f")) {
+      level = 2;
+    } else if (__builtin_cpu_supports("avx2") &&
+               __builtin_cpu_supports("fma")) {
+      level = 1;
+    }
+#endif  // TACS_BCSR_SIMD
+  }
+  return level;
+}
+
+#ifdef TACS_BCSR_SIMD
+
+#include <immintrin.h>
+
+/*
+  The AVX2 + FMA kernels
+
+  A 6-wide row is held as a 4-wide ymm register and a 2-wide xmm
+  register; an 8-wide row is held as two ymm registers.
+*/
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+// Horizontally reduce a (ymm, xmm) accumulator pair to a double
+static inline double bcsr_reduce6(__m256d a4, __m128d a2) {
+  __m128d lo = _mm256_castpd256_pd128(a4);
+  __m128d hi = _mm256_extractf128_pd(a4, 1);
+  lo = _mm_add_pd(lo, hi);
+  lo = _mm_add_pd(lo, a2);
+  return _mm_cvtsd_f64(_mm_add_pd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+// Horizontally reduce a pair of ymm accumulators to a double
+static inline double bcsr_reduce8(__m256d a, __m256d b) {
+  a = _mm256_add_pd(a, b);
+  __m128d lo = _mm256_castpd256_pd128(a);
+  __m128d hi = _mm256_extractf128_pd(a, 1);
+  lo = _mm_add_pd(lo, hi);
+  return _mm_cvtsd_f64(_mm_add_pd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+/*!
+  Compute the matrix-vector product: y = A * x for bsize = 6
+*/
+void BCSRMatVecMult6Avx2(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    __m256d acc4[6];
+    __m128d acc2[6];
+    for (int ii = 0; ii < 6; ii++) {
+      acc4[ii] = _mm256_setzero_pd();
+      acc2[ii] = _mm_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[36 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      const TacsScalar *xj = &x[6 * cols[k]];
+      __m256d x4 = _mm256_loadu_pd(xj);
+      __m128d x2 = _mm_loadu_pd(&xj[4]);
+
+      for (int ii = 0; ii < 6; ii++) {
+        acc4[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[6 * ii]), x4, acc4[ii]);
+        acc2[ii] = _mm_fmadd_pd(_mm_loadu_pd(&a[6 * ii + 4]), x2, acc2[ii]);
+      }
+      a += 36;
+    }
+
+    for (int ii = 0; ii < 6; ii++) {
+      y[6 * i + ii] = bcsr_reduce6(acc4[ii], acc2[ii]);
+    }
+  }
+
+  TacsAddFlops(2 * 36 * rowp[nrows]);
+}
+
+/*!
+  Compute the matrix-vector product: z = A * x + y for bsize = 6
+*/
+void BCSRMatVecMultAdd6Avx2(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
+                            TacsScalar *z) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    __m256d acc4[6];
+    __m128d acc2[6];
+    for (int ii = 0; ii < 6; ii++) {
+      acc4[ii] = _mm256_setzero_pd();
+      acc2[ii] = _mm_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[36 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      const TacsScalar *xj = &x[6 * cols[k]];
+      __m256d x4 = _mm256_loadu_pd(xj);
+      __m128d x2 = _mm_loadu_pd(&xj[4]);
+
+      for (int ii = 0; ii < 6; ii++) {
+        acc4[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[6 * ii]), x4, acc4[ii]);
+        acc2[ii] = _mm_fmadd_pd(_mm_loadu_pd(&a[6 * ii + 4]), x2, acc2[ii]);
+      }
+      a += 36;
+    }
+
+    for (int ii = 0; ii < 6; ii++) {
+      z[6 * i + ii] = y[6 * i + ii] + bcsr_reduce6(acc4[ii], acc2[ii]);
+    }
+  }
+
+  TacsAddFlops(2 * 36 * rowp[nrows] + 6 * nrows);
+}
+
+/*!
+  Apply the lower factorization y = L^{-1} x for bsize = 6
+*/
+void BCSRMatApplyLower6Avx2(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *diag = data->diag;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    __m256d acc4[6];
+    __m128d acc2[6];
+    for (int ii = 0; ii < 6; ii++) {
+      acc4[ii] = _mm256_setzero_pd();
+      acc2[ii] = _mm_setzero_pd();
+    }
+
+    int end = diag[i];
+    const TacsScalar *a = &A[36 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      const TacsScalar *yj = &y[6 * cols[k]];
+      __m256d y4 = _mm256_loadu_pd(yj);
+      __m128d y2 = _mm_loadu_pd(&yj[4]);
+
+      for (int ii = 0; ii < 6; ii++) {
+        acc4[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[6 * ii]), y4, acc4[ii]);
+        acc2[ii] = _mm_fmadd_pd(_mm_loadu_pd(&a[6 * ii + 4]), y2, acc2[ii]);
+      }
+      a += 36;
+    }
+
+    for (int ii = 0; ii < 6; ii++) {
+      y[6 * i + ii] = x[6 * i + ii] - bcsr_reduce6(acc4[ii], acc2[ii]);
+    }
+  }
+}
+
+/*!
+  Apply the upper factorization y = U^{-1} x for bsize = 6
+*/
+void BCSRMatApplyUpper6Avx2(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *diag = data->diag;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = nrows - 1; i >= 0; i--) {
+    __m256d acc4[6];
+    __m128d acc2[6];
+    for (int ii = 0; ii < 6; ii++) {
+      acc4[ii] = _mm256_setzero_pd();
+      acc2[ii] = _mm_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[36 * (diag[i] + 1)];
+    for (int k = diag[i] + 1; k < end; k++) {
+      const TacsScalar *yj = &y[6 * cols[k]];
+      __m256d y4 = _mm256_loadu_pd(yj);
+      __m128d y2 = _mm_loadu_pd(&yj[4]);
+
+      for (int ii = 0; ii < 6; ii++) {
+        acc4[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[6 * ii]), y4, acc4[ii]);
+        acc2[ii] = _mm_fmadd_pd(_mm_loadu_pd(&a[6 * ii + 4]), y2, acc2[ii]);
+      }
+      a += 36;
+    }
+
+    double t[6];
+    for (int ii = 0; ii < 6; ii++) {
+      t[ii] = x[6 * i + ii] - bcsr_reduce6(acc4[ii], acc2[ii]);
+    }
+
+    // Multiply by the inverse of the diagonal block
+    __m256d t4 = _mm256_loadu_pd(t);
+    __m128d t2 = _mm_loadu_pd(&t[4]);
+    a = &A[36 * diag[i]];
+    for (int ii = 0; ii < 6; ii++) {
+      __m256d d4 = _mm256_mul_pd(_mm256_loadu_pd(&a[6 * ii]), t4);
+      __m128d d2 = _mm_mul_pd(_mm_loadu_pd(&a[6 * ii + 4]), t2);
+      y[6 * i + ii] = bcsr_reduce6(d4, d2);
+    }
+  }
+}
+
+/*!
+  Compute the matrix-matrix product: C += A * B for bsize = 6
+*/
+void BCSRMatMatMultAdd6Avx2(double alpha, BCSRMatData *Adata,
+                            BCSRMatData *Bdata, BCSRMatData *Cdata) {
+  // The SIMD path only handles alpha = 1.0 - delegate other scalings
+  // to the scalar kernel
+  if (alpha != 1.0) {
+    BCSRMatMatMultAdd6(alpha, Adata, Bdata, Cdata);
+    return;
+  }
+
+  const int nrows_a = Adata->nrows;
+  const int *arowp = Adata->rowp;
+  const int *acols = Adata->cols;
+  const TacsScalar *A = Adata->A;
+
+  const int *browp = Bdata->rowp;
+  const int *bcols = Bdata->cols;
+  const TacsScalar *B = Bdata->A;
+
+  const int *crowp = Cdata->rowp;
+  const int *ccols = Cdata->cols;
+  TacsScalar *C = Cdata->A;
+
+  for (int i = 0; i < nrows_a; i++) {
+    for (int jp = arowp[i]; jp < arowp[i + 1]; jp++) {
+      int j = acols[jp];
+      const TacsScalar *a = &A[36 * jp];
+
+      int kp = browp[j];
+      int kp_end = browp[j + 1];
+      const TacsScalar *b = &B[36 * kp];
+
+      int cp = crowp[i];
+      int cp_end = crowp[i + 1];
+      TacsScalar *c = &C[36 * cp];
+
+      for (; kp < kp_end; kp++) {
+        while ((cp < cp_end) && (ccols[cp] < bcols[kp])) {
+          cp++;
+          c += 36;
+        }
+        if (cp >= cp_end) {
+          break;
+        }
+
+        if (bcols[kp] == ccols[cp]) {
+          // Load the rows of the B block
+          __m256d b4[6];
+          __m128d b2[6];
+          for (int kk = 0; kk < 6; kk++) {
+            b4[kk] = _mm256_loadu_pd(&b[6 * kk]);
+            b2[kk] = _mm_loadu_pd(&b[6 * kk + 4]);
+          }
+
+          // c_row(ii) += sum_kk a[ii][kk] * b_row(kk)
+          for (int ii = 0; ii < 6; ii++) {
+            __m256d c4 = _mm256_loadu_pd(&c[6 * ii]);
+            __m128d c2 = _mm_loadu_pd(&c[6 * ii + 4]);
+            for (int kk = 0; kk < 6; kk++) {
+              __m256d av4 = _mm256_set1_pd(a[6 * ii + kk]);
+              __m128d av2 = _mm_set1_pd(a[6 * ii + kk]);
+              c4 = _mm256_fmadd_pd(av4, b4[kk], c4);
+              c2 = _mm_fmadd_pd(av2, b2[kk], c2);
+            }
+            _mm256_storeu_pd(&c[6 * ii], c4);
+            _mm_storeu_pd(&c[6 * ii + 4], c2);
+          }
+        }
+        b += 36;
+      }
+    }
+  }
+}
+
+/*!
+  Compute the matrix-vector product: y = A * x for bsize = 8
+*/
+void BCSRMatVecMult8Avx2(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    __m256d lo[8], hi[8];
+    for (int ii = 0; ii < 8; ii++) {
+      lo[ii] = _mm256_setzero_pd();
+      hi[ii] = _mm256_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[64 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      const TacsScalar *xj = &x[8 * cols[k]];
+      __m256d xlo = _mm256_loadu_pd(xj);
+      __m256d xhi = _mm256_loadu_pd(&xj[4]);
+
+      for (int ii = 0; ii < 8; ii++) {
+        lo[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[8 * ii]), xlo, lo[ii]);
+        hi[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[8 * ii + 4]), xhi, hi[ii]);
+      }
+      a += 64;
+    }
+
+    for (int ii = 0; ii < 8; ii++) {
+      y[8 * i + ii] = bcsr_reduce8(lo[ii], hi[ii]);
+    }
+  }
+
+  TacsAddFlops(2 * 64 * rowp[nrows]);
+}
+
+/*!
+  Compute the matrix-vector product: z = A * x + y for bsize = 8
+*/
+void BCSRMatVecMultAdd8Avx2(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
+                            TacsScalar *z) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    __m256d lo[8], hi[8];
+    for (int ii = 0; ii < 8; ii++) {
+      lo[ii] = _mm256_setzero_pd();
+      hi[ii] = _mm256_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[64 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      const TacsScalar *xj = &x[8 * cols[k]];
+      __m256d xlo = _mm256_loadu_pd(xj);
+      __m256d xhi = _mm256_loadu_pd(&xj[4]);
+
+      for (int ii = 0; ii < 8; ii++) {
+        lo[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[8 * ii]), xlo, lo[ii]);
+        hi[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[8 * ii + 4]), xhi, hi[ii]);
+      }
+      a += 64;
+    }
+
+    for (int ii = 0; ii < 8; ii++) {
+      z[8 * i + ii] = y[8 * i + ii] + bcsr_reduce8(lo[ii], hi[ii]);
+    }
+  }
+
+  TacsAddFlops(2 * 64 * rowp[nrows] + 8 * nrows);
+}
+
+/*!
+  Apply the lower factorization y = L^{-1} x for bsize = 8
+*/
+void BCSRMatApplyLower8Avx2(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *diag = data->diag;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    __m256d lo[8], hi[8];
+    for (int ii = 0; ii < 8; ii++) {
+      lo[ii] = _mm256_setzero_pd();
+      hi[ii] = _mm256_setzero_pd();
+    }
+
+    int end = diag[i];
+    const TacsScalar *a = &A[64 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      const TacsScalar *yj = &y[8 * cols[k]];
+      __m256d ylo = _mm256_loadu_pd(yj);
+      __m256d yhi = _mm256_loadu_pd(&yj[4]);
+
+      for (int ii = 0; ii < 8; ii++) {
+        lo[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[8 * ii]), ylo, lo[ii]);
+        hi[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[8 * ii + 4]), yhi, hi[ii]);
+      }
+      a += 64;
+    }
+
+    for (int ii = 0; ii < 8; ii++) {
+      y[8 * i + ii] = x[8 * i + ii] - bcsr_reduce8(lo[ii], hi[ii]);
+    }
+  }
+}
+
+/*!
+  Apply the upper factorization y = U^{-1} x for bsize = 8
+*/
+void BCSRMatApplyUpper8Avx2(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *diag = data->diag;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = nrows - 1; i >= 0; i--) {
+    __m256d lo[8], hi[8];
+    for (int ii = 0; ii < 8; ii++) {
+      lo[ii] = _mm256_setzero_pd();
+      hi[ii] = _mm256_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[64 * (diag[i] + 1)];
+    for (int k = diag[i] + 1; k < end; k++) {
+      const TacsScalar *yj = &y[8 * cols[k]];
+      __m256d ylo = _mm256_loadu_pd(yj);
+      __m256d yhi = _mm256_loadu_pd(&yj[4]);
+
+      for (int ii = 0; ii < 8; ii++) {
+        lo[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[8 * ii]), ylo, lo[ii]);
+        hi[ii] = _mm256_fmadd_pd(_mm256_loadu_pd(&a[8 * ii + 4]), yhi, hi[ii]);
+      }
+      a += 64;
+    }
+
+    double t[8];
+    for (int ii = 0; ii < 8; ii++) {
+      t[ii] = x[8 * i + ii] - bcsr_reduce8(lo[ii], hi[ii]);
+    }
+
+    // Multiply by the inverse of the diagonal block
+    __m256d tlo = _mm256_loadu_pd(t);
+    __m256d thi = _mm256_loadu_pd(&t[4]);
+    a = &A[64 * diag[i]];
+    for (int ii = 0; ii < 8; ii++) {
+      __m256d dlo = _mm256_mul_pd(_mm256_loadu_pd(&a[8 * ii]), tlo);
+      __m256d dhi = _mm256_mul_pd(_mm256_loadu_pd(&a[8 * ii + 4]), thi);
+      y[8 * i + ii] = bcsr_reduce8(dlo, dhi);
+    }
+  }
+}
+
+/*!
+  Compute the matrix-matrix product: C += A * B for bsize = 8
+*/
+void BCSRMatMatMultAdd8Avx2(double alpha, BCSRMatData *Adata,
+                            BCSRMatData *Bdata, BCSRMatData *Cdata) {
+  // The SIMD path only handles alpha = 1.0 - delegate other scalings
+  // to the scalar kernel
+  if (alpha != 1.0) {
+    BCSRMatMatMultAdd8(alpha, Adata, Bdata, Cdata);
+    return;
+  }
+
+  const int nrows_a = Adata->nrows;
+  const int *arowp = Adata->rowp;
+  const int *acols = Adata->cols;
+  const TacsScalar *A = Adata->A;
+
+  const int *browp = Bdata->rowp;
+  const int *bcols = Bdata->cols;
+  const TacsScalar *B = Bdata->A;
+
+  const int *crowp = Cdata->rowp;
+  const int *ccols = Cdata->cols;
+  TacsScalar *C = Cdata->A;
+
+  for (int i = 0; i < nrows_a; i++) {
+    for (int jp = arowp[i]; jp < arowp[i + 1]; jp++) {
+      int j = acols[jp];
+      const TacsScalar *a = &A[64 * jp];
+
+      int kp = browp[j];
+      int kp_end = browp[j + 1];
+      const TacsScalar *b = &B[64 * kp];
+
+      int cp = crowp[i];
+      int cp_end = crowp[i + 1];
+      TacsScalar *c = &C[64 * cp];
+
+      for (; kp < kp_end; kp++) {
+        while ((cp < cp_end) && (ccols[cp] < bcols[kp])) {
+          cp++;
+          c += 64;
+        }
+        if (cp >= cp_end) {
+          break;
+        }
+
+        if (bcols[kp] == ccols[cp]) {
+          // Load the rows of the B block
+          __m256d blo[8], bhi[8];
+          for (int kk = 0; kk < 8; kk++) {
+            blo[kk] = _mm256_loadu_pd(&b[8 * kk]);
+            bhi[kk] = _mm256_loadu_pd(&b[8 * kk + 4]);
+          }
+
+          // c_row(ii) += sum_kk a[ii][kk] * b_row(kk)
+          for (int ii = 0; ii < 8; ii++) {
+            __m256d clo = _mm256_loadu_pd(&c[8 * ii]);
+            __m256d chi = _mm256_loadu_pd(&c[8 * ii + 4]);
+            for (int kk = 0; kk < 8; kk++) {
+              __m256d av = _mm256_set1_pd(a[8 * ii + kk]);
+              clo = _mm256_fmadd_pd(av, blo[kk], clo);
+              chi = _mm256_fmadd_pd(av, bhi[kk], chi);
+            }
+            _mm256_storeu_pd(&c[8 * ii], clo);
+            _mm256_storeu_pd(&c[8 * ii + 4], chi);
+          }
+        }
+        b += 64;
+      }
+    }
+  }
+}
+
+#pragma GCC pop_options
+
+/*
+  The AVX-512F kernels
+
+  A 6-wide row is held in a masked zmm register (mask 0x3f); an 8-wide
+  row fills a zmm register exactly.
+*/
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+
+/*!
+  Compute the matrix-vector product: y = A * x for bsize = 6
+*/
+void BCSRMatVecMult6Avx512(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+  const __mmask8 m6 = 0x3f;
+
+  for (int i = 0; i < nrows; i++) {
+    __m512d acc[6];
+    for (int ii = 0; ii < 6; ii++) {
+      acc[ii] = _mm512_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[36 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      __m512d xv = _mm512_maskz_loadu_pd(m6, &x[6 * cols[k]]);
+      for (int ii = 0; ii < 6; ii++) {
+        acc[ii] = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m6, &a[6 * ii]), xv,
+                                  acc[ii]);
+      }
+      a += 36;
+    }
+
+    for (int ii = 0; ii < 6; ii++) {
+      y[6 * i + ii] = _mm512_reduce_add_pd(acc[ii]);
+    }
+  }
+
+  TacsAddFlops(2 * 36 * rowp[nrows]);
+}
+
+/*!
+  Compute the matrix-vector product: z = A * x + y for bsize = 6
+*/
+void BCSRMatVecMultAdd6Avx512(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
+                              TacsScalar *z) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+  const __mmask8 m6 = 0x3f;
+
+  for (int i = 0; i < nrows; i++) {
+    __m512d acc[6];
+    for (int ii = 0; ii < 6; ii++) {
+      acc[ii] = _mm512_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[36 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      __m512d xv = _mm512_maskz_loadu_pd(m6, &x[6 * cols[k]]);
+      for (int ii = 0; ii < 6; ii++) {
+        acc[ii] = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m6, &a[6 * ii]), xv,
+                                  acc[ii]);
+      }
+      a += 36;
+    }
+
+    for (int ii = 0; ii < 6; ii++) {
+      z[6 * i + ii] = y[6 * i + ii] + _mm512_reduce_add_pd(acc[ii]);
+    }
+  }
+
+  TacsAddFlops(2 * 36 * rowp[nrows] + 6 * nrows);
+}
+
+/*!
+  Apply the lower factorization y = L^{-1} x for bsize = 6
+*/
+void BCSRMatApplyLower6Avx512(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *diag = data->diag;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+  const __mmask8 m6 = 0x3f;
+
+  for (int i = 0; i < nrows; i++) {
+    __m512d acc[6];
+    for (int ii = 0; ii < 6; ii++) {
+      acc[ii] = _mm512_setzero_pd();
+    }
+
+    int end = diag[i];
+    const TacsScalar *a = &A[36 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      __m512d yv = _mm512_maskz_loadu_pd(m6, &y[6 * cols[k]]);
+      for (int ii = 0; ii < 6; ii++) {
+        acc[ii] = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m6, &a[6 * ii]), yv,
+                                  acc[ii]);
+      }
+      a += 36;
+    }
+
+    for (int ii = 0; ii < 6; ii++) {
+      y[6 * i + ii] = x[6 * i + ii] - _mm512_reduce_add_pd(acc[ii]);
+    }
+  }
+}
+
+/*!
+  Apply the upper factorization y = U^{-1} x for bsize = 6
+*/
+void BCSRMatApplyUpper6Avx512(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *diag = data->diag;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+  const __mmask8 m6 = 0x3f;
+
+  for (int i = nrows - 1; i >= 0; i--) {
+    __m512d acc[6];
+    for (int ii = 0; ii < 6; ii++) {
+      acc[ii] = _mm512_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[36 * (diag[i] + 1)];
+    for (int k = diag[i] + 1; k < end; k++) {
+      __m512d yv = _mm512_maskz_loadu_pd(m6, &y[6 * cols[k]]);
+      for (int ii = 0; ii < 6; ii++) {
+        acc[ii] = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m6, &a[6 * ii]), yv,
+                                  acc[ii]);
+      }
+      a += 36;
+    }
+
+    double t[6];
+    for (int ii = 0; ii < 6; ii++) {
+      t[ii] = x[6 * i + ii] - _mm512_reduce_add_pd(acc[ii]);
+    }
+
+    // Multiply by the inverse of the diagonal block
+    __m512d tv = _mm512_maskz_loadu_pd(m6, t);
+    a = &A[36 * diag[i]];
+    for (int ii = 0; ii < 6; ii++) {
+      __m512d dv = _mm512_mul_pd(_mm512_maskz_loadu_pd(m6, &a[6 * ii]), tv);
+      y[6 * i + ii] = _mm512_reduce_add_pd(dv);
+    }
+  }
+}
+
+/*!
+  Compute the matrix-matrix product: C += A * B for bsize = 6
+*/
+void BCSRMatMatMultAdd6Avx512(double alpha, BCSRMatData *Adata,
+                              BCSRMatData *Bdata, BCSRMatData *Cdata) {
+  // The SIMD path only handles alpha = 1.0 - delegate other scalings
+  // to the scalar kernel
+  if (alpha != 1.0) {
+    BCSRMatMatMultAdd6(alpha, Adata, Bdata, Cdata);
+    return;
+  }
+
+  const int nrows_a = Adata->nrows;
+  const int *arowp = Adata->rowp;
+  const int *acols = Adata->cols;
+  const TacsScalar *A = Adata->A;
+
+  const int *browp = Bdata->rowp;
+  const int *bcols = Bdata->cols;
+  const TacsScalar *B = Bdata->A;
+
+  const int *crowp = Cdata->rowp;
+  const int *ccols = Cdata->cols;
+  TacsScalar *C = Cdata->A;
+  const __mmask8 m6 = 0x3f;
+
+  for (int i = 0; i < nrows_a; i++) {
+    for (int jp = arowp[i]; jp < arowp[i + 1]; jp++) {
+      int j = acols[jp];
+      const TacsScalar *a = &A[36 * jp];
+
+      int kp = browp[j];
+      int kp_end = browp[j + 1];
+      const TacsScalar *b = &B[36 * kp];
+
+      int cp = crowp[i];
+      int cp_end = crowp[i + 1];
+      TacsScalar *c = &C[36 * cp];
+
+      for (; kp < kp_end; kp++) {
+        while ((cp < cp_end) && (ccols[cp] < bcols[kp])) {
+          cp++;
+          c += 36;
+        }
+        if (cp >= cp_end) {
+          break;
+        }
+
+        if (bcols[kp] == ccols[cp]) {
+          // Load the rows of the B block
+          __m512d bv[6];
+          for (int kk = 0; kk < 6; kk++) {
+            bv[kk] = _mm512_maskz_loadu_pd(m6, &b[6 * kk]);
+          }
+
+          // c_row(ii) += sum_kk a[ii][kk] * b_row(kk)
+          for (int ii = 0; ii < 6; ii++) {
+            __m512d cv = _mm512_maskz_loadu_pd(m6, &c[6 * ii]);
+            for (int kk = 0; kk < 6; kk++) {
+              cv = _mm512_fmadd_pd(_mm512_set1_pd(a[6 * ii + kk]), bv[kk], cv);
+            }
+            _mm512_mask_storeu_pd(&c[6 * ii], m6, cv);
+          }
+        }
+        b += 36;
+      }
+    }
+  }
+}
+
+/*!
+  Compute the matrix-vector product: y = A * x for bsize = 8
+*/
+void BCSRMatVecMult8Avx512(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    __m512d acc[8];
+    for (int ii = 0; ii < 8; ii++) {
+      acc[ii] = _mm512_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[64 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      __m512d xv = _mm512_loadu_pd(&x[8 * cols[k]]);
+      for (int ii = 0; ii < 8; ii++) {
+        acc[ii] = _mm512_fmadd_pd(_mm512_loadu_pd(&a[8 * ii]), xv, acc[ii]);
+      }
+      a += 64;
+    }
+
+    for (int ii = 0; ii < 8; ii++) {
+      y[8 * i + ii] = _mm512_reduce_add_pd(acc[ii]);
+    }
+  }
+
+  TacsAddFlops(2 * 64 * rowp[nrows]);
+}
+
+/*!
+  Compute the matrix-vector product: z = A * x + y for bsize = 8
+*/
+void BCSRMatVecMultAdd8Avx512(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
+                              TacsScalar *z) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    __m512d acc[8];
+    for (int ii = 0; ii < 8; ii++) {
+      acc[ii] = _mm512_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[64 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      __m512d xv = _mm512_loadu_pd(&x[8 * cols[k]]);
+      for (int ii = 0; ii < 8; ii++) {
+        acc[ii] = _mm512_fmadd_pd(_mm512_loadu_pd(&a[8 * ii]), xv, acc[ii]);
+      }
+      a += 64;
+    }
+
+    for (int ii = 0; ii < 8; ii++) {
+      z[8 * i + ii] = y[8 * i + ii] + _mm512_reduce_add_pd(acc[ii]);
+    }
+  }
+
+  TacsAddFlops(2 * 64 * rowp[nrows] + 8 * nrows);
+}
+
+/*!
+  Apply the lower factorization y = L^{-1} x for bsize = 8
+*/
+void BCSRMatApplyLower8Avx512(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *diag = data->diag;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = 0; i < nrows; i++) {
+    __m512d acc[8];
+    for (int ii = 0; ii < 8; ii++) {
+      acc[ii] = _mm512_setzero_pd();
+    }
+
+    int end = diag[i];
+    const TacsScalar *a = &A[64 * rowp[i]];
+    for (int k = rowp[i]; k < end; k++) {
+      __m512d yv = _mm512_loadu_pd(&y[8 * cols[k]]);
+      for (int ii = 0; ii < 8; ii++) {
+        acc[ii] = _mm512_fmadd_pd(_mm512_loadu_pd(&a[8 * ii]), yv, acc[ii]);
+      }
+      a += 64;
+    }
+
+    for (int ii = 0; ii < 8; ii++) {
+      y[8 * i + ii] = x[8 * i + ii] - _mm512_reduce_add_pd(acc[ii]);
+    }
+  }
+}
+
+/*!
+  Apply the upper factorization y = U^{-1} x for bsize = 8
+*/
+void BCSRMatApplyUpper8Avx512(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *diag = data->diag;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const TacsScalar *A = data->A;
+
+  for (int i = nrows - 1; i >= 0; i--) {
+    __m512d acc[8];
+    for (int ii = 0; ii < 8; ii++) {
+      acc[ii] = _mm512_setzero_pd();
+    }
+
+    int end = rowp[i + 1];
+    const TacsScalar *a = &A[64 * (diag[i] + 1)];
+    for (int k = diag[i] + 1; k < end; k++) {
+      __m512d yv = _mm512_loadu_pd(&y[8 * cols[k]]);
+      for (int ii = 0; ii < 8; ii++) {
+        acc[ii] = _mm512_fmadd_pd(_mm512_loadu_pd(&a[8 * ii]), yv, acc[ii]);
+      }
+      a += 64;
+    }
+
+    double t[8];
+    for (int ii = 0; ii < 8; ii++) {
+      t[ii] = x[8 * i + ii] - _mm512_reduce_add_pd(acc[ii]);
+    }
+
+    // Multiply by the inverse of the diagonal block
+    __m512d tv = _mm512_loadu_pd(t);
+    a = &A[64 * diag[i]];
+    for (int ii = 0; ii < 8; ii++) {
+      __m512d dv = _mm512_mul_pd(_mm512_loadu_pd(&a[8 * ii]), tv);
+      y[8 * i + ii] = _mm512_reduce_add_pd(dv);
+    }
+  }
+}
+
+/*!
+  Compute the matrix-matrix product: C += A * B for bsize = 8
+*/
+void BCSRMatMatMultAdd8Avx512(double alpha, BCSRMatData *Adata,
+                              BCSRMatData *Bdata, BCSRMatData *Cdata) {
+  // The SIMD path only handles alpha = 1.0 - delegate other scalings
+  // to the scalar kernel
+  if (alpha != 1.0) {
+    BCSRMatMatMultAdd8(alpha, Adata, Bdata, Cdata);
+    return;
+  }
+
+  const int nrows_a = Adata->nrows;
+  const int *arowp = Adata->rowp;
+  const int *acols = Adata->cols;
+  const TacsScalar *A = Adata->A;
+
+  const int *browp = Bdata->rowp;
+  const int *bcols = Bdata->cols;
+  const TacsScalar *B = Bdata->A;
+
+  const int *crowp = Cdata->rowp;
+  const int *ccols = Cdata->cols;
+  TacsScalar *C = Cdata->A;
+
+  for (int i = 0; i < nrows_a; i++) {
+    for (int jp = arowp[i]; jp < arowp[i + 1]; jp++) {
+      int j = acols[jp];
+      const TacsScalar *a = &A[64 * jp];
+
+      int kp = browp[j];
+      int kp_end = browp[j + 1];
+      const TacsScalar *b = &B[64 * kp];
+
+      int cp = crowp[i];
+      int cp_end = crowp[i + 1];
+      TacsScalar *c = &C[64 * cp];
+
+      for (; kp < kp_end; kp++) {
+        while ((cp < cp_end) && (ccols[cp] < bcols[kp])) {
+          cp++;
+          c += 64;
+        }
+        if (cp >= cp_end) {
+          break;
+        }
+
+        if (bcols[kp] == ccols[cp]) {
+          // Load the rows of the B block
+          __m512d bv[8];
+          for (int kk = 0; kk < 8; kk++) {
+            bv[kk] = _mm512_loadu_pd(&b[8 * kk]);
+          }
+
+          // c_row(ii) += sum_kk a[ii][kk] * b_row(kk)
+          for (int ii = 0; ii < 8; ii++) {
+            __m512d cv = _mm512_loadu_pd(&c[8 * ii]);
+            for (int kk = 0; kk < 8; kk++) {
+              cv = _mm512_fmadd_pd(_mm512_set1_pd(a[8 * ii + kk]), bv[kk], cv);
+            }
+            _mm512_storeu_pd(&c[8 * ii], cv);
+          }
+        }
+        b += 64;
+      }
+    }
+  }
+}
+
+#pragma GCC pop_options
+
+#endif  // TACS_BCSR_SIMD
@@ -0,0 +1,393 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include <math.h>
+
+#include "BCSRMatImpl.h"
+#include "TacsUtilities.h"
+#include "tacslapack.h"
+
+/*
+  Kernels for the symmetric (upper-triangle) storage mode.
+
+  Only the blocks with column >= row are stored. Each stored
+  off-diagonal block A_{ij} represents both itself and its transpose
+  A_{ji} = A_{ij}^{T}, so the mat-vec kernels process each block twice
+  - once for the row and once scattered into the column - and the
+  matrix traffic is halved relative to the full storage.
+
+  The factorization computes the Cholesky-style decomposition
+  A = R^{T}*R restricted to the stored non-zero pattern, where R is
+  block upper triangular. Following the convention of the LU kernels,
+  the diagonal slot of each factored row stores the inverse L^{-1} of
+  the dense Cholesky factor of the (updated) diagonal block
+  A_{ii} = L*L^{T}, so that the triangular sweeps multiply by a stored
+  block rather than solving a small system. The off-diagonal slots
+  store R_{ij} = L^{-1}*A_{ij}.
+*/
+
+/*!
+  Compute the matrix-vector product y = A*x with symmetric storage
+
+  Each stored block contributes A_{ij}*x_{j} to y_{i} and, for the
+  off-diagonal blocks, A_{ij}^{T}*x_{i} to y_{j}. Because the column
+  contributions scatter across the output vector, this kernel has no
+  threaded counterpart.
+*/
+void BCSRMatVecMultSymm(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = 1.0;
+  TacsScalar beta = 1.0;
+
+  memset(y, 0, bsize * nrows * sizeof(TacsScalar));
+
+  TacsScalar *a = data->A;
+  for (int i = 0; i < nrows; i++) {
+    TacsScalar *yi = &y[bsize * i];
+    TacsScalar *xi = &x[bsize * i];
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = cols[k];
+      int bj = bsize * j;
+
+      // y_{i} += A_{ij}*x_{j}
+      BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &x[bj], &one, &beta, yi,
+               &one);
+
+      if (j != i) {
+        // y_{j} += A_{ij}^{T}*x_{i}
+        BLASgemv("N", &bsize, &bsize, &alpha, a, &bsize, xi, &one, &beta,
+                 &y[bj], &one);
+      }
+      a += b2;
+    }
+  }
+}
+
+/*!
+  Compute y = A*x + z with symmetric storage
+
+  The add vector is copied into the output up front since the column
+  contributions scatter across all of the rows.
+*/
+void BCSRMatVecMultAddSymm(BCSRMatData *data, TacsScalar *x, TacsScalar *y,
+                           TacsScalar *z) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = 1.0;
+  TacsScalar beta = 1.0;
+
+  if (z != y) {
+    memcpy(y, z, bsize * nrows * sizeof(TacsScalar));
+  }
+
+  TacsScalar *a = data->A;
+  for (int i = 0; i < nrows; i++) {
+    TacsScalar *yi = &y[bsize * i];
+    TacsScalar *xi = &x[bsize * i];
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = cols[k];
+      int bj = bsize * j;
+
+      BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &x[bj], &one, &beta, yi,
+               &one);
+
+      if (j != i) {
+        BLASgemv("N", &bsize, &bsize, &alpha, a, &bsize, xi, &one, &beta,
+                 &y[bj], &one);
+      }
+      a += b2;
+    }
+  }
+}
+
+/*!
+  Compute Y = A*X with symmetric storage for multiple right-hand sides
+
+  The multivectors use the same packing as BCSRMatVecMultRHS: the nrhs
+  right-hand sides for block row j are stored contiguously at
+  &x[bsize*nrhs*j] with the bsize components of each vector adjacent.
+*/
+void BCSRMatVecMultRHSSymm(BCSRMatData *data, int nrhs, TacsScalar *x,
+                           TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = 1.0;
+  TacsScalar beta = 1.0;
+
+  memset(y, 0, bsize * nrhs * nrows * sizeof(TacsScalar));
+
+  TacsScalar *a = data->A;
+  for (int i = 0; i < nrows; i++) {
+    TacsScalar *yi = &y[bsize * nrhs * i];
+    TacsScalar *xi = &x[bsize * nrhs * i];
+
+    int end = rowp[i + 1];
+    for (int k = rowp[i]; k < end; k++) {
+      int j = cols[k];
+      int bj = bsize * nrhs * j;
+
+      for (int r = 0; r < nrhs; r++) {
+        BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &x[bj + bsize * r],
+                 &one, &beta, &yi[bsize * r], &one);
+
+        if (j != i) {
+          BLASgemv("N", &bsize, &bsize, &alpha, a, &bsize, &xi[bsize * r],
+                   &one, &beta, &y[bj + bsize * r], &one);
+        }
+      }
+      a += b2;
+    }
+  }
+}
+
+/*!
+  Compute the Cholesky-style factorization A = R^{T}*R in place
+
+  The factorization is restricted to the stored upper-triangle
+  pattern: updates that fall outside the pattern are dropped, so this
+  is an incomplete Cholesky factorization on an assembled pattern and
+  an exact one when the pattern contains the full fill. The updated
+  diagonal blocks must remain positive definite - an indefinite block
+  stops the factorization with an error message.
+*/
+void BCSRMatFactorSymm(BCSRMatData *data) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  const int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+  TacsScalar *A = data->A;
+
+  // The dense Cholesky factor of the diagonal block and a temporary
+  // block for the triangular scaling of the off-diagonal blocks
+  TacsScalar *L = new TacsScalar[b2];
+  TacsScalar *T = new TacsScalar[b2];
+
+  for (int i = 0; i < nrows; i++) {
+    if (diag[i] < 0) {
+      fprintf(stderr, "Error in factorization: no diagonal entry for row %d\n",
+              i);
+      delete[] L;
+      delete[] T;
+      return;
+    }
+
+    // Compute the dense Cholesky factorization A_{ii} = L*L^{T} of
+    // the (already updated) diagonal block
+    TacsScalar *d = &A[b2 * diag[i]];
+    for (int m = 0; m < bsize; m++) {
+      for (int n = 0; n <= m; n++) {
+        TacsScalar s = d[bsize * m + n];
+        for (int p = 0; p < n; p++) {
+          s -= L[bsize * m + p] * L[bsize * n + p];
+        }
+
+        if (m == n) {
+          if (TacsRealPart(s) <= 0.0) {
+            fprintf(stderr,
+                    "Error in factorization: non-positive pivot in row %d\n",
+                    i);
+            delete[] L;
+            delete[] T;
+            return;
+          }
+          L[bsize * m + m] = sqrt(s);
+        } else {
+          L[bsize * m + n] = s / L[bsize * n + n];
+        }
+      }
+    }
+
+    // Invert the triangular factor and store L^{-1} in the diagonal
+    // slot - the triangular sweeps multiply by this stored block
+    for (int n = 0; n < bsize; n++) {
+      d[bsize * n + n] = 1.0 / L[bsize * n + n];
+      for (int m = 0; m < n; m++) {
+        d[bsize * m + n] = 0.0;
+      }
+      for (int m = n + 1; m < bsize; m++) {
+        TacsScalar s = 0.0;
+        for (int p = n; p < m; p++) {
+          s += L[bsize * m + p] * d[bsize * p + n];
+        }
+        d[bsize * m + n] = -s / L[bsize * m + m];
+      }
+    }
+
+    // Scale the off-diagonal blocks of the row: R_{ij} = L^{-1}*A_{ij}
+    int row_end = rowp[i + 1];
+    for (int k = diag[i] + 1; k < row_end; k++) {
+      TacsScalar *a = &A[b2 * k];
+      for (int m = 0; m < bsize; m++) {
+        for (int n = 0; n < bsize; n++) {
+          TacsScalar s = 0.0;
+          for (int p = 0; p <= m; p++) {
+            s += d[bsize * m + p] * a[bsize * p + n];
+          }
+          T[bsize * m + n] = s;
+        }
+      }
+      memcpy(a, T, b2 * sizeof(TacsScalar));
+    }
+
+    // Apply the trailing update A_{jk} -= R_{ij}^{T}*R_{ik} for the
+    // pairs of stored blocks in this row. Updates that fall outside
+    // the stored pattern are dropped.
+    for (int ki = diag[i] + 1; ki < row_end; ki++) {
+      int ci = cols[ki];
+      const TacsScalar *ai = &A[b2 * ki];
+
+      int row_size = rowp[ci + 1] - rowp[ci];
+      const int *col_array = &cols[rowp[ci]];
+
+      for (int kj = ki; kj < row_end; kj++) {
+        int *item = TacsSearchArray(cols[kj], row_size, col_array);
+        if (item) {
+          const TacsScalar *aj = &A[b2 * kj];
+          TacsScalar *c = &A[b2 * (item - cols)];
+
+          for (int m = 0; m < bsize; m++) {
+            for (int n = 0; n < bsize; n++) {
+              TacsScalar s = 0.0;
+              for (int p = 0; p < bsize; p++) {
+                s += ai[bsize * p + m] * aj[bsize * p + n];
+              }
+              c[bsize * m + n] -= s;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  delete[] L;
+  delete[] T;
+}
+
+/*!
+  Apply the forward sweep y = R^{-T}*x of the symmetric factorization
+
+  The lower triangular factor R^{T} is traversed through the stored
+  rows of R: once row i is solved, its contribution is scattered into
+  the remaining entries of the right-hand side.
+*/
+void BCSRMatApplyLowerSymm(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = -1.0;
+  TacsScalar beta = 1.0;
+  TacsScalar pos = 1.0;
+  TacsScalar zero = 0.0;
+
+  if (x != y) {
+    memcpy(y, x, bsize * nrows * sizeof(TacsScalar));
+  }
+
+  TacsScalar *ty = new TacsScalar[bsize];
+
+  for (int i = 0; i < nrows; i++) {
+    TacsScalar *yi = &y[bsize * i];
+
+    // y_{i} = L^{-1}*y_{i} using the stored inverse diagonal factor
+    memcpy(ty, yi, bsize * sizeof(TacsScalar));
+    TacsScalar *adiag = &data->A[b2 * diag[i]];
+    BLASgemv("T", &bsize, &bsize, &pos, adiag, &bsize, ty, &one, &zero, yi,
+             &one);
+
+    // Scatter y_{j} -= R_{ij}^{T}*y_{i} into the remaining rows
+    int end = rowp[i + 1];
+    int k = diag[i] + 1;
+    TacsScalar *a = &data->A[b2 * k];
+    for (; k < end; k++) {
+      int bj = bsize * cols[k];
+
+      BLASgemv("N", &bsize, &bsize, &alpha, a, &bsize, yi, &one, &beta, &y[bj],
+               &one);
+      a += b2;
+    }
+  }
+
+  delete[] ty;
+}
+
+/*!
+  Apply the backward sweep y = R^{-1}*x of the symmetric factorization
+*/
+void BCSRMatApplyUpperSymm(BCSRMatData *data, TacsScalar *x, TacsScalar *y) {
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+  int bsize = data->bsize;
+  const int b2 = bsize * bsize;
+
+  int one = 1;
+  TacsScalar alpha = -1.0;
+  TacsScalar beta = 1.0;
+  TacsScalar pos = 1.0;
+  TacsScalar zero = 0.0;
+
+  TacsScalar *ty = new TacsScalar[bsize];
+  TacsScalar *xx = &x[bsize * (nrows - 1)];
+
+  for (int i = nrows - 1; i >= 0; i--) {
+    memcpy(ty, xx, bsize * sizeof(TacsScalar));
+
+    // Subtract the off-diagonal contributions R_{ij}*y_{j}
+    int end = rowp[i + 1];
+    int k = diag[i] + 1;
+    TacsScalar *a = &data->A[b2 * k];
+    for (; k < end; k++) {
+      int bj = bsize * cols[k];
+
+      BLASgemv("T", &bsize, &bsize, &alpha, a, &bsize, &y[bj], &one, &beta, ty,
+               &one);
+      a += b2;
+    }
+
+    // y_{i} = L^{-T}*ty using the stored inverse diagonal factor
+    TacsScalar *adiag = &data->A[b2 * diag[i]];
+    BLASgemv("N", &bsize, &bsize, &pos, adiag, &bsize, ty, &one, &zero,
+             &y[bsize * i], &one);
+
+    xx -= bsize;
+  }
+
+  delete[] ty;
+}
@@ -18,6 +18,7 @@
 
 #include "GSEP.h"
 
+#include "JacobiDavidson.h"
 #include "tacslapack.h"
 
 /*
@@ -418,6 +419,8 @@ SEP::SEP(EPOperator *_Op, int _max_iters, OrthoType _ortho_type,
   spectrum = SMALLEST;
   neigvals = 4;
   niters = -1;
+  use_warm_start = 0;
+  conv_buffer = 0;
 
   // Create the vectors required for the Lanczos subspace
   for (int i = 0; i < max_iters + 1; i++) {
@@ -474,6 +477,29 @@ void SEP::setOperator(EPOperator *_Op) {
   Op = _Op;
 }
 
+/*
+  Set the flag to warm-start the next solve from the Ritz vectors
+  computed during the previous solve. When the operator changes only
+  modestly between solves - as is typical across design iterations -
+  the previous eigenvector estimates are far better starting points
+  than a random vector.
+*/
+void SEP::setWarmStart(int flag) { use_warm_start = flag; }
+
+/*
+  Set the number of additional eigenvalues, beyond the requested
+  number, that must converge before the Lanczos iteration terminates.
+
+  When the eigenvectors are tracked across a sequence of solves, a
+  tracked mode can drift to the edge of the requested window as the
+  spectrum shifts. Converging a small buffer of extra eigenvalues
+  keeps the eigenpairs at the edge of the window accurate so that the
+  tracking does not latch onto an unconverged estimate.
+*/
+void SEP::setConvergenceBuffer(int nbuffer) {
+  conv_buffer = (nbuffer > 0 ? nbuffer : 0);
+}
+
 /*
   Solve the eigenvalue problem using the Lanczos method with full or
   local orthogonalization.
@@ -483,8 +509,25 @@ void SEP::setOperator(EPOperator *_Op) {
   series or orthonormal vectors with respect to a given inner product.
 */
 void SEP::solve(KSMPrint *ksm_print, KSMPrint *ksm_file) {
-  // Select the initial vector randomly
-  Q[0]->setRand();
+  if (use_warm_start && niters > 0) {
+    // Start from the combination of the Ritz vectors computed during
+    // the previous solve. The extra vector at the end of the Lanczos
+    // sequence is used as scratch so that the basis can be read
+    // while the combination is formed.
+    TACSVec *tmp = Q[max_iters];
+    tmp->zeroEntries();
+    int nvecs = (neigvals < niters ? neigvals : niters);
+    for (int n = 0; n < nvecs; n++) {
+      int p = perm[n];
+      for (int i = 0; i < niters; i++) {
+        tmp->axpy(eigvecs[p * niters + i], Q[i]);
+      }
+    }
+    Q[0]->copyValues(tmp);
+  } else {
+    // Select the initial vector randomly
+    Q[0]->setRand();
+  }
   if (bcs) {
     Q[0]->applyBCs(bcs);
   }
@@ -752,8 +795,15 @@ void SEP::sortEigenvalues(TacsScalar *values, int neigs, int *p) {
   have converged based on either a relative or absolute tolerance.xx
 */
 int SEP::checkConverged(TacsScalar *A, TacsScalar *B, int n) {
+  // The number of eigenvalues that must converge, including the
+  // buffer of extra eigenvalues used when modes are tracked
+  int nconv = neigvals + conv_buffer;
+  if (nconv > max_iters) {
+    nconv = max_iters;
+  }
+
   // If we haven't iterated n-times, we can quit immediately
-  if (n < neigvals) {
+  if (n < nconv) {
     return 0;
   }
 
@@ -769,7 +819,7 @@ int SEP::checkConverged(TacsScalar *A, TacsScalar *B, int n) {
 
   // Check for convergence of each of the desired eigenvalues
   int is_converged = 1;
-  for (int k = 0; k < neigvals; k++) {
+  for (int k = 0; k < nconv; k++) {
     // Read off the index
     int index = perm[k];
     TacsScalar er = Op->errorNorm(Q[n]);
@@ -784,3 +834,420 @@ int SEP::checkConverged(TacsScalar *A, TacsScalar *B, int n) {
 
   return is_converged;
 }
+
+/*
+  Create the LOBPCG eigenvalue solver.
+
+  The solver iterates on a block of block_size eigenvector estimates
+  simultaneously, so the block size should be set to the number of
+  eigenvalues that are required. The storage consists of four blocks
+  of vectors - the eigenvector estimates, the preconditioned
+  residuals, the search directions and a scratch block - along with
+  the A/B products of each block that are updated by recurrence to
+  avoid repeated matrix-vector products.
+
+  input:
+  oper:        the operator that defines the eigenproblem
+  block_size:  the number of eigenvalues/eigenvectors to compute
+  max_iters:   the maximum number of iterations
+*/
+LOBPCG::LOBPCG(TACSJacobiDavidsonOperator *_oper, int _block_size,
+               int _max_iters) {
+  oper = _oper;
+  oper->incref();
+
+  block_size = _block_size;
+  if (block_size < 1) {
+    block_size = 1;
+  }
+  max_iters = _max_iters;
+
+  // Set the default convergence tolerance
+  tol = 1e-8;
+  nconverged = 0;
+
+  // Allocate the blocks of vectors
+  X = new TACSVec *[block_size];
+  AX = new TACSVec *[block_size];
+  BX = new TACSVec *[block_size];
+  W = new TACSVec *[block_size];
+  AW = new TACSVec *[block_size];
+  BW = new TACSVec *[block_size];
+  P = new TACSVec *[block_size];
+  AP = new TACSVec *[block_size];
+  BP = new TACSVec *[block_size];
+  T = new TACSVec *[block_size];
+  AT = new TACSVec *[block_size];
+  BT = new TACSVec *[block_size];
+
+  for (int i = 0; i < block_size; i++) {
+    X[i] = oper->createVec();
+    X[i]->incref();
+    AX[i] = oper->createVec();
+    AX[i]->incref();
+    BX[i] = oper->createVec();
+    BX[i]->incref();
+    W[i] = oper->createVec();
+    W[i]->incref();
+    AW[i] = oper->createVec();
+    AW[i]->incref();
+    BW[i] = oper->createVec();
+    BW[i]->incref();
+    P[i] = oper->createVec();
+    P[i]->incref();
+    AP[i] = oper->createVec();
+    AP[i]->incref();
+    BP[i] = oper->createVec();
+    BP[i]->incref();
+    T[i] = oper->createVec();
+    T[i]->incref();
+    AT[i] = oper->createVec();
+    AT[i]->incref();
+    BT[i] = oper->createVec();
+    BT[i]->incref();
+  }
+
+  work = oper->createVec();
+  work->incref();
+
+  // Allocate the eigenvalues and residual norms
+  eigs = new TacsScalar[block_size];
+  eigerror = new TacsScalar[block_size];
+  memset(eigs, 0, block_size * sizeof(TacsScalar));
+  memset(eigerror, 0, block_size * sizeof(TacsScalar));
+}
+
+/*
+  Deallocate all the information stored in the solver
+*/
+LOBPCG::~LOBPCG() {
+  for (int i = 0; i < block_size; i++) {
+    X[i]->decref();
+    AX[i]->decref();
+    BX[i]->decref();
+    W[i]->decref();
+    AW[i]->decref();
+    BW[i]->decref();
+    P[i]->decref();
+    AP[i]->decref();
+    BP[i]->decref();
+    T[i]->decref();
+    AT[i]->decref();
+    BT[i]->decref();
+  }
+  delete[] X;
+  delete[] AX;
+  delete[] BX;
+  delete[] W;
+  delete[] AW;
+  delete[] BW;
+  delete[] P;
+  delete[] AP;
+  delete[] BP;
+  delete[] T;
+  delete[] AT;
+  delete[] BT;
+
+  work->decref();
+  oper->decref();
+
+  delete[] eigs;
+  delete[] eigerror;
+}
+
+/*
+  Set the relative convergence tolerance for the residual norms
+*/
+void LOBPCG::setTolerances(double _tol) { tol = _tol; }
+
+/*
+  Solve the generalized eigenvalue problem using the LOBPCG method.
+
+  The method maintains a B-orthonormal block of eigenvector estimates
+  X. At each iteration the residuals
+
+  r_i = A*x_i - lambda_i*B*x_i
+
+  are preconditioned and B-orthonormalized against the basis, and a
+  Rayleigh-Ritz procedure is applied over the subspace spanned by the
+  eigenvector block, the preconditioned residuals and the search
+  directions from the previous iteration. The A/B products of all the
+  basis vectors are updated by applying the same linear combinations
+  that are applied to the basis itself, so that each iteration
+  requires only one A and one B product per residual, plus one
+  application of the preconditioner.
+
+  Since the basis is kept B-orthonormal, the projected problem reduces
+  to a standard symmetric eigenproblem that is solved with LAPACK.
+  Basis vectors that become linearly dependent are dropped from the
+  Rayleigh-Ritz subspace, which keeps the projected problem
+  well-conditioned as the residuals converge.
+*/
+void LOBPCG::solve(KSMPrint *ksm_print, int print_level) {
+  const int m = block_size;
+
+  // Allocate the data for the dense Rayleigh-Ritz problem. The
+  // subspace consists of at most the three blocks [X, W, P].
+  const int max_nv = 3 * m;
+  double *gram = new double[max_nv * max_nv];
+  double *ritzvals = new double[max_nv];
+  int lwork = 16 * max_nv;
+  double *rwork = new double[lwork];
+
+  // Pointers into the basis and its A/B products
+  TACSVec **V = new TACSVec *[max_nv];
+  TACSVec **AV = new TACSVec *[max_nv];
+  TACSVec **BV = new TACSVec *[max_nv];
+
+  // Initialize the eigenvector block with random entries
+  for (int i = 0; i < m; i++) {
+    X[i]->setRand(-1.0, 1.0);
+    oper->applyBCs(X[i]);
+    oper->multA(X[i], AX[i]);
+    oper->multB(X[i], BX[i]);
+  }
+
+  // B-orthonormalize the initial block
+  for (int k = 0; k < m; k++) {
+    for (int j = 0; j < k; j++) {
+      TacsScalar h = BX[j]->dot(X[k]);
+      X[k]->axpy(-h, X[j]);
+      AX[k]->axpy(-h, AX[j]);
+      BX[k]->axpy(-h, BX[j]);
+    }
+    TacsScalar xnorm = sqrt(BX[k]->dot(X[k]));
+    X[k]->scale(1.0 / xnorm);
+    AX[k]->scale(1.0 / xnorm);
+    BX[k]->scale(1.0 / xnorm);
+  }
+
+  // Set the initial eigenvalue estimates to the Rayleigh quotients
+  for (int i = 0; i < m; i++) {
+    eigs[i] = AX[i]->dot(X[i]);
+  }
+
+  // The number of search directions in the subspace
+  int np = 0;
+  nconverged = 0;
+
+  if (ksm_print && print_level > 0) {
+    char line[256];
+    sprintf(line, "%4s %10s %15s\n", "Iter", "Converged", "Max residual");
+    ksm_print->print(line);
+  }
+
+  for (int iter = 0; iter < max_iters; iter++) {
+    // Compute the residuals and their norms
+    for (int i = 0; i < m; i++) {
+      W[i]->copyValues(AX[i]);
+      W[i]->axpy(-eigs[i], BX[i]);
+      oper->applyBCs(W[i]);
+      eigerror[i] = W[i]->norm();
+    }
+
+    // Count the number of leading converged eigenvalues. The
+    // tolerance is relative to the norms of the two matrix-vector
+    // products so that it is insensitive to the matrix scaling.
+    nconverged = 0;
+    double max_res = 0.0;
+    for (int i = 0; i < m; i++) {
+      double toler =
+          tol * (TacsRealPart(AX[i]->norm()) +
+                 fabs(TacsRealPart(eigs[i])) * TacsRealPart(BX[i]->norm()));
+      if (i == nconverged && fabs(TacsRealPart(eigerror[i])) < toler) {
+        nconverged++;
+      }
+      if (fabs(TacsRealPart(eigerror[i])) > max_res) {
+        max_res = fabs(TacsRealPart(eigerror[i]));
+      }
+    }
+
+    if (ksm_print && print_level > 0) {
+      char line[256];
+      sprintf(line, "%4d %10d %15.5e\n", iter, nconverged, max_res);
+      ksm_print->print(line);
+    }
+
+    if (nconverged >= m) {
+      break;
+    }
+
+    // Apply the preconditioner to the residuals and compute the
+    // products of the preconditioned residuals
+    for (int i = 0; i < m; i++) {
+      work->copyValues(W[i]);
+      oper->applyFactor(work, W[i]);
+      oper->applyBCs(W[i]);
+      oper->multA(W[i], AW[i]);
+      oper->multB(W[i], BW[i]);
+    }
+
+    // Assemble the subspace [X, W, P]. The eigenvector block is
+    // B-orthonormal by construction; the residuals and search
+    // directions are B-orthonormalized against the basis and dropped
+    // if they become linearly dependent. The A/B products are
+    // combined in lock-step so that they remain consistent.
+    for (int i = 0; i < m; i++) {
+      V[i] = X[i];
+      AV[i] = AX[i];
+      BV[i] = BX[i];
+    }
+    int nv = m;
+
+    for (int k = 0; k < m + np; k++) {
+      TACSVec *v, *av, *bv;
+      if (k < m) {
+        v = W[k];
+        av = AW[k];
+        bv = BW[k];
+      } else {
+        v = P[k - m];
+        av = AP[k - m];
+        bv = BP[k - m];
+      }
+
+      for (int j = 0; j < nv; j++) {
+        TacsScalar h = BV[j]->dot(v);
+        v->axpy(-h, V[j]);
+        av->axpy(-h, AV[j]);
+        bv->axpy(-h, BV[j]);
+      }
+
+      TacsScalar vnorm = sqrt(bv->dot(v));
+      if (TacsRealPart(vnorm) > 1e-14) {
+        v->scale(1.0 / vnorm);
+        av->scale(1.0 / vnorm);
+        bv->scale(1.0 / vnorm);
+        V[nv] = v;
+        AV[nv] = av;
+        BV[nv] = bv;
+        nv++;
+      }
+    }
+
+    // Form the projected matrix V^{T}*A*V. Since the basis is
+    // B-orthonormal the projection of B is the identity and the
+    // projected problem is a standard symmetric eigenproblem.
+    for (int j = 0; j < nv; j++) {
+      for (int i = 0; i <= j; i++) {
+        gram[i + nv * j] = TacsRealPart(AV[j]->dot(V[i]));
+      }
+    }
+
+    // Compute the eigenvalues and eigenvectors of the projected
+    // problem. The eigenvalues are sorted in ascending order.
+    const char *jobz = "V", *uplo = "U";
+    int n = nv, info = 0;
+    LAPACKdsyev(jobz, uplo, &n, gram, &n, ritzvals, rwork, &lwork, &info);
+    if (info != 0) {
+      fprintf(stderr, "LOBPCG: Error in LAPACK function dsyev\n");
+      break;
+    }
+
+    // Form the new search directions from the residual/direction
+    // components of the smallest Ritz vectors
+    for (int i = 0; i < m; i++) {
+      T[i]->zeroEntries();
+      AT[i]->zeroEntries();
+      BT[i]->zeroEntries();
+      for (int j = m; j < nv; j++) {
+        TacsScalar h = gram[j + nv * i];
+        T[i]->axpy(h, V[j]);
+        AT[i]->axpy(h, AV[j]);
+        BT[i]->axpy(h, BV[j]);
+      }
+    }
+
+    // Swap in the new search directions
+    for (int i = 0; i < m; i++) {
+      TACSVec *t = P[i];
+      P[i] = T[i];
+      T[i] = t;
+      t = AP[i];
+      AP[i] = AT[i];
+      AT[i] = t;
+      t = BP[i];
+      BP[i] = BT[i];
+      BT[i] = t;
+    }
+    np = m;
+
+    // Form the new eigenvector block by adding the contributions
+    // from the current block to the search directions
+    for (int i = 0; i < m; i++) {
+      T[i]->copyValues(P[i]);
+      AT[i]->copyValues(AP[i]);
+      BT[i]->copyValues(BP[i]);
+      for (int j = 0; j < m; j++) {
+        TacsScalar h = gram[j + nv * i];
+        T[i]->axpy(h, X[j]);
+        AT[i]->axpy(h, AX[j]);
+        BT[i]->axpy(h, BX[j]);
+      }
+    }
+
+    // Swap in the new eigenvector block and record the Ritz values
+    for (int i = 0; i < m; i++) {
+      TACSVec *t = X[i];
+      X[i] = T[i];
+      T[i] = t;
+      t = AX[i];
+      AX[i] = AT[i];
+      AT[i] = t;
+      t = BX[i];
+      BX[i] = BT[i];
+      BT[i] = t;
+
+      eigs[i] = ritzvals[i];
+    }
+  }
+
+  delete[] gram;
+  delete[] ritzvals;
+  delete[] rwork;
+  delete[] V;
+  delete[] AV;
+  delete[] BV;
+}
+
+/*
+  Get the number of converged eigenvalues
+*/
+int LOBPCG::getNumConvergedEigenvalues() { return nconverged; }
+
+/*
+  Extract the n-th eigenvalue and the norm of its residual
+*/
+TacsScalar LOBPCG::extractEigenvalue(int n, TacsScalar *error) {
+  if (n < 0 || n >= block_size) {
+    fprintf(stderr, "Eigenvalue out of range\n");
+    if (error) {
+      *error = -1.0;
+    }
+    return 0.0;
+  }
+  if (error) {
+    *error = eigerror[n];
+  }
+  return eigs[n];
+}
+
+/*
+  Extract the n-th eigenvector and return the eigenvalue and the norm
+  of the residual
+*/
+TacsScalar LOBPCG::extractEigenvector(int n, TACSVec *ans, TacsScalar *error) {
+  if (n < 0 || n >= block_size) {
+    fprintf(stderr, "Eigenvector out of range\n");
+    if (error) {
+      *error = -1.0;
+    }
+    ans->zeroEntries();
+    return 0.0;
+  }
+  ans->copyValues(X[n]);
+  if (error) {
+    *error = eigerror[n];
+  }
+  return eigs[n];
+}
@@ -198,6 +198,12 @@ class SEP : public TACSObject {
   // Reset the eigenproblem operator
   void setOperator(EPOperator *_Op);
 
+  // Warm-start subsequent solves from the previous Ritz vectors
+  void setWarmStart(int flag);
+
+  // Converge extra eigenvalues beyond the requested set
+  void setConvergenceBuffer(int nbuffer);
+
   // Solve the eigenproblem
   void solve(KSMPrint *ksm_print = NULL, KSMPrint *ksm_file = NULL);
 
@@ -241,6 +247,14 @@ class SEP : public TACSObject {
   // The type of orthogonalization to use
   OrthoType ortho_type;
 
+  // Flag to start the Lanczos sequence from the Ritz vectors
+  // computed during the previous solve
+  int use_warm_start;
+
+  // The number of additional eigenvalues beyond neigvals that must
+  // converge before the iteration is terminated
+  int conv_buffer;
+
   int max_iters;
   TACSVec **Q;  // The Vectors for the eigenvalue problem...
 
@@ -248,4 +262,79 @@ class SEP : public TACSObject {
   TACSBcMap *bcs;
 };
 
+// Forward declaration of the eigenproblem operator defined for the
+// Jacobi-Davidson method. The same operator abstraction provides the
+// separate A/B products and the preconditioner required here.
+class TACSJacobiDavidsonOperator;
+
+/*
+  The locally optimal block preconditioned conjugate gradient (LOBPCG)
+  eigenvalue solver.
+
+  This solver computes the smallest eigenvalues of the generalized
+  problem
+
+  A x = lambda B x
+
+  without ever factoring a shifted operator. At each iteration the
+  preconditioned residuals of the current eigenvector block are
+  combined with the block and the previous search directions, and a
+  Rayleigh-Ritz procedure is applied over the combined subspace. The
+  preconditioner is applied through the operator so that a multigrid
+  cycle can be used in place of a factorization, which makes this the
+  method of choice when factorization memory is prohibitive.
+
+  The solver uses the same operator abstraction as the Jacobi-Davidson
+  method, which provides the separate A/B matrix-vector products, the
+  preconditioner and the B-inner product.
+*/
+class LOBPCG : public TACSObject {
+ public:
+  LOBPCG(TACSJacobiDavidsonOperator *_oper, int _block_size, int _max_iters);
+  ~LOBPCG();
+
+  // Set the convergence tolerance
+  void setTolerances(double _tol);
+
+  // Solve the eigenproblem
+  void solve(KSMPrint *ksm_print = NULL, int print_level = 0);
+
+  // Extract the eigenvalues and eigenvectors from the solver
+  int getNumConvergedEigenvalues();
+  TacsScalar extractEigenvalue(int n, TacsScalar *error);
+  TacsScalar extractEigenvector(int n, TACSVec *ans, TacsScalar *error);
+
+ private:
+  // The operator that defines the eigenproblem
+  TACSJacobiDavidsonOperator *oper;
+
+  // The block size and the maximum number of iterations
+  int block_size;
+  int max_iters;
+
+  // The relative convergence tolerance for the residual norms
+  double tol;
+
+  // The eigenvector block and the A/B products of the block
+  TACSVec **X, **AX, **BX;
+
+  // The preconditioned residuals and their A/B products
+  TACSVec **W, **AW, **BW;
+
+  // The search directions and their A/B products
+  TACSVec **P, **AP, **BP;
+
+  // Scratch block used to form the new iterates
+  TACSVec **T, **AT, **BT;
+
+  // Work vector for the preconditioner application
+  TACSVec *work;
+
+  // The eigenvalues and the residual norms
+  TacsScalar *eigs, *eigerror;
+
+  // The number of converged eigenvalues
+  int nconverged;
+};
+
 #endif  // TACS_GSEP_H
@@ -183,6 +183,9 @@ TACSJacobiDavidson::TACSJacobiDavidson(TACSJacobiDavidsonOperator *_oper,
   num_recycle_vecs = 0;
   recycle_type = JD_NUM_RECYCLE;
 
+  // Solve a single correction equation per outer iteration by default
+  block_size = 1;
+
   // The eigen tolerance
   eig_rtol = 1e-9;
   eig_atol = 1e-30;
@@ -467,6 +470,10 @@ void TACSJacobiDavidson::solve(KSMPrint *ksm_print, int print_level) {
   int iteration = 0;
   int gmres_iteration = 0;
 
+  // The number of correction vectors computed during a previous blocked
+  // outer iteration that have not yet been added to the subspace
+  int npending = 0;
+
   // Check if the recycle flag is set
   int kstart = 0;
   if (num_recycle_vecs > 0) {
@@ -768,125 +775,181 @@ void TACSJacobiDavidson::solve(KSMPrint *ksm_print, int print_level) {
       // of the V subspace
       k = new_subspace_vecs - 2;
 
+      // Discard any correction vectors that had not yet been added to
+      // the subspace since the subspace has been rebuilt
+      npending = 0;
+
       // Reset the iteration loop and continue
       continue;
     }
 
-    // Now solve the system (K - theta*M)*t = -work
-    // Keep track of the number of iterations in GMRES
-    int niters = 0;
-
-    // Copy the residual to the first work vector
-    W[0]->copyValues(work);
-    res[0] = W[0]->norm();
-    W[0]->scale(1.0 / res[0]);  // W[0] = b/|| b ||
-
-    // Keep track of the initial norm of the right-hand-side
-    double beta = TacsRealPart(res[0]);
-
-    // Using GMRES, solve for the update equation
-    for (int i = 0; i < max_gmres_size; i++) {
-      // Now compute: work = (I - Q*P^{T})*Z[i]
-      // Note that we compute the product in this way since
-      // it is numerical more stable and equivalent to the form above
-      // since Q^{T}P = 0 so that: (since Q is a B-orthogonal subspace)
-      // (I - q1*p1^{T})*(I - q2*p2^{T}) =
-      // (I - q1*p1^{T} - q2*p2^{T} - q1*p1^{T}*q2*p2^{T}) =
-      // (I - q1*p1^{T} - q2*p2^{T})
-
-      // Apply the preconditioner, Z[i] = (I - Q*P^{T})*M^{-1} W[i]
-      oper->applyFactor(W[i], Z[i]);
-      for (int j = 0; j <= nconverged; j++) {
-        TacsScalar h = Z[i]->dot(P[j]);
-        Z[i]->axpy(-h, Q[j]);
-      }
+    // If correction vectors computed during a previous blocked outer
+    // iteration have not yet been added to the subspace, add the next
+    // one before computing any new corrections
+    if (npending > 0) {
+      npending--;
+      iteration++;
+      continue;
+    }
 
-      // Form the product (A - theta*B)*Z[i]
-      oper->multA(Z[i], W[i + 1]);
-      oper->multB(Z[i], work);
-      W[i + 1]->axpy(-theta, work);
-      oper->applyBCs(W[i + 1]);
+    // Compute the number of correction equations to solve during this
+    // outer iteration. The block is limited by the number of Ritz pairs
+    // available and by the remaining space in the V subspace.
+    int nblock = block_size;
+    if (nblock > k + 1) {
+      nblock = k + 1;
+    }
+    if (nblock > m - k) {
+      nblock = m - k;
+    }
 
-      // Finish computing the product W[i+1] = (I - P*Q^{T})*A*Z[i]
-      for (int j = 0; j <= nconverged; j++) {
-        TacsScalar h = W[i + 1]->dot(Q[j]);
-        W[i + 1]->axpy(-h, P[j]);
-      }
+    // Solve the correction equations for the leading nblock Ritz pairs
+    // that have not yet converged. The additional correction vectors
+    // are appended to the subspace over the following outer iterations.
+    for (int b = 0; b < nblock; b++) {
+      if (b > 0) {
+        // Set the Ritz value for the next pair in the cluster
+        theta = ritzvals[b];
 
-      // Build the orthogonal basis using MGS
-      for (int j = i; j >= 0; j--) {
-        H[j + Hptr[i]] = W[i + 1]->dot(W[j]);   // H[j,i] = dot(W[i+1], W[i])
-        W[i + 1]->axpy(-H[j + Hptr[i]], W[j]);  // W[i+1] = W[i+1] - H[j,i]*W[j]
-      }
+        // Assemble the predicted Ritz vector
+        Q[nconverged]->zeroEntries();
+        for (int j = 0; j <= k; j++) {
+          Q[nconverged]->axpy(ritzvecs[b * (k + 1) + j], V[j]);
+        }
+        oper->applyBCs(Q[nconverged]);
+
+        // Normalize the predicted eigenvalue
+        TacsScalar qnorm = sqrt(oper->dot(Q[nconverged], Q[nconverged]));
+        Q[nconverged]->scale(1.0 / qnorm);
 
-      // Complete the basis
-      H[i + 1 + Hptr[i]] = W[i + 1]->norm();  // H[i+1,i] = || W[i+1] ||
-      W[i + 1]->scale(1.0 /
-                      H[i + 1 + Hptr[i]]);  // W[i+1] = W[i+1]/|| W[i+1] ||
-
-      // Apply the existing part of Q to the new components of the
-      // Hessenberg matrix
-      TacsScalar h1, h2;
-      for (int k = 0; k < i; k++) {
-        h1 = H[k + Hptr[i]];
-        h2 = H[k + 1 + Hptr[i]];
-        H[k + Hptr[i]] = h1 * Qcos[k] + h2 * Qsin[k];
-        H[k + 1 + Hptr[i]] = -h1 * Qsin[k] + h2 * Qcos[k];
+        // Compute the residual: work = A*q - theta*B*q
+        // and store it in the work vector
+        oper->multA(Q[nconverged], work);
+        oper->multB(Q[nconverged], P[nconverged]);
+        work->axpy(-theta, P[nconverged]);
+        oper->applyBCs(work);
       }
 
-      // Now, compute the rotation for the new column that was just added
-      h1 = H[i + Hptr[i]];
-      h2 = H[i + 1 + Hptr[i]];
-      TacsScalar sq = sqrt(h1 * h1 + h2 * h2);
+      // Now solve the system (K - theta*M)*t = -work
+      // Keep track of the number of iterations in GMRES
+      int niters = 0;
+
+      // Copy the residual to the first work vector
+      W[0]->copyValues(work);
+      res[0] = W[0]->norm();
+      W[0]->scale(1.0 / res[0]);  // W[0] = b/|| b ||
+
+      // Keep track of the initial norm of the right-hand-side
+      double beta = TacsRealPart(res[0]);
+
+      // Using GMRES, solve for the update equation
+      for (int i = 0; i < max_gmres_size; i++) {
+        // Now compute: work = (I - Q*P^{T})*Z[i]
+        // Note that we compute the product in this way since
+        // it is numerical more stable and equivalent to the form above
+        // since Q^{T}P = 0 so that: (since Q is a B-orthogonal subspace)
+        // (I - q1*p1^{T})*(I - q2*p2^{T}) =
+        // (I - q1*p1^{T} - q2*p2^{T} - q1*p1^{T}*q2*p2^{T}) =
+        // (I - q1*p1^{T} - q2*p2^{T})
+
+        // Apply the preconditioner, Z[i] = (I - Q*P^{T})*M^{-1} W[i]
+        oper->applyFactor(W[i], Z[i]);
+        for (int j = 0; j <= nconverged; j++) {
+          TacsScalar h = Z[i]->dot(P[j]);
+          Z[i]->axpy(-h, Q[j]);
+        }
 
-      // Evaluate the sin/cos of the rotation matrix
-      Qcos[i] = h1 / sq;
-      Qsin[i] = h2 / sq;
-      H[i + Hptr[i]] = h1 * Qcos[i] + h2 * Qsin[i];
-      H[i + 1 + Hptr[i]] = -h1 * Qsin[i] + h2 * Qcos[i];
+        // Form the product (A - theta*B)*Z[i]
+        oper->multA(Z[i], W[i + 1]);
+        oper->multB(Z[i], work);
+        W[i + 1]->axpy(-theta, work);
+        oper->applyBCs(W[i + 1]);
 
-      // Update the residual
-      h1 = res[i];
-      res[i] = h1 * Qcos[i];
-      res[i + 1] = -h1 * Qsin[i];
+        // Finish computing the product W[i+1] = (I - P*Q^{T})*A*Z[i]
+        for (int j = 0; j <= nconverged; j++) {
+          TacsScalar h = W[i + 1]->dot(Q[j]);
+          W[i + 1]->axpy(-h, P[j]);
+        }
 
-      if (ksm_print && print_level > 1) {
-        ksm_print->printResidual(niters, fabs(TacsRealPart(res[i + 1])));
-      }
+        // Build the orthogonal basis using MGS
+        for (int j = i; j >= 0; j--) {
+          H[j + Hptr[i]] = W[i + 1]->dot(W[j]);   // H[j,i] = dot(W[i+1], W[i])
+          W[i + 1]->axpy(-H[j + Hptr[i]], W[j]);  // W[i+1] = W[i+1] - H[j,i]*W[j]
+        }
 
-      niters++;           // Number of iterations for this GMRES solve
-      gmres_iteration++;  // Total number of GMRES iterations
+        // Complete the basis
+        H[i + 1 + Hptr[i]] = W[i + 1]->norm();  // H[i+1,i] = || W[i+1] ||
+        W[i + 1]->scale(1.0 /
+                        H[i + 1 + Hptr[i]]);  // W[i+1] = W[i+1]/|| W[i+1] ||
+
+        // Apply the existing part of Q to the new components of the
+        // Hessenberg matrix
+        TacsScalar h1, h2;
+        for (int k = 0; k < i; k++) {
+          h1 = H[k + Hptr[i]];
+          h2 = H[k + 1 + Hptr[i]];
+          H[k + Hptr[i]] = h1 * Qcos[k] + h2 * Qsin[k];
+          H[k + 1 + Hptr[i]] = -h1 * Qsin[k] + h2 * Qcos[k];
+        }
 
-      if (fabs(TacsRealPart(res[i + 1])) < atol ||
-          fabs(TacsRealPart(res[i + 1])) < rtol * beta) {
-        break;
+        // Now, compute the rotation for the new column that was just added
+        h1 = H[i + Hptr[i]];
+        h2 = H[i + 1 + Hptr[i]];
+        TacsScalar sq = sqrt(h1 * h1 + h2 * h2);
+
+        // Evaluate the sin/cos of the rotation matrix
+        Qcos[i] = h1 / sq;
+        Qsin[i] = h2 / sq;
+        H[i + Hptr[i]] = h1 * Qcos[i] + h2 * Qsin[i];
+        H[i + 1 + Hptr[i]] = -h1 * Qsin[i] + h2 * Qcos[i];
+
+        // Update the residual
+        h1 = res[i];
+        res[i] = h1 * Qcos[i];
+        res[i + 1] = -h1 * Qsin[i];
+
+        if (ksm_print && print_level > 1) {
+          ksm_print->printResidual(niters, fabs(TacsRealPart(res[i + 1])));
+        }
+
+        niters++;           // Number of iterations for this GMRES solve
+        gmres_iteration++;  // Total number of GMRES iterations
+
+        if (fabs(TacsRealPart(res[i + 1])) < atol ||
+            fabs(TacsRealPart(res[i + 1])) < rtol * beta) {
+          break;
+        }
       }
-    }
 
-    // Now, compute the solution. The linear combination of the
-    // Arnoldi vectors. The matrix H is now upper triangular. First
-    // compute the weights for each basis vector.
-    for (int i = niters - 1; i >= 0; i--) {
-      for (int j = i + 1; j < niters; j++) {
-        res[i] = res[i] - H[i + Hptr[j]] * res[j];
+      // Now, compute the solution. The linear combination of the
+      // Arnoldi vectors. The matrix H is now upper triangular. First
+      // compute the weights for each basis vector.
+      for (int i = niters - 1; i >= 0; i--) {
+        for (int j = i + 1; j < niters; j++) {
+          res[i] = res[i] - H[i + Hptr[j]] * res[j];
+        }
+        res[i] = res[i] / H[i + Hptr[i]];
       }
-      res[i] = res[i] / H[i + Hptr[i]];
-    }
 
-    // Compute the next basis vector for the outer Jacobi--Davidson basis
-    V[k + 1]->zeroEntries();
-    for (int i = 0; i < niters; i++) {
-      V[k + 1]->axpy(-res[i], Z[i]);
-    }
+      // Compute the next basis vector for the outer Jacobi--Davidson basis
+      V[k + 1 + b]->zeroEntries();
+      for (int i = 0; i < niters; i++) {
+        V[k + 1 + b]->axpy(-res[i], Z[i]);
+      }
 
-    // Compute the product to test the error
-    // (1 - P*Q^{T})*(A - theta*B)*(1 - Q*P^{T})
-    W[0]->copyValues(V[k + 1]);
-    for (int j = 0; j <= nconverged; j++) {
-      TacsScalar h = W[0]->dot(P[j]);
-      W[0]->axpy(-h, Q[j]);
+      // Compute the product to test the error
+      // (1 - P*Q^{T})*(A - theta*B)*(1 - Q*P^{T})
+      W[0]->copyValues(V[k + 1 + b]);
+      for (int j = 0; j <= nconverged; j++) {
+        TacsScalar h = W[0]->dot(P[j]);
+        W[0]->axpy(-h, Q[j]);
+      }
     }
 
+    // The remaining correction vectors are appended to the subspace
+    // one at a time over the following outer iterations
+    npending = nblock - 1;
+
     iteration++;
   }
 
@@ -954,3 +1017,20 @@ void TACSJacobiDavidson::setRecycle(int _num_recycle_vecs,
   num_recycle_vecs = _num_recycle_vecs;
   recycle_type = _recycle_type;
 }
+
+/*
+  Set the number of correction equations to solve in each outer iteration
+
+  Solving corrections for several of the smallest Ritz pairs at once
+  amortizes the cost of updating the preconditioner when the spectrum
+  contains clusters of nearly coincident eigenvalues.
+
+  input:
+  block_size: the number of correction equations per outer iteration
+*/
+void TACSJacobiDavidson::setBlockSize(int _block_size) {
+  block_size = _block_size;
+  if (block_size < 1) {
+    block_size = 1;
+  }
+}
@@ -165,6 +165,9 @@ class TACSJacobiDavidson : public TACSObject {
   // Set the number of vectors to recycle
   void setRecycle(int _recycle, JDRecycleType _recycle_type);
 
+  // Set the number of correction equations solved per outer iteration
+  void setBlockSize(int _block_size);
+
  private:
   // The operator class that defines the eigenproblem
   TACSJacobiDavidsonOperator *oper;
@@ -174,6 +177,10 @@ class TACSJacobiDavidson : public TACSObject {
   JDRecycleType recycle_type;
   int num_recycle_vecs;
 
+  // The number of correction equations that are solved in each outer
+  // iteration of the eigenvalue solve
+  int block_size;
+
   // Generic work vector
   TACSVec *work;
 
@@ -20,6 +20,11 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+#include "TACSBVec.h"
+#include "TACSProfiler.h"
+#include "tacslapack.h"
 
 /*
   Implementation of various Krylov-subspace methods
@@ -50,6 +55,13 @@ TACSBcMap::TACSBcMap(int _bsize, int num_bcs) {
   nodes = new int[max_size];
   vars = new int[max_size];
   values = new TacsScalar[bsize * max_size];
+
+  // The run-length-encoded ranges are computed on demand
+  nranges = 0;
+  range_nodes = NULL;
+  range_counts = NULL;
+  range_vars = NULL;
+  ranges_valid = 0;
 }
 
 /*
@@ -60,6 +72,11 @@ TACSBcMap::~TACSBcMap() {
   delete[] nodes;
   delete[] vars;
   delete[] values;
+  if (range_nodes) {
+    delete[] range_nodes;
+    delete[] range_counts;
+    delete[] range_vars;
+  }
 }
 
 /*
@@ -123,6 +140,7 @@ void TACSBcMap::addBC(int node, int nvals, const int *bc_vars,
 
   // Increment the boundary conditions
   nbcs++;
+  ranges_valid = 0;
 }
 
 /*
@@ -163,6 +181,7 @@ void TACSBcMap::addBinaryFlagBC(int node, int _vars) {
   memset(&values[bsize * nbcs], 0, bsize * sizeof(TacsScalar));
   vars[nbcs] = _vars;
   nbcs++;
+  ranges_valid = 0;
 }
 
 /*
@@ -190,14 +209,134 @@ int TACSBcMap::getBCs(const int **_nodes, const int **_vars,
 
 /*
   Retrieve the boundary condition node numbers
+
+  The caller may rewrite the node numbers through the returned
+  pointer, so any cached range information is invalidated here.
 */
 int TACSBcMap::getBCNodeNums(int **_nodes) {
   if (_nodes) {
     *_nodes = nodes;
   }
+  ranges_valid = 0;
   return nbcs;
 }
 
+/*
+  Compare the (node, vars) pairs stored in the sorted range
+  computation by their node number
+*/
+static int compare_bc_nodes(const void *a, const void *b) {
+  return ((const int *)a)[0] - ((const int *)b)[0];
+}
+
+/*
+  Compute the run-length-encoded ranges of the boundary conditions.
+
+  The boundary conditions are sorted by node number, duplicate entries
+  for the same node are merged by combining their variable masks, and
+  maximal runs of consecutive nodes that share the same variable mask
+  are collapsed into a single (first node, count, mask) triplet. For
+  meshes with large fully-clamped surfaces this reduces millions of
+  entries to a handful of ranges.
+*/
+void TACSBcMap::computeBCRanges() {
+  if (range_nodes) {
+    delete[] range_nodes;
+    delete[] range_counts;
+    delete[] range_vars;
+    range_nodes = NULL;
+    range_counts = NULL;
+    range_vars = NULL;
+  }
+  nranges = 0;
+
+  if (nbcs > 0) {
+    // Sort the (node, mask) pairs by node number
+    int *sorted = new int[2 * nbcs];
+    for (int i = 0; i < nbcs; i++) {
+      sorted[2 * i] = nodes[i];
+      sorted[2 * i + 1] = vars[i];
+    }
+    qsort(sorted, nbcs, 2 * sizeof(int), compare_bc_nodes);
+
+    // Merge duplicate nodes by combining their variable masks
+    int len = 0;
+    for (int i = 0; i < nbcs; i++) {
+      if (len > 0 && sorted[2 * (len - 1)] == sorted[2 * i]) {
+        sorted[2 * (len - 1) + 1] |= sorted[2 * i + 1];
+      } else {
+        sorted[2 * len] = sorted[2 * i];
+        sorted[2 * len + 1] = sorted[2 * i + 1];
+        len++;
+      }
+    }
+
+    // Count the maximal runs of consecutive nodes with uniform masks
+    nranges = 1;
+    for (int i = 1; i < len; i++) {
+      if (sorted[2 * i] != sorted[2 * (i - 1)] + 1 ||
+          sorted[2 * i + 1] != sorted[2 * (i - 1) + 1]) {
+        nranges++;
+      }
+    }
+
+    // Collapse the runs into the range representation
+    range_nodes = new int[nranges];
+    range_counts = new int[nranges];
+    range_vars = new int[nranges];
+
+    int index = -1;
+    for (int i = 0; i < len; i++) {
+      if (i > 0 && sorted[2 * i] == sorted[2 * (i - 1)] + 1 &&
+          sorted[2 * i + 1] == sorted[2 * (i - 1) + 1]) {
+        range_counts[index]++;
+      } else {
+        index++;
+        range_nodes[index] = sorted[2 * i];
+        range_counts[index] = 1;
+        range_vars[index] = sorted[2 * i + 1];
+      }
+    }
+
+    delete[] sorted;
+  }
+
+  ranges_valid = 1;
+}
+
+/*
+  Retrieve the boundary conditions as sorted ranges of consecutive
+  nodes that share a uniform variable mask.
+
+  This representation only identifies which unknowns are constrained -
+  the associated boundary condition values must be retrieved through
+  getBCs(). The ranges are computed on the first call and re-used
+  until the boundary conditions are modified.
+
+  output:
+  range_nodes:   the first node number of each range
+  range_counts:  the number of consecutive nodes in each range
+  range_vars:    the variable mask shared by the nodes in each range
+
+  returns: the number of ranges
+*/
+int TACSBcMap::getBCRanges(const int **_range_nodes, const int **_range_counts,
+                           const int **_range_vars) {
+  if (!ranges_valid) {
+    computeBCRanges();
+  }
+  if (_range_nodes) {
+    *_range_nodes = range_nodes;
+  }
+  if (_range_counts) {
+    *_range_counts = range_counts;
+  }
+  if (_range_vars) {
+    *_range_vars = range_vars;
+  }
+  return nranges;
+}
+
 /*
   The default implementation for performing multiple dot-products
   simultaneously. This operation can be implemented more efficiently
@@ -215,18 +354,345 @@ void TACSVec::mdot(TACSVec **x, TacsScalar *ans, int m) {
   }
 }
 
+/*
+  The default implementation of the split-phase multiple dot-product.
+
+  Vector classes that can overlap the reduction with other work should
+  override these functions with a non-blocking implementation. The
+  default simply performs the blocking operation in mdot_begin() so
+  that the results are always available by the time mdot_end() is
+  called. Only one split-phase dot product may be outstanding at a
+  time.
+*/
+void TACSVec::mdot_begin(TACSVec **x, TacsScalar *ans, int m) {
+  mdot(x, ans, m);
+}
+
+void TACSVec::mdot_end(TacsScalar *ans, int m) {}
+
+/*
+  The default implementation of the fused update-and-norm
+
+  y <- y + alpha*x, returning ||y||
+
+  Vector classes should override this with a single-pass
+  implementation: the separate calls stream y through memory twice and
+  the update itself reads y a third time.
+*/
+TacsScalar TACSVec::axpyNorm(TacsScalar alpha, TACSVec *x) {
+  axpy(alpha, x);
+  return norm();
+}
+
+/*
+  The default implementation of the fused two-vector update
+
+  z <- z + alpha*x + beta*y
+
+  A single-pass implementation halves the memory traffic on z.
+*/
+void TACSVec::axpbypz(TacsScalar alpha, TACSVec *x, TacsScalar beta,
+                      TACSVec *y) {
+  axpy(alpha, x);
+  axpy(beta, y);
+}
+
+/*
+  The default implementation of the fused dot product and norm
+
+  xdot = y^{T}*x and nrm = ||y||
+
+  A single-pass implementation reads y once and combines the two
+  reductions into a single communication step.
+*/
+void TACSVec::dotNorm(TACSVec *x, TacsScalar *xdot, TacsScalar *nrm) {
+  *xdot = dot(x);
+  *nrm = norm();
+}
+
 const char *TACSMat::getObjectName() { return matName; }
 const char *TACSMat::matName = "TACSMat";
 
+/*!
+  Create the lazy linear combination of the given matrices
+
+  input:
+  nmats:  the number of matrices in the combination
+  mats:   the member matrices
+  coefs:  the coefficient of each member matrix
+*/
+TACSLinearCombMat::TACSLinearCombMat(int _nmats, TACSMat **_mats,
+                                     const TacsScalar *_coefs) {
+  nmats = _nmats;
+  mats = new TACSMat *[nmats];
+  coefs = new TacsScalar[nmats];
+  for (int i = 0; i < nmats; i++) {
+    mats[i] = _mats[i];
+    mats[i]->incref();
+    coefs[i] = _coefs[i];
+  }
+
+  temp = mats[0]->createVec();
+  temp->incref();
+}
+
+TACSLinearCombMat::~TACSLinearCombMat() {
+  for (int i = 0; i < nmats; i++) {
+    mats[i]->decref();
+  }
+  delete[] mats;
+  delete[] coefs;
+  temp->decref();
+}
+
+/*
+  Overwrite the coefficients of the combination. The member matrices
+  themselves are untouched, so this is the entire cost of a damping
+  parameter update.
+*/
+void TACSLinearCombMat::setCoefficients(const TacsScalar *_coefs) {
+  for (int i = 0; i < nmats; i++) {
+    coefs[i] = _coefs[i];
+  }
+}
+
+TACSVec *TACSLinearCombMat::createVec() { return mats[0]->createVec(); }
+
+/*
+  Compute y = (coefs[0]*mats[0] + coefs[1]*mats[1] + ...)*x
+
+  The products with the member matrices whose coefficient is zero are
+  skipped entirely.
+*/
+void TACSLinearCombMat::mult(TACSVec *x, TACSVec *y) {
+  y->zeroEntries();
+  for (int i = 0; i < nmats; i++) {
+    if (coefs[i] != TacsScalar(0.0)) {
+      mats[i]->mult(x, temp);
+      y->axpy(coefs[i], temp);
+    }
+  }
+}
+
+const char *TACSLinearCombMat::getObjectName() { return "TACSLinearCombMat"; }
+
 const char *TACSPc::getObjectName() { return pcName; }
 const char *TACSPc::pcName = "TACSPc";
 
+/*
+  Create the deferred-factorization preconditioner wrapper.
+
+  input:
+  mat:  the matrix whose values track the sweep parameter
+  pc:   the preconditioner that factors the matrix
+  rtol: the relative tolerance for the defect-correction refinement
+  max_iters:  the refinement iteration limit for each application
+  refactor_threshold:  the refinement count that triggers a refactor
+*/
+TACSDeferredFactorPc::TACSDeferredFactorPc(TACSMat *_mat, TACSPc *_pc,
+                                           double _rtol, int _max_iters,
+                                           int _refactor_threshold) {
+  mat = _mat;
+  mat->incref();
+  pc = _pc;
+  pc->incref();
+
+  rtol = _rtol;
+  max_iters = _max_iters;
+  refactor_threshold = _refactor_threshold;
+  factored = 0;
+
+  res = mat->createVec();
+  res->incref();
+  update = mat->createVec();
+  update->incref();
+
+  num_applies = 0;
+  num_refine_iters = 0;
+  num_factors = 0;
+}
+
+TACSDeferredFactorPc::~TACSDeferredFactorPc() {
+  mat->decref();
+  pc->decref();
+  res->decref();
+  update->decref();
+}
+
+/*
+  Record that the matrix values have changed. The base factorization
+  is kept and the refactorization is deferred until the refinement in
+  applyFactor() degrades. The first call computes the factorization.
+*/
+void TACSDeferredFactorPc::factor() {
+  if (!factored) {
+    forceFactor();
+  }
+}
+
+/*
+  Unconditionally refactor the base preconditioner
+*/
+void TACSDeferredFactorPc::forceFactor() {
+  pc->factor();
+  factored = 1;
+  num_factors++;
+}
+
+/*
+  Apply the (possibly stale) factorization with defect-correction
+  refinement around the current matrix:
+
+  y_{k+1} = y_k + P^{-1}(x - A*y_k)
+
+  The base preconditioner is refactored when the refinement takes more
+  than refactor_threshold iterations or the residual stops
+  contracting. Once refactored, the refinement continues from the
+  fresh factorization without triggering a second refactor.
+*/
+void TACSDeferredFactorPc::applyFactor(TACSVec *x, TACSVec *y) {
+  int fresh = 0;
+  if (!factored) {
+    forceFactor();
+    fresh = 1;
+  }
+  num_applies++;
+
+  // The initial solve with the stale factorization
+  pc->applyFactor(x, y);
+
+  double xnorm = TacsRealPart(x->norm());
+  double prev_rnorm = 0.0;
+  for (int iters = 0; iters < max_iters; iters++) {
+    // Compute the residual with the current matrix values
+    mat->mult(y, res);
+    res->axpby(1.0, -1.0, x);
+
+    double rnorm = TacsRealPart(res->norm());
+    if (rnorm <= rtol * xnorm) {
+      break;
+    }
+
+    // The refinement has degraded - refactor and restart from the
+    // fresh factorization
+    if (!fresh && (iters + 1 >= refactor_threshold ||
+                   (iters > 0 && rnorm >= 0.5 * prev_rnorm))) {
+      forceFactor();
+      fresh = 1;
+      pc->applyFactor(x, y);
+      continue;
+    }
+
+    prev_rnorm = rnorm;
+    pc->applyFactor(res, update);
+    y->axpy(1.0, update);
+    num_refine_iters++;
+  }
+}
+
+/*
+  Retrieve the matrix associated with the preconditioner
+*/
+void TACSDeferredFactorPc::getMat(TACSMat **_mat) { *_mat = mat; }
+
+/*
+  Retrieve the cumulative counts of preconditioner applications,
+  refinement iterations and base factorizations
+*/
+void TACSDeferredFactorPc::getCounts(int *_num_applies,
+                                     int *_num_refine_iters,
+                                     int *_num_factors) {
+  if (_num_applies) {
+    *_num_applies = num_applies;
+  }
+  if (_num_refine_iters) {
+    *_num_refine_iters = num_refine_iters;
+  }
+  if (_num_factors) {
+    *_num_factors = num_factors;
+  }
+}
+
+/*
+  Create the forcing-term controller. The defaults are the standard
+  Eisenstat-Walker choice 2 parameters with the forcing term bounded
+  between eta_min and eta_max.
+*/
+TACSEisenstatWalker::TACSEisenstatWalker(double _eta_max, double _eta_min,
+                                         double _gamma, double _alpha) {
+  eta_max = _eta_max;
+  eta_min = _eta_min;
+  gamma = _gamma;
+  alpha = _alpha;
+  reset();
+}
+
+/*
+  Reset the controller at the start of a nonlinear solve. The first
+  inner solve uses the loosest tolerance eta_max.
+*/
+void TACSEisenstatWalker::reset() {
+  eta = eta_max;
+  prev_norm = -1.0;
+}
+
+/*
+  Compute the forcing term for the next inner solve from the latest
+  nonlinear residual norm:
+
+  eta_{k} = gamma*(||r_{k}||/||r_{k-1}||)^{alpha}
+
+  safeguarded by eta_{k} >= gamma*eta_{k-1}^{alpha} whenever the
+  safeguard exceeds 0.1, and clipped to [eta_min, eta_max]
+*/
+double TACSEisenstatWalker::update(TacsScalar _res_norm) {
+  double res_norm = TacsRealPart(_res_norm);
+
+  if (prev_norm > 0.0 && res_norm > 0.0) {
+    double eta_new = gamma * pow(res_norm / prev_norm, alpha);
+
+    // Keep the tolerance from dropping too fast after one good step
+    double safeguard = gamma * pow(eta, alpha);
+    if (safeguard > 0.1 && safeguard > eta_new) {
+      eta_new = safeguard;
+    }
+
+    eta = eta_new;
+    if (eta > eta_max) {
+      eta = eta_max;
+    }
+    if (eta < eta_min) {
+      eta = eta_min;
+    }
+  }
+
+  prev_norm = res_norm;
+  return eta;
+}
+
 const char *KSMPrint::getObjectName() { return printName; }
 const char *KSMPrint::printName = "TACSPrint";
 
 const char *TACSKsm::getObjectName() { return ksmName; }
 const char *TACSKsm::ksmName = "TACSKsm";
 
+/*
+  Set the per-iteration callback - possibly NULL - that is invoked by
+  solve() with the raw residual data
+
+  input:
+  _callback: the callback object
+*/
+void TACSKsm::setCallback(TACSKsmCallback *_callback) {
+  if (_callback) {
+    _callback->incref();
+  }
+  if (callback) {
+    callback->decref();
+  }
+  callback = _callback;
+}
+
 /*
   The KSMPrint object controls how the data it output to the screen
   (if at all)
@@ -332,6 +798,56 @@ void KSMPrintFile::print(const char *cstr) {
   }
 }
 
+/*
+  Create the residual history capture buffer
+
+  input:
+  max_iters: the capacity of the history buffer
+*/
+TACSKsmHistory::TACSKsmHistory(int _max_iters) {
+  max_iters = (_max_iters > 0 ? _max_iters : 1);
+  num_entries = 0;
+  res = new TacsScalar[max_iters];
+}
+
+TACSKsmHistory::~TACSKsmHistory() { delete[] res; }
+
+/*
+  Record the residual norm of the iteration. The history restarts
+  when a new solve reports iteration 0.
+
+  input:
+  iter:  the cumulative iteration count
+  _res:  the residual norm
+
+  returns: 0 - the capture never terminates the solve
+*/
+int TACSKsmHistory::iteration(TACSKsm *ksm, int iter, TacsScalar _res) {
+  if (iter == 0) {
+    num_entries = 0;
+  }
+  if (num_entries < max_iters) {
+    res[num_entries] = _res;
+  }
+  num_entries++;
+  return 0;
+}
+
+/*
+  Retrieve the history captured during the most recent solve
+
+  output:
+  _res: the captured residual norms
+
+  returns: the number of entries stored in the buffer
+*/
+int TACSKsmHistory::getHistory(const TacsScalar **_res) {
+  if (_res) {
+    *_res = res;
+  }
+  return (num_entries < max_iters ? num_entries : max_iters);
+}
+
 /*
   The preconditioned conjugate gradient method
 
@@ -438,6 +954,7 @@ void PCG::setMonitor(KSMPrint *_monitor) {
 */
 int PCG::solve(TACSVec *b, TACSVec *x, int zero_guess) {
   int solve_flag = 0;
+  int stop_flag = 0;
   iterCount = 0;
   TacsScalar rhs_norm = 0.0;
   // R, Z and P are work-vectors
@@ -462,6 +979,9 @@ int PCG::solve(TACSVec *b, TACSVec *x, int zero_guess) {
     if (monitor && count == 0) {
       monitor->printResidual(0, rhs_norm);
     }
+    if (callback && count == 0 && callback->iteration(this, 0, rhs_norm)) {
+      break;
+    }
 
     if (TacsRealPart(rhs_norm) > atol) {
       // Apply the preconditioner
@@ -470,22 +990,33 @@ int PCG::solve(TACSVec *b, TACSVec *x, int zero_guess) {
       // Copy Z to P, ie. P = Z
       P->copyValues(Z);
 
+      // (R,Z) is carried between iterations: the value for the next
+      // iteration is computed by the fused dot-norm below
+      TacsScalar temp = R->dot(Z);
+
       for (int i = 0; i < reset; i++) {
         mat->mult(P, work);                        // work = A*P
-        TacsScalar temp = R->dot(Z);               // (R,Z)
         TacsScalar alpha = temp / (work->dot(P));  // alpha = (R,Z)/(A*P,P)
         x->axpy(alpha, P);                         // x = x + alpha*P
         R->axpy(-alpha, work);                     // R' = R - alpha*A*P
         pc->applyFactor(R, Z);                     // Z' = M^{-1} R
-        TacsScalar beta = R->dot(Z) / temp;        // beta = (R',Z')/(R,Z)
-        P->axpby(1.0, beta, Z);                    // P' = Z' + beta*P
-        iterCount++;
 
-        resNorm = R->norm();
+        // Compute (R',Z') and || R' || in one pass over R
+        TacsScalar rz;
+        R->dotNorm(Z, &rz, &resNorm);
+
+        TacsScalar beta = rz / temp;  // beta = (R',Z')/(R,Z)
+        temp = rz;
+        P->axpby(1.0, beta, Z);  // P' = Z' + beta*P
+        iterCount++;
 
         if (monitor) {
           monitor->printResidual(i + 1, resNorm);
         }
+        if (callback && callback->iteration(this, iterCount, resNorm)) {
+          stop_flag = 1;
+          break;
+        }
 
         if (TacsRealPart(resNorm) < atol ||
             TacsRealPart(resNorm) < rtol * TacsRealPart(rhs_norm)) {
@@ -495,7 +1026,7 @@ int PCG::solve(TACSVec *b, TACSVec *x, int zero_guess) {
       }
     }
 
-    if (solve_flag) {
+    if (solve_flag || stop_flag) {
       break;
     }
   }
@@ -503,78 +1034,2133 @@ int PCG::solve(TACSVec *b, TACSVec *x, int zero_guess) {
 }
 
 /*
-  Classical Gram-Schmidt orthogonalization.
+  The pipelined preconditioned conjugate gradient method
 
-  Given an input vector q, and the set of orthogonal vectors w. Make q
-  orthogonal to the set of vectors w.
+  The two inner products of each iteration are fused into a single
+  non-blocking reduction that overlaps with the preconditioner and
+  matrix-vector product.
 
-  Return an array h = w^{T} q.
-  q' = q - w h
-  w^{T} q' = w^{T} q - w^{T} w w^{T} q
+  input:
+  mat:    the matrix operator
+  pc:     the preconditioner operator
+  reset:  reset the CG iterations every 'reset' iterations
+  nouter: the number of resets to try before giving up
 */
-static void ClassicalGramSchmidt(TacsScalar *h, TACSVec *q, TACSVec **w,
-                                 int nvecs) {
-  q->mdot(w, h, nvecs);
-  for (int j = 0; j < nvecs; j++) {
-    q->axpy(-h[j], w[j]);
-  }
-}
+PPCG::PPCG(TACSMat *_mat, TACSPc *_pc, int _reset, int _nouter) {
+  monitor = NULL;
 
-/*
-  Modified Gram-Schmidt orthogonalization
-*/
-static void ModifiedGramSchmidt(TacsScalar *h, TACSVec *q, TACSVec **w,
-                                int nvecs) {
-  for (int j = 0; j < nvecs; j++) {
-    h[j] = w[j]->dot(q);
-    q->axpy(-h[j], w[j]);
-  }
-}
+  mat = _mat;
+  pc = _pc;
 
-/*
-  Create a GMRES object for solving a linear system.
+  mat->incref();
+  pc->incref();
 
-  This automatically allocates the requried Krylov subspace on
-  initialization.
+  reset = _reset;
+  nouter = _nouter;
 
-  input:
-  mat:        the matrix operator
-  pc:         the preconditioner
-  m:          the size of the Krylov subspace
-  nrestart:   the number of restarts before we give up
-  isFlexible: is the preconditioner actually flexible? If so use FGMRES
-*/
-GMRES::GMRES(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart,
-             int _isFlexible) {
-  init(_mat, _pc, _m, _nrestart, _isFlexible);
-}
+  // Set default absolute and relative tolerances
+  rtol = 1e-8;
+  atol = 1e-30;
 
-/*
-  Initialize GMRES without a preconditioner. This is used for the
-  ApproximateSchur preconditioner.
+  // Create the vectors required
+  R = mat->createVec();
+  U = mat->createVec();
+  W = mat->createVec();
+  Mv = mat->createVec();
+  Nv = mat->createVec();
+  P = mat->createVec();
+  S = mat->createVec();
+  Q = mat->createVec();
+  Z = mat->createVec();
+
+  R->incref();
+  U->incref();
+  W->incref();
+  Mv->incref();
+  Nv->incref();
+  P->incref();
+  S->incref();
+  Q->incref();
+  Z->incref();
+}
+
+PPCG::~PPCG() {
+  mat->decref();
+  pc->decref();
+
+  R->decref();
+  U->decref();
+  W->decref();
+  Mv->decref();
+  Nv->decref();
+  P->decref();
+  S->decref();
+  Q->decref();
+  Z->decref();
+}
+
+/*
+  Set the operators for the pipelined conjugate gradient method.
+*/
+void PPCG::setOperators(TACSMat *_mat, TACSPc *_pc) {
+  if (_mat) {
+    _mat->incref();
+    if (mat) {
+      mat->decref();
+    }
+    mat = _mat;
+  }
+  if (_pc) {
+    _pc->incref();
+    if (pc) {
+      pc->decref();
+    }
+    pc = _pc;
+  }
+}
+
+void PPCG::getOperators(TACSMat **_mat, TACSPc **_pc) {
+  if (_mat) {
+    *_mat = mat;
+  }
+  if (_pc) {
+    *_pc = pc;
+  }
+}
+
+void PPCG::setTolerances(double _rtol, double _atol) {
+  rtol = _rtol;
+  atol = _atol;
+}
+
+void PPCG::setMonitor(KSMPrint *_monitor) {
+  _monitor->incref();
+  if (monitor) {
+    monitor->decref();
+  }
+  monitor = _monitor;
+}
+
+/*
+  Solve the linear system with the pipelined preconditioned conjugate
+  gradient method
+
+  Each iteration starts the fused reduction for gamma = (U,R) and
+  delta = (U,W) and then applies the preconditioner and the matrix to
+  form the auxiliary vectors while the reduction is in flight. The
+  convergence test uses the preconditioner-norm of the residual
+  sqrt((U,R)), since that is the quantity computed by the fused
+  reduction; the true residual is re-established at every reset.
+
+  input:
+  b:          the right-hand-side
+  x:          the solution vector
+  zero_guess: flag to indicate whether to start with x = 0
+
+  output:
+  solve_flag: flag for the whether the solve terminated successfully
+*/
+int PPCG::solve(TACSVec *b, TACSVec *x, int zero_guess) {
+  int solve_flag = 0;
+  int stop_flag = 0;
+  iterCount = 0;
+  TacsScalar rhs_norm = 0.0;
+
+  for (int count = 0; count < nouter; count++) {
+    // Compute the residual from scratch - this also applies the
+    // residual replacement at each reset
+    if (zero_guess && count == 0) {
+      x->zeroEntries();  // Set x = 0
+      R->copyValues(b);  // R = b
+    } else {
+      mat->mult(x, R);         // R = A*x
+      R->axpby(1.0, -1.0, b);  // R = b - A*x
+    }
+
+    pc->applyFactor(R, U);  // U = M^{-1}*R
+    mat->mult(U, W);        // W = A*U
+
+    // The scalars from the previous iteration
+    TacsScalar gamma_old = 1.0, alpha_old = 1.0;
+
+    for (int i = 0; i < reset; i++) {
+      // Start the fused reduction for gamma = (U,R) and delta = (U,W)
+      TACSVec *vecs[2] = {R, W};
+      TacsScalar dots[2];
+      U->mdot_begin(vecs, dots, 2);
+
+      // Overlap the preconditioner and the matrix-vector product
+      // with the reduction
+      pc->applyFactor(W, Mv);  // Mv = M^{-1}*W
+      mat->mult(Mv, Nv);       // Nv = A*Mv
+
+      // Complete the reduction
+      U->mdot_end(dots, 2);
+      TacsScalar gamma = dots[0];
+      TacsScalar delta = dots[1];
+
+      // The preconditioner-norm of the residual
+      resNorm = sqrt(fabs(TacsRealPart(gamma)));
+
+      if (i == 0 && count == 0) {
+        rhs_norm = resNorm;
+        if (monitor) {
+          monitor->printResidual(0, rhs_norm);
+        }
+        if (callback && callback->iteration(this, 0, rhs_norm)) {
+          stop_flag = 1;
+          break;
+        }
+      }
+
+      if (TacsRealPart(resNorm) < atol ||
+          TacsRealPart(resNorm) < rtol * TacsRealPart(rhs_norm)) {
+        solve_flag = 1;
+        break;
+      }
+
+      // Compute the scalars and update the recurrences
+      TacsScalar alpha, beta;
+      if (i == 0) {
+        beta = 0.0;
+        alpha = gamma / delta;
+        Z->copyValues(Nv);  // Z = Nv
+        Q->copyValues(Mv);  // Q = Mv
+        S->copyValues(W);   // S = W
+        P->copyValues(U);   // P = U
+      } else {
+        beta = gamma / gamma_old;
+        alpha = gamma / (delta - beta * gamma / alpha_old);
+        Z->axpby(1.0, beta, Nv);  // Z = Nv + beta*Z
+        Q->axpby(1.0, beta, Mv);  // Q = Mv + beta*Q
+        S->axpby(1.0, beta, W);   // S = W + beta*S
+        P->axpby(1.0, beta, U);   // P = U + beta*P
+      }
+
+      x->axpy(alpha, P);   // x = x + alpha*P
+      R->axpy(-alpha, S);  // R = R - alpha*S
+      U->axpy(-alpha, Q);  // U = U - alpha*Q
+      W->axpy(-alpha, Z);  // W = W - alpha*Z
+
+      gamma_old = gamma;
+      alpha_old = alpha;
+      iterCount++;
+
+      if (monitor) {
+        monitor->printResidual(iterCount, resNorm);
+      }
+      if (callback && callback->iteration(this, iterCount, resNorm)) {
+        stop_flag = 1;
+        break;
+      }
+    }
+
+    if (solve_flag || stop_flag) {
+      break;
+    }
+  }
+  return solve_flag;
+}
+
+/*
+  Create the block conjugate gradient method for solving linear
+  systems with multiple right-hand sides simultaneously. The
+  preconditioner cannot be flexible.
+
+  input:
+  mat:    the matrix operator
+  pc:     the preconditioner operator
+  nrhs:   the number of simultaneous right-hand sides
+  reset:  reset the CG iterations every 'reset' iterations
+  nouter: the number of resets to try before giving up
+*/
+BlockPCG::BlockPCG(TACSMat *_mat, TACSPc *_pc, int _nrhs, int _reset,
+                   int _nouter) {
+  monitor = NULL;
+
+  mat = _mat;
+  pc = _pc;
+
+  mat->incref();
+  pc->incref();
+
+  nrhs = (_nrhs > 1 ? _nrhs : 1);
+  reset = _reset;
+  nouter = _nouter;
+
+  // Set default absolute and relative tolerances
+  rtol = 1e-8;
+  atol = 1e-30;
+
+  // Create the block vectors required
+  W = new TACSVec *[nrhs];
+  R = new TACSVec *[nrhs];
+  Z = new TACSVec *[nrhs];
+  P = new TACSVec *[nrhs];
+  for (int i = 0; i < nrhs; i++) {
+    W[i] = mat->createVec();
+    R[i] = mat->createVec();
+    Z[i] = mat->createVec();
+    P[i] = mat->createVec();
+    W[i]->incref();
+    R[i]->incref();
+    Z[i]->incref();
+    P[i]->incref();
+  }
+
+  // Allocate the coefficient matrices
+  gamma = new TacsScalar[nrhs * nrhs];
+  delta = new TacsScalar[nrhs * nrhs];
+  cmat = new TacsScalar[nrhs * nrhs];
+  cpiv = new int[nrhs];
+}
+
+BlockPCG::~BlockPCG() {
+  mat->decref();
+  pc->decref();
+
+  for (int i = 0; i < nrhs; i++) {
+    W[i]->decref();
+    R[i]->decref();
+    Z[i]->decref();
+    P[i]->decref();
+  }
+  delete[] W;
+  delete[] R;
+  delete[] Z;
+  delete[] P;
+
+  delete[] gamma;
+  delete[] delta;
+  delete[] cmat;
+  delete[] cpiv;
+
+  if (monitor) {
+    monitor->decref();
+  }
+}
+
+/*
+  Set the operators for the block conjugate gradient method.
+*/
+void BlockPCG::setOperators(TACSMat *_mat, TACSPc *_pc) {
+  if (_mat) {
+    _mat->incref();
+    if (mat) {
+      mat->decref();
+    }
+    mat = _mat;
+  }
+  if (_pc) {
+    _pc->incref();
+    if (pc) {
+      pc->decref();
+    }
+    pc = _pc;
+  }
+}
+
+void BlockPCG::getOperators(TACSMat **_mat, TACSPc **_pc) {
+  if (_mat) {
+    *_mat = mat;
+  }
+  if (_pc) {
+    *_pc = pc;
+  }
+}
+
+void BlockPCG::setTolerances(double _rtol, double _atol) {
+  rtol = _rtol;
+  atol = _atol;
+}
+
+void BlockPCG::setMonitor(KSMPrint *_monitor) {
+  _monitor->incref();
+  if (monitor) {
+    monitor->decref();
+  }
+  monitor = _monitor;
+}
+
+/*
+  Solve a single linear system with a degenerate 1 x 1 block
+*/
+int BlockPCG::solve(TACSVec *b, TACSVec *x, int zero_guess) {
+  return solveBlock(1, &b, &x, zero_guess);
+}
+
+/*
+  Solve the nrhs linear systems simultaneously
+
+  input:
+  b:          the right-hand sides
+  x:          the solution vectors
+  zero_guess: flag to indicate whether to start with x = 0
+
+  output:
+  solve_flag: flag for whether all systems converged
+*/
+int BlockPCG::solveRHS(TACSVec **b, TACSVec **x, int zero_guess) {
+  return solveBlock(nrhs, b, x, zero_guess);
+}
+
+/*
+  Solve the first m <= nrhs systems with the block conjugate gradient
+  method
+
+  The block recurrences follow O'Leary's formulation: with
+  gamma = R^{T}*Z and delta = P^{T}*A*P, the step and conjugation
+  coefficients are the solutions of the m x m systems
+  delta*alpha = gamma and gamma*beta = gamma', where gamma' is
+  computed from the updated residual. Each matrix-multivector product
+  is a single call to mat->multRHS() and each set of inner products
+  is batched through mdot() to limit the number of all-reduce
+  operations.
+*/
+int BlockPCG::solveBlock(int m, TACSVec **b, TACSVec **x, int zero_guess) {
+  int solve_flag = 0;
+  int info = 0;
+  iterCount = 0;
+  TacsScalar rhs_norm = 0.0;
+
+  for (int count = 0; count < nouter; count++) {
+    // R is the block residual
+    if (zero_guess && count == 0) {
+      for (int j = 0; j < m; j++) {
+        x[j]->zeroEntries();   // Set x = 0
+        R[j]->copyValues(b[j]);  // R = b
+      }
+    } else {
+      mat->multRHS(m, x, R);  // R = A*x
+      for (int j = 0; j < m; j++) {
+        R[j]->axpby(1.0, -1.0, b[j]);  // R = b - A*x
+      }
+    }
+
+    if (count == 0) {
+      // Take the largest residual norm as the reference norm
+      for (int j = 0; j < m; j++) {
+        TacsScalar norm = R[j]->norm();
+        if (TacsRealPart(norm) > TacsRealPart(rhs_norm)) {
+          rhs_norm = norm;
+        }
+      }
+      resNorm = rhs_norm;
+    }
+
+    if (monitor && count == 0) {
+      monitor->printResidual(0, rhs_norm);
+    }
+
+    if (TacsRealPart(rhs_norm) > atol) {
+      // Apply the preconditioner and set P = Z
+      for (int j = 0; j < m; j++) {
+        pc->applyFactor(R[j], Z[j]);
+        P[j]->copyValues(Z[j]);
+      }
+
+      // Compute gamma = R^{T}*Z
+      for (int j = 0; j < m; j++) {
+        Z[j]->mdot(R, &gamma[m * j], m);
+      }
+
+      for (int i = 0; i < reset; i++) {
+        mat->multRHS(m, P, W);  // W = A*P
+
+        // Compute delta = P^{T}*(A*P) and solve delta*alpha = gamma
+        for (int j = 0; j < m; j++) {
+          W[j]->mdot(P, &delta[m * j], m);
+        }
+        memcpy(cmat, gamma, m * m * sizeof(TacsScalar));
+        LAPACKgetrf(&m, &m, delta, &m, cpiv, &info);
+        LAPACKgetrs("N", &m, &m, delta, &m, cpiv, cmat, &m, &info);
+
+        // Update x = x + P*alpha and R = R - (A*P)*alpha
+        for (int j = 0; j < m; j++) {
+          for (int k = 0; k < m; k++) {
+            x[j]->axpy(cmat[k + m * j], P[k]);
+            R[j]->axpy(-cmat[k + m * j], W[k]);
+          }
+        }
+
+        // Apply the preconditioner and compute gamma' = R'^{T}*Z'
+        for (int j = 0; j < m; j++) {
+          pc->applyFactor(R[j], Z[j]);
+        }
+        memcpy(cmat, gamma, m * m * sizeof(TacsScalar));
+        for (int j = 0; j < m; j++) {
+          Z[j]->mdot(R, &gamma[m * j], m);
+        }
+
+        // Solve gamma*beta = gamma' for the conjugation coefficients.
+        // The factored delta is no longer needed, so it stores beta.
+        memcpy(delta, gamma, m * m * sizeof(TacsScalar));
+        LAPACKgetrf(&m, &m, cmat, &m, cpiv, &info);
+        LAPACKgetrs("N", &m, &m, cmat, &m, cpiv, delta, &m, &info);
+
+        // Update the search directions P' = Z' + P*beta using W as
+        // temporary storage, then swap the two sets of vectors
+        for (int j = 0; j < m; j++) {
+          W[j]->copyValues(Z[j]);
+          for (int k = 0; k < m; k++) {
+            W[j]->axpy(delta[k + m * j], P[k]);
+          }
+        }
+        TACSVec **t = P;
+        P = W;
+        W = t;
+        iterCount++;
+
+        // Check the maximum residual norm over the block
+        resNorm = 0.0;
+        for (int j = 0; j < m; j++) {
+          TacsScalar norm = R[j]->norm();
+          if (TacsRealPart(norm) > TacsRealPart(resNorm)) {
+            resNorm = norm;
+          }
+        }
+
+        if (monitor) {
+          monitor->printResidual(i + 1, resNorm);
+        }
+
+        if (TacsRealPart(resNorm) < atol ||
+            TacsRealPart(resNorm) < rtol * TacsRealPart(rhs_norm)) {
+          solve_flag = 1;
+          break;
+        }
+      }
+    } else {
+      solve_flag = 1;
+    }
+
+    if (solve_flag) {
+      break;
+    }
+  }
+  return solve_flag;
+}
+
+/*
+  Classical Gram-Schmidt orthogonalization.
+
+  Given an input vector q, and the set of orthogonal vectors w. Make q
+  orthogonal to the set of vectors w.
+
+  Return an array h = w^{T} q.
+  q' = q - w h
+  w^{T} q' = w^{T} q - w^{T} w w^{T} q
+*/
+static void ClassicalGramSchmidt(TacsScalar *h, TACSVec *q, TACSVec **w,
+                                 int nvecs) {
+  q->mdot(w, h, nvecs);
+  for (int j = 0; j < nvecs; j++) {
+    q->axpy(-h[j], w[j]);
+  }
+}
+
+/*
+  Modified Gram-Schmidt orthogonalization
+*/
+static void ModifiedGramSchmidt(TacsScalar *h, TACSVec *q, TACSVec **w,
+                                int nvecs) {
+  for (int j = 0; j < nvecs; j++) {
+    h[j] = w[j]->dot(q);
+    q->axpy(-h[j], w[j]);
+  }
+}
+
+/*
+  Blocked modified Gram-Schmidt orthogonalization
+
+  The previous vectors are processed in blocks: within each block the
+  projections are computed with one fused mdot and subtracted
+  together, while successive blocks see the partially orthogonalized
+  vector as in modified Gram-Schmidt. This streams q through memory
+  twice per block instead of twice per previous vector, which
+  dominates the orthogonalization cost for large subspace sizes. It
+  also performs one reduction per block rather than one per vector.
+
+  The blocked sweep is slightly less stable than vector-at-a-time
+  modified Gram-Schmidt; the GMRES loop compensates with adaptive
+  reorthogonalization.
+*/
+static void BlockedGramSchmidt(TacsScalar *h, TACSVec *q, TACSVec **w,
+                               int nvecs) {
+  const int block = 8;
+  for (int j = 0; j < nvecs; j += block) {
+    int nb = (nvecs - j < block ? nvecs - j : block);
+    q->mdot(&w[j], &h[j], nb);
+
+    // Subtract the projections in fused pairs so that q streams
+    // through memory half as many times
+    int k = 0;
+    for (; k < nb - 1; k += 2) {
+      q->axpbypz(-h[j + k], w[j + k], -h[j + k + 1], w[j + k + 1]);
+    }
+    if (k < nb) {
+      q->axpy(-h[j + k], w[j + k]);
+    }
+  }
+}
+
+/*
+  Accumulate the linear combination x <- x + sum_{i} alpha[i]*v[i]
+
+  The updates are fused in pairs so that x streams through memory half
+  as many times as with repeated axpy calls.
+*/
+static void SumVecs(TACSVec *x, const TacsScalar *alpha, TACSVec **v, int n) {
+  int i = 0;
+  for (; i < n - 1; i += 2) {
+    x->axpbypz(alpha[i], v[i], alpha[i + 1], v[i + 1]);
+  }
+  if (i < n) {
+    x->axpy(alpha[i], v[i]);
+  }
+}
+
+/*
+  Create a GMRES object for solving a linear system.
+
+  This automatically allocates the requried Krylov subspace on
+  initialization.
+
+  input:
+  mat:        the matrix operator
+  pc:         the preconditioner
+  m:          the size of the Krylov subspace
+  nrestart:   the number of restarts before we give up
+  isFlexible: is the preconditioner actually flexible? If so use FGMRES
+*/
+GMRES::GMRES(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart,
+             int _isFlexible) {
+  init(_mat, _pc, _m, _nrestart, _isFlexible);
+}
+
+/*
+  Initialize GMRES without a preconditioner. This is used for the
+  ApproximateSchur preconditioner.
+
+  input:
+  mat:      the matrix operator
+  m:        the size of the Krylov subspace
+  nrestart: try this many times before giving up
+*/
+GMRES::GMRES(TACSMat *_mat, int _m, int _nrestart) {
+  init(_mat, NULL, _m, _nrestart, 0);
+}
+
+/*
+  Initialize the underlying GMRES data structure.
+
+  This is called by both of the two constructors above.
+*/
+void GMRES::init(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart,
+                 int _isFlexible) {
+  orthogonalize = BlockedGramSchmidt;
+  monitor = NULL;
+  monitor_time = 0;
+  msub = _m;
+  nrestart = (_nrestart >= 0 ? _nrestart : 0);
+  isFlexible = _isFlexible;
+
+  mat = _mat;
+  pc = _pc;
+  mat->incref();
+
+  if (pc) {
+    pc->incref();
+  } else {
+    // If there's no Pc then it doesn't have to be a flexible variant
+    isFlexible = 0;
+  }
+
+  // Set default absolute and relative tolerances
+  rtol = 1e-8;
+  atol = 1e-30;
+
+  // Allocate the subspace of vectors
+  work = NULL;  // Required only for regular GMRES
+  Z = NULL;     // Required only for flexible GMRES
+  W = new TACSVec *[msub + 1];
+
+  for (int i = 0; i < msub + 1; i++) {
+    W[i] = mat->createVec();
+    W[i]->incref();
+  }
+
+  if (isFlexible) {
+    Z = new TACSVec *[msub];
+    for (int i = 0; i < msub; i++) {
+      Z[i] = mat->createVec();
+      Z[i]->incref();
+    }
+  } else if (pc) {
+    // Allocate the work array
+    work = mat->createVec();
+    work->incref();
+  }
+
+  // Allocate space for the Hessenberg matrix
+  // This is a (msub+1) x msub matrix with non-zeros
+  // on and above the first diagonal below the main diagonal
+  Hptr = new int[msub + 1];
+  Hptr[0] = 0;
+
+  for (int i = 0; i < msub; i++) {
+    Hptr[i + 1] = Hptr[i] + i + 2;
+  }
+
+  int size = Hptr[msub];
+  H = new TacsScalar[size];        // The Hessenberg matrix
+  res = new TacsScalar[msub + 1];  // The residual
+
+  memset(H, 0, size * sizeof(TacsScalar));
+  memset(res, 0, (msub + 1) * sizeof(TacsScalar));
+
+  // Allocate the terms that represent the unitary Q matrix
+  // in the QR factorixation of H
+  Qsin = new TacsScalar[msub];
+  Qcos = new TacsScalar[msub];
+
+  memset(Qsin, 0, msub * sizeof(TacsScalar));
+  memset(Qcos, 0, msub * sizeof(TacsScalar));
+
+  // Corrections computed by the reorthogonalization passes
+  hcorr = new TacsScalar[msub + 1];
+  memset(hcorr, 0, (msub + 1) * sizeof(TacsScalar));
+}
+
+/*
+  Free the data/memory allocated by GMRES
+*/
+GMRES::~GMRES() {
+  mat->decref();
+
+  if (pc) {
+    pc->decref();
+  }
+  if (work) {
+    work->decref();
+  }
+
+  if (Z) {
+    for (int i = 0; i < msub; i++) {
+      Z[i]->decref();
+    }
+    delete[] Z;
+  }
+
+  for (int i = 0; i < msub + 1; i++) {
+    W[i]->decref();
+  }
+  delete[] W;
+
+  if (monitor) {
+    monitor->decref();
+  }
+
+  delete[] H;
+  delete[] Hptr;
+  delete[] res;
+  delete[] hcorr;
+  delete[] Qsin;
+  delete[] Qcos;
+}
+
+/*
+  Set the matrix and/or preconditioner operators. If either (or both)
+  are NULL, then the operator is not replaced.
+
+  input:
+  mat: the new matrix operator (possibly NULL)
+  pc:  the new preconditioner operator (possibly NULL)
+*/
+void GMRES::setOperators(TACSMat *_mat, TACSPc *_pc) {
+  if (_mat) {
+    _mat->incref();
+    if (mat) {
+      mat->decref();
+    }
+    mat = _mat;
+  }
+  if (_pc) {
+    _pc->incref();
+    if (pc) {
+      pc->decref();
+    }
+    pc = _pc;
+  }
+}
+
+/*
+  Retrieve the preconditioner operators from GMRES
+
+  output:
+  mat: the matrix
+  pc:  the preconditioner
+*/
+void GMRES::getOperators(TACSMat **_mat, TACSPc **_pc) {
+  if (_mat) {
+    *_mat = mat;
+  }
+  if (_pc) {
+    *_pc = pc;
+  }
+}
+
+/*
+  Set the relative and absolute tolerances used for the stopping
+  criterion.
+
+  input:
+  rtol: the relative tolerance ||r_k|| < rtol*||r_0||
+  atol: the absolute tolerancne ||r_k|| < atol
+*/
+void GMRES::setTolerances(double _rtol, double _atol) {
+  rtol = _rtol;
+  atol = _atol;
+}
+
+/*
+  Set the object to control how the convergence history is displayed
+  (if at all)
+
+  input:
+  monitor: the KSMPrint monitor object
+*/
+void GMRES::setMonitor(KSMPrint *_monitor) {
+  _monitor->incref();
+  if (monitor) {
+    monitor->decref();
+  }
+  monitor = _monitor;
+}
+
+/*
+  Set the type of orthogonalization to use. This will be classical
+  Gram-Schmidt, modified Gram-Schmidt or blocked modified
+  Gram-Schmidt (default).
+
+  The blocked variant has the lowest memory traffic and fewest
+  reductions; with the adaptive reorthogonalization performed in the
+  solve it is as robust as modified Gram-Schmidt in practice.
+*/
+void GMRES::setOrthoType(enum OrthoType otype) {
+  if (otype == CLASSICAL_GRAM_SCHMIDT) {
+    orthogonalize = ClassicalGramSchmidt;
+  } else if (otype == MODIFIED_GRAM_SCHMIDT) {
+    orthogonalize = ModifiedGramSchmidt;
+  } else {
+    orthogonalize = BlockedGramSchmidt;
+  }
+}
+
+/*
+  Set a flag to also monitor the time spent in various operations
+  internally.
+*/
+void GMRES::setTimeMonitor() { monitor_time = 1; }
+
+const char *GMRES::getObjectName() { return gmresName; }
+
+const char *GMRES::gmresName = "GMRES";
+
+/*
+  Try to solve the linear system using GMRES.
+
+  The following code tries to solve the linear system using GMRES (or
+  FGMRES if the preconditioner is flexible.)
+
+  input:
+  b:          the right-hand-side
+  x:          the solution vector (with possibly significant entries)
+  zero_guess: flag to indicate whether to zero entries of x before solution
+
+  output:
+  solve_flag: flag for the whether the solve terminated successfully
+*/
+int GMRES::solve(TACSVec *b, TACSVec *x, int zero_guess) {
+  TacsProfileScope profile("GMRES::solve");
+  TacsScalar rhs_norm = 0.0;
+  int solve_flag = 0;
+  int stop_flag = 0;
+  iterCount = 0;
+
+  double t_pc = 0.0, t_ortho = 0.0;
+  double t_total = 0.0;
+
+  if (monitor_time) {
+    t_total = MPI_Wtime();
+  }
+
+  for (int count = 0; count < nrestart + 1; count++) {
+    // Compute the residual
+    if (zero_guess && count == 0) {
+      // If the initial guess is zero
+      x->zeroEntries();     // Set x = 0
+      W[0]->copyValues(b);  // W[0] = b
+
+      res[0] = W[0]->norm();
+      W[0]->scale(1.0 / res[0]);  // W[0] = b/|| b ||
+    } else {
+      // If the initial guess is non-zero or restarting
+      mat->mult(x, W[0]);
+
+      // W[0] = A*x - b with the norm fused into the update
+      res[0] = W[0]->axpyNorm(-1.0, b);
+      W[0]->scale(-1.0 / res[0]);  // W[0] = (b - A*x)/|| b - A*x ||
+    }
+
+    if (monitor) {
+      monitor->printResidual(0, fabs(TacsRealPart(res[0])));
+    }
+
+    if (count == 0) {
+      rhs_norm = res[0];  // The initial residual
+      resNorm = rhs_norm;
+      if (callback &&
+          callback->iteration(this, 0, fabs(TacsRealPart(res[0])))) {
+        break;
+      }
+    }
+
+    int niters = 0;  // Keep track of the size of the Hessenberg matrix
+
+    if (TacsRealPart(res[0]) < atol) {
+      solve_flag = 1;
+      break;
+    }
+
+    for (int i = 0; i < msub; i++) {
+      if (monitor_time) {
+        t_pc -= MPI_Wtime();
+      }
+      if (isFlexible) {
+        // Apply the preconditioner, Z[i] = M^{-1} W[i]
+        pc->applyFactor(W[i], Z[i]);
+        mat->mult(Z[i], W[i + 1]);  // W[i+1] = A*Z[i] = A*M^{-1}*W[i]
+      } else {
+        if (pc) {
+          // Apply the preconditioner, work = M^{-1} W[i]
+          pc->applyFactor(W[i], work);
+          mat->mult(work, W[i + 1]);  // W[i+1] = A*work = A*M^{-1}*W[i]
+        } else {
+          mat->mult(W[i], W[i + 1]);  // Compute W[i+1] = A*W[i]
+        }
+      }
+      if (monitor_time) {
+        double t0 = MPI_Wtime();
+        t_pc += t0;
+        t_ortho -= t0;
+      }
+
+      // Build the orthogonal basis using the selected Gram-Schmidt
+      // variant
+      orthogonalize(&H[Hptr[i]], W[i + 1], W, i + 1);
+
+      H[i + 1 + Hptr[i]] = W[i + 1]->norm();  // H[i+1,i] = || W[i+1] ||
+
+      // Reorthogonalize adaptively based on the Rutishauser
+      // criterion: when the norm of the vector drops by more than
+      // 1/sqrt(2) during orthogonalization, the cancellation has
+      // eaten into the significant digits and a second pass is
+      // required. The pre-orthogonalization norm is recovered from
+      // the Pythagorean identity, so the test costs no additional
+      // reduction.
+      TacsScalar wnorm2 = H[i + 1 + Hptr[i]] * H[i + 1 + Hptr[i]];
+      for (int k = 0; k <= i; k++) {
+        wnorm2 += H[k + Hptr[i]] * H[k + Hptr[i]];
+      }
+      if (TacsRealPart(H[i + 1 + Hptr[i]] * H[i + 1 + Hptr[i]]) <
+          0.5 * TacsRealPart(wnorm2)) {
+        orthogonalize(hcorr, W[i + 1], W, i + 1);
+        for (int k = 0; k <= i; k++) {
+          H[k + Hptr[i]] += hcorr[k];
+        }
+        H[i + 1 + Hptr[i]] = W[i + 1]->norm();
+      }
+      if (monitor_time) {
+        t_ortho += MPI_Wtime();
+      }
+
+      W[i + 1]->scale(1.0 /
+                      H[i + 1 + Hptr[i]]);  // W[i+1] = W[i+1]/|| W[i+1] ||
+
+      // Apply the existing part of Q to the new components of
+      // the Hessenberg matrix
+      TacsScalar h1, h2;
+      for (int k = 0; k < i; k++) {
+        h1 = H[k + Hptr[i]];
+        h2 = H[k + 1 + Hptr[i]];
+        H[k + Hptr[i]] = h1 * Qcos[k] + h2 * Qsin[k];
+        H[k + 1 + Hptr[i]] = -h1 * Qsin[k] + h2 * Qcos[k];
+      }
+
+      // Now, compute the rotation for the new column that was just added
+      h1 = H[i + Hptr[i]];
+      h2 = H[i + 1 + Hptr[i]];
+      TacsScalar sq = sqrt(h1 * h1 + h2 * h2);
+
+      Qcos[i] = h1 / sq;
+      Qsin[i] = h2 / sq;
+      H[i + Hptr[i]] = h1 * Qcos[i] + h2 * Qsin[i];
+      H[i + 1 + Hptr[i]] = -h1 * Qsin[i] + h2 * Qcos[i];
+
+      // Update the residual
+      h1 = res[i];
+      // h2 = res[i+1]; = 0
+      res[i] = h1 * Qcos[i];
+      res[i + 1] = -h1 * Qsin[i];
+
+      niters++;
+      resNorm = fabs(res[i + 1]);
+
+      if (monitor) {
+        monitor->printResidual(i + 1, resNorm);
+      }
+      if (callback && callback->iteration(this, iterCount + niters, resNorm)) {
+        stop_flag = 1;
+        break;
+      }
+
+      if (TacsRealPart(resNorm) < atol ||
+          TacsRealPart(resNorm) < rtol * TacsRealPart(rhs_norm)) {
+        // Set the solve flag
+        solve_flag = 1;
+
+        break;
+      }
+    }
+
+    iterCount += niters;
+
+    // Now, compute the solution - the linear combination of the
+    // Arnoldi vectors. H is upper triangular
+
+    // Compute the weights
+    for (int i = niters - 1; i >= 0; i--) {
+      for (int j = i + 1; j < niters; j++) {  //
+        res[i] = res[i] - H[i + Hptr[j]] * res[j];
+      }
+      res[i] = res[i] / H[i + Hptr[i]];
+    }
+
+    // Compute the linear combination with fused pairs of updates
+    if (isFlexible) {  // Flexible variant
+      SumVecs(x, res, Z, niters);
+    } else if (!pc) {  // If there's no pc
+      SumVecs(x, res, W, niters);
+    } else {  // If the pc isn't flexible
+      work->zeroEntries();
+      SumVecs(work, res, W, niters);
+
+      // Apply M^{-1} to the linear combination
+      pc->applyFactor(work, W[0]);
+      x->axpy(1.0, W[0]);
+    }
+
+    if (solve_flag || stop_flag) {
+      break;
+    }
+  }
+
+  if (monitor_time && monitor) {
+    t_total = MPI_Wtime() - t_total;
+    char str_mat[80], str_ort[80], str_tot[80];
+    sprintf(str_mat, "pc-mat time %10.6f\n", t_pc);
+    sprintf(str_ort, "ortho time  %10.6f\n", t_ortho);
+    sprintf(str_tot, "total time  %10.6f\n", t_total);
+    monitor->print(str_mat);
+    monitor->print(str_ort);
+    monitor->print(str_tot);
+  }
+
+  TacsProfileAddCount("GMRES iterations", iterCount);
+
+  return solve_flag;
+}
+
+/*
+  Create a pipelined GMRES object for solving a linear system.
+
+  This automatically allocates the required Krylov subspace and the
+  matching subspace of operator images on initialization.
+
+  input:
+  mat:        the matrix operator
+  pc:         the preconditioner
+  m:          the size of the Krylov subspace
+  nrestart:   the number of restarts before we give up
+*/
+PGMRES::PGMRES(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart) {
+  init(_mat, _pc, _m, _nrestart);
+}
+
+/*
+  Initialize pipelined GMRES without a preconditioner
+
+  input:
+  mat:      the matrix operator
+  m:        the size of the Krylov subspace
+  nrestart: try this many times before giving up
+*/
+PGMRES::PGMRES(TACSMat *_mat, int _m, int _nrestart) {
+  init(_mat, NULL, _m, _nrestart);
+}
+
+/*
+  Initialize the underlying PGMRES data structure.
+
+  This is called by both of the two constructors above.
+*/
+void PGMRES::init(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart) {
+  monitor = NULL;
+  monitor_time = 0;
+  msub = _m;
+  nrestart = (_nrestart >= 0 ? _nrestart : 0);
+
+  mat = _mat;
+  pc = _pc;
+  mat->incref();
+
+  if (pc) {
+    pc->incref();
+  }
+
+  // Set default absolute and relative tolerances
+  rtol = 1e-8;
+  atol = 1e-30;
+
+  // Allocate the subspace of Arnoldi vectors and the subspace of
+  // their images under the preconditioned operator
+  W = new TACSVec *[msub + 1];
+  V = new TACSVec *[msub + 1];
+
+  for (int i = 0; i < msub + 1; i++) {
+    W[i] = mat->createVec();
+    W[i]->incref();
+    V[i] = mat->createVec();
+    V[i]->incref();
+  }
+
+  // The fused dot product computes the products with the existing
+  // basis vectors and the candidate vector itself in one reduction
+  dotw = new TACSVec *[msub + 1];
+  for (int i = 0; i < msub + 1; i++) {
+    dotw[i] = W[i];
+  }
+
+  work = NULL;
+  if (pc) {
+    work = mat->createVec();
+    work->incref();
+  }
+
+  // Allocate space for the Hessenberg matrix
+  // This is a (msub+1) x msub matrix with non-zeros
+  // on and above the first diagonal below the main diagonal
+  Hptr = new int[msub + 1];
+  Hptr[0] = 0;
+
+  for (int i = 0; i < msub; i++) {
+    Hptr[i + 1] = Hptr[i] + i + 2;
+  }
+
+  int size = Hptr[msub];
+  H = new TacsScalar[size];        // The Hessenberg matrix
+  res = new TacsScalar[msub + 1];  // The residual
+
+  memset(H, 0, size * sizeof(TacsScalar));
+  memset(res, 0, (msub + 1) * sizeof(TacsScalar));
+
+  // Allocate the terms that represent the unitary Q matrix
+  // in the QR factorixation of H
+  Qsin = new TacsScalar[msub];
+  Qcos = new TacsScalar[msub];
+
+  memset(Qsin, 0, msub * sizeof(TacsScalar));
+  memset(Qcos, 0, msub * sizeof(TacsScalar));
+
+  // Allocate the fused Gram-Schmidt coefficients here so that solve
+  // does not allocate in steady state
+  gwork = new TacsScalar[msub + 1];
+  memset(gwork, 0, (msub + 1) * sizeof(TacsScalar));
+}
+
+/*
+  Free the data/memory allocated by PGMRES
+*/
+PGMRES::~PGMRES() {
+  mat->decref();
+
+  if (pc) {
+    pc->decref();
+  }
+  if (work) {
+    work->decref();
+  }
+
+  for (int i = 0; i < msub + 1; i++) {
+    W[i]->decref();
+    V[i]->decref();
+  }
+  delete[] W;
+  delete[] V;
+  delete[] dotw;
+
+  if (monitor) {
+    monitor->decref();
+  }
+
+  delete[] H;
+  delete[] Hptr;
+  delete[] res;
+  delete[] Qsin;
+  delete[] Qcos;
+  delete[] gwork;
+}
+
+/*
+  Set the matrix and/or preconditioner operators. If either (or both)
+  are NULL, then the operator is not replaced.
+
+  input:
+  mat: the new matrix operator (possibly NULL)
+  pc:  the new preconditioner operator (possibly NULL)
+*/
+void PGMRES::setOperators(TACSMat *_mat, TACSPc *_pc) {
+  if (_mat) {
+    _mat->incref();
+    if (mat) {
+      mat->decref();
+    }
+    mat = _mat;
+  }
+  if (_pc) {
+    _pc->incref();
+    if (pc) {
+      pc->decref();
+    }
+    pc = _pc;
+  }
+}
+
+/*
+  Retrieve the preconditioner operators from PGMRES
+
+  output:
+  mat: the matrix
+  pc:  the preconditioner
+*/
+void PGMRES::getOperators(TACSMat **_mat, TACSPc **_pc) {
+  if (_mat) {
+    *_mat = mat;
+  }
+  if (_pc) {
+    *_pc = pc;
+  }
+}
+
+/*
+  Set the relative and absolute tolerances used for the stopping
+  criterion.
+
+  input:
+  rtol: the relative tolerance ||r_k|| < rtol*||r_0||
+  atol: the absolute tolerancne ||r_k|| < atol
+*/
+void PGMRES::setTolerances(double _rtol, double _atol) {
+  rtol = _rtol;
+  atol = _atol;
+}
+
+/*
+  Set the object to control how the convergence history is displayed
+  (if at all)
+
+  input:
+  monitor: the KSMPrint monitor object
+*/
+void PGMRES::setMonitor(KSMPrint *_monitor) {
+  _monitor->incref();
+  if (monitor) {
+    monitor->decref();
+  }
+  monitor = _monitor;
+}
+
+/*
+  Set a flag to also monitor the time spent in various operations
+  internally.
+*/
+void PGMRES::setTimeMonitor() { monitor_time = 1; }
+
+const char *PGMRES::getObjectName() { return pgmresName; }
+
+const char *PGMRES::pgmresName = "PGMRES";
+
+/*
+  Compute out = A*M^{-1}*in - the right-preconditioned operator
+*/
+void PGMRES::applyOperator(TACSVec *in, TACSVec *out) {
+  if (pc) {
+    pc->applyFactor(in, work);
+    mat->mult(work, out);
+  } else {
+    mat->mult(in, out);
+  }
+}
+
+/*
+  Try to solve the linear system using the pipelined GMRES algorithm.
+
+  Each iteration uses a single fused all-reduce that computes both the
+  classical Gram-Schmidt coefficients and the norm of the candidate
+  vector. The reduction is started with a non-blocking operation and
+  the matrix-vector product for the next iteration - applied to the
+  unnormalized candidate - is computed while the reduction is in
+  flight. Once the reduction completes, the new Arnoldi vector and its
+  image under the operator are recovered from the recurrence
+
+  W[i+1] = (V[i] - sum_k H[k,i]*W[k])/H[i+1,i]
+  V[i+1] = (A*M^{-1}*V[i] - sum_k H[k,i]*V[k])/H[i+1,i]
+
+  where V[k] = A*M^{-1}*W[k]. The norm of the new vector is computed
+  from the same reduction using the Pythagorean identity. When
+  cancellation makes that identity unreliable, the norm is recomputed
+  explicitly.
+
+  input:
+  b:          the right-hand-side
+  x:          the solution vector (with possibly significant entries)
+  zero_guess: flag to indicate whether to zero entries of x before solution
+
+  output:
+  solve_flag: flag for the whether the solve terminated successfully
+*/
+int PGMRES::solve(TACSVec *b, TACSVec *x, int zero_guess) {
+  TacsScalar rhs_norm = 0.0;
+  int solve_flag = 0;
+  int stop_flag = 0;
+  iterCount = 0;
+
+  double t_pc = 0.0, t_ortho = 0.0;
+  double t_total = 0.0;
+
+  if (monitor_time) {
+    t_total = MPI_Wtime();
+  }
+
+  // The fused Gram-Schmidt coefficients: g[k] = W[k]^{T}*V[i] for
+  // k <= i and g[i+1] = V[i]^{T}*V[i]
+  TacsScalar *g = gwork;
+
+  for (int count = 0; count < nrestart + 1; count++) {
+    // Compute the residual
+    if (zero_guess && count == 0) {
+      // If the initial guess is zero
+      x->zeroEntries();     // Set x = 0
+      W[0]->copyValues(b);  // W[0] = b
+
+      res[0] = W[0]->norm();
+      W[0]->scale(1.0 / res[0]);  // W[0] = b/|| b ||
+    } else {
+      // If the initial guess is non-zero or restarting
+      mat->mult(x, W[0]);
+      W[0]->axpy(-1.0, b);  // W[0] = A*x - b
+
+      res[0] = W[0]->norm();
+      W[0]->scale(-1.0 / res[0]);  // W[0] = (b - A*x)/|| b - A*x ||
+    }
+
+    if (monitor) {
+      monitor->printResidual(0, fabs(TacsRealPart(res[0])));
+    }
+
+    if (count == 0) {
+      rhs_norm = res[0];  // The initial residual
+      resNorm = rhs_norm;
+      if (callback &&
+          callback->iteration(this, 0, fabs(TacsRealPart(res[0])))) {
+        break;
+      }
+    }
+
+    int niters = 0;  // Keep track of the size of the Hessenberg matrix
+
+    if (TacsRealPart(res[0]) < atol) {
+      solve_flag = 1;
+      break;
+    }
+
+    // Compute the image of the first Arnoldi vector
+    if (monitor_time) {
+      t_pc -= MPI_Wtime();
+    }
+    applyOperator(W[0], V[0]);
+    if (monitor_time) {
+      t_pc += MPI_Wtime();
+    }
+
+    for (int i = 0; i < msub; i++) {
+      // Start the single fused reduction: the Gram-Schmidt
+      // coefficients against the existing basis and the square of the
+      // candidate norm
+      if (monitor_time) {
+        t_ortho -= MPI_Wtime();
+      }
+      dotw[i] = W[i];  // Restore the slot used by the previous iteration
+      dotw[i + 1] = V[i];
+      V[i]->mdot_begin(dotw, g, i + 2);
+      if (monitor_time) {
+        t_ortho += MPI_Wtime();
+      }
+
+      // While the reduction is in flight, apply the operator to the
+      // unnormalized candidate vector
+      if (monitor_time) {
+        t_pc -= MPI_Wtime();
+      }
+      applyOperator(V[i], V[i + 1]);
+      if (monitor_time) {
+        t_pc += MPI_Wtime();
+      }
+
+      if (monitor_time) {
+        t_ortho -= MPI_Wtime();
+      }
+      V[i]->mdot_end(g, i + 2);
+
+      // Orthogonalize the candidate against the basis
+      W[i + 1]->copyValues(V[i]);
+      TacsScalar gg = 0.0;
+      for (int k = 0; k < i + 1; k++) {
+        H[k + Hptr[i]] = g[k];
+        W[i + 1]->axpy(-g[k], W[k]);
+        gg += g[k] * g[k];
+      }
+
+      // Compute the norm of the new vector from the Pythagorean
+      // identity || W[i+1] ||^2 = || V[i] ||^2 - sum_k g[k]^2. If
+      // cancellation destroys the identity, fall back to an explicit
+      // norm computation.
+      TacsScalar beta2 = g[i + 1] - gg;
+      TacsScalar beta;
+      if (TacsRealPart(beta2) >= 1e-8 * TacsRealPart(g[i + 1])) {
+        beta = sqrt(beta2);
+      } else {
+        beta = W[i + 1]->norm();
+      }
+
+      H[i + 1 + Hptr[i]] = beta;    // H[i+1,i] = || W[i+1] ||
+      W[i + 1]->scale(1.0 / beta);  // W[i+1] = W[i+1]/|| W[i+1] ||
+
+      // Recover the image of the new Arnoldi vector from the
+      // speculative product computed during the reduction
+      for (int k = 0; k < i + 1; k++) {
+        V[i + 1]->axpy(-g[k], V[k]);
+      }
+      V[i + 1]->scale(1.0 / beta);
+      if (monitor_time) {
+        t_ortho += MPI_Wtime();
+      }
+
+      // Apply the existing part of Q to the new components of
+      // the Hessenberg matrix
+      TacsScalar h1, h2;
+      for (int k = 0; k < i; k++) {
+        h1 = H[k + Hptr[i]];
+        h2 = H[k + 1 + Hptr[i]];
+        H[k + Hptr[i]] = h1 * Qcos[k] + h2 * Qsin[k];
+        H[k + 1 + Hptr[i]] = -h1 * Qsin[k] + h2 * Qcos[k];
+      }
+
+      // Now, compute the rotation for the new column that was just added
+      h1 = H[i + Hptr[i]];
+      h2 = H[i + 1 + Hptr[i]];
+      TacsScalar sq = sqrt(h1 * h1 + h2 * h2);
+
+      Qcos[i] = h1 / sq;
+      Qsin[i] = h2 / sq;
+      H[i + Hptr[i]] = h1 * Qcos[i] + h2 * Qsin[i];
+      H[i + 1 + Hptr[i]] = -h1 * Qsin[i] + h2 * Qcos[i];
+
+      // Update the residual
+      h1 = res[i];
+      // h2 = res[i+1]; = 0
+      res[i] = h1 * Qcos[i];
+      res[i + 1] = -h1 * Qsin[i];
+
+      niters++;
+      resNorm = fabs(res[i + 1]);
+
+      if (monitor) {
+        monitor->printResidual(i + 1, resNorm);
+      }
+      if (callback && callback->iteration(this, iterCount + niters, resNorm)) {
+        stop_flag = 1;
+        break;
+      }
+
+      if (TacsRealPart(resNorm) < atol ||
+          TacsRealPart(resNorm) < rtol * TacsRealPart(rhs_norm)) {
+        // Set the solve flag
+        solve_flag = 1;
+
+        break;
+      }
+    }
+
+    iterCount += niters;
+
+    // Now, compute the solution - the linear combination of the
+    // Arnoldi vectors. H is upper triangular
+
+    // Compute the weights
+    for (int i = niters - 1; i >= 0; i--) {
+      for (int j = i + 1; j < niters; j++) {
+        res[i] = res[i] - H[i + Hptr[j]] * res[j];
+      }
+      res[i] = res[i] / H[i + Hptr[i]];
+    }
+
+    // Compute the linear combination
+    if (!pc) {  // If there's no pc
+      for (int i = 0; i < niters; i++) {
+        x->axpy(res[i], W[i]);
+      }
+    } else {
+      work->zeroEntries();
+      for (int i = 0; i < niters; i++) {
+        work->axpy(res[i], W[i]);
+      }
+
+      // Apply M^{-1} to the linear combination
+      pc->applyFactor(work, W[0]);
+      x->axpy(1.0, W[0]);
+    }
+
+    if (solve_flag || stop_flag) {
+      break;
+    }
+  }
+
+  if (monitor_time && monitor) {
+    t_total = MPI_Wtime() - t_total;
+    char str_mat[80], str_ort[80], str_tot[80];
+    sprintf(str_mat, "pc-mat time %10.6f\n", t_pc);
+    sprintf(str_ort, "ortho time  %10.6f\n", t_ortho);
+    sprintf(str_tot, "total time  %10.6f\n", t_total);
+    monitor->print(str_mat);
+    monitor->print(str_ort);
+    monitor->print(str_tot);
+  }
+
+  return solve_flag;
+}
+
+/*
+  Create the s-step GMRES linear system solver
+
+  The restart size is msub = s*nblocks: each restart performs nblocks
+  blocks of s iterations, with one fused reduction per block.
+
+  input:
+  mat:      the matrix operator
+  pc:       the preconditioner (may be NULL); must not be flexible
+  s:        the number of Krylov vectors generated per reduction
+  nblocks:  the number of s-step blocks per restart
+  nrestart: the number of restarts before we give up
+*/
+SSGMRES::SSGMRES(TACSMat *_mat, TACSPc *_pc, int _s, int _nblocks,
+                 int _nrestart) {
+  monitor = NULL;
+
+  mat = _mat;
+  pc = _pc;
+  mat->incref();
+  if (pc) {
+    pc->incref();
+  }
+
+  sstep = (_s >= 1 ? _s : 1);
+  nblocks = (_nblocks >= 1 ? _nblocks : 1);
+  msub = sstep * nblocks;
+  nrestart = (_nrestart >= 0 ? _nrestart : 0);
+
+  // Set default absolute and relative tolerances
+  rtol = 1e-8;
+  atol = 1e-30;
+
+  // Allocate the basis of the Krylov subspace
+  V = new TACSVec *[msub + 1];
+  for (int i = 0; i < msub + 1; i++) {
+    V[i] = mat->createVec();
+    V[i]->incref();
+  }
+
+  work = NULL;
+  if (pc) {
+    work = mat->createVec();
+    work->incref();
+  }
+
+  // The block-Hessenberg matrix is stored densely by columns with a
+  // leading dimension of msub+1, since the s-step recovery fills the
+  // columns block-by-block
+  H = new TacsScalar[(msub + 1) * msub];
+  memset(H, 0, (msub + 1) * msub * sizeof(TacsScalar));
+
+  // Work space for the fused block reduction and the basis
+  // coefficients of the raw block
+  gram = new TacsScalar[(msub + 1) * sstep];
+  wc = new TacsScalar[(msub + 1) * sstep];
+
+  // The Givens rotations for the QR factorization of H
+  Qsin = new TacsScalar[msub];
+  Qcos = new TacsScalar[msub];
+  res = new TacsScalar[msub + 1];
+
+  memset(Qsin, 0, msub * sizeof(TacsScalar));
+  memset(Qcos, 0, msub * sizeof(TacsScalar));
+  memset(res, 0, (msub + 1) * sizeof(TacsScalar));
+}
+
+/*
+  Free the data/memory allocated by s-step GMRES
+*/
+SSGMRES::~SSGMRES() {
+  mat->decref();
+  if (pc) {
+    pc->decref();
+  }
+  if (work) {
+    work->decref();
+  }
+  for (int i = 0; i < msub + 1; i++) {
+    V[i]->decref();
+  }
+  delete[] V;
+
+  if (monitor) {
+    monitor->decref();
+  }
+
+  delete[] H;
+  delete[] gram;
+  delete[] wc;
+  delete[] Qsin;
+  delete[] Qcos;
+  delete[] res;
+}
+
+/*
+  Set the matrix and/or preconditioner operators. If either (or both)
+  are NULL, then the operator is not replaced.
+*/
+void SSGMRES::setOperators(TACSMat *_mat, TACSPc *_pc) {
+  if (_mat) {
+    _mat->incref();
+    if (mat) {
+      mat->decref();
+    }
+    mat = _mat;
+  }
+  if (_pc) {
+    _pc->incref();
+    if (pc) {
+      pc->decref();
+    }
+    pc = _pc;
+  }
+}
+
+void SSGMRES::getOperators(TACSMat **_mat, TACSPc **_pc) {
+  if (_mat) {
+    *_mat = mat;
+  }
+  if (_pc) {
+    *_pc = pc;
+  }
+}
+
+void SSGMRES::setTolerances(double _rtol, double _atol) {
+  rtol = _rtol;
+  atol = _atol;
+}
+
+void SSGMRES::setMonitor(KSMPrint *_monitor) {
+  _monitor->incref();
+  if (monitor) {
+    monitor->decref();
+  }
+  monitor = _monitor;
+}
+
+const char *SSGMRES::getObjectName() { return ssgmresName; }
+
+const char *SSGMRES::ssgmresName = "SSGMRES";
+
+/*
+  Compute the cross products of the candidate block against the
+  existing basis and against itself with a single reduction.
+
+  On output gram contains, in column-major order with a leading
+  dimension of ldg = nv + nw, the products
+
+  gram[p + ldg*k] = V[p]^{T} * V[nv + k]
+
+  for p = 0 ... nv+nw-1 and k = 0 ... nw-1. The local contributions
+  are computed directly from the vector storage and summed with one
+  MPI_Allreduce. If the vectors do not expose their array storage, the
+  entries are computed with blocking dot products instead.
+
+  input:
+  nv: the number of orthonormal basis vectors
+  nw: the number of vectors in the candidate block
+
+  output:
+  gram: the cross products
+*/
+void SSGMRES::computeBlockGram(int nv, int nw, TacsScalar *gram) {
+  int ldg = nv + nw;
+
+  // Check that all the vectors expose their array storage
+  int use_arrays = 1;
+  for (int p = 0; p < ldg; p++) {
+    if (!dynamic_cast<TACSBVec *>(V[p])) {
+      use_arrays = 0;
+      break;
+    }
+  }
+
+  if (use_arrays) {
+    // Compute the local products and perform a single reduction
+    for (int k = 0; k < nw; k++) {
+      TacsScalar *w;
+      int size = dynamic_cast<TACSBVec *>(V[nv + k])->getArray(&w);
+
+      for (int p = 0; p < ldg; p++) {
+        TacsScalar *v;
+        dynamic_cast<TACSBVec *>(V[p])->getArray(&v);
+
+        TacsScalar sum = 0.0;
+        for (int i = 0; i < size; i++) {
+          sum += v[i] * w[i];
+        }
+        gram[p + ldg * k] = sum;
+      }
+    }
+
+    MPI_Comm comm = dynamic_cast<TACSBVec *>(V[0])->getMPIComm();
+    double twait = MPI_Wtime();
+    MPI_Allreduce(MPI_IN_PLACE, gram, ldg * nw, TACS_MPI_TYPE, MPI_SUM, comm);
+    TacsProfileAddWait("KSM.gram", MPI_Wtime() - twait);
+  } else {
+    // Fall back to blocking dot products
+    for (int k = 0; k < nw; k++) {
+      for (int p = 0; p < ldg; p++) {
+        gram[p + ldg * k] = V[p]->dot(V[nv + k]);
+      }
+    }
+  }
+}
+
+/*
+  Try to solve the linear system using s-step GMRES.
+
+  Each block of s iterations proceeds as follows: the s raw Krylov
+  vectors are generated back-to-back with the preconditioned
+  matrix-vector product, the cross products against the basis and
+  within the block are computed with a single reduction, the block is
+  projected with block classical Gram-Schmidt and orthonormalized with
+  a local Cholesky QR, and the new block-Hessenberg columns are
+  recovered from the change-of-basis coefficients. The Givens QR of
+  the Hessenberg matrix and the convergence test then proceed exactly
+  as in standard GMRES.
+
+  If the Cholesky factorization of the projected block Gram matrix
+  breaks down, the monomial basis has lost independence: the block is
+  truncated at the last independent vector and the method restarts
+  from the current iterate, which also replaces the recurrence
+  residual with the true residual.
 
   input:
-  mat:      the matrix operator
-  m:        the size of the Krylov subspace
-  nrestart: try this many times before giving up
+  b:          the right-hand-side
+  x:          the solution vector (with possibly significant entries)
+  zero_guess: flag to indicate whether to zero entries of x before solution
+
+  output:
+  solve_flag: flag for the whether the solve terminated successfully
 */
-GMRES::GMRES(TACSMat *_mat, int _m, int _nrestart) {
-  init(_mat, NULL, _m, _nrestart, 0);
+int SSGMRES::solve(TACSVec *b, TACSVec *x, int zero_guess) {
+  TacsProfileScope profile("SSGMRES::solve");
+  TacsScalar rhs_norm = 0.0;
+  int solve_flag = 0;
+  int stop_flag = 0;
+  iterCount = 0;
+  const int ldh = msub + 1;
+
+  for (int count = 0; count < nrestart + 1; count++) {
+    // Compute the residual and the first basis vector
+    if (zero_guess && count == 0) {
+      // If the initial guess is zero
+      x->zeroEntries();    // Set x = 0
+      V[0]->copyValues(b); // V[0] = b
+
+      res[0] = V[0]->norm();
+      V[0]->scale(1.0 / res[0]); // V[0] = b/|| b ||
+    } else {
+      // If the initial guess is non-zero or restarting
+      mat->mult(x, V[0]);
+      V[0]->axpy(-1.0, b); // V[0] = A*x - b
+
+      res[0] = V[0]->norm();
+      V[0]->scale(-1.0 / res[0]); // V[0] = (b - A*x)/|| b - A*x ||
+    }
+    memset(&res[1], 0, msub * sizeof(TacsScalar));
+    memset(H, 0, (msub + 1) * msub * sizeof(TacsScalar));
+
+    if (monitor) {
+      monitor->printResidual(0, fabs(TacsRealPart(res[0])));
+    }
+
+    if (count == 0) {
+      rhs_norm = res[0]; // The initial residual
+      resNorm = rhs_norm;
+      if (callback &&
+          callback->iteration(this, 0, fabs(TacsRealPart(res[0])))) {
+        break;
+      }
+    }
+
+    int niters = 0; // The number of Hessenberg columns
+    int terminate = 0;
+
+    if (TacsRealPart(res[0]) < atol) {
+      solve_flag = 1;
+      break;
+    }
+
+    for (int blk = 0; blk < nblocks && !terminate; blk++) {
+      // The number of orthonormal basis vectors computed so far
+      int nv = blk * sstep + 1;
+      int ldg = nv + sstep;
+
+      // Generate the raw block with repeated preconditioned products
+      for (int k = 0; k < sstep; k++) {
+        TACSVec *src = V[nv + k - 1];
+        if (pc) {
+          pc->applyFactor(src, work); // work = M^{-1}*src
+          mat->mult(work, V[nv + k]); // V[nv+k] = A*M^{-1}*src
+        } else {
+          mat->mult(src, V[nv + k]); // V[nv+k] = A*src
+        }
+      }
+
+      // Compute all the cross products with a single reduction
+      computeBlockGram(nv, sstep, gram);
+
+      // Project the raw block against the existing basis with block
+      // classical Gram-Schmidt
+      for (int k = 0; k < sstep; k++) {
+        for (int p = 0; p < nv; p++) {
+          V[nv + k]->axpy(-gram[p + ldg * k], V[p]);
+        }
+      }
+
+      // Form the projected block Gram matrix in place:
+      // S = W^{T}*W - C^{T}*C overwrites the block rows of gram
+      for (int bcol = 0; bcol < sstep; bcol++) {
+        for (int a = 0; a <= bcol; a++) {
+          TacsScalar sum = 0.0;
+          for (int p = 0; p < nv; p++) {
+            sum += gram[p + ldg * a] * gram[p + ldg * bcol];
+          }
+          gram[nv + a + ldg * bcol] -= sum;
+        }
+      }
+
+      // Factor S = R^{T}*R with an upper Cholesky factorization,
+      // overwriting the upper triangle of the block rows. A
+      // non-positive pivot indicates that the monomial basis has lost
+      // independence, and the block is truncated there.
+      int sgood = sstep;
+      for (int k = 0; k < sstep; k++) {
+        TacsScalar d = gram[nv + k + ldg * k];
+        for (int a = 0; a < k; a++) {
+          d -= gram[nv + a + ldg * k] * gram[nv + a + ldg * k];
+        }
+        if (TacsRealPart(d) <= 0.0) {
+          sgood = k;
+          break;
+        }
+        TacsScalar rkk = sqrt(d);
+        gram[nv + k + ldg * k] = rkk;
+
+        for (int bcol = k + 1; bcol < sstep; bcol++) {
+          TacsScalar v = gram[nv + k + ldg * bcol];
+          for (int a = 0; a < k; a++) {
+            v -= gram[nv + a + ldg * k] * gram[nv + a + ldg * bcol];
+          }
+          gram[nv + k + ldg * bcol] = v / rkk;
+        }
+      }
+
+      if (sgood == 0) {
+        if (niters == 0) {
+          // The monomial basis degenerated on the very first vector -
+          // this happens whenever the preconditioned operator is close
+          // to the identity, where the sign of the first Cholesky
+          // pivot is decided by rounding. Fall back to a single
+          // standard Arnoldi step so that the restart still makes
+          // progress instead of returning the unmodified iterate.
+          TACSVec *w = V[1];
+          if (pc) {
+            pc->applyFactor(V[0], work); // work = M^{-1}*V[0]
+            mat->mult(work, w);          // w = A*M^{-1}*V[0]
+          } else {
+            mat->mult(V[0], w); // w = A*V[0]
+          }
+
+          // Orthogonalize against the first basis vector with
+          // modified Gram-Schmidt and normalize
+          TacsScalar h0 = V[0]->dot(w);
+          w->axpy(-h0, V[0]);
+          TacsScalar h1 = w->norm();
+
+          TacsScalar sq = sqrt(h0 * h0 + h1 * h1);
+          if (TacsRealPart(sq) > 0.0) {
+            if (TacsRealPart(h1) > 0.0) {
+              w->scale(1.0 / h1);
+            }
+
+            // Apply the Givens rotation and convergence test for the
+            // single new column, as in the s-step path
+            Qcos[0] = h0 / sq;
+            Qsin[0] = h1 / sq;
+            H[0] = h0 * Qcos[0] + h1 * Qsin[0];
+            H[1] = -h0 * Qsin[0] + h1 * Qcos[0];
+            res[1] = -res[0] * Qsin[0];
+            res[0] = res[0] * Qcos[0];
+
+            niters = 1;
+            resNorm = fabs(res[1]);
+
+            if (monitor) {
+              monitor->printResidual(1, resNorm);
+            }
+            if (callback &&
+                callback->iteration(this, iterCount + 1, resNorm)) {
+              stop_flag = 1;
+            }
+
+            if (TacsRealPart(resNorm) < atol ||
+                TacsRealPart(resNorm) < rtol * TacsRealPart(rhs_norm)) {
+              solve_flag = 1;
+            }
+          }
+        }
+
+        // The s-step basis cannot be extended - restart from the
+        // current iterate with the true residual
+        break;
+      }
+
+      // Orthonormalize the projected block in place:
+      // V[nv+k] = (V[nv+k] - sum_{a<k} R[a][k]*V[nv+a])/R[k][k]
+      for (int k = 0; k < sgood; k++) {
+        for (int a = 0; a < k; a++) {
+          V[nv + k]->axpy(-gram[nv + a + ldg * k], V[nv + a]);
+        }
+        V[nv + k]->scale(1.0 / gram[nv + k + ldg * k]);
+      }
+
+      // Record the coefficients of the raw block vectors in the
+      // orthonormal basis: wc_k = [C(:,k); R(0:k,k)]
+      for (int k = 0; k < sgood; k++) {
+        for (int p = 0; p < nv; p++) {
+          wc[p + ldh * k] = gram[p + ldg * k];
+        }
+        for (int a = 0; a <= k; a++) {
+          wc[nv + a + ldh * k] = gram[nv + a + ldg * k];
+        }
+      }
+
+      // Recover the new columns of the block-Hessenberg matrix. The
+      // raw vectors satisfy A*M^{-1}*z_k = w_k where z_0 is the last
+      // basis vector of the previous block and z_k = w_{k-1}
+      // otherwise, so each new column follows from the known columns
+      // and the change-of-basis coefficients.
+      for (int k = 0; k < sgood; k++) {
+        int t = nv - 1 + k; // The new column of H
+        TacsScalar *Hcol = &H[ldh * t];
+
+        if (k == 0) {
+          // z_0 = e_t, so the column is the coefficient vector itself
+          for (int r = 0; r < nv + 1; r++) {
+            Hcol[r] = wc[r];
+          }
+        } else {
+          // z_k = w_{k-1}: subtract the known columns and divide by
+          // the top coefficient R[k-1][k-1]
+          for (int r = 0; r < nv + k + 1; r++) {
+            Hcol[r] = wc[r + ldh * k];
+          }
+          for (int c = 0; c < t; c++) {
+            TacsScalar z = wc[c + ldh * (k - 1)];
+            for (int r = 0; r < c + 2; r++) {
+              Hcol[r] = Hcol[r] - z * H[r + ldh * c];
+            }
+          }
+          TacsScalar ztop = wc[t + ldh * (k - 1)];
+          for (int r = 0; r < nv + k + 1; r++) {
+            Hcol[r] = Hcol[r] / ztop;
+          }
+        }
+      }
+
+      // Apply the Givens QR update and convergence test to each new
+      // column, exactly as in standard GMRES
+      for (int k = 0; k < sgood; k++) {
+        int t = nv - 1 + k;
+        TacsScalar *Hcol = &H[ldh * t];
+
+        // Apply the existing rotations to the new column
+        TacsScalar h1, h2;
+        for (int q = 0; q < t; q++) {
+          h1 = Hcol[q];
+          h2 = Hcol[q + 1];
+          Hcol[q] = h1 * Qcos[q] + h2 * Qsin[q];
+          Hcol[q + 1] = -h1 * Qsin[q] + h2 * Qcos[q];
+        }
+
+        // Compute the rotation for the new column
+        h1 = Hcol[t];
+        h2 = Hcol[t + 1];
+        TacsScalar sq = sqrt(h1 * h1 + h2 * h2);
+
+        Qcos[t] = h1 / sq;
+        Qsin[t] = h2 / sq;
+        Hcol[t] = h1 * Qcos[t] + h2 * Qsin[t];
+        Hcol[t + 1] = -h1 * Qsin[t] + h2 * Qcos[t];
+
+        // Update the residual
+        h1 = res[t];
+        res[t] = h1 * Qcos[t];
+        res[t + 1] = -h1 * Qsin[t];
+
+        niters++;
+        resNorm = fabs(res[t + 1]);
+
+        if (monitor) {
+          monitor->printResidual(t + 1, resNorm);
+        }
+        if (callback &&
+            callback->iteration(this, iterCount + niters, resNorm)) {
+          stop_flag = 1;
+          terminate = 1;
+          break;
+        }
+
+        if (TacsRealPart(resNorm) < atol ||
+            TacsRealPart(resNorm) < rtol * TacsRealPart(rhs_norm)) {
+          solve_flag = 1;
+          terminate = 1;
+          break;
+        }
+      }
+
+      if (sgood < sstep) {
+        // The truncated block cannot be extended - restart
+        break;
+      }
+    }
+
+    iterCount += niters;
+
+    // Compute the weights from the upper triangular system
+    for (int i = niters - 1; i >= 0; i--) {
+      for (int j = i + 1; j < niters; j++) {
+        res[i] = res[i] - H[i + ldh * j] * res[j];
+      }
+      res[i] = res[i] / H[i + ldh * i];
+    }
+
+    // Compute the linear combination
+    if (!pc) {
+      for (int i = 0; i < niters; i++) {
+        x->axpy(res[i], V[i]);
+      }
+    } else {
+      work->zeroEntries();
+      for (int i = 0; i < niters; i++) {
+        work->axpy(res[i], V[i]);
+      }
+
+      // Apply M^{-1} to the linear combination
+      pc->applyFactor(work, V[0]);
+      x->axpy(1.0, V[0]);
+    }
+
+    if (solve_flag || stop_flag) {
+      break;
+    }
+    if (niters == 0) {
+      // No progress was made during this restart - give up rather
+      // than looping on a broken-down basis
+      break;
+    }
+  }
+
+  TacsProfileAddCount("SSGMRES iterations", iterCount);
+
+  return solve_flag;
 }
 
 /*
-  Initialize the underlying GMRES data structure.
+  Create the GCROT linear system solver
 
-  This is called by both of the two constructors above.
+  This constructor creates an object that uses a simplified variant of
+  GCROT described by Hicken and Zingg.
+
+  input:
+  mat:        the matrix operator
+  pc:         the preconditioner
+  outer:      the number of outer vectors
+  max_outer:  the maximum number of outer iterations before we give up
+  msub:       the size of the underlying GMRES (FGMRES) subspace
+  isFlexible: flag to indicate required use of flexible GCROT
 */
-void GMRES::init(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart,
-                 int _isFlexible) {
-  orthogonalize = ModifiedGramSchmidt;
+GCROT::GCROT(TACSMat *_mat, TACSPc *_pc, int _outer, int _max_outer, int _msub,
+             int _isFlexible) {
+  init(_mat, _pc, _outer, _max_outer, _msub, _isFlexible);
+}
+
+/*
+  Create the GCROT linear system solver without a preconditioner. Note
+  that this variant is never flexible.
+*/
+GCROT::GCROT(TACSMat *_mat, int _outer, int _max_outer, int _msub) {
+  init(_mat, NULL, _outer, _max_outer, _msub, 0);
+}
+
+/*
+  Initialize the GCROT data.
+
+  This allocates all the vectors required for the underlying subspace.
+  After initialization, no new significant memory allocation is
+  required.
+*/
+void GCROT::init(TACSMat *_mat, TACSPc *_pc, int _outer, int _max_outer,
+                 int _msub, int _isFlexible) {
   monitor = NULL;
-  monitor_time = 0;
-  msub = _m;
-  nrestart = (_nrestart >= 0 ? _nrestart : 0);
-  isFlexible = _isFlexible;
+  msub = _msub;              // Size of the F/GMRES subspace
+  outer = _outer;            // Number of outer iterations
+  max_outer = _max_outer;    // Maximum number of outer iterations
+  isFlexible = _isFlexible;  // Flexible variant?
 
   mat = _mat;
   pc = _pc;
@@ -592,8 +3178,7 @@ void GMRES::init(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart,
   atol = 1e-30;
 
   // Allocate the subspace of vectors
-  work = NULL;  // Required only for regular GMRES
-  Z = NULL;     // Required only for flexible GMRES
+  Z = NULL;  // Required only for flexible GMRES
   W = new TACSVec *[msub + 1];
 
   for (int i = 0; i < msub + 1; i++) {
@@ -603,14 +3188,29 @@ void GMRES::init(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart,
 
   if (isFlexible) {
     Z = new TACSVec *[msub];
+
     for (int i = 0; i < msub; i++) {
       Z[i] = mat->createVec();
       Z[i]->incref();
     }
-  } else if (pc) {
-    // Allocate the work array
-    work = mat->createVec();
-    work->incref();
+  }
+
+  R = mat->createVec();
+  c_hat = mat->createVec();
+  u_hat = mat->createVec();
+
+  R->incref();
+  c_hat->incref();
+  u_hat->incref();
+
+  U = new TACSVec *[outer];
+  C = new TACSVec *[outer];
+
+  for (int i = 0; i < outer; i++) {
+    U[i] = mat->createVec();
+    U[i]->incref();
+    C[i] = mat->createVec();
+    C[i]->incref();
   }
 
   // Allocate space for the Hessenberg matrix
@@ -626,9 +3226,11 @@ void GMRES::init(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart,
   int size = Hptr[msub];
   H = new TacsScalar[size];        // The Hessenberg matrix
   res = new TacsScalar[msub + 1];  // The residual
+  B = new TacsScalar[msub * outer];
 
   memset(H, 0, size * sizeof(TacsScalar));
   memset(res, 0, (msub + 1) * sizeof(TacsScalar));
+  memset(B, 0, msub * outer * sizeof(TacsScalar));
 
   // Allocate the terms that represent the unitary Q matrix
   // in the QR factorixation of H
@@ -640,18 +3242,31 @@ void GMRES::init(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart,
 }
 
 /*
-  Free the data/memory allocated by GMRES
+  Delete the object and free all the data
 */
-GMRES::~GMRES() {
+GCROT::~GCROT() {
   mat->decref();
 
   if (pc) {
     pc->decref();
   }
-  if (work) {
-    work->decref();
+
+  R->decref();
+  u_hat->decref();
+  c_hat->decref();
+
+  for (int i = 0; i < outer; i++) {
+    if (U[i]) {
+      U[i]->decref();
+    }
+    if (C[i]) {
+      C[i]->decref();
+    }
   }
 
+  delete[] U;
+  delete[] C;
+
   if (Z) {
     for (int i = 0; i < msub; i++) {
       Z[i]->decref();
@@ -671,19 +3286,15 @@ GMRES::~GMRES() {
   delete[] H;
   delete[] Hptr;
   delete[] res;
+  delete[] B;
   delete[] Qsin;
   delete[] Qcos;
 }
 
 /*
-  Set the matrix and/or preconditioner operators. If either (or both)
-  are NULL, then the operator is not replaced.
-
-  input:
-  mat: the new matrix operator (possibly NULL)
-  pc:  the new preconditioner operator (possibly NULL)
+  Set the matrix/preconditioner operators used for GCROT
 */
-void GMRES::setOperators(TACSMat *_mat, TACSPc *_pc) {
+void GCROT::setOperators(TACSMat *_mat, TACSPc *_pc) {
   if (_mat) {
     _mat->incref();
     if (mat) {
@@ -701,13 +3312,9 @@ void GMRES::setOperators(TACSMat *_mat, TACSPc *_pc) {
 }
 
 /*
-  Retrieve the preconditioner operators from GMRES
-
-  output:
-  mat: the matrix
-  pc:  the preconditioner
+  Retrieve the matrix/preconditioner operators set in the GCROT object
 */
-void GMRES::getOperators(TACSMat **_mat, TACSPc **_pc) {
+void GCROT::getOperators(TACSMat **_mat, TACSPc **_pc) {
   if (_mat) {
     *_mat = mat;
   }
@@ -716,27 +3323,18 @@ void GMRES::getOperators(TACSMat **_mat, TACSPc **_pc) {
   }
 }
 
-/*
-  Set the relative and absolute tolerances used for the stopping
-  criterion.
-
-  input:
-  rtol: the relative tolerance ||r_k|| < rtol*||r_0||
-  atol: the absolute tolerancne ||r_k|| < atol
+/*
+  Set the relative and absolute convergence tolerances for GCROT
 */
-void GMRES::setTolerances(double _rtol, double _atol) {
+void GCROT::setTolerances(double _rtol, double _atol) {
   rtol = _rtol;
   atol = _atol;
 }
 
 /*
-  Set the object to control how the convergence history is displayed
-  (if at all)
-
-  input:
-  monitor: the KSMPrint monitor object
+  Set the residual/solution monitor object
 */
-void GMRES::setMonitor(KSMPrint *_monitor) {
+void GCROT::setMonitor(KSMPrint *_monitor) {
   _monitor->incref();
   if (monitor) {
     monitor->decref();
@@ -744,117 +3342,97 @@ void GMRES::setMonitor(KSMPrint *_monitor) {
   monitor = _monitor;
 }
 
-/*
-  Set the type of orthogonalization to use. This will be either
-  classical Gram-Schmidt or modified Gram-Schmidt (default).
-
-  Unless you have a good reason, you should use modified Gram-Schmidt.
-*/
-void GMRES::setOrthoType(enum OrthoType otype) {
-  if (otype == CLASSICAL_GRAM_SCHMIDT) {
-    orthogonalize = ClassicalGramSchmidt;
-  } else {
-    orthogonalize = ModifiedGramSchmidt;
-  }
-}
-
-/*
-  Set a flag to also monitor the time spent in various operations
-  internally.
-*/
-void GMRES::setTimeMonitor() { monitor_time = 1; }
-
-const char *GMRES::getObjectName() { return gmresName; }
+const char *GCROT::getObjectName() { return gcrotName; }
 
-const char *GMRES::gmresName = "GMRES";
+const char *GCROT::gcrotName = "GCROT";
 
 /*
-  Try to solve the linear system using GMRES.
-
-  The following code tries to solve the linear system using GMRES (or
-  FGMRES if the preconditioner is flexible.)
+  Solve the linear system defined by the matrix operator with the
+  given (possibly flexible) preconditioner
 
   input:
-  b:          the right-hand-side
-  x:          the solution vector (with possibly significant entries)
-  zero_guess: flag to indicate whether to zero entries of x before solution
+  b:          the input right-hand-side
+  x:          the solution vector
+  zero_guess: flag to treat x as an initial guess or zero
 
   output:
   solve_flag: flag for the whether the solve terminated successfully
 */
-int GMRES::solve(TACSVec *b, TACSVec *x, int zero_guess) {
+int GCROT::solve(TACSVec *b, TACSVec *x, int zero_guess) {
   TacsScalar rhs_norm = 0.0;
   int solve_flag = 0;
+  int stop_flag = 0;
+  int mat_iters = 0;
   iterCount = 0;
 
-  double t_pc = 0.0, t_ortho = 0.0;
-  double t_total = 0.0;
-
-  if (monitor_time) {
-    t_total = MPI_Wtime();
+  // Compute the residual
+  if (zero_guess) {
+    // If the initial guess is zero
+    x->zeroEntries();  // Set x = 0
+    R->copyValues(b);  // R = b
+  } else {
+    // If the initial guess is non-zero or restarting
+    mat->mult(x, R);  // R = A*x
+    mat_iters++;
+    R->axpy(-1.0, b);  // R = A*x - b
+    R->scale(-1.0);    // R = b - A*x0
   }
 
-  for (int count = 0; count < nrestart + 1; count++) {
-    // Compute the residual
-    if (zero_guess && count == 0) {
-      // If the initial guess is zero
-      x->zeroEntries();     // Set x = 0
-      W[0]->copyValues(b);  // W[0] = b
-
-      res[0] = W[0]->norm();
-      W[0]->scale(1.0 / res[0]);  // W[0] = b/|| b ||
-    } else {
-      // If the initial guess is non-zero or restarting
-      mat->mult(x, W[0]);
-      W[0]->axpy(-1.0, b);  // W[0] = A*x - b
+  rhs_norm = R->norm();  // The initial residual
+  resNorm = rhs_norm;
 
-      res[0] = W[0]->norm();
-      W[0]->scale(-1.0 / res[0]);  // W[0] = (b - A*x)/|| b - A*x ||
-    }
+  if (callback && callback->iteration(this, 0, rhs_norm)) {
+    return solve_flag;
+  }
 
-    if (monitor) {
-      monitor->printResidual(0, fabs(TacsRealPart(res[0])));
-    }
+  if (TacsRealPart(rhs_norm) < atol) {
+    solve_flag = 1;
+    return solve_flag;
+  }
 
-    if (count == 0) {
-      rhs_norm = res[0];  // The initial residual
-      resNorm = rhs_norm;
-    }
+  for (int count = 0; count < max_outer; count++) {
+    // Size of the U/C subspaces
+    int outer_size = (count < outer ? count : outer);  // min(count, outer);
+    int niters = 0;  // The size of the Hessenberg matrix
 
-    int niters = 0;  // Keep track of the size of the Hessenberg matrix
+    W[0]->copyValues(R);  // W[0] = R
+    res[0] = W[0]->norm();
+    W[0]->scale(1.0 / res[0]);  // W[0] = b/|| b ||
 
-    if (TacsRealPart(res[0]) < atol) {
-      solve_flag = 1;
-      break;
+    if (monitor) {
+      monitor->printResidual(mat_iters, resNorm);
     }
 
+    // The inner F/GMRES loop
     for (int i = 0; i < msub; i++) {
-      if (monitor_time) {
-        t_pc -= MPI_Wtime();
-      }
       if (isFlexible) {
         // Apply the preconditioner, Z[i] = M^{-1} W[i]
         pc->applyFactor(W[i], Z[i]);
         mat->mult(Z[i], W[i + 1]);  // W[i+1] = A*Z[i] = A*M^{-1}*W[i]
       } else {
         if (pc) {
+          // Use u_hat here as a temporary array
           // Apply the preconditioner, work = M^{-1} W[i]
-          pc->applyFactor(W[i], work);
-          mat->mult(work, W[i + 1]);  // W[i+1] = A*work = A*M^{-1}*W[i]
+          pc->applyFactor(W[i], u_hat);
+          mat->mult(u_hat, W[i + 1]);  // W[i+1] = A*work = A*M^{-1}*W[i]
         } else {
           mat->mult(W[i], W[i + 1]);  // Compute W[i+1] = A*W[i]
         }
       }
-      if (monitor_time) {
-        double t0 = MPI_Wtime();
-        t_pc += t0;
-        t_ortho -= t0;
+      mat_iters++;
+
+      // First, orthonormalize W[i+1] w.r.t.
+      // the basis C[j] j = 0 .. outer_size-1 B is (outer_size, msub)
+      for (int j = 0; j < outer_size; j++) {
+        B[j * msub + i] = W[i + 1]->dot(C[j]);  // B[j,i] = dot( W[i+1], C[j] )
+        W[i + 1]->axpy(-B[j * msub + i],
+                       C[j]);  // W[i+1] = W[i+1] - B[j,i]*C[j]
       }
 
-      // Build the orthogonal basis using MGS
-      orthogonalize(&H[Hptr[i]], W[i + 1], W, i + 1);
-      if (monitor_time) {
-        t_ortho += MPI_Wtime();
+      // Build expand the orthogonal basis using MGS
+      for (int j = i; j >= 0; j--) {
+        H[j + Hptr[i]] = W[i + 1]->dot(W[j]);   // H[j,i] = dot( W[i+1], W[i] )
+        W[i + 1]->axpy(-H[j + Hptr[i]], W[j]);  // W[i+1] = W[i+1] - H[j,i]*W[j]
       }
 
       H[i + 1 + Hptr[i]] = W[i + 1]->norm();  // H[i+1,i] = || W[i+1] ||
@@ -888,12 +3466,17 @@ int GMRES::solve(TACSVec *b, TACSVec *x, int zero_guess) {
       res[i + 1] = -h1 * Qsin[i];
 
       niters++;
+
       resNorm = fabs(res[i + 1]);
 
       if (monitor) {
-        monitor->printResidual(i + 1, resNorm);
+        monitor->printResidual(mat_iters, resNorm);
+      }
+      if (callback &&
+          callback->iteration(this, iterCount + niters, resNorm)) {
+        stop_flag = 1;
+        break;
       }
-
       if (TacsRealPart(resNorm) < atol ||
           TacsRealPart(resNorm) < rtol * TacsRealPart(rhs_norm)) {
         // Set the solve flag
@@ -902,288 +3485,193 @@ int GMRES::solve(TACSVec *b, TACSVec *x, int zero_guess) {
         break;
       }
     }
-
     iterCount += niters;
 
     // Now, compute the solution - the linear combination of the
-    // Arnoldi vectors. H is upper triangular
+    // Arnoldi vectors
+    // H is now upper triangular
 
     // Compute the weights
     for (int i = niters - 1; i >= 0; i--) {
-      for (int j = i + 1; j < niters; j++) {  //
+      // Compute res[i] = res[i] - H[i,j]*res[j];
+      for (int j = i + 1; j < niters; j++) {
         res[i] = res[i] - H[i + Hptr[j]] * res[j];
       }
       res[i] = res[i] / H[i + Hptr[i]];
     }
 
+    // u_hat = Z*y - U*B*y
+    // where y = the weights computed from the inner GMRES loop above
+
     // Compute the linear combination
     if (isFlexible) {  // Flexible variant
-      for (int i = 0; i < niters; i++) {
-        x->axpy(res[i], Z[i]);
-      }
-    } else if (!pc) {  // If there's no pc
-      for (int i = 0; i < niters; i++) {
-        x->axpy(res[i], W[i]);
-      }
-    } else {  // If the pc isn't flexible
-      work->zeroEntries();
-      for (int i = 0; i < niters; i++) {
-        work->axpy(res[i], W[i]);
-      }
-
-      // Apply M^{-1} to the linear combination
-      pc->applyFactor(work, W[0]);
-      x->axpy(1.0, W[0]);
-    }
-
-    if (solve_flag) {
-      break;
-    }
-  }
-
-  if (monitor_time && monitor) {
-    t_total = MPI_Wtime() - t_total;
-    char str_mat[80], str_ort[80], str_tot[80];
-    sprintf(str_mat, "pc-mat time %10.6f\n", t_pc);
-    sprintf(str_ort, "ortho time  %10.6f\n", t_ortho);
-    sprintf(str_tot, "total time  %10.6f\n", t_total);
-    monitor->print(str_mat);
-    monitor->print(str_ort);
-    monitor->print(str_tot);
-  }
-
-  return solve_flag;
-}
-
-/*
-  Create the GCROT linear system solver
-
-  This constructor creates an object that uses a simplified variant of
-  GCROT described by Hicken and Zingg.
-
-  input:
-  mat:        the matrix operator
-  pc:         the preconditioner
-  outer:      the number of outer vectors
-  max_outer:  the maximum number of outer iterations before we give up
-  msub:       the size of the underlying GMRES (FGMRES) subspace
-  isFlexible: flag to indicate required use of flexible GCROT
-*/
-GCROT::GCROT(TACSMat *_mat, TACSPc *_pc, int _outer, int _max_outer, int _msub,
-             int _isFlexible) {
-  init(_mat, _pc, _outer, _max_outer, _msub, _isFlexible);
-}
-
-/*
-  Create the GCROT linear system solver without a preconditioner. Note
-  that this variant is never flexible.
-*/
-GCROT::GCROT(TACSMat *_mat, int _outer, int _max_outer, int _msub) {
-  init(_mat, NULL, _outer, _max_outer, _msub, 0);
-}
-
-/*
-  Initialize the GCROT data.
-
-  This allocates all the vectors required for the underlying subspace.
-  After initialization, no new significant memory allocation is
-  required.
-*/
-void GCROT::init(TACSMat *_mat, TACSPc *_pc, int _outer, int _max_outer,
-                 int _msub, int _isFlexible) {
-  monitor = NULL;
-  msub = _msub;              // Size of the F/GMRES subspace
-  outer = _outer;            // Number of outer iterations
-  max_outer = _max_outer;    // Maximum number of outer iterations
-  isFlexible = _isFlexible;  // Flexible variant?
-
-  mat = _mat;
-  pc = _pc;
-  mat->incref();
-
-  if (pc) {
-    pc->incref();
-  } else {
-    // If there's no Pc then it doesn't have to be a flexible variant
-    isFlexible = 0;
-  }
-
-  // Set default absolute and relative tolerances
-  rtol = 1e-8;
-  atol = 1e-30;
-
-  // Allocate the subspace of vectors
-  Z = NULL;  // Required only for flexible GMRES
-  W = new TACSVec *[msub + 1];
-
-  for (int i = 0; i < msub + 1; i++) {
-    W[i] = mat->createVec();
-    W[i]->incref();
-  }
-
-  if (isFlexible) {
-    Z = new TACSVec *[msub];
+      u_hat->zeroEntries();
+      for (int i = 0; i < niters; i++) {
+        u_hat->axpy(res[i], Z[i]);
+      }
+    } else if (!pc) {  // If there's no pc
+      u_hat->zeroEntries();
+      for (int i = 0; i < niters; i++) {
+        u_hat->axpy(res[i], W[i]);
+      }
+    } else {  // If the pc isn't flexible
+      // Use c_hat here as a temporary array
+      c_hat->zeroEntries();
+      for (int i = 0; i < niters; i++) {
+        c_hat->axpy(res[i], W[i]);
+      }
 
-    for (int i = 0; i < msub; i++) {
-      Z[i] = mat->createVec();
-      Z[i]->incref();
+      // Apply u_hat = M^{-1} c_hat to the linear combination
+      pc->applyFactor(c_hat, u_hat);
     }
-  }
 
-  R = mat->createVec();
-  c_hat = mat->createVec();
-  u_hat = mat->createVec();
+    // Now complete u_hat by computing u_hat = u_hat - U*B*y
+    // Here y = res
+    // Note that B is (outer_size,msub)
+    for (int i = 0; i < outer_size; i++) {
+      TacsScalar bsum = TacsScalar(0.0);
+      for (int j = 0; j < niters; j++) {
+        bsum = bsum + B[i * msub + j] * res[j];
+      }
 
-  R->incref();
-  c_hat->incref();
-  u_hat->incref();
+      u_hat->axpy(-bsum, U[i]);
+    }
 
-  U = new TACSVec *[outer];
-  C = new TACSVec *[outer];
+    c_hat->zeroEntries();
 
-  for (int i = 0; i < outer; i++) {
-    U[i] = mat->createVec();
-    U[i]->incref();
-    C[i] = mat->createVec();
-    C[i]->incref();
-  }
+    // Compute c_hat = W*H*y
+    // The Hessenberg matrix has been modified by pre-multiplying by Q
+    // now, undo these rotations and multiply by Q^{T}
+    for (int i = 0; i < niters; i++) {
+      TacsScalar h1, h2;
+      for (int k = i; k >= 0; k--) {
+        h1 = H[k + Hptr[i]];
+        h2 = H[k + 1 + Hptr[i]];
+        H[k + Hptr[i]] = h1 * Qcos[k] - h2 * Qsin[k];
+        H[k + 1 + Hptr[i]] = h1 * Qsin[k] + h2 * Qcos[k];
+      }
+    }
 
-  // Allocate space for the Hessenberg matrix
-  // This is a (msub+1) x msub matrix with non-zeros
-  // on and above the first diagonal below the main diagonal
-  Hptr = new int[msub + 1];
-  Hptr[0] = 0;
+    // The matrix H is (niters+1) by (niters) // H[i,j] = H[i + Hptr[j]]
+    // y = the variables res is niters
+    for (int i = 0; i < niters + 1; i++) {
+      TacsScalar hsum = TacsScalar(0.0);
+      int j = i - 1;
+      if (i == 0) {
+        j = 0;
+      }
 
-  for (int i = 0; i < msub; i++) {
-    Hptr[i + 1] = Hptr[i] + i + 2;
-  }
+      // hsum = hsum + H[i,j]*res[j]
+      for (; j < niters; j++) {
+        hsum += H[i + Hptr[j]] * res[j];
+      }
 
-  int size = Hptr[msub];
-  H = new TacsScalar[size];        // The Hessenberg matrix
-  res = new TacsScalar[msub + 1];  // The residual
-  B = new TacsScalar[msub * outer];
+      c_hat->axpy(hsum, W[i]);
+    }
 
-  memset(H, 0, size * sizeof(TacsScalar));
-  memset(res, 0, (msub + 1) * sizeof(TacsScalar));
-  memset(B, 0, msub * outer * sizeof(TacsScalar));
+    TacsScalar cnorm = c_hat->norm();
+    c_hat->scale(1.0 / cnorm);
+    u_hat->scale(1.0 / cnorm);
 
-  // Allocate the terms that represent the unitary Q matrix
-  // in the QR factorixation of H
-  Qsin = new TacsScalar[msub];
-  Qcos = new TacsScalar[msub];
+    // Update the residual and solution
+    TacsScalar alpha = R->dot(c_hat);
+    R->axpy(-alpha, c_hat);
+    x->axpy(alpha, u_hat);
 
-  memset(Qsin, 0, msub * sizeof(TacsScalar));
-  memset(Qcos, 0, msub * sizeof(TacsScalar));
-}
+    // Compute the residual and compare...
+    // mat->mult( x, R );      // R = A*x
+    // R->axpy( -1.0, b );     // R = A*x - b
+    // R->scale( -1.0 );
 
-/*
-  Delete the object and free all the data
-*/
-GCROT::~GCROT() {
-  mat->decref();
+    if (solve_flag || stop_flag) {
+      break;
+    }
 
-  if (pc) {
-    pc->decref();
-  }
+    // Now, prepend c_hat and u_hat to C and U respectively.
+    // All this is done with pointers - no copying actually occurs.
+    // Otherwise, discard the oldest vector -
+    // but use it for the 'new' u_hat/c_hat
+    TACSVec *u = u_hat;
+    TACSVec *c = c_hat;
 
-  R->decref();
-  u_hat->decref();
-  c_hat->decref();
+    // This is the size of the subspace on the next iteration
+    outer_size = (count + 1 < outer ? count + 1 : outer);
 
-  for (int i = 0; i < outer; i++) {
-    if (U[i]) {
-      U[i]->decref();
-    }
-    if (C[i]) {
-      C[i]->decref();
-    }
-  }
+    for (int i = 0; i < outer_size; i++) {
+      TACSVec *tu = U[i];
+      TACSVec *tc = C[i];
 
-  delete[] U;
-  delete[] C;
+      U[i] = u;
+      C[i] = c;
 
-  if (Z) {
-    for (int i = 0; i < msub; i++) {
-      Z[i]->decref();
+      u = tu;
+      c = tc;
     }
-    delete[] Z;
-  }
-
-  for (int i = 0; i < msub + 1; i++) {
-    W[i]->decref();
-  }
-  delete[] W;
 
-  if (monitor) {
-    monitor->decref();
+    u_hat = u;
+    c_hat = c;
   }
 
-  delete[] H;
-  delete[] Hptr;
-  delete[] res;
-  delete[] B;
-  delete[] Qsin;
-  delete[] Qcos;
+  return solve_flag;
 }
 
 /*
-  Set the matrix/preconditioner operators used for GCROT
-*/
-void GCROT::setOperators(TACSMat *_mat, TACSPc *_pc) {
-  if (_mat) {
-    _mat->incref();
-    if (mat) {
-      mat->decref();
-    }
-    mat = _mat;
-  }
-  if (_pc) {
-    _pc->incref();
-    if (pc) {
-      pc->decref();
-    }
-    pc = _pc;
-  }
-}
+  Create the recycling GCRO-DR solver
 
-/*
-  Retrieve the matrix/preconditioner operators set in the GCROT object
+  The constructor arguments match GCROT. The outer subspace is
+  retained between calls to solve() so that consecutive nearly
+  identical systems - such as those generated during a design
+  optimization loop - are deflated by the directions discovered in
+  earlier solves.
+
+  input:
+  mat:        the matrix operator
+  pc:         the preconditioner
+  outer:      the number of outer (recycled) vectors
+  max_outer:  the maximum number of outer iterations before we give up
+  msub:       the size of the underlying GMRES (FGMRES) subspace
+  isflexible: parameter to indicate whether to use a flexible variant
 */
-void GCROT::getOperators(TACSMat **_mat, TACSPc **_pc) {
-  if (_mat) {
-    *_mat = mat;
-  }
-  if (_pc) {
-    *_pc = pc;
-  }
+GCRODR::GCRODR(TACSMat *_mat, TACSPc *_pc, int _outer, int _max_outer,
+               int _msub, int _isFlexible)
+    : GCROT(_mat, _pc, _outer, _max_outer, _msub, _isFlexible) {
+  recycle_size = 0;
 }
 
 /*
-  Set the relative and absolute convergence tolerances for GCROT
+  Create the recycling GCRO-DR solver without a preconditioner. Note
+  that this variant is never flexible.
 */
-void GCROT::setTolerances(double _rtol, double _atol) {
-  rtol = _rtol;
-  atol = _atol;
+GCRODR::GCRODR(TACSMat *_mat, int _outer, int _max_outer, int _msub)
+    : GCROT(_mat, _outer, _max_outer, _msub) {
+  recycle_size = 0;
 }
 
 /*
-  Set the residual/solution monitor object
+  Discard the recycled subspace.
+
+  Call this when the design variables (and therefore the matrix) have
+  changed so drastically that the directions accumulated from previous
+  solves are no longer representative.
 */
-void GCROT::setMonitor(KSMPrint *_monitor) {
-  _monitor->incref();
-  if (monitor) {
-    monitor->decref();
-  }
-  monitor = _monitor;
-}
+void GCRODR::resetRecycle() { recycle_size = 0; }
 
-const char *GCROT::getObjectName() { return gcrotName; }
+const char *GCRODR::getObjectName() { return gcrodrName; }
 
-const char *GCROT::gcrotName = "GCROT";
+const char *GCRODR::gcrodrName = "GCRODR";
 
 /*
-  Solve the linear system defined by the matrix operator with the
-  given (possibly flexible) preconditioner
+  Solve the linear system, recycling the outer subspace from previous
+  calls to solve().
+
+  This follows the GCROT algorithm with two modifications. First, the
+  U/C pairs retained from the previous solve are refreshed for the
+  current operator - the images C[i] = A*U[i] are recomputed and
+  re-orthonormalized with the same transformations applied to U[i] so
+  that the invariant C[i] = A*U[i] holds with C orthonormal - and the
+  initial residual is projected onto the recycled space. Second, the
+  outer vectors remaining at the end of the solve are retained for the
+  next call instead of being discarded.
 
   input:
   b:          the input right-hand-side
@@ -1193,12 +3681,48 @@ const char *GCROT::gcrotName = "GCROT";
   output:
   solve_flag: flag for the whether the solve terminated successfully
 */
-int GCROT::solve(TACSVec *b, TACSVec *x, int zero_guess) {
+int GCRODR::solve(TACSVec *b, TACSVec *x, int zero_guess) {
   TacsScalar rhs_norm = 0.0;
   int solve_flag = 0;
+  int stop_flag = 0;
   int mat_iters = 0;
   iterCount = 0;
 
+  // Refresh the recycled subspace for the current operator. The
+  // matrix may have been modified since the previous solve, so the
+  // images of the recycled directions must be recomputed.
+  int nrecycle = 0;
+  for (int i = 0; i < recycle_size; i++) {
+    TACSVec *u = U[i];
+    TACSVec *c = C[i];
+
+    mat->mult(u, c);  // C[i] = A*U[i]
+    mat_iters++;
+    TacsScalar cnorm0 = c->norm();
+
+    // Orthogonalize against the pairs that have already been accepted
+    for (int j = 0; j < nrecycle; j++) {
+      TacsScalar h = c->dot(C[j]);
+      c->axpy(-h, C[j]);
+      u->axpy(-h, U[j]);
+    }
+
+    // Drop directions that have become linearly dependent
+    TacsScalar cnorm = c->norm();
+    if (TacsRealPart(cnorm) > 1e-12 * TacsRealPart(cnorm0)) {
+      c->scale(1.0 / cnorm);
+      u->scale(1.0 / cnorm);
+
+      // Move the pair into the next accepted slot
+      U[i] = U[nrecycle];
+      C[i] = C[nrecycle];
+      U[nrecycle] = u;
+      C[nrecycle] = c;
+      nrecycle++;
+    }
+  }
+  recycle_size = nrecycle;
+
   // Compute the residual
   if (zero_guess) {
     // If the initial guess is zero
@@ -1215,14 +3739,35 @@ int GCROT::solve(TACSVec *b, TACSVec *x, int zero_guess) {
   rhs_norm = R->norm();  // The initial residual
   resNorm = rhs_norm;
 
+  if (callback && callback->iteration(this, 0, rhs_norm)) {
+    return solve_flag;
+  }
+
   if (TacsRealPart(rhs_norm) < atol) {
     solve_flag = 1;
     return solve_flag;
   }
 
+  // Project the initial residual onto the recycled subspace. Since
+  // C[i] = A*U[i] with C orthonormal, the residual components in the
+  // range of C are removed at the cost of the projection alone.
+  for (int i = 0; i < recycle_size; i++) {
+    TacsScalar alpha = R->dot(C[i]);
+    R->axpy(-alpha, C[i]);
+    x->axpy(alpha, U[i]);
+  }
+
+  resNorm = R->norm();
+  if (TacsRealPart(resNorm) < atol ||
+      TacsRealPart(resNorm) < rtol * TacsRealPart(rhs_norm)) {
+    solve_flag = 1;
+    return solve_flag;
+  }
+
   for (int count = 0; count < max_outer; count++) {
-    // Size of the U/C subspaces
-    int outer_size = (count < outer ? count : outer);  // min(count, outer);
+    // Size of the U/C subspaces, including the recycled directions
+    int outer_size =
+        (recycle_size + count < outer ? recycle_size + count : outer);
     int niters = 0;  // The size of the Hessenberg matrix
 
     W[0]->copyValues(R);  // W[0] = R
@@ -1302,6 +3847,11 @@ int GCROT::solve(TACSVec *b, TACSVec *x, int zero_guess) {
       if (monitor) {
         monitor->printResidual(mat_iters, resNorm);
       }
+      if (callback &&
+          callback->iteration(this, iterCount + niters, resNorm)) {
+        stop_flag = 1;
+        break;
+      }
       if (TacsRealPart(resNorm) < atol ||
           TacsRealPart(resNorm) < rtol * TacsRealPart(rhs_norm)) {
         // Set the solve flag
@@ -1403,24 +3953,16 @@ int GCROT::solve(TACSVec *b, TACSVec *x, int zero_guess) {
     R->axpy(-alpha, c_hat);
     x->axpy(alpha, u_hat);
 
-    // Compute the residual and compare...
-    // mat->mult( x, R );      // R = A*x
-    // R->axpy( -1.0, b );     // R = A*x - b
-    // R->scale( -1.0 );
-
-    if (solve_flag) {
-      break;
-    }
-
-    // Now, prepend c_hat and u_hat to C and U respectively.
-    // All this is done with pointers - no copying actually occurs.
-    // Otherwise, discard the oldest vector -
-    // but use it for the 'new' u_hat/c_hat
+    // Prepend c_hat and u_hat to C and U respectively, discarding the
+    // oldest direction once the subspace is full. Unlike GCROT, this
+    // is also done when the solve has converged so that the final
+    // direction is available for the next solve.
     TACSVec *u = u_hat;
     TACSVec *c = c_hat;
 
     // This is the size of the subspace on the next iteration
-    outer_size = (count + 1 < outer ? count + 1 : outer);
+    outer_size =
+        (recycle_size + count + 1 < outer ? recycle_size + count + 1 : outer);
 
     for (int i = 0; i < outer_size; i++) {
       TACSVec *tu = U[i];
@@ -1435,6 +3977,16 @@ int GCROT::solve(TACSVec *b, TACSVec *x, int zero_guess) {
 
     u_hat = u;
     c_hat = c;
+
+    if (solve_flag || stop_flag) {
+      // Retain the outer subspace for the next call to solve()
+      recycle_size = outer_size;
+      break;
+    }
+
+    if (count + 1 == max_outer) {
+      recycle_size = outer_size;
+    }
   }
 
   return solve_flag;
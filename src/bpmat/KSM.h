@@ -39,6 +39,9 @@ enum MatrixOrientation { TACS_MAT_NORMAL, TACS_MAT_TRANSPOSE };
 
   BCMap should only be instantiated once for a given analysis.  All
   other classes in this file should point that instance.
+
+  Once the boundary conditions have been initialized, the object is
+  read-only and may be queried concurrently from several threads.
 */
 class TACSBcMap : public TACSObject {
  public:
@@ -59,7 +62,15 @@ class TACSBcMap : public TACSObject {
   // ----------------------------------------------------------
   void addBinaryFlagBC(int node, int _vars);
 
+  // Get the boundary conditions as sorted ranges of consecutive nodes
+  // -----------------------------------------------------------------
+  int getBCRanges(const int **_range_nodes, const int **_range_counts,
+                  const int **_range_vars);
+
  private:
+  // Compute the run-length-encoded ranges of the boundary conditions
+  void computeBCRanges();
+
   // Set the block size
   int bsize;
 
@@ -76,6 +87,14 @@ class TACSBcMap : public TACSObject {
   // Set the boundary condition sizes
   int max_size;
   int bc_increment;
+
+  // The run-length-encoded ranges of consecutive boundary condition
+  // nodes that share a uniform variable mask, computed on demand
+  int nranges;
+  int *range_nodes;
+  int *range_counts;
+  int *range_vars;
+  int ranges_valid;
 };
 
 /*!
@@ -98,13 +117,29 @@ class TACSVec : public TACSObject {
   virtual void scale(TacsScalar alpha) = 0;  // Scale the vector by a value
   virtual TacsScalar dot(TACSVec *x) = 0;    // Compute x^{T} * y
   virtual void mdot(TACSVec **x, TacsScalar *ans,
-                    int m);                             // Multiple dot product
+                    int m);  // Multiple dot product
+  virtual void mdot_begin(TACSVec **x, TacsScalar *ans,
+                          int m);  // Start a non-blocking multiple dot product
+  virtual void mdot_end(TacsScalar *ans,
+                        int m);  // Complete the non-blocking dot product
   virtual void axpy(TacsScalar alpha, TACSVec *x) = 0;  // y <- y + alpha * x
   virtual void copyValues(TACSVec *x) = 0;  // Copy values from x to this
   virtual void axpby(TacsScalar alpha, TacsScalar beta,
                      TACSVec *x) = 0;  // Compute y <- alpha * x + beta * y
   virtual void zeroEntries() = 0;      // Zero all the entries
 
+  // Fused kernels for Krylov updates. The defaults fall back on the
+  // single operations; subclasses should override them with
+  // single-pass implementations since the vector operations in the
+  // Krylov methods are limited by memory bandwidth
+  // ----------------------------------------------------------------
+  virtual TacsScalar axpyNorm(TacsScalar alpha,
+                              TACSVec *x);  // y += alpha*x; return ||y||
+  virtual void axpbypz(TacsScalar alpha, TACSVec *x, TacsScalar beta,
+                       TACSVec *y);  // z <- z + alpha*x + beta*y
+  virtual void dotNorm(TACSVec *x, TacsScalar *xdot,
+                       TacsScalar *nrm);  // <y,x> and ||y|| together
+
   // Additional useful member functions
   // ----------------------------------
   virtual void setRand(double lower = -1.0, double upper = 1.0) {}
@@ -173,12 +208,25 @@ class TACSMat : public TACSObject {
   // Operations required for solving problems
   // ----------------------------------------
   virtual void mult(TACSVec *x, TACSVec *y) = 0;
+  virtual void multRHS(int nrhs, TACSVec **x, TACSVec **y) {
+    // Matrix types that can stream their entries once across the
+    // whole set of vectors override this default
+    for (int i = 0; i < nrhs; i++) {
+      mult(x[i], y[i]);
+    }
+  }
   virtual void multTranspose(TACSVec *x, TACSVec *y) {}
   virtual void copyValues(TACSMat *mat) {}
   virtual void scale(TacsScalar alpha) {}
   virtual void axpy(TacsScalar alpha, TACSMat *mat) {}
   virtual void addDiag(TacsScalar alpha) {}
 
+  // Binary export/import of the assembled matrix. Matrix types that
+  // store their entries in a portable layout override these.
+  // ---------------------------------------------------------------
+  virtual int writeToFile(const char *fname) { return 1; }
+  virtual int readFromFile(const char *fname) { return 1; }
+
   // Return the name of the object
   // -----------------------------
   const char *getObjectName();
@@ -187,6 +235,45 @@ class TACSMat : public TACSObject {
   static const char *matName;
 };
 
+/*!
+  A lazy linear combination of matrices.
+
+  This operator applies the action of the matrix
+
+  C = coefs[0]*mats[0] + coefs[1]*mats[1] + ...
+
+  without ever materializing C: mult() computes the products with the
+  member matrices and accumulates the scaled results. The typical use
+  is the Rayleigh damping matrix C = alpha*M + beta*K of a transient
+  analysis, where M and K are already assembled - representing C this
+  way saves the memory of a full matrix and the assembly pass that a
+  call to assembleMatCombo() would cost at every damping update, since
+  setCoefficients() only overwrites the scalar coefficients.
+
+  The operator supports only the matrix-vector product operations, so
+  it must be paired with a preconditioner built from a different
+  (assembled) matrix.
+*/
+class TACSLinearCombMat : public TACSMat {
+ public:
+  TACSLinearCombMat(int _nmats, TACSMat **_mats, const TacsScalar *_coefs);
+  ~TACSLinearCombMat();
+
+  // Update the coefficients of the combination
+  void setCoefficients(const TacsScalar *_coefs);
+
+  // Compute products with the combined operator
+  TACSVec *createVec();
+  void mult(TACSVec *x, TACSVec *y);
+  const char *getObjectName();
+
+ private:
+  int nmats;
+  TACSMat **mats;
+  TacsScalar *coefs;
+  TACSVec *temp;
+};
+
 /*!
   The abstract pre-conditioner class
 
@@ -219,6 +306,102 @@ class TACSPc : public TACSObject {
   static const char *pcName;
 };
 
+/*!
+  A preconditioner wrapper that re-uses a stale factorization.
+
+  Parameter sweeps - the load factor in TACSContinuation, frequency
+  shifts in flutter preprocessing - factor a sequence of nearby
+  matrices (K - lambda_i*M), paying a full factorization for each
+  parameter value even though consecutive matrices differ little.
+
+  This wrapper defers the refactorization: factor() only records that
+  the matrix values have changed, and applyFactor() performs
+  defect-correction iterative refinement around the existing (stale)
+  factorization
+
+  y_{k+1} = y_k + P^{-1}(x - A*y_k)
+
+  using the current matrix A for the residual. The refinement
+  converges quickly while the factored matrix remains close to the
+  current one. When the refinement needs more iterations than the
+  refactor threshold - or stops contracting - the base factorization
+  is recomputed and the refinement restarts from it, so the cost of
+  factorization is paid only when the parameter has drifted far enough
+  to degrade the stale factor.
+
+  The wrapper is a drop-in TACSPc: the sweep codes call factor() at
+  every parameter value exactly as they do now.
+*/
+class TACSDeferredFactorPc : public TACSPc {
+ public:
+  TACSDeferredFactorPc(TACSMat *_mat, TACSPc *_pc, double _rtol = 1e-12,
+                       int _max_iters = 10, int _refactor_threshold = 4);
+  ~TACSDeferredFactorPc();
+
+  // Mark the factorization stale - the refactorization is deferred
+  // until the refinement in applyFactor() degrades
+  void factor();
+
+  // Unconditionally refactor the base preconditioner
+  void forceFactor();
+
+  // Apply the stale factor with defect-correction refinement
+  void applyFactor(TACSVec *x, TACSVec *y);
+  void getMat(TACSMat **_mat);
+
+  // Retrieve the counts of refinement iterations and factorizations
+  void getCounts(int *_num_applies, int *_num_refine_iters,
+                 int *_num_factors);
+
+ private:
+  TACSMat *mat;  // The matrix with the current parameter value
+  TACSPc *pc;    // The factorization of a previous matrix
+
+  double rtol;             // Relative tolerance for the refinement
+  int max_iters;           // Refinement iteration limit per apply
+  int refactor_threshold;  // Refinement count that triggers a refactor
+  int factored;            // Has the base factorization been computed?
+
+  TACSVec *res, *update;  // Temporary vectors for the refinement
+
+  // Statistics over the lifetime of the object
+  int num_applies, num_refine_iters, num_factors;
+};
+
+/*!
+  Adaptive forcing-term controller for inexact Newton methods
+
+  The controller picks the relative tolerance for each inner linear
+  solve from the observed nonlinear residual history, following the
+  choice of Eisenstat and Walker. Early Newton iterations far from the
+  solution are solved loosely rather than to a fixed tight tolerance,
+  and the inner solves tighten as the nonlinear residual contracts. A
+  safeguard keeps the tolerance from dropping too abruptly after a
+  single good step.
+
+  This is a reusable policy object: call reset() at the start of each
+  nonlinear solve, then pass each new nonlinear residual norm to
+  update() and apply the returned tolerance with
+  TACSKsm::setTolerances() before the inner solve.
+*/
+class TACSEisenstatWalker : public TACSObject {
+ public:
+  TACSEisenstatWalker(double _eta_max = 0.1, double _eta_min = 1e-8,
+                      double _gamma = 0.9, double _alpha = 2.0);
+
+  // Reset the controller at the start of a nonlinear solve
+  void reset();
+
+  // Compute the forcing term from the latest nonlinear residual norm
+  double update(TacsScalar res_norm);
+
+ private:
+  double eta_max, eta_min;  // Bounds on the forcing term
+  double gamma, alpha;      // Contraction weight and exponent
+  double eta;               // The current forcing term
+  double prev_norm;         // The previous nonlinear residual norm
+};
+
 /*!
   The abstract residual history class
 
@@ -237,6 +420,34 @@ class KSMPrint : public TACSObject {
   static const char *printName;
 };
 
+class TACSKsm;
+
+/*!
+  The abstract per-iteration solver callback class
+
+  Unlike KSMPrint, which formats the residual for a screen or a file,
+  the callback receives the raw iteration data during the solve. An
+  outer solver - an aeroelastic coupling or a nonlinear continuation,
+  for example - can capture the residual history into its own buffers,
+  retarget the tolerances mid-solve through setTolerances() on the
+  solver passed to the callback, or terminate the solve early by
+  returning non-zero once the remaining accuracy no longer matters.
+  An early-terminated solve leaves the current iterate in the solution
+  vector and returns from solve() as unconverged.
+
+  The callback is invoked with iteration 0 and the initial residual
+  norm at the start of each solve, and then once per iteration with
+  the cumulative iteration count across restarts. When no callback is
+  set the solvers only test a pointer, so the hook costs nothing.
+*/
+class TACSKsmCallback : public TACSObject {
+ public:
+  virtual ~TACSKsmCallback() {}
+
+  // Return non-zero to terminate the solve after this iteration
+  virtual int iteration(TACSKsm *ksm, int iter, TacsScalar res) = 0;
+};
+
 /*!
   The abstract Krylov-subspace method class
 
@@ -264,8 +475,12 @@ class KSMPrint : public TACSObject {
  */
 class TACSKsm : public TACSObject {
  public:
-  TACSKsm() : iterCount(0), resNorm(0.0) {}
-  virtual ~TACSKsm() {}
+  TACSKsm() : iterCount(0), resNorm(0.0), callback(NULL) {}
+  virtual ~TACSKsm() {
+    if (callback) {
+      callback->decref();
+    }
+  }
 
   virtual TACSVec *createVec() = 0;
   virtual void setOperators(TACSMat *_mat, TACSPc *_pc) = 0;
@@ -273,6 +488,7 @@ class TACSKsm : public TACSObject {
   virtual int solve(TACSVec *b, TACSVec *x, int zero_guess = 1) = 0;
   virtual void setTolerances(double _rtol, double _atol) = 0;
   virtual void setMonitor(KSMPrint *_monitor) = 0;
+  void setCallback(TACSKsmCallback *_callback);
   virtual int getIterCount() { return iterCount; }
   virtual TacsScalar getResidualNorm() { return resNorm; }
   const char *getObjectName();
@@ -283,6 +499,7 @@ class TACSKsm : public TACSObject {
  protected:
   int iterCount;       ///< Number of iterations taken during the last solve
   TacsScalar resNorm;  ///< The residual norm at the end of the last solve
+  TACSKsmCallback *callback;  ///< Per-iteration callback - possibly NULL
 };
 
 /*
@@ -322,6 +539,28 @@ class KSMPrintFile : public KSMPrint {
   int freq;
 };
 
+/*
+  Capture the residual history of a solve into a reusable buffer
+
+  The buffer is sized once at creation and re-used across solves;
+  reset() is called automatically when iteration 0 arrives, so the
+  history always covers the most recent solve. Iterations past the
+  capacity of the buffer update the entry count but are not stored.
+*/
+class TACSKsmHistory : public TACSKsmCallback {
+ public:
+  TACSKsmHistory(int _max_iters);
+  ~TACSKsmHistory();
+
+  int iteration(TACSKsm *ksm, int iter, TacsScalar res);
+  int getHistory(const TacsScalar **_res);
+
+ private:
+  int max_iters;     // The capacity of the buffer
+  int num_entries;   // The number of iterations seen this solve
+  TacsScalar *res;   // The captured residual norms
+};
+
 /*!
   Pre-conditioned conjugate gradient method
 */
@@ -357,6 +596,133 @@ class PCG : public TACSKsm {
   KSMPrint *monitor;
 };
 
+/*!
+  Pipelined preconditioned conjugate gradient method
+
+  This is a communication-reduced variant of PCG based on the
+  Ghysels-Vanroose pipelined algorithm. The two inner products of the
+  standard method are fused into a single non-blocking reduction that
+  is overlapped with the preconditioner application and matrix-vector
+  product of the next iteration, so each iteration has one reduction
+  phase that is hidden behind local work. On large processor counts
+  where PCG is allreduce-bound this substantially reduces the time
+  per iteration; the convergence behavior is identical in exact
+  arithmetic.
+
+  The recurrences drift from the true residual faster than in standard
+  PCG, so the residual is recomputed from scratch at every reset. The
+  convergence test uses the preconditioner-norm of the residual, which
+  is the quantity available from the fused reduction. The
+  preconditioner must be fixed (not flexible) and symmetric positive
+  definite, as in PCG.
+
+  The input parameters are:
+  -------------------------
+  mat: the matrix operator
+  pc: the preconditioner
+  reset: reset the CG iterations every 'reset' iterations
+  nouter: the number of resets to try before giving up
+*/
+class PPCG : public TACSKsm {
+ public:
+  PPCG(TACSMat *_mat, TACSPc *_pc, int _reset, int _nouter);
+  ~PPCG();
+
+  TACSVec *createVec() { return mat->createVec(); }
+  int solve(TACSVec *b, TACSVec *x, int zero_guess = 1);
+  void setOperators(TACSMat *_mat, TACSPc *_pc);
+  void getOperators(TACSMat **_mat, TACSPc **_pc);
+  void setTolerances(double _rtol, double _atol);
+  void setMonitor(KSMPrint *_print);
+
+ private:
+  // Operators in the KSM method
+  TACSMat *mat;
+  TACSPc *pc;
+
+  // The relative/absolute tolerances
+  double rtol, atol;
+
+  // Reset parameters
+  int nouter, reset;
+
+  // Vectors required for the solution method
+  TACSVec *R;   // The residual
+  TACSVec *U;   // U = M^{-1}*R
+  TACSVec *W;   // W = A*U
+  TACSVec *Mv;  // Mv = M^{-1}*W
+  TACSVec *Nv;  // Nv = A*Mv
+  TACSVec *P;   // The search direction
+  TACSVec *S;   // S = A*P
+  TACSVec *Q;   // Q = M^{-1}*S
+  TACSVec *Z;   // Z = A*Q
+
+  KSMPrint *monitor;
+};
+
+/*!
+  Block preconditioned conjugate gradient method for multiple
+  right-hand sides
+
+  All of the right-hand sides are iterated on simultaneously. The
+  matrix-multivector products are computed through mat->multRHS() so
+  that matrix classes with a single-sweep product amortize the matrix
+  memory traffic over all of the vectors. The standard CG scalars
+  become small nrhs-by-nrhs coefficient systems that couple the
+  search directions across the right-hand sides; these are factored
+  with LAPACK on each processor.
+
+  The input parameters are:
+  -------------------------
+  mat: the matrix handle
+  pc: the preconditioner
+  nrhs: the number of simultaneous right-hand sides
+  reset: reset the CG iterations every 'reset' iterations
+  nouter: the number of resets to try before giving up
+*/
+class BlockPCG : public TACSKsm {
+ public:
+  BlockPCG(TACSMat *_mat, TACSPc *_pc, int _nrhs, int _reset, int _nouter);
+  ~BlockPCG();
+
+  TACSVec *createVec() { return mat->createVec(); }
+  int solve(TACSVec *b, TACSVec *x, int zero_guess = 1);
+  int solveRHS(TACSVec **b, TACSVec **x, int zero_guess = 1);
+  void setOperators(TACSMat *_mat, TACSPc *_pc);
+  void getOperators(TACSMat **_mat, TACSPc **_pc);
+  void setTolerances(double _rtol, double _atol);
+  void setMonitor(KSMPrint *_print);
+
+ private:
+  // Solve for the first m <= nrhs right-hand sides
+  int solveBlock(int m, TACSVec **b, TACSVec **x, int zero_guess);
+
+  // Operators in the KSM method
+  TACSMat *mat;
+  TACSPc *pc;
+
+  // The relative/absolute tolerances
+  double rtol, atol;
+
+  // Reset parameters
+  int nouter, reset;
+
+  // The number of simultaneous right-hand sides
+  int nrhs;
+
+  // Block vectors required for the solution method
+  TACSVec **W;  // W = A*P
+  TACSVec **R;  // The block residual
+  TACSVec **P;  // The search directions
+  TACSVec **Z;  // The preconditioned residual
+
+  // The nrhs x nrhs coefficient matrices and pivot sequence
+  TacsScalar *gamma, *delta, *cmat;
+  int *cpiv;
+
+  KSMPrint *monitor;
+};
+
 /*!
   Right-preconditioned GMRES
 
@@ -390,7 +756,11 @@ class PCG : public TACSKsm {
 */
 class GMRES : public TACSKsm {
  public:
-  enum OrthoType { CLASSICAL_GRAM_SCHMIDT, MODIFIED_GRAM_SCHMIDT };
+  enum OrthoType {
+    CLASSICAL_GRAM_SCHMIDT,
+    MODIFIED_GRAM_SCHMIDT,
+    BLOCKED_GRAM_SCHMIDT
+  };
   GMRES(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart, int _isFlexible);
   GMRES(TACSMat *_mat, int _m, int _nrestart);
   ~GMRES();
@@ -432,12 +802,164 @@ class GMRES : public TACSKsm {
   TacsScalar *Qcos;
   TacsScalar *res;
 
+  // Corrections from the reorthogonalization passes
+  TacsScalar *hcorr;
+
   int monitor_time;
   KSMPrint *monitor;
 
   static const char *gmresName;
 };
 
+/*!
+  Pipelined GMRES with a single reduction per iteration
+
+  This is a communication-avoiding variant of right-preconditioned
+  GMRES. The classical Gram-Schmidt dot products and the norm of the
+  new Krylov vector are fused into a single all-reduce per iteration,
+  and the reduction is started with a non-blocking operation so that
+  the next matrix-vector product and preconditioner application
+  proceed while the reduction is in flight. The cost is one additional
+  matrix-vector product per restart cycle and a second set of subspace
+  vectors that store the images A*M^{-1}*W[i].
+
+  This trades extra local work for far fewer synchronization points,
+  which pays off when the all-reduce latency is significant relative
+  to the matrix-vector product time. Note that the preconditioner must
+  be fixed (not flexible) since the recurrence assumes that the
+  preconditioner is a linear operator.
+*/
+class PGMRES : public TACSKsm {
+ public:
+  PGMRES(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart);
+  PGMRES(TACSMat *_mat, int _m, int _nrestart);
+  ~PGMRES();
+
+  TACSVec *createVec() { return mat->createVec(); }
+  int solve(TACSVec *b, TACSVec *x, int zero_guess = 1);
+  void setOperators(TACSMat *_mat, TACSPc *_pc);
+  void getOperators(TACSMat **_mat, TACSPc **_pc);
+  void setTolerances(double _rtol, double _atol);
+  void setMonitor(KSMPrint *_monitor);
+  void setTimeMonitor();
+  const char *getObjectName();
+
+ private:
+  // Initialize the class
+  void init(TACSMat *_mat, TACSPc *_pc, int _m, int _nrestart);
+
+  // Compute out = A*M^{-1}*in
+  void applyOperator(TACSVec *in, TACSVec *out);
+
+  TACSMat *mat;
+  TACSPc *pc;
+  int msub;
+  int nrestart;
+
+  TACSVec **W;     // The Arnoldi vectors that span the Krylov subspace
+  TACSVec **V;     // The images V[i] = A*M^{-1}*W[i]
+  TACSVec **dotw;  // The vectors used in the fused dot product
+  TACSVec *work;   // A work vector
+
+  int *Hptr;      // Array to make accessing the elements of the matrix easier!
+  TacsScalar *H;  // The Hessenberg matrix
+
+  double rtol;
+  double atol;
+
+  TacsScalar *Qsin;
+  TacsScalar *Qcos;
+  TacsScalar *res;
+  TacsScalar *gwork;  // The fused Gram-Schmidt coefficients
+
+  int monitor_time;
+  KSMPrint *monitor;
+
+  static const char *pgmresName;
+};
+
+/*!
+  Communication-avoiding s-step GMRES
+
+  This solver restructures right-preconditioned GMRES so that the
+  global communication happens once per block of s iterations instead
+  of once (or more) per iteration. Each block generates s new Krylov
+  vectors back-to-back with repeated preconditioned matrix-vector
+  products, then orthogonalizes the whole block in two steps: the
+  cross products of the block against the existing basis and among
+  itself are computed with a single all-reduce, the block is projected
+  with block classical Gram-Schmidt, and the projected block is
+  orthonormalized with a local Cholesky QR. The block-Hessenberg
+  columns are recovered algebraically from the change of basis, so the
+  least-squares problem and the convergence test are identical to
+  standard GMRES.
+
+  On high-latency interconnects where GMRES is dominated by the
+  orthogonalization reductions, this trades one reduction per s
+  iterations against the weaker numerical properties of the monomial
+  basis: the basis conditioning degrades quickly with s, so s should
+  be kept small (s <= 6). The true residual is recomputed at every
+  restart, which acts as the residual replacement for the drift
+  introduced by the block recurrences. If the block basis loses
+  independence, the block is truncated at the last independent vector
+  and the solver restarts from the current iterate.
+
+  The matrix-powers kernel uses the standard halo exchange of the
+  underlying matrix for each product; the reductions, not the
+  neighbor exchanges, are the latency bottleneck this addresses.
+
+  The input parameters are:
+  -------------------------
+  mat: the matrix operator
+  pc: the preconditioner (may be NULL); must not be flexible
+  s: the number of Krylov vectors generated per reduction
+  nblocks: the number of s-step blocks before a restart (m = s*nblocks)
+  nrestart: the number of restarts before we give up
+*/
+class SSGMRES : public TACSKsm {
+ public:
+  SSGMRES(TACSMat *_mat, TACSPc *_pc, int _s, int _nblocks, int _nrestart);
+  ~SSGMRES();
+
+  TACSVec *createVec() { return mat->createVec(); }
+  int solve(TACSVec *b, TACSVec *x, int zero_guess = 1);
+  void setOperators(TACSMat *_mat, TACSPc *_pc);
+  void getOperators(TACSMat **_mat, TACSPc **_pc);
+  void setTolerances(double _rtol, double _atol);
+  void setMonitor(KSMPrint *_monitor);
+  const char *getObjectName();
+
+ private:
+  // Compute the cross products of the candidate block against the
+  // basis and itself with a single reduction
+  void computeBlockGram(int nv, int nw, TacsScalar *gram);
+
+  TACSMat *mat;
+  TACSPc *pc;
+  int sstep;    // The number of steps per reduction
+  int nblocks;  // The number of blocks per restart
+  int msub;     // The restart size msub = sstep*nblocks
+  int nrestart;
+
+  TACSVec **V;   // The orthonormal basis of the Krylov subspace
+  TACSVec *work;  // A work vector for the preconditioner
+
+  TacsScalar *H;     // The block-Hessenberg matrix, (msub+1) x msub
+  TacsScalar *gram;  // Work space for the fused block reduction
+  TacsScalar *wc;    // The basis coefficients of the raw block
+
+  double rtol;
+  double atol;
+
+  TacsScalar *Qsin;
+  TacsScalar *Qcos;
+  TacsScalar *res;
+
+  KSMPrint *monitor;
+
+  static const char *ssgmresName;
+};
+
 /*!
   A simplified and flexible variant of GCROT - from Hicken and Zingg
 
@@ -468,7 +990,7 @@ class GCROT : public TACSKsm {
   void setMonitor(KSMPrint *_monitor);
   const char *getObjectName();
 
- private:
+ protected:
   void init(TACSMat *_mat, TACSPc *_pc, int _outer, int _max_outer, int _msub,
             int _isFlexible);
 
@@ -496,9 +1018,46 @@ class GCROT : public TACSKsm {
 
   KSMPrint *monitor;
 
+ private:
   static const char *gcrotName;
 };
 
+/*!
+  GCRO with subspace recycling across consecutive solves
+
+  This solver extends the GCROT machinery so that the outer subspace
+  of U/C pairs is carried over from one call to solve() to the next,
+  in the style of GCRO-DR. In a design-optimization loop the linear
+  systems change slowly between design iterations, so the outer
+  directions built up during one solve deflate the systems that
+  follow. At the start of each solve the images C[i] = A*U[i] are
+  recomputed and re-orthonormalized so that the recycled space remains
+  consistent with the updated operator, then the initial residual is
+  projected onto the recycled space before the inner iterations begin.
+
+  Rather than computing harmonic Ritz vectors, the recycled space is
+  selected by the same truncation used by GCROT within a single solve:
+  the most recent outer directions are retained. Call resetRecycle()
+  to discard the subspace when the design variables change so much
+  that the recycled directions are no longer useful.
+*/
+class GCRODR : public GCROT {
+ public:
+  GCRODR(TACSMat *_mat, TACSPc *_pc, int _outer, int _max_outer, int _msub,
+         int _isFlexible);
+  GCRODR(TACSMat *_mat, int _outer, int _max_outer, int _msub);
+
+  int solve(TACSVec *b, TACSVec *x, int zero_guess = 1);
+  void resetRecycle();
+  const char *getObjectName();
+
+ private:
+  // The number of U/C pairs retained from previous solves
+  int recycle_size;
+
+  static const char *gcrodrName;
+};
+
 /*
   Create a Krylov-subspace class that is just a preconditioner.
 
@@ -18,6 +18,9 @@
 
 #include "TACSBVec.h"
 
+#include <string.h>
+
+#include "TacsUtilities.h"
 #include "tacslapack.h"
 
 /*
@@ -87,6 +90,9 @@ TACSBVec::TACSBVec(TACSNodeMap *map, int _bsize, TACSBVecDistribute *_ext_dist,
   // Get the MPI communicator
   comm = node_map->getMPIComm();
 
+  // No non-blocking dot product is outstanding
+  mdot_request = MPI_REQUEST_NULL;
+
   // Set the block size
   bsize = _bsize;
   size = bsize * node_map->getNumNodes();
@@ -94,26 +100,23 @@ TACSBVec::TACSBVec(TACSNodeMap *map, int _bsize, TACSBVecDistribute *_ext_dist,
   // Allocate the array of owned unknowns
   x = new TacsScalar[size];
   memset(x, 0, size * sizeof(TacsScalar));
+  TacsAddAllocs(1);
 
-  // Set the external data
+  // Set the external data. The ghost storage and the communication
+  // context are materialized lazily on the first ghost access.
   ext_dist = _ext_dist;
   if (ext_dist) {
     ext_dist->incref();
     ext_indices = ext_dist->getIndices();
     ext_indices->incref();
     ext_size = bsize * ext_dist->getNumNodes();
-    x_ext = new TacsScalar[ext_size];
-    memset(x_ext, 0, ext_size * sizeof(TacsScalar));
-
-    // Create the communicator context
-    ext_ctx = ext_dist->createCtx(bsize);
-    ext_ctx->incref();
+    num_ghost_capable++;
   } else {
     ext_size = 0;
     ext_indices = NULL;
-    x_ext = NULL;
-    ext_ctx = NULL;
   }
+  x_ext = NULL;
+  ext_ctx = NULL;
 
   // Set the dependent node data (if defined)
   dep_nodes = _dep_nodes;
@@ -138,6 +141,7 @@ TACSBVec::TACSBVec(TACSNodeMap *map, int _bsize, TACSBVecDistribute *_ext_dist,
   size:  the number of local entries stored by this vector
 */
 TACSBVec::TACSBVec(MPI_Comm _comm, int _size, int _bsize) {
+  mdot_request = MPI_REQUEST_NULL;
   bsize = _bsize;
   size = _size;
   comm = _comm;
@@ -145,11 +149,13 @@ TACSBVec::TACSBVec(MPI_Comm _comm, int _size, int _bsize) {
 
   x = new TacsScalar[size];
   memset(x, 0, size * sizeof(TacsScalar));
+  TacsAddAllocs(1);
 
   // Zero/NULL the external data
   ext_size = 0;
   x_ext = NULL;
   ext_dist = NULL;
+  ext_indices = NULL;
   ext_ctx = NULL;
 
   // Zero/NULL the dependent node data
@@ -185,6 +191,61 @@ TACSBVec::~TACSBVec() {
   }
 }
 
+/*
+  Materialize the external/ghost storage and the communication context
+  on the first ghost access.
+
+  Vectors that never read, write or exchange ghost values - pure
+  output vectors, design variable vectors and most work vectors -
+  never pay for the ghost storage or the context set-up. A vector with
+  no materialized storage behaves as if all of its ghost values were
+  zero.
+
+  The check-then-allocate here is not thread-safe. Callers that rely
+  on concurrent setValues() calls with disjoint indices - such as the
+  colored lock-free element scatter - must call this once before the
+  writers start.
+*/
+void TACSBVec::initExtArray() {
+  if (ext_dist && !x_ext) {
+    x_ext = new TacsScalar[ext_size];
+    memset(x_ext, 0, ext_size * sizeof(TacsScalar));
+
+    // Create the communicator context
+    ext_ctx = ext_dist->createCtx(bsize);
+    ext_ctx->incref();
+
+    num_ghost_materialized++;
+    if (ghost_tracking) {
+      int rank;
+      MPI_Comm_rank(comm, &rank);
+      fprintf(stderr,
+              "[%d] TACSBVec %p: materialized ghost storage (%d values)\n",
+              rank, (void *)this, ext_size);
+    }
+  }
+}
+
+/*
+  Enable or disable the ghost access tracking mode. When enabled, each
+  vector that materializes its ghost storage prints a line identifying
+  itself - vectors that remain silent never needed an exchange.
+*/
+void TACSBVec::setGhostAccessTracking(int flag) { ghost_tracking = flag; }
+
+/*
+  Retrieve the number of exchange-capable vectors created and the
+  number that actually materialized their ghost storage
+*/
+void TACSBVec::getGhostAccessCounts(int *num_capable, int *num_materialized) {
+  if (num_capable) {
+    *num_capable = num_ghost_capable;
+  }
+  if (num_materialized) {
+    *num_materialized = num_ghost_materialized;
+  }
+}
+
 /*
   Get the local size of the vector on this processor
 */
@@ -217,7 +278,8 @@ TacsScalar TACSBVec::norm() {
 #endif
   TacsAddFlops(2 * size);
 
-  MPI_Allreduce(&res, &sum, 1, TACS_MPI_TYPE, MPI_SUM, comm);
+  sum = res;
+  TacsScalarAllreduce(comm, &sum, 1);
 
   return sqrt(sum);
 }
@@ -265,7 +327,8 @@ TacsScalar TACSBVec::dot(TACSVec *tvec) {
     int one = 1;
     res = BLASdot(&size, x, &one, vec->x, &one);
 #endif
-    MPI_Allreduce(&res, &sum, 1, TACS_MPI_TYPE, MPI_SUM, comm);
+    sum = res;
+    TacsScalarAllreduce(comm, &sum, 1);
   } else {
     fprintf(stderr, "TACSBVec type error: Input must be TACSBVec\n");
   }
@@ -321,7 +384,76 @@ void TACSBVec::mdot(TACSVec **tvec, TacsScalar *ans, int nvecs) {
 
   TacsAddFlops(2 * nvecs * size);
 
-  MPI_Allreduce(MPI_IN_PLACE, ans, nvecs, TACS_MPI_TYPE, MPI_SUM, comm);
+  TacsScalarAllreduce(comm, ans, nvecs);
+}
+
+/*
+  Start a non-blocking multiple dot product.
+
+  The local dot products are computed immediately, then the global
+  reduction is started with a non-blocking all-reduce so that the
+  caller can overlap other work with the communication. The results
+  are available in ans only after the call to mdot_end(). Only one
+  split-phase dot product may be outstanding at a time.
+*/
+void TACSBVec::mdot_begin(TACSVec **tvec, TacsScalar *ans, int nvecs) {
+  for (int k = 0; k < nvecs; k++) {
+    ans[k] = 0.0;
+
+    TACSBVec *vec = dynamic_cast<TACSBVec *>(tvec[k]);
+    if (vec) {
+      if (vec->size != size) {
+        fprintf(stderr, "TACSBVec::dot Error, the sizes must be the same\n");
+        continue;
+      }
+
+#if defined(TACS_USE_COMPLEX)
+      TacsScalar res = 0.0;
+      int i = 0;
+      int rem = size % 4;
+      TacsScalar *y = x;
+      TacsScalar *z = vec->x;
+      for (; i < rem; i++) {
+        res += y[0] * z[0];
+        y++;
+        z++;
+      }
+
+      for (; i < size; i += 4) {
+        res += y[0] * z[0] + y[1] * z[1] + y[2] * z[2] + y[3] * z[3];
+        y += 4;
+        z += 4;
+      }
+
+      ans[k] = res;
+#else
+      int one = 1;
+      ans[k] = BLASdot(&size, x, &one, vec->x, &one);
+#endif
+    } else {
+      fprintf(stderr, "TACSBVec type error: Input must be TACSBVec\n");
+    }
+  }
+
+  TacsAddFlops(2 * nvecs * size);
+
+  if (TacsGetDeterministicReductions()) {
+    // Complete the reduction eagerly: a non-blocking all-reduce does
+    // not fix the order of the summation
+    TacsScalarAllreduce(comm, ans, nvecs);
+    mdot_request = MPI_REQUEST_NULL;
+  } else {
+    MPI_Iallreduce(MPI_IN_PLACE, ans, nvecs, TACS_MPI_TYPE, MPI_SUM, comm,
+                   &mdot_request);
+  }
+}
+
+/*
+  Complete the non-blocking multiple dot product started with
+  mdot_begin()
+*/
+void TACSBVec::mdot_end(TacsScalar *ans, int nvecs) {
+  MPI_Wait(&mdot_request, MPI_STATUS_IGNORE);
 }
 
 /*
@@ -383,6 +515,153 @@ void TACSBVec::axpby(TacsScalar alpha, TacsScalar beta, TACSVec *tvec) {
   TacsAddFlops(3 * size);
 }
 
+/*
+  Compute y <- y + alpha*x and return the norm of the updated vector
+
+  The update and the local square norm are fused so that y streams
+  through memory once rather than three times for the separate
+  axpy/norm calls.
+*/
+TacsScalar TACSBVec::axpyNorm(TacsScalar alpha, TACSVec *tvec) {
+  TacsScalar sum = 0.0;
+  TACSBVec *vec = dynamic_cast<TACSBVec *>(tvec);
+
+  if (vec) {
+    if (vec->size != size) {
+      fprintf(stderr, "TACSBVec::axpyNorm Error, the sizes must be the same\n");
+      return 0.0;
+    }
+
+    TacsScalar res = 0.0;
+    int i = 0;
+    int rem = size % 4;
+    TacsScalar *y = x;
+    TacsScalar *z = vec->x;
+
+    for (; i < rem; i++) {
+      y[0] = y[0] + alpha * z[0];
+      res += y[0] * y[0];
+      y++;
+      z++;
+    }
+
+    for (; i < size; i += 4) {
+      y[0] = y[0] + alpha * z[0];
+      y[1] = y[1] + alpha * z[1];
+      y[2] = y[2] + alpha * z[2];
+      y[3] = y[3] + alpha * z[3];
+      res += y[0] * y[0] + y[1] * y[1] + y[2] * y[2] + y[3] * y[3];
+      y += 4;
+      z += 4;
+    }
+
+    sum = res;
+    TacsScalarAllreduce(comm, &sum, 1);
+  } else {
+    fprintf(stderr, "TACSBVec type error: Input must be TACSBVec\n");
+  }
+
+  TacsAddFlops(4 * size);
+
+  return sqrt(sum);
+}
+
+/*
+  Compute z <- z + alpha*x + beta*y in a single pass
+*/
+void TACSBVec::axpbypz(TacsScalar alpha, TACSVec *tx, TacsScalar beta,
+                       TACSVec *ty) {
+  TACSBVec *xvec = dynamic_cast<TACSBVec *>(tx);
+  TACSBVec *yvec = dynamic_cast<TACSBVec *>(ty);
+
+  if (xvec && yvec) {
+    if (xvec->size != size || yvec->size != size) {
+      fprintf(stderr, "TACSBVec::axpbypz Error, the sizes must be the same\n");
+      return;
+    }
+
+    int i = 0;
+    int rem = size % 4;
+    TacsScalar *z = x;
+    TacsScalar *xs = xvec->x;
+    TacsScalar *ys = yvec->x;
+
+    for (; i < rem; i++) {
+      z[0] = z[0] + alpha * xs[0] + beta * ys[0];
+      z++;
+      xs++;
+      ys++;
+    }
+
+    for (; i < size; i += 4) {
+      z[0] = z[0] + alpha * xs[0] + beta * ys[0];
+      z[1] = z[1] + alpha * xs[1] + beta * ys[1];
+      z[2] = z[2] + alpha * xs[2] + beta * ys[2];
+      z[3] = z[3] + alpha * xs[3] + beta * ys[3];
+      z += 4;
+      xs += 4;
+      ys += 4;
+    }
+  } else {
+    fprintf(stderr, "TACSBVec type error: Input must be TACSBVec\n");
+  }
+
+  TacsAddFlops(4 * size);
+}
+
+/*
+  Compute the dot product with x and the norm of this vector together
+
+  xdot = y^{T}*x and nrm = ||y||
+
+  The two local reductions share one pass over y and a single
+  all-reduce.
+*/
+void TACSBVec::dotNorm(TACSVec *tvec, TacsScalar *xdot, TacsScalar *nrm) {
+  TacsScalar sum[2] = {0.0, 0.0};
+  TACSBVec *vec = dynamic_cast<TACSBVec *>(tvec);
+
+  if (vec) {
+    if (vec->size != size) {
+      fprintf(stderr, "TACSBVec::dotNorm Error, the sizes must be the same\n");
+      *xdot = 0.0;
+      *nrm = 0.0;
+      return;
+    }
+
+    TacsScalar res[2] = {0.0, 0.0};
+    int i = 0;
+    int rem = size % 4;
+    TacsScalar *y = x;
+    TacsScalar *z = vec->x;
+
+    for (; i < rem; i++) {
+      res[0] += y[0] * z[0];
+      res[1] += y[0] * y[0];
+      y++;
+      z++;
+    }
+
+    for (; i < size; i += 4) {
+      res[0] += y[0] * z[0] + y[1] * z[1] + y[2] * z[2] + y[3] * z[3];
+      res[1] += y[0] * y[0] + y[1] * y[1] + y[2] * y[2] + y[3] * y[3];
+      y += 4;
+      z += 4;
+    }
+
+    sum[0] = res[0];
+    sum[1] = res[1];
+    TacsScalarAllreduce(comm, sum, 2);
+  } else {
+    fprintf(stderr, "TACSBVec type error: Input must be TACSBVec\n");
+  }
+
+  TacsAddFlops(4 * size);
+
+  *xdot = sum[0];
+  *nrm = sqrt(sum[1]);
+}
+
 /*
   Copy the values x <- vec->x
 */
@@ -400,9 +679,15 @@ void TACSBVec::copyValues(TACSVec *tvec) {
     BLAScopy(&size, vec->x, &one, x, &one);
 
     // Copy the external nodes and dependent nodes only if this
-    // vector and the source share the same objects
-    if (x_ext && vec->x_ext && ext_dist == vec->ext_dist) {
-      BLAScopy(&ext_size, vec->x_ext, &one, x_ext, &one);
+    // vector and the source share the same objects. A source with no
+    // materialized ghost storage is equivalent to zero ghost values.
+    if (ext_dist && ext_dist == vec->ext_dist) {
+      if (vec->x_ext) {
+        initExtArray();
+        BLAScopy(&ext_size, vec->x_ext, &one, x_ext, &one);
+      } else if (x_ext) {
+        memset(x_ext, 0, ext_size * sizeof(TacsScalar));
+      }
     }
     if (x_dep && vec->x_dep && dep_nodes == vec->dep_nodes) {
       BLAScopy(&dep_size, vec->x_dep, &one, x_dep, &one);
@@ -511,10 +796,14 @@ int TACSBVec::getDepArray(TacsScalar **array) {
 }
 
 /*
-  Retrieve the external values stored on this processor
+  Retrieve the external values stored on this processor.
+
+  Requesting the array counts as a ghost access and materializes the
+  storage.
 */
 int TACSBVec::getExtArray(TacsScalar **array) {
   if (array) {
+    initExtArray();
     *array = x_ext;
   }
   return ext_size;
@@ -559,12 +848,12 @@ void TACSBVec::applyBCs(TACSBcMap *bcmap, TACSVec *tvec) {
     const int *owner_range;
     node_map->getOwnerRange(&owner_range);
 
-    // Get the values from the boundary condition arrays
-    const int *nodes, *vars;
-    TacsScalar *values;
-    int nbcs = bcmap->getBCs(&nodes, &vars, &values);
-
     if (uvals) {
+      // Get the values from the boundary condition arrays
+      const int *nodes, *vars;
+      TacsScalar *values;
+      int nbcs = bcmap->getBCs(&nodes, &vars, &values);
+
       for (int i = 0; i < nbcs; i++) {
         if (nodes[i] >= owner_range[mpi_rank] &&
             nodes[i] < owner_range[mpi_rank + 1]) {
@@ -578,14 +867,36 @@ void TACSBVec::applyBCs(TACSBcMap *bcmap, TACSVec *tvec) {
         }
       }
     } else {
-      for (int i = 0; i < nbcs; i++) {
-        if (nodes[i] >= owner_range[mpi_rank] &&
-            nodes[i] < owner_range[mpi_rank + 1]) {
-          int var = bsize * (nodes[i] - owner_range[mpi_rank]);
-          for (int k = 0; k < bsize; k++) {
-            if (vars[i] & (1 << k)) {
-              // Scan through the rows to be zeroed
-              x[var + k] = 0.0;
+      // Zero the boundary condition entries using the
+      // run-length-encoded ranges so that fully clamped nodes are
+      // handled with contiguous memsets
+      const int *range_nodes, *range_counts, *range_vars;
+      int nranges =
+          bcmap->getBCRanges(&range_nodes, &range_counts, &range_vars);
+
+      const int full_mask = (1 << bsize) - 1;
+      for (int i = 0; i < nranges; i++) {
+        // Clip the range against the ownership interval
+        int start = range_nodes[i];
+        int end = range_nodes[i] + range_counts[i];
+        if (start < owner_range[mpi_rank]) {
+          start = owner_range[mpi_rank];
+        }
+        if (end > owner_range[mpi_rank + 1]) {
+          end = owner_range[mpi_rank + 1];
+        }
+
+        if (start < end) {
+          int var = bsize * (start - owner_range[mpi_rank]);
+          if (range_vars[i] == full_mask) {
+            memset(&x[var], 0, bsize * (end - start) * sizeof(TacsScalar));
+          } else {
+            for (int j = start; j < end; j++, var += bsize) {
+              for (int k = 0; k < bsize; k++) {
+                if (range_vars[i] & (1 << k)) {
+                  x[var + k] = 0.0;
+                }
+              }
             }
           }
         }
@@ -815,6 +1126,8 @@ void TACSBVec::setValues(int n, const int *index, const TacsScalar *vals,
         }
       }
     } else {
+      // Writing a ghost entry materializes the external storage
+      initExtArray();
       int ext_index = bsize * ext_indices->findIndex(index[i]);
       TacsScalar *y = &x_ext[ext_index];
 
@@ -844,6 +1157,11 @@ void TACSBVec::setValues(int n, const int *index, const TacsScalar *vals,
   Begin collecting the vector values to their owners
 */
 void TACSBVec::beginSetValues(TACSBVecOperation op) {
+  // The reverse exchange is symmetric across processors, so the
+  // external storage must exist even if no ghost entry was written
+  // locally - the unwritten values contribute zero
+  initExtArray();
+
   // Get the MPI rank
   int rank;
   MPI_Comm_rank(comm, &rank);
@@ -913,6 +1231,8 @@ void TACSBVec::endSetValues(TACSBVecOperation op) {
 */
 void TACSBVec::beginDistributeValues() {
   if (ext_dist) {
+    // Distributing values is a ghost access
+    initExtArray();
     ext_dist->beginForward(ext_ctx, x, x_ext);
   }
 }
@@ -1020,16 +1340,102 @@ int TACSBVec::getValues(int n, const int *index, TacsScalar *vals) {
       }
     } else {
       int ext_index = bsize * ext_indices->findIndex(index[i]);
-      TacsScalar *y = &x_ext[ext_index];
 
       if (ext_index >= 0) {
-        // Add the values to the array
-        for (int k = 0; k < bsize; k++, vals++, y++) {
-          vals[0] = y[0];
+        if (x_ext) {
+          // Add the values to the array
+          TacsScalar *y = &x_ext[ext_index];
+          for (int k = 0; k < bsize; k++, vals++, y++) {
+            vals[0] = y[0];
+          }
+        } else {
+          // Unmaterialized ghost storage reads as zero
+          for (int k = 0; k < bsize; k++, vals++) {
+            vals[0] = 0.0;
+          }
+        }
+      } else {
+        fail = 1;
+      }
+    }
+  }
+
+  return fail;
+}
+
+/*
+  Get the values of all block components at the specified nodes as a
+  single blocked gather.
+
+  This is equivalent to getValues(), but consecutive locally owned
+  nodes in the index list are detected and copied as one contiguous
+  streaming operation of bsize*run scalars, rather than resolving the
+  ownership of every node separately. Element node lists produced by
+  the matrix reordering are largely runs of consecutive node numbers,
+  so the gather for a multi-component (e.g. coupled thermoelastic)
+  element reduces to a few block copies into the element-layout
+  staging array.
+
+  Like getValues(), this call is read-only and safe to call
+  concurrently from several threads.
+*/
+int TACSBVec::getBlockedValues(int n, const int *index, TacsScalar *vals) {
+  // Get the MPI rank
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  // Get the ownership range
+  const int *owner_range;
+  node_map->getOwnerRange(&owner_range);
+  const int lower = owner_range[rank];
+  const int upper = owner_range[rank + 1];
+
+  // Fail flag
+  int fail = 0;
+
+  // Loop over the values
+  for (int i = 0; i < n;) {
+    if (index[i] >= lower && index[i] < upper) {
+      // Extend the run of consecutive locally owned nodes
+      int len = 1;
+      while (i + len < n && index[i + len] == index[i] + len &&
+             index[i + len] < upper) {
+        len++;
+      }
+
+      // Copy the entire run of blocks in one operation
+      memcpy(vals, &x[bsize * (index[i] - lower)],
+             bsize * len * sizeof(TacsScalar));
+      vals += bsize * len;
+      i += len;
+    } else if (index[i] < 0) {
+      // Compute the dependent node
+      int dep_index = -bsize * (index[i] + 1);
+
+      // Add the values to the array
+      if (dep_index < dep_size) {
+        memcpy(vals, &x_dep[dep_index], bsize * sizeof(TacsScalar));
+      } else {
+        fail = 1;
+      }
+      vals += bsize;
+      i++;
+    } else {
+      int ext_index = bsize * ext_indices->findIndex(index[i]);
+
+      if (ext_index >= 0) {
+        if (x_ext) {
+          // Add the values to the array
+          memcpy(vals, &x_ext[ext_index], bsize * sizeof(TacsScalar));
+        } else {
+          // Unmaterialized ghost storage reads as zero
+          memset(vals, 0, bsize * sizeof(TacsScalar));
         }
       } else {
         fail = 1;
       }
+      vals += bsize;
+      i++;
     }
   }
 
@@ -1037,3 +1443,8 @@ int TACSBVec::getValues(int n, const int *index, TacsScalar *vals) {
 }
 
 const char *TACSBVec::vecName = "TACSBVec";
+
+// The counters for the ghost access tracking mode
+int TACSBVec::ghost_tracking = 0;
+int TACSBVec::num_ghost_capable = 0;
+int TACSBVec::num_ghost_materialized = 0;
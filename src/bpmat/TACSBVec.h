@@ -80,10 +80,21 @@ class TACSBVec : public TACSVec {
   void scale(TacsScalar alpha);         // Scale the vector by a value
   TacsScalar dot(TACSVec *x);           // Compute x^{T}*y
   void mdot(TACSVec **x, TacsScalar *ans, int m);  // Multiple dot product
-  void axpy(TacsScalar alpha, TACSVec *x);         // y <- y + alpha*x
+  void mdot_begin(TACSVec **x, TacsScalar *ans,
+                  int m);                    // Start a non-blocking mdot
+  void mdot_end(TacsScalar *ans, int m);     // Complete the non-blocking mdot
+  void axpy(TacsScalar alpha, TACSVec *x);   // y <- y + alpha*x
   void copyValues(TACSVec *x);                     // Copy values from x to this
   void axpby(TacsScalar alpha, TacsScalar beta,
              TACSVec *x);  // y <- alpha*x + beta*y
+
+  // Fused single-pass kernels for the Krylov methods
+  // ------------------------------------------------
+  TacsScalar axpyNorm(TacsScalar alpha, TACSVec *x);  // y += alpha*x; ||y||
+  void axpbypz(TacsScalar alpha, TACSVec *x, TacsScalar beta,
+               TACSVec *y);  // z <- z + alpha*x + beta*y
+  void dotNorm(TACSVec *x, TacsScalar *xdot,
+               TacsScalar *nrm);  // <y,x> and ||y||
   void applyBCs(TACSBcMap *map, TACSVec *vec = NULL);
   void setBCs(TACSBcMap *map);
 
@@ -109,27 +120,42 @@ class TACSBVec : public TACSVec {
   TACSBVecDistribute *getBVecDistribute();
   TACSBVecDepNodes *getBVecDepNodes();
 
-  // Add/set the values from the array
-  // ---------------------------------
+  // Add/set the values from the array. Concurrent calls to setValues()
+  // must be serialized by the caller (or write to disjoint indices -
+  // in that case call initExtArray() first, since the lazy ghost
+  // allocation itself is not thread-safe)
+  // ------------------------------------------------------------------
+  void initExtArray();
   void setValues(int n, const int *index, const TacsScalar *vals,
                  TACSBVecOperation op);
   void beginSetValues(TACSBVecOperation op);
   void endSetValues(TACSBVecOperation op);
 
-  // Retrieve the values that have been set
-  // --------------------------------------
+  // Retrieve the values that have been set. getValues() is read-only
+  // and safe to call concurrently from several threads
+  // ----------------------------------------------------------------
   void beginDistributeValues();
   void endDistributeValues();
   int getValues(int n, const int *index, TacsScalar *vals);
+  int getBlockedValues(int n, const int *index, TacsScalar *vals);
 
   // Get the name of this object
   // ---------------------------
   const char *getObjectName();
 
+  // Track which vectors materialize their ghost/external storage
+  // ------------------------------------------------------------
+  static void setGhostAccessTracking(int flag);
+  static void getGhostAccessCounts(int *num_ghost_capable,
+                                   int *num_materialized);
+
  private:
   // The MPI communicator
   MPI_Comm comm;
 
+  // The request for an outstanding non-blocking dot product
+  MPI_Request mdot_request;
+
   // The variable map that defines the global distribution of nodes
   TACSNodeMap *node_map;
 
@@ -140,7 +166,9 @@ class TACSBVec : public TACSVec {
   int size;       // The size of the array
   TacsScalar *x;  // The entries allocated for the array
 
-  // External off-processor part (not always allocated)
+  // External off-processor part. The storage is materialized lazily
+  // on the first ghost access - many vectors never read or exchange
+  // ghost values and carry no external storage at all.
   int ext_size;
   TacsScalar *x_ext;
 
@@ -159,6 +187,11 @@ class TACSBVec : public TACSVec {
 
   // Name for the vector
   static const char *vecName;
+
+  // Counters for the ghost access tracking mode
+  static int ghost_tracking;
+  static int num_ghost_capable;
+  static int num_ghost_materialized;
 };
 
 #endif  // TACS_BVEC_H
@@ -18,6 +18,8 @@
 
 #include "TACSBVecDistribute.h"
 
+#include "TACSProfiler.h"
+
 #include "TacsUtilities.h"
 
 /*
@@ -487,22 +489,89 @@ TACSBVecDistribute::~TACSBVecDistribute() {
   rmap->decref();
 }
 
+/*
+  Check whether the neighborhood-collective exchange has been
+  requested through the environment. The result is cached after the
+  first call. Note that the value must be consistent across all
+  processes since the graph communicator creation is collective.
+*/
+static int use_neighbor_alltoall() {
+  static int use_neighbor = -1;
+  if (use_neighbor < 0) {
+    const char *env = getenv("TACS_USE_NEIGHBOR_ALLTOALL");
+    use_neighbor = (env && atoi(env) != 0) ? 1 : 0;
+  }
+  return use_neighbor;
+}
+
 /*
   Create a context
+
+  The external values are always staged through a buffer owned by the
+  context so that the communication buffers are fixed. This allows the
+  persistent send/receive requests to be created once here, and only
+  started on each subsequent forward/reverse exchange.
 */
 TACSBVecDistCtx *TACSBVecDistribute::createCtx(int bsize) {
   TACSBVecDistCtx *ctx = new TACSBVecDistCtx(this, bsize);
-  if (!sorted_flag) {
-    ctx->ext_sorted_vals = new TacsScalar[bsize * next_vars];
-  }
+  ctx->ext_sorted_vals = new TacsScalar[bsize * next_vars];
   ctx->reqvals = new TacsScalar[bsize * req_ptr[n_req_proc]];
 
-  // Allocate space for the send/recevies
-  if (n_req_proc > 0) {
-    ctx->sends = new MPI_Request[n_req_proc];
+#if MPI_VERSION >= 3
+  if (use_neighbor_alltoall()) {
+    // Create the distributed graph communicators for each direction.
+    // In the forward direction data is sent to the requesting
+    // processes and received from the owners of the external values;
+    // the reverse direction swaps the edges.
+    MPI_Dist_graph_create_adjacent(comm, n_ext_proc, ext_proc, MPI_UNWEIGHTED,
+                                   n_req_proc, req_proc, MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL, 0, &ctx->fwd_graph);
+    MPI_Dist_graph_create_adjacent(comm, n_req_proc, req_proc, MPI_UNWEIGHTED,
+                                   n_ext_proc, ext_proc, MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL, 0, &ctx->rev_graph);
+
+    // Set the counts/displacements in scalar units for this block size
+    ctx->send_counts = new int[n_req_proc];
+    ctx->send_displs = new int[n_req_proc];
+    for (int i = 0; i < n_req_proc; i++) {
+      ctx->send_counts[i] = bsize * req_count[i];
+      ctx->send_displs[i] = bsize * req_ptr[i];
+    }
+    ctx->recv_counts = new int[n_ext_proc];
+    ctx->recv_displs = new int[n_ext_proc];
+    for (int i = 0; i < n_ext_proc; i++) {
+      ctx->recv_counts[i] = bsize * ext_count[i];
+      ctx->recv_displs[i] = bsize * ext_ptr[i];
+    }
+
+    return ctx;
   }
-  if (n_ext_proc > 0) {
-    ctx->recvs = new MPI_Request[n_ext_proc];
+#endif  // MPI_VERSION >= 3
+
+  // Create the persistent requests bound to the context buffers
+  ctx->nreqs = n_req_proc + n_ext_proc;
+  if (ctx->nreqs > 0) {
+    ctx->fwd_reqs = new MPI_Request[ctx->nreqs];
+    ctx->rev_reqs = new MPI_Request[ctx->nreqs];
+
+    for (int i = 0; i < n_req_proc; i++) {
+      int dest = req_proc[i];
+      int start = bsize * req_ptr[i];
+      int size = bsize * req_count[i];
+      MPI_Send_init(&ctx->reqvals[start], size, TACS_MPI_TYPE, dest,
+                    ctx->ctx_tag, comm, &ctx->fwd_reqs[i]);
+      MPI_Recv_init(&ctx->reqvals[start], size, TACS_MPI_TYPE, dest,
+                    ctx->ctx_tag, comm, &ctx->rev_reqs[n_ext_proc + i]);
+    }
+    for (int i = 0; i < n_ext_proc; i++) {
+      int dest = ext_proc[i];
+      int start = bsize * ext_ptr[i];
+      int size = bsize * ext_count[i];
+      MPI_Recv_init(&ctx->ext_sorted_vals[start], size, TACS_MPI_TYPE, dest,
+                    ctx->ctx_tag, comm, &ctx->fwd_reqs[n_req_proc + i]);
+      MPI_Send_init(&ctx->ext_sorted_vals[start], size, TACS_MPI_TYPE, dest,
+                    ctx->ctx_tag, comm, &ctx->rev_reqs[i]);
+    }
   }
 
   return ctx;
@@ -552,8 +621,6 @@ void TACSBVecDistribute::beginForward(TACSBVecDistCtx *ctx, TacsScalar *global,
   int bsize = ctx->bsize;
   TacsScalar *reqvals = ctx->reqvals;
   TacsScalar *ext_sorted_vals = ctx->ext_sorted_vals;
-  MPI_Request *sends = ctx->sends;
-  MPI_Request *recvs = ctx->recvs;
 
   // Get the rank/size
   int mpi_rank;
@@ -573,45 +640,30 @@ void TACSBVecDistribute::beginForward(TACSBVecDistCtx *ctx, TacsScalar *global,
   bgetvars(bsize, req_ptr[n_req_proc], req_vars, lower, global, reqvals,
            TACS_INSERT_VALUES);
 
-  for (int i = 0; i < n_req_proc; i++) {
-    // Initiate the sends and receives
-    int dest = req_proc[i];
-    int start = bsize * req_ptr[i];
-    int size = bsize * req_count[i];
-    MPI_Isend(&reqvals[start], size, TACS_MPI_TYPE, dest, ctx->ctx_tag, comm,
-              &sends[i]);
-  }
-
   if (sorted_flag) {
-    // Copy over the local values
+    // Copy over the local values directly into place
     bgetvars(bsize, ext_self_count, &ext_vars[ext_self_ptr], lower, global,
              &local[bsize * ext_self_ptr], TACS_INSERT_VALUES);
-
-    // If the receiving array is sorted, it can be placed directly
-    // into local array
-    for (int i = 0; i < n_ext_proc; i++) {
-      int dest = ext_proc[i];
-      int start = bsize * ext_ptr[i];
-      int size = bsize * ext_count[i];
-
-      MPI_Irecv(&local[start], size, TACS_MPI_TYPE, dest, ctx->ctx_tag, comm,
-                &recvs[i]);
-    }
   } else {
-    // Copy the local values first
+    // Copy the local values into the sorted staging array
     bgetvars(bsize, ext_self_count, &ext_vars[ext_self_ptr], lower, global,
              &ext_sorted_vals[bsize * ext_self_ptr], TACS_INSERT_VALUES);
+  }
 
-    // If the receiving array is not sorted, the data must
-    // first be placed in a receiving array
-    for (int i = 0; i < n_ext_proc; i++) {
-      int dest = ext_proc[i];
-      int start = bsize * ext_ptr[i];
-      int size = bsize * ext_count[i];
+#if MPI_VERSION >= 3
+  if (ctx->fwd_graph != MPI_COMM_NULL) {
+    // Start the neighborhood-collective exchange
+    MPI_Ineighbor_alltoallv(reqvals, ctx->send_counts, ctx->send_displs,
+                            TACS_MPI_TYPE, ext_sorted_vals, ctx->recv_counts,
+                            ctx->recv_displs, TACS_MPI_TYPE, ctx->fwd_graph,
+                            &ctx->nbr_req);
+    return;
+  }
+#endif  // MPI_VERSION >= 3
 
-      MPI_Irecv(&ext_sorted_vals[start], size, TACS_MPI_TYPE, dest,
-                ctx->ctx_tag, comm, &recvs[i]);
-    }
+  // Start the persistent sends and receives
+  if (ctx->nreqs > 0) {
+    MPI_Startall(ctx->nreqs, ctx->fwd_reqs);
   }
 }
 
@@ -626,10 +678,30 @@ void TACSBVecDistribute::endForward(TACSBVecDistCtx *ctx, TacsScalar *global,
   }
 
   // Finalize the sends and receives
-  MPI_Waitall(n_req_proc, ctx->sends, MPI_STATUSES_IGNORE);
-  MPI_Waitall(n_ext_proc, ctx->recvs, MPI_STATUSES_IGNORE);
+  double twait = MPI_Wtime();
+#if MPI_VERSION >= 3
+  if (ctx->fwd_graph != MPI_COMM_NULL) {
+    MPI_Wait(&ctx->nbr_req, MPI_STATUS_IGNORE);
+  } else if (ctx->nreqs > 0) {
+    MPI_Waitall(ctx->nreqs, ctx->fwd_reqs, MPI_STATUSES_IGNORE);
+  }
+#else
+  if (ctx->nreqs > 0) {
+    MPI_Waitall(ctx->nreqs, ctx->fwd_reqs, MPI_STATUSES_IGNORE);
+  }
+#endif  // MPI_VERSION >= 3
+  TacsProfileAddWait("BVecDistribute.forward", MPI_Wtime() - twait);
 
-  if (!sorted_flag) {
+  if (sorted_flag) {
+    // Copy the received values from the staging array into place
+    int bsize = ctx->bsize;
+    for (int i = 0; i < n_ext_proc; i++) {
+      int start = bsize * ext_ptr[i];
+      int size = bsize * ext_count[i];
+      memcpy(&local[start], &ctx->ext_sorted_vals[start],
+             size * sizeof(TacsScalar));
+    }
+  } else {
     // Initialize the implementation
     initImpl(ctx->bsize);
 
@@ -660,8 +732,6 @@ void TACSBVecDistribute::beginReverse(TACSBVecDistCtx *ctx, TacsScalar *local,
   int bsize = ctx->bsize;
   TacsScalar *reqvals = ctx->reqvals;
   TacsScalar *ext_sorted_vals = ctx->ext_sorted_vals;
-  MPI_Request *sends = ctx->sends;
-  MPI_Request *recvs = ctx->recvs;
 
   // Get the rank/size
   int mpi_rank;
@@ -675,38 +745,43 @@ void TACSBVecDistribute::beginReverse(TACSBVecDistCtx *ctx, TacsScalar *local,
   rmap->getOwnerRange(&owner_range);
   int lower = bsize * owner_range[mpi_rank];
 
-  // If the index array is not sorted, then allocate an array that is
-  // large enough to store the sorted external values
   if (!sorted_flag) {
-    // Copy over the values from the sorted to the unsorted array
+    // Copy over the values from the unsorted to the sorted array
     int len = bsize * next_vars;
     memset(ext_sorted_vals, 0, len * sizeof(TacsScalar));
     bsetvars(bsize, nvars_unsorted, ext_unsorted_index, 0, local,
              ext_sorted_vals, op);
     local = ext_sorted_vals;
+  } else {
+    // Copy the outgoing values into the staging array that the
+    // persistent requests are bound to
+    for (int i = 0; i < n_ext_proc; i++) {
+      int start = bsize * ext_ptr[i];
+      int size = bsize * ext_count[i];
+      memcpy(&ext_sorted_vals[start], &local[start],
+             size * sizeof(TacsScalar));
+    }
   }
 
   // Do the sends on myself
   bsetvars(bsize, ext_self_count, &ext_vars[ext_self_ptr], lower,
            &local[bsize * ext_self_ptr], global, op);
 
-  // Note that the receives/send MPI_Requests have been reversed --
-  // this is because they are allocated for the forward operation -
-  // the sizes must be reversed for the reverse operation done here
-  for (int i = 0; i < n_ext_proc; i++) {
-    int dest = ext_proc[i];
-    int start = bsize * ext_ptr[i];
-    int size = bsize * ext_count[i];
-    MPI_Isend(&local[start], size, TACS_MPI_TYPE, dest, ctx->ctx_tag, comm,
-              &recvs[i]);
+#if MPI_VERSION >= 3
+  if (ctx->rev_graph != MPI_COMM_NULL) {
+    // Start the neighborhood-collective exchange. The counts and
+    // displacements swap roles relative to the forward operation
+    MPI_Ineighbor_alltoallv(ext_sorted_vals, ctx->recv_counts,
+                            ctx->recv_displs, TACS_MPI_TYPE, reqvals,
+                            ctx->send_counts, ctx->send_displs, TACS_MPI_TYPE,
+                            ctx->rev_graph, &ctx->nbr_req);
+    return;
   }
+#endif  // MPI_VERSION >= 3
 
-  for (int i = 0; i < n_req_proc; i++) {
-    int dest = req_proc[i];
-    int start = bsize * req_ptr[i];
-    int size = bsize * req_count[i];
-    MPI_Irecv(&reqvals[start], size, TACS_MPI_TYPE, dest, ctx->ctx_tag, comm,
-              &sends[i]);
+  // Start the persistent sends and receives
+  if (ctx->nreqs > 0) {
+    MPI_Startall(ctx->nreqs, ctx->rev_reqs);
   }
 }
 
@@ -735,8 +810,19 @@ void TACSBVecDistribute::endReverse(TACSBVecDistCtx *ctx, TacsScalar *local,
   int lower = ctx->bsize * owner_range[mpi_rank];
 
   // Finalize the sends and receives
-  MPI_Waitall(n_req_proc, ctx->sends, MPI_STATUSES_IGNORE);
-  MPI_Waitall(n_ext_proc, ctx->recvs, MPI_STATUSES_IGNORE);
+  double twait = MPI_Wtime();
+#if MPI_VERSION >= 3
+  if (ctx->rev_graph != MPI_COMM_NULL) {
+    MPI_Wait(&ctx->nbr_req, MPI_STATUS_IGNORE);
+  } else if (ctx->nreqs > 0) {
+    MPI_Waitall(ctx->nreqs, ctx->rev_reqs, MPI_STATUSES_IGNORE);
+  }
+#else
+  if (ctx->nreqs > 0) {
+    MPI_Waitall(ctx->nreqs, ctx->rev_reqs, MPI_STATUSES_IGNORE);
+  }
+#endif  // MPI_VERSION >= 3
+  TacsProfileAddWait("BVecDistribute.reverse", MPI_Wtime() - twait);
 
   bsetvars(ctx->bsize, req_ptr[n_req_proc], req_vars, lower, ctx->reqvals,
            global, op);
@@ -1332,21 +1418,53 @@ TACSBVecDistCtx::~TACSBVecDistCtx() {
   if (reqvals) {
     delete[] reqvals;
   }
-  if (sends) {
-    delete[] sends;
+
+  // Free the persistent communication requests
+  for (int i = 0; i < nreqs; i++) {
+    MPI_Request_free(&fwd_reqs[i]);
+    MPI_Request_free(&rev_reqs[i]);
+  }
+  if (fwd_reqs) {
+    delete[] fwd_reqs;
+  }
+  if (rev_reqs) {
+    delete[] rev_reqs;
+  }
+
+#if MPI_VERSION >= 3
+  if (fwd_graph != MPI_COMM_NULL) {
+    MPI_Comm_free(&fwd_graph);
+  }
+  if (rev_graph != MPI_COMM_NULL) {
+    MPI_Comm_free(&rev_graph);
+  }
+  if (send_counts) {
+    delete[] send_counts;
+    delete[] send_displs;
   }
-  if (recvs) {
-    delete[] recvs;
+  if (recv_counts) {
+    delete[] recv_counts;
+    delete[] recv_displs;
   }
+#endif  // MPI_VERSION >= 3
 }
 
 TACSBVecDistCtx::TACSBVecDistCtx(TACSBVecDistribute *_me, int _bsize) {
+  TacsAddAllocs(1);
   bsize = _bsize;
   me = _me;
   ext_sorted_vals = NULL;
   reqvals = NULL;
-  sends = NULL;
-  recvs = NULL;
+  nreqs = 0;
+  fwd_reqs = NULL;
+  rev_reqs = NULL;
+
+#if MPI_VERSION >= 3
+  fwd_graph = MPI_COMM_NULL;
+  rev_graph = MPI_COMM_NULL;
+  send_counts = send_displs = NULL;
+  recv_counts = recv_displs = NULL;
+#endif  // MPI_VERSION >= 3
 
   // Set the tag values
   ctx_tag = tag_value;
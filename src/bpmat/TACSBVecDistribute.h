@@ -179,6 +179,14 @@ class TACSBVecDistribute : public TACSObject {
   Context for the distribute vector class. Note that this class can
   only be created by the TACSBVecDistribute class itself so that the
   data is allocated correctly.
+
+  The context owns the communication buffers so that the persistent
+  send/receive requests can be bound to them once, when the context is
+  created, rather than setting up new requests on every exchange. When
+  the environment variable TACS_USE_NEIGHBOR_ALLTOALL is set to a
+  non-zero value (and MPI-3 is available), the point-to-point exchange
+  is replaced by a nonblocking neighborhood collective on a distributed
+  graph communicator, which can be faster on topology-aware networks.
 */
 class TACSBVecDistCtx : public TACSObject {
  public:
@@ -193,15 +201,26 @@ class TACSBVecDistCtx : public TACSObject {
   // Pointer to ensure the context is used correctly
   TACSBVecDistribute *me;
 
-  // The external data sorted
+  // The external values staged for communication
   TacsScalar *ext_sorted_vals;
 
   // The requested values
   TacsScalar *reqvals;
 
-  // The MPI requests for either the sends or recvs
-  MPI_Request *sends;
-  MPI_Request *recvs;
+  // The persistent requests for the sends/recvs in each direction
+  int nreqs;
+  MPI_Request *fwd_reqs;
+  MPI_Request *rev_reqs;
+
+#if MPI_VERSION >= 3
+  // Optional neighborhood-collective exchange: graph communicators
+  // for each direction and the counts/displacements in scalar units
+  MPI_Comm fwd_graph;
+  MPI_Comm rev_graph;
+  int *send_counts, *send_displs;
+  int *recv_counts, *recv_displs;
+  MPI_Request nbr_req;
+#endif  // MPI_VERSION >= 3
 
   // Set the send and recv tags
   int ctx_tag;
@@ -35,6 +35,14 @@ void BVecInterpMultTransposeAddGen(int bsize, int nrows, const int *rowp,
                                    const int *cols, const TacsScalar *weights,
                                    const TacsScalar *x, TacsScalar *y);
 
+void BVecInterpMultAddMulti(int bsize, int nrows, const int *rowp,
+                            const int *cols, const TacsScalar *weights,
+                            int nvecs, TacsScalar **x, TacsScalar **y);
+void BVecInterpMultTransposeAddMulti(int bsize, int nrows, const int *rowp,
+                                     const int *cols,
+                                     const TacsScalar *weights, int nvecs,
+                                     TacsScalar **x, TacsScalar **y);
+
 void BVecInterpMultAdd1(int bsize, int nrows, const int *rowp, const int *cols,
                         const TacsScalar *weights, const TacsScalar *x,
                         TacsScalar *y);
@@ -169,6 +177,9 @@ void TACSBVecInterp::init(TACSNodeMap *_inMap, TACSNodeMap *_outMap,
   // For now, set the interpolation data to null
   vecDist = NULL;
   ctx = NULL;
+  num_multi_ctx = 0;
+  multi_ctx = NULL;
+  x_ext_multi = NULL;
   rowp = NULL;
   cols = NULL;
   weights = NULL;
@@ -272,6 +283,15 @@ TACSBVecInterp::~TACSBVecInterp() {
   if (ctx) {
     ctx->decref();
   }
+  if (multi_ctx) {
+    for (int k = 0; k < num_multi_ctx; k++) {
+      multi_ctx[k]->decref();
+    }
+    delete[] multi_ctx;
+  }
+  if (x_ext_multi) {
+    delete[] x_ext_multi;
+  }
   if (rowp) {
     delete[] rowp;
   }
@@ -1223,6 +1243,269 @@ void TACSBVecInterp::multTransposeAdd(TACSBVec *inVec, TACSBVec *addVec,
   vecDist->endReverse(ctx, x_ext, out, TACS_ADD_VALUES);
 }
 
+/*
+  Reserve the communication contexts and external buffers needed to
+  apply the interpolation to nvecs vectors simultaneously. The contexts
+  are retained and re-used by subsequent multi-vector operations.
+*/
+void TACSBVecInterp::reserveMultiCtx(int nvecs) {
+  if (nvecs > num_multi_ctx) {
+    TACSBVecDistCtx **tmp = new TACSBVecDistCtx *[nvecs];
+    for (int k = 0; k < num_multi_ctx; k++) {
+      tmp[k] = multi_ctx[k];
+    }
+    for (int k = num_multi_ctx; k < nvecs; k++) {
+      tmp[k] = vecDist->createCtx(bsize);
+      tmp[k]->incref();
+    }
+    if (multi_ctx) {
+      delete[] multi_ctx;
+    }
+    multi_ctx = tmp;
+    num_multi_ctx = nvecs;
+
+    if (x_ext_multi) {
+      delete[] x_ext_multi;
+    }
+    x_ext_multi = new TacsScalar[nvecs * bsize * num_ext_vars];
+  }
+}
+
+/*
+  Perform the interpolation for several vectors simultaneously:
+
+  Interp*inVec[n] -> outVec[n]
+
+  The on- and off-processor products stream the interpolation weights
+  once for the whole set of vectors, and the forward communication for
+  all of the vectors proceeds concurrently.
+
+  input:
+  nvecs:   the number of vectors
+  inVecs:  the input vectors
+
+  output:
+  outVecs: the interpolated output vectors
+*/
+void TACSBVecInterp::mult(int nvecs, TACSBVec **inVecs, TACSBVec **outVecs) {
+  if (!vecDist) {
+    fprintf(stderr,
+            "Must call initialize() before using TACSBVecInterp object\n");
+    return;
+  }
+  if (nvecs <= 0) {
+    return;
+  }
+  reserveMultiCtx(nvecs);
+
+  TacsScalar **in = new TacsScalar *[nvecs];
+  TacsScalar **out = new TacsScalar *[nvecs];
+  TacsScalar **xe = new TacsScalar *[nvecs];
+  for (int n = 0; n < nvecs; n++) {
+    // Zero the entries and start the off-processor communication
+    outVecs[n]->zeroEntries();
+    inVecs[n]->getArray(&in[n]);
+    outVecs[n]->getArray(&out[n]);
+    xe[n] = &x_ext_multi[n * bsize * num_ext_vars];
+    vecDist->beginForward(multi_ctx[n], in[n], xe[n]);
+  }
+
+  // Multiply the on-processor part for all of the vectors
+  BVecInterpMultAddMulti(bsize, N, rowp, cols, weights, nvecs, in, out);
+
+  // Finish the off-processor communication
+  for (int n = 0; n < nvecs; n++) {
+    vecDist->endForward(multi_ctx[n], in[n], xe[n]);
+  }
+
+  // Multiply the off-processor part for all of the vectors
+  BVecInterpMultAddMulti(bsize, N, ext_rowp, ext_cols, ext_weights, nvecs, xe,
+                         out);
+
+  delete[] in;
+  delete[] out;
+  delete[] xe;
+}
+
+/*
+  Perform the interpolation for several vectors simultaneously:
+
+  addVec[n] + Interp*inVec[n] -> outVec[n]
+
+  input:
+  nvecs:   the number of vectors
+  inVecs:  the input vectors
+  addVecs: the vectors to add to the output
+
+  output:
+  outVecs: the interpolated output vectors
+*/
+void TACSBVecInterp::multAdd(int nvecs, TACSBVec **inVecs, TACSBVec **addVecs,
+                             TACSBVec **outVecs) {
+  if (!vecDist) {
+    fprintf(stderr,
+            "Must call initialize() before using TACSBVecInterp object\n");
+    return;
+  }
+  if (nvecs <= 0) {
+    return;
+  }
+  reserveMultiCtx(nvecs);
+
+  TacsScalar **in = new TacsScalar *[nvecs];
+  TacsScalar **out = new TacsScalar *[nvecs];
+  TacsScalar **xe = new TacsScalar *[nvecs];
+  for (int n = 0; n < nvecs; n++) {
+    // Copy the values to the output and start the communication
+    if (outVecs[n] != addVecs[n]) {
+      outVecs[n]->copyValues(addVecs[n]);
+    }
+    inVecs[n]->getArray(&in[n]);
+    outVecs[n]->getArray(&out[n]);
+    xe[n] = &x_ext_multi[n * bsize * num_ext_vars];
+    vecDist->beginForward(multi_ctx[n], in[n], xe[n]);
+  }
+
+  // Multiply the on-processor part for all of the vectors
+  BVecInterpMultAddMulti(bsize, N, rowp, cols, weights, nvecs, in, out);
+
+  // Finish the off-processor communication
+  for (int n = 0; n < nvecs; n++) {
+    vecDist->endForward(multi_ctx[n], in[n], xe[n]);
+  }
+
+  // Multiply the off-processor part for all of the vectors
+  BVecInterpMultAddMulti(bsize, N, ext_rowp, ext_cols, ext_weights, nvecs, xe,
+                         out);
+
+  delete[] in;
+  delete[] out;
+  delete[] xe;
+}
+
+/*
+  Perform the transpose interpolation for several vectors
+  simultaneously:
+
+  Interp^{T}*inVec[n] -> outVec[n]
+
+  input:
+  nvecs:   the number of vectors
+  inVecs:  the input vectors
+
+  output:
+  outVecs: the interpolated output vectors
+*/
+void TACSBVecInterp::multTranspose(int nvecs, TACSBVec **inVecs,
+                                   TACSBVec **outVecs) {
+  if (!vecDist) {
+    fprintf(stderr,
+            "Must call initialize() before using TACSBVecInterp object\n");
+    return;
+  }
+  if (nvecs <= 0) {
+    return;
+  }
+  reserveMultiCtx(nvecs);
+
+  TacsScalar **in = new TacsScalar *[nvecs];
+  TacsScalar **out = new TacsScalar *[nvecs];
+  TacsScalar **xe = new TacsScalar *[nvecs];
+  for (int n = 0; n < nvecs; n++) {
+    outVecs[n]->zeroEntries();
+    inVecs[n]->getArray(&in[n]);
+    outVecs[n]->getArray(&out[n]);
+    xe[n] = &x_ext_multi[n * bsize * num_ext_vars];
+  }
+
+  // Zero the off-processor contributions and multiply the
+  // off-processor part for all of the vectors first
+  memset(x_ext_multi, 0, nvecs * bsize * num_ext_vars * sizeof(TacsScalar));
+  BVecInterpMultTransposeAddMulti(bsize, N, ext_rowp, ext_cols, ext_weights,
+                                  nvecs, in, xe);
+
+  // Start the communication of the off-processor parts
+  for (int n = 0; n < nvecs; n++) {
+    vecDist->beginReverse(multi_ctx[n], xe[n], out[n], TACS_ADD_VALUES);
+  }
+
+  // Multiply the on-processor part for all of the vectors
+  BVecInterpMultTransposeAddMulti(bsize, N, rowp, cols, weights, nvecs, in,
+                                  out);
+
+  // Finalize the communication of the off-processor parts
+  for (int n = 0; n < nvecs; n++) {
+    vecDist->endReverse(multi_ctx[n], xe[n], out[n], TACS_ADD_VALUES);
+  }
+
+  delete[] in;
+  delete[] out;
+  delete[] xe;
+}
+
+/*
+  Perform the transpose interpolation for several vectors
+  simultaneously:
+
+  addVec[n] + Interp^{T}*inVec[n] -> outVec[n]
+
+  input:
+  nvecs:   the number of vectors
+  inVecs:  the input vectors
+  addVecs: the vectors to add to the output
+
+  output:
+  outVecs: the interpolated output vectors
+*/
+void TACSBVecInterp::multTransposeAdd(int nvecs, TACSBVec **inVecs,
+                                      TACSBVec **addVecs, TACSBVec **outVecs) {
+  if (!vecDist) {
+    fprintf(stderr,
+            "Must call initialize() before using TACSBVecInterp object\n");
+    return;
+  }
+  if (nvecs <= 0) {
+    return;
+  }
+  reserveMultiCtx(nvecs);
+
+  TacsScalar **in = new TacsScalar *[nvecs];
+  TacsScalar **out = new TacsScalar *[nvecs];
+  TacsScalar **xe = new TacsScalar *[nvecs];
+  for (int n = 0; n < nvecs; n++) {
+    if (outVecs[n] != addVecs[n]) {
+      outVecs[n]->copyValues(addVecs[n]);
+    }
+    inVecs[n]->getArray(&in[n]);
+    outVecs[n]->getArray(&out[n]);
+    xe[n] = &x_ext_multi[n * bsize * num_ext_vars];
+  }
+
+  // Zero the off-processor contributions and multiply the
+  // off-processor part for all of the vectors first
+  memset(x_ext_multi, 0, nvecs * bsize * num_ext_vars * sizeof(TacsScalar));
+  BVecInterpMultTransposeAddMulti(bsize, N, ext_rowp, ext_cols, ext_weights,
+                                  nvecs, in, xe);
+
+  // Start the communication of the off-processor parts
+  for (int n = 0; n < nvecs; n++) {
+    vecDist->beginReverse(multi_ctx[n], xe[n], out[n], TACS_ADD_VALUES);
+  }
+
+  // Multiply the on-processor part for all of the vectors
+  BVecInterpMultTransposeAddMulti(bsize, N, rowp, cols, weights, nvecs, in,
+                                  out);
+
+  // Finalize the communication of the off-processor parts
+  for (int n = 0; n < nvecs; n++) {
+    vecDist->endReverse(multi_ctx[n], xe[n], out[n], TACS_ADD_VALUES);
+  }
+
+  delete[] in;
+  delete[] out;
+  delete[] xe;
+}
+
 /*
   Perform the weighted transpose interpolation
 
@@ -1793,19 +2076,51 @@ void TACSBVecInterp::computeGalerkin(TACSParallelMat *Afine,
   // Block size squred
   int b2 = bsize * bsize;
 
+  // Get the non-zero pattern of the external part of the matrix
+  int nBrows;
+  const int *Browp, *Bcols;
+  TacsScalar *Bvals;
+  B->getArrays(&bsize, &nBrows, NULL, &Browp, &Bcols, &Bvals);
+
+  // Compute the maximum number of block entries within any fine row
+  int max_row_nnz = 0;
+  for (int i = 0; i < nArows; i++) {
+    if (Arowp[i + 1] - Arowp[i] > max_row_nnz) {
+      max_row_nnz = Arowp[i + 1] - Arowp[i];
+    }
+  }
+  for (int i = 0; i < nBrows; i++) {
+    if (Browp[i + 1] - Browp[i] > max_row_nnz) {
+      max_row_nnz = Browp[i + 1] - Browp[i];
+    }
+  }
+
   // Allocate space
   int max_size = getMaxRowSize();
   int *row_entries = new int[max_size];
   TacsScalar *row_weights = new TacsScalar[max_size];
   int *col_entries = new int[max_size];
   TacsScalar *col_weights = new TacsScalar[max_size];
-  TacsScalar *values = new TacsScalar[b2 * max_size * max_size];
 
-  // Loop over all the entries in the A matrix
+  // Space to accumulate the contribution from an entire fine row:
+  // the union of the coarse columns and the associated values. The
+  // accumulated values are stored with the fixed row stride m so
+  // that the same buffer can be used as the column union grows.
+  int max_cols = max_size * max_row_nnz;
+  int m = bsize * max_cols;
+  int *union_cols = new int[max_cols];
+  TacsScalar *values = new TacsScalar[b2 * max_size * max_cols];
+
+  // Loop over all the entries in the A matrix. The contribution
+  // P[i]^{T}*A[i,:]*P from each fine row is accumulated into a
+  // single block of values so that the coarse matrix is updated
+  // once per fine row, rather than once per fine non-zero
   for (int i = 0; i < nArows; i++) {
     int row = i + range[rank];
     int num_row_entries = getRow(row, row_entries, row_weights);
+    int n = bsize * num_row_entries;
 
+    int num_cols = 0;
     for (int jp = Arowp[i]; jp < Arowp[i + 1]; jp++) {
       int col = Acols[jp] + range[rank];
 
@@ -1814,31 +2129,39 @@ void TACSBVecInterp::computeGalerkin(TACSParallelMat *Afine,
       // Get the row and column entries for the matrix
       int num_col_entries = getRow(col, col_entries, col_weights);
 
-      // Set the row weights and values
-      int n = bsize * num_row_entries;
-      int m = bsize * num_col_entries;
-      for (int ii = 0; ii < num_row_entries; ii++) {
-        for (int jj = 0; jj < num_col_entries; jj++) {
+      for (int jj = 0; jj < num_col_entries; jj++) {
+        // Find the coarse column in the union, or append and zero a
+        // new column of the values
+        int index = 0;
+        while (index < num_cols && union_cols[index] != col_entries[jj]) {
+          index++;
+        }
+        if (index == num_cols) {
+          union_cols[num_cols] = col_entries[jj];
+          for (int ib = 0; ib < n; ib++) {
+            memset(&values[ib * m + bsize * index], 0,
+                   bsize * sizeof(TacsScalar));
+          }
+          num_cols++;
+        }
+
+        // Add the weighted contribution to the values
+        for (int ii = 0; ii < num_row_entries; ii++) {
+          TacsScalar w = row_weights[ii] * col_weights[jj];
           for (int ib = 0; ib < bsize; ib++) {
             for (int jb = 0; jb < bsize; jb++) {
-              values[(bsize * ii + ib) * m + (bsize * jj + jb)] =
-                  row_weights[ii] * col_weights[jj] * a[ib * bsize + jb];
+              values[(bsize * ii + ib) * m + (bsize * index + jb)] +=
+                  w * a[ib * bsize + jb];
             }
           }
         }
       }
-
-      // Add the values
-      Acoarse->addValues(num_row_entries, row_entries, num_col_entries,
-                         col_entries, n, m, values);
     }
-  }
 
-  // Loop over all the entries in the external part of the matrix
-  int nBrows;
-  const int *Browp, *Bcols;
-  TacsScalar *Bvals;
-  B->getArrays(&bsize, &nBrows, NULL, &Browp, &Bcols, &Bvals);
+    // Add the accumulated values for this fine row
+    Acoarse->addValues(num_row_entries, row_entries, num_cols, union_cols, n,
+                       m, values);
+  }
 
   // Get the indices of the external unknowns
   TACSBVecDistribute *ext_map;
@@ -1855,40 +2178,56 @@ void TACSBVecInterp::computeGalerkin(TACSParallelMat *Afine,
     // Compute the row index
     int row = (i + Na - Na_coupled) + range[rank];
     int num_row_entries = getRow(row, row_entries, row_weights);
+    int n = bsize * num_row_entries;
 
+    int num_cols = 0;
     for (int jp = Browp[i]; jp < Browp[i + 1]; jp++) {
       int col = ext_indices[Bcols[jp]];
 
+      const TacsScalar *a = &Bvals[b2 * jp];
+
       // Get the row and column entries for the matrix
       int num_col_entries = getRow(col, col_entries, col_weights);
 
-      // Set the contribution for this entry
-      const TacsScalar *a = &Bvals[b2 * jp];
+      for (int jj = 0; jj < num_col_entries; jj++) {
+        // Find the coarse column in the union, or append and zero a
+        // new column of the values
+        int index = 0;
+        while (index < num_cols && union_cols[index] != col_entries[jj]) {
+          index++;
+        }
+        if (index == num_cols) {
+          union_cols[num_cols] = col_entries[jj];
+          for (int ib = 0; ib < n; ib++) {
+            memset(&values[ib * m + bsize * index], 0,
+                   bsize * sizeof(TacsScalar));
+          }
+          num_cols++;
+        }
 
-      // Set the row weights and values
-      int n = bsize * num_row_entries;
-      int m = bsize * num_col_entries;
-      for (int ii = 0; ii < num_row_entries; ii++) {
-        for (int jj = 0; jj < num_col_entries; jj++) {
+        // Add the weighted contribution to the values
+        for (int ii = 0; ii < num_row_entries; ii++) {
+          TacsScalar w = row_weights[ii] * col_weights[jj];
           for (int ib = 0; ib < bsize; ib++) {
             for (int jb = 0; jb < bsize; jb++) {
-              values[(bsize * ii + ib) * m + (bsize * jj + jb)] =
-                  row_weights[ii] * col_weights[jj] * a[ib * bsize + jb];
+              values[(bsize * ii + ib) * m + (bsize * index + jb)] +=
+                  w * a[ib * bsize + jb];
             }
           }
         }
       }
-
-      // Add the values
-      Acoarse->addValues(num_row_entries, row_entries, num_col_entries,
-                         col_entries, n, m, values);
     }
+
+    // Add the accumulated values for this fine row
+    Acoarse->addValues(num_row_entries, row_entries, num_cols, union_cols, n,
+                       m, values);
   }
 
   delete[] row_entries;
   delete[] row_weights;
   delete[] col_entries;
   delete[] col_weights;
+  delete[] union_cols;
   delete[] values;
 
   Acoarse->beginAssembly();
@@ -1942,6 +2281,58 @@ void BVecInterpMultTransposeAddGen(int bsize, int nrows, const int *rowp,
   }
 }
 
+/*
+  Compute the matrix-vector product for several vectors at once.
+
+  Each interpolation weight is fetched once and applied to all of the
+  vectors, amortizing the memory traffic for the weights across the
+  set.
+*/
+void BVecInterpMultAddMulti(int bsize, int nrows, const int *rowp,
+                            const int *cols, const TacsScalar *w, int nvecs,
+                            TacsScalar **x, TacsScalar **y) {
+  for (int i = 0; i < nrows; i++) {
+    int j = rowp[i];
+    int end = rowp[i + 1];
+
+    for (; j < end; j++) {
+      for (int n = 0; n < nvecs; n++) {
+        const TacsScalar *xn = &x[n][bsize * cols[j]];
+        TacsScalar *yn = &y[n][bsize * i];
+        for (int k = 0; k < bsize; k++) {
+          yn[k] += w[0] * xn[k];
+        }
+      }
+      w++;
+    }
+  }
+}
+
+/*
+  Compute the matrix-vector transpose product for several vectors at
+  once
+*/
+void BVecInterpMultTransposeAddMulti(int bsize, int nrows, const int *rowp,
+                                     const int *cols, const TacsScalar *w,
+                                     int nvecs, TacsScalar **x,
+                                     TacsScalar **y) {
+  for (int i = 0; i < nrows; i++) {
+    int j = rowp[i];
+    int end = rowp[i + 1];
+
+    for (; j < end; j++) {
+      for (int n = 0; n < nvecs; n++) {
+        const TacsScalar *xn = &x[n][bsize * i];
+        TacsScalar *yn = &y[n][bsize * cols[j]];
+        for (int k = 0; k < bsize; k++) {
+          yn[k] += w[0] * xn[k];
+        }
+      }
+      w++;
+    }
+  }
+}
+
 /*
   Compute a matrix-vector product for bsize = 1
 */
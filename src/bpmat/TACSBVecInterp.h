@@ -80,6 +80,15 @@ class TACSBVecInterp : public TACSObject {
   void multTranspose(TACSBVec *in, TACSBVec *out);
   void multTransposeAdd(TACSBVec *in, TACSBVec *add, TACSBVec *out);
 
+  // Multi-vector variants that stream the interpolation weights once
+  // for the whole set of vectors
+  // ----------------------------------------------------------------
+  void mult(int nvecs, TACSBVec **in, TACSBVec **out);
+  void multAdd(int nvecs, TACSBVec **in, TACSBVec **add, TACSBVec **out);
+  void multTranspose(int nvecs, TACSBVec **in, TACSBVec **out);
+  void multTransposeAdd(int nvecs, TACSBVec **in, TACSBVec **add,
+                        TACSBVec **out);
+
   // Perform the weighted transpose interpolation
   // --------------------------------------------
   void multWeightTranspose(TACSBVec *in, TACSBVec *out);
@@ -154,6 +163,13 @@ class TACSBVecInterp : public TACSObject {
   // external variables
   TACSBVecDistribute *vecDist;
   TACSBVecDistCtx *ctx;
+
+  // Reserve the communication contexts and external buffers used by
+  // the multi-vector operations
+  void reserveMultiCtx(int nvecs);
+  int num_multi_ctx;
+  TACSBVecDistCtx **multi_ctx;
+  TacsScalar *x_ext_multi;
 };
 
 #endif  // TACS_BVEC_INTERP_H
@@ -76,6 +76,16 @@ TACSBlockCyclicMat::TACSBlockCyclicMat(MPI_Comm _comm, int csr_m, int csr_n,
   monitor_factor = 0;
   perm = iperm = orig_bptr = NULL;
 
+  // No precomputed assembly pattern yet
+  pattern_bsize = 0;
+  pattern_nlocal = pattern_nsend = pattern_nrecv = 0;
+  pattern_local = pattern_send_index = pattern_recv = NULL;
+  pattern_local_ptr = NULL;
+  pattern_recv_dest = NULL;
+  pattern_send_counts = pattern_send_ptr = NULL;
+  pattern_recv_counts = pattern_recv_ptr = NULL;
+  pattern_send_vals = pattern_recv_vals = NULL;
+
   int rank = 0, size = 0;
   MPI_Comm_size(comm, &size);
   MPI_Comm_rank(comm, &rank);
@@ -194,6 +204,16 @@ TACSBlockCyclicMat::TACSBlockCyclicMat(MPI_Comm _comm, int _nrows, int _ncols) {
   monitor_factor = 0;
   perm = iperm = orig_bptr = NULL;
 
+  // No precomputed assembly pattern yet
+  pattern_bsize = 0;
+  pattern_nlocal = pattern_nsend = pattern_nrecv = 0;
+  pattern_local = pattern_send_index = pattern_recv = NULL;
+  pattern_local_ptr = NULL;
+  pattern_recv_dest = NULL;
+  pattern_send_counts = pattern_send_ptr = NULL;
+  pattern_recv_counts = pattern_recv_ptr = NULL;
+  pattern_send_vals = pattern_recv_vals = NULL;
+
   int rank = 0, size = 0;
   MPI_Comm_size(comm, &size);
   MPI_Comm_rank(comm, &rank);
@@ -307,6 +327,10 @@ TACSBlockCyclicMat::~TACSBlockCyclicMat() {
     delete[] orig_bptr;
   }
 
+  // Release the factor storage from the per-process memory budget
+  TacsReleaseAllocation(((size_t)dval_size + uval_size + lval_size) *
+                        sizeof(TacsScalar));
+
   // Delete the diagonal components
   delete[] Dvals;
   delete[] dval_offset;
@@ -323,6 +347,21 @@ TACSBlockCyclicMat::~TACSBlockCyclicMat() {
   delete[] lval_offset;
   delete[] Lvals;
 
+  // Delete the precomputed assembly pattern if it was created
+  if (pattern_local) {
+    delete[] pattern_local;
+    delete[] pattern_local_ptr;
+    delete[] pattern_send_index;
+    delete[] pattern_recv;
+    delete[] pattern_recv_dest;
+    delete[] pattern_send_counts;
+    delete[] pattern_send_ptr;
+    delete[] pattern_recv_counts;
+    delete[] pattern_recv_ptr;
+    delete[] pattern_send_vals;
+    delete[] pattern_recv_vals;
+  }
+
   // Delete arrays for the back-solves
   if (lower_row_sum_count) {
     delete[] lower_row_sum_count;
@@ -859,6 +898,27 @@ void TACSBlockCyclicMat::setMonitorFactorFlag(int flag) {
   - max_ubuff_size, max_lbuff_size: Maximum size required for
   buffers during factorization
 */
+/*
+  Register a factor allocation against the per-process memory budget
+  and warn ahead of the allocation when the projection exceeds it.
+  The dense factor panels cannot degrade gracefully the way the ILU
+  level of fill can, so the warning gives the ops side a chance to
+  act before the operating system kills the rank.
+*/
+static void register_factor_alloc(MPI_Comm comm, const char *name,
+                                  size_t bytes) {
+  size_t budget = TacsGetMemoryBudget();
+  if (budget > 0 && TacsGetRegisteredMemory() + bytes > budget) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    fprintf(stderr,
+            "[%d] TACSBlockCyclicMat: %s factor storage (%zu bytes) "
+            "projected to exceed the memory budget\n",
+            rank, name, bytes);
+  }
+  TacsRegisterAllocation(bytes);
+}
+
 void TACSBlockCyclicMat::init_nz_arrays() {
   int rank;
   MPI_Comm_rank(comm, &rank);
@@ -880,6 +940,7 @@ void TACSBlockCyclicMat::init_nz_arrays() {
 
   // Allocate the diagonal values
   dval_size = dval_offset[nrows];
+  register_factor_alloc(comm, "diagonal", dval_size * sizeof(TacsScalar));
   Dvals = new TacsScalar[dval_size];
   memset(Dvals, 0, dval_size * sizeof(TacsScalar));
 
@@ -906,6 +967,7 @@ void TACSBlockCyclicMat::init_nz_arrays() {
 
   // Allocate the upper triangular components
   uval_size = uval_offset[Urowp[nrows]];
+  register_factor_alloc(comm, "upper", uval_size * sizeof(TacsScalar));
   Uvals = new TacsScalar[uval_size];
   memset(Uvals, 0, uval_size * sizeof(TacsScalar));
 
@@ -932,6 +994,7 @@ void TACSBlockCyclicMat::init_nz_arrays() {
 
   // Allocate space for the lower triangular components
   lval_size = lval_offset[Lcolp[ncols]];
+  register_factor_alloc(comm, "lower", lval_size * sizeof(TacsScalar));
   Lvals = new TacsScalar[lval_size];
   memset(Lvals, 0, lval_size * sizeof(TacsScalar));
 
@@ -1347,6 +1410,309 @@ void TACSBlockCyclicMat::addAlltoallValues(int csr_bsize, int nvars,
   delete[] recv_ptr;
 }
 
+/*
+  Precompute the index translation required to assemble the given CSR
+  non-zero pattern into the block-cyclic matrix. This function is
+  collective on all processes in the block-cyclic comm.
+
+  When the same non-zero pattern is assembled repeatedly - as in the
+  global Schur complement assembly performed on every factorization -
+  the per-entry work in addAllValues()/addAlltoallValues() is pure
+  addressing overhead: the block number searches, the owner
+  computation and the storage look-ups produce the same result every
+  time. This function performs that translation once and records, for
+  every CSR block, either the destination pointer within the local
+  storage or its slot within a persistent send buffer. The incoming
+  (i, j) index pairs are exchanged here as well, so the numeric
+  assembly in addPatternValues() sends values only.
+
+  input:
+  csr_bsize: the block size of the CSR data structure
+  csr_vars:  the global block variable associated with each CSR row
+  nvars:     the number of local CSR rows
+  csr_rowp:  the pointer into the csr_cols array
+  csr_cols:  the global block column index of each CSR entry
+*/
+void TACSBlockCyclicMat::initAssemblyPattern(int csr_bsize, int nvars,
+                                             const int *csr_vars,
+                                             const int *csr_rowp,
+                                             const int *csr_cols) {
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  int b2 = csr_bsize * csr_bsize;
+
+  // Free any previously computed pattern
+  if (pattern_local) {
+    delete[] pattern_local;
+    delete[] pattern_local_ptr;
+    delete[] pattern_send_index;
+    delete[] pattern_recv;
+    delete[] pattern_recv_dest;
+    delete[] pattern_send_counts;
+    delete[] pattern_send_ptr;
+    delete[] pattern_recv_counts;
+    delete[] pattern_recv_ptr;
+    delete[] pattern_send_vals;
+    delete[] pattern_recv_vals;
+  }
+  pattern_bsize = csr_bsize;
+
+  // Count up the number of local and off-process blocks
+  int *send_counts = new int[size];
+  memset(send_counts, 0, size * sizeof(int));
+
+  pattern_nlocal = 0;
+  for (int ip = 0; ip < nvars; ip++) {
+    int i = csr_bsize * csr_vars[ip];
+    int ib;
+    if (orig_bptr) {
+      ib = iperm[get_block_num(i, orig_bptr)];
+    } else {
+      ib = get_block_num(i, bptr);
+    }
+
+    for (int jp = csr_rowp[ip]; jp < csr_rowp[ip + 1]; jp++) {
+      int j = csr_bsize * csr_cols[jp];
+      int jb;
+      if (orig_bptr) {
+        jb = iperm[get_block_num(j, orig_bptr)];
+      } else {
+        jb = get_block_num(j, bptr);
+      }
+
+      int owner = get_block_owner(ib, jb);
+      if (owner == rank) {
+        pattern_nlocal++;
+      } else {
+        send_counts[owner]++;
+      }
+    }
+  }
+
+  // Exchange the block counts and set the send/recv pointers
+  pattern_send_counts = new int[size];
+  pattern_send_ptr = new int[size + 1];
+  pattern_recv_counts = new int[size];
+  pattern_recv_ptr = new int[size + 1];
+  MPI_Alltoall(send_counts, 1, MPI_INT, pattern_recv_counts, 1, MPI_INT,
+               comm);
+
+  pattern_send_ptr[0] = 0;
+  pattern_recv_ptr[0] = 0;
+  for (int k = 0; k < size; k++) {
+    pattern_send_ptr[k + 1] = pattern_send_ptr[k] + send_counts[k];
+    pattern_recv_ptr[k + 1] = pattern_recv_ptr[k] + pattern_recv_counts[k];
+  }
+  pattern_nsend = pattern_send_ptr[size];
+  int nrecv_slots = pattern_recv_ptr[size];
+
+  // Record the addressing of the local blocks and the send slot of
+  // every off-process block
+  pattern_local = new int[4 * pattern_nlocal];
+  pattern_local_ptr = new TacsScalar *[pattern_nlocal];
+  pattern_send_index = new int[pattern_nsend];
+  int *send_ij = new int[2 * pattern_nsend];
+
+  memset(send_counts, 0, size * sizeof(int));
+  int nlocal = 0;
+  for (int ip = 0; ip < nvars; ip++) {
+    int i = csr_bsize * csr_vars[ip];
+    int ioff, ib;
+    if (orig_bptr) {
+      ib = get_block_num(i, orig_bptr);
+      ioff = i - orig_bptr[ib];
+      ib = iperm[ib];
+    } else {
+      ib = get_block_num(i, bptr);
+      ioff = i - bptr[ib];
+    }
+
+    for (int jp = csr_rowp[ip]; jp < csr_rowp[ip + 1]; jp++) {
+      int j = csr_bsize * csr_cols[jp];
+      int joff, jb;
+      if (orig_bptr) {
+        jb = get_block_num(j, orig_bptr);
+        joff = j - orig_bptr[jb];
+        jb = iperm[jb];
+      } else {
+        jb = get_block_num(j, bptr);
+        joff = j - bptr[jb];
+      }
+
+      int owner = get_block_owner(ib, jb);
+      if (owner == rank) {
+        TacsScalar *A = get_block(rank, ib, jb);
+        if (A) {
+          pattern_local[4 * nlocal] = jp;
+          pattern_local[4 * nlocal + 1] = bptr[ib + 1] - bptr[ib];
+          pattern_local[4 * nlocal + 2] = ioff;
+          pattern_local[4 * nlocal + 3] = joff;
+          pattern_local_ptr[nlocal] = A;
+          nlocal++;
+        } else {
+          fprintf(stderr,
+                  "[%d] TACSBlockCyclicMat: Error, (%d, %d) not in "
+                  "nz-pattern\n",
+                  rank, ib, jb);
+        }
+      } else {
+        int sc = pattern_send_ptr[owner] + send_counts[owner];
+        send_counts[owner]++;
+        pattern_send_index[sc] = jp;
+        send_ij[2 * sc] = i;
+        send_ij[2 * sc + 1] = j;
+      }
+    }
+  }
+  pattern_nlocal = nlocal;
+
+  // Exchange the (i, j) indices of the incoming blocks
+  int *send_counts2 = new int[size];
+  int *send_ptr2 = new int[size];
+  int *recv_counts2 = new int[size];
+  int *recv_ptr2 = new int[size];
+  for (int k = 0; k < size; k++) {
+    send_counts2[k] = 2 * send_counts[k];
+    send_ptr2[k] = 2 * pattern_send_ptr[k];
+    recv_counts2[k] = 2 * pattern_recv_counts[k];
+    recv_ptr2[k] = 2 * pattern_recv_ptr[k];
+  }
+
+  int *recv_ij = new int[2 * nrecv_slots];
+  MPI_Alltoallv(send_ij, send_counts2, send_ptr2, MPI_INT, recv_ij,
+                recv_counts2, recv_ptr2, MPI_INT, comm);
+
+  delete[] send_counts2;
+  delete[] send_ptr2;
+  delete[] recv_counts2;
+  delete[] recv_ptr2;
+  delete[] send_counts;
+  delete[] send_ij;
+
+  // Translate the incoming indices into their destinations
+  pattern_recv = new int[4 * nrecv_slots];
+  pattern_recv_dest = new TacsScalar *[nrecv_slots];
+  int nrecv = 0;
+  for (int n = 0; n < nrecv_slots; n++) {
+    int i = recv_ij[2 * n];
+    int j = recv_ij[2 * n + 1];
+
+    int ib, jb, ioff, joff;
+    if (orig_bptr) {
+      ib = get_block_num(i, orig_bptr);
+      jb = get_block_num(j, orig_bptr);
+      ioff = i - orig_bptr[ib];
+      joff = j - orig_bptr[jb];
+      ib = iperm[ib];
+      jb = iperm[jb];
+    } else {
+      ib = get_block_num(i, bptr);
+      jb = get_block_num(j, bptr);
+      ioff = i - bptr[ib];
+      joff = j - bptr[jb];
+    }
+
+    TacsScalar *A = get_block(rank, ib, jb);
+    if (A) {
+      pattern_recv[4 * nrecv] = n;
+      pattern_recv[4 * nrecv + 1] = bptr[ib + 1] - bptr[ib];
+      pattern_recv[4 * nrecv + 2] = ioff;
+      pattern_recv[4 * nrecv + 3] = joff;
+      pattern_recv_dest[nrecv] = A;
+      nrecv++;
+    } else {
+      fprintf(stderr,
+              "[%d] TACSBlockCyclicMat: Error, (%d, %d) not in nz-pattern\n",
+              rank, ib, jb);
+    }
+  }
+  pattern_nrecv = nrecv;
+  delete[] recv_ij;
+
+  // Scale the counts and pointers to exchange the values directly
+  for (int k = 0; k < size; k++) {
+    pattern_send_counts[k] = b2 * (pattern_send_ptr[k + 1] -
+                                   pattern_send_ptr[k]);
+    pattern_recv_counts[k] = b2 * (pattern_recv_ptr[k + 1] -
+                                   pattern_recv_ptr[k]);
+    pattern_send_ptr[k] *= b2;
+    pattern_recv_ptr[k] *= b2;
+  }
+  pattern_send_ptr[size] *= b2;
+  pattern_recv_ptr[size] *= b2;
+
+  // Allocate the persistent exchange buffers
+  pattern_send_vals = new TacsScalar[b2 * pattern_nsend];
+  pattern_recv_vals = new TacsScalar[b2 * nrecv_slots];
+}
+
+/*
+  Add values into the matrix using the precomputed assembly pattern.
+  This function is collective on all processes in the block-cyclic
+  comm.
+
+  The values must be supplied in the same CSR non-zero pattern that
+  was passed to initAssemblyPattern(): the local contributions are
+  added through the precomputed destination pointers, the off-process
+  blocks are packed into the persistent send buffer in precomputed
+  order and a single MPI_Alltoallv exchanges the values without any
+  accompanying index information.
+*/
+void TACSBlockCyclicMat::addPatternValues(TacsScalar *vals) {
+  if (!pattern_local) {
+    fprintf(stderr,
+            "TACSBlockCyclicMat: Must call initAssemblyPattern() before "
+            "addPatternValues()\n");
+    return;
+  }
+
+  int csr_bsize = pattern_bsize;
+  int b2 = csr_bsize * csr_bsize;
+
+  // Add the locally-owned blocks directly into the matrix storage
+  for (int n = 0; n < pattern_nlocal; n++) {
+    const TacsScalar *a = &vals[b2 * pattern_local[4 * n]];
+    int bi = pattern_local[4 * n + 1];
+    int ioff = pattern_local[4 * n + 2];
+    int joff = pattern_local[4 * n + 3];
+    TacsScalar *A = pattern_local_ptr[n];
+
+    for (int m = 0; m < csr_bsize; m++) {
+      for (int p = 0; p < csr_bsize; p++) {
+        A[(ioff + m) + bi * (joff + p)] += a[csr_bsize * m + p];
+      }
+    }
+  }
+
+  // Pack the off-process blocks in the precomputed send order
+  for (int n = 0; n < pattern_nsend; n++) {
+    memcpy(&pattern_send_vals[b2 * n], &vals[b2 * pattern_send_index[n]],
+           b2 * sizeof(TacsScalar));
+  }
+
+  // Exchange the values
+  MPI_Alltoallv(pattern_send_vals, pattern_send_counts, pattern_send_ptr,
+                TACS_MPI_TYPE, pattern_recv_vals, pattern_recv_counts,
+                pattern_recv_ptr, TACS_MPI_TYPE, comm);
+
+  // Add the incoming blocks through the precomputed destinations
+  for (int n = 0; n < pattern_nrecv; n++) {
+    const TacsScalar *a = &pattern_recv_vals[b2 * pattern_recv[4 * n]];
+    int bi = pattern_recv[4 * n + 1];
+    int ioff = pattern_recv[4 * n + 2];
+    int joff = pattern_recv[4 * n + 3];
+    TacsScalar *A = pattern_recv_dest[n];
+
+    for (int m = 0; m < csr_bsize; m++) {
+      for (int p = 0; p < csr_bsize; p++) {
+        A[(ioff + m) + bi * (joff + p)] += a[csr_bsize * m + p];
+      }
+    }
+  }
+}
+
 /*
   Determine the block number i such that var is within the interval:
 
@@ -2432,6 +2798,14 @@ TacsScalar *TACSBlockCyclicMat::get_block(int rank, int i, int j) {
   2. Compute L[i+1:n,i] = A[i+1:n,i]*U[i,i]^{-1}
   3. Compute the update
   A[i+1:n,i+1:n] <-- A[i+1:n,i+1:n] - L[i+1:n,i]*U[i,i+1:n]
+
+  To reduce the time that processes idle waiting for the panel
+  broadcasts, the loop is implemented with a one-step lookahead. The
+  trailing update for step i is split into two passes: the blocks in
+  row and column i+1 are updated first, after which the panel for
+  step i+1 is factored and its broadcast posted. The remainder of the
+  trailing update is then computed while the broadcast of the next
+  panel is in flight.
 */
 void TACSBlockCyclicMat::factor() {
   int rank;
@@ -2449,229 +2823,419 @@ void TACSBlockCyclicMat::factor() {
   int lwork = 128 * max_bsize;
   TacsScalar *work = new TacsScalar[lwork];
 
-  // Buffers to handle the recieves information
-  TacsScalar *Ubuff = new TacsScalar[max_ubuff_size];
-  TacsScalar *Lbuff = new TacsScalar[max_lbuff_size];
-
-  // Send information for rows owning U
-  MPI_Request *U_send_request = new MPI_Request[nprows - 1];
-  MPI_Status *U_send_status = new MPI_Status[nprows - 1];
-
-  // Send information for columns owning L
-  MPI_Request *L_send_request = new MPI_Request[npcols - 1];
-  MPI_Status *L_send_status = new MPI_Status[npcols - 1];
+  // Double-buffered storage for the panels. Two panels are in flight
+  // at once: the panel for the current step and the panel for the
+  // next step, which is factored and broadcast while the trailing
+  // update for the current step is still being computed.
+  TacsScalar *Ubuff[2], *Lbuff[2];
+  MPI_Request *U_send_request[2], *L_send_request[2];
+  MPI_Request U_recv_request[2], L_recv_request[2];
+  for (int k = 0; k < 2; k++) {
+    Ubuff[k] = new TacsScalar[max_ubuff_size];
+    Lbuff[k] = new TacsScalar[max_lbuff_size];
+    U_send_request[k] = new MPI_Request[nprows - 1];
+    L_send_request[k] = new MPI_Request[npcols - 1];
+  }
 
   double t_update = 0.0;
   double t_recv_wait = 0.0;
   double t_send_wait = 0.0;
   int n_gemm = 0;
 
+  // Factor and post the broadcast of the first panel
+  if (nrows > 0) {
+    factor_panel(0, rank, proc_row, proc_col, temp_piv, work, lwork, temp_diag,
+                 temp_block, U_send_request[0], L_send_request[0], Ubuff[0],
+                 &U_recv_request[0], Lbuff[0], &L_recv_request[0], &n_gemm);
+  }
+
   for (int i = 0; i < nrows; i++) {
-    int bi = bptr[i + 1] - bptr[i];
+    // Select the buffers for the current and next panels
+    int ip = i % 2;
+    int inext = (i + 1) % 2;
 
-    // The diagonal factor of A and its pivot
-    TacsScalar *d_diag = NULL;
-    int diag_owner = get_block_owner(i, i);
-
-    // Get the owner for the diagonal block
-    if (rank == diag_owner) {
-      // Determine the address of the diagonal block
-      int nd = dval_offset[i];
-      d_diag = &Dvals[nd];
-
-      // Compute the inverse of the diagonal block
-      int info;
-      LAPACKgetrf(&bi, &bi, d_diag, &bi, temp_piv, &info);
-      LAPACKgetri(&bi, d_diag, &bi, temp_piv, work, &lwork, &info);
-      // Add flops from the inversion
-      TacsAddFlops(1.333333 * bi * bi * bi);
-
-      // Send the factor to the column processes
-      for (int p = 0; p < nprows; p++) {
-        int dest = proc_grid[proc_col + p * npcols];
-        if (rank != dest) {
-          MPI_Send(d_diag, bi * bi, TACS_MPI_TYPE, dest, p, comm);
-        }
-      }
-    }
+    // Wait until the panel for this step has arrived
+    wait_panel(i, proc_row, proc_col, U_send_request[ip], L_send_request[ip],
+               &U_recv_request[ip], &L_recv_request[ip], &t_send_wait,
+               &t_recv_wait);
 
-    // Receive U[i,i]^{-1}
-    if (rank != diag_owner && proc_col == get_proc_column(i)) {
-      MPI_Status status;
-      MPI_Recv(temp_diag, bi * bi, TACS_MPI_TYPE, diag_owner, proc_row, comm,
-               &status);
-      d_diag = temp_diag;
+    if (monitor_factor) {
+      t_update -= MPI_Wtime();
     }
 
-    // Before computing the entries for L[i:n,i], post all the recieve
-    // information for U and L.
+    // Apply the update to the blocks in row and column i+1 first, so
+    // that the next panel can be factored before the rest of the
+    // trailing update is complete
+    update_panel(i, rank, proc_row, proc_col, Ubuff[ip], Lbuff[ip], i + 1, 1,
+                 &n_gemm);
 
-    // Determine the size of the incoming/outgoing U
-    int ubuff_size = 0;
-    for (int jp = Urowp[i]; jp < Urowp[i + 1]; jp++) {
-      int j = Ucols[jp];
-      int bj = bptr[j + 1] - bptr[j];
+    if (monitor_factor) {
+      t_update += MPI_Wtime();
+    }
 
-      if (get_proc_column(j) == proc_col) {
-        ubuff_size += bi * bj;
-      }
+    // Factor the next panel and post its broadcast
+    if (i + 1 < nrows) {
+      factor_panel(i + 1, rank, proc_row, proc_col, temp_piv, work, lwork,
+                   temp_diag, temp_block, U_send_request[inext],
+                   L_send_request[inext], Ubuff[inext], &U_recv_request[inext],
+                   Lbuff[inext], &L_recv_request[inext], &n_gemm);
     }
 
-    // Set the U values to the row processes that need it
-    MPI_Request U_recv_request;
-    int source_proc_row = get_proc_row(i);
-    if (source_proc_row == proc_row) {
-      // The sending processes
-      int offset = uval_offset[Urowp[i]];
-      for (int p = 0, k = 0; p < nprows; p++) {
-        int dest = proc_grid[proc_col + p * npcols];
-        if (rank != dest) {
-          int tag = 2 * i;
-          MPI_Isend(&Uvals[offset], ubuff_size, TACS_MPI_TYPE, dest, tag, comm,
-                    &U_send_request[k]);
-          k++;
-        }
-      }
-    } else {
-      // The receiving processes
-      int source = proc_grid[proc_col + source_proc_row * npcols];
-      int tag = 2 * i;
-      MPI_Irecv(Ubuff, ubuff_size, TACS_MPI_TYPE, source, tag, comm,
-                &U_recv_request);
+    if (monitor_factor) {
+      t_update -= MPI_Wtime();
     }
 
-    // Determine the size of the incoming/outgoing L
-    int lbuff_size = 0;
-    for (int jp = Lcolp[i]; jp < Lcolp[i + 1]; jp++) {
-      int j = Lrows[jp];
-      int bj = bptr[j + 1] - bptr[j];
+    // Apply the update to the remainder of the trailing submatrix,
+    // overlapping the computation with the broadcast of the next
+    // panel
+    update_panel(i, rank, proc_row, proc_col, Ubuff[ip], Lbuff[ip], i + 1, 0,
+                 &n_gemm);
 
-      if (get_proc_row(j) == proc_row) {
-        lbuff_size += bi * bj;
-      }
+    if (monitor_factor) {
+      t_update += MPI_Wtime();
     }
+  }
+
+  if (monitor_factor) {
+    printf("[%d] Number of GEMM updates: %d\n", rank, n_gemm);
+    printf("[%d] Update time:      %15.8f\n", rank, t_update);
+    printf("[%d] Recv wait time:   %15.8f\n", rank, t_recv_wait);
+    printf("[%d] Send wait time:   %15.8f\n", rank, t_send_wait);
+  }
 
-    // Compute L[i+1:n,i] = A[i+1:n,i]*U[i,i]^{-1} and send the results to
-    // the destination immediately
-    if (proc_col == get_proc_column(i)) {
-      for (int jp = Lcolp[i]; jp < Lcolp[i + 1]; jp++) {
-        int j = Lrows[jp];
-        int bj = bptr[j + 1] - bptr[j];
+  // Remove memory for the block factorization
+  delete[] temp_piv;
+  delete[] temp_diag;
+  delete[] temp_block;
+  delete[] work;
 
-        if (rank == get_block_owner(j, i)) {
-          int np = lval_offset[jp];
+  // Release memory for the data transfer
+  for (int k = 0; k < 2; k++) {
+    delete[] Ubuff[k];
+    delete[] Lbuff[k];
+    delete[] U_send_request[k];
+    delete[] L_send_request[k];
+  }
+}
+
+/*
+  Count the number of negative pivots in the factored matrix.
+
+  The block factorization is performed without inter-block pivoting
+  and stores the diagonal blocks U[i,i] in inverted form. Inversion
+  preserves the inertia of each diagonal block, so for a symmetric
+  matrix the sum of the negative pivot signs across the diagonal
+  blocks equals the number of negative eigenvalues by Sylvester's law
+  of inertia.
+
+  This call is collective on the matrix communicator: each process
+  counts the pivots in the diagonal blocks that it owns and the
+  result is summed across all processes. The matrix must be factored
+  before this call.
+*/
+int TACSBlockCyclicMat::countNegativePivots() {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TacsScalar *block = new TacsScalar[max_bsize * max_bsize];
+
+  int count = 0;
+  int ndiag = (nrows < ncols ? nrows : ncols);
+  for (int i = 0; i < ndiag; i++) {
+    if (rank == get_block_owner(i, i)) {
+      int bi = bptr[i + 1] - bptr[i];
 
-          // Compute L[i+1:n,i] = A[i+1:n,i]*U[i,i]^{-1}
-          // L in bj x bi
-          // A in bj x bi
-          // U^{-1} in bi x bi
-          TacsScalar alpha = 1.0, beta = 0.0;
-          BLASgemm("N", "N", &bj, &bi, &bi, &alpha, &Lvals[np], &bj, d_diag,
-                   &bi, &beta, temp_block, &bj);
-          n_gemm++;
-          TacsAddFlops(2 * bi * bi * bj);
+      // Copy the inverted diagonal block so that the pivot
+      // computation does not modify the stored factorization
+      memcpy(block, &Dvals[dval_offset[i]], bi * bi * sizeof(TacsScalar));
 
-          memcpy(&Lvals[np], temp_block, bi * bj * sizeof(TacsScalar));
+      // Compute an unpivoted LU factorization of the block and count
+      // the pivots with negative real part
+      for (int k = 0; k < bi; k++) {
+        TacsScalar d = block[(bi + 1) * k];
+        if (TacsRealPart(d) < 0.0) {
+          count++;
+        }
+        if (TacsRealPart(d) != 0.0) {
+          for (int j = k + 1; j < bi; j++) {
+            TacsScalar ljk = block[bi * j + k] / d;
+            for (int p = k + 1; p < bi; p++) {
+              block[bi * j + p] -= ljk * block[bi * k + p];
+            }
+          }
         }
       }
     }
+  }
 
-    // Set the L values to the row processes that need it
-    MPI_Request L_recv_request;
-    int source_proc_column = get_proc_column(i);
-    if (source_proc_column == proc_col) {
-      // Send the proc_rows requiring everything
-      for (int p = 0, k = 0; p < npcols; p++) {
-        int dest = proc_grid[p + proc_row * npcols];
-        if (rank != dest) {
-          int tag = 2 * i + 1;
-          int offset = lval_offset[Lcolp[i]];
-          MPI_Isend(&Lvals[offset], lbuff_size, TACS_MPI_TYPE, dest, tag, comm,
-                    &L_send_request[k]);
-          k++;
-        }
-      }
-    } else {
-      // The receiving processes
-      int source = proc_grid[source_proc_column + proc_row * npcols];
-      int tag = 2 * i + 1;
-      MPI_Irecv(Lbuff, lbuff_size, TACS_MPI_TYPE, source, tag, comm,
-                &L_recv_request);
-    }
-
-    // There are four cases:
-    // 1. The processor owns both the row and column elements required.
-    // This is true of only the root processor.
-    // 2. The processor owns the column but not the row and must wait for
-    // any of the U_recv requests.
-    // 3. The processor owns the row but not the column and must wait for
-    // any of the L_recv requests.
-    // 4. The processor owns neither the column or the row and must wait
-    // for combinations of requests to begin.
+  delete[] block;
 
-    if (monitor_factor) {
-      t_send_wait -= MPI_Wtime();
+  // Sum the contributions from all processes
+  MPI_Allreduce(MPI_IN_PLACE, &count, 1, MPI_INT, MPI_SUM, comm);
+
+  return count;
+}
+
+/*
+  Factor the i-th panel and post its broadcast.
+
+  This computes the inverse of the diagonal block U[i,i] and
+  distributes it down the process column, computes the column
+  L[i+1:n,i] = A[i+1:n,i]*U[i,i]^{-1}, and posts the non-blocking
+  sends/receives that broadcast the row U[i,i+1:n] down the process
+  columns and the column L[i+1:n,i] along the process rows. The
+  matching waits are posted in wait_panel(), so that the broadcast of
+  this panel can complete while the trailing update for the previous
+  panel is computed.
+
+  Note that the blocks in row and column i must be up-to-date before
+  this call: the trailing update for the previous step is split so
+  that these blocks are updated first.
+*/
+void TACSBlockCyclicMat::factor_panel(
+    int i, int rank, int proc_row, int proc_col, int *temp_piv,
+    TacsScalar *work, int lwork, TacsScalar *temp_diag, TacsScalar *temp_block,
+    MPI_Request *U_send_request, MPI_Request *L_send_request, TacsScalar *Ubuff,
+    MPI_Request *U_recv_request, TacsScalar *Lbuff,
+    MPI_Request *L_recv_request, int *n_gemm) {
+  int bi = bptr[i + 1] - bptr[i];
+
+  // The diagonal factor of A and its pivot
+  TacsScalar *d_diag = NULL;
+  int diag_owner = get_block_owner(i, i);
+
+  // Use a tag space for the diagonal blocks that is distinct from the
+  // tags used for the U/L panel broadcasts
+  int diag_tag = 2 * nrows + i;
+
+  // Get the owner for the diagonal block
+  if (rank == diag_owner) {
+    // Determine the address of the diagonal block
+    int nd = dval_offset[i];
+    d_diag = &Dvals[nd];
+
+    // Compute the inverse of the diagonal block. Small blocks take
+    // the unrolled fixed-size path.
+    int info;
+    TacsLAPACKgetrf(bi, d_diag, temp_piv, &info);
+    TacsLAPACKgetri(bi, d_diag, temp_piv, work, lwork, &info);
+    // Add flops from the inversion
+    TacsAddFlops(1.333333 * bi * bi * bi);
+
+    // Send the factor to the column processes
+    for (int p = 0; p < nprows; p++) {
+      int dest = proc_grid[proc_col + p * npcols];
+      if (rank != dest) {
+        MPI_Send(d_diag, bi * bi, TACS_MPI_TYPE, dest, diag_tag, comm);
+      }
     }
+  }
 
-    // Wait for the remaining sends to complete
-    if (source_proc_row == proc_row) {
-      MPI_Waitall(nprows - 1, U_send_request, U_send_status);
+  // Receive U[i,i]^{-1}
+  if (rank != diag_owner && proc_col == get_proc_column(i)) {
+    MPI_Status status;
+    MPI_Recv(temp_diag, bi * bi, TACS_MPI_TYPE, diag_owner, diag_tag, comm,
+             &status);
+    d_diag = temp_diag;
+  }
+
+  // Before computing the entries for L[i:n,i], post all the recieve
+  // information for U and L.
+
+  // Determine the size of the incoming/outgoing U
+  int ubuff_size = 0;
+  for (int jp = Urowp[i]; jp < Urowp[i + 1]; jp++) {
+    int j = Ucols[jp];
+    int bj = bptr[j + 1] - bptr[j];
+
+    if (get_proc_column(j) == proc_col) {
+      ubuff_size += bi * bj;
     }
-    if (source_proc_column == proc_col) {
-      MPI_Waitall(npcols - 1, L_send_request, L_send_status);
+  }
+
+  // Set the U values to the row processes that need it
+  int source_proc_row = get_proc_row(i);
+  if (source_proc_row == proc_row) {
+    // The sending processes
+    int offset = uval_offset[Urowp[i]];
+    for (int p = 0, k = 0; p < nprows; p++) {
+      int dest = proc_grid[proc_col + p * npcols];
+      if (rank != dest) {
+        int tag = 2 * i;
+        MPI_Isend(&Uvals[offset], ubuff_size, TACS_MPI_TYPE, dest, tag, comm,
+                  &U_send_request[k]);
+        k++;
+      }
     }
+  } else {
+    // The receiving processes
+    int source = proc_grid[proc_col + source_proc_row * npcols];
+    int tag = 2 * i;
+    MPI_Irecv(Ubuff, ubuff_size, TACS_MPI_TYPE, source, tag, comm,
+              U_recv_request);
+  }
 
-    if (monitor_factor) {
-      t_send_wait += MPI_Wtime();
-      t_recv_wait -= MPI_Wtime();
+  // Determine the size of the incoming/outgoing L
+  int lbuff_size = 0;
+  for (int jp = Lcolp[i]; jp < Lcolp[i + 1]; jp++) {
+    int j = Lrows[jp];
+    int bj = bptr[j + 1] - bptr[j];
+
+    if (get_proc_row(j) == proc_row) {
+      lbuff_size += bi * bj;
     }
+  }
+
+  // Compute L[i+1:n,i] = A[i+1:n,i]*U[i,i]^{-1} and send the results to
+  // the destination immediately
+  if (proc_col == get_proc_column(i)) {
+    for (int jp = Lcolp[i]; jp < Lcolp[i + 1]; jp++) {
+      int j = Lrows[jp];
+      int bj = bptr[j + 1] - bptr[j];
+
+      if (rank == get_block_owner(j, i)) {
+        int np = lval_offset[jp];
+
+        // Compute L[i+1:n,i] = A[i+1:n,i]*U[i,i]^{-1}
+        // L in bj x bi
+        // A in bj x bi
+        // U^{-1} in bi x bi
+        TacsScalar alpha = 1.0, beta = 0.0;
+        BLASgemm("N", "N", &bj, &bi, &bi, &alpha, &Lvals[np], &bj, d_diag, &bi,
+                 &beta, temp_block, &bj);
+        (*n_gemm)++;
+        TacsAddFlops(2 * bi * bi * bj);
 
-    // Wait for the receive to completex
-    if (source_proc_column != proc_col) {
-      MPI_Status L_recv_status;
-      MPI_Wait(&L_recv_request, &L_recv_status);
+        memcpy(&Lvals[np], temp_block, bi * bj * sizeof(TacsScalar));
+      }
     }
-    if (source_proc_row != proc_row) {
-      MPI_Status U_recv_status;
-      MPI_Wait(&U_recv_request, &U_recv_status);
+  }
+
+  // Set the L values to the row processes that need it
+  int source_proc_column = get_proc_column(i);
+  if (source_proc_column == proc_col) {
+    // Send the proc_rows requiring everything
+    for (int p = 0, k = 0; p < npcols; p++) {
+      int dest = proc_grid[p + proc_row * npcols];
+      if (rank != dest) {
+        int tag = 2 * i + 1;
+        int offset = lval_offset[Lcolp[i]];
+        MPI_Isend(&Lvals[offset], lbuff_size, TACS_MPI_TYPE, dest, tag, comm,
+                  &L_send_request[k]);
+        k++;
+      }
     }
+  } else {
+    // The receiving processes
+    int source = proc_grid[source_proc_column + proc_row * npcols];
+    int tag = 2 * i + 1;
+    MPI_Irecv(Lbuff, lbuff_size, TACS_MPI_TYPE, source, tag, comm,
+              L_recv_request);
+  }
+}
 
-    // Compute the bi-rank update to the remainder of the matrix
-    // A[i+1:n,i+1:n] = A[i+1:n,i+1:n] - L[i:n,i]*U[i,i:n]
+/*
+  Wait until the broadcast of the i-th panel is complete.
+
+  There are four cases:
+  1. The processor owns both the row and column elements required.
+  This is true of only the root processor.
+  2. The processor owns the column but not the row and must wait for
+  any of the U_recv requests.
+  3. The processor owns the row but not the column and must wait for
+  any of the L_recv requests.
+  4. The processor owns neither the column or the row and must wait
+  for combinations of requests to begin.
+*/
+void TACSBlockCyclicMat::wait_panel(int i, int proc_row, int proc_col,
+                                    MPI_Request *U_send_request,
+                                    MPI_Request *L_send_request,
+                                    MPI_Request *U_recv_request,
+                                    MPI_Request *L_recv_request,
+                                    double *t_send_wait, double *t_recv_wait) {
+  if (monitor_factor) {
+    *t_send_wait -= MPI_Wtime();
+  }
 
-    if (monitor_factor) {
-      t_recv_wait += MPI_Wtime();
-      t_update -= MPI_Wtime();
-    }
+  // Wait for the remaining sends to complete
+  if (get_proc_row(i) == proc_row) {
+    MPI_Waitall(nprows - 1, U_send_request, MPI_STATUSES_IGNORE);
+  }
+  if (get_proc_column(i) == proc_col) {
+    MPI_Waitall(npcols - 1, L_send_request, MPI_STATUSES_IGNORE);
+  }
+
+  if (monitor_factor) {
+    *t_send_wait += MPI_Wtime();
+    *t_recv_wait -= MPI_Wtime();
+  }
 
-    // Initialize the L-pointer
-    TacsScalar *L = Lbuff;
-    if (source_proc_column == proc_col) {
-      L = &Lvals[lval_offset[Lcolp[i]]];
+  // Wait for the receive to complete
+  if (get_proc_column(i) != proc_col) {
+    MPI_Wait(L_recv_request, MPI_STATUS_IGNORE);
+  }
+  if (get_proc_row(i) != proc_row) {
+    MPI_Wait(U_recv_request, MPI_STATUS_IGNORE);
+  }
+
+  if (monitor_factor) {
+    *t_recv_wait += MPI_Wtime();
+  }
+}
+
+/*
+  Apply part of the trailing update for the i-th panel.
+
+  This computes the bi-rank update to the remainder of the matrix
+
+  A[i+1:n,i+1:n] = A[i+1:n,i+1:n] - L[i:n,i]*U[i,i:n]
+
+  The update is split into two passes to implement the lookahead: when
+  next_only is true, only the blocks in row and column next are
+  updated - these are the blocks required to factor the next panel.
+  When next_only is false, all the remaining blocks are updated, which
+  overlaps with the broadcast of the next panel.
+*/
+void TACSBlockCyclicMat::update_panel(int i, int rank, int proc_row,
+                                      int proc_col, TacsScalar *Ubuff,
+                                      TacsScalar *Lbuff, int next,
+                                      int next_only, int *n_gemm) {
+  int bi = bptr[i + 1] - bptr[i];
+  int source_proc_row = get_proc_row(i);
+  int source_proc_column = get_proc_column(i);
+
+  // Initialize the L-pointer
+  TacsScalar *L = Lbuff;
+  if (source_proc_column == proc_col) {
+    L = &Lvals[lval_offset[Lcolp[i]]];
+  }
+
+  for (int iip = Lcolp[i]; iip < Lcolp[i + 1]; iip++) {
+    // Skip rows not locally owned
+    int ii = Lrows[iip];
+    int bii = bptr[ii + 1] - bptr[ii];
+    if (get_proc_row(ii) != proc_row) {
+      continue;
+    }
+
+    // Initialize the U-pointer
+    TacsScalar *U = Ubuff;
+    if (source_proc_row == proc_row) {
+      U = &Uvals[uval_offset[Urowp[i]]];
     }
 
-    for (int iip = Lcolp[i]; iip < Lcolp[i + 1]; iip++) {
-      // Skip rows not locally owned
-      int ii = Lrows[iip];
-      int bii = bptr[ii + 1] - bptr[ii];
-      if (get_proc_row(ii) != proc_row) {
+    for (int jjp = Urowp[i]; jjp < Urowp[i + 1]; jjp++) {
+      // Skip columns not locally owned
+      int jj = Ucols[jjp];
+      int bjj = bptr[jj + 1] - bptr[jj];
+      if (get_proc_column(jj) != proc_col) {
         continue;
       }
 
-      // Initialize the U-pointer
-      TacsScalar *U = Ubuff;
-      if (source_proc_row == proc_row) {
-        U = &Uvals[uval_offset[Urowp[i]]];
-      }
-
-      for (int jjp = Urowp[i]; jjp < Urowp[i + 1]; jjp++) {
-        // Skip columns not locally owned
-        int jj = Ucols[jjp];
-        int bjj = bptr[jj + 1] - bptr[jj];
-        if (get_proc_column(jj) != proc_col) {
-          continue;
-        }
-
+      // Select the blocks for this pass of the update: the blocks in
+      // row/column next are updated in the first pass, the remaining
+      // blocks in the second
+      if ((ii == next || jj == next) == (next_only != 0)) {
         TacsScalar *A = get_block(rank, ii, jj);
 
         if (A) {
@@ -2684,40 +3248,14 @@ void TACSBlockCyclicMat::factor() {
           TacsScalar alpha = -1.0, beta = 1.0;
           BLASgemm("N", "N", &bii, &bjj, &bi, &alpha, L, &bii, U, &bi, &beta, A,
                    &bii);
-          n_gemm++;
+          (*n_gemm)++;
           TacsAddFlops(2 * bii * bjj * bi);
         }
-
-        U += bi * bjj;
       }
 
-      L += bi * bii;
+      U += bi * bjj;
     }
 
-    if (monitor_factor) {
-      t_update += MPI_Wtime();
-    }
-  }
-
-  if (monitor_factor) {
-    printf("[%d] Number of GEMM updates: %d\n", rank, n_gemm);
-    printf("[%d] Update time:      %15.8f\n", rank, t_update);
-    printf("[%d] Recv wait time:   %15.8f\n", rank, t_recv_wait);
-    printf("[%d] Send wait time:   %15.8f\n", rank, t_send_wait);
+    L += bi * bii;
   }
-
-  // Remove memory for the block factorization
-  delete[] temp_piv;
-  delete[] temp_diag;
-  delete[] temp_block;
-  delete[] work;
-
-  // Release memory for the data transfer
-  delete[] Ubuff;
-  delete[] Lbuff;
-
-  delete[] U_send_request;
-  delete[] L_send_request;
-  delete[] U_send_status;
-  delete[] L_send_status;
 }
@@ -126,6 +126,12 @@ class TACSBlockCyclicMat : public TACSObject {
   void addAlltoallValues(int csr_bsize, int nvars, const int *vars,
                          const int *csr_rowp, const int *csr_cols,
                          TacsScalar *vals);
+
+  // Precompute the index translation for repeated numeric assembly
+  // --------------------------------------------------------------
+  void initAssemblyPattern(int csr_bsize, int nvars, const int *vars,
+                           const int *csr_rowp, const int *csr_cols);
+  void addPatternValues(TacsScalar *vals);
   void setRand();
 
   // Matrix operations - note that factorization is in-place
@@ -134,6 +140,10 @@ class TACSBlockCyclicMat : public TACSObject {
   void applyFactor(TacsScalar *x);
   void factor();
 
+  // Count the negative pivots in the factored matrix (collective)
+  // -------------------------------------------------------------
+  int countNegativePivots();
+
   // Given the i/j location within the matrix, determine the owner
   // -------------------------------------------------------------
   int get_block_owner(int i, int j) const {
@@ -153,6 +163,23 @@ class TACSBlockCyclicMat : public TACSObject {
   int add_values(int rank, int i, int j, int csr_bsize, int csr_i, int csr_j,
                  TacsScalar *b);
 
+  // Helper functions for the lookahead in the factorization: factor
+  // and broadcast the panel for step i, wait for the panel to arrive,
+  // and apply the trailing update for step i
+  void factor_panel(int i, int rank, int proc_row, int proc_col, int *temp_piv,
+                    TacsScalar *work, int lwork, TacsScalar *temp_diag,
+                    TacsScalar *temp_block, MPI_Request *U_send_request,
+                    MPI_Request *L_send_request, TacsScalar *Ubuff,
+                    MPI_Request *U_recv_request, TacsScalar *Lbuff,
+                    MPI_Request *L_recv_request, int *n_gemm);
+  void wait_panel(int i, int proc_row, int proc_col,
+                  MPI_Request *U_send_request, MPI_Request *L_send_request,
+                  MPI_Request *U_recv_request, MPI_Request *L_recv_request,
+                  double *t_send_wait, double *t_recv_wait);
+  void update_panel(int i, int rank, int proc_row, int proc_col,
+                    TacsScalar *Ubuff, TacsScalar *Lbuff, int next,
+                    int next_only, int *n_gemm);
+
   // Helper functions for applying the lower-triangular back-solve
   void lower_column_update(int col, TacsScalar *x, TacsScalar *xsum,
                            TacsScalar *xlocal, int *row_sum_count,
@@ -254,6 +281,23 @@ class TACSBlockCyclicMat : public TACSObject {
   int lower_block_count, upper_block_count;
   int *lower_row_sum_count, *lower_row_sum_recv;
   int *upper_row_sum_count, *upper_row_sum_recv;
+
+  // The precomputed assembly pattern set by initAssemblyPattern().
+  // The local and incoming lists store 4 entries per CSR block: the
+  // source index (CSR entry or receive slot), the leading dimension
+  // of the destination block and the row/column offsets within it.
+  int pattern_bsize;              // CSR block size of the pattern
+  int pattern_nlocal;             // Number of locally-owned CSR blocks
+  int *pattern_local;             // Addressing for the local blocks
+  TacsScalar **pattern_local_ptr; // Destination of each local block
+  int pattern_nsend;              // Number of blocks sent away
+  int *pattern_send_index;        // CSR entry of each block in send order
+  int pattern_nrecv;              // Number of incoming blocks
+  int *pattern_recv;              // Addressing for the incoming blocks
+  TacsScalar **pattern_recv_dest; // Destination of each incoming block
+  int *pattern_send_counts, *pattern_send_ptr;  // Alltoallv send sizes
+  int *pattern_recv_counts, *pattern_recv_ptr;  // Alltoallv recv sizes
+  TacsScalar *pattern_send_vals, *pattern_recv_vals;  // Persistent buffers
 };
 
 #endif  // TACS_BLOCK_CYCLIC_MAT_H
@@ -0,0 +1,179 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSConstraintProjection.h"
+
+/*
+  Store the sparse constraint relation.
+
+  The input arrays are copied internally.
+
+  input:
+  num_dep:  the number of dependent DOFs
+  dep_dofs: the local index of each dependent DOF
+  rowp:     pointer of length num_dep+1 into the cols/coefs arrays
+  cols:     the local indices of the independent DOFs
+  coefs:    the constraint coefficients
+*/
+TACSConstraintProjection::TACSConstraintProjection(int _num_dep,
+                                                  const int _dep_dofs[],
+                                                  const int _rowp[],
+                                                  const int _cols[],
+                                                  const TacsScalar _coefs[]) {
+  num_dep = _num_dep;
+
+  dep_dofs = new int[num_dep];
+  memcpy(dep_dofs, _dep_dofs, num_dep * sizeof(int));
+
+  rowp = new int[num_dep + 1];
+  memcpy(rowp, _rowp, (num_dep + 1) * sizeof(int));
+
+  int nnz = rowp[num_dep];
+  cols = new int[nnz];
+  memcpy(cols, _cols, nnz * sizeof(int));
+
+  coefs = new TacsScalar[nnz];
+  memcpy(coefs, _coefs, nnz * sizeof(TacsScalar));
+}
+
+TACSConstraintProjection::~TACSConstraintProjection() {
+  delete[] dep_dofs;
+  delete[] rowp;
+  delete[] cols;
+  delete[] coefs;
+}
+
+/*
+  Apply the projection u <- P*u.
+
+  The dependent entries of the vector are overwritten with the
+  constrained combination of the independent entries. All other
+  entries are left unchanged.
+*/
+void TACSConstraintProjection::applyProjection(TACSBVec *vec) {
+  TacsScalar *x;
+  vec->getArray(&x);
+
+  for (int i = 0; i < num_dep; i++) {
+    TacsScalar val = 0.0;
+    for (int jp = rowp[i]; jp < rowp[i + 1]; jp++) {
+      val += coefs[jp] * x[cols[jp]];
+    }
+    x[dep_dofs[i]] = val;
+  }
+}
+
+/*
+  Apply the transpose projection r <- P^{T}*r.
+
+  The dependent entries are accumulated into the independent entries
+  that drive them and are then zeroed out, transferring the residual
+  contributions from the slaved DOFs onto the retained DOFs.
+*/
+void TACSConstraintProjection::applyProjectionTranspose(TACSBVec *vec) {
+  TacsScalar *x;
+  vec->getArray(&x);
+
+  for (int i = 0; i < num_dep; i++) {
+    TacsScalar val = x[dep_dofs[i]];
+    x[dep_dofs[i]] = 0.0;
+    for (int jp = rowp[i]; jp < rowp[i + 1]; jp++) {
+      x[cols[jp]] += coefs[jp] * val;
+    }
+  }
+}
+
+/*
+  Copy only the dependent entries from x into y
+*/
+void TACSConstraintProjection::copyDependentValues(TACSBVec *xvec,
+                                                   TACSBVec *yvec) {
+  TacsScalar *x, *y;
+  xvec->getArray(&x);
+  yvec->getArray(&y);
+
+  for (int i = 0; i < num_dep; i++) {
+    y[dep_dofs[i]] = x[dep_dofs[i]];
+  }
+}
+
+/*
+  Create the projected matrix y = P^{T}*A*P*x + D*x
+*/
+TACSProjectedMat::TACSProjectedMat(TACSMat *_mat,
+                                   TACSConstraintProjection *_proj) {
+  mat = _mat;
+  mat->incref();
+  proj = _proj;
+  proj->incref();
+
+  xtmp = dynamic_cast<TACSBVec *>(mat->createVec());
+  if (xtmp) {
+    xtmp->incref();
+  } else {
+    fprintf(stderr,
+            "TACSProjectedMat type error: Underlying matrix must create "
+            "TACSBVec vectors\n");
+  }
+}
+
+TACSProjectedMat::~TACSProjectedMat() {
+  mat->decref();
+  proj->decref();
+  if (xtmp) {
+    xtmp->decref();
+  }
+}
+
+/*
+  Get the size of the underlying matrix
+*/
+void TACSProjectedMat::getSize(int *_nr, int *_nc) { mat->getSize(_nr, _nc); }
+
+/*
+  Create a vector compatible with the underlying matrix
+*/
+TACSVec *TACSProjectedMat::createVec() { return mat->createVec(); }
+
+/*
+  Compute the projected matrix-vector product y = P^{T}*A*P*x + D*x
+*/
+void TACSProjectedMat::mult(TACSVec *txvec, TACSVec *tyvec) {
+  TACSBVec *xvec, *yvec;
+  xvec = dynamic_cast<TACSBVec *>(txvec);
+  yvec = dynamic_cast<TACSBVec *>(tyvec);
+
+  if (xvec && yvec && xtmp) {
+    // Fill in the dependent entries from the independent entries
+    xtmp->copyValues(xvec);
+    proj->applyProjection(xtmp);
+
+    // Apply the underlying matrix
+    mat->mult(xtmp, yvec);
+
+    // Fold the dependent rows back onto the independent rows
+    proj->applyProjectionTranspose(yvec);
+
+    // Apply the identity on the dependent DOFs so that the operator
+    // remains nonsingular on the slaved subspace
+    proj->copyDependentValues(xvec, yvec);
+  } else {
+    fprintf(stderr,
+            "TACSProjectedMat type error: Input/output must be TACSBVec\n");
+  }
+}
@@ -0,0 +1,123 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_CONSTRAINT_PROJECTION_H
+#define TACS_CONSTRAINT_PROJECTION_H
+
+/*
+  Sparse projection operators for eliminating multi-point constraints
+  (e.g. RBE2/RBE3 relations) around a Krylov solve
+*/
+
+#include "KSM.h"
+#include "TACSBVec.h"
+
+/*
+  This class stores the sparse relation between a set of dependent
+  degrees of freedom and the independent degrees of freedom that drive
+  them:
+
+  u_dep[i] = sum_{jp} coefs[jp]*u[cols[jp]]
+
+  The relation defines a projection operator P from the reduced space,
+  in which the dependent DOFs are slaved, to the full space. Rather
+  than assembling dense Lagrange-multiplier blocks for large
+  constraint spiders, the projection can be applied around a Krylov
+  solve through the TACSProjectedMat class below.
+
+  The constraint coefficients for the RBE2/RBE3 elements can be
+  retrieved in element-local form from their getConstraintMatrix
+  member functions.
+
+  All indices are local indices into the local array of a TACSBVec, so
+  all of the DOFs coupled by a single constraint must be owned by the
+  same processor. DOFs that should be dropped from the solve entirely,
+  such as the Lagrange multiplier unknowns of the constraint elements
+  themselves, can be listed as dependent DOFs with an empty row of
+  coefficients.
+*/
+class TACSConstraintProjection : public TACSObject {
+ public:
+  TACSConstraintProjection(int _num_dep, const int _dep_dofs[],
+                           const int _rowp[], const int _cols[],
+                           const TacsScalar _coefs[]);
+  ~TACSConstraintProjection();
+
+  // Apply the projection u <- P*u: overwrite the dependent entries
+  // with their constrained combination of the independent entries
+  void applyProjection(TACSBVec *vec);
+
+  // Apply the transpose projection r <- P^{T}*r: accumulate the
+  // dependent entries into the independent entries and zero the
+  // dependent entries
+  void applyProjectionTranspose(TACSBVec *vec);
+
+  // Copy only the dependent entries from x into y
+  void copyDependentValues(TACSBVec *xvec, TACSBVec *yvec);
+
+  // Get the number of dependent degrees of freedom
+  int getNumDependentDOFs() { return num_dep; }
+
+ private:
+  int num_dep;        // The number of dependent DOFs
+  int *dep_dofs;      // The local index of each dependent DOF
+  int *rowp;          // Pointer into the coefficients for each DOF
+  int *cols;          // The local indices of the independent DOFs
+  TacsScalar *coefs;  // The constraint coefficients
+};
+
+/*
+  A matrix that applies the constraint projection around an inner
+  matrix-vector product:
+
+  y = P^{T}*A*P*x + D*x
+
+  where D is the identity on the dependent DOFs. The identity keeps
+  the operator nonsingular on the slaved subspace without coupling it
+  to the independent DOFs, so the matrix can be handed directly to any
+  of the Krylov solvers.
+
+  To solve A*u = b with the constraints eliminated:
+
+  1. project the right-hand side: b <- P^{T}*b
+  2. solve the projected system with this matrix
+  3. recover the dependent DOFs: u <- P*u
+
+  The matrix itself is assembled without the constraint element
+  contributions; the Lagrange-multiplier path remains available by
+  assembling the constraint elements as before.
+*/
+class TACSProjectedMat : public TACSMat {
+ public:
+  TACSProjectedMat(TACSMat *_mat, TACSConstraintProjection *_proj);
+  ~TACSProjectedMat();
+
+  // Retrieve the size/create vectors from the underlying matrix
+  void getSize(int *_nr, int *_nc);
+  TACSVec *createVec();
+
+  // Compute the projected matrix-vector product
+  void mult(TACSVec *x, TACSVec *y);
+
+ private:
+  TACSMat *mat;                    // The underlying matrix
+  TACSConstraintProjection *proj;  // The constraint projection
+  TACSBVec *xtmp;                  // Temporary vector for P*x
+};
+
+#endif  // TACS_CONSTRAINT_PROJECTION_H
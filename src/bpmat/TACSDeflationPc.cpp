@@ -0,0 +1,305 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2014 Georgia Tech Research Corporation
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSDeflationPc.h"
+
+#include "tacslapack.h"
+
+/*!
+  Create the deflation preconditioner.
+
+  The matrix and the inner preconditioner are fixed at construction;
+  the deflation subspace may be installed or recomputed at any point
+  afterwards.
+
+  input:
+  mat:          the matrix that is being preconditioned
+  pc:           the inner preconditioner to apply after deflation
+  max_num_vecs: the maximum size of the deflation subspace
+*/
+TACSDeflationPc::TACSDeflationPc(TACSMat *_mat, TACSPc *_pc,
+                                 int _max_num_vecs) {
+  mat = _mat;
+  mat->incref();
+  pc = _pc;
+  pc->incref();
+
+  max_num_vecs = (_max_num_vecs > 0 ? _max_num_vecs : 1);
+  num_vecs = 0;
+  W = new TACSVec *[max_num_vecs];
+
+  wsum = mat->createVec();
+  wsum->incref();
+  temp = mat->createVec();
+  temp->incref();
+
+  E = new TacsScalar[max_num_vecs * max_num_vecs];
+  Epiv = new int[max_num_vecs];
+  coef = new TacsScalar[max_num_vecs];
+}
+
+/*
+  Free the deflation subspace and the coarse matrix data
+*/
+TACSDeflationPc::~TACSDeflationPc() {
+  for (int i = 0; i < num_vecs; i++) {
+    W[i]->decref();
+  }
+  delete[] W;
+  wsum->decref();
+  temp->decref();
+  mat->decref();
+  pc->decref();
+  delete[] E;
+  delete[] Epiv;
+  delete[] coef;
+}
+
+/*!
+  Set the deflation subspace directly.
+
+  The vectors are normalized in place and replace any existing
+  subspace. The coarse matrix is recomputed and factored immediately,
+  so the matrix must hold its final values before this call.
+
+  input:
+  num_vecs: the number of deflation vectors
+  W:        the deflation vectors
+*/
+void TACSDeflationPc::setDeflationVecs(int _num_vecs, TACSVec **_W) {
+  for (int i = 0; i < num_vecs; i++) {
+    W[i]->decref();
+  }
+  num_vecs = 0;
+
+  for (int i = 0; i < _num_vecs && i < max_num_vecs; i++) {
+    TacsScalar nrm = _W[i]->norm();
+    if (TacsRealPart(nrm) > 0.0) {
+      _W[i]->scale(1.0 / nrm);
+      W[num_vecs] = _W[i];
+      W[num_vecs]->incref();
+      num_vecs++;
+    }
+  }
+
+  factorCoarseMat();
+}
+
+/*!
+  Append vectors interpolated from a coarse space.
+
+  Each coarse vector is prolongated to the fine space through the
+  interpolation object and appended to the deflation subspace. The
+  coarse matrix is recomputed and factored after the vectors are
+  added.
+
+  input:
+  interp: the interpolation from the coarse to the fine space
+  nvecs:  the number of coarse vectors
+  coarse: the coarse-space vectors
+*/
+void TACSDeflationPc::addCoarseSpace(TACSBVecInterp *interp, int nvecs,
+                                     TACSBVec **coarse) {
+  for (int i = 0; i < nvecs && num_vecs < max_num_vecs; i++) {
+    TACSVec *vec = mat->createVec();
+    vec->incref();
+
+    TACSBVec *bvec = dynamic_cast<TACSBVec *>(vec);
+    if (!bvec) {
+      fprintf(stderr,
+              "TACSDeflationPc: Cannot interpolate to a vector that is "
+              "not a TACSBVec\n");
+      vec->decref();
+      return;
+    }
+
+    interp->mult(coarse[i], bvec);
+
+    TacsScalar nrm = vec->norm();
+    if (TacsRealPart(nrm) > 0.0) {
+      vec->scale(1.0 / nrm);
+      W[num_vecs] = vec;
+      num_vecs++;
+    } else {
+      vec->decref();
+    }
+  }
+
+  factorCoarseMat();
+}
+
+/*!
+  Compute the lowest eigenmodes of the matrix as the deflation
+  subspace.
+
+  The smallest eigenvalues are computed with the shift-and-invert
+  Lanczos method from GSEP. The inverse applications are performed
+  with GMRES preconditioned by the inner preconditioner, so the inner
+  preconditioner must be factored before this call - for a sequence of
+  solves with a slowly varying matrix the modes are typically computed
+  once and retained.
+
+  Any existing deflation subspace is replaced, and the coarse matrix
+  is factored before returning.
+
+  input:
+  num_modes: the number of eigenmodes to compute
+  max_iters: the maximum size of the Lanczos subspace
+  eig_tol:   the relative tolerance on the eigenvalues
+  rtol:      the relative tolerance for the inner GMRES solves
+  atol:      the absolute tolerance for the inner GMRES solves
+
+  returns: the number of modes installed in the subspace
+*/
+int TACSDeflationPc::computeDeflationModes(int num_modes, int max_iters,
+                                           double eig_tol, double rtol,
+                                           double atol) {
+  if (num_modes > max_num_vecs) {
+    num_modes = max_num_vecs;
+  }
+
+  // Set up the inverse operator using the inner preconditioner
+  GMRES *ksm = new GMRES(mat, pc, 30, 4, 0);
+  ksm->incref();
+  ksm->setTolerances(rtol, atol);
+
+  // Shift-and-invert about the origin: the smallest eigenvalues of
+  // the matrix become the largest of the operator
+  EPShiftInvert *ep = new EPShiftInvert(0.0, ksm);
+  ep->incref();
+
+  SEP *sep = new SEP(ep, max_iters, SEP::FULL);
+  sep->incref();
+  sep->setTolerances(eig_tol, SEP::LARGEST_MAGNITUDE, num_modes);
+  sep->solve();
+
+  // Replace the deflation subspace with the converged eigenvectors
+  for (int i = 0; i < num_vecs; i++) {
+    W[i]->decref();
+  }
+  num_vecs = 0;
+
+  for (int i = 0; i < num_modes; i++) {
+    TACSVec *vec = mat->createVec();
+    vec->incref();
+
+    TacsScalar error;
+    sep->extractEigenvector(i, vec, &error);
+
+    TacsScalar nrm = vec->norm();
+    if (TacsRealPart(nrm) > 0.0) {
+      vec->scale(1.0 / nrm);
+      W[num_vecs] = vec;
+      num_vecs++;
+    } else {
+      vec->decref();
+    }
+  }
+
+  sep->decref();
+  ep->decref();
+  ksm->decref();
+
+  factorCoarseMat();
+  return num_vecs;
+}
+
+/*
+  Retrieve the number of vectors in the deflation subspace
+*/
+int TACSDeflationPc::getNumDeflationVecs() { return num_vecs; }
+
+/*
+  Recompute and factor the dense coarse matrix E = W^{T} A W.
+
+  The inner products are collective, so every processor holds an
+  identical copy of the coarse matrix and the dense factorization is
+  replicated rather than communicated.
+*/
+void TACSDeflationPc::factorCoarseMat() {
+  if (num_vecs > 0) {
+    for (int j = 0; j < num_vecs; j++) {
+      mat->mult(W[j], temp);
+      for (int i = 0; i < num_vecs; i++) {
+        E[i + max_num_vecs * j] = W[i]->dot(temp);
+      }
+    }
+
+    int info = 0;
+    LAPACKgetrf(&num_vecs, &num_vecs, E, &max_num_vecs, Epiv, &info);
+    if (info != 0) {
+      fprintf(stderr,
+              "TACSDeflationPc: Coarse matrix factorization failed with "
+              "info = %d. The deflation vectors may be linearly "
+              "dependent\n",
+              info);
+      num_vecs = 0;
+    }
+  }
+}
+
+/*!
+  Factor the preconditioner.
+
+  The inner preconditioner is factored first, then the coarse matrix
+  is recomputed from the current matrix values. The deflation subspace
+  itself is retained - for a slowly varying matrix the subspace stays
+  effective over many factorizations.
+*/
+void TACSDeflationPc::factor() {
+  pc->factor();
+  factorCoarseMat();
+}
+
+/*!
+  Apply the deflated preconditioner:
+
+  y = W E^{-1} W^{T} x + M^{-1} (x - A W E^{-1} W^{T} x)
+
+  The coarse correction resolves the near-kernel content of the input
+  exactly, and the inner preconditioner is applied to the deflated
+  remainder.
+*/
+void TACSDeflationPc::applyFactor(TACSVec *x, TACSVec *y) {
+  if (num_vecs > 0) {
+    // Solve the coarse problem E * coef = W^{T} x
+    for (int i = 0; i < num_vecs; i++) {
+      coef[i] = W[i]->dot(x);
+    }
+    int one = 1, info = 0;
+    LAPACKgetrs("N", &num_vecs, &one, E, &max_num_vecs, Epiv, coef,
+                &num_vecs, &info);
+
+    // Compute the coarse correction wsum = W * coef
+    wsum->zeroEntries();
+    for (int i = 0; i < num_vecs; i++) {
+      wsum->axpy(coef[i], W[i]);
+    }
+
+    // Deflate the input: temp = x - A * wsum
+    mat->mult(wsum, temp);
+    temp->axpby(1.0, -1.0, x);
+
+    // Apply the inner preconditioner and add the coarse correction
+    pc->applyFactor(temp, y);
+    y->axpy(1.0, wsum);
+  } else {
+    pc->applyFactor(x, y);
+  }
+}
+
+/*
+  Get the matrix associated with the preconditioner
+*/
+void TACSDeflationPc::getMat(TACSMat **_mat) { *_mat = mat; }
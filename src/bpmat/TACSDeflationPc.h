@@ -0,0 +1,114 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2014 Georgia Tech Research Corporation
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_DEFLATION_PC_H
+#define TACS_DEFLATION_PC_H
+
+#include "GSEP.h"
+#include "TACSBVecInterp.h"
+
+/*!
+  Two-grid deflation preconditioner.
+
+  Thin-shell stiffness matrices carry a cluster of near-kernel modes -
+  the rigid-body modes of each component and its lowest bending modes -
+  whose eigenvalues approach zero as the shell becomes more slender.
+  Local preconditioners such as additive Schwarz or ILU leave these
+  modes nearly untouched, so the Krylov iteration count grows with the
+  slenderness of the structure.
+
+  This preconditioner removes the near-kernel from the iteration. For
+  a deflation subspace W with m columns and the coarse matrix
+
+  E = W^{T} A W,
+
+  the preconditioner applies a coarse correction followed by the inner
+  preconditioner M on the deflated residual:
+
+  y = W E^{-1} W^{T} x + M^{-1} (x - A W E^{-1} W^{T} x)
+
+  The coarse solve is a dense m x m back-substitution that is
+  replicated on every processor, so the only parallel operations per
+  application are the m inner products, one matrix-vector product and
+  the inner preconditioner itself.
+
+  The deflation subspace can be supplied in three ways, which may be
+  combined:
+
+  1. setDeflationVecs() installs precomputed vectors directly - for
+  instance the rigid-body modes of each component.
+
+  2. addCoarseSpace() interpolates vectors from a coarser model
+  through a TACSBVecInterp object, so a coarse modal basis can be
+  computed cheaply and prolongated to the fine space.
+
+  3. computeDeflationModes() computes the lowest eigenmodes of the
+  matrix with the shift-and-invert Lanczos machinery, using the inner
+  preconditioner to accelerate the inverse applications.
+
+  The preconditioner wraps any TACSPc, so it composes with the
+  existing Schwarz and Schur-complement preconditioners without
+  changes to the solver setup.
+*/
+class TACSDeflationPc : public TACSPc {
+ public:
+  TACSDeflationPc(TACSMat *_mat, TACSPc *_pc, int _max_num_vecs);
+  ~TACSDeflationPc();
+
+  // Set the deflation subspace directly
+  void setDeflationVecs(int _num_vecs, TACSVec **_W);
+
+  // Append vectors interpolated from a coarse space
+  void addCoarseSpace(TACSBVecInterp *interp, int nvecs, TACSBVec **coarse);
+
+  // Compute the lowest eigenmodes of the matrix as the deflation
+  // subspace. Returns the number of modes installed.
+  int computeDeflationModes(int num_modes, int max_iters, double eig_tol,
+                            double rtol = 1e-10, double atol = 1e-30);
+
+  // Retrieve the number of vectors in the deflation subspace
+  int getNumDeflationVecs();
+
+  // Factor the inner preconditioner and the coarse matrix
+  void factor();
+
+  // Apply the deflated preconditioner y = M^{-1}_{defl} x
+  void applyFactor(TACSVec *x, TACSVec *y);
+
+  // Get the matrix associated with the inner preconditioner
+  void getMat(TACSMat **_mat);
+
+ private:
+  // Recompute and factor the coarse matrix E = W^{T} A W
+  void factorCoarseMat();
+
+  // The matrix and the inner preconditioner
+  TACSMat *mat;
+  TACSPc *pc;
+
+  // The deflation subspace
+  int max_num_vecs, num_vecs;
+  TACSVec **W;
+
+  // Temporary vectors for the coarse correction
+  TACSVec *wsum, *temp;
+
+  // The dense coarse matrix in column-major order, its LU pivots and
+  // the right-hand side workspace for the coarse solves
+  TacsScalar *E;
+  int *Epiv;
+  TacsScalar *coef;
+};
+
+#endif  // TACS_DEFLATION_PC_H
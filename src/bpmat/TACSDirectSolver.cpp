@@ -0,0 +1,167 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSDirectSolver.h"
+
+#include <stdio.h>
+
+/*
+  Create the Schur-complement direct solver.
+
+  The symbolic analysis is deferred until factorSymbolic() - or the
+  first call to factorNumeric() - so that the matrix can be assembled
+  before the analysis is performed.
+
+  input:
+  mat:      the Schur-complement matrix to factor
+  levFill:  the level of fill used for the local ILU patterns
+  fill:     the expected fill-in ratio of the factorization
+  reorder_schur_complement:  reorder the interface unknowns
+*/
+TACSSchurDirectSolver::TACSSchurDirectSolver(TACSSchurMat *_mat, int _levFill,
+                                             double _fill,
+                                             int _reorder_schur_complement) {
+  mat = _mat;
+  mat->incref();
+  pc = NULL;
+  levFill = _levFill;
+  fill = _fill;
+  reorder_schur_complement = _reorder_schur_complement;
+}
+
+TACSSchurDirectSolver::~TACSSchurDirectSolver() {
+  mat->decref();
+  if (pc) {
+    pc->decref();
+  }
+}
+
+/*
+  Perform the symbolic analysis by constructing the preconditioner
+  object. Any previous analysis is discarded, so this call is also the
+  way to react to a change in the non-zero pattern of the matrix.
+*/
+void TACSSchurDirectSolver::factorSymbolic() {
+  if (pc) {
+    pc->decref();
+  }
+  pc = new TACSSchurPc(mat, levFill, fill, reorder_schur_complement);
+  pc->incref();
+}
+
+/*
+  Compute the numeric factorization. The symbolic patterns stored in
+  the preconditioner object are reused - only the values are
+  recomputed.
+*/
+void TACSSchurDirectSolver::factorNumeric() {
+  if (!pc) {
+    factorSymbolic();
+  }
+  pc->factor();
+}
+
+/*
+  Solve the system with the computed factorization
+*/
+void TACSSchurDirectSolver::solve(TACSVec *rhs, TACSVec *ans) {
+  if (!pc) {
+    fprintf(stderr,
+            "TACSSchurDirectSolver: Must call factorNumeric() "
+            "before solve()\n");
+    return;
+  }
+  pc->applyFactor(rhs, ans);
+}
+
+/*
+  Retrieve the matrix associated with the solver
+*/
+void TACSSchurDirectSolver::getMat(TACSMat **_mat) { *_mat = mat; }
+
+/*
+  Retrieve the preconditioner view of the factorization
+*/
+TACSPc *TACSSchurDirectSolver::getPc() {
+  if (!pc) {
+    factorSymbolic();
+  }
+  return pc;
+}
+
+/*
+  Create the serial partial-pivoting direct solver
+*/
+TACSSerialDirectSolver::TACSSerialDirectSolver(TACSSerialPivotMat *_mat) {
+  mat = _mat;
+  mat->incref();
+  pc = NULL;
+}
+
+TACSSerialDirectSolver::~TACSSerialDirectSolver() {
+  mat->decref();
+  if (pc) {
+    pc->decref();
+  }
+}
+
+/*
+  Set up the factorization object. With partial pivoting the factor
+  pattern depends on the values, so there is no exact pattern to
+  compute here - the state reused across numeric factorizations is the
+  fill estimate accumulated by the preconditioner object.
+*/
+void TACSSerialDirectSolver::factorSymbolic() {
+  if (pc) {
+    pc->decref();
+  }
+  pc = new TACSSerialPivotPc(mat);
+  pc->incref();
+}
+
+/*
+  Compute the numeric factorization
+*/
+void TACSSerialDirectSolver::factorNumeric() {
+  if (!pc) {
+    factorSymbolic();
+  }
+  pc->factor();
+}
+
+/*
+  Solve the system with the computed factorization
+*/
+void TACSSerialDirectSolver::solve(TACSVec *rhs, TACSVec *ans) {
+  if (!pc) {
+    fprintf(stderr,
+            "TACSSerialDirectSolver: Must call factorNumeric() "
+            "before solve()\n");
+    return;
+  }
+  pc->applyFactor(rhs, ans);
+}
+
+/*
+  Retrieve the matrix associated with the solver
+*/
+void TACSSerialDirectSolver::getMat(TACSMat **_mat) { *_mat = mat; }
+
+/*
+  Retrieve the preconditioner view of the factorization
+*/
+TACSPc *TACSSerialDirectSolver::getPc() {
+  if (!pc) {
+    factorSymbolic();
+  }
+  return pc;
+}
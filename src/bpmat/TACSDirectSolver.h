@@ -0,0 +1,120 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_DIRECT_SOLVER_H
+#define TACS_DIRECT_SOLVER_H
+
+/*
+  Interface layer for sparse direct solvers
+*/
+
+#include "TACSSchurMat.h"
+#include "TACSSerialPivotMat.h"
+
+/*!
+  Abstract interface for sparse direct solvers.
+
+  The interface splits the factorization into a symbolic phase, which
+  depends only on the non-zero pattern of the matrix, and a numeric
+  phase, which depends on the values. Callers that refactor the same
+  pattern many times - continuation, buckling and time-integration
+  loops - perform the symbolic analysis once and call only
+  factorNumeric() afterwards. The interface is also the extension
+  point for wrapping external direct solvers behind the TACSMat
+  assembly path: an external implementation maps factorSymbolic() to
+  the solver's analysis call and factorNumeric() to its numeric
+  refactorization.
+
+  The first implementations below wrap the existing internal
+  factorization paths.
+*/
+class TACSDirectSolver : public TACSObject {
+ public:
+  virtual ~TACSDirectSolver() {}
+
+  // Perform the symbolic analysis of the non-zero pattern. This must
+  // be called again if the non-zero pattern of the matrix changes.
+  virtual void factorSymbolic() = 0;
+
+  // Compute the numeric factorization, reusing the symbolic analysis
+  virtual void factorNumeric() = 0;
+
+  // Solve the system using the computed factorization
+  virtual void solve(TACSVec *rhs, TACSVec *ans) = 0;
+
+  // Retrieve the matrix associated with the solver
+  virtual void getMat(TACSMat **_mat) = 0;
+
+  // Retrieve the preconditioner view of the factorization so that the
+  // solver can also be used within the Krylov methods
+  virtual TACSPc *getPc() = 0;
+};
+
+/*!
+  A direct solver built on the Schur-complement factorization.
+
+  The symbolic phase constructs the TACSSchurPc object: the ILU
+  patterns of the local blocks, the reordering of the interface
+  unknowns and the set-up of the block-cyclic Schur complement. The
+  numeric phase fills those patterns with values. Since all of the
+  pattern information lives in the preconditioner object, repeated
+  calls to factorNumeric() pay no symbolic cost.
+*/
+class TACSSchurDirectSolver : public TACSDirectSolver {
+ public:
+  TACSSchurDirectSolver(TACSSchurMat *_mat, int _levFill, double _fill,
+                        int _reorder_schur_complement);
+  ~TACSSchurDirectSolver();
+
+  void factorSymbolic();
+  void factorNumeric();
+  void solve(TACSVec *rhs, TACSVec *ans);
+  void getMat(TACSMat **_mat);
+  TACSPc *getPc();
+
+ private:
+  TACSSchurMat *mat;
+  TACSSchurPc *pc;
+
+  // The fill parameters used for the symbolic analysis
+  int levFill;
+  double fill;
+  int reorder_schur_complement;
+};
+
+/*!
+  A direct solver built on the serial partial-pivoting factorization.
+
+  Partial pivoting couples the pivot sequence - and therefore the
+  factor pattern - to the matrix values, so the numeric phase cannot
+  reuse an exact symbolic pattern. What is reused is the fill estimate
+  accumulated by TACSSerialPivotPc across factorizations, which sizes
+  the factor storage so that repeated refactorizations avoid the
+  repeated reallocation a fresh analysis would pay.
+*/
+class TACSSerialDirectSolver : public TACSDirectSolver {
+ public:
+  TACSSerialDirectSolver(TACSSerialPivotMat *_mat);
+  ~TACSSerialDirectSolver();
+
+  void factorSymbolic();
+  void factorNumeric();
+  void solve(TACSVec *rhs, TACSVec *ans);
+  void getMat(TACSMat **_mat);
+  TACSPc *getPc();
+
+ private:
+  TACSSerialPivotMat *mat;
+  TACSSerialPivotPc *pc;
+};
+
+#endif  // TACS_DIRECT_SOLVER_H
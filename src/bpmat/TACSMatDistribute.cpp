@@ -18,6 +18,8 @@
 
 #include "TACSMatDistribute.h"
 
+#include "TACSProfiler.h"
+
 #include "TacsUtilities.h"
 
 /*
@@ -72,6 +74,13 @@ TACSMatDistribute::TACSMatDistribute(TACSThreadInfo *thread_info,
   row_map = _row_map;
   row_map->incref();
 
+  // Set the tag for the reverse value exchange. Each matrix gets its
+  // own tag so that the receives can be posted before the assembly
+  // starts without matching the messages of another matrix
+  assembly_tag = 5 + tag_value;
+  tag_value++;
+  recvs_posted = 0;
+
   // Get the rank/size of this communicator
   int mpiRank, mpiSize;
   comm = row_map->getMPIComm();
@@ -415,6 +424,16 @@ TACSMatDistribute::TACSMatDistribute(TACSThreadInfo *thread_info,
 }
 
 TACSMatDistribute::~TACSMatDistribute() {
+  // Cancel any receives that were posted ahead of an assembly that
+  // never took place
+  if (recvs_posted) {
+    for (int k = 0; k < num_in_procs; k++) {
+      MPI_Cancel(&in_requests[k]);
+      MPI_Request_free(&in_requests[k]);
+    }
+    recvs_posted = 0;
+  }
+
   row_map->decref();
   delete[] ext_procs;
   delete[] ext_count;
@@ -439,8 +458,43 @@ void TACSMatDistribute::zeroEntries() {
   int ext_len = bsize * bsize * ext_rowp[num_ext_rows];
   memset(ext_A, 0, ext_len * sizeof(TacsScalar));
 
-  int in_len = bsize * bsize * in_rowp[num_in_rows];
-  memset(in_A, 0, in_len * sizeof(TacsScalar));
+  // The incoming buffer is overwritten in full by the receives, so it
+  // is only zeroed when no receives are outstanding
+  if (!recvs_posted) {
+    int in_len = bsize * bsize * in_rowp[num_in_rows];
+    memset(in_A, 0, in_len * sizeof(TacsScalar));
+  }
+
+  // Post the receives for the next assembly now, so that they are in
+  // place for the whole assembly phase before any process reaches its
+  // sends
+  postRecvs();
+}
+
+/*
+  Post the receives for the off-process matrix entries.
+
+  The receives are posted when the matrix is zeroed, well before any
+  process finishes its element loop and starts sending. Early-posted
+  receives let the incoming rows land directly in their buffers as
+  the sends complete, rather than waiting in unexpected-message
+  storage until endAssembly(), and give the reverse exchange the
+  whole assembly phase to make progress.
+*/
+void TACSMatDistribute::postRecvs() {
+  if (!recvs_posted) {
+    const int b2 = bsize * bsize;
+
+    for (int k = 0; k < num_in_procs; k++) {
+      int start = in_rowp[in_row_ptr[k]];
+      int count = b2 * (in_rowp[in_row_ptr[k + 1]] - start);
+      int source = in_procs[k];
+      MPI_Irecv(&in_A[b2 * start], count, TACS_MPI_TYPE, source, assembly_tag,
+                comm, &in_requests[k]);
+    }
+
+    recvs_posted = 1;
+  }
 }
 
 /*!
@@ -1158,31 +1212,44 @@ void TACSMatDistribute::beginAssembly(TACSParallelMat *mat) {
   // Get the block size squared
   const int b2 = bsize * bsize;
 
-  // Post the recvs
-  for (int k = 0, offset = 0, buff_offset = 0; k < num_in_procs; k++) {
-    int count = in_rowp[offset + in_count[k]] - in_rowp[offset];
-    count *= b2;
+  // Ensure that the receives are posted. The receives are normally
+  // posted when the matrix entries are zeroed, before the element
+  // loop starts
+  postRecvs();
 
-    int source = in_procs[k];
-    int tag = 5;
-    MPI_Irecv(&in_A[buff_offset], count, TACS_MPI_TYPE, source, tag, comm,
-              &in_requests[k]);
-    offset += in_count[k];
-    buff_offset += count;
+  // Post the sends, largest first, so that the biggest transfers get
+  // the most time to overlap with the remaining local work
+  int *send_order = new int[num_ext_procs];
+  for (int k = 0; k < num_ext_procs; k++) {
+    send_order[k] = k;
+  }
+  for (int k = 0; k < num_ext_procs; k++) {
+    int largest = k;
+    for (int j = k + 1; j < num_ext_procs; j++) {
+      int count_j = (ext_rowp[ext_row_ptr[send_order[j] + 1]] -
+                     ext_rowp[ext_row_ptr[send_order[j]]]);
+      int count_l = (ext_rowp[ext_row_ptr[send_order[largest] + 1]] -
+                     ext_rowp[ext_row_ptr[send_order[largest]]]);
+      if (count_j > count_l) {
+        largest = j;
+      }
+    }
+    int temp = send_order[k];
+    send_order[k] = send_order[largest];
+    send_order[largest] = temp;
   }
 
-  // Post the sends
-  for (int k = 0, offset = 0, buff_offset = 0; k < num_ext_procs; k++) {
-    int count = ext_rowp[offset + ext_count[k]] - ext_rowp[offset];
-    count *= b2;
+  for (int k = 0; k < num_ext_procs; k++) {
+    int index = send_order[k];
+    int start = ext_rowp[ext_row_ptr[index]];
+    int count = b2 * (ext_rowp[ext_row_ptr[index + 1]] - start);
 
-    int dest = ext_procs[k];
-    int tag = 5;
-    MPI_Isend(&ext_A[buff_offset], count, TACS_MPI_TYPE, dest, tag, comm,
-              &ext_requests[k]);
-    offset += ext_count[k];
-    buff_offset += count;
+    int dest = ext_procs[index];
+    MPI_Isend(&ext_A[b2 * start], count, TACS_MPI_TYPE, dest, assembly_tag,
+              comm, &ext_requests[index]);
   }
+
+  delete[] send_order;
 }
 
 /*
@@ -1218,7 +1285,9 @@ void TACSMatDistribute::endAssembly(TACSParallelMat *mat) {
     // Get the recv that just completed
     int index;
     MPI_Status status;
+    double twait = MPI_Wtime();
     int ierr = MPI_Waitany(num_in_procs, in_requests, &index, &status);
+    TacsProfileAddWait("MatDistribute.assembly", MPI_Wtime() - twait);
 
     // Check whether the recv was successful
     if (ierr != MPI_SUCCESS) {
@@ -1260,8 +1329,15 @@ void TACSMatDistribute::endAssembly(TACSParallelMat *mat) {
     }
   }
 
+  // All the receives have now completed
+  recvs_posted = 0;
+
   // Wait for all the sending requests
   if (num_ext_procs > 0) {
+    double twait = MPI_Wtime();
     MPI_Waitall(num_ext_procs, ext_requests, MPI_STATUSES_IGNORE);
+    TacsProfileAddWait("MatDistribute.assembly", MPI_Wtime() - twait);
   }
 }
+
+int TACSMatDistribute::tag_value = 0;
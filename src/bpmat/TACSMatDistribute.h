@@ -67,6 +67,9 @@ class TACSMatDistribute : public TACSObject {
                        int **_Arowp, int **_Acols, int *_Np, int **_Browp,
                        int **_Bcols);
 
+  // Post the receives for the reverse value exchange
+  void postRecvs();
+
   // Variables for the column map
   // ----------------------------
   int col_map_size;
@@ -105,6 +108,14 @@ class TACSMatDistribute : public TACSObject {
   int *in_cols;      // Global column indices
   MPI_Request *in_requests;  // Requests for recving data
   TacsScalar *in_A;
+
+  // Tag used for the reverse value exchange. Each matrix uses its own
+  // tag so that the receives can be posted ahead of the assembly
+  // without matching the exchange of another matrix on the same
+  // communicator
+  int assembly_tag;
+  int recvs_posted;  // Flag indicating the receives are outstanding
+  static int tag_value;
 };
 
 #endif  // TACS_MAT_DISTRIBUTE_H
@@ -20,6 +20,8 @@
 
 #include <stdio.h>
 
+#include "BCSRMatImpl.h"
+#include "TACSSerialPivotMat.h"
 #include "tacslapack.h"
 
 /*!
@@ -92,6 +94,15 @@ void TACSParallelMat::init(TACSNodeMap *_rmap, BCSRMat *_Aloc, BCSRMat *_Bext,
   ext_dist = NULL;
   x_ext = NULL;
 
+  // The multiple right-hand side data is allocated on the first
+  // call to multRHS()
+  max_nrhs = 0;
+  rhs_ctx = NULL;
+  x_ext_rhs = NULL;
+  x_rhs = NULL;
+  y_rhs = NULL;
+  y_ext_rhs = NULL;
+
   N = Aloc->getRowDim();
   if (N != Aloc->getColDim()) {
     fprintf(stderr,
@@ -158,6 +169,24 @@ TACSParallelMat::~TACSParallelMat() {
   if (x_ext) {
     delete[] x_ext;
   }
+  if (rhs_ctx) {
+    for (int i = 0; i < max_nrhs; i++) {
+      rhs_ctx[i]->decref();
+    }
+    delete[] rhs_ctx;
+  }
+  if (x_ext_rhs) {
+    delete[] x_ext_rhs;
+  }
+  if (x_rhs) {
+    delete[] x_rhs;
+  }
+  if (y_rhs) {
+    delete[] y_rhs;
+  }
+  if (y_ext_rhs) {
+    delete[] y_ext_rhs;
+  }
 }
 
 TACSMat *TACSParallelMat::createDuplicate() {
@@ -264,6 +293,110 @@ void TACSParallelMat::mult(TACSVec *txvec, TACSVec *tyvec) {
   }
 }
 
+/*!
+  Matrix multiplication with multiple right-hand sides
+
+  The input vectors are packed into a single multivector with the
+  layout x[bsize*(nrhs*node + rhs)] so that each block row of the
+  matrix is streamed through memory only once for all nrhs products.
+  The forward scatters for all of the vectors are overlapped with the
+  local product. The contexts and packed multivectors are allocated
+  on the first call and re-used on subsequent calls.
+*/
+void TACSParallelMat::multRHS(int nrhs, TACSVec **txvec, TACSVec **tyvec) {
+  if (nrhs == 1) {
+    mult(txvec[0], tyvec[0]);
+    return;
+  }
+
+  // Check that all of the input/output vectors are TACSBVec objects
+  TacsScalar **x = new TacsScalar *[nrhs];
+  TacsScalar **y = new TacsScalar *[nrhs];
+  for (int r = 0; r < nrhs; r++) {
+    TACSBVec *xvec = dynamic_cast<TACSBVec *>(txvec[r]);
+    TACSBVec *yvec = dynamic_cast<TACSBVec *>(tyvec[r]);
+    if (!xvec || !yvec) {
+      fprintf(stderr, "PMat type error: Input/output must be TACSBVec\n");
+      delete[] x;
+      delete[] y;
+      return;
+    }
+    xvec->getArray(&x[r]);
+    yvec->getArray(&y[r]);
+  }
+
+  // Allocate (or grow) the contexts and the packed multivectors
+  const int next = ext_dist->getNumNodes();
+  if (nrhs > max_nrhs) {
+    if (rhs_ctx) {
+      for (int i = 0; i < max_nrhs; i++) {
+        rhs_ctx[i]->decref();
+      }
+      delete[] rhs_ctx;
+      delete[] x_ext_rhs;
+      delete[] x_rhs;
+      delete[] y_rhs;
+      delete[] y_ext_rhs;
+    }
+    max_nrhs = nrhs;
+    rhs_ctx = new TACSBVecDistCtx *[max_nrhs];
+    for (int i = 0; i < max_nrhs; i++) {
+      rhs_ctx[i] = ext_dist->createCtx(bsize);
+      rhs_ctx[i]->incref();
+    }
+    x_ext_rhs = new TacsScalar[max_nrhs * bsize * next];
+    x_rhs = new TacsScalar[max_nrhs * bsize * N];
+    y_rhs = new TacsScalar[max_nrhs * bsize * N];
+    y_ext_rhs = new TacsScalar[max_nrhs * bsize * Nc];
+  }
+
+  // Begin the forward scatter for each right-hand side
+  for (int r = 0; r < nrhs; r++) {
+    ext_dist->beginForward(rhs_ctx[r], x[r], &x_ext_rhs[bsize * next * r]);
+  }
+
+  // Pack the local values and compute the local product
+  for (int i = 0; i < N; i++) {
+    for (int r = 0; r < nrhs; r++) {
+      memcpy(&x_rhs[bsize * (nrhs * i + r)], &x[r][bsize * i],
+             bsize * sizeof(TacsScalar));
+    }
+  }
+  Aloc->multRHS(nrhs, x_rhs, y_rhs);
+
+  // Finish the scatters and pack the external values
+  for (int r = 0; r < nrhs; r++) {
+    ext_dist->endForward(rhs_ctx[r], x[r], &x_ext_rhs[bsize * next * r]);
+  }
+  for (int i = 0; i < next; i++) {
+    for (int r = 0; r < nrhs; r++) {
+      memcpy(&x_rhs[bsize * (nrhs * i + r)],
+             &x_ext_rhs[bsize * (next * r + i)], bsize * sizeof(TacsScalar));
+    }
+  }
+
+  // Compute the external contribution and unpack the result
+  Bext->multRHS(nrhs, x_rhs, y_ext_rhs);
+  for (int i = 0; i < Np; i++) {
+    for (int r = 0; r < nrhs; r++) {
+      memcpy(&y[r][bsize * i], &y_rhs[bsize * (nrhs * i + r)],
+             bsize * sizeof(TacsScalar));
+    }
+  }
+  for (int i = Np; i < N; i++) {
+    for (int r = 0; r < nrhs; r++) {
+      const TacsScalar *yl = &y_rhs[bsize * (nrhs * i + r)];
+      const TacsScalar *ye = &y_ext_rhs[bsize * (nrhs * (i - Np) + r)];
+      for (int k = 0; k < bsize; k++) {
+        y[r][bsize * i + k] = yl[k] + ye[k];
+      }
+    }
+  }
+
+  delete[] x;
+  delete[] y;
+}
+
 /*!
   Matrix multiplication
 */
@@ -287,6 +420,18 @@ void TACSParallelMat::multTranspose(TACSVec *txvec, TACSVec *tyvec) {
   }
 }
 
+/*!
+  Enable or disable explicit transpose storage for the local matrices.
+
+  When enabled, multTranspose uses explicit copies of the transposed
+  local matrices, which are built once per assembly and reused across
+  all subsequent transpose products - see BCSRMat::setStoreTranspose.
+*/
+void TACSParallelMat::setStoreTranspose(int flag) {
+  Aloc->setStoreTranspose(flag);
+  Bext->setStoreTranspose(flag);
+}
+
 /*!
   Access the underlying matrices
 */
@@ -348,25 +493,38 @@ void TACSParallelMat::applyBCs(TACSBcMap *bcmap) {
     MPI_Comm_rank(rmap->getMPIComm(), &mpi_rank);
     rmap->getOwnerRange(&ownerRange);
 
-    // apply the boundary conditions
-    const int *nodes, *vars;
-    int nbcs = bcmap->getBCs(&nodes, &vars, NULL);
+    // Apply the boundary conditions using the run-length-encoded
+    // ranges so that contiguous clamped rows are zeroed in single
+    // sweeps through the matrix values
+    const int *range_nodes, *range_counts, *range_vars;
+    int nranges = bcmap->getBCRanges(&range_nodes, &range_counts, &range_vars);
+
+    for (int i = 0; i < nranges; i++) {
+      // Clip the range against the ownership interval
+      int start = range_nodes[i];
+      int end = range_nodes[i] + range_counts[i];
+      if (start < ownerRange[mpi_rank]) {
+        start = ownerRange[mpi_rank];
+      }
+      if (end > ownerRange[mpi_rank + 1]) {
+        end = ownerRange[mpi_rank + 1];
+      }
 
-    // Get the matrix values
-    for (int i = 0; i < nbcs; i++) {
-      // Find block i and zero out the variables associated with it
-      if (nodes[i] >= ownerRange[mpi_rank] &&
-          nodes[i] < ownerRange[mpi_rank + 1]) {
-        int bvar = nodes[i] - ownerRange[mpi_rank];
+      if (start < end) {
+        int bvar = start - ownerRange[mpi_rank];
+        int count = end - start;
         int ident = 1;  // Replace the diagonal with the identity matrix
-        Aloc->zeroRow(bvar, vars[i], ident);
-
-        // Now, check if the variable will be
-        // in the off diagonal block (potentially)
-        bvar = bvar - (N - Nc);
-        if (bvar >= 0) {
+        Aloc->zeroRows(bvar, count, range_vars[i], ident);
+
+        // Now, check whether the rows overlap the off-diagonal block
+        int bstart = bvar - (N - Nc);
+        int bend = bstart + count;
+        if (bend > 0) {
+          if (bstart < 0) {
+            bstart = 0;
+          }
           ident = 0;
-          Bext->zeroRow(bvar, vars[i], ident);
+          Bext->zeroRows(bstart, bend - bstart, range_vars[i], ident);
         }
       }
     }
@@ -490,6 +648,69 @@ void TACSParallelMat::printNzPattern(const char *fileName) {
   }
 }
 
+/*!
+  Write the local matrix blocks to binary files.
+
+  One file per rank is written for each of the diagonal and
+  off-diagonal blocks, named <fname>.A.<rank> and <fname>.B.<rank>.
+  The layout of each file is described in BCSRMat::writeToFile().
+
+  Returns 0 on success on all ranks, 1 otherwise.
+*/
+int TACSParallelMat::writeToFile(const char *fname) {
+  int mpi_rank;
+  MPI_Comm_rank(rmap->getMPIComm(), &mpi_rank);
+
+  // Create the file names for the local blocks
+  size_t len = strlen(fname) + 32;
+  char *name = new char[len];
+
+  snprintf(name, len, "%s.A.%d", fname, mpi_rank);
+  int fail = Aloc->writeToFile(name);
+
+  snprintf(name, len, "%s.B.%d", fname, mpi_rank);
+  fail = Bext->writeToFile(name) || fail;
+  delete[] name;
+
+  // Fail on all ranks if any rank failed
+  int temp = fail;
+  MPI_Allreduce(&temp, &fail, 1, MPI_INT, MPI_MAX, rmap->getMPIComm());
+
+  return fail;
+}
+
+/*!
+  Read the local matrix block values from binary files written by
+  writeToFile().
+
+  The matrix must be created with the same non-zero structure and the
+  same number of ranks as the matrix that was written: only the block
+  values are loaded, so no symbolic computation is required.
+
+  Returns 0 on success on all ranks, 1 otherwise.
+*/
+int TACSParallelMat::readFromFile(const char *fname) {
+  int mpi_rank;
+  MPI_Comm_rank(rmap->getMPIComm(), &mpi_rank);
+
+  // Create the file names for the local blocks
+  size_t len = strlen(fname) + 32;
+  char *name = new char[len];
+
+  snprintf(name, len, "%s.A.%d", fname, mpi_rank);
+  int fail = Aloc->readFromFile(name);
+
+  snprintf(name, len, "%s.B.%d", fname, mpi_rank);
+  fail = Bext->readFromFile(name) || fail;
+  delete[] name;
+
+  // Fail on all ranks if any rank failed
+  int temp = fail;
+  MPI_Allreduce(&temp, &fail, 1, MPI_INT, MPI_MAX, rmap->getMPIComm());
+
+  return fail;
+}
+
 /*!
   Add values to the matrix.
 
@@ -865,6 +1086,497 @@ void TACSGaussSeidel::applyFactor(TACSVec *txvec, TACSVec *tyvec) {
 */
 void TACSGaussSeidel::getMat(TACSMat **_mat) { *_mat = mat; }
 
+/*
+  Create the block-Jacobi smoother object
+
+  input:
+  mat:    the parallel matrix
+  omega:  the damping factor
+  iters:  the number of Jacobi iterations to apply
+*/
+TACSBlockJacobi::TACSBlockJacobi(TACSParallelMat *_mat, TacsScalar _omega,
+                                 int _iters) {
+  mat = _mat;
+  mat->incref();
+
+  // Create a vector to store the residual for multi-iteration sweeps
+  TACSVec *trvec = mat->createVec();
+  rvec = dynamic_cast<TACSBVec *>(trvec);
+  if (rvec) {
+    rvec->incref();
+  } else {
+    fprintf(stderr, "TACSBlockJacobi error: Input/output must be TACSBVec\n");
+  }
+
+  // The inverted diagonal blocks are computed in factor()
+  Dinv = NULL;
+
+  // Store the relaxation options
+  omega = _omega;
+  iters = _iters;
+}
+
+/*
+  Free the block-Jacobi smoother
+*/
+TACSBlockJacobi::~TACSBlockJacobi() {
+  mat->decref();
+  if (rvec) {
+    rvec->decref();
+  }
+  if (Dinv) {
+    delete[] Dinv;
+  }
+}
+
+/*
+  Factor the diagonal blocks of the matrix
+
+  This computes and stores the inverse of each diagonal block so that
+  the apply phase consists of independent block-diagonal products.
+*/
+void TACSBlockJacobi::factor() {
+  // Get the local part of the matrix
+  BCSRMat *A, *B;
+  mat->getBCSRMat(&A, &B);
+  BCSRMatData *Adata = A->getMatData();
+
+  // Get the number of variables in the row map
+  int bsize, N, Nc;
+  mat->getRowMap(&bsize, &N, &Nc);
+  const int b2 = bsize * bsize;
+
+  // Allocate the inverted diagonal block storage on the first call
+  if (!Dinv) {
+    Dinv = new TacsScalar[b2 * N];
+  }
+
+  TacsScalar *D = new TacsScalar[b2];
+  int *ipiv = new int[bsize];
+
+  for (int i = 0; i < N; i++) {
+    // Locate the diagonal block within the row
+    int jp = 0;
+    if (Adata->diag) {
+      jp = Adata->diag[i];
+    } else {
+      for (jp = Adata->rowp[i]; jp < Adata->rowp[i + 1]; jp++) {
+        if (Adata->cols[jp] == i) {
+          break;
+        }
+      }
+    }
+
+    // Invert the diagonal block
+    memcpy(D, &Adata->A[b2 * jp], b2 * sizeof(TacsScalar));
+    int fail = BMatComputeInverse(&Dinv[b2 * i], D, ipiv, bsize);
+    if (fail) {
+      fprintf(stderr,
+              "TACSBlockJacobi error: Failure in block diagonal inverse %d in "
+              "row %d\n",
+              fail, i);
+    }
+  }
+
+  delete[] D;
+  delete[] ipiv;
+}
+
+/*
+  Apply the block-Jacobi smoother: y = omega*D^{-1}*x
+
+  For additional iterations, the damped Jacobi update
+
+  y <- y + omega*D^{-1}*(x - A*y)
+
+  is applied using the full parallel matrix-vector product, which
+  overlaps the off-processor exchange with the local product.
+*/
+void TACSBlockJacobi::applyFactor(TACSVec *txvec, TACSVec *tyvec) {
+  // Convert to TACSBVec objects
+  TACSBVec *xvec, *yvec;
+  xvec = dynamic_cast<TACSBVec *>(txvec);
+  yvec = dynamic_cast<TACSBVec *>(tyvec);
+
+  if (xvec && yvec) {
+    // Retrieve the values from the input vectors
+    TacsScalar *x, *y, *r;
+    xvec->getArray(&x);
+    yvec->getArray(&y);
+    rvec->getArray(&r);
+
+    // Get the number of variables in the row map
+    int bsize, N, Nc;
+    mat->getRowMap(&bsize, &N, &Nc);
+    const int b2 = bsize * bsize;
+
+    // Apply the first iteration: y = omega*D^{-1}*x. Each block row
+    // is independent so the sweep is limited only by memory bandwidth.
+    for (int i = 0; i < N; i++) {
+      const TacsScalar *d = &Dinv[b2 * i];
+      const TacsScalar *xi = &x[bsize * i];
+      TacsScalar *yi = &y[bsize * i];
+      for (int ii = 0; ii < bsize; ii++) {
+        TacsScalar t = 0.0;
+        for (int jj = 0; jj < bsize; jj++) {
+          t += d[bsize * ii + jj] * xi[jj];
+        }
+        yi[ii] = omega * t;
+      }
+    }
+
+    // Apply the damped Jacobi update for the remaining iterations
+    for (int iter = 1; iter < iters; iter++) {
+      // Compute the residual r = x - A*y
+      mat->mult(yvec, rvec);
+      for (int i = 0; i < bsize * N; i++) {
+        r[i] = x[i] - r[i];
+      }
+
+      // Update y <- y + omega*D^{-1}*r
+      for (int i = 0; i < N; i++) {
+        const TacsScalar *d = &Dinv[b2 * i];
+        const TacsScalar *ri = &r[bsize * i];
+        TacsScalar *yi = &y[bsize * i];
+        for (int ii = 0; ii < bsize; ii++) {
+          TacsScalar t = 0.0;
+          for (int jj = 0; jj < bsize; jj++) {
+            t += d[bsize * ii + jj] * ri[jj];
+          }
+          yi[ii] += omega * t;
+        }
+      }
+    }
+  } else {
+    fprintf(stderr,
+            "TACSBlockJacobi type error: Input/output must be TACSBVec\n");
+  }
+}
+
+/*
+  Retrieve the underlying matrix
+*/
+void TACSBlockJacobi::getMat(TACSMat **_mat) { *_mat = mat; }
+
+/*
+  Create the multicolor block-SOR smoother
+
+  input:
+  mat:        the parallel matrix
+  zero_guess: flag to indicate whether to zero the initial guess
+  omega:      the relaxation factor
+  iters:      the number of sweeps to apply
+  symmetric:  flag to indicate whether to use the symmetric variant
+*/
+TACSMulticolorSOR::TACSMulticolorSOR(TACSParallelMat *_mat, int _zero_guess,
+                                     TacsScalar _omega, int _iters,
+                                     int _symmetric) {
+  mat = _mat;
+  mat->incref();
+
+  // Get the on- and off-diagonal components of the matrix
+  mat->getBCSRMat(&Aloc, &Bext);
+  Aloc->incref();
+  Bext->incref();
+
+  // Get the number of variables in the row map
+  int bsize, N, Nc;
+  mat->getRowMap(&bsize, &N, &Nc);
+
+  // Compute the offset to the off-processor terms
+  ext_offset = bsize * (N - Nc);
+
+  // Get the external column map - a VecDistribute object
+  mat->getExtColMap(&ext_dist);
+  ext_dist->incref();
+  ctx = ext_dist->createCtx(bsize);
+  ctx->incref();
+
+  // Compute the size of the external components
+  int ysize = bsize * ext_dist->getNumNodes();
+  yext = new TacsScalar[ysize];
+
+  // The inverted diagonal blocks and the coloring are computed in
+  // factor()
+  Dinv = NULL;
+  num_colors = 0;
+  color_ptr = NULL;
+  color_rows = NULL;
+
+  // Store the relaxation options
+  zero_guess = _zero_guess;
+  omega = _omega;
+  iters = _iters;
+  symmetric = _symmetric;
+}
+
+/*
+  Free the multicolor block-SOR smoother
+*/
+TACSMulticolorSOR::~TACSMulticolorSOR() {
+  mat->decref();
+  Aloc->decref();
+  Bext->decref();
+  ext_dist->decref();
+  ctx->decref();
+  delete[] yext;
+  if (Dinv) {
+    delete[] Dinv;
+  }
+  if (color_ptr) {
+    delete[] color_ptr;
+  }
+  if (color_rows) {
+    delete[] color_rows;
+  }
+}
+
+/*
+  Factor the diagonal blocks of the matrix and color the local rows
+
+  The inverse of each diagonal block is computed and stored so that
+  the sweeps consist of block products only. On the first call, the
+  local block rows are colored with a first-fit greedy algorithm over
+  the local non-zero pattern. Since the finite-element matrices are
+  structurally symmetric, the greedy pass guarantees that no two
+  coupled rows share a color, so the rows within each color can be
+  relaxed independently.
+*/
+void TACSMulticolorSOR::factor() {
+  BCSRMatData *Adata = Aloc->getMatData();
+
+  // Get the number of variables in the row map
+  int bsize, N, Nc;
+  mat->getRowMap(&bsize, &N, &Nc);
+  const int b2 = bsize * bsize;
+
+  // Allocate the inverted diagonal block storage on the first call
+  if (!Dinv) {
+    Dinv = new TacsScalar[b2 * N];
+  }
+
+  TacsScalar *D = new TacsScalar[b2];
+  int *ipiv = new int[bsize];
+
+  for (int i = 0; i < N; i++) {
+    // Locate the diagonal block within the row
+    int jp = 0;
+    if (Adata->diag) {
+      jp = Adata->diag[i];
+    } else {
+      for (jp = Adata->rowp[i]; jp < Adata->rowp[i + 1]; jp++) {
+        if (Adata->cols[jp] == i) {
+          break;
+        }
+      }
+    }
+
+    // Invert the diagonal block
+    memcpy(D, &Adata->A[b2 * jp], b2 * sizeof(TacsScalar));
+    int fail = BMatComputeInverse(&Dinv[b2 * i], D, ipiv, bsize);
+    if (fail) {
+      fprintf(stderr,
+              "TACSMulticolorSOR error: Failure in block diagonal inverse %d "
+              "in row %d\n",
+              fail, i);
+    }
+  }
+
+  delete[] D;
+  delete[] ipiv;
+
+  // Color the local rows on the first call - the non-zero pattern
+  // does not change between factorizations
+  if (!color_rows) {
+    int *colors = new int[N];
+    for (int i = 0; i < N; i++) {
+      colors[i] = -1;
+    }
+
+    num_colors = 0;
+    int *mask = new int[N];
+    memset(mask, 0, N * sizeof(int));
+
+    for (int i = 0; i < N; i++) {
+      // Mark the colors of the neighboring rows
+      for (int jp = Adata->rowp[i]; jp < Adata->rowp[i + 1]; jp++) {
+        int j = Adata->cols[jp];
+        if (j < N && colors[j] >= 0) {
+          mask[colors[j]] = i + 1;
+        }
+      }
+
+      // Assign the first color not used by any neighbor
+      int c = 0;
+      while (mask[c] == i + 1) {
+        c++;
+      }
+      colors[i] = c;
+      if (c + 1 > num_colors) {
+        num_colors = c + 1;
+      }
+    }
+
+    delete[] mask;
+
+    // Sort the rows by color with a counting sort
+    color_ptr = new int[num_colors + 1];
+    memset(color_ptr, 0, (num_colors + 1) * sizeof(int));
+    for (int i = 0; i < N; i++) {
+      color_ptr[colors[i] + 1]++;
+    }
+    for (int c = 0; c < num_colors; c++) {
+      color_ptr[c + 1] += color_ptr[c];
+    }
+
+    color_rows = new int[N];
+    int *next = new int[num_colors];
+    memcpy(next, color_ptr, num_colors * sizeof(int));
+    for (int i = 0; i < N; i++) {
+      color_rows[next[colors[i]]] = i;
+      next[colors[i]]++;
+    }
+
+    delete[] next;
+    delete[] colors;
+  }
+}
+
+/*
+  Relax all of the rows of a single color
+
+  Since no two rows of the same color are coupled, the rows can be
+  updated in any order:
+
+  y_i <- (1 - omega)*y_i + omega*D_i^{-1}*(x_i - sum_{j != i} A_ij*y_j)
+
+  The off-processor contributions use the values in yext from the
+  most recent exchange.
+*/
+void TACSMulticolorSOR::relaxColor(int color, int bsize, int offset,
+                                   const TacsScalar *x, TacsScalar *y) {
+  BCSRMatData *Adata = Aloc->getMatData();
+  BCSRMatData *Bdata = Bext->getMatData();
+  const int b2 = bsize * bsize;
+
+  TacsScalar *r = new TacsScalar[bsize];
+
+  for (int ip = color_ptr[color]; ip < color_ptr[color + 1]; ip++) {
+    int i = color_rows[ip];
+
+    // Compute the residual r = x_i - sum_{j != i} A_ij*y_j
+    memcpy(r, &x[bsize * i], bsize * sizeof(TacsScalar));
+    for (int jp = Adata->rowp[i]; jp < Adata->rowp[i + 1]; jp++) {
+      int j = Adata->cols[jp];
+      if (j != i) {
+        const TacsScalar *a = &Adata->A[b2 * jp];
+        const TacsScalar *yj = &y[bsize * j];
+        for (int ii = 0; ii < bsize; ii++) {
+          TacsScalar t = 0.0;
+          for (int jj = 0; jj < bsize; jj++) {
+            t += a[bsize * ii + jj] * yj[jj];
+          }
+          r[ii] -= t;
+        }
+      }
+    }
+
+    // Add the off-processor coupling for the interface rows
+    if (i >= offset) {
+      int bi = i - offset;
+      for (int jp = Bdata->rowp[bi]; jp < Bdata->rowp[bi + 1]; jp++) {
+        const TacsScalar *a = &Bdata->A[b2 * jp];
+        const TacsScalar *yj = &yext[bsize * Bdata->cols[jp]];
+        for (int ii = 0; ii < bsize; ii++) {
+          TacsScalar t = 0.0;
+          for (int jj = 0; jj < bsize; jj++) {
+            t += a[bsize * ii + jj] * yj[jj];
+          }
+          r[ii] -= t;
+        }
+      }
+    }
+
+    // Apply the relaxation with the inverted diagonal block
+    const TacsScalar *d = &Dinv[b2 * i];
+    TacsScalar *yi = &y[bsize * i];
+    for (int ii = 0; ii < bsize; ii++) {
+      TacsScalar t = 0.0;
+      for (int jj = 0; jj < bsize; jj++) {
+        t += d[bsize * ii + jj] * r[jj];
+      }
+      yi[ii] = (1.0 - omega) * yi[ii] + omega * t;
+    }
+  }
+
+  delete[] r;
+}
+
+/*
+  Apply the multicolor block-SOR smoother
+
+  Each sweep exchanges the off-processor values once and then relaxes
+  the colors in sequence (and in reverse for the symmetric variant).
+  The delayed off-processor updates make this a hybrid
+  Jacobi/multicolor-SOR method in parallel.
+*/
+void TACSMulticolorSOR::applyFactor(TACSVec *txvec, TACSVec *tyvec) {
+  // Convert to TACSBVec objects
+  TACSBVec *xvec, *yvec;
+  xvec = dynamic_cast<TACSBVec *>(txvec);
+  yvec = dynamic_cast<TACSBVec *>(tyvec);
+
+  if (xvec && yvec) {
+    // Retrieve the values from the input vectors
+    TacsScalar *x, *y;
+    xvec->getArray(&x);
+    yvec->getArray(&y);
+
+    // Get the number of variables in the row map
+    int bsize, N, Nc;
+    mat->getRowMap(&bsize, &N, &Nc);
+    const int offset = N - Nc;
+
+    if (zero_guess) {
+      yvec->zeroEntries();
+      int ysize = bsize * ext_dist->getNumNodes();
+      memset(yext, 0, ysize * sizeof(TacsScalar));
+    } else {
+      // Exchange the external-interface values
+      ext_dist->beginForward(ctx, y, yext);
+      ext_dist->endForward(ctx, y, yext);
+    }
+
+    for (int iter = 0; iter < iters; iter++) {
+      if (iter > 0) {
+        // Refresh the external-interface values
+        ext_dist->beginForward(ctx, y, yext);
+        ext_dist->endForward(ctx, y, yext);
+      }
+
+      // Relax the colors in sequence
+      for (int c = 0; c < num_colors; c++) {
+        relaxColor(c, bsize, offset, x, y);
+      }
+
+      if (symmetric) {
+        // Relax the colors in reverse
+        for (int c = num_colors - 1; c >= 0; c--) {
+          relaxColor(c, bsize, offset, x, y);
+        }
+      }
+    }
+  } else {
+    fprintf(stderr,
+            "TACSMulticolorSOR type error: Input/output must be TACSBVec\n");
+  }
+}
+
+/*
+  Retrieve the underlying matrix
+*/
+void TACSMulticolorSOR::getMat(TACSMat **_mat) { *_mat = mat; }
+
 /*
   Create the Chebyshev smoother object
 */
@@ -894,6 +1606,12 @@ TACSChebyshevSmoother::TACSChebyshevSmoother(TACSMat *_mat, int _degree,
   // Set the numger of iterations
   iters = _iters;
 
+  // Use the cached power-iteration spectral estimate by default
+  power_iters = 15;
+  rho_rtol = 0.05;
+  rho_cached = -1.0;
+  power_vec = NULL;
+
   // Compute the order
   degree = _degree;
   alpha = beta = 0.0;
@@ -919,6 +1637,29 @@ TACSChebyshevSmoother::~TACSChebyshevSmoother() {
   h->decref();
   t->decref();
   res->decref();
+  if (power_vec) {
+    power_vec->decref();
+  }
+}
+
+/*
+  Set the controls for the cached power-iteration spectral estimate.
+
+  input:
+  power_iters: the maximum power iterations per re-estimate; zero
+               falls back to the Gershgorin/Arnoldi estimate
+  rho_rtol:    relative drift in the estimate that triggers a full
+               re-estimate
+*/
+void TACSChebyshevSmoother::setSpectralEstimator(int _power_iters,
+                                                 double _rho_rtol) {
+  power_iters = _power_iters;
+  if (_rho_rtol > 0.0) {
+    rho_rtol = _rho_rtol;
+  }
+
+  // Invalidate the cached estimate
+  rho_cached = -1.0;
 }
 
 /*
@@ -935,12 +1676,16 @@ void TACSChebyshevSmoother::factor() {
   // Compute the spectral radius
   double rho = 1.0;
 
-  // Check if this is a TACSParallelMat
-  TACSParallelMat *pmat = dynamic_cast<TACSParallelMat *>(mat);
-  if (pmat) {
-    rho = gershgorin(pmat);
+  if (power_iters > 0) {
+    rho = powerEstimate();
   } else {
-    rho = arnoldi(10, mat);
+    // Check if this is a TACSParallelMat
+    TACSParallelMat *pmat = dynamic_cast<TACSParallelMat *>(mat);
+    if (pmat) {
+      rho = gershgorin(pmat);
+    } else {
+      rho = arnoldi(10, mat);
+    }
   }
 
   // Compute the factor
@@ -1018,6 +1763,66 @@ void TACSChebyshevSmoother::applyFactor(TACSVec *tx, TACSVec *ty) {
 */
 void TACSChebyshevSmoother::getMat(TACSMat **_mat) { *_mat = mat; }
 
+/*
+  Estimate the spectral radius by power iteration with the estimate
+  cached across factorizations.
+
+  The power iterate persists between calls. Each factorization first
+  advances the iterate by a single matrix-vector product: in a
+  transient run, where the matrix changes slowly between the many
+  factorizations, this one product both verifies and sharpens the
+  cached estimate. The full power iteration only re-runs when the
+  single-step estimate drifts from the cached value by more than the
+  relative tolerance.
+*/
+double TACSChebyshevSmoother::powerEstimate() {
+  // Create and seed the power iterate on the first call
+  if (!power_vec) {
+    power_vec = dynamic_cast<TACSBVec *>(mat->createVec());
+    power_vec->incref();
+    power_vec->setRand(-1.0, 1.0);
+    double vnorm = TacsRealPart(power_vec->norm());
+    if (vnorm != 0.0) {
+      power_vec->scale(1.0 / vnorm);
+    }
+  }
+
+  // Advance the iterate by one step and estimate the spectral radius
+  mat->mult(power_vec, t);
+  double rho = TacsRealPart(t->norm());
+  if (rho != 0.0) {
+    t->scale(1.0 / rho);
+    power_vec->copyValues(t);
+  }
+
+  // Re-use the cached estimate when the single-step value has not
+  // drifted appreciably
+  if (rho_cached > 0.0 && fabs(rho - rho_cached) <= rho_rtol * rho_cached) {
+    rho_cached = rho;
+    return rho_cached;
+  }
+
+  // Run the power iteration until the estimate settles
+  for (int i = 0; i < power_iters; i++) {
+    double rho_prev = rho;
+    mat->mult(power_vec, t);
+    rho = TacsRealPart(t->norm());
+    if (rho == 0.0) {
+      rho = 1.0;
+      break;
+    }
+    t->scale(1.0 / rho);
+    power_vec->copyValues(t);
+
+    if (fabs(rho - rho_prev) <= 0.01 * rho) {
+      break;
+    }
+  }
+
+  rho_cached = rho;
+  return rho_cached;
+}
+
 /*
   Estimate the spectral radius using Gershgorin disks
 */
@@ -1220,6 +2025,15 @@ TACSAdditiveSchwarz::~TACSAdditiveSchwarz() {
 */
 void TACSAdditiveSchwarz::setDiagShift(TacsScalar _alpha) { alpha = _alpha; }
 
+/*
+  Store and apply the local factorization in single precision. The
+  outer Krylov iteration remains in full precision - see
+  BCSRMat::setSinglePrecisionFactor().
+*/
+void TACSAdditiveSchwarz::setSinglePrecisionFactor(int flag) {
+  Apc->setSinglePrecisionFactor(flag);
+}
+
 /*
   Factor the preconditioner by copying the values from the
   block-diagonal matrix and then factoring the copy.
@@ -1311,6 +2125,12 @@ TACSApproximateSchur::TACSApproximateSchur(TACSParallelMat *_mat, int levFill,
   Apc->incref();
   alpha = 0.0;
 
+  // Threshold-based dropping is disabled by default - the ILU(k)
+  // pattern computed above is used as-is
+  ilut_tol = 0.0;
+  ilut_maxfill = 0;
+  ilut_active = 0;
+
   // Check if we're dealing with a serial case here...
   gsmat = NULL;
   rvec = wvec = NULL;
@@ -1374,6 +2194,15 @@ TACSApproximateSchur::~TACSApproximateSchur() {
 */
 void TACSApproximateSchur::setDiagShift(TacsScalar _alpha) { alpha = _alpha; }
 
+/*
+  Store and apply the local factorization in single precision. The
+  inner and outer Krylov iterations remain in full precision - see
+  BCSRMat::setSinglePrecisionFactor().
+*/
+void TACSApproximateSchur::setSinglePrecisionFactor(int flag) {
+  Apc->setSinglePrecisionFactor(flag);
+}
+
 /*
   Set a monitor for the inner Krylov method
 */
@@ -1383,15 +2212,44 @@ void TACSApproximateSchur::setMonitor(KSMPrint *ksm_print) {
   }
 }
 
+/*
+  Set the parameters for threshold-based ILUT dropping.
+
+  When the tolerance is positive, each call to factor() re-runs the
+  numerical dropping: blocks whose norm falls below tol times the
+  average block norm of their row are discarded and at most maxfill
+  blocks are kept per row on either side of the diagonal. This makes
+  it cheap to re-tune the fill between optimization cycles - there is
+  no symbolic structure to rebuild. Note that the first ILUT
+  factorization replaces the ILU(k) pattern, so the dropping cannot be
+  disabled afterwards, only re-tuned.
+*/
+void TACSApproximateSchur::setILUTDropping(double tol, int maxfill) {
+  if (ilut_active && !(tol > 0.0)) {
+    fprintf(stderr,
+            "TACSApproximateSchur: cannot disable ILUT dropping after "
+            "the factor pattern has been replaced\n");
+    return;
+  }
+  ilut_tol = tol;
+  ilut_maxfill = maxfill;
+}
+
 /*
   Factor preconditioner based on the values in the matrix.
 */
 void TACSApproximateSchur::factor() {
-  Apc->copyValues(Aloc);
-  if (alpha != 0.0) {
-    Apc->addDiag(alpha);
+  if (ilut_tol > 0.0) {
+    // Re-run the numerical dropping on the current matrix values
+    Apc->factorILUT(Aloc, ilut_tol, ilut_maxfill, alpha);
+    ilut_active = 1;
+  } else {
+    Apc->copyValues(Aloc);
+    if (alpha != 0.0) {
+      Apc->addDiag(alpha);
+    }
+    Apc->factor();
   }
-  Apc->factor();
 }
 
 /*
@@ -1892,3 +2750,287 @@ void TACSBlockCyclicPc::factor() {
 
 // Get the matrix associated with the preconditioner itself
 void TACSBlockCyclicPc::getMat(TACSMat **_mat) { *_mat = mat; }
+
+/*!
+  Create the gathered direct solver and set up the gather plan.
+
+  The global block structure of the matrix is gathered to the root
+  processor once here: each processor assembles its block rows in
+  global numbering - the diagonal blocks from A and the external
+  coupling blocks from B in row-by-row order - and the root processor
+  concatenates them into a global block CSR structure. Since each
+  processor owns a contiguous range of block rows, the concatenation
+  is already in global row order. The serial matrix and its
+  factorization are created on the root, and the per-processor counts
+  and offsets are cached for the value gathers performed at each
+  factorization.
+
+  @param mat The parallel matrix to be factored
+*/
+TACSGatherDirectPc::TACSGatherDirectPc(TACSParallelMat *_mat) {
+  mat = _mat;
+  mat->incref();
+
+  // Get the communicator and the number of ranks
+  comm = mat->getMPIComm();
+  MPI_Comm_size(comm, &mpi_size);
+  MPI_Comm_rank(comm, &mpi_rank);
+
+  // Get the mapping for the nodes
+  TACSNodeMap *node_map = mat->getRowMap();
+  const int *range;
+  node_map->getOwnerRange(&range);
+
+  // Get the total number of block rows and the local dimensions
+  N = range[mpi_size];
+  mat->getRowMap(&bsize, &n, &nc);
+
+  // Get the local block matrix structure
+  BCSRMat *Aloc, *Bext;
+  mat->getBCSRMat(&Aloc, &Bext);
+  const int *arowp, *browp, *acols, *bcols;
+  Aloc->getArrays(NULL, NULL, NULL, &arowp, &acols, NULL);
+  Bext->getArrays(NULL, NULL, NULL, &browp, &bcols, NULL);
+
+  // Get the global indices of the external columns
+  TACSBVecDistribute *ext_vars = NULL;
+  mat->getExtColMap(&ext_vars);
+  TACSBVecIndices *ext_indices = ext_vars->getIndices();
+  const int *bindices;
+  ext_indices->getIndices(&bindices);
+
+  // Assemble the local block structure in global numbering, in the
+  // same row-by-row order used to pack the values at each
+  // factorization
+  local_nnz = arowp[n] + browp[nc];
+  int *local_rowlens = new int[n];
+  int *local_cols = new int[local_nnz];
+
+  int index = 0;
+  for (int i = 0; i < n; i++) {
+    for (int jp = arowp[i]; jp < arowp[i + 1]; jp++, index++) {
+      local_cols[index] = acols[jp] + range[mpi_rank];
+    }
+    local_rowlens[i] = arowp[i + 1] - arowp[i];
+
+    if (i >= n - nc) {
+      int ib = i - (n - nc);
+      for (int jp = browp[ib]; jp < browp[ib + 1]; jp++, index++) {
+        local_cols[index] = bindices[bcols[jp]];
+      }
+      local_rowlens[i] += browp[ib + 1] - browp[ib];
+    }
+  }
+
+  // Initialize the root-only data
+  val_counts = val_displs = NULL;
+  vec_counts = vec_displs = NULL;
+  rowp = NULL;
+  all_cols = NULL;
+  all_vals = NULL;
+  serial_mat = NULL;
+  serial_pc = NULL;
+  serial_x = serial_y = NULL;
+
+  // Gather the number of blocks from each processor to the root
+  int *block_counts = NULL, *block_displs = NULL;
+  int *row_counts = NULL, *row_displs = NULL;
+  int *all_rowlens = NULL;
+  if (mpi_rank == 0) {
+    block_counts = new int[mpi_size];
+    block_displs = new int[mpi_size];
+    row_counts = new int[mpi_size];
+    row_displs = new int[mpi_size];
+    all_rowlens = new int[N];
+  }
+  MPI_Gather(&local_nnz, 1, MPI_INT, block_counts, 1, MPI_INT, 0, comm);
+
+  if (mpi_rank == 0) {
+    int nnz_total = 0;
+    for (int k = 0; k < mpi_size; k++) {
+      block_displs[k] = nnz_total;
+      nnz_total += block_counts[k];
+
+      // The block rows are distributed in contiguous ranges
+      row_counts[k] = range[k + 1] - range[k];
+      row_displs[k] = range[k];
+    }
+    all_cols = new int[nnz_total];
+  }
+
+  // Gather the row lengths and the global block columns
+  MPI_Gatherv(local_rowlens, n, MPI_INT, all_rowlens, row_counts, row_displs,
+              MPI_INT, 0, comm);
+  MPI_Gatherv(local_cols, local_nnz, MPI_INT, all_cols, block_counts,
+              block_displs, MPI_INT, 0, comm);
+
+  // Allocate the packing space for the local block values
+  const int b2 = bsize * bsize;
+  local_vals = new TacsScalar[b2 * local_nnz];
+
+  if (mpi_rank == 0) {
+    // Assemble the global block CSR structure
+    rowp = new int[N + 1];
+    rowp[0] = 0;
+    for (int i = 0; i < N; i++) {
+      rowp[i + 1] = rowp[i] + all_rowlens[i];
+    }
+    all_vals = new TacsScalar[b2 * rowp[N]];
+
+    // Cache the counts/offsets in scalar units for the value and
+    // vector gathers
+    val_counts = new int[mpi_size];
+    val_displs = new int[mpi_size];
+    vec_counts = new int[mpi_size];
+    vec_displs = new int[mpi_size];
+    for (int k = 0; k < mpi_size; k++) {
+      val_counts[k] = b2 * block_counts[k];
+      val_displs[k] = b2 * block_displs[k];
+      vec_counts[k] = bsize * (range[k + 1] - range[k]);
+      vec_displs[k] = bsize * range[k];
+    }
+
+    // Create the serial matrix and its factorization on the root
+    TACSNodeMap *serial_map = new TACSNodeMap(MPI_COMM_SELF, N);
+    serial_mat = new TACSSerialPivotMat(serial_map, bsize, N, N, rowp,
+                                        all_cols);
+    serial_mat->incref();
+    serial_pc = new TACSSerialPivotPc(serial_mat);
+    serial_pc->incref();
+
+    serial_x = dynamic_cast<TACSBVec *>(serial_mat->createVec());
+    serial_y = dynamic_cast<TACSBVec *>(serial_mat->createVec());
+    serial_x->incref();
+    serial_y->incref();
+
+    delete[] block_counts;
+    delete[] block_displs;
+    delete[] row_counts;
+    delete[] row_displs;
+    delete[] all_rowlens;
+  }
+
+  delete[] local_rowlens;
+  delete[] local_cols;
+}
+
+TACSGatherDirectPc::~TACSGatherDirectPc() {
+  mat->decref();
+  delete[] local_vals;
+  if (val_counts) {
+    delete[] val_counts;
+    delete[] val_displs;
+    delete[] vec_counts;
+    delete[] vec_displs;
+  }
+  if (rowp) {
+    delete[] rowp;
+  }
+  if (all_cols) {
+    delete[] all_cols;
+  }
+  if (all_vals) {
+    delete[] all_vals;
+  }
+  if (serial_mat) {
+    serial_mat->decref();
+  }
+  if (serial_pc) {
+    serial_pc->decref();
+  }
+  if (serial_x) {
+    serial_x->decref();
+  }
+  if (serial_y) {
+    serial_y->decref();
+  }
+}
+
+/*
+  Gather the matrix values to the root processor and factor the
+  serial matrix there. The block structure and the gather plan were
+  cached when the object was created, so only the values move.
+*/
+void TACSGatherDirectPc::factor() {
+  // Get the local block matrix values
+  BCSRMat *Aloc, *Bext;
+  mat->getBCSRMat(&Aloc, &Bext);
+  const int *arowp, *browp;
+  TacsScalar *Avals, *Bvals;
+  Aloc->getArrays(NULL, NULL, NULL, &arowp, NULL, &Avals);
+  Bext->getArrays(NULL, NULL, NULL, &browp, NULL, &Bvals);
+
+  // Pack the local block values in the same row-by-row order as the
+  // structure assembled in the constructor
+  const int b2 = bsize * bsize;
+  int index = 0;
+  for (int i = 0; i < n; i++) {
+    for (int jp = arowp[i]; jp < arowp[i + 1]; jp++, index++) {
+      memcpy(&local_vals[b2 * index], &Avals[b2 * jp], b2 * sizeof(TacsScalar));
+    }
+    if (i >= n - nc) {
+      int ib = i - (n - nc);
+      for (int jp = browp[ib]; jp < browp[ib + 1]; jp++, index++) {
+        memcpy(&local_vals[b2 * index], &Bvals[b2 * jp],
+               b2 * sizeof(TacsScalar));
+      }
+    }
+  }
+
+  // Gather the values to the root processor
+  MPI_Gatherv(local_vals, b2 * local_nnz, TACS_MPI_TYPE, all_vals, val_counts,
+              val_displs, TACS_MPI_TYPE, 0, comm);
+
+  if (mpi_rank == 0) {
+    // Set the gathered blocks into the serial matrix. The gathered
+    // values are in global block CSR order, matching all_cols
+    serial_mat->zeroEntries();
+    for (int i = 0; i < N; i++) {
+      for (int jp = rowp[i]; jp < rowp[i + 1]; jp++) {
+        serial_mat->addValues(1, &i, 1, &all_cols[jp], bsize, bsize,
+                              &all_vals[b2 * jp]);
+      }
+    }
+
+    // Factor the serial matrix
+    serial_pc->factor();
+  }
+}
+
+// Apply the factorization: gather the right-hand-side, solve on the
+// root processor, and scatter the solution back to its owners
+void TACSGatherDirectPc::applyFactor(TACSVec *tx, TACSVec *ty) {
+  TACSBVec *x, *y;
+  x = dynamic_cast<TACSBVec *>(tx);
+  y = dynamic_cast<TACSBVec *>(ty);
+
+  if (x && y) {
+    TacsScalar *x_array, *y_array;
+    x->getArray(&x_array);
+    y->getArray(&y_array);
+
+    // Gather the right-hand-side to the root processor
+    TacsScalar *rhs = NULL, *sol = NULL;
+    if (mpi_rank == 0) {
+      serial_x->getArray(&rhs);
+      serial_y->getArray(&sol);
+    }
+    MPI_Gatherv(x_array, bsize * n, TACS_MPI_TYPE, rhs, vec_counts, vec_displs,
+                TACS_MPI_TYPE, 0, comm);
+
+    // Solve the gathered problem
+    if (mpi_rank == 0) {
+      serial_pc->applyFactor(serial_x, serial_y);
+    }
+
+    // Scatter the solution back to the owning processors
+    MPI_Scatterv(sol, vec_counts, vec_displs, TACS_MPI_TYPE, y_array,
+                 bsize * n, TACS_MPI_TYPE, 0, comm);
+  } else {
+    fprintf(stderr,
+            "TACSGatherDirectPc type error: Input/output must be TACSBVec\n");
+  }
+}
+
+// Get the matrix associated with the preconditioner itself
+void TACSGatherDirectPc::getMat(TACSMat **_mat) { *_mat = mat; }
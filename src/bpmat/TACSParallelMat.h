@@ -87,8 +87,11 @@ class TACSParallelMat : public TACSMat {
   // Functions required for solving linear systems
   // ---------------------------------------------
   void getSize(int *_nr, int *_nc);            // Get the local dimensions
-  void mult(TACSVec *x, TACSVec *y);           // y <- A*x
-  void multTranspose(TACSVec *x, TACSVec *y);  // y <- A^{T}*x
+  void mult(TACSVec *x, TACSVec *y);             // y <- A*x
+  void multRHS(int nrhs, TACSVec **x,
+               TACSVec **y);                     // y[i] <- A*x[i]
+  void multTranspose(TACSVec *x, TACSVec *y);    // y <- A^{T}*x
+  void setStoreTranspose(int flag);            // Store an explicit transpose
   TACSVec *createVec();                        // Create a vector
   void copyValues(TACSMat *mat);               // Copy matrix entries
   void scale(TacsScalar alpha);                // Scale the matrix
@@ -108,6 +111,11 @@ class TACSParallelMat : public TACSMat {
   void printNzPattern(const char *fileName);  // Print the non-zero pattern
   const char *getObjectName();
 
+  // Binary export/import of the local matrix blocks
+  // -----------------------------------------------
+  int writeToFile(const char *fname);
+  int readFromFile(const char *fname);
+
  private:
   // Common initialization routine
   void init(TACSNodeMap *_rmap, BCSRMat *_Aloc, BCSRMat *_Bext,
@@ -132,6 +140,15 @@ class TACSParallelMat : public TACSMat {
   TacsScalar *x_ext;
   int ext_offset;
 
+  // Data for multiple right-hand side products. The contexts and the
+  // packed multivectors are allocated on the first call to multRHS()
+  // and re-used on subsequent calls.
+  int max_nrhs;
+  TACSBVecDistCtx **rhs_ctx;
+  TacsScalar *x_ext_rhs;      // The external values for each vector
+  TacsScalar *x_rhs, *y_rhs;  // The packed input/output multivectors
+  TacsScalar *y_ext_rhs;      // The packed external product
+
   static const char *matName;
 };
 
@@ -174,6 +191,95 @@ class TACSGaussSeidel : public TACSPc {
   TacsScalar *yext;
 };
 
+/*
+  Parallel block-Jacobi smoother
+
+  This smoother applies the inverse of the point-block diagonal of the
+  matrix. Unlike Gauss--Seidel, the apply has no sequential dependency
+  between the rows, so every block row is independent and the sweep is
+  limited only by memory bandwidth. Additional iterations perform the
+  damped Jacobi update y <- y + omega*D^{-1}*(x - A*y) using the full
+  parallel matrix-vector product.
+*/
+class TACSBlockJacobi : public TACSPc {
+ public:
+  TACSBlockJacobi(TACSParallelMat *_mat, TacsScalar _omega, int _iters);
+  ~TACSBlockJacobi();
+
+  void factor();
+  void applyFactor(TACSVec *xvec, TACSVec *yvec);
+  void getMat(TACSMat **_mat);
+
+ private:
+  // Parallel matrix pointer
+  TACSParallelMat *mat;
+
+  // Information about how to handle the smoother
+  TacsScalar omega;  // The damping factor
+  int iters;         // The number of iterations to apply
+
+  // The inverted diagonal blocks of the local matrix
+  TacsScalar *Dinv;
+
+  // Temporary vector for the residual in multi-iteration sweeps
+  TACSBVec *rvec;
+};
+
+/*
+  Parallel multicolor block-SOR smoother
+
+  The local block rows are partitioned into colors such that no two
+  rows of the same color are coupled through the local matrix. Rows
+  within a color can then be relaxed in any order, removing the
+  sequential dependency of the standard Gauss--Seidel sweep while
+  retaining its convergence behavior. As with TACSGaussSeidel, the
+  off-processor updates are delayed, making this a hybrid
+  Jacobi/multicolor-SOR method in parallel. The sweep applies the
+  stored inverse of each diagonal block, so no ILU-style fill storage
+  is required.
+*/
+class TACSMulticolorSOR : public TACSPc {
+ public:
+  TACSMulticolorSOR(TACSParallelMat *_mat, int _zero_guess, TacsScalar _omega,
+                    int _iters, int _symmetric);
+  ~TACSMulticolorSOR();
+
+  void factor();
+  void applyFactor(TACSVec *xvec, TACSVec *yvec);
+  void getMat(TACSMat **_mat);
+
+ private:
+  // Relax the rows of a single color
+  void relaxColor(int color, int bsize, int offset, const TacsScalar *x,
+                  TacsScalar *y);
+
+  // Parallel matrix pointer
+  TACSParallelMat *mat;
+
+  // Information about how to handle the smoother
+  TacsScalar omega;  // The over/under relaxation factor
+  int zero_guess;    // Zero the initial guess
+  int iters;         // The number of iterations to apply
+  int symmetric;     // Apply the symmetric variant
+
+  // The inverted diagonal blocks of the local matrix
+  TacsScalar *Dinv;
+
+  // The multicolor ordering of the local block rows
+  int num_colors;
+  int *color_ptr;   // Pointer into color_rows for each color
+  int *color_rows;  // The block rows sorted by color
+
+  // Pointers to the local/external matrix
+  BCSRMat *Aloc, *Bext;
+
+  // Parallel data for the delayed off-processor update
+  TACSBVecDistribute *ext_dist;
+  TACSBVecDistCtx *ctx;
+  int ext_offset;
+  TacsScalar *yext;
+};
+
 /*
   Chebyshev Smoother
 */
@@ -188,6 +294,11 @@ class TACSChebyshevSmoother : public TACSPc {
   void applyFactor(TACSVec *xvec, TACSVec *yvec);
   void getMat(TACSMat **_mat);
 
+  // Control the cached power-iteration spectral estimate. Setting
+  // zero power iterations falls back to the Gershgorin/Arnoldi
+  // estimate on every factorization.
+  void setSpectralEstimator(int _power_iters, double _rho_rtol);
+
  private:
   // Estimate the spectral radius using Gershgorin method
   double gershgorin(TACSParallelMat *pmat);
@@ -195,6 +306,10 @@ class TACSChebyshevSmoother : public TACSPc {
   // Estimate the spectral radius using Arnoldi
   double arnoldi(int size, TACSMat *pmat);
 
+  // Estimate the spectral radius by power iteration, re-using the
+  // cached estimate when the matrix has not changed appreciably
+  double powerEstimate();
+
   // Parallel matrix pointer
   TACSMat *mat;
 
@@ -202,6 +317,13 @@ class TACSChebyshevSmoother : public TACSPc {
   double lower_factor;
   double upper_factor;
 
+  // The cached spectral radius estimate and the power iterate that
+  // persists across factorizations
+  int power_iters;
+  double rho_rtol;
+  double rho_cached;
+  TACSBVec *power_vec;
+
   // Set the values for the upper/lower eigenvalues
   double alpha, beta;
 
@@ -228,6 +350,7 @@ class TACSAdditiveSchwarz : public TACSPc {
   ~TACSAdditiveSchwarz();
 
   void setDiagShift(TacsScalar _alpha);
+  void setSinglePrecisionFactor(int flag);
   void factor();
   void applyFactor(TACSVec *xvec, TACSVec *yvec);
   void applyFactor(TACSVec *yvec);
@@ -291,7 +414,9 @@ class TACSApproximateSchur : public TACSPc {
   ~TACSApproximateSchur();
 
   void setDiagShift(TacsScalar _alpha);
+  void setSinglePrecisionFactor(int flag);
   void setMonitor(KSMPrint *ksm_print);
+  void setILUTDropping(double tol, int maxfill);
   void factor();
   void applyFactor(TACSVec *xvec, TACSVec *yvec);
   void getMat(TACSMat **_mat);
@@ -303,6 +428,11 @@ class TACSApproximateSchur : public TACSPc {
   BCSRMat *Aloc, *Apc;
   TacsScalar alpha;
 
+  // Parameters for the threshold-based ILUT dropping
+  double ilut_tol;
+  int ilut_maxfill;
+  int ilut_active;
+
   // Offsets into the array
   int start, end, var_offset;
 
@@ -338,4 +468,61 @@ class TACSBlockCyclicPc : public TACSPc {
   TACSBVecDistCtx *vec_ctx;
 };
 
+class TACSSerialPivotMat;
+class TACSSerialPivotPc;
+
+/*
+  A direct solver that agglomerates the matrix onto the root processor
+
+  At high processor counts the coarsest multigrid problem has only a
+  few thousand unknowns spread across every processor, and a
+  distributed direct solve there is dominated by communication
+  latency. This solver gathers the matrix to the root processor at
+  each factorization, factors it there with the serial pivoting direct
+  solver, and gathers/scatters the right-hand-side and solution around
+  the serial solve. The gather plan - the global block structure and
+  the counts and offsets of every processor's contribution - is
+  computed once when the object is created and re-used for every
+  factorization and solve.
+*/
+class TACSGatherDirectPc : public TACSPc {
+ public:
+  TACSGatherDirectPc(TACSParallelMat *_mat);
+  ~TACSGatherDirectPc();
+
+  // Apply the preconditioner to x, to produce y
+  void applyFactor(TACSVec *x, TACSVec *y);
+
+  // Factor (or set up) the preconditioner
+  void factor();
+
+  // Get the matrix associated with the preconditioner itself
+  void getMat(TACSMat **_mat);
+
+ private:
+  MPI_Comm comm;
+  int mpi_rank, mpi_size;
+  TACSParallelMat *mat;
+
+  // The matrix dimensions and the cached gather plan
+  int bsize, n, nc;  // The local block dimensions
+  int N;             // The global number of block rows
+  int local_nnz;     // The number of local blocks from A and B
+  TacsScalar *local_vals;  // The packed local block values
+
+  // The counts/offsets of each processor's values and vector entries,
+  // allocated on the root processor only
+  int *val_counts, *val_displs;
+  int *vec_counts, *vec_displs;
+
+  // The gathered global block structure and values (root only)
+  int *rowp, *all_cols;
+  TacsScalar *all_vals;
+
+  // The serial matrix and its factorization (root only)
+  TACSSerialPivotMat *serial_mat;
+  TACSSerialPivotPc *serial_pc;
+  TACSBVec *serial_x, *serial_y;
+};
+
 #endif  // TACS_PARALLEL_MATRIX_H
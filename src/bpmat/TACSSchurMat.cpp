@@ -924,6 +924,82 @@ void TACSSchurMat::getBCSRMat(BCSRMat **_B, BCSRMat **_E, BCSRMat **_F,
   }
 }
 
+/*!
+  Write the local matrix blocks to binary files.
+
+  One file per rank is written for each of the B, E, F and C blocks,
+  named <fname>.B.<rank>, <fname>.E.<rank>, <fname>.F.<rank> and
+  <fname>.C.<rank>. The layout of each file is described in
+  BCSRMat::writeToFile().
+
+  Returns 0 on success on all ranks, 1 otherwise.
+*/
+int TACSSchurMat::writeToFile(const char *fname) {
+  int mpi_rank;
+  MPI_Comm_rank(rmap->getMPIComm(), &mpi_rank);
+
+  // Create the file names for the local blocks
+  size_t len = strlen(fname) + 32;
+  char *name = new char[len];
+
+  snprintf(name, len, "%s.B.%d", fname, mpi_rank);
+  int fail = B->writeToFile(name);
+
+  snprintf(name, len, "%s.E.%d", fname, mpi_rank);
+  fail = E->writeToFile(name) || fail;
+
+  snprintf(name, len, "%s.F.%d", fname, mpi_rank);
+  fail = F->writeToFile(name) || fail;
+
+  snprintf(name, len, "%s.C.%d", fname, mpi_rank);
+  fail = C->writeToFile(name) || fail;
+  delete[] name;
+
+  // Fail on all ranks if any rank failed
+  int temp = fail;
+  MPI_Allreduce(&temp, &fail, 1, MPI_INT, MPI_MAX, rmap->getMPIComm());
+
+  return fail;
+}
+
+/*!
+  Read the local matrix block values from binary files written by
+  writeToFile().
+
+  The matrix must be created with the same non-zero structure and the
+  same number of ranks as the matrix that was written: only the block
+  values are loaded, so no symbolic computation is required.
+
+  Returns 0 on success on all ranks, 1 otherwise.
+*/
+int TACSSchurMat::readFromFile(const char *fname) {
+  int mpi_rank;
+  MPI_Comm_rank(rmap->getMPIComm(), &mpi_rank);
+
+  // Create the file names for the local blocks
+  size_t len = strlen(fname) + 32;
+  char *name = new char[len];
+
+  snprintf(name, len, "%s.B.%d", fname, mpi_rank);
+  int fail = B->readFromFile(name);
+
+  snprintf(name, len, "%s.E.%d", fname, mpi_rank);
+  fail = E->readFromFile(name) || fail;
+
+  snprintf(name, len, "%s.F.%d", fname, mpi_rank);
+  fail = F->readFromFile(name) || fail;
+
+  snprintf(name, len, "%s.C.%d", fname, mpi_rank);
+  fail = C->readFromFile(name) || fail;
+  delete[] name;
+
+  // Fail on all ranks if any rank failed
+  int temp = fail;
+  MPI_Allreduce(&temp, &fail, 1, MPI_INT, MPI_MAX, rmap->getMPIComm());
+
+  return fail;
+}
+
 /*!
   The Global Schur preconditioner. Some assembly required.
 
@@ -935,17 +1011,32 @@ void TACSSchurMat::getBCSRMat(BCSRMat **_B, BCSRMat **_E, BCSRMat **_F,
   levFill and fill are the level of fill and fill-in on the global
   Schur complement
 
+  Alternatively, when use_sparse_schur is true, the global Schur
+  complement is never assembled. Instead, the interface problem is
+  solved approximately with an inner GMRES iteration on the
+  matrix-free sum of the local Schur complement contributions,
+  preconditioned with an additive Schwarz method based on an
+  incomplete factorization of the local Schur complements.
+
   input:
   smat:    the TACSSchurMat matrix for the preconditioner
   levFill: the level of fill to use
   fill:    the expected/best estimate of the fill-in factor
   reorder: flag to indicate whether to re-order the global Schur complement
+  use_sparse_schur:  keep the global Schur complement in sparse form
+  inner_gmres_iters: subspace size for the inner interface solver
+  inner_rtol:        relative tolerance for the inner interface solver
+  inner_atol:        absolute tolerance for the inner interface solver
 */
 TACSSchurPc::TACSSchurPc(TACSSchurMat *_mat, int levFill, double fill,
-                         int reorder_schur_complement) {
+                         int reorder_schur_complement, int _use_sparse_schur,
+                         int inner_gmres_iters, double inner_rtol,
+                         double inner_atol) {
   mat = _mat;
   mat->incref();
 
+  use_sparse_schur = _use_sparse_schur;
+
   mat->getBCSRMat(&B, &E, &F, &C);
   B->incref();
   E->incref();
@@ -958,6 +1049,9 @@ TACSSchurPc::TACSSchurPc(TACSSchurMat *_mat, int levFill, double fill,
   // By default use the less-memory intensive option
   use_cyclic_alltoall = 0;
 
+  // The block-cyclic assembly pattern is computed on first use
+  schur_pattern_init = 0;
+
   // Perform the symbolic factorization of the [ B, E; F, C ] matrix
   int use_full_schur = 1;  // Use the exact F * B^{-1} * E
 
@@ -1069,127 +1163,190 @@ TACSSchurPc::TACSSchurPc(TACSSchurMat *_mat, int levFill, double fill,
   MPI_Scatterv(schur_root, schur_count, schur_ptr, MPI_INT, local_schur_vars,
                num_local_schur_vars, MPI_INT, root, comm);
 
-  // Retrieve the non-zero pattern from the local Schur complement
-  // and pass it into the block-cyclic matrix
-  int bs, num_schur_vars;
-  const int *rowp, *cols;
-  TacsScalar *vals;
-  Sc->getArrays(&bs, &num_schur_vars, &num_schur_vars, &rowp, &cols, &vals);
+  // Set the default state of the global Schur complement objects
+  bcyclic = NULL;
+  gsmat = NULL;
+  sparse_pc = NULL;
+  inner_ksm = NULL;
+
+  // The number of global Schur variables owned by this process, the
+  // corresponding TACS variable numbers and the indices of the local
+  // interface variables within the global Schur complement ordering
+  int local_var_count = 0;
+  int *tacs_schur_vars = NULL;
+  int *local_schur = NULL;
+
+  if (use_sparse_schur) {
+    // Keep the global Schur complement in sparse form. The unique
+    // (sorted) ordering of the Schur variables is retained, so the
+    // indices scattered above can be used directly. Partition the
+    // unique Schur variables evenly across the processors.
+    local_var_count = num_unique_schur / size;
+    if (rank < num_unique_schur % size) {
+      local_var_count++;
+    }
 
-  // Determine the size of the global Schur complement
-  int M = num_unique_schur, N = num_unique_schur;
+    // Compute the same partition on the root process and send each
+    // process the TACS variable numbers that it owns
+    int *tacs_schur_count = NULL;
+    int *tacs_schur_ptr = NULL;
+    if (rank == root) {
+      tacs_schur_count = new int[size];
+      tacs_schur_ptr = new int[size];
+
+      int num_schur = 0;
+      for (int i = 0; i < size; i++) {
+        tacs_schur_count[i] = num_unique_schur / size;
+        if (i < num_unique_schur % size) {
+          tacs_schur_count[i]++;
+        }
+        tacs_schur_ptr[i] = num_schur;
+        num_schur += tacs_schur_count[i];
+      }
+    }
 
-  // Determine the number of blocks to use per block-cylic block
-  int csr_blocks_per_block = 1;
-  if (bsize < 36) {
-    csr_blocks_per_block = 36 / bsize;
-  }
+    tacs_schur_vars = new int[local_var_count];
+    MPI_Scatterv(unique_schur, tacs_schur_count, tacs_schur_ptr, MPI_INT,
+                 tacs_schur_vars, local_var_count, MPI_INT, root, comm);
+
+    // The ordering is unchanged - copy the indices scattered above
+    local_schur = new int[num_local_schur_vars];
+    memcpy(local_schur, local_schur_vars, num_local_schur_vars * sizeof(int));
+
+    // Free memory not required anymore
+    if (rank == root) {
+      delete[] tacs_schur_count;
+      delete[] tacs_schur_ptr;
+      delete[] schur_count;
+      delete[] schur_ptr;
+      delete[] schur_root;
+      delete[] unique_schur;
+    }
+  } else {
+    // Retrieve the non-zero pattern from the local Schur complement
+    // and pass it into the block-cyclic matrix
+    int bs, num_schur_vars;
+    const int *rowp, *cols;
+    TacsScalar *vals;
+    Sc->getArrays(&bs, &num_schur_vars, &num_schur_vars, &rowp, &cols, &vals);
+
+    // Determine the size of the global Schur complement
+    int M = num_unique_schur, N = num_unique_schur;
+
+    // Determine the number of blocks to use per block-cylic block
+    int csr_blocks_per_block = 1;
+    if (bsize < 36) {
+      csr_blocks_per_block = 36 / bsize;
+    }
 
-  int *schur_cols = new int[rowp[num_schur_vars]];
-  for (int i = 0; i < rowp[num_schur_vars]; i++) {
-    schur_cols[i] = local_schur_vars[cols[i]];
-  }
+    int *schur_cols = new int[rowp[num_schur_vars]];
+    for (int i = 0; i < rowp[num_schur_vars]; i++) {
+      schur_cols[i] = local_schur_vars[cols[i]];
+    }
 
-  // Create the global block-cyclic Schur complement matrix
-  bcyclic = new TACSBlockCyclicMat(
-      comm, M, N, bsize, local_schur_vars, num_schur_vars, rowp, schur_cols,
-      csr_blocks_per_block, reorder_schur_complement, max_grid_size);
-  bcyclic->incref();
-  delete[] schur_cols;
+    // Create the global block-cyclic Schur complement matrix
+    bcyclic = new TACSBlockCyclicMat(
+        comm, M, N, bsize, local_schur_vars, num_schur_vars, rowp, schur_cols,
+        csr_blocks_per_block, reorder_schur_complement, max_grid_size);
+    bcyclic->incref();
+    delete[] schur_cols;
+
+    // Get the information about the reordering/blocks from the matrix
+    int nrows, ncols;
+    const int *bptr, *xbptr, *perm, *iperm, *orig_bptr;
+    bcyclic->getBlockPointers(&nrows, &ncols, &bptr, &xbptr, &perm, &iperm,
+                              &orig_bptr);
+    if (!orig_bptr) {
+      orig_bptr = bptr;
+    }
 
-  // Get the information about the reordering/blocks from the matrix
-  int nrows, ncols;
-  const int *bptr, *xbptr, *perm, *iperm, *orig_bptr;
-  bcyclic->getBlockPointers(&nrows, &ncols, &bptr, &xbptr, &perm, &iperm,
-                            &orig_bptr);
-  if (!orig_bptr) {
-    orig_bptr = bptr;
-  }
+    // Set the number of local variables that are defined
+    local_var_count = xbptr[nrows] / bsize;
 
-  // Set the number of local variables that are defined
-  int local_var_count = xbptr[nrows] / bsize;
+    // Allocate space for the new pointers
+    int *tacs_schur_count = NULL;
+    int *tacs_schur_ptr = NULL;
+    if (rank == root) {
+      tacs_schur_count = new int[size];
+      tacs_schur_ptr = new int[size];
+    }
 
-  // Allocate space for the new pointers
-  int *tacs_schur_count = NULL;
-  int *tacs_schur_ptr = NULL;
-  if (rank == root) {
-    tacs_schur_count = new int[size];
-    tacs_schur_ptr = new int[size];
-  }
+    // Gather the local variable count on this processor
+    MPI_Gather(&local_var_count, 1, MPI_INT, tacs_schur_count, 1, MPI_INT, root,
+               comm);
+
+    // Now, reorder the variables in the Schur complement
+    int *local_tacs_schur_vars = NULL;
+    if (rank == root) {
+      // Compute the offset into the block order
+      int num_schur = 0;
+      for (int i = 0; i < size; i++) {
+        tacs_schur_ptr[i] = num_schur;
+        num_schur += tacs_schur_count[i];
+      }
 
-  // Gather the local variable count on this processor
-  MPI_Gather(&local_var_count, 1, MPI_INT, tacs_schur_count, 1, MPI_INT, root,
-             comm);
+      // Find out where to place variable i from the unique list of
+      // local schur variables
+      local_tacs_schur_vars = new int[num_schur];
+      for (int i = 0, j = 0; (i < nrows) && (j < num_unique_schur); i++) {
+        while (j < num_unique_schur && bsize * j >= orig_bptr[i] &&
+               bsize * j < orig_bptr[i + 1]) {
+          // Get the re-ordered block
+          int block = i;
+          if (iperm) {
+            block = iperm[i];
+          }
+          int owner = bcyclic->get_block_owner(block, block);
+
+          // Count up the number of local blocks to offset.  This is a
+          // double loop which could be avoided in future. This might be
+          // a bottle neck for very large cases, but just at set up.
+          int index =
+              (bsize * j - orig_bptr[i]) / bsize + tacs_schur_ptr[owner];
+          for (int k = 0; k < block; k++) {
+            if (owner == bcyclic->get_block_owner(k, k)) {
+              index += (bptr[k + 1] - bptr[k]) / bsize;
+            }
+          }
 
-  // Now, reorder the variables in the Schur complement
-  int *local_tacs_schur_vars = NULL;
-  if (rank == root) {
-    // Compute the offset into the block order
-    int num_schur = 0;
-    for (int i = 0; i < size; i++) {
-      tacs_schur_ptr[i] = num_schur;
-      num_schur += tacs_schur_count[i];
-    }
+          // Set the new value of the schur index
+          local_tacs_schur_vars[index] = unique_schur[j];
+          unique_schur[j] = index;
 
-    // Find out where to place variable i from the unique list of
-    // local schur variables
-    local_tacs_schur_vars = new int[num_schur];
-    for (int i = 0, j = 0; (i < nrows) && (j < num_unique_schur); i++) {
-      while (j < num_unique_schur && bsize * j >= orig_bptr[i] &&
-             bsize * j < orig_bptr[i + 1]) {
-        // Get the re-ordered block
-        int block = i;
-        if (iperm) {
-          block = iperm[i];
+          // Increment the index
+          j++;
         }
-        int owner = bcyclic->get_block_owner(block, block);
-
-        // Count up the number of local blocks to offset.  This is a
-        // double loop which could be avoided in future. This might be
-        // a bottle neck for very large cases, but just at set up.
-        int index = (bsize * j - orig_bptr[i]) / bsize + tacs_schur_ptr[owner];
-        for (int k = 0; k < block; k++) {
-          if (owner == bcyclic->get_block_owner(k, k)) {
-            index += (bptr[k + 1] - bptr[k]) / bsize;
-          }
-        }
-
-        // Set the new value of the schur index
-        local_tacs_schur_vars[index] = unique_schur[j];
-        unique_schur[j] = index;
+      }
 
-        // Increment the index
-        j++;
+      // For each global Schur variable, now assign an output - the index
+      // into the unique list of global Schur variables
+      for (int i = 0; i < num_schur_root; i++) {
+        schur_root[i] = unique_schur[schur_root[i]];
       }
-    }
 
-    // For each global Schur variable, now assign an output - the index
-    // into the unique list of global Schur variables
-    for (int i = 0; i < num_schur_root; i++) {
-      schur_root[i] = unique_schur[schur_root[i]];
+      // Free the original set of unique schur variables
+      delete[] unique_schur;
     }
 
-    // Free the original set of unique schur variables
-    delete[] unique_schur;
-  }
-
-  // Send unique_schur back to the owning processes
-  int *tacs_schur_vars = new int[local_var_count];
-  MPI_Scatterv(local_tacs_schur_vars, tacs_schur_count, tacs_schur_ptr, MPI_INT,
-               tacs_schur_vars, local_var_count, MPI_INT, root, comm);
-
-  int *local_schur = new int[num_local_schur_vars];
-  MPI_Scatterv(schur_root, schur_count, schur_ptr, MPI_INT, local_schur,
-               num_local_schur_vars, MPI_INT, root, comm);
-
-  // Free memory not required anymore
-  if (rank == root) {
-    delete[] tacs_schur_count;
-    delete[] tacs_schur_ptr;
-    delete[] schur_count;
-    delete[] schur_ptr;
-    delete[] schur_root;
-    delete[] local_tacs_schur_vars;
+    // Send unique_schur back to the owning processes
+    tacs_schur_vars = new int[local_var_count];
+    MPI_Scatterv(local_tacs_schur_vars, tacs_schur_count, tacs_schur_ptr,
+                 MPI_INT, tacs_schur_vars, local_var_count, MPI_INT, root,
+                 comm);
+
+    local_schur = new int[num_local_schur_vars];
+    MPI_Scatterv(schur_root, schur_count, schur_ptr, MPI_INT, local_schur,
+                 num_local_schur_vars, MPI_INT, root, comm);
+
+    // Free memory not required anymore
+    if (rank == root) {
+      delete[] tacs_schur_count;
+      delete[] tacs_schur_ptr;
+      delete[] schur_count;
+      delete[] schur_ptr;
+      delete[] schur_root;
+      delete[] local_tacs_schur_vars;
+    }
   }
 
   // Set up information required for the global Schur complement matrix
@@ -1234,6 +1391,22 @@ TACSSchurPc::TACSSchurPc(TACSSchurMat *_mat, int levFill, double fill,
   gschur = new TACSBVec(schur_map, bsize);
   yschur->incref();
   gschur->incref();
+
+  // Create the matrix-free operator, the additive Schwarz
+  // preconditioner and the inner solver for the interface problem
+  if (use_sparse_schur) {
+    gsmat = new TACSSparseSchurMat(schur_map, schur_dist, Sc);
+    gsmat->incref();
+
+    sparse_pc = new TACSSparseSchurPc(schur_map, schur_dist, Sc, levFill, fill);
+    sparse_pc->incref();
+
+    int nrestart = 0, is_flexible = 0;
+    inner_ksm = new GMRES(gsmat, sparse_pc, inner_gmres_iters, nrestart,
+                          is_flexible);
+    inner_ksm->incref();
+    inner_ksm->setTolerances(inner_rtol, inner_atol);
+  }
 }
 
 /*
@@ -1268,7 +1441,20 @@ TACSSchurPc::~TACSSchurPc() {
   tacs_schur_ctx->decref();
 
   // Free the global Schur complement matrix
-  bcyclic->decref();
+  if (bcyclic) {
+    bcyclic->decref();
+  }
+
+  // Free the sparse global Schur complement objects
+  if (gsmat) {
+    gsmat->decref();
+  }
+  if (sparse_pc) {
+    sparse_pc->decref();
+  }
+  if (inner_ksm) {
+    inner_ksm->decref();
+  }
 
   // Deallocate the local vectors
   gschur->decref();
@@ -1322,7 +1508,11 @@ void TACSSchurPc::testSchurComplement(TACSVec *tin, TACSVec *tout) {
 
     TacsScalar *g = NULL;
     yschur->getArray(&y);
-    bcyclic->mult(y, g);
+    if (use_sparse_schur) {
+      gsmat->mult(yschur, gschur);
+    } else {
+      bcyclic->mult(y, g);
+    }
 
     TacsScalar outnorm = outvec->norm();
     TacsScalar gnorm = gschur->norm();
@@ -1331,7 +1521,11 @@ void TACSSchurPc::testSchurComplement(TACSVec *tin, TACSVec *tout) {
     tacs_schur_dist->beginForward(tacs_schur_ctx, in, y);
     tacs_schur_dist->endForward(tacs_schur_ctx, in, y);
 
-    bcyclic->mult(y, g);
+    if (use_sparse_schur) {
+      gsmat->mult(yschur, gschur);
+    } else {
+      bcyclic->mult(y, g);
+    }
     TacsScalar gnorm2 = gschur->norm();
 
     int rank;
@@ -1378,6 +1572,17 @@ void TACSSchurPc::getBCSRMat(BCSRMat **_Bpc, BCSRMat **_Epc, BCSRMat **_Fpc,
 */
 void TACSSchurPc::setMonitorFactorFlag(int flag) { monitor_factor = flag; }
 
+/*
+  Store and apply the factorization of the local diagonal block in
+  single precision. The back-solves against Bpc dominate the local
+  work per iteration and are bandwidth-bound; the global Schur solve
+  and the outer Krylov iteration remain in full precision - see
+  BCSRMat::setSinglePrecisionFactor().
+*/
+void TACSSchurPc::setSinglePrecisionFactor(int flag) {
+  Bpc->setSinglePrecisionFactor(flag);
+}
+
 /*
   Set the flag that prints out the back solve time
 
@@ -1391,11 +1596,11 @@ void TACSSchurPc::setMonitorBackSolveFlag(int flag) {
 /*
   Set the flag that controls which matrix assembly code to use.
 
-  This flag controls whether the Alltoall version of the block matrix
-  assembly is used. When true, this uses a faster, but more
-  memory-intensive version of the code. Be aware that this can cause
-  the code to run out of memory, but can be very beneficial in terms
-  of CPU time.
+  This flag controlled whether the Alltoall version of the block
+  matrix assembly was used. The global Schur complement assembly in
+  factor() now uses an index translation that is precomputed on the
+  first factorization, which supersedes both assembly paths, so the
+  flag is retained for backwards compatibility only.
 
   input:
   flag:  the flag value to use for the Alltoall flag
@@ -1462,41 +1667,53 @@ void TACSSchurPc::factor() {
     global_schur_assembly = -MPI_Wtime();
   }
 
-  // Assemble the global Schur complement system into block matrix.
-  // First, zero the Schur complement matrix
-  bcyclic->zeroEntries();
+  if (use_sparse_schur) {
+    if (monitor_factor) {
+      global_schur_assembly += MPI_Wtime();
+      global_schur_time = -MPI_Wtime();
+    }
 
-  // Retrieve the local arrays for the local Schur complement
-  int bsize, mlocal, nlocal;
-  const int *rowp, *cols;
-  TacsScalar *scvals;
-  Sc->getArrays(&bsize, &mlocal, &nlocal, &rowp, &cols, &scvals);
+    // The global Schur complement is kept in sparse form - factor
+    // the additive Schwarz preconditioner for the interface problem
+    sparse_pc->factor();
+  } else {
+    // Assemble the global Schur complement system into block matrix.
+    // First, zero the Schur complement matrix
+    bcyclic->zeroEntries();
+
+    // Retrieve the local arrays for the local Schur complement
+    int bsize, mlocal, nlocal;
+    const int *rowp, *cols;
+    TacsScalar *scvals;
+    Sc->getArrays(&bsize, &mlocal, &nlocal, &rowp, &cols, &scvals);
+
+    // Precompute the index translation into the block-cyclic matrix
+    // on the first factorization. The non-zero pattern of the local
+    // Schur complement is fixed by the symbolic factorization, so
+    // subsequent factorizations only pack and exchange values.
+    if (!schur_pattern_init) {
+      int *schur_cols = new int[rowp[mlocal]];
+      for (int i = 0; i < rowp[mlocal]; i++) {
+        schur_cols[i] = local_schur_vars[cols[i]];
+      }
+      bcyclic->initAssemblyPattern(bsize, mlocal, local_schur_vars, rowp,
+                                   schur_cols);
+      delete[] schur_cols;
+      schur_pattern_init = 1;
+    }
 
-  int *schur_cols = new int[rowp[mlocal]];
-  for (int i = 0; i < rowp[mlocal]; i++) {
-    schur_cols[i] = local_schur_vars[cols[i]];
-  }
+    // Add the values into the global Schur complement matrix
+    bcyclic->addPatternValues(scvals);
 
-  // Add the values into the global Schur complement matrix
-  // using either the alltoall approach or a sequential add values
-  // approach that uses less memory
-  if (use_cyclic_alltoall) {
-    bcyclic->addAlltoallValues(bsize, mlocal, local_schur_vars, rowp,
-                               schur_cols, scvals);
-  } else {
-    bcyclic->addAllValues(bsize, mlocal, local_schur_vars, rowp, schur_cols,
-                          scvals);
-  }
-  delete[] schur_cols;
+    if (monitor_factor) {
+      global_schur_assembly += MPI_Wtime();
+      global_schur_time = -MPI_Wtime();
+    }
 
-  if (monitor_factor) {
-    global_schur_assembly += MPI_Wtime();
-    global_schur_time = -MPI_Wtime();
+    // Factor the global Schur complement
+    bcyclic->factor();
   }
 
-  // Factor the global Schur complement
-  bcyclic->factor();
-
   if (monitor_factor) {
     global_schur_time += MPI_Wtime();
 
@@ -1509,6 +1726,55 @@ void TACSSchurPc::factor() {
   }
 }
 
+/*!
+  Count the number of negative pivots in the factorization.
+
+  The factorization is a block triangular decomposition
+
+  [ B, E ]   [ Lb       , 0  ][ Ub,  Lb^{-1} E ]
+  [ F, C ] = [ F Ub^{-1}, Lc ][  0,  Uc        ]
+
+  performed without pivoting, so for a symmetric matrix the inertia
+  is the sum of the inertias of the diagonal pivot blocks: the local
+  factorizations Bpc on each process plus the factored global Schur
+  complement. This permits eigenvalue counting by Sylvester's law of
+  inertia: the number of negative pivots of K - sigma*M equals the
+  number of eigenvalues below sigma.
+
+  This call is collective on the matrix communicator and must follow
+  a call to factor(). The count is only exact when the local
+  factorization is complete (no dropped fill). The count is not
+  available in the sparse global Schur complement mode, since the
+  interface problem is never factored exactly in that mode.
+
+  returns: the global number of negative pivots, or -1 if the count
+  is not available
+*/
+int TACSSchurPc::countNegativePivots() {
+  if (use_sparse_schur) {
+    int rank;
+    MPI_Comm_rank(b_map->getMPIComm(), &rank);
+    if (rank == 0) {
+      fprintf(stderr,
+              "TACSSchurPc: Negative pivot count is not available "
+              "with the sparse global Schur complement\n");
+    }
+    return -1;
+  }
+
+  // Count the negative pivots in the local factorization. Each
+  // process owns a distinct diagonal block B of the global matrix.
+  int count = Bpc->countNegativePivots();
+  MPI_Allreduce(MPI_IN_PLACE, &count, 1, MPI_INT, MPI_SUM,
+                b_map->getMPIComm());
+
+  // Add the contribution from the global Schur complement. This
+  // count is itself collective and is returned on all processes.
+  count += bcyclic->countNegativePivots();
+
+  return count;
+}
+
 /*!
   Apply the preconditioner to the input vector
 
@@ -1600,18 +1866,24 @@ void TACSSchurPc::applyFactor(TACSVec *tin, TACSVec *tout) {
       schur_time = -MPI_Wtime();
     }
 
-    // Apply the global Schur complement factorization to the right
-    // hand side
-    bcyclic->applyFactor(g);
+    if (use_sparse_schur) {
+      // Solve the interface problem approximately with the inner
+      // Krylov method, placing the solution in yschur
+      inner_ksm->solve(gschur, yschur);
+    } else {
+      // Apply the global Schur complement factorization to the right
+      // hand side
+      bcyclic->applyFactor(g);
+
+      // copy the values from gschur to yschur
+      yschur->copyValues(gschur);
+    }
 
     if (monitor_back_solve) {
       schur_time += MPI_Wtime();
       local_time -= schur_time;
     }
 
-    // copy the values from gschur to yschur
-    yschur->copyValues(gschur);
-
     // Pass yschur solution back to the local variables
     schur_dist->beginForward(schur_ctx, y, yinterface);
 
@@ -1655,3 +1927,214 @@ void TACSSchurPc::applyFactor(TACSVec *tin, TACSVec *tout) {
   Retrieve the underlying matrix
 */
 void TACSSchurPc::getMat(TACSMat **_mat) { *_mat = mat; }
+
+/*
+  Create the matrix-free global Schur complement operator
+
+  The operator applies the sum of the local Schur complement
+  contributions without ever assembling the global matrix. The input
+  vector is distributed to the local interface unknowns, each local
+  Schur complement is applied, and the products are summed back into
+  the global ordering.
+
+  input:
+  schur_map:  the variable map for the global Schur unknowns
+  schur_dist: the object that distributes the global Schur unknowns
+  Sc:         the local Schur complement matrix
+*/
+TACSSparseSchurMat::TACSSparseSchurMat(TACSNodeMap *_schur_map,
+                                       TACSBVecDistribute *_schur_dist,
+                                       BCSRMat *_Sc) {
+  schur_map = _schur_map;
+  schur_map->incref();
+  schur_dist = _schur_dist;
+  schur_dist->incref();
+  Sc = _Sc;
+  Sc->incref();
+
+  // Create the context for the distribution object
+  bsize = Sc->getBlockSize();
+  schur_ctx = schur_dist->createCtx(bsize);
+  schur_ctx->incref();
+
+  // Compute the number of locally owned Schur unknowns
+  int rank;
+  MPI_Comm_rank(schur_map->getMPIComm(), &rank);
+  const int *ownerRange;
+  schur_map->getOwnerRange(&ownerRange);
+  nvars = bsize * (ownerRange[rank + 1] - ownerRange[rank]);
+
+  // Allocate the local interface arrays
+  int isize = bsize * schur_dist->getNumNodes();
+  xinterface = new TacsScalar[isize];
+  yinterface = new TacsScalar[isize];
+  memset(xinterface, 0, isize * sizeof(TacsScalar));
+  memset(yinterface, 0, isize * sizeof(TacsScalar));
+}
+
+/*
+  Free the matrix-free global Schur complement operator
+*/
+TACSSparseSchurMat::~TACSSparseSchurMat() {
+  schur_map->decref();
+  schur_dist->decref();
+  schur_ctx->decref();
+  Sc->decref();
+  delete[] xinterface;
+  delete[] yinterface;
+}
+
+/*
+  Get the local size of the matrix
+*/
+void TACSSparseSchurMat::getSize(int *_nr, int *_nc) {
+  *_nr = nvars;
+  *_nc = nvars;
+}
+
+/*
+  Compute the matrix-vector product
+
+  y = S*x = sum_{p} P_{p}^{T}*Sc_{p}*P_{p}*x
+*/
+void TACSSparseSchurMat::mult(TACSVec *txvec, TACSVec *tyvec) {
+  TACSBVec *xvec, *yvec;
+  xvec = dynamic_cast<TACSBVec *>(txvec);
+  yvec = dynamic_cast<TACSBVec *>(tyvec);
+
+  if (xvec && yvec) {
+    TacsScalar *x, *y;
+    xvec->getArray(&x);
+    yvec->getArray(&y);
+
+    // Distribute the global Schur unknowns to the local interface
+    schur_dist->beginForward(schur_ctx, x, xinterface);
+    schur_dist->endForward(schur_ctx, x, xinterface);
+
+    // Apply the local Schur complement
+    Sc->mult(xinterface, yinterface);
+
+    // Sum the products from all processors
+    yvec->zeroEntries();
+    schur_dist->beginReverse(schur_ctx, yinterface, y, TACS_ADD_VALUES);
+    schur_dist->endReverse(schur_ctx, yinterface, y, TACS_ADD_VALUES);
+  } else {
+    fprintf(stderr,
+            "TACSSparseSchurMat type error: Input/output must be TACSBVec\n");
+  }
+}
+
+/*
+  Create a vector for the global Schur complement system
+*/
+TACSVec *TACSSparseSchurMat::createVec() {
+  return new TACSBVec(schur_map, bsize);
+}
+
+/*
+  Create the additive Schwarz preconditioner for the global Schur
+  complement system
+
+  The preconditioner is based on an incomplete factorization of the
+  local Schur complement on each processor. The non-zero pattern of
+  the factorization is computed once here; the numerical values are
+  copied and re-factored on each call to factor().
+
+  input:
+  schur_map:  the variable map for the global Schur unknowns
+  schur_dist: the object that distributes the global Schur unknowns
+  Sc:         the local Schur complement matrix
+  levFill:    the level of fill to use in the factorization
+  fill:       the expected/best estimate of the fill-in factor
+*/
+TACSSparseSchurPc::TACSSparseSchurPc(TACSNodeMap *_schur_map,
+                                     TACSBVecDistribute *_schur_dist,
+                                     BCSRMat *_Sc, int levFill, double fill) {
+  schur_map = _schur_map;
+  schur_map->incref();
+  schur_dist = _schur_dist;
+  schur_dist->incref();
+  Sc = _Sc;
+  Sc->incref();
+
+  // Create the context for the distribution object
+  bsize = Sc->getBlockSize();
+  schur_ctx = schur_dist->createCtx(bsize);
+  schur_ctx->incref();
+
+  // Compute the symbolic incomplete factorization of the local
+  // Schur complement
+  Scpc = new BCSRMat(schur_map->getMPIComm(), Sc, levFill, fill);
+  Scpc->incref();
+
+  // Compute the number of locally owned Schur unknowns
+  int rank;
+  MPI_Comm_rank(schur_map->getMPIComm(), &rank);
+  const int *ownerRange;
+  schur_map->getOwnerRange(&ownerRange);
+  nvars = bsize * (ownerRange[rank + 1] - ownerRange[rank]);
+
+  // Allocate the local interface arrays
+  int isize = bsize * schur_dist->getNumNodes();
+  xinterface = new TacsScalar[isize];
+  yinterface = new TacsScalar[isize];
+  memset(xinterface, 0, isize * sizeof(TacsScalar));
+  memset(yinterface, 0, isize * sizeof(TacsScalar));
+}
+
+/*
+  Free the additive Schwarz preconditioner
+*/
+TACSSparseSchurPc::~TACSSparseSchurPc() {
+  schur_map->decref();
+  schur_dist->decref();
+  schur_ctx->decref();
+  Sc->decref();
+  Scpc->decref();
+  delete[] xinterface;
+  delete[] yinterface;
+}
+
+/*
+  Copy the values of the local Schur complement and compute the
+  incomplete factorization
+*/
+void TACSSparseSchurPc::factor() {
+  Scpc->copyValues(Sc);
+  Scpc->factor();
+}
+
+/*
+  Apply the additive Schwarz preconditioner
+
+  y = sum_{p} P_{p}^{T}*Uc_{p}^{-1}*Lc_{p}^{-1}*P_{p}*x
+
+  Each local back-solve is independent; communication is only
+  required to restrict/prolongate the global interface unknowns.
+*/
+void TACSSparseSchurPc::applyFactor(TACSVec *txvec, TACSVec *tyvec) {
+  TACSBVec *xvec, *yvec;
+  xvec = dynamic_cast<TACSBVec *>(txvec);
+  yvec = dynamic_cast<TACSBVec *>(tyvec);
+
+  if (xvec && yvec) {
+    TacsScalar *x, *y;
+    xvec->getArray(&x);
+    yvec->getArray(&y);
+
+    // Distribute the global residual to the local interface
+    schur_dist->beginForward(schur_ctx, x, xinterface);
+    schur_dist->endForward(schur_ctx, x, xinterface);
+
+    // Apply the local incomplete factorization
+    Scpc->applyFactor(xinterface, yinterface);
+
+    // Sum the local contributions from all processors
+    yvec->zeroEntries();
+    schur_dist->beginReverse(schur_ctx, yinterface, y, TACS_ADD_VALUES);
+    schur_dist->endReverse(schur_ctx, yinterface, y, TACS_ADD_VALUES);
+  } else {
+    fprintf(stderr,
+            "TACSSparseSchurPc type error: Input/output must be TACSBVec\n");
+  }
+}
@@ -101,6 +101,11 @@ class TACSSchurMat : public TACSMat {
   TACSBVecDistribute *getSchurMap() { return c_map; }
   TACSNodeMap *getNodeMap() { return rmap; }
 
+  // Binary export/import of the local matrix blocks
+  // -----------------------------------------------
+  int writeToFile(const char *fname);
+  int readFromFile(const char *fname);
+
  protected:
   TACSSchurMat();
   void init(TACSNodeMap *_rmap, BCSRMat *_B, BCSRMat *_E, BCSRMat *_F,
@@ -123,6 +128,82 @@ class TACSSchurMat : public TACSMat {
   static const char *matName;
 };
 
+/*!
+  A matrix-free operator for the global Schur complement system.
+
+  The global Schur complement is the sum of the local Schur
+  complement contributions
+
+  S = sum_{p} P_{p}^{T}*Sc_{p}*P_{p}
+
+  where P_{p} distributes the unique global interface unknowns to the
+  local interface unknowns on processor p. Rather than assembling S
+  explicitly, this operator applies each local Schur complement in
+  BCSR form and accumulates the result across processors. As a
+  result, the memory required for the interface problem is
+  proportional to the local Schur complement storage, rather than the
+  square of the global interface size.
+*/
+class TACSSparseSchurMat : public TACSMat {
+ public:
+  TACSSparseSchurMat(TACSNodeMap *_schur_map, TACSBVecDistribute *_schur_dist,
+                     BCSRMat *_Sc);
+  ~TACSSparseSchurMat();
+
+  // Functions required for solving linear systems
+  // ---------------------------------------------
+  void getSize(int *_nr, int *_nc);
+  void mult(TACSVec *x, TACSVec *y);
+  TACSVec *createVec();
+
+ private:
+  TACSNodeMap *schur_map;          // Map for the global Schur unknowns
+  TACSBVecDistribute *schur_dist;  // Distributes the global Schur unknowns
+  TACSBVecDistCtx *schur_ctx;      // Context for the distribution object
+  BCSRMat *Sc;                     // The local Schur complement
+
+  int bsize, nvars;        // The block size/number of local unknowns
+  TacsScalar *xinterface;  // The local interface values
+  TacsScalar *yinterface;  // The local interface products
+};
+
+/*!
+  An additive Schwarz preconditioner for the global Schur complement.
+
+  This preconditioner approximates the inverse of the global Schur
+  complement operator by the sum of the approximate inverses of the
+  local Schur complement contributions
+
+  S^{-1} ~ sum_{p} P_{p}^{T}*Uc_{p}^{-1}*Lc_{p}^{-1}*P_{p}
+
+  where Lc*Uc is an incomplete factorization of the local Schur
+  complement. No communication is required during the local
+  back-solves themselves, only during the restriction/prolongation of
+  the global interface unknowns.
+*/
+class TACSSparseSchurPc : public TACSPc {
+ public:
+  TACSSparseSchurPc(TACSNodeMap *_schur_map, TACSBVecDistribute *_schur_dist,
+                    BCSRMat *_Sc, int levFill, double fill);
+  ~TACSSparseSchurPc();
+
+  // Functions associated with the factorization
+  // -------------------------------------------
+  void factor();
+  void applyFactor(TACSVec *xvec, TACSVec *yvec);
+
+ private:
+  TACSNodeMap *schur_map;          // Map for the global Schur unknowns
+  TACSBVecDistribute *schur_dist;  // Distributes the global Schur unknowns
+  TACSBVecDistCtx *schur_ctx;      // Context for the distribution object
+  BCSRMat *Sc;                     // The local Schur complement
+  BCSRMat *Scpc;                   // The factorization of Sc
+
+  int bsize, nvars;        // The block size/number of local unknowns
+  TacsScalar *xinterface;  // The local interface values
+  TacsScalar *yinterface;  // The local interface products
+};
+
 /*!
   The global Schur complement preconditioner.
 
@@ -142,11 +223,21 @@ class TACSSchurMat : public TACSMat {
   filled-in than the original matrices, so this factorization often
   performs extremely well in parallel, and is much smaller than the
   full matrix.
+
+  Alternatively, the preconditioner can keep the global Schur
+  complement in sparse form. In this mode the interface problem is
+  solved approximately with an inner GMRES iteration applied to the
+  matrix-free operator TACSSparseSchurMat, preconditioned with the
+  additive Schwarz method TACSSparseSchurPc. This avoids both the
+  assembly and the dense factorization of the global Schur
+  complement, at the expense of an inexact interface solve.
 */
 class TACSSchurPc : public TACSPc {
  public:
   TACSSchurPc(TACSSchurMat *_mat, int levFill, double fill,
-              int reorder_schur_complement);
+              int reorder_schur_complement, int use_sparse_schur = 0,
+              int inner_gmres_iters = 8, double inner_rtol = 1e-3,
+              double inner_atol = 1e-30);
   ~TACSSchurPc();
 
   // Functions associated with the factorization
@@ -161,6 +252,10 @@ class TACSSchurPc : public TACSPc {
   void setMonitorFactorFlag(int flag);
   void setMonitorBackSolveFlag(int flag);
 
+  // Store and apply the local factorization in single precision
+  // -----------------------------------------------------------
+  void setSinglePrecisionFactor(int flag);
+
   // Set the type of matrix assembly to use
   // --------------------------------------
   void setAlltoallAssemblyFlag(int flag);
@@ -170,6 +265,10 @@ class TACSSchurPc : public TACSPc {
   void getBCSRMat(BCSRMat **_Bpc, BCSRMat **_Epc, BCSRMat **_Fpc,
                   BCSRMat **_Sc);
 
+  // Count the negative pivots in the factorization (collective)
+  // -----------------------------------------------------------
+  int countNegativePivots();
+
  private:
   TACSSchurMat *mat;
   BCSRMat *B, *E, *F, *C;    // The block matrices
@@ -187,6 +286,12 @@ class TACSSchurPc : public TACSPc {
   // The sparse block cyclic matrix
   TACSBlockCyclicMat *bcyclic;  // This stores the Schur complement
 
+  // Data for the sparse global Schur complement mode
+  int use_sparse_schur;          // Keep the global Schur complement sparse
+  TACSSparseSchurMat *gsmat;     // Matrix-free global Schur operator
+  TACSSparseSchurPc *sparse_pc;  // Additive Schwarz preconditioner
+  TACSKsm *inner_ksm;            // Inner solver for the interface problem
+
   // This set of indices defines the ordering passed into the
   // parallel block-cyclic matrix factorization
   int num_local_schur_vars;
@@ -199,6 +304,7 @@ class TACSSchurPc : public TACSPc {
   TACSBVecDistribute *schur_dist;  // Map that distributes the Schur complement
   TACSBVecDistCtx *schur_ctx;      // The context for the distribution object
   int use_cyclic_alltoall;  // Use the Alltoall version for matrix assembly
+  int schur_pattern_init;   // The assembly pattern has been precomputed
 
   // This object defines a mapping between the variables in the
   // global vectors (from ScMat - in/out in applyFactor) and the
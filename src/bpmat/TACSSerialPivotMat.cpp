@@ -308,3 +308,10 @@ void TACSSerialPivotPc::applyFactor(TACSVec *txvec, TACSVec *tyvec) {
   Retrieve the underlying matrix
 */
 void TACSSerialPivotPc::getMat(TACSMat **_mat) { *_mat = mat; }
+
+/*
+  Set the number of threads used during the factorization
+*/
+void TACSSerialPivotPc::setNumThreads(int num_threads) {
+  pivot->setNumThreads(num_threads);
+}
@@ -74,6 +74,10 @@ class TACSSerialPivotPc : public TACSPc {
   void applyFactor(TACSVec *txvec, TACSVec *tyvec);
   void getMat(TACSMat **_mat);
 
+  // Set the number of threads used during the factorization
+  // -------------------------------------------------------
+  void setNumThreads(int num_threads);
+
  private:
   TACSSerialPivotMat *mat;
   double fill;
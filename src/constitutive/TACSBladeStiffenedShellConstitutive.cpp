@@ -346,6 +346,9 @@ void TACSBladeStiffenedShellConstitutive::setStiffenerPlyFractions(
   for (int ii = 0; ii < this->numStiffenerPlies; ii++) {
     this->stiffenerPlyFracs[ii] = plyFractions[ii];
   }
+  this->criticalLoadsUpToDate = false;
+  this->stiffenerStiffnessUpToDate = false;
+  this->shellStiffnessUpToDate = false;
 }
 
 void TACSBladeStiffenedShellConstitutive::setPanelPlyFractions(
@@ -353,6 +356,9 @@ void TACSBladeStiffenedShellConstitutive::setPanelPlyFractions(
   for (int ii = 0; ii < this->numPanelPlies; ii++) {
     this->panelPlyFracs[ii] = plyFractions[ii];
   }
+  this->criticalLoadsUpToDate = false;
+  this->panelStiffnessUpToDate = false;
+  this->shellStiffnessUpToDate = false;
 }
 
 // ==============================================================================
@@ -421,6 +427,13 @@ int TACSBladeStiffenedShellConstitutive::setDesignVars(int elemIndex, int dvLen,
         this->stiffenerPlyFracs[ii] = dvs[this->stiffenerPlyFracLocalNums[ii]];
       }
     }
+
+    // The critical buckling loads and stiffness matrices depend on the
+    // design variables and must be recomputed
+    this->criticalLoadsUpToDate = false;
+    this->panelStiffnessUpToDate = false;
+    this->stiffenerStiffnessUpToDate = false;
+    this->shellStiffnessUpToDate = false;
   }
   return this->numDesignVars;
 }
@@ -844,6 +857,48 @@ TacsScalar TACSBladeStiffenedShellConstitutive::evalFailure(
   return aggFail;
 }
 
+// Calculate the point-wise failure criteria at a batch of points. The
+// critical buckling loads are computed from the design variables only,
+// so the first point of the batch populates the critical load cache
+// and the remaining points reuse it (see updateCriticalLoadCache).
+void TACSBladeStiffenedShellConstitutive::evalFailureBatch(
+    int elemIndex, int npts, const double pts[], const TacsScalar Xpts[],
+    const TacsScalar strains[], TacsScalar fails[]) {
+  TacsScalar failValues[this->NUM_FAILURES];
+  for (int n = 0; n < npts; n++) {
+    fails[n] =
+        this->computeFailureValues(&strains[NUM_STRESSES * n], failValues);
+  }
+}
+
+// Recompute the cached critical buckling loads from the design
+// variables
+void TACSBladeStiffenedShellConstitutive::updateCriticalLoadCache() {
+  // --- Global panel buckling loads ---
+  TacsScalar D1, D2, D3;
+  this->computeCriticalGlobalBucklingStiffness(&D1, &D2, &D3);
+  const TacsScalar L = this->panelLength;
+  this->cachedGlobalAxialLoad = computeCriticalGlobalAxialLoad(D1, L);
+  this->cachedGlobalShearLoad = this->computeCriticalShearLoad(D1, D2, D3, L);
+
+  // --- Local panel buckling loads ---
+  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES];
+  this->computePanelStiffness(panelStiffness);
+  const TacsScalar *A, *D;
+  this->extractTangentStiffness(panelStiffness, &A, NULL, &D, NULL, NULL);
+  const TacsScalar D11 = D[0], D12 = D[1], D22 = D[3], D66 = D[5],
+                   pitch = this->stiffenerPitch;
+  this->cachedLocalAxialLoad =
+      this->computeCriticalLocalAxialLoad(D11, D22, D12, D66, pitch);
+  this->cachedLocalShearLoad =
+      this->computeCriticalShearLoad(D11, D22, D12 + 2.0 * D66, pitch);
+
+  // --- Stiffener column buckling load ---
+  this->cachedColumnBucklingLoad = this->computeStiffenerColumnBucklingLoad();
+
+  this->criticalLoadsUpToDate = true;
+}
+
 // Compute the failure values for each failure mode of the stiffened panel
 TacsScalar TACSBladeStiffenedShellConstitutive::computeFailureValues(
     const TacsScalar e[], TacsScalar fails[]) {
@@ -1117,6 +1172,14 @@ TACSBladeStiffenedShellConstitutive::computeEffectiveBendingThickness() {
 
 // Compute the stiffness matrix
 void TACSBladeStiffenedShellConstitutive::computeStiffness(TacsScalar C[]) {
+  // If the cached stiffness matrix is still valid for the current design
+  // variable values, just copy it out
+  if (this->shellStiffnessUpToDate) {
+    memcpy(C, this->cachedShellStiffness,
+           this->NUM_TANGENT_STIFFNESS_ENTRIES * sizeof(TacsScalar));
+    return;
+  }
+
   // --- Zero out the C matrix ---
   memset(C, 0, this->NUM_TANGENT_STIFFNESS_ENTRIES * sizeof(TacsScalar));
 
@@ -1128,6 +1191,11 @@ void TACSBladeStiffenedShellConstitutive::computeStiffness(TacsScalar C[]) {
   TacsScalar Cstiff[TACSBeamConstitutive::NUM_TANGENT_STIFFNESS_ENTRIES];
   this->computeStiffenerStiffness(Cstiff);
   this->addStiffenerStiffness(Cstiff, C);
+
+  // Cache the result so subsequent calls at this design point are a copy
+  memcpy(this->cachedShellStiffness, C,
+         this->NUM_TANGENT_STIFFNESS_ENTRIES * sizeof(TacsScalar));
+  this->shellStiffnessUpToDate = true;
 }
 
 void TACSBladeStiffenedShellConstitutive::computeSmearedStiffness(
@@ -1422,6 +1490,14 @@ void TACSBladeStiffenedShellConstitutive::addPanelStressDVSens(
 
 void TACSBladeStiffenedShellConstitutive::computePanelStiffness(
     TacsScalar C[]) {
+  // If the cached panel stiffness matrix is still valid for the current
+  // design variable values, just copy it out
+  if (this->panelStiffnessUpToDate) {
+    memcpy(C, this->cachedPanelStiffness,
+           this->NUM_TANGENT_STIFFNESS_ENTRIES * sizeof(TacsScalar));
+    return;
+  }
+
   TacsScalar* A = &C[0];
   TacsScalar* D = &C[12];
   TacsScalar* As = &C[18];
@@ -1452,6 +1528,11 @@ void TACSBladeStiffenedShellConstitutive::computePanelStiffness(
 
   // Add the drill stiffness
   C[21] = DRILLING_REGULARIZATION * 0.5 * (As[0] + As[2]);
+
+  // Cache the result so subsequent calls at this design point are a copy
+  memcpy(this->cachedPanelStiffness, C,
+         this->NUM_TANGENT_STIFFNESS_ENTRIES * sizeof(TacsScalar));
+  this->panelStiffnessUpToDate = true;
 }
 
 // Compute the failure criteria in the panel
@@ -1696,6 +1777,15 @@ void TACSBladeStiffenedShellConstitutive::addStiffenerStressDVSens(
 // Compute the stiffener's beam stiffness matrix
 void TACSBladeStiffenedShellConstitutive::computeStiffenerStiffness(
     TacsScalar C[]) {
+  // If the cached stiffener stiffness matrix is still valid for the current
+  // design variable values, just copy it out
+  if (this->stiffenerStiffnessUpToDate) {
+    memcpy(C, this->cachedStiffenerStiffness,
+           TACSBeamConstitutive::NUM_TANGENT_STIFFNESS_ENTRIES *
+               sizeof(TacsScalar));
+    return;
+  }
+
   // --- Zero out the C matrix ---
   memset(
       C, 0,
@@ -1715,6 +1805,12 @@ void TACSBladeStiffenedShellConstitutive::computeStiffenerStiffness(
   C[11] = E * Izz;              // C[2, 2]
   C[18] = this->kcorr * G * A;  // C[4, 4]
   C[20] = this->kcorr * G * A;  // C[5, 5]
+
+  // Cache the result so subsequent calls at this design point are a copy
+  memcpy(this->cachedStiffenerStiffness, C,
+         TACSBeamConstitutive::NUM_TANGENT_STIFFNESS_ENTRIES *
+             sizeof(TacsScalar));
+  this->stiffenerStiffnessUpToDate = true;
 }
 
 void TACSBladeStiffenedShellConstitutive::computeEffectiveModulii(
@@ -2034,12 +2130,11 @@ void TACSBladeStiffenedShellConstitutive::computeStiffenerMOISens(
 TacsScalar TACSBladeStiffenedShellConstitutive::evalGlobalPanelBuckling(
     const TacsScalar e[]) {
   TacsScalar stress[TACSShellConstitutive::NUM_STRESSES];
-  TacsScalar D1, D2, D3;
-  this->computeCriticalGlobalBucklingStiffness(&D1, &D2, &D3);
-  const TacsScalar L = this->panelLength;
-
-  const TacsScalar N1Crit = computeCriticalGlobalAxialLoad(D1, L);
-  const TacsScalar N12Crit = this->computeCriticalShearLoad(D1, D2, D3, L);
+  if (!this->criticalLoadsUpToDate) {
+    this->updateCriticalLoadCache();
+  }
+  const TacsScalar N1Crit = this->cachedGlobalAxialLoad;
+  const TacsScalar N12Crit = this->cachedGlobalShearLoad;
 
   this->evalStress(0, NULL, NULL, e, stress);
   return this->bucklingEnvelope(-stress[0], N1Crit, stress[2], N12Crit);
@@ -2677,21 +2772,15 @@ void TACSBladeStiffenedShellConstitutive::testGlobalBucklingStiffnessSens() {
 
 TacsScalar TACSBladeStiffenedShellConstitutive::evalLocalPanelBuckling(
     const TacsScalar e[]) {
-  // Compute panel stiffness matrix and loads
-  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES],
-      stress[NUM_STRESSES];
-  this->computePanelStiffness(panelStiffness);
-  const TacsScalar *A, *D;
-  this->extractTangentStiffness(panelStiffness, &A, NULL, &D, NULL, NULL);
+  // Compute the panel stress and look up the cached critical loads
+  TacsScalar stress[NUM_STRESSES];
+  if (!this->criticalLoadsUpToDate) {
+    this->updateCriticalLoadCache();
+  }
   this->computePanelStress(e, stress);
 
-  // Compute the critical local loads
-  const TacsScalar D11 = D[0], D12 = D[1], D22 = D[3], D66 = D[5],
-                   L = this->stiffenerPitch;
-  const TacsScalar N1Crit =
-      this->computeCriticalLocalAxialLoad(D11, D22, D12, D66, L);
-  const TacsScalar N12Crit =
-      this->computeCriticalShearLoad(D11, D22, D12 + 2.0 * D66, L);
+  const TacsScalar N1Crit = this->cachedLocalAxialLoad;
+  const TacsScalar N12Crit = this->cachedLocalShearLoad;
 
   // Compute the buckling criteria
   return this->bucklingEnvelope(-stress[0], N1Crit, stress[2], N12Crit);
@@ -3082,7 +3171,10 @@ TacsScalar TACSBladeStiffenedShellConstitutive::evalStiffenerColumnBuckling(
   TacsScalar stiffenerStress[TACSBeamConstitutive::NUM_STRESSES];
   this->computeStiffenerStress(stiffenerStrain, stiffenerStress);
   // The first component of the stiffener stress is the axial force
-  TacsScalar fCrit = this->computeStiffenerColumnBucklingLoad();
+  if (!this->criticalLoadsUpToDate) {
+    this->updateCriticalLoadCache();
+  }
+  TacsScalar fCrit = this->cachedColumnBucklingLoad;
   return -stiffenerStress[0] / fCrit;
 }
 
@@ -381,6 +381,13 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
   TacsScalar evalFailure(int elemIndex, const double pt[], const TacsScalar X[],
                          const TacsScalar e[]);
 
+  // Calculate the failure criteria at a batch of points. The critical
+  // buckling loads depend only on the design variables and are cached
+  // across the batch (see updateCriticalLoadCache)
+  void evalFailureBatch(int elemIndex, int npts, const double pts[],
+                        const TacsScalar Xpts[], const TacsScalar strains[],
+                        TacsScalar fails[]);
+
   // Evaluate the derivative of the failure criteria w.r.t. the strain
   TacsScalar evalFailureStrainSens(int elemIndex, const double pt[],
                                    const TacsScalar X[], const TacsScalar e[],
@@ -461,6 +468,9 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
   /**
    * @brief Compute the stiffness matrix of the stiffened shell
    *
+   * The stiffness matrix depends only on the design variables, so the result
+   * is cached and reused until the design variables change
+   *
    * @param C Array to store the stiffness matrix in (will be zeroed out within
    * this function)
    */
@@ -512,6 +522,17 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
    */
   TacsScalar computeFailureValues(const TacsScalar e[], TacsScalar fail[]);
 
+  /**
+   * @brief Recompute the cached critical buckling loads
+   *
+   * The critical global and local panel buckling loads and the stiffener
+   * column buckling load depend only on the design variables, not on the
+   * strain state, so they are computed once and reused for every
+   * quadrature point until the design variables change. The cache is
+   * invalidated whenever the design variables or ply fractions are set.
+   */
+  void updateCriticalLoadCache();
+
   // ==============================================================================
   // Helper functions for transforming strains/stresses/stiffnesses between the
   // panel and stiffener
@@ -647,6 +668,9 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
   /**
    * @brief Compute the stiffness matrix of the panel (without stiffeners)
    *
+   * The panel stiffness depends only on the design variables, so the result
+   * is cached and reused until the design variables change
+   *
    * @param C Array to store the stiffness matrix in (will be zeroed out within
    * this function)
    */
@@ -733,6 +757,9 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
   /**
    * @brief Compute the stiffener's stiffness matrix
    *
+   * The stiffener stiffness depends only on the design variables, so the
+   * result is cached and reused until the design variables change
+   *
    * @param C The stiffener local stiffness matrix (The derivative of the beam
    * stresses w.r.t the beam strains)
    */
@@ -1334,6 +1361,33 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
   TacsScalar* panelPlyFracs;      ///< Panel ply Fracs
   TacsScalar* stiffenerPlyFracs;  ///< Stiffener ply Fracs
 
+  // --- Cached critical buckling loads (see updateCriticalLoadCache) ---
+  bool criticalLoadsUpToDate = false;  ///< Whether the cache is valid
+  TacsScalar cachedGlobalAxialLoad;    ///< Critical global axial load
+  TacsScalar cachedGlobalShearLoad;    ///< Critical global shear load
+  TacsScalar cachedLocalAxialLoad;     ///< Critical local axial load
+  TacsScalar cachedLocalShearLoad;     ///< Critical local shear load
+  TacsScalar cachedColumnBucklingLoad;  ///< Critical column buckling load
+
+  // --- Cached stiffness matrices ---
+  // These depend only on the design variables, so they are computed once per
+  // design iteration and invalidated whenever the design variables change
+  bool panelStiffnessUpToDate = false;  ///< Whether the panel stiffness cache
+                                        ///< is valid
+  bool stiffenerStiffnessUpToDate = false;  ///< Whether the stiffener
+                                            ///< stiffness cache is valid
+  bool shellStiffnessUpToDate = false;  ///< Whether the full shell stiffness
+                                        ///< cache is valid
+  TacsScalar cachedPanelStiffness
+      [NUM_TANGENT_STIFFNESS_ENTRIES];  ///< Cached panel stiffness matrix
+  TacsScalar cachedStiffenerStiffness
+      [TACSBeamConstitutive::
+           NUM_TANGENT_STIFFNESS_ENTRIES];  ///< Cached stiffener stiffness
+                                            ///< matrix
+  TacsScalar cachedShellStiffness
+      [NUM_TANGENT_STIFFNESS_ENTRIES];  ///< Cached stiffened shell stiffness
+                                        ///< matrix
+
   // --- Fixed parameters ---
   TacsScalar* panelPlyAngles;      ///< Panel ply angles
   TacsScalar* stiffenerPlyAngles;  ///< Stiffener ply angles
@@ -195,6 +195,50 @@ TacsScalar TACSCompositeShellConstitutive::evalFailure(
   return max;
 }
 
+/*
+  Compute the most critical failure criteria at a batch of points.
+
+  The laminate thickness and the through-thickness position of each
+  ply depend only on the design, so they are computed once for the
+  whole batch rather than once per quadrature point.
+*/
+void TACSCompositeShellConstitutive::evalFailureBatch(
+    int elemIndex, int npts, const double pts[], const TacsScalar Xpts[],
+    const TacsScalar strains[], TacsScalar fails[]) {
+  // Compute the total thickness of the laminate and the position of
+  // the mid-plane of each ply
+  TacsScalar t = 0.0;
+  for (int i = 0; i < num_plies; i++) {
+    t += ply_thickness[i];
+  }
+
+  TacsScalar* tp = new TacsScalar[num_plies];
+  TacsScalar t0 = -(0.5 + tOffset) * t;
+  for (int i = 0; i < num_plies; i++) {
+    tp[i] = t0 + 0.5 * ply_thickness[i];
+    t0 += ply_thickness[i];
+  }
+
+  for (int n = 0; n < npts; n++) {
+    const TacsScalar* strain = &strains[NUM_STRESSES * n];
+
+    // Keep track of the maximum failure criterion
+    TacsScalar max = 0.0;
+    for (int i = 0; i < num_plies; i++) {
+      TacsScalar lamStrain[3];
+      getLaminaStrain(lamStrain, strain, tp[i]);
+      TacsScalar fval = ply_props[i]->failure(ply_angles[i], lamStrain);
+
+      if (TacsRealPart(fval) > TacsRealPart(max)) {
+        max = fval;
+      }
+    }
+    fails[n] = max;
+  }
+
+  delete[] tp;
+}
+
 // Evaluate the derivative of the failure criteria w.r.t. the strain
 TacsScalar TACSCompositeShellConstitutive::evalFailureStrainSens(
     int elemIndex, const double pt[], const TacsScalar X[],
@@ -52,6 +52,12 @@ class TACSCompositeShellConstitutive : public TACSShellConstitutive {
   TacsScalar evalFailure(int elemIndex, const double pt[], const TacsScalar X[],
                          const TacsScalar e[]);
 
+  // Evaluate failure at a batch of points, computing the laminate
+  // geometry only once for the whole batch
+  void evalFailureBatch(int elemIndex, int npts, const double pts[],
+                        const TacsScalar Xpts[], const TacsScalar strains[],
+                        TacsScalar fails[]);
+
   // Evaluate the derivative of the failure criteria w.r.t. the strain
   TacsScalar evalFailureStrainSens(int elemIndex, const double pt[],
                                    const TacsScalar X[], const TacsScalar e[],
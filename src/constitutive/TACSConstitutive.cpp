@@ -69,19 +69,17 @@ void TACSConstitutive::getFailureEnvelope(
     evalStress(elemIndex, pt, X, e, &C[i * nstress]);
   }
 
-  // Factor the constitutive matrix
+  // Factor the constitutive matrix. This takes the unrolled
+  // fixed-size path since nstress is element-sized.
   int info;
-  LAPACKgetrf(&nstress, &nstress, C, &nstress, ipiv, &info);
+  TacsLAPACKgetrf(nstress, C, ipiv, &info);
 
   // Copy over the stress values and solve for the strain
   memcpy(x_strain, x_stress, nstress * sizeof(TacsScalar));
   memcpy(y_strain, y_stress, nstress * sizeof(TacsScalar));
 
-  int one = 1;
-  LAPACKgetrs("N", &nstress, &one, C, &nstress, ipiv, x_strain, &nstress,
-              &info);
-  LAPACKgetrs("N", &nstress, &one, C, &nstress, ipiv, y_strain, &nstress,
-              &info);
+  TacsLAPACKgetrs(nstress, 1, C, ipiv, x_strain, &info);
+  TacsLAPACKgetrs(nstress, 1, C, ipiv, y_strain, &info);
 
   TacsScalar P = 1.0;
   for (int k = 0; k < npts; k++) {
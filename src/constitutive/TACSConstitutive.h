@@ -530,6 +530,33 @@ class TACSConstitutive : public TACSObject {
     return 0.0;
   }
 
+  /**
+    Evaluate the failure index at a batch of quadrature points
+
+    The default implementation simply loops over the points and calls
+    evalFailure(). Subclasses override this to hoist the design
+    variable-dependent precomputation out of the point loop, so that
+    evaluating all of the quadrature points of an element costs one
+    setup instead of one per point.
+
+    @param elemIndex The local element index
+    @param npts The number of quadrature points in the batch
+    @param pts The parametric points (3 values per point)
+    @param Xpts The physical node locations (3 values per point)
+    @param strains The strain values (getNumStresses() values per point)
+    @param fails The failure index value at each point
+  */
+  virtual void evalFailureBatch(int elemIndex, int npts, const double pts[],
+                                const TacsScalar Xpts[],
+                                const TacsScalar strains[],
+                                TacsScalar fails[]) {
+    int nstress = getNumStresses();
+    for (int i = 0; i < npts; i++) {
+      fails[i] = evalFailure(elemIndex, &pts[3 * i], &Xpts[3 * i],
+                             &strains[nstress * i]);
+    }
+  }
+
   /**
     Evaluate the failure index at a quadrature point
 
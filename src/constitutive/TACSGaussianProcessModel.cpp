@@ -1,5 +1,7 @@
 #include "TACSGaussianProcessModel.h"
 
+#include "tacslapack.h"
+
 TACSGaussianProcessModel::TACSGaussianProcessModel(int n_train, int n_param,
                                                    const TacsScalar Xtrain[],
                                                    const TacsScalar alpha[],
@@ -56,6 +58,34 @@ TacsScalar TACSGaussianProcessModel::predictMeanTestData(
   return Ytest;
 }
 
+void TACSGaussianProcessModel::predictMeanTestDataBatch(int n_test,
+                                                        const TacsScalar* Xtest,
+                                                        TacsScalar* Ytest) {
+  // Xtest is an array of size n_test * n_param (a block of test data points)
+  // use the equation mean(Ytest) = cov(Xtest,X_train) @ alpha, assembling the
+  // cross-term covariance matrix for the whole block and applying it to alpha
+  // with a single BLAS matrix-vector product
+
+  // assemble the kernel matrix in column-major order with one column per
+  // training data point, so K[itest + n_test * itrain] = k(Xtest_i, Xtrain_j)
+  TacsScalar* K = new TacsScalar[(size_t)n_test * n_train];
+  for (int itrain = 0; itrain < n_train; itrain++) {
+    TacsScalar* loc_Xtrain = &Xtrain[n_param * itrain];
+    for (int itest = 0; itest < n_test; itest++) {
+      K[itest + (size_t)n_test * itrain] =
+          kernel(&Xtest[n_param * itest], loc_Xtrain);
+    }
+  }
+
+  // compute Ytest = K @ alpha
+  TacsScalar a = 1.0, b = 0.0;
+  int one = 1;
+  BLASgemv("N", &n_test, &n_train, &a, K, &n_test, alpha, &one, &b, Ytest,
+           &one);
+
+  delete[] K;
+}
+
 TacsScalar TACSGaussianProcessModel::predictMeanTestDataSens(
     const TacsScalar Ysens, const TacsScalar* Xtest, TacsScalar* Xtestsens) {
   // Xtest is an array of size n_param (for one test data point)
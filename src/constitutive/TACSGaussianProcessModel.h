@@ -45,6 +45,20 @@ class TACSGaussianProcessModel : public TACSObject {
    */
   TacsScalar predictMeanTestData(const TacsScalar* Xtest);
 
+  /**
+   * @brief predict the mean test data Ytest for a block of test data points
+   *
+   * the kernel matrix k(Xtest, Xtrain) for the whole block is assembled first
+   * and then applied to the alpha training weights with a single BLAS GEMV
+   * call, which is much faster than predicting the test points one at a time
+   *
+   * @param n_test the number of test data points in the block
+   * @param Xtest the 2-tensor of test data inputs, length n_test * n_param
+   * @param Ytest the predicted test data outputs, an array of length n_test
+   */
+  void predictMeanTestDataBatch(int n_test, const TacsScalar* Xtest,
+                                TacsScalar* Ytest);
+
   /**
    * @brief backpropagate derivatives df/dYtest to df/dXtest for
    * predictMeanTestData
@@ -296,6 +296,57 @@ TacsScalar TACSIsoShellConstitutive::evalFailure(int elemIndex,
   return 0.0;
 }
 
+// Calculate the failure criteria at a batch of points. The tangent
+// stiffness and the through-thickness evaluation heights depend only
+// on the design variables, so they are computed once for the batch.
+void TACSIsoShellConstitutive::evalFailureBatch(int elemIndex, int npts,
+                                                const double pts[],
+                                                const TacsScalar Xpts[],
+                                                const TacsScalar strains[],
+                                                TacsScalar fails[]) {
+  if (properties) {
+    TacsScalar ht = (0.5 - tOffset) * t;
+    TacsScalar hb = -(0.5 + tOffset) * t;
+
+    TacsScalar C[6];
+    properties->evalTangentStiffness2D(C);
+
+    for (int n = 0; n < npts; n++) {
+      const TacsScalar* e = &strains[NUM_STRESSES * n];
+
+      TacsScalar et[3], eb[3];
+      et[0] = e[0] + ht * e[3];
+      et[1] = e[1] + ht * e[4];
+      et[2] = e[2] + ht * e[5];
+
+      eb[0] = e[0] + hb * e[3];
+      eb[1] = e[1] + hb * e[4];
+      eb[2] = e[2] + hb * e[5];
+
+      TacsScalar st[3], sb[3];
+      mat3x3SymmMult(C, et, st);
+      mat3x3SymmMult(C, eb, sb);
+
+      TacsScalar top = properties->vonMisesFailure2D(st);
+      TacsScalar bottom = properties->vonMisesFailure2D(sb);
+
+      TacsScalar ksMax;
+      if (TacsRealPart(top) > TacsRealPart(bottom)) {
+        ksMax = top;
+      } else {
+        ksMax = bottom;
+      }
+
+      // Use a ks approximation for the max value
+      TacsScalar ksSum =
+          exp(ksWeight * (top - ksMax)) + exp(ksWeight * (bottom - ksMax));
+      fails[n] = ksMax + log(ksSum) / ksWeight;
+    }
+  } else {
+    memset(fails, 0, npts * sizeof(TacsScalar));
+  }
+}
+
 // Evaluate the derivative of the failure criteria w.r.t. the strain
 TacsScalar TACSIsoShellConstitutive::evalFailureStrainSens(int elemIndex,
                                                            const double pt[],
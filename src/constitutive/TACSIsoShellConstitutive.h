@@ -86,6 +86,12 @@ class TACSIsoShellConstitutive : public TACSShellConstitutive {
   TacsScalar evalFailure(int elemIndex, const double pt[], const TacsScalar X[],
                          const TacsScalar e[]);
 
+  // Calculate the failure criteria at a batch of points, evaluating
+  // the tangent stiffness only once for the whole batch
+  void evalFailureBatch(int elemIndex, int npts, const double pts[],
+                        const TacsScalar Xpts[], const TacsScalar strains[],
+                        TacsScalar fails[]);
+
   // Evaluate the derivative of the failure criteria w.r.t. the strain
   TacsScalar evalFailureStrainSens(int elemIndex, const double pt[],
                                    const TacsScalar X[], const TacsScalar e[],
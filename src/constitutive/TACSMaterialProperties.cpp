@@ -21,6 +21,173 @@
 const static double LINEAR_STRESS_CUTOFF = 1e-15;
 const static double HUGE_FAILURE_LOAD = 1e20;
 
+/*
+  Build the precompiled property interpolation table.
+
+  Each sampled property curve is resampled linearly onto a uniform
+  temperature grid spanning the sample range and converted into cubic
+  Hermite segment coefficients, with the segment slopes taken from
+  central differences of the grid values. Evaluation then needs only
+  the clamped interval index and a cubic polynomial per property.
+
+  input:
+  num_props:      the number of property curves
+  num_points:     the number of sample points per curve
+  Tpts:           the sample temperatures in increasing order
+  values:         the sampled values: values[j*num_points + i] is the
+                  value of property j at temperature Tpts[i]
+  num_intervals:  the number of uniform grid intervals
+*/
+TACSMaterialPropertyTable::TACSMaterialPropertyTable(int _num_props,
+                                                     int num_points,
+                                                     const TacsScalar Tpts[],
+                                                     const TacsScalar *values,
+                                                     int _num_intervals) {
+  num_props = _num_props;
+  num_intervals = _num_intervals;
+  if (num_intervals < 1) {
+    num_intervals = 1;
+  }
+
+  Tmin = TacsRealPart(Tpts[0]);
+  double Tmax = TacsRealPart(Tpts[num_points - 1]);
+  if (num_points < 2 || Tmax <= Tmin) {
+    fprintf(stderr,
+            "TACSMaterialPropertyTable: at least two increasing "
+            "sample temperatures are required\n");
+    Tmax = Tmin + 1.0;
+    num_intervals = 1;
+  }
+  dT = (Tmax - Tmin) / num_intervals;
+  inv_dT = 1.0 / dT;
+
+  // Resample each property curve linearly onto the uniform grid
+  const int ngrid = num_intervals + 1;
+  TacsScalar *grid = new TacsScalar[num_props * ngrid];
+  for (int j = 0; j < num_props; j++) {
+    const TacsScalar *vals = &values[j * num_points];
+    int p = 0;
+    for (int k = 0; k < ngrid; k++) {
+      double t = Tmin + dT * k;
+      while (p < num_points - 2 && t > TacsRealPart(Tpts[p + 1])) {
+        p++;
+      }
+      double span = TacsRealPart(Tpts[p + 1]) - TacsRealPart(Tpts[p]);
+      TacsScalar xi = 0.0;
+      if (span > 0.0) {
+        xi = (t - TacsRealPart(Tpts[p])) / span;
+      }
+      grid[j * ngrid + k] = (1.0 - xi) * vals[p] + xi * vals[p + 1];
+    }
+  }
+
+  // Convert the grid values into cubic Hermite coefficients on each
+  // interval, parametrized by the local temperature offset
+  coef = new TacsScalar[4 * num_props * num_intervals];
+  for (int k = 0; k < num_intervals; k++) {
+    for (int j = 0; j < num_props; j++) {
+      const TacsScalar *g = &grid[j * ngrid];
+
+      // Compute the end-point slopes by central differences, with
+      // one-sided differences at the ends of the table
+      TacsScalar m0, m1;
+      if (k > 0) {
+        m0 = 0.5 * inv_dT * (g[k + 1] - g[k - 1]);
+      } else {
+        m0 = inv_dT * (g[k + 1] - g[k]);
+      }
+      if (k < num_intervals - 1) {
+        m1 = 0.5 * inv_dT * (g[k + 2] - g[k]);
+      } else {
+        m1 = inv_dT * (g[k + 1] - g[k]);
+      }
+
+      TacsScalar *c = &coef[4 * (num_props * k + j)];
+      c[0] = g[k];
+      c[1] = m0;
+      c[2] = 3.0 * inv_dT * inv_dT * (g[k + 1] - g[k]) -
+             inv_dT * (2.0 * m0 + m1);
+      c[3] = 2.0 * inv_dT * inv_dT * inv_dT * (g[k] - g[k + 1]) +
+             inv_dT * inv_dT * (m0 + m1);
+    }
+  }
+
+  delete[] grid;
+}
+
+TACSMaterialPropertyTable::~TACSMaterialPropertyTable() { delete[] coef; }
+
+/*
+  Get the number of property curves stored in the table
+*/
+int TACSMaterialPropertyTable::getNumProperties() { return num_props; }
+
+/*
+  Get the temperature range covered by the table
+*/
+void TACSMaterialPropertyTable::getTemperatureRange(TacsScalar *_Tmin,
+                                                    TacsScalar *_Tmax) {
+  *_Tmin = Tmin;
+  *_Tmax = Tmin + dT * num_intervals;
+}
+
+/*
+  Evaluate all of the properties at a single temperature.
+
+  The interval index is computed from the real part of the input
+  temperature, while the cubic polynomial is evaluated in TacsScalar
+  arithmetic so that complex-step and dual-number derivatives
+  propagate through the interpolation.
+*/
+void TACSMaterialPropertyTable::evalProperties(TacsScalar T,
+                                               TacsScalar props[]) {
+  int k = (int)((TacsRealPart(T) - Tmin) * inv_dT);
+  k = (k < 0 ? 0 : (k >= num_intervals ? num_intervals - 1 : k));
+  TacsScalar s = T - (Tmin + dT * k);
+
+  const TacsScalar *c = &coef[4 * num_props * k];
+  for (int j = 0; j < num_props; j++, c += 4) {
+    props[j] = c[0] + s * (c[1] + s * (c[2] + s * c[3]));
+  }
+}
+
+/*
+  Evaluate all of the properties at a batch of temperatures.
+
+  The values for temperature i are stored at &props[num_props*i], so
+  one call serves all of the quadrature points of an element.
+*/
+void TACSMaterialPropertyTable::evalPropertiesBatch(int n,
+                                                    const TacsScalar T[],
+                                                    TacsScalar props[]) {
+  for (int i = 0; i < n; i++) {
+    int k = (int)((TacsRealPart(T[i]) - Tmin) * inv_dT);
+    k = (k < 0 ? 0 : (k >= num_intervals ? num_intervals - 1 : k));
+    TacsScalar s = T[i] - (Tmin + dT * k);
+
+    const TacsScalar *c = &coef[4 * num_props * k];
+    TacsScalar *p = &props[num_props * i];
+    for (int j = 0; j < num_props; j++, c += 4) {
+      p[j] = c[0] + s * (c[1] + s * (c[2] + s * c[3]));
+    }
+  }
+}
+
+/*
+  Evaluate the temperature derivative of all of the properties
+*/
+void TACSMaterialPropertyTable::evalPropertiesDeriv(TacsScalar T,
+                                                    TacsScalar dprops[]) {
+  int k = (int)((TacsRealPart(T) - Tmin) * inv_dT);
+  k = (k < 0 ? 0 : (k >= num_intervals ? num_intervals - 1 : k));
+  TacsScalar s = T - (Tmin + dT * k);
+
+  const TacsScalar *c = &coef[4 * num_props * k];
+  for (int j = 0; j < num_props; j++, c += 4) {
+    dprops[j] = c[1] + s * (2.0 * c[2] + 3.0 * s * c[3]);
+  }
+}
+
 TACSMaterialProperties::TACSMaterialProperties(
     TacsScalar _rho, TacsScalar _specific_heat, TacsScalar _E, TacsScalar _nu,
     TacsScalar _ys, TacsScalar _alpha, TacsScalar _kappa) {
@@ -60,6 +227,7 @@ TACSMaterialProperties::TACSMaterialProperties(
   kappa1 = kappa;
 
   mat_type = TACS_ISOTROPIC_MATERIAL;
+  temp_table = NULL;
 }
 
 TACSMaterialProperties::TACSMaterialProperties(
@@ -71,6 +239,7 @@ TACSMaterialProperties::TACSMaterialProperties(
     TacsScalar _alpha1, TacsScalar _alpha2, TacsScalar _alpha3,
     TacsScalar _kappa1, TacsScalar _kappa2, TacsScalar _kappa3) {
   mat_type = TACS_ANISOTROPIC_MATERIAL;
+  temp_table = NULL;
 
   rho = _rho;
   specific_heat = _specific_heat;
@@ -119,6 +288,105 @@ TACSMaterialProperties::TACSMaterialProperties(
   kappa3 = _kappa3;
 }
 
+TACSMaterialProperties::~TACSMaterialProperties() {
+  if (temp_table) {
+    temp_table->decref();
+  }
+}
+
+/*
+  Set the temperature dependence of the isotropic thermal-structural
+  properties from sampled curves.
+
+  The curves are compiled into a single uniform-grid interpolation
+  table so that the temperature-dependent constitutive evaluations
+  reduce to one table lookup per quadrature point. Any of the curves
+  may be NULL - the corresponding property is then held at its
+  constant value across the temperature range.
+
+  input:
+  num_points:  the number of sample points per curve
+  Tpts:        the sample temperatures in increasing order
+  E_T:         the elastic modulus at each sample temperature
+  alpha_T:     the thermal expansion coefficient at each sample
+  kappa_T:     the thermal conductivity at each sample
+  cp_T:        the specific heat at each sample
+*/
+void TACSMaterialProperties::setTemperatureDependence(
+    int num_points, const TacsScalar Tpts[], const TacsScalar E_T[],
+    const TacsScalar alpha_T[], const TacsScalar kappa_T[],
+    const TacsScalar cp_T[]) {
+  if (mat_type != TACS_ISOTROPIC_MATERIAL) {
+    fprintf(stderr,
+            "TACSMaterialProperties: temperature dependence is only "
+            "implemented for isotropic materials\n");
+    return;
+  }
+
+  // Assemble the sampled curves, substituting the constant property
+  // values for the curves that were not provided
+  TacsScalar *values = new TacsScalar[NUM_TEMP_PROPS * num_points];
+  for (int i = 0; i < num_points; i++) {
+    values[PROP_E * num_points + i] = (E_T ? E_T[i] : E);
+    values[PROP_ALPHA * num_points + i] = (alpha_T ? alpha_T[i] : alpha);
+    values[PROP_KAPPA * num_points + i] = (kappa_T ? kappa_T[i] : kappa);
+    values[PROP_SPECIFIC_HEAT * num_points + i] =
+        (cp_T ? cp_T[i] : specific_heat);
+  }
+
+  if (temp_table) {
+    temp_table->decref();
+  }
+  temp_table = new TACSMaterialPropertyTable(NUM_TEMP_PROPS, num_points, Tpts,
+                                             values);
+  temp_table->incref();
+  delete[] values;
+}
+
+/*
+  Get the compiled property table - NULL if the properties are
+  constant
+*/
+TACSMaterialPropertyTable *TACSMaterialProperties::getPropertyTable() {
+  return temp_table;
+}
+
+/*
+  Evaluate the temperature-dependent properties for a batch of
+  quadrature-point temperatures in one pass.
+
+  Each of the output arrays may be NULL if that property is not
+  needed. When no temperature dependence has been set, the outputs
+  are filled with the constant property values.
+*/
+void TACSMaterialProperties::evalTemperatureProperties(
+    int n, const TacsScalar T[], TacsScalar E_T[], TacsScalar alpha_T[],
+    TacsScalar kappa_T[], TacsScalar cp_T[]) {
+  for (int i = 0; i < n; i++) {
+    TacsScalar props[NUM_TEMP_PROPS];
+    if (temp_table) {
+      temp_table->evalProperties(T[i], props);
+    } else {
+      props[PROP_E] = E;
+      props[PROP_ALPHA] = alpha;
+      props[PROP_KAPPA] = kappa;
+      props[PROP_SPECIFIC_HEAT] = specific_heat;
+    }
+    if (E_T) {
+      E_T[i] = props[PROP_E];
+    }
+    if (alpha_T) {
+      alpha_T[i] = props[PROP_ALPHA];
+    }
+    if (kappa_T) {
+      kappa_T[i] = props[PROP_KAPPA];
+    }
+    if (cp_T) {
+      cp_T[i] = props[PROP_SPECIFIC_HEAT];
+    }
+  }
+}
+
 // Get the material type
 MaterialType TACSMaterialProperties::getMaterialType() { return mat_type; }
 
@@ -348,6 +616,96 @@ void TACSMaterialProperties::evalThermalStrain2D(TacsScalar e[]) {
   e[2] = 0.0;
 }
 
+/*
+  Temperature-dependent evaluation of the constitutive relationships.
+
+  For an isotropic material with constant Poisson ratio, every entry
+  of the tangent stiffness is proportional to the elastic modulus, so
+  the temperature dependence reduces to a single scale factor applied
+  to the constant-property stiffness. When no temperature dependence
+  has been set, these reduce to the constant-property evaluations.
+*/
+TacsScalar TACSMaterialProperties::getSpecificHeat(TacsScalar T) {
+  if (temp_table) {
+    TacsScalar props[NUM_TEMP_PROPS];
+    temp_table->evalProperties(T, props);
+    return props[PROP_SPECIFIC_HEAT];
+  }
+  return specific_heat;
+}
+
+void TACSMaterialProperties::evalTangentStiffness3D(TacsScalar T,
+                                                    TacsScalar C[]) {
+  evalTangentStiffness3D(C);
+  if (temp_table) {
+    TacsScalar props[NUM_TEMP_PROPS];
+    temp_table->evalProperties(T, props);
+    TacsScalar scale = props[PROP_E] / E;
+    for (int i = 0; i < 21; i++) {
+      C[i] *= scale;
+    }
+  }
+}
+
+void TACSMaterialProperties::evalTangentStiffness2D(TacsScalar T,
+                                                    TacsScalar C[]) {
+  evalTangentStiffness2D(C);
+  if (temp_table) {
+    TacsScalar props[NUM_TEMP_PROPS];
+    temp_table->evalProperties(T, props);
+    TacsScalar scale = props[PROP_E] / E;
+    for (int i = 0; i < 6; i++) {
+      C[i] *= scale;
+    }
+  }
+}
+
+void TACSMaterialProperties::evalTangentHeatFlux3D(TacsScalar T,
+                                                   TacsScalar Kc[]) {
+  if (temp_table) {
+    TacsScalar props[NUM_TEMP_PROPS];
+    temp_table->evalProperties(T, props);
+    Kc[0] = Kc[3] = Kc[5] = props[PROP_KAPPA];
+    Kc[1] = Kc[2] = Kc[4] = 0.0;
+  } else {
+    evalTangentHeatFlux3D(Kc);
+  }
+}
+
+void TACSMaterialProperties::evalTangentHeatFlux2D(TacsScalar T,
+                                                   TacsScalar Kc[]) {
+  if (temp_table) {
+    TacsScalar props[NUM_TEMP_PROPS];
+    temp_table->evalProperties(T, props);
+    Kc[0] = Kc[2] = props[PROP_KAPPA];
+    Kc[1] = 0.0;
+  } else {
+    evalTangentHeatFlux2D(Kc);
+  }
+}
+
+void TACSMaterialProperties::evalThermalStrain3D(TacsScalar T, TacsScalar e[]) {
+  if (temp_table) {
+    TacsScalar props[NUM_TEMP_PROPS];
+    temp_table->evalProperties(T, props);
+    e[0] = e[1] = e[2] = props[PROP_ALPHA];
+    e[3] = e[4] = e[5] = 0.0;
+  } else {
+    evalThermalStrain3D(e);
+  }
+}
+
+void TACSMaterialProperties::evalThermalStrain2D(TacsScalar T, TacsScalar e[]) {
+  if (temp_table) {
+    TacsScalar props[NUM_TEMP_PROPS];
+    temp_table->evalProperties(T, props);
+    e[0] = e[1] = props[PROP_ALPHA];
+    e[2] = 0.0;
+  } else {
+    evalThermalStrain2D(e);
+  }
+}
+
 void TACSMaterialProperties::evalStress2D(const TacsScalar e[],
                                           TacsScalar s[]) {
   if (mat_type == TACS_ISOTROPIC_MATERIAL) {
@@ -1045,6 +1403,119 @@ TacsScalar TACSOrthotropicPly::failureAngleSens(TacsScalar angle,
   return fail;
 }
 
+/*
+  Precompute the Tsai-Wu failure envelope in laminate coordinates.
+
+  The Tsai-Wu criterion is a linear plus quadratic form of the ply
+  stress, and for a fixed ply angle the ply stress is a fixed linear
+  map of the laminate strain. Folding the strain transformation and
+  the ply stiffness into the failure coefficients gives
+
+  linTerm = g^{T} e   and   quadTerm = e^{T} H e
+
+  directly in laminate strain coordinates, so the criterion can be
+  evaluated at each point as a short dot-product chain without
+  recomputing the angle transforms. The quadratic coefficients are
+  stored as the symmetric matrix
+
+  H = [ H[0], H[1], H[2] ]
+      [ H[1], H[3], H[4] ]
+      [ H[2], H[4], H[5] ]
+
+  returns:
+  1 if the envelope applies (Tsai-Wu criterion), 0 for the
+  maximum-strain criterion, which is not a quadratic form
+
+  input:
+  angle = [radians] the orientation angle of the lamina
+
+  output:
+  g = the 3 linear coefficients in laminate strain coordinates
+  H = the 6 symmetric quadratic coefficients
+*/
+int TACSOrthotropicPly::getFailureEnvelope(TacsScalar angle, TacsScalar g[],
+                                           TacsScalar H[]) {
+  if (!useTsaiWuCriterion) {
+    return 0;
+  }
+
+  // Compute the ply stress produced by each unit laminate strain
+  TacsScalar s[3][3];
+  for (int k = 0; k < 3; k++) {
+    TacsScalar unit[3] = {0.0, 0.0, 0.0};
+    unit[k] = 1.0;
+
+    TacsScalar e[3];
+    transformStrainGlobal2Ply(angle, unit, e);
+    getPlyStress(e, s[k]);
+  }
+
+  // Fold the linear coefficients through the stress map
+  for (int k = 0; k < 3; k++) {
+    g[k] = F1 * s[k][0] + F2 * s[k][1];
+  }
+
+  // Fold the quadratic coefficients: H_{kl} = s_{k}^{T} F s_{l}
+  for (int k = 0, index = 0; k < 3; k++) {
+    for (int l = k; l < 3; l++, index++) {
+      H[index] = (F11 * s[k][0] * s[l][0] + F22 * s[k][1] * s[l][1] +
+                  F12 * (s[k][0] * s[l][1] + s[k][1] * s[l][0]) +
+                  F66 * s[k][2] * s[l][2]);
+    }
+  }
+
+  return 1;
+}
+
+/*
+  Evaluate the failure criterion from the precomputed envelope
+  coefficients returned by getFailureEnvelope()
+*/
+TacsScalar TACSOrthotropicPly::evalFailureEnvelope(const TacsScalar g[],
+                                                   const TacsScalar H[],
+                                                   const TacsScalar e[]) {
+  TacsScalar linTerm = g[0] * e[0] + g[1] * e[1] + g[2] * e[2];
+  TacsScalar quadTerm =
+      (H[0] * e[0] * e[0] + H[3] * e[1] * e[1] + H[5] * e[2] * e[2] +
+       2.0 * (H[1] * e[0] * e[1] + H[2] * e[0] * e[2] + H[4] * e[1] * e[2]));
+
+  if (useModifiedTsaiWu) {
+    return 0.5 * (linTerm + sqrt(linTerm * linTerm + 4.0 * quadTerm));
+  }
+  return linTerm + quadTerm;
+}
+
+/*
+  Evaluate the failure criterion and its derivative w.r.t. the
+  laminate strain from the precomputed envelope coefficients
+*/
+TacsScalar TACSOrthotropicPly::evalFailureEnvelopeStrainSens(
+    const TacsScalar g[], const TacsScalar H[], const TacsScalar e[],
+    TacsScalar sens[]) {
+  TacsScalar linTerm = g[0] * e[0] + g[1] * e[1] + g[2] * e[2];
+
+  // Compute q = H * e
+  TacsScalar q[3];
+  q[0] = H[0] * e[0] + H[1] * e[1] + H[2] * e[2];
+  q[1] = H[1] * e[0] + H[3] * e[1] + H[4] * e[2];
+  q[2] = H[2] * e[0] + H[4] * e[1] + H[5] * e[2];
+
+  TacsScalar quadTerm = e[0] * q[0] + e[1] * q[1] + e[2] * q[2];
+
+  if (useModifiedTsaiWu) {
+    TacsScalar root = sqrt(linTerm * linTerm + 4.0 * quadTerm);
+    for (int k = 0; k < 3; k++) {
+      sens[k] = 0.5 * (g[k] + (linTerm * g[k] + 4.0 * q[k]) / root);
+    }
+    return 0.5 * (linTerm + root);
+  }
+
+  for (int k = 0; k < 3; k++) {
+    sens[k] = g[k] + 2.0 * q[k];
+  }
+  return linTerm + quadTerm;
+}
+
 /*
   Calculate the failure load based on constant and linear components
   of the strain. The components of the strain are in the laminate
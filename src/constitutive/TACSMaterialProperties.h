@@ -28,6 +28,51 @@
 
 enum MaterialType { TACS_ISOTROPIC_MATERIAL, TACS_ANISOTROPIC_MATERIAL };
 
+/**
+   A precompiled interpolation table for temperature-dependent
+   material properties.
+
+   The table is built once at setup: each sampled property curve is
+   resampled onto a uniform temperature grid and converted into cubic
+   Hermite segment coefficients. Evaluation then reduces to a clamped
+   index computation and one cubic polynomial per property - there is
+   no search over the sample points and no branching on the sample
+   spacing - and the batched entry point evaluates all of the
+   quadrature-point temperatures of an element in a single pass.
+
+   Temperatures outside the sampled range are clamped to the end
+   segments of the table.
+*/
+class TACSMaterialPropertyTable : public TACSObject {
+ public:
+  TACSMaterialPropertyTable(int _num_props, int num_points,
+                            const TacsScalar Tpts[], const TacsScalar *values,
+                            int _num_intervals = 128);
+  ~TACSMaterialPropertyTable();
+
+  // Get the number of property curves stored in the table
+  int getNumProperties();
+
+  // Get the temperature range covered by the table
+  void getTemperatureRange(TacsScalar *_Tmin, TacsScalar *_Tmax);
+
+  // Evaluate all of the properties at a single temperature
+  void evalProperties(TacsScalar T, TacsScalar props[]);
+
+  // Evaluate all of the properties at a batch of temperatures
+  void evalPropertiesBatch(int n, const TacsScalar T[], TacsScalar props[]);
+
+  // Evaluate the temperature derivative of all of the properties
+  void evalPropertiesDeriv(TacsScalar T, TacsScalar dprops[]);
+
+ private:
+  int num_props;      // The number of property curves
+  int num_intervals;  // The number of uniform grid intervals
+  double Tmin, dT;    // The uniform temperature grid
+  double inv_dT;      // The reciprocal grid spacing
+  TacsScalar *coef;   // The cubic coefficients: 4 per (interval, property)
+};
+
 /**
    This class stores the mechanical and thermal material properties for
    isotropic and anisotropic materials.
@@ -55,7 +100,23 @@ class TACSMaterialProperties : public TACSObject {
                          TacsScalar _alpha2 = 0.0, TacsScalar _alpha3 = 0.0,
                          TacsScalar _kappa1 = 0.0, TacsScalar _kappa2 = 0.0,
                          TacsScalar _kappa3 = 0.0);
-  ~TACSMaterialProperties() {}
+  ~TACSMaterialProperties();
+
+  // Set the temperature dependence of the isotropic thermal-structural
+  // properties from sampled curves. Any of the curves may be NULL to
+  // keep that property constant.
+  void setTemperatureDependence(int num_points, const TacsScalar Tpts[],
+                                const TacsScalar E_T[],
+                                const TacsScalar alpha_T[],
+                                const TacsScalar kappa_T[],
+                                const TacsScalar cp_T[]);
+  TACSMaterialPropertyTable *getPropertyTable();
+
+  // Evaluate the temperature-dependent properties for a batch of
+  // quadrature-point temperatures in one pass
+  void evalTemperatureProperties(int n, const TacsScalar T[], TacsScalar E_T[],
+                                 TacsScalar alpha_T[], TacsScalar kappa_T[],
+                                 TacsScalar cp_T[]);
 
   // Get the material type
   MaterialType getMaterialType();
@@ -96,6 +157,16 @@ class TACSMaterialProperties : public TACSObject {
   void evalThermalStrain3D(TacsScalar e[]);
   void evalThermalStrain2D(TacsScalar e[]);
 
+  // Temperature-dependent evaluation. These reduce to the constant
+  // property values when no temperature dependence has been set.
+  TacsScalar getSpecificHeat(TacsScalar T);
+  void evalTangentStiffness3D(TacsScalar T, TacsScalar C[]);
+  void evalTangentStiffness2D(TacsScalar T, TacsScalar C[]);
+  void evalTangentHeatFlux3D(TacsScalar T, TacsScalar Kc[]);
+  void evalTangentHeatFlux2D(TacsScalar T, TacsScalar Kc[]);
+  void evalThermalStrain3D(TacsScalar T, TacsScalar e[]);
+  void evalThermalStrain2D(TacsScalar T, TacsScalar e[]);
+
   // Given the strain state, compute the stresses
   void evalStress2D(const TacsScalar e[], TacsScalar s[]);
   void evalStress3D(const TacsScalar e[], TacsScalar s[]);
@@ -113,6 +184,17 @@ class TACSMaterialProperties : public TACSObject {
  private:
   MaterialType mat_type;
 
+  // The rows of the temperature-dependent property table
+  static const int PROP_E = 0;
+  static const int PROP_ALPHA = 1;
+  static const int PROP_KAPPA = 2;
+  static const int PROP_SPECIFIC_HEAT = 3;
+  static const int NUM_TEMP_PROPS = 4;
+
+  // The temperature-dependent property table - NULL for
+  // constant-property materials
+  TACSMaterialPropertyTable *temp_table;
+
   // Density
   TacsScalar rho;
 
@@ -216,6 +298,17 @@ class TACSOrthotropicPly : public TACSObject {
   TacsScalar failureAngleSens(TacsScalar angle, const TacsScalar strain[],
                               TacsScalar *failSens);
 
+  // Precompute the failure envelope in laminate coordinates and
+  // evaluate it without the per-point angle transforms
+  // ------------------------------------------------------------
+  int getFailureEnvelope(TacsScalar angle, TacsScalar g[], TacsScalar H[]);
+  TacsScalar evalFailureEnvelope(const TacsScalar g[], const TacsScalar H[],
+                                 const TacsScalar strain[]);
+  TacsScalar evalFailureEnvelopeStrainSens(const TacsScalar g[],
+                                           const TacsScalar H[],
+                                           const TacsScalar strain[],
+                                           TacsScalar sens[]);
+
   // Calculate the failure load fraction for given
   // constant and linear strain components
   // ---------------------------------------------
@@ -124,6 +124,15 @@ TACSPanelAnalysis::TACSPanelAnalysis(int _nnodes, int _nsegments, int _nbeams,
   // Set the eigenvalue tolerance
   lanczos_eigen_tol = 1e-12;
 
+  // By default, do not cache the solve results between design
+  // variable updates
+  cache_solves = 0;
+  num_cached_solves = 0;
+  for (int k = 0; k < MAX_CACHED_SOLVES; k++) {
+    cachedVals[k] = NULL;
+    cachedNegVals[k] = NULL;
+  }
+
   // The slope of the line x = - beta*y, that defines the rib locations
   beta = 0.0;
   if (theta != 0.0) {
@@ -237,6 +246,8 @@ TACSPanelAnalysis::~TACSPanelAnalysis() {
     delete[] geoLb;
     delete[] geoUb;
   }
+
+  clearSolutionCache();
 }
 
 /*
@@ -253,6 +264,111 @@ void TACSPanelAnalysis::setLanczosSubspaceSize(int subspace_size) {
   lanczos_subspace_size = subspace_size;
 }
 
+/*
+  Set the flag that indicates whether to cache the buckling load and
+  frequency solve results.
+
+  When enabled, the results of each solve are stored keyed on the
+  applied loads and re-used for repeated calls with the same arguments
+  until the design variables are changed through setDesignVars. This
+  avoids repeated eigenvalue solves when the same buckling loads are
+  required by several failure criteria within one design iterate. Note
+  that the cache is only consistent if all design variable updates are
+  made through TACSPanelAnalysis::setDesignVars.
+*/
+void TACSPanelAnalysis::setSolutionCaching(int cache_flag) {
+  cache_solves = cache_flag;
+  if (!cache_solves) {
+    clearSolutionCache();
+  }
+}
+
+/*
+  Free the cached solve results
+*/
+void TACSPanelAnalysis::clearSolutionCache() {
+  for (int k = 0; k < num_cached_solves; k++) {
+    if (cachedVals[k]) {
+      delete[] cachedVals[k];
+      cachedVals[k] = NULL;
+    }
+    if (cachedNegVals[k]) {
+      delete[] cachedNegVals[k];
+      cachedNegVals[k] = NULL;
+    }
+  }
+  num_cached_solves = 0;
+}
+
+/*
+  Try to retrieve a cached solve result.
+
+  The cached result must match the solve type, the applied loads and
+  the number of requested values exactly. Two-sided buckling solves
+  only match cache entries that also stored the negative loads.
+
+  returns 1 and copies the cached values if a match is found,
+  otherwise returns 0
+*/
+int TACSPanelAnalysis::retrieveCachedSolve(int solve_type, TacsScalar Nx,
+                                           TacsScalar Nxy, int nvals,
+                                           TacsScalar vals[],
+                                           TacsScalar negVals[]) {
+  for (int k = 0; k < num_cached_solves; k++) {
+    if (cachedSolveType[k] == solve_type && cachedNumVals[k] == nvals &&
+        cachedNx[k] == Nx && cachedNxy[k] == Nxy &&
+        ((negVals != NULL) == (cachedNegVals[k] != NULL))) {
+      memcpy(vals, cachedVals[k], nvals * sizeof(TacsScalar));
+      if (negVals) {
+        memcpy(negVals, cachedNegVals[k], nvals * sizeof(TacsScalar));
+      }
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*
+  Store a solve result in the cache.
+
+  If the cache is full, the oldest entry is discarded.
+*/
+void TACSPanelAnalysis::cacheSolve(int solve_type, TacsScalar Nx,
+                                   TacsScalar Nxy, int nvals,
+                                   const TacsScalar vals[],
+                                   const TacsScalar negVals[]) {
+  if (num_cached_solves == MAX_CACHED_SOLVES) {
+    // Discard the oldest entry and shift the remaining entries down
+    delete[] cachedVals[0];
+    if (cachedNegVals[0]) {
+      delete[] cachedNegVals[0];
+    }
+    for (int k = 0; k < num_cached_solves - 1; k++) {
+      cachedSolveType[k] = cachedSolveType[k + 1];
+      cachedNumVals[k] = cachedNumVals[k + 1];
+      cachedNx[k] = cachedNx[k + 1];
+      cachedNxy[k] = cachedNxy[k + 1];
+      cachedVals[k] = cachedVals[k + 1];
+      cachedNegVals[k] = cachedNegVals[k + 1];
+    }
+    num_cached_solves--;
+  }
+
+  int k = num_cached_solves;
+  cachedSolveType[k] = solve_type;
+  cachedNumVals[k] = nvals;
+  cachedNx[k] = Nx;
+  cachedNxy[k] = Nxy;
+  cachedVals[k] = new TacsScalar[nvals];
+  memcpy(cachedVals[k], vals, nvals * sizeof(TacsScalar));
+  cachedNegVals[k] = NULL;
+  if (negVals) {
+    cachedNegVals[k] = new TacsScalar[nvals];
+    memcpy(cachedNegVals[k], negVals, nvals * sizeof(TacsScalar));
+  }
+  num_cached_solves++;
+}
+
 /*
   Set the nodal locations.
 
@@ -584,6 +700,10 @@ void TACSPanelAnalysis::setDesignVars(const TacsScalar dvs[], int numDVs) {
   }
 
   updateGeometry();
+
+  // The cached solve results are no longer valid at the new design
+  // point
+  clearSolutionCache();
 }
 
 /*
@@ -1690,6 +1810,15 @@ int TACSPanelAnalysis::computePressureLoad(TacsScalar p,
 int TACSPanelAnalysis::computeBucklingLoads(TacsScalar Nx, TacsScalar Nxy,
                                             TacsScalar loads[], int nloads,
                                             const char *prefix) {
+  // Check whether this solve has already been performed at this design
+  // point. The cache is bypassed when the buckling modes must be
+  // written to a file since the eigenvectors are not stored.
+  if (cache_solves && !prefix) {
+    if (retrieveCachedSolve(BUCKLING_SOLVE, Nx, Nxy, nloads, loads, NULL)) {
+      return 0;
+    }
+  }
+
   // Allocate space for the eigenvalues and eigenvectors
   TacsScalar *eigvals = new TacsScalar[nloads];
   TacsScalar *eigvecs = new TacsScalar[nloads * nvars];
@@ -1724,6 +1853,11 @@ int TACSPanelAnalysis::computeBucklingLoads(TacsScalar Nx, TacsScalar Nxy,
     delete[] file_name;
   }
 
+  // Cache the result for subsequent calls at this design point
+  if (cache_solves && !prefix && info == 0) {
+    cacheSolve(BUCKLING_SOLVE, Nx, Nxy, nloads, loads, NULL);
+  }
+
   // Delete the allocated memory
   delete[] segmentLoads;
   delete[] beamLoads;
@@ -1755,6 +1889,15 @@ int TACSPanelAnalysis::computeBucklingLoads(TacsScalar Nxy,
   // Set the axial load per unit length to zero
   TacsScalar Nx = 0.0;
 
+  // Check whether this solve has already been performed at this
+  // design point
+  if (cache_solves) {
+    if (retrieveCachedSolve(BUCKLING_SOLVE, Nx, Nxy, nloads, posLoads,
+                            negLoads)) {
+      return 0;
+    }
+  }
+
   // Allocate space for the eigenvalues and eigenvectors
   TacsScalar *eigvals = new TacsScalar[2 * nloads];
   TacsScalar *eigvecs = new TacsScalar[2 * nvars * nloads];
@@ -1779,6 +1922,11 @@ int TACSPanelAnalysis::computeBucklingLoads(TacsScalar Nxy,
     }
   }
 
+  // Cache the result for subsequent calls at this design point
+  if (cache_solves && info == 0) {
+    cacheSolve(BUCKLING_SOLVE, Nx, Nxy, nloads, posLoads, negLoads);
+  }
+
   // Free the allocated space
   delete[] segmentLoads;
   delete[] beamLoads;
@@ -2163,6 +2311,15 @@ int TACSPanelAnalysis::computeBucklingLoadsDVSens( TacsScalar Nx,
 */
 int TACSPanelAnalysis::computeFrequencies(TacsScalar freq[], int nfreq,
                                           const char *prefix) {
+  // Check whether this solve has already been performed at this design
+  // point. The cache is bypassed when the modes must be written to a
+  // file since the eigenvectors are not stored.
+  if (cache_solves && !prefix) {
+    if (retrieveCachedSolve(FREQUENCY_SOLVE, 0.0, 0.0, nfreq, freq, NULL)) {
+      return 0;
+    }
+  }
+
   TacsScalar *eigvecs = new TacsScalar[nvars * nfreq];
 
   int info = computeFrequencies(nfreq, freq, eigvecs);
@@ -2171,6 +2328,11 @@ int TACSPanelAnalysis::computeFrequencies(TacsScalar freq[], int nfreq,
     freq[k] = sqrt(freq[k]);
   }
 
+  // Cache the result for subsequent calls at this design point
+  if (cache_solves && !prefix && info == 0) {
+    cacheSolve(FREQUENCY_SOLVE, 0.0, 0.0, nfreq, freq, NULL);
+  }
+
   if (prefix) {
     int file_len = strlen(prefix) + 81;
     char *file_name = new char[file_len];
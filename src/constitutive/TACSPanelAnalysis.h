@@ -135,11 +135,31 @@ class TACSPanelAnalysis : public TACSObject {
   void setUseLapackEigensolver(int use_lapack);
   void setLanczosSubspaceSize(int subspace_size);
 
+  // Set the flag to indicate whether to cache the solve results
+  // between design variable updates
+  // -----------------------------------------------------------
+  void setSolutionCaching(int cache_flag);
+
   // Retrieve the problem size - for load balancing purposes
   // -------------------------------------------------------
   int getProblemSize() { return nvars; }
 
  private:
+  // Cache the results of the buckling/frequency solves. The same
+  // buckling problems are often solved repeatedly while evaluating
+  // failure criteria within a single design iterate, so the solve
+  // results are stored keyed on the applied loads and re-used until
+  // the design variables change.
+  // --------------------------------------------------------------
+  static const int MAX_CACHED_SOLVES = 8;
+  static const int BUCKLING_SOLVE = 0;
+  static const int FREQUENCY_SOLVE = 1;
+  int retrieveCachedSolve(int solve_type, TacsScalar Nx, TacsScalar Nxy,
+                          int nvals, TacsScalar vals[], TacsScalar negVals[]);
+  void cacheSolve(int solve_type, TacsScalar Nx, TacsScalar Nxy, int nvals,
+                  const TacsScalar vals[], const TacsScalar negVals[]);
+  void clearSolutionCache();
+
   // Compute the raw eigenvalues and eigenmodes
   // ------------------------------------------
   int computeEigenvalues(int lm, const char *auplo, const char *buplo, int n,
@@ -391,6 +411,16 @@ class TACSPanelAnalysis : public TACSObject {
   int lanczos_subspace_size;
   double lanczos_eigen_tol;
 
+  // The storage for the cached solve results
+  int cache_solves;       // Flag to indicate whether to cache solves
+  int num_cached_solves;  // The number of solves currently cached
+  int cachedSolveType[MAX_CACHED_SOLVES];
+  int cachedNumVals[MAX_CACHED_SOLVES];
+  TacsScalar cachedNx[MAX_CACHED_SOLVES];
+  TacsScalar cachedNxy[MAX_CACHED_SOLVES];
+  TacsScalar *cachedVals[MAX_CACHED_SOLVES];
+  TacsScalar *cachedNegVals[MAX_CACHED_SOLVES];
+
   // Assign the start and end nodes - these are used
   // to compute the mass per unit area of the panel
   int first_node, last_node;
@@ -89,6 +89,53 @@ TacsScalar TACSPanelGPs::predictMeanTestData(int predInd,
   return savedYtest[predInd];
 }
 
+void TACSPanelGPs::predictMeanTestDataBatch(int npreds, const int predInds[],
+                                            const TacsScalar* Xtests,
+                                            TacsScalar* Ytests) {
+  // group the requested predictions by the GP model that serves them:
+  // the axial GP serves indices 0-1, the shear GP indices 2-3 and the
+  // crippling GP index 4
+  TACSBucklingGaussianProcessModel* gps[3] = {axialGP, shearGP, cripplingGP};
+
+  int* batch_pos = new int[npreds];
+  TacsScalar* Xbatch = new TacsScalar[4 * npreds];
+  TacsScalar* Ybatch = new TacsScalar[npreds];
+
+  for (int igp = 0; igp < 3; igp++) {
+    // gather the predictions for this GP model that aren't saved yet
+    int count = 0;
+    for (int ii = 0; ii < npreds; ii++) {
+      int gp_index = (predInds[ii] < 2 ? 0 : (predInds[ii] < 4 ? 1 : 2));
+      if (gp_index != igp || (saveData && savedForward[predInds[ii]])) {
+        continue;
+      }
+      batch_pos[count] = ii;
+      memcpy(&Xbatch[4 * count], &Xtests[4 * ii], 4 * sizeof(TacsScalar));
+      count++;
+    }
+
+    // evaluate the whole group with one batched kernel-matrix product
+    // and save the results in the shared cache
+    if (count > 0 && gps[igp]) {
+      gps[igp]->predictMeanTestDataBatch(count, Xbatch, Ybatch);
+      for (int k = 0; k < count; k++) {
+        int predInd = predInds[batch_pos[k]];
+        savedYtest[predInd] = Ybatch[k];
+        savedForward[predInd] = saveData;
+      }
+    }
+  }
+
+  // return the predictions from the shared cache
+  for (int ii = 0; ii < npreds; ii++) {
+    Ytests[ii] = savedYtest[predInds[ii]];
+  }
+
+  delete[] batch_pos;
+  delete[] Xbatch;
+  delete[] Ybatch;
+}
+
 void TACSPanelGPs::predictMeanTestDataSens(int predInd, const TacsScalar Ysens,
                                            const TacsScalar* Xtest,
                                            TacsScalar* Xtestsens) {
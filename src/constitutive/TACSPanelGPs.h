@@ -69,6 +69,23 @@ class TACSPanelGPs : public TACSObject {
    */
   TacsScalar predictMeanTestData(int predInd, const TacsScalar* Xtest);
 
+  /**
+   * predict a block of mean test data values in one call.
+   * the requested predictions are grouped by the GP model that serves them
+   * and each group is evaluated with one batched kernel-matrix product,
+   * which is much faster than making the predictions one at a time. any
+   * prediction already saved in the shared cache is returned from the cache,
+   * and newly computed predictions are saved so that the other constitutive
+   * objects in the TACS component reuse them.
+   *
+   * @param npreds the number of requested predictions
+   * @param predInds the prediction indices (see predictMeanTestData)
+   * @param Xtests the test data points, a rank 1-tensor of length 4 * npreds
+   * @param Ytests the Ytest mean predictions of the GPs, length npreds
+   */
+  void predictMeanTestDataBatch(int npreds, const int predInds[],
+                                const TacsScalar* Xtests, TacsScalar* Ytests);
+
   /**
    * derivatives of predictMeanTestData, which also saves and restores the
    * jacobians for faster derivative computations across an entire panel / TACS
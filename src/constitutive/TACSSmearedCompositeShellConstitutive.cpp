@@ -85,6 +85,12 @@ TACSSmearedCompositeShellConstitutive::TACSSmearedCompositeShellConstitutive(
   for (int i = 0; i < nfvals; i++) {
     dfvals[i] = new TacsScalar[NUM_STRESSES];
   }
+
+  // Fold the failure criterion of each ply into laminate coordinates
+  fail_envelope = new int[num_plies];
+  fail_g = new TacsScalar[3 * num_plies];
+  fail_H = new TacsScalar[6 * num_plies];
+  computeFailureEnvelopes();
 }
 
 TACSSmearedCompositeShellConstitutive::
@@ -104,6 +110,24 @@ TACSSmearedCompositeShellConstitutive::
     delete[] dfvals[i];
   }
   delete[] dfvals;
+  delete[] fail_envelope;
+  delete[] fail_g;
+  delete[] fail_H;
+}
+
+/*
+  Precompute the failure envelope of each ply in laminate coordinates.
+
+  The ply angles are fixed for this constitutive object, so the
+  transformed Tsai-Wu coefficients only need to be recomputed when the
+  design variables are set, not at every quadrature point. Plies that
+  use the maximum-strain criterion fall back to the full evaluation.
+*/
+void TACSSmearedCompositeShellConstitutive::computeFailureEnvelopes() {
+  for (int i = 0; i < num_plies; i++) {
+    fail_envelope[i] = ply_props[i]->getFailureEnvelope(
+        ply_angles[i], &fail_g[3 * i], &fail_H[6 * i]);
+  }
 }
 
 int TACSSmearedCompositeShellConstitutive::getDesignVarNums(int elemIndex,
@@ -140,6 +164,10 @@ int TACSSmearedCompositeShellConstitutive::setDesignVars(
       index++;
     }
   }
+
+  // Refresh the precomputed failure envelopes for the new design point
+  computeFailureEnvelopes();
+
   return index;
 }
 
@@ -440,11 +468,24 @@ void TACSSmearedCompositeShellConstitutive::evalPlyTopBottomFailure(
   for (int i = 0; i < num_plies; i++) {
     TacsScalar lamStrain[3] = {0.0};
 
-    getLaminaStrain(strain, tb, lamStrain);
-    fvals[2 * i] = ply_props[i]->failure(ply_angles[i], lamStrain);
+    // Evaluate from the precomputed envelope when the criterion
+    // admits it, avoiding the per-point ply-angle transforms
+    if (fail_envelope[i]) {
+      const TacsScalar *g = &fail_g[3 * i];
+      const TacsScalar *H = &fail_H[6 * i];
 
-    getLaminaStrain(strain, tt, lamStrain);
-    fvals[2 * i + 1] = ply_props[i]->failure(ply_angles[i], lamStrain);
+      getLaminaStrain(strain, tb, lamStrain);
+      fvals[2 * i] = ply_props[i]->evalFailureEnvelope(g, H, lamStrain);
+
+      getLaminaStrain(strain, tt, lamStrain);
+      fvals[2 * i + 1] = ply_props[i]->evalFailureEnvelope(g, H, lamStrain);
+    } else {
+      getLaminaStrain(strain, tb, lamStrain);
+      fvals[2 * i] = ply_props[i]->failure(ply_angles[i], lamStrain);
+
+      getLaminaStrain(strain, tt, lamStrain);
+      fvals[2 * i + 1] = ply_props[i]->failure(ply_angles[i], lamStrain);
+    }
   }
 }
 
@@ -467,8 +508,13 @@ TacsScalar TACSSmearedCompositeShellConstitutive::evalFailureStrainSens(
 
     // plate bottom stress
     getLaminaStrain(strain, tb, lamStrain);
-    TacsScalar fval_bot =
-        ply_props[i]->failureStrainSens(ply_angles[i], lamStrain, phi);
+    if (fail_envelope[i]) {
+      ply_props[i]->evalFailureEnvelopeStrainSens(&fail_g[3 * i],
+                                                  &fail_H[6 * i], lamStrain,
+                                                  phi);
+    } else {
+      ply_props[i]->failureStrainSens(ply_angles[i], lamStrain, phi);
+    }
     dfvals[2 * i + 0][0] = phi[0];
     dfvals[2 * i + 0][1] = phi[1];
     dfvals[2 * i + 0][2] = phi[2];
@@ -479,8 +525,13 @@ TacsScalar TACSSmearedCompositeShellConstitutive::evalFailureStrainSens(
 
     // plate top stress
     getLaminaStrain(strain, tt, lamStrain);
-    TacsScalar fval_top =
-        ply_props[i]->failureStrainSens(ply_angles[i], lamStrain, phi);
+    if (fail_envelope[i]) {
+      ply_props[i]->evalFailureEnvelopeStrainSens(&fail_g[3 * i],
+                                                  &fail_H[6 * i], lamStrain,
+                                                  phi);
+    } else {
+      ply_props[i]->failureStrainSens(ply_angles[i], lamStrain, phi);
+    }
     dfvals[2 * i + 1][0] = phi[0];
     dfvals[2 * i + 1][1] = phi[1];
     dfvals[2 * i + 1][2] = phi[2];
@@ -136,6 +136,15 @@ class TACSSmearedCompositeShellConstitutive : public TACSShellConstitutive {
   TacsScalar **dfvals;
   TacsScalar t_offset;
 
+  // Precompute the failure envelope coefficients for each ply
+  void computeFailureEnvelopes();
+
+  // The failure envelopes folded into laminate coordinates, one per
+  // ply, so that the failure criterion can be evaluated at each point
+  // without recomputing the ply-angle transforms
+  int *fail_envelope;
+  TacsScalar *fail_g, *fail_H;
+
   // The object name
   static const char *constName;
 
@@ -28,11 +28,18 @@ TACSCentrifugalForce3D::TACSCentrifugalForce3D(int _varsPerNode,
   basis->incref();
   memcpy(omegaVec, _omegaVec, 3 * sizeof(TacsScalar));
   memcpy(rotCenter, _rotCenter, 3 * sizeof(TacsScalar));
+
+  // The load depends only on the node locations and the design
+  // variables, so cache the element load vectors by default
+  use_cache = 1;
+  cache = new TACSElementLoadCache(3 * basis->getNumNodes(),
+                                   varsPerNode * basis->getNumNodes());
 }
 
 TACSCentrifugalForce3D::~TACSCentrifugalForce3D() {
   con->decref();
   basis->decref();
+  delete cache;
 }
 
 const char *TACSCentrifugalForce3D::getObjectName() {
@@ -83,9 +90,18 @@ int TACSCentrifugalForce3D::getDesignVarNums(int elemIndex, int dvLen,
 
 int TACSCentrifugalForce3D::setDesignVars(int elemIndex, int dvLen,
                                           const TacsScalar dvs[]) {
+  // The density may change with the design variables
+  cache->invalidate();
   return con->setDesignVars(elemIndex, dvLen, dvs);
 }
 
+void TACSCentrifugalForce3D::setLoadCaching(int flag) {
+  use_cache = flag;
+  if (!use_cache) {
+    cache->invalidate();
+  }
+}
+
 int TACSCentrifugalForce3D::getDesignVars(int elemIndex, int dvLen,
                                           TacsScalar dvs[]) {
   return con->getDesignVars(elemIndex, dvLen, dvs);
@@ -103,6 +119,34 @@ int TACSCentrifugalForce3D::getDesignVarRange(int elemIndex, int dvLen,
 void TACSCentrifugalForce3D::addResidual(
     int elemIndex, double time, const TacsScalar *Xpts, const TacsScalar *vars,
     const TacsScalar *dvars, const TacsScalar *ddvars, TacsScalar *res) {
+  if (use_cache) {
+    // Serve the cached load vector if the node locations still match
+    if (cache->addCached(elemIndex, Xpts, res)) {
+      return;
+    }
+
+    // Compute and cache the load vector for this element
+    const int nvars = varsPerNode * basis->getNumNodes();
+    TacsScalar *load = new TacsScalar[nvars];
+    memset(load, 0, nvars * sizeof(TacsScalar));
+    computeLoad(elemIndex, Xpts, load);
+    cache->insert(elemIndex, Xpts, load);
+
+    for (int i = 0; i < nvars; i++) {
+      res[i] += load[i];
+    }
+    delete[] load;
+    return;
+  }
+
+  computeLoad(elemIndex, Xpts, res);
+}
+
+/*
+  Compute the centrifugal load vector for the element by quadrature
+*/
+void TACSCentrifugalForce3D::computeLoad(int elemIndex, const TacsScalar *Xpts,
+                                         TacsScalar *res) {
   // Compute the number of quadrature points
   const int nquad = basis->getNumQuadraturePoints();
 
@@ -113,9 +157,8 @@ void TACSCentrifugalForce3D::addResidual(
     double weight = basis->getQuadraturePoint(n, pt);
 
     // Get the face normal
-    TacsScalar X[3], Xd[9], J[9], U[3];
+    TacsScalar X[3], Xd[9], J[9];
     basis->interpFields(n, pt, 3, Xpts, 1, X);
-    basis->interpFields(n, pt, 3, vars, 1, U);
     TacsScalar detXd = basis->getJacobianTransform(n, pt, Xpts, Xd, J);
 
     // Multiply the quadrature weight by the quadrature point
@@ -161,54 +204,9 @@ void TACSCentrifugalForce3D::addJacobian(
     TacsScalar gamma, const TacsScalar *Xpts, const TacsScalar *vars,
     const TacsScalar *dvars, const TacsScalar *ddvars, TacsScalar *res,
     TacsScalar *mat) {
-  // Compute the number of quadrature points
-  const int nquad = basis->getNumQuadraturePoints();
-
-  // Loop over each quadrature point and add the residual contribution
-  for (int n = 0; n < nquad; n++) {
-    // Get the quadrature weight
-    double pt[3];
-    double weight = basis->getQuadraturePoint(n, pt);
-
-    // Get the face normal
-    TacsScalar X[3], Xd[9], J[9], U[3];
-    basis->interpFields(n, pt, 3, Xpts, 1, X);
-    basis->interpFields(n, pt, 3, vars, 1, U);
-    TacsScalar detXd = basis->getJacobianTransform(n, pt, Xpts, Xd, J);
-
-    // Multiply the weight by the quadrature point
-    TacsScalar volume = weight * detXd;
-
-    // Evaluate the weak form of the model
-    TacsScalar DUt[3 * TACSElement3D::MAX_VARS_PER_NODE];
-    TacsScalar DUx[3 * TACSElement3D::MAX_VARS_PER_NODE];
-    memset(DUt, 0, 3 * varsPerNode * sizeof(TacsScalar));
-    memset(DUx, 0, 3 * varsPerNode * sizeof(TacsScalar));
-
-    // Get the element density
-    TacsScalar density = con->evalDensity(elemIndex, pt, X);
-
-    TacsScalar r[3], wxr[3], ac[3];
-
-    // Create vector pointing from rotation center to element gpt, including
-    // deformations
-    r[0] = X[0] - rotCenter[0];  // + U[0];
-    r[1] = X[1] - rotCenter[1];  // + U[1];
-    r[2] = X[2] - rotCenter[2];  // + U[2];
-
-    // Compute omega x r
-    crossProduct(omegaVec, r, wxr);
-
-    // Compute centrifugal acceleration
-    crossProduct(omegaVec, wxr, ac);
-
-    for (int k = 0; k < 3; k++) {
-      DUt[3 * k] = density * ac[k];
-    }
-
-    // Add the weak form of the residual at this point
-    if (res) {
-      basis->addWeakResidual(n, pt, volume, J, varsPerNode, DUt, DUx, res);
-    }
+  // The load is independent of the state variables, so there is no
+  // Jacobian contribution - only the residual
+  if (res) {
+    addResidual(elemIndex, time, Xpts, vars, dvars, ddvars, res);
   }
 }
@@ -17,6 +17,7 @@
 
 #include "TACSConstitutive.h"
 #include "TACSElement3D.h"
+#include "TACSElementLoadCache.h"
 
 class TACSCentrifugalForce3D : public TACSElement {
  public:
@@ -59,6 +60,14 @@ class TACSCentrifugalForce3D : public TACSElement {
   int getDesignVarRange(int elemIndex, int dvLen, TacsScalar lb[],
                         TacsScalar ub[]);
 
+  /**
+    Enable or disable caching of the element load vectors. The load
+    depends only on the node locations and the design variables, so
+    with caching enabled (the default) repeated residual evaluations
+    during a steady solve serve the cached integrals.
+  */
+  void setLoadCaching(int flag);
+
   /**
     Add the residual to the provided vector
   */
@@ -75,10 +84,17 @@ class TACSCentrifugalForce3D : public TACSElement {
                    const TacsScalar *ddvars, TacsScalar *res, TacsScalar *mat);
 
  private:
+  // Compute the element load vector by quadrature
+  void computeLoad(int elemIndex, const TacsScalar *Xpts, TacsScalar *load);
+
   int varsPerNode;
   TACSConstitutive *con;
   TACSElementBasis *basis;
   TacsScalar omegaVec[3], rotCenter[3];
+
+  // The cache of element load vectors
+  int use_cache;
+  TACSElementLoadCache *cache;
 };
 
 #endif  // TACS_CENTRIFUGAL_FORCE_3D_H
@@ -196,6 +196,14 @@ class TACSElement : public TACSObject {
   */
   virtual TACSElementModel *getElementModel() { return NULL; }
 
+  /**
+    Get the constitutive object
+
+    @return The TACSConstitutive object associated with this element. Possibly
+    NULL.
+  */
+  virtual TACSConstitutive *getConstitutive() { return NULL; }
+
   /**
     Create element traction class
 
@@ -383,6 +391,17 @@ class TACSElement : public TACSObject {
     memset(fXptSens, 0, 3 * getNumNodes() * sizeof(TacsScalar));
   }
 
+  /**
+    Discard any data the element has cached from the node locations.
+
+    This is called by the assembler whenever the node locations are
+    modified. Element classes that cache data derived from the node
+    locations - such as coordinate transformations or normal
+    directions - should discard that data here. The default
+    implementation does nothing.
+  */
+  virtual void invalidateGeometryCache() {}
+
   /**
     Compute the kinetic and potential energy within the element.
 
@@ -423,6 +442,42 @@ class TACSElement : public TACSObject {
                            const TacsScalar vars[], const TacsScalar dvars[],
                            const TacsScalar ddvars[], TacsScalar res[]) = 0;
 
+  /**
+    Add the contributions from a batch of elements to their residuals.
+
+    All the elements in the batch share this element object, so they
+    have the same number of nodes and variables. The data for the i-th
+    element in the batch is stored contiguously: the node locations at
+    &Xpts[3*getNumNodes()*i] and the variables, time derivatives and
+    residual at &vars[getNumVariables()*i] (and similarly for dvars,
+    ddvars and res).
+
+    The default implementation loops over the batch one element at a
+    time. Element classes can override this to amortize per-call setup
+    and vectorize across the batch.
+
+    @param count The number of elements in the batch
+    @param elemIndex The local element index for each batch entry
+    @param time The simulation time
+    @param Xpts The node locations for each element in the batch
+    @param vars The values of the element degrees of freedom
+    @param dvars The first time derivative of the element DOF
+    @param ddvars The second time derivative of the element DOF
+    @param res The element residuals input/output
+  */
+  virtual void addResidualBatch(int count, const int elemIndex[], double time,
+                                const TacsScalar Xpts[],
+                                const TacsScalar vars[],
+                                const TacsScalar dvars[],
+                                const TacsScalar ddvars[], TacsScalar res[]) {
+    const int nxpts = 3 * getNumNodes();
+    const int nvars = getNumVariables();
+    for (int i = 0; i < count; i++) {
+      addResidual(elemIndex[i], time, &Xpts[nxpts * i], &vars[nvars * i],
+                  &dvars[nvars * i], &ddvars[nvars * i], &res[nvars * i]);
+    }
+  }
+
   /**
     Add the contribution from this element to the residual and Jacobian.
 
@@ -453,6 +508,102 @@ class TACSElement : public TACSObject {
                            const TacsScalar dvars[], const TacsScalar ddvars[],
                            TacsScalar res[], TacsScalar mat[]);
 
+  /**
+    Is the element Jacobian constant with respect to the states?
+
+    Linear elements whose Jacobian does not depend on vars, dvars or
+    ddvars (for fixed coefficients alpha, beta and gamma) can return
+    true here. The incremental assembly path in TACSAssembler then
+    keeps their cached contributions across state updates and only
+    recomputes the state-dependent elements. The default is
+    conservative and recomputes the element every time the states
+    change.
+
+    @return True if the Jacobian is independent of the element states
+  */
+  virtual int isConstantJacobian() { return 0; }
+
+  /**
+    Is the element residual independent of the element states?
+
+    Pure load elements - tractions, pressures and other loads whose
+    residual depends only on the node locations, the design variables
+    and the time - can return true here. The auxiliary element path in
+    TACSAssembler then folds their contributions into a cached load
+    vector that is recomputed only when the nodes, design variables or
+    time change, rather than re-evaluating every load element on every
+    residual assembly.
+
+    @return True if the residual is independent of the element states
+  */
+  virtual int isConstantLoad() { return 0; }
+
+  /**
+    Add the contributions from a batch of elements to their residuals
+    and Jacobians.
+
+    The batch data layout follows addResidualBatch(): all elements
+    share this element object and the data for the i-th element starts
+    at &Xpts[3*getNumNodes()*i], &vars[getNumVariables()*i] and so on.
+    The Jacobian for the i-th element is stored at
+    &mat[getNumVariables()*getNumVariables()*i].
+
+    The default implementation loops over the batch one element at a
+    time. Element classes can override this to amortize per-call setup
+    and vectorize across the batch.
+
+    @param count The number of elements in the batch
+    @param elemIndex The local element index for each batch entry
+    @param time The simulation time
+    @param alpha The coefficient for the DOF Jacobian
+    @param beta The coefficient for the first time derivative DOF Jacobian
+    @param gamma The coefficient for the second time derivative DOF Jacobian
+    @param Xpts The node locations for each element in the batch
+    @param vars The values of the element degrees of freedom
+    @param dvars The first time derivative of the element DOF
+    @param ddvars The second time derivative of the element DOF
+    @param res The element residuals input/output
+    @param mat The element Jacobians input/output
+  */
+  virtual void addJacobianBatch(int count, const int elemIndex[], double time,
+                                TacsScalar alpha, TacsScalar beta,
+                                TacsScalar gamma, const TacsScalar Xpts[],
+                                const TacsScalar vars[],
+                                const TacsScalar dvars[],
+                                const TacsScalar ddvars[], TacsScalar res[],
+                                TacsScalar mat[]) {
+    const int nxpts = 3 * getNumNodes();
+    const int nvars = getNumVariables();
+    for (int i = 0; i < count; i++) {
+      addJacobian(elemIndex[i], time, alpha, beta, gamma, &Xpts[nxpts * i],
+                  &vars[nvars * i], &dvars[nvars * i], &ddvars[nvars * i],
+                  &res[nvars * i], &mat[nvars * nvars * i]);
+    }
+  }
+
+  /**
+    Get the block-sparsity pattern of the element Jacobian.
+
+    The pattern has one entry for each pair of element nodes, stored
+    row-major: pattern[getNumNodes()*i + j] is non-zero when the
+    varsPerNode x varsPerNode sub-block coupling nodes i and j may be
+    non-zero. Elements whose Jacobians contain structurally zero
+    sub-blocks can override this so that the assembler skips those
+    blocks when scattering the element matrix into the global matrix.
+    The pattern must not depend on the values of the variables - only
+    on the element formulation.
+
+    The default implementation leaves the pattern unset and returns
+    zero, which the assembler treats as a dense element matrix.
+
+    @param elemIndex The local element index
+    @param pattern The node-pair pattern, length getNumNodes()^2
+    @return Non-zero if the pattern was set, zero for a dense Jacobian
+  */
+  virtual int getJacobianBlockPattern(int elemIndex, int pattern[]) {
+    return 0;
+  }
+
   /**
     Add the derivative of the adjoint-residual product to the output vector
 
@@ -26,11 +26,19 @@ TACSElement2D::TACSElement2D(TACSElementModel *_model,
   model->incref();
   basis = _basis;
   basis->incref();
+
+  // Build the Gram matrix here so that the threaded assembly never
+  // triggers the lazy computation concurrently
+  massGram = NULL;
+  getMassGramMatrix();
 }
 
 TACSElement2D::~TACSElement2D() {
   model->decref();
   basis->decref();
+  if (massGram) {
+    delete[] massGram;
+  }
 }
 
 // Get the layout properties of the element
@@ -52,6 +60,10 @@ TACSElementBasis *TACSElement2D::getElementBasis() { return basis; }
 
 TACSElementModel *TACSElement2D::getElementModel() { return model; }
 
+TACSConstitutive *TACSElement2D::getConstitutive() {
+  return model->getConstitutive();
+}
+
 TACSElement *TACSElement2D::createElementTraction(int faceIndex,
                                                   const TacsScalar t[]) {
   int varsPerNode = getVarsPerNode();
@@ -319,6 +331,80 @@ void TACSElement2D::getMatType(ElementMatrixType matType, int elemIndex,
   const int *Jac_pairs;
   model->getWeakMatrixNonzeros(matType, elemIndex, &Jac_nnz, &Jac_pairs);
 
+  // The consistent mass matrix of an affine element with uniform
+  // density is a scaled copy of the reference-element Gram matrix of
+  // the basis functions. Check whether the weak matrix contains only
+  // interpolation products with coefficients and a Jacobian
+  // determinant that are constant across the quadrature points, and
+  // skip the quadrature-level accumulation when it does.
+  if (matType == TACS_MASS_MATRIX && nquad > 0) {
+    const int num_params = basis->getNumParameters();
+
+    int affine = 1;
+    for (int ii = 0; ii < Jac_nnz; ii++) {
+      if (Jac_pairs[2 * ii] % (num_params + 3) >= 3 ||
+          Jac_pairs[2 * ii + 1] % (num_params + 3) >= 3) {
+        affine = 0;
+        break;
+      }
+    }
+
+    TacsScalar detXd0 = 0.0;
+    TacsScalar Jac0[25 * MAX_VARS_PER_NODE * MAX_VARS_PER_NODE];
+    for (int n = 0; n < nquad && affine; n++) {
+      double pt[3];
+      basis->getQuadraturePoint(n, pt);
+
+      TacsScalar X[3], Xd[6], J[4];
+      TacsScalar Ut[3 * MAX_VARS_PER_NODE];
+      TacsScalar Ud[2 * MAX_VARS_PER_NODE], Ux[2 * MAX_VARS_PER_NODE];
+      TacsScalar detXd = basis->getFieldGradient(
+          n, pt, Xpts, vars_per_node, vars, NULL, NULL, X, Xd, J, Ut, Ud, Ux);
+
+      TacsScalar DUt[3 * MAX_VARS_PER_NODE], DUx[2 * MAX_VARS_PER_NODE];
+      TacsScalar Jac[25 * MAX_VARS_PER_NODE * MAX_VARS_PER_NODE];
+      model->evalWeakMatrix(matType, elemIndex, time, n, pt, X, Xd, Ut, Ux,
+                            DUt, DUx, Jac);
+
+      if (n == 0) {
+        detXd0 = detXd;
+        memcpy(Jac0, Jac, Jac_nnz * sizeof(TacsScalar));
+      } else if (detXd != detXd0) {
+        affine = 0;
+      } else {
+        for (int ii = 0; ii < Jac_nnz; ii++) {
+          if (Jac[ii] != Jac0[ii]) {
+            affine = 0;
+            break;
+          }
+        }
+      }
+    }
+
+    if (affine) {
+      // Scale the Gram matrix into each non-zero block of the mass
+      // matrix. The quadrature weights are included in the Gram matrix.
+      const double *gram = getMassGramMatrix();
+      const int num_nodes = basis->getNumNodes();
+      for (int ii = 0; ii < Jac_nnz; ii++) {
+        if (Jac0[ii] != 0.0) {
+          int ix = Jac_pairs[2 * ii];
+          int jx = Jac_pairs[2 * ii + 1];
+          TacsScalar scale = detXd0 * Jac0[ii];
+          TacsScalar *M =
+              &mat[nvars * (ix / (num_params + 3)) + (jx / (num_params + 3))];
+          for (int i = 0; i < num_nodes; i++) {
+            for (int j = 0; j < num_nodes; j++) {
+              M[nvars * vars_per_node * i + vars_per_node * j] +=
+                  scale * gram[num_nodes * i + j];
+            }
+          }
+        }
+      }
+      return;
+    }
+  }
+
   // Loop over each quadrature point and add the residual contribution
   for (int n = 0; n < nquad; n++) {
     // Get the quadrature weight
@@ -349,6 +435,41 @@ void TACSElement2D::getMatType(ElementMatrixType matType, int elemIndex,
   }
 }
 
+/*
+  Integrate the products of the basis functions over the reference
+  element. The result is computed once per element object; only the
+  upper triangle is accumulated and then mirrored.
+*/
+const double *TACSElement2D::getMassGramMatrix() {
+  if (!massGram) {
+    const int num_nodes = basis->getNumNodes();
+    const int nquad = basis->getNumQuadraturePoints();
+    massGram = new double[num_nodes * num_nodes];
+    memset(massGram, 0, num_nodes * num_nodes * sizeof(double));
+
+    double *N = new double[num_nodes];
+    for (int n = 0; n < nquad; n++) {
+      double pt[3];
+      double weight = basis->getQuadraturePoint(n, pt);
+      basis->computeBasis(pt, N);
+      for (int i = 0; i < num_nodes; i++) {
+        for (int j = i; j < num_nodes; j++) {
+          massGram[num_nodes * i + j] += weight * N[i] * N[j];
+        }
+      }
+    }
+    delete[] N;
+
+    // Mirror the upper triangle into the lower triangle
+    for (int i = 0; i < num_nodes; i++) {
+      for (int j = 0; j < i; j++) {
+        massGram[num_nodes * i + j] = massGram[num_nodes * j + i];
+      }
+    }
+  }
+  return massGram;
+}
+
 void TACSElement2D::getMatVecDataSizes(ElementMatrixType matType, int elemIndex,
                                        int *_data_size, int *_temp_size) {
   int Jac_nnz;
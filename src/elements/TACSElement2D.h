@@ -34,6 +34,7 @@ class TACSElement2D : public TACSElement {
   ElementType getElementType();
   TACSElementBasis *getElementBasis();
   TACSElementModel *getElementModel();
+  TACSConstitutive *getConstitutive();
   TACSElement *createElementTraction(int faceIndex, const TacsScalar t[]);
   TACSElement *createElementPressure(int faceIndex, TacsScalar p);
   TACSElement *createElementInertialForce(const TacsScalar inertiaVec[]);
@@ -201,8 +202,13 @@ class TACSElement2D : public TACSElement {
                      int ld_data, TacsScalar *data);
 
  private:
+  // Compute the reference-element Gram matrix of the basis functions,
+  // used by the closed-form mass matrix path in getMatType()
+  const double *getMassGramMatrix();
+
   TACSElementModel *model;
   TACSElementBasis *basis;
+  double *massGram;
 };
 
 #endif  // TACS_ELEMENT_2D_H
@@ -27,11 +27,50 @@ TACSElement3D::TACSElement3D(TACSElementModel *_model,
   model->incref();
   basis = _basis;
   basis->incref();
+
+  // Build the Gram matrix here so that the threaded assembly never
+  // triggers the lazy computation concurrently
+  massGram = NULL;
+  getMassGramMatrix();
+
+  // Full integration by default
+  reducedIntegration = 0;
+  hourglassCoef = 0.05;
 }
 
 TACSElement3D::~TACSElement3D() {
   model->decref();
   basis->decref();
+  if (massGram) {
+    delete[] massGram;
+  }
+}
+
+/*
+  Enable single-point reduced integration with hourglass control
+
+  When enabled, addResidual() and addJacobian() evaluate the weak form
+  at the element centroid only, instead of the full Gauss rule of the
+  basis, and add a Flanagan-Belytschko stiffness stabilization of the
+  four hourglass modes that the single-point rule leaves unresisted.
+  The stabilization stiffness is set by the hourglass coefficient
+  times an effective modulus extracted from the gradient-gradient
+  diagonal of the weak form Jacobian, so the control scales with the
+  material without model-specific input.
+
+  The reduced path applies only to the linear hex basis - for any
+  other basis the element silently retains full integration. The
+  adjoint, sensitivity and getMatType() paths also retain full
+  integration, so the mode is intended for transient and preliminary
+  design runs where residual and Jacobian evaluations dominate.
+
+  input:
+  flag:       enable (non-zero) or disable the reduced integration
+  hourglass:  the hourglass stabilization coefficient
+*/
+void TACSElement3D::setReducedIntegration(int flag, double hourglass) {
+  reducedIntegration = flag;
+  hourglassCoef = hourglass;
 }
 
 const char *TACSElement3D::getObjectName() { return "TACSElement3D"; }
@@ -80,6 +119,10 @@ TACSElementBasis *TACSElement3D::getElementBasis() { return basis; }
 
 TACSElementModel *TACSElement3D::getElementModel() { return model; }
 
+TACSConstitutive *TACSElement3D::getConstitutive() {
+  return model->getConstitutive();
+}
+
 int TACSElement3D::getNumQuadraturePoints() {
   return basis->getNumQuadraturePoints();
 }
@@ -135,28 +178,75 @@ int TACSElement3D::getDesignVarRange(int elemIndex, int dvLen, TacsScalar lb[],
 
 /*
   Add the residual to the provided vector
+
+  The solution fields and their gradients are staged at all of the
+  quadrature points up front, and the weak form coefficients are
+  scattered back in a single pass. This allows the tensor-product bases
+  to apply their sum-factorized interpolation kernels, rather than
+  re-evaluating the full basis at each quadrature point.
 */
 void TACSElement3D::addResidual(int elemIndex, double time,
                                 const TacsScalar *Xpts, const TacsScalar *vars,
                                 const TacsScalar *dvars,
                                 const TacsScalar *ddvars, TacsScalar *res) {
+  if (reducedIntegration && basis->getLayoutType() == TACS_HEXA_ELEMENT) {
+    addResidualReduced(elemIndex, time, Xpts, vars, dvars, ddvars, res);
+    return;
+  }
+
   // Compute the number of quadrature points
   const int nquad = basis->getNumQuadraturePoints();
   const int vars_per_node = model->getVarsPerNode();
 
+  // Allocate a workspace that stores the values and the parametric
+  // gradient of each field at every quadrature point
+  const int xsize = 12 * nquad;
+  const int usize = 4 * vars_per_node * nquad;
+  TacsScalar *temp = new TacsScalar[xsize + 4 * usize];
+  TacsScalar *Xtemp = temp;
+  TacsScalar *Utemp = &temp[xsize];
+  TacsScalar *dUtemp = &temp[xsize + usize];
+  TacsScalar *ddUtemp = &temp[xsize + 2 * usize];
+  TacsScalar *DUtemp = &temp[xsize + 3 * usize];
+
+  // Interpolate the node locations and states at all quadrature points
+  basis->interpAllFieldsGrad(3, Xpts, Xtemp);
+  basis->interpAllFieldsGrad(vars_per_node, vars, Utemp);
+  if (dvars && ddvars) {
+    basis->interpAllFieldsGrad(vars_per_node, dvars, dUtemp);
+    basis->interpAllFieldsGrad(vars_per_node, ddvars, ddUtemp);
+  } else {
+    // Zero the time derivatives
+    memset(dUtemp, 0, 2 * usize * sizeof(TacsScalar));
+  }
+
   // Loop over each quadrature point and add the residual contribution
   for (int n = 0; n < nquad; n++) {
     // Get the quadrature weight
     double pt[3];
     double weight = basis->getQuadraturePoint(n, pt);
 
-    // Get the solution field and the solution field gradient and the
-    // Jacobian transformation
-    TacsScalar X[3], Xd[9], J[9];
-    TacsScalar Ut[3 * MAX_VARS_PER_NODE];
-    TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
-    TacsScalar detXd = basis->getFieldGradient(
-        n, pt, Xpts, vars_per_node, vars, dvars, ddvars, X, Xd, J, Ut, Ud, Ux);
+    // Set pointers to the staged values at this quadrature point
+    const TacsScalar *X = &Xtemp[12 * n];
+    const TacsScalar *Xd = &Xtemp[12 * n + 3];
+    const TacsScalar *U = &Utemp[4 * vars_per_node * n];
+    const TacsScalar *Ud = &Utemp[4 * vars_per_node * n + vars_per_node];
+    const TacsScalar *dU = &dUtemp[4 * vars_per_node * n];
+    const TacsScalar *ddU = &ddUtemp[4 * vars_per_node * n];
+
+    // Compute the Jacobian transformation
+    TacsScalar J[9];
+    TacsScalar detXd = inv3x3(Xd, J);
+
+    // Assemble the solution fields and transform the gradient to the
+    // spatial derivatives U,x = U,xi * J
+    TacsScalar Ut[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
+    for (int i = 0; i < vars_per_node; i++) {
+      Ut[3 * i] = U[i];
+      Ut[3 * i + 1] = dU[i];
+      Ut[3 * i + 2] = ddU[i];
+      mat3x3MultTrans(J, &Ud[3 * i], &Ux[3 * i]);
+    }
 
     // Multiply the weight by the quadrature point
     detXd *= weight;
@@ -165,9 +255,25 @@ void TACSElement3D::addResidual(int elemIndex, double time,
     TacsScalar DUt[3 * MAX_VARS_PER_NODE], DUx[3 * MAX_VARS_PER_NODE];
     model->evalWeakIntegrand(elemIndex, n, time, pt, X, Xd, Ut, Ux, DUt, DUx);
 
-    // Add the weak form of the residual at this point
-    basis->addWeakResidual(n, pt, detXd, J, vars_per_node, DUt, DUx, res);
+    // Stage the coefficients of the weak form for the transpose
+    // interpolation back to the residual
+    TacsScalar *DU = &DUtemp[4 * vars_per_node * n];
+    TacsScalar *DUd = &DUtemp[4 * vars_per_node * n + vars_per_node];
+    for (int i = 0; i < vars_per_node; i++) {
+      DU[i] = detXd * (DUt[3 * i] + DUt[3 * i + 1] + DUt[3 * i + 2]);
+
+      TacsScalar dx[3];
+      mat3x3Mult(J, &DUx[3 * i], dx);
+      DUd[3 * i] = detXd * dx[0];
+      DUd[3 * i + 1] = detXd * dx[1];
+      DUd[3 * i + 2] = detXd * dx[2];
+    }
   }
+
+  // Add the weak form coefficients to the residual
+  basis->addInterpAllFieldsGradTranspose(vars_per_node, DUtemp, res);
+
+  delete[] temp;
 }
 
 /*
@@ -179,6 +285,12 @@ void TACSElement3D::addJacobian(int elemIndex, double time, TacsScalar alpha,
                                 const TacsScalar *dvars,
                                 const TacsScalar *ddvars, TacsScalar *res,
                                 TacsScalar *mat) {
+  if (reducedIntegration && basis->getLayoutType() == TACS_HEXA_ELEMENT) {
+    addJacobianReduced(elemIndex, time, alpha, beta, gamma, Xpts, vars, dvars,
+                       ddvars, res, mat);
+    return;
+  }
+
   // Compute the number of quadrature points
   const int nquad = basis->getNumQuadraturePoints();
   const int vars_per_node = model->getVarsPerNode();
@@ -223,6 +335,241 @@ void TACSElement3D::addJacobian(int elemIndex, double time, TacsScalar alpha,
   }
 }
 
+/*
+  Compute the hourglass mode shapes of the linear hex basis
+
+  The four hourglass base vectors are the bilinear and trilinear sign
+  patterns of the tensor-product nodes, orthogonalized against the
+  linear fields following Flanagan and Belytschko so that the
+  stabilization produces no force under rigid body motion or a
+  uniform deformation gradient. The entries are stored as
+  modes[8*m + a] for hourglass mode m and node a.
+*/
+void TACSElement3D::computeHourglassModes(const TacsScalar Xpts[],
+                                          const TacsScalar J[],
+                                          TacsScalar modes[]) {
+  // The sign pattern of tensor-product node a is
+  // (xi, eta, zeta) = (+/-1, +/-1, +/-1) with xi varying fastest
+  TacsScalar B[24];
+  double h[4][8];
+  for (int a = 0; a < 8; a++) {
+    double xi = (a & 1 ? 1.0 : -1.0);
+    double eta = (a & 2 ? 1.0 : -1.0);
+    double zeta = (a & 4 ? 1.0 : -1.0);
+
+    // Compute the spatial gradient of the shape function at the
+    // centroid, B_a = J^{T} dN_a/dxi
+    TacsScalar g[3];
+    g[0] = 0.125 * xi;
+    g[1] = 0.125 * eta;
+    g[2] = 0.125 * zeta;
+    mat3x3MultTrans(J, g, &B[3 * a]);
+
+    // Set the hourglass base vectors
+    h[0][a] = xi * eta;
+    h[1][a] = eta * zeta;
+    h[2][a] = xi * zeta;
+    h[3][a] = xi * eta * zeta;
+  }
+
+  for (int m = 0; m < 4; m++) {
+    // Project the node locations onto the hourglass base vector
+    TacsScalar hx[3];
+    hx[0] = hx[1] = hx[2] = 0.0;
+    for (int a = 0; a < 8; a++) {
+      hx[0] += h[m][a] * Xpts[3 * a];
+      hx[1] += h[m][a] * Xpts[3 * a + 1];
+      hx[2] += h[m][a] * Xpts[3 * a + 2];
+    }
+
+    // Orthogonalize the base vector against the linear fields
+    for (int a = 0; a < 8; a++) {
+      modes[8 * m + a] = h[m][a] - (hx[0] * B[3 * a] + hx[1] * B[3 * a + 1] +
+                                    hx[2] * B[3 * a + 2]);
+    }
+  }
+}
+
+/*
+  Add the residual using single-point reduced integration
+
+  The weak form is evaluated at the element centroid with the full
+  reference volume as the quadrature weight, and the four hourglass
+  modes that the single-point rule leaves unresisted are stabilized
+  with a stiffness proportional to the largest gradient-gradient
+  diagonal coefficient of the weak form Jacobian - the effective
+  modulus of the model - and the element length scale.
+*/
+void TACSElement3D::addResidualReduced(int elemIndex, double time,
+                                       const TacsScalar *Xpts,
+                                       const TacsScalar *vars,
+                                       const TacsScalar *dvars,
+                                       const TacsScalar *ddvars,
+                                       TacsScalar *res) {
+  const int vars_per_node = model->getVarsPerNode();
+
+  // Evaluate the field gradient at the element centroid
+  double pt[3] = {0.0, 0.0, 0.0};
+  const double weight = 8.0;
+
+  TacsScalar X[3], Xd[9], J[9];
+  TacsScalar Ut[3 * MAX_VARS_PER_NODE];
+  TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
+  TacsScalar detXd = basis->getFieldGradient(
+      0, pt, Xpts, vars_per_node, vars, dvars, ddvars, X, Xd, J, Ut, Ud, Ux);
+
+  // Extract the non-zero pattern
+  int Jac_nnz;
+  const int *Jac_pairs;
+  model->getWeakMatrixNonzeros(TACS_JACOBIAN_MATRIX, elemIndex, &Jac_nnz,
+                               &Jac_pairs);
+
+  // Evaluate the weak matrix rather than the integrand alone, so that
+  // the effective modulus for the hourglass stabilization is
+  // available alongside the weak form coefficients
+  TacsScalar DUt[3 * MAX_VARS_PER_NODE], DUx[3 * MAX_VARS_PER_NODE];
+  TacsScalar Jac[36 * MAX_VARS_PER_NODE * MAX_VARS_PER_NODE];
+  model->evalWeakMatrix(TACS_JACOBIAN_MATRIX, elemIndex, 0, time, pt, X, Xd,
+                        Ut, Ux, DUt, DUx, Jac);
+
+  // Add the centroid contribution to the residual
+  basis->addWeakResidual(0, pt, weight * detXd, J, vars_per_node, DUt, DUx,
+                         res);
+
+  // Find the largest gradient-gradient diagonal coefficient of the
+  // weak matrix. The indices are encoded with a stride of
+  // num_params + 3 = 6, with the gradient components last.
+  TacsScalar mu = 0.0;
+  for (int ii = 0; ii < Jac_nnz; ii++) {
+    int ix = Jac_pairs[2 * ii];
+    int jx = Jac_pairs[2 * ii + 1];
+    if (ix == jx && ix % 6 >= 3) {
+      if (TacsRealPart(Jac[ii]) > TacsRealPart(mu)) {
+        mu = Jac[ii];
+      }
+    }
+  }
+
+  // The stabilization stiffness scales with the element length
+  double len = cbrt(fabs(TacsRealPart(weight * detXd)));
+  TacsScalar khg = hourglassCoef * len * mu;
+
+  // Add the hourglass resisting forces
+  TacsScalar modes[32];
+  computeHourglassModes(Xpts, J, modes);
+  for (int m = 0; m < 4; m++) {
+    const TacsScalar *gm = &modes[8 * m];
+    for (int i = 0; i < vars_per_node; i++) {
+      TacsScalar q = 0.0;
+      for (int a = 0; a < 8; a++) {
+        q += gm[a] * vars[vars_per_node * a + i];
+      }
+      q *= khg;
+      for (int a = 0; a < 8; a++) {
+        res[vars_per_node * a + i] += gm[a] * q;
+      }
+    }
+  }
+}
+
+/*
+  Add the residual and Jacobian using single-point reduced integration
+
+  This mirrors addResidualReduced(): the weak form contributions come
+  from the element centroid alone, and the hourglass stabilization
+  enters the Jacobian as a rank-four update scaled by alpha, matching
+  the stiffness-like character of the resisting forces.
+*/
+void TACSElement3D::addJacobianReduced(
+    int elemIndex, double time, TacsScalar alpha, TacsScalar beta,
+    TacsScalar gamma, const TacsScalar *Xpts, const TacsScalar *vars,
+    const TacsScalar *dvars, const TacsScalar *ddvars, TacsScalar *res,
+    TacsScalar *mat) {
+  const int vars_per_node = model->getVarsPerNode();
+  const int num_vars = 8 * vars_per_node;
+
+  // Evaluate the field gradient at the element centroid
+  double pt[3] = {0.0, 0.0, 0.0};
+  const double weight = 8.0;
+
+  TacsScalar X[3], Xd[9], J[9];
+  TacsScalar Ut[3 * MAX_VARS_PER_NODE];
+  TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
+  TacsScalar detXd = basis->getFieldGradient(
+      0, pt, Xpts, vars_per_node, vars, dvars, ddvars, X, Xd, J, Ut, Ud, Ux);
+
+  // Extract the non-zero pattern
+  int Jac_nnz;
+  const int *Jac_pairs;
+  model->getWeakMatrixNonzeros(TACS_JACOBIAN_MATRIX, elemIndex, &Jac_nnz,
+                               &Jac_pairs);
+
+  // Evaluate the weak form of the model at the centroid
+  TacsScalar DUt[3 * MAX_VARS_PER_NODE], DUx[3 * MAX_VARS_PER_NODE];
+  TacsScalar Jac[36 * MAX_VARS_PER_NODE * MAX_VARS_PER_NODE];
+  model->evalWeakMatrix(TACS_JACOBIAN_MATRIX, elemIndex, 0, time, pt, X, Xd,
+                        Ut, Ux, DUt, DUx, Jac);
+
+  // Multiply the weight by the quadrature point
+  TacsScalar wdet = weight * detXd;
+
+  // Add the contributions to the residual
+  if (res) {
+    basis->addWeakResidual(0, pt, wdet, J, vars_per_node, DUt, DUx, res);
+  }
+
+  // Extract the effective modulus before the matrix entries are
+  // scaled by the time-integration coefficients
+  TacsScalar mu = 0.0;
+  for (int ii = 0; ii < Jac_nnz; ii++) {
+    int ix = Jac_pairs[2 * ii];
+    int jx = Jac_pairs[2 * ii + 1];
+    if (ix == jx && ix % 6 >= 3) {
+      if (TacsRealPart(Jac[ii]) > TacsRealPart(mu)) {
+        mu = Jac[ii];
+      }
+    }
+  }
+
+  // Add the weak form of the Jacobian
+  basis->scaleWeakMatrix(wdet, alpha, beta, gamma, Jac_nnz, Jac_pairs, Jac);
+  basis->addWeakMatrix(0, pt, J, vars_per_node, Jac_nnz, Jac_pairs, Jac, mat);
+
+  // The stabilization stiffness scales with the element length
+  double len = cbrt(fabs(TacsRealPart(wdet)));
+  TacsScalar khg = hourglassCoef * len * mu;
+
+  // Add the hourglass stabilization to the residual and the Jacobian
+  TacsScalar modes[32];
+  computeHourglassModes(Xpts, J, modes);
+  for (int m = 0; m < 4; m++) {
+    const TacsScalar *gm = &modes[8 * m];
+
+    if (res) {
+      for (int i = 0; i < vars_per_node; i++) {
+        TacsScalar q = 0.0;
+        for (int a = 0; a < 8; a++) {
+          q += gm[a] * vars[vars_per_node * a + i];
+        }
+        q *= khg;
+        for (int a = 0; a < 8; a++) {
+          res[vars_per_node * a + i] += gm[a] * q;
+        }
+      }
+    }
+
+    for (int a = 0; a < 8; a++) {
+      for (int b = 0; b < 8; b++) {
+        TacsScalar coef = alpha * khg * gm[a] * gm[b];
+        for (int i = 0; i < vars_per_node; i++) {
+          mat[(vars_per_node * a + i) * num_vars + vars_per_node * b + i] +=
+              coef;
+        }
+      }
+    }
+  }
+}
+
 // Functions for the adjoint
 void TACSElement3D::addAdjResProduct(
     int elemIndex, double time, TacsScalar scale, const TacsScalar psi[],
@@ -329,6 +676,80 @@ void TACSElement3D::getMatType(ElementMatrixType matType, int elemIndex,
   const int *Jac_pairs;
   model->getWeakMatrixNonzeros(matType, elemIndex, &Jac_nnz, &Jac_pairs);
 
+  // The consistent mass matrix of an affine element with uniform
+  // density is a scaled copy of the reference-element Gram matrix of
+  // the basis functions. Check whether the weak matrix contains only
+  // interpolation products with coefficients and a Jacobian
+  // determinant that are constant across the quadrature points, and
+  // skip the quadrature-level accumulation when it does.
+  if (matType == TACS_MASS_MATRIX && nquad > 0) {
+    const int num_params = basis->getNumParameters();
+
+    int affine = 1;
+    for (int ii = 0; ii < Jac_nnz; ii++) {
+      if (Jac_pairs[2 * ii] % (num_params + 3) >= 3 ||
+          Jac_pairs[2 * ii + 1] % (num_params + 3) >= 3) {
+        affine = 0;
+        break;
+      }
+    }
+
+    TacsScalar detXd0 = 0.0;
+    TacsScalar Jac0[36 * MAX_VARS_PER_NODE * MAX_VARS_PER_NODE];
+    for (int n = 0; n < nquad && affine; n++) {
+      double pt[3];
+      basis->getQuadraturePoint(n, pt);
+
+      TacsScalar X[3], Xd[9], J[9];
+      TacsScalar Ut[3 * MAX_VARS_PER_NODE];
+      TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
+      TacsScalar detXd = basis->getFieldGradient(
+          n, pt, Xpts, vars_per_node, vars, NULL, NULL, X, Xd, J, Ut, Ud, Ux);
+
+      TacsScalar DUt[3 * MAX_VARS_PER_NODE], DUx[3 * MAX_VARS_PER_NODE];
+      TacsScalar Jac[36 * MAX_VARS_PER_NODE * MAX_VARS_PER_NODE];
+      model->evalWeakMatrix(matType, elemIndex, time, n, pt, X, Xd, Ut, Ux,
+                            DUt, DUx, Jac);
+
+      if (n == 0) {
+        detXd0 = detXd;
+        memcpy(Jac0, Jac, Jac_nnz * sizeof(TacsScalar));
+      } else if (detXd != detXd0) {
+        affine = 0;
+      } else {
+        for (int ii = 0; ii < Jac_nnz; ii++) {
+          if (Jac[ii] != Jac0[ii]) {
+            affine = 0;
+            break;
+          }
+        }
+      }
+    }
+
+    if (affine) {
+      // Scale the Gram matrix into each non-zero block of the mass
+      // matrix. The quadrature weights are included in the Gram matrix.
+      const double *gram = getMassGramMatrix();
+      const int num_nodes = basis->getNumNodes();
+      for (int ii = 0; ii < Jac_nnz; ii++) {
+        if (Jac0[ii] != 0.0) {
+          int ix = Jac_pairs[2 * ii];
+          int jx = Jac_pairs[2 * ii + 1];
+          TacsScalar scale = detXd0 * Jac0[ii];
+          TacsScalar *M =
+              &mat[nvars * (ix / (num_params + 3)) + (jx / (num_params + 3))];
+          for (int i = 0; i < num_nodes; i++) {
+            for (int j = 0; j < num_nodes; j++) {
+              M[nvars * vars_per_node * i + vars_per_node * j] +=
+                  scale * gram[num_nodes * i + j];
+            }
+          }
+        }
+      }
+      return;
+    }
+  }
+
   // Loop over each quadrature point and add the residual contribution
   for (int n = 0; n < nquad; n++) {
     // Get the quadrature weight
@@ -359,6 +780,41 @@ void TACSElement3D::getMatType(ElementMatrixType matType, int elemIndex,
   }
 }
 
+/*
+  Integrate the products of the basis functions over the reference
+  element. The result is computed once per element object; only the
+  upper triangle is accumulated and then mirrored.
+*/
+const double *TACSElement3D::getMassGramMatrix() {
+  if (!massGram) {
+    const int num_nodes = basis->getNumNodes();
+    const int nquad = basis->getNumQuadraturePoints();
+    massGram = new double[num_nodes * num_nodes];
+    memset(massGram, 0, num_nodes * num_nodes * sizeof(double));
+
+    double *N = new double[num_nodes];
+    for (int n = 0; n < nquad; n++) {
+      double pt[3];
+      double weight = basis->getQuadraturePoint(n, pt);
+      basis->computeBasis(pt, N);
+      for (int i = 0; i < num_nodes; i++) {
+        for (int j = i; j < num_nodes; j++) {
+          massGram[num_nodes * i + j] += weight * N[i] * N[j];
+        }
+      }
+    }
+    delete[] N;
+
+    // Mirror the upper triangle into the lower triangle
+    for (int i = 0; i < num_nodes; i++) {
+      for (int j = 0; j < i; j++) {
+        massGram[num_nodes * i + j] = massGram[num_nodes * j + i];
+      }
+    }
+  }
+  return massGram;
+}
+
 void TACSElement3D::getMatVecDataSizes(ElementMatrixType matType, int elemIndex,
                                        int *_data_size, int *_temp_size) {
   int Jac_nnz;
@@ -26,6 +26,11 @@ class TACSElement3D : public TACSElement {
   TACSElement3D(TACSElementModel *_model, TACSElementBasis *_basis);
   ~TACSElement3D();
 
+  /**
+    Enable single-point reduced integration with hourglass control
+  */
+  void setReducedIntegration(int flag, double hourglass = 0.05);
+
   // Get the layout properties of the element
   const char *getObjectName();
   int getVarsPerNode();
@@ -35,6 +40,7 @@ class TACSElement3D : public TACSElement {
   ElementType getElementType();
   TACSElementBasis *getElementBasis();
   TACSElementModel *getElementModel();
+  TACSConstitutive *getConstitutive();
   TACSElement *createElementTraction(int faceIndex, const TacsScalar t[]);
   TACSElement *createElementPressure(int faceIndex, TacsScalar p);
   TACSElement *createElementInertialForce(const TacsScalar inertiaVec[]);
@@ -205,8 +211,30 @@ class TACSElement3D : public TACSElement {
                      int ld_data, TacsScalar *data);
 
  private:
+  // Compute the reference-element Gram matrix of the basis functions,
+  // used by the closed-form mass matrix path in getMatType()
+  const double *getMassGramMatrix();
+
+  // Single-point reduced integration paths with hourglass control,
+  // used when reduced integration is enabled on a linear hex basis
+  void computeHourglassModes(const TacsScalar Xpts[], const TacsScalar J[],
+                             TacsScalar gamma[]);
+  void addResidualReduced(int elemIndex, double time, const TacsScalar *Xpts,
+                          const TacsScalar *vars, const TacsScalar *dvars,
+                          const TacsScalar *ddvars, TacsScalar *res);
+  void addJacobianReduced(int elemIndex, double time, TacsScalar alpha,
+                          TacsScalar beta, TacsScalar gamma,
+                          const TacsScalar *Xpts, const TacsScalar *vars,
+                          const TacsScalar *dvars, const TacsScalar *ddvars,
+                          TacsScalar *res, TacsScalar *mat);
+
   TACSElementModel *model;
   TACSElementBasis *basis;
+  double *massGram;
+
+  // Reduced-integration mode flag and hourglass stiffness coefficient
+  int reducedIntegration;
+  double hourglassCoef;
 };
 
 #endif  // TACS_ELEMENT_3D_H
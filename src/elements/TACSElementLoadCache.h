@@ -0,0 +1,197 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_ELEMENT_LOAD_CACHE_H
+#define TACS_ELEMENT_LOAD_CACHE_H
+
+#include <pthread.h>
+
+#include "TACSObject.h"
+
+/**
+  Cache of element load vectors for body-force elements.
+
+  The inertial and centrifugal force elements integrate a load that
+  depends only on the node locations and the design variables, yet a
+  steady Newton solve re-evaluates that unchanged integral on every
+  residual call. This cache stores the element load vector the first
+  time it is computed and serves it back until it is invalidated.
+
+  An entry is keyed by the element index and validated against a
+  stored copy of the element node locations, so a mesh change refreshes
+  the stale entries automatically. The owning element is responsible
+  for invalidating the whole cache when the design variables change
+  and for bypassing the cache when its load depends on the state
+  variables. The rotation vector and similar fixed element parameters
+  are set at construction, so they never invalidate the cache.
+
+  The entries are kept sorted by element index for binary-search
+  lookup, and a mutex protects the table so the cache can be used from
+  the threaded assembly path.
+*/
+class TACSElementLoadCache {
+ public:
+  /**
+    Create the load cache
+
+    @param _num_xpts The number of node location entries per element
+    @param _num_vars The number of load vector entries per element
+  */
+  TACSElementLoadCache(int _num_xpts, int _num_vars) {
+    num_xpts = _num_xpts;
+    num_vars = _num_vars;
+    num_entries = 0;
+    max_entries = 0;
+    elems = NULL;
+    xpts = NULL;
+    loads = NULL;
+    pthread_mutex_init(&lock, NULL);
+  }
+
+  ~TACSElementLoadCache() {
+    if (elems) {
+      delete[] elems;
+      delete[] xpts;
+      delete[] loads;
+    }
+    pthread_mutex_destroy(&lock);
+  }
+
+  /**
+    Add the cached load for the element into the residual.
+
+    The entry is only used when the stored node locations match the
+    given locations exactly.
+
+    @param elemIndex The element index
+    @param Xpts The element node locations
+    @param res The element residual to add the load into
+    @return 1 when the cached load was added, 0 on a miss
+  */
+  int addCached(int elemIndex, const TacsScalar Xpts[], TacsScalar res[]) {
+    int hit = 0;
+    pthread_mutex_lock(&lock);
+    int index = findEntry(elemIndex);
+    if (index >= 0 && memcmp(&xpts[(size_t)num_xpts * index], Xpts,
+                             num_xpts * sizeof(TacsScalar)) == 0) {
+      const TacsScalar *load = &loads[(size_t)num_vars * index];
+      for (int i = 0; i < num_vars; i++) {
+        res[i] += load[i];
+      }
+      hit = 1;
+    }
+    pthread_mutex_unlock(&lock);
+    return hit;
+  }
+
+  /**
+    Insert or refresh the cached load for the element
+
+    @param elemIndex The element index
+    @param Xpts The element node locations the load was computed at
+    @param load The element load vector
+  */
+  void insert(int elemIndex, const TacsScalar Xpts[], const TacsScalar load[]) {
+    pthread_mutex_lock(&lock);
+    int index = findEntry(elemIndex);
+    if (index < 0) {
+      // Extend the table if it is full
+      if (num_entries >= max_entries) {
+        int new_max = (max_entries > 0 ? 2 * max_entries : 256);
+        int *new_elems = new int[new_max];
+        TacsScalar *new_xpts = new TacsScalar[(size_t)num_xpts * new_max];
+        TacsScalar *new_loads = new TacsScalar[(size_t)num_vars * new_max];
+        if (elems) {
+          memcpy(new_elems, elems, num_entries * sizeof(int));
+          memcpy(new_xpts, xpts,
+                 (size_t)num_xpts * num_entries * sizeof(TacsScalar));
+          memcpy(new_loads, loads,
+                 (size_t)num_vars * num_entries * sizeof(TacsScalar));
+          delete[] elems;
+          delete[] xpts;
+          delete[] loads;
+        }
+        max_entries = new_max;
+        elems = new_elems;
+        xpts = new_xpts;
+        loads = new_loads;
+      }
+
+      // Find the sorted position of the new entry. The elements are
+      // usually visited in increasing order so this is normally an
+      // append.
+      index = num_entries;
+      while (index > 0 && elems[index - 1] > elemIndex) {
+        index--;
+      }
+      if (index < num_entries) {
+        memmove(&elems[index + 1], &elems[index],
+                (num_entries - index) * sizeof(int));
+        memmove(&xpts[(size_t)num_xpts * (index + 1)],
+                &xpts[(size_t)num_xpts * index],
+                (size_t)num_xpts * (num_entries - index) * sizeof(TacsScalar));
+        memmove(&loads[(size_t)num_vars * (index + 1)],
+                &loads[(size_t)num_vars * index],
+                (size_t)num_vars * (num_entries - index) * sizeof(TacsScalar));
+      }
+      elems[index] = elemIndex;
+      num_entries++;
+    }
+
+    memcpy(&xpts[(size_t)num_xpts * index], Xpts,
+           num_xpts * sizeof(TacsScalar));
+    memcpy(&loads[(size_t)num_vars * index], load,
+           num_vars * sizeof(TacsScalar));
+    pthread_mutex_unlock(&lock);
+  }
+
+  /**
+    Invalidate every cached entry, e.g. when the design variables
+    change
+  */
+  void invalidate() {
+    pthread_mutex_lock(&lock);
+    num_entries = 0;
+    pthread_mutex_unlock(&lock);
+  }
+
+ private:
+  // Binary search for the element index; returns -1 on a miss
+  int findEntry(int elemIndex) {
+    int low = 0, high = num_entries - 1;
+    while (low <= high) {
+      int mid = (low + high) / 2;
+      if (elems[mid] == elemIndex) {
+        return mid;
+      } else if (elems[mid] < elemIndex) {
+        low = mid + 1;
+      } else {
+        high = mid - 1;
+      }
+    }
+    return -1;
+  }
+
+  // The per-entry sizes
+  int num_xpts, num_vars;
+
+  // The table of cached entries, sorted by element index
+  int num_entries, max_entries;
+  int *elems;
+  TacsScalar *xpts;
+  TacsScalar *loads;
+
+  // Protects the table on the threaded assembly path
+  pthread_mutex_t lock;
+};
+
+#endif  // TACS_ELEMENT_LOAD_CACHE_H
@@ -17,8 +17,31 @@
 #include <string.h>
 
 #include "TACSElementAlgebra.h"
+#include "TACSThreadPool.h"
 #include "tacslapack.h"
 
+// The number of threads used for the finite-difference sweeps and the
+// persistent pool of workers shared by the verification tests
+static int test_num_threads = 1;
+static TACSThreadPool *test_pool = NULL;
+
+/*
+  Set the number of threads used for the finite-difference sweeps
+*/
+void TacsSetNumTestThreads(int num_threads) {
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  if (num_threads > TACSThreadInfo::TACS_MAX_NUM_THREADS) {
+    num_threads = TACSThreadInfo::TACS_MAX_NUM_THREADS;
+  }
+  if (test_pool && num_threads != test_num_threads) {
+    test_pool->decref();
+    test_pool = NULL;
+  }
+  test_num_threads = num_threads;
+}
+
 /*
   Helper function to get the matrix type name from the ElementMatrixType enum
 */
@@ -63,6 +86,13 @@ void TacsGenerateRandomArray(TacsComplex *array, int size, TacsComplex lower,
   }
 }
 
+void TacsGenerateRandomArray(TacsDual *array, int size, TacsDual lower,
+                             TacsDual upper) {
+  for (int i = 0; i < size; i++) {
+    array[i] = (upper - lower) * (rand() / ((double)RAND_MAX + 1)) + lower;
+  }
+}
+
 /*
   Find the largest absolute value of the difference between an array of test
   values and an array of reference values
@@ -190,6 +220,123 @@ void TacsFormDiffApproximate(TacsScalar *forward, const TacsScalar *backward,
 #endif  // TACS_USE_COMPLEX
 }
 
+/*
+  Evaluate the finite-difference (or complex-step) derivative of the
+  Lagrangian L = T - P with respect to the entry p[i], where p aliases
+  either the q or dq array
+*/
+static TacsScalar TacsTestEnergyDeriv(TACSElement *element, int elemIndex,
+                                      double time, const TacsScalar Xpts[],
+                                      TacsScalar *q, TacsScalar *dq,
+                                      TacsScalar *p, int i, double dh) {
+  TacsScalar deriv;
+  TacsScalar T1, P1;
+  TacsScalar tmp = p[i];
+#ifdef TACS_USE_COMPLEX
+  p[i] = tmp + TacsScalar(0.0, dh);
+  element->computeEnergies(elemIndex, time, Xpts, q, dq, &T1, &P1);
+  deriv = TacsImagPart((T1 - P1)) / dh;
+#else
+  TacsScalar T2, P2;
+  p[i] = tmp + dh;
+  element->computeEnergies(elemIndex, time, Xpts, q, dq, &T1, &P1);
+
+  p[i] = tmp - dh;
+  element->computeEnergies(elemIndex, time, Xpts, q, dq, &T2, &P2);
+  deriv = 0.5 * ((T1 - P1) - (T2 - P2)) / dh;
+#endif
+  p[i] = tmp;
+
+  return deriv;
+}
+
+/*
+  The information required for one threaded finite-difference sweep
+*/
+typedef struct {
+  TACSElement *element;
+  int elemIndex;
+  double time;
+  const TacsScalar *Xpts;
+  const TacsScalar *q, *dq;  // The base states for the sweep
+  int nvars;
+  int perturb_q;    // Perturb the entries of q (1) or dq (0)
+  double dh;
+  TacsScalar *out;  // The derivative approximations
+} TacsTestSweepInfo;
+
+/*
+  The work function for the threaded finite-difference sweep. Each
+  worker copies the base states into its own scratch arrays so that
+  the per-component perturbations are independent, then claims ranges
+  of components from the pool schedule.
+*/
+static void *TacsTestSweepWork(void *info_ptr) {
+  TacsTestSweepInfo *info = static_cast<TacsTestSweepInfo *>(info_ptr);
+  const int nvars = info->nvars;
+
+  // Allocate the per-thread copies of the states
+  TacsScalar *q = new TacsScalar[nvars];
+  TacsScalar *dq = new TacsScalar[nvars];
+  memcpy(q, info->q, nvars * sizeof(TacsScalar));
+  memcpy(dq, info->dq, nvars * sizeof(TacsScalar));
+  TacsScalar *p = (info->perturb_q ? q : dq);
+
+  int thread = test_pool->acquireThread();
+  int begin, end;
+  while (test_pool->getNextRange(thread, &begin, &end)) {
+    for (int i = begin; i < end; i++) {
+      info->out[i] = TacsTestEnergyDeriv(info->element, info->elemIndex,
+                                         info->time, info->Xpts, q, dq, p, i,
+                                         info->dh);
+    }
+  }
+
+  delete[] q;
+  delete[] dq;
+
+  return NULL;
+}
+
+/*
+  Sweep the finite-difference derivative of the Lagrangian over all
+  components of either q or dq. When multiple test threads are
+  configured, the components are distributed across the worker pool
+  with per-thread copies of the element states.
+*/
+static void TacsTestEnergySweep(TACSElement *element, int elemIndex,
+                                double time, const TacsScalar Xpts[],
+                                TacsScalar *q, TacsScalar *dq, int perturb_q,
+                                double dh, TacsScalar *out, int nvars) {
+  if (test_num_threads > 1) {
+    if (!test_pool) {
+      test_pool = new TACSThreadPool(test_num_threads);
+      test_pool->incref();
+    }
+
+    TacsTestSweepInfo info;
+    info.element = element;
+    info.elemIndex = elemIndex;
+    info.time = time;
+    info.Xpts = Xpts;
+    info.q = q;
+    info.dq = dq;
+    info.nvars = nvars;
+    info.perturb_q = perturb_q;
+    info.dh = dh;
+    info.out = out;
+
+    test_pool->initSchedule(nvars);
+    test_pool->run(TacsTestSweepWork, &info);
+  } else {
+    TacsScalar *p = (perturb_q ? q : dq);
+    for (int i = 0; i < nvars; i++) {
+      out[i] = TacsTestEnergyDeriv(element, elemIndex, time, Xpts, q, dq, p, i,
+                                   dh);
+    }
+  }
+}
+
 /*
   The following function tests the consistency of the implementation
   of the residuals and the energy expressions, relying on Lagrange's
@@ -231,6 +378,10 @@ int TacsTestElementResidual(TACSElement *element, int elemIndex, double time,
   TacsScalar *res2 = new TacsScalar[nvars];
   TacsScalar *fd = new TacsScalar[nvars];
 
+  // Time the finite-difference sweeps so that the test doubles as a
+  // per-element performance check
+  double t_sweep = MPI_Wtime();
+
   // Compute the values of the variables at (t + dt)
   for (int i = 0; i < nvars; i++) {
     q[i] = vars[i] + dh * dvars[i];
@@ -238,24 +389,8 @@ int TacsTestElementResidual(TACSElement *element, int elemIndex, double time,
   }
 
   // Evaluate the derivative w.r.t. dot{q}
-  for (int i = 0; i < nvars; i++) {
-    // Evaluate the finite-difference for component i
-    TacsScalar T1, P1, T2, P2;
-    TacsScalar dqtmp = dq[i];
-#ifdef TACS_USE_COMPLEX
-    dq[i] = dqtmp + TacsScalar(0.0, dh);
-    element->computeEnergies(elemIndex, time, Xpts, q, dq, &T1, &P1);
-    res1[i] = TacsImagPart((T1 - P1)) / dh;
-#else
-    dq[i] = dqtmp + dh;
-    element->computeEnergies(elemIndex, time, Xpts, q, dq, &T1, &P1);
-
-    dq[i] = dqtmp - dh;
-    element->computeEnergies(elemIndex, time, Xpts, q, dq, &T2, &P2);
-    res1[i] = 0.5 * ((T1 - P1) - (T2 - P2)) / dh;
-#endif
-    dq[i] = dqtmp;
-  }
+  TacsTestEnergySweep(element, elemIndex, time, Xpts, q, dq, 0, dh, res1,
+                      nvars);
 
   // Compute the values of the variables at (t - dt)
   for (int i = 0; i < nvars; i++) {
@@ -264,26 +399,8 @@ int TacsTestElementResidual(TACSElement *element, int elemIndex, double time,
   }
 
   // Evaluate the derivative w.r.t. dot{q}
-  for (int i = 0; i < nvars; i++) {
-    // Evaluate the finite-difference for component i
-    TacsScalar T1, P1, T2, P2;
-    TacsScalar dqtmp = dq[i];
-#ifdef TACS_USE_COMPLEX
-    dq[i] = dqtmp + TacsScalar(0.0, dh);
-    element->computeEnergies(elemIndex, time, Xpts, q, dq, &T1, &P1);
-    res2[i] = TacsImagPart((T1 - P1)) / dh;
-#else
-    dq[i] = dqtmp + dh;
-    element->computeEnergies(elemIndex, time, Xpts, q, dq, &T1, &P1);
-
-    dq[i] = dqtmp - dh;
-    element->computeEnergies(elemIndex, time, Xpts, q, dq, &T2, &P2);
-
-    // Compute and store the approximation
-    res2[i] = 0.5 * ((T1 - P1) - (T2 - P2)) / dh;
-#endif
-    dq[i] = dqtmp;
-  }
+  TacsTestEnergySweep(element, elemIndex, time, Xpts, q, dq, 0, dh, res2,
+                      nvars);
 
   // Evaluate the finite-difference for the first term in Largrange's
   // equations of motion
@@ -298,33 +415,16 @@ int TacsTestElementResidual(TACSElement *element, int elemIndex, double time,
   }
 
   // Compute the contribution from dL/dq^{T}
-  for (int i = 0; i < nvars; i++) {
-    // Evaluate the finite-difference for component i
-    TacsScalar T1, P1, T2, P2;
-    TacsScalar qtmp = q[i];
-
-#ifdef TACS_USE_COMPLEX
-    q[i] = qtmp + TacsScalar(0.0, dh);
-    element->computeEnergies(elemIndex, time, Xpts, q, dq, &T1, &P1);
-    res1[i] = TacsImagPart((T1 - P1)) / dh;
-#else
-    q[i] = qtmp + dh;
-    element->computeEnergies(elemIndex, time, Xpts, q, dq, &T1, &P1);
-
-    q[i] = qtmp - dh;
-    element->computeEnergies(elemIndex, time, Xpts, q, dq, &T2, &P2);
-
-    // Compute and store the approximation
-    res1[i] = 0.5 * ((T1 - P1) - (T2 - P2)) / dh;
-#endif
-    q[i] = qtmp;
-  }
+  TacsTestEnergySweep(element, elemIndex, time, Xpts, q, dq, 1, dh, res1,
+                      nvars);
 
   // Add the result to the finite-difference result
   for (int i = 0; i < nvars; i++) {
     fd[i] -= res1[i];
   }
 
+  t_sweep = MPI_Wtime() - t_sweep;
+
   // Evaluate the residual using the code
   memset(res1, 0, nvars * sizeof(TacsScalar));
   element->addResidual(elemIndex, time, Xpts, vars, dvars, ddvars, res1);
@@ -341,6 +441,8 @@ int TacsTestElementResidual(TACSElement *element, int elemIndex, double time,
             max_err_index);
     fprintf(stderr, "Max REr: %10.4e in component %d.\n", max_rel,
             max_rel_index);
+    fprintf(stderr, "FD sweep time: %10.4e s for %d variables on %d threads\n",
+            t_sweep, nvars, test_num_threads);
   }
 
   // Print the error if required
@@ -405,15 +507,21 @@ int TacsTestElementJacobian(TACSElement *element, int elemIndex, double time,
   double beta = (1.0 * rand()) / RAND_MAX;
   double gamma = (1.0 * rand()) / RAND_MAX;
 
+  // Time the Jacobian and residual evaluations so that the test
+  // doubles as a per-element performance check
+  double t_jac = MPI_Wtime();
   memset(mat, 0, nvars * nvars * sizeof(TacsScalar));
   element->addJacobian(elemIndex, time, alpha, beta, gamma, Xpts, vars, dvars,
                        ddvars, res, mat);
+  t_jac = MPI_Wtime() - t_jac;
 
   // Evaluate the Jacobian
   int one = 1;
   TacsScalar a = 1.0, b = 0.0;
   BLASgemv("T", &nvars, &nvars, &a, mat, &nvars, pert, &one, &b, result, &one);
 
+  double t_res = MPI_Wtime();
+
   // Perturb the variables in the forward sense
   TacsForwardDiffPerturb(q, nvars, vars, pert, alpha * dh);
   TacsForwardDiffPerturb(dq, nvars, dvars, pert, beta * dh);
@@ -428,6 +536,9 @@ int TacsTestElementJacobian(TACSElement *element, int elemIndex, double time,
   memset(temp, 0, nvars * sizeof(TacsScalar));
   element->addResidual(elemIndex, time, Xpts, q, dq, ddq, temp);
 
+  // Average over the two residual calls
+  t_res = 0.5 * (MPI_Wtime() - t_res);
+
   // Form the FD/CS approximate
   TacsFormDiffApproximate(res, temp, nvars, dh);
 
@@ -449,6 +560,8 @@ int TacsTestElementJacobian(TACSElement *element, int elemIndex, double time,
             max_err_index);
     fprintf(stderr, "Max REr: %10.4e in component %d.\n", max_rel,
             max_rel_index);
+    fprintf(stderr, "addJacobian time: %10.4e s addResidual time: %10.4e s\n",
+            t_jac, t_res);
   }
   // Print the error if required
   if (test_print_level > 1) {
@@ -1186,7 +1299,7 @@ int TacsTestElementBasisFunctions(TACSElementBasis *basis, double dh,
     }
   }
 
-#ifndef TACS_USE_COMPLEX
+#if !defined(TACS_USE_COMPLEX) && !defined(TACS_USE_DUAL)
   // Compute the error
   int max_err_index, max_rel_index;
   double max_err =
@@ -1212,7 +1325,7 @@ int TacsTestElementBasisFunctions(TACSElementBasis *basis, double dh,
 
   fail = !TacsAssertAllClose(result, fd, nparams * nnodes, test_fail_atol,
                              test_fail_rtol);
-#endif  // not TACS_USE_COMPLEX
+#endif  // not TACS_USE_COMPLEX and not TACS_USE_DUAL
 
   delete[] result;
   delete[] fd;
@@ -24,10 +24,21 @@
   testing various things.
  */
 void TacsSeedRandomGenerator(int seed);
+
+/**
+  Set the number of threads used for the finite-difference sweeps in
+  the element verification tests. The element must be safe to call
+  concurrently with separate state arrays, which matches the
+  requirement already imposed by the threaded assembly paths. The
+  default is a single thread.
+ */
+void TacsSetNumTestThreads(int num_threads);
 void TacsGenerateRandomArray(TacsReal *array, int size, TacsReal lower = -1.0,
                              TacsReal upper = 1.0);
 void TacsGenerateRandomArray(TacsComplex *array, int size,
                              TacsComplex lower = -1.0, TacsComplex upper = 1.0);
+void TacsGenerateRandomArray(TacsDual *array, int size, TacsDual lower = -1.0,
+                             TacsDual upper = 1.0);
 
 /*
   Find the largest absolute value of the difference between an array of test
@@ -26,11 +26,18 @@ TACSInertialForce3D::TACSInertialForce3D(int _varsPerNode,
   basis = _basis;
   basis->incref();
   memcpy(inertiaVec, _inertiaVec, 3 * sizeof(TacsScalar));
+
+  // The load depends only on the node locations and the design
+  // variables, so cache the element load vectors by default
+  use_cache = 1;
+  cache = new TACSElementLoadCache(3 * basis->getNumNodes(),
+                                   varsPerNode * basis->getNumNodes());
 }
 
 TACSInertialForce3D::~TACSInertialForce3D() {
   con->decref();
   basis->decref();
+  delete cache;
 }
 
 const char *TACSInertialForce3D::getObjectName() {
@@ -80,9 +87,18 @@ int TACSInertialForce3D::getDesignVarNums(int elemIndex, int dvLen,
 
 int TACSInertialForce3D::setDesignVars(int elemIndex, int dvLen,
                                        const TacsScalar dvs[]) {
+  // The density may change with the design variables
+  cache->invalidate();
   return con->setDesignVars(elemIndex, dvLen, dvs);
 }
 
+void TACSInertialForce3D::setLoadCaching(int flag) {
+  use_cache = flag;
+  if (!use_cache) {
+    cache->invalidate();
+  }
+}
+
 int TACSInertialForce3D::getDesignVars(int elemIndex, int dvLen,
                                        TacsScalar dvs[]) {
   return con->getDesignVars(elemIndex, dvLen, dvs);
@@ -99,6 +115,34 @@ int TACSInertialForce3D::getDesignVarRange(int elemIndex, int dvLen,
 void TACSInertialForce3D::addResidual(
     int elemIndex, double time, const TacsScalar *Xpts, const TacsScalar *vars,
     const TacsScalar *dvars, const TacsScalar *ddvars, TacsScalar *res) {
+  if (use_cache) {
+    // Serve the cached load vector if the node locations still match
+    if (cache->addCached(elemIndex, Xpts, res)) {
+      return;
+    }
+
+    // Compute and cache the load vector for this element
+    const int nvars = varsPerNode * basis->getNumNodes();
+    TacsScalar *load = new TacsScalar[nvars];
+    memset(load, 0, nvars * sizeof(TacsScalar));
+    computeLoad(elemIndex, Xpts, load);
+    cache->insert(elemIndex, Xpts, load);
+
+    for (int i = 0; i < nvars; i++) {
+      res[i] += load[i];
+    }
+    delete[] load;
+    return;
+  }
+
+  computeLoad(elemIndex, Xpts, res);
+}
+
+/*
+  Compute the inertial load vector for the element by quadrature
+*/
+void TACSInertialForce3D::computeLoad(int elemIndex, const TacsScalar *Xpts,
+                                      TacsScalar *res) {
   // Compute the number of quadrature points
   const int nquad = basis->getNumQuadraturePoints();
 
@@ -144,39 +188,9 @@ void TACSInertialForce3D::addJacobian(int elemIndex, double time,
                                       const TacsScalar *dvars,
                                       const TacsScalar *ddvars, TacsScalar *res,
                                       TacsScalar *mat) {
-  // Compute the number of quadrature points
-  const int nquad = basis->getNumQuadraturePoints();
-
-  // Loop over each quadrature point and add the residual contribution
-  for (int n = 0; n < nquad; n++) {
-    // Get the quadrature weight
-    double pt[3];
-    double weight = basis->getQuadraturePoint(n, pt);
-
-    // Get the face normal
-    TacsScalar X[3], Xd[9], J[9];
-    basis->interpFields(n, pt, 3, Xpts, 1, X);
-    TacsScalar detXd = basis->getJacobianTransform(n, pt, Xpts, Xd, J);
-
-    // Multiply the weight by the quadrature point
-    TacsScalar volume = weight * detXd;
-
-    // Evaluate the weak form of the model
-    TacsScalar DUt[3 * TACSElement3D::MAX_VARS_PER_NODE];
-    TacsScalar DUx[3 * TACSElement3D::MAX_VARS_PER_NODE];
-    memset(DUt, 0, 3 * varsPerNode * sizeof(TacsScalar));
-    memset(DUx, 0, 3 * varsPerNode * sizeof(TacsScalar));
-
-    // Get the element density
-    TacsScalar density = con->evalDensity(elemIndex, pt, X);
-
-    for (int k = 0; k < 3; k++) {
-      DUt[3 * k] = -density * inertiaVec[k];
-    }
-
-    // Add the weak form of the residual at this point
-    if (res) {
-      basis->addWeakResidual(n, pt, volume, J, varsPerNode, DUt, DUx, res);
-    }
+  // The load is independent of the state variables, so there is no
+  // Jacobian contribution - only the residual
+  if (res) {
+    addResidual(elemIndex, time, Xpts, vars, dvars, ddvars, res);
   }
 }
@@ -95,6 +95,14 @@ void TACSInterpAllTensor3DInterp5VarsPerNode3(const double N[],
                                               const double Nx[],
                                               const TacsScalar values[],
                                               TacsScalar out[]) {
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+  // Use the SIMD kernels when the processor supports them
+  if (TacsGetTensorSimdLevel() >= 1) {
+    TACSInterpAllTensor3DInterp5VarsPerNode3Avx2(N, Nx, values, out);
+    return;
+  }
+#endif  // TACS_TENSOR_PRODUCT_SIMD
+
   memset(out, 0, 4 * 3 * 125 * sizeof(TacsScalar));
 
   for (int n = 0; n < 125; n++) {
@@ -148,6 +156,17 @@ void TACSInterpAllTensor3DInterp5VarsPerNode4(const double N[],
                                               const double Nx[],
                                               const TacsScalar values[],
                                               TacsScalar out[]) {
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+  // Use the SIMD kernels when the processor supports them
+  if (TacsGetTensorSimdLevel() >= 2) {
+    TACSInterpAllTensor3DInterp5VarsPerNode4Avx512(N, Nx, values, out);
+    return;
+  } else if (TacsGetTensorSimdLevel() == 1) {
+    TACSInterpAllTensor3DInterp5VarsPerNode4Avx2(N, Nx, values, out);
+    return;
+  }
+#endif  // TACS_TENSOR_PRODUCT_SIMD
+
   memset(out, 0, 4 * 4 * 125 * sizeof(TacsScalar));
 
   for (int n = 0; n < 125; n++) {
@@ -283,6 +302,14 @@ void TacsAddAllTransTensor3DInterp5VarsPerNode3(const double N[],
                                                 const double Nx[],
                                                 const TacsScalar in[],
                                                 TacsScalar values[]) {
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+  // Use the SIMD kernels when the processor supports them
+  if (TacsGetTensorSimdLevel() >= 1) {
+    TacsAddAllTransTensor3DInterp5VarsPerNode3Avx2(N, Nx, in, values);
+    return;
+  }
+#endif  // TACS_TENSOR_PRODUCT_SIMD
+
   for (int n = 0; n < 125; n++) {
     const double *n1 = &N[5 * (n % 5)];
     const double *n2 = &N[5 * ((n % 25) / 5)];
@@ -338,6 +365,17 @@ void TacsAddAllTransTensor3DInterp5VarsPerNode4(const double N[],
                                                 const double Nx[],
                                                 const TacsScalar in[],
                                                 TacsScalar values[]) {
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+  // Use the SIMD kernels when the processor supports them
+  if (TacsGetTensorSimdLevel() >= 2) {
+    TacsAddAllTransTensor3DInterp5VarsPerNode4Avx512(N, Nx, in, values);
+    return;
+  } else if (TacsGetTensorSimdLevel() == 1) {
+    TacsAddAllTransTensor3DInterp5VarsPerNode4Avx2(N, Nx, in, values);
+    return;
+  }
+#endif  // TACS_TENSOR_PRODUCT_SIMD
+
   for (int n = 0; n < 125; n++) {
     const double *n1 = &N[5 * (n % 5)];
     const double *n2 = &N[5 * ((n % 25) / 5)];
@@ -533,6 +571,14 @@ void TACSInterpAllTensor3DInterp6VarsPerNode3(const double N[],
                                               const double Nx[],
                                               const TacsScalar values[],
                                               TacsScalar out[]) {
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+  // Use the SIMD kernels when the processor supports them
+  if (TacsGetTensorSimdLevel() >= 1) {
+    TACSInterpAllTensor3DInterp6VarsPerNode3Avx2(N, Nx, values, out);
+    return;
+  }
+#endif  // TACS_TENSOR_PRODUCT_SIMD
+
   memset(out, 0, 4 * 3 * 216 * sizeof(TacsScalar));
 
   for (int n = 0; n < 216; n++) {
@@ -587,6 +633,17 @@ void TACSInterpAllTensor3DInterp6VarsPerNode4(const double N[],
                                               const double Nx[],
                                               const TacsScalar values[],
                                               TacsScalar out[]) {
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+  // Use the SIMD kernels when the processor supports them
+  if (TacsGetTensorSimdLevel() >= 2) {
+    TACSInterpAllTensor3DInterp6VarsPerNode4Avx512(N, Nx, values, out);
+    return;
+  } else if (TacsGetTensorSimdLevel() == 1) {
+    TACSInterpAllTensor3DInterp6VarsPerNode4Avx2(N, Nx, values, out);
+    return;
+  }
+#endif  // TACS_TENSOR_PRODUCT_SIMD
+
   memset(out, 0, 4 * 4 * 216 * sizeof(TacsScalar));
 
   for (int n = 0; n < 216; n++) {
@@ -770,6 +827,14 @@ void TacsAddAllTransTensor3DInterp6VarsPerNode3(const double N[],
                                                 const double Nx[],
                                                 const TacsScalar in[],
                                                 TacsScalar values[]) {
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+  // Use the SIMD kernels when the processor supports them
+  if (TacsGetTensorSimdLevel() >= 1) {
+    TacsAddAllTransTensor3DInterp6VarsPerNode3Avx2(N, Nx, in, values);
+    return;
+  }
+#endif  // TACS_TENSOR_PRODUCT_SIMD
+
   for (int n = 0; n < 36; n++) {
     const double *n11 = &N[0];
     const double *n12 = &N[6];
@@ -920,6 +985,17 @@ void TacsAddAllTransTensor3DInterp6VarsPerNode4(const double N[],
                                                 const double Nx[],
                                                 const TacsScalar in[],
                                                 TacsScalar values[]) {
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+  // Use the SIMD kernels when the processor supports them
+  if (TacsGetTensorSimdLevel() >= 2) {
+    TacsAddAllTransTensor3DInterp6VarsPerNode4Avx512(N, Nx, in, values);
+    return;
+  } else if (TacsGetTensorSimdLevel() == 1) {
+    TacsAddAllTransTensor3DInterp6VarsPerNode4Avx2(N, Nx, in, values);
+    return;
+  }
+#endif  // TACS_TENSOR_PRODUCT_SIMD
+
   for (int n = 0; n < 36; n++) {
     const double *n11 = &N[0];
     const double *n12 = &N[6];
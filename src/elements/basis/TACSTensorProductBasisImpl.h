@@ -1398,4 +1398,73 @@ void TacsAddAllTransTensor3DInterp6VarsPerNode4(const double N[],
                                                 const TacsScalar in[],
                                                 TacsScalar values[]);
 
+/*
+  Explicit SIMD variants of the order 5 and 6 all-quadrature-point
+  kernels. These are only available for real (double precision) builds
+  on x86-64 - the scalar kernels above remain the fallback on other
+  platforms or processors.
+*/
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(TACS_USE_COMPLEX)
+#define TACS_TENSOR_PRODUCT_SIMD 1
+#endif
+
+// Run-time processor detection: 0 = scalar only, 1 = AVX2+FMA,
+// 2 = AVX-512F
+int TacsGetTensorSimdLevel();
+
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+// The AVX2 + FMA kernels
+void TACSInterpAllTensor3DInterp5VarsPerNode3Avx2(const double N[],
+                                                  const double Nx[],
+                                                  const TacsScalar values[],
+                                                  TacsScalar out[]);
+void TACSInterpAllTensor3DInterp5VarsPerNode4Avx2(const double N[],
+                                                  const double Nx[],
+                                                  const TacsScalar values[],
+                                                  TacsScalar out[]);
+void TacsAddAllTransTensor3DInterp5VarsPerNode3Avx2(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar in[],
+                                                    TacsScalar values[]);
+void TacsAddAllTransTensor3DInterp5VarsPerNode4Avx2(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar in[],
+                                                    TacsScalar values[]);
+void TACSInterpAllTensor3DInterp6VarsPerNode3Avx2(const double N[],
+                                                  const double Nx[],
+                                                  const TacsScalar values[],
+                                                  TacsScalar out[]);
+void TACSInterpAllTensor3DInterp6VarsPerNode4Avx2(const double N[],
+                                                  const double Nx[],
+                                                  const TacsScalar values[],
+                                                  TacsScalar out[]);
+void TacsAddAllTransTensor3DInterp6VarsPerNode3Avx2(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar in[],
+                                                    TacsScalar values[]);
+void TacsAddAllTransTensor3DInterp6VarsPerNode4Avx2(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar in[],
+                                                    TacsScalar values[]);
+
+// The AVX-512F kernels for 4 variables per node; the 3-variable
+// kernels fall back to the AVX2 variants
+void TACSInterpAllTensor3DInterp5VarsPerNode4Avx512(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar values[],
+                                                    TacsScalar out[]);
+void TacsAddAllTransTensor3DInterp5VarsPerNode4Avx512(const double N[],
+                                                      const double Nx[],
+                                                      const TacsScalar in[],
+                                                      TacsScalar values[]);
+void TACSInterpAllTensor3DInterp6VarsPerNode4Avx512(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar values[],
+                                                    TacsScalar out[]);
+void TacsAddAllTransTensor3DInterp6VarsPerNode4Avx512(const double N[],
+                                                      const double Nx[],
+                                                      const TacsScalar in[],
+                                                      TacsScalar values[]);
+#endif  // TACS_TENSOR_PRODUCT_SIMD
+
 #endif  // TACS_TENSOR_PRODUCT_BASIS_IMPL_H
@@ -0,0 +1,696 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2014 Georgia Tech Research Corporation
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSTensorProductBasisImpl.h"
+
+/*
+  Explicit SIMD implementations of the all-quadrature-point
+  interpolation kernels for the order 5 and 6 tensor-product bases.
+
+  These kernels are only compiled for real (double precision) builds
+  on x86-64. The processor capabilities are detected at run time in
+  TacsGetTensorSimdLevel() and the scalar kernels in
+  TACSTensorProductBasisImpl.cpp remain the fallback when the required
+  instructions are not available.
+
+  The kernels vectorize across the variables at each node: a node with
+  3 or 4 variables is held in a single 4-wide ymm register, so the
+  value and gradient sums for all of the variables are formed
+  simultaneously. The accumulators for the interpolated values and the
+  three parametric derivatives are kept in registers over the full
+  inner loop and only scattered into the interleaved output layout
+  once per quadrature point. The AVX-512 variants additionally process
+  the nodes two at a time for the 4-variable kernels, where two nodes
+  fill a zmm register exactly.
+*/
+
+/*!
+  Detect the SIMD level supported by the processor at run time.
+
+  returns: 0 for no SIMD support, 1 for AVX2+FMA, 2 for AVX-512F
+*/
+int TacsGetTensorSimdLevel() {
+  static int level = -1;
+  if (level < 0) {
+    level = 0;
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+    if (__builtin_cpu_supports("avx512f")) {
+      level = 2;
+    } else if (__builtin_cpu_supports("avx2") &&
+               __builtin_cpu_supports("fma")) {
+      level = 1;
+    }
+#endif  // TACS_TENSOR_PRODUCT_SIMD
+  }
+  return level;
+}
+
+#ifdef TACS_TENSOR_PRODUCT_SIMD
+
+#include <immintrin.h>
+
+/*
+  The AVX2 + FMA kernels
+*/
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+// The load/store mask for nodes with 3 variables
+static inline __m256i tacs_mask3() {
+  return _mm256_set_epi64x(0, -1, -1, -1);
+}
+
+void TACSInterpAllTensor3DInterp5VarsPerNode3Avx2(const double N[],
+                                                  const double Nx[],
+                                                  const TacsScalar values[],
+                                                  TacsScalar out[]) {
+  const __m256i mask = tacs_mask3();
+
+  for (int n = 0; n < 125; n++) {
+    const double *n1 = &N[5 * (n % 5)];
+    const double *n2 = &N[5 * ((n % 25) / 5)];
+    const double *n3 = &N[5 * (n / 25)];
+    const double *n1x = &Nx[5 * (n % 5)];
+    const double *n2x = &Nx[5 * ((n % 25) / 5)];
+    const double *n3x = &Nx[5 * (n / 25)];
+
+    __m256d u = _mm256_setzero_pd();
+    __m256d gx = _mm256_setzero_pd();
+    __m256d gy = _mm256_setzero_pd();
+    __m256d gz = _mm256_setzero_pd();
+
+    const TacsScalar *v = values;
+    for (int k = 0; k < 5; k++) {
+      for (int j = 0; j < 5; j++) {
+        __m256d t1 = _mm256_setzero_pd();
+        __m256d tx = _mm256_setzero_pd();
+        for (int i = 0; i < 5; i++) {
+          __m256d vi = _mm256_maskload_pd(&v[3 * i], mask);
+          t1 = _mm256_fmadd_pd(_mm256_set1_pd(n1[i]), vi, t1);
+          tx = _mm256_fmadd_pd(_mm256_set1_pd(n1x[i]), vi, tx);
+        }
+
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        u = _mm256_fmadd_pd(n23, t1, u);
+        gx = _mm256_fmadd_pd(n23, tx, gx);
+        gy = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), t1, gy);
+        gz = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), t1, gz);
+        v += 15;
+      }
+    }
+
+    double us[4], gxs[4], gys[4], gzs[4];
+    _mm256_storeu_pd(us, u);
+    _mm256_storeu_pd(gxs, gx);
+    _mm256_storeu_pd(gys, gy);
+    _mm256_storeu_pd(gzs, gz);
+    for (int p = 0; p < 3; p++) {
+      out[p] = us[p];
+      out[3 + 3 * p] = gxs[p];
+      out[4 + 3 * p] = gys[p];
+      out[5 + 3 * p] = gzs[p];
+    }
+    out += 12;
+  }
+}
+
+void TACSInterpAllTensor3DInterp5VarsPerNode4Avx2(const double N[],
+                                                  const double Nx[],
+                                                  const TacsScalar values[],
+                                                  TacsScalar out[]) {
+  for (int n = 0; n < 125; n++) {
+    const double *n1 = &N[5 * (n % 5)];
+    const double *n2 = &N[5 * ((n % 25) / 5)];
+    const double *n3 = &N[5 * (n / 25)];
+    const double *n1x = &Nx[5 * (n % 5)];
+    const double *n2x = &Nx[5 * ((n % 25) / 5)];
+    const double *n3x = &Nx[5 * (n / 25)];
+
+    __m256d u = _mm256_setzero_pd();
+    __m256d gx = _mm256_setzero_pd();
+    __m256d gy = _mm256_setzero_pd();
+    __m256d gz = _mm256_setzero_pd();
+
+    const TacsScalar *v = values;
+    for (int k = 0; k < 5; k++) {
+      for (int j = 0; j < 5; j++) {
+        __m256d t1 = _mm256_setzero_pd();
+        __m256d tx = _mm256_setzero_pd();
+        for (int i = 0; i < 5; i++) {
+          __m256d vi = _mm256_loadu_pd(&v[4 * i]);
+          t1 = _mm256_fmadd_pd(_mm256_set1_pd(n1[i]), vi, t1);
+          tx = _mm256_fmadd_pd(_mm256_set1_pd(n1x[i]), vi, tx);
+        }
+
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        u = _mm256_fmadd_pd(n23, t1, u);
+        gx = _mm256_fmadd_pd(n23, tx, gx);
+        gy = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), t1, gy);
+        gz = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), t1, gz);
+        v += 20;
+      }
+    }
+
+    double us[4], gxs[4], gys[4], gzs[4];
+    _mm256_storeu_pd(us, u);
+    _mm256_storeu_pd(gxs, gx);
+    _mm256_storeu_pd(gys, gy);
+    _mm256_storeu_pd(gzs, gz);
+    for (int p = 0; p < 4; p++) {
+      out[p] = us[p];
+      out[4 + 3 * p] = gxs[p];
+      out[5 + 3 * p] = gys[p];
+      out[6 + 3 * p] = gzs[p];
+    }
+    out += 16;
+  }
+}
+
+void TacsAddAllTransTensor3DInterp5VarsPerNode3Avx2(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar in[],
+                                                    TacsScalar values[]) {
+  const __m256i mask = tacs_mask3();
+
+  for (int n = 0; n < 125; n++) {
+    const double *n1 = &N[5 * (n % 5)];
+    const double *n2 = &N[5 * ((n % 25) / 5)];
+    const double *n3 = &N[5 * (n / 25)];
+    const double *n1x = &Nx[5 * (n % 5)];
+    const double *n2x = &Nx[5 * ((n % 25) / 5)];
+    const double *n3x = &Nx[5 * (n / 25)];
+
+    __m256d u = _mm256_maskload_pd(in, mask);
+    __m256d gx = _mm256_set_pd(0.0, in[9], in[6], in[3]);
+    __m256d gy = _mm256_set_pd(0.0, in[10], in[7], in[4]);
+    __m256d gz = _mm256_set_pd(0.0, in[11], in[8], in[5]);
+
+    TacsScalar *v = values;
+    for (int k = 0; k < 5; k++) {
+      for (int j = 0; j < 5; j++) {
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        __m256d a = _mm256_mul_pd(n23, u);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), gy, a);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), gz, a);
+        __m256d b = _mm256_mul_pd(n23, gx);
+
+        for (int i = 0; i < 5; i++) {
+          __m256d vi = _mm256_maskload_pd(&v[3 * i], mask);
+          vi = _mm256_fmadd_pd(a, _mm256_set1_pd(n1[i]), vi);
+          vi = _mm256_fmadd_pd(b, _mm256_set1_pd(n1x[i]), vi);
+          _mm256_maskstore_pd(&v[3 * i], mask, vi);
+        }
+        v += 15;
+      }
+    }
+    in += 12;
+  }
+}
+
+void TacsAddAllTransTensor3DInterp5VarsPerNode4Avx2(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar in[],
+                                                    TacsScalar values[]) {
+  for (int n = 0; n < 125; n++) {
+    const double *n1 = &N[5 * (n % 5)];
+    const double *n2 = &N[5 * ((n % 25) / 5)];
+    const double *n3 = &N[5 * (n / 25)];
+    const double *n1x = &Nx[5 * (n % 5)];
+    const double *n2x = &Nx[5 * ((n % 25) / 5)];
+    const double *n3x = &Nx[5 * (n / 25)];
+
+    __m256d u = _mm256_loadu_pd(in);
+    __m256d gx = _mm256_set_pd(in[13], in[10], in[7], in[4]);
+    __m256d gy = _mm256_set_pd(in[14], in[11], in[8], in[5]);
+    __m256d gz = _mm256_set_pd(in[15], in[12], in[9], in[6]);
+
+    TacsScalar *v = values;
+    for (int k = 0; k < 5; k++) {
+      for (int j = 0; j < 5; j++) {
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        __m256d a = _mm256_mul_pd(n23, u);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), gy, a);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), gz, a);
+        __m256d b = _mm256_mul_pd(n23, gx);
+
+        for (int i = 0; i < 5; i++) {
+          __m256d vi = _mm256_loadu_pd(&v[4 * i]);
+          vi = _mm256_fmadd_pd(a, _mm256_set1_pd(n1[i]), vi);
+          vi = _mm256_fmadd_pd(b, _mm256_set1_pd(n1x[i]), vi);
+          _mm256_storeu_pd(&v[4 * i], vi);
+        }
+        v += 20;
+      }
+    }
+    in += 16;
+  }
+}
+
+void TACSInterpAllTensor3DInterp6VarsPerNode3Avx2(const double N[],
+                                                  const double Nx[],
+                                                  const TacsScalar values[],
+                                                  TacsScalar out[]) {
+  const __m256i mask = tacs_mask3();
+
+  for (int n = 0; n < 216; n++) {
+    const double *n1 = &N[6 * (n % 6)];
+    const double *n2 = &N[6 * ((n % 36) / 6)];
+    const double *n3 = &N[6 * (n / 36)];
+    const double *n1x = &Nx[6 * (n % 6)];
+    const double *n2x = &Nx[6 * ((n % 36) / 6)];
+    const double *n3x = &Nx[6 * (n / 36)];
+
+    __m256d u = _mm256_setzero_pd();
+    __m256d gx = _mm256_setzero_pd();
+    __m256d gy = _mm256_setzero_pd();
+    __m256d gz = _mm256_setzero_pd();
+
+    const TacsScalar *v = values;
+    for (int k = 0; k < 6; k++) {
+      for (int j = 0; j < 6; j++) {
+        __m256d t1 = _mm256_setzero_pd();
+        __m256d tx = _mm256_setzero_pd();
+        for (int i = 0; i < 6; i++) {
+          __m256d vi = _mm256_maskload_pd(&v[3 * i], mask);
+          t1 = _mm256_fmadd_pd(_mm256_set1_pd(n1[i]), vi, t1);
+          tx = _mm256_fmadd_pd(_mm256_set1_pd(n1x[i]), vi, tx);
+        }
+
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        u = _mm256_fmadd_pd(n23, t1, u);
+        gx = _mm256_fmadd_pd(n23, tx, gx);
+        gy = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), t1, gy);
+        gz = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), t1, gz);
+        v += 18;
+      }
+    }
+
+    double us[4], gxs[4], gys[4], gzs[4];
+    _mm256_storeu_pd(us, u);
+    _mm256_storeu_pd(gxs, gx);
+    _mm256_storeu_pd(gys, gy);
+    _mm256_storeu_pd(gzs, gz);
+    for (int p = 0; p < 3; p++) {
+      out[p] = us[p];
+      out[3 + 3 * p] = gxs[p];
+      out[4 + 3 * p] = gys[p];
+      out[5 + 3 * p] = gzs[p];
+    }
+    out += 12;
+  }
+}
+
+void TACSInterpAllTensor3DInterp6VarsPerNode4Avx2(const double N[],
+                                                  const double Nx[],
+                                                  const TacsScalar values[],
+                                                  TacsScalar out[]) {
+  for (int n = 0; n < 216; n++) {
+    const double *n1 = &N[6 * (n % 6)];
+    const double *n2 = &N[6 * ((n % 36) / 6)];
+    const double *n3 = &N[6 * (n / 36)];
+    const double *n1x = &Nx[6 * (n % 6)];
+    const double *n2x = &Nx[6 * ((n % 36) / 6)];
+    const double *n3x = &Nx[6 * (n / 36)];
+
+    __m256d u = _mm256_setzero_pd();
+    __m256d gx = _mm256_setzero_pd();
+    __m256d gy = _mm256_setzero_pd();
+    __m256d gz = _mm256_setzero_pd();
+
+    const TacsScalar *v = values;
+    for (int k = 0; k < 6; k++) {
+      for (int j = 0; j < 6; j++) {
+        __m256d t1 = _mm256_setzero_pd();
+        __m256d tx = _mm256_setzero_pd();
+        for (int i = 0; i < 6; i++) {
+          __m256d vi = _mm256_loadu_pd(&v[4 * i]);
+          t1 = _mm256_fmadd_pd(_mm256_set1_pd(n1[i]), vi, t1);
+          tx = _mm256_fmadd_pd(_mm256_set1_pd(n1x[i]), vi, tx);
+        }
+
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        u = _mm256_fmadd_pd(n23, t1, u);
+        gx = _mm256_fmadd_pd(n23, tx, gx);
+        gy = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), t1, gy);
+        gz = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), t1, gz);
+        v += 24;
+      }
+    }
+
+    double us[4], gxs[4], gys[4], gzs[4];
+    _mm256_storeu_pd(us, u);
+    _mm256_storeu_pd(gxs, gx);
+    _mm256_storeu_pd(gys, gy);
+    _mm256_storeu_pd(gzs, gz);
+    for (int p = 0; p < 4; p++) {
+      out[p] = us[p];
+      out[4 + 3 * p] = gxs[p];
+      out[5 + 3 * p] = gys[p];
+      out[6 + 3 * p] = gzs[p];
+    }
+    out += 16;
+  }
+}
+
+void TacsAddAllTransTensor3DInterp6VarsPerNode3Avx2(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar in[],
+                                                    TacsScalar values[]) {
+  const __m256i mask = tacs_mask3();
+
+  for (int n = 0; n < 216; n++) {
+    const double *n1 = &N[6 * (n % 6)];
+    const double *n2 = &N[6 * ((n % 36) / 6)];
+    const double *n3 = &N[6 * (n / 36)];
+    const double *n1x = &Nx[6 * (n % 6)];
+    const double *n2x = &Nx[6 * ((n % 36) / 6)];
+    const double *n3x = &Nx[6 * (n / 36)];
+
+    __m256d u = _mm256_maskload_pd(in, mask);
+    __m256d gx = _mm256_set_pd(0.0, in[9], in[6], in[3]);
+    __m256d gy = _mm256_set_pd(0.0, in[10], in[7], in[4]);
+    __m256d gz = _mm256_set_pd(0.0, in[11], in[8], in[5]);
+
+    TacsScalar *v = values;
+    for (int k = 0; k < 6; k++) {
+      for (int j = 0; j < 6; j++) {
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        __m256d a = _mm256_mul_pd(n23, u);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), gy, a);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), gz, a);
+        __m256d b = _mm256_mul_pd(n23, gx);
+
+        for (int i = 0; i < 6; i++) {
+          __m256d vi = _mm256_maskload_pd(&v[3 * i], mask);
+          vi = _mm256_fmadd_pd(a, _mm256_set1_pd(n1[i]), vi);
+          vi = _mm256_fmadd_pd(b, _mm256_set1_pd(n1x[i]), vi);
+          _mm256_maskstore_pd(&v[3 * i], mask, vi);
+        }
+        v += 18;
+      }
+    }
+    in += 12;
+  }
+}
+
+void TacsAddAllTransTensor3DInterp6VarsPerNode4Avx2(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar in[],
+                                                    TacsScalar values[]) {
+  for (int n = 0; n < 216; n++) {
+    const double *n1 = &N[6 * (n % 6)];
+    const double *n2 = &N[6 * ((n % 36) / 6)];
+    const double *n3 = &N[6 * (n / 36)];
+    const double *n1x = &Nx[6 * (n % 6)];
+    const double *n2x = &Nx[6 * ((n % 36) / 6)];
+    const double *n3x = &Nx[6 * (n / 36)];
+
+    __m256d u = _mm256_loadu_pd(in);
+    __m256d gx = _mm256_set_pd(in[13], in[10], in[7], in[4]);
+    __m256d gy = _mm256_set_pd(in[14], in[11], in[8], in[5]);
+    __m256d gz = _mm256_set_pd(in[15], in[12], in[9], in[6]);
+
+    TacsScalar *v = values;
+    for (int k = 0; k < 6; k++) {
+      for (int j = 0; j < 6; j++) {
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        __m256d a = _mm256_mul_pd(n23, u);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), gy, a);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), gz, a);
+        __m256d b = _mm256_mul_pd(n23, gx);
+
+        for (int i = 0; i < 6; i++) {
+          __m256d vi = _mm256_loadu_pd(&v[4 * i]);
+          vi = _mm256_fmadd_pd(a, _mm256_set1_pd(n1[i]), vi);
+          vi = _mm256_fmadd_pd(b, _mm256_set1_pd(n1x[i]), vi);
+          _mm256_storeu_pd(&v[4 * i], vi);
+        }
+        v += 24;
+      }
+    }
+    in += 16;
+  }
+}
+
+#pragma GCC pop_options
+
+/*
+  The AVX-512F kernels for 4 variables per node, where a pair of nodes
+  fills a zmm register exactly. The 3-variable kernels dispatch to the
+  AVX2 variants instead.
+*/
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+
+// Build a zmm register holding (a, a, a, a, b, b, b, b)
+static inline __m512d tacs_pair_pd(double a, double b) {
+  return _mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_set1_pd(a)),
+                            _mm256_set1_pd(b), 1);
+}
+
+// Reduce a zmm accumulator to the sum of its 4-wide halves
+static inline __m256d tacs_fold_pd(__m512d a) {
+  return _mm256_add_pd(_mm512_castpd512_pd256(a),
+                       _mm512_extractf64x4_pd(a, 1));
+}
+
+void TACSInterpAllTensor3DInterp5VarsPerNode4Avx512(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar values[],
+                                                    TacsScalar out[]) {
+  for (int n = 0; n < 125; n++) {
+    const double *n1 = &N[5 * (n % 5)];
+    const double *n2 = &N[5 * ((n % 25) / 5)];
+    const double *n3 = &N[5 * (n / 25)];
+    const double *n1x = &Nx[5 * (n % 5)];
+    const double *n2x = &Nx[5 * ((n % 25) / 5)];
+    const double *n3x = &Nx[5 * (n / 25)];
+
+    // Pairs of basis function values for the node pairs (0,1) and (2,3)
+    __m512d n1p[2], n1xp[2];
+    for (int i = 0; i < 2; i++) {
+      n1p[i] = tacs_pair_pd(n1[2 * i], n1[2 * i + 1]);
+      n1xp[i] = tacs_pair_pd(n1x[2 * i], n1x[2 * i + 1]);
+    }
+    __m256d n1r = _mm256_set1_pd(n1[4]);
+    __m256d n1xr = _mm256_set1_pd(n1x[4]);
+
+    __m256d u = _mm256_setzero_pd();
+    __m256d gx = _mm256_setzero_pd();
+    __m256d gy = _mm256_setzero_pd();
+    __m256d gz = _mm256_setzero_pd();
+
+    const TacsScalar *v = values;
+    for (int k = 0; k < 5; k++) {
+      for (int j = 0; j < 5; j++) {
+        __m512d t8 = _mm512_setzero_pd();
+        __m512d tx8 = _mm512_setzero_pd();
+        for (int i = 0; i < 2; i++) {
+          __m512d vi = _mm512_loadu_pd(&v[8 * i]);
+          t8 = _mm512_fmadd_pd(n1p[i], vi, t8);
+          tx8 = _mm512_fmadd_pd(n1xp[i], vi, tx8);
+        }
+        __m256d vr = _mm256_loadu_pd(&v[16]);
+        __m256d t1 = _mm256_fmadd_pd(n1r, vr, tacs_fold_pd(t8));
+        __m256d tx = _mm256_fmadd_pd(n1xr, vr, tacs_fold_pd(tx8));
+
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        u = _mm256_fmadd_pd(n23, t1, u);
+        gx = _mm256_fmadd_pd(n23, tx, gx);
+        gy = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), t1, gy);
+        gz = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), t1, gz);
+        v += 20;
+      }
+    }
+
+    double us[4], gxs[4], gys[4], gzs[4];
+    _mm256_storeu_pd(us, u);
+    _mm256_storeu_pd(gxs, gx);
+    _mm256_storeu_pd(gys, gy);
+    _mm256_storeu_pd(gzs, gz);
+    for (int p = 0; p < 4; p++) {
+      out[p] = us[p];
+      out[4 + 3 * p] = gxs[p];
+      out[5 + 3 * p] = gys[p];
+      out[6 + 3 * p] = gzs[p];
+    }
+    out += 16;
+  }
+}
+
+void TacsAddAllTransTensor3DInterp5VarsPerNode4Avx512(const double N[],
+                                                      const double Nx[],
+                                                      const TacsScalar in[],
+                                                      TacsScalar values[]) {
+  for (int n = 0; n < 125; n++) {
+    const double *n1 = &N[5 * (n % 5)];
+    const double *n2 = &N[5 * ((n % 25) / 5)];
+    const double *n3 = &N[5 * (n / 25)];
+    const double *n1x = &Nx[5 * (n % 5)];
+    const double *n2x = &Nx[5 * ((n % 25) / 5)];
+    const double *n3x = &Nx[5 * (n / 25)];
+
+    __m512d n1p[2], n1xp[2];
+    for (int i = 0; i < 2; i++) {
+      n1p[i] = tacs_pair_pd(n1[2 * i], n1[2 * i + 1]);
+      n1xp[i] = tacs_pair_pd(n1x[2 * i], n1x[2 * i + 1]);
+    }
+    __m256d n1r = _mm256_set1_pd(n1[4]);
+    __m256d n1xr = _mm256_set1_pd(n1x[4]);
+
+    __m256d u = _mm256_loadu_pd(in);
+    __m256d gx = _mm256_set_pd(in[13], in[10], in[7], in[4]);
+    __m256d gy = _mm256_set_pd(in[14], in[11], in[8], in[5]);
+    __m256d gz = _mm256_set_pd(in[15], in[12], in[9], in[6]);
+
+    TacsScalar *v = values;
+    for (int k = 0; k < 5; k++) {
+      for (int j = 0; j < 5; j++) {
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        __m256d a = _mm256_mul_pd(n23, u);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), gy, a);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), gz, a);
+        __m256d b = _mm256_mul_pd(n23, gx);
+
+        __m512d a8 = _mm512_broadcast_f64x4(a);
+        __m512d b8 = _mm512_broadcast_f64x4(b);
+        for (int i = 0; i < 2; i++) {
+          __m512d vi = _mm512_loadu_pd(&v[8 * i]);
+          vi = _mm512_fmadd_pd(a8, n1p[i], vi);
+          vi = _mm512_fmadd_pd(b8, n1xp[i], vi);
+          _mm512_storeu_pd(&v[8 * i], vi);
+        }
+        __m256d vr = _mm256_loadu_pd(&v[16]);
+        vr = _mm256_fmadd_pd(a, n1r, vr);
+        vr = _mm256_fmadd_pd(b, n1xr, vr);
+        _mm256_storeu_pd(&v[16], vr);
+        v += 20;
+      }
+    }
+    in += 16;
+  }
+}
+
+void TACSInterpAllTensor3DInterp6VarsPerNode4Avx512(const double N[],
+                                                    const double Nx[],
+                                                    const TacsScalar values[],
+                                                    TacsScalar out[]) {
+  for (int n = 0; n < 216; n++) {
+    const double *n1 = &N[6 * (n % 6)];
+    const double *n2 = &N[6 * ((n % 36) / 6)];
+    const double *n3 = &N[6 * (n / 36)];
+    const double *n1x = &Nx[6 * (n % 6)];
+    const double *n2x = &Nx[6 * ((n % 36) / 6)];
+    const double *n3x = &Nx[6 * (n / 36)];
+
+    // Pairs of basis function values for the node pairs (0,1), (2,3)
+    // and (4,5)
+    __m512d n1p[3], n1xp[3];
+    for (int i = 0; i < 3; i++) {
+      n1p[i] = tacs_pair_pd(n1[2 * i], n1[2 * i + 1]);
+      n1xp[i] = tacs_pair_pd(n1x[2 * i], n1x[2 * i + 1]);
+    }
+
+    __m256d u = _mm256_setzero_pd();
+    __m256d gx = _mm256_setzero_pd();
+    __m256d gy = _mm256_setzero_pd();
+    __m256d gz = _mm256_setzero_pd();
+
+    const TacsScalar *v = values;
+    for (int k = 0; k < 6; k++) {
+      for (int j = 0; j < 6; j++) {
+        __m512d t8 = _mm512_setzero_pd();
+        __m512d tx8 = _mm512_setzero_pd();
+        for (int i = 0; i < 3; i++) {
+          __m512d vi = _mm512_loadu_pd(&v[8 * i]);
+          t8 = _mm512_fmadd_pd(n1p[i], vi, t8);
+          tx8 = _mm512_fmadd_pd(n1xp[i], vi, tx8);
+        }
+        __m256d t1 = tacs_fold_pd(t8);
+        __m256d tx = tacs_fold_pd(tx8);
+
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        u = _mm256_fmadd_pd(n23, t1, u);
+        gx = _mm256_fmadd_pd(n23, tx, gx);
+        gy = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), t1, gy);
+        gz = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), t1, gz);
+        v += 24;
+      }
+    }
+
+    double us[4], gxs[4], gys[4], gzs[4];
+    _mm256_storeu_pd(us, u);
+    _mm256_storeu_pd(gxs, gx);
+    _mm256_storeu_pd(gys, gy);
+    _mm256_storeu_pd(gzs, gz);
+    for (int p = 0; p < 4; p++) {
+      out[p] = us[p];
+      out[4 + 3 * p] = gxs[p];
+      out[5 + 3 * p] = gys[p];
+      out[6 + 3 * p] = gzs[p];
+    }
+    out += 16;
+  }
+}
+
+void TacsAddAllTransTensor3DInterp6VarsPerNode4Avx512(const double N[],
+                                                      const double Nx[],
+                                                      const TacsScalar in[],
+                                                      TacsScalar values[]) {
+  for (int n = 0; n < 216; n++) {
+    const double *n1 = &N[6 * (n % 6)];
+    const double *n2 = &N[6 * ((n % 36) / 6)];
+    const double *n3 = &N[6 * (n / 36)];
+    const double *n1x = &Nx[6 * (n % 6)];
+    const double *n2x = &Nx[6 * ((n % 36) / 6)];
+    const double *n3x = &Nx[6 * (n / 36)];
+
+    __m512d n1p[3], n1xp[3];
+    for (int i = 0; i < 3; i++) {
+      n1p[i] = tacs_pair_pd(n1[2 * i], n1[2 * i + 1]);
+      n1xp[i] = tacs_pair_pd(n1x[2 * i], n1x[2 * i + 1]);
+    }
+
+    __m256d u = _mm256_loadu_pd(in);
+    __m256d gx = _mm256_set_pd(in[13], in[10], in[7], in[4]);
+    __m256d gy = _mm256_set_pd(in[14], in[11], in[8], in[5]);
+    __m256d gz = _mm256_set_pd(in[15], in[12], in[9], in[6]);
+
+    TacsScalar *v = values;
+    for (int k = 0; k < 6; k++) {
+      for (int j = 0; j < 6; j++) {
+        __m256d n23 = _mm256_set1_pd(n2[j] * n3[k]);
+        __m256d a = _mm256_mul_pd(n23, u);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2x[j] * n3[k]), gy, a);
+        a = _mm256_fmadd_pd(_mm256_set1_pd(n2[j] * n3x[k]), gz, a);
+        __m256d b = _mm256_mul_pd(n23, gx);
+
+        __m512d a8 = _mm512_broadcast_f64x4(a);
+        __m512d b8 = _mm512_broadcast_f64x4(b);
+        for (int i = 0; i < 3; i++) {
+          __m512d vi = _mm512_loadu_pd(&v[8 * i]);
+          vi = _mm512_fmadd_pd(a8, n1p[i], vi);
+          vi = _mm512_fmadd_pd(b8, n1xp[i], vi);
+          _mm512_storeu_pd(&v[8 * i], vi);
+        }
+        v += 24;
+      }
+    }
+    in += 16;
+  }
+}
+
+#pragma GCC pop_options
+
+#endif  // TACS_TENSOR_PRODUCT_SIMD
@@ -153,6 +153,8 @@ class TACSBeamElement : public TACSElement {
 
   ElementType getElementType() { return TACS_BEAM_OR_SHELL_ELEMENT; }
 
+  TACSConstitutive *getConstitutive() { return con; }
+
   int getNumQuadraturePoints() { return quadrature::getNumQuadraturePoints(); }
 
   double getQuadratureWeight(int n) {
@@ -4,6 +4,23 @@
 #include "TACSElementAlgebra.h"
 #include "TACSElementVerification.h"
 
+/*
+  Packed SIMD kernels for the quaternion director algebra.
+
+  The derivative matrices D = d(Qdot*t)/d(qdot) are stored as three
+  rows of four quaternion entries, so the quaternion index maps
+  directly onto a 4-wide double register. When the compiler targets
+  AVX2 and FMA in a real (double precision) build, the residual
+  accumulation and the node-pair products in addDirectorJacobian are
+  computed with packed registers; the scalar expressions remain the
+  fallback for all other builds.
+*/
+#if defined(__AVX2__) && defined(__FMA__) && !defined(TACS_USE_COMPLEX) && \
+    !defined(TACS_USE_DUAL)
+#define TACS_DIRECTOR_SIMD
+#include <immintrin.h>
+#endif  // __AVX2__ && __FMA__
+
 /*
   The director class.
 
@@ -2166,10 +2183,20 @@ class TACSQuaternionRotation {
       D[10] = 2.0 * (q[3] * t[1] - q[0] * t[0] - 2.0 * q[2] * t[2]);
       D[11] = 2.0 * (q[1] * t[0] + q[2] * t[1]);
 
+#ifdef TACS_DIRECTOR_SIMD
+      // Accumulate all four quaternion entries of the residual in a
+      // single packed register: r += D^{T} * dd
+      __m256d rv = _mm256_loadu_pd(r);
+      rv = _mm256_fmadd_pd(_mm256_loadu_pd(&D[0]), _mm256_set1_pd(dd[0]), rv);
+      rv = _mm256_fmadd_pd(_mm256_loadu_pd(&D[4]), _mm256_set1_pd(dd[1]), rv);
+      rv = _mm256_fmadd_pd(_mm256_loadu_pd(&D[8]), _mm256_set1_pd(dd[2]), rv);
+      _mm256_storeu_pd(r, rv);
+#else
       r[0] += dd[0] * D[0] + dd[1] * D[4] + dd[2] * D[8];
       r[1] += dd[0] * D[1] + dd[1] * D[5] + dd[2] * D[9];
       r[2] += dd[0] * D[2] + dd[1] * D[6] + dd[2] * D[10];
       r[3] += dd[0] * D[3] + dd[1] * D[7] + dd[2] * D[11];
+#endif  // TACS_DIRECTOR_SIMD
 
       r += vars_per_node;
       q += vars_per_node;
@@ -2276,10 +2303,21 @@ class TACSQuaternionRotation {
     const TacsScalar *Di = D;
     for (int i = 0; i < num_nodes; i++, Di += 12) {
       if (res) {
+#ifdef TACS_DIRECTOR_SIMD
+        __m256d rv = _mm256_loadu_pd(r);
+        rv =
+            _mm256_fmadd_pd(_mm256_loadu_pd(&Di[0]), _mm256_set1_pd(dd[0]), rv);
+        rv =
+            _mm256_fmadd_pd(_mm256_loadu_pd(&Di[4]), _mm256_set1_pd(dd[1]), rv);
+        rv =
+            _mm256_fmadd_pd(_mm256_loadu_pd(&Di[8]), _mm256_set1_pd(dd[2]), rv);
+        _mm256_storeu_pd(r, rv);
+#else
         r[0] += dd[0] * Di[0] + dd[1] * Di[4] + dd[2] * Di[8];
         r[1] += dd[0] * Di[1] + dd[1] * Di[5] + dd[2] * Di[9];
         r[2] += dd[0] * Di[2] + dd[1] * Di[6] + dd[2] * Di[10];
         r[3] += dd[0] * Di[3] + dd[1] * Di[7] + dd[2] * Di[11];
+#endif  // TACS_DIRECTOR_SIMD
 
         r += vars_per_node;
       }
@@ -2288,6 +2326,49 @@ class TACSQuaternionRotation {
       const TacsScalar *Djdot = Ddot;
       const TacsScalar *Djddot = Dddot;
       for (int j = 0; j < num_nodes; j++, Dj += 12, Djdot += 12, Djddot += 12) {
+        TacsScalar jac[16];
+#ifdef TACS_DIRECTOR_SIMD
+        // Form the products with all four quaternion entries of node
+        // j packed in a register: qf[k][m] holds dfdq[3*m + k]
+        const __m256d Dj0 = _mm256_loadu_pd(&Dj[0]);
+        const __m256d Dj1 = _mm256_loadu_pd(&Dj[4]);
+        const __m256d Dj2 = _mm256_loadu_pd(&Dj[8]);
+        const __m256d Djd0 = _mm256_loadu_pd(&Djdot[0]);
+        const __m256d Djd1 = _mm256_loadu_pd(&Djdot[4]);
+        const __m256d Djd2 = _mm256_loadu_pd(&Djdot[8]);
+        const __m256d Djdd0 = _mm256_loadu_pd(&Djddot[0]);
+        const __m256d Djdd1 = _mm256_loadu_pd(&Djddot[4]);
+        const __m256d Djdd2 = _mm256_loadu_pd(&Djddot[8]);
+
+        __m256d qf[3];
+        for (int k = 0; k < 3; k++) {
+          const TacsScalar *h = &d2d[dsize * (3 * i + k) + 3 * j];
+          const TacsScalar *hT = &d2Tdotd[dsize * (3 * i + k) + 3 * j];
+
+          __m256d v =
+              _mm256_mul_pd(Dj0, _mm256_set1_pd(h[0] + gamma * hT[0]));
+          v = _mm256_fmadd_pd(Dj1, _mm256_set1_pd(h[1] + gamma * hT[1]), v);
+          v = _mm256_fmadd_pd(Dj2, _mm256_set1_pd(h[2] + gamma * hT[2]), v);
+
+          v = _mm256_fmadd_pd(Djd0, _mm256_set1_pd(2.0 * beta * hT[0]), v);
+          v = _mm256_fmadd_pd(Djd1, _mm256_set1_pd(2.0 * beta * hT[1]), v);
+          v = _mm256_fmadd_pd(Djd2, _mm256_set1_pd(2.0 * beta * hT[2]), v);
+
+          v = _mm256_fmadd_pd(Djdd0, _mm256_set1_pd(alpha * hT[0]), v);
+          v = _mm256_fmadd_pd(Djdd1, _mm256_set1_pd(alpha * hT[1]), v);
+          v = _mm256_fmadd_pd(Djdd2, _mm256_set1_pd(alpha * hT[2]), v);
+
+          qf[k] = v;
+        }
+
+        // Form the rows of the 4x4 Jacobian block jac[4*ii + jj]
+        for (int ii = 0; ii < 4; ii++) {
+          __m256d row = _mm256_mul_pd(qf[0], _mm256_set1_pd(Di[ii]));
+          row = _mm256_fmadd_pd(qf[1], _mm256_set1_pd(Di[4 + ii]), row);
+          row = _mm256_fmadd_pd(qf[2], _mm256_set1_pd(Di[8 + ii]), row);
+          _mm256_storeu_pd(&jac[4 * ii], row);
+        }
+#else
         TacsScalar dfdq[12];
         for (int k = 0; k < 3; k++) {
           TacsScalar tmp[3];
@@ -2330,7 +2411,6 @@ class TACSQuaternionRotation {
               Djddot[3] * tmp[0] + Djddot[7] * tmp[1] + Djddot[11] * tmp[2];
         }
 
-        TacsScalar jac[16];
         for (int k = 0; k < 4; k++) {
           jac[k] = dfdq[3 * k] * Di[0] + dfdq[3 * k + 1] * Di[4] +
                    dfdq[3 * k + 2] * Di[8];
@@ -2341,6 +2421,7 @@ class TACSQuaternionRotation {
           jac[12 + k] = dfdq[3 * k] * Di[3] + dfdq[3 * k + 1] * Di[7] +
                         dfdq[3 * k + 2] * Di[11];
         }
+#endif  // TACS_DIRECTOR_SIMD
 
         if (i == j) {
           TacsScalar tmp[3];
@@ -2368,11 +2449,20 @@ class TACSQuaternionRotation {
           jac[15] -= 4.0 * (tmp[0] * t[0] + tmp[1] * t[1]);
         }
 
+#ifdef TACS_DIRECTOR_SIMD
+        for (int ii = 0; ii < 4; ii++) {
+          TacsScalar *mrow = &m[vars_per_node * j + ii * size];
+          __m256d mv = _mm256_add_pd(_mm256_loadu_pd(mrow),
+                                     _mm256_loadu_pd(&jac[4 * ii]));
+          _mm256_storeu_pd(mrow, mv);
+        }
+#else
         for (int ii = 0; ii < 4; ii++) {
           for (int jj = 0; jj < 4; jj++) {
             m[vars_per_node * j + ii * size + jj] += jac[4 * ii + jj];
           }
         }
+#endif  // TACS_DIRECTOR_SIMD
       }
 
       q += vars_per_node;
@@ -2389,6 +2479,49 @@ class TACSQuaternionRotation {
     for (int i = 0; i < num_nodes; i++, Di += 12, Didot += 12, Diddot += 12) {
       for (int j = 0; j < num_nodes; j++) {
         TacsScalar dfdq[12], dfdqT[12];
+#ifdef TACS_DIRECTOR_SIMD
+        // Compute the products with all four quaternion entries of
+        // node i packed in a register, then transpose the result
+        // into the dfdq/dfdqT layout used by the scatter below
+        const __m256d Di0 = _mm256_loadu_pd(&Di[0]);
+        const __m256d Di1 = _mm256_loadu_pd(&Di[4]);
+        const __m256d Di2 = _mm256_loadu_pd(&Di[8]);
+        const __m256d Did0 = _mm256_loadu_pd(&Didot[0]);
+        const __m256d Did1 = _mm256_loadu_pd(&Didot[4]);
+        const __m256d Did2 = _mm256_loadu_pd(&Didot[8]);
+        const __m256d Didd0 = _mm256_loadu_pd(&Diddot[0]);
+        const __m256d Didd1 = _mm256_loadu_pd(&Diddot[4]);
+        const __m256d Didd2 = _mm256_loadu_pd(&Diddot[8]);
+
+        for (int k = 0; k < 3; k++) {
+          const TacsScalar h0 = d2du[dsize * (3 * i) + 3 * j + k];
+          const TacsScalar h1 = d2du[dsize * (3 * i + 1) + 3 * j + k];
+          const TacsScalar h2 = d2du[dsize * (3 * i + 2) + 3 * j + k];
+          const TacsScalar hT0 = d2Tdotu[dsize * (3 * i) + 3 * j + k];
+          const TacsScalar hT1 = d2Tdotu[dsize * (3 * i + 1) + 3 * j + k];
+          const TacsScalar hT2 = d2Tdotu[dsize * (3 * i + 2) + 3 * j + k];
+
+          __m256d v = _mm256_mul_pd(Di0, _mm256_set1_pd(h0 + gamma * hT0));
+          v = _mm256_fmadd_pd(Di1, _mm256_set1_pd(h1 + gamma * hT1), v);
+          v = _mm256_fmadd_pd(Di2, _mm256_set1_pd(h2 + gamma * hT2), v);
+
+          __m256d vT = _mm256_fmadd_pd(Did0, _mm256_set1_pd(2.0 * beta * hT0), v);
+          vT = _mm256_fmadd_pd(Did1, _mm256_set1_pd(2.0 * beta * hT1), vT);
+          vT = _mm256_fmadd_pd(Did2, _mm256_set1_pd(2.0 * beta * hT2), vT);
+
+          vT = _mm256_fmadd_pd(Didd0, _mm256_set1_pd(alpha * hT0), vT);
+          vT = _mm256_fmadd_pd(Didd1, _mm256_set1_pd(alpha * hT1), vT);
+          vT = _mm256_fmadd_pd(Didd2, _mm256_set1_pd(alpha * hT2), vT);
+
+          TacsScalar vals[4], valsT[4];
+          _mm256_storeu_pd(vals, v);
+          _mm256_storeu_pd(valsT, vT);
+          for (int m = 0; m < 4; m++) {
+            dfdq[3 * m + k] = vals[m];
+            dfdqT[3 * m + k] = valsT[m];
+          }
+        }
+#else
         for (int k = 0; k < 3; k++) {
           TacsScalar tmp[3];
           tmp[0] = d2du[dsize * (3 * i) + 3 * j + k] +
@@ -2438,6 +2571,7 @@ class TACSQuaternionRotation {
           dfdqT[9 + k] +=
               Diddot[3] * tmp[0] + Diddot[7] * tmp[1] + Diddot[11] * tmp[2];
         }
+#endif  // TACS_DIRECTOR_SIMD
 
         for (int ii = 0; ii < 4; ii++) {
           for (int jj = 0; jj < 3; jj++) {
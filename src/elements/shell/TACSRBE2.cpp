@@ -241,6 +241,63 @@ void TACSRBE2::addResidual(int elemIndex, double time, const TacsScalar Xpts[],
   delete[] maskedLM;
 }
 
+/*
+  Compute the constraint coefficients relating the dependent node
+  displacements to the independent node displacements.
+
+  The rigid-body relation enforced by the residual is:
+
+  un = u0 + theta0 x r
+  tn = theta0
+
+  where r = Xn - X0 points from the independent node to the dependent
+  node. G is stored row-major with NUM_DISPS*NUM_DEP_NODES rows and
+  NUM_DISPS columns; rows for unconstrained dependent DOFs are left
+  zero.
+*/
+void TACSRBE2::getConstraintMatrix(const TacsScalar Xpts[], TacsScalar G[]) {
+  const TacsScalar *X0 = &Xpts[0];  // indep node location
+  const TacsScalar *Xn = &Xpts[3];  // dep node locations
+
+  memset(G, 0, NUM_DISPS * NUM_DEP_NODES * NUM_DISPS * sizeof(TacsScalar));
+
+  for (int n = 0; n < NUM_DEP_NODES; n++) {
+    TacsScalar *row = &G[NUM_DISPS * NUM_DISPS * n];
+
+    // Displacements un = u0 + theta0 x r
+    if (dof_constrained[n][0]) {
+      row[0] = 1.0;
+      row[4] = Xn[2] - X0[2];
+      row[5] = -(Xn[1] - X0[1]);
+    }
+    row += NUM_DISPS;
+
+    if (dof_constrained[n][1]) {
+      row[1] = 1.0;
+      row[3] = -(Xn[2] - X0[2]);
+      row[5] = Xn[0] - X0[0];
+    }
+    row += NUM_DISPS;
+
+    if (dof_constrained[n][2]) {
+      row[2] = 1.0;
+      row[3] = Xn[1] - X0[1];
+      row[4] = -(Xn[0] - X0[0]);
+    }
+    row += NUM_DISPS;
+
+    // Rotations tn = theta0
+    for (int i = 0; i < 3; i++) {
+      if (dof_constrained[n][3 + i]) {
+        row[3 + i] = 1.0;
+      }
+      row += NUM_DISPS;
+    }
+
+    Xn += 3;
+  }
+}
+
 /*
   Assemble the stiffness matrix for the RBE2 element.
 */
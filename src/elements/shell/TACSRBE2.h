@@ -26,6 +26,15 @@ class TACSRBE2 : public TACSElement {
   int const* const* getDependentDOFs() { return dof_constrained; }
   int getNumDependentNodes() { return NUM_DEP_NODES; }
 
+  // Get the constraint coefficients relating the dependent node DOFs
+  // to the independent node DOFs. G is a row-major matrix with
+  // NUM_DISPS*NUM_DEP_NODES rows and NUM_DISPS columns such that
+  // u_dep[i] = sum_j G[i][j]*u_indep[j]. Rows for unconstrained
+  // dependent DOFs are zero. This is used to build the sparse
+  // constraint-elimination path (see TACSConstraintProjection) as an
+  // alternative to assembling the Lagrange-multiplier blocks.
+  void getConstraintMatrix(const TacsScalar Xpts[], TacsScalar G[]);
+
   // Get the element properties and names
   // ------------------------------------
   const char* getObjectName();
@@ -60,6 +69,9 @@ class TACSRBE2 : public TACSElement {
                    const TacsScalar ddvars[], TacsScalar res[],
                    TacsScalar mat[]);
 
+  // The Jacobian is independent of the element states
+  int isConstantJacobian() { return 1; }
+
   // Functions required to determine the derivatives w.r.t. the design variables
   // ---------------------------------------------------------------------------
   void addAdjResXptProduct(int elemIndex, double time, TacsScalar scale,
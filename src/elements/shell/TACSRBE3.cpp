@@ -422,6 +422,116 @@ void TACSRBE3::addResidual(int elemIndex, double time, const TacsScalar Xpts[],
   delete[] maskedVars;
 }
 
+/*
+  Compute the constraint coefficients relating the dependent node DOFs
+  to the independent node DOFs.
+
+  These are the coefficients of the weighted-average relation enforced
+  by the last six residual equations: the dependent node motion is the
+  transpose of the load-distribution matrix applied to the independent
+  node motion. G is stored row-major with NUM_DISPS rows and
+  NUM_DISPS*NUM_INDEP_NODES columns; rows for unconstrained dependent
+  DOFs are left zero, as are columns for unconstrained independent
+  DOFs.
+*/
+void TACSRBE3::getConstraintMatrix(const TacsScalar Xpts[], TacsScalar G[]) {
+  TacsScalar Xcg[3], Jcg[3][3], W[3], Lc;
+  const TacsScalar *X0, *Xn;
+
+  // Compute the centroid location and inverse moments of inertia tensor
+  getCG(Xcg, W, w, Xpts);
+  Lc = getMomentsOfInertia(Jcg, w, Xpts, Xcg);
+
+  const int ncols = NUM_DISPS * NUM_INDEP_NODES;
+  memset(G, 0, NUM_DISPS * ncols * sizeof(TacsScalar));
+
+  // Vector pointing from cg to the dependent node
+  X0 = &Xpts[0];
+  TacsScalar rco[3], rnc[3];
+  for (int i = 0; i < 3; i++) {
+    rco[i] = X0[i] - Xcg[i];
+  }
+
+  // The moment-arm factors coupling the moment about axis j at the cg
+  // to translation i of the dependent node (the transpose of the
+  // cross-product matrix of rco)
+  TacsScalar f[3][3];
+  f[0][0] = 0.0;
+  f[0][1] = rco[2];
+  f[0][2] = -rco[1];
+  f[1][0] = -rco[2];
+  f[1][1] = 0.0;
+  f[1][2] = rco[0];
+  f[2][0] = rco[1];
+  f[2][1] = -rco[0];
+  f[2][2] = 0.0;
+
+  Xn = &Xpts[3];  // independent node locations
+  for (int n = 0; n < NUM_INDEP_NODES; n++) {
+    // Vector pointing from cg to current indep node
+    for (int i = 0; i < 3; i++) {
+      rnc[i] = Xn[i] - Xcg[i];
+    }
+
+    // The bracket terms from the load-distribution matrix: b[k][j] is
+    // the translation k produced at this node by a unit moment about
+    // axis j at the cg
+    TacsScalar b[3][3];
+    for (int j = 0; j < 3; j++) {
+      b[0][j] = Jcg[1][j] * rnc[2] - Jcg[2][j] * rnc[1];
+      b[1][j] = Jcg[2][j] * rnc[0] - Jcg[0][j] * rnc[2];
+      b[2][j] = Jcg[0][j] * rnc[1] - Jcg[1][j] * rnc[0];
+    }
+
+    // Dependent node translations
+    for (int i = 0; i < 3; i++) {
+      if (dep_dof_constrained[i]) {
+        TacsScalar *row = &G[i * ncols + NUM_DISPS * n];
+        for (int k = 0; k < 3; k++) {
+          if (indep_dof_constrained[n][k]) {
+            TacsScalar val = 0.0;
+            if (i == k) {
+              val += w[n] / W[i];
+            }
+            for (int j = 0; j < 3; j++) {
+              val += w[n] * b[k][j] * f[i][j];
+            }
+            row[k] = val;
+          }
+        }
+        for (int m = 0; m < 3; m++) {
+          if (indep_dof_constrained[n][3 + m]) {
+            TacsScalar val = 0.0;
+            for (int j = 0; j < 3; j++) {
+              val += w[n] * Lc * Lc * Jcg[m][j] * f[i][j];
+            }
+            row[3 + m] = val;
+          }
+        }
+      }
+    }
+
+    // Dependent node rotations
+    for (int j = 0; j < 3; j++) {
+      if (dep_dof_constrained[3 + j]) {
+        TacsScalar *row = &G[(3 + j) * ncols + NUM_DISPS * n];
+        for (int k = 0; k < 3; k++) {
+          if (indep_dof_constrained[n][k]) {
+            row[k] = w[n] * b[k][j];
+          }
+        }
+        for (int m = 0; m < 3; m++) {
+          if (indep_dof_constrained[n][3 + m]) {
+            row[3 + m] = w[n] * Lc * Lc * Jcg[m][j];
+          }
+        }
+      }
+    }
+
+    Xn += 3;
+  }
+}
+
 /*
   Assemble the stiffness matrix for the RBE3 element.
 */
@@ -3,6 +3,7 @@
 #define TACS_SHELL_CENTRIFUGAL_FORCE_H
 
 #include "TACSElementAlgebra.h"
+#include "TACSElementLoadCache.h"
 #include "TACSShellConstitutive.h"
 #include "TACSShellUtilities.h"
 
@@ -18,12 +19,24 @@ class TACSShellCentrifugalForce : public TACSElement {
     memcpy(omegaVec, _omegaVec, 3 * sizeof(TacsScalar));
     memcpy(rotCenter, _rotCenter, 3 * sizeof(TacsScalar));
     first_order = _first_order;
+
+    // The first-order load follows the deformation, so the load
+    // vectors can only be cached in the undeformed configuration
+    use_cache = !first_order;
+    cache = NULL;
+    if (use_cache) {
+      cache = new TACSElementLoadCache(3 * basis::NUM_NODES,
+                                       vars_per_node * basis::NUM_NODES);
+    }
   }
 
   ~TACSShellCentrifugalForce() {
     if (con) {
       con->decref();
     }
+    if (cache) {
+      delete cache;
+    }
   }
 
   const char *getObjectName() { return "TACSShellCentrifugalForce"; }
@@ -59,9 +72,23 @@ class TACSShellCentrifugalForce : public TACSElement {
   }
 
   int setDesignVars(int elemIndex, int dvLen, const TacsScalar dvs[]) {
+    // The mass moments may change with the design variables
+    if (cache) {
+      cache->invalidate();
+    }
     return con->setDesignVars(elemIndex, dvLen, dvs);
   }
 
+  // Enable or disable caching of the element load vectors. The cache
+  // is never used for the first-order load, which depends on the
+  // state variables.
+  void setLoadCaching(int flag) {
+    use_cache = (flag && !first_order);
+    if (!use_cache && cache) {
+      cache->invalidate();
+    }
+  }
+
   int getDesignVars(int elemIndex, int dvLen, TacsScalar dvs[]) {
     return con->getDesignVars(elemIndex, dvLen, dvs);
   }
@@ -74,6 +101,30 @@ class TACSShellCentrifugalForce : public TACSElement {
   void addResidual(int elemIndex, double time, const TacsScalar *Xpts,
                    const TacsScalar *vars, const TacsScalar *dvars,
                    const TacsScalar *ddvars, TacsScalar *res) {
+    if (use_cache) {
+      // Serve the cached load vector if the node locations still match
+      if (cache->addCached(elemIndex, Xpts, res)) {
+        return;
+      }
+
+      // Compute and cache the load vector for this element
+      TacsScalar load[vars_per_node * basis::NUM_NODES];
+      memset(load, 0, vars_per_node * basis::NUM_NODES * sizeof(TacsScalar));
+      computeLoad(elemIndex, Xpts, vars, load);
+      cache->insert(elemIndex, Xpts, load);
+
+      for (int i = 0; i < vars_per_node * basis::NUM_NODES; i++) {
+        res[i] += load[i];
+      }
+      return;
+    }
+
+    computeLoad(elemIndex, Xpts, vars, res);
+  }
+
+  // Compute the centrifugal load vector for the element by quadrature
+  void computeLoad(int elemIndex, const TacsScalar *Xpts,
+                   const TacsScalar *vars, TacsScalar *res) {
     // Compute the number of quadrature points
     const int nquad = quadrature::getNumQuadraturePoints();
 
@@ -246,6 +297,10 @@ class TACSShellCentrifugalForce : public TACSElement {
   TacsScalar omegaVec[3], rotCenter[3];
   TACSShellConstitutive *con;
   bool first_order;
+
+  // The cache of element load vectors
+  int use_cache;
+  TACSElementLoadCache *cache;
 };
 
 #endif  // TACS_SHELL_CENTRIFUGAL_FORCE_H
@@ -46,6 +46,12 @@ class TACSShellElement : public TACSElement {
     con = _con;
     con->incref();
 
+    // The geometry cache is allocated on first use
+    useGeometryCache = 0;
+    numCacheElements = 0;
+    cacheElemValid = NULL;
+    geomCache = NULL;
+
     // For linear models, we'll need to switch to a nonlinear implementation to
     // capture geometric effects
     if (typeid(model) == typeid(TACSShellLinearModel)) {
@@ -71,6 +77,11 @@ class TACSShellElement : public TACSElement {
       con->decref();
     }
 
+    if (geomCache) {
+      delete[] geomCache;
+      delete[] cacheElemValid;
+    }
+
     // free nonlinear element pointer
     if (nlElem != this) {
       delete nlElem;
@@ -86,6 +97,8 @@ class TACSShellElement : public TACSElement {
 
   ElementType getElementType() { return TACS_BEAM_OR_SHELL_ELEMENT; }
 
+  TACSConstitutive *getConstitutive() { return con; }
+
   int getNumQuadraturePoints() { return quadrature::getNumQuadraturePoints(); }
 
   double getQuadratureWeight(int n) {
@@ -103,6 +116,21 @@ class TACSShellElement : public TACSElement {
 
   bool getComplexStepGmatrix() { return complexStepGmatrix; };
 
+  // Cache the node normals and coordinate transformations across
+  // residual and Jacobian calls. These quantities depend only on the
+  // node locations, so they can be re-used across the iterations of a
+  // nonlinear solve or the time steps of a transient analysis. The
+  // cache is discarded whenever the assembler node locations change.
+  // Note that filling the cache is not thread-safe, so this should not
+  // be combined with threaded assembly.
+  void setUseGeometryCache(int flag) { useGeometryCache = flag; }
+
+  void invalidateGeometryCache() {
+    if (cacheElemValid) {
+      memset(cacheElemValid, 0, numCacheElements * sizeof(int));
+    }
+  }
+
   double getQuadraturePoint(int n, double pt[]) {
     return quadrature::getQuadraturePoint(n, pt);
   }
@@ -163,12 +191,23 @@ class TACSShellElement : public TACSElement {
                    const TacsScalar *vars, const TacsScalar *dvars,
                    const TacsScalar *ddvars, TacsScalar *res);
 
+  void addResidualBatch(int count, const int elemIndex[], double time,
+                        const TacsScalar Xpts[], const TacsScalar vars[],
+                        const TacsScalar dvars[], const TacsScalar ddvars[],
+                        TacsScalar res[]);
+
   void addJacobian(int elemIndex, double time, TacsScalar alpha,
                    TacsScalar beta, TacsScalar gamma, const TacsScalar Xpts[],
                    const TacsScalar vars[], const TacsScalar dvars[],
                    const TacsScalar ddvars[], TacsScalar res[],
                    TacsScalar mat[]);
 
+  void addJacobianBatch(int count, const int elemIndex[], double time,
+                        TacsScalar alpha, TacsScalar beta, TacsScalar gamma,
+                        const TacsScalar Xpts[], const TacsScalar vars[],
+                        const TacsScalar dvars[], const TacsScalar ddvars[],
+                        TacsScalar res[], TacsScalar mat[]);
+
   void getMatType(ElementMatrixType matType, int elemIndex, double time,
                   const TacsScalar Xpts[], const TacsScalar vars[],
                   TacsScalar mat[]);
@@ -217,11 +256,109 @@ class TACSShellElement : public TACSElement {
   static const int dsize = 3 * num_nodes;
   static const int csize = 9 * num_nodes;
 
+  // Layout of one geometry cache entry: the node normals fn and frame
+  // derivatives Xdn, followed by the node-wise transformations Tn and
+  // XdinvTn, followed by X, T, XdinvT, XdinvzT and detXd at each
+  // quadrature point
+  static const int GEO_FN = 0;
+  static const int GEO_XDN = 3 * num_nodes;
+  static const int GEO_TN = 12 * num_nodes;
+  static const int GEO_XDINVTN = 21 * num_nodes;
+  static const int GEO_QUAD = 30 * num_nodes;
+  static const int GEO_QUAD_SIZE = 31;  // X[3] + T[9] + XdinvT[9] + XdinvzT[9]
+                                        // + detXd
+
+  // Compute (or re-use) the cached geometry data for this element
+  const TacsScalar *getCachedGeometry(int elemIndex, const TacsScalar Xpts[]);
+
   TACSShellTransform *transform;
   TACSShellConstitutive *con;
   TACSElement *nlElem;
+
+  // Cached node-location-dependent data, keyed by the element index
+  int useGeometryCache;
+  int numCacheElements;  // Number of entries allocated in the cache
+  int *cacheElemValid;   // Flag for whether each entry is up to date
+  TacsScalar *geomCache;
 };
 
+/*
+  Retrieve the cached geometry data for the given element, computing it
+  from the node locations if the cache entry is missing or stale
+*/
+template <class quadrature, class basis, class director, class model>
+const TacsScalar *
+TACSShellElement<quadrature, basis, director, model>::getCachedGeometry(
+    int elemIndex, const TacsScalar Xpts[]) {
+  const int nquad = quadrature::getNumQuadraturePoints();
+  const int entry_size = GEO_QUAD + GEO_QUAD_SIZE * nquad;
+
+  // Grow the cache so that the entry for this element exists
+  if (elemIndex >= numCacheElements) {
+    int new_size = 2 * numCacheElements;
+    if (new_size < elemIndex + 1) {
+      new_size = elemIndex + 1;
+    }
+
+    TacsScalar *new_cache = new TacsScalar[entry_size * new_size];
+    int *new_valid = new int[new_size];
+    memset(new_valid, 0, new_size * sizeof(int));
+
+    if (geomCache) {
+      memcpy(new_cache, geomCache,
+             entry_size * numCacheElements * sizeof(TacsScalar));
+      memcpy(new_valid, cacheElemValid, numCacheElements * sizeof(int));
+      delete[] geomCache;
+      delete[] cacheElemValid;
+    }
+
+    geomCache = new_cache;
+    cacheElemValid = new_valid;
+    numCacheElements = new_size;
+  }
+
+  TacsScalar *entry = &geomCache[entry_size * elemIndex];
+  if (!cacheElemValid[elemIndex]) {
+    // Compute the node normal directions and node-wise transformations
+    TacsScalar *fn = &entry[GEO_FN];
+    TacsScalar *Xdn = &entry[GEO_XDN];
+    TacsScalar *Tn = &entry[GEO_TN];
+    TacsScalar *XdinvTn = &entry[GEO_XDINVTN];
+    TacsShellComputeNodeNormals<basis>(Xpts, fn, Xdn);
+    TacsShellComputeNodeTransforms<basis>(transform, Xdn, fn, Tn, XdinvTn);
+
+    // Compute the transformation data at each quadrature point
+    TacsScalar *qdata = &entry[GEO_QUAD];
+    for (int quad_index = 0; quad_index < nquad;
+         quad_index++, qdata += GEO_QUAD_SIZE) {
+      double pt[3];
+      quadrature::getQuadraturePoint(quad_index, pt);
+
+      TacsScalar *X = &qdata[0];
+      TacsScalar *T = &qdata[3];
+      TacsScalar *XdinvT = &qdata[12];
+      TacsScalar *XdinvzT = &qdata[21];
+
+      // Compute X, X,xi and the interpolated normal n0
+      TacsScalar Xxi[6], n0[3];
+      basis::template interpFields<3, 3>(pt, Xpts, X);
+      basis::template interpFieldsGrad<3, 3>(pt, Xpts, Xxi);
+      basis::template interpFields<3, 3>(pt, fn, n0);
+
+      // Compute the transformation at the quadrature point
+      transform->computeTransform(Xxi, n0, T);
+
+      // Compute the Jacobian transformation products
+      qdata[30] = TacsShellComputeFrameTransforms<basis>(pt, Xxi, fn, n0, T,
+                                                         XdinvT, XdinvzT);
+    }
+
+    cacheElemValid[elemIndex] = 1;
+  }
+
+  return entry;
+}
+
 /*
   Compute the kinetic and potential energies of the shell
 */
@@ -258,41 +395,68 @@ void TACSShellElement<quadrature, basis, director, model>::computeEnergies(
   model::template computeTyingStrain<vars_per_node, basis>(Xpts, fn, vars, d,
                                                            ety);
 
-  // Loop over each quadrature point and add the residual contribution
+  // Get the quadrature-point-major interpolation tables
+  const TACSShellQuadptInterp<quadrature, basis> *qinterp =
+      TACSShellQuadptInterp<quadrature, basis>::get();
+
+  // Batch-interpolate the geometry and solution fields at all of the
+  // quadrature points
+  const int max_quad_pts = quadrature::NUM_QUADRATURE_POINTS;
+  TacsScalar Xq[3 * max_quad_pts], Xxiq[6 * max_quad_pts];
+  TacsScalar n0q[3 * max_quad_pts], nxiq[6 * max_quad_pts];
+  TacsScalar etq[max_quad_pts];
+  TacsScalar u0xiq[6 * max_quad_pts];
+  TacsScalar d0q[3 * max_quad_pts], d0xiq[6 * max_quad_pts];
+  TacsScalar u0dotq[3 * max_quad_pts], d0dotq[3 * max_quad_pts];
+  TacsScalar gtyq[6 * max_quad_pts];
+
+  qinterp->template interpFieldsAll<3, 3>(Xpts, Xq);
+  qinterp->template interpFieldsGradAll<3, 3>(Xpts, Xxiq);
+  qinterp->template interpFieldsAll<3, 3>(fn, n0q);
+  qinterp->template interpFieldsGradAll<3, 3>(fn, nxiq);
+  qinterp->template interpFieldsAll<1, 1>(etn, etq);
+  qinterp->template interpFieldsGradAll<vars_per_node, 3>(vars, u0xiq);
+  qinterp->template interpFieldsAll<3, 3>(d, d0q);
+  qinterp->template interpFieldsGradAll<3, 3>(d, d0xiq);
+  qinterp->template interpFieldsAll<vars_per_node, 3>(dvars, u0dotq);
+  qinterp->template interpFieldsAll<3, 3>(ddot, d0dotq);
+  qinterp->interpTyingStrainAll(ety, gtyq);
+
+  // Loop over each quadrature point and add the energy contributions
   for (int quad_index = 0; quad_index < nquad; quad_index++) {
     // Get the quadrature weight
     double pt[3];
     double weight = quadrature::getQuadraturePoint(quad_index, pt);
 
-    // Compute X, X,xi and the interpolated normal n0
-    TacsScalar X[3], Xxi[6], n0[3], T[9], et;
-    basis::template interpFields<3, 3>(pt, Xpts, X);
-    basis::template interpFieldsGrad<3, 3>(pt, Xpts, Xxi);
-    basis::template interpFields<3, 3>(pt, fn, n0);
-    basis::template interpFields<1, 1>(pt, etn, &et);
+    // Get X, X,xi and the interpolated normal n0
+    const TacsScalar *X = &Xq[3 * quad_index];
+    const TacsScalar *Xxi = &Xxiq[6 * quad_index];
+    const TacsScalar *n0 = &n0q[3 * quad_index];
 
     // Compute the transformation at the quadrature point
+    TacsScalar T[9];
     transform->computeTransform(Xxi, n0, T);
 
     // Evaluate the displacement gradient at the point
     TacsScalar XdinvT[9], XdinvzT[9];
+    TacsScalar detXd = TacsShellComputeFrameTransforms(
+        Xxi, n0, &nxiq[6 * quad_index], T, XdinvT, XdinvzT);
+
     TacsScalar u0x[9], u1x[9];
-    TacsScalar detXd = TacsShellComputeDispGrad<vars_per_node, basis>(
-        pt, Xpts, vars, fn, d, Xxi, n0, T, XdinvT, XdinvzT, u0x, u1x);
+    TacsShellComputeDispGradFromInterp(&u0xiq[6 * quad_index],
+                                       &d0q[3 * quad_index],
+                                       &d0xiq[6 * quad_index], T, XdinvT,
+                                       XdinvzT, u0x, u1x);
     detXd *= weight;
 
-    // Evaluate the tying components of the strain
-    TacsScalar gty[6];  // The symmetric components of the tying strain
-    basis::interpTyingStrain(pt, ety, gty);
-
     // Compute the symmetric parts of the tying strain
     TacsScalar e0ty[6];  // e0ty = XdinvT^{T}*gty*XdinvT
-    mat3x3SymmTransformTranspose(XdinvT, gty, e0ty);
+    mat3x3SymmTransformTranspose(XdinvT, &gtyq[6 * quad_index], e0ty);
 
     // Compute the set of strain components
     TacsScalar e[9];  // The components of the strain
     model::evalStrain(u0x, u1x, e0ty, e);
-    e[8] = et;
+    e[8] = etq[quad_index];
 
     // Compute the corresponding stresses
     TacsScalar s[9];
@@ -307,10 +471,9 @@ void TACSShellElement<quadrature, basis, director, model>::computeEnergies(
     TacsScalar moments[3];
     con->evalMassMoments(elemIndex, pt, X, moments);
 
-    // Compute the velocities and the director velocities
-    TacsScalar u0dot[3], d0dot[3];
-    basis::template interpFields<vars_per_node, 3>(pt, dvars, u0dot);
-    basis::template interpFields<3, 3>(pt, ddot, d0dot);
+    // Get the velocities and the director velocities
+    const TacsScalar *u0dot = &u0dotq[3 * quad_index];
+    const TacsScalar *d0dot = &d0dotq[3 * quad_index];
 
     Telem += 0.5 * detXd *
              (moments[0] * vec3Dot(u0dot, u0dot) +
@@ -337,9 +500,15 @@ void TACSShellElement<quadrature, basis, director, model>::addResidual(
   TacsScalar dd[dsize];
   memset(dd, 0, 3 * num_nodes * sizeof(TacsScalar));
 
+  // Look up the cached geometry data for this element, if enabled
+  const TacsScalar *geo = NULL;
+  if (useGeometryCache) {
+    geo = getCachedGeometry(elemIndex, Xpts);
+  }
+
   // Compute the node normal directions
-  TacsScalar fn[3 * num_nodes], Xdn[9 * num_nodes];
-  TacsShellComputeNodeNormals<basis>(Xpts, fn, Xdn);
+  TacsScalar fnl[3 * num_nodes], Xdnl[9 * num_nodes];
+  const TacsScalar *fn = fnl, *Xdn = Xdnl;
 
   // Compute the drill strain penalty at each node
   TacsScalar etn[num_nodes], detn[num_nodes];
@@ -347,10 +516,21 @@ void TACSShellElement<quadrature, basis, director, model>::addResidual(
 
   // Store information about the transformation and derivatives at each node for
   // the drilling degrees of freedom
-  TacsScalar XdinvTn[9 * num_nodes], Tn[9 * num_nodes];
+  TacsScalar XdinvTnl[9 * num_nodes], Tnl[9 * num_nodes];
+  const TacsScalar *XdinvTn = XdinvTnl, *Tn = Tnl;
   TacsScalar u0xn[9 * num_nodes], Ctn[csize];
-  TacsShellComputeDrillStrain<vars_per_node, offset, basis, director, model>(
-      transform, Xdn, fn, vars, XdinvTn, Tn, u0xn, Ctn, etn);
+  if (geo) {
+    fn = &geo[GEO_FN];
+    Xdn = &geo[GEO_XDN];
+    Tn = &geo[GEO_TN];
+    XdinvTn = &geo[GEO_XDINVTN];
+    TacsShellComputeDrillStrain<vars_per_node, offset, basis, director, model>(
+        XdinvTn, Tn, vars, u0xn, Ctn, etn);
+  } else {
+    TacsShellComputeNodeNormals<basis>(Xpts, fnl, Xdnl);
+    TacsShellComputeDrillStrain<vars_per_node, offset, basis, director, model>(
+        transform, Xdnl, fnl, vars, XdinvTnl, Tnl, u0xn, Ctn, etn);
+  }
 
   TacsScalar d[dsize], ddot[dsize], dddot[dsize];
   director::template computeDirectorRates<vars_per_node, offset, num_nodes>(
@@ -362,41 +542,93 @@ void TACSShellElement<quadrature, basis, director, model>::addResidual(
   model::template computeTyingStrain<vars_per_node, basis>(Xpts, fn, vars, d,
                                                            ety);
 
-  // Loop over each quadrature point and add the residual contribution
+  // Get the quadrature-point-major interpolation tables
+  const TACSShellQuadptInterp<quadrature, basis> *qinterp =
+      TACSShellQuadptInterp<quadrature, basis>::get();
+
+  // Batch-interpolate the solution fields at all of the quadrature
+  // points
+  const int max_quad_pts = quadrature::NUM_QUADRATURE_POINTS;
+  TacsScalar etq[max_quad_pts];
+  TacsScalar u0xiq[6 * max_quad_pts];
+  TacsScalar d0q[3 * max_quad_pts], d0xiq[6 * max_quad_pts];
+  TacsScalar u0ddotq[3 * max_quad_pts], d0ddotq[3 * max_quad_pts];
+  TacsScalar gtyq[6 * max_quad_pts];
+
+  qinterp->template interpFieldsAll<1, 1>(etn, etq);
+  qinterp->template interpFieldsGradAll<vars_per_node, 3>(vars, u0xiq);
+  qinterp->template interpFieldsAll<3, 3>(d, d0q);
+  qinterp->template interpFieldsGradAll<3, 3>(d, d0xiq);
+  qinterp->template interpFieldsAll<vars_per_node, 3>(ddvars, u0ddotq);
+  qinterp->template interpFieldsAll<3, 3>(dddot, d0ddotq);
+  qinterp->interpTyingStrainAll(ety, gtyq);
+
+  // Batch-interpolate the geometry when no cached data is available
+  TacsScalar Xq[3 * max_quad_pts], Xxiq[6 * max_quad_pts];
+  TacsScalar n0q[3 * max_quad_pts], nxiq[6 * max_quad_pts];
+  if (!geo) {
+    qinterp->template interpFieldsAll<3, 3>(Xpts, Xq);
+    qinterp->template interpFieldsGradAll<3, 3>(Xpts, Xxiq);
+    qinterp->template interpFieldsAll<3, 3>(fn, n0q);
+    qinterp->template interpFieldsGradAll<3, 3>(fn, nxiq);
+  }
+
+  // The weak-form coefficients staged at the quadrature points for
+  // the batched transpose interpolation after the loop
+  TacsScalar detq[max_quad_pts];
+  TacsScalar du0xiq[6 * max_quad_pts];
+  TacsScalar dd0q[3 * max_quad_pts], dd0xiq[6 * max_quad_pts];
+  TacsScalar dgtyq[6 * max_quad_pts];
+  TacsScalar du0dotq[3 * max_quad_pts], dd0dotq[3 * max_quad_pts];
+
+  // Loop over each quadrature point and evaluate the pointwise
+  // stress/strain and weak-form coefficients
   for (int quad_index = 0; quad_index < nquad; quad_index++) {
     // Get the quadrature weight
     double pt[3];
     double weight = quadrature::getQuadraturePoint(quad_index, pt);
 
-    // Compute X, X,xi and the interpolated normal n0
-    TacsScalar X[3], Xxi[6], n0[3], T[9], et;
-    basis::template interpFields<3, 3>(pt, Xpts, X);
-    basis::template interpFieldsGrad<3, 3>(pt, Xpts, Xxi);
-    basis::template interpFields<3, 3>(pt, fn, n0);
-    basis::template interpFields<1, 1>(pt, etn, &et);
+    // Compute the transformation at the quadrature point, re-using
+    // the cached geometry data when it is available
+    TacsScalar Tl[9], XdinvTl[9], XdinvzTl[9];
+    const TacsScalar *X, *T = Tl, *XdinvT = XdinvTl, *XdinvzT = XdinvzTl;
+    TacsScalar detXd;
+    if (geo) {
+      const TacsScalar *qdata = &geo[GEO_QUAD + GEO_QUAD_SIZE * quad_index];
+      X = &qdata[0];
+      T = &qdata[3];
+      XdinvT = &qdata[12];
+      XdinvzT = &qdata[21];
+      detXd = qdata[30];
+    } else {
+      // Get X, X,xi and the interpolated normal n0
+      X = &Xq[3 * quad_index];
+      const TacsScalar *Xxi = &Xxiq[6 * quad_index];
+      const TacsScalar *n0 = &n0q[3 * quad_index];
 
-    // Compute the transformation at the quadrature point
-    transform->computeTransform(Xxi, n0, T);
+      // Compute the transformation at the quadrature point
+      transform->computeTransform(Xxi, n0, Tl);
+
+      detXd = TacsShellComputeFrameTransforms(
+          Xxi, n0, &nxiq[6 * quad_index], Tl, XdinvTl, XdinvzTl);
+    }
 
     // Evaluate the displacement gradient at the point
-    TacsScalar XdinvT[9], XdinvzT[9];
     TacsScalar u0x[9], u1x[9];
-    TacsScalar detXd = TacsShellComputeDispGrad<vars_per_node, basis>(
-        pt, Xpts, vars, fn, d, Xxi, n0, T, XdinvT, XdinvzT, u0x, u1x);
+    TacsShellComputeDispGradFromInterp(&u0xiq[6 * quad_index],
+                                       &d0q[3 * quad_index],
+                                       &d0xiq[6 * quad_index], T, XdinvT,
+                                       XdinvzT, u0x, u1x);
     detXd *= weight;
 
-    // Evaluate the tying components of the strain
-    TacsScalar gty[6];  // The symmetric components of the tying strain
-    basis::interpTyingStrain(pt, ety, gty);
-
     // Compute the symmetric parts of the tying strain
     TacsScalar e0ty[6];  // e0ty = XdinvT^{T}*gty*XdinvT
-    mat3x3SymmTransformTranspose(XdinvT, gty, e0ty);
+    mat3x3SymmTransformTranspose(XdinvT, &gtyq[6 * quad_index], e0ty);
 
     // Compute the set of strain components
     TacsScalar e[9];  // The components of the strain
     model::evalStrain(u0x, u1x, e0ty, e);
-    e[8] = et;
+    e[8] = etq[quad_index];
 
     // Compute the corresponding stresses
     TacsScalar s[9];
@@ -407,44 +639,49 @@ void TACSShellElement<quadrature, basis, director, model>::addResidual(
     TacsScalar du0x[9], du1x[9], de0ty[6];
     model::evalStrainSens(detXd, s, u0x, u1x, du0x, du1x, de0ty);
 
-    // Add the contribution to the drilling strain
-    TacsScalar det = detXd * s[8];
-    basis::template addInterpFieldsTranspose<1, 1>(pt, &det, detn);
-
-    // Add the contributions to the residual from du0x, du1x and dCt
-    TacsShellAddDispGradSens<vars_per_node, basis>(pt, T, XdinvT, XdinvzT, du0x,
-                                                   du1x, res, dd);
+    // Stage the contribution to the drilling strain
+    detq[quad_index] = detXd * s[8];
 
-    // Compute the of the tying strain w.r.t. derivative w.r.t. the coefficients
-    TacsScalar dgty[6];
-    mat3x3SymmTransformTransSens(XdinvT, de0ty, dgty);
+    // Stage the contributions to the residual from du0x and du1x
+    TacsShellDispGradSensToInterp(T, XdinvT, XdinvzT, du0x, du1x,
+                                  &du0xiq[6 * quad_index],
+                                  &dd0q[3 * quad_index],
+                                  &dd0xiq[6 * quad_index]);
 
-    // Evaluate the tying strain
-    basis::addInterpTyingStrainTranspose(pt, dgty, dety);
+    // Stage the derivative of the tying strain w.r.t. the coefficients
+    mat3x3SymmTransformTransSens(XdinvT, de0ty, &dgtyq[6 * quad_index]);
 
     // Evaluate the mass moments
     TacsScalar moments[3];
     con->evalMassMoments(elemIndex, pt, X, moments);
 
-    // Evaluate the second time derivatives
-    TacsScalar u0ddot[3], d0ddot[3];
-    basis::template interpFields<vars_per_node, 3>(pt, ddvars, u0ddot);
-    basis::template interpFields<3, 3>(pt, dddot, d0ddot);
+    // Get the second time derivatives
+    const TacsScalar *u0ddot = &u0ddotq[3 * quad_index];
+    const TacsScalar *d0ddot = &d0ddotq[3 * quad_index];
 
-    // Add the contributions to the derivative
-    TacsScalar du0dot[3];
+    // Stage the contributions to the derivative
+    TacsScalar *du0dot = &du0dotq[3 * quad_index];
     du0dot[0] = detXd * (moments[0] * u0ddot[0] + moments[1] * d0ddot[0]);
     du0dot[1] = detXd * (moments[0] * u0ddot[1] + moments[1] * d0ddot[1]);
     du0dot[2] = detXd * (moments[0] * u0ddot[2] + moments[1] * d0ddot[2]);
-    basis::template addInterpFieldsTranspose<vars_per_node, 3>(pt, du0dot, res);
 
-    TacsScalar dd0dot[3];
+    TacsScalar *dd0dot = &dd0dotq[3 * quad_index];
     dd0dot[0] = detXd * (moments[1] * u0ddot[0] + moments[2] * d0ddot[0]);
     dd0dot[1] = detXd * (moments[1] * u0ddot[1] + moments[2] * d0ddot[1]);
     dd0dot[2] = detXd * (moments[1] * u0ddot[2] + moments[2] * d0ddot[2]);
-    basis::template addInterpFieldsTranspose<3, 3>(pt, dd0dot, dd);
   }
 
+  // Scatter the staged coefficients back to the nodes in batched
+  // transpose interpolations over all of the quadrature points
+  qinterp->template addInterpFieldsTransposeAll<1, 1>(detq, detn);
+  qinterp->template addInterpFieldsGradTransposeAll<vars_per_node, 3>(du0xiq,
+                                                                      res);
+  qinterp->template addInterpFieldsTransposeAll<3, 3>(dd0q, dd);
+  qinterp->template addInterpFieldsGradTransposeAll<3, 3>(dd0xiq, dd);
+  qinterp->addInterpTyingStrainTransposeAll(dgtyq, dety);
+  qinterp->template addInterpFieldsTransposeAll<vars_per_node, 3>(du0dotq, res);
+  qinterp->template addInterpFieldsTransposeAll<3, 3>(dd0dotq, dd);
+
   // Add the contribution to the residual from the drill strain
   TacsShellAddDrillStrainSens<vars_per_node, offset, basis, director, model>(
       Xdn, fn, vars, XdinvTn, Tn, u0xn, Ctn, detn, res);
@@ -463,6 +700,28 @@ void TACSShellElement<quadrature, basis, director, model>::addResidual(
       vars, res);
 }
 
+/*
+  Add the residuals for a batch of elements that share this element
+  object.
+
+  The loop calls the class implementation directly so that the batch
+  pays for a single virtual dispatch and the compiler can inline and
+  keep the per-element kernel hot across the batch.
+*/
+template <class quadrature, class basis, class director, class model>
+void TACSShellElement<quadrature, basis, director, model>::addResidualBatch(
+    int count, const int elemIndex[], double time, const TacsScalar Xpts[],
+    const TacsScalar vars[], const TacsScalar dvars[],
+    const TacsScalar ddvars[], TacsScalar res[]) {
+  const int nxpts = 3 * num_nodes;
+  const int nvars = vars_per_node * num_nodes;
+  for (int i = 0; i < count; i++) {
+    TACSShellElement<quadrature, basis, director, model>::addResidual(
+        elemIndex[i], time, &Xpts[nxpts * i], &vars[nvars * i],
+        &dvars[nvars * i], &ddvars[nvars * i], &res[nvars * i]);
+  }
+}
+
 /*
   Add the contributions to the residual and Jacobian matrix
 */
@@ -499,9 +758,15 @@ void TACSShellElement<quadrature, basis, director, model>::addJacobian(
   memset(d2etyu, 0, basis::NUM_TYING_POINTS * usize * sizeof(TacsScalar));
   memset(d2etyd, 0, basis::NUM_TYING_POINTS * dsize * sizeof(TacsScalar));
 
+  // Look up the cached geometry data for this element, if enabled
+  const TacsScalar *geo = NULL;
+  if (useGeometryCache) {
+    geo = getCachedGeometry(elemIndex, Xpts);
+  }
+
   // Compute the node normal directions
-  TacsScalar fn[3 * num_nodes], Xdn[9 * num_nodes];
-  TacsShellComputeNodeNormals<basis>(Xpts, fn, Xdn);
+  TacsScalar fnl[3 * num_nodes], Xdnl[9 * num_nodes];
+  const TacsScalar *fn = fnl, *Xdn = Xdnl;
 
   // Compute the drill strain penalty at each node
   TacsScalar etn[num_nodes], detn[num_nodes];
@@ -511,10 +776,21 @@ void TACSShellElement<quadrature, basis, director, model>::addJacobian(
 
   // Store information about the transformation and derivatives at each node for
   // the drilling degrees of freedom
-  TacsScalar XdinvTn[9 * num_nodes], Tn[9 * num_nodes];
+  TacsScalar XdinvTnl[9 * num_nodes], Tnl[9 * num_nodes];
+  const TacsScalar *XdinvTn = XdinvTnl, *Tn = Tnl;
   TacsScalar u0xn[9 * num_nodes], Ctn[csize];
-  TacsShellComputeDrillStrain<vars_per_node, offset, basis, director, model>(
-      transform, Xdn, fn, vars, XdinvTn, Tn, u0xn, Ctn, etn);
+  if (geo) {
+    fn = &geo[GEO_FN];
+    Xdn = &geo[GEO_XDN];
+    Tn = &geo[GEO_TN];
+    XdinvTn = &geo[GEO_XDINVTN];
+    TacsShellComputeDrillStrain<vars_per_node, offset, basis, director, model>(
+        XdinvTn, Tn, vars, u0xn, Ctn, etn);
+  } else {
+    TacsShellComputeNodeNormals<basis>(Xpts, fnl, Xdnl);
+    TacsShellComputeDrillStrain<vars_per_node, offset, basis, director, model>(
+        transform, Xdnl, fnl, vars, XdinvTnl, Tnl, u0xn, Ctn, etn);
+  }
 
   TacsScalar d[dsize], ddot[dsize], dddot[dsize];
   director::template computeDirectorRates<vars_per_node, offset, num_nodes>(
@@ -531,21 +807,41 @@ void TACSShellElement<quadrature, basis, director, model>::addJacobian(
     double pt[3];
     double weight = quadrature::getQuadraturePoint(quad_index, pt);
 
-    // Compute X, X,xi and the interpolated normal n0
-    TacsScalar X[3], Xxi[6], n0[3], T[9], et;
-    basis::template interpFields<3, 3>(pt, Xpts, X);
-    basis::template interpFieldsGrad<3, 3>(pt, Xpts, Xxi);
-    basis::template interpFields<3, 3>(pt, fn, n0);
+    // Interpolate the drill strain
+    TacsScalar et;
     basis::template interpFields<1, 1>(pt, etn, &et);
 
-    // Compute the transformation at the quadrature point
-    transform->computeTransform(Xxi, n0, T);
-
-    // Evaluate the displacement gradient at the point
-    TacsScalar XdinvT[9], XdinvzT[9];
+    // Compute the transformation and the displacement gradient at the
+    // quadrature point, re-using the cached geometry data when it is
+    // available
+    TacsScalar Xl[3], Tl[9], XdinvTl[9], XdinvzTl[9];
+    const TacsScalar *X = Xl, *T = Tl, *XdinvT = XdinvTl, *XdinvzT = XdinvzTl;
     TacsScalar u0x[9], u1x[9];
-    TacsScalar detXd = TacsShellComputeDispGrad<vars_per_node, basis>(
-        pt, Xpts, vars, fn, d, Xxi, n0, T, XdinvT, XdinvzT, u0x, u1x);
+    TacsScalar detXd;
+    if (geo) {
+      const TacsScalar *qdata = &geo[GEO_QUAD + GEO_QUAD_SIZE * quad_index];
+      X = &qdata[0];
+      T = &qdata[3];
+      XdinvT = &qdata[12];
+      XdinvzT = &qdata[21];
+      detXd = qdata[30];
+
+      TacsShellComputeDispGrad<vars_per_node, basis>(pt, vars, d, T, XdinvT,
+                                                     XdinvzT, u0x, u1x);
+    } else {
+      // Compute X, X,xi and the interpolated normal n0
+      TacsScalar Xxi[6], n0[3];
+      basis::template interpFields<3, 3>(pt, Xpts, Xl);
+      basis::template interpFieldsGrad<3, 3>(pt, Xpts, Xxi);
+      basis::template interpFields<3, 3>(pt, fn, n0);
+
+      // Compute the transformation at the quadrature point
+      transform->computeTransform(Xxi, n0, Tl);
+
+      // Evaluate the displacement gradient at the point
+      detXd = TacsShellComputeDispGrad<vars_per_node, basis>(
+          pt, Xpts, vars, fn, d, Xxi, n0, Tl, XdinvTl, XdinvzTl, u0x, u1x);
+    }
     detXd *= weight;
 
     // Evaluate the tying components of the strain
@@ -671,6 +967,30 @@ void TACSShellElement<quadrature, basis, director, model>::addJacobian(
                                                           mat);
 }
 
+/*
+  Add the residuals and Jacobians for a batch of elements that share
+  this element object.
+
+  As with addResidualBatch(), the loop calls the class implementation
+  directly so that the batch pays for a single virtual dispatch and the
+  compiler can keep the per-element kernel hot across the batch.
+*/
+template <class quadrature, class basis, class director, class model>
+void TACSShellElement<quadrature, basis, director, model>::addJacobianBatch(
+    int count, const int elemIndex[], double time, TacsScalar alpha,
+    TacsScalar beta, TacsScalar gamma, const TacsScalar Xpts[],
+    const TacsScalar vars[], const TacsScalar dvars[],
+    const TacsScalar ddvars[], TacsScalar res[], TacsScalar mat[]) {
+  const int nxpts = 3 * num_nodes;
+  const int nvars = vars_per_node * num_nodes;
+  for (int i = 0; i < count; i++) {
+    TACSShellElement<quadrature, basis, director, model>::addJacobian(
+        elemIndex[i], time, alpha, beta, gamma, &Xpts[nxpts * i],
+        &vars[nvars * i], &dvars[nvars * i], &ddvars[nvars * i],
+        &res[nvars * i], &mat[nvars * nvars * i]);
+  }
+}
+
 template <class quadrature, class basis, class director, class model>
 void TACSShellElement<quadrature, basis, director, model>::getMatType(
     ElementMatrixType matType, int elemIndex, double time,
@@ -1395,26 +1715,36 @@ void TACSShellElement<quadrature, basis, director, model>::getOutputData(
     // Get the number of nodes associated with the visualization
     int num_vis_nodes = TacsGetNumVisNodes(basis::getLayoutType());
 
-    // Compute the node normal directions
-    TacsScalar fn[3 * num_nodes], Xdn[9 * num_nodes];
-    TacsShellComputeNodeNormals<basis>(Xpts, fn, Xdn);
+    // The strain-dependent quantities are only needed when the
+    // strains, stresses or extra fields are written
+    int need_strain =
+        write_flag &
+        (TACS_OUTPUT_STRAINS | TACS_OUTPUT_STRESSES | TACS_OUTPUT_EXTRAS);
 
-    // Store information about the transformation and derivatives at each node
-    // for the drilling degrees of freedom
+    TacsScalar fn[3 * num_nodes], Xdn[9 * num_nodes];
     TacsScalar etn[num_nodes];
-    TacsScalar XdinvTn[9 * num_nodes], Tn[9 * num_nodes];
-    TacsScalar u0xn[9 * num_nodes], Ctn[csize];
-    TacsShellComputeDrillStrain<vars_per_node, offset, basis, director, model>(
-        transform, Xdn, fn, vars, XdinvTn, Tn, u0xn, Ctn, etn);
-
     TacsScalar d[dsize], ddot[dsize], dddot[dsize];
-    director::template computeDirectorRates<vars_per_node, offset, num_nodes>(
-        vars, dvars, ddvars, fn, d, ddot, dddot);
-
-    // Set the total number of tying points needed for this element
     TacsScalar ety[basis::NUM_TYING_POINTS];
-    model::template computeTyingStrain<vars_per_node, basis>(Xpts, fn, vars, d,
-                                                             ety);
+
+    if (need_strain) {
+      // Compute the node normal directions
+      TacsShellComputeNodeNormals<basis>(Xpts, fn, Xdn);
+
+      // Store information about the transformation and derivatives at each
+      // node for the drilling degrees of freedom
+      TacsScalar XdinvTn[9 * num_nodes], Tn[9 * num_nodes];
+      TacsScalar u0xn[9 * num_nodes], Ctn[csize];
+      TacsShellComputeDrillStrain<vars_per_node, offset, basis, director,
+                                  model>(transform, Xdn, fn, vars, XdinvTn, Tn,
+                                         u0xn, Ctn, etn);
+
+      director::template computeDirectorRates<vars_per_node, offset, num_nodes>(
+          vars, dvars, ddvars, fn, d, ddot, dddot);
+
+      // Set the total number of tying points needed for this element
+      model::template computeTyingStrain<vars_per_node, basis>(Xpts, fn, vars,
+                                                               d, ety);
+    }
 
     // Loop over each quadrature point and add the residual contribution
     for (int index = 0; index < num_vis_nodes; index++) {
@@ -1422,38 +1752,43 @@ void TACSShellElement<quadrature, basis, director, model>::getOutputData(
       double pt[3];
       basis::getNodePoint(index, pt);
 
-      // Compute X, X,xi and the interpolated normal n0
-      TacsScalar X[3], Xxi[6], n0[3], T[9], et;
+      // Compute the node location at the point
+      TacsScalar X[3], e[9], s[9];
       basis::template interpFields<3, 3>(pt, Xpts, X);
-      basis::template interpFieldsGrad<3, 3>(pt, Xpts, Xxi);
-      basis::template interpFields<3, 3>(pt, fn, n0);
-      basis::template interpFields<1, 1>(pt, etn, &et);
 
-      // Compute the transformation at the quadrature point
-      transform->computeTransform(Xxi, n0, T);
-
-      // Evaluate the displacement gradient at the point
-      TacsScalar XdinvT[9], XdinvzT[9];
-      TacsScalar u0x[9], u1x[9];
-      TacsShellComputeDispGrad<vars_per_node, basis>(
-          pt, Xpts, vars, fn, d, Xxi, n0, T, XdinvT, XdinvzT, u0x, u1x);
-
-      // Evaluate the tying components of the strain
-      TacsScalar gty[6];  // The symmetric components of the tying strain
-      basis::interpTyingStrain(pt, ety, gty);
-
-      // Compute the symmetric parts of the tying strain
-      TacsScalar e0ty[6];  // e0ty = XdinvT^{T}*gty*XdinvT
-      mat3x3SymmTransformTranspose(XdinvT, gty, e0ty);
-
-      // Compute the set of strain components
-      TacsScalar e[9];  // The components of the strain
-      model::evalStrain(u0x, u1x, e0ty, e);
-      e[8] = et;
-
-      // Compute the corresponding stresses
-      TacsScalar s[9];
-      con->evalStress(elemIndex, pt, X, e, s);
+      if (need_strain) {
+        // Compute X,xi and the interpolated normal n0
+        TacsScalar Xxi[6], n0[3], T[9], et;
+        basis::template interpFieldsGrad<3, 3>(pt, Xpts, Xxi);
+        basis::template interpFields<3, 3>(pt, fn, n0);
+        basis::template interpFields<1, 1>(pt, etn, &et);
+
+        // Compute the transformation at the quadrature point
+        transform->computeTransform(Xxi, n0, T);
+
+        // Evaluate the displacement gradient at the point
+        TacsScalar XdinvT[9], XdinvzT[9];
+        TacsScalar u0x[9], u1x[9];
+        TacsShellComputeDispGrad<vars_per_node, basis>(
+            pt, Xpts, vars, fn, d, Xxi, n0, T, XdinvT, XdinvzT, u0x, u1x);
+
+        // Evaluate the tying components of the strain
+        TacsScalar gty[6];  // The symmetric components of the tying strain
+        basis::interpTyingStrain(pt, ety, gty);
+
+        // Compute the symmetric parts of the tying strain
+        TacsScalar e0ty[6];  // e0ty = XdinvT^{T}*gty*XdinvT
+        mat3x3SymmTransformTranspose(XdinvT, gty, e0ty);
+
+        // Compute the set of strain components
+        model::evalStrain(u0x, u1x, e0ty, e);
+        e[8] = et;
+
+        // Compute the corresponding stresses only when they are written
+        if (write_flag & TACS_OUTPUT_STRESSES) {
+          con->evalStress(elemIndex, pt, X, e, s);
+        }
+      }
 
       if (write_flag & TACS_OUTPUT_NODES) {
         data[0] = X[0];
@@ -9,6 +9,7 @@
 #include "TACSShellElementModel.h"
 #include "TACSShellElementQuadBasis.h"
 #include "TACSShellElementTriBasis.h"
+#include "TACSAssembler.h"
 #include "TACSShellInplaneElementModel.h"
 #include "TACSThermalShellElement.h"
 
@@ -294,4 +295,31 @@ inline TACSElement *TacsCreateShellByName(const char *name,
   return shell;
 }
 
+/**
+  Register devirtualized residual kernels for the standard shell
+  element types with the assembler.
+
+  Meshes that are dominated by one of these types then dispatch the
+  element residuals through direct, inlinable calls in the batched
+  serial assembly path rather than through the vtable. Registration is
+  cheap and elements of unregistered types are unaffected, so this can
+  be called unconditionally after the assembler is created.
+
+  @param assembler The assembler used for the analysis
+*/
+inline void TacsRegisterShellResidualKernels(TACSAssembler *assembler) {
+  assembler->registerResidualKernel<TACSQuad4Shell>();
+  assembler->registerResidualKernel<TACSQuad9Shell>();
+  assembler->registerResidualKernel<TACSQuad16Shell>();
+  assembler->registerResidualKernel<TACSTri3Shell>();
+  assembler->registerResidualKernel<TACSQuad4ThermalShell>();
+  assembler->registerResidualKernel<TACSQuad9ThermalShell>();
+  assembler->registerResidualKernel<TACSQuad16ThermalShell>();
+  assembler->registerResidualKernel<TACSTri3ThermalShell>();
+  assembler->registerResidualKernel<TACSQuad4NonlinearShell>();
+  assembler->registerResidualKernel<TACSQuad9NonlinearShell>();
+  assembler->registerResidualKernel<TACSQuad16NonlinearShell>();
+  assembler->registerResidualKernel<TACSTri3NonlinearShell>();
+}
+
 #endif  // TACS_SHELL_ELEMENT_DEFS_H
@@ -15,8 +15,9 @@ enum TacsShellTyingStrainComponent {
 };
 
 template <int order>
-inline void TacsLagrangeShapeFunction(const double u, const double knots[],
-                                      double N[]) {
+TACS_SHELL_CONSTEXPR void TacsLagrangeShapeFunction(const double u,
+                                                     const double knots[],
+                                                     double N[]) {
   // Loop over the shape functions
   for (int i = 0; i < order; i++) {
     N[i] = 1.0;
@@ -30,9 +31,10 @@ inline void TacsLagrangeShapeFunction(const double u, const double knots[],
 }
 
 template <int order>
-inline void TacsLagrangeShapeFuncDerivative(const double u,
-                                            const double knots[], double N[],
-                                            double Nd[]) {
+TACS_SHELL_CONSTEXPR void TacsLagrangeShapeFuncDerivative(const double u,
+                                                           const double knots[],
+                                                           double N[],
+                                                           double Nd[]) {
   // Loop over the shape function knot locations
   for (int i = 0; i < order; i++) {
     N[i] = 1.0;
@@ -60,7 +62,8 @@ inline void TacsLagrangeShapeFuncDerivative(const double u,
 }
 
 template <int order>
-inline void TacsLagrangeLobattoShapeFunction(const double u, double *N) {
+TACS_SHELL_CONSTEXPR void TacsLagrangeLobattoShapeFunction(const double u,
+                                                            double *N) {
   if (order == 1) {
     N[0] = 1.0;
   } else if (order == 2) {
@@ -83,8 +86,8 @@ inline void TacsLagrangeLobattoShapeFunction(const double u, double *N) {
 }
 
 template <int order>
-inline void TacsLagrangeLobattoShapeFuncDerivative(const double u, double *N,
-                                                   double *Nd) {
+TACS_SHELL_CONSTEXPR void TacsLagrangeLobattoShapeFuncDerivative(
+    const double u, double *N, double *Nd) {
   if (order == 1) {
     N[0] = 1.0;
   } else if (order == 2) {
@@ -113,7 +116,7 @@ inline void TacsLagrangeLobattoShapeFuncDerivative(const double u, double *N,
   }
 }
 
-const double TacsShellLinearTyingPoints[2] = {-1.0, 1.0};
+constexpr double TacsShellLinearTyingPoints[2] = {-1.0, 1.0};
 
 template <int order>
 class TACSShellQuadBasis {
@@ -169,9 +172,10 @@ class TACSShellQuadBasis {
   }
 
   template <int vars_per_node, int m>
-  static void interpFields(const double pt[], const TacsScalar values[],
-                           TacsScalar field[]) {
-    double na[order], nb[order];
+  static TACS_SHELL_CONSTEXPR void interpFields(const double pt[],
+                                                const TacsScalar values[],
+                                                TacsScalar field[]) {
+    double na[order] = {0.0}, nb[order] = {0.0};
     TacsLagrangeLobattoShapeFunction<order>(pt[0], na);
     TacsLagrangeLobattoShapeFunction<order>(pt[1], nb);
 
@@ -208,10 +212,10 @@ class TACSShellQuadBasis {
   }
 
   template <int vars_per_node, int m>
-  static void interpFieldsGrad(const double pt[], const TacsScalar values[],
-                               TacsScalar grad[]) {
-    double na[order], dna[order];
-    double nb[order], dnb[order];
+  static TACS_SHELL_CONSTEXPR void interpFieldsGrad(
+      const double pt[], const TacsScalar values[], TacsScalar grad[]) {
+    double na[order] = {0.0}, dna[order] = {0.0};
+    double nb[order] = {0.0}, dnb[order] = {0.0};
     TacsLagrangeLobattoShapeFuncDerivative<order>(pt[0], na, dna);
     TacsLagrangeLobattoShapeFuncDerivative<order>(pt[1], nb, dnb);
 
@@ -484,7 +488,8 @@ class TACSShellQuadBasis {
     @param index The index of the tying point
     @return The tying strain field index
   */
-  static inline TacsShellTyingStrainComponent getTyingField(int index) {
+  static TACS_SHELL_CONSTEXPR TacsShellTyingStrainComponent getTyingField(
+      int index) {
     if (index < G11_OFFSET) {
       return TACS_SHELL_G11_COMPONENT;
     } else if (index < G22_OFFSET) {
@@ -501,8 +506,8 @@ class TACSShellQuadBasis {
   /*
     Get the knots associated with the tying points
   */
-  static inline void getTyingKnots(const double **ty_knots_order,
-                                   const double **ty_knots_reduced) {
+  static TACS_SHELL_CONSTEXPR void getTyingKnots(
+      const double **ty_knots_order, const double **ty_knots_reduced) {
     if (order == 2) {
       *ty_knots_order = TacsShellLinearTyingPoints;
       *ty_knots_reduced = TacsGaussQuadPts1;
@@ -566,16 +571,17 @@ class TACSShellQuadBasis {
   /*
     Evaluate the interpolation for all of the tying points
   */
-  static void evalTyingInterp(const double pt[], double N[]) {
-    const double *ty_knots_order, *ty_knots_reduced;
+  static TACS_SHELL_CONSTEXPR void evalTyingInterp(const double pt[],
+                                                   double N[]) {
+    const double *ty_knots_order = NULL, *ty_knots_reduced = NULL;
     getTyingKnots(&ty_knots_order, &ty_knots_reduced);
 
     // Evaluate the required shape functions
-    double na[order], nb[order];
+    double na[order] = {0.0}, nb[order] = {0.0};
     TacsLagrangeShapeFunction<order>(pt[0], ty_knots_order, na);
     TacsLagrangeShapeFunction<order>(pt[1], ty_knots_order, nb);
 
-    double nar[order - 1], nbr[order - 1];
+    double nar[order - 1] = {0.0}, nbr[order - 1] = {0.0};
     TacsLagrangeShapeFunction<order - 1>(pt[0], ty_knots_reduced, nar);
     TacsLagrangeShapeFunction<order - 1>(pt[1], ty_knots_reduced, nbr);
 
@@ -618,7 +624,7 @@ class TACSShellQuadBasis {
   /*
     Get the number of tying points associated with each field
   */
-  static inline int getNumTyingPoints(const int field) {
+  static TACS_SHELL_CONSTEXPR int getNumTyingPoints(const int field) {
     if (field == TACS_SHELL_G11_COMPONENT) {
       return NUM_G11_TYING_POINTS;
     } else if (field == TACS_SHELL_G22_COMPONENT) {
@@ -648,13 +654,13 @@ class TACSShellQuadBasis {
     @param ety The strain computed at the tying points
     @param gty The interpolated tying strain
   */
-  static inline void interpTyingStrain(const double pt[],
-                                       const TacsScalar ety[],
-                                       TacsScalar gty[]) {
+  static TACS_SHELL_CONSTEXPR void interpTyingStrain(const double pt[],
+                                                     const TacsScalar ety[],
+                                                     TacsScalar gty[]) {
     const int index[] = {0, 3, 1, 4, 2};
     const int num_tying_fields = 5;
 
-    double N[NUM_TYING_POINTS];
+    double N[NUM_TYING_POINTS] = {0.0};
     evalTyingInterp(pt, N);
 
     const double *N0 = N;
@@ -7,6 +7,22 @@
 #include "TACSLagrangeInterpolation.h"
 #include "TACSTriangleQuadrature.h"
 
+/*
+  The quadrature and basis evaluation routines below can run at
+  compile time to build constant interpolation tables. The relaxed
+  constexpr rules that permit loops require C++14, and the routines
+  operate on real-valued scalars only, so the constexpr qualifier is
+  applied when both conditions hold and the routines fall back to
+  plain inline functions otherwise.
+*/
+#if __cplusplus >= 201402L && !defined(TACS_USE_COMPLEX) && \
+    !defined(TACS_USE_DUAL)
+#define TACS_SHELL_CONSTEXPR_TABLES
+#define TACS_SHELL_CONSTEXPR constexpr
+#else
+#define TACS_SHELL_CONSTEXPR inline
+#endif
+
 /**
   Defines the quadrature over both the face and quadrature
 */
@@ -15,11 +31,11 @@ class TACSQuadLinearQuadrature {
   static const int NUM_QUADRATURE_POINTS = 4;
 
   static int getNumParameters() { return 2; }
-  static int getNumQuadraturePoints() { return 4; }
+  static TACS_SHELL_CONSTEXPR int getNumQuadraturePoints() { return 4; }
   static double getQuadratureWeight(int n) {
     return TacsGaussQuadWts2[n % 2] * TacsGaussQuadWts2[n / 2];
   }
-  static double getQuadraturePoint(int n, double pt[]) {
+  static TACS_SHELL_CONSTEXPR double getQuadraturePoint(int n, double pt[]) {
     pt[0] = TacsGaussQuadPts2[n % 2];
     pt[1] = TacsGaussQuadPts2[n / 2];
 
@@ -64,11 +80,11 @@ class TACSQuadQuadraticQuadrature {
   static const int NUM_QUADRATURE_POINTS = 9;
 
   static int getNumParameters() { return 2; }
-  static int getNumQuadraturePoints() { return 9; }
+  static TACS_SHELL_CONSTEXPR int getNumQuadraturePoints() { return 9; }
   static double getQuadratureWeight(int n) {
     return TacsGaussQuadWts3[n % 3] * TacsGaussQuadWts3[n / 3];
   }
-  static double getQuadraturePoint(int n, double pt[]) {
+  static TACS_SHELL_CONSTEXPR double getQuadraturePoint(int n, double pt[]) {
     pt[0] = TacsGaussQuadPts3[n % 3];
     pt[1] = TacsGaussQuadPts3[n / 3];
 
@@ -113,11 +129,11 @@ class TACSQuadCubicQuadrature {
   static const int NUM_QUADRATURE_POINTS = 16;
 
   static int getNumParameters() { return 2; }
-  static int getNumQuadraturePoints() { return 16; }
+  static TACS_SHELL_CONSTEXPR int getNumQuadraturePoints() { return 16; }
   static double getQuadratureWeight(int n) {
     return TacsGaussQuadWts4[n % 4] * TacsGaussQuadWts4[n / 4];
   }
-  static double getQuadraturePoint(int n, double pt[]) {
+  static TACS_SHELL_CONSTEXPR double getQuadraturePoint(int n, double pt[]) {
     pt[0] = TacsGaussQuadPts4[n % 4];
     pt[1] = TacsGaussQuadPts4[n / 4];
 
@@ -162,9 +178,9 @@ class TACSTriLinearQuadrature {
   static const int NUM_QUADRATURE_POINTS = 3;
 
   static int getNumParameters() { return 2; }
-  static int getNumQuadraturePoints() { return 3; }
+  static TACS_SHELL_CONSTEXPR int getNumQuadraturePoints() { return 3; }
   static double getQuadratureWeight(int n) { return TacsTriangleWts3[n]; }
-  static double getQuadraturePoint(int n, double pt[]) {
+  static TACS_SHELL_CONSTEXPR double getQuadraturePoint(int n, double pt[]) {
     pt[0] = TacsTrianglePts3[2 * n];
     pt[1] = TacsTrianglePts3[2 * n + 1];
 
@@ -208,9 +224,9 @@ class TACSTriQuadraticQuadrature {
   static const int NUM_QUADRATURE_POINTS = 6;
 
   static int getNumParameters() { return 2; }
-  static int getNumQuadraturePoints() { return 4; }
+  static TACS_SHELL_CONSTEXPR int getNumQuadraturePoints() { return 4; }
   static double getQuadratureWeight(int n) { return TacsTriangleWts4[n]; }
-  static double getQuadraturePoint(int n, double pt[]) {
+  static TACS_SHELL_CONSTEXPR double getQuadraturePoint(int n, double pt[]) {
     pt[0] = TacsTrianglePts4[2 * n];
     pt[1] = TacsTrianglePts4[2 * n + 1];
 
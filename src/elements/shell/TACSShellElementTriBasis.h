@@ -28,13 +28,14 @@ class TACSShellTriLinearBasis {
   }
   static ElementLayout getLayoutType() { return TACS_TRI_ELEMENT; }
 
-  static inline void computeBasis(const double pt[], double N[]) {
+  static TACS_SHELL_CONSTEXPR void computeBasis(const double pt[], double N[]) {
     N[0] = (1.0 - pt[0] - pt[1]);
     N[1] = pt[0];
     N[2] = pt[1];
   }
 
-  static inline void computeBasisGradient(const double pt[], double Nxi[]) {
+  static TACS_SHELL_CONSTEXPR void computeBasisGradient(const double pt[],
+                                                        double Nxi[]) {
     Nxi[0] = -1.0;
     Nxi[1] = -1.0;
     Nxi[2] = 1.0;
@@ -44,9 +45,10 @@ class TACSShellTriLinearBasis {
   }
 
   template <int vars_per_node, int m>
-  static void interpFields(const double pt[], const TacsScalar values[],
-                           TacsScalar field[]) {
-    double N[NUM_NODES];
+  static TACS_SHELL_CONSTEXPR void interpFields(const double pt[],
+                                                const TacsScalar values[],
+                                                TacsScalar field[]) {
+    double N[NUM_NODES] = {0.0};
     computeBasis(pt, N);
 
     for (int k = 0; k < m; k++) {
@@ -77,9 +79,9 @@ class TACSShellTriLinearBasis {
   }
 
   template <int vars_per_node, int m>
-  static void interpFieldsGrad(const double pt[], const TacsScalar values[],
-                               TacsScalar grad[]) {
-    double Nxi[2 * NUM_NODES];
+  static TACS_SHELL_CONSTEXPR void interpFieldsGrad(
+      const double pt[], const TacsScalar values[], TacsScalar grad[]) {
+    double Nxi[2 * NUM_NODES] = {0.0};
     computeBasisGradient(pt, Nxi);
 
     for (int k = 0; k < m; k++) {
@@ -288,7 +290,8 @@ class TACSShellTriLinearBasis {
   /*
     Get the tying strain component
   */
-  static inline TacsShellTyingStrainComponent getTyingField(int ty_index) {
+  static TACS_SHELL_CONSTEXPR TacsShellTyingStrainComponent getTyingField(
+      int ty_index) {
     if (ty_index == 0 || ty_index == 1) {
       // g13
       return TACS_SHELL_G13_COMPONENT;
@@ -332,9 +335,9 @@ class TACSShellTriLinearBasis {
     @param ety The strain computed at the tying points
     @param gty The interpolated tying strain
   */
-  static inline void interpTyingStrain(const double pt[],
-                                       const TacsScalar ety[],
-                                       TacsScalar gty[]) {
+  static TACS_SHELL_CONSTEXPR void interpTyingStrain(const double pt[],
+                                                     const TacsScalar ety[],
+                                                     TacsScalar gty[]) {
     // Perform the interpolation
     // cc = g23[1] - g13[0] - g23[2] + g13[2];
     TacsScalar cc = ety[2] - ety[0] - ety[3] + ety[1];
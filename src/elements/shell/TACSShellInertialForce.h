@@ -24,6 +24,8 @@ class TACSShellInertialForce : public TACSElement {
 
   const char *getObjectName() { return "TACSShellInertialForce"; }
 
+  int isConstantLoad() { return 1; }
+
   int getVarsPerNode() { return vars_per_node; }
   int getNumNodes() { return basis::NUM_NODES; }
 
@@ -24,6 +24,8 @@ class TACSShellPressure : public TACSElement {
 
   const char *getObjectName() { return "TACSShellPressure"; }
 
+  int isConstantLoad() { return 1; }
+
   int getVarsPerNode() { return vars_per_node; }
   int getNumNodes() { return basis::NUM_NODES; }
 
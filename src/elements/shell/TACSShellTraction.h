@@ -27,6 +27,8 @@ class TACSShellTraction : public TACSElement {
 
   const char *getObjectName() { return "TACSShellTraction"; }
 
+  int isConstantLoad() { return 1; }
+
   int getVarsPerNode() { return vars_per_node; }
   int getNumNodes() { return basis::NUM_NODES; }
 
@@ -3,6 +3,7 @@
 
 #include "TACSElementAlgebra.h"
 #include "TACSElementVerification.h"
+#include "TACSShellElementQuadrature.h"
 #include "TACSShellElementTransform.h"
 
 inline void TacsShellAssembleFrame(const TacsScalar Xxi[], const TacsScalar n[],
@@ -342,34 +343,62 @@ void TacsShellComputeNodeNormals(const TacsScalar Xpts[], TacsScalar fn[],
 }
 
 /**
-  Compute the displacement gradient of the constant and through-thickness
-  rate of change of the displacements.
+  Compute the transformation to local coordinates at each of the nodes
+
+  This computes the node-wise transformations that are required for the
+  drill strain computation. These depend only on the node locations, so
+  they may be computed once and re-used while the geometry is fixed.
+
+  @param transform The transformation object for the shell
+  @param Xdn The frame derivatives at each node
+  @param fn The frame normals at each node
+  @param Tn The transformation at each node
+  @param XdinvTn Computed inverse frame times transformation at each node
+*/
+template <class basis>
+void TacsShellComputeNodeTransforms(TACSShellTransform *transform,
+                                    const TacsScalar Xdn[],
+                                    const TacsScalar fn[], TacsScalar Tn[],
+                                    TacsScalar XdinvTn[]) {
+  for (int i = 0; i < basis::NUM_NODES; i++) {
+    // Compute the transformation at the node
+    TacsScalar Xxi[6];
+    TacsShellExtractFrame(&Xdn[9 * i], Xxi);
+    transform->computeTransform(Xxi, &fn[3 * i], &Tn[9 * i]);
+
+    // Compute the inverse transformation
+    TacsScalar Xdinv[9];
+    inv3x3(&Xdn[9 * i], Xdinv);
+
+    // Compute XdinvT = Xdinv*T
+    mat3x3MatMult(Xdinv, &Tn[9 * i], &XdinvTn[9 * i]);
+  }
+}
+
+/**
+  Compute the Jacobian transformation products at a quadrature point
+
+  This computes the geometry-dependent part of the displacement gradient
+  computation. The resulting products XdinvT and XdinvzT depend only on
+  the node locations, so they may be computed once and re-used while the
+  geometry is fixed.
+
+  This variant takes the interpolated normal derivatives n,xi as an
+  input so that the basis interpolation may be batched over all of the
+  quadrature points before the pointwise algebra is performed. The
+  templated variant below interpolates n,xi at a single point.
 
-  @param pt The parametric point
-  @param Xpts The node locations for the element
-  @param vars The element variables
-  @param fn The frame normal directions at each node
-  @param d The director field at each node
   @param Xxi The in-plane coordinate derivatives
   @param n0 The interpolated frame normal direction
+  @param nxi The interpolated frame normal derivatives
   @param T The transformation to local coordinates
   @param XdinvT Product of inverse of the Jacobian trans. and T
   @param XdinvzT Product of z-derivative of Jac. trans. inv. and T
-  @param u0x Derivative of the displacement in the local x coordinates
-  @param u1x Derivative of the through-thickness disp. in local x coordinates
+  @return The determinant of the Jacobian transformation
 */
-template <int vars_per_node, class basis>
-TacsScalar TacsShellComputeDispGrad(const double pt[], const TacsScalar Xpts[],
-                                    const TacsScalar vars[],
-                                    const TacsScalar fn[], const TacsScalar d[],
-                                    const TacsScalar Xxi[],
-                                    const TacsScalar n0[], const TacsScalar T[],
-                                    TacsScalar XdinvT[], TacsScalar XdinvzT[],
-                                    TacsScalar u0x[], TacsScalar u1x[]) {
-  // Compute n,xi = [dn/dxi1; dn/dxi2]
-  TacsScalar nxi[6];
-  basis::template interpFieldsGrad<3, 3>(pt, fn, nxi);
-
+inline TacsScalar TacsShellComputeFrameTransforms(
+    const TacsScalar Xxi[], const TacsScalar n0[], const TacsScalar nxi[],
+    const TacsScalar T[], TacsScalar XdinvT[], TacsScalar XdinvzT[]) {
   // Assemble the terms Xd = [Xxi; n] and Xdz
   TacsScalar Xd[9], Xdz[9];
   TacsShellAssembleFrame(Xxi, n0, Xd);
@@ -392,16 +421,60 @@ TacsScalar TacsShellComputeDispGrad(const double pt[], const TacsScalar Xpts[],
   // Compute Xdinvz = -Xdinv*Xdz*Xdinv*T
   mat3x3MatMult(negXdinvXdz, XdinvT, XdinvzT);
 
-  // Compute the director field and the gradient of the director
-  // field at the specified point
-  TacsScalar d0[3], d0xi[6];
-  basis::template interpFields<3, 3>(pt, d, d0);
-  basis::template interpFieldsGrad<3, 3>(pt, d, d0xi);
+  return detXd;
+}
 
-  // Compute the gradient of the displacement solution at the quadrature points
-  TacsScalar u0xi[6];
-  basis::template interpFieldsGrad<vars_per_node, 3>(pt, vars, u0xi);
+template <class basis>
+TacsScalar TacsShellComputeFrameTransforms(
+    const double pt[], const TacsScalar Xxi[], const TacsScalar fn[],
+    const TacsScalar n0[], const TacsScalar T[], TacsScalar XdinvT[],
+    TacsScalar XdinvzT[]) {
+  // Compute n,xi = [dn/dxi1; dn/dxi2]
+  TacsScalar nxi[6];
+  basis::template interpFieldsGrad<3, 3>(pt, fn, nxi);
+
+  return TacsShellComputeFrameTransforms(Xxi, n0, nxi, T, XdinvT, XdinvzT);
+}
 
+/**
+  Compute the displacement gradient of the constant and through-thickness
+  rate of change of the displacements.
+
+  @param pt The parametric point
+  @param Xpts The node locations for the element
+  @param vars The element variables
+  @param fn The frame normal directions at each node
+  @param d The director field at each node
+  @param Xxi The in-plane coordinate derivatives
+  @param n0 The interpolated frame normal direction
+  @param T The transformation to local coordinates
+  @param XdinvT Product of inverse of the Jacobian trans. and T
+  @param XdinvzT Product of z-derivative of Jac. trans. inv. and T
+  @param u0x Derivative of the displacement in the local x coordinates
+  @param u1x Derivative of the through-thickness disp. in local x coordinates
+*/
+/**
+  Compute the displacement gradient from interpolated solution
+  quantities.
+
+  This performs only the pointwise algebra of the displacement
+  gradient computation: the displacement derivatives, the director and
+  the director derivatives are passed in as inputs so that all of the
+  basis interpolation may be batched over the quadrature points.
+
+  @param u0xi The interpolated displacement derivatives
+  @param d0 The interpolated director field
+  @param d0xi The interpolated director derivatives
+  @param T The transformation to local coordinates
+  @param XdinvT Product of inverse of the Jacobian trans. and T
+  @param XdinvzT Product of z-derivative of Jac. trans. inv. and T
+  @param u0x Derivative of the displacement in the local x coordinates
+  @param u1x Derivative of the through-thickness disp. in local x coordinates
+*/
+inline void TacsShellComputeDispGradFromInterp(
+    const TacsScalar u0xi[], const TacsScalar d0[], const TacsScalar d0xi[],
+    const TacsScalar T[], const TacsScalar XdinvT[], const TacsScalar XdinvzT[],
+    TacsScalar u0x[], TacsScalar u1x[]) {
   // Compute the derivative u0,x
   TacsShellAssembleFrame(u0xi, d0, u0x);  // Use u0x to store [u0,xi; d0]
 
@@ -416,10 +489,75 @@ TacsScalar TacsShellComputeDispGrad(const double pt[], const TacsScalar Xpts[],
   // u0x = T^{T}*u0d*Xdinv*T
   mat3x3MatMult(u0x, XdinvT, tmp);
   mat3x3TransMatMult(T, tmp, u0x);
+}
+
+template <int vars_per_node, class basis>
+TacsScalar TacsShellComputeDispGrad(const double pt[], const TacsScalar Xpts[],
+                                    const TacsScalar vars[],
+                                    const TacsScalar fn[], const TacsScalar d[],
+                                    const TacsScalar Xxi[],
+                                    const TacsScalar n0[], const TacsScalar T[],
+                                    TacsScalar XdinvT[], TacsScalar XdinvzT[],
+                                    TacsScalar u0x[], TacsScalar u1x[]) {
+  // Compute the geometry-dependent transformation products
+  TacsScalar detXd = TacsShellComputeFrameTransforms<basis>(pt, Xxi, fn, n0, T,
+                                                            XdinvT, XdinvzT);
+
+  // Compute the director field and the gradient of the director
+  // field at the specified point
+  TacsScalar d0[3], d0xi[6];
+  basis::template interpFields<3, 3>(pt, d, d0);
+  basis::template interpFieldsGrad<3, 3>(pt, d, d0xi);
+
+  // Compute the gradient of the displacement solution at the quadrature points
+  TacsScalar u0xi[6];
+  basis::template interpFieldsGrad<vars_per_node, 3>(pt, vars, u0xi);
+
+  // Compute u0x and u1x from the interpolated quantities
+  TacsShellComputeDispGradFromInterp(u0xi, d0, d0xi, T, XdinvT, XdinvzT, u0x,
+                                     u1x);
 
   return detXd;
 }
 
+/**
+  Compute the displacement gradient from pre-computed transformations
+
+  This version of the displacement gradient computation takes the
+  Jacobian transformation products computed by
+  TacsShellComputeFrameTransforms() as inputs, so that only the
+  state-variable-dependent part of the computation is performed.
+
+  @param pt The parametric point
+  @param vars The element variables
+  @param d The director field at each node
+  @param T The transformation to local coordinates
+  @param XdinvT Product of inverse of the Jacobian trans. and T
+  @param XdinvzT Product of z-derivative of Jac. trans. inv. and T
+  @param u0x Derivative of the displacement in the local x coordinates
+  @param u1x Derivative of the through-thickness disp. in local x coordinates
+*/
+template <int vars_per_node, class basis>
+void TacsShellComputeDispGrad(const double pt[], const TacsScalar vars[],
+                              const TacsScalar d[], const TacsScalar T[],
+                              const TacsScalar XdinvT[],
+                              const TacsScalar XdinvzT[], TacsScalar u0x[],
+                              TacsScalar u1x[]) {
+  // Compute the director field and the gradient of the director
+  // field at the specified point
+  TacsScalar d0[3], d0xi[6];
+  basis::template interpFields<3, 3>(pt, d, d0);
+  basis::template interpFieldsGrad<3, 3>(pt, d, d0xi);
+
+  // Compute the gradient of the displacement solution at the quadrature points
+  TacsScalar u0xi[6];
+  basis::template interpFieldsGrad<vars_per_node, 3>(pt, vars, u0xi);
+
+  // Compute u0x and u1x from the interpolated quantities
+  TacsShellComputeDispGradFromInterp(u0xi, d0, d0xi, T, XdinvT, XdinvzT, u0x,
+                                     u1x);
+}
+
 /**
   Compute the displacement gradient and the derivative of the displacement
   gradient with respect to input variables
@@ -527,12 +665,28 @@ TacsScalar TacsShellComputeDispGradDeriv(
   @param res The residual
   @param dd Residual intermediate for the director field
 */
-template <int vars_per_node, class basis>
-void TacsShellAddDispGradSens(const double pt[], const TacsScalar T[],
-                              const TacsScalar XdinvT[],
-                              const TacsScalar XdinvzT[],
-                              const TacsScalar du0x[], const TacsScalar du1x[],
-                              TacsScalar res[], TacsScalar dd[]) {
+/**
+  Compute the sensitivities of the interpolated quantities from the
+  coefficients of u0x and u1x.
+
+  This is the pointwise part of TacsShellAddDispGradSens(): the
+  resulting coefficients du0xi, dd0 and dd0xi may be staged for all of
+  the quadrature points and scattered back to the element residual in
+  a single batched transpose interpolation.
+
+  @param T The transformation to local coordinates
+  @param XdinvT Product of inverse of the Jacobian trans. and T
+  @param XdinvzT Product of z-derivative of Jac. trans. inv. and T
+  @param du0x Coefficients for u0x
+  @param du1x Coefficients for u1x
+  @param du0xi Coefficients for the displacement derivatives
+  @param dd0 Coefficients for the director field
+  @param dd0xi Coefficients for the director derivatives
+*/
+inline void TacsShellDispGradSensToInterp(
+    const TacsScalar T[], const TacsScalar XdinvT[], const TacsScalar XdinvzT[],
+    const TacsScalar du0x[], const TacsScalar du1x[], TacsScalar du0xi[],
+    TacsScalar dd0[], TacsScalar dd0xi[]) {
   // Compute du0d = T*du0x*XdinvT^{T} + T*du1x*XdinvzT^{T}
   TacsScalar du0d[9], tmp[9];
   mat3x3MatTransMult(du1x, XdinvzT, tmp);
@@ -545,11 +699,20 @@ void TacsShellAddDispGradSens(const double pt[], const TacsScalar T[],
   mat3x3MatMult(T, tmp, du1d);
 
   // du0d = [du0xi; dd0]
-  TacsScalar du0xi[6], dd0[3];
   TacsShellExtractFrame(du0d, du0xi, dd0);
-
-  TacsScalar dd0xi[6];
   TacsShellExtractFrame(du1d, dd0xi);
+}
+
+template <int vars_per_node, class basis>
+void TacsShellAddDispGradSens(const double pt[], const TacsScalar T[],
+                              const TacsScalar XdinvT[],
+                              const TacsScalar XdinvzT[],
+                              const TacsScalar du0x[], const TacsScalar du1x[],
+                              TacsScalar res[], TacsScalar dd[]) {
+  // Compute the sensitivities w.r.t. the interpolated quantities
+  TacsScalar du0xi[6], dd0[3], dd0xi[6];
+  TacsShellDispGradSensToInterp(T, XdinvT, XdinvzT, du0x, du1x, du0xi, dd0,
+                                dd0xi);
 
   // Compute the director field and the gradient of the director
   // field at the specified point
@@ -692,6 +855,54 @@ void TacsShellComputeDrillStrain(TACSShellTransform *transform,
   }
 }
 
+/**
+  Compute the drilling strain penalty from pre-computed transformations
+
+  This version of the drill strain computation takes the node-wise
+  transformations computed by TacsShellComputeNodeTransforms() as
+  inputs, so that only the state-variable-dependent part of the
+  computation is performed.
+
+  @param XdinvTn Pre-computed inverse frame times transformation at each node
+  @param Tn The pre-computed transformation at each node
+  @param vars The state variable values
+  @param u0xn The derivative of the displacements at each node
+  @param Ctn The rotation matrix at each node
+  @param etn The drill strain penalty value at each node
+*/
+template <int vars_per_node, int offset, class basis, class director,
+          class model>
+void TacsShellComputeDrillStrain(const TacsScalar XdinvTn[],
+                                 const TacsScalar Tn[],
+                                 const TacsScalar vars[], TacsScalar u0xn[],
+                                 TacsScalar Ctn[], TacsScalar etn[]) {
+  for (int i = 0; i < basis::NUM_NODES; i++) {
+    double pt[2];
+    basis::getNodePoint(i, pt);
+
+    // Compute the field gradient at the node
+    TacsScalar u0xi[6];
+    basis::template interpFieldsGrad<vars_per_node, 3>(pt, vars, u0xi);
+    TacsShellAssembleFrame(u0xi, &u0xn[9 * i]);  // Use u0x to store [u0,xi; 0]
+
+    // Compute the rotation matrix at this node
+    TacsScalar C[9], tmp[9];
+    director::template computeRotationMat<vars_per_node, offset, 1>(
+        &vars[vars_per_node * i], C);
+
+    // Compute Ct = T^{T}*C*T
+    mat3x3TransMatMult(&Tn[9 * i], C, tmp);
+    mat3x3MatMult(tmp, &Tn[9 * i], &Ctn[9 * i]);
+
+    // Compute the transformation u0x = T^{T}*ueta*Xdinv*T
+    // u0x = T^{T}*u0d*Xdinv*T
+    mat3x3MatMult(&u0xn[9 * i], &XdinvTn[9 * i], tmp);
+    mat3x3TransMatMult(&Tn[9 * i], tmp, &u0xn[9 * i]);
+
+    etn[i] = director::evalDrillStrain(&u0xn[9 * i], &Ctn[9 * i]);
+  }
+}
+
 /**
   Compute the drilling strain penalty at each node
 
@@ -1059,6 +1270,238 @@ void TacsShellAddTyingDispCoupling(const double pt[], const TacsScalar T[],
   }
 }
 
+/**
+  Precomputed quadrature-point-major interpolation tables for the
+  shell element kernels.
+
+  The per-point basis routines re-evaluate the Lagrange shape
+  functions at every call, so a residual evaluation recomputes the
+  same interpolants many times per quadrature point. This class
+  tabulates the shape function values, the parametric derivatives and
+  the tying strain interpolants at every quadrature point of the
+  quadrature scheme, and provides batched routines that evaluate (or
+  scatter) the interpolation at all of the quadrature points of one
+  element in a single pass. The batched routines are small
+  matrix-matrix products between the tables and the nodal values, with
+  the outputs stored quadrature-point-major so that the pointwise
+  physics reads each point's values contiguously.
+
+  The tables are built once per (quadrature, basis) instantiation
+  through the public basis interface by interpolating unit nodal
+  vectors, so the same implementation works for any basis type. When
+  the basis evaluation routines are constexpr (see
+  TACSShellElementQuadrature.h) the construction runs at compile time
+  and the tables become read-only constants.
+*/
+template <class quadrature, class basis>
+class TACSShellQuadptInterp {
+ public:
+  // Upper bound on the number of quadrature points used to size the
+  // static tables. The actual number of points is set from
+  // quadrature::getNumQuadraturePoints().
+  static const int MAX_QUAD_PTS = quadrature::NUM_QUADRATURE_POINTS;
+  static const int NUM_NODES = basis::NUM_NODES;
+  static const int NUM_TYING_POINTS = basis::NUM_TYING_POINTS;
+
+  /*
+    Get the interpolation tables for this quadrature/basis pair. When
+    the basis evaluation routines are constexpr the tables are
+    constant-initialized and placed in read-only storage; otherwise
+    they are constructed on the first call.
+  */
+  static const TACSShellQuadptInterp *get() {
+#ifdef TACS_SHELL_CONSTEXPR_TABLES
+    static constexpr TACSShellQuadptInterp tables;
+#else
+    static TACSShellQuadptInterp tables;
+#endif
+    return &tables;
+  }
+
+  /*
+    Interpolate the field values at all of the quadrature points.
+
+    The output is stored quadrature-point-major: field[m*q + k] is the
+    k-th component of the field at quadrature point q.
+  */
+  template <int vars_per_node, int m>
+  void interpFieldsAll(const TacsScalar values[], TacsScalar field[]) const {
+    const double *n = N;
+    for (int q = 0; q < nquad; q++, field += m) {
+      for (int k = 0; k < m; k++) {
+        field[k] = 0.0;
+      }
+
+      const TacsScalar *v = values;
+      for (int i = 0; i < NUM_NODES; i++, n++, v += vars_per_node) {
+        for (int k = 0; k < m; k++) {
+          field[k] += n[0] * v[k];
+        }
+      }
+    }
+  }
+
+  /*
+    Add the transpose of the field interpolation at all of the
+    quadrature points to the nodal values
+  */
+  template <int vars_per_node, int m>
+  void addInterpFieldsTransposeAll(const TacsScalar field[],
+                                   TacsScalar values[]) const {
+    const double *n = N;
+    for (int q = 0; q < nquad; q++, field += m) {
+      TacsScalar *v = values;
+      for (int i = 0; i < NUM_NODES; i++, n++, v += vars_per_node) {
+        for (int k = 0; k < m; k++) {
+          v[k] += n[0] * field[k];
+        }
+      }
+    }
+  }
+
+  /*
+    Interpolate the field gradient at all of the quadrature points.
+
+    The output is stored quadrature-point-major: grad[2*m*q + 2*k] and
+    grad[2*m*q + 2*k + 1] are the parametric derivatives of the k-th
+    field component at quadrature point q.
+  */
+  template <int vars_per_node, int m>
+  void interpFieldsGradAll(const TacsScalar values[], TacsScalar grad[]) const {
+    const double *na = Nxia, *nb = Nxib;
+    for (int q = 0; q < nquad; q++, grad += 2 * m) {
+      for (int k = 0; k < 2 * m; k++) {
+        grad[k] = 0.0;
+      }
+
+      const TacsScalar *v = values;
+      for (int i = 0; i < NUM_NODES; i++, na++, nb++, v += vars_per_node) {
+        for (int k = 0; k < m; k++) {
+          grad[2 * k] += na[0] * v[k];
+          grad[2 * k + 1] += nb[0] * v[k];
+        }
+      }
+    }
+  }
+
+  /*
+    Add the transpose of the gradient interpolation at all of the
+    quadrature points to the nodal values
+  */
+  template <int vars_per_node, int m>
+  void addInterpFieldsGradTransposeAll(const TacsScalar grad[],
+                                       TacsScalar values[]) const {
+    const double *na = Nxia, *nb = Nxib;
+    for (int q = 0; q < nquad; q++, grad += 2 * m) {
+      TacsScalar *v = values;
+      for (int i = 0; i < NUM_NODES; i++, na++, nb++, v += vars_per_node) {
+        for (int k = 0; k < m; k++) {
+          v[k] += na[0] * grad[2 * k] + nb[0] * grad[2 * k + 1];
+        }
+      }
+    }
+  }
+
+  /*
+    Interpolate the tying strain at all of the quadrature points.
+
+    The output is stored quadrature-point-major: gty[6*q] through
+    gty[6*q + 5] store the symmetric tying strain components at
+    quadrature point q, in the same order as
+    basis::interpTyingStrain().
+  */
+  void interpTyingStrainAll(const TacsScalar ety[], TacsScalar gty[]) const {
+    const double *n = Nty;
+    for (int q = 0; q < nquad; q++, gty += 6) {
+      for (int k = 0; k < 6; k++) {
+        gty[k] = 0.0;
+      }
+
+      for (int t = 0; t < NUM_TYING_POINTS; t++, n++) {
+        gty[ty_component[t]] += n[0] * ety[t];
+      }
+    }
+  }
+
+  /*
+    Add the transpose of the tying strain interpolation at all of the
+    quadrature points to the strain at the tying points
+  */
+  void addInterpTyingStrainTransposeAll(const TacsScalar dgty[],
+                                        TacsScalar dety[]) const {
+    const double *n = Nty;
+    for (int q = 0; q < nquad; q++, dgty += 6) {
+      for (int t = 0; t < NUM_TYING_POINTS; t++, n++) {
+        dety[t] += n[0] * dgty[ty_component[t]];
+      }
+    }
+  }
+
+ private:
+  TACS_SHELL_CONSTEXPR TACSShellQuadptInterp()
+      : nquad(quadrature::getNumQuadraturePoints()),
+        N{},
+        Nxia{},
+        Nxib{},
+        Nty{},
+        ty_component{} {
+    // The location of each tying strain component within the
+    // symmetric tying strain tensor
+    const int gty_index[] = {0, 3, 1, 4, 2};
+    for (int t = 0; t < NUM_TYING_POINTS; t++) {
+      ty_component[t] = gty_index[basis::getTyingField(t)];
+    }
+
+    // Build the tables by interpolating unit nodal vectors through
+    // the public basis interface
+    for (int q = 0; q < nquad; q++) {
+      double pt[3] = {0.0, 0.0, 0.0};
+      quadrature::getQuadraturePoint(q, pt);
+
+      TacsScalar values[NUM_NODES] = {0.0};
+      for (int i = 0; i < NUM_NODES; i++) {
+        values[i] = 1.0;
+
+        TacsScalar f = 0.0, g[2] = {0.0, 0.0};
+        basis::template interpFields<1, 1>(pt, values, &f);
+        basis::template interpFieldsGrad<1, 1>(pt, values, g);
+        N[NUM_NODES * q + i] = TacsRealPart(f);
+        Nxia[NUM_NODES * q + i] = TacsRealPart(g[0]);
+        Nxib[NUM_NODES * q + i] = TacsRealPart(g[1]);
+
+        values[i] = 0.0;
+      }
+
+      TacsScalar ety[NUM_TYING_POINTS] = {0.0};
+      for (int t = 0; t < NUM_TYING_POINTS; t++) {
+        ety[t] = 1.0;
+
+        // The unit tying strain contributes a single non-zero entry
+        // at the component for this tying point
+        TacsScalar gty[6] = {0.0};
+        basis::interpTyingStrain(pt, ety, gty);
+        Nty[NUM_TYING_POINTS * q + t] = TacsRealPart(gty[ty_component[t]]);
+
+        ety[t] = 0.0;
+      }
+    }
+  }
+
+  // The number of quadrature points
+  int nquad;
+
+  // The shape function values and parametric derivatives at each
+  // quadrature point
+  double N[MAX_QUAD_PTS * NUM_NODES];
+  double Nxia[MAX_QUAD_PTS * NUM_NODES];
+  double Nxib[MAX_QUAD_PTS * NUM_NODES];
+
+  // The tying strain interpolants at each quadrature point and the
+  // tying strain tensor entry for each tying point
+  double Nty[MAX_QUAD_PTS * NUM_TYING_POINTS];
+  int ty_component[NUM_TYING_POINTS];
+};
+
 /*
   Test the implementation of the shell terms for a given basis
 */
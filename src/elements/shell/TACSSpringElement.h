@@ -61,6 +61,9 @@ class TACSSpringElement : public TACSElement {
                    const TacsScalar ddvars[], TacsScalar res[],
                    TacsScalar mat[]);
 
+  // The Jacobian is independent of the element states
+  int isConstantJacobian() { return 1; }
+
   void getMatType(ElementMatrixType matType, int elemIndex, double time,
                   const TacsScalar Xpts[], const TacsScalar vars[],
                   TacsScalar mat[]);
@@ -15,6 +15,7 @@
 #include "DisplacementIntegral.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   The context for the TACSDisplacementIntegral function
@@ -82,8 +83,7 @@ void TACSDisplacementIntegral::initEvaluation(EvaluationType ftype) {
   Reduce the function values across all MPI processes
 */
 void TACSDisplacementIntegral::finalEvaluation(EvaluationType ftype) {
-  TacsScalar temp = value;
-  MPI_Allreduce(&temp, &value, 1, TACS_MPI_TYPE, MPI_SUM, tacs->getMPIComm());
+  TacsScalarAllreduce(tacs->getMPIComm(), &value, 1);
 }
 
 /*
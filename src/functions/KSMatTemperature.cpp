@@ -17,6 +17,7 @@
 #include "CoupledThermoPlaneStressStiffness.h"
 #include "CoupledThermoSolidStiffness.h"
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   The context for the TACSKSTemperature function
@@ -153,8 +154,7 @@ void TACSKSMatTemperature::finalEvaluation(EvaluationType ftype) {
     }
   } else {
     // Find the sum of the ks contributions from all processes
-    TacsScalar temp = ksSum;
-    MPI_Allreduce(&temp, &ksSum, 1, TACS_MPI_TYPE, MPI_SUM, tacs->getMPIComm());
+    TacsScalarAllreduce(tacs->getMPIComm(), &ksSum, 1);
 
     // Compute the P-norm quantity if needed
     invPnorm = 0.0;
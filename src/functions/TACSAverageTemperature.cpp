@@ -19,6 +19,7 @@
 #include "TACSAverageTemperature.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   Initialize the TACSAverageTemperature class properties
@@ -60,10 +61,7 @@ void TACSAverageTemperature::initEvaluation(EvaluationType ftype) {
 */
 void TACSAverageTemperature::finalEvaluation(EvaluationType ftype) {
   // Distribute the values of the KS function computed on this domain
-  TacsScalar result = 0.0;
-  MPI_Allreduce(&integral_temp, &result, 1, TACS_MPI_TYPE, MPI_SUM,
-                assembler->getMPIComm());
-  integral_temp = result;
+  TacsScalarAllreduce(assembler->getMPIComm(), &integral_temp, 1);
 }
 
 /*
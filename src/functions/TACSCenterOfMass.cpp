@@ -19,6 +19,7 @@
 #include "TACSCenterOfMass.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   Allocate the structural mass function
@@ -65,12 +66,8 @@ void TACSCenterOfMass::initEvaluation(EvaluationType ftype) {
   Sum the mass across all MPI processes
 */
 void TACSCenterOfMass::finalEvaluation(EvaluationType ftype) {
-  TacsScalar temp = totalMass;
-  MPI_Allreduce(&temp, &totalMass, 1, TACS_MPI_TYPE, MPI_SUM,
-                assembler->getMPIComm());
-  temp = massMoment;
-  MPI_Allreduce(&temp, &massMoment, 1, TACS_MPI_TYPE, MPI_SUM,
-                assembler->getMPIComm());
+  TacsScalarAllreduce(assembler->getMPIComm(), &totalMass, 1);
+  TacsScalarAllreduce(assembler->getMPIComm(), &massMoment, 1);
 }
 
 /*
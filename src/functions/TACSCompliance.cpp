@@ -19,6 +19,7 @@
 #include "TACSCompliance.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   Initialize the Compliance class properties
@@ -58,9 +59,7 @@ void TACSCompliance::initEvaluation(EvaluationType ftype) { compliance = 0.0; }
 */
 void TACSCompliance::finalEvaluation(EvaluationType ftype) {
   // Distribute the values of the KS function computed on this domain
-  TacsScalar temp = compliance;
-  MPI_Allreduce(&temp, &compliance, 1, TACS_MPI_TYPE, MPI_SUM,
-                assembler->getMPIComm());
+  TacsScalarAllreduce(assembler->getMPIComm(), &compliance, 1);
 }
 
 /*
@@ -19,6 +19,7 @@
 #include "TACSEnclosedVolume.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   Allocate the enclosed volume function
@@ -56,9 +57,7 @@ void TACSEnclosedVolume::initEvaluation(EvaluationType ftype) {
   Sum the volume across all MPI processes
 */
 void TACSEnclosedVolume::finalEvaluation(EvaluationType ftype) {
-  TacsScalar temp = totalVol;
-  MPI_Allreduce(&temp, &totalVol, 1, TACS_MPI_TYPE, MPI_SUM,
-                assembler->getMPIComm());
+  TacsScalarAllreduce(assembler->getMPIComm(), &totalVol, 1);
 }
 
 /*
@@ -74,6 +74,13 @@ enum TACSFunction::StageType TACSFunction::getStageType() {
   return funcStageType;
 }
 
+/*
+  Set the type of function
+*/
+void TACSFunction::setStageType(enum StageType _funcStageType) {
+  funcStageType = _funcStageType;
+}
+
 /*
   Overwrite the domain in the function with a new set of elements.
   This reallocates the existing array if it is not long enough.
@@ -253,6 +253,17 @@ class TACSFunction : public TACSObject {
   }
 
  protected:
+  /**
+     Set the stage type of this function
+
+     This allows a function to switch between the single-stage and
+     two-stage evaluation strategies, for instance when an aggregation
+     function implements a streaming single-pass evaluation.
+
+     @param _funcStageType The enum type of evaluation stage strategy
+  */
+  void setStageType(StageType _funcStageType);
+
   TACSAssembler *assembler;
 
  private:
@@ -15,6 +15,7 @@
 #include "TACSHeatFlux.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 #include "TACSElementAlgebra.h"
 
 TACSHeatFlux::TACSHeatFlux(TACSAssembler *_assembler, int *elem_index,
@@ -69,9 +70,7 @@ void TACSHeatFlux::initEvaluation(EvaluationType ftype) { value = 0.0; }
   Reduce the function values across all MPI processes
 */
 void TACSHeatFlux::finalEvaluation(EvaluationType ftype) {
-  TacsScalar temp = value;
-  MPI_Allreduce(&temp, &value, 1, TACS_MPI_TYPE, MPI_SUM,
-                assembler->getMPIComm());
+  TacsScalarAllreduce(assembler->getMPIComm(), &value, 1);
 }
 
 /*
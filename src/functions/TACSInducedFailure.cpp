@@ -15,6 +15,7 @@
 #include "TACSInducedFailure.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   Initialize the TACSInducedFailure class properties
@@ -27,6 +28,7 @@ TACSInducedFailure::TACSInducedFailure(TACSAssembler *_assembler, double _P)
   // Set the penalization information
   P = _P;
   normType = EXPONENTIAL;
+  singlePass = 0;
 
   // Initialize values
   maxFail = -1e20;
@@ -61,6 +63,43 @@ void TACSInducedFailure::setInducedType(enum InducedNormType type) {
   normType = type;
 }
 
+/*
+  Use a single-pass streaming evaluation of the aggregate.
+
+  This maintains a running maximum and rescales the partial numerator
+  and denominator whenever a new maximum is encountered, so the
+  maximum and the sums are computed in one sweep over the elements
+  instead of two.
+*/
+void TACSInducedFailure::setSinglePassEvaluation(int flag) {
+  singlePass = flag;
+  if (singlePass) {
+    setStageType(TACSFunction::SINGLE_STAGE);
+  } else {
+    setStageType(TACSFunction::TWO_STAGE);
+  }
+}
+
+/*
+  Rescale the partial numerator and denominator from the maximum
+  oldMax to the new maximum newMax
+*/
+void TACSInducedFailure::rescaleSums(TacsScalar oldMax, TacsScalar newMax) {
+  if (failNumer != 0.0 || failDenom != 0.0) {
+    if (normType == POWER || normType == DISCRETE_POWER ||
+        normType == POWER_SQUARED || normType == DISCRETE_POWER_SQUARED) {
+      TacsScalar ratio = oldMax / newMax;
+      TacsScalar fp = pow(fabs(TacsRealPart(ratio)), P);
+      failNumer *= ratio * fp;
+      failDenom *= fp;
+    } else {
+      TacsScalar efp = exp(P * (oldMax - newMax));
+      failNumer *= (oldMax / newMax) * efp;
+      failDenom *= efp;
+    }
+  }
+}
+
 /*
   Retrieve the function name
 */
@@ -81,6 +120,11 @@ void TACSInducedFailure::initEvaluation(EvaluationType ftype) {
   if (ftype == TACSFunction::INITIALIZE) {
     maxFail = -1e20;
   } else if (ftype == TACSFunction::INTEGRATE) {
+    // In the single-pass evaluation the maximum is computed in the
+    // same sweep as the sums
+    if (singlePass) {
+      maxFail = -1e20;
+    }
     failNumer = 0.0;
     failDenom = 0.0;
   }
@@ -96,15 +140,25 @@ void TACSInducedFailure::finalEvaluation(EvaluationType ftype) {
     MPI_Allreduce(&temp, &maxFail, 1, TACS_MPI_TYPE, TACS_MPI_MAX,
                   assembler->getMPIComm());
   } else if (ftype == TACSFunction::INTEGRATE) {
+    if (singlePass) {
+      // Determine the global maximum, then rescale the local partial
+      // sums from the local maximum to the global one before the sums
+      // are reduced
+      TacsScalar localMax = maxFail;
+      MPI_Allreduce(&localMax, &maxFail, 1, TACS_MPI_TYPE, TACS_MPI_MAX,
+                    assembler->getMPIComm());
+      rescaleSums(localMax, maxFail);
+    }
+
     // Find the sum of the ks contributions from all processes
-    TacsScalar in[2], out[2];
-    in[0] = failNumer;
-    in[1] = failDenom;
+    TacsScalar sums[2];
+    sums[0] = failNumer;
+    sums[1] = failDenom;
 
-    MPI_Allreduce(in, out, 2, TACS_MPI_TYPE, MPI_SUM, assembler->getMPIComm());
+    TacsScalarAllreduce(assembler->getMPIComm(), sums, 2);
 
-    failNumer = out[0];
-    failDenom = out[1];
+    failNumer = sums[0];
+    failDenom = sums[1];
   }
 }
 
@@ -135,6 +189,13 @@ void TACSInducedFailure::elementWiseEval(
           maxFail = fail;
         }
       } else {
+        // Update the running maximum and rescale the partial sums to
+        // the new maximum before the contribution is added
+        if (singlePass && TacsRealPart(fail) > TacsRealPart(maxFail)) {
+          rescaleSums(maxFail, fail);
+          maxFail = fail;
+        }
+
         if (normType == POWER) {
           TacsScalar fp = pow(fabs(fail / maxFail), P);
           failNumer += scale * weight * detXd * (fail / maxFail) * fp;
@@ -86,6 +86,11 @@ class TACSInducedFailure : public TACSFunction {
   double getParameter();
   void setInducedType(InducedNormType _norm_type);
 
+  // Use a single-pass streaming evaluation instead of the two-stage
+  // max-then-sum evaluation
+  // ---------------------------------------------------------------
+  void setSinglePassEvaluation(int flag);
+
   // Set the value of the failure offset for numerical stability
   // -----------------------------------------------------------
   void setMaxFailOffset(TacsScalar _maxFail) { maxFail = _maxFail; }
@@ -140,6 +145,9 @@ class TACSInducedFailure : public TACSFunction {
                          const TacsScalar ddvars[], TacsScalar fXptSens[]);
 
  private:
+  // Rescale the partial sums to a new maximum value
+  void rescaleSums(TacsScalar oldMax, TacsScalar newMax);
+
   // The type of norm to evaluate
   InducedNormType normType;
 
@@ -149,6 +157,10 @@ class TACSInducedFailure : public TACSFunction {
   // The P in the P-norm
   double P;
 
+  // Evaluate the maximum and the rescaled sums in a single pass over
+  // the elements
+  int singlePass;
+
   // The name of the function
   static const char *funcName;
 };
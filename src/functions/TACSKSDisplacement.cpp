@@ -19,6 +19,7 @@
 #include "TACSKSDisplacement.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   Initialize the TACSKSDisplacement class properties
@@ -110,9 +111,7 @@ void TACSKSDisplacement::finalEvaluation(EvaluationType ftype) {
                   assembler->getMPIComm());
   } else {
     // Find the sum of the ks contributions from all processes
-    TacsScalar temp = ksDispSum;
-    MPI_Allreduce(&temp, &ksDispSum, 1, TACS_MPI_TYPE, MPI_SUM,
-                  assembler->getMPIComm());
+    TacsScalarAllreduce(assembler->getMPIComm(), &ksDispSum, 1);
 
     // Compute the P-norm quantity if needed
     invPnorm = 0.0;
@@ -19,6 +19,7 @@
 #include "TACSKSFailure.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   Initialize the TACSKSFailure class properties
@@ -31,6 +32,7 @@ TACSKSFailure::TACSKSFailure(TACSAssembler *_assembler, double _ksWeight,
   alpha = _alpha;
   safetyFactor = _safetyFactor;
   ksType = CONTINUOUS;
+  singlePass = 0;
 
   // Initialize the maximum failure value and KS sum to default values
   // that will be overwritten later.
@@ -51,6 +53,22 @@ const char *TACSKSFailure::funcName = "TACSKSFailure";
 */
 void TACSKSFailure::setKSFailureType(enum KSFailureType type) { ksType = type; }
 
+/*
+  Use a single-pass streaming evaluation of the aggregate.
+
+  This maintains a running maximum and rescales the partial sum
+  whenever a new maximum is encountered, so the maximum and the sum
+  are computed in one sweep over the elements instead of two.
+*/
+void TACSKSFailure::setSinglePassEvaluation(int flag) {
+  singlePass = flag;
+  if (singlePass) {
+    setStageType(TACSFunction::SINGLE_STAGE);
+  } else {
+    setStageType(TACSFunction::TWO_STAGE);
+  }
+}
+
 /*
   Retrieve the KS aggregation weight
 */
@@ -88,6 +106,11 @@ void TACSKSFailure::initEvaluation(EvaluationType ftype) {
   if (ftype == TACSFunction::INITIALIZE) {
     maxFail = -1e20;
   } else if (ftype == TACSFunction::INTEGRATE) {
+    // In the single-pass evaluation the maximum is computed in the
+    // same sweep as the sum
+    if (singlePass) {
+      maxFail = -1e20;
+    }
     ksFailSum = 0.0;
   }
 }
@@ -102,10 +125,23 @@ void TACSKSFailure::finalEvaluation(EvaluationType ftype) {
     MPI_Allreduce(&temp, &maxFail, 1, TACS_MPI_TYPE, TACS_MPI_MAX,
                   assembler->getMPIComm());
   } else {
+    if (singlePass) {
+      // Determine the global maximum, then rescale the local partial
+      // sum from the local maximum to the global one before the sum
+      // is reduced
+      TacsScalar localMax = maxFail;
+      MPI_Allreduce(&localMax, &maxFail, 1, TACS_MPI_TYPE, TACS_MPI_MAX,
+                    assembler->getMPIComm());
+
+      if (ksType == DISCRETE || ksType == CONTINUOUS) {
+        ksFailSum *= exp(ksWeight * (localMax - maxFail));
+      } else if (ksFailSum != 0.0) {
+        ksFailSum *= pow(fabs(TacsRealPart(localMax / maxFail)), ksWeight);
+      }
+    }
+
     // Find the sum of the ks contributions from all processes
-    TacsScalar temp = ksFailSum;
-    MPI_Allreduce(&temp, &ksFailSum, 1, TACS_MPI_TYPE, MPI_SUM,
-                  assembler->getMPIComm());
+    TacsScalarAllreduce(assembler->getMPIComm(), &ksFailSum, 1);
 
     // Compute the P-norm quantity if needed
     invPnorm = 0.0;
@@ -148,6 +184,17 @@ void TACSKSFailure::elementWiseEval(EvaluationType ftype, int elemIndex,
           maxFail = fail;
         }
       } else {
+        // Update the running maximum and rescale the partial sum to
+        // the new maximum before the contribution is added
+        if (singlePass && TacsRealPart(fail) > TacsRealPart(maxFail)) {
+          if (ksType == DISCRETE || ksType == CONTINUOUS) {
+            ksFailSum *= exp(ksWeight * (maxFail - fail));
+          } else if (ksFailSum != 0.0) {
+            ksFailSum *= pow(fabs(TacsRealPart(maxFail / fail)), ksWeight);
+          }
+          maxFail = fail;
+        }
+
         // Add the failure load to the sum
         if (ksType == DISCRETE) {
           TacsScalar fexp = exp(ksWeight * (fail - maxFail));
@@ -71,6 +71,11 @@ class TACSKSFailure : public TACSFunction {
   double getParameter();
   void setParameter(double _ksWeight);
 
+  // Use a single-pass streaming evaluation instead of the two-stage
+  // max-then-sum evaluation
+  // ---------------------------------------------------------------
+  void setSinglePassEvaluation(int flag);
+
   // Set the value of the failure offset for numerical stability
   // -----------------------------------------------------------
   void setMaxFailOffset(TacsScalar _maxFail) { maxFail = _maxFail; }
@@ -142,6 +147,10 @@ class TACSKSFailure : public TACSFunction {
   // The safety factor
   double safetyFactor;
 
+  // Evaluate the maximum and the rescaled sum in a single pass over
+  // the elements
+  int singlePass;
+
   // The name of the function
   static const char *funcName;
 
@@ -19,6 +19,7 @@
 #include "TACSKSTemperature.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   Initialize the TACSKSTemperature class properties
@@ -30,6 +31,7 @@ TACSKSTemperature::TACSKSTemperature(TACSAssembler *_assembler,
   ksWeight = _ksWeight;
   alpha = _alpha;
   ksType = CONTINUOUS;
+  singlePass = 0;
 
   // Initialize the maximum temperature value and KS sum to default values
   // that will be overwritten later.
@@ -52,6 +54,22 @@ void TACSKSTemperature::setKSTemperatureType(enum KSTemperatureType type) {
   ksType = type;
 }
 
+/*
+  Use a single-pass streaming evaluation of the aggregate.
+
+  This maintains a running maximum and rescales the partial sum
+  whenever a new maximum is encountered, so the maximum and the sum
+  are computed in one sweep over the elements instead of two.
+*/
+void TACSKSTemperature::setSinglePassEvaluation(int flag) {
+  singlePass = flag;
+  if (singlePass) {
+    setStageType(TACSFunction::SINGLE_STAGE);
+  } else {
+    setStageType(TACSFunction::TWO_STAGE);
+  }
+}
+
 /*
   Retrieve the KS aggregation weight
 */
@@ -89,6 +107,11 @@ void TACSKSTemperature::initEvaluation(EvaluationType ftype) {
   if (ftype == TACSFunction::INITIALIZE) {
     maxTemp = -1e20;
   } else if (ftype == TACSFunction::INTEGRATE) {
+    // In the single-pass evaluation the maximum is computed in the
+    // same sweep as the sum
+    if (singlePass) {
+      maxTemp = -1e20;
+    }
     ksTempSum = 0.0;
   }
 }
@@ -103,10 +126,23 @@ void TACSKSTemperature::finalEvaluation(EvaluationType ftype) {
     MPI_Allreduce(&temp, &maxTemp, 1, TACS_MPI_TYPE, TACS_MPI_MAX,
                   assembler->getMPIComm());
   } else {
+    if (singlePass) {
+      // Determine the global maximum, then rescale the local partial
+      // sum from the local maximum to the global one before the sum
+      // is reduced
+      TacsScalar localMax = maxTemp;
+      MPI_Allreduce(&localMax, &maxTemp, 1, TACS_MPI_TYPE, TACS_MPI_MAX,
+                    assembler->getMPIComm());
+
+      if (ksType == DISCRETE || ksType == CONTINUOUS) {
+        ksTempSum *= exp(ksWeight * (localMax - maxTemp));
+      } else if (ksTempSum != 0.0) {
+        ksTempSum *= pow(fabs(TacsRealPart(localMax / maxTemp)), ksWeight);
+      }
+    }
+
     // Find the sum of the ks contributions from all processes
-    TacsScalar temp = ksTempSum;
-    MPI_Allreduce(&temp, &ksTempSum, 1, TACS_MPI_TYPE, MPI_SUM,
-                  assembler->getMPIComm());
+    TacsScalarAllreduce(assembler->getMPIComm(), &ksTempSum, 1);
 
     // Compute the P-norm quantity if needed
     invPnorm = 0.0;
@@ -144,6 +180,18 @@ void TACSKSTemperature::elementWiseEval(
           maxTemp = temperature;
         }
       } else {
+        // Update the running maximum and rescale the partial sum to
+        // the new maximum before the contribution is added
+        if (singlePass && TacsRealPart(temperature) > TacsRealPart(maxTemp)) {
+          if (ksType == DISCRETE || ksType == CONTINUOUS) {
+            ksTempSum *= exp(ksWeight * (maxTemp - temperature));
+          } else if (ksTempSum != 0.0) {
+            ksTempSum *=
+                pow(fabs(TacsRealPart(maxTemp / temperature)), ksWeight);
+          }
+          maxTemp = temperature;
+        }
+
         // Add the temperature to the sum
         if (ksType == DISCRETE) {
           TacsScalar fexp = exp(ksWeight * (temperature - maxTemp));
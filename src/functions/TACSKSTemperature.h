@@ -67,6 +67,11 @@ class TACSKSTemperature : public TACSFunction {
   double getParameter();
   void setParameter(double _ksWeight);
 
+  // Use a single-pass streaming evaluation instead of the two-stage
+  // max-then-sum evaluation
+  // ---------------------------------------------------------------
+  void setSinglePassEvaluation(int flag);
+
   // Set the value of the temperature offset for numerical stability
   // -----------------------------------------------------------
   void setMaxTempOffset(TacsScalar _maxTemp) { maxTemp = _maxTemp; }
@@ -135,6 +140,10 @@ class TACSKSTemperature : public TACSFunction {
   // The integral scaling value
   double alpha;
 
+  // Evaluate the maximum and the rescaled sum in a single pass over
+  // the elements
+  int singlePass;
+
   // The name of the function
   static const char *funcName;
 
@@ -19,6 +19,7 @@
 #include "TACSMomentOfInertia.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 #include "TACSElementAlgebra.h"
 
 /*
@@ -84,14 +85,9 @@ void TACSMomentOfInertia::initEvaluation(EvaluationType ftype) {
   Sum the mass/moments across all MPI processes
 */
 void TACSMomentOfInertia::finalEvaluation(EvaluationType ftype) {
-  TacsScalar temp = totalMass;
-  MPI_Allreduce(&temp, &totalMass, 1, TACS_MPI_TYPE, MPI_SUM,
-                assembler->getMPIComm());
-  TacsScalar temp2[3] = {massMoment[0], massMoment[1], massMoment[2]};
-  MPI_Allreduce(temp2, massMoment, 3, TACS_MPI_TYPE, MPI_SUM,
-                assembler->getMPIComm());
-  temp = I0;
-  MPI_Allreduce(&temp, &I0, 1, TACS_MPI_TYPE, MPI_SUM, assembler->getMPIComm());
+  TacsScalarAllreduce(assembler->getMPIComm(), &totalMass, 1);
+  TacsScalarAllreduce(assembler->getMPIComm(), massMoment, 3);
+  TacsScalarAllreduce(assembler->getMPIComm(), &I0, 1);
 }
 
 /*
@@ -19,6 +19,7 @@
 #include "TACSStructuralMass.h"
 
 #include "TACSAssembler.h"
+#include "TacsUtilities.h"
 
 /*
   Allocate the structural mass function
@@ -56,9 +57,7 @@ void TACSStructuralMass::initEvaluation(EvaluationType ftype) {
   Sum the mass across all MPI processes
 */
 void TACSStructuralMass::finalEvaluation(EvaluationType ftype) {
-  TacsScalar temp = totalMass;
-  MPI_Allreduce(&temp, &totalMass, 1, TACS_MPI_TYPE, MPI_SUM,
-                assembler->getMPIComm());
+  TacsScalarAllreduce(assembler->getMPIComm(), &totalMass, 1);
 }
 
 /*
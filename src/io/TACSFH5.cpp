@@ -18,6 +18,162 @@
 
 #include "TACSFH5.h"
 
+#include <pthread.h>
+
+// The number of rows in each independently compressed chunk of a
+// compressed zone. Each chunk can be decompressed on its own, so
+// readers can seek to a range of rows without reading the whole zone.
+static const int FH5_COMPRESS_CHUNK_ROWS = 4096;
+
+/*
+  Upper bound on the compressed size of nbytes of input
+*/
+static size_t FH5CompressBound(size_t nbytes) {
+  return nbytes + 2 * (nbytes / 255 + 1) + 2;
+}
+
+/*
+  Compress a chunk of float values into the output buffer.
+
+  The codec is designed for the smooth fields that dominate solution
+  output and uses two stages:
+
+  1. An optional lossy quantization that keeps only the leading
+  mantissa_bits of the 23-bit float mantissa. With mantissa_bits >= 23
+  the transform is the identity and the codec is lossless.
+
+  2. A byte transposition that groups the bytes of the values by
+  significance, followed by a run-length encoding of the zero bytes.
+  After quantization the low-significance byte planes are mostly zero
+  and the high-significance planes are highly repetitive, so the zero
+  runs capture most of the redundancy.
+
+  The encoded stream consists of alternating one-byte counts: a
+  literal count followed by that many literal bytes, then a zero-run
+  count, repeated until the chunk is complete.
+
+  The output buffer must be at least FH5CompressBound(4*nvals) bytes.
+
+  returns: the number of bytes written to the output
+*/
+static size_t FH5CompressChunk(const float *data, size_t nvals,
+                               int mantissa_bits, unsigned char *out) {
+  size_t nbytes = 4 * nvals;
+  unsigned char *shuffle = new unsigned char[nbytes];
+
+  // Quantize the values and transpose the bytes by significance
+  unsigned int mask = 0xFFFFFFFFu;
+  if (mantissa_bits >= 0 && mantissa_bits < 23) {
+    mask <<= (23 - mantissa_bits);
+  }
+  for (size_t i = 0; i < nvals; i++) {
+    unsigned int u;
+    memcpy(&u, &data[i], sizeof(float));
+    u &= mask;
+    shuffle[i] = (u >> 24) & 0xFF;
+    shuffle[nvals + i] = (u >> 16) & 0xFF;
+    shuffle[2 * nvals + i] = (u >> 8) & 0xFF;
+    shuffle[3 * nvals + i] = u & 0xFF;
+  }
+
+  // Run-length encode the zero bytes
+  size_t n = 0, pos = 0;
+  while (pos < nbytes) {
+    // Gather literal bytes until a run of at least two zero bytes
+    size_t lit = 0;
+    while (pos + lit < nbytes && lit < 255) {
+      if (shuffle[pos + lit] == 0 &&
+          (pos + lit + 1 == nbytes || shuffle[pos + lit + 1] == 0)) {
+        break;
+      }
+      lit++;
+    }
+    out[n] = (unsigned char)lit;
+    n++;
+    memcpy(&out[n], &shuffle[pos], lit);
+    n += lit;
+    pos += lit;
+
+    // Count the length of the zero run
+    size_t run = 0;
+    while (pos + run < nbytes && run < 255 && shuffle[pos + run] == 0) {
+      run++;
+    }
+    out[n] = (unsigned char)run;
+    n++;
+    pos += run;
+  }
+
+  delete[] shuffle;
+  return n;
+}
+
+/*
+  Decompress a chunk of nvals float values from the input stream
+*/
+static void FH5DecompressChunk(const unsigned char *in, size_t in_bytes,
+                               size_t nvals, float *data) {
+  size_t nbytes = 4 * nvals;
+  unsigned char *shuffle = new unsigned char[nbytes];
+
+  // Decode the run-length encoded stream
+  size_t n = 0, pos = 0;
+  while (pos < nbytes && n < in_bytes) {
+    size_t lit = in[n];
+    n++;
+    memcpy(&shuffle[pos], &in[n], lit);
+    n += lit;
+    pos += lit;
+
+    if (n < in_bytes && pos < nbytes) {
+      size_t run = in[n];
+      n++;
+      memset(&shuffle[pos], 0, run);
+      pos += run;
+    }
+  }
+
+  // Transpose the bytes back into the float values
+  for (size_t i = 0; i < nvals; i++) {
+    unsigned int u = (((unsigned int)shuffle[i]) << 24) |
+                     (((unsigned int)shuffle[nvals + i]) << 16) |
+                     (((unsigned int)shuffle[2 * nvals + i]) << 8) |
+                     ((unsigned int)shuffle[3 * nvals + i]);
+    memcpy(&data[i], &u, sizeof(float));
+  }
+
+  delete[] shuffle;
+}
+
+/*
+  The data for one thread compressing a subset of the chunks
+*/
+class FH5CompressCtx {
+ public:
+  int tid, num_threads, num_chunks;
+  int dim2, mantissa_bits;
+  const float *data;
+  const int *rows, *counts;
+  unsigned char **buffers;
+  size_t *sizes;
+};
+
+/*
+  Compress the chunks assigned to this thread. The chunks are
+  independent, so the threads are statically interleaved over the
+  chunk index with no synchronization.
+*/
+static void *fh5_compress_chunks(void *arg) {
+  FH5CompressCtx *ctx = static_cast<FH5CompressCtx *>(arg);
+  for (int k = ctx->tid; k < ctx->num_chunks; k += ctx->num_threads) {
+    ctx->sizes[k] =
+        FH5CompressChunk(&ctx->data[(size_t)ctx->rows[k] * ctx->dim2],
+                         (size_t)ctx->counts[k] * ctx->dim2,
+                         ctx->mantissa_bits, ctx->buffers[k]);
+  }
+  return NULL;
+}
+
 /**
    Create the FH5 object with the given communicator
 
@@ -63,13 +219,23 @@ TACSFH5File::~TACSFH5File() {
    Write the zone map to the file. This consists of a map between the
    zone numbers and the variable names.
 
+   All of the data in the file is written with the collective
+   MPI_File_write_at_all calls, so the MPI-IO layer performs two-phase
+   aggregation onto a subset of writer processes when the appropriate
+   hints are set. The optional info argument passes those hints to
+   MPI_File_open - for instance romio_cb_write, cb_nodes and
+   cb_buffer_size to control the aggregators, or striping_unit and
+   striping_factor to align the aggregated writes with the stripes of
+   a parallel file system.
+
    @param file_name the file that will be created
    @param component_names the names of the components
    @param num_components the total number of zones
+   @param info MPI-IO hints passed to the file open
    @return 0 on successs, 1 if there is an error creating the file
 */
 int TACSFH5File::createFile(const char *file_name, int num_components,
-                            char **component_names) {
+                            char **component_names, MPI_Info info) {
   if (fp) {
     int rank;
     MPI_Comm_rank(comm, &rank);
@@ -82,9 +248,8 @@ int TACSFH5File::createFile(const char *file_name, int num_components,
     char *fname = new char[slen];
     strcpy(fname, file_name);
 
-    // Open the file for writing
-    MPI_File_open(comm, fname, MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL,
-                  &fp);
+    // Open the file for writing with the supplied MPI-IO hints
+    MPI_File_open(comm, fname, MPI_MODE_WRONLY | MPI_MODE_CREATE, info, &fp);
     delete[] fname;
 
     file_for_writing = 1;
@@ -269,6 +434,246 @@ int TACSFH5File::writeZoneData(char *zone_name, char *var_names,
   return 0;
 }
 
+/**
+   Write float data to the file as independently compressed chunks.
+
+   The data is split into chunks of FH5_COMPRESS_CHUNK_ROWS rows that
+   are compressed independently, so that readers can still seek to a
+   range of rows within the zone. The zone uses the same pre-header as
+   writeZoneData, followed by the chunk count, a table of (first row,
+   row count, compressed bytes) triplets for each chunk, and then the
+   compressed chunk streams back to back.
+
+   Setting mantissa_bits < 23 discards the trailing mantissa bits of
+   each value before compression. This is lossy, but improves the
+   compression ratio considerably and is acceptable for data that is
+   only used for visualization. The default of 23 bits is lossless.
+
+   The chunks are compressed in parallel when num_threads > 1.
+
+   @param zone_name The name of the zone
+   @param var_names The comma-separated variable names
+   @param dim1 The number of local rows of data
+   @param dim2 The number of entries per row
+   @param data The local rows of float data
+   @param dim1_range The optional global row offsets for each process
+   @param mantissa_bits The number of mantissa bits to retain (0--23)
+   @param num_threads The number of threads used for compression
+   @return 1 on success, 0 if the file is not open for writing
+*/
+int TACSFH5File::writeZoneDataCompressed(char *zone_name, char *var_names,
+                                         int dim1, int dim2, float *data,
+                                         int *dim1_range, int mantissa_bits,
+                                         int num_threads) {
+  // Check the file status to ensure that it's open
+  if (!(fp && file_for_writing)) {
+    return 0;
+  }
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  int *dim_count = NULL;
+  if (!dim1_range) {
+    dim_count = new int[size + 1];
+    dim_count[0] = 0;
+    MPI_Allgather(&dim1, 1, MPI_INT, &dim_count[1], 1, MPI_INT, comm);
+
+    for (int k = 0; k < size; k++) {
+      dim_count[k + 1] += dim_count[k];
+    }
+    dim1_range = dim_count;
+  }
+  int total_dim = dim1_range[size];
+
+  // Split the local rows into fixed-size chunks
+  int local_chunks = 0;
+  if (dim1 > 0) {
+    local_chunks =
+        (dim1 + FH5_COMPRESS_CHUNK_ROWS - 1) / FH5_COMPRESS_CHUNK_ROWS;
+  }
+
+  int *rows = new int[local_chunks];
+  int *counts = new int[local_chunks];
+  unsigned char **buffers = new unsigned char *[local_chunks];
+  size_t *sizes = new size_t[local_chunks];
+  for (int k = 0; k < local_chunks; k++) {
+    rows[k] = k * FH5_COMPRESS_CHUNK_ROWS;
+    counts[k] = dim1 - rows[k];
+    if (counts[k] > FH5_COMPRESS_CHUNK_ROWS) {
+      counts[k] = FH5_COMPRESS_CHUNK_ROWS;
+    }
+    buffers[k] =
+        new unsigned char[FH5CompressBound(4 * (size_t)counts[k] * dim2)];
+    sizes[k] = 0;
+  }
+
+  // Compress the local chunks, fanning out over the threads when more
+  // than one thread is requested
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  if (num_threads > TACSThreadInfo::TACS_MAX_NUM_THREADS) {
+    num_threads = TACSThreadInfo::TACS_MAX_NUM_THREADS;
+  }
+  if (num_threads > local_chunks && local_chunks > 0) {
+    num_threads = local_chunks;
+  }
+
+  FH5CompressCtx ctx[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+  for (int t = 0; t < num_threads; t++) {
+    ctx[t].tid = t;
+    ctx[t].num_threads = num_threads;
+    ctx[t].num_chunks = local_chunks;
+    ctx[t].dim2 = dim2;
+    ctx[t].mantissa_bits = mantissa_bits;
+    ctx[t].data = data;
+    ctx[t].rows = rows;
+    ctx[t].counts = counts;
+    ctx[t].buffers = buffers;
+    ctx[t].sizes = sizes;
+  }
+
+  if (num_threads > 1) {
+    pthread_t threads[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+    for (int t = 0; t < num_threads; t++) {
+      pthread_create(&threads[t], NULL, fh5_compress_chunks, &ctx[t]);
+    }
+    for (int t = 0; t < num_threads; t++) {
+      pthread_join(threads[t], NULL);
+    }
+  } else {
+    fh5_compress_chunks(&ctx[0]);
+  }
+
+  // Gather the number of chunks on each process
+  int *chunks_per_rank = new int[size];
+  MPI_Allgather(&local_chunks, 1, MPI_INT, chunks_per_rank, 1, MPI_INT, comm);
+
+  int total_chunks = 0;
+  for (int k = 0; k < size; k++) {
+    total_chunks += chunks_per_rank[k];
+  }
+
+  // Assemble the local chunk table entries with global row numbers
+  int *ltable = new int[3 * local_chunks];
+  long long local_bytes = 0;
+  for (int k = 0; k < local_chunks; k++) {
+    ltable[3 * k] = dim1_range[rank] + rows[k];
+    ltable[3 * k + 1] = counts[k];
+    ltable[3 * k + 2] = (int)sizes[k];
+    local_bytes += sizes[k];
+  }
+
+  // Gather the chunk table onto the root process
+  int *table = NULL;
+  int *recv_counts = NULL, *displs = NULL;
+  if (rank == 0) {
+    table = new int[3 * total_chunks];
+    recv_counts = new int[size];
+    displs = new int[size];
+    displs[0] = 0;
+    for (int k = 0; k < size; k++) {
+      recv_counts[k] = 3 * chunks_per_rank[k];
+      if (k > 0) {
+        displs[k] = displs[k - 1] + recv_counts[k - 1];
+      }
+    }
+  }
+  MPI_Gatherv(ltable, 3 * local_chunks, MPI_INT, table, recv_counts, displs,
+              MPI_INT, 0, comm);
+
+  // Compute the byte offset of each process within the chunk data
+  long long *bytes_per_rank = new long long[size + 1];
+  bytes_per_rank[0] = 0;
+  MPI_Allgather(&local_bytes, 1, MPI_LONG_LONG, &bytes_per_rank[1], 1,
+                MPI_LONG_LONG, comm);
+  for (int k = 0; k < size; k++) {
+    bytes_per_rank[k + 1] += bytes_per_rank[k];
+  }
+
+  // Calculate the size of the header including the chunk table
+  size_t header_len = 5 * sizeof(int) + strlen(zone_name) + strlen(var_names) +
+                      2 + sizeof(int) * (1 + 3 * (size_t)total_chunks);
+
+  // Write the zone and variable names to the file
+  char datarep[] = "native";
+  MPI_File_set_view(fp, file_offset, MPI_CHAR, MPI_CHAR, datarep,
+                    MPI_INFO_NULL);
+
+  // Write the header for this zone just on the root processor
+  if (rank == 0) {
+    char *pre_header = new char[header_len];
+    int pre_int[5];
+    pre_int[0] = FH5_FLOAT_COMPRESSED;
+    pre_int[1] = total_dim;
+    pre_int[2] = dim2;
+    pre_int[3] = strlen(zone_name) + 1;
+    pre_int[4] = strlen(var_names) + 1;
+
+    // Copy the pre-header to the file
+    memcpy(pre_header, pre_int, 5 * sizeof(int));
+
+    size_t off = 5 * sizeof(int);
+    memcpy(&pre_header[off], zone_name, strlen(zone_name) + 1);
+
+    off += strlen(zone_name) + 1;
+    memcpy(&pre_header[off], var_names, strlen(var_names) + 1);
+
+    // Copy the chunk count and the chunk table
+    off += strlen(var_names) + 1;
+    memcpy(&pre_header[off], &total_chunks, sizeof(int));
+
+    off += sizeof(int);
+    memcpy(&pre_header[off], table, 3 * (size_t)total_chunks * sizeof(int));
+
+    MPI_File_write(fp, pre_header, header_len, MPI_CHAR, MPI_STATUS_IGNORE);
+    delete[] pre_header;
+  }
+
+  // Increment the global file-offset to match
+  file_offset += header_len;
+
+  // Concatenate the local chunk streams
+  unsigned char *stream = new unsigned char[local_bytes > 0 ? local_bytes : 1];
+  size_t stream_len = 0;
+  for (int k = 0; k < local_chunks; k++) {
+    memcpy(&stream[stream_len], buffers[k], sizes[k]);
+    stream_len += sizes[k];
+  }
+
+  // Write the chunk streams at the byte offset of this process
+  MPI_File_set_view(fp, file_offset, MPI_BYTE, MPI_BYTE, datarep,
+                    MPI_INFO_NULL);
+  MPI_File_write_at_all(fp, bytes_per_rank[rank], stream, (int)local_bytes,
+                        MPI_BYTE, MPI_STATUS_IGNORE);
+  file_offset += bytes_per_rank[size];
+
+  // Free the compression buffers and tables
+  delete[] stream;
+  delete[] bytes_per_rank;
+  if (rank == 0) {
+    delete[] table;
+    delete[] recv_counts;
+    delete[] displs;
+  }
+  delete[] ltable;
+  delete[] chunks_per_rank;
+  for (int k = 0; k < local_chunks; k++) {
+    delete[] buffers[k];
+  }
+  delete[] sizes;
+  delete[] buffers;
+  delete[] counts;
+  delete[] rows;
+  if (dim_count) {
+    delete[] dim_count;
+  }
+
+  return 1;
+}
+
 /**
    Close the file
 */
@@ -430,6 +835,32 @@ int TACSFH5File::scanFH5File() {
       return 1;
     }
 
+    // Read the chunk table for compressed zones
+    if (tip->dtype == FH5_FLOAT_COMPRESSED) {
+      if (fread(&tip->num_chunks, sizeof(int), 1, rfp) != 1) {
+        fprintf(stderr, "FH5: Error reading compressed chunk count\n");
+        return 1;
+      }
+
+      size_t table_len = 3 * (size_t)tip->num_chunks;
+      int *table = new int[table_len];
+      if (fread(table, sizeof(int), table_len, rfp) != table_len) {
+        fprintf(stderr, "FH5: Error reading compressed chunk table\n");
+        delete[] table;
+        return 1;
+      }
+
+      tip->chunk_rows = new int[tip->num_chunks];
+      tip->chunk_counts = new int[tip->num_chunks];
+      tip->chunk_bytes = new int[tip->num_chunks];
+      for (int k = 0; k < tip->num_chunks; k++) {
+        tip->chunk_rows[k] = table[3 * k];
+        tip->chunk_counts[k] = table[3 * k + 1];
+        tip->chunk_bytes[k] = table[3 * k + 2];
+      }
+      delete[] table;
+    }
+
     // Record the file position
     file_pos = ftell(rfp);
     tip->data_offset = file_pos;
@@ -437,6 +868,13 @@ int TACSFH5File::scanFH5File() {
       file_pos += sizeof(int) * tip->dim1 * tip->dim2;
     } else if (tip->dtype == FH5_FLOAT) {
       file_pos += sizeof(float) * tip->dim1 * tip->dim2;
+    } else if (tip->dtype == FH5_FLOAT_COMPRESSED) {
+      // Compute the file offset of each compressed chunk
+      tip->chunk_offsets = new size_t[tip->num_chunks];
+      for (int k = 0; k < tip->num_chunks; k++) {
+        tip->chunk_offsets[k] = file_pos;
+        file_pos += tip->chunk_bytes[k];
+      }
     } else {
       file_pos += sizeof(double) * tip->dim1 * tip->dim2;
     }
@@ -492,6 +930,8 @@ int TACSFH5File::getZoneInfo(const char **zone_name, const char **var_names,
       *dtype = FH5_INT;
     } else if (current->dtype == FH5_FLOAT) {
       *dtype = FH5_FLOAT;
+    } else if (current->dtype == FH5_FLOAT_COMPRESSED) {
+      *dtype = FH5_FLOAT_COMPRESSED;
     } else if (current->dtype == FH5_DOUBLE) {
       *dtype = FH5_DOUBLE;
     }
@@ -570,6 +1010,31 @@ int TACSFH5File::getZoneData(const char **zone_name, const char **var_names,
         return 0;
       }
     }
+  } else if (dtype == FH5_FLOAT_COMPRESSED) {
+    if (_dtype) {
+      *_dtype = FH5_FLOAT_COMPRESSED;
+    }
+    if (data) {
+      float *fdata = new float[len];
+
+      // Decompress each chunk of the zone in sequence
+      for (int k = 0; k < current->num_chunks; k++) {
+        size_t nbytes = current->chunk_bytes[k];
+        unsigned char *buf = new unsigned char[nbytes];
+        fseek(rfp, current->chunk_offsets[k], SEEK_SET);
+        if (fread(buf, sizeof(unsigned char), nbytes, rfp) != nbytes) {
+          fprintf(stderr, "FH5: Error reading compressed data\n");
+          delete[] buf;
+          delete[] fdata;
+          return 0;
+        }
+        FH5DecompressChunk(
+            buf, nbytes, (size_t)current->chunk_counts[k] * current->dim2,
+            &fdata[(size_t)current->chunk_rows[k] * current->dim2]);
+        delete[] buf;
+      }
+      *data = fdata;
+    }
   } else if (dtype == FH5_DOUBLE) {
     if (_dtype) {
       *_dtype = FH5_DOUBLE;
@@ -585,3 +1050,160 @@ int TACSFH5File::getZoneData(const char **zone_name, const char **var_names,
 
   return 1;
 }
+
+/**
+   Read a contiguous range of rows from the current zone of data.
+
+   This reads only the rows [row_start, row_end) of the zone, where
+   each row consists of dim2 entries. Seeking directly to the
+   requested range means that only the requested portion of the file
+   is ever read into memory, which permits streaming through files
+   that are much larger than the available memory.
+
+   The output data is allocated by this call and must be freed by the
+   caller. The range is clamped to the dimensions of the zone.
+
+   @param zone_name The name of the zone
+   @param var_names The comma-separated variable names
+   @param _dtype The data type of the zone
+   @param dim2 The number of entries per row
+   @param data The newly allocated data for the requested rows
+   @param row_start The first row to read
+   @param row_end One past the last row to read
+   @return The number of rows read, or -1 on an error
+*/
+int TACSFH5File::getZoneDataRange(const char **zone_name,
+                                  const char **var_names, FH5DataType *_dtype,
+                                  int *dim2, void **data, int row_start,
+                                  int row_end) {
+  // No pointer or no file
+  if (!current || !rfp) {
+    fprintf(stderr, "FH5: Error, no file opened yet\n");
+    return -1;
+  }
+
+  // Variables not defined in the file
+  if (!current->var_names) {
+    fprintf(stderr, "FH5: Error variables are not defined\n");
+    return -1;
+  }
+
+  // Clamp the requested range to the dimensions of the zone
+  if (row_start < 0) {
+    row_start = 0;
+  }
+  if (row_end > current->dim1) {
+    row_end = current->dim1;
+  }
+  if (row_end < row_start) {
+    row_end = row_start;
+  }
+
+  int dtype = current->dtype;
+  if (zone_name) {
+    *zone_name = current->zone_name;
+  }
+  if (var_names) {
+    *var_names = current->var_names;
+  }
+  if (dim2) {
+    *dim2 = current->dim2;
+  }
+
+  // Compressed zones are read by decompressing only the chunks that
+  // overlap the requested range of rows
+  if (dtype == FH5_FLOAT_COMPRESSED) {
+    if (_dtype) {
+      *_dtype = FH5_FLOAT_COMPRESSED;
+    }
+    if (data) {
+      int d2 = current->dim2;
+      float *fdata = new float[(size_t)(row_end - row_start) * d2];
+
+      for (int k = 0; k < current->num_chunks; k++) {
+        int cs = current->chunk_rows[k];
+        int ce = cs + current->chunk_counts[k];
+        if (ce <= row_start || cs >= row_end) {
+          continue;
+        }
+
+        // Read and decompress the overlapping chunk
+        size_t nbytes = current->chunk_bytes[k];
+        unsigned char *buf = new unsigned char[nbytes];
+        float *chunk = new float[(size_t)current->chunk_counts[k] * d2];
+        fseek(rfp, current->chunk_offsets[k], SEEK_SET);
+        if (fread(buf, sizeof(unsigned char), nbytes, rfp) != nbytes) {
+          fprintf(stderr, "FH5: Error reading compressed data\n");
+          delete[] buf;
+          delete[] chunk;
+          delete[] fdata;
+          return -1;
+        }
+        FH5DecompressChunk(buf, nbytes,
+                           (size_t)current->chunk_counts[k] * d2, chunk);
+        delete[] buf;
+
+        // Copy the overlapping rows into the output
+        int first = (cs > row_start ? cs : row_start);
+        int last = (ce < row_end ? ce : row_end);
+        memcpy(&fdata[(size_t)(first - row_start) * d2],
+               &chunk[(size_t)(first - cs) * d2],
+               sizeof(float) * (size_t)(last - first) * d2);
+        delete[] chunk;
+      }
+      *data = fdata;
+    }
+    return row_end - row_start;
+  }
+
+  // Compute the entry size for the seek offset
+  size_t entry_size = sizeof(double);
+  if (dtype == FH5_INT) {
+    entry_size = sizeof(int);
+  } else if (dtype == FH5_FLOAT) {
+    entry_size = sizeof(float);
+  }
+
+  // Seek directly to the first requested row
+  size_t offset =
+      current->data_offset + entry_size * current->dim2 * (size_t)row_start;
+  fseek(rfp, offset, SEEK_SET);
+
+  size_t len = (size_t)(row_end - row_start) * current->dim2;
+  if (dtype == FH5_INT) {
+    if (_dtype) {
+      *_dtype = FH5_INT;
+    }
+    if (data) {
+      *data = new int[len];
+      if (fread(*data, sizeof(int), len, rfp) != len) {
+        fprintf(stderr, "FH5: Error reading integer data\n");
+        return -1;
+      }
+    }
+  } else if (dtype == FH5_FLOAT) {
+    if (_dtype) {
+      *_dtype = FH5_FLOAT;
+    }
+    if (data) {
+      *data = new float[len];
+      if (fread(*data, sizeof(float), len, rfp) != len) {
+        fprintf(stderr, "FH5: Error reading float data\n");
+        return -1;
+      }
+    }
+  } else if (dtype == FH5_DOUBLE) {
+    if (_dtype) {
+      *_dtype = FH5_DOUBLE;
+    }
+    if (data) {
+      *data = new double[len];
+      if (fread(*data, sizeof(double), len, rfp) != len) {
+        fprintf(stderr, "FH5: Error reading double data\n");
+        return -1;
+      }
+    }
+  }
+
+  return row_end - row_start;
+}
@@ -29,18 +29,29 @@
 class TACSFH5File : public TACSObject {
  public:
   // Data types accepted by FH5: Note that float comes last
-  // for backwards compatibility
-  enum FH5DataType { FH5_INT = 0, FH5_DOUBLE = 1, FH5_FLOAT = 2 };
+  // for backwards compatibility. Compressed float zones store the
+  // data as independently compressed chunks of rows so that ranges
+  // of rows can still be read without reading the whole zone.
+  enum FH5DataType {
+    FH5_INT = 0,
+    FH5_DOUBLE = 1,
+    FH5_FLOAT = 2,
+    FH5_FLOAT_COMPRESSED = 3
+  };
 
   // Create the FH5 object
   TACSFH5File(MPI_Comm _comm);
   ~TACSFH5File();
 
-  // Create an output file
+  // Create an output file. The optional info object passes MPI-IO
+  // hints (e.g. collective buffering and striping hints) to the file
   int createFile(const char *file_name, int num_components,
-                 char **component_names);
+                 char **component_names, MPI_Info info = MPI_INFO_NULL);
   int writeZoneData(char *zone_name, char *var_names, FH5DataType data_name,
                     int dim1, int dim2, void *data, int *dim1_range = NULL);
+  int writeZoneDataCompressed(char *zone_name, char *var_names, int dim1,
+                              int dim2, float *data, int *dim1_range = NULL,
+                              int mantissa_bits = 23, int num_threads = 1);
   void close();
 
   // Open a file for reading input
@@ -57,6 +68,9 @@ class TACSFH5File : public TACSObject {
                   FH5DataType *_dtype, int *dim1, int *dim2);
   int getZoneData(const char **zone_name, const char **var_names,
                   FH5DataType *_dtype, int *dim1, int *dim2, void **data);
+  int getZoneDataRange(const char **zone_name, const char **var_names,
+                       FH5DataType *_dtype, int *dim2, void **data,
+                       int row_start, int row_end);
 
  private:
   // Store information about the location of the data within the file
@@ -69,6 +83,11 @@ class TACSFH5File : public TACSObject {
       dtype = -1;
       dim1 = dim2 = 0;
       data_offset = 0;
+      num_chunks = 0;
+      chunk_rows = NULL;
+      chunk_counts = NULL;
+      chunk_bytes = NULL;
+      chunk_offsets = NULL;
     }
     ~FH5FileInfo() {
       if (zone_name) {
@@ -77,12 +96,31 @@ class TACSFH5File : public TACSObject {
       if (var_names) {
         delete[] var_names;
       }
+      if (chunk_rows) {
+        delete[] chunk_rows;
+      }
+      if (chunk_counts) {
+        delete[] chunk_counts;
+      }
+      if (chunk_bytes) {
+        delete[] chunk_bytes;
+      }
+      if (chunk_offsets) {
+        delete[] chunk_offsets;
+      }
     }
     int dtype;
     char *zone_name;
     char *var_names;
     int dim1, dim2;
     size_t data_offset;
+
+    // The chunk table for compressed zones
+    int num_chunks;
+    int *chunk_rows;        // The first row of each chunk
+    int *chunk_counts;      // The number of rows in each chunk
+    int *chunk_bytes;       // The compressed size of each chunk
+    size_t *chunk_offsets;  // The file offset of each chunk
     FH5FileInfo *next;
   } * root, *tip, *current;
 
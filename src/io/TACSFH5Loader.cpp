@@ -14,6 +14,8 @@
 
 #include "TACSFH5Loader.h"
 
+#include <pthread.h>
+
 #include "TACSMarchingCubes.h"
 #include "TacsUtilities.h"
 
@@ -39,6 +41,20 @@ TACSFH5Loader::TACSFH5Loader() {
   element_vars = NULL;
   num_nodes_element = -1;
   num_vals_element = -1;
+
+  lazy_loading = 0;
+  continuous_zone_index = -1;
+  element_zone_index = -1;
+  iter_elems_per_block = 0;
+  iter_elem = 0;
+
+  num_threads = 1;
+  iso_caching = 0;
+  iso_cache_isoval = 0.0;
+  iso_cache_layout = -1;
+  iso_cache_data = NULL;
+  iso_cache_ptr = NULL;
+  iso_cache_verts = NULL;
 }
 
 TACSFH5Loader::~TACSFH5Loader() {
@@ -63,9 +79,100 @@ TACSFH5Loader::~TACSFH5Loader() {
   if (data_file) {
     data_file->decref();
   }
+  if (iso_cache_data) {
+    delete[] iso_cache_data;
+  }
+  if (iso_cache_ptr) {
+    delete[] iso_cache_ptr;
+  }
+  if (iso_cache_verts) {
+    delete[] iso_cache_verts;
+  }
+}
+
+/**
+  Set the number of threads used for iso-surface extraction
+
+  @param _num_threads The number of threads
+*/
+void TACSFH5Loader::setNumThreads(int _num_threads) {
+  num_threads = _num_threads;
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  if (num_threads > TACSThreadInfo::TACS_MAX_NUM_THREADS) {
+    num_threads = TACSThreadInfo::TACS_MAX_NUM_THREADS;
+  }
+}
+
+/**
+  Enable or disable caching of the iso-surface data between calls.
+
+  When enabled, getIsoSurfaces() stores the extracted triangles and
+  the nodal values used for the extraction. Subsequent calls with the
+  same isovalue reuse the cached triangles for any element whose nodal
+  values have not changed, so extracting a sequence of frames only
+  revisits the elements near where the solution changed. Disabling
+  the caching frees the cached data.
+
+  Note that the cache does not track the element mask - if the mask
+  changes between calls, toggle the caching off and on again to
+  invalidate the cached triangles.
+
+  @param flag Non-zero to cache the iso-surface data between calls
+*/
+void TACSFH5Loader::setIsoSurfaceCaching(int flag) {
+  iso_caching = flag;
+  if (!iso_caching) {
+    if (iso_cache_data) {
+      delete[] iso_cache_data;
+      iso_cache_data = NULL;
+    }
+    if (iso_cache_ptr) {
+      delete[] iso_cache_ptr;
+      iso_cache_ptr = NULL;
+    }
+    if (iso_cache_verts) {
+      delete[] iso_cache_verts;
+      iso_cache_verts = NULL;
+    }
+    iso_cache_layout = -1;
+  }
 }
 
 int TACSFH5Loader::loadData(const char *conn_fname, const char *data_fname) {
+  return scanFile(conn_fname, data_fname, 0);
+}
+
+/**
+  Load the connectivity, but only record the location of the solution
+  data within the file.
+
+  The connectivity arrays are small and are always read into memory,
+  but in this mode the continuous and element data zones are left on
+  disk and are read on demand through getContinuousDataRange(),
+  getElementDataRange() or the element block iterator. This permits
+  streaming through solution files that are far larger than the
+  available memory. The whole-array accessors getContinuousData() and
+  getElementData() return NULL data pointers in this mode.
+
+  @param conn_file The name of the connectivity file
+  @param data_file The name of the data file (optional)
+  @return Fail flag indicating if the load went well
+*/
+int TACSFH5Loader::loadDataLazy(const char *conn_fname,
+                                const char *data_fname) {
+  return scanFile(conn_fname, data_fname, 1);
+}
+
+/*
+  Scan the connectivity and data files, reading the solution data
+  either eagerly or on demand
+*/
+int TACSFH5Loader::scanFile(const char *conn_fname, const char *data_fname,
+                            int lazy) {
+  lazy_loading = lazy;
+
   // Load in the data for the connectivity
   TACSFH5File *conn_file = new TACSFH5File(MPI_COMM_SELF);
   conn_file->incref();
@@ -151,6 +258,7 @@ int TACSFH5Loader::loadData(const char *conn_fname, const char *data_fname) {
     }
 
     iterate = 1;
+    int zone_index = 0;
     while (iterate) {
       const char *zone_name, *var_names;
       TACSFH5File::FH5DataType dtype;
@@ -160,30 +268,191 @@ int TACSFH5Loader::loadData(const char *conn_fname, const char *data_fname) {
       data_file->getZoneInfo(&zone_name, &var_names, &dtype, &dim1, &dim2);
 
       if (strncmp("continuous data", zone_name, 15) == 0) {
-        void *fdata;
-        data_file->getZoneData(&continuous_zone, &continuous_vars, NULL, NULL,
-                               NULL, &fdata);
+        // Record the zone header information. In the lazy mode the
+        // data itself is left on disk and read on demand.
+        data_file->getZoneInfo(&continuous_zone, &continuous_vars, NULL, NULL,
+                               NULL);
         num_nodes_continuous = dim1;
         num_vals_continuous = dim2;
-        continuous_data = (float *)fdata;
+        continuous_zone_index = zone_index;
+        if (!lazy) {
+          void *fdata;
+          data_file->getZoneData(NULL, NULL, NULL, NULL, NULL, &fdata);
+          continuous_data = (float *)fdata;
+        }
       } else if (strncmp("element data", zone_name, 12) == 0) {
-        void *fdata;
-        data_file->getZoneData(&element_zone, &element_vars, NULL, NULL, NULL,
-                               &fdata);
+        data_file->getZoneInfo(&element_zone, &element_vars, NULL, NULL, NULL);
         num_nodes_element = dim1;
         num_vals_element = dim2;
-        element_data = (float *)fdata;
+        element_zone_index = zone_index;
+        if (!lazy) {
+          void *fdata;
+          data_file->getZoneData(NULL, NULL, NULL, NULL, NULL, &fdata);
+          element_data = (float *)fdata;
+        }
       }
 
       if (!data_file->nextZone()) {
         iterate = 0;
       }
+      zone_index++;
     }
   }
 
   return 0;
 }
 
+/*
+  Read a range of rows from the given data zone, either by copying
+  from the loaded data or by a range-read from the file
+*/
+int TACSFH5Loader::readDataRange(int zone_index, int start, int end,
+                                 int num_rows, const float *loaded_data,
+                                 float **range_data) {
+  if (zone_index < 0 || !data_file) {
+    fprintf(stderr, "TACSFH5Loader: Data has not been loaded\n");
+    return -1;
+  }
+
+  // Clamp the requested range to the dimensions of the zone
+  if (start < 0) {
+    start = 0;
+  }
+  if (end > num_rows) {
+    end = num_rows;
+  }
+  if (end < start) {
+    end = start;
+  }
+
+  if (loaded_data) {
+    // The data is already in memory - copy out the requested range
+    int dim2 = (zone_index == continuous_zone_index ? num_vals_continuous
+                                                    : num_vals_element);
+    size_t len = (size_t)(end - start) * dim2;
+    float *data = new float[len];
+    memcpy(data, &loaded_data[(size_t)start * dim2], len * sizeof(float));
+    *range_data = data;
+    return end - start;
+  }
+
+  // Position the file at the requested zone and read only the
+  // requested rows
+  data_file->firstZone();
+  for (int k = 0; k < zone_index; k++) {
+    if (!data_file->nextZone()) {
+      fprintf(stderr, "TACSFH5Loader: Data zone is missing from the file\n");
+      return -1;
+    }
+  }
+
+  void *fdata;
+  int nrows = data_file->getZoneDataRange(NULL, NULL, NULL, NULL, &fdata,
+                                          start, end);
+  if (nrows < 0) {
+    return -1;
+  }
+  *range_data = (float *)fdata;
+  return nrows;
+}
+
+/**
+  Read a range of rows from the continuous data zone.
+
+  The output array is allocated by this call and must be freed by the
+  caller. In the lazy loading mode only the requested rows are read
+  from the file.
+
+  @param start The first node to read
+  @param end One past the last node to read
+  @param range_data The newly allocated data for the requested rows
+  @return The number of rows read, or -1 on an error
+*/
+int TACSFH5Loader::getContinuousDataRange(int start, int end,
+                                          float **range_data) {
+  return readDataRange(continuous_zone_index, start, end, num_nodes_continuous,
+                       continuous_data, range_data);
+}
+
+/**
+  Read a range of rows from the element data zone.
+
+  Each row corresponds to one entry of the element connectivity, so
+  the rows for element i are ptr[i] through ptr[i+1]-1. The output
+  array is allocated by this call and must be freed by the caller.
+
+  @param start The first row to read
+  @param end One past the last row to read
+  @param range_data The newly allocated data for the requested rows
+  @return The number of rows read, or -1 on an error
+*/
+int TACSFH5Loader::getElementDataRange(int start, int end,
+                                       float **range_data) {
+  return readDataRange(element_zone_index, start, end, num_nodes_element,
+                       element_data, range_data);
+}
+
+/**
+  Initialize the iterator over blocks of element data.
+
+  @param elems_per_block The number of elements read per block
+*/
+void TACSFH5Loader::initElementBlockIterator(int elems_per_block) {
+  if (elems_per_block < 1) {
+    elems_per_block = 1;
+  }
+  iter_elems_per_block = elems_per_block;
+  iter_elem = 0;
+}
+
+/**
+  Read the next block of element data.
+
+  The block contains the element data rows ptr[elem_start] through
+  ptr[elem_end]-1 for the elements [elem_start, elem_end). The block
+  is allocated by this call and must be freed by the caller. Used with
+  loadDataLazy(), this streams through the element data while holding
+  only one block in memory at a time.
+
+  @param elem_start The first element in the block
+  @param elem_end One past the last element in the block
+  @param block_data The newly allocated data for the block
+  @return The number of elements in the block, 0 when the iteration
+  is complete, or -1 on an error
+*/
+int TACSFH5Loader::getElementBlock(int *elem_start, int *elem_end,
+                                   float **block_data) {
+  if (!ptr || iter_elems_per_block < 1) {
+    fprintf(stderr,
+            "TACSFH5Loader: Element block iterator is not initialized\n");
+    return -1;
+  }
+  if (iter_elem >= num_elements) {
+    return 0;
+  }
+
+  int first = iter_elem;
+  int last = first + iter_elems_per_block;
+  if (last > num_elements) {
+    last = num_elements;
+  }
+
+  int nrows = getElementDataRange(ptr[first], ptr[last], block_data);
+  if (nrows < 0) {
+    return -1;
+  }
+
+  if (elem_start) {
+    *elem_start = first;
+  }
+  if (elem_end) {
+    *elem_end = last;
+  }
+  iter_elem = last;
+
+  return last - first;
+}
+
 /**
    Get the number of components defined in this file
 */
@@ -752,9 +1021,164 @@ void TACSFH5Loader::getUnmatchedEdgesAndFaces(
   delete[] global_to_local;
 }
 
+/*
+  The data for one thread extracting iso-surface triangles from its
+  subset of the elements
+*/
+class TACSIsoSurfaceCtx {
+ public:
+  int tid, num_threads;
+  int num_elements;
+  int layout, npe;
+  const int *ltypes, *mask, *ptr, *conn;
+  const float *data;
+  int incr;
+  const float *continuous_data;
+  int num_vals_continuous;
+  float isoval;
+
+  // The nodal values from the previous extraction, or NULL if no
+  // cached triangles are available
+  const float *cache_data;
+
+  // Output: the number of triangles for each element and a flag
+  // indicating that the cached triangles can be reused
+  int *elem_ntris;
+  int *elem_cached;
+
+  // Output: the triangle vertices extracted by this thread, stored
+  // in element order for the elements assigned to this thread
+  float *verts;
+  int ntris, max_tris;
+};
+
+/*
+  Extract the iso-surface triangles for the elements assigned to this
+  thread. The threads are statically interleaved over the element
+  index and write to thread-local buffers, so no synchronization is
+  required.
+*/
+static void *fh5_extract_iso_surfaces(void *arg) {
+  TACSIsoSurfaceCtx *ctx = static_cast<TACSIsoSurfaceCtx *>(arg);
+  const int hex_ordering_transform[] = {0, 1, 3, 2, 4, 5, 7, 6};
+  const int npe = ctx->npe;
+  const int *ptr = ctx->ptr;
+  const int *conn = ctx->conn;
+  const float *data = ctx->data;
+  const int incr = ctx->incr;
+  const float isoval = ctx->isoval;
+
+  for (int i = ctx->tid; i < ctx->num_elements; i += ctx->num_threads) {
+    ctx->elem_ntris[i] = 0;
+    ctx->elem_cached[i] = 0;
+    if (!(ctx->ltypes[i] == ctx->layout && !(ctx->mask && ctx->mask[i]))) {
+      continue;
+    }
+
+    // Check the range of the nodal values. If the values have not
+    // changed since the previous extraction, reuse the cached
+    // triangles; if the values do not straddle the isovalue, the
+    // element contributes no triangles.
+    int changed = (ctx->cache_data == NULL);
+    float fmin = data[incr * conn[ptr[i]]];
+    float fmax = fmin;
+    for (int j = ptr[i]; j < ptr[i + 1]; j++) {
+      float val = data[incr * conn[j]];
+      if (val < fmin) {
+        fmin = val;
+      }
+      if (val > fmax) {
+        fmax = val;
+      }
+      if (!changed && val != ctx->cache_data[conn[j]]) {
+        changed = 1;
+      }
+    }
+    if (!changed) {
+      ctx->elem_cached[i] = 1;
+      continue;
+    }
+    if (isoval < fmin || isoval > fmax) {
+      continue;
+    }
+
+    // March through the cells of the element
+    int ntris_elem = 0;
+    for (int iz = 0; iz < npe - 1; iz++) {
+      for (int iy = 0; iy < npe - 1; iy++) {
+        for (int ix = 0; ix < npe - 1; ix++) {
+          TACSMarchingCubesCell cell;
+
+          for (int kk = 0; kk < 2; kk++) {
+            for (int jj = 0; jj < 2; jj++) {
+              for (int ii = 0; ii < 2; ii++) {
+                // Compute the index
+                int index = hex_ordering_transform[ii + 2 * jj + 4 * kk];
+
+                // Compute the offset into the local mesh
+                int offset = (ix + ii) + (iy + jj) * npe + (iz + kk) * npe * npe;
+
+                // Get the node number
+                int node = conn[ptr[i] + offset];
+                cell.val[index] = data[incr * node];
+
+                // Extract the node value
+                const float *vals =
+                    &ctx->continuous_data[node * ctx->num_vals_continuous];
+                cell.p[index].x = vals[0];
+                cell.p[index].y = vals[1];
+                cell.p[index].z = vals[2];
+              }
+            }
+          }
+
+          // Find the additional triangles that are needed
+          TACSMarchingCubesTriangle tris[5];
+          int new_tris = TacsPolygonizeCube(cell, isoval, tris);
+
+          // Expand the thread-local buffer if needed
+          if (new_tris + ctx->ntris > ctx->max_tris) {
+            ctx->max_tris = 2 * (ctx->ntris + new_tris) + 1024;
+            float *buff = new float[9 * (size_t)ctx->max_tris];
+            memcpy(buff, ctx->verts, 9 * ctx->ntris * sizeof(float));
+            if (ctx->verts) {
+              delete[] ctx->verts;
+            }
+            ctx->verts = buff;
+          }
+
+          // Add the new triangles
+          float *v = &ctx->verts[9 * ctx->ntris];
+          for (int k = 0; k < new_tris; ctx->ntris++, k++) {
+            for (int kk = 0; kk < 3; kk++) {
+              v[0] = tris[k].p[kk].x;
+              v[1] = tris[k].p[kk].y;
+              v[2] = tris[k].p[kk].z;
+              v += 3;
+            }
+          }
+          ntris_elem += new_tris;
+        }
+      }
+    }
+    ctx->elem_ntris[i] = ntris_elem;
+  }
+
+  return NULL;
+}
+
 /*
   Extract the iso-surface for the given element type.
 
+  The elements are processed in parallel on the number of threads set
+  by setNumThreads(). Each thread extracts triangles into its own
+  buffer and the buffers are merged into the output in element order
+  afterwards, so the output is identical regardless of the number of
+  threads. When caching is enabled with setIsoSurfaceCaching(), the
+  triangles of elements whose nodal values have not changed since the
+  previous call are copied from the cache instead of being
+  re-extracted.
+
   @param layout Element layout type to look for
   @param mask Element mask array to apply
   @param isoval The isovalue of the contour
@@ -780,19 +1204,10 @@ void TACSFH5Loader::getIsoSurfaces(ElementLayout layout, const int *mask,
   int ntris = 0;
   float *verts = NULL;
 
-  // Keep track of the max number of triangles
-  int chunk_size = num_elements;
-  if (num_elements > (1 << 16)) {
-    chunk_size = 1 << 16;
-  }
-  int max_num_tris = 0;
-
   if (layout == TACS_HEXA_ELEMENT || layout == TACS_HEXA_QUADRATIC_ELEMENT ||
       layout == TACS_HEXA_CUBIC_ELEMENT ||
       layout == TACS_HEXA_QUARTIC_ELEMENT ||
       layout == TACS_HEXA_QUARTIC_ELEMENT) {
-    const int hex_ordering_transform[] = {0, 1, 3, 2, 4, 5, 7, 6};
-
     int npe = 2;
     if (layout == TACS_HEXA_QUADRATIC_ELEMENT) {
       npe = 3;
@@ -804,67 +1219,133 @@ void TACSFH5Loader::getIsoSurfaces(ElementLayout layout, const int *mask,
       npe = 6;
     }
 
-    for (int i = 0; i < num_elements; i++) {
-      if (ltypes[i] == layout && !(mask && mask[i])) {
-        for (int iz = 0; iz < npe - 1; iz++) {
-          for (int iy = 0; iy < npe - 1; iy++) {
-            for (int ix = 0; ix < npe - 1; ix++) {
-              TACSMarchingCubesCell cell;
-
-              for (int kk = 0; kk < 2; kk++) {
-                for (int jj = 0; jj < 2; jj++) {
-                  for (int ii = 0; ii < 2; ii++) {
-                    // Compute the index
-                    int index = hex_ordering_transform[ii + 2 * jj + 4 * kk];
-
-                    // Compute the offset into the local mesh
-                    int offset =
-                        (ix + ii) + (iy + jj) * npe + (iz + kk) * npe * npe;
-
-                    // Get the node number
-                    int node = conn[ptr[i] + offset];
-                    cell.val[index] = data[incr * node];
-
-                    // Extract the node value
-                    const float *vals =
-                        &continuous_data[node * num_vals_continuous];
-                    cell.p[index].x = vals[0];
-                    cell.p[index].y = vals[1];
-                    cell.p[index].z = vals[2];
-                  }
-                }
-              }
+    // Check whether the cached triangles from the previous call can
+    // be reused. The cache is keyed on the isovalue and the layout -
+    // the per-element value comparison is performed by the threads.
+    int cache_valid = (iso_caching && iso_cache_verts && iso_cache_ptr &&
+                       iso_cache_data && iso_cache_isoval == isoval &&
+                       iso_cache_layout == layout);
 
-              // Find the additional triangles that are needed
-              TACSMarchingCubesTriangle tris[5];
-              int new_tris = TacsPolygonizeCube(cell, isoval, tris);
+    int *elem_ntris = new int[num_elements];
+    int *elem_cached = new int[num_elements];
 
-              // Expand the buffer if needed
-              if (new_tris + ntris > max_num_tris) {
-                max_num_tris = ntris + new_tris + chunk_size;
-                float *buff = new float[9 * max_num_tris];
-                memcpy(buff, verts, 9 * ntris * sizeof(float));
-                if (verts) {
-                  delete[] verts;
-                }
-                verts = buff;
-              }
+    // Set up the thread contexts with statically interleaved elements
+    int nthreads = num_threads;
+    if (nthreads > num_elements && num_elements > 0) {
+      nthreads = num_elements;
+    }
+    if (nthreads < 1) {
+      nthreads = 1;
+    }
 
-              // Add the new triangles
-              float *v = &verts[9 * ntris];
-              for (int k = 0; k < new_tris; ntris++, k++) {
-                for (int kk = 0; kk < 3; kk++) {
-                  v[0] = tris[k].p[kk].x;
-                  v[1] = tris[k].p[kk].y;
-                  v[2] = tris[k].p[kk].z;
-                  v += 3;
-                }
-              }
-            }
-          }
+    TACSIsoSurfaceCtx ctx[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+    for (int t = 0; t < nthreads; t++) {
+      ctx[t].tid = t;
+      ctx[t].num_threads = nthreads;
+      ctx[t].num_elements = num_elements;
+      ctx[t].layout = layout;
+      ctx[t].npe = npe;
+      ctx[t].ltypes = ltypes;
+      ctx[t].mask = mask;
+      ctx[t].ptr = ptr;
+      ctx[t].conn = conn;
+      ctx[t].data = data;
+      ctx[t].incr = incr;
+      ctx[t].continuous_data = continuous_data;
+      ctx[t].num_vals_continuous = num_vals_continuous;
+      ctx[t].isoval = isoval;
+      ctx[t].cache_data = (cache_valid ? iso_cache_data : NULL);
+      ctx[t].elem_ntris = elem_ntris;
+      ctx[t].elem_cached = elem_cached;
+      ctx[t].verts = NULL;
+      ctx[t].ntris = 0;
+      ctx[t].max_tris = 0;
+    }
+
+    if (nthreads > 1) {
+      pthread_t threads[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+      for (int t = 0; t < nthreads; t++) {
+        pthread_create(&threads[t], NULL, fh5_extract_iso_surfaces, &ctx[t]);
+      }
+      for (int t = 0; t < nthreads; t++) {
+        pthread_join(threads[t], NULL);
+      }
+    } else {
+      fh5_extract_iso_surfaces(&ctx[0]);
+    }
+
+    // Fill in the triangle counts for the cached elements and count
+    // the total number of triangles
+    for (int i = 0; i < num_elements; i++) {
+      if (elem_cached[i]) {
+        elem_ntris[i] = iso_cache_ptr[i + 1] - iso_cache_ptr[i];
+      }
+      ntris += elem_ntris[i];
+    }
+
+    // Merge the thread-local buffers and the cached triangles into
+    // the output in element order
+    if (ntris > 0) {
+      verts = new float[9 * (size_t)ntris];
+    }
+    int *cursor = new int[nthreads];
+    memset(cursor, 0, nthreads * sizeof(int));
+
+    int offset = 0;
+    for (int i = 0; i < num_elements; i++) {
+      if (elem_ntris[i] > 0) {
+        if (elem_cached[i]) {
+          memcpy(&verts[9 * (size_t)offset],
+                 &iso_cache_verts[9 * (size_t)iso_cache_ptr[i]],
+                 9 * elem_ntris[i] * sizeof(float));
+        } else {
+          int t = i % nthreads;
+          memcpy(&verts[9 * (size_t)offset],
+                 &ctx[t].verts[9 * (size_t)cursor[t]],
+                 9 * elem_ntris[i] * sizeof(float));
+          cursor[t] += elem_ntris[i];
         }
+        offset += elem_ntris[i];
+      }
+    }
+
+    // Update the cache with the new triangles and nodal values
+    if (iso_caching && data) {
+      if (!iso_cache_ptr) {
+        iso_cache_ptr = new int[num_elements + 1];
+      }
+      iso_cache_ptr[0] = 0;
+      for (int i = 0; i < num_elements; i++) {
+        iso_cache_ptr[i + 1] = iso_cache_ptr[i] + elem_ntris[i];
+      }
+
+      if (iso_cache_verts) {
+        delete[] iso_cache_verts;
+        iso_cache_verts = NULL;
+      }
+      if (ntris > 0) {
+        iso_cache_verts = new float[9 * (size_t)ntris];
+        memcpy(iso_cache_verts, verts, 9 * (size_t)ntris * sizeof(float));
+      }
+
+      if (!iso_cache_data) {
+        iso_cache_data = new float[num_nodes_continuous];
+      }
+      for (int i = 0; i < num_nodes_continuous; i++) {
+        iso_cache_data[i] = data[incr * i];
+      }
+      iso_cache_isoval = isoval;
+      iso_cache_layout = layout;
+    }
+
+    for (int t = 0; t < nthreads; t++) {
+      if (ctx[t].verts) {
+        delete[] ctx[t].verts;
       }
     }
+    delete[] cursor;
+    delete[] elem_cached;
+    delete[] elem_ntris;
   }
 
   *_ntris = ntris;
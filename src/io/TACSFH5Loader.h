@@ -34,6 +34,18 @@ class TACSFH5Loader : public TACSObject {
   // Load data from the file
   int loadData(const char *conn_file, const char *data_file = NULL);
 
+  // Load only the connectivity and record the location of the
+  // solution data so that it can be streamed in ranges
+  int loadDataLazy(const char *conn_file, const char *data_file = NULL);
+
+  // Read a range of rows from the continuous/element data zones
+  int getContinuousDataRange(int start, int end, float **range_data);
+  int getElementDataRange(int start, int end, float **range_data);
+
+  // Iterate over the element data in blocks of elements
+  void initElementBlockIterator(int elems_per_block);
+  int getElementBlock(int *elem_start, int *elem_end, float **block_data);
+
   // Get the component names/data from the file
   int getNumComponents();
   char *getComponentName(int comp);
@@ -46,6 +58,13 @@ class TACSFH5Loader : public TACSObject {
   void getElementData(const char **zone_name, const char **var_names, int *dim1,
                       int *dim2, float **data);
 
+  // Set the number of threads used for iso-surface extraction
+  void setNumThreads(int _num_threads);
+
+  // Cache the iso-surface data so that repeated extractions only
+  // revisit the elements whose nodal values changed
+  void setIsoSurfaceCaching(int flag);
+
   // Methods for post-processing data
   void getElementDataAsContinuous(int index, float *data);
   void computeValueMask(ElementLayout layout, int use_continuous_data,
@@ -64,6 +83,10 @@ class TACSFH5Loader : public TACSObject {
                                  int **_verts);
 
  private:
+  int scanFile(const char *conn_file, const char *data_file, int lazy);
+  int readDataRange(int zone_index, int start, int end, int num_rows,
+                    const float *loaded_data, float **range_data);
+
   void computeNodeToElement(ElementLayout layout, const int *mask,
                             int num_sub_indices, const int *sub_indices,
                             int **_node_to_element_ptr, int **_node_to_element);
@@ -86,6 +109,28 @@ class TACSFH5Loader : public TACSObject {
   int num_nodes_element, num_vals_element;
   float *element_data;
 
+  // Flag indicating that the solution data is read on demand and the
+  // indices of the data zones within the file
+  int lazy_loading;
+  int continuous_zone_index, element_zone_index;
+
+  // State for the element block iterator
+  int iter_elems_per_block;
+  int iter_elem;
+
+  // The number of threads used for iso-surface extraction
+  int num_threads;
+
+  // State for incremental iso-surface extraction. The cache stores
+  // the extracted triangles and the nodal values from the previous
+  // frame so that unchanged elements are not revisited.
+  int iso_caching;
+  float iso_cache_isoval;
+  int iso_cache_layout;
+  float *iso_cache_data;   // The nodal values from the last extraction
+  int *iso_cache_ptr;      // Per-element offsets into the cached triangles
+  float *iso_cache_verts;  // The triangle vertices from the last extraction
+
   // Open file that contains the
   TACSFH5File *data_file;
 };
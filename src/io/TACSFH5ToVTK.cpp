@@ -0,0 +1,626 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSFH5ToVTK.h"
+
+#include <pthread.h>
+
+// The VTK cell type identifiers for the basic element layouts
+const int VTK_VERTEX = 1;
+const int VTK_LINE = 3;
+const int VTK_TRIANGLE = 5;
+const int VTK_QUAD = 9;
+const int VTK_TETRA = 10;
+const int VTK_HEXAHEDRON = 12;
+const int VTK_QUADRATIC_TRIANGLE = 22;
+const int VTK_QUADRATIC_TETRA = 24;
+
+/*
+  Map a basic element layout to the VTK cell type
+*/
+static int fh5_to_vtk_cell_type(int ltype) {
+  if (ltype == TACS_POINT_ELEMENT) {
+    return VTK_VERTEX;
+  } else if (ltype == TACS_LINE_ELEMENT) {
+    return VTK_LINE;
+  } else if (ltype == TACS_TRI_ELEMENT) {
+    return VTK_TRIANGLE;
+  } else if (ltype == TACS_TRI_QUADRATIC_ELEMENT) {
+    return VTK_QUADRATIC_TRIANGLE;
+  } else if (ltype == TACS_QUAD_ELEMENT) {
+    return VTK_QUAD;
+  } else if (ltype == TACS_TETRA_ELEMENT) {
+    return VTK_TETRA;
+  } else if (ltype == TACS_TETRA_QUADRATIC_ELEMENT) {
+    return VTK_QUADRATIC_TETRA;
+  } else if (ltype == TACS_HEXA_ELEMENT) {
+    return VTK_HEXAHEDRON;
+  }
+  return -1;
+}
+
+/*
+  Copy the comma-separated variable name with the given index into the
+  name buffer
+*/
+static void fh5_to_vtk_var_name(const char *var_names, int index, char *name,
+                                int max_len) {
+  // Skip the preceding names
+  for (int j = 0; j < index && var_names[0]; j++) {
+    while (var_names[0] && var_names[0] != ',') {
+      var_names++;
+    }
+    if (var_names[0] == ',') {
+      var_names++;
+    }
+  }
+
+  int len = 0;
+  while (var_names[0] && var_names[0] != ',' && len < max_len - 1) {
+    name[len] = var_names[0];
+    len++;
+    var_names++;
+  }
+  name[len] = '\0';
+}
+
+/*
+  The context for one encoding thread: format the rows in the slab
+  [start, end) into a text buffer that the writer concatenates in
+  thread order
+*/
+typedef struct {
+  int tid, num_threads;
+  int nrows, dim2, index, stride;
+  const float *data;
+  const int *rowmap;
+  char *buf;
+  size_t len;
+} FH5ToVTKEncodeCtx;
+
+static void *fh5_to_vtk_encode(void *arg) {
+  FH5ToVTKEncodeCtx *ctx = (FH5ToVTKEncodeCtx *)arg;
+
+  // Each thread formats a contiguous slab of the rows
+  int start = (ctx->tid * ctx->nrows) / ctx->num_threads;
+  int end = ((ctx->tid + 1) * ctx->nrows) / ctx->num_threads;
+
+  // Each formatted value takes at most 16 characters
+  size_t max_len = 16 * (size_t)(end - start) * ctx->dim2 + 1;
+  ctx->buf = new char[max_len];
+  ctx->len = 0;
+
+  for (int i = start; i < end; i++) {
+    int row = (ctx->rowmap ? ctx->rowmap[i] : i);
+    const float *d = &ctx->data[(size_t)ctx->stride * row + ctx->index];
+    for (int j = 0; j < ctx->dim2; j++) {
+      ctx->len += sprintf(&ctx->buf[ctx->len], "%.6e ", d[j]);
+    }
+    ctx->buf[ctx->len - 1] = '\n';
+  }
+
+  pthread_exit(NULL);
+  return NULL;
+}
+
+/**
+  Create the converter.
+
+  @param _comm The communicator that the conversion runs on
+*/
+TACSFH5ToVTK::TACSFH5ToVTK(MPI_Comm _comm) {
+  comm = _comm;
+  num_threads = 1;
+}
+
+TACSFH5ToVTK::~TACSFH5ToVTK() {}
+
+/**
+  Set the number of threads used to encode the data arrays into text.
+
+  @param _num_threads The number of threads
+*/
+void TACSFH5ToVTK::setNumThreads(int _num_threads) {
+  num_threads = _num_threads;
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  if (num_threads > TACSThreadInfo::TACS_MAX_NUM_THREADS) {
+    num_threads = TACSThreadInfo::TACS_MAX_NUM_THREADS;
+  }
+}
+
+/*
+  Format the data array into text with the encoding threads and write
+  it to the file. One value column (or dim2 consecutive columns) is
+  written per row, with the source row taken through the optional row
+  map.
+*/
+void TACSFH5ToVTK::writeFloatArray(FILE *fp, int nrows, int dim2, int index,
+                                   int stride, const float *data) {
+  writeFloatArrayMapped(fp, nrows, dim2, index, stride, data, NULL);
+}
+
+void TACSFH5ToVTK::writeFloatArrayMapped(FILE *fp, int nrows, int dim2,
+                                         int index, int stride,
+                                         const float *data, const int *rowmap) {
+  int nthreads = num_threads;
+  if (nthreads > nrows) {
+    nthreads = (nrows > 0 ? nrows : 1);
+  }
+
+  FH5ToVTKEncodeCtx ctx[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+  for (int t = 0; t < nthreads; t++) {
+    ctx[t].tid = t;
+    ctx[t].num_threads = nthreads;
+    ctx[t].nrows = nrows;
+    ctx[t].dim2 = dim2;
+    ctx[t].index = index;
+    ctx[t].stride = stride;
+    ctx[t].data = data;
+    ctx[t].rowmap = rowmap;
+    ctx[t].buf = NULL;
+    ctx[t].len = 0;
+  }
+
+  if (nthreads > 1) {
+    pthread_t threads[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+    for (int t = 0; t < nthreads; t++) {
+      pthread_create(&threads[t], NULL, fh5_to_vtk_encode, &ctx[t]);
+    }
+    for (int t = 0; t < nthreads; t++) {
+      pthread_join(threads[t], NULL);
+    }
+  } else if (nrows > 0) {
+    // Avoid the thread start-up cost for the serial case. The worker
+    // calls pthread_exit(), so it still runs on its own thread.
+    pthread_t thread;
+    pthread_create(&thread, NULL, fh5_to_vtk_encode, &ctx[0]);
+    pthread_join(thread, NULL);
+  }
+
+  // Concatenate the slabs in thread order
+  for (int t = 0; t < nthreads; t++) {
+    if (ctx[t].buf) {
+      fwrite(ctx[t].buf, 1, ctx[t].len, fp);
+      delete[] ctx[t].buf;
+    }
+  }
+}
+
+/*
+  Derive the output prefix: either a copy of the given prefix, or the
+  input file name with its extension stripped
+*/
+char *TACSFH5ToVTK::makePrefix(const char *infile, const char *outprefix) {
+  if (!outprefix) {
+    outprefix = infile;
+  }
+
+  int len = strlen(outprefix);
+  int end = len;
+  if (outprefix == infile) {
+    // Strip the extension, but only from the file name itself
+    for (int i = len - 1; i >= 0; i--) {
+      if (outprefix[i] == '/') {
+        break;
+      }
+      if (outprefix[i] == '.') {
+        end = i;
+        break;
+      }
+    }
+  }
+
+  char *prefix = new char[end + 1];
+  memcpy(prefix, outprefix, end);
+  prefix[end] = '\0';
+  return prefix;
+}
+
+/*!
+  Write the elements [elem_start, elem_end) of the loaded archive as a
+  serial .vtu piece.
+
+  Only the data rows touched by the element range are read from the
+  file: the element data range is contiguous, and the continuous data
+  is read as the covering row range of the connectivity entries.
+
+  input:
+  loader:     the loader with the archive open in the lazy mode
+  elem_start: the first element of the piece
+  elem_end:   one past the last element of the piece
+  piece_name: the name of the output file
+
+  returns: 0 on success
+*/
+int TACSFH5ToVTK::writePiece(TACSFH5Loader *loader, int elem_start,
+                             int elem_end, const char *piece_name) {
+  int num_elements;
+  int *comp_nums, *ltypes, *ptr, *conn;
+  loader->getConnectivity(&num_elements, &comp_nums, &ltypes, &ptr, &conn);
+
+  const char *cvars, *evars;
+  int cdim1, cdim2, edim1, edim2;
+  loader->getContinuousData(NULL, &cvars, &cdim1, &cdim2, NULL);
+  loader->getElementData(NULL, &evars, &edim1, &edim2, NULL);
+
+  if (elem_start < 0) {
+    elem_start = 0;
+  }
+  if (elem_end > num_elements) {
+    elem_end = num_elements;
+  }
+  if (elem_end < elem_start) {
+    elem_end = elem_start;
+  }
+
+  // One output point per connectivity entry of the piece, numbered
+  // locally from the start of the piece
+  int pt_offset = ptr[elem_start];
+  int npts = ptr[elem_end] - pt_offset;
+
+  // Find the covering range of continuous data rows and build the map
+  // from the local points to the rows of the range
+  int cmin = 0, cmax = -1;
+  for (int k = ptr[elem_start]; k < ptr[elem_end]; k++) {
+    if (cmax < cmin) {
+      cmin = cmax = conn[k];
+    } else if (conn[k] < cmin) {
+      cmin = conn[k];
+    } else if (conn[k] > cmax) {
+      cmax = conn[k];
+    }
+  }
+
+  int *rowmap = NULL;
+  float *cdata = NULL, *edata = NULL;
+  if (npts > 0) {
+    rowmap = new int[npts];
+    for (int k = 0; k < npts; k++) {
+      rowmap[k] = conn[pt_offset + k] - cmin;
+    }
+
+    // Read only the rows that this piece touches
+    if (loader->getContinuousDataRange(cmin, cmax + 1, &cdata) < 0 ||
+        loader->getElementDataRange(pt_offset, ptr[elem_end], &edata) < 0) {
+      fprintf(stderr, "TACSFH5ToVTK: Failed to read the data for piece %s\n",
+              piece_name);
+      delete[] rowmap;
+      if (cdata) {
+        delete[] cdata;
+      }
+      return 1;
+    }
+  }
+
+  // Convert the element range to basic cell types
+  int num_basic = 0, basic_conn_size = 0;
+  for (int k = elem_start; k < elem_end; k++) {
+    int ntypes = 0, nconn = 0;
+    ElementLayout ltype = (ElementLayout)ltypes[k];
+    if (ltype == TACS_TRI_QUADRATIC_ELEMENT) {
+      ntypes = 1;
+      nconn = 6;
+    } else if (ltype == TACS_TETRA_QUADRATIC_ELEMENT) {
+      ntypes = 1;
+      nconn = 10;
+    } else {
+      TacsConvertVisLayoutToBasicCount(ltype, &ntypes, &nconn);
+    }
+    num_basic += ntypes;
+    basic_conn_size += nconn;
+  }
+
+  int *basic_ltypes = new int[num_basic + 1];
+  int *basic_conn = new int[basic_conn_size + 1];
+
+  // The element connectivity in the local point numbering
+  int *elem_pts = new int[npts + 1];
+  for (int k = 0; k < npts; k++) {
+    elem_pts[k] = k;
+  }
+
+  int *btypes = basic_ltypes;
+  int *bconn = basic_conn;
+  for (int k = elem_start; k < elem_end; k++) {
+    int ntypes = 0, nconn = 0;
+    ElementLayout ltype = (ElementLayout)ltypes[k];
+    if (ltype == TACS_TRI_QUADRATIC_ELEMENT) {
+      btypes[0] = ltype;
+      ntypes = 1;
+      nconn = 6;
+      memcpy(bconn, &elem_pts[ptr[k] - pt_offset], 6 * sizeof(int));
+    } else if (ltype == TACS_TETRA_QUADRATIC_ELEMENT) {
+      btypes[0] = ltype;
+      ntypes = 1;
+      nconn = 10;
+      memcpy(bconn, &elem_pts[ptr[k] - pt_offset], 10 * sizeof(int));
+    } else {
+      TacsConvertVisLayoutToBasicCount(ltype, &ntypes, &nconn);
+      TacsConvertVisLayoutToBasic(ltype, &elem_pts[ptr[k] - pt_offset], btypes,
+                                  bconn);
+    }
+    btypes += ntypes;
+    bconn += nconn;
+  }
+  delete[] elem_pts;
+
+  // Open the output file for the piece
+  FILE *fp = fopen(piece_name, "w");
+  if (!fp) {
+    fprintf(stderr, "TACSFH5ToVTK: Failed to open the output file %s\n",
+            piece_name);
+    delete[] basic_ltypes;
+    delete[] basic_conn;
+    if (rowmap) {
+      delete[] rowmap;
+      delete[] cdata;
+      delete[] edata;
+    }
+    return 1;
+  }
+
+  fprintf(fp, "<?xml version=\"1.0\"?>\n");
+  fprintf(fp,
+          "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" "
+          "byte_order=\"LittleEndian\">\n");
+  fprintf(fp, "<UnstructuredGrid>\n");
+  fprintf(fp, "<Piece NumberOfPoints=\"%d\" NumberOfCells=\"%d\">\n", npts,
+          num_basic);
+
+  // Write out the points
+  fprintf(fp, "<Points>\n");
+  fprintf(fp,
+          "<DataArray type=\"Float32\" NumberOfComponents=\"3\" "
+          "format=\"ascii\">\n");
+  writeFloatArrayMapped(fp, npts, 3, 0, cdim2, cdata, rowmap);
+  fprintf(fp, "</DataArray>\n</Points>\n");
+
+  // Write out the cells
+  fprintf(fp, "<Cells>\n");
+  fprintf(fp,
+          "<DataArray type=\"Int32\" Name=\"connectivity\" "
+          "format=\"ascii\">\n");
+  int conn_offset = 0;
+  for (int k = 0; k < num_basic; k++) {
+    int conn_size = TacsGetNumVisNodes((ElementLayout)basic_ltypes[k]);
+    if (basic_ltypes[k] == TACS_QUAD_ELEMENT) {
+      const int convert[] = {0, 1, 3, 2};
+      for (int j = 0; j < conn_size; j++) {
+        fprintf(fp, "%d ", basic_conn[conn_offset + convert[j]]);
+      }
+      conn_offset += 4;
+    } else if (basic_ltypes[k] == TACS_HEXA_ELEMENT) {
+      const int convert[] = {0, 1, 3, 2, 4, 5, 7, 6};
+      for (int j = 0; j < conn_size; j++) {
+        fprintf(fp, "%d ", basic_conn[conn_offset + convert[j]]);
+      }
+      conn_offset += 8;
+    } else {
+      for (int j = 0; j < conn_size; j++, conn_offset++) {
+        fprintf(fp, "%d ", basic_conn[conn_offset]);
+      }
+    }
+    fprintf(fp, "\n");
+  }
+  fprintf(fp, "</DataArray>\n");
+
+  fprintf(fp, "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n");
+  conn_offset = 0;
+  for (int k = 0; k < num_basic; k++) {
+    conn_offset += TacsGetNumVisNodes((ElementLayout)basic_ltypes[k]);
+    fprintf(fp, "%d\n", conn_offset);
+  }
+  fprintf(fp, "</DataArray>\n");
+
+  fprintf(fp, "<DataArray type=\"UInt8\" Name=\"types\" format=\"ascii\">\n");
+  for (int k = 0; k < num_basic; k++) {
+    fprintf(fp, "%d\n", fh5_to_vtk_cell_type(basic_ltypes[k]));
+  }
+  fprintf(fp, "</DataArray>\n</Cells>\n");
+
+  delete[] basic_ltypes;
+  delete[] basic_conn;
+
+  // Write the continuous variables beyond X, Y and Z, then the
+  // element variables, as point data
+  fprintf(fp, "<PointData>\n");
+  char name[256];
+  for (int j = 3; j < cdim2; j++) {
+    fh5_to_vtk_var_name(cvars, j, name, sizeof(name));
+    fprintf(fp, "<DataArray type=\"Float32\" Name=\"%s\" format=\"ascii\">\n",
+            name);
+    writeFloatArrayMapped(fp, npts, 1, j, cdim2, cdata, rowmap);
+    fprintf(fp, "</DataArray>\n");
+  }
+  for (int j = 0; j < edim2; j++) {
+    fh5_to_vtk_var_name(evars, j, name, sizeof(name));
+    fprintf(fp, "<DataArray type=\"Float32\" Name=\"%s\" format=\"ascii\">\n",
+            name);
+    writeFloatArray(fp, npts, 1, j, edim2, edata);
+    fprintf(fp, "</DataArray>\n");
+  }
+  fprintf(fp, "</PointData>\n");
+
+  fprintf(fp, "</Piece>\n</UnstructuredGrid>\n</VTKFile>\n");
+  fclose(fp);
+
+  if (rowmap) {
+    delete[] rowmap;
+    delete[] cdata;
+    delete[] edata;
+  }
+
+  return 0;
+}
+
+/*
+  Write the .pvtu index that stitches the pieces together. The pieces
+  are referenced relative to the index file.
+*/
+int TACSFH5ToVTK::writeIndex(TACSFH5Loader *loader, const char *outprefix,
+                             int num_pieces) {
+  const char *cvars, *evars;
+  int cdim1, cdim2, edim1, edim2;
+  loader->getContinuousData(NULL, &cvars, &cdim1, &cdim2, NULL);
+  loader->getElementData(NULL, &evars, &edim1, &edim2, NULL);
+
+  char *index_name = new char[strlen(outprefix) + 8];
+  sprintf(index_name, "%s.pvtu", outprefix);
+
+  FILE *fp = fopen(index_name, "w");
+  if (!fp) {
+    fprintf(stderr, "TACSFH5ToVTK: Failed to open the output file %s\n",
+            index_name);
+    delete[] index_name;
+    return 1;
+  }
+  delete[] index_name;
+
+  fprintf(fp, "<?xml version=\"1.0\"?>\n");
+  fprintf(fp,
+          "<VTKFile type=\"PUnstructuredGrid\" version=\"0.1\" "
+          "byte_order=\"LittleEndian\">\n");
+  fprintf(fp, "<PUnstructuredGrid GhostLevel=\"0\">\n");
+  fprintf(fp, "<PPoints>\n");
+  fprintf(fp, "<PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n");
+  fprintf(fp, "</PPoints>\n");
+
+  fprintf(fp, "<PPointData>\n");
+  char name[256];
+  for (int j = 3; j < cdim2; j++) {
+    fh5_to_vtk_var_name(cvars, j, name, sizeof(name));
+    fprintf(fp, "<PDataArray type=\"Float32\" Name=\"%s\"/>\n", name);
+  }
+  for (int j = 0; j < edim2; j++) {
+    fh5_to_vtk_var_name(evars, j, name, sizeof(name));
+    fprintf(fp, "<PDataArray type=\"Float32\" Name=\"%s\"/>\n", name);
+  }
+  fprintf(fp, "</PPointData>\n");
+
+  // Reference the pieces relative to the index file
+  const char *base = outprefix;
+  for (const char *c = outprefix; c[0]; c++) {
+    if (c[0] == '/') {
+      base = c + 1;
+    }
+  }
+  for (int p = 0; p < num_pieces; p++) {
+    fprintf(fp, "<Piece Source=\"%s.%d.vtu\"/>\n", base, p);
+  }
+
+  fprintf(fp, "</PUnstructuredGrid>\n</VTKFile>\n");
+  fclose(fp);
+
+  return 0;
+}
+
+/**
+  Convert one archive, partitioned across the communicator.
+
+  Each process streams its contiguous element range from the archive,
+  writes it as the piece outprefix.rank.vtu, and the root process
+  writes the outprefix.pvtu index. This call is collective.
+
+  @param infile The name of the FH5 archive
+  @param outprefix The output prefix; the input name with the
+  extension stripped when NULL
+  @return 0 when the conversion succeeded on every process
+*/
+int TACSFH5ToVTK::convertToVTU(const char *infile, const char *outprefix) {
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  TACSFH5Loader *loader = new TACSFH5Loader();
+  loader->incref();
+
+  int fail = loader->loadDataLazy(infile);
+  if (fail) {
+    fprintf(stderr, "TACSFH5ToVTK: Failed to open the file %s\n", infile);
+  } else {
+    int num_elements;
+    loader->getConnectivity(&num_elements, NULL, NULL, NULL, NULL);
+
+    // Partition the elements evenly across the processes
+    int elem_start = (rank * num_elements) / size;
+    int elem_end = ((rank + 1) * num_elements) / size;
+
+    char *prefix = makePrefix(infile, outprefix);
+    char *piece_name = new char[strlen(prefix) + 32];
+    sprintf(piece_name, "%s.%d.vtu", prefix, rank);
+
+    fail = writePiece(loader, elem_start, elem_end, piece_name);
+    if (rank == 0) {
+      fail = writeIndex(loader, prefix, size) || fail;
+    }
+
+    delete[] piece_name;
+    delete[] prefix;
+  }
+  loader->decref();
+
+  // The conversion fails if any piece failed
+  MPI_Allreduce(MPI_IN_PLACE, &fail, 1, MPI_INT, MPI_MAX, comm);
+  return fail;
+}
+
+/**
+  Convert a series of archives with one whole archive per process.
+
+  The archives are distributed round-robin across the communicator
+  and each becomes a stand-alone .vtu file, which is the natural
+  decomposition for the frames of a transient archive. This call is
+  collective.
+
+  @param num_files The number of archives
+  @param infiles The archive file names
+  @return 0 when every conversion succeeded
+*/
+int TACSFH5ToVTK::convertSeries(int num_files, const char *const *infiles) {
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  int fail = 0;
+  for (int k = rank; k < num_files; k += size) {
+    TACSFH5Loader *loader = new TACSFH5Loader();
+    loader->incref();
+
+    if (loader->loadDataLazy(infiles[k])) {
+      fprintf(stderr, "TACSFH5ToVTK: Failed to open the file %s\n",
+              infiles[k]);
+      fail = 1;
+    } else {
+      loader->setNumThreads(num_threads);
+
+      int num_elements;
+      loader->getConnectivity(&num_elements, NULL, NULL, NULL, NULL);
+
+      char *prefix = makePrefix(infiles[k], NULL);
+      char *outfile = new char[strlen(prefix) + 8];
+      sprintf(outfile, "%s.vtu", prefix);
+
+      if (writePiece(loader, 0, num_elements, outfile)) {
+        fail = 1;
+      }
+
+      delete[] outfile;
+      delete[] prefix;
+    }
+    loader->decref();
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, &fail, 1, MPI_INT, MPI_MAX, comm);
+  return fail;
+}
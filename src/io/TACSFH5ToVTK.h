@@ -0,0 +1,80 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_FH5_TO_VTK_H
+#define TACS_FH5_TO_VTK_H
+
+#include "TACSFH5Loader.h"
+
+/**
+  MPI-parallel conversion of FH5 solution archives to VTK output.
+
+  The stand-alone f5tovtk utility converts one archive at a time in
+  serial, which makes visualization prep the slowest step of a
+  transient campaign. This class builds the conversion into the
+  library so that it can run on the job's own allocation, typically in
+  the epilogue after the analysis completes.
+
+  Two levels of parallelism are provided. convertToVTU() partitions
+  the elements of a single archive across the communicator: each
+  process streams only its element range from the file through the
+  lazy TACSFH5Loader reads, encodes its piece into a serial .vtu file
+  and the root process writes the .pvtu index that stitches the pieces
+  together. convertSeries() distributes whole archives round-robin
+  across the processes, which is the natural decomposition for the
+  many frames of a transient archive; each frame becomes a single
+  stand-alone .vtu file.
+
+  Within each process the encoding of the large nodal data arrays
+  into the VTU text format is threaded, since the formatting cost
+  dominates the conversion once the reads are parallel.
+*/
+class TACSFH5ToVTK : public TACSObject {
+ public:
+  TACSFH5ToVTK(MPI_Comm _comm);
+  ~TACSFH5ToVTK();
+
+  // Set the number of threads used to encode the data arrays
+  void setNumThreads(int _num_threads);
+
+  // Convert one archive, partitioned across the communicator
+  int convertToVTU(const char *infile, const char *outprefix = NULL);
+
+  // Convert a series of archives, one whole archive per process
+  int convertSeries(int num_files, const char *const *infiles);
+
+ private:
+  // Write the elements [elem_start, elem_end) as a serial .vtu piece
+  int writePiece(TACSFH5Loader *loader, int elem_start, int elem_end,
+                 const char *piece_name);
+
+  // Write the .pvtu index that references the pieces
+  int writeIndex(TACSFH5Loader *loader, const char *outprefix, int num_pieces);
+
+  // Derive the output prefix from the input file name
+  char *makePrefix(const char *infile, const char *outprefix);
+
+  // Format a float data array into text using the encoding threads
+  // and write it to the file, optionally through a row map
+  void writeFloatArray(FILE *fp, int nrows, int dim2, int index, int stride,
+                       const float *data);
+  void writeFloatArrayMapped(FILE *fp, int nrows, int dim2, int index,
+                             int stride, const float *data, const int *rowmap);
+
+  // The communicator that the conversion is partitioned over
+  MPI_Comm comm;
+
+  // The number of encoding threads per process
+  int num_threads;
+};
+
+#endif  // TACS_FH5_TO_VTK_H
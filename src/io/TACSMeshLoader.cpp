@@ -18,9 +18,14 @@
 
 #include "TACSMeshLoader.h"
 
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+
+#include <atomic>
 
 /*!
   This is an interface for reading NASTRAN-style files.
@@ -420,6 +425,516 @@ static int parse_element_field(size_t *loc, char *buffer,
   return fail;
 }
 
+/*
+  Advance a buffer location to the beginning of the next card.
+
+  Continuation lines in the small-field, large-field and GRID* formats
+  begin with a blank or an asterisk, so the next card starts at the
+  first subsequent line whose leading character is neither. This is
+  used to align the scanning chunk boundaries on card boundaries.
+*/
+static size_t next_card_location(size_t loc, const char *buffer,
+                                 size_t bulk_end) {
+  // Skip to the end of the current line
+  while ((loc < bulk_end) && (buffer[loc] != '\n')) {
+    loc++;
+  }
+  loc++;
+
+  // Skip over any continuation lines
+  while ((loc < bulk_end) && (buffer[loc] == ' ' || buffer[loc] == '*')) {
+    while ((loc < bulk_end) && (buffer[loc] != '\n')) {
+      loc++;
+    }
+    loc++;
+  }
+
+  if (loc > bulk_end) {
+    loc = bulk_end;
+  }
+  return loc;
+}
+
+/*
+  Match the element type keyword at the beginning of the line.
+
+  Returns the index into TacsMeshLoaderElementTypes, or -1 if the line
+  does not start a recognized element, and sets the entry width and
+  the maximum connectivity size for the type.
+*/
+static int match_element_type(const char *line, int *entry_width,
+                              int *max_num_conn) {
+  *entry_width = 8;
+  *max_num_conn = -1;
+  for (int k = 0; k < TacsMeshLoaderNumElementTypes; k++) {
+    int len = strlen(TacsMeshLoaderElementTypes[k]);
+    if (strncmp(line, TacsMeshLoaderElementTypes[k], len) == 0) {
+      *max_num_conn = TacsMeshLoaderElementLimits[k][1];
+
+      // Check if we should use the extended width or not
+      if (line[len] == '*') {
+        *entry_width = 16;
+      }
+      return k;
+    }
+  }
+  return -1;
+}
+
+/*
+  Scan the constrained degrees of freedom on an SPC line.
+
+  This is a fixed-width format: SPC SID G1 C D, where the C field
+  occupies columns 24-32. The scan stops at the end of the line so
+  that the counting and writing passes agree on the number of
+  constrained variables. If bc_vars/bc_vals are provided, record the
+  variable numbers and values as well.
+*/
+static int parse_spc_dofs(const char *line, int line_len, double val,
+                          int *bc_vars, TacsScalar *bc_vals) {
+  int nvars = 0;
+  for (int k = 24; (k < 32) && (k < line_len); k++) {
+    const char dofs[9] = "12345678";
+
+    for (int j = 0; j < 8; j++) {
+      if (dofs[j] == line[k]) {
+        if (bc_vars) {
+          bc_vars[nvars] = j;
+          bc_vals[nvars] = val;
+        }
+        nvars++;
+        break;
+      }
+    }
+  }
+  return nvars;
+}
+
+/*
+  A card-aligned range of the bulk data section scanned by one thread.
+
+  The counting pass fills in the counts for each chunk. The offsets
+  are then set from the exclusive prefix sums of the counts over the
+  chunks, so that the writing pass can store the data parsed from each
+  chunk directly into its portion of the output arrays.
+*/
+struct TacsScanChunk {
+  size_t begin, end;  // The byte range [begin, end) of the chunk
+
+  // Counts gathered by the counting pass
+  int num_nodes, num_elements, conn_size;
+  int num_bcs, bc_vars_size, num_shell;
+  int max_conn, max_comp;
+  int fail;
+
+  // Output offsets used by the writing pass
+  int node_base, elem_base, conn_base;
+  int bc_base, bc_var_base, shell_base;
+};
+
+/*
+  Shared state for the threaded scan of the bulk data section
+*/
+struct TacsScanInfo {
+  // The file contents
+  char *buffer;
+  size_t buffer_len;
+
+  // The chunks and the index of the next unclaimed chunk
+  TacsScanChunk *chunks;
+  int num_chunks;
+  std::atomic<int> next_chunk;
+
+  // Data set between the counting and writing passes
+  int max_element_conn;
+  int num_components;
+
+  // The output arrays written by the writing pass
+  int *file_node_nums;
+  double *file_Xpts;
+  int *file_elem_nums, *file_comp;
+  int *file_conn, *file_conn_ptr;
+  int *bc_nodes, *bc_ptr, *bc_vars;
+  TacsScalar *bc_vals;
+  char *component_elems, *component_descript;
+
+  // Guards the first-touch writes to component_elems
+  pthread_mutex_t comp_mutex;
+};
+
+/*
+  The counting pass: count the nodes, elements, boundary conditions
+  and connectivity entries in each chunk.
+
+  The workers claim chunks with an atomic increment until all of the
+  chunks have been scanned.
+*/
+static void *scan_bdf_count_job(void *arg) {
+  TacsScanInfo *info = static_cast<TacsScanInfo *>(arg);
+  char line[81], line2[81];
+
+  int c;
+  while ((c = info->next_chunk++) < info->num_chunks) {
+    TacsScanChunk *chunk = &info->chunks[c];
+    size_t loc = chunk->begin;
+
+    while (loc < chunk->end) {
+      // Read the first line of the card
+      size_t temp_loc = loc;
+      int line_len = read_buffer_line(line, sizeof(line), &temp_loc,
+                                      info->buffer, info->buffer_len);
+      if (!line_len) {
+        chunk->fail = 1;
+        break;
+      }
+
+      if (line[0] == '$') {
+        // Count the ICEM component descriptions for the writing pass
+        if (strncmp(line, "$       Shell", 13) == 0) {
+          chunk->num_shell++;
+        }
+      } else if (strncmp(line, "GRID*", 5) == 0) {
+        if (!read_buffer_line(line2, sizeof(line2), &temp_loc, info->buffer,
+                              info->buffer_len)) {
+          chunk->fail = 1;
+          break;
+        }
+        chunk->num_nodes++;
+      } else if (strncmp(line, "GRID", 4) == 0) {
+        chunk->num_nodes++;
+      } else if (strncmp(line, "SPC", 3) == 0) {
+        chunk->bc_vars_size += parse_spc_dofs(line, line_len, 0.0, NULL, NULL);
+        chunk->num_bcs++;
+      } else {
+        // Check the library of elements
+        int entry_width, max_num_conn;
+        int index = match_element_type(line, &entry_width, &max_num_conn);
+
+        if (index >= 0) {
+          // Find the number of entries in the element
+          int elem_num, component_num, num_conn;
+          temp_loc = loc;
+          if (parse_element_field(&temp_loc, info->buffer, info->buffer_len,
+                                  entry_width, max_num_conn, &elem_num,
+                                  &component_num, NULL, &num_conn)) {
+            chunk->fail = 1;
+            break;
+          }
+
+          // Check if the number of nodes is within the prescribed limits
+          if (num_conn < TacsMeshLoaderElementLimits[index][0]) {
+            fprintf(stderr,
+                    "TACSMeshLoader: Number of nodes for element %s "
+                    "not within limits\n",
+                    TacsMeshLoaderElementTypes[index]);
+            chunk->fail = 1;
+            break;
+          }
+
+          chunk->conn_size += num_conn;
+          chunk->num_elements++;
+          if (num_conn > chunk->max_conn) {
+            chunk->max_conn = num_conn;
+          }
+          if (component_num > chunk->max_comp) {
+            chunk->max_comp = component_num;
+          }
+        } else {
+          fprintf(stderr, "TACSMeshLoader: Element not recognized. Line\n %s\n",
+                  line);
+        }
+      }
+
+      loc = temp_loc;
+    }
+  }
+
+  return NULL;
+}
+
+/*
+  The writing pass: parse each chunk again and store the nodes,
+  connectivity, boundary conditions and component labels at the
+  offsets computed from the counting pass.
+*/
+static void *scan_bdf_fill_job(void *arg) {
+  TacsScanInfo *info = static_cast<TacsScanInfo *>(arg);
+  char line[81], line2[81];
+
+  // Allocate space to store the element node numbers
+  int *temp_nodes = new int[info->max_element_conn];
+
+  int c;
+  while ((c = info->next_chunk++) < info->num_chunks) {
+    TacsScanChunk *chunk = &info->chunks[c];
+    size_t loc = chunk->begin;
+
+    // Set the output offsets for this chunk
+    int num_nodes = chunk->node_base;
+    int num_elements = chunk->elem_base;
+    int elem_conn_size = chunk->conn_base;
+    int num_bcs = chunk->bc_base;
+    int bc_vars_size = chunk->bc_var_base;
+    int component_counter = chunk->shell_base;
+
+    while (loc < chunk->end) {
+      // Read the first line of the card
+      size_t temp_loc = loc;
+      int line_len = read_buffer_line(line, sizeof(line), &temp_loc,
+                                      info->buffer, info->buffer_len);
+      if (!line_len) {
+        chunk->fail = 1;
+        break;
+      }
+
+      if (strncmp(line, "$       Shell", 13) == 0) {
+        // A standard icem output - description of each
+        // component. This is very useful for describing what the
+        // components actually are with a string.
+        // Again use a fixed width format
+        char comp[33];
+        int comp_num = component_counter;
+        component_counter++;
+
+        strncpy(comp, &line[41], 32);
+        comp[32] = '\0';
+        // Remove white space
+        if (comp_num >= 0 && comp_num < info->num_components) {
+          sscanf(comp, "%s", &info->component_descript[33 * comp_num]);
+        }
+      }
+      if (line[0] != '$') {  // A comment line
+        if (strncmp(line, "GRID*", 5) == 0) {
+          if (!read_buffer_line(line2, sizeof(line2), &temp_loc, info->buffer,
+                                info->buffer_len)) {
+            chunk->fail = 1;
+            break;
+          }
+          int node;
+          double x, y, z;
+          parse_node_long_field(line, line2, &node, &x, &y, &z);
+          info->file_node_nums[num_nodes] = node - 1;  // Get the C ordering
+          info->file_Xpts[3 * num_nodes] = x;
+          info->file_Xpts[3 * num_nodes + 1] = y;
+          info->file_Xpts[3 * num_nodes + 2] = z;
+          num_nodes++;
+        } else if (strncmp(line, "GRID", 4) == 0) {
+          int node;
+          double x, y, z;
+          parse_node_short_free_field(line, &node, &x, &y, &z);
+          info->file_node_nums[num_nodes] = node - 1;  // Get the C ordering
+          info->file_Xpts[3 * num_nodes] = x;
+          info->file_Xpts[3 * num_nodes + 1] = y;
+          info->file_Xpts[3 * num_nodes + 2] = z;
+          num_nodes++;
+        } else if (strncmp(line, "SPC", 3) == 0) {
+          // Read in the nodal value
+          char node[9];
+          strncpy(node, &line[16], 8);
+          node[8] = '\0';
+          info->bc_nodes[num_bcs] = atoi(node) - 1;
+
+          strncpy(node, &line[32], 8);
+          node[8] = '\0';
+          double val = bdf_atof(node);
+
+          // Read in the dof that will be constrained
+          bc_vars_size +=
+              parse_spc_dofs(line, line_len, val, &info->bc_vars[bc_vars_size],
+                             &info->bc_vals[bc_vars_size]);
+
+          info->bc_ptr[num_bcs + 1] = bc_vars_size;
+          num_bcs++;
+        } else {
+          // Check the library of elements
+          int entry_width, max_num_conn;
+          int index = match_element_type(line, &entry_width, &max_num_conn);
+
+          if (index >= 0) {
+            // Find the number of entries in the element
+            int elem_num, component_num, num_conn;
+            temp_loc = loc;
+            if (parse_element_field(&temp_loc, info->buffer, info->buffer_len,
+                                    entry_width, max_num_conn, &elem_num,
+                                    &component_num, temp_nodes, &num_conn)) {
+              chunk->fail = 1;
+              break;
+            }
+
+            int *conn = &info->file_conn[elem_conn_size];
+            if (strncmp(line, "CQUAD4", 6) == 0 ||
+                strncmp(line, "CQUADR", 6) == 0) {
+              conn[0] = temp_nodes[0] - 1;
+              conn[1] = temp_nodes[1] - 1;
+              conn[2] = temp_nodes[3] - 1;
+              conn[3] = temp_nodes[2] - 1;
+            } else if (strncmp(line, "CQUAD9", 6) == 0 ||
+                       strncmp(line, "CQUAD", 5) == 0) {
+              conn[0] = temp_nodes[0] - 1;
+              conn[1] = temp_nodes[4] - 1;
+              conn[2] = temp_nodes[1] - 1;
+              conn[3] = temp_nodes[7] - 1;
+              conn[4] = temp_nodes[8] - 1;
+              conn[5] = temp_nodes[5] - 1;
+              conn[6] = temp_nodes[3] - 1;
+              conn[7] = temp_nodes[6] - 1;
+              conn[8] = temp_nodes[2] - 1;
+            } else if (strncmp(line, "CHEXA", 5) == 0) {
+              conn[0] = temp_nodes[0] - 1;
+              conn[1] = temp_nodes[1] - 1;
+              conn[2] = temp_nodes[3] - 1;
+              conn[3] = temp_nodes[2] - 1;
+              conn[4] = temp_nodes[4] - 1;
+              conn[5] = temp_nodes[5] - 1;
+              conn[6] = temp_nodes[7] - 1;
+              conn[7] = temp_nodes[6] - 1;
+            } else {
+              for (int k = 0; k < num_conn; k++) {
+                conn[k] = temp_nodes[k] - 1;
+              }
+            }
+
+            // Set the node numbers
+            info->file_elem_nums[num_elements] = elem_num - 1;
+            info->file_comp[num_elements] = component_num - 1;
+
+            elem_conn_size += num_conn;
+            info->file_conn_ptr[num_elements + 1] = elem_conn_size;
+            num_elements++;
+
+            if (info->component_elems[9 * (component_num - 1)] == '\0') {
+              pthread_mutex_lock(&info->comp_mutex);
+              if (info->component_elems[9 * (component_num - 1)] == '\0') {
+                if (strncmp(line, "CTETRA", 6) == 0 && num_conn == 10) {
+                  strcpy(&info->component_elems[9 * (component_num - 1)],
+                         "CTETRA10");
+                } else {
+                  strcpy(&info->component_elems[9 * (component_num - 1)],
+                         TacsMeshLoaderElementTypes[index]);
+                }
+              }
+              pthread_mutex_unlock(&info->comp_mutex);
+            }
+          } else {
+            fprintf(stderr,
+                    "TACSMeshLoader: Element not recognized. Line\n %s\n",
+                    line);
+          }
+        }
+      }
+
+      loc = temp_loc;
+    }
+  }
+
+  delete[] temp_nodes;
+
+  return NULL;
+}
+
+/*
+  Run one scanning pass over all of the chunks with the given number
+  of threads
+*/
+static void scan_bdf_run(void *(*job)(void *), TacsScanInfo *info,
+                         int num_threads) {
+  info->next_chunk = 0;
+  if (num_threads > 1) {
+    pthread_t threads[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+    for (int t = 0; t < num_threads; t++) {
+      pthread_create(&threads[t], NULL, job, info);
+    }
+    for (int t = 0; t < num_threads; t++) {
+      pthread_join(threads[t], NULL);
+    }
+  } else {
+    job(info);
+  }
+}
+
+/*
+  Compute the FNV-1a hash of the given contents.
+
+  This is used to key the binary mesh cache to the BDF file that it
+  was scanned from.
+*/
+static uint64_t hash_file_contents(const char *buffer, size_t buffer_len) {
+  uint64_t hash = 1469598103934665603ULL;
+  for (size_t i = 0; i < buffer_len; i++) {
+    hash ^= (unsigned char)buffer[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/*
+  Compute the hash and size of the contents of the named file.
+
+  Returns a non-zero fail code if the file cannot be read.
+*/
+static int hash_file(const char *file_name, uint64_t *hash, uint64_t *size) {
+  FILE *fp = fopen(file_name, "rb");
+  if (!fp) {
+    return 1;
+  }
+
+  // Determine the size of the file
+  fseek(fp, 0, SEEK_END);
+  size_t buffer_len = ftell(fp);
+  rewind(fp);
+
+  // Map the file read-only, falling back to reading it into memory
+  int buffer_mapped = 1;
+  char *buffer =
+      (char *)mmap(NULL, buffer_len, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+  if (buffer == MAP_FAILED) {
+    buffer_mapped = 0;
+    buffer = new char[buffer_len];
+    if (fread(buffer, 1, buffer_len, fp) != buffer_len) {
+      delete[] buffer;
+      fclose(fp);
+      return 1;
+    }
+  }
+  fclose(fp);
+
+  *hash = hash_file_contents(buffer, buffer_len);
+  *size = buffer_len;
+
+  if (buffer_mapped) {
+    munmap(buffer, buffer_len);
+  } else {
+    delete[] buffer;
+  }
+  return 0;
+}
+
+// The version number of the binary mesh cache format. Increment this
+// whenever the header or the array layout below changes.
+static const int TACS_MESH_CACHE_VERSION = 1;
+
+/*
+  The header of a binary mesh cache file.
+
+  The header is followed by the mesh arrays in a fixed order: Xpts,
+  elem_node_ptr, elem_node_conn, elem_component, file_node_nums,
+  node_arg_sort_list, file_elem_nums, elem_arg_sort_list, bc_nodes,
+  bc_ptr, bc_vars, bc_vals, component_elems, component_descript. The
+  hash and size of the source BDF file are stored so that a stale
+  cache is rejected when the BDF changes.
+*/
+struct TacsMeshCacheHeader {
+  char magic[8];    // The string "TACSMESH"
+  int version;      // TACS_MESH_CACHE_VERSION
+  int scalar_size;  // sizeof(TacsScalar) - real/complex compatibility
+  uint64_t bdf_hash;  // FNV-1a hash of the source BDF file
+  uint64_t bdf_size;  // Size of the source BDF file in bytes
+
+  // The sizes of the mesh data
+  int num_nodes, num_elements, num_components, num_bcs;
+  int elem_conn_size, bc_vars_size;
+};
+
 /*
   The TACSMeshLoader class
 
@@ -455,6 +970,12 @@ TACSMeshLoader::TACSMeshLoader(MPI_Comm _comm) {
 
   // Set the creator object to NULL
   creator = NULL;
+
+  // By default, scan the file with a single thread
+  num_scan_threads = 1;
+
+  // The hash of the scanned BDF file
+  bdf_hash = bdf_size = 0;
 }
 
 /*
@@ -522,6 +1043,24 @@ TACSMeshLoader::~TACSMeshLoader() {
   }
 }
 
+/*
+  Set the number of threads used to scan the file.
+
+  The scan is threaded only on the root processor, where the file is
+  read. The chunks of the file are parsed by pthreads rather than by
+  distributing the file across processors, since the mesh data is
+  stored on the root processor until the TACSAssembler object is
+  created.
+*/
+void TACSMeshLoader::setNumThreads(int t) {
+  num_scan_threads = t;
+  if (num_scan_threads < 1) {
+    num_scan_threads = 1;
+  } else if (num_scan_threads > TACSThreadInfo::TACS_MAX_NUM_THREADS) {
+    num_scan_threads = TACSThreadInfo::TACS_MAX_NUM_THREADS;
+  }
+}
+
 /*
   Get the number of components defined by the data
 */
@@ -599,143 +1138,129 @@ int TACSMeshLoader::scanBDFFile(const char *file_name) {
     size_t buffer_len = ftell(fp);
     rewind(fp);
 
-    // Allocate enough space to store the entire file
-    char *buffer = new char[buffer_len];
-    if (fread(buffer, 1, buffer_len, fp) != buffer_len) {
-      fprintf(stderr, "[%d] TACSMeshLoader: Problem reading file %s\n", rank,
-              file_name);
-      MPI_Abort(comm, 1);
-      return 1;
+    // Map the file read-only so that the page-ins overlap with the
+    // parsing work. If the map fails, fall back to reading the entire
+    // file into memory.
+    int buffer_mapped = 1;
+    char *buffer =
+        (char *)mmap(NULL, buffer_len, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if (buffer == MAP_FAILED) {
+      buffer_mapped = 0;
+      buffer = new char[buffer_len];
+      if (fread(buffer, 1, buffer_len, fp) != buffer_len) {
+        fprintf(stderr, "[%d] TACSMeshLoader: Problem reading file %s\n", rank,
+                file_name);
+        MPI_Abort(comm, 1);
+        return 1;
+      }
     }
     fclose(fp);
 
-    // Keep track of where the current point in the buffer is
-    size_t buffer_loc = 0;
-    read_buffer_line(line, sizeof(line), &buffer_loc, buffer, buffer_len);
+    // Record the hash and size of the file to key the mesh cache
+    bdf_hash = hash_file_contents(buffer, buffer_len);
+    bdf_size = buffer_len;
 
-    // Flags which indicate where the bulk data begins
-    int in_bulk = 0;
-    int bulk_start = 0;
+    // Scan the file for the extent of the bulk data section. If no
+    // BEGIN BULK statement exists, then the whole file is treated as
+    // bulk data.
+    size_t buffer_loc = 0;
+    size_t bulk_start = 0;
+    size_t bulk_end = buffer_len;
 
-    // Scan the file for the begin bulk location. If none exists, then
-    // the whole file is treated as bulk data.
     while (buffer_loc < buffer_len) {
+      size_t line_start = buffer_loc;
+      read_buffer_line(line, sizeof(line), &buffer_loc, buffer, buffer_len);
       if (strncmp(line, "BEGIN BULK", 10) == 0) {
-        in_bulk = 1;
         bulk_start = buffer_loc;
+        bulk_end = buffer_len;
+      } else if (bulk_end == buffer_len &&
+                 (strncmp(line, "END BULK", 8) == 0 ||
+                  strncmp(line, "ENDDATA", 7) == 0)) {
+        bulk_end = line_start;
       }
-      read_buffer_line(line, sizeof(line), &buffer_loc, buffer, buffer_len);
     }
 
-    // Treat the entire file as bulk data
-    if (!in_bulk) {
-      in_bulk = 1;
+    // Carve the bulk data into card-aligned chunks. With more chunks
+    // than threads, a chunk that is dense in continuation lines does
+    // not leave the remaining threads idle.
+    int num_threads = num_scan_threads;
+    int num_chunks = 1;
+    if (num_threads > 1) {
+      num_chunks = 4 * num_threads;
     }
 
-    // Set the starting location
-    buffer_loc = bulk_start;
-
-    // Keep track of the maximum number of nodes defined by
-    // any of the elements
-    int max_element_conn = -1;
+    TacsScanChunk *chunks = new TacsScanChunk[num_chunks];
+    memset(chunks, 0, num_chunks * sizeof(TacsScanChunk));
+
+    size_t chunk_begin = bulk_start;
+    for (int c = 0; c < num_chunks; c++) {
+      size_t chunk_end = bulk_end;
+      if (c < num_chunks - 1) {
+        size_t target =
+            bulk_start + ((c + 1) * (bulk_end - bulk_start)) / num_chunks;
+        if (target < chunk_begin) {
+          target = chunk_begin;
+        }
+        chunk_end = next_card_location(target, buffer, bulk_end);
+      }
+      chunks[c].begin = chunk_begin;
+      chunks[c].end = chunk_end;
+      chunk_begin = chunk_end;
+    }
 
-    while (buffer_loc < buffer_len) {
-      // Read the first line of the buffer
-      size_t buffer_temp_loc = buffer_loc;
-      if (!read_buffer_line(line, sizeof(line), &buffer_temp_loc, buffer,
-                            buffer_len)) {
+    // Set the shared state for the scanning passes
+    TacsScanInfo info;
+    info.buffer = buffer;
+    info.buffer_len = buffer_len;
+    info.chunks = chunks;
+    info.num_chunks = num_chunks;
+    pthread_mutex_init(&info.comp_mutex, NULL);
+
+    // Count the entries within each chunk
+    scan_bdf_run(scan_bdf_count_job, &info, num_threads);
+
+    // Compute the totals and set the chunk output offsets from the
+    // exclusive prefix sums of the counts
+    int max_element_conn = 0;
+    int num_shell = 0;
+    for (int c = 0; c < num_chunks; c++) {
+      chunks[c].node_base = num_nodes;
+      chunks[c].elem_base = num_elements;
+      chunks[c].conn_base = elem_conn_size;
+      chunks[c].bc_base = num_bcs;
+      chunks[c].bc_var_base = bc_vars_size;
+      chunks[c].shell_base = num_shell;
+
+      num_nodes += chunks[c].num_nodes;
+      num_elements += chunks[c].num_elements;
+      elem_conn_size += chunks[c].conn_size;
+      num_bcs += chunks[c].num_bcs;
+      bc_vars_size += chunks[c].bc_vars_size;
+      num_shell += chunks[c].num_shell;
+
+      if (chunks[c].max_conn > max_element_conn) {
+        max_element_conn = chunks[c].max_conn;
+      }
+      if (chunks[c].max_comp > num_components) {
+        num_components = chunks[c].max_comp;
+      }
+      if (chunks[c].fail) {
         fail = 1;
-        break;
       }
+    }
 
-      if (line[0] != '$') {
-        if (in_bulk && (strncmp(line, "END BULK", 8) == 0 ||
-                        strncmp(line, "ENDDATA", 7) == 0)) {
-          buffer_temp_loc = buffer_len;
-        } else if (strncmp(line, "GRID*", 5) == 0) {
-          char line2[81];
-          if (!read_buffer_line(line2, sizeof(line2), &buffer_temp_loc, buffer,
-                                buffer_len)) {
-            fail = 1;
-            break;
-          }
-          int node;
-          double x, y, z;
-          parse_node_long_field(line, line2, &node, &x, &y, &z);
-          num_nodes++;
-        } else if (strncmp(line, "GRID", 4) == 0) {
-          int node;
-          double x, y, z;
-          parse_node_short_free_field(line, &node, &x, &y, &z);
-          num_nodes++;
-        } else if (strncmp(line, "SPC", 3) == 0) {
-          bc_vars_size += 8;
-          num_bcs++;
-        } else {
-          // Check the library of elements
-          int max_num_conn = -1;
-          int entry_width = 8;
-
-          // Loop over the number of types and determine the number of
-          // nodes
-          int index = -1;
-          for (int k = 0; k < TacsMeshLoaderNumElementTypes; k++) {
-            int len = strlen(TacsMeshLoaderElementTypes[k]);
-            if (strncmp(line, TacsMeshLoaderElementTypes[k], len) == 0) {
-              max_num_conn = TacsMeshLoaderElementLimits[k][1];
-              index = k;
-
-              // Check if we should use the extended width or not
-              if (line[len] == '*') {
-                entry_width = 16;
-              }
-              break;
-            }
-          }
-
-          if (index >= 0) {
-            // Find the number of entries in the element
-            int elem_num, component_num, num_conn;
-            buffer_temp_loc = buffer_loc;
-            int fail = parse_element_field(&buffer_temp_loc, buffer, buffer_len,
-                                           entry_width, max_num_conn, &elem_num,
-                                           &component_num, NULL, &num_conn);
-            if (fail) {
-              break;
-            }
-
-            // Check if the number of nodes is within the prescribed limits
-            if (num_conn < TacsMeshLoaderElementLimits[index][0]) {
-              fprintf(stderr,
-                      "TACSMeshLoader: Number of nodes for element %s "
-                      "not within limits\n",
-                      TacsMeshLoaderElementTypes[index]);
-              fail = 1;
-              break;
-            }
-
-            elem_conn_size += num_conn;
-            num_elements++;
-            if (num_conn > max_element_conn) {
-              max_element_conn = num_conn;
-            }
-            if (component_num > num_components) {
-              num_components = component_num;
-            }
-          } else {
-            fprintf(stderr,
-                    "TACSMeshLoader: Element not recognized. Line\n %s\n",
-                    line);
-          }
-        }
+    if (fail) {
+      pthread_mutex_destroy(&info.comp_mutex);
+      delete[] chunks;
+      if (buffer_mapped) {
+        munmap(buffer, buffer_len);
+      } else {
+        delete[] buffer;
       }
-
-      buffer_loc = buffer_temp_loc;
+      MPI_Abort(comm, fail);
+      return fail;
     }
 
-    // Allocate space to store the node numbers
-    int *temp_nodes = new int[max_element_conn];
-
     // Allocate space for everything
     file_node_nums = new int[num_nodes];
     double *file_Xpts = new double[3 * num_nodes];
@@ -762,198 +1287,37 @@ int TACSMeshLoader::scanBDFFile(const char *file_name) {
     memset(component_elems, '\0', 9 * num_components * sizeof(char));
     memset(component_descript, '\0', 33 * num_components * sizeof(char));
 
-    // Reset the sizes of the things to be read in
-    num_nodes = 0;
-    num_elements = 0;
-    num_bcs = 0;
-    elem_conn_size = 0;
-    bc_vars_size = 0;
-
-    // Rewind to the beginning of the bulk section and allocate everything
-    buffer_loc = bulk_start;
-
-    // Keep track of the component numbers loaded from an
-    // ICEM-generated bdf file
-    int component_counter = 0;
-
-    while (buffer_loc < buffer_len) {
-      // Read the first line of the buffer
-      size_t buffer_temp_loc = buffer_loc;
-      if (!read_buffer_line(line, sizeof(line), &buffer_temp_loc, buffer,
-                            buffer_len)) {
+    // Parse each chunk into its portion of the output arrays
+    info.max_element_conn = (max_element_conn > 0 ? max_element_conn : 1);
+    info.num_components = num_components;
+    info.file_node_nums = file_node_nums;
+    info.file_Xpts = file_Xpts;
+    info.file_elem_nums = file_elem_nums;
+    info.file_comp = file_comp;
+    info.file_conn = file_conn;
+    info.file_conn_ptr = file_conn_ptr;
+    info.bc_nodes = bc_nodes;
+    info.bc_ptr = bc_ptr;
+    info.bc_vars = bc_vars;
+    info.bc_vals = bc_vals;
+    info.component_elems = component_elems;
+    info.component_descript = component_descript;
+
+    scan_bdf_run(scan_bdf_fill_job, &info, num_threads);
+
+    for (int c = 0; c < num_chunks; c++) {
+      if (chunks[c].fail) {
         fail = 1;
-        break;
-      }
-
-      if (strncmp(line, "$       Shell", 13) == 0) {
-        // A standard icem output - description of each
-        // component. This is very useful for describing what the
-        // components actually are with a string.
-        // Again use a fixed width format
-        char comp[33];
-        int comp_num = component_counter;
-        component_counter++;
-
-        strncpy(comp, &line[41], 32);
-        comp[32] = '\0';
-        // Remove white space
-        if (comp_num >= 0 && comp_num < num_components) {
-          sscanf(comp, "%s", &component_descript[33 * comp_num]);
-        }
-      }
-      if (line[0] != '$') {  // A comment line
-        if (in_bulk && (strncmp(line, "END BULK", 8) == 0 ||
-                        strncmp(line, "ENDDATA", 7) == 0)) {
-          buffer_temp_loc = buffer_len;
-        } else if (strncmp(line, "GRID*", 5) == 0) {
-          char line2[81];
-          if (!read_buffer_line(line2, sizeof(line2), &buffer_temp_loc, buffer,
-                                buffer_len)) {
-            fail = 1;
-            break;
-          }
-          int node;
-          double x, y, z;
-          parse_node_long_field(line, line2, &node, &x, &y, &z);
-          file_node_nums[num_nodes] = node - 1;  // Get the C ordering
-          file_Xpts[3 * num_nodes] = x;
-          file_Xpts[3 * num_nodes + 1] = y;
-          file_Xpts[3 * num_nodes + 2] = z;
-          num_nodes++;
-        } else if (strncmp(line, "GRID", 4) == 0) {
-          int node;
-          double x, y, z;
-          parse_node_short_free_field(line, &node, &x, &y, &z);
-          file_node_nums[num_nodes] = node - 1;  // Get the C ordering
-          file_Xpts[3 * num_nodes] = x;
-          file_Xpts[3 * num_nodes + 1] = y;
-          file_Xpts[3 * num_nodes + 2] = z;
-          num_nodes++;
-        } else if (strncmp(line, "SPC", 3) == 0) {
-          // This is a variable-length format. Read in grid points until
-          // zero is reached. This is a fixed-width format
-          // SPC SID  G1  C  D
-
-          // Read in the nodal value
-          char node[9];
-          strncpy(node, &line[16], 8);
-          node[8] = '\0';
-          bc_nodes[num_bcs] = atoi(node) - 1;
-
-          strncpy(node, &line[32], 8);
-          node[8] = '\0';
-          double val = bdf_atof(node);
-
-          // Read in the dof that will be constrained
-          for (int k = 24; k < 32; k++) {
-            char dofs[9] = "12345678";
-
-            for (int j = 0; j < 8; j++) {
-              if (dofs[j] == line[k]) {
-                bc_vars[bc_vars_size] = j;
-                bc_vals[bc_vars_size] = val;
-                bc_vars_size++;
-                break;
-              }
-            }
-          }
-
-          bc_ptr[num_bcs + 1] = bc_vars_size;
-          num_bcs++;
-        } else {
-          // Check the library of elements
-          int max_num_conn = -1;
-          int entry_width = 8;
-
-          // Loop over the number of types and determine the number of
-          // nodes
-          int index = -1;
-          for (int k = 0; k < TacsMeshLoaderNumElementTypes; k++) {
-            int len = strlen(TacsMeshLoaderElementTypes[k]);
-            if (strncmp(line, TacsMeshLoaderElementTypes[k], len) == 0) {
-              max_num_conn = TacsMeshLoaderElementLimits[k][1];
-              index = k;
-
-              // Check if we should use the extended width or not
-              if (line[len] == '*') {
-                entry_width = 16;
-              }
-              break;
-            }
-          }
-
-          if (index >= 0) {
-            // Find the number of entries in the element
-            int elem_num, component_num, num_conn;
-            buffer_temp_loc = buffer_loc;
-            int fail = parse_element_field(
-                &buffer_temp_loc, buffer, buffer_len, entry_width, max_num_conn,
-                &elem_num, &component_num, temp_nodes, &num_conn);
-            if (fail) {
-              break;
-            }
-
-            if (strncmp(line, "CQUAD4", 6) == 0 ||
-                strncmp(line, "CQUADR", 6) == 0) {
-              file_conn[elem_conn_size] = temp_nodes[0] - 1;
-              file_conn[elem_conn_size + 1] = temp_nodes[1] - 1;
-              file_conn[elem_conn_size + 2] = temp_nodes[3] - 1;
-              file_conn[elem_conn_size + 3] = temp_nodes[2] - 1;
-            } else if (strncmp(line, "CQUAD9", 6) == 0 ||
-                       strncmp(line, "CQUAD", 5) == 0) {
-              file_conn[elem_conn_size] = temp_nodes[0] - 1;
-              file_conn[elem_conn_size + 1] = temp_nodes[4] - 1;
-              file_conn[elem_conn_size + 2] = temp_nodes[1] - 1;
-              file_conn[elem_conn_size + 3] = temp_nodes[7] - 1;
-              file_conn[elem_conn_size + 4] = temp_nodes[8] - 1;
-              file_conn[elem_conn_size + 5] = temp_nodes[5] - 1;
-              file_conn[elem_conn_size + 6] = temp_nodes[3] - 1;
-              file_conn[elem_conn_size + 7] = temp_nodes[6] - 1;
-              file_conn[elem_conn_size + 8] = temp_nodes[2] - 1;
-            } else if (strncmp(line, "CHEXA", 5) == 0) {
-              file_conn[elem_conn_size] = temp_nodes[0] - 1;
-              file_conn[elem_conn_size + 1] = temp_nodes[1] - 1;
-              file_conn[elem_conn_size + 2] = temp_nodes[3] - 1;
-              file_conn[elem_conn_size + 3] = temp_nodes[2] - 1;
-              file_conn[elem_conn_size + 4] = temp_nodes[4] - 1;
-              file_conn[elem_conn_size + 5] = temp_nodes[5] - 1;
-              file_conn[elem_conn_size + 6] = temp_nodes[7] - 1;
-              file_conn[elem_conn_size + 7] = temp_nodes[6] - 1;
-            } else {
-              for (int k = 0; k < num_conn; k++) {
-                file_conn[elem_conn_size + k] = temp_nodes[k] - 1;
-              }
-            }
-
-            // Set the node numbers
-            file_elem_nums[num_elements] = elem_num - 1;
-            file_comp[num_elements] = component_num - 1;
-
-            elem_conn_size += num_conn;
-            file_conn_ptr[num_elements + 1] = elem_conn_size;
-            num_elements++;
-
-            if (component_elems[9 * (component_num - 1)] == '\0') {
-              if (strncmp(line, "CTETRA", 6) == 0 && num_conn == 10) {
-                strcpy(&component_elems[9 * (component_num - 1)], "CTETRA10");
-              } else {
-                strcpy(&component_elems[9 * (component_num - 1)],
-                       TacsMeshLoaderElementTypes[index]);
-              }
-            }
-          } else {
-            fprintf(stderr,
-                    "TACSMeshLoader: Element not recognized. Line\n %s\n",
-                    line);
-          }
-        }
       }
-
-      buffer_loc = buffer_temp_loc;
     }
 
-    delete[] buffer;
-    delete[] temp_nodes;
+    pthread_mutex_destroy(&info.comp_mutex);
+    delete[] chunks;
+    if (buffer_mapped) {
+      munmap(buffer, buffer_len);
+    } else {
+      delete[] buffer;
+    }
 
     if (fail) {
       MPI_Abort(comm, fail);
@@ -1058,6 +1422,269 @@ int TACSMeshLoader::scanBDFFile(const char *file_name) {
   return fail;
 }
 
+/*
+  Copy an array out of the cache buffer and advance the read location
+*/
+static const char *cache_read(const char *ptr, void *dest, size_t len) {
+  memcpy(dest, ptr, len);
+  return ptr + len;
+}
+
+/*
+  Write a binary cache of the scanned mesh.
+
+  The cache stores the post-scan state of the loader - the
+  connectivity, node locations, boundary conditions and component
+  descriptors - together with the hash of the BDF file that was
+  scanned. Reading the cache back with scanMeshCache skips the BDF
+  parse entirely on repeated runs with the same mesh.
+*/
+int TACSMeshLoader::writeMeshCache(const char *file_name) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  int fail = 0;
+
+  const int root = 0;
+  if (rank == root) {
+    if (!(Xpts && elem_node_ptr && elem_node_conn && elem_component &&
+          file_node_nums && node_arg_sort_list && file_elem_nums &&
+          elem_arg_sort_list && bc_ptr)) {
+      // No mesh has been scanned
+      fail = 1;
+    } else {
+      FILE *fp = fopen(file_name, "wb");
+      if (!fp) {
+        fail = 1;
+      } else {
+        // Set the header for the cache file
+        TacsMeshCacheHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "TACSMESH", 8);
+        header.version = TACS_MESH_CACHE_VERSION;
+        header.scalar_size = sizeof(TacsScalar);
+        header.bdf_hash = bdf_hash;
+        header.bdf_size = bdf_size;
+        header.num_nodes = num_nodes;
+        header.num_elements = num_elements;
+        header.num_components = num_components;
+        header.num_bcs = num_bcs;
+        header.elem_conn_size = elem_node_ptr[num_elements];
+        header.bc_vars_size = bc_ptr[num_bcs];
+
+        // Write the header and the mesh arrays in order
+        fwrite(&header, sizeof(header), 1, fp);
+        fwrite(Xpts, sizeof(TacsScalar), 3 * num_nodes, fp);
+        fwrite(elem_node_ptr, sizeof(int), num_elements + 1, fp);
+        fwrite(elem_node_conn, sizeof(int), header.elem_conn_size, fp);
+        fwrite(elem_component, sizeof(int), num_elements, fp);
+        fwrite(file_node_nums, sizeof(int), num_nodes, fp);
+        fwrite(node_arg_sort_list, sizeof(int), num_nodes, fp);
+        fwrite(file_elem_nums, sizeof(int), num_elements, fp);
+        fwrite(elem_arg_sort_list, sizeof(int), num_elements, fp);
+        fwrite(bc_nodes, sizeof(int), num_bcs, fp);
+        fwrite(bc_ptr, sizeof(int), num_bcs + 1, fp);
+        fwrite(bc_vars, sizeof(int), header.bc_vars_size, fp);
+        fwrite(bc_vals, sizeof(TacsScalar), header.bc_vars_size, fp);
+        fwrite(component_elems, sizeof(char), 9 * num_components, fp);
+        fwrite(component_descript, sizeof(char), 33 * num_components, fp);
+
+        if (ferror(fp)) {
+          fail = 1;
+        }
+        fclose(fp);
+      }
+    }
+  }
+
+  // Ensure that all processors agree on the result
+  MPI_Bcast(&fail, 1, MPI_INT, root, comm);
+  return fail;
+}
+
+/*
+  Read the mesh from a binary cache written by writeMeshCache.
+
+  If bdf_name is given, the named BDF file is hashed and the cache is
+  rejected unless it was written from a file with identical contents.
+  A non-zero fail code is returned if the cache is missing, stale or
+  incompatible, in which case the caller should fall back to the BDF
+  file itself:
+
+  if (loader->scanMeshCache(cache_file, bdf_file)) {
+    loader->scanBDFFile(bdf_file);
+    loader->writeMeshCache(cache_file);
+  }
+*/
+int TACSMeshLoader::scanMeshCache(const char *file_name,
+                                  const char *bdf_name) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  int fail = 0;
+
+  const int root = 0;
+
+  // The contents of the cache file on the root processor
+  char *buffer = NULL;
+  size_t buffer_len = 0;
+  int buffer_mapped = 0;
+
+  if (rank == root) {
+    FILE *fp = fopen(file_name, "rb");
+    if (!fp) {
+      fail = 1;
+    } else {
+      // Determine the size of the file
+      fseek(fp, 0, SEEK_END);
+      buffer_len = ftell(fp);
+      rewind(fp);
+
+      // Map the cache read-only, falling back to reading it into memory
+      buffer_mapped = 1;
+      buffer =
+          (char *)mmap(NULL, buffer_len, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+      if (buffer == MAP_FAILED) {
+        buffer_mapped = 0;
+        buffer = new char[buffer_len];
+        if (fread(buffer, 1, buffer_len, fp) != buffer_len) {
+          delete[] buffer;
+          buffer = NULL;
+          fail = 1;
+        }
+      }
+      fclose(fp);
+    }
+  }
+
+  if (rank == root && !fail) {
+    // Check that the header matches this build and the source BDF
+    TacsMeshCacheHeader header;
+    if (buffer_len < sizeof(header)) {
+      fail = 1;
+    } else {
+      memcpy(&header, buffer, sizeof(header));
+      if (memcmp(header.magic, "TACSMESH", 8) != 0 ||
+          header.version != TACS_MESH_CACHE_VERSION ||
+          header.scalar_size != (int)sizeof(TacsScalar) ||
+          header.num_nodes < 0 || header.num_elements < 0 ||
+          header.num_components < 0 || header.num_bcs < 0 ||
+          header.elem_conn_size < 0 || header.bc_vars_size < 0) {
+        fail = 1;
+      } else if (bdf_name) {
+        uint64_t hash, size;
+        if (hash_file(bdf_name, &hash, &size) || hash != header.bdf_hash ||
+            size != header.bdf_size) {
+          fail = 1;
+        }
+      }
+    }
+
+    // Check that the file length matches the header
+    if (!fail) {
+      size_t expected =
+          sizeof(header) + 3 * (size_t)header.num_nodes * sizeof(TacsScalar) +
+          ((size_t)header.num_elements + 1) * sizeof(int) +
+          (size_t)header.elem_conn_size * sizeof(int) +
+          (size_t)header.num_elements * sizeof(int) +
+          2 * (size_t)header.num_nodes * sizeof(int) +
+          2 * (size_t)header.num_elements * sizeof(int) +
+          (size_t)header.num_bcs * sizeof(int) +
+          ((size_t)header.num_bcs + 1) * sizeof(int) +
+          (size_t)header.bc_vars_size * sizeof(int) +
+          (size_t)header.bc_vars_size * sizeof(TacsScalar) +
+          9 * (size_t)header.num_components * sizeof(char) +
+          33 * (size_t)header.num_components * sizeof(char);
+      if (buffer_len != expected) {
+        fail = 1;
+      }
+    }
+
+    if (!fail) {
+      // Set the sizes and copy the arrays out of the cache
+      num_nodes = header.num_nodes;
+      num_elements = header.num_elements;
+      num_components = header.num_components;
+      num_bcs = header.num_bcs;
+      bdf_hash = header.bdf_hash;
+      bdf_size = header.bdf_size;
+
+      const char *ptr = buffer + sizeof(header);
+
+      Xpts = new TacsScalar[3 * num_nodes];
+      ptr = cache_read(ptr, Xpts, 3 * num_nodes * sizeof(TacsScalar));
+
+      elem_node_ptr = new int[num_elements + 1];
+      ptr = cache_read(ptr, elem_node_ptr, (num_elements + 1) * sizeof(int));
+
+      elem_node_conn = new int[header.elem_conn_size];
+      ptr = cache_read(ptr, elem_node_conn, header.elem_conn_size * sizeof(int));
+
+      elem_component = new int[num_elements];
+      ptr = cache_read(ptr, elem_component, num_elements * sizeof(int));
+
+      file_node_nums = new int[num_nodes];
+      ptr = cache_read(ptr, file_node_nums, num_nodes * sizeof(int));
+
+      node_arg_sort_list = new int[num_nodes];
+      ptr = cache_read(ptr, node_arg_sort_list, num_nodes * sizeof(int));
+
+      file_elem_nums = new int[num_elements];
+      ptr = cache_read(ptr, file_elem_nums, num_elements * sizeof(int));
+
+      elem_arg_sort_list = new int[num_elements];
+      ptr = cache_read(ptr, elem_arg_sort_list, num_elements * sizeof(int));
+
+      bc_nodes = new int[num_bcs];
+      ptr = cache_read(ptr, bc_nodes, num_bcs * sizeof(int));
+
+      bc_ptr = new int[num_bcs + 1];
+      ptr = cache_read(ptr, bc_ptr, (num_bcs + 1) * sizeof(int));
+
+      bc_vars = new int[header.bc_vars_size];
+      ptr = cache_read(ptr, bc_vars, header.bc_vars_size * sizeof(int));
+
+      bc_vals = new TacsScalar[header.bc_vars_size];
+      ptr = cache_read(ptr, bc_vals, header.bc_vars_size * sizeof(TacsScalar));
+
+      component_elems = new char[9 * num_components];
+      ptr = cache_read(ptr, component_elems, 9 * num_components * sizeof(char));
+
+      component_descript = new char[33 * num_components];
+      ptr = cache_read(ptr, component_descript,
+                       33 * num_components * sizeof(char));
+    }
+  }
+
+  if (rank == root && buffer) {
+    if (buffer_mapped) {
+      munmap(buffer, buffer_len);
+    } else {
+      delete[] buffer;
+    }
+  }
+
+  // Check whether the read succeeded on the root processor
+  MPI_Bcast(&fail, 1, MPI_INT, root, comm);
+  if (fail) {
+    return fail;
+  }
+
+  // Distribute the component numbers and descriptions
+  MPI_Bcast(&num_components, 1, MPI_INT, root, comm);
+  if (rank != root) {
+    component_elems = new char[9 * num_components];
+    component_descript = new char[33 * num_components];
+  }
+  MPI_Bcast(component_elems, 9 * num_components, MPI_CHAR, root, comm);
+  MPI_Bcast(component_descript, 33 * num_components, MPI_CHAR, root, comm);
+
+  elements = new TACSElement *[num_components];
+  for (int k = 0; k < num_components; k++) {
+    elements[k] = NULL;
+  }
+
+  return fail;
+}
+
 /*
   Retrieve the number of nodes in the model
 */
@@ -55,6 +55,8 @@ const int TacsMeshLoaderElementLimits[][2] = {{2, 2},    // CBAR
   in to the object based on the component number.
 */
 
+#include <stdint.h>
+
 #include "TACSAuxElements.h"
 #include "TACSCreator.h"
 #include "TACSToFH5.h"
@@ -68,6 +70,15 @@ class TACSMeshLoader : public TACSObject {
   // -------------------------
   int scanBDFFile(const char *file_name);
 
+  // Set the number of threads used to scan the file
+  // -----------------------------------------------
+  void setNumThreads(int t);
+
+  // Read and write a binary cache of the scanned mesh
+  // -------------------------------------------------
+  int scanMeshCache(const char *file_name, const char *bdf_name = NULL);
+  int writeMeshCache(const char *file_name);
+
   // Get information about the mesh after scanning
   // ---------------------------------------------
   int getNumComponents();
@@ -124,6 +135,13 @@ class TACSMeshLoader : public TACSObject {
   // Communicator for all processors
   MPI_Comm comm;
 
+  // The number of threads used to scan the file on the root processor
+  int num_scan_threads;
+
+  // The hash and size of the scanned BDF file, used to key the
+  // binary mesh cache
+  uint64_t bdf_hash, bdf_size;
+
   // The underlying creator object
   TACSCreator *creator;
 
@@ -0,0 +1,191 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSOutputSink.h"
+
+#include <netdb.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/*
+  Create the callback sink
+
+  input:
+  callback:  the function invoked for each zone
+  ctx:       an opaque pointer passed through to the callback
+*/
+TACSCallbackSink::TACSCallbackSink(ZoneCallback _callback, void *_ctx) {
+  callback = _callback;
+  ctx = _ctx;
+}
+
+int TACSCallbackSink::beginOutput(MPI_Comm comm) { return 0; }
+
+int TACSCallbackSink::putZone(const char *zone_name, const char *var_names,
+                              TACSFH5File::FH5DataType dtype, int dim1,
+                              int dim2, const void *data) {
+  if (callback) {
+    return callback(ctx, zone_name, var_names, dtype, dim1, dim2, data);
+  }
+  return 0;
+}
+
+int TACSCallbackSink::endOutput() { return 0; }
+
+/*
+  Create the socket sink. The connection is established on the first
+  output pass.
+
+  input:
+  hostname:  the host name of the consumer
+  port:      the TCP port of the consumer
+*/
+TACSSocketSink::TACSSocketSink(const char *_hostname, int _port) {
+  hostname = new char[strlen(_hostname) + 1];
+  strcpy(hostname, _hostname);
+  port = _port;
+  fd = -1;
+}
+
+TACSSocketSink::~TACSSocketSink() {
+  if (fd >= 0) {
+    close(fd);
+  }
+  delete[] hostname;
+}
+
+/*
+  Resolve the host name, connect to the consumer and send the stream
+  header
+*/
+int TACSSocketSink::connectSocket() {
+  char service[16];
+  snprintf(service, sizeof(service), "%d", port);
+
+  struct addrinfo hints, *result = NULL;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  if (getaddrinfo(hostname, service, &hints, &result) != 0 || !result) {
+    fprintf(stderr, "TACSSocketSink: Could not resolve host %s\n", hostname);
+    return 1;
+  }
+
+  int fail = 1;
+  for (struct addrinfo *rp = result; rp; rp = rp->ai_next) {
+    fd = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol);
+    if (fd >= 0) {
+      if (connect(fd, rp->ai_addr, rp->ai_addrlen) == 0) {
+        fail = 0;
+        break;
+      }
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(result);
+
+  if (fail) {
+    fprintf(stderr, "TACSSocketSink: Could not connect to %s:%d\n", hostname,
+            port);
+    return 1;
+  }
+
+  // Send the stream header
+  int version = 1;
+  fail = writeBlock("FH5S", 4);
+  fail = fail || writeBlock(&version, sizeof(int));
+  return fail;
+}
+
+/*
+  Write the full buffer to the socket, restarting from short writes
+*/
+int TACSSocketSink::writeBlock(const void *buf, size_t len) {
+  const char *ptr = (const char *)buf;
+  while (len > 0) {
+    ssize_t n = write(fd, ptr, len);
+    if (n <= 0) {
+      fprintf(stderr, "TACSSocketSink: Write to %s:%d failed\n", hostname,
+              port);
+      close(fd);
+      fd = -1;
+      return 1;
+    }
+    ptr += n;
+    len -= n;
+  }
+  return 0;
+}
+
+int TACSSocketSink::beginOutput(MPI_Comm comm) {
+  if (fd < 0) {
+    if (connectSocket()) {
+      return 1;
+    }
+  }
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  int msg[3];
+  msg[0] = 1;  // begin
+  msg[1] = rank;
+  msg[2] = size;
+  return writeBlock(msg, sizeof(msg));
+}
+
+int TACSSocketSink::putZone(const char *zone_name, const char *var_names,
+                            TACSFH5File::FH5DataType dtype, int dim1,
+                            int dim2, const void *data) {
+  if (fd < 0) {
+    return 1;
+  }
+
+  size_t dsize = sizeof(double);
+  if (dtype == TACSFH5File::FH5_INT) {
+    dsize = sizeof(int);
+  } else if (dtype == TACSFH5File::FH5_FLOAT) {
+    dsize = sizeof(float);
+  }
+
+  int name_len = strlen(zone_name) + 1;
+  int vars_len = strlen(var_names) + 1;
+  long nbytes = dsize * dim1 * dim2;
+
+  int msg = 2;  // zone
+  int fail = writeBlock(&msg, sizeof(int));
+  fail = fail || writeBlock(&name_len, sizeof(int));
+  fail = fail || writeBlock(zone_name, name_len);
+  fail = fail || writeBlock(&vars_len, sizeof(int));
+  fail = fail || writeBlock(var_names, vars_len);
+
+  int header[3];
+  header[0] = dtype;
+  header[1] = dim1;
+  header[2] = dim2;
+  fail = fail || writeBlock(header, sizeof(header));
+  fail = fail || writeBlock(&nbytes, sizeof(long));
+  fail = fail || writeBlock(data, nbytes);
+  return fail;
+}
+
+int TACSSocketSink::endOutput() {
+  if (fd < 0) {
+    return 1;
+  }
+  int msg = 3;  // end
+  return writeBlock(&msg, sizeof(int));
+}
@@ -0,0 +1,120 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_OUTPUT_SINK_H
+#define TACS_OUTPUT_SINK_H
+
+/*
+  In-situ output sinks for the staged FH5 zone data
+*/
+
+#include "TACSFH5.h"
+
+/**
+  Interface for in-situ consumers of the staged output data.
+
+  TACSToFH5::writeToSink() stages the output zones - the same
+  component and field selection as writeToFile() - and delivers each
+  zone to the sink instead of writing a file. The data passed to
+  putZone() is the local contribution of the calling process; the
+  sink is responsible for any aggregation across the communicator.
+
+  The zone buffers are owned by the caller and are freed after
+  endOutput() returns, so a sink that retains the data must copy it.
+*/
+class TACSOutputSink : public TACSObject {
+ public:
+  virtual ~TACSOutputSink() {}
+
+  // Called once per output pass before the first zone
+  virtual int beginOutput(MPI_Comm comm) = 0;
+
+  // Deliver the local portion of a single zone of output data
+  virtual int putZone(const char *zone_name, const char *var_names,
+                      TACSFH5File::FH5DataType dtype, int dim1, int dim2,
+                      const void *data) = 0;
+
+  // Called once per output pass after the last zone
+  virtual int endOutput() = 0;
+};
+
+/**
+  Output sink that forwards each zone to a registered C callback.
+
+  This is the lightest-weight way to embed a monitoring consumer in
+  the same process: the callback receives the packed zone buffers
+  directly with no serialization or copies beyond the staging that
+  writeToFile() would perform anyway.
+*/
+class TACSCallbackSink : public TACSOutputSink {
+ public:
+  // The callback signature. A non-zero return value is reported as a
+  // failure of the output pass.
+  typedef int (*ZoneCallback)(void *ctx, const char *zone_name,
+                              const char *var_names, int dtype, int dim1,
+                              int dim2, const void *data);
+
+  TACSCallbackSink(ZoneCallback callback, void *ctx = NULL);
+
+  int beginOutput(MPI_Comm comm);
+  int putZone(const char *zone_name, const char *var_names,
+              TACSFH5File::FH5DataType dtype, int dim1, int dim2,
+              const void *data);
+  int endOutput();
+
+ private:
+  ZoneCallback callback;
+  void *ctx;
+};
+
+/**
+  Output sink that streams the zones to a TCP socket.
+
+  Each process opens its own connection to the given host and port on
+  the first output pass and keeps it open across passes, so a long
+  transient streams to a live consumer with no intermediate files.
+
+  The stream is a sequence of framed messages in the native byte
+  order of the sender:
+
+  connect:  the characters "FH5S" followed by int version
+  begin:    int 1, int rank, int size
+  zone:     int 2, int name_len, name, int vars_len, var_names,
+            int dtype, int dim1, int dim2, long nbytes, payload
+  end:      int 3
+
+  The string lengths include the terminating zero.
+*/
+class TACSSocketSink : public TACSOutputSink {
+ public:
+  TACSSocketSink(const char *hostname, int port);
+  ~TACSSocketSink();
+
+  int beginOutput(MPI_Comm comm);
+  int putZone(const char *zone_name, const char *var_names,
+              TACSFH5File::FH5DataType dtype, int dim1, int dim2,
+              const void *data);
+  int endOutput();
+
+ private:
+  // Connect to the consumer and send the stream header
+  int connectSocket();
+
+  // Write the full buffer to the socket
+  int writeBlock(const void *buf, size_t len);
+
+  char *hostname;
+  int port;
+  int fd;  // The socket descriptor, or -1 when not connected
+};
+
+#endif  // TACS_OUTPUT_SINK_H
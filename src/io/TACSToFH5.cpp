@@ -18,6 +18,8 @@
 
 #include "TACSToFH5.h"
 
+#include "TACSProfiler.h"
+
 /**
    Create the TACSToFH5 object.
 
@@ -69,12 +71,47 @@ TACSToFH5::TACSToFH5(TACSAssembler *_assembler, ElementType _elem_type,
     sprintf(comp_name, "Component %d", k);
     setComponentName(k, comp_name);
   }
+
+  // All components are written unless setOutputComponents is called
+  num_output_comps = 0;
+  output_comps = NULL;
+
+  // No MPI-IO hints are applied unless setWriteHint is called
+  write_info = MPI_INFO_NULL;
+
+  // Data is written uncompressed unless setCompression is called
+  use_compression = 0;
+  compress_mantissa_bits = 23;
+
+  // No smoothed data zone unless setElementSmoothing is called
+  use_smoothing = 0;
+
+  // Writes are synchronous unless setAsyncWrites is called
+  async_writes = 0;
+  write_comm = MPI_COMM_NULL;
+  write_active = 0;
+  write_fail = 0;
+  write_filename = NULL;
+  write_zones = NULL;
+
+  // No borrowed extraction data outside of a grouped write
+  shared_element_zone = NULL;
+  shared_smoothed_zone = NULL;
 }
 
 /**
    Free the FH5 object
 */
 TACSToFH5::~TACSToFH5() {
+  // Complete any background write before freeing anything
+  waitForWrites();
+  if (write_comm != MPI_COMM_NULL) {
+    MPI_Comm_free(&write_comm);
+  }
+  if (write_info != MPI_INFO_NULL) {
+    MPI_Info_free(&write_info);
+  }
+
   assembler->decref();
 
   // Deallocate the comma separated list of variable names
@@ -87,6 +124,10 @@ TACSToFH5::~TACSToFH5() {
     }
   }
   delete[] component_names;
+
+  if (output_comps) {
+    delete[] output_comps;
+  }
 }
 
 /**
@@ -111,6 +152,33 @@ void TACSToFH5::setComponentName(int comp_num, const char *comp_name) {
   }
 }
 
+/**
+   Restrict the element data output to a set of component numbers
+
+   Only the elements belonging to the listed components are evaluated
+   when the element data is extracted; the data for the remaining
+   elements is written as zero. This keeps in-situ monitoring outputs
+   - a few components of a handful of fields every time step - from
+   paying the extraction cost of the full mesh. Passing a zero count
+   restores the default of writing every component.
+
+   @param num_comps The number of component numbers in the list
+   @param comp_nums The component numbers to output
+*/
+void TACSToFH5::setOutputComponents(int num_comps, const int *comp_nums) {
+  if (output_comps) {
+    delete[] output_comps;
+    output_comps = NULL;
+  }
+
+  num_output_comps = 0;
+  if (num_comps > 0 && comp_nums) {
+    num_output_comps = num_comps;
+    output_comps = new int[num_comps];
+    memcpy(output_comps, comp_nums, num_comps * sizeof(int));
+  }
+}
+
 /**
    Write the data stored in the TACSAssembler object to a file
 
@@ -121,30 +189,596 @@ void TACSToFH5::setComponentName(int comp_num, const char *comp_name) {
    data can be expensive and take considerable diskspace, so care
    should be exercised when creating these files.
 
+   When asynchronous writes are enabled with setAsyncWrites, the
+   output data is staged on the calling thread and the file itself is
+   written by a background thread, so that computation can proceed
+   while the write is in flight. In that case the returned fail code
+   refers to the previous write, which is completed before the new
+   data is staged; call waitForWrites to complete the last write.
+
    @param filename The name of the file to write
 */
 int TACSToFH5::writeToFile(const char *filename) {
-  int rank, size;
-  MPI_Comm_rank(assembler->getMPIComm(), &rank);
-  MPI_Comm_size(assembler->getMPIComm(), &size);
+  TacsProfileScope profile("TACSToFH5::writeToFile");
+
+  // Complete any write that is still in flight before staging the
+  // new output data
+  int fail = waitForWrites();
+
+  // Stage the output data. This performs all of the element-level
+  // computations and inter-processor exchanges on the calling thread.
+  FH5ZoneData *zones = gatherZoneData();
+
+  // Record the volume of data staged for output
+  double nbytes = 0.0;
+  for (FH5ZoneData *zone = zones; zone; zone = zone->next) {
+    double dsize = sizeof(double);
+    if (zone->dtype == TACSFH5File::FH5_INT) {
+      dsize = sizeof(int);
+    } else if (zone->dtype == TACSFH5File::FH5_FLOAT) {
+      dsize = sizeof(float);
+    }
+    nbytes += dsize * zone->dim1 * zone->dim2;
+  }
+  TacsProfileAddCount("TACSToFH5 bytes written", nbytes);
+
+  if (async_writes) {
+    // Hand the staged data to the background writer thread
+    write_zones = zones;
+    write_filename = new char[strlen(filename) + 1];
+    strcpy(write_filename, filename);
+    pthread_create(&write_thread, NULL, writeFileJob, this);
+    write_active = 1;
+  } else {
+    fail = writeZones(filename, assembler->getMPIComm(), zones);
+  }
+
+  return fail;
+}
+
+/*
+  Check whether the element data extraction of the other writer can be
+  shared with this one: the same assembler, element type, field
+  selection and component filter produce identical packed data
+*/
+int TACSToFH5::matchesExtraction(TACSToFH5 *other) {
+  if (assembler != other->assembler || elem_type != other->elem_type ||
+      element_write_flag != other->element_write_flag ||
+      nvals != other->nvals || num_output_comps != other->num_output_comps) {
+    return 0;
+  }
+  for (int i = 0; i < num_output_comps; i++) {
+    if (output_comps[i] != other->output_comps[i]) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+  Write several output pipelines concurrently from one extraction
+  pass.
+
+  Writing displacement, stress and checkpoint files per transient step
+  through separate writeToFile() calls costs one element extraction
+  sweep per file plus serialized writes. This call stages all of the
+  writers first - writers with the same element type, field selection
+  and component filter share the packed data from a single
+  getElementOutputData sweep - and then overlaps the file writes:
+  each writer with a duplicated writer-thread communicator performs
+  its MPI-IO on a background thread. The communicator is created on
+  demand when the MPI library provides MPI_THREAD_MULTIPLE; otherwise
+  that writer falls back to a synchronous write.
+
+  On return, the writes of the writers without asynchronous output
+  enabled have completed; a writer with setAsyncWrites() enabled keeps
+  its write in flight, exactly as writeToFile() would.
+
+  @param num_writers The number of output writers
+  @param writers The writers, each with its own staging and settings
+  @param filenames The output file name for each writer
+  @return Non-zero if any completed write failed
+*/
+int TACSToFH5::writeFiles(int num_writers, TACSToFH5 **writers,
+                          const char *const *filenames) {
+  TacsProfileScope profile("TACSToFH5::writeFiles");
+
+  // Complete any writes that are still in flight before staging the
+  // new output data
+  int fail = 0;
+  for (int k = 0; k < num_writers; k++) {
+    fail = writers[k]->waitForWrites() || fail;
+  }
+
+  // Stage all of the zone lists, sharing the packed element data
+  // between writers with the same extraction signature
+  FH5ZoneData **zones = new FH5ZoneData *[num_writers];
+  for (int k = 0; k < num_writers; k++) {
+    TACSToFH5 *f5 = writers[k];
+    for (int j = 0; j < k; j++) {
+      if (f5->matchesExtraction(writers[j])) {
+        for (FH5ZoneData *zone = zones[j]; zone; zone = zone->next) {
+          if (strncmp(zone->zone_name, "element data", 12) == 0) {
+            f5->shared_element_zone = zone;
+          } else if (strncmp(zone->zone_name, "smoothed data", 13) == 0) {
+            f5->shared_smoothed_zone = zone;
+          }
+        }
+        break;
+      }
+    }
+    zones[k] = f5->gatherZoneData();
+    f5->shared_element_zone = NULL;
+    f5->shared_smoothed_zone = NULL;
+  }
+
+  // Launch the writes so that they overlap. Create the duplicated
+  // writer-thread communicator on demand where the MPI library
+  // permits it.
+  for (int k = 0; k < num_writers; k++) {
+    TACSToFH5 *f5 = writers[k];
+    if (f5->write_comm == MPI_COMM_NULL) {
+      int provided;
+      MPI_Query_thread(&provided);
+      if (provided >= MPI_THREAD_MULTIPLE) {
+        MPI_Comm_dup(f5->assembler->getMPIComm(), &f5->write_comm);
+      }
+    }
+
+    if (f5->write_comm != MPI_COMM_NULL) {
+      f5->write_zones = zones[k];
+      f5->write_filename = new char[strlen(filenames[k]) + 1];
+      strcpy(f5->write_filename, filenames[k]);
+      pthread_create(&f5->write_thread, NULL, writeFileJob, f5);
+      f5->write_active = 1;
+    } else {
+      fail = f5->writeZones(filenames[k], f5->assembler->getMPIComm(),
+                            zones[k]) ||
+             fail;
+    }
+  }
+
+  // Complete the writes for the writers that are not configured for
+  // free-running asynchronous output
+  for (int k = 0; k < num_writers; k++) {
+    if (!writers[k]->async_writes) {
+      fail = writers[k]->waitForWrites() || fail;
+    }
+  }
+
+  delete[] zones;
+  return fail;
+}
+
+/**
+  Deliver the staged output data to an in-situ sink.
+
+  This performs the same component and field selection and the same
+  staging as writeToFile(), but hands the packed zone buffers to the
+  sink instead of writing a file - there is no intermediate file and
+  no duplicated serialization for live consumers. Each process
+  delivers its local contribution; the sink sees the zones in the
+  same order that writeToFile() writes them.
+
+  The staged buffers are freed when this call returns, so a sink that
+  retains the data must copy it.
+
+  @param sink The in-situ consumer of the output data
+*/
+int TACSToFH5::writeToSink(TACSOutputSink *sink) {
+  TacsProfileScope profile("TACSToFH5::writeToSink");
+
+  // Complete any file write that is still in flight before staging
+  // the new output data
+  int fail = waitForWrites();
+
+  // Stage the output data
+  FH5ZoneData *zones = gatherZoneData();
+
+  // Deliver the zones to the sink
+  if (sink->beginOutput(assembler->getMPIComm())) {
+    fail = 1;
+  } else {
+    for (FH5ZoneData *zone = zones; zone; zone = zone->next) {
+      if (sink->putZone(zone->zone_name, zone->var_names, zone->dtype,
+                        zone->dim1, zone->dim2, zone->data)) {
+        fail = 1;
+        break;
+      }
+    }
+    if (sink->endOutput()) {
+      fail = 1;
+    }
+  }
+
+  // Free the staged zones
+  while (zones) {
+    FH5ZoneData *next = zones->next;
+    delete zones;
+    zones = next;
+  }
+
+  return fail;
+}
+
+/**
+   Write a block of nodal derivative fields to a single file.
+
+   This stages all of the vectors - typically the design-variable
+   sensitivities of the state at a checkpoint - into one continuous
+   data zone with the components of every vector stored per node, and
+   writes them through the same zone machinery as writeToFile(). The
+   entire block is packed in a single sweep into one shared staging
+   buffer and results in one file, rather than assembling a separate
+   output pass and file per vector.
+
+   The connectivity and node locations are included when the write
+   flag selects them, so the file can be visualized on its own. Each
+   vector must be created by the assembler associated with this
+   object. If vector names are supplied, the components are named
+   <name>_v<k>; otherwise they default to dv<i>_v<k>. When
+   asynchronous writes are enabled the write proceeds in the
+   background, as in writeToFile().
+
+   @param filename The name of the file to write
+   @param num_vecs The number of vectors in the block
+   @param vecs The array of nodal vectors to write
+   @param vec_names Optional names for each of the vectors
+*/
+int TACSToFH5::writeSensitivitiesToFile(const char *filename, int num_vecs,
+                                        TACSBVec **vecs,
+                                        const char **vec_names) {
+  TacsProfileScope profile("TACSToFH5::writeSensitivitiesToFile");
+
+  if (num_vecs <= 0) {
+    return 0;
+  }
+
+  // Complete any write that is still in flight before staging the
+  // new output data
+  int fail = waitForWrites();
+
+  FH5ZoneData *zones = NULL;
+  FH5ZoneData **tail = &zones;
+
+  if (write_flag & TACS_OUTPUT_CONNECTIVITY) {
+    tail = gatherConnectivity(tail);
+  }
+
+  int vars_per_node = assembler->getVarsPerNode();
+
+  // Compute the dimensions of the staged data
+  int nnodes = assembler->getNumOwnedNodes();
+  int ndep = assembler->getNumDependentNodes();
+  int dim1 = nnodes + ndep;
+
+  int field_offset = 0;
+  if (write_flag & TACS_OUTPUT_NODES) {
+    field_offset = 3;
+  }
+  int dim2 = field_offset + num_vecs * vars_per_node;
+
+  // Assemble the comma-separated component names
+  size_t str_len = strlen("X,Y,Z") + 1;
+  for (int i = 0; i < num_vecs; i++) {
+    char stemp[64];
+    const char *name = stemp;
+    if (vec_names && vec_names[i]) {
+      name = vec_names[i];
+    } else {
+      sprintf(stemp, "dv%d", i);
+    }
+    str_len += vars_per_node * (strlen(name) + 16);
+  }
+
+  char *var_names = new char[str_len];
+  var_names[0] = '\0';
+  if (write_flag & TACS_OUTPUT_NODES) {
+    sprintf(var_names, "X,Y,Z");
+  }
+  for (int i = 0; i < num_vecs; i++) {
+    char stemp[64];
+    const char *name = stemp;
+    if (vec_names && vec_names[i]) {
+      name = vec_names[i];
+    } else {
+      sprintf(stemp, "dv%d", i);
+    }
+    for (int k = 0; k < vars_per_node; k++) {
+      size_t len = strlen(var_names);
+      if (len == 0) {
+        sprintf(&(var_names[len]), "%s_v%d", name, k);
+      } else {
+        sprintf(&(var_names[len]), ",%s_v%d", name, k);
+      }
+    }
+  }
+
+  // Pack all of the fields into the shared staging buffer in a
+  // single sweep over the nodes
+  float *float_data = new float[dim1 * dim2];
+
+  if (write_flag & TACS_OUTPUT_NODES) {
+    TACSBVec *X;
+    assembler->getNodes(&X);
+
+    TacsScalar *Xarray;
+    X->getArray(&Xarray);
+    for (int i = 0; i < nnodes; i++) {
+      for (int j = 0; j < 3; j++) {
+        float_data[dim2 * i + j] = TacsRealPart(Xarray[3 * i + j]);
+      }
+    }
+
+    X->getDepArray(&Xarray);
+    for (int i = 0; i < ndep; i++) {
+      for (int j = 0; j < 3; j++) {
+        float_data[dim2 * (i + nnodes) + j] = TacsRealPart(Xarray[3 * i + j]);
+      }
+    }
+  }
+
+  for (int n = 0; n < num_vecs; n++) {
+    int offset = field_offset + n * vars_per_node;
+
+    TacsScalar *array;
+    vecs[n]->getArray(&array);
+    for (int i = 0; i < nnodes; i++) {
+      for (int j = 0; j < vars_per_node; j++) {
+        float_data[dim2 * i + offset + j] =
+            TacsRealPart(array[vars_per_node * i + j]);
+      }
+    }
+
+    array = NULL;
+    vecs[n]->getDepArray(&array);
+    for (int i = 0; i < ndep; i++) {
+      for (int j = 0; j < vars_per_node; j++) {
+        float_data[dim2 * (i + nnodes) + offset + j] =
+            (array ? TacsRealPart(array[vars_per_node * i + j]) : 0.0f);
+      }
+    }
+  }
+
+  // Stage the data with a time stamp from the simulation in TACS
+  char data_name[128];
+  double t = assembler->getSimulationTime();
+  sprintf(data_name, "continuous data t=%.10e", t);
+
+  FH5ZoneData *zone = new FH5ZoneData();
+  zone->zone_name = new char[strlen(data_name) + 1];
+  strcpy(zone->zone_name, data_name);
+  zone->var_names = var_names;
+  zone->dtype = TACSFH5File::FH5_FLOAT;
+  zone->dim1 = dim1;
+  zone->dim2 = dim2;
+  zone->data = float_data;
+  *tail = zone;
+  tail = &zone->next;
+
+  // Record the volume of data staged for output
+  double nbytes = 0.0;
+  for (FH5ZoneData *z = zones; z; z = z->next) {
+    double dsize = sizeof(double);
+    if (z->dtype == TACSFH5File::FH5_INT) {
+      dsize = sizeof(int);
+    } else if (z->dtype == TACSFH5File::FH5_FLOAT) {
+      dsize = sizeof(float);
+    }
+    nbytes += dsize * z->dim1 * z->dim2;
+  }
+  TacsProfileAddCount("TACSToFH5 bytes written", nbytes);
+
+  if (async_writes) {
+    // Hand the staged data to the background writer thread
+    write_zones = zones;
+    write_filename = new char[strlen(filename) + 1];
+    strcpy(write_filename, filename);
+    pthread_create(&write_thread, NULL, writeFileJob, this);
+    write_active = 1;
+  } else {
+    fail = writeZones(filename, assembler->getMPIComm(), zones);
+  }
+
+  return fail;
+}
+
+/**
+   Set an MPI-IO hint that is applied when the output file is opened.
+
+   All of the file data is written with collective MPI-IO calls, so
+   the hints control the two-phase aggregation performed by the MPI-IO
+   layer. On striped file systems such as Lustre, aggregating the
+   writes onto one writer per node or per stripe avoids the
+   small-stripe traffic generated by having every rank write its own
+   slab. Typical hints are romio_cb_write, cb_nodes and
+   cb_buffer_size for the aggregators, and striping_unit and
+   striping_factor to align the aggregated writes with the stripes.
+
+   The hints must be set consistently on all processes.
+
+   @param key The name of the MPI-IO hint
+   @param value The value of the hint
+*/
+void TACSToFH5::setWriteHint(const char *key, const char *value) {
+  if (write_info == MPI_INFO_NULL) {
+    MPI_Info_create(&write_info);
+  }
+  MPI_Info_set(write_info, key, value);
+}
+
+/**
+   Enable or disable compression of the solution data zones.
+
+   When enabled, the float-valued solution zones are written as
+   independently compressed chunks through writeZoneDataCompressed.
+   Setting mantissa_bits < 23 discards the trailing mantissa bits of
+   each value, which is lossy but acceptable for data that is only
+   used for visualization; the default retains full float precision.
+   When asynchronous writes are enabled the compression also runs on
+   the background writer thread, off the solution path.
+
+   @param flag Non-zero to compress the solution data zones
+   @param mantissa_bits The number of mantissa bits to retain (0--23)
+*/
+void TACSToFH5::setCompression(int flag, int mantissa_bits) {
+  use_compression = flag;
+  if (mantissa_bits < 0) {
+    mantissa_bits = 0;
+  }
+  if (mantissa_bits > 23) {
+    mantissa_bits = 23;
+  }
+  compress_mantissa_bits = mantissa_bits;
+}
+
+/**
+   Enable or disable the smoothed nodal element data zone.
+
+   When enabled, a "smoothed data" zone is staged alongside the
+   element data zone with the same variables, holding one row per
+   node. The values are recovered by fitting a linear polynomial to
+   the element-local values over the patch of elements surrounding
+   each node, which filters the inter-element jumps in the stress and
+   strain outputs without any post-processing of the output files.
+   See TACSAssembler::getSmoothedOutputData for the details of the
+   patch fits.
+
+   @param flag Non-zero to write the smoothed data zone
+*/
+void TACSToFH5::setElementSmoothing(int flag) { use_smoothing = flag; }
+
+/**
+   Enable or disable asynchronous writes.
+
+   Asynchronous writes are double-buffered: writeToFile copies the
+   output data into freshly staged zones and a background thread
+   performs the MPI-IO on a duplicated communicator, so collective
+   calls on the assembler communicator can proceed concurrently. This
+   requires MPI_THREAD_MULTIPLE support from the MPI library; if that
+   is unavailable, the writes stay synchronous and a warning is
+   printed.
+
+   @param flag Non-zero to enable asynchronous writes
+*/
+void TACSToFH5::setAsyncWrites(int flag) {
+  if (flag && write_comm == MPI_COMM_NULL) {
+    int provided;
+    MPI_Query_thread(&provided);
+    if (provided < MPI_THREAD_MULTIPLE) {
+      int rank;
+      MPI_Comm_rank(assembler->getMPIComm(), &rank);
+      if (rank == 0) {
+        fprintf(stderr,
+                "TACSToFH5 warning: Asynchronous writes require "
+                "MPI_THREAD_MULTIPLE support. Writes will be synchronous\n");
+      }
+      async_writes = 0;
+      return;
+    }
+
+    // Duplicate the communicator for the writer thread so that its
+    // collective calls cannot interleave with those on the assembler
+    // communicator
+    MPI_Comm_dup(assembler->getMPIComm(), &write_comm);
+  }
+
+  async_writes = (flag != 0) && (write_comm != MPI_COMM_NULL);
+}
+
+/**
+   Wait for the write in flight, if any, to complete.
+
+   @return The fail code from the last asynchronous write
+*/
+int TACSToFH5::waitForWrites() {
+  int fail = 0;
+  if (write_active) {
+    pthread_join(write_thread, NULL);
+    write_active = 0;
+    delete[] write_filename;
+    write_filename = NULL;
+    fail = write_fail;
+  }
+  return fail;
+}
+
+/**
+  The entry point for the background writer thread
+*/
+void *TACSToFH5::writeFileJob(void *arg) {
+  TACSToFH5 *f5 = static_cast<TACSToFH5 *>(arg);
+  f5->write_fail =
+      f5->writeZones(f5->write_filename, f5->write_comm, f5->write_zones);
+  f5->write_zones = NULL;
+  return NULL;
+}
+
+/**
+  Write the staged zones to the named file and free them
+*/
+int TACSToFH5::writeZones(const char *filename, MPI_Comm comm,
+                          FH5ZoneData *zones) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
 
   // Create the FH5 file object for writting
-  TACSFH5File *file = new TACSFH5File(assembler->getMPIComm());
+  TACSFH5File *file = new TACSFH5File(comm);
   file->incref();
 
   // Open the file - if possible for writing
-  int fail = file->createFile(filename, num_components, component_names);
+  int fail =
+      file->createFile(filename, num_components, component_names, write_info);
 
   if (fail) {
     file->decref();
     if (rank == 0) {
       fprintf(stderr, "[%d] TACSToFH5 error: Could not create file\n", rank);
     }
-    return 1;
+    fail = 1;
+  } else {
+    for (FH5ZoneData *zone = zones; zone; zone = zone->next) {
+      if (use_compression && zone->dtype == TACSFH5File::FH5_FLOAT) {
+        // Compress the solution data zones. The connectivity zones
+        // are left uncompressed so that older readers can still scan
+        // the mesh from the file.
+        file->writeZoneDataCompressed(zone->zone_name, zone->var_names,
+                                      zone->dim1, zone->dim2,
+                                      (float *)zone->data, NULL,
+                                      compress_mantissa_bits);
+      } else {
+        file->writeZoneData(zone->zone_name, zone->var_names, zone->dtype,
+                            zone->dim1, zone->dim2, zone->data);
+      }
+    }
+
+    file->close();
+    file->decref();
   }
 
+  // Free the staged zones
+  while (zones) {
+    FH5ZoneData *next = zones->next;
+    delete zones;
+    zones = next;
+  }
+
+  return fail;
+}
+
+/**
+  Stage the output data into a list of zones.
+
+  This gathers the element output, the nodal data and the
+  connectivity in the same order that they were previously written
+  directly to the file.
+*/
+TACSToFH5::FH5ZoneData *TACSToFH5::gatherZoneData() {
+  FH5ZoneData *zones = NULL;
+  FH5ZoneData **tail = &zones;
+
   if (write_flag & TACS_OUTPUT_CONNECTIVITY) {
-    writeConnectivity(file);
+    tail = gatherConnectivity(tail);
   }
 
   // Write out the nodes and solution vector to a file (continuous)
@@ -321,52 +955,121 @@ int TACSToFH5::writeToFile(const char *filename) {
       }
     }
 
-    // Write the data with a time stamp from the simulation in TACS
+    // Stage the data with a time stamp from the simulation in TACS
     char data_name[128];
     double t = assembler->getSimulationTime();
     sprintf(data_name, "continuous data t=%.10e", t);
-    file->writeZoneData(data_name, var_names, TACSFH5File::FH5_FLOAT, dim1,
-                        dim2, float_data);
-    delete[] float_data;
-    delete[] var_names;
+
+    FH5ZoneData *zone = new FH5ZoneData();
+    zone->zone_name = new char[strlen(data_name) + 1];
+    strcpy(zone->zone_name, data_name);
+    zone->var_names = var_names;
+    zone->dtype = TACSFH5File::FH5_FLOAT;
+    zone->dim1 = dim1;
+    zone->dim2 = dim2;
+    zone->data = float_data;
+    *tail = zone;
+    tail = &zone->next;
+
     if (F) {
       F->decref();
     }
   }
 
   if (nvals > 0) {
-    // Write out the data to a file
-    TacsScalar *data;
     int dim1, dim2;
-    assembler->getElementOutputData(elem_type, element_write_flag, &dim1, &dim2,
-                                    &data);
-
-    // Convert the data to float
-    float *float_data = new float[dim1 * dim2];
-    for (int i = 0; i < dim1 * dim2; i++) {
-      float_data[i] = TacsRealPart(data[i]);
+    float *float_data;
+    if (shared_element_zone) {
+      // Reuse the packed data already extracted by another writer in
+      // a grouped write
+      dim1 = shared_element_zone->dim1;
+      dim2 = shared_element_zone->dim2;
+      float_data = new float[dim1 * dim2];
+      memcpy(float_data, shared_element_zone->data,
+             (size_t)dim1 * dim2 * sizeof(float));
+    } else {
+      // Write out the data to a file
+      TacsScalar *data;
+      assembler->getElementOutputData(elem_type, element_write_flag, &dim1,
+                                      &dim2, &data, num_output_comps,
+                                      output_comps);
+
+      // Convert the data to float
+      float_data = new float[dim1 * dim2];
+      for (int i = 0; i < dim1 * dim2; i++) {
+        float_data[i] = TacsRealPart(data[i]);
+      }
+      delete[] data;
     }
-    delete[] data;
 
-    // Write the data with a time stamp from the simulation in TACS
+    // Stage the data with a time stamp from the simulation in TACS
     char data_name[128];
     double t = assembler->getSimulationTime();
     sprintf(data_name, "element data t=%.10e", t);
-    file->writeZoneData(data_name, variable_names, TACSFH5File::FH5_FLOAT, dim1,
-                        dim2, float_data);
-    delete[] float_data;
+
+    FH5ZoneData *zone = new FH5ZoneData();
+    zone->zone_name = new char[strlen(data_name) + 1];
+    strcpy(zone->zone_name, data_name);
+    zone->var_names = new char[strlen(variable_names) + 1];
+    strcpy(zone->var_names, variable_names);
+    zone->dtype = TACSFH5File::FH5_FLOAT;
+    zone->dim1 = dim1;
+    zone->dim2 = dim2;
+    zone->data = float_data;
+    *tail = zone;
+    tail = &zone->next;
   }
 
-  file->close();
-  file->decref();
+  if (use_smoothing && nvals > 0) {
+    int dim1, dim2;
+    float *float_data;
+    if (shared_smoothed_zone) {
+      // Reuse the smoothed data recovered by another writer
+      dim1 = shared_smoothed_zone->dim1;
+      dim2 = shared_smoothed_zone->dim2;
+      float_data = new float[dim1 * dim2];
+      memcpy(float_data, shared_smoothed_zone->data,
+             (size_t)dim1 * dim2 * sizeof(float));
+    } else {
+      // Recover the smoothed nodal data from the element-local values
+      TacsScalar *data;
+      assembler->getSmoothedOutputData(elem_type, element_write_flag, &dim1,
+                                       &dim2, &data, num_output_comps,
+                                       output_comps);
+
+      // Convert the data to float
+      float_data = new float[dim1 * dim2];
+      for (int i = 0; i < dim1 * dim2; i++) {
+        float_data[i] = TacsRealPart(data[i]);
+      }
+      delete[] data;
+    }
+
+    // Stage the data with a time stamp from the simulation in TACS
+    char data_name[128];
+    double t = assembler->getSimulationTime();
+    sprintf(data_name, "smoothed data t=%.10e", t);
+
+    FH5ZoneData *zone = new FH5ZoneData();
+    zone->zone_name = new char[strlen(data_name) + 1];
+    strcpy(zone->zone_name, data_name);
+    zone->var_names = new char[strlen(variable_names) + 1];
+    strcpy(zone->var_names, variable_names);
+    zone->dtype = TACSFH5File::FH5_FLOAT;
+    zone->dim1 = dim1;
+    zone->dim2 = dim2;
+    zone->data = float_data;
+    *tail = zone;
+    tail = &zone->next;
+  }
 
-  return 0;
+  return zones;
 }
 
 /**
-  Write out the connectivity information to the file
+  Stage the connectivity information for writing
 */
-int TACSToFH5::writeConnectivity(TACSFH5File *file) {
+TACSToFH5::FH5ZoneData **TACSToFH5::gatherConnectivity(FH5ZoneData **tail) {
   int mpi_rank, mpi_size;
   MPI_Comm comm = assembler->getMPIComm();
   MPI_Comm_rank(comm, &mpi_rank);
@@ -386,19 +1089,33 @@ int TACSToFH5::writeConnectivity(TACSFH5File *file) {
     comp_nums[i] = elements[i]->getComponentNum();
   }
 
-  // Write the component numbers to a zone
+  // Stage the component numbers as a zone
   int dim1 = num_elements;
   int dim2 = 1;
-  char comp_name[] = "components";
-  file->writeZoneData(comp_name, comp_name, TACSFH5File::FH5_INT, dim1, dim2,
-                      comp_nums);
-  delete[] comp_nums;
-
-  // Write the layout types to a new zone
-  char layout_name[] = "ltypes";
-  file->writeZoneData(layout_name, layout_name, TACSFH5File::FH5_INT, dim1,
-                      dim2, layout_types);
-  delete[] layout_types;
+  FH5ZoneData *zone = new FH5ZoneData();
+  zone->zone_name = new char[strlen("components") + 1];
+  strcpy(zone->zone_name, "components");
+  zone->var_names = new char[strlen("components") + 1];
+  strcpy(zone->var_names, "components");
+  zone->dtype = TACSFH5File::FH5_INT;
+  zone->dim1 = dim1;
+  zone->dim2 = dim2;
+  zone->data = comp_nums;
+  *tail = zone;
+  tail = &zone->next;
+
+  // Stage the layout types as a new zone
+  zone = new FH5ZoneData();
+  zone->zone_name = new char[strlen("ltypes") + 1];
+  strcpy(zone->zone_name, "ltypes");
+  zone->var_names = new char[strlen("ltypes") + 1];
+  strcpy(zone->var_names, "ltypes");
+  zone->dtype = TACSFH5File::FH5_INT;
+  zone->dim1 = dim1;
+  zone->dim2 = dim2;
+  zone->data = layout_types;
+  *tail = zone;
+  tail = &zone->next;
 
   // Copy over the connectivity
   const int *ptr, *conn;
@@ -430,10 +1147,17 @@ int TACSToFH5::writeConnectivity(TACSFH5File *file) {
     dim1++;
   }
 
-  char ptr_name[] = "ptr";
-  file->writeZoneData(ptr_name, ptr_name, TACSFH5File::FH5_INT, dim1, dim2,
-                      ptr_copy);
-  delete[] ptr_copy;
+  zone = new FH5ZoneData();
+  zone->zone_name = new char[strlen("ptr") + 1];
+  strcpy(zone->zone_name, "ptr");
+  zone->var_names = new char[strlen("ptr") + 1];
+  strcpy(zone->var_names, "ptr");
+  zone->dtype = TACSFH5File::FH5_INT;
+  zone->dim1 = dim1;
+  zone->dim2 = dim2;
+  zone->data = ptr_copy;
+  *tail = zone;
+  tail = &zone->next;
 
   // Get the ownership range for each group of nodes
   const int *ownerRange;
@@ -482,13 +1206,21 @@ int TACSToFH5::writeConnectivity(TACSFH5File *file) {
 
   dim1 = conn_size;
   dim2 = 1;
-  char conn_name[] = "connectivity";
-  file->writeZoneData(conn_name, conn_name, TACSFH5File::FH5_INT, dim1, dim2,
-                      conn_copy);
-  delete[] conn_copy;
+  zone = new FH5ZoneData();
+  zone->zone_name = new char[strlen("connectivity") + 1];
+  strcpy(zone->zone_name, "connectivity");
+  zone->var_names = new char[strlen("connectivity") + 1];
+  strcpy(zone->var_names, "connectivity");
+  zone->dtype = TACSFH5File::FH5_INT;
+  zone->dim1 = dim1;
+  zone->dim2 = dim2;
+  zone->data = conn_copy;
+  *tail = zone;
+  tail = &zone->next;
+
   delete[] new_owner_range;
 
-  return 0;
+  return tail;
 }
 
 /**
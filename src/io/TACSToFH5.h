@@ -23,8 +23,11 @@
   Create an FH5 file from the TACSAssembler object
 */
 
+#include <pthread.h>
+
 #include "TACSAssembler.h"
 #include "TACSFH5.h"
+#include "TACSOutputSink.h"
 
 /**
   Write out the solution data to a binary file in a TACS-specific
@@ -42,15 +45,90 @@ class TACSToFH5 : public TACSObject {
   // Set the group name for each zone
   void setComponentName(int comp_num, const char *group_name);
 
+  // Restrict the element data output to a set of components
+  void setOutputComponents(int num_comps, const int *comp_nums);
+
   // Write the data to a file
   int writeToFile(const char *filename);
 
+  // Write several output pipelines from one shared extraction pass
+  static int writeFiles(int num_writers, TACSToFH5 **writers,
+                        const char *const *filenames);
+
+  // Write a block of nodal derivative fields to a single file
+  int writeSensitivitiesToFile(const char *filename, int num_vecs,
+                               TACSBVec **vecs,
+                               const char **vec_names = NULL);
+
+  // Deliver the staged output data to an in-situ sink
+  int writeToSink(TACSOutputSink *sink);
+
+  // Set an MPI-IO hint applied when the output file is opened
+  void setWriteHint(const char *key, const char *value);
+
+  // Control compression of the solution data zones
+  void setCompression(int flag, int mantissa_bits = 23);
+
+  // Control asynchronous (double-buffered) writes
+  void setAsyncWrites(int flag);
+  int waitForWrites();
+
+  // Control the output of a smoothed (patch-recovered) nodal data zone
+  void setElementSmoothing(int flag);
+
  private:
+  // A zone of output data staged for writing
+  class FH5ZoneData {
+   public:
+    FH5ZoneData() {
+      zone_name = var_names = NULL;
+      dtype = TACSFH5File::FH5_FLOAT;
+      dim1 = dim2 = 0;
+      data = NULL;
+      next = NULL;
+    }
+    ~FH5ZoneData() {
+      if (zone_name) {
+        delete[] zone_name;
+      }
+      if (var_names) {
+        delete[] var_names;
+      }
+      if (data) {
+        if (dtype == TACSFH5File::FH5_INT) {
+          delete[] (int *)data;
+        } else {
+          delete[] (float *)data;
+        }
+      }
+    }
+    char *zone_name;  // The name of the zone
+    char *var_names;  // Comma-separated list of the variable names
+    TACSFH5File::FH5DataType dtype;
+    int dim1, dim2;  // The dimensions of the data
+    void *data;      // The data itself, freed after the write
+    FH5ZoneData *next;
+  };
+
   // Get a character string of the variable names
   char *getElementVarNames(int flag);
 
-  // Write the connectivity information to a file
-  int writeConnectivity(TACSFH5File *file);
+  // Check whether the element data extraction of the other writer
+  // can be shared with this one
+  int matchesExtraction(TACSToFH5 *other);
+
+  // Stage the output data into a list of zones
+  FH5ZoneData *gatherZoneData();
+
+  // Stage the connectivity information
+  FH5ZoneData **gatherConnectivity(FH5ZoneData **tail);
+
+  // Write the staged zones to the named file and free them
+  int writeZones(const char *filename, MPI_Comm write_comm,
+                 FH5ZoneData *zones);
+
+  // The entry point for the background writer thread
+  static void *writeFileJob(void *arg);
 
   // The Assembler object
   TACSAssembler *assembler;
@@ -64,6 +142,33 @@ class TACSToFH5 : public TACSObject {
   int num_components;      // The number of components in the model
   char **component_names;  // The names of each of the components
   char *variable_names;    // The names of all the variables
+
+  int num_output_comps;  // Length of the component filter (0 = all)
+  int *output_comps;     // The component numbers to output
+
+  // MPI-IO hints applied when the output file is opened
+  MPI_Info write_info;
+
+  // Parameters for the compressed solution data zones
+  int use_compression;        // Non-zero to compress the float data zones
+  int compress_mantissa_bits; // Mantissa bits retained by the compression
+
+  // Non-zero to also write a smoothed nodal element data zone
+  int use_smoothing;
+
+  // State for asynchronous writes
+  int async_writes;          // Non-zero if writes happen in the background
+  MPI_Comm write_comm;       // Duplicated communicator for the writer thread
+  pthread_t write_thread;    // The background writer thread
+  int write_active;          // Non-zero while a write is in flight
+  int write_fail;            // Fail code from the last background write
+  char *write_filename;      // The file name for the write in flight
+  FH5ZoneData *write_zones;  // The staged zones for the write in flight
+
+  // Zones borrowed from another writer during a grouped write, so
+  // that the element extraction runs once for all of the writers
+  const FH5ZoneData *shared_element_zone;
+  const FH5ZoneData *shared_smoothed_zone;
 };
 
 #endif  // TACS_TO_FH5
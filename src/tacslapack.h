@@ -60,6 +60,29 @@
 #define LAPACKgetrf zgetrf_
 #define LAPACKgetrs zgetrs_
 #define LAPACKgetri zgetri_
+#elif defined(TACS_USE_DUAL)
+// The dual build has no vendor BLAS: the routines that take
+// TacsScalar arguments are implemented natively in TacsDualLapack.cpp
+// under these names
+#define BLASdot tacs_dual_dot
+#define BLASaxpy tacs_dual_axpy
+#define BLASscal tacs_dual_scal
+#define BLASnrm2 tacs_dual_nrm2
+#define BLAScopy tacs_dual_copy
+#define BLASgemv tacs_dual_gemv
+#define BLASgbmv tacs_dual_gbmv
+#define BLASsbmv tacs_dual_sbmv
+#define BLASgemm tacs_dual_gemm
+#define BLAStrsm tacs_dual_trsm
+#define BLAStrsv tacs_dual_trsv
+#define BLAStbsv tacs_dual_tbsv
+#define LAPACKpbtrf tacs_dual_pbtrf
+#define LAPACKstev tacs_dual_stev
+#define LAPACKgesv tacs_dual_gesv
+#define LAPACKspsv tacs_dual_spsv
+#define LAPACKgetrf tacs_dual_getrf
+#define LAPACKgetrs tacs_dual_getrs
+#define LAPACKgetri tacs_dual_getri
 #else
 #define BLASdot ddot_
 #define BLASaxpy daxpy_
@@ -263,4 +286,247 @@ extern void LAPACKzggev(const char *JOBVL, const char *JOBVR, int *N,
                         int *INFO);
 }
 
+/*
+  Inlined replacements for the LU routines for the tiny dense systems
+  that arise at the element and block level. For n <= 12 the f77 call
+  overhead, the pivot search and the column-major marshaling exceed
+  the arithmetic, so these templates fix the dimension at compile time
+  and let the compiler fully unroll the loops. The runtime dispatchers
+  below fall through to the f77 routines above the size threshold, so
+  call sites can use them unconditionally.
+
+  The matrices are stored in column-major order with lda = n, and the
+  pivot indices follow the one-based LAPACK convention, so a matrix
+  factored on the fixed-size path can still be passed to LAPACKgetrs.
+  The pivot selection compares value parts only, matching the native
+  dual implementation, so the pivot sequence is consistent with the
+  underlying real factorization.
+*/
+static const int TACS_SMALL_LAPACK_SIZE = 12;
+
+/*
+  Compute the LU factorization of the n x n column-major matrix A with
+  partial pivoting. Returns 0 on success, or the one-based index of
+  the first zero pivot.
+*/
+template <int n>
+inline int TacsFixedSizeFactor(TacsScalar A[], int ipiv[]) {
+  int fail = 0;
+
+  for (int k = 0; k < n; k++) {
+    // Find the pivot row
+    int p = k;
+    double amax = fabs(TacsRealPart(A[k + k * n]));
+    for (int i = k + 1; i < n; i++) {
+      double av = fabs(TacsRealPart(A[i + k * n]));
+      if (av > amax) {
+        amax = av;
+        p = i;
+      }
+    }
+    ipiv[k] = p + 1;
+
+    if (amax == 0.0) {
+      if (fail == 0) {
+        fail = k + 1;
+      }
+      continue;
+    }
+
+    // Swap rows k and p
+    if (p != k) {
+      for (int j = 0; j < n; j++) {
+        TacsScalar t = A[k + j * n];
+        A[k + j * n] = A[p + j * n];
+        A[p + j * n] = t;
+      }
+    }
+
+    // Eliminate below the diagonal
+    TacsScalar inv = 1.0 / A[k + k * n];
+    for (int i = k + 1; i < n; i++) {
+      A[i + k * n] *= inv;
+    }
+    for (int j = k + 1; j < n; j++) {
+      TacsScalar akj = A[k + j * n];
+      for (int i = k + 1; i < n; i++) {
+        A[i + j * n] -= A[i + k * n] * akj;
+      }
+    }
+  }
+
+  return fail;
+}
+
+/*
+  Solve A*x = b in place with the factorization from
+  TacsFixedSizeFactor()
+*/
+template <int n>
+inline void TacsFixedSizeApplyFactor(const TacsScalar A[], const int ipiv[],
+                                     TacsScalar x[]) {
+  // Apply the row interchanges
+  for (int k = 0; k < n; k++) {
+    int p = ipiv[k] - 1;
+    if (p != k) {
+      TacsScalar t = x[k];
+      x[k] = x[p];
+      x[p] = t;
+    }
+  }
+
+  // Solve L*y = b with the unit lower triangular factor
+  for (int k = 1; k < n; k++) {
+    for (int j = 0; j < k; j++) {
+      x[k] -= A[k + j * n] * x[j];
+    }
+  }
+
+  // Solve U*x = y
+  for (int k = n - 1; k >= 0; k--) {
+    for (int j = k + 1; j < n; j++) {
+      x[k] -= A[k + j * n] * x[j];
+    }
+    x[k] = x[k] / A[k + k * n];
+  }
+}
+
+/*
+  LU factor the n x n column-major matrix A with lda = n, taking the
+  unrolled fixed-size path for n <= TACS_SMALL_LAPACK_SIZE
+*/
+inline void TacsLAPACKgetrf(int n, TacsScalar *A, int *ipiv, int *info) {
+  switch (n) {
+    case 1:
+      *info = TacsFixedSizeFactor<1>(A, ipiv);
+      break;
+    case 2:
+      *info = TacsFixedSizeFactor<2>(A, ipiv);
+      break;
+    case 3:
+      *info = TacsFixedSizeFactor<3>(A, ipiv);
+      break;
+    case 4:
+      *info = TacsFixedSizeFactor<4>(A, ipiv);
+      break;
+    case 5:
+      *info = TacsFixedSizeFactor<5>(A, ipiv);
+      break;
+    case 6:
+      *info = TacsFixedSizeFactor<6>(A, ipiv);
+      break;
+    case 7:
+      *info = TacsFixedSizeFactor<7>(A, ipiv);
+      break;
+    case 8:
+      *info = TacsFixedSizeFactor<8>(A, ipiv);
+      break;
+    case 9:
+      *info = TacsFixedSizeFactor<9>(A, ipiv);
+      break;
+    case 10:
+      *info = TacsFixedSizeFactor<10>(A, ipiv);
+      break;
+    case 11:
+      *info = TacsFixedSizeFactor<11>(A, ipiv);
+      break;
+    case 12:
+      *info = TacsFixedSizeFactor<12>(A, ipiv);
+      break;
+    default:
+      LAPACKgetrf(&n, &n, A, &n, ipiv, info);
+      break;
+  }
+}
+
+/*
+  Solve A*X = B with the factorization from TacsLAPACKgetrf(). The
+  right-hand sides are stored contiguously with ldb = n.
+*/
+inline void TacsLAPACKgetrs(int n, int nrhs, TacsScalar *A, int *ipiv,
+                            TacsScalar *B, int *info) {
+  if (n > TACS_SMALL_LAPACK_SIZE) {
+    LAPACKgetrs("N", &n, &nrhs, A, &n, ipiv, B, &n, info);
+    return;
+  }
+
+  *info = 0;
+  for (int j = 0; j < nrhs; j++) {
+    TacsScalar *bj = &B[j * n];
+    switch (n) {
+      case 1:
+        TacsFixedSizeApplyFactor<1>(A, ipiv, bj);
+        break;
+      case 2:
+        TacsFixedSizeApplyFactor<2>(A, ipiv, bj);
+        break;
+      case 3:
+        TacsFixedSizeApplyFactor<3>(A, ipiv, bj);
+        break;
+      case 4:
+        TacsFixedSizeApplyFactor<4>(A, ipiv, bj);
+        break;
+      case 5:
+        TacsFixedSizeApplyFactor<5>(A, ipiv, bj);
+        break;
+      case 6:
+        TacsFixedSizeApplyFactor<6>(A, ipiv, bj);
+        break;
+      case 7:
+        TacsFixedSizeApplyFactor<7>(A, ipiv, bj);
+        break;
+      case 8:
+        TacsFixedSizeApplyFactor<8>(A, ipiv, bj);
+        break;
+      case 9:
+        TacsFixedSizeApplyFactor<9>(A, ipiv, bj);
+        break;
+      case 10:
+        TacsFixedSizeApplyFactor<10>(A, ipiv, bj);
+        break;
+      case 11:
+        TacsFixedSizeApplyFactor<11>(A, ipiv, bj);
+        break;
+      case 12:
+        TacsFixedSizeApplyFactor<12>(A, ipiv, bj);
+        break;
+    }
+  }
+}
+
+/*
+  Solve A*X = B by LU factorization with partial pivoting, with the
+  fixed-size path below the threshold
+*/
+inline void TacsLAPACKgesv(int n, int nrhs, TacsScalar *A, int *ipiv,
+                           TacsScalar *B, int *info) {
+  TacsLAPACKgetrf(n, A, ipiv, info);
+  if (*info == 0) {
+    TacsLAPACKgetrs(n, nrhs, A, ipiv, B, info);
+  }
+}
+
+/*
+  Compute the inverse of a matrix from the factorization computed by
+  TacsLAPACKgetrf(). The work array must hold at least lwork >= n
+  entries for the f77 fallback; the fixed-size path ignores it.
+*/
+inline void TacsLAPACKgetri(int n, TacsScalar *A, int *ipiv, TacsScalar *work,
+                            int lwork, int *info) {
+  if (n > TACS_SMALL_LAPACK_SIZE) {
+    LAPACKgetri(&n, A, &n, ipiv, work, &lwork, info);
+    return;
+  }
+
+  // Solve A*X = I column by column, then copy the inverse back
+  TacsScalar ainv[TACS_SMALL_LAPACK_SIZE * TACS_SMALL_LAPACK_SIZE];
+  memset(ainv, 0, n * n * sizeof(TacsScalar));
+  for (int j = 0; j < n; j++) {
+    ainv[j + j * n] = 1.0;
+  }
+
+  TacsLAPACKgetrs(n, n, A, ipiv, ainv, info);
+  memcpy(A, ainv, n * n * sizeof(TacsScalar));
+}
+
 #endif
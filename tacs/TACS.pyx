@@ -971,7 +971,10 @@ cdef class Mat:
         """
         Matrix multiplication
         """
-        self.ptr.mult(x.ptr, y.ptr)
+        cdef TACSVec *xp = x.ptr
+        cdef TACSVec *yp = y.ptr
+        with nogil:
+            self.ptr.mult(xp, yp)
 
     def copyValues(self, Mat mat):
         """
@@ -1123,11 +1126,15 @@ cdef class Pc:
 
     def factor(self):
         """Factor the preconditioner"""
-        self.ptr.factor()
+        with nogil:
+            self.ptr.factor()
 
     def applyFactor(self, Vec x, Vec y):
         """Apply the preconditioner"""
-        self.ptr.applyFactor(x.ptr, y.ptr)
+        cdef TACSVec *xp = x.ptr
+        cdef TACSVec *yp = y.ptr
+        with nogil:
+            self.ptr.applyFactor(xp, yp)
 
     def getMat(self):
         """Retrieve the associated matrix"""
@@ -1185,7 +1192,8 @@ cdef class Mg(Pc):
         cdef TACSBVec *res = NULL
         if residual is not None:
             res = residual.getBVecPtr()
-        self.mg.assembleJacobian(alpha, beta, gamma, res, matOr)
+        with nogil:
+            self.mg.assembleJacobian(alpha, beta, gamma, res, matOr)
         return
 
     def assembleMatType(self, ElementMatrixType matType,
@@ -1193,7 +1201,8 @@ cdef class Mg(Pc):
         """
         Assemble the given matrix type
         """
-        self.mg.assembleMatType(matType, matOr)
+        with nogil:
+            self.mg.assembleMatType(matType, matOr)
         return
 
     def assembleMatCombo(self, ElementMatrixType matType1, double scale1,
@@ -1210,7 +1219,8 @@ cdef class Mg(Pc):
         matTypes[1] = matType2
         scale[0] = scale1
         scale[1] = scale2
-        self.mg.assembleMatCombo(matTypes, scale, 2, matOr)
+        with nogil:
+            self.mg.assembleMatCombo(matTypes, scale, 2, matOr)
         return
 
     def assembleGalerkinMat(self):
@@ -1288,7 +1298,12 @@ cdef class KSM:
         output:
         solve_flag: flag for whether the solve terminated successfully
         """
-        return self.ptr.solve(b.ptr, x.ptr, zero_guess)
+        cdef TACSVec *bp = b.ptr
+        cdef TACSVec *xp = x.ptr
+        cdef int solve_flag = 0
+        with nogil:
+            solve_flag = self.ptr.solve(bp, xp, zero_guess)
+        return solve_flag
 
     def setTolerances(self, double rtol, double atol):
         """
@@ -1427,7 +1442,8 @@ cdef class JacobiDavidson:
             ksm_print = new KSMPrintStdout("JD", rank, freq)
             ksm_print.incref()
 
-        self.ptr.solve(ksm_print, print_level)
+        with nogil:
+            self.ptr.solve(ksm_print, print_level)
         if ksm_print != NULL:
             ksm_print.decref()
 
@@ -1545,7 +1561,8 @@ cdef class SEPsolver:
             ksm_print = new KSMPrintStdout("SEP", comm.rank, freq)
             ksm_print.incref()
 
-        self.ptr.solve(ksm_print, NULL)
+        with nogil:
+            self.ptr.solve(ksm_print, NULL)
 
         if ksm_print != NULL:
             ksm_print.decref()
@@ -2146,7 +2163,9 @@ cdef class Assembler:
         rhs:        the residual output
         loadScale:  Scaling factor for the aux element contributions, by default 1
         """
-        self.ptr.assembleRes(residual.getBVecPtr(), loadScale)
+        cdef TACSBVec *res = residual.getBVecPtr()
+        with nogil:
+            self.ptr.assembleRes(res, loadScale)
         return
 
     def assembleJacobian(self, double alpha, double beta, double gamma,
@@ -2173,11 +2192,13 @@ cdef class Assembler:
         loadScale: Scaling factor for the aux element contributions, by default 1
         """
         cdef TACSBVec *res = NULL
+        cdef TACSMat *Ap = A.ptr
         if residual is not None:
             res = residual.getBVecPtr()
 
-        self.ptr.assembleJacobian(alpha, beta, gamma,
-                                  res, A.ptr, matOr, loadScale)
+        with nogil:
+            self.ptr.assembleJacobian(alpha, beta, gamma,
+                                      res, Ap, matOr, loadScale)
         return
 
     def assembleMatType(self, ElementMatrixType matType,
@@ -2204,7 +2225,9 @@ cdef class Assembler:
         matOr:      the matrix orientation NORMAL or TRANSPOSE
         loadScale: Scaling factor for the aux element contributions, by default 1
         """
-        self.ptr.assembleMatType(matType, A.ptr, matOr, loadScale)
+        cdef TACSMat *Ap = A.ptr
+        with nogil:
+            self.ptr.assembleMatType(matType, Ap, matOr, loadScale)
         return
 
     def assembleMatCombo(self, ElementMatrixType matType1, double scale1,
@@ -2222,7 +2245,9 @@ cdef class Assembler:
         matTypes[1] = matType2
         scale[0] = scale1
         scale[1] = scale2
-        self.ptr.assembleMatCombo(matTypes, scale, 2, A.ptr, matOr, loadScale)
+        cdef TACSMat *Ap = A.ptr
+        with nogil:
+            self.ptr.assembleMatCombo(matTypes, scale, 2, Ap, matOr, loadScale)
         return
 
     def evalFunctions(self, funclist):
@@ -2245,7 +2270,10 @@ cdef class Assembler:
         # Allocate the numpy array of function values
         cdef np.ndarray fvals = np.zeros(len(funclist), dtype)
 
-        self.ptr.evalFunctions(len(funclist), funcs, <TacsScalar*>fvals.data)
+        cdef int num_funcs = len(funclist)
+        cdef TacsScalar *fvals_ptr = <TacsScalar*>fvals.data
+        with nogil:
+            self.ptr.evalFunctions(num_funcs, funcs, fvals_ptr)
 
         # Free the allocated array
         free(funcs)
@@ -2277,7 +2305,8 @@ cdef class Assembler:
             dfdx[i] = (<Vec>dfdxlist[i]).getBVecPtr()
 
         # Evaluate the derivative of the functions
-        self.ptr.addDVSens(alpha, num_funcs, funcs, dfdx)
+        with nogil:
+            self.ptr.addDVSens(alpha, num_funcs, funcs, dfdx)
 
         free(funcs)
         free(dfdx)
@@ -2315,7 +2344,8 @@ cdef class Assembler:
             dfdu[i] = (<Vec>dfdulist[i]).getBVecPtr()
 
         # Evaluate the derivative of the functions
-        self.ptr.addSVSens(alpha, beta, gamma, num_funcs, funcs, dfdu)
+        with nogil:
+            self.ptr.addSVSens(alpha, beta, gamma, num_funcs, funcs, dfdu)
 
         free(funcs)
         free(dfdu)
@@ -2347,7 +2377,9 @@ cdef class Assembler:
             dfdX[i] = (<Vec>dfdXlist[i]).getBVecPtr()
 
         # Evaluate the derivative of the functions
-        self.ptr.addXptSens(alpha, num_funcs, funcs, dfdX)
+        cdef double _alpha = alpha
+        with nogil:
+            self.ptr.addXptSens(_alpha, num_funcs, funcs, dfdX)
 
         free(funcs)
         free(dfdX)
@@ -2387,7 +2419,9 @@ cdef class Assembler:
             dfdx[i] = (<Vec>dfdxlist[i]).getBVecPtr()
 
         # Evaluate the derivative of the functions
-        self.ptr.addAdjointResProducts(alpha, num_adjoints, adjoints, dfdx, loadScale)
+        with nogil:
+            self.ptr.addAdjointResProducts(alpha, num_adjoints, adjoints,
+                                           dfdx, loadScale)
 
         free(adjoints)
         free(dfdx)
@@ -2418,7 +2452,9 @@ cdef class Assembler:
             dfdX[i] = (<Vec>dfdXlist[i]).getBVecPtr()
 
         # Evaluate the derivative of the functions
-        self.ptr.addAdjointResXptSensProducts(alpha, num_adjoints, adjoints, dfdX, loadScale)
+        with nogil:
+            self.ptr.addAdjointResXptSensProducts(alpha, num_adjoints, adjoints,
+                                                  dfdX, loadScale)
 
         free(adjoints)
         free(dfdX)
@@ -2433,14 +2469,20 @@ cdef class Assembler:
         matrix with the input vectors to the design variable
         sensitivity vector A.
         """
-        self.ptr.addMatDVSensInnerProduct(scale, matType, psi.getBVecPtr(),
-                                          phi.getBVecPtr(), dfdx.getBVecPtr())
+        cdef TACSBVec *psip = psi.getBVecPtr()
+        cdef TACSBVec *phip = phi.getBVecPtr()
+        cdef TACSBVec *dfdxp = dfdx.getBVecPtr()
+        with nogil:
+            self.ptr.addMatDVSensInnerProduct(scale, matType, psip, phip, dfdxp)
         return
 
     def evalMatSVSensInnerProduct(self, ElementMatrixType matType,
                                   Vec psi, Vec phi, Vec res):
-        self.ptr.evalMatSVSensInnerProduct(matType,
-                                           psi.getBVecPtr(), phi.getBVecPtr(), res.getBVecPtr())
+        cdef TACSBVec *psip = psi.getBVecPtr()
+        cdef TACSBVec *phip = phi.getBVecPtr()
+        cdef TACSBVec *resp = res.getBVecPtr()
+        with nogil:
+            self.ptr.evalMatSVSensInnerProduct(matType, psip, phip, resp)
         return
 
     def addJacobianVecProduct(self, TacsScalar scale,
@@ -2450,8 +2492,11 @@ cdef class Assembler:
         """
         Compute the Jacobian-vector product
         """
-        self.ptr.addJacobianVecProduct(scale, alpha, beta, gamma,
-                                       x.getBVecPtr(), y.getBVecPtr(), matOr, loadScale)
+        cdef TACSBVec *xp = x.getBVecPtr()
+        cdef TACSBVec *yp = y.getBVecPtr()
+        with nogil:
+            self.ptr.addJacobianVecProduct(scale, alpha, beta, gamma,
+                                           xp, yp, matOr, loadScale)
         return
 
     def testElement(self, int elemNum, int print_level,
@@ -3190,7 +3235,8 @@ cdef class FrequencyAnalysis:
             ksm_print = new KSMPrintStdout("FrequencyAnalysis", rank, freq)
             ksm_print.incref()
 
-        self.ptr.solve(ksm_print, print_level)
+        with nogil:
+            self.ptr.solve(ksm_print, print_level)
         if ksm_print != NULL:
             ksm_print.decref()
         return
@@ -3326,7 +3372,8 @@ cdef class BucklingAnalysis:
             MPI_Comm_rank(comm, &rank)
             ksm_print = new KSMPrintStdout("BucklingAnalysis", rank, freq)
 
-        self.ptr.solve(f, u0, ksm_print)
+        with nogil:
+            self.ptr.solve(f, u0, ksm_print)
         return
 
     def extractEigenvalue(self, int eig):
@@ -3629,9 +3676,12 @@ cdef class Integrator:
         Solve the nonlinear system at current time step
         """
         cdef TACSBVec *fvec = NULL
+        cdef int flag = 0
         if forces is not None:
             fvec = forces.getBVecPtr()
-        return self.ptr.iterate(step_num, fvec)
+        with nogil:
+            flag = self.ptr.iterate(step_num, fvec)
+        return flag
 
     def integrate(self):
         """
@@ -3639,7 +3689,10 @@ cdef class Integrator:
 
         Integrates the governing equations forward in time
         """
-        return self.ptr.integrate()
+        cdef int flag = 0
+        with nogil:
+            flag = self.ptr.integrate()
+        return flag
 
     def evalFunctions(self, funclist):
         """
@@ -3659,7 +3712,9 @@ cdef class Integrator:
 
         # Allocate the numpy array of function values
         cdef np.ndarray fvals = np.zeros(len(funclist), dtype)
-        self.ptr.evalFunctions(<TacsScalar*>fvals.data)
+        cdef TacsScalar *fvals_ptr = <TacsScalar*>fvals.data
+        with nogil:
+            self.ptr.evalFunctions(fvals_ptr)
 
         # Free the allocated array
         free(funcs)
@@ -3672,7 +3727,8 @@ cdef class Integrator:
 
         Initialize adjoint at the specified step
         """
-        self.ptr.initAdjoint(step_num)
+        with nogil:
+            self.ptr.initAdjoint(step_num)
         return
 
     def iterateAdjoint(self, int step_num, list adjlist=None):
@@ -3689,7 +3745,8 @@ cdef class Integrator:
             for i in range(nadj):
                 adjoint[i] = (<Vec>adjlist[i]).getBVecPtr()
 
-        self.ptr.iterateAdjoint(step_num, adjoint)
+        with nogil:
+            self.ptr.iterateAdjoint(step_num, adjoint)
         if adjlist is not None:
             free(adjoint)
         return
@@ -3700,7 +3757,8 @@ cdef class Integrator:
 
         Finish the calculations at the specified adjoint step
         """
-        self.ptr.postAdjoint(step_num)
+        with nogil:
+            self.ptr.postAdjoint(step_num)
         return
 
     def integrateAdjoint(self):
@@ -3709,7 +3767,8 @@ cdef class Integrator:
 
         Integrates the adjoint backwards in time
         """
-        self.ptr.integrateAdjoint()
+        with nogil:
+            self.ptr.integrateAdjoint()
         return
 
     def getAdjoint(self, int step_num, int func_num):
@@ -3900,9 +3959,12 @@ cdef class DIRKIntegrator(Integrator):
         """
         cdef TACSDIRKIntegrator *dirk = <TACSDIRKIntegrator*> self.ptr
         cdef TACSBVec *fvec = NULL
+        cdef int flag = 0
         if forces is not None:
             fvec = forces.getBVecPtr()
-        return dirk.iterateStage(step_num, stage_num, fvec)
+        with nogil:
+            flag = dirk.iterateStage(step_num, stage_num, fvec)
+        return flag
 
     def getStageStates(self, int step_num, int stage_num):
         """
@@ -3943,9 +4005,12 @@ cdef class ESDIRKIntegrator(Integrator):
         """
         cdef TACSESDIRKIntegrator *esdirk = <TACSESDIRKIntegrator*> self.ptr
         cdef TACSBVec *fvec = NULL
+        cdef int flag = 0
         if forces is not None:
             fvec = forces.getBVecPtr()
-        return esdirk.iterateStage(step_num, stage_num, fvec)
+        with nogil:
+            flag = esdirk.iterateStage(step_num, stage_num, fvec)
+        return flag
 
     def getStageStates(self, int step_num, int stage_num):
         """
@@ -4066,7 +4131,8 @@ cdef class LinearSpectralMg(Pc):
 
         Factor the preconditioner object
         """
-        self.ptr.factor()
+        with nogil:
+            self.ptr.factor()
 
 cdef class SpectralIntegrator:
     cdef TACSSpectralIntegrator *ptr
@@ -4177,7 +4243,9 @@ cdef class SpectralIntegrator:
 
         Assemble the residual for the spectral system
         """
-        self.ptr.assembleRes(vec.getSpectralVecPtr())
+        cdef TACSSpectralVec *res = vec.getSpectralVecPtr()
+        with nogil:
+            self.ptr.assembleRes(res)
         return
 
     def assembleMat(self, LinearSpectralMat mat, MatrixOrientation matOr=TACS_MAT_NORMAL):
@@ -4186,7 +4254,9 @@ cdef class SpectralIntegrator:
 
         Assemble the spectral matrix with the specified orientation
         """
-        self.ptr.assembleMat(mat.mat_ptr, matOr)
+        cdef TACSLinearSpectralMat *matp = mat.mat_ptr
+        with nogil:
+            self.ptr.assembleMat(matp, matOr)
         return
 
     def evalFunctions(self, funclist):
@@ -4211,7 +4281,10 @@ cdef class SpectralIntegrator:
         # Allocate the numpy array of function values
         cdef np.ndarray fvals = np.zeros(len(funclist), dtype)
 
-        self.ptr.evalFunctions(len(funclist), funcs, <TacsScalar*>fvals.data)
+        cdef int num_funcs = len(funclist)
+        cdef TacsScalar *fvals_ptr = <TacsScalar*>fvals.data
+        with nogil:
+            self.ptr.evalFunctions(num_funcs, funcs, fvals_ptr)
 
         # Free the allocated array
         free(funcs)
@@ -4224,7 +4297,10 @@ cdef class SpectralIntegrator:
 
         Evaluate the derivative of the function w.r.t. state variables
         """
-        self.ptr.evalSVSens(func.ptr, vec.getSpectralVecPtr())
+        cdef TACSFunction *funcp = func.ptr
+        cdef TACSSpectralVec *vecp = vec.getSpectralVecPtr()
+        with nogil:
+            self.ptr.evalSVSens(funcp, vecp)
         return
 
     def addDVSens(self, Function func, Vec dfdx):
@@ -4233,7 +4309,10 @@ cdef class SpectralIntegrator:
 
         Evaluate the derivative of the function w.r.t. design variables
         """
-        self.ptr.addDVSens(func.ptr, dfdx.getBVecPtr())
+        cdef TACSFunction *funcp = func.ptr
+        cdef TACSBVec *dfdxp = dfdx.getBVecPtr()
+        with nogil:
+            self.ptr.addDVSens(funcp, dfdxp)
         return
 
     def addAdjointResProduct(self, scale, SpectralVec vec, Vec dfdx):
@@ -4242,7 +4321,11 @@ cdef class SpectralIntegrator:
 
         Add the derivative of the adjoint-vector product
         """
-        self.ptr.addAdjointResProduct(scale, vec.getSpectralVecPtr(), dfdx.getBVecPtr())
+        cdef TacsScalar _scale = scale
+        cdef TACSSpectralVec *vecp = vec.getSpectralVecPtr()
+        cdef TACSBVec *dfdxp = dfdx.getBVecPtr()
+        with nogil:
+            self.ptr.addAdjointResProduct(_scale, vecp, dfdxp)
         return
 
     def computeSolution(self, t, Vec u):
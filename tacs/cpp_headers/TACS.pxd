@@ -121,15 +121,15 @@ cdef extern from "KSM.h":
     cdef cppclass TACSMat(TACSObject):
         TACSVec *createVec()
         void zeroEntries()
-        void mult(TACSVec *x, TACSVec *y)
+        void mult(TACSVec *x, TACSVec *y) nogil
         void copyValues(TACSMat *mat)
         void scale(TacsScalar alpha)
         void axpy(TacsScalar alpha, TACSMat *mat)
         void addDiag(TacsScalar)
 
     cdef cppclass TACSPc(TACSObject):
-        void factor()
-        void applyFactor(TACSVec *x, TACSVec *y)
+        void factor() nogil
+        void applyFactor(TACSVec *x, TACSVec *y) nogil
         void getMat(TACSMat**)
 
     cdef cppclass KSMPrint(TACSObject):
@@ -142,7 +142,7 @@ cdef extern from "KSM.h":
         TACSVec *createVec()
         void setOperators(TACSMat *_mat, TACSPc *_pc)
         void getOperators(TACSMat **_mat, TACSPc **_pc)
-        int solve(TACSVec *b, TACSVec *x, int zero_guess)
+        int solve(TACSVec *b, TACSVec *x, int zero_guess) nogil
         void setTolerances(double _rtol, double _atol)
         void setMonitor(KSMPrint *_monitor)
         int getIterCount()
@@ -240,10 +240,10 @@ cdef extern from "TACSMg.h":
                       TACSMat*, TACSPc*)
         void setVariables(TACSBVec*)
         void assembleJacobian(double, double, double, TACSBVec*,
-                              MatrixOrientation)
-        void assembleMatType(ElementMatrixType, MatrixOrientation)
-        void assembleMatCombo(ElementMatrixType*, TacsScalar*, int, MatrixOrientation)
-        int assembleGalerkinMat()
+                              MatrixOrientation) nogil
+        void assembleMatType(ElementMatrixType, MatrixOrientation) nogil
+        void assembleMatCombo(ElementMatrixType*, TacsScalar*, int, MatrixOrientation) nogil
+        int assembleGalerkinMat() nogil
         void setMonitor(KSMPrint*)
 
 cdef extern from "TACSElementBasis.h":
@@ -373,45 +373,45 @@ cdef extern from "TACSAssembler.h":
         void getInitConditions(TACSBVec*, TACSBVec*, TACSBVec*)
         void setInitConditions(TACSBVec*, TACSBVec*, TACSBVec*)
         void evalEnergies(TacsScalar*, TacsScalar*)
-        void assembleRes(TACSBVec *residual, TacsScalar loadScale)
+        void assembleRes(TACSBVec *residual, TacsScalar loadScale) nogil
         void assembleJacobian(double alpha, double beta, double gamma,
                               TACSBVec *residual, TACSMat *A,
                               MatrixOrientation matOr,
-                              TacsScalar loadScale)
+                              TacsScalar loadScale) nogil
         void assembleMatType(ElementMatrixType matType,
                              TACSMat *A, MatrixOrientation matOr,
-                             TacsScalar loadScale)
+                             TacsScalar loadScale) nogil
         void assembleMatCombo(ElementMatrixType*, TacsScalar*, int,
                               TACSMat*, MatrixOrientation matOr,
-                              TacsScalar loadScale)
+                              TacsScalar loadScale) nogil
         void addJacobianVecProduct(TacsScalar scale,
                                    double alpha, double beta, double gamma,
                                    TACSBVec *x, TACSBVec *y,
                                    MatrixOrientation matOr,
-                                   TacsScalar loadScale)
+                                   TacsScalar loadScale) nogil
         void evalFunctions(int numFuncs, TACSFunction **functions,
-                           TacsScalar *funcVals)
+                           TacsScalar *funcVals) nogil
         void addDVSens(double coef, int numFuncs, TACSFunction **funcs,
-                       TACSBVec **dfdx)
+                       TACSBVec **dfdx) nogil
         void addSVSens(double alpha, double beta, double gamma,
                        int numFuncs, TACSFunction **funcs,
-                       TACSBVec **fuSens)
+                       TACSBVec **fuSens) nogil
         void addAdjointResProducts(double scale, int numAdjoints,
                                    TACSBVec **adjoint, TACSBVec **dfdx,
-                                   TacsScalar loadScale)
+                                   TacsScalar loadScale) nogil
         void addXptSens(double coef, int numFuncs, TACSFunction **funcs,
-                        TACSBVec **fXptSens)
+                        TACSBVec **fXptSens) nogil
         void addAdjointResXptSensProducts(double scale, int numAdjoints,
                                           TACSBVec **adjoint,
                                           TACSBVec **adjXptSens,
-                                          TacsScalar loadScale)
+                                          TacsScalar loadScale) nogil
         void addMatDVSensInnerProduct(double scale,
                                       ElementMatrixType matType,
                                       TACSBVec *psi, TACSBVec *phi,
-                                      TACSBVec *dfdx)
+                                      TACSBVec *dfdx) nogil
         void evalMatSVSensInnerProduct(ElementMatrixType matType,
                                        TACSBVec *psi, TACSBVec *phi,
-                                       TACSBVec *res)
+                                       TACSBVec *res) nogil
 
         void testElement(int elemNum, int print_level, double dh,
                          double rtol, double atol)
@@ -446,7 +446,7 @@ cdef extern from "GSEP.h":
     cdef cppclass SEP(TACSObject):
         SEP(EPOperator*, int, OrthoType, TACSBcMap*)
         void setTolerances(double, EigenSpectrum, int)
-        void solve(KSMPrint*, KSMPrint*)
+        void solve(KSMPrint*, KSMPrint*) nogil
         TacsScalar extractEigenvalue(int, TacsScalar*)
         TacsScalar extractEigenvector(int, TACSBVec*, TacsScalar*)
         void printOrthogonality()
@@ -474,7 +474,7 @@ cdef extern from "JacobiDavidson.h":
        int getNumConvergedEigenvalues()
        TacsScalar extractEigenvalue(int, TacsScalar*)
        TacsScalar extractEigenvector(int n, TACSVec*, TacsScalar*)
-       void solve(KSMPrint*, int)
+       void solve(KSMPrint*, int) nogil
        void setTolerances(double, double, double, double)
        void setThetaCutoff(double)
        void setRecycle(int, JDRecycleType)
@@ -492,7 +492,7 @@ cdef extern from "TACSBuckling.h":
         TACSAssembler* getAssembler()
         TacsScalar getSigma()
         void setSigma(TacsScalar)
-        void solve(KSMPrint*, int)
+        void solve(KSMPrint*, int) nogil
         TacsScalar extractEigenvalue(int, TacsScalar*)
         TacsScalar extractEigenvector(int, TACSBVec*, TacsScalar*)
         void evalEigenDVSens(int, TACSBVec*)
@@ -507,7 +507,7 @@ cdef extern from "TACSBuckling.h":
         TACSAssembler* getAssembler()
         TacsScalar getSigma()
         void setSigma(TacsScalar)
-        void solve(TACSVec*, TACSVec*, KSMPrint*)
+        void solve(TACSVec*, TACSVec*, KSMPrint*) nogil
         void evalEigenDVSens(int, TacsScalar, int)
         TacsScalar extractEigenvalue(int, TacsScalar*)
         TacsScalar extractEigenvector(int, TACSBVec*, TacsScalar*)
@@ -615,15 +615,15 @@ cdef extern from "TACSIntegrator.h":
                                       TACSBVec*, TacsScalar*, TacsScalar*)
 
         # Forward mode functions
-        int iterate(int step_num,TACSBVec *forces)
-        int integrate()
-        void evalFunctions(TacsScalar *fvals)
+        int iterate(int step_num,TACSBVec *forces) nogil
+        int integrate() nogil
+        void evalFunctions(TacsScalar *fvals) nogil
 
         # Reverse mode functions
-        void iterateAdjoint(int step_num, TACSBVec **adj_rhs)
-        void initAdjoint(int step_num)
-        void integrateAdjoint()
-        void postAdjoint(int step_num)
+        void iterateAdjoint(int step_num, TACSBVec **adj_rhs) nogil
+        void initAdjoint(int step_num) nogil
+        void integrateAdjoint() nogil
+        void postAdjoint(int step_num) nogil
         void getAdjoint(int step_num, int func_num, TACSBVec **adjoint)
         void getGradient(int func_num, TACSBVec **dfdx)
         void getXptGradient(int func_num, TACSBVec **dfdXpt)
@@ -658,7 +658,7 @@ cdef extern from "TACSIntegrator.h":
                            double num_steps,
                            int stages)
 
-        int iterateStage(int k, int s, TACSBVec *forces)
+        int iterateStage(int k, int s, TACSBVec *forces) nogil
         double getStageStates( int step, int stage,
 		      TACSBVec **qS, TACSBVec **qdotS, TACSBVec **qddotS)
 
@@ -669,7 +669,7 @@ cdef extern from "TACSIntegrator.h":
                              double num_steps,
                              int stages)
 
-        int iterateStage(int k, int s, TACSBVec *forces)
+        int iterateStage(int k, int s, TACSBVec *forces) nogil
         double getStageStates( int step, int stage,
 		      TACSBVec **qS, TACSBVec **qdotS, TACSBVec **qddotS)
 
@@ -703,7 +703,7 @@ cdef extern from "TACSSpectralIntegrator.h":
     cdef cppclass TACSLinearSpectralMg(TACSPc):
         TACSLinearSpectralMg(TACSLinearSpectralMat*, int,
                              TACSAssembler**, TACSBVecInterp**, int*)
-        void factor()
+        void factor() nogil
 
     cdef cppclass TACSSpectralIntegrator(TACSObject):
         TACSSpectralIntegrator(TACSAssembler*, double, int)
@@ -718,15 +718,15 @@ cdef extern from "TACSSpectralIntegrator.h":
         TACSLinearSpectralMat *createLinearMat()
         void setInitialConditions(TACSBVec*)
         void setVariables(TACSSpectralVec*)
-        void assembleRes(TACSSpectralVec*res)
+        void assembleRes(TACSSpectralVec*res) nogil
         void assembleMat(TACSLinearSpectralMat*,
-                         MatrixOrientation matOr)
+                         MatrixOrientation matOr) nogil
 
-        void evalFunctions(int, TACSFunction**, TacsScalar*)
-        void evalSVSens(TACSFunction*, TACSSpectralVec*)
-        void addDVSens(TACSFunction*, TACSBVec*)
+        void evalFunctions(int, TACSFunction**, TacsScalar*) nogil
+        void evalSVSens(TACSFunction*, TACSSpectralVec*) nogil
+        void addDVSens(TACSFunction*, TACSBVec*) nogil
         void addAdjointResProduct(TacsScalar, TACSSpectralVec*,
-                                  TACSBVec*)
+                                  TACSBVec*) nogil
 
         # Compute the solution at a point in the time interval
         void computeSolutionAndDeriv(double, TACSSpectralVec*, TACSBVec *u, TACSBVec*)